@@ -0,0 +1,59 @@
+/**
+ * \file            lwesp_opts.h
+ * \brief           ESP application options
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_OPTS_H
+#define LWESP_HDR_OPTS_H
+
+/* Rename this file to "lwesp_opts.h" for your application */
+
+/*
+ * Open "include/lwesp/lwesp_opt.h" and
+ * copy & replace here settings you want to change values
+ */
+#define LWESP_CFG_AT_PORT_BAUDRATE            921600
+#define LWESP_CFG_INPUT_USE_PROCESS           1
+#define LWESP_CFG_NETCONN                     1
+#define LWESP_CFG_MEM_STATS                   1
+#define LWESP_CFG_SYS_NOW_US                  1
+#define LWESP_CFG_STATS                       1
+#define LWESP_CFG_STATS_THREAD                1
+#define LWESP_CFG_STATS_TRAFFIC               1
+#define LWESP_CFG_TRACE                       1
+#define LWESP_CFG_TRACE_BUFF_LEN              4096
+
+/* Benchmark and load test results are written to result file too */
+int profile_printf(const char* fmt, ...);
+#define BENCH_PRINTF                          profile_printf
+#define LOADTEST_PRINTF                       profile_printf
+
+#endif /* LWESP_HDR_OPTS_H */
@@ -0,0 +1,227 @@
+/**
+ * \file            main.c
+ * \brief           Main file
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Profile runs benchmarks and standard load test workload against simulated ESP device
+ * from lwesp_ll_sim.c, with statistics and trace points enabled. No hardware is required.
+ *
+ * Results are printed as JSON lines and written to PROFILE_RESULT_FILE,
+ * followed by command and thread statistics. Trace of the run is written
+ * to PROFILE_TRACE_FILE and can be opened in Perfetto UI or chrome://tracing.
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include "lwesp/lwesp.h"
+#include "lwesp/lwesp_stats.h"
+#include "lwesp/lwesp_trace.h"
+#include "benchmark.h"
+#include "loadtest.h"
+
+/**
+ * \brief           Output file names, relative to working directory
+ */
+#define PROFILE_RESULT_FILE         "lwesp_profile.json"
+#define PROFILE_TRACE_FILE          "lwesp_profile_trace.json"
+
+static lwespr_t lwesp_callback_func(lwesp_evt_t* evt);
+static void profile_thread(void const* arg);
+
+static FILE* profile_file;
+
+/**
+ * \brief           Standard load test workload, the same on every run to compare results
+ */
+static const loadtest_cfg_t profile_loads[] = {
+    {.type = LOADTEST_TYPE_CONN, .sessions = 1, .payload = 512, .rate = 0, .duration = 3000},
+    {.type = LOADTEST_TYPE_CONN, .sessions = 4, .payload = 512, .rate = 0, .duration = 3000},
+    {.type = LOADTEST_TYPE_NETCONN_TCP, .sessions = 1, .payload = LOADTEST_MAX_PAYLOAD, .rate = 0, .duration = 3000},
+    {.type = LOADTEST_TYPE_NETCONN_UDP, .sessions = 1, .payload = 64, .rate = 100, .duration = 3000},
+    {.type = LOADTEST_TYPE_MQTT, .sessions = 2, .payload = 64, .rate = 0, .duration = 3000},
+};
+
+/**
+ * \brief           Program entry point
+ */
+int
+main(void) {
+    printf("Starting ESP application!\r\n");
+
+    /* Initialize ESP with default callback function */
+    printf("Initializing LwESP\r\n");
+    if (lwesp_init(lwesp_callback_func, 1) != lwespOK) {
+        printf("Cannot initialize LwESP!\r\n");
+    } else {
+        printf("LwESP initialized!\r\n");
+    }
+
+    /* Start profile thread */
+    lwesp_sys_thread_create(NULL, "profile", (lwesp_sys_thread_fn)profile_thread, NULL, LWESP_SYS_THREAD_SS, LWESP_SYS_THREAD_PRIO);
+
+    /*
+     * Do not stop program here.
+     * New threads were created for ESP processing
+     */
+    while (1) {
+        lwesp_delay(1000);
+    }
+
+    return 0;
+}
+
+/**
+ * \brief           Print formatted output to console and result file
+ * \param[in]       fmt: Format string
+ * \return          Number of characters printed to console
+ */
+int
+profile_printf(const char* fmt, ...) {
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = vprintf(fmt, args);
+    va_end(args);
+    if (profile_file != NULL) {
+        va_start(args, fmt);
+        vfprintf(profile_file, fmt, args);
+        va_end(args);
+    }
+    return len;
+}
+
+/**
+ * \brief           Print statistics collected during the run
+ */
+static void
+profile_print_stats(void) {
+    lwesp_stats_t stats;
+    lwesp_stats_cmd_t cmd;
+
+    if (lwesp_stats_get(&stats) != lwespOK) {
+        return;
+    }
+    for (size_t i = 0; i < stats.cmd_count; ++i) {
+        if (lwesp_stats_get_cmd(i, &cmd) != lwespOK || cmd.count == 0) {
+            continue;
+        }
+        profile_printf("{\"stats_cmd\":%u,\"count\":%u,\"errors\":%u,\"timeouts\":%u,\"time_avg\":%u,\"time_max\":%u,\"resp_time_max\":%u,\"queue_time_max\":%u,\"unit\":\"%s\"}\r\n",
+                       (unsigned)i, (unsigned)cmd.count, (unsigned)cmd.err_count, (unsigned)cmd.timeout_count,
+                       (unsigned)(cmd.time_sum / cmd.count), (unsigned)cmd.time_max,
+                       (unsigned)cmd.resp_time_max, (unsigned)cmd.queue_time_max, LWESP_STATS_TIME_UNIT);
+    }
+    profile_printf("{\"stats_thread\":\"producer\",\"busy\":%u,\"idle\":%u,\"sync\":%u,\"wakeups\":%u,\"unit\":\"%s\"}\r\n",
+                   (unsigned)stats.producer.busy_time, (unsigned)stats.producer.idle_time,
+                   (unsigned)stats.producer.sync_time, (unsigned)stats.producer.wakeups, LWESP_STATS_TIME_UNIT);
+    profile_printf("{\"stats_thread\":\"process\",\"busy\":%u,\"idle\":%u,\"wakeups\":%u,\"unit\":\"%s\"}\r\n",
+                   (unsigned)stats.process.busy_time, (unsigned)stats.process.idle_time,
+                   (unsigned)stats.process.wakeups, LWESP_STATS_TIME_UNIT);
+    profile_printf("{\"stats_traffic\":\"total\",\"uart_rx_bytes\":%u,\"uart_tx_bytes\":%u,\"uart_rx_dropped\":%u,\"tx_bytes\":%u,\"rx_bytes\":%u,\"ipd_drops\":%u}\r\n",
+                   (unsigned)stats.uart_rx_bytes, (unsigned)stats.uart_tx_bytes, (unsigned)stats.uart_rx_dropped,
+                   (unsigned)stats.conn.tx_bytes, (unsigned)stats.conn.rx_bytes, (unsigned)stats.conn.ipd_drops);
+}
+
+/**
+ * \brief           Trace export output function
+ * \param[in]       str: Output chunk
+ * \param[in]       len: Length of chunk in units of bytes
+ * \param[in]       arg: Output file
+ */
+static void
+profile_trace_out(const char* str, size_t len, void* arg) {
+    fwrite(str, 1, len, arg);
+}
+
+/**
+ * \brief           Profile thread, runs benchmarks and load test once and writes result files
+ * \param[in]       arg: User argument, not used
+ */
+static void
+profile_thread(void const* arg) {
+    FILE* f;
+
+    LWESP_UNUSED(arg);
+
+    profile_file = fopen(PROFILE_RESULT_FILE, "w");
+    if (profile_file == NULL) {
+        printf("Cannot open result file %s\r\n", PROFILE_RESULT_FILE);
+    }
+
+    /* Trace and statistics cover benchmarks and load test */
+    lwesp_stats_reset();
+    benchmark_run();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(profile_loads); ++i) {
+        loadtest_run(&profile_loads[i]);
+    }
+    profile_print_stats();
+
+    if (profile_file != NULL) {
+        fclose(profile_file);
+        profile_file = NULL;
+        printf("Results written to %s\r\n", PROFILE_RESULT_FILE);
+    }
+    if ((f = fopen(PROFILE_TRACE_FILE, "w")) != NULL) {
+        lwesp_trace_export(profile_trace_out, f);
+        fclose(f);
+        printf("Trace written to %s, lost events: %u\r\n", PROFILE_TRACE_FILE, (unsigned)lwesp_trace_get_lost());
+    }
+    printf("Profile finished\r\n");
+    lwesp_sys_thread_terminate(NULL);
+}
+
+/**
+ * \brief           Event callback function for ESP stack
+ * \param[in]       evt: Event information with data
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+static lwespr_t
+lwesp_callback_func(lwesp_evt_t* evt) {
+    switch (lwesp_evt_get_type(evt)) {
+        case LWESP_EVT_AT_VERSION_NOT_SUPPORTED: {
+            lwesp_sw_version_t v_min, v_curr;
+
+            lwesp_get_min_at_fw_version(&v_min);
+            lwesp_get_current_at_fw_version(&v_curr);
+
+            printf("Current ESP8266 AT version is not supported by library!\r\n");
+            printf("Minimum required AT version is: %d.%d.%d\r\n", (int)v_min.major, (int)v_min.minor, (int)v_min.patch);
+            printf("Current AT version is: %d.%d.%d\r\n", (int)v_curr.major, (int)v_curr.minor, (int)v_curr.patch);
+            break;
+        }
+        case LWESP_EVT_INIT_FINISH: {
+            printf("Library initialized!\r\n");
+            break;
+        }
+        case LWESP_EVT_RESET_DETECTED: {
+            printf("Device reset detected!\r\n");
+            break;
+        }
+        default: break;
+    }
+    return lwespOK;
+}
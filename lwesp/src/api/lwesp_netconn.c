@@ -35,6 +35,9 @@
 #include "lwesp/lwesp_private.h"
 #include "lwesp/lwesp_conn.h"
 #include "lwesp/lwesp_mem.h"
+#if LWESP_CFG_NETCONN_DEADLINE || LWESP_CFG_NETCONN_PREWARM
+#include "lwesp/lwesp_timeout.h"
+#endif /* LWESP_CFG_NETCONN_DEADLINE || LWESP_CFG_NETCONN_PREWARM */
 
 #if LWESP_CFG_NETCONN || __DOXYGEN__
 
@@ -43,10 +46,22 @@
 #error "LWESP_CFG_NETCONN_RECEIVE_QUEUE_LEN must be greater or equal to 2"
 #endif /* LWESP_CFG_NETCONN_RECEIVE_QUEUE_LEN < 2 */
 
+#if LWESP_CFG_NETCONN_RECEIVE_LOW_WATERMARK > LWESP_CFG_NETCONN_RECEIVE_HIGH_WATERMARK
+#error "LWESP_CFG_NETCONN_RECEIVE_LOW_WATERMARK must not be greater than LWESP_CFG_NETCONN_RECEIVE_HIGH_WATERMARK"
+#endif /* LWESP_CFG_NETCONN_RECEIVE_LOW_WATERMARK > LWESP_CFG_NETCONN_RECEIVE_HIGH_WATERMARK */
+
+#if LWESP_CFG_NETCONN_REACTOR && !LWESP_CFG_NETCONN_SELECT
+#error "LWESP_CFG_NETCONN_REACTOR requires LWESP_CFG_NETCONN_SELECT"
+#endif /* LWESP_CFG_NETCONN_REACTOR && !LWESP_CFG_NETCONN_SELECT */
+
 #if LWESP_CFG_NETCONN_ACCEPT_QUEUE_LEN < 2
 #error "LWESP_CFG_NETCONN_ACCEPT_QUEUE_LEN must be greater or equal to 2"
 #endif /* LWESP_CFG_NETCONN_ACCEPT_QUEUE_LEN < 2 */
 
+#if LWESP_CFG_NETCONN_PREWARM >= LWESP_CFG_MAX_CONNS
+#error "LWESP_CFG_NETCONN_PREWARM must be lower than LWESP_CFG_MAX_CONNS"
+#endif /* LWESP_CFG_NETCONN_PREWARM >= LWESP_CFG_MAX_CONNS */
+
 /**
  * \brief           Sequential API structure
  */
@@ -62,9 +77,29 @@ typedef struct lwesp_netconn {
     lwesp_sys_mbox_t mbox_accept;               /*!< List of active connections waiting to be processed */
     lwesp_sys_mbox_t mbox_receive;              /*!< Message queue for receive mbox */
     size_t mbox_receive_entries;                /*!< Number of entries written to receive mbox */
+    size_t mbox_receive_bytes;                  /*!< Number of data bytes written to receive mbox */
 
     lwesp_linbuff_t buff;                       /*!< Linear buffer structure */
 
+    struct lwesp_netconn* spare;                /*!< List of preallocated netconns for incoming clients (listening netconn) */
+    struct lwesp_netconn* spare_next;           /*!< Next netconn in list of preallocated netconns */
+    size_t spare_cnt;                           /*!< Number of netconns in preallocated list */
+    size_t spare_target;                        /*!< Number of preallocated netconns to keep ready */
+    lwespr_t accept_err;                        /*!< Listening error received during batched accept, reported on next accept */
+
+#if LWESP_CFG_NETCONN_DEADLINE || __DOXYGEN__
+    uint32_t idle_time;                         /*!< Idle time in units of milliseconds, `0` when deadline is disabled */
+    uint32_t deadline;                          /*!< Absolute time when idle deadline expires */
+    uint8_t deadline_posted;                    /*!< Flag if timeout event is written to receive mbox */
+#endif /* LWESP_CFG_NETCONN_DEADLINE || __DOXYGEN__ */
+#if LWESP_CFG_NETCONN_POOL || __DOXYGEN__
+    uint8_t pool_used;                          /*!< Flag if pool entry is in use */
+#endif /* LWESP_CFG_NETCONN_POOL || __DOXYGEN__ */
+
+    lwesp_pbuf_p rd_pbuf;                       /*!< Received packet buffer partially consumed by \ref lwesp_netconn_read */
+    size_t rd_off;                              /*!< Offset of first not yet read byte in `rd_pbuf` */
+    uint8_t rd_closed;                          /*!< Flag if connection closed has been received while reading multiple packets */
+
     uint16_t conn_timeout;                      /*!< Connection timeout in units of seconds when
                                                     netconn is in server (listen) mode.
                                                     Connection will be automatically closed if there is no
@@ -73,11 +108,85 @@ typedef struct lwesp_netconn {
 #if LWESP_CFG_NETCONN_RECEIVE_TIMEOUT || __DOXYGEN__
     uint32_t rcv_timeout;                       /*!< Receive timeout in unit of milliseconds */
 #endif
+#if LWESP_CFG_NETCONN_WRITE_NONBLOCK || __DOXYGEN__
+    size_t write_pending;                       /*!< Number of bytes queued with non-blocking write and not yet sent */
+    lwespr_t write_err;                         /*!< Last error of non-blocking send, reported on next write */
+    uint8_t write_nonblock;                     /*!< Flag if non-blocking write has been used on netconn */
+    uint8_t write_wait;                         /*!< Flag if application waits for write budget to become available */
+#endif /* LWESP_CFG_NETCONN_WRITE_NONBLOCK || __DOXYGEN__ */
+#if LWESP_CFG_NETCONN_SELECT || __DOXYGEN__
+    size_t mbox_accept_entries;                 /*!< Number of entries written to accept mbox */
+    struct lwesp_netconn_set* set;              /*!< Netconn set this netconn belongs to */
+    struct lwesp_netconn* set_next;             /*!< Next netconn in the same set */
+#if LWESP_CFG_NETCONN_REACTOR || __DOXYGEN__
+    lwesp_netconn_reactor_fn reactor_fn;        /*!< Reactor event callback */
+    void* reactor_arg;                          /*!< Reactor callback custom argument */
+    uint32_t reactor_pass;                      /*!< Last reactor pass in which netconn was served */
+#endif /* LWESP_CFG_NETCONN_REACTOR || __DOXYGEN__ */
+#endif /* LWESP_CFG_NETCONN_SELECT || __DOXYGEN__ */
 } lwesp_netconn_t;
 
+#if LWESP_CFG_NETCONN_SELECT || __DOXYGEN__
+
+/**
+ * \brief           Netconn set structure
+ */
+typedef struct lwesp_netconn_set {
+    lwesp_sys_sem_t sem;                        /*!< Semaphore released on every event of any netconn in set */
+    lwesp_netconn_t* first;                     /*!< First netconn in set */
+#if LWESP_CFG_NETCONN_REACTOR || __DOXYGEN__
+    uint32_t reactor_pass;                      /*!< Current reactor pass */
+#endif /* LWESP_CFG_NETCONN_REACTOR || __DOXYGEN__ */
+} lwesp_netconn_set_t;
+
+/**
+ * \brief           Notify set waiter about new event on netconn
+ * \param[in]       nc: Netconn handle
+ */
+#define NETCONN_SET_NOTIFY(nc)      do {                        \
+        if ((nc) != NULL && (nc)->set != NULL) {                \
+            lwesp_sys_sem_release(&(nc)->set->sem);            \
+        }                                                       \
+    } while (0)
+
+/**
+ * \brief           Increase number of entries in accept mbox
+ * \param[in]       nc: Netconn handle
+ */
+#define NETCONN_ACCEPT_INC(nc)      do {                        \
+        ++(nc)->mbox_accept_entries;                            \
+        NETCONN_SET_NOTIFY(nc);                                 \
+    } while (0)
+#else /* LWESP_CFG_NETCONN_SELECT || __DOXYGEN__ */
+#define NETCONN_SET_NOTIFY(nc)
+#define NETCONN_ACCEPT_INC(nc)
+#endif /* !(LWESP_CFG_NETCONN_SELECT || __DOXYGEN__) */
+
+#if LWESP_CFG_NETCONN_WRITE_NONBLOCK
+/**
+ * \brief           Check if netconn waits for write budget and budget is available
+ * \param[in]       nc: Netconn handle
+ */
+#define NETCONN_IS_WRITABLE(nc)     ((nc)->write_wait && (nc)->write_pending < LWESP_CFG_NETCONN_WRITE_BUDGET)
+#else /* LWESP_CFG_NETCONN_WRITE_NONBLOCK */
+#define NETCONN_IS_WRITABLE(nc)     0
+#endif /* !LWESP_CFG_NETCONN_WRITE_NONBLOCK */
+
 static uint8_t recv_closed = 0xFF, recv_not_present = 0xFF;
+#if LWESP_CFG_NETCONN_DEADLINE
+static uint8_t recv_deadline = 0xFF;            /*!< Receive mbox entry for expired idle deadline */
+static lwesp_timeout_id_t deadline_id;          /*!< Timer serving all netconn deadlines */
+static uint32_t deadline_time;                  /*!< Absolute expiry time of deadline timer */
+#endif /* LWESP_CFG_NETCONN_DEADLINE */
 static lwesp_netconn_t* listen_api;             /*!< Main connection in listening mode */
 static lwesp_netconn_t* netconn_list;           /*!< Linked list of netconn entries */
+#if LWESP_CFG_NETCONN_POOL
+static lwesp_netconn_t netconn_pool[LWESP_CFG_NETCONN_POOL_SIZE];   /*!< Static pool of netconn entries */
+#endif /* LWESP_CFG_NETCONN_POOL */
+#if LWESP_CFG_NETCONN_MUX
+static uint32_t netconn_reset_cnt;              /*!< Number of detected device resets */
+static uint8_t netconn_in_reset;                /*!< Set to `1` between reset detection and reset finish */
+#endif /* LWESP_CFG_NETCONN_MUX */
 
 /**
  * \brief           Flush all mboxes and clear possible used memories
@@ -91,17 +200,28 @@ flush_mboxes(lwesp_netconn_t* nc, uint8_t protect) {
     if (protect) {
         lwesp_core_lock();
     }
+    if (nc->rd_pbuf != NULL) {                  /* Free partially read buffer */
+        lwesp_pbuf_free(nc->rd_pbuf);
+        nc->rd_pbuf = NULL;
+    }
     if (lwesp_sys_mbox_isvalid(&nc->mbox_receive)) {
         while (lwesp_sys_mbox_getnow(&nc->mbox_receive, (void**)&pbuf)) {
             if (nc->mbox_receive_entries > 0) {
                 --nc->mbox_receive_entries;
             }
-            if (pbuf != NULL && (uint8_t*)pbuf != (uint8_t*)&recv_closed) {
+            if (pbuf != NULL && (uint8_t*)pbuf != (uint8_t*)&recv_closed
+#if LWESP_CFG_NETCONN_DEADLINE
+                && (uint8_t*)pbuf != (uint8_t*)&recv_deadline
+#endif /* LWESP_CFG_NETCONN_DEADLINE */
+               ) {
                 lwesp_pbuf_free(pbuf);          /* Free received data buffers */
             }
+            nc->mbox_receive_bytes = 0;
         }
+#if !LWESP_CFG_NETCONN_POOL
         lwesp_sys_mbox_delete(&nc->mbox_receive);   /* Delete message queue */
         lwesp_sys_mbox_invalid(&nc->mbox_receive);  /* Invalid handle */
+#endif /* !LWESP_CFG_NETCONN_POOL */
     }
     if (lwesp_sys_mbox_isvalid(&nc->mbox_accept)) {
         while (lwesp_sys_mbox_getnow(&nc->mbox_accept, (void**)&new_nc)) {
@@ -111,14 +231,101 @@ flush_mboxes(lwesp_netconn_t* nc, uint8_t protect) {
                 lwesp_netconn_close(new_nc);    /* Close netconn connection */
             }
         }
+#if LWESP_CFG_NETCONN_SELECT
+        nc->mbox_accept_entries = 0;
+#endif /* LWESP_CFG_NETCONN_SELECT */
+#if !LWESP_CFG_NETCONN_POOL
         lwesp_sys_mbox_delete(&nc->mbox_accept);/* Delete message queue */
         lwesp_sys_mbox_invalid(&nc->mbox_accept);   /* Invalid handle */
+#endif /* !LWESP_CFG_NETCONN_POOL */
     }
     if (protect) {
         lwesp_core_unlock();
     }
 }
 
+#if LWESP_CFG_NETCONN_DEADLINE
+
+static void netconn_deadline_cb(void* arg);
+
+/**
+ * \brief           Make sure deadline timer expires no later than specific time
+ * \note            Function must be called with core lock acquired
+ * \param[in]       time: Absolute time in units of milliseconds
+ */
+static void
+netconn_deadline_schedule(uint32_t time) {
+    int32_t diff;
+
+    if (deadline_id != 0) {
+        if ((int32_t)(time - deadline_time) >= 0) {
+            return;                             /* Timer already expires on time */
+        }
+        lwesp_timeout_cancel(deadline_id);      /* Restart timer with earlier time */
+    }
+    diff = (int32_t)(time - lwesp_sys_now());
+    deadline_time = time;
+    deadline_id = lwesp_timeout_addex(diff > 0 ? (uint32_t)diff : 0, netconn_deadline_cb, NULL);
+}
+
+/**
+ * \brief           Restart idle deadline of netconn after traffic
+ * \note            Function must be called with core lock acquired
+ * \param[in]       nc: Netconn handle
+ */
+static void
+netconn_deadline_restart(lwesp_netconn_t* nc) {
+    if (nc->idle_time > 0) {
+        /* Timer is not moved on later deadline, callback reschedules itself */
+        nc->deadline = lwesp_sys_now() + nc->idle_time;
+        netconn_deadline_schedule(nc->deadline);
+    }
+}
+
+/**
+ * \brief           Timer callback serving idle deadlines of all netconns
+ *
+ * Expired netconns get timeout entry in receive mbox,
+ * timer is then scheduled for nearest remaining deadline
+ *
+ * \param[in]       arg: Custom argument, unused
+ */
+static void
+netconn_deadline_cb(void* arg) {
+    uint32_t now, next = 0;
+    uint8_t has_next = 0;
+
+    LWESP_UNUSED(arg);
+    deadline_id = 0;
+    now = lwesp_sys_now();
+    for (lwesp_netconn_t* nc = netconn_list; nc != NULL; nc = nc->next) {
+        if (nc->idle_time == 0) {
+            continue;
+        }
+        if ((int32_t)(now - nc->deadline) >= 0) {
+            if (!nc->deadline_posted && lwesp_sys_mbox_isvalid(&nc->mbox_receive)
+                && lwesp_sys_mbox_putnow(&nc->mbox_receive, &recv_deadline)) {
+                nc->deadline_posted = 1;
+                ++nc->mbox_receive_entries;
+                NETCONN_SET_NOTIFY(nc);
+            }
+            nc->deadline = now + nc->idle_time; /* Report again after next idle period */
+        }
+        if (!has_next || (int32_t)(nc->deadline - next) < 0) {
+            next = nc->deadline;
+            has_next = 1;
+        }
+    }
+    if (has_next) {
+        netconn_deadline_schedule(next);
+    }
+}
+
+#define NETCONN_DEADLINE_RESTART(nc)    netconn_deadline_restart(nc)
+#else /* LWESP_CFG_NETCONN_DEADLINE */
+#define NETCONN_DEADLINE_RESTART(nc)
+#endif /* !LWESP_CFG_NETCONN_DEADLINE */
+
 /**
  * \brief           Callback function for every server connection
  * \param[in]       evt: Pointer to callback structure
@@ -151,7 +358,14 @@ netconn_evt(lwesp_evt_t* evt) {
                  * Create a new netconn structure
                  * and set it as connection argument.
                  */
-                nc = lwesp_netconn_new(LWESP_NETCONN_TYPE_TCP); /* Create new API */
+                if (listen_api->spare != NULL) {/* Use preallocated netconn when available */
+                    nc = listen_api->spare;
+                    listen_api->spare = nc->spare_next;
+                    nc->spare_next = NULL;
+                    --listen_api->spare_cnt;
+                } else {
+                    nc = lwesp_netconn_new(LWESP_NETCONN_TYPE_TCP); /* Create new API */
+                }
                 LWESP_DEBUGW(LWESP_CFG_DBG_NETCONN | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING,
                            nc == NULL, "[NETCONN] Cannot create new structure for incoming server connection!\r\n");
 
@@ -166,6 +380,8 @@ netconn_evt(lwesp_evt_t* evt) {
                     if (!lwesp_sys_mbox_isvalid(&listen_api->mbox_accept)
                         || !lwesp_sys_mbox_putnow(&listen_api->mbox_accept, nc)) {
                         close = 1;
+                    } else {
+                        NETCONN_ACCEPT_INC(listen_api);
                     }
                 } else {
                     close = 1;
@@ -211,9 +427,16 @@ netconn_evt(lwesp_evt_t* evt) {
                 return lwespOKIGNOREMORE;       /* Return OK to free the memory and ignore further data */
             }
             ++nc->mbox_receive_entries;         /* Increase number of packets in receive mbox */
+            nc->mbox_receive_bytes += lwesp_pbuf_length(pbuf, 1);
+            NETCONN_DEADLINE_RESTART(nc);       /* Traffic moves idle deadline */
+            NETCONN_SET_NOTIFY(nc);
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
-            /* Check against 1 less to still allow potential close event to be written to queue */
-            if (nc->mbox_receive_entries >= (LWESP_CFG_NETCONN_RECEIVE_QUEUE_LEN - 1)) {
+            /*
+             * Stop reading when queue holds too many bytes, device TCP window throttles the sender.
+             * Check entries against 1 less to still allow potential close event to be written to queue
+             */
+            if (nc->mbox_receive_entries >= (LWESP_CFG_NETCONN_RECEIVE_QUEUE_LEN - 1)
+                || nc->mbox_receive_bytes >= LWESP_CFG_NETCONN_RECEIVE_HIGH_WATERMARK) {
                 conn->status.f.receive_blocked = 1; /* Block reading more data */
             }
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
@@ -225,6 +448,34 @@ netconn_evt(lwesp_evt_t* evt) {
             break;
         }
 
+#if LWESP_CFG_NETCONN_WRITE_NONBLOCK || LWESP_CFG_NETCONN_DEADLINE
+        /* Data sent, release write budget for non-blocking write */
+        case LWESP_EVT_CONN_SEND: {
+            nc = lwesp_conn_get_arg(conn);
+#if LWESP_CFG_NETCONN_DEADLINE
+            if (nc != NULL && lwesp_evt_conn_send_get_result(evt) == lwespOK) {
+                NETCONN_DEADLINE_RESTART(nc);   /* Traffic moves idle deadline */
+            }
+#endif /* LWESP_CFG_NETCONN_DEADLINE */
+#if LWESP_CFG_NETCONN_WRITE_NONBLOCK
+            if (nc != NULL && nc->write_nonblock) {
+                if (lwesp_evt_conn_send_get_result(evt) == lwespOK) {
+                    size_t len = lwesp_evt_conn_send_get_length(evt);
+                    nc->write_pending -= LWESP_MIN(nc->write_pending, len);
+                } else {
+                    /* Queued data are lost, report error on next write */
+                    nc->write_err = lwesp_evt_conn_send_get_result(evt);
+                    nc->write_pending = 0;
+                }
+                if (NETCONN_IS_WRITABLE(nc)) {
+                    NETCONN_SET_NOTIFY(nc);     /* Notify waiter about available budget */
+                }
+            }
+#endif /* LWESP_CFG_NETCONN_WRITE_NONBLOCK */
+            break;
+        }
+#endif /* LWESP_CFG_NETCONN_WRITE_NONBLOCK || LWESP_CFG_NETCONN_DEADLINE */
+
         /* Connection was just closed */
         case LWESP_EVT_CONN_CLOSE: {
             nc = lwesp_conn_get_arg(conn);      /* Get API from connection */
@@ -236,6 +487,7 @@ netconn_evt(lwesp_evt_t* evt) {
             if (nc != NULL && lwesp_sys_mbox_isvalid(&nc->mbox_receive)) {
                 if (lwesp_sys_mbox_putnow(&nc->mbox_receive, (void*)&recv_closed)) {
                     ++nc->mbox_receive_entries;
+                    NETCONN_SET_NOTIFY(nc);
                 }
             }
 
@@ -257,15 +509,31 @@ lwesp_evt(lwesp_evt_t* evt) {
     switch (lwesp_evt_get_type(evt)) {
         case LWESP_EVT_WIFI_DISCONNECTED: {     /* Wifi disconnected event */
             if (listen_api != NULL) {           /* Check if listen API active */
-                lwesp_sys_mbox_putnow(&listen_api->mbox_accept, &recv_closed);
+                if (lwesp_sys_mbox_putnow(&listen_api->mbox_accept, &recv_closed)) {
+                    NETCONN_ACCEPT_INC(listen_api);
+                }
             }
             break;
         }
         case LWESP_EVT_DEVICE_PRESENT: {        /* Device present event */
             if (listen_api != NULL && !lwesp_device_is_present()) { /* Check if device present */
-                lwesp_sys_mbox_putnow(&listen_api->mbox_accept, &recv_not_present);
+                if (lwesp_sys_mbox_putnow(&listen_api->mbox_accept, &recv_not_present)) {
+                    NETCONN_ACCEPT_INC(listen_api);
+                }
             }
+            break;
+        }
+#if LWESP_CFG_NETCONN_MUX
+        case LWESP_EVT_RESET_DETECTED: {        /* Device reset detected, connections are lost */
+            ++netconn_reset_cnt;
+            netconn_in_reset = 1;
+            break;
         }
+        case LWESP_EVT_RESET: {                 /* Reset sequence finished */
+            netconn_in_reset = 0;
+            break;
+        }
+#endif /* LWESP_CFG_NETCONN_MUX */
         default:
             break;
     }
@@ -273,32 +541,287 @@ lwesp_evt(lwesp_evt_t* evt) {
 }
 
 /**
- * \brief           Create new netconn connection
- * \param[in]       type: Netconn connection type
- * \return          New netconn connection on success, `NULL` otherwise
+ * \brief           Register global event function, only once
  */
-lwesp_netconn_p
-lwesp_netconn_new(lwesp_netconn_type_t type) {
-    lwesp_netconn_t* a;
+static void
+netconn_evt_register(void) {
     static uint8_t first = 1;
 
-    /* Register only once! */
     lwesp_core_lock();
     if (first) {
         first = 0;
-        lwesp_evt_register(lwesp_evt);          /* Register global event function */
+        lwesp_evt_register_ex(lwesp_evt,
+#if LWESP_CFG_MODE_STATION
+                              LWESP_EVT_MASK(LWESP_EVT_WIFI_DISCONNECTED) |
+#endif /* LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_NETCONN_MUX
+                              LWESP_EVT_MASK(LWESP_EVT_RESET_DETECTED) | LWESP_EVT_MASK(LWESP_EVT_RESET) |
+#endif /* LWESP_CFG_NETCONN_MUX */
+                              LWESP_EVT_MASK(LWESP_EVT_DEVICE_PRESENT));
+    }
+    lwesp_core_unlock();
+}
+
+#if LWESP_CFG_NETCONN_PREWARM || __DOXYGEN__
+
+/**
+ * \brief           State of pre-warmed connection entry
+ */
+typedef enum {
+    NETCONN_PREWARM_FREE = 0x00,                /*!< Entry is not used */
+    NETCONN_PREWARM_CLOSED,                     /*!< Entry is set for endpoint, connection is not open */
+    NETCONN_PREWARM_CONNECTING,                 /*!< Connection is being opened */
+    NETCONN_PREWARM_READY,                      /*!< Connection is open and idle, ready to be handed out */
+    NETCONN_PREWARM_CLOSING,                    /*!< Connection is being closed */
+} netconn_prewarm_state_t;
+
+/**
+ * \brief           Pre-warmed connection entry
+ */
+typedef struct {
+    netconn_prewarm_state_t state;              /*!< Entry state */
+    lwesp_netconn_type_t type;                  /*!< Connection type */
+    const char* host;                           /*!< Remote host */
+    lwesp_port_t port;                          /*!< Remote port */
+    lwesp_conn_p conn;                          /*!< Connection handle while open */
+    uint32_t time;                              /*!< Time when connection got ready */
+    uint8_t removed;                            /*!< Flag if entry is removed, freed once connection is closed */
+} netconn_prewarm_t;
+
+static netconn_prewarm_t prewarm[LWESP_CFG_NETCONN_PREWARM];    /*!< Pre-warmed connection entries */
+static lwesp_timeout_id_t prewarm_retry_id;     /*!< Timer to open connections again after failure */
+
+static lwespr_t netconn_prewarm_evt(lwesp_evt_t* evt);
+static void prewarm_refill(void);
+
+/**
+ * \brief           Timer callback to open failed pre-warmed connections again
+ * \param[in]       arg: Custom argument, unused
+ */
+static void
+prewarm_retry_cb(void* arg) {
+    LWESP_UNUSED(arg);
+    prewarm_retry_id = 0;
+    prewarm_refill();
+}
+
+/**
+ * \brief           Schedule retry of failed pre-warmed connections
+ * \note            Function must be called with core lock acquired
+ */
+static void
+prewarm_schedule_retry(void) {
+    if (prewarm_retry_id == 0) {
+        prewarm_retry_id = lwesp_timeout_addex(LWESP_CFG_NETCONN_PREWARM_RETRY_TIME, prewarm_retry_cb, NULL);
+    }
+}
+
+/**
+ * \brief           Start connection for every entry without open connection
+ * \note            Function must be called with core lock acquired
+ */
+static void
+prewarm_refill(void) {
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(prewarm); ++i) {
+        netconn_prewarm_t* e = &prewarm[i];
+
+        if (e->state == NETCONN_PREWARM_CLOSED) {
+            if (lwesp_conn_start(NULL, (lwesp_conn_type_t)e->type, e->host, e->port,
+                                 e, netconn_prewarm_evt, 0) == lwespOK) {
+                e->state = NETCONN_PREWARM_CONNECTING;
+            } else {
+                prewarm_schedule_retry();
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Close connection of pre-warmed entry
+ * \note            Function must be called with core lock acquired
+ * \param[in]       e: Entry in ready state
+ */
+static void
+prewarm_close(netconn_prewarm_t* e) {
+    e->state = NETCONN_PREWARM_CLOSING;
+    lwesp_conn_close(e->conn, 0);
+}
+
+/**
+ * \brief           Callback function for pre-warmed connections while idle
+ * \param[in]       evt: Pointer to callback structure
+ * \return          Member of \ref lwespr_t enumeration
+ */
+static lwespr_t
+netconn_prewarm_evt(lwesp_evt_t* evt) {
+    lwesp_conn_p conn;
+    netconn_prewarm_t* e;
+
+    switch (lwesp_evt_get_type(evt)) {
+        case LWESP_EVT_CONN_ACTIVE: {
+            conn = lwesp_conn_get_from_evt(evt);
+            e = lwesp_conn_get_arg(conn);
+            e->conn = conn;
+            e->time = lwesp_sys_now();
+            e->state = NETCONN_PREWARM_READY;
+            if (e->removed) {
+                prewarm_close(e);
+            }
+            break;
+        }
+        case LWESP_EVT_CONN_ERROR: {
+            e = lwesp_evt_conn_error_get_arg(evt);
+            if (e->removed) {
+                LWESP_MEMSET(e, 0x00, sizeof(*e));
+            } else if (e->state == NETCONN_PREWARM_CONNECTING) {
+                e->state = NETCONN_PREWARM_CLOSED;
+                prewarm_schedule_retry();       /* Try again later */
+            }
+            break;
+        }
+        case LWESP_EVT_CONN_RECV: {
+            /* Nothing is expected on idle connection, protocol state is unknown */
+            conn = lwesp_conn_get_from_evt(evt);
+            e = lwesp_conn_get_arg(conn);
+#if !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+            lwesp_conn_recved(conn, lwesp_evt_conn_recv_get_buff(evt));
+#endif /* !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+            if (e->state == NETCONN_PREWARM_READY) {
+                prewarm_close(e);
+            }
+            break;
+        }
+        case LWESP_EVT_CONN_POLL: {             /* Health check of idle connection */
+            conn = lwesp_conn_get_from_evt(evt);
+            e = lwesp_conn_get_arg(conn);
+            if (e->state == NETCONN_PREWARM_READY
+                && (!lwesp_conn_is_active(conn)
+                    || (LWESP_CFG_NETCONN_PREWARM_IDLE_TIME > 0
+                        && (lwesp_sys_now() - e->time) >= LWESP_CFG_NETCONN_PREWARM_IDLE_TIME))) {
+                prewarm_close(e);
+            }
+            break;
+        }
+        case LWESP_EVT_CONN_CLOSE: {
+            conn = lwesp_conn_get_from_evt(evt);
+            e = lwesp_conn_get_arg(conn);
+            if (e->removed) {
+                LWESP_MEMSET(e, 0x00, sizeof(*e));
+            } else {
+                /* Connection closed by remote side soon after open is not reopened immediately */
+                uint8_t early = e->state == NETCONN_PREWARM_READY
+                                && (lwesp_sys_now() - e->time) < LWESP_CFG_NETCONN_PREWARM_RETRY_TIME;
+
+                e->conn = NULL;
+                e->state = NETCONN_PREWARM_CLOSED;
+                if (early) {
+                    prewarm_schedule_retry();
+                } else {
+                    prewarm_refill();
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return lwespOK;
+}
+
+/**
+ * \brief           Hand out ready pre-warmed connection to netconn
+ * \param[in]       nc: Netconn handle to take over connection
+ * \param[in]       host: Remote host
+ * \param[in]       port: Remote port
+ * \return          `1` if connection has been handed out, `0` otherwise
+ */
+static uint8_t
+prewarm_take(lwesp_netconn_t* nc, const char* host, lwesp_port_t port) {
+    uint8_t taken = 0;
+
+    lwesp_core_lock();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(prewarm); ++i) {
+        netconn_prewarm_t* e = &prewarm[i];
+
+        if (e->state == NETCONN_PREWARM_READY && !e->removed && e->type == nc->type
+            && e->port == port && !strcmp(e->host, host) && lwesp_conn_is_active(e->conn)) {
+            nc->conn = e->conn;
+            nc->conn->evt_func = netconn_evt;   /* Further events go to netconn */
+            lwesp_conn_set_arg(nc->conn, nc);
+            e->conn = NULL;
+            e->state = NETCONN_PREWARM_CLOSED;
+            taken = 1;
+            break;
+        }
+    }
+    if (taken) {
+        prewarm_refill();                       /* Open replacement for taken connection */
+    }
+    lwesp_core_unlock();
+    return taken;
+}
+
+#endif /* LWESP_CFG_NETCONN_PREWARM || __DOXYGEN__ */
+
+#if LWESP_CFG_NETCONN_POOL
+
+/**
+ * \brief           Get free netconn entry from static pool
+ *
+ * Entry is reset, but its message boxes are kept from previous use
+ *
+ * \return          Pool entry on success, `NULL` if pool is exhausted
+ */
+static lwesp_netconn_t*
+netconn_pool_alloc(void) {
+    lwesp_netconn_t* a = NULL;
+    lwesp_sys_mbox_t mbox_accept, mbox_receive;
+
+    lwesp_core_lock();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(netconn_pool); ++i) {
+        if (!netconn_pool[i].pool_used) {
+            a = &netconn_pool[i];
+            mbox_accept = a->mbox_accept;
+            mbox_receive = a->mbox_receive;
+            LWESP_MEMSET(a, 0x00, sizeof(*a));
+            a->mbox_accept = mbox_accept;
+            a->mbox_receive = mbox_receive;
+            a->pool_used = 1;
+            break;
+        }
     }
     lwesp_core_unlock();
+    return a;
+}
+
+#endif /* LWESP_CFG_NETCONN_POOL */
+
+/**
+ * \brief           Create new netconn connection
+ * \param[in]       type: Netconn connection type
+ * \return          New netconn connection on success, `NULL` otherwise
+ */
+lwesp_netconn_p
+lwesp_netconn_new(lwesp_netconn_type_t type) {
+    lwesp_netconn_t* a;
+
+    netconn_evt_register();                     /* Register global event function */
+#if LWESP_CFG_NETCONN_POOL
+    a = netconn_pool_alloc();                   /* Get entry from static pool */
+#else /* LWESP_CFG_NETCONN_POOL */
     a = lwesp_mem_calloc(1, sizeof(*a));        /* Allocate memory for core object */
+#endif /* !LWESP_CFG_NETCONN_POOL */
     if (a != NULL) {
         a->type = type;                         /* Save netconn type */
         a->conn_timeout = 0;                    /* Default connection timeout */
-        if (!lwesp_sys_mbox_create(&a->mbox_accept, LWESP_CFG_NETCONN_ACCEPT_QUEUE_LEN)) {  /* Allocate memory for accepting message box */
+        if (!lwesp_sys_mbox_isvalid(&a->mbox_accept)    /* Pool entry may have message box already */
+            && !lwesp_sys_mbox_create(&a->mbox_accept, LWESP_CFG_NETCONN_ACCEPT_QUEUE_LEN)) {  /* Allocate memory for accepting message box */
             LWESP_DEBUGF(LWESP_CFG_DBG_NETCONN | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_DANGER,
                        "[NETCONN] Cannot create accept MBOX\r\n");
             goto free_ret;
         }
-        if (!lwesp_sys_mbox_create(&a->mbox_receive, LWESP_CFG_NETCONN_RECEIVE_QUEUE_LEN)) {/* Allocate memory for receiving message box */
+        if (!lwesp_sys_mbox_isvalid(&a->mbox_receive)
+            && !lwesp_sys_mbox_create(&a->mbox_receive, LWESP_CFG_NETCONN_RECEIVE_QUEUE_LEN)) {/* Allocate memory for receiving message box */
             LWESP_DEBUGF(LWESP_CFG_DBG_NETCONN | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_DANGER,
                        "[NETCONN] Cannot create receive MBOX\r\n");
             goto free_ret;
@@ -314,6 +837,11 @@ lwesp_netconn_new(lwesp_netconn_type_t type) {
     }
     return a;
 free_ret:
+#if LWESP_CFG_NETCONN_POOL
+    lwesp_core_lock();
+    a->pool_used = 0;                           /* Valid message box is kept for next use */
+    lwesp_core_unlock();
+#else /* LWESP_CFG_NETCONN_POOL */
     if (lwesp_sys_mbox_isvalid(&a->mbox_accept)) {
         lwesp_sys_mbox_delete(&a->mbox_accept);
         lwesp_sys_mbox_invalid(&a->mbox_accept);
@@ -325,6 +853,7 @@ free_ret:
     if (a != NULL) {
         lwesp_mem_free_s((void**)&a);
     }
+#endif /* !LWESP_CFG_NETCONN_POOL */
     return NULL;
 }
 
@@ -337,6 +866,28 @@ lwespr_t
 lwesp_netconn_delete(lwesp_netconn_p nc) {
     LWESP_ASSERT("netconn != NULL", nc != NULL);
 
+    /* Delete preallocated netconns of listening netconn */
+    nc->spare_target = 0;
+    while (1) {
+        lwesp_netconn_t* spare;
+
+        lwesp_core_lock();
+        if ((spare = nc->spare) != NULL) {
+            nc->spare = spare->spare_next;
+            --nc->spare_cnt;
+        }
+        lwesp_core_unlock();
+        if (spare == NULL) {
+            break;
+        }
+        lwesp_netconn_delete(spare);
+    }
+
+#if LWESP_CFG_NETCONN_SELECT
+    if (nc->set != NULL) {
+        lwesp_netconn_set_remove(nc->set, nc);  /* Remove from set before it is freed */
+    }
+#endif /* LWESP_CFG_NETCONN_SELECT */
     lwesp_core_lock();
     flush_mboxes(nc, 0);                        /* Clear mboxes */
 
@@ -362,14 +913,23 @@ lwesp_netconn_delete(lwesp_netconn_p nc) {
             }
         }
     }
+#if LWESP_CFG_NETCONN_POOL
+    nc->pool_used = 0;                          /* Return entry to pool, message boxes are kept */
+    lwesp_core_unlock();
+#else /* LWESP_CFG_NETCONN_POOL */
     lwesp_core_unlock();
 
     lwesp_mem_free_s((void**)&nc);
+#endif /* !LWESP_CFG_NETCONN_POOL */
     return lwespOK;
 }
 
 /**
  * \brief           Connect to server as client
+ *
+ * When \ref LWESP_CFG_NETCONN_PREWARM is enabled and idle connection
+ * to the same endpoint is ready, it is used instead of opening a new one
+ *
  * \param[in]       nc: Netconn handle
  * \param[in]       host: Pointer to host, such as domain name or IP address in string format
  * \param[in]       port: Target port to use
@@ -383,6 +943,12 @@ lwesp_netconn_connect(lwesp_netconn_p nc, const char* host, lwesp_port_t port) {
     LWESP_ASSERT("host != NULL", host != NULL);
     LWESP_ASSERT("port > 0", port > 0);
 
+#if LWESP_CFG_NETCONN_PREWARM
+    if (prewarm_take(nc, host, port)) {         /* Use already open connection */
+        return lwespOK;
+    }
+#endif /* LWESP_CFG_NETCONN_PREWARM */
+
     /*
      * Start a new connection as client and:
      *
@@ -521,26 +1087,87 @@ lwesp_netconn_listen_with_max_conn(lwesp_netconn_p nc, uint16_t max_connections)
 }
 
 /**
- * \brief           Accept a new connection
+ * \brief           Allocate netconns to keep number of preallocated netconns at target value
+ * \param[in]       nc: Listening netconn handle
+ */
+static void
+netconn_spare_refill(lwesp_netconn_t* nc) {
+    lwesp_netconn_t* spare;
+
+    while (1) {
+        lwesp_core_lock();
+        if (nc->spare_cnt >= nc->spare_target) {
+            lwesp_core_unlock();
+            break;
+        }
+        lwesp_core_unlock();
+
+        /* Allocate outside of lock, may take time */
+        if ((spare = lwesp_netconn_new(LWESP_NETCONN_TYPE_TCP)) == NULL) {
+            break;
+        }
+        lwesp_core_lock();
+        spare->spare_next = nc->spare;
+        nc->spare = spare;
+        ++nc->spare_cnt;
+        lwesp_core_unlock();
+    }
+}
+
+/**
+ * \brief           Set number of netconns preallocated for incoming clients of listening netconn
+ *
+ * Incoming connection takes preallocated netconn instead of allocating memory
+ * and creating message boxes in processing thread.
+ * List is refilled from accept functions, in application thread.
+ *
+ * \note            Call this function before you put connection to listen mode with \ref lwesp_netconn_listen
+ * \param[in]       nc: Netconn handle used for listening
+ * \param[in]       count: Number of netconns to keep preallocated. Set to `0` to disable
+ * \return          \ref lwespOK on success, \ref lwespERRMEM if not all netconns could be allocated
+ */
+lwespr_t
+lwesp_netconn_set_accept_prealloc(lwesp_netconn_p nc, size_t count) {
+    LWESP_ASSERT("nc != NULL", nc != NULL);
+    LWESP_ASSERT("nc->type must be TCP", nc->type == LWESP_NETCONN_TYPE_TCP);
+
+    nc->spare_target = count;
+    netconn_spare_refill(nc);
+    return nc->spare_cnt >= count ? lwespOK : lwespERRMEM;
+}
+
+/**
+ * \brief           Get next netconn from accept queue
  * \param[in]       nc: Netconn handle used as base connection to accept new clients
  * \param[out]      client: Pointer to netconn handle to save new connection to
+ * \param[in]       block: Set to `1` to wait for new client, `0` to return immediately
  * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
  */
-lwespr_t
-lwesp_netconn_accept(lwesp_netconn_p nc, lwesp_netconn_p* client) {
+static lwespr_t
+netconn_accept_get(lwesp_netconn_t* nc, lwesp_netconn_t** client, uint8_t block) {
     lwesp_netconn_t* tmp;
-    uint32_t time;
-
-    LWESP_ASSERT("nc != NULL", nc != NULL);
-    LWESP_ASSERT("client != NULL", client != NULL);
-    LWESP_ASSERT("nc->type must be TCP", nc->type == LWESP_NETCONN_TYPE_TCP);
-    LWESP_ASSERT("nc == listen_api", nc == listen_api);
+    lwespr_t res;
 
     *client = NULL;
-    time = lwesp_sys_mbox_get(&nc->mbox_accept, (void**)&tmp, 0);
-    if (time == LWESP_SYS_TIMEOUT) {
+    if (nc->accept_err != lwespOK) {            /* Report error received during batched accept */
+        res = nc->accept_err;
+        nc->accept_err = lwespOK;
+        return res;
+    }
+    if (block) {
+        if (lwesp_sys_mbox_get(&nc->mbox_accept, (void**)&tmp, 0) == LWESP_SYS_TIMEOUT) {
+            return lwespTIMEOUT;
+        }
+    } else if (!lwesp_sys_mbox_getnow(&nc->mbox_accept, (void**)&tmp)) {
         return lwespTIMEOUT;
     }
+#if LWESP_CFG_NETCONN_SELECT
+    lwesp_core_lock();
+    if (nc->mbox_accept_entries > 0) {
+        --nc->mbox_accept_entries;
+    }
+    lwesp_core_unlock();
+#endif /* LWESP_CFG_NETCONN_SELECT */
     if ((uint8_t*)tmp == (uint8_t*)&recv_closed) {
         lwesp_core_lock();
         listen_api = NULL;                      /* Disable listening at this point */
@@ -557,23 +1184,85 @@ lwesp_netconn_accept(lwesp_netconn_p nc, lwesp_netconn_p* client) {
 }
 
 /**
- * \brief           Write data to connection output buffers
- * \note            This function may only be used on TCP or SSL connections
- * \param[in]       nc: Netconn handle used to write data to
- * \param[in]       data: Pointer to data to write
- * \param[in]       btw: Number of bytes to write
+ * \brief           Accept a new connection
+ * \param[in]       nc: Netconn handle used as base connection to accept new clients
+ * \param[out]      client: Pointer to netconn handle to save new connection to
  * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
  */
 lwespr_t
-lwesp_netconn_write(lwesp_netconn_p nc, const void* data, size_t btw) {
-    size_t len, sent;
-    const uint8_t* d = data;
+lwesp_netconn_accept(lwesp_netconn_p nc, lwesp_netconn_p* client) {
     lwespr_t res;
 
     LWESP_ASSERT("nc != NULL", nc != NULL);
-    LWESP_ASSERT("nc->type must be TCP or SSL", nc->type == LWESP_NETCONN_TYPE_TCP || nc->type == LWESP_NETCONN_TYPE_SSL);
-    LWESP_ASSERT("nc->conn must be active", lwesp_conn_is_active(nc->conn));
-
+    LWESP_ASSERT("client != NULL", client != NULL);
+    LWESP_ASSERT("nc->type must be TCP", nc->type == LWESP_NETCONN_TYPE_TCP);
+    LWESP_ASSERT("nc == listen_api", nc == listen_api || nc->accept_err != lwespOK);
+
+    res = netconn_accept_get(nc, client, 1);
+    netconn_spare_refill(nc);
+    return res;
+}
+
+/**
+ * \brief           Accept multiple new connections at a time
+ *
+ * Function waits for first client and then takes all clients
+ * waiting in accept queue, up to `max_clients`.
+ *
+ * \param[in]       nc: Netconn handle used as base connection to accept new clients
+ * \param[out]      clients: Array to save new connection handles to
+ * \param[in]       max_clients: Number of entries in `clients` array
+ * \param[out]      cnt: Pointer to output variable to save number of accepted clients
+ * \return          \ref lwespOK when at least one client is accepted, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_accept_many(lwesp_netconn_p nc, lwesp_netconn_p* clients, size_t max_clients, size_t* cnt) {
+    lwespr_t res;
+    size_t i;
+
+    LWESP_ASSERT("nc != NULL", nc != NULL);
+    LWESP_ASSERT("clients != NULL", clients != NULL);
+    LWESP_ASSERT("max_clients > 0", max_clients > 0);
+    LWESP_ASSERT("cnt != NULL", cnt != NULL);
+    LWESP_ASSERT("nc->type must be TCP", nc->type == LWESP_NETCONN_TYPE_TCP);
+    LWESP_ASSERT("nc == listen_api", nc == listen_api || nc->accept_err != lwespOK);
+
+    *cnt = 0;
+    if ((res = netconn_accept_get(nc, &clients[0], 1)) == lwespOK) {
+        for (i = 1; i < max_clients; ++i) {
+            res = netconn_accept_get(nc, &clients[i], 0);
+            if (res != lwespOK) {
+                if (res != lwespTIMEOUT) {
+                    nc->accept_err = res;       /* Report listening error on next call */
+                }
+                break;
+            }
+        }
+        *cnt = i;
+        res = lwespOK;
+    }
+    netconn_spare_refill(nc);
+    return res;
+}
+
+/**
+ * \brief           Write data to connection output buffers
+ * \note            This function may only be used on TCP or SSL connections
+ * \param[in]       nc: Netconn handle used to write data to
+ * \param[in]       data: Pointer to data to write
+ * \param[in]       btw: Number of bytes to write
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_write(lwesp_netconn_p nc, const void* data, size_t btw) {
+    size_t len, sent, max_len = lwesp_conn_get_max_data_len();
+    const uint8_t* d = data;
+    lwespr_t res;
+
+    LWESP_ASSERT("nc != NULL", nc != NULL);
+    LWESP_ASSERT("nc->type must be TCP or SSL", nc->type == LWESP_NETCONN_TYPE_TCP || nc->type == LWESP_NETCONN_TYPE_SSL);
+    LWESP_ASSERT("nc->conn must be active", lwesp_conn_is_active(nc->conn));
+
     /*
      * Several steps are done in write process
      *
@@ -598,7 +1287,8 @@ lwesp_netconn_write(lwesp_netconn_p nc, const void* data, size_t btw) {
         if (nc->buff.ptr == nc->buff.len) {
             res = lwesp_conn_send(nc->conn, nc->buff.buff, nc->buff.len, &sent, 1);
 
-            lwesp_mem_free_s((void**)&nc->buff.buff);
+            lwespi_conn_buff_free(nc->buff.buff);
+            nc->buff.buff = NULL;
             if (res != lwespOK) {
                 return res;
             }
@@ -608,9 +1298,9 @@ lwesp_netconn_write(lwesp_netconn_p nc, const void* data, size_t btw) {
     }
 
     /* Step 2 */
-    if (btw >= LWESP_CFG_CONN_MAX_DATA_LEN) {
+    if (btw >= max_len) {
         size_t rem;
-        rem = btw % LWESP_CFG_CONN_MAX_DATA_LEN;/* Get remaining bytes for max data length */
+        rem = btw % max_len;                    /* Get remaining bytes for max data length */
         res = lwesp_conn_send(nc->conn, d, btw - rem, &sent, 1);/* Write data directly */
         if (res != lwespOK) {
             return res;
@@ -625,8 +1315,8 @@ lwesp_netconn_write(lwesp_netconn_p nc, const void* data, size_t btw) {
 
     /* Step 3 */
     if (nc->buff.buff == NULL) {                /* Check if we should allocate a new buffer */
-        nc->buff.buff = lwesp_mem_malloc(sizeof(*nc->buff.buff) * LWESP_CFG_CONN_MAX_DATA_LEN);
-        nc->buff.len = LWESP_CFG_CONN_MAX_DATA_LEN; /* Save buffer length */
+        nc->buff.buff = lwespi_conn_buff_alloc(max_len);
+        nc->buff.len = max_len;                 /* Save buffer length */
         nc->buff.ptr = 0;                       /* Save buffer pointer */
     }
 
@@ -652,6 +1342,16 @@ lwesp_netconn_flush(lwesp_netconn_p nc) {
     LWESP_ASSERT("nc->type must be TCP or SSL", nc->type == LWESP_NETCONN_TYPE_TCP || nc->type == LWESP_NETCONN_TYPE_SSL);
     LWESP_ASSERT("nc->conn must be active", lwesp_conn_is_active(nc->conn));
 
+#if LWESP_CFG_NETCONN_WRITE_NONBLOCK
+    if (nc->write_nonblock) {                   /* Queue connection write buffer without waiting */
+        lwespr_t res;
+        lwesp_core_lock();
+        res = lwesp_conn_write(nc->conn, NULL, 0, 1, NULL);
+        lwesp_core_unlock();
+        return res;
+    }
+#endif /* LWESP_CFG_NETCONN_WRITE_NONBLOCK */
+
     /*
      * In case we have data in write buffer,
      * flush them out to network
@@ -660,11 +1360,90 @@ lwesp_netconn_flush(lwesp_netconn_p nc) {
         if (nc->buff.ptr > 0) {                 /* Do we have data in current buffer? */
             lwesp_conn_send(nc->conn, nc->buff.buff, nc->buff.ptr, NULL, 1);/* Send data */
         }
-        lwesp_mem_free_s((void**)&nc->buff.buff);
+        lwespi_conn_buff_free(nc->buff.buff);
+        nc->buff.buff = NULL;
     }
     return lwespOK;
 }
 
+#if LWESP_CFG_NETCONN_WRITE_NONBLOCK || __DOXYGEN__
+
+/**
+ * \brief           Write data to connection without waiting for send to finish
+ *
+ * Data are copied to connection write buffer and queued for send in non-blocking way.
+ * At most \ref LWESP_CFG_NETCONN_WRITE_BUDGET bytes may be queued and not yet sent at a time.
+ * Use \ref lwesp_netconn_flush to queue remaining buffered data.
+ *
+ * \note            This function may only be used on TCP or SSL connections.
+ *                  Do not mix it with \ref lwesp_netconn_write on the same netconn
+ * \param[in]       nc: Netconn handle used to write data to
+ * \param[in]       data: Pointer to data to write
+ * \param[in]       btw: Number of bytes to write
+ * \param[out]      bw: Pointer to output variable to save number of bytes accepted. Can be set to `NULL`
+ * \return          \ref lwespOK when all data were accepted
+ * \return          \ref lwespINPROG when only part of data (or none) were accepted as write budget is full.
+ *                  Netconn in select set is notified when budget becomes available
+ * \return          Any other member of \ref lwespr_t otherwise
+ */
+lwespr_t
+lwesp_netconn_write_nonblock(lwesp_netconn_p nc, const void* data, size_t btw, size_t* const bw) {
+    size_t len;
+    lwespr_t res = lwespOK;
+
+    LWESP_ASSERT("nc != NULL", nc != NULL);
+    LWESP_ASSERT("nc->type must be TCP or SSL", nc->type == LWESP_NETCONN_TYPE_TCP || nc->type == LWESP_NETCONN_TYPE_SSL);
+    LWESP_ASSERT("nc->conn must be active", lwesp_conn_is_active(nc->conn));
+
+    if (bw != NULL) {
+        *bw = 0;
+    }
+
+    lwesp_core_lock();
+    nc->write_nonblock = 1;
+    if (nc->write_err != lwespOK) {             /* Report previous send failure */
+        res = nc->write_err;
+        nc->write_err = lwespOK;
+        lwesp_core_unlock();
+        return res;
+    }
+    len = LWESP_MIN(btw, LWESP_CFG_NETCONN_WRITE_BUDGET - LWESP_MIN(nc->write_pending, LWESP_CFG_NETCONN_WRITE_BUDGET));
+    if (len > 0) {
+        res = lwesp_conn_write(nc->conn, data, len, 0, NULL);
+        if (res == lwespOK) {
+            nc->write_pending += len;
+            if (bw != NULL) {
+                *bw = len;
+            }
+        }
+    }
+    nc->write_wait = res == lwespOK && len < btw;   /* Wait for budget to write the rest */
+    lwesp_core_unlock();
+    if (res == lwespOK && len < btw) {
+        res = lwespINPROG;
+    }
+    return res;
+}
+
+/**
+ * \brief           Get number of bytes non-blocking write can accept at the moment
+ * \param[in]       nc: Netconn handle
+ * \return          Number of bytes available in write budget
+ */
+size_t
+lwesp_netconn_get_write_available(lwesp_netconn_p nc) {
+    size_t len = 0;
+
+    if (nc != NULL) {
+        lwesp_core_lock();
+        len = LWESP_CFG_NETCONN_WRITE_BUDGET - LWESP_MIN(nc->write_pending, LWESP_CFG_NETCONN_WRITE_BUDGET);
+        lwesp_core_unlock();
+    }
+    return len;
+}
+
+#endif /* LWESP_CFG_NETCONN_WRITE_NONBLOCK || __DOXYGEN__ */
+
 /**
  * \brief           Send data on UDP connection to default IP and port
  * \param[in]       nc: Netconn handle used to send
@@ -700,6 +1479,91 @@ lwesp_netconn_sendto(lwesp_netconn_p nc, const lwesp_ip_t* ip, lwesp_port_t port
     return lwesp_conn_sendto(nc->conn, ip, port, data, btw, NULL, 1);
 }
 
+/**
+ * \brief           Send multiple datagrams on UDP connection with single queue write
+ *
+ * Datagrams are recorded to a batch and sent back-to-back by producer thread.
+ * Function returns once all datagrams are processed.
+ *
+ * \note            This function may only be used on UDP connections
+ * \param[in]       nc: Netconn handle used to send
+ * \param[in]       dgrams: Array of datagrams to send
+ * \param[in]       cnt: Number of datagrams in array
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_sendto_many(lwesp_netconn_p nc, const lwesp_netconn_dgram_t* dgrams, size_t cnt) {
+    lwesp_batch_t batch;
+    lwespr_t res = lwespOK;
+
+    LWESP_ASSERT("nc != NULL", nc != NULL);
+    LWESP_ASSERT("dgrams != NULL", dgrams != NULL);
+    LWESP_ASSERT("nc->type must be UDP", nc->type == LWESP_NETCONN_TYPE_UDP);
+    LWESP_ASSERT("nc->conn must be active", lwesp_conn_is_active(nc->conn));
+
+    if ((res = lwesp_batch_begin(&batch)) != lwespOK) {
+        return res;
+    }
+    for (size_t i = 0; i < cnt && res == lwespOK; ++i) {
+        if (dgrams[i].ip != NULL) {
+            res = lwesp_conn_sendto(nc->conn, dgrams[i].ip, dgrams[i].port, dgrams[i].data, dgrams[i].len, NULL, 0);
+        } else {
+            res = lwesp_conn_send(nc->conn, dgrams[i].data, dgrams[i].len, NULL, 0);
+        }
+    }
+    if (res != lwespOK) {
+        lwesp_batch_submit(&batch, NULL, NULL, 1);  /* Send datagrams recorded so far */
+        return res;
+    }
+    return lwesp_batch_submit(&batch, NULL, NULL, 1);
+}
+
+/**
+ * \brief           Process packet buffer taken from receive queue
+ * \param[in]       nc: Netconn handle
+ * \param[in,out]   pbuf: Pointer to received packet buffer. Set to `NULL` when connection closed
+ * \return          \ref lwespOK for valid data, \ref lwespCLOSED when connection closed,
+ *                  \ref lwespTIMEOUT when idle deadline expired
+ */
+static lwespr_t
+netconn_receive_dequeued(lwesp_netconn_t* nc, lwesp_pbuf_p* pbuf) {
+    lwesp_core_lock();
+    if (nc->mbox_receive_entries > 0) {
+        --nc->mbox_receive_entries;
+    }
+#if LWESP_CFG_NETCONN_DEADLINE
+    if ((uint8_t*)(*pbuf) == (uint8_t*)&recv_deadline) {
+        nc->deadline_posted = 0;
+        lwesp_core_unlock();
+        *pbuf = NULL;
+        return lwespTIMEOUT;                    /* Idle deadline expired */
+    }
+#endif /* LWESP_CFG_NETCONN_DEADLINE */
+    if ((uint8_t*)(*pbuf) != (uint8_t*)&recv_closed) {
+        nc->mbox_receive_bytes -= LWESP_MIN(nc->mbox_receive_bytes, lwesp_pbuf_length(*pbuf, 1));
+    }
+    lwesp_core_unlock();
+
+    /* Check if connection closed */
+    if ((uint8_t*)(*pbuf) == (uint8_t*)&recv_closed) {
+        *pbuf = NULL;                           /* Reset pbuf */
+        return lwespCLOSED;
+    }
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+    else {
+        lwesp_core_lock();
+        /* Resume reading once queue drops below low watermark */
+        if (nc->mbox_receive_entries < (LWESP_CFG_NETCONN_RECEIVE_QUEUE_LEN - 1)
+            && nc->mbox_receive_bytes <= LWESP_CFG_NETCONN_RECEIVE_LOW_WATERMARK) {
+            nc->conn->status.f.receive_blocked = 0;
+        }
+        lwesp_conn_recved(nc->conn, *pbuf);     /* Notify stack about received data */
+        lwesp_core_unlock();
+    }
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+    return lwespOK;                             /* We have data available */
+}
+
 /**
  * \brief           Receive data from connection
  * \param[in]       nc: Netconn handle used to receive from
@@ -716,6 +1580,9 @@ lwesp_netconn_receive(lwesp_netconn_p nc, lwesp_pbuf_p* pbuf) {
     LWESP_ASSERT("pbuf != NULL", pbuf != NULL);
 
     *pbuf = NULL;
+    if (nc->rd_closed) {                        /* Closed event was already taken from queue */
+        return lwespCLOSED;
+    }
 #if LWESP_CFG_NETCONN_RECEIVE_TIMEOUT
     /*
      * Wait for new received data for up to specific timeout
@@ -732,27 +1599,121 @@ lwesp_netconn_receive(lwesp_netconn_p nc, lwesp_pbuf_p* pbuf) {
     /* Forever wait for new receive packet */
     lwesp_sys_mbox_get(&nc->mbox_receive, (void**)pbuf, 0);
 #endif /* !LWESP_CFG_NETCONN_RECEIVE_TIMEOUT */
+    return netconn_receive_dequeued(nc, pbuf);
+}
 
-    lwesp_core_lock();
-    if (nc->mbox_receive_entries > 0) {
-        --nc->mbox_receive_entries;
+/**
+ * \brief           Receive multiple packets from connection at a time
+ *
+ * Function waits for first packet, the same way as \ref lwesp_netconn_receive,
+ * and then takes all packets already waiting in receive queue, up to `max_pbufs`.
+ * For UDP, remote IP and port of every datagram are available in its packet buffer,
+ * see \ref lwesp_pbuf_get_ip
+ *
+ * \param[in]       nc: Netconn handle used to receive from
+ * \param[out]      pbufs: Array to save received packet buffers to
+ * \param[in]       max_pbufs: Number of entries in `pbufs` array
+ * \param[out]      cnt: Pointer to output variable to save number of received packet buffers
+ * \return          \ref lwespOK when at least one packet is received
+ * \return          \ref lwespCLOSED when connection closed by remote side
+ * \return          \ref lwespTIMEOUT when receive timeout occurs
+ * \return          Any other member of \ref lwespr_t otherwise
+ */
+lwespr_t
+lwesp_netconn_receive_many(lwesp_netconn_p nc, lwesp_pbuf_p* pbufs, size_t max_pbufs, size_t* cnt) {
+    lwespr_t res;
+    size_t i;
+
+    LWESP_ASSERT("nc != NULL", nc != NULL);
+    LWESP_ASSERT("pbufs != NULL", pbufs != NULL);
+    LWESP_ASSERT("max_pbufs > 0", max_pbufs > 0);
+    LWESP_ASSERT("cnt != NULL", cnt != NULL);
+
+    *cnt = 0;
+    if ((res = lwesp_netconn_receive(nc, &pbufs[0])) != lwespOK) {
+        return res;
     }
-    lwesp_core_unlock();
+    for (i = 1; i < max_pbufs; ++i) {
+        if (!lwesp_sys_mbox_getnow(&nc->mbox_receive, (void**)&pbufs[i])) {
+            break;
+        }
+        if ((res = netconn_receive_dequeued(nc, &pbufs[i])) != lwespOK) {
+            if (res == lwespCLOSED) {
+                nc->rd_closed = 1;              /* Report closed state on next receive */
+            }
+            break;
+        }
+    }
+    *cnt = i;
+    return lwespOK;
+}
 
-    /* Check if connection closed */
-    if ((uint8_t*)(*pbuf) == (uint8_t*)&recv_closed) {
-        *pbuf = NULL;                           /* Reset pbuf */
-        return lwespCLOSED;
+/**
+ * \brief           Read received data from connection to user buffer
+ *
+ * Data are copied from received packet buffers as a byte stream.
+ * Packet buffer is freed once all its data have been read,
+ * remaining bytes stay available for next call.
+ *
+ * \note            Function blocks until at least `min_len` bytes are read.
+ *                  Receive timeout, when set, applies for every received packet while waiting
+ * \note            Do not mix it with \ref lwesp_netconn_receive while read data are pending
+ * \param[in]       nc: Netconn handle used to read from
+ * \param[out]      buf: Buffer to copy data to
+ * \param[in]       len: Size of buffer in units of bytes
+ * \param[in]       min_len: Minimal number of bytes to read before function returns.
+ *                      Set to `0` or `1` to return as soon as any data are available
+ * \param[out]      br: Pointer to output variable to save number of bytes read. Can be set to `NULL`
+ * \return          \ref lwespOK when at least `min_len` bytes were read
+ * \return          \ref lwespCLOSED when connection closed by remote side before enough data were read
+ * \return          \ref lwespTIMEOUT when receive timeout occurs
+ * \return          Any other member of \ref lwespr_t otherwise
+ */
+lwespr_t
+lwesp_netconn_read(lwesp_netconn_p nc, void* buf, size_t len, size_t min_len, size_t* br) {
+    uint8_t* d = buf;
+    size_t copied = 0, tot_len, cnt;
+    lwespr_t res = lwespOK;
+
+    LWESP_ASSERT("nc != NULL", nc != NULL);
+    LWESP_ASSERT("buf != NULL", buf != NULL);
+    LWESP_ASSERT("len > 0", len > 0);
+
+    min_len = LWESP_MIN(LWESP_MAX(min_len, 1), len);
+    while (copied < len) {
+        /* Get next packet when current one is consumed */
+        if (nc->rd_pbuf == NULL) {
+            if (copied >= min_len) {            /* Do not wait if enough data were read already */
+                break;
+            }
+            if (nc->rd_closed) {
+                res = lwespCLOSED;
+                break;
+            }
+            if ((res = lwesp_netconn_receive(nc, &nc->rd_pbuf)) != lwespOK) {
+                if (res == lwespCLOSED) {
+                    nc->rd_closed = 1;          /* Closed state is reported to every next read */
+                }
+                break;
+            }
+            nc->rd_off = 0;
+        }
+
+        /* Copy data from current packet buffer */
+        tot_len = lwesp_pbuf_length(nc->rd_pbuf, 1);
+        cnt = lwesp_pbuf_copy(nc->rd_pbuf, &d[copied], len - copied, nc->rd_off);
+        copied += cnt;
+        nc->rd_off += cnt;
+        if (nc->rd_off >= tot_len) {            /* Everything read, release packet buffer */
+            lwesp_pbuf_free(nc->rd_pbuf);
+            nc->rd_pbuf = NULL;
+            nc->rd_off = 0;
+        }
     }
-#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
-    else {
-        lwesp_core_lock();
-        nc->conn->status.f.receive_blocked = 0; /* Resume reading more data */
-        lwesp_conn_recved(nc->conn, *pbuf);     /* Notify stack about received data */
-        lwesp_core_unlock();
+    if (br != NULL) {
+        *br = copied;
     }
-#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
-    return lwespOK;                             /* We have data available */
+    return copied >= min_len ? lwespOK : res;
 }
 
 /**
@@ -823,6 +1784,33 @@ lwesp_netconn_get_receive_timeout(lwesp_netconn_p nc) {
 
 #endif /* LWESP_CFG_NETCONN_RECEIVE_TIMEOUT || __DOXYGEN__ */
 
+#if LWESP_CFG_NETCONN_DEADLINE || __DOXYGEN__
+
+/**
+ * \brief           Set idle deadline for netconn
+ *
+ * When no data are received or sent for `idle_time`, receive function
+ * returns \ref lwespTIMEOUT, without timed wait in receiving thread.
+ * Deadline is moved on every traffic and is reported again after every next idle period.
+ * All deadlines are served by single stack timer, scheduled for nearest one.
+ *
+ * \param[in]       nc: Netconn handle
+ * \param[in]       idle_time: Idle time in units of milliseconds. Set to `0` to disable deadline
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_set_idle_deadline(lwesp_netconn_p nc, uint32_t idle_time) {
+    LWESP_ASSERT("nc != NULL", nc != NULL);
+
+    lwesp_core_lock();
+    nc->idle_time = idle_time;
+    netconn_deadline_restart(nc);
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_NETCONN_DEADLINE || __DOXYGEN__ */
+
 /**
  * \brief           Get netconn connection handle
  * \param[in]       nc: Netconn handle
@@ -833,4 +1821,486 @@ lwesp_netconn_get_conn(lwesp_netconn_p nc) {
     return nc->conn;
 }
 
+#if LWESP_CFG_NETCONN_SELECT || __DOXYGEN__
+
+/**
+ * \brief           Create new netconn set to wait on multiple netconns from single thread
+ * \return          New set handle on success, `NULL` otherwise
+ */
+lwesp_netconn_set_p
+lwesp_netconn_set_new(void) {
+    lwesp_netconn_set_t* set;
+
+    set = lwesp_mem_calloc(1, sizeof(*set));
+    if (set != NULL) {
+        if (!lwesp_sys_sem_create(&set->sem, 0)) {  /* Semaphore is taken until first event */
+            LWESP_DEBUGF(LWESP_CFG_DBG_NETCONN | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_DANGER,
+                       "[NETCONN] Cannot create set semaphore\r\n");
+            lwesp_mem_free_s((void**)&set);
+        }
+    }
+    return set;
+}
+
+/**
+ * \brief           Delete netconn set
+ * \note            Netconns in set are removed from it, but are not closed or deleted
+ * \param[in]       set: Set handle
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_set_delete(lwesp_netconn_set_p set) {
+    lwesp_netconn_t* nc;
+
+    LWESP_ASSERT("set != NULL", set != NULL);
+
+    lwesp_core_lock();
+    for (nc = set->first; nc != NULL; ) {
+        lwesp_netconn_t* next = nc->set_next;
+        nc->set = NULL;
+        nc->set_next = NULL;
+        nc = next;
+    }
+    set->first = NULL;
+    lwesp_core_unlock();
+
+    lwesp_sys_sem_delete(&set->sem);
+    lwesp_sys_sem_invalid(&set->sem);
+    lwesp_mem_free_s((void**)&set);
+    return lwespOK;
+}
+
+/**
+ * \brief           Add netconn to set
+ * \note            Netconn may be part of one set at a time
+ * \param[in]       set: Set handle
+ * \param[in]       nc: Netconn handle to add
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_set_add(lwesp_netconn_set_p set, lwesp_netconn_p nc) {
+    lwespr_t res = lwespOK;
+
+    LWESP_ASSERT("set != NULL", set != NULL);
+    LWESP_ASSERT("nc != NULL", nc != NULL);
+
+    lwesp_core_lock();
+    if (nc->set == NULL) {
+        nc->set = set;
+        nc->set_next = set->first;              /* Add it to beginning of the list */
+        set->first = nc;
+    } else if (nc->set != set) {
+        res = lwespERR;                         /* Netconn is already part of other set */
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Remove netconn from set
+ * \param[in]       set: Set handle
+ * \param[in]       nc: Netconn handle to remove
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_set_remove(lwesp_netconn_set_p set, lwesp_netconn_p nc) {
+    lwesp_netconn_t** curr;
+
+    LWESP_ASSERT("set != NULL", set != NULL);
+    LWESP_ASSERT("nc != NULL", nc != NULL);
+
+    lwesp_core_lock();
+    for (curr = &set->first; *curr != NULL; curr = &(*curr)->set_next) {
+        if (*curr == nc) {
+            *curr = nc->set_next;               /* Unlink netconn from set */
+            nc->set = NULL;
+            nc->set_next = NULL;
+            break;
+        }
+    }
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+/**
+ * \brief           Check if netconn has data or new client waiting
+ *
+ * When function returns `1`, next call to \ref lwesp_netconn_receive
+ * or \ref lwesp_netconn_accept for listening netconn, will not block.
+ * With non-blocking write, it also returns `1` when netconn waits
+ * for write budget and the budget became available
+ *
+ * \param[in]       nc: Netconn handle
+ * \return          `1` if netconn is ready, `0` otherwise
+ */
+uint8_t
+lwesp_netconn_is_ready(lwesp_netconn_p nc) {
+    uint8_t ready;
+
+    lwesp_core_lock();
+    ready = nc != NULL && (nc->mbox_receive_entries > 0 || nc->mbox_accept_entries > 0 || NETCONN_IS_WRITABLE(nc));
+    lwesp_core_unlock();
+    return ready;
+}
+
+/**
+ * \brief           Wait for at least one netconn in set to become ready
+ *
+ * Use \ref lwesp_netconn_is_ready on every netconn in set
+ * to find which are ready for receive or accept.
+ *
+ * \param[in]       set: Set handle
+ * \param[in]       timeout: Maximal time to wait in units of milliseconds.
+ *                      Set to `0` to wait forever, or \ref LWESP_NETCONN_RECEIVE_NO_WAIT for no wait
+ * \return          \ref lwespOK when at least one netconn is ready
+ * \return          \ref lwespTIMEOUT when timeout occurs
+ */
+lwespr_t
+lwesp_netconn_select(lwesp_netconn_set_p set, uint32_t timeout) {
+    lwesp_netconn_t* nc;
+    uint32_t start, elapsed, wait;
+    uint8_t ready;
+
+    LWESP_ASSERT("set != NULL", set != NULL);
+
+    start = lwesp_sys_now();
+    while (1) {
+        ready = 0;
+        lwesp_core_lock();
+        for (nc = set->first; nc != NULL; nc = nc->set_next) {
+            if (nc->mbox_receive_entries > 0 || nc->mbox_accept_entries > 0 || NETCONN_IS_WRITABLE(nc)) {
+                ready = 1;
+                break;
+            }
+        }
+        lwesp_core_unlock();
+        if (ready) {
+            return lwespOK;
+        }
+        if (timeout == LWESP_NETCONN_RECEIVE_NO_WAIT) {
+            return lwespTIMEOUT;
+        }
+
+        /*
+         * Every event releases semaphore,
+         * wait for next one and check netconns again
+         */
+        wait = 0;
+        if (timeout > 0) {
+            elapsed = lwesp_sys_now() - start;
+            if (elapsed >= timeout) {
+                return lwespTIMEOUT;
+            }
+            wait = timeout - elapsed;
+        }
+        if (lwesp_sys_sem_wait(&set->sem, wait) == LWESP_SYS_TIMEOUT) {
+            return lwespTIMEOUT;
+        }
+    }
+}
+
+#endif /* LWESP_CFG_NETCONN_SELECT || __DOXYGEN__ */
+
+#if LWESP_CFG_NETCONN_REACTOR || __DOXYGEN__
+
+/**
+ * \brief           Add netconn to set and register reactor callback for it
+ * \param[in]       set: Set handle
+ * \param[in]       nc: Netconn handle
+ * \param[in]       fn: Callback function for netconn events
+ * \param[in]       arg: Custom argument for callback function
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_reactor_add(lwesp_netconn_set_p set, lwesp_netconn_p nc, lwesp_netconn_reactor_fn fn, void* arg) {
+    lwespr_t res;
+
+    LWESP_ASSERT("fn != NULL", fn != NULL);
+
+    if ((res = lwesp_netconn_set_add(set, nc)) == lwespOK) {
+        lwesp_core_lock();
+        nc->reactor_fn = fn;
+        nc->reactor_arg = arg;
+        nc->reactor_pass = set->reactor_pass;
+        lwesp_core_unlock();
+    }
+    return res;
+}
+
+/**
+ * \brief           Take one pending event of netconn
+ * \param[in]       nc: Netconn handle
+ * \param[out]      evt: Event structure to fill
+ * \return          `1` if event is available, `0` otherwise
+ */
+static uint8_t
+netconn_reactor_get_evt(lwesp_netconn_t* nc, lwesp_netconn_reactor_evt_t* evt) {
+    lwespr_t res;
+
+    LWESP_MEMSET(evt, 0x00, sizeof(*evt));
+    evt->nc = nc;
+    if (nc->mbox_accept_entries > 0 || nc->accept_err != lwespOK) {
+        res = netconn_accept_get(nc, &evt->client, 0);
+        netconn_spare_refill(nc);
+        if (res == lwespOK) {
+            evt->type = LWESP_NETCONN_REACTOR_ACCEPT;
+            return 1;
+        } else if (res != lwespTIMEOUT) {
+            evt->type = LWESP_NETCONN_REACTOR_CLOSED;   /* Listening stopped */
+            evt->res = res;
+            return 1;
+        }
+    }
+    if (nc->mbox_receive_entries > 0
+        && lwesp_sys_mbox_getnow(&nc->mbox_receive, (void**)&evt->pbuf)) {
+        res = netconn_receive_dequeued(nc, &evt->pbuf);
+        evt->res = res;
+        if (res == lwespOK) {
+            evt->type = LWESP_NETCONN_REACTOR_RECV;
+        } else if (res == lwespTIMEOUT) {
+            evt->type = LWESP_NETCONN_REACTOR_TIMEOUT;
+        } else {
+            evt->type = LWESP_NETCONN_REACTOR_CLOSED;
+        }
+        return 1;
+    }
+#if LWESP_CFG_NETCONN_WRITE_NONBLOCK
+    lwesp_core_lock();
+    if (NETCONN_IS_WRITABLE(nc)) {
+        nc->write_wait = 0;                     /* Report only once, until write budget is full again */
+        evt->type = LWESP_NETCONN_REACTOR_WRITABLE;
+        lwesp_core_unlock();
+        return 1;
+    }
+    lwesp_core_unlock();
+#endif /* LWESP_CFG_NETCONN_WRITE_NONBLOCK */
+    return 0;
+}
+
+/**
+ * \brief           Run reactor on set and dispatch events of all ready netconns
+ *
+ * Function waits for at least one netconn in set to become ready,
+ * then calls callback function of ready netconns, one event per netconn per pass
+ * in round-robin order, until no more events are pending.
+ *
+ * Received packet buffers are handed to callback and must be freed by application.
+ * Callback may write, close or delete its netconn and may add accepted clients to set.
+ *
+ * \note            Netconns in set must only be used from thread calling this function
+ * \param[in]       set: Set handle
+ * \param[in]       timeout: Maximal time to wait for first event in units of milliseconds.
+ *                      Set to `0` to wait forever
+ * \return          \ref lwespOK when at least one event was dispatched, \ref lwespTIMEOUT otherwise
+ */
+lwespr_t
+lwesp_netconn_reactor_run(lwesp_netconn_set_p set, uint32_t timeout) {
+    lwesp_netconn_reactor_evt_t evt;
+    lwesp_netconn_reactor_fn fn;
+    lwesp_netconn_t* nc;
+    void* arg;
+    uint8_t dispatched = 0, served;
+
+    LWESP_ASSERT("set != NULL", set != NULL);
+
+    if (lwesp_netconn_select(set, timeout) != lwespOK) {
+        return lwespTIMEOUT;
+    }
+    do {
+        served = 0;
+        ++set->reactor_pass;                    /* Start new round over all netconns */
+        while (1) {
+            /* Find next netconn not yet served in current pass */
+            lwesp_core_lock();
+            for (nc = set->first; nc != NULL; nc = nc->set_next) {
+                if (nc->reactor_fn != NULL && nc->reactor_pass != set->reactor_pass) {
+                    break;
+                }
+            }
+            fn = NULL;
+            arg = NULL;
+            if (nc != NULL) {
+                nc->reactor_pass = set->reactor_pass;
+                fn = nc->reactor_fn;
+                arg = nc->reactor_arg;
+            }
+            lwesp_core_unlock();
+            if (nc == NULL) {
+                break;
+            }
+
+            /* Dispatch outside core lock, callback may delete netconn */
+            if (netconn_reactor_get_evt(nc, &evt)) {
+                fn(&evt, arg);
+                served = dispatched = 1;
+            }
+        }
+    } while (served);
+    return dispatched ? lwespOK : lwespTIMEOUT;
+}
+
+#endif /* LWESP_CFG_NETCONN_REACTOR || __DOXYGEN__ */
+
+#if LWESP_CFG_NETCONN_PREWARM || __DOXYGEN__
+
+/**
+ * \brief           Keep idle connections to remote endpoint open for \ref lwesp_netconn_connect
+ *
+ * Connections are opened in background and checked on every poll event.
+ * Connection which receives data while idle or exceeds \ref LWESP_CFG_NETCONN_PREWARM_IDLE_TIME
+ * is closed and opened again. Every connection handed out is replaced with a new one.
+ *
+ * \note            Use it only for protocols where fresh connection has no server-initiated data,
+ *                  such as HTTP. Connection is reused only by netconn of the same type
+ * \param[in]       type: Connection type, \ref LWESP_NETCONN_TYPE_TCP or \ref LWESP_NETCONN_TYPE_SSL
+ * \param[in]       host: Remote host. String must stay valid until endpoint is removed
+ * \param[in]       port: Remote port
+ * \param[in]       count: Number of idle connections to keep open
+ * \return          \ref lwespOK on success, \ref lwespERRMEM if there are not enough free entries
+ */
+lwespr_t
+lwesp_netconn_prewarm_add(lwesp_netconn_type_t type, const char* host, lwesp_port_t port, size_t count) {
+    size_t free_cnt = 0;
+    lwespr_t res = lwespOK;
+
+    LWESP_ASSERT("type != UDP", type == LWESP_NETCONN_TYPE_TCP || type == LWESP_NETCONN_TYPE_SSL);
+    LWESP_ASSERT("host != NULL", host != NULL);
+    LWESP_ASSERT("port > 0", port > 0);
+    LWESP_ASSERT("count > 0", count > 0);
+
+    lwesp_core_lock();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(prewarm); ++i) {
+        if (prewarm[i].state == NETCONN_PREWARM_FREE) {
+            ++free_cnt;
+        }
+    }
+    if (free_cnt >= count) {
+        for (size_t i = 0; count > 0 && i < LWESP_ARRAYSIZE(prewarm); ++i) {
+            netconn_prewarm_t* e = &prewarm[i];
+
+            if (e->state == NETCONN_PREWARM_FREE) {
+                e->type = type;
+                e->host = host;
+                e->port = port;
+                e->state = NETCONN_PREWARM_CLOSED;
+                --count;
+            }
+        }
+        prewarm_refill();
+    } else {
+        res = lwespERRMEM;
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Stop keeping idle connections to remote endpoint
+ *
+ * Idle connections are closed, connections already handed out are not affected
+ *
+ * \param[in]       host: Remote host
+ * \param[in]       port: Remote port
+ * \return          \ref lwespOK on success, \ref lwespERR if endpoint is not set
+ */
+lwespr_t
+lwesp_netconn_prewarm_remove(const char* host, lwesp_port_t port) {
+    lwespr_t res = lwespERR;
+
+    LWESP_ASSERT("host != NULL", host != NULL);
+
+    lwesp_core_lock();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(prewarm); ++i) {
+        netconn_prewarm_t* e = &prewarm[i];
+
+        if (e->state == NETCONN_PREWARM_FREE || e->removed
+            || e->port != port || strcmp(e->host, host)) {
+            continue;
+        }
+        res = lwespOK;
+        if (e->state == NETCONN_PREWARM_CLOSED) {
+            LWESP_MEMSET(e, 0x00, sizeof(*e));
+        } else {
+            e->removed = 1;                     /* Entry is freed on close or error event */
+            if (e->state == NETCONN_PREWARM_READY) {
+                prewarm_close(e);
+            }
+        }
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Get number of idle connections to remote endpoint ready to be used
+ * \param[in]       host: Remote host
+ * \param[in]       port: Remote port
+ * \return          Number of ready connections
+ */
+size_t
+lwesp_netconn_prewarm_get_ready(const char* host, lwesp_port_t port) {
+    size_t cnt = 0;
+
+    if (host == NULL) {
+        return 0;
+    }
+    lwesp_core_lock();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(prewarm); ++i) {
+        if (prewarm[i].state == NETCONN_PREWARM_READY && !prewarm[i].removed
+            && prewarm[i].port == port && !strcmp(prewarm[i].host, host)) {
+            ++cnt;
+        }
+    }
+    lwesp_core_unlock();
+    return cnt;
+}
+
+#endif /* LWESP_CFG_NETCONN_PREWARM || __DOXYGEN__ */
+
+#if LWESP_CFG_NETCONN_MUX || __DOXYGEN__
+
+/**
+ * \brief           Check if device accepts new connections
+ * \return          `1` if device is present, not in reset and has IP in station mode, `0` otherwise
+ */
+static uint8_t
+netconn_mux_is_ready(void) {
+    uint8_t res;
+
+    netconn_evt_register();                     /* Reset tracking starts with first check */
+    lwesp_core_lock();
+    res = esp.status.f.dev_present && !netconn_in_reset;
+    lwesp_core_unlock();
+#if LWESP_CFG_MODE_STATION
+    res = res && lwesp_sta_has_ip();
+#endif /* LWESP_CFG_MODE_STATION */
+    return res;
+}
+
+/**
+ * \brief           Get number of detected device resets
+ * \return          Number of resets since reset tracking started
+ */
+static uint32_t
+netconn_mux_get_reset_count(void) {
+    return netconn_reset_cnt;
+}
+
+/**
+ * \brief           Netconn operations of this stack copy for netconn multiplexer
+ */
+const lwesp_netconn_mux_ops_t lwesp_netconn_mux_ops = {
+    .nc_new = lwesp_netconn_new,
+    .nc_delete = lwesp_netconn_delete,
+    .nc_connect = lwesp_netconn_connect,
+    .nc_write = lwesp_netconn_write,
+    .nc_flush = lwesp_netconn_flush,
+    .nc_read = lwesp_netconn_read,
+    .nc_close = lwesp_netconn_close,
+    .is_ready = netconn_mux_is_ready,
+    .get_reset_count = netconn_mux_get_reset_count,
+};
+
+#endif /* LWESP_CFG_NETCONN_MUX || __DOXYGEN__ */
+
 #endif /* LWESP_CFG_NETCONN || __DOXYGEN__ */
@@ -0,0 +1,314 @@
+/**
+ * \file            lwesp_netconn_mux.c
+ * \brief           Netconn multiplexer over multiple stack copies
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include "lwesp/lwesp_netconn_mux.h"
+#include "lwesp/lwesp_mem.h"
+
+#if LWESP_CFG_NETCONN_MUX || __DOXYGEN__
+
+/**
+ * \brief           Attached stack copy
+ */
+typedef struct {
+    const lwesp_netconn_mux_ops_t* ops;         /*!< Netconn operations of stack copy */
+    size_t conns;                               /*!< Number of multiplexed connections open on device */
+} netconn_mux_inst_t;
+
+/**
+ * \brief           Multiplexed connection
+ */
+typedef struct lwesp_netconn_mux_conn {
+    lwesp_netconn_type_t type;                  /*!< Connection type */
+    int8_t inst;                                /*!< Index of instance with open connection, `-1` if not connected */
+    lwesp_netconn_p nc;                         /*!< Netconn handle of instance */
+    uint32_t reset_cnt;                         /*!< Device reset count when connection was opened */
+} lwesp_netconn_mux_conn_t;
+
+static netconn_mux_inst_t mux_insts[LWESP_CFG_NETCONN_MUX_INSTANCES];
+static size_t mux_insts_cnt;                    /*!< Number of attached instances */
+static size_t mux_next;                         /*!< Instance to start search from for round-robin order */
+
+/**
+ * \brief           Get operations of connection instance
+ * \param[in]       mc: Multiplexed connection
+ */
+#define MUX_OPS(mc)                 (mux_insts[(mc)->inst].ops)
+
+/**
+ * \brief           Find ready instance with lowest load
+ * \param[in]       tried: Bit mask of instances to skip
+ * \return          Instance index or `-1` if no instance is ready
+ */
+static int8_t
+mux_pick(uint32_t tried) {
+    uint8_t ready[LWESP_CFG_NETCONN_MUX_INSTANCES];
+    size_t cnt, idx;
+    int8_t best = -1;
+
+    cnt = mux_insts_cnt;
+    for (size_t i = 0; i < cnt; ++i) {          /* Query devices outside of protection */
+        ready[i] = !(tried & (1UL << i)) && mux_insts[i].ops->is_ready();
+    }
+    lwesp_sys_protect();
+    for (size_t i = 0; i < cnt; ++i) {
+        idx = (mux_next + i) % cnt;
+        if (ready[idx] && (best < 0 || mux_insts[idx].conns < mux_insts[best].conns)) {
+            best = (int8_t)idx;
+        }
+    }
+    if (best >= 0) {
+        ++mux_insts[best].conns;                /* Reserve slot before connecting */
+        mux_next = (size_t)best + 1;
+    }
+    lwesp_sys_unprotect();
+    return best;
+}
+
+/**
+ * \brief           Close and delete netconn of instance and release instance load
+ * \param[in]       mc: Multiplexed connection
+ * \param[in]       close: Set to `1` to close connection before delete
+ */
+static void
+mux_release(lwesp_netconn_mux_conn_t* mc, uint8_t close) {
+    if (mc->inst < 0) {
+        return;
+    }
+    if (mc->nc != NULL) {
+        if (close) {
+            MUX_OPS(mc)->nc_close(mc->nc);
+        }
+        MUX_OPS(mc)->nc_delete(mc->nc);
+        mc->nc = NULL;
+    }
+    lwesp_sys_protect();
+    --mux_insts[mc->inst].conns;
+    lwesp_sys_unprotect();
+    mc->inst = -1;
+}
+
+/**
+ * \brief           Check if connection is open and its device was not reset since
+ * \param[in]       mc: Multiplexed connection
+ * \return          \ref lwespOK on success, \ref lwespCLOSED otherwise
+ */
+static lwespr_t
+mux_check(lwesp_netconn_mux_conn_t* mc) {
+    if (mc->inst < 0 || MUX_OPS(mc)->get_reset_count() != mc->reset_cnt) {
+        return lwespCLOSED;
+    }
+    return lwespOK;
+}
+
+/**
+ * \brief           Attach stack copy to multiplexer
+ * \note            Call it from translation unit compiled with \ref LWESP_CFG_PREFIX of the copy,
+ *                  where \ref lwesp_netconn_mux_ops refers to operations of that copy
+ * \param[in]       ops: Netconn operations of stack copy, \ref lwesp_netconn_mux_ops
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_mux_attach(const lwesp_netconn_mux_ops_t* ops) {
+    lwespr_t res = lwespOK;
+
+    LWESP_ASSERT("ops != NULL", ops != NULL);
+
+    lwesp_sys_protect();
+    if (mux_insts_cnt >= LWESP_ARRAYSIZE(mux_insts)) {
+        res = lwespERRMEM;
+    } else {
+        mux_insts[mux_insts_cnt].ops = ops;
+        mux_insts[mux_insts_cnt].conns = 0;
+        ++mux_insts_cnt;
+    }
+    lwesp_sys_unprotect();
+    return res;
+}
+
+/**
+ * \brief           Create new multiplexed connection
+ * \note            Device is selected when connection is opened with \ref lwesp_netconn_mux_connect
+ * \param[in]       type: Netconn connection type
+ * \return          New connection handle on success, `NULL` otherwise
+ */
+lwesp_netconn_mux_conn_p
+lwesp_netconn_mux_new(lwesp_netconn_type_t type) {
+    lwesp_netconn_mux_conn_t* mc;
+
+    if ((mc = lwesp_mem_calloc(1, sizeof(*mc))) != NULL) {
+        mc->type = type;
+        mc->inst = -1;
+    }
+    return mc;
+}
+
+/**
+ * \brief           Delete multiplexed connection, close it first if still open
+ * \param[in]       mc: Multiplexed connection
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_mux_delete(lwesp_netconn_mux_conn_p mc) {
+    LWESP_ASSERT("mc != NULL", mc != NULL);
+
+    mux_release(mc, 1);
+    lwesp_mem_free(mc);
+    return lwespOK;
+}
+
+/**
+ * \brief           Connect to server on least loaded ready device
+ *
+ * When connection fails on selected device, other ready devices are tried.
+ * Any previous connection of the handle is closed first, which is used for failover after device reset.
+ *
+ * \param[in]       mc: Multiplexed connection
+ * \param[in]       host: Host name or IP address in string format
+ * \param[in]       port: Server port
+ * \return          \ref lwespOK on success, \ref lwespERRNODEVICE if no device is ready,
+ *                  member of \ref lwespr_t enumeration of last failed connect otherwise
+ */
+lwespr_t
+lwesp_netconn_mux_connect(lwesp_netconn_mux_conn_p mc, const char* host, lwesp_port_t port) {
+    const lwesp_netconn_mux_ops_t* ops;
+    lwespr_t res = lwespERRNODEVICE;
+    uint32_t tried = 0;
+    int8_t inst;
+
+    LWESP_ASSERT("mc != NULL", mc != NULL);
+    LWESP_ASSERT("host != NULL", host != NULL);
+    LWESP_ASSERT("port > 0", port > 0);
+
+    mux_release(mc, 1);
+    while ((inst = mux_pick(tried)) >= 0) {
+        ops = mux_insts[inst].ops;
+        mc->inst = inst;
+        mc->reset_cnt = ops->get_reset_count();
+        if ((mc->nc = ops->nc_new(mc->type)) == NULL) {
+            res = lwespERRMEM;
+        } else if ((res = ops->nc_connect(mc->nc, host, port)) == lwespOK) {
+            break;
+        }
+        mux_release(mc, 0);
+        tried |= 1UL << inst;
+    }
+    return res;
+}
+
+/**
+ * \brief           Write data to multiplexed connection
+ * \param[in]       mc: Multiplexed connection
+ * \param[in]       data: Data to write
+ * \param[in]       btw: Number of bytes to write
+ * \return          \ref lwespOK on success, \ref lwespCLOSED if connection is not open or device was reset,
+ *                  member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_mux_write(lwesp_netconn_mux_conn_p mc, const void* data, size_t btw) {
+    lwespr_t res;
+
+    LWESP_ASSERT("mc != NULL", mc != NULL);
+
+    if ((res = mux_check(mc)) != lwespOK) {
+        return res;
+    }
+    return MUX_OPS(mc)->nc_write(mc->nc, data, btw);
+}
+
+/**
+ * \brief           Flush buffered data of multiplexed connection
+ * \param[in]       mc: Multiplexed connection
+ * \return          \ref lwespOK on success, \ref lwespCLOSED if connection is not open or device was reset,
+ *                  member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_mux_flush(lwesp_netconn_mux_conn_p mc) {
+    lwespr_t res;
+
+    LWESP_ASSERT("mc != NULL", mc != NULL);
+
+    if ((res = mux_check(mc)) != lwespOK) {
+        return res;
+    }
+    return MUX_OPS(mc)->nc_flush(mc->nc);
+}
+
+/**
+ * \brief           Read data from multiplexed connection
+ * \param[in]       mc: Multiplexed connection
+ * \param[out]      buf: Buffer to copy data to
+ * \param[in]       len: Maximal number of bytes to read
+ * \param[in]       min_len: Minimal number of bytes to read before function returns
+ * \param[out]      br: Output variable to save number of bytes read. Can be set to `NULL`
+ * \return          \ref lwespOK on success, \ref lwespCLOSED if connection is closed or device was reset,
+ *                  member of \ref lwespr_t enumeration otherwise, see \ref lwesp_netconn_read
+ */
+lwespr_t
+lwesp_netconn_mux_read(lwesp_netconn_mux_conn_p mc, void* buf, size_t len, size_t min_len, size_t* br) {
+    lwespr_t res;
+
+    LWESP_ASSERT("mc != NULL", mc != NULL);
+
+    if (br != NULL) {
+        *br = 0;
+    }
+    if ((res = mux_check(mc)) != lwespOK) {
+        return res;
+    }
+    return MUX_OPS(mc)->nc_read(mc->nc, buf, len, min_len, br);
+}
+
+/**
+ * \brief           Close multiplexed connection and release its device
+ * \param[in]       mc: Multiplexed connection
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_netconn_mux_close(lwesp_netconn_mux_conn_p mc) {
+    LWESP_ASSERT("mc != NULL", mc != NULL);
+
+    mux_release(mc, 1);
+    return lwespOK;
+}
+
+/**
+ * \brief           Get index of device connection is open on
+ * \param[in]       mc: Multiplexed connection
+ * \return          Instance index in attach order, `-1` if connection is not open
+ */
+int8_t
+lwesp_netconn_mux_get_instance(lwesp_netconn_mux_conn_p mc) {
+    return mc != NULL ? mc->inst : -1;
+}
+
+#endif /* LWESP_CFG_NETCONN_MUX || __DOXYGEN__ */
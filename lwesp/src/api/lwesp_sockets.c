@@ -0,0 +1,660 @@
+/**
+ * \file            lwesp_sockets.c
+ * \brief           BSD-style socket API on top of netconn
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include <stdio.h>
+#include "lwesp/lwesp_sockets.h"
+#include "lwesp/lwesp_pbuf.h"
+#include "lwesp/lwesp_mem.h"
+
+#if LWESP_CFG_SOCKETS || __DOXYGEN__
+
+#if !LWESP_CFG_NETCONN || !LWESP_CFG_NETCONN_SELECT || !LWESP_CFG_NETCONN_RECEIVE_TIMEOUT
+#error "LWESP_CFG_SOCKETS requires LWESP_CFG_NETCONN, LWESP_CFG_NETCONN_SELECT and LWESP_CFG_NETCONN_RECEIVE_TIMEOUT"
+#endif /* !LWESP_CFG_NETCONN || !LWESP_CFG_NETCONN_SELECT || !LWESP_CFG_NETCONN_RECEIVE_TIMEOUT */
+
+/**
+ * \brief           Socket descriptor entry
+ */
+typedef struct {
+    lwesp_netconn_p nc;                         /*!< Netconn handle, `NULL` when entry is free */
+    uint8_t type;                               /*!< Socket type, \ref LWESP_SOCK_STREAM or \ref LWESP_SOCK_DGRAM */
+    uint8_t flags;                              /*!< Socket flags, \ref LWESP_O_NONBLOCK */
+    uint8_t closed;                             /*!< Flag if remote side closed connection */
+    lwespr_t err;                               /*!< Last error on socket */
+    lwesp_pbuf_p pbuf;                          /*!< Received packet buffer not yet fully read */
+    size_t pbuf_off;                            /*!< Offset of first not yet read byte in `pbuf` */
+} lwesp_sock_t;
+
+static lwesp_sock_t socks[LWESP_CFG_SOCKETS_MAX];   /*!< Socket descriptor table */
+static lwesp_netconn_set_p sel_set;             /*!< Netconn set used by select function */
+static lwesp_sys_sem_t sel_sem;                 /*!< Semaphore to protect select set */
+
+/**
+ * \brief           Get socket entry from descriptor
+ * \param[in]       fd: Socket descriptor
+ * \return          Socket entry on success, `NULL` otherwise
+ */
+static lwesp_sock_t*
+sock_get(int fd) {
+    if (fd < 0 || fd >= (int)LWESP_ARRAYSIZE(socks) || socks[fd].nc == NULL) {
+        return NULL;
+    }
+    return &socks[fd];
+}
+
+/**
+ * \brief           Save error to socket and return failure
+ * \param[in]       s: Socket entry
+ * \param[in]       err: Error to save
+ * \return          `-1`
+ */
+static int
+sock_fail(lwesp_sock_t* s, lwespr_t err) {
+    s->err = err;
+    return -1;
+}
+
+/**
+ * \brief           Allocate new socket descriptor for netconn
+ * \param[in]       nc: Netconn handle
+ * \param[in]       type: Socket type
+ * \return          Socket descriptor on success, `-1` otherwise
+ */
+static int
+sock_alloc(lwesp_netconn_p nc, uint8_t type) {
+    int fd = -1;
+
+    lwesp_core_lock();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(socks); ++i) {
+        if (socks[i].nc == NULL) {
+            LWESP_MEMSET(&socks[i], 0x00, sizeof(socks[i]));
+            socks[i].nc = nc;
+            socks[i].type = type;
+            fd = (int)i;
+            break;
+        }
+    }
+    lwesp_core_unlock();
+    return fd;
+}
+
+/**
+ * \brief           Check if socket has data ready to read without blocking
+ * \param[in]       s: Socket entry
+ * \return          `1` if ready, `0` otherwise
+ */
+static uint8_t
+sock_is_readable(lwesp_sock_t* s) {
+    return s->pbuf != NULL || s->closed || lwesp_netconn_is_ready(s->nc);
+}
+
+/**
+ * \brief           Check if socket can accept data without blocking
+ * \param[in]       s: Socket entry
+ * \return          `1` if ready, `0` otherwise
+ */
+static uint8_t
+sock_is_writable(lwesp_sock_t* s) {
+#if LWESP_CFG_NETCONN_WRITE_NONBLOCK
+    if (s->type == LWESP_SOCK_STREAM) {
+        return lwesp_netconn_get_write_available(s->nc) > 0;
+    }
+#endif /* LWESP_CFG_NETCONN_WRITE_NONBLOCK */
+    return lwesp_netconn_get_conn(s->nc) != NULL;
+}
+
+/**
+ * \brief           Make sure socket holds received packet buffer
+ * \param[in]       s: Socket entry
+ * \param[in]       flags: Receive flags
+ * \return          \ref lwespOK if packet is available, member of \ref lwespr_t otherwise
+ */
+static lwespr_t
+sock_fetch(lwesp_sock_t* s, int flags) {
+    uint32_t timeout;
+    lwespr_t res;
+
+    if (s->pbuf != NULL) {
+        return lwespOK;
+    }
+    if (s->closed) {
+        return lwespCLOSED;
+    }
+
+    /* Use netconn receive timeout for blocking mode, no wait otherwise */
+    timeout = lwesp_netconn_get_receive_timeout(s->nc);
+    if ((flags & LWESP_MSG_DONTWAIT) || (s->flags & LWESP_O_NONBLOCK)) {
+        lwesp_netconn_set_receive_timeout(s->nc, LWESP_NETCONN_RECEIVE_NO_WAIT);
+    }
+    res = lwesp_netconn_receive(s->nc, &s->pbuf);
+    lwesp_netconn_set_receive_timeout(s->nc, timeout);
+    if (res == lwespCLOSED) {
+        s->closed = 1;
+    }
+    s->pbuf_off = 0;
+    return res;
+}
+
+/**
+ * \brief           Consume bytes from held packet buffer
+ * \param[in]       s: Socket entry
+ * \param[in]       len: Number of bytes consumed
+ */
+static void
+sock_consume(lwesp_sock_t* s, size_t len) {
+    s->pbuf_off += len;
+    if (s->pbuf_off >= lwesp_pbuf_length(s->pbuf, 1)) {
+        lwesp_pbuf_free(s->pbuf);
+        s->pbuf = NULL;
+        s->pbuf_off = 0;
+    }
+}
+
+/**
+ * \brief           Create new socket
+ * \param[in]       domain: Address family, only \ref LWESP_AF_INET is supported
+ * \param[in]       type: Socket type, \ref LWESP_SOCK_STREAM or \ref LWESP_SOCK_DGRAM
+ * \param[in]       protocol: Protocol, ignored
+ * \return          Socket descriptor on success, `-1` otherwise
+ */
+int
+lwesp_socket(int domain, int type, int protocol) {
+    lwesp_netconn_p nc;
+    int fd;
+
+    LWESP_UNUSED(protocol);
+    if (domain != LWESP_AF_INET || (type != LWESP_SOCK_STREAM && type != LWESP_SOCK_DGRAM)) {
+        return -1;
+    }
+
+    /* Select set is created once, when first socket is created */
+    lwesp_core_lock();
+    if (sel_set == NULL) {
+        if (!lwesp_sys_sem_create(&sel_sem, 1)) {
+            lwesp_core_unlock();
+            return -1;
+        }
+        if ((sel_set = lwesp_netconn_set_new()) == NULL) {
+            lwesp_sys_sem_delete(&sel_sem);
+            lwesp_sys_sem_invalid(&sel_sem);
+            lwesp_core_unlock();
+            return -1;
+        }
+    }
+    lwesp_core_unlock();
+
+    nc = lwesp_netconn_new(type == LWESP_SOCK_STREAM ? LWESP_NETCONN_TYPE_TCP : LWESP_NETCONN_TYPE_UDP);
+    if (nc == NULL) {
+        return -1;
+    }
+    if ((fd = sock_alloc(nc, (uint8_t)type)) < 0) {
+        lwesp_netconn_delete(nc);
+    }
+    return fd;
+}
+
+/**
+ * \brief           Close socket and release its descriptor
+ * \param[in]       fd: Socket descriptor
+ * \return          `0` on success, `-1` otherwise
+ */
+int
+lwesp_sock_close(int fd) {
+    lwesp_sock_t* s;
+    lwesp_netconn_p nc;
+
+    if ((s = sock_get(fd)) == NULL) {
+        return -1;
+    }
+    nc = s->nc;
+    if (s->pbuf != NULL) {
+        lwesp_pbuf_free(s->pbuf);
+    }
+    if (lwesp_netconn_get_conn(nc) != NULL && lwesp_conn_is_active(lwesp_netconn_get_conn(nc))) {
+        lwesp_netconn_close(nc);
+    }
+    lwesp_netconn_delete(nc);
+
+    lwesp_core_lock();
+    LWESP_MEMSET(s, 0x00, sizeof(*s));
+    lwesp_core_unlock();
+    return 0;
+}
+
+/**
+ * \brief           Bind socket to local port
+ * \param[in]       fd: Socket descriptor
+ * \param[in]       addr: Local address, only port is used
+ * \return          `0` on success, `-1` otherwise
+ */
+int
+lwesp_bind(int fd, const lwesp_sockaddr_in_t* addr) {
+    lwesp_sock_t* s;
+    lwespr_t res;
+
+    if ((s = sock_get(fd)) == NULL || addr == NULL) {
+        return -1;
+    }
+    if ((res = lwesp_netconn_bind(s->nc, addr->port)) != lwespOK) {
+        return sock_fail(s, res);
+    }
+    return 0;
+}
+
+/**
+ * \brief           Put stream socket to listening mode
+ * \param[in]       fd: Socket descriptor
+ * \param[in]       backlog: Maximal number of clients. Set to `0` for default
+ * \return          `0` on success, `-1` otherwise
+ */
+int
+lwesp_listen(int fd, int backlog) {
+    lwesp_sock_t* s;
+    lwespr_t res;
+
+    if ((s = sock_get(fd)) == NULL || s->type != LWESP_SOCK_STREAM) {
+        return -1;
+    }
+    res = lwesp_netconn_listen_with_max_conn(s->nc, backlog > 0 ? (uint16_t)backlog : LWESP_CFG_MAX_CONNS);
+    if (res != lwespOK) {
+        return sock_fail(s, res);
+    }
+    return 0;
+}
+
+/**
+ * \brief           Accept new client on listening socket
+ * \param[in]       fd: Listening socket descriptor
+ * \param[out]      addr: Output variable to save remote address to. Can be set to `NULL`
+ * \return          New socket descriptor on success, `-1` otherwise.
+ *                  Error is set to \ref lwespTIMEOUT when socket is non-blocking and no client is waiting
+ */
+int
+lwesp_accept(int fd, lwesp_sockaddr_in_t* addr) {
+    lwesp_sock_t* s;
+    lwesp_netconn_p client;
+    lwesp_conn_p conn;
+    lwespr_t res;
+    int cfd;
+
+    if ((s = sock_get(fd)) == NULL) {
+        return -1;
+    }
+    if ((s->flags & LWESP_O_NONBLOCK) && !lwesp_netconn_is_ready(s->nc)) {
+        return sock_fail(s, lwespTIMEOUT);
+    }
+    if ((res = lwesp_netconn_accept(s->nc, &client)) != lwespOK) {
+        return sock_fail(s, res);
+    }
+    if ((cfd = sock_alloc(client, LWESP_SOCK_STREAM)) < 0) {
+        lwesp_netconn_close(client);
+        lwesp_netconn_delete(client);
+        return sock_fail(s, lwespERRMEM);
+    }
+    if (addr != NULL && (conn = lwesp_netconn_get_conn(client)) != NULL) {
+        lwesp_conn_get_remote_ip(conn, &addr->ip);
+        addr->port = lwesp_conn_get_remote_port(conn);
+    }
+    return cfd;
+}
+
+/**
+ * \brief           Connect socket to remote host
+ *
+ * For datagram socket, address is used as default remote for \ref lwesp_send
+ *
+ * \param[in]       fd: Socket descriptor
+ * \param[in]       addr: Remote address
+ * \return          `0` on success, `-1` otherwise
+ */
+int
+lwesp_connect(int fd, const lwesp_sockaddr_in_t* addr) {
+    lwesp_sock_t* s;
+    lwespr_t res;
+    char host[16];
+
+    if ((s = sock_get(fd)) == NULL || addr == NULL) {
+        return -1;
+    }
+    sprintf(host, "%d.%d.%d.%d", (int)addr->ip.ip[0], (int)addr->ip.ip[1], (int)addr->ip.ip[2], (int)addr->ip.ip[3]);
+    if ((res = lwesp_netconn_connect(s->nc, host, addr->port)) != lwespOK) {
+        return sock_fail(s, res);
+    }
+    return 0;
+}
+
+/**
+ * \brief           Send data on connected socket
+ * \param[in]       fd: Socket descriptor
+ * \param[in]       data: Data to send
+ * \param[in]       len: Number of bytes to send
+ * \param[in]       flags: Send flags, \ref LWESP_MSG_DONTWAIT
+ * \return          Number of bytes accepted on success, `-1` otherwise
+ */
+int
+lwesp_send(int fd, const void* data, size_t len, int flags) {
+    return lwesp_sendto(fd, data, len, flags, NULL);
+}
+
+/**
+ * \brief           Send data to specific remote address
+ * \param[in]       fd: Socket descriptor
+ * \param[in]       data: Data to send
+ * \param[in]       len: Number of bytes to send
+ * \param[in]       flags: Send flags, \ref LWESP_MSG_DONTWAIT
+ * \param[in]       addr: Remote address for datagram socket. Set to `NULL` to use connected remote
+ * \return          Number of bytes accepted on success, `-1` otherwise
+ */
+int
+lwesp_sendto(int fd, const void* data, size_t len, int flags, const lwesp_sockaddr_in_t* addr) {
+    lwesp_sock_t* s;
+    lwespr_t res;
+
+    if ((s = sock_get(fd)) == NULL || data == NULL) {
+        return -1;
+    }
+    if (lwesp_netconn_get_conn(s->nc) == NULL) {
+        return sock_fail(s, lwespCLOSED);
+    }
+    if (s->type == LWESP_SOCK_DGRAM) {
+        if (addr != NULL) {
+            res = lwesp_netconn_sendto(s->nc, &addr->ip, addr->port, data, len);
+        } else {
+            res = lwesp_netconn_send(s->nc, data, len);
+        }
+        return res == lwespOK ? (int)len : sock_fail(s, res);
+    }
+#if LWESP_CFG_NETCONN_WRITE_NONBLOCK
+    if ((flags & LWESP_MSG_DONTWAIT) || (s->flags & LWESP_O_NONBLOCK)) {
+        size_t bw;
+
+        res = lwesp_netconn_write_nonblock(s->nc, data, len, &bw);
+        if (res == lwespOK || res == lwespINPROG) {
+            if (bw == 0) {
+                return sock_fail(s, lwespTIMEOUT);  /* Would block */
+            }
+            lwesp_netconn_flush(s->nc);
+            return (int)bw;
+        }
+        return sock_fail(s, res);
+    }
+#else /* LWESP_CFG_NETCONN_WRITE_NONBLOCK */
+    LWESP_UNUSED(flags);
+#endif /* !LWESP_CFG_NETCONN_WRITE_NONBLOCK */
+    if ((res = lwesp_netconn_write(s->nc, data, len)) == lwespOK) {
+        res = lwesp_netconn_flush(s->nc);
+    }
+    return res == lwespOK ? (int)len : sock_fail(s, res);
+}
+
+/**
+ * \brief           Receive data from socket
+ * \param[in]       fd: Socket descriptor
+ * \param[out]      buf: Buffer to copy data to
+ * \param[in]       len: Size of buffer
+ * \param[in]       flags: Receive flags, \ref LWESP_MSG_DONTWAIT
+ * \return          Number of bytes received, `0` when connection is closed, `-1` on failure.
+ *                  Error is set to \ref lwespTIMEOUT when no data are available in non-blocking mode
+ */
+int
+lwesp_recv(int fd, void* buf, size_t len, int flags) {
+    return lwesp_recvfrom(fd, buf, len, flags, NULL);
+}
+
+/**
+ * \brief           Receive data from socket with remote address
+ *
+ * For datagram socket, one datagram is returned per call.
+ * Part of datagram which does not fit to buffer is discarded
+ *
+ * \param[in]       fd: Socket descriptor
+ * \param[out]      buf: Buffer to copy data to
+ * \param[in]       len: Size of buffer
+ * \param[in]       flags: Receive flags, \ref LWESP_MSG_DONTWAIT
+ * \param[out]      addr: Output variable to save remote address to. Can be set to `NULL`
+ * \return          Number of bytes received, `0` when connection is closed, `-1` on failure
+ */
+int
+lwesp_recvfrom(int fd, void* buf, size_t len, int flags, lwesp_sockaddr_in_t* addr) {
+    lwesp_sock_t* s;
+    lwespr_t res;
+    size_t cnt;
+
+    if ((s = sock_get(fd)) == NULL || buf == NULL) {
+        return -1;
+    }
+    if ((res = sock_fetch(s, flags)) != lwespOK) {
+        return res == lwespCLOSED ? 0 : sock_fail(s, res);
+    }
+    if (addr != NULL) {
+        lwesp_pbuf_get_ip(s->pbuf, &addr->ip, &addr->port);
+    }
+    cnt = lwesp_pbuf_copy(s->pbuf, buf, len, s->pbuf_off);
+    if (s->type == LWESP_SOCK_DGRAM) {          /* Datagram is always consumed at once */
+        sock_consume(s, lwesp_pbuf_length(s->pbuf, 1));
+    } else {
+        sock_consume(s, cnt);
+    }
+    return (int)cnt;
+}
+
+/**
+ * \brief           Receive data from socket without copy
+ *
+ * Function returns pointer to received data in place.
+ * Data stay valid until \ref lwesp_recv_zc_done is called,
+ * which must be called before any other receive function on socket
+ *
+ * \param[in]       fd: Socket descriptor
+ * \param[out]      data: Output variable to save pointer to received data to
+ * \param[in]       flags: Receive flags, \ref LWESP_MSG_DONTWAIT
+ * \return          Number of contiguous bytes available at `*data`, `0` when connection is closed, `-1` on failure
+ */
+int
+lwesp_recv_zc(int fd, const void** data, int flags) {
+    lwesp_sock_t* s;
+    lwespr_t res;
+    size_t len = 0;
+
+    if ((s = sock_get(fd)) == NULL || data == NULL) {
+        return -1;
+    }
+    if ((res = sock_fetch(s, flags)) != lwespOK) {
+        return res == lwespCLOSED ? 0 : sock_fail(s, res);
+    }
+    *data = lwesp_pbuf_get_linear_addr(s->pbuf, s->pbuf_off, &len);
+    return (int)len;
+}
+
+/**
+ * \brief           Release data received with \ref lwesp_recv_zc
+ * \param[in]       fd: Socket descriptor
+ * \param[in]       len: Number of bytes consumed by application
+ * \return          `0` on success, `-1` otherwise
+ */
+int
+lwesp_recv_zc_done(int fd, size_t len) {
+    lwesp_sock_t* s;
+
+    if ((s = sock_get(fd)) == NULL || s->pbuf == NULL) {
+        return -1;
+    }
+    sock_consume(s, len);
+    return 0;
+}
+
+/**
+ * \brief           Get or set socket flags
+ * \param[in]       fd: Socket descriptor
+ * \param[in]       cmd: Command, \ref LWESP_F_GETFL or \ref LWESP_F_SETFL
+ * \param[in]       val: New flags for \ref LWESP_F_SETFL command, \ref LWESP_O_NONBLOCK
+ * \return          Socket flags for \ref LWESP_F_GETFL, `0` on success for \ref LWESP_F_SETFL, `-1` otherwise
+ */
+int
+lwesp_fcntl(int fd, int cmd, int val) {
+    lwesp_sock_t* s;
+
+    if ((s = sock_get(fd)) == NULL) {
+        return -1;
+    }
+    switch (cmd) {
+        case LWESP_F_GETFL:
+            return s->flags;
+        case LWESP_F_SETFL:
+            s->flags = (uint8_t)(val & LWESP_O_NONBLOCK);
+            return 0;
+        default:
+            return sock_fail(s, lwespPARERR);
+    }
+}
+
+/**
+ * \brief           Check ready sockets and update sets
+ * \param[in]       nfds: Highest socket descriptor plus `1`
+ * \param[in,out]   readfds: Sockets to check for read
+ * \param[in,out]   writefds: Sockets to check for write
+ * \param[in]       update: Set to `1` to write result to sets
+ * \return          Number of ready sockets
+ */
+static int
+select_check(int nfds, lwesp_fd_set_t* readfds, lwesp_fd_set_t* writefds, uint8_t update) {
+    lwesp_sock_t* s;
+    int cnt = 0;
+
+    for (int fd = 0; fd < nfds; ++fd) {
+        s = sock_get(fd);
+        if (readfds != NULL && LWESP_FD_ISSET(fd, readfds)) {
+            if (s != NULL && sock_is_readable(s)) {
+                ++cnt;
+            } else if (update) {
+                LWESP_FD_CLR(fd, readfds);
+            }
+        }
+        if (writefds != NULL && LWESP_FD_ISSET(fd, writefds)) {
+            if (s != NULL && sock_is_writable(s)) {
+                ++cnt;
+            } else if (update) {
+                LWESP_FD_CLR(fd, writefds);
+            }
+        }
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Wait for sockets to become ready for read or write
+ *
+ * Every socket in sets waits on single netconn set, no thread is used per socket.
+ *
+ * \note            Exception set is not supported and is cleared on return
+ * \param[in]       nfds: Highest socket descriptor plus `1`
+ * \param[in,out]   readfds: Sockets to check for read. Can be set to `NULL`
+ * \param[in,out]   writefds: Sockets to check for write. Can be set to `NULL`
+ * \param[in,out]   exceptfds: Not supported, cleared on return. Can be set to `NULL`
+ * \param[in]       timeout: Timeout in units of milliseconds. Set to `0` to wait forever,
+ *                      or \ref LWESP_NETCONN_RECEIVE_NO_WAIT to return immediately
+ * \return          Number of ready sockets, `0` on timeout, `-1` on failure
+ */
+int
+lwesp_select(int nfds, lwesp_fd_set_t* readfds, lwesp_fd_set_t* writefds, lwesp_fd_set_t* exceptfds, uint32_t timeout) {
+    lwesp_sock_t* s;
+    uint32_t start, elapsed;
+    int cnt;
+
+    if (nfds < 0 || nfds > (int)LWESP_ARRAYSIZE(socks) || sel_set == NULL) {
+        return -1;
+    }
+    if (exceptfds != NULL) {
+        LWESP_FD_ZERO(exceptfds);
+    }
+
+    lwesp_sys_sem_wait(&sel_sem, 0);            /* Set is used by one select call at a time */
+    for (int fd = 0; fd < nfds; ++fd) {
+        if ((s = sock_get(fd)) != NULL
+            && ((readfds != NULL && LWESP_FD_ISSET(fd, readfds))
+                || (writefds != NULL && LWESP_FD_ISSET(fd, writefds)))) {
+            lwesp_netconn_set_add(sel_set, s->nc);
+        }
+    }
+    start = lwesp_sys_now();
+    while ((cnt = select_check(nfds, readfds, writefds, 0)) == 0) {
+        uint32_t wait = timeout;
+        if (timeout != 0 && timeout != LWESP_NETCONN_RECEIVE_NO_WAIT) {
+            elapsed = lwesp_sys_now() - start;
+            if (elapsed >= timeout) {
+                break;
+            }
+            wait = timeout - elapsed;
+        }
+        if (lwesp_netconn_select(sel_set, wait) != lwespOK) {
+            break;
+        }
+    }
+    for (int fd = 0; fd < nfds; ++fd) {
+        if ((s = sock_get(fd)) != NULL) {
+            lwesp_netconn_set_remove(sel_set, s->nc);
+        }
+    }
+    lwesp_sys_sem_release(&sel_sem);
+
+    cnt = select_check(nfds, readfds, writefds, 1); /* Write result to sets */
+    return cnt;
+}
+
+/**
+ * \brief           Get last error of socket
+ * \param[in]       fd: Socket descriptor
+ * \return          Last error as member of \ref lwespr_t enumeration
+ */
+lwespr_t
+lwesp_sock_get_error(int fd) {
+    lwesp_sock_t* s;
+
+    if ((s = sock_get(fd)) == NULL) {
+        return lwespPARERR;
+    }
+    return s->err;
+}
+
+/**
+ * \brief           Get netconn handle of socket
+ * \param[in]       fd: Socket descriptor
+ * \return          Netconn handle on success, `NULL` otherwise
+ */
+lwesp_netconn_p
+lwesp_sock_get_netconn(int fd) {
+    lwesp_sock_t* s = sock_get(fd);
+    return s != NULL ? s->nc : NULL;
+}
+
+#endif /* LWESP_CFG_SOCKETS || __DOXYGEN__ */
@@ -42,14 +42,14 @@
 #define LWESP_CFG_DBG_CAYENNE_TRACE_WARNING       (LWESP_CFG_DBG_CAYENNE | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING)
 #define LWESP_CFG_DBG_CAYENNE_TRACE_SEVERE        (LWESP_CFG_DBG_CAYENNE | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_SEVERE)
 
-#define LWESP_CAYENNE_API_VERSION_LEN             (sizeof(LWESP_CAYENNE_API_VERSION) - 1)
-
-#define CHECK_FORWARDSLASH_AND_FORWARD(str)     do { if ((str) == NULL || *(str) != '/') { return lwespERR; } ++(str); } while (0)
-
 #if !LWESP_CFG_NETCONN || !LWESP_CFG_MODE_STATION
 #error "Netconn and station mode must be enabled!"
 #endif /* !LWESP_CFG_NETCONN || !LWESP_CFG_MODE_STATION */
 
+#if LWESP_CAYENNE_TOPIC_CACHE_LEN < 1 || LWESP_CAYENNE_TOPIC_CACHE_LEN > 32
+#error "LWESP_CAYENNE_TOPIC_CACHE_LEN must be between 1 and 32!"
+#endif /* LWESP_CAYENNE_TOPIC_CACHE_LEN < 1 || LWESP_CAYENNE_TOPIC_CACHE_LEN > 32 */
+
 /**
  * \brief           Topic type and string key-value pair structure
  */
@@ -85,6 +85,15 @@ topic_cmd_str_pairs[] = {
 static lwesp_sys_mutex_t
 prot_mutex;
 
+/**
+ * \brief           Worker shared by all Cayenne instances
+ */
+static struct {
+    lwesp_mqtt_client_api_group_p group;        /*!< Receive group of all instances */
+    lwesp_sys_thread_t thread;                  /*!< Worker thread handle */
+    lwesp_cayenne_t* volatile instances;        /*!< List of created instances */
+} worker;
+
 /**
  * \brief           Topic name for publish/subscribe
  */
@@ -98,61 +107,24 @@ static char
 payload_data[128];
 
 /**
- * \brief           Parse received topic string
- * \param[in]       c: Cayenne handle
- * \param[in]       buf: MQTT buffer with received data
+ * \brief           Parse topic part after `v1/<user>/things/<id>/` prefix
+ * \param[out]      msg: Message to fill
+ * \param[in]       topic: Topic suffix, does not need to be NULL terminated
+ * \param[in]       len: Length of topic suffix
  * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
  */
 static lwespr_t
-parse_topic(lwesp_cayenne_t* c, lwesp_mqtt_client_api_buf_p buf) {
-    lwesp_cayenne_msg_t* msg;
-    const char* topic;
-    size_t len, i;
-
-    LWESP_ASSERT("c != NULL", c != NULL);
-    LWESP_ASSERT("buf != NULL && buf->topic != NULL", buf != NULL && buf->topic != NULL);
-
-    msg = &c->msg;                              /* Get message handle */
-    topic = (void*)buf->topic;                  /* Get topic data */
-
-    LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] Parsing received topic: %s\r\n", topic);
-
-    /* Topic starts with API version */
-    if (strncmp(topic, LWESP_CAYENNE_API_VERSION, LWESP_CAYENNE_API_VERSION_LEN)) {
-        return lwespERR;
-    }
-    topic += LWESP_CAYENNE_API_VERSION_LEN;
-    CHECK_FORWARDSLASH_AND_FORWARD(topic);
-
-    /* Check username */
-    len = strlen(c->info_c->user);
-    if (strncmp(topic, c->info_c->user, len)) {
-        return lwespERR;
-    }
-    topic += len;
-
-    /* Check for /things/ */
-    len = sizeof("/things/") - 1;
-    if (strncmp(topic, "/things/", len)) {
-        return lwespERR;
-    }
-    topic += len;
-
-    /* Check client ID */
-    len = strlen(c->info_c->id);
-    if (strncmp(topic, c->info_c->id, len)) {
-        return lwespERR;
-    }
-    topic += len;
-    CHECK_FORWARDSLASH_AND_FORWARD(topic);
+parse_topic_suffix(lwesp_cayenne_msg_t* msg, const char* topic, size_t len) {
+    const char* end = topic + len;
+    size_t str_len, i;
 
     /* Now parse topic string */
     msg->topic = LWESP_CAYENNE_TOPIC_END;
     for (i = 0; i < LWESP_ARRAYSIZE(topic_cmd_str_pairs); ++i) {
-        len = strlen(topic_cmd_str_pairs[i].str);
-        if (!strncmp(topic_cmd_str_pairs[i].str, topic, len)) {
+        str_len = strlen(topic_cmd_str_pairs[i].str);
+        if (str_len <= len && !strncmp(topic_cmd_str_pairs[i].str, topic, str_len)) {
             msg->topic = topic_cmd_str_pairs[i].topic;
-            topic += len;
+            topic += str_len;
             break;
         }
     }
@@ -163,15 +135,13 @@ parse_topic(lwesp_cayenne_t* c, lwesp_mqtt_client_api_buf_p buf) {
 
     /* Parse channel */
     msg->channel = LWESP_CAYENNE_NO_CHANNEL;
-    if (*topic == '/') {
+    if (topic < end && *topic == '/') {
         ++topic;
-        if (*topic == '+') {
-            msg->channel = LWESP_CAYENNE_ALL_CHANNELS;
-        } else if (*topic == '#') {
+        if (topic < end && (*topic == '+' || *topic == '#')) {
             msg->channel = LWESP_CAYENNE_ALL_CHANNELS;
-        } else if (*topic >= '0' && *topic <= '9') {
+        } else if (topic < end && *topic >= '0' && *topic <= '9') {
             msg->channel = 0;
-            while (*topic >= '0' && *topic <= '9') {
+            while (topic < end && *topic >= '0' && *topic <= '9') {
                 msg->channel = 10 * msg->channel + *topic - '0';
                 ++topic;
             }
@@ -184,21 +154,38 @@ parse_topic(lwesp_cayenne_t* c, lwesp_mqtt_client_api_buf_p buf) {
 }
 
 /**
- * \brief           Parse received data from MQTT channel
+ * \brief           Parse received topic string
  * \param[in]       c: Cayenne handle
- * \param[in]       buf: MQTT buffer with received data
+ * \param[out]      msg: Message to fill
+ * \param[in]       topic: Received topic, does not need to be NULL terminated
+ * \param[in]       len: Length of topic
  * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
  */
 static lwespr_t
-parse_payload(lwesp_cayenne_t* c, lwesp_mqtt_client_api_buf_p buf) {
-    lwesp_cayenne_msg_t* msg;
-    char* payload;
-
+parse_topic(lwesp_cayenne_t* c, lwesp_cayenne_msg_t* msg, const char* topic, size_t len) {
     LWESP_ASSERT("c != NULL", c != NULL);
-    LWESP_ASSERT("buf != NULL", buf != NULL);
+    LWESP_ASSERT("topic != NULL", topic != NULL);
+
+    LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] Parsing received topic: %.*s\r\n", (int)len, topic);
 
-    msg = &c->msg;                              /* Get message handle */
-    payload = (void*)buf->payload;              /* Get payload data */
+    /* Prefix is fixed for handle, compare it in single step */
+    if (len < c->topic_prefix_len || memcmp(topic, c->topic_prefix, c->topic_prefix_len)) {
+        return lwespERR;
+    }
+    return parse_topic_suffix(msg, topic + c->topic_prefix_len, len - c->topic_prefix_len);
+}
+
+/**
+ * \brief           Parse received data from MQTT channel
+ * \param[out]      msg: Message with parsed topic
+ * \param[in]       payload: Received payload, NULL terminated and modified during parsing
+ * \param[in]       len: Length of payload
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+static lwespr_t
+parse_payload(lwesp_cayenne_msg_t* msg, char* payload, size_t len) {
+    LWESP_ASSERT("msg != NULL", msg != NULL);
+    LWESP_ASSERT("payload != NULL", payload != NULL);
 
     LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] Parsing received payload\r\n");
 
@@ -207,7 +194,7 @@ parse_payload(lwesp_cayenne_t* c, lwesp_mqtt_client_api_buf_p buf) {
     /* Parse topic format here */
     switch (msg->topic) {
         case LWESP_CAYENNE_TOPIC_DATA: {
-            LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] TOPIC DATA: %*s\r\n", (int)buf->payload_len, (const char*)buf->payload);
+            LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] TOPIC DATA: %.*s\r\n", (int)len, payload);
             /* Parse data with '=' separator */
             break;
         }
@@ -215,7 +202,7 @@ parse_payload(lwesp_cayenne_t* c, lwesp_mqtt_client_api_buf_p buf) {
         case LWESP_CAYENNE_TOPIC_ANALOG_COMMAND:
         case LWESP_CAYENNE_TOPIC_DIGITAL_COMMAND: {
             /* Parsing "sequence,value" */
-            char* comm = strchr(payload, ',');
+            char* comm = memchr(payload, ',', len);
             if (comm != NULL) {
                 *comm = 0;
                 msg->seq = payload;
@@ -229,7 +216,7 @@ parse_payload(lwesp_cayenne_t* c, lwesp_mqtt_client_api_buf_p buf) {
             break;
         }
         case LWESP_CAYENNE_TOPIC_ANALOG: {
-            LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] TOPIC ANALOG: %*s\r\n", (int)buf->payload_len, (const char*)buf->payload);
+            LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] TOPIC ANALOG: %.*s\r\n", (int)len, payload);
             /* Here parse type,value */
         }
         default:
@@ -240,38 +227,83 @@ parse_payload(lwesp_cayenne_t* c, lwesp_mqtt_client_api_buf_p buf) {
 }
 
 /**
- * \brief           Build topic string based on input parameters
- * \param[in]       topic_str: Output variable for created topic
+ * \brief           Parse received packet in MQTT receive context, without buffer allocation
+ *
+ * Payload is copied to handle memory and message is parsed to `rx_msg` member.
+ * Packet is processed in default way when previous message is still pending or it does not fit to memory
+ *
+ * \param[in]       api_c: MQTT API client handle
+ * \param[in]       view: Received packet
+ * \param[in]       arg: Cayenne handle
+ * \return          Cayenne receive buffer on success, `NULL` otherwise
+ */
+static lwesp_mqtt_client_api_buf_p
+mqtt_recv_view(lwesp_mqtt_client_api_p api_c, const lwesp_mqtt_client_api_buf_t* view, void* arg) {
+    lwesp_cayenne_t* c = arg;
+
+    LWESP_UNUSED(api_c);
+    if (c->rx_busy || view->payload_len >= sizeof(c->rx_payload)
+        || parse_topic(c, &c->rx_msg, view->topic, view->topic_len) != lwespOK) {
+        return NULL;
+    }
+    LWESP_MEMCPY(c->rx_payload, view->payload, view->payload_len);
+    c->rx_payload[view->payload_len] = 0;
+    if (parse_payload(&c->rx_msg, c->rx_payload, view->payload_len) != lwespOK) {
+        return NULL;
+    }
+    c->rx_busy = 1;                             /* Cleared by Cayenne thread after user event */
+    return &c->rx_buf;
+}
+
+/**
+ * \brief           Build `v1/<user>/things/<id>/` topic prefix
+ * \param[in]       topic_str: Output variable for created prefix
  * \param[in]       topic_str_len: Length of topic_str param including NULL termination
  * \param[in]       username: MQTT username
  * \param[in]       client_id: MQTT client id
- * \param[in]       topic: Cayenne topic
- * \param[in]       channel: Cayenne channel
  * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
  */
 static lwespr_t
-build_topic(char* topic_str, size_t topic_str_len, const char* username,
-            const char* client_id, lwesp_cayenne_topic_t topic, uint16_t channel) {
-    size_t rem_len;
-    char ch_token[6];
-
+build_topic_prefix(char* topic_str, size_t topic_str_len, const char* username, const char* client_id) {
     LWESP_ASSERT("topic_str != NULL", topic_str != NULL);
     LWESP_ASSERT("username != NULL", username != NULL);
     LWESP_ASSERT("client_id != NULL", client_id != NULL);
-    LWESP_ASSERT("topic < LWESP_CAYENNE_TOPIC_END", topic < LWESP_CAYENNE_TOPIC_END);
 
     /* Assert for basic part without topic */
     LWESP_ASSERT("topic_str_len > string_length", topic_str_len > (strlen(LWESP_CAYENNE_API_VERSION) + strlen(username) + strlen(client_id) + 11));
 
     topic_str[0] = 0;
-
-    /* Base part */
     strcat(topic_str, LWESP_CAYENNE_API_VERSION);
     strcat(topic_str, "/");
     strcat(topic_str, username);
     strcat(topic_str, "/things/");
     strcat(topic_str, client_id);
     strcat(topic_str, "/");
+    return lwespOK;
+}
+
+/**
+ * \brief           Build topic string based on input parameters
+ * \param[in]       topic_str: Output variable for created topic
+ * \param[in]       topic_str_len: Length of topic_str param including NULL termination
+ * \param[in]       username: MQTT username
+ * \param[in]       client_id: MQTT client id
+ * \param[in]       topic: Cayenne topic
+ * \param[in]       channel: Cayenne channel
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+static lwespr_t
+build_topic(char* topic_str, size_t topic_str_len, const char* username,
+            const char* client_id, lwesp_cayenne_topic_t topic, uint16_t channel) {
+    size_t rem_len;
+    char ch_token[6];
+
+    LWESP_ASSERT("topic < LWESP_CAYENNE_TOPIC_END", topic < LWESP_CAYENNE_TOPIC_END);
+
+    /* Base part */
+    if (build_topic_prefix(topic_str, topic_str_len, username, client_id) != lwespOK) {
+        return lwespERR;
+    }
     rem_len = topic_str_len - strlen(topic_str) - 1;
 
     /* Topic string */
@@ -303,97 +335,256 @@ build_topic(char* topic_str, size_t topic_str_len, const char* username,
 }
 
 /**
- * \brief           Cayenne thread
- * \param[in]       arg: Thread argument. Pointer to \ref lwesp_mqtt_client_cayenne_t structure
+ * \brief           Build data payload string in `type,unit=data` format
+ * \param[out]      out: Output buffer, set to `NULL` to only calculate length
+ * \param[in]       type: Data type, can be `NULL`
+ * \param[in]       unit: Data unit, can be `NULL`
+ * \param[in]       data: Data value
+ * \return          Length of payload without NULL termination
  */
-static void
-mqtt_thread(void* const arg) {
-    lwesp_cayenne_t* c = arg;
-    lwesp_mqtt_conn_status_t status;
-    lwesp_mqtt_client_api_buf_p buf;
-    lwespr_t res;
+static size_t
+build_payload(char* out, const char* type, const char* unit, const char* data) {
+    size_t len = 0;
 
-    /* Create sync mutex for multiple cayenne accesses */
-    lwesp_core_lock();
-    if (!lwesp_sys_mutex_isvalid(&prot_mutex)) {
-        lwesp_sys_mutex_create(&prot_mutex);
+    if (out != NULL) {
+        out[0] = 0;
+    }
+    if (type != NULL) {
+        len += strlen(type);
+    }
+    if (unit != NULL) {
+        len += strlen(unit) + (type != NULL ? 1 : 0);
+    }
+    if (len > 0) {
+        ++len;
+    }
+    len += strlen(data);
+    if (out != NULL) {
+        if (type != NULL) {
+            strcat(out, type);
+        }
+        if (type != NULL && unit != NULL) {
+            strcat(out, ",");
+        }
+        if (unit != NULL) {
+            strcat(out, unit);
+        }
+        if (strlen(out)) {
+            strcat(out, "=");
+        }
+        strcat(out, data);
+    }
+    return len;
+}
 
-        LWESP_DEBUGW(LWESP_CFG_DBG_CAYENNE_TRACE, lwesp_sys_mutex_isvalid(&prot_mutex), "[CAYENNE] New mutex created\r\n");
-        LWESP_DEBUGW(LWESP_CFG_DBG_CAYENNE_TRACE_SEVERE, !lwesp_sys_mutex_isvalid(&prot_mutex), "[CAYENNE] Cannot create mutex\r\n");
+/**
+ * \brief           Get topic string from handle cache, build it on miss
+ * \param[in]       c: Cayenne handle
+ * \param[in]       topic: Cayenne topic
+ * \param[in]       channel: Cayenne channel
+ * \param[in,out]   used: Bit mask of entries used by current batch, these are not replaced
+ * \return          Topic string on success, `NULL` otherwise
+ */
+static const char*
+get_cached_topic(lwesp_cayenne_t* c, lwesp_cayenne_topic_t topic, uint16_t channel, uint32_t* used) {
+    lwesp_cayenne_topic_cache_t* e;
+    size_t idx;
+
+    for (idx = 0; idx < LWESP_ARRAYSIZE(c->topic_cache); ++idx) {
+        e = &c->topic_cache[idx];
+        if (e->str[0] != 0 && e->topic == topic && e->channel == channel) {
+            *used |= 1UL << idx;
+            return e->str;
+        }
     }
-    lwesp_core_unlock();
 
-    /* Release calling thread now */
-    if (lwesp_sys_sem_isvalid(&c->sem)) {
-        lwesp_sys_sem_release(&c->sem);
+    /* Replace next entry not used by current batch */
+    do {
+        idx = c->topic_cache_next;
+        c->topic_cache_next = (c->topic_cache_next + 1) % LWESP_ARRAYSIZE(c->topic_cache);
+    } while (*used & (1UL << idx));
+    e = &c->topic_cache[idx];
+    e->str[0] = 0;
+    if (build_topic(e->str, sizeof(e->str), c->info_c->user, c->info_c->id, topic, channel) != lwespOK) {
+        e->str[0] = 0;
+        return NULL;
     }
+    e->topic = topic;
+    e->channel = channel;
+    *used |= 1UL << idx;
+    return e->str;
+}
 
-    while (1) {
-        /* Device must be connected to access point */
-        while (!lwesp_sta_has_ip()) {
-            lwesp_delay(1000);
+/**
+ * \brief           Process received packet or connection close of Cayenne instance
+ * \param[in]       c: Cayenne handle
+ * \param[in]       res: Receive result
+ * \param[in]       buf: Received buffer, `NULL` on connection close
+ */
+static void
+process_received(lwesp_cayenne_t* c, lwespr_t res, lwesp_mqtt_client_api_buf_p buf) {
+    lwesp_cayenne_msg_t* msg;
+
+    if (res == lwespCLOSED) {
+        /* Connection closed at this point, worker reconnects it */
+        c->connected = 0;
+        c->evt.type = LWESP_CAYENNE_EVT_DISCONNECT;
+        c->evt_fn(c, &c->evt);
+        return;
+    }
+    if (res != lwespOK || buf == NULL) {
+        return;
+    }
+    LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] Packet received\r\n");
+
+    /* Message parsed in receive context or parse received topic and payload now */
+    if (buf == &c->rx_buf) {
+        msg = &c->rx_msg;
+    } else if (parse_topic(c, &c->msg, buf->topic, buf->topic_len) == lwespOK
+               && parse_payload(&c->msg, (char*)buf->payload, buf->payload_len) == lwespOK) {
+        msg = &c->msg;
+    } else {
+        msg = NULL;
+    }
+    if (msg != NULL) {
+        LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] Topic and payload parsed!\r\n");
+        LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] Channel: %d, Sequence: %s, Key: %s, Value: %s\r\n",
+                   (int)msg->channel, msg->seq, msg->values[0].key, msg->values[0].value
+                  );
+
+        /* Send notification to user */
+        c->evt.type = LWESP_CAYENNE_EVT_DATA;
+        c->evt.evt.data.msg = msg;
+        c->evt_fn(c, &c->evt);
+    }
+
+    if (buf == &c->rx_buf) {
+        c->rx_busy = 0;                         /* Receive context may parse next message */
+    } else {
+        lwesp_mqtt_client_api_buf_free(buf);
+    }
+}
+
+/**
+ * \brief           Connect all disconnected Cayenne instances
+ * \return          `1` if any instance remains disconnected, `0` otherwise
+ */
+static uint8_t
+connect_instances(void) {
+    lwesp_mqtt_conn_status_t status;
+    uint8_t pending = 0;
+
+    for (lwesp_cayenne_t* c = worker.instances; c != NULL; c = c->next) {
+        if (c->connected) {
+            continue;
         }
 
         /* Connect to API server */
         status = lwesp_mqtt_client_api_connect(c->api_c, LWESP_CAYENNE_HOST, LWESP_CAYENNE_PORT, c->info_c);
         if (status != LWESP_MQTT_CONN_STATUS_ACCEPTED) {
             /* Find out reason not to be accepted and decide accordingly */
+            pending = 1;
         } else {
+            c->connected = 1;
+
             /* Notify user */
             c->evt.type = LWESP_CAYENNE_EVT_CONNECT;
             c->evt_fn(c, &c->evt);
 
             /* We are connected and ready to subscribe/publish/receive packets */
             lwesp_cayenne_subscribe(c, LWESP_CAYENNE_TOPIC_COMMAND, LWESP_CAYENNE_ALL_CHANNELS);
+        }
+    }
+    return pending;
+}
 
-            /* Unlimited loop */
-            while (1) {
-                /* Wait for new received packet or connection closed */
-                res = lwesp_mqtt_client_api_receive(c->api_c, &buf, 0);
-
-                if (res == lwespOK) {
-                    if (buf != NULL) {
-                        LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] Packet received\r\nTopic: %s\r\nData: %s\r\n\r\n", buf->topic, buf->payload);
-
-                        /* Parse received topic and payload */
-                        if (parse_topic(c, buf) == lwespOK && parse_payload(c, buf) == lwespOK) {
-                            LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] Topic and payload parsed!\r\n");
-                            LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE, "[CAYENNE] Channel: %d, Sequence: %s, Key: %s, Value: %s\r\n",
-                                       (int)c->msg.channel, c->msg.seq, c->msg.values[0].key, c->msg.values[0].value
-                                      );
-
-                            /* Send notification to user */
-                            c->evt.type = LWESP_CAYENNE_EVT_DATA;
-                            c->evt.evt.data.msg = &c->msg;
-                            c->evt_fn(c, &c->evt);
-                        }
-
-                        lwesp_mqtt_client_api_buf_free(buf);
-                        buf = NULL;
-                    }
-                } else if (res == lwespCLOSED) {
-                    /* Connection closed at this point */
-                    c->evt.type = LWESP_CAYENNE_EVT_DISCONNECT;
-                    c->evt_fn(c, &c->evt);
-                    break;
-                }
+/**
+ * \brief           Cayenne worker thread, shared by all Cayenne instances
+ * \param[in]       arg: Thread argument, not used
+ */
+static void
+worker_thread(void* const arg) {
+    lwesp_mqtt_client_api_p api_c;
+    lwesp_mqtt_client_api_buf_p buf;
+    uint8_t pending = 0;
+    lwespr_t res;
+
+    LWESP_UNUSED(arg);
+
+    while (1) {
+        /* Device must be connected to access point, worker is woken up on new IP */
+        if (lwesp_sta_has_ip()) {
+            pending = connect_instances();
+        }
+
+        /* Wait for new received packet, connection closed or wakeup */
+        res = lwesp_mqtt_client_api_group_receive(worker.group, &api_c, &buf,
+                                                  pending ? LWESP_CAYENNE_RECONNECT_DELAY : LWESP_CAYENNE_IDLE_TIMEOUT);
+        if (res == lwespTIMEOUT || api_c == NULL) {
+            continue;
+        }
+        for (lwesp_cayenne_t* c = worker.instances; c != NULL; c = c->next) {
+            if (c->api_c == api_c) {
+                process_received(c, res, buf);
+                buf = NULL;
+                break;
             }
         }
+        if (buf != NULL) {                      /* Client not found, should not happen */
+            lwesp_mqtt_client_api_buf_free(buf);
+        }
     }
+}
 
-    /* Clean resources */
-    if (lwesp_sys_sem_isvalid(&c->sem)) {
-        lwesp_sys_sem_delete(&c->sem);
-        lwesp_sys_sem_invalid(&c->sem);
+/**
+ * \brief           Global event callback to wake up worker when station gets IP
+ * \param[in]       evt: Event information
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+static lwespr_t
+worker_evt(lwesp_evt_t* evt) {
+    if (lwesp_evt_get_type(evt) == LWESP_EVT_WIFI_GOT_IP && worker.group != NULL) {
+        lwesp_mqtt_client_api_group_wakeup(worker.group);
     }
+    return lwespOK;
+}
+
+/**
+ * \brief           Create protection mutex, shared receive group and worker thread on first use
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+static lwespr_t
+worker_init(void) {
+    lwespr_t res = lwespOK;
 
-    lwesp_sys_thread_terminate(NULL);           /* Terminate thread */
+    lwesp_core_lock();
+    if (!lwesp_sys_mutex_isvalid(&prot_mutex)) {
+        lwesp_sys_mutex_create(&prot_mutex);
+
+        LWESP_DEBUGW(LWESP_CFG_DBG_CAYENNE_TRACE, lwesp_sys_mutex_isvalid(&prot_mutex), "[CAYENNE] New mutex created\r\n");
+        LWESP_DEBUGW(LWESP_CFG_DBG_CAYENNE_TRACE_SEVERE, !lwesp_sys_mutex_isvalid(&prot_mutex), "[CAYENNE] Cannot create mutex\r\n");
+    }
+    if (!lwesp_sys_mutex_isvalid(&prot_mutex)) {
+        res = lwespERRMEM;
+    } else if (worker.group == NULL) {
+        if ((worker.group = lwesp_mqtt_client_api_group_new(LWESP_CAYENNE_WORKER_QUEUE_LEN)) == NULL) {
+            res = lwespERRMEM;
+        } else if (!lwesp_sys_thread_create(&worker.thread, "mqtt_cayenne", worker_thread, NULL, LWESP_SYS_THREAD_SS, LWESP_SYS_THREAD_PRIO)) {
+            LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE_SEVERE, "[CAYENNE] Cannot create new thread\r\n");
+            lwesp_mqtt_client_api_group_delete(worker.group);
+            worker.group = NULL;
+            res = lwespERRMEM;
+        } else {
+            lwesp_evt_register(worker_evt);
+        }
+    }
+    lwesp_core_unlock();
+    return res;
 }
 
 /**
  * \brief           Create new instance of cayenne MQTT connection
- * \note            Each call to this functions starts new thread for async receive processing.
- *                  Function will block until thread is created and successfully started
+ * \note            All instances are served by single worker thread, started with first instance
  * \param[in]       c: Cayenne empty handle
  * \param[in]       client_info: MQTT client info with username, password and id
  * \param[in]       evt_fn: Event function
@@ -401,37 +592,42 @@ mqtt_thread(void* const arg) {
  */
 lwespr_t
 lwesp_cayenne_create(lwesp_cayenne_t* c, const lwesp_mqtt_client_info_t* client_info, lwesp_cayenne_evt_fn evt_fn) {
+    lwespr_t res;
+
     LWESP_ASSERT("c != NULL", c != NULL);
     LWESP_ASSERT("client_info != NULL", client_info != NULL);
     LWESP_ASSERT("evt_fn != NULL", evt_fn != NULL);
 
-    c->api_c = lwesp_mqtt_client_api_new(256, 256);
-    c->info_c = client_info;
-    c->evt_fn = evt_fn;
-    if (c->api_c == NULL) {
-        return lwespERRMEM;
+    /* Prefix of all topics is fixed, received topics are matched against it */
+    if (build_topic_prefix(c->topic_prefix, sizeof(c->topic_prefix), client_info->user, client_info->id) != lwespOK) {
+        return lwespPARERR;
     }
+    c->topic_prefix_len = strlen(c->topic_prefix);
+    c->rx_busy = 0;
+    c->connected = 0;
 
-    /* Create semaphore */
-    if (!lwesp_sys_sem_create(&c->sem, 1)) {
-        LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE_SEVERE, "[CAYENNE] Cannot create semaphore\r\n");
-        return lwespERRMEM;
+    if ((res = worker_init()) != lwespOK) {
+        return res;
     }
 
-    /* Create and wait for thread to start */
-    lwesp_sys_sem_wait(&c->sem, 0);
-    if (!lwesp_sys_thread_create(&c->thread, "mqtt_cayenne", mqtt_thread, c, LWESP_SYS_THREAD_SS, LWESP_SYS_THREAD_PRIO)) {
-        LWESP_DEBUGF(LWESP_CFG_DBG_CAYENNE_TRACE_SEVERE, "[CAYENNE] Cannot create new thread\r\n");
-        lwesp_sys_sem_release(&c->sem);
-        lwesp_sys_sem_delete(&c->sem);
-        lwesp_sys_sem_invalid(&c->sem);
-        lwesp_mem_free_s((void**)&c->api_c);
-        c->info_c = NULL;
+    c->api_c = lwesp_mqtt_client_api_new_in_group(worker.group, 256, 256);
+    c->info_c = client_info;
+    c->evt_fn = evt_fn;
+    LWESP_MEMSET(c->topic_cache, 0x00, sizeof(c->topic_cache));
+    c->topic_cache_next = 0;
+    if (c->api_c == NULL) {
         return lwespERRMEM;
     }
-    lwesp_sys_sem_wait(&c->sem, 0);
-    lwesp_sys_sem_release(&c->sem);
+    c->rx_buf.client = c->api_c;                /* Group receive reports owner of buffer */
+    lwesp_mqtt_client_api_set_recv_fn(c->api_c, mqtt_recv_view, c);
 
+    /* Add to list of instances, worker only walks it and never removes entries */
+    lwesp_core_lock();
+    c->next = worker.instances;
+    worker.instances = c;
+    lwesp_core_unlock();
+
+    lwesp_mqtt_client_api_group_wakeup(worker.group);  /* Connect new instance */
     return lwespOK;
 }
 
@@ -502,20 +698,7 @@ lwesp_cayenne_publish_data(lwesp_cayenne_t* c, lwesp_cayenne_topic_t topic, uint
     if ((res = build_topic(topic_name, sizeof(topic_name), c->info_c->user, c->info_c->id, topic, channel)) != lwespOK) {
         goto exit;
     }
-    payload_data[0] = 0;
-    if (type != NULL) {
-        strcat(payload_data, type);
-    }
-    if (type != NULL && unit != NULL) {
-        strcat(payload_data, ",");
-    }
-    if (unit != NULL) {
-        strcat(payload_data, unit);
-    }
-    if (strlen(payload_data)) {
-        strcat(payload_data, "=");
-    }
-    strcat(payload_data, data);
+    build_payload(payload_data, type, unit, data);
 
     res = lwesp_mqtt_client_api_publish(c->api_c, topic_name, payload_data, strlen(payload_data), LWESP_MQTT_QOS_AT_LEAST_ONCE, 1);
 exit:
@@ -523,6 +706,77 @@ exit:
     return res;
 }
 
+/**
+ * \brief           Publish multiple channel values in bursts of MQTT packets
+ *
+ * Up to \ref LWESP_CAYENNE_TOPIC_CACHE_LEN messages are written to output together and sent with single flush,
+ * function waits once per burst for all acknowledges. Topics are kept in handle cache for next calls.
+ *
+ * \param[in]       c: Cayenne handle
+ * \param[in]       data: Array of channel values
+ * \param[in]       count: Number of entries in array
+ * \param[out]      results: Optional array of `count` entries to write result of each value to.
+ *                      Set to `NULL` if not used
+ * \return          \ref lwespOK if all values were published, member of \ref lwespr_t otherwise
+ */
+lwespr_t
+lwesp_cayenne_publish_data_many(lwesp_cayenne_t* c, const lwesp_cayenne_data_t* data, size_t count, lwespr_t* results) {
+    lwesp_mqtt_pub_msg_t msgs[LWESP_CAYENNE_TOPIC_CACHE_LEN];
+    lwespr_t res = lwespOK;
+    size_t off, cnt, len;
+    uint32_t used;
+    char* payloads, *p;
+
+    LWESP_ASSERT("c != NULL", c != NULL);
+    LWESP_ASSERT("data != NULL", data != NULL);
+    LWESP_ASSERT("count > 0", count > 0);
+
+    lwesp_sys_mutex_lock(&prot_mutex);
+    for (off = 0; off < count && res == lwespOK; off += cnt) {
+        cnt = LWESP_MIN(count - off, LWESP_ARRAYSIZE(msgs));
+
+        /* Single memory block for all payloads of burst */
+        len = 0;
+        for (size_t i = 0; i < cnt; ++i) {
+            len += build_payload(NULL, data[off + i].type, data[off + i].unit, data[off + i].data) + 1;
+        }
+        if ((payloads = lwesp_mem_malloc(len)) == NULL) {
+            res = lwespERRMEM;
+            break;
+        }
+
+        used = 0;
+        p = payloads;
+        for (size_t i = 0; i < cnt; ++i) {
+            const lwesp_cayenne_data_t* d = &data[off + i];
+
+            if ((msgs[i].topic = get_cached_topic(c, d->topic, d->channel, &used)) == NULL) {
+                res = lwespERR;
+                break;
+            }
+            msgs[i].payload = p;
+            msgs[i].len = LWESP_U16(build_payload(p, d->type, d->unit, d->data));
+            msgs[i].qos = LWESP_MQTT_QOS_AT_LEAST_ONCE;
+            msgs[i].retain = 1;
+            msgs[i].arg = results != NULL ? &results[off + i] : NULL;
+            p += msgs[i].len + 1;
+        }
+        if (res == lwespOK) {
+            res = lwesp_mqtt_client_api_publish_many(c->api_c, msgs, cnt);
+        } else {
+            cnt = 0;                            /* Not published, reported below */
+        }
+        lwesp_mem_free_s((void**)&payloads);
+    }
+    if (res != lwespOK && results != NULL) {
+        for (; off < count; ++off) {            /* Values not sent */
+            results[off] = res;
+        }
+    }
+    lwesp_sys_mutex_unlock(&prot_mutex);
+    return res;
+}
+
 /**
  * \brief           Publish response message to command
  * \param[in]       c: Cayenne handle
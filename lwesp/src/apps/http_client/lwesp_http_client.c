@@ -0,0 +1,860 @@
+/**
+ * \file            lwesp_http_client.c
+ * \brief           HTTP client
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include <string.h>
+#include "lwesp/apps/lwesp_http_client.h"
+#include "lwesp/lwesp_mem.h"
+#include "lwesp/lwesp_pbuf.h"
+
+#if LWESP_CFG_STATIC_ONLY
+#error "HTTP client allocates memory at runtime and cannot be used with LWESP_CFG_STATIC_ONLY!"
+#endif /* LWESP_CFG_STATIC_ONLY */
+
+/* Tracing debug message */
+#define LWESP_CFG_DBG_HTTP_CLIENT_TRACE           (LWESP_CFG_DBG_HTTP_CLIENT | LWESP_DBG_TYPE_TRACE)
+#define LWESP_CFG_DBG_HTTP_CLIENT_TRACE_WARNING   (LWESP_CFG_DBG_HTTP_CLIENT | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING)
+
+/**
+ * \brief           State of single client connection
+ */
+typedef enum {
+    HTTP_CONN_CLOSED = 0x00,                    /*!< Connection is not open */
+    HTTP_CONN_CONNECTING,                       /*!< Connection is being established */
+    HTTP_CONN_IDLE,                             /*!< Connection is open and ready for next request */
+    HTTP_CONN_BUSY,                             /*!< Request is being executed on connection */
+    HTTP_CONN_CLOSING,                          /*!< Connection is being closed */
+} http_conn_state_t;
+
+/**
+ * \brief           Response parser state
+ */
+typedef enum {
+    HTTP_PARSE_STATUS = 0x00,                   /*!< Waiting for status line */
+    HTTP_PARSE_HEADER,                          /*!< Receiving header lines */
+    HTTP_PARSE_BODY_LEN,                        /*!< Receiving body with known length */
+    HTTP_PARSE_BODY_CLOSE,                      /*!< Receiving body until connection is closed */
+    HTTP_PARSE_CHUNK_SIZE,                      /*!< Waiting for chunk size line */
+    HTTP_PARSE_CHUNK_DATA,                      /*!< Receiving chunk data */
+    HTTP_PARSE_CHUNK_DATA_END,                  /*!< Waiting for `CRLF` after chunk data */
+    HTTP_PARSE_CHUNK_TRAILER,                   /*!< Receiving trailer lines after last chunk */
+    HTTP_PARSE_DONE,                            /*!< Response has been received */
+} http_parse_state_t;
+
+/**
+ * \brief           Request entry
+ */
+typedef struct {
+    lwesp_http_client_req_t req;                /*!< Request description */
+    uint8_t retried;                            /*!< Set to `1` when request was sent again after stale connection */
+} http_req_entry_t;
+
+/**
+ * \brief           Single connection of HTTP client
+ */
+typedef struct {
+    struct lwesp_http_client* client;           /*!< Client connection belongs to */
+    lwesp_conn_p conn;                          /*!< Connection handle */
+    http_conn_state_t state;                    /*!< Connection state */
+    uint32_t time;                              /*!< Time of last activity in units of milliseconds */
+    uint8_t reused;                             /*!< Set to `1` when at least one response was received on connection */
+
+    http_req_entry_t entry;                     /*!< Request being executed */
+    uint8_t has_req;                            /*!< Set to `1` when `entry` is valid */
+    uint8_t recv_any;                           /*!< Set to `1` when any response data was received for request */
+
+    http_parse_state_t parse_state;             /*!< Response parser state */
+    uint16_t status;                            /*!< Response status code */
+    uint8_t conn_close;                         /*!< Set to `1` when connection is closed after response */
+    uint8_t chunked;                            /*!< Set to `1` for chunked transfer encoding */
+    int32_t content_length;                     /*!< Value of `Content-Length` header, `-1` when not received */
+    uint32_t body_rem;                          /*!< Remaining length of body or current chunk */
+    char line[LWESP_CFG_HTTP_CLIENT_LINE_LEN];  /*!< Current line */
+    size_t line_len;                            /*!< Length of current line */
+} http_conn_t;
+
+/**
+ * \brief           HTTP client
+ */
+typedef struct lwesp_http_client {
+    const char* host;                           /*!< Server host name, stored after structure */
+    lwesp_port_t port;                          /*!< Server port */
+    lwesp_conn_type_t type;                     /*!< Connection type */
+    http_conn_t conns[LWESP_CFG_HTTP_CLIENT_MAX_CONNS]; /*!< Persistent connections */
+    http_req_entry_t queue[LWESP_CFG_HTTP_CLIENT_MAX_REQUESTS]; /*!< FIFO of requests waiting for connection */
+    uint8_t queue_r;                            /*!< Read index of request FIFO */
+    uint8_t queue_cnt;                          /*!< Number of entries in request FIFO */
+    uint8_t deleted;                            /*!< Set to `1` when client is freed once all connections are closed */
+} lwesp_http_client_t;
+
+static lwespr_t http_conn_cb(lwesp_evt_t* evt);
+
+/**
+ * \brief           Case insensitive compare of string with lowercase constant
+ * \param[in]       str: String to compare
+ * \param[in]       lc: Lowercase string to compare with
+ * \return          `1` when equal, `0` otherwise
+ */
+static uint8_t
+http_str_eq(const char* str, const char* lc) {
+    for (; *str != '\0' && *lc != '\0'; ++str, ++lc) {
+        char c = *str;
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        if (c != *lc) {
+            return 0;
+        }
+    }
+    return *str == *lc;
+}
+
+/**
+ * \brief           Check if header value contains token
+ * \param[in]       value: Header value
+ * \param[in]       lc: Lowercase token to find
+ * \return          `1` when found, `0` otherwise
+ */
+static uint8_t
+http_value_has(const char* value, const char* lc) {
+    char token[16];
+
+    while (*value != '\0') {
+        size_t len = 0;
+
+        while (*value == ' ' || *value == ',') {
+            ++value;
+        }
+        while (*value != '\0' && *value != ',' && *value != ' ') {
+            if (len < sizeof(token) - 1) {
+                token[len++] = *value;
+            }
+            ++value;
+        }
+        token[len] = '\0';
+        if (len > 0 && http_str_eq(token, lc)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Send event to user for request on connection
+ * \param[in]       hc: Client connection
+ * \param[in]       evt: Event to send
+ */
+static void
+http_send_evt(http_conn_t* hc, lwesp_http_client_evt_t* evt) {
+    evt->arg = hc->entry.req.arg;
+    evt->status = hc->status;
+    if (hc->entry.req.evt_fn != NULL) {
+        hc->entry.req.evt_fn(hc->client, evt);
+    }
+}
+
+/**
+ * \brief           Finish request without connection
+ * \param[in]       client: HTTP client
+ * \param[in]       req: Request to finish
+ * \param[in]       res: Result of request
+ */
+static void
+http_req_fail(lwesp_http_client_p client, const lwesp_http_client_req_t* req, lwespr_t res) {
+    lwesp_http_client_evt_t evt = {0};
+
+    if (req->evt_fn != NULL) {
+        evt.type = LWESP_HTTP_CLIENT_EVT_DONE;
+        evt.arg = req->arg;
+        evt.evt.done.res = res;
+        req->evt_fn(client, &evt);
+    }
+}
+
+/**
+ * \brief           Finish request on connection and notify user
+ * \param[in]       hc: Client connection
+ * \param[in]       res: Result of request
+ */
+static void
+http_req_done(http_conn_t* hc, lwespr_t res) {
+    lwesp_http_client_evt_t evt = {0};
+
+    if (!hc->has_req) {
+        return;
+    }
+    hc->has_req = 0;
+    hc->parse_state = HTTP_PARSE_DONE;
+    LWESP_DEBUGF(LWESP_CFG_DBG_HTTP_CLIENT_TRACE,
+               "[HTTP CLIENT] Request done, status %d, result %d\r\n", (int)hc->status, (int)res);
+    evt.type = LWESP_HTTP_CLIENT_EVT_DONE;
+    evt.evt.done.res = res;
+    http_send_evt(hc, &evt);
+}
+
+/**
+ * \brief           Start closing connection
+ * \param[in]       hc: Client connection
+ */
+static void
+http_conn_close(http_conn_t* hc) {
+    if (hc->conn != NULL && (hc->state == HTTP_CONN_IDLE || hc->state == HTTP_CONN_BUSY)) {
+        hc->state = HTTP_CONN_CLOSING;
+        lwesp_conn_close(hc->conn, 0);
+    }
+}
+
+/**
+ * \brief           Fail current request and close connection, as its state is unknown
+ * \param[in]       hc: Client connection
+ * \param[in]       res: Result of request
+ */
+static void
+http_conn_fail(http_conn_t* hc, lwespr_t res) {
+    http_req_done(hc, res);
+    http_conn_close(hc);
+}
+
+/**
+ * \brief           Add request to FIFO
+ * \param[in]       client: HTTP client
+ * \param[in]       entry: Request entry to add
+ * \param[in]       front: Set to `1` to add it as first entry
+ * \return          `1` on success, `0` when FIFO is full
+ */
+static uint8_t
+http_queue_add(lwesp_http_client_p client, const http_req_entry_t* entry, uint8_t front) {
+    size_t idx;
+
+    if (client->queue_cnt >= LWESP_ARRAYSIZE(client->queue)) {
+        return 0;
+    }
+    if (front) {
+        client->queue_r = (uint8_t)((client->queue_r + LWESP_ARRAYSIZE(client->queue) - 1) % LWESP_ARRAYSIZE(client->queue));
+        idx = client->queue_r;
+    } else {
+        idx = (client->queue_r + client->queue_cnt) % LWESP_ARRAYSIZE(client->queue);
+    }
+    client->queue[idx] = *entry;
+    ++client->queue_cnt;
+    return 1;
+}
+
+/**
+ * \brief           Remove first request from FIFO
+ * \param[in]       client: HTTP client
+ * \param[out]      entry: Output entry
+ */
+static void
+http_queue_get(lwesp_http_client_p client, http_req_entry_t* entry) {
+    *entry = client->queue[client->queue_r];
+    client->queue_r = (uint8_t)((client->queue_r + 1) % LWESP_ARRAYSIZE(client->queue));
+    --client->queue_cnt;
+}
+
+/**
+ * \brief           Write null-terminated string to connection buffer
+ * \param[in]       hc: Client connection
+ * \param[in]       str: String to write
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+http_write_str(http_conn_t* hc, const char* str) {
+    return lwesp_conn_write(hc->conn, str, strlen(str), 0, NULL);
+}
+
+/**
+ * \brief           Write request head and body to connection
+ * \param[in]       hc: Client connection with request
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+http_send_request(http_conn_t* hc) {
+    const lwesp_http_client_req_t* req = &hc->entry.req;
+    lwesp_http_client_p client = hc->client;
+    char num[11];
+    lwespr_t res;
+
+    res = http_write_str(hc, req->method != NULL ? req->method : "GET");
+    res = res == lwespOK ? http_write_str(hc, " ") : res;
+    res = res == lwespOK ? http_write_str(hc, req->path != NULL ? req->path : "/") : res;
+    res = res == lwespOK ? http_write_str(hc, " HTTP/1.1\r\nHost: ") : res;
+    res = res == lwespOK ? http_write_str(hc, client->host) : res;
+    if (client->port != (client->type == LWESP_CONN_TYPE_SSL ? 443 : 80)) {
+        lwesp_u16_to_str(client->port, num);
+        res = res == lwespOK ? http_write_str(hc, ":") : res;
+        res = res == lwespOK ? http_write_str(hc, num) : res;
+    }
+    res = res == lwespOK ? http_write_str(hc, "\r\n") : res;
+    if (req->body != NULL || req->body_len > 0) {
+        lwesp_u32_to_str(req->body_len, num);
+        res = res == lwespOK ? http_write_str(hc, "Content-Length: ") : res;
+        res = res == lwespOK ? http_write_str(hc, num) : res;
+        res = res == lwespOK ? http_write_str(hc, "\r\n") : res;
+    }
+    if (req->headers != NULL) {
+        res = res == lwespOK ? http_write_str(hc, req->headers) : res;
+    }
+    res = res == lwespOK ? http_write_str(hc, "\r\n") : res;
+
+    /* Body is sent from user memory and flushed together with head */
+    if (res == lwespOK) {
+        if (req->body_len > 0) {
+            res = lwesp_conn_write_ref(hc->conn, req->body, req->body_len, 1, NULL);
+        } else {
+            res = lwesp_conn_write(hc->conn, NULL, 0, 1, NULL);
+        }
+    }
+    return res;
+}
+
+/**
+ * \brief           Start first queued request on idle connection
+ * \param[in]       hc: Idle client connection
+ */
+static void
+http_start_request(http_conn_t* hc) {
+    http_queue_get(hc->client, &hc->entry);
+    hc->has_req = 1;
+    hc->recv_any = 0;
+    hc->state = HTTP_CONN_BUSY;
+    hc->time = lwesp_sys_now();
+    hc->parse_state = HTTP_PARSE_STATUS;
+    hc->status = 0;
+    hc->line_len = 0;
+
+    LWESP_DEBUGF(LWESP_CFG_DBG_HTTP_CLIENT_TRACE,
+               "[HTTP CLIENT] Sending request on connection %p\r\n", (void*)hc->conn);
+    if (http_send_request(hc) != lwespOK) {
+        http_conn_fail(hc, lwespERRMEM);
+    }
+}
+
+/**
+ * \brief           Assign queued requests to idle connections and open new connections when needed
+ * \param[in]       client: HTTP client
+ */
+static void
+http_dispatch(lwesp_http_client_p client) {
+    size_t connecting = 0;
+
+    if (client->deleted) {
+        return;
+    }
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(client->conns); ++i) {
+        http_conn_t* hc = &client->conns[i];
+
+        if (hc->state == HTTP_CONN_IDLE && client->queue_cnt > 0) {
+            http_start_request(hc);
+        } else if (hc->state == HTTP_CONN_CONNECTING) {
+            ++connecting;
+        }
+    }
+
+    /* Open new connections only for requests not waiting for connection already */
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(client->conns) && client->queue_cnt > connecting; ++i) {
+        http_conn_t* hc = &client->conns[i];
+        lwespr_t res;
+
+        if (hc->state != HTTP_CONN_CLOSED) {
+            continue;
+        }
+        hc->state = HTTP_CONN_CONNECTING;
+        res = lwesp_conn_start(&hc->conn, client->type, client->host, client->port, hc, http_conn_cb, 0);
+        if (res == lwespOK) {
+            ++connecting;
+        } else {
+            http_req_entry_t entry;
+
+            hc->state = HTTP_CONN_CLOSED;
+            http_queue_get(client, &entry);
+            http_req_fail(client, &entry.req, res);
+        }
+    }
+}
+
+/**
+ * \brief           Free client when it was deleted and all connections are closed
+ * \param[in]       client: HTTP client
+ * \return          `1` when client was freed, `0` otherwise
+ */
+static uint8_t
+http_free_check(lwesp_http_client_p client) {
+    if (!client->deleted) {
+        return 0;
+    }
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(client->conns); ++i) {
+        if (client->conns[i].state != HTTP_CONN_CLOSED) {
+            return 0;
+        }
+    }
+    lwesp_mem_free(client);
+    return 1;
+}
+
+/**
+ * \brief           Finish response and decide about connection reuse
+ * \param[in]       hc: Client connection
+ */
+static void
+http_response_done(http_conn_t* hc) {
+    http_req_done(hc, lwespOK);
+    if (hc->conn_close || LWESP_CFG_HTTP_CLIENT_IDLE_TIME == 0 || hc->client->deleted) {
+        http_conn_close(hc);
+    } else {
+        hc->state = HTTP_CONN_IDLE;             /* Next request is started after data are processed */
+        hc->reused = 1;
+        hc->time = lwesp_sys_now();
+    }
+}
+
+/**
+ * \brief           Process all headers received and select body mode
+ * \param[in]       hc: Client connection
+ */
+static void
+http_headers_done(http_conn_t* hc) {
+    lwesp_http_client_evt_t evt = {0};
+    const char* method = hc->entry.req.method;
+    uint8_t no_body;
+
+    no_body = hc->status == 204 || hc->status == 304 || (method != NULL && http_str_eq(method, "head"));
+    evt.type = LWESP_HTTP_CLIENT_EVT_HEADERS_DONE;
+    evt.evt.headers_done.content_length = no_body ? 0 : (hc->chunked ? -1 : hc->content_length);
+    http_send_evt(hc, &evt);
+    if (!hc->has_req) {
+        return;
+    }
+
+    if (no_body || (!hc->chunked && hc->content_length == 0)) {
+        http_response_done(hc);
+    } else if (hc->chunked) {
+        hc->parse_state = HTTP_PARSE_CHUNK_SIZE;
+    } else if (hc->content_length > 0) {
+        hc->body_rem = (uint32_t)hc->content_length;
+        hc->parse_state = HTTP_PARSE_BODY_LEN;
+    } else {
+        hc->conn_close = 1;                     /* Body ends when server closes connection */
+        hc->parse_state = HTTP_PARSE_BODY_CLOSE;
+    }
+}
+
+/**
+ * \brief           Process single header line
+ * \param[in]       hc: Client connection
+ */
+static void
+http_header_line(http_conn_t* hc) {
+    lwesp_http_client_evt_t evt = {0};
+    char *name = hc->line, *value;
+
+    if ((value = strchr(name, ':')) == NULL) {
+        return;                                 /* Not a valid header, ignore it */
+    }
+    *value++ = '\0';
+    while (*value == ' ' || *value == '\t') {
+        ++value;
+    }
+
+    if (http_str_eq(name, "content-length")) {
+        int32_t len = 0;
+
+        for (const char* c = value; *c >= '0' && *c <= '9'; ++c) {
+            len = 10 * len + (*c - '0');
+        }
+        hc->content_length = len;
+    } else if (http_str_eq(name, "transfer-encoding")) {
+        hc->chunked = http_value_has(value, "chunked");
+    } else if (http_str_eq(name, "connection")) {
+        if (http_value_has(value, "close")) {
+            hc->conn_close = 1;
+        } else if (http_value_has(value, "keep-alive")) {
+            hc->conn_close = 0;
+        }
+    }
+
+    evt.type = LWESP_HTTP_CLIENT_EVT_HEADER;
+    evt.evt.header.name = name;
+    evt.evt.header.value = value;
+    http_send_evt(hc, &evt);
+}
+
+/**
+ * \brief           Process received line, without line ending
+ * \param[in]       hc: Client connection
+ */
+static void
+http_process_line(http_conn_t* hc) {
+    switch (hc->parse_state) {
+        case HTTP_PARSE_STATUS: {
+            if (hc->line_len == 0) {
+                break;                          /* Ignore empty lines before status line */
+            }
+            if (hc->line_len < 12 || strncmp(hc->line, "HTTP/1.", 7) || hc->line[8] != ' ') {
+                http_conn_fail(hc, lwespERR);
+                break;
+            }
+            hc->status = (uint16_t)(100 * (hc->line[9] - '0') + 10 * (hc->line[10] - '0') + (hc->line[11] - '0'));
+            hc->conn_close = hc->line[7] == '0';/* HTTP/1.0 closes connection by default */
+            hc->chunked = 0;
+            hc->content_length = -1;
+            hc->parse_state = HTTP_PARSE_HEADER;
+            break;
+        }
+        case HTTP_PARSE_HEADER: {
+            if (hc->line_len > 0) {
+                http_header_line(hc);
+            } else if (hc->status >= 100 && hc->status < 200) {
+                hc->status = 0;                 /* Interim response, wait for final one */
+                hc->parse_state = HTTP_PARSE_STATUS;
+            } else {
+                http_headers_done(hc);
+            }
+            break;
+        }
+        case HTTP_PARSE_CHUNK_SIZE: {
+            uint32_t size = 0;
+            size_t i;
+
+            for (i = 0; i < hc->line_len; ++i) {
+                char c = hc->line[i];
+
+                if (c >= '0' && c <= '9') {
+                    size = (size << 4) | (uint32_t)(c - '0');
+                } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+                    size = (size << 4) | (uint32_t)((c | 0x20) - 'a' + 10);
+                } else {
+                    break;                      /* Chunk extensions are ignored */
+                }
+            }
+            if (i == 0) {
+                http_conn_fail(hc, lwespERR);
+            } else if (size == 0) {
+                hc->parse_state = HTTP_PARSE_CHUNK_TRAILER;
+            } else {
+                hc->body_rem = size;
+                hc->parse_state = HTTP_PARSE_CHUNK_DATA;
+            }
+            break;
+        }
+        case HTTP_PARSE_CHUNK_DATA_END: {
+            hc->parse_state = HTTP_PARSE_CHUNK_SIZE;
+            break;
+        }
+        case HTTP_PARSE_CHUNK_TRAILER: {
+            if (hc->line_len == 0) {
+                http_response_done(hc);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * \brief           Parse received response data
+ * \param[in]       hc: Client connection
+ * \param[in]       d: Received data
+ * \param[in]       len: Length of data in units of bytes
+ */
+static void
+http_parse(http_conn_t* hc, const uint8_t* d, size_t len) {
+    while (len > 0 && hc->has_req) {
+        switch (hc->parse_state) {
+            case HTTP_PARSE_BODY_LEN:
+            case HTTP_PARSE_BODY_CLOSE:
+            case HTTP_PARSE_CHUNK_DATA: {
+                lwesp_http_client_evt_t evt = {0};
+                size_t n = len;
+
+                if (hc->parse_state != HTTP_PARSE_BODY_CLOSE) {
+                    n = LWESP_MIN(len, (size_t)hc->body_rem);
+                    hc->body_rem -= (uint32_t)n;
+                }
+
+                /* Body is passed directly from packet buffer */
+                evt.type = LWESP_HTTP_CLIENT_EVT_BODY;
+                evt.evt.body.data = d;
+                evt.evt.body.len = n;
+                http_send_evt(hc, &evt);
+                d += n;
+                len -= n;
+
+                if (hc->has_req && hc->parse_state != HTTP_PARSE_BODY_CLOSE && hc->body_rem == 0) {
+                    if (hc->parse_state == HTTP_PARSE_BODY_LEN) {
+                        http_response_done(hc);
+                    } else {
+                        hc->line_len = 0;
+                        hc->parse_state = HTTP_PARSE_CHUNK_DATA_END;
+                    }
+                }
+                break;
+            }
+            default: {                          /* Line based states */
+                const uint8_t* lf = memchr(d, '\n', len);
+                size_t n = lf != NULL ? (size_t)(lf - d) : len;
+                size_t copy = LWESP_MIN(n, sizeof(hc->line) - 1 - hc->line_len);
+
+                LWESP_MEMCPY(&hc->line[hc->line_len], d, copy);
+                hc->line_len += copy;           /* Longer lines are truncated */
+                d += n;
+                len -= n;
+                if (lf != NULL) {
+                    ++d;
+                    --len;
+                    if (hc->line_len > 0 && hc->line[hc->line_len - 1] == '\r') {
+                        --hc->line_len;
+                    }
+                    hc->line[hc->line_len] = '\0';
+                    http_process_line(hc);
+                    hc->line_len = 0;
+                }
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Connection callback
+ * \param[in]       evt: Callback parameters
+ * \result          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+http_conn_cb(lwesp_evt_t* evt) {
+    lwesp_conn_p conn = NULL;
+    http_conn_t* hc;
+    lwesp_http_client_p client;
+
+    if (lwesp_evt_get_type(evt) == LWESP_EVT_CONN_ERROR) {
+        hc = lwesp_evt_conn_error_get_arg(evt);
+    } else {
+        conn = lwesp_conn_get_from_evt(evt);
+        if (conn == NULL) {
+            return lwespERR;
+        }
+        if ((hc = lwesp_conn_get_arg(conn)) == NULL) {
+            lwesp_conn_close(conn, 0);          /* Force connection close immediately */
+            return lwespERR;
+        }
+    }
+    if (hc == NULL) {
+        return lwespERR;
+    }
+    client = hc->client;
+
+    switch (lwesp_evt_get_type(evt)) {
+        case LWESP_EVT_CONN_ERROR: {
+            http_req_entry_t entry;
+
+            LWESP_DEBUGF(LWESP_CFG_DBG_HTTP_CLIENT_TRACE_WARNING,
+                       "[HTTP CLIENT] Cannot connect to %s\r\n", client->host);
+            hc->state = HTTP_CONN_CLOSED;
+            hc->conn = NULL;
+            if (client->queue_cnt > 0) {        /* Fail request this connection was opened for */
+                http_queue_get(client, &entry);
+                http_req_fail(client, &entry.req, lwespERRCONNFAIL);
+            }
+            if (!http_free_check(client)) {
+                http_dispatch(client);
+            }
+            break;
+        }
+        case LWESP_EVT_CONN_ACTIVE: {
+            hc->conn = conn;
+            hc->state = HTTP_CONN_IDLE;
+            hc->reused = 0;
+            hc->time = lwesp_sys_now();
+            if (client->deleted) {
+                http_conn_close(hc);
+            } else {
+                http_dispatch(client);
+            }
+            break;
+        }
+        case LWESP_EVT_CONN_RECV: {
+            lwesp_pbuf_p pbuf = lwesp_evt_conn_recv_get_buff(evt);
+            const uint8_t* d;
+            size_t len;
+
+            if (hc->state == HTTP_CONN_BUSY && hc->has_req) {
+                hc->recv_any = 1;
+                hc->time = lwesp_sys_now();
+
+                /* Parse packet buffer chain in place, part by part */
+                for (size_t off = 0; hc->has_req
+                     && (d = lwesp_pbuf_get_linear_addr(pbuf, off, &len)) != NULL; off += len) {
+                    http_parse(hc, d, len);
+                }
+            }
+            lwesp_conn_recved(conn, pbuf);
+            http_dispatch(client);
+            break;
+        }
+        case LWESP_EVT_CONN_SEND: {
+            if (lwesp_evt_conn_send_get_result(evt) != lwespOK && hc->state == HTTP_CONN_BUSY) {
+                http_conn_fail(hc, lwespERR);
+            }
+            break;
+        }
+        case LWESP_EVT_CONN_POLL: {
+            uint32_t diff = lwesp_sys_now() - hc->time;
+
+            if (hc->state == HTTP_CONN_IDLE && diff >= LWESP_CFG_HTTP_CLIENT_IDLE_TIME) {
+                http_conn_close(hc);
+            } else if (hc->state == HTTP_CONN_BUSY && diff >= LWESP_CFG_HTTP_CLIENT_RESP_TIMEOUT) {
+                http_conn_fail(hc, lwespTIMEOUT);
+            }
+            break;
+        }
+        case LWESP_EVT_CONN_CLOSE: {
+            if (hc->has_req) {
+                if (hc->parse_state == HTTP_PARSE_BODY_CLOSE) {
+                    http_req_done(hc, lwespOK); /* Body was terminated by close */
+                } else if (!hc->recv_any && hc->reused && !hc->entry.retried) {
+                    /* Server closed idle connection before request arrived, send it again */
+                    hc->entry.retried = 1;
+                    if (http_queue_add(client, &hc->entry, 1)) {
+                        hc->has_req = 0;
+                    }
+                }
+                http_req_done(hc, lwespCLOSED);
+            }
+            hc->state = HTTP_CONN_CLOSED;
+            hc->conn = NULL;
+            if (!http_free_check(client)) {
+                http_dispatch(client);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return lwespOK;
+}
+
+/**
+ * \brief           Create new HTTP client for single server
+ * \param[in]       host: Server host name or IP address. String is copied
+ * \param[in]       port: Server port
+ * \param[in]       type: Connection type, \ref LWESP_CONN_TYPE_TCP or \ref LWESP_CONN_TYPE_SSL
+ * \return          New HTTP client on success, `NULL` otherwise
+ */
+lwesp_http_client_p
+lwesp_http_client_new(const char* host, lwesp_port_t port, lwesp_conn_type_t type) {
+    lwesp_http_client_p client;
+    size_t host_len;
+
+    if (host == NULL || port == 0) {
+        return NULL;
+    }
+    host_len = strlen(host);
+    client = lwesp_mem_calloc(1, sizeof(*client) + host_len + 1);
+    if (client != NULL) {
+        LWESP_MEMCPY(client + 1, host, host_len + 1);
+        client->host = (const char*)(client + 1);
+        client->port = port;
+        client->type = type;
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(client->conns); ++i) {
+            client->conns[i].client = client;
+        }
+    }
+    return client;
+}
+
+/**
+ * \brief           Delete HTTP client
+ *
+ * Open connections are closed and memory is freed after they are closed
+ *
+ * \param[in]       client: HTTP client
+ * \return          \ref lwespOK on success, \ref lwespINPROG when requests are still pending
+ */
+lwespr_t
+lwesp_http_client_delete(lwesp_http_client_p client) {
+    lwespr_t res = lwespOK;
+
+    LWESP_ASSERT("client != NULL", client != NULL);
+
+    lwesp_core_lock();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(client->conns); ++i) {
+        if (client->conns[i].has_req) {
+            res = lwespINPROG;
+        }
+    }
+    if (client->queue_cnt > 0) {
+        res = lwespINPROG;
+    }
+    if (res == lwespOK) {
+        client->deleted = 1;
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(client->conns); ++i) {
+            http_conn_close(&client->conns[i]);
+        }
+        http_free_check(client);
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Queue request on HTTP client
+ *
+ * Request is sent on idle persistent connection, or new connection is opened
+ * when less than \ref LWESP_CFG_HTTP_CLIENT_MAX_CONNS are open.
+ * Result is reported with \ref LWESP_HTTP_CLIENT_EVT_DONE event
+ *
+ * \param[in]       client: HTTP client
+ * \param[in]       req: Request description, structure is copied
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_http_client_request(lwesp_http_client_p client, const lwesp_http_client_req_t* req) {
+    http_req_entry_t entry = {0};
+    lwespr_t res = lwespOK;
+
+    LWESP_ASSERT("client != NULL", client != NULL);
+    LWESP_ASSERT("req != NULL", req != NULL);
+    LWESP_ASSERT("req->body_len == 0 || req->body != NULL", req->body_len == 0 || req->body != NULL);
+
+    entry.req = *req;
+    lwesp_core_lock();
+    if (client->deleted) {
+        res = lwespERR;
+    } else if (!http_queue_add(client, &entry, 0)) {
+        res = lwespERRMEM;
+    } else {
+        http_dispatch(client);
+    }
+    lwesp_core_unlock();
+    return res;
+}
@@ -32,9 +32,17 @@
  * Version:         $_version_$
  */
 #include <ctype.h>
+#include <stddef.h>
 #include "lwesp/apps/lwesp_http_server.h"
 #include "lwesp/lwesp_mem.h"
 
+#if LWESP_CFG_STATIC_ONLY
+#error "HTTP server allocates memory at runtime and cannot be used with LWESP_CFG_STATIC_ONLY!"
+#endif /* LWESP_CFG_STATIC_ONLY */
+#if HTTP_FS_ASYNC
+#include "lwesp/lwesp_timeout.h"
+#endif /* HTTP_FS_ASYNC */
+
 #define LWESP_CFG_DBG_SERVER_TRACE            (LWESP_CFG_DBG_SERVER | LWESP_DBG_TYPE_TRACE)
 #define LWESP_CFG_DBG_SERVER_TRACE_WARNING    (LWESP_CFG_DBG_SERVER | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING)
 #define LWESP_CFG_DBG_SERVER_TRACE_DANGER     (LWESP_CFG_DBG_SERVER | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_DANGER)
@@ -43,18 +51,65 @@
 uint8_t     http_fs_data_open_file(const http_init_t* hi, http_fs_file_t* file, const char* path);
 uint32_t    http_fs_data_read_file(const http_init_t* hi, http_fs_file_t* file, void** buff, size_t btr, size_t* br);
 void        http_fs_data_close_file(const http_init_t* hi, http_fs_file_t* file);
+#if HTTP_SSI_PRECOMPILED
+uint8_t     http_fs_data_ssi_compile(http_fs_file_t* file);
+#endif /* HTTP_SSI_PRECOMPILED */
+#if HTTP_USE_ETAG
+uint8_t     http_fs_data_get_etag(const http_fs_file_t* file, uint32_t* etag);
+#endif /* HTTP_USE_ETAG */
+#if HTTP_USE_RANGE
+uint8_t     http_fs_data_seek_file(const http_init_t* hi, http_fs_file_t* file, uint32_t offset);
+#endif /* HTTP_USE_RANGE */
 
 /** Number of opened files in system */
 uint16_t http_fs_opened_files_cnt;
 
 #define CRLF                        "\r\n"
 
-static char http_uri[HTTP_MAX_URI_LEN + 1];
 static http_param_t http_params[HTTP_MAX_PARAMS];
 
 /* HTTP init structure with user settings */
 static const http_init_t* hi;
 
+/* Number of allocated connection states */
+static size_t http_states_cnt;
+
+#if HTTP_RATE_LIMIT_REQS > 0
+/**
+ * \brief           Request counter of single client in current time window
+ */
+typedef struct {
+    lwesp_ip_t ip;                              /*!< Client IP address */
+    uint32_t start;                             /*!< Time window start in units of milliseconds */
+    uint16_t cnt;                               /*!< Number of requests in time window, `0` if entry is not used */
+} http_rate_client_t;
+
+static http_rate_client_t http_rate_clients[HTTP_RATE_LIMIT_CLIENTS];
+#endif /* HTTP_RATE_LIMIT_REQS > 0 */
+
+#if HTTP_CGI_HASH_SIZE > 0
+/**
+ * \brief           Open addressing hash index over CGI table of init structure.
+ *                  Entry is table index plus `1`, `0` means empty slot
+ */
+static uint16_t http_cgi_index[HTTP_CGI_HASH_SIZE];
+static uint8_t http_cgi_index_ready;
+#endif /* HTTP_CGI_HASH_SIZE > 0 */
+
+#if HTTP_RESP_CACHE_SIZE > 0
+/**
+ * \brief           Rendered CGI response cache entry
+ */
+typedef struct {
+    lwesp_pbuf_p p;                             /*!< Entry data in format `key\0uri\0body\0`, `NULL` if entry is not used */
+    uint32_t time;                              /*!< Time entry was stored in units of milliseconds */
+    uint32_t ttl;                               /*!< Time entry stays valid in units of milliseconds */
+} http_resp_cache_t;
+
+static http_resp_cache_t http_resp_cache[HTTP_RESP_CACHE_SIZE];
+static char http_resp_cache_key[HTTP_MAX_URI_LEN + 2];
+#endif /* HTTP_RESP_CACHE_SIZE > 0 */
+
 #if HTTP_USE_METHOD_NOTALLOWED_RESP
 /**
  * \brief           Default output for method not allowed response
@@ -72,6 +127,86 @@ http_data_method_not_allowed[] = ""
                                  "";
 #endif /* HTTP_USE_METHOD_NOTALLOWED_RESP */
 
+#if HTTP_MAX_CONCURRENT_REQS < LWESP_CFG_MAX_CONNS || HTTP_RATE_LIMIT_REQS > 0
+#define HTTP_USE_ADMISSION                  1
+
+/**
+ * \brief           Constant response for rejected requests, sent without parsing request
+ */
+static const char
+http_data_unavailable[] = ""
+                          "HTTP/1.1 503 Service Unavailable" CRLF
+                          "Server: " HTTP_SERVER_NAME CRLF
+                          "Retry-After: " HTTP_RETRY_AFTER CRLF
+                          "Content-Length: 0" CRLF
+                          "Connection: close" CRLF
+                          CRLF
+                          "";
+#else
+#define HTTP_USE_ADMISSION                  0
+#endif /* HTTP_MAX_CONCURRENT_REQS < LWESP_CFG_MAX_CONNS || HTTP_RATE_LIMIT_REQS > 0 */
+
+#if HTTP_RATE_LIMIT_REQS > 0
+
+/**
+ * \brief           Count new request of connection client against rate limit
+ * \param[in]       conn: Connection handle
+ * \return          `1` if request is allowed, `0` if client exceeded the limit
+ */
+static uint8_t
+http_rate_admit(lwesp_conn_p conn) {
+    http_rate_client_t* c = NULL, *oldest = &http_rate_clients[0];
+    uint32_t now = lwesp_sys_now();
+    lwesp_ip_t ip;
+
+    if (!lwesp_conn_get_remote_ip(conn, &ip)) {
+        return 1;
+    }
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(http_rate_clients); ++i) {
+        http_rate_client_t* e = &http_rate_clients[i];
+
+        if (e->cnt > 0 && !memcmp(&e->ip, &ip, sizeof(ip))) {
+            c = e;
+            break;
+        }
+        if (oldest->cnt > 0 && (e->cnt == 0 || (now - e->start) > (now - oldest->start))) {
+            oldest = e;                         /* Prefer unused entries, then the oldest window */
+        }
+    }
+    if (c == NULL) {                            /* New client replaces least recent one */
+        c = oldest;
+        c->ip = ip;
+        c->cnt = 0;
+        c->start = now;
+    } else if ((now - c->start) >= HTTP_RATE_LIMIT_WINDOW) {
+        c->cnt = 0;                             /* Start new time window */
+        c->start = now;
+    }
+    if (c->cnt >= HTTP_RATE_LIMIT_REQS) {
+        return 0;
+    }
+    ++c->cnt;
+    return 1;
+}
+
+#endif /* HTTP_RATE_LIMIT_REQS > 0 */
+
+#if HTTP_USE_ADMISSION
+
+/**
+ * \brief           Respond with constant `503` response and close connection
+ * \param[in]       conn: Connection handle
+ */
+static void
+http_reject(lwesp_conn_p conn) {
+    LWESP_DEBUGF(LWESP_CFG_DBG_SERVER_TRACE_WARNING, "[HTTP SERVER] Conn %d rejected\r\n",
+               (int)lwesp_conn_getnum(conn));
+    lwesp_conn_send(conn, http_data_unavailable, sizeof(http_data_unavailable) - 1, NULL, 0);
+    lwesp_conn_close(conn, 0);
+}
+
+#endif /* HTTP_USE_ADMISSION */
+
 #if HTTP_DYNAMIC_HEADERS
 /**
  * \brief           Intexes for \ref http_dynstrs array
@@ -79,12 +214,31 @@ http_data_method_not_allowed[] = ""
 typedef enum {
     /* Response code */
     HTTP_HDR_200,
+    HTTP_HDR_206,
+    HTTP_HDR_304,
     HTTP_HDR_400,
     HTTP_HDR_404,
+    HTTP_HDR_416,
 
     /* Server response code */
     HTTP_HDR_SERVER,
 
+    /* Content encoding */
+    HTTP_HDR_GZIP,
+
+    /* Connection type */
+    HTTP_HDR_KEEP_ALIVE,
+    HTTP_HDR_CLOSE,
+
+    /* Caching */
+    HTTP_HDR_CACHE_CONTROL,
+
+    /* Partial content */
+    HTTP_HDR_ACCEPT_RANGES,
+
+    /* Transfer encoding */
+    HTTP_HDR_CHUNKED,
+
     /* Content type strings */
     HTTP_HDR_HTML,
     HTTP_HDR_PNG,
@@ -95,6 +249,9 @@ typedef enum {
     HTTP_HDR_ICO,
     HTTP_HDR_XML,
     HTTP_HDR_PLAIN,
+
+    /* End of headers without content */
+    HTTP_HDR_END,
 } dynamic_headers_index_t;
 
 /**
@@ -104,12 +261,31 @@ static const char* const
 http_dynstrs[] = {
     /* Response code */
     "HTTP/1.1 200 OK" CRLF,
+    "HTTP/1.1 206 Partial Content" CRLF,
+    "HTTP/1.1 304 Not Modified" CRLF,
     "HTTP/1.1 400 Bad Request" CRLF,
     "HTTP/1.1 404 File Not Found" CRLF,
+    "HTTP/1.1 416 Range Not Satisfiable" CRLF,
 
     /* Server response code */
     "Server: " HTTP_SERVER_NAME CRLF,
 
+    /* Content encoding */
+    "Content-Encoding: gzip" CRLF "Vary: Accept-Encoding" CRLF,
+
+    /* Connection type */
+    "Connection: keep-alive" CRLF,
+    "Connection: close" CRLF,
+
+    /* Caching */
+    "Cache-Control: " HTTP_CACHE_CONTROL CRLF,
+
+    /* Partial content */
+    "Accept-Ranges: bytes" CRLF,
+
+    /* Transfer encoding */
+    "Transfer-Encoding: chunked" CRLF,
+
     /* Content type strings */
     "Content-type: text/html" CRLF CRLF,
     "Content-type: image/png" CRLF CRLF,
@@ -120,6 +296,9 @@ http_dynstrs[] = {
     "Content-type: text/x-icon" CRLF CRLF,
     "Content-type: text/xml" CRLF CRLF,
     "Content-type: text/plain" CRLF CRLF,
+
+    /* End of headers without content */
+    CRLF,
 };
 
 /**
@@ -203,40 +382,366 @@ strcmpa(const char* a, const char* b) {
     }
 }
 
+#if HTTP_USE_WEBSOCKET
+
 /**
- * \brief           Parse URI from HTTP request and copy it to linear memory location
- * \param[in]       p: Chain of pbufs from request
- * \return          \ref lwespOK if successfully parsed, member of \ref lwespr_t otherwise
+ * \brief           Calculate `Sec-WebSocket-Accept` value from request key
+ *
+ * Value is base64 encoded SHA-1 hash of the key, concatenated with protocol GUID
+ *
+ * \param[in]       key: `Sec-WebSocket-Key` request header value, `24` characters long
+ * \param[out]      accept: Output buffer for `28` characters and NULL termination
  */
-static lwespr_t
-http_parse_uri(lwesp_pbuf_p p) {
-    size_t pos_s, pos_e, pos_crlf, uri_len;
+static void
+http_ws_calc_accept(const char* key, char* accept) {
+    static const char guid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint8_t msg[128], digest[20];
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    uint32_t w[80], a, b, c, d, e, f, k, t;
+    size_t i, j, len;
+
+    /* Key and GUID are 60 bytes, padded message is always 2 blocks */
+    len = 24 + sizeof(guid) - 1;
+    LWESP_MEMSET(msg, 0x00, sizeof(msg));
+    LWESP_MEMCPY(msg, key, 24);
+    LWESP_MEMCPY(&msg[24], guid, sizeof(guid) - 1);
+    msg[len] = 0x80;
+    msg[sizeof(msg) - 2] = (uint8_t)((len * 8) >> 8);
+    msg[sizeof(msg) - 1] = (uint8_t)(len * 8);
+
+    for (i = 0; i < sizeof(msg); i += 64) {
+        for (j = 0; j < 16; ++j) {
+            w[j] = ((uint32_t)msg[i + 4 * j] << 24) | ((uint32_t)msg[i + 4 * j + 1] << 16)
+                   | ((uint32_t)msg[i + 4 * j + 2] << 8) | (uint32_t)msg[i + 4 * j + 3];
+        }
+        for (; j < 80; ++j) {
+            t = w[j - 3] ^ w[j - 8] ^ w[j - 14] ^ w[j - 16];
+            w[j] = (t << 1) | (t >> 31);
+        }
+        a = h[0];
+        b = h[1];
+        c = h[2];
+        d = h[3];
+        e = h[4];
+        for (j = 0; j < 80; ++j) {
+            if (j < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (j < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (j < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            t = ((a << 5) | (a >> 27)) + f + e + k + w[j];
+            e = d;
+            d = c;
+            c = (b << 30) | (b >> 2);
+            b = a;
+            a = t;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+    for (i = 0; i < 20; ++i) {
+        digest[i] = (uint8_t)(h[i / 4] >> (24 - 8 * (i % 4)));
+    }
 
-    pos_s = lwesp_pbuf_strfind(p, " ", 0);      /* Find first " " in request header */
-    if (pos_s == LWESP_SIZET_MAX || (pos_s != 3 && pos_s != 4)) {
-        return lwespERR;
+    /* Base64 encode 20 bytes to 28 characters, last group has 2 bytes */
+    for (i = 0, j = 0; i < 20; i += 3) {
+        t = ((uint32_t)digest[i] << 16) | ((uint32_t)digest[i + 1] << 8) | (i + 2 < 20 ? digest[i + 2] : 0);
+        accept[j++] = b64[(t >> 18) & 0x3F];
+        accept[j++] = b64[(t >> 12) & 0x3F];
+        accept[j++] = b64[(t >> 6) & 0x3F];
+        accept[j++] = i + 2 < 20 ? b64[t & 0x3F] : '=';
     }
-    pos_crlf = lwesp_pbuf_strfind(p, CRLF, 0);  /* Find CRLF position */
-    if (pos_crlf == LWESP_SIZET_MAX) {
-        return lwespERR;
+    accept[j] = 0;
+}
+
+#endif /* HTTP_USE_WEBSOCKET */
+
+#if HTTP_USE_ETAG
+
+/**
+ * \brief           Parse quoted ETag value from request header
+ * \param[in]       value: Header value
+ * \param[out]      etag: Pointer to save ETag value to
+ * \return          `1` if value includes valid ETag, `0` otherwise
+ */
+static uint8_t
+http_parse_etag(const char* value, uint32_t* etag) {
+    if ((value = strchr(value, '"')) == NULL) {
+        return 0;
     }
-    pos_e = lwesp_pbuf_strfind(p, " ", pos_s + 1);  /* Find second " " in request header */
-    if (pos_e == LWESP_SIZET_MAX) {             /* If there is no second " " */
-        /*
-         * HTTP 0.9 request is "GET /\r\n" without
-         * space between request URI and CRLF
-         */
-        pos_e = pos_crlf;                       /* Use the one from CRLF */
+    *etag = 0;
+    for (++value; *value != '\0' && *value != '"'; ++value) {
+        if (!isxdigit((uint8_t)*value)) {
+            return 0;
+        }
+        *etag = (*etag << 4) | (*value <= '9' ? (*value - '0') : ((*value | 0x20) - 'a' + 10));
     }
+    return 1;
+}
+
+#endif /* HTTP_USE_ETAG */
+
+#if HTTP_USE_RANGE
+
+/**
+ * \brief           Parse decimal byte position of range
+ * \param[in,out]   str: Pointer to string pointer, advanced after parsed digits
+ * \param[out]      num: Pointer to save parsed number to
+ * \return          `1` on success, `0` if there are no digits or number overflows
+ */
+static uint8_t
+http_parse_range_num(const char** str, uint32_t* num) {
+    const char* s = *str;
 
-    uri_len = pos_e - pos_s - 1;                /* Get length of uri */
-    if (uri_len > HTTP_MAX_URI_LEN) {
-        return lwespERR;
+    for (*num = 0; *s >= '0' && *s <= '9'; ++s) {
+        if (*num > (0xFFFFFFFFUL - 9) / 10) {
+            return 0;
+        }
+        *num = 10 * *num + (*s - '0');
+    }
+    if (s == *str) {
+        return 0;
     }
-    lwesp_pbuf_copy(p, http_uri, uri_len, pos_s + 1);   /* Copy data from pbuf to linear memory */
-    http_uri[uri_len] = 0;                      /* Set terminating 0 */
+    *str = s;
+    return 1;
+}
 
-    return lwespOK;
+/**
+ * \brief           Parse `Range` request header value
+ *
+ * Only single `bytes` range is supported, other ranges are ignored
+ * and full response is sent instead
+ *
+ * \param[in]       hs: HTTP state
+ * \param[in]       value: Header value
+ */
+static void
+http_parse_range(http_state_t* hs, const char* value) {
+    hs->range = 0;
+    if (strncmp(value, "bytes=", 6)) {
+        return;
+    }
+    value += 6;
+    if (*value == '-') {                        /* Suffix range, "-n" means last n bytes */
+        ++value;
+        if (!http_parse_range_num(&value, &hs->range_first)) {
+            return;
+        }
+        hs->range = 2;
+    } else {
+        if (!http_parse_range_num(&value, &hs->range_first) || *value++ != '-') {
+            return;
+        }
+        hs->range_last = 0xFFFFFFFFUL;          /* Open range, until end of file */
+        if (*value >= '0' && *value <= '9'
+            && (!http_parse_range_num(&value, &hs->range_last) || hs->range_last < hs->range_first)) {
+            return;
+        }
+        hs->range = 1;
+    }
+    while (*value == ' ') {
+        ++value;
+    }
+    if (*value != '\0') {                       /* Multiple ranges are not supported */
+        hs->range = 0;
+    }
+}
+
+#endif /* HTTP_USE_RANGE */
+
+/**
+ * \brief           Process single request header line
+ *
+ * Well known headers are processed directly to HTTP state,
+ * all headers are optionally stored for \ref lwesp_http_server_get_header function
+ *
+ * \param[in]       hs: HTTP state
+ * \param[in]       name: Header name
+ * \param[in]       value: Header value without leading white spaces
+ */
+static void
+http_process_header(http_state_t* hs, const char* name, const char* value) {
+#if HTTP_SUPPORT_POST
+    if (!strcmpa(name, "Content-Length")) {
+        hs->content_length = 0;
+        for (; *value >= '0' && *value <= '9'; ++value) {
+            hs->content_length = 10 * hs->content_length + (*value - '0');
+        }
+    }
+#endif /* HTTP_SUPPORT_POST */
+#if HTTP_USE_KEEP_ALIVE
+    if (!strcmpa(name, "Connection")) {
+        if (!strcmpa(value, "close")) {
+            hs->req_conn_hdr = 1;
+        } else if (!strcmpa(value, "keep-alive")) {
+            hs->req_conn_hdr = 2;
+        }
+    }
+#endif /* HTTP_USE_KEEP_ALIVE */
+#if HTTP_USE_GZIP_FILES
+    if (!strcmpa(name, "Accept-Encoding") && strstr(value, "gzip") != NULL) {
+        hs->accept_gzip = 1;                    /* Client accepts gzip compressed response */
+    }
+#endif /* HTTP_USE_GZIP_FILES */
+#if HTTP_USE_ETAG
+    if (!strcmpa(name, "If-None-Match")) {
+        hs->has_if_none_match = http_parse_etag(value, &hs->if_none_match);
+    }
+#endif /* HTTP_USE_ETAG */
+#if HTTP_USE_RANGE
+    if (!strcmpa(name, "Range")) {
+        http_parse_range(hs, value);
+    }
+    if (!strcmpa(name, "If-Range")) {
+        hs->range_if = 1;
+#if HTTP_USE_ETAG
+        hs->has_if_range = http_parse_etag(value, &hs->if_range);
+#endif /* HTTP_USE_ETAG */
+    }
+#endif /* HTTP_USE_RANGE */
+#if HTTP_USE_WEBSOCKET
+    if (!strcmpa(name, "Upgrade") && !strcmpa(value, "websocket")) {
+        hs->ws_upgrade = 1;
+    }
+    if (!strcmpa(name, "Sec-WebSocket-Key") && strlen(value) == 24) {
+        http_ws_calc_accept(value, hs->ws_accept);
+        hs->ws_key_valid = 1;
+    }
+#endif /* HTTP_USE_WEBSOCKET */
+#if HTTP_MAX_REQ_HEADERS > 0
+    {
+        size_t name_len = strlen(name) + 1, value_len = strlen(value) + 1;
+
+        /* Store header if there is enough memory, otherwise ignore it */
+        if (hs->req_headers_cnt < HTTP_MAX_REQ_HEADERS
+            && (hs->req_headers_buff_len + name_len + value_len) <= sizeof(hs->req_headers_buff)) {
+            char* b = &hs->req_headers_buff[hs->req_headers_buff_len];
+
+            LWESP_MEMCPY(b, name, name_len);
+            LWESP_MEMCPY(&b[name_len], value, value_len);
+            hs->req_headers[hs->req_headers_cnt].name = b;
+            hs->req_headers[hs->req_headers_cnt].value = &b[name_len];
+            ++hs->req_headers_cnt;
+            hs->req_headers_buff_len += name_len + value_len;
+        }
+    }
+#endif /* HTTP_MAX_REQ_HEADERS > 0 */
+}
+
+/**
+ * \brief           Parse received request bytes
+ *
+ * Request line and headers are parsed byte by byte as they are received,
+ * received data do not have to be kept until all headers are received
+ *
+ * \param[in]       hs: HTTP state
+ * \param[in]       p: Received packet buffer
+ * \return          Number of bytes consumed from packet buffer.
+ *                  When headers are fully received, remaining bytes belong to request body
+ */
+static size_t
+http_parse_request(http_state_t* hs, lwesp_pbuf_p p) {
+    lwesp_pbuf_cursor_t cur;
+    const char* d;
+    size_t off = 0, len, i;
+    char ch;
+
+    lwesp_pbuf_cursor_init(&cur, p, 0);
+    while (!hs->headers_received && (d = lwesp_pbuf_cursor_peek_linear(&cur, &len)) != NULL) {
+        for (i = 0; i < len && !hs->headers_received; ++i) {
+            ch = d[i];
+            if (ch == '\r') {                   /* Carriage return is never part of data */
+                continue;
+            }
+            switch (hs->req_parse_state) {
+                case HTTP_REQ_PARSE_METHOD: {
+                    if (ch == ' ') {
+                        hs->hdr_line[hs->hdr_line_len] = 0;
+                        if (!strcmp(hs->hdr_line, "GET")) {
+                            hs->req_method = HTTP_METHOD_GET;
+#if HTTP_SUPPORT_POST
+                        } else if (!strcmp(hs->hdr_line, "POST")) {
+                            hs->req_method = HTTP_METHOD_POST;
+#endif /* HTTP_SUPPORT_POST */
+                        } else {
+                            hs->req_method = HTTP_METHOD_NOTALLOWED;
+                        }
+                        hs->hdr_line_len = 0;
+                        hs->req_uri_len = 0;
+                        hs->req_uri_valid = 1;
+                        hs->req_params = NULL;
+                        hs->req_parse_state = HTTP_REQ_PARSE_URI;
+                    } else if (ch == '\n') {
+                        hs->hdr_line_len = 0;   /* Ignore empty lines before request line */
+                    } else if (hs->hdr_line_len < HTTP_MAX_HEADER_LINE_LEN) {
+                        hs->hdr_line[hs->hdr_line_len++] = ch;
+                    }
+                    break;
+                }
+                case HTTP_REQ_PARSE_URI: {
+                    if (ch == ' ' || ch == '\n') {
+                        hs->req_uri[hs->req_uri_len] = 0;
+                        /* HTTP 0.9 request is "GET /\r\n" without version */
+                        hs->req_parse_state = ch == ' ' ? HTTP_REQ_PARSE_VERSION : HTTP_REQ_PARSE_HEADER;
+                    } else if (hs->req_uri_len < HTTP_MAX_URI_LEN) {
+                        hs->req_uri[hs->req_uri_len++] = ch;
+                    } else {
+                        hs->req_uri_valid = 0;  /* URI is too long */
+                    }
+                    break;
+                }
+                case HTTP_REQ_PARSE_VERSION: {
+                    if (ch == '\n') {
+                        hs->hdr_line[hs->hdr_line_len] = 0;
+                        hs->req_http11 = !strcmp(hs->hdr_line, "HTTP/1.1");
+                        hs->hdr_line_len = 0;
+                        hs->req_parse_state = HTTP_REQ_PARSE_HEADER;
+                    } else if (hs->hdr_line_len < HTTP_MAX_HEADER_LINE_LEN) {
+                        hs->hdr_line[hs->hdr_line_len++] = ch;
+                    }
+                    break;
+                }
+                case HTTP_REQ_PARSE_HEADER: {
+                    if (ch == '\n') {
+                        if (hs->hdr_line_len == 0) {    /* Empty line is end of headers */
+                            hs->headers_received = 1;
+                        } else {
+                            char* v;
+
+                            hs->hdr_line[hs->hdr_line_len] = 0;
+                            if ((v = strchr(hs->hdr_line, ':')) != NULL) {
+                                *v++ = 0;
+                                while (*v == ' ' || *v == '\t') {
+                                    ++v;
+                                }
+                                http_process_header(hs, hs->hdr_line, v);
+                            }
+                        }
+                        hs->hdr_line_len = 0;
+                    } else if (hs->hdr_line_len < HTTP_MAX_HEADER_LINE_LEN) {
+                        hs->hdr_line[hs->hdr_line_len++] = ch;  /* Longer lines are truncated */
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+        off += lwesp_pbuf_cursor_skip(&cur, i);
+    }
+    return off;
 }
 
 /**
@@ -274,7 +779,139 @@ http_get_params(char* params) {
     return cnt;
 }
 
+#if HTTP_CGI_HASH_SIZE > 0
+/**
+ * \brief           Calculate FNV-1a hash of CGI URI
+ * \param[in]       uri: URI path without parameters
+ * \return          URI hash
+ */
+static uint32_t
+http_cgi_hash(const char* uri) {
+    uint32_t h = 0x811C9DC5UL;
+
+    for (; *uri != '\0'; ++uri) {
+        h = (h ^ (uint8_t)*uri) * 0x01000193UL;
+    }
+    return h;
+}
+
+/**
+ * \brief           Build CGI hash index for current init structure
+ *
+ * Entries with the same URI end up in probe sequence in table order,
+ * lookup therefore returns the same entry as linear search
+ */
+static void
+http_cgi_index_build(void) {
+    size_t slot;
+
+    LWESP_MEMSET(http_cgi_index, 0x00, sizeof(http_cgi_index));
+    http_cgi_index_ready = 0;
+    if (hi == NULL || hi->cgi == NULL || hi->cgi_count >= HTTP_CGI_HASH_SIZE) {
+        return;                                 /* Linear search is used, there must be at least one empty slot */
+    }
+    for (size_t i = 0; i < hi->cgi_count; ++i) {
+        slot = http_cgi_hash(hi->cgi[i].uri) % HTTP_CGI_HASH_SIZE;
+        while (http_cgi_index[slot] != 0) {
+            slot = (slot + 1) % HTTP_CGI_HASH_SIZE;
+        }
+        http_cgi_index[slot] = (uint16_t)(i + 1);
+    }
+    http_cgi_index_ready = 1;
+}
+#endif /* HTTP_CGI_HASH_SIZE > 0 */
+
+/**
+ * \brief           Check if CGI entry handles request
+ * \param[in]       cgi: CGI entry
+ * \param[in]       uri: Request URI without parameters
+ * \param[in]       method: Request method
+ * \return          `1` on match, `0` otherwise
+ */
+static uint8_t
+http_cgi_match(const http_cgi_t* cgi, const char* uri, http_req_method_t method) {
+    return (cgi->method == HTTP_METHOD_NOTALLOWED || cgi->method == method) && !strcmp(cgi->uri, uri);
+}
+
+/**
+ * \brief           Find CGI handler for request
+ * \param[in]       uri: Request URI without parameters
+ * \param[in]       method: Request method
+ * \return          CGI entry or `NULL` if there is no handler for request
+ */
+static const http_cgi_t*
+http_cgi_find(const char* uri, http_req_method_t method) {
+    if (hi == NULL || hi->cgi == NULL) {
+        return NULL;
+    }
+#if HTTP_CGI_HASH_SIZE > 0
+    if (http_cgi_index_ready) {
+        /* Probe until empty slot, there is always at least one */
+        for (size_t slot = http_cgi_hash(uri) % HTTP_CGI_HASH_SIZE; http_cgi_index[slot] != 0;
+             slot = (slot + 1) % HTTP_CGI_HASH_SIZE) {
+            const http_cgi_t* cgi = &hi->cgi[http_cgi_index[slot] - 1];
+            if (http_cgi_match(cgi, uri, method)) {
+                return cgi;
+            }
+        }
+        return NULL;
+    }
+#endif /* HTTP_CGI_HASH_SIZE > 0 */
+    for (size_t i = 0; i < hi->cgi_count; ++i) {
+        if (http_cgi_match(&hi->cgi[i], uri, method)) {
+            return &hi->cgi[i];
+        }
+    }
+    return NULL;
+}
+
 #if HTTP_DYNAMIC_HEADERS
+#if HTTP_USE_RANGE
+
+/**
+ * \brief           Limit response file to requested range and prepare partial content headers
+ *
+ * Response stays `200 OK` with entire file when file cannot be seeked
+ *
+ * \param[in]       hs: HTTP state
+ */
+static void
+prepare_range_headers(http_state_t* hs) {
+    uint32_t size = hs->rlwesp_file.size, first, last;
+    uint8_t satisfiable;
+
+    if (hs->range == 2) {                       /* Last n bytes of file */
+        first = hs->range_first < size ? (size - hs->range_first) : 0;
+        last = size - 1;
+        satisfiable = hs->range_first > 0 && size > 0;
+    } else {
+        first = hs->range_first;
+        last = LWESP_MIN(hs->range_last, size - 1);
+        satisfiable = first < size;
+    }
+
+    if (!satisfiable) {
+        hs->rlwesp_file.size = 0;               /* Respond without content */
+        sprintf(hs->dyn_hdr_range, "Content-Range: bytes */%lu" CRLF, (unsigned long)size);
+        sprintf(hs->dyn_hdr_cnt_len, "Content-Length: 0" CRLF);
+        hs->dyn_hdr_strs[0] = http_dynstrs[HTTP_HDR_416];
+        hs->dyn_hdr_strs[3] = NULL;
+        hs->dyn_hdr_strs[HTTP_MAX_HEADERS - 1] = http_dynstrs[HTTP_HDR_END];
+    } else if (http_fs_data_seek_file(hi, &hs->rlwesp_file, first)) {
+        hs->rlwesp_file.size = last + 1;        /* Stop reading at the end of range */
+        sprintf(hs->dyn_hdr_range, "Content-Range: bytes %lu-%lu/%lu" CRLF,
+                (unsigned long)first, (unsigned long)last, (unsigned long)size);
+        sprintf(hs->dyn_hdr_cnt_len, "Content-Length: %d" CRLF, (int)(last - first + 1));
+        hs->dyn_hdr_strs[0] = http_dynstrs[HTTP_HDR_206];
+    } else {
+        return;                                 /* Send entire file */
+    }
+    hs->dyn_hdr_strs[2] = hs->dyn_hdr_cnt_len;
+    hs->dyn_hdr_strs[8] = hs->dyn_hdr_range;   /* Accept-Ranges in 7 stays in place */
+}
+
+#endif /* HTTP_USE_RANGE */
+
 /**
  * \brief           Prepare dynamic headers to be sent as response to user
  * \param[in]       hs: HTTP state
@@ -284,20 +921,60 @@ static void
 prepare_dynamic_headers(http_state_t* hs, const char* uri) {
     char* ext, *u;
     size_t i;
+#if HTTP_USE_ETAG
+    uint32_t etag;
+    uint8_t has_etag = 0;
+#endif /* HTTP_USE_ETAG */
 
     hs->dyn_hdr_idx = 0;
     hs->dyn_hdr_pos = 0;
 
     hs->dyn_hdr_strs[1] = http_dynstrs[HTTP_HDR_SERVER];/* Set server name */
+    hs->dyn_hdr_strs[3] = NULL;                 /* No content encoding by default */
+    hs->dyn_hdr_strs[4] = NULL;
+    hs->dyn_hdr_strs[5] = NULL;                 /* No ETag and cache control by default */
+    hs->dyn_hdr_strs[6] = NULL;
+#if HTTP_USE_RANGE
+    hs->dyn_hdr_strs[7] = NULL;                 /* No ranges support by default */
+    hs->dyn_hdr_strs[8] = NULL;                 /* No content range by default */
+#endif /* HTTP_USE_RANGE */
+#if HTTP_USE_CHUNKED
+    /* SSI output length is not known, HTTP/1.1 client gets it in chunks */
+    hs->chunked = hs->rlwesp_file_opened && hs->is_ssi && hs->req_http11;
+#endif /* HTTP_USE_CHUNKED */
+#if HTTP_USE_KEEP_ALIVE
+    if (!hs->rlwesp_file_opened || (hs->is_ssi
+#if HTTP_USE_CHUNKED
+                                    && !hs->chunked
+#endif /* HTTP_USE_CHUNKED */
+                                   )) {         /* Response length is not known */
+        hs->keep_alive = 0;
+    }
+    hs->dyn_hdr_strs[4] = http_dynstrs[hs->keep_alive ? HTTP_HDR_KEEP_ALIVE : HTTP_HDR_CLOSE];
+#endif /* HTTP_USE_KEEP_ALIVE */
     if (!hs->rlwesp_file_opened) {              /* This should never be the case as 404.html file exists as static */
         hs->dyn_hdr_strs[0] = http_dynstrs[HTTP_HDR_404];   /* 404 Not Found */
         hs->dyn_hdr_strs[HTTP_MAX_HEADERS - 1] = http_dynstrs[HTTP_HDR_HTML];   /* Content type text/html */
     } else {
+#if HTTP_USE_ETAG
+        /* ETag is calculated from original file data, before headers are skipped */
+        if (!hs->is_ssi && strstr(uri, "/404.") == NULL) {
+            has_etag = http_fs_data_get_etag(&hs->rlwesp_file, &etag);
+        }
+#endif /* HTTP_USE_ETAG */
+
         /*
          * Try to find CRLFCRLF sequence on static files and remove
          * the headers if dynamic headers are used
          */
-        if (hs->rlwesp_file.is_static) {
+        if (hs->rlwesp_file.is_static
+#if HTTP_USE_GZIP_FILES
+            && !hs->is_gzip                     /* Compressed files have no headers part */
+#endif /* HTTP_USE_GZIP_FILES */
+#if HTTP_RESP_CACHE_SIZE > 0
+            && hs->resp_cache == NULL           /* Cached output has no headers part */
+#endif /* HTTP_RESP_CACHE_SIZE > 0 */
+           ) {
             char* crlfcrlf;
             crlfcrlf = strstr((const char*)hs->rlwesp_file.data, CRLF CRLF);
             if (crlfcrlf != NULL) {             /* Skip header part of file */
@@ -321,6 +998,17 @@ prepare_dynamic_headers(http_state_t* hs, const char* uri) {
             hs->dyn_hdr_strs[2] = hs->dyn_hdr_cnt_len;
         }
 #endif /* HTTP_DYNAMIC_HEADERS_CONTENT_LEN */
+#if HTTP_USE_CHUNKED
+        if (hs->chunked) {
+            hs->dyn_hdr_strs[2] = http_dynstrs[HTTP_HDR_CHUNKED];
+        }
+#endif /* HTTP_USE_CHUNKED */
+
+#if HTTP_USE_GZIP_FILES
+        if (hs->is_gzip) {
+            hs->dyn_hdr_strs[3] = http_dynstrs[HTTP_HDR_GZIP];
+        }
+#endif /* HTTP_USE_GZIP_FILES */
 
         /*
          * Determine if file is 404 or normal user file.
@@ -366,6 +1054,44 @@ prepare_dynamic_headers(http_state_t* hs, const char* uri) {
         } else {
             hs->dyn_hdr_strs[HTTP_MAX_HEADERS - 1] = http_dynstrs[HTTP_HDR_PLAIN];  /* Plain text, unknown type */
         }
+
+#if HTTP_USE_ETAG
+        if (has_etag) {
+            sprintf(hs->dyn_hdr_etag, "ETag: \"%08lx\"" CRLF, (unsigned long)etag);
+            hs->dyn_hdr_strs[5] = hs->dyn_hdr_etag;
+            hs->dyn_hdr_strs[6] = http_dynstrs[HTTP_HDR_CACHE_CONTROL];
+
+            /* Client has the same file already, respond without content */
+            if (hs->has_if_none_match && hs->if_none_match == etag) {
+                hs->rlwesp_file.size = 0;
+                hs->dyn_hdr_strs[0] = http_dynstrs[HTTP_HDR_304];
+                hs->dyn_hdr_strs[2] = NULL;
+                hs->dyn_hdr_strs[3] = NULL;
+                hs->dyn_hdr_strs[HTTP_MAX_HEADERS - 1] = http_dynstrs[HTTP_HDR_END];
+            }
+        }
+#endif /* HTTP_USE_ETAG */
+
+#if HTTP_USE_RANGE
+        /* Only full file with known length can be sent partially */
+        if (!hs->is_ssi && hs->dyn_hdr_strs[0] == http_dynstrs[HTTP_HDR_200]
+            && (hs->rlwesp_file.is_static || (hi != NULL && hi->fs_seek != NULL))) {
+            uint8_t use_range = hs->range;
+
+            /* Range is valid only if client has the same file version */
+            if (hs->range_if) {
+#if HTTP_USE_ETAG
+                use_range = use_range && has_etag && hs->has_if_range && hs->if_range == etag;
+#else /* HTTP_USE_ETAG */
+                use_range = 0;
+#endif /* !HTTP_USE_ETAG */
+            }
+            hs->dyn_hdr_strs[7] = http_dynstrs[HTTP_HDR_ACCEPT_RANGES];
+            if (use_range) {
+                prepare_range_headers(hs);
+            }
+        }
+#endif /* HTTP_USE_RANGE */
     }
 }
 
@@ -412,57 +1138,349 @@ send_dynamic_headers(http_state_t* hs) {
 }
 #endif
 
+#if HTTP_USE_CHUNKED
 /**
- * \brief           Get file from uri in format /folder/file?param1=value1&...
+ * \brief           Write collected chunk to connection output
  * \param[in]       hs: HTTP state
- * \param[in]       uri: Input URI to get file for
- * \return          `1` on success, `0` otherwise
  */
-uint8_t
-http_get_file_from_uri(http_state_t* hs, const char* uri) {
-    size_t uri_len;
+static void
+http_chunk_flush(http_state_t* hs) {
+    char hdr[12];
+    size_t hdr_len;
 
-    LWESP_MEMSET(&hs->rlwesp_file, 0x00, sizeof(hs->rlwesp_file));
-    uri_len = strlen(uri);                      /* Get URI total length */
-    if ((uri_len == 1 && uri[0] == '/') ||      /* Index file only requested */
-        (uri_len > 1 && uri[0] == '/' && uri[1] == '?')) {  /* Index file + parameters */
-        size_t i;
-        /*
-         * Scan index files and check if there is one from user
-         * available to return as main file
-         */
-        for (i = 0; i < LWESP_ARRAYSIZE(http_index_filenames); ++i) {
-            hs->rlwesp_file_opened = http_fs_data_open_file(hi, &hs->rlwesp_file, http_index_filenames[i]); /* Give me a file with desired path */
-            if (hs->rlwesp_file_opened) {       /* Do we have a file? */
-                uri = http_index_filenames[i];  /* Set new URI for next of this func */
-                break;
-            }
-        }
+    if (hs->chunk_len == 0) {
+        return;
     }
+    hdr_len = (size_t)sprintf(hdr, "%X" CRLF, (unsigned)hs->chunk_len);
+    lwesp_conn_write(hs->conn, hdr, hdr_len, 0, &hs->conn_mem_available);
+    lwesp_conn_write(hs->conn, hs->chunk_buff, hs->chunk_len, 0, &hs->conn_mem_available);
+    lwesp_conn_write(hs->conn, CRLF, 2, 0, &hs->conn_mem_available);
+    hs->written_total += hdr_len + hs->chunk_len + 2;
+    hs->chunk_len = 0;
+}
+#endif /* HTTP_USE_CHUNKED */
 
-    /*
-     * We still don't have a file,
-     * maybe there was a request for specific file and possible parameters
-     */
-    if (!hs->rlwesp_file_opened) {
-        char* req_params;
-        size_t params_len;
-        req_params = strchr(uri, '?');          /* Search for params delimiter */
-        if (req_params != NULL) {               /* We found parameters? They should not exists in static strings or we may have buf! */
-            req_params[0] = 0;                  /* Reset everything at this point */
-            ++req_params;                       /* Skip NULL part and go to next one */
-        }
+#if HTTP_RESP_CACHE_SIZE > 0
 
-        params_len = http_get_params(req_params);   /* Get request params from request */
-        if (hi != NULL && hi->cgi != NULL) {    /* Check if any user specific controls to process */
-            for (size_t i = 0; i < hi->cgi_count; ++i) {
-                if (!strcmp(hi->cgi[i].uri, uri)) {
-                    uri = hi->cgi[i].fn(http_params, params_len);
-                    break;
-                }
-            }
+/**
+ * \brief           Build response cache key from request path and parameters
+ * \param[in]       path: Request path without parameters
+ * \param[in]       params: Request parameters or `NULL` if not present
+ * \return          `1` on success, `0` if key is too long
+ */
+static uint8_t
+http_resp_cache_key_build(const char* path, const char* params) {
+    size_t path_len, params_len;
+
+    path_len = strlen(path);
+    params_len = params != NULL ? strlen(params) : 0;
+    if (path_len + params_len + 1 >= sizeof(http_resp_cache_key)) {
+        return 0;
+    }
+    LWESP_MEMCPY(http_resp_cache_key, path, path_len);
+    http_resp_cache_key[path_len] = '?';
+    LWESP_MEMCPY(&http_resp_cache_key[path_len + 1], params != NULL ? params : "", params_len + 1);
+    return 1;
+}
+
+/**
+ * \brief           Open cached response for current key as static file
+ * \param[in]       hs: HTTP state
+ * \return          URI response was rendered from, `NULL` if there is no valid entry
+ */
+static const char*
+http_resp_cache_open(http_state_t* hs) {
+    const char *d, *uri;
+    size_t body;
+
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(http_resp_cache); ++i) {
+        http_resp_cache_t* e = &http_resp_cache[i];
+
+        if (e->p == NULL || strcmp(lwesp_pbuf_data(e->p), http_resp_cache_key)) {
+            continue;
+        }
+        if ((uint32_t)(lwesp_sys_now() - e->time) >= e->ttl) {
+            lwesp_pbuf_free(e->p);              /* Entry expired, render it again */
+            e->p = NULL;
+            return NULL;
         }
-        hs->rlwesp_file_opened = http_fs_data_open_file(hi, &hs->rlwesp_file, uri); /* Give me a new file now */
+        d = lwesp_pbuf_data(e->p);
+        uri = d + strlen(d) + 1;
+        body = (size_t)(uri - d) + strlen(uri) + 1;
+
+        lwesp_pbuf_ref(e->p);                   /* Entry may be replaced while response is sent */
+        hs->resp_cache = e->p;
+        hs->rlwesp_file.data = (const uint8_t*)&d[body];
+        hs->rlwesp_file.size = (uint32_t)(lwesp_pbuf_length(e->p, 0) - body - 1);
+        hs->rlwesp_file.is_static = 1;
+        LWESP_DEBUGF(LWESP_CFG_DBG_SERVER_TRACE, "[HTTP SERVER] Response served from cache: %s\r\n", http_resp_cache_key);
+        return uri;
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Start rendering response to cache for current key
+ * \param[in]       hs: HTTP state
+ * \param[in]       uri: URI response is rendered from
+ * \param[in]       ttl: Time entry stays valid in units of milliseconds
+ */
+static void
+http_resp_cache_start(http_state_t* hs, const char* uri, uint32_t ttl) {
+    size_t key_len, uri_len;
+    uint8_t* d;
+
+    key_len = strlen(http_resp_cache_key) + 1;
+    uri_len = strlen(uri) + 1;
+    hs->resp_cache_fill = lwesp_pbuf_new(key_len + uri_len + HTTP_RESP_CACHE_MAX_LEN + 1);
+    if (hs->resp_cache_fill != NULL) {
+        d = lwesp_pbuf_data(hs->resp_cache_fill);
+        LWESP_MEMCPY(d, http_resp_cache_key, key_len);
+        LWESP_MEMCPY(&d[key_len], uri, uri_len);
+        hs->resp_cache_body = key_len + uri_len;
+        hs->resp_cache_fill_len = 0;
+        hs->resp_cache_ttl = ttl;
+    }
+}
+
+/**
+ * \brief           Copy rendered response data to cache entry
+ * \param[in]       hs: HTTP state
+ * \param[in]       data: Data to write
+ * \param[in]       len: Length of data in units of bytes
+ */
+static void
+http_resp_cache_write(http_state_t* hs, const void* data, size_t len) {
+    uint8_t* d;
+
+    if (hs->resp_cache_fill_len + len > HTTP_RESP_CACHE_MAX_LEN) {
+        lwesp_pbuf_free(hs->resp_cache_fill);   /* Response is too long, do not cache it */
+        hs->resp_cache_fill = NULL;
+        return;
+    }
+    d = lwesp_pbuf_data(hs->resp_cache_fill);
+    LWESP_MEMCPY(&d[hs->resp_cache_body + hs->resp_cache_fill_len], data, len);
+    hs->resp_cache_fill_len += len;
+}
+
+/**
+ * \brief           Store fully rendered response to cache
+ *
+ * Entry with the same key is replaced first,
+ * followed by empty entry and entry closest to expiration
+ *
+ * \param[in]       hs: HTTP state
+ */
+static void
+http_resp_cache_finish(http_state_t* hs) {
+    http_resp_cache_t* e = NULL;
+    uint32_t now, age, rem, best_rem = 0;
+    size_t len;
+    char* d;
+
+    d = lwesp_pbuf_data(hs->resp_cache_fill);
+    len = hs->resp_cache_body + hs->resp_cache_fill_len;
+    d[len] = 0;                                 /* Body is used as string when opened */
+    lwesp_pbuf_set_length(hs->resp_cache_fill, len + 1);
+
+    now = lwesp_sys_now();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(http_resp_cache); ++i) {
+        http_resp_cache_t* c = &http_resp_cache[i];
+
+        if (c->p != NULL && !strcmp(lwesp_pbuf_data(c->p), d)) {
+            e = c;
+            break;
+        }
+        rem = 0;
+        if (c->p != NULL && (age = now - c->time) < c->ttl) {
+            rem = c->ttl - age;
+        }
+        if (e == NULL || rem < best_rem) {
+            e = c;
+            best_rem = rem;
+        }
+    }
+    if (e->p != NULL) {
+        lwesp_pbuf_free(e->p);
+    }
+    e->p = hs->resp_cache_fill;
+    e->time = now;
+    e->ttl = hs->resp_cache_ttl;
+    hs->resp_cache_fill = NULL;
+}
+
+#endif /* HTTP_RESP_CACHE_SIZE > 0 */
+
+/**
+ * \brief           Write response body data to connection output
+ *
+ * In case of chunked response, data are collected to chunk first
+ *
+ * \param[in]       hs: HTTP state
+ * \param[in]       data: Data to write
+ * \param[in]       len: Length of data in units of bytes
+ */
+static void
+http_write(http_state_t* hs, const void* data, size_t len) {
+#if HTTP_RESP_CACHE_SIZE > 0
+    if (hs->resp_cache_fill != NULL) {
+        http_resp_cache_write(hs, data, len);
+    }
+#endif /* HTTP_RESP_CACHE_SIZE > 0 */
+#if HTTP_USE_CHUNKED
+    if (hs->chunked) {
+        const uint8_t* d = data;
+        size_t to_copy;
+
+        while (len > 0) {
+            to_copy = LWESP_MIN(len, sizeof(hs->chunk_buff) - hs->chunk_len);
+            LWESP_MEMCPY(&hs->chunk_buff[hs->chunk_len], d, to_copy);
+            hs->chunk_len += to_copy;
+            d += to_copy;
+            len -= to_copy;
+            if (hs->chunk_len == sizeof(hs->chunk_buff)) {
+                http_chunk_flush(hs);           /* Chunk is full, write it */
+            }
+        }
+        return;
+    }
+#endif /* HTTP_USE_CHUNKED */
+    lwesp_conn_write(hs->conn, data, len, 0, &hs->conn_mem_available);
+    hs->written_total += len;                   /* Increase total length */
+}
+
+/**
+ * \brief           Check if URI has one of SSI enabled suffixes
+ * \param[in]       uri: File URI without parameters
+ * \return          `1` if SSI is supported on file, `0` otherwise
+ */
+static uint8_t
+http_uri_is_ssi(const char* uri) {
+    size_t uri_len, suffix_len;
+    const char* suffix;
+
+    uri_len = strlen(uri);                      /* Get length of URI */
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(http_ssi_suffixes); ++i) {
+        suffix = http_ssi_suffixes[i];          /* Get suffix */
+        suffix_len = strlen(suffix);            /* Get length of suffix */
+
+        if (suffix_len < uri_len && !strcmpa(suffix, &uri[uri_len - suffix_len])) {
+            return 1;                           /* We have a SSI tag */
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Open response file for URI
+ *
+ * When client accepts gzip encoding, compressed `.gz` sibling is tried first
+ *
+ * \param[in]       hs: HTTP state
+ * \param[in]       uri: File URI without parameters
+ * \return          `1` if file is opened, `0` otherwise
+ */
+static uint8_t
+http_open_file(http_state_t* hs, const char* uri) {
+#if HTTP_USE_GZIP_FILES
+    static char gz_path[HTTP_MAX_URI_LEN + 4];
+    size_t uri_len;
+
+    if (hs->accept_gzip && !http_uri_is_ssi(uri)
+        && (uri_len = strlen(uri)) < (sizeof(gz_path) - 3)) {
+        LWESP_MEMCPY(gz_path, uri, uri_len);
+        LWESP_MEMCPY(&gz_path[uri_len], ".gz", 4);
+        if (http_fs_data_open_file(hi, &hs->rlwesp_file, gz_path)) {
+            hs->is_gzip = 1;
+            return 1;
+        }
+    }
+#endif /* HTTP_USE_GZIP_FILES */
+    return http_fs_data_open_file(hi, &hs->rlwesp_file, uri);
+}
+
+/**
+ * \brief           Get file from uri in format /folder/file?param1=value1&...
+ * \param[in]       hs: HTTP state
+ * \param[in]       uri: Input URI to get file for
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+http_get_file_from_uri(http_state_t* hs, const char* uri) {
+    size_t uri_len;
+
+    LWESP_MEMSET(&hs->rlwesp_file, 0x00, sizeof(hs->rlwesp_file));
+#if HTTP_USE_GZIP_FILES
+    hs->is_gzip = 0;
+#endif /* HTTP_USE_GZIP_FILES */
+    uri_len = strlen(uri);                      /* Get URI total length */
+    hs->req_params = strchr(uri, '?');          /* Parameters are parsed only when handler asks for them */
+    if (hs->req_params != NULL) {
+        ++hs->req_params;
+    }
+    if ((uri_len == 1 && uri[0] == '/') ||      /* Index file only requested */
+        (uri_len > 1 && uri[0] == '/' && uri[1] == '?')) {  /* Index file + parameters */
+        size_t i;
+        /*
+         * Scan index files and check if there is one from user
+         * available to return as main file
+         */
+        for (i = 0; i < LWESP_ARRAYSIZE(http_index_filenames); ++i) {
+            hs->rlwesp_file_opened = http_open_file(hs, http_index_filenames[i]);   /* Give me a file with desired path */
+            if (hs->rlwesp_file_opened) {       /* Do we have a file? */
+                uri = http_index_filenames[i];  /* Set new URI for next of this func */
+                break;
+            }
+        }
+    }
+
+    /*
+     * We still don't have a file,
+     * maybe there was a request for specific file and possible parameters
+     */
+    if (!hs->rlwesp_file_opened) {
+        char* req_params;
+        const http_cgi_t* cgi;
+#if HTTP_RESP_CACHE_SIZE > 0
+        uint8_t cache = 0;
+        const char* cache_uri = NULL;
+#endif /* HTTP_RESP_CACHE_SIZE > 0 */
+        req_params = strchr(uri, '?');          /* Search for params delimiter */
+        if (req_params != NULL) {               /* We found parameters? They should not exists in static strings or we may have buf! */
+            req_params[0] = 0;                  /* Reset everything at this point */
+            ++req_params;                       /* Skip NULL part and go to next one */
+        }
+
+        /* Check if any user specific controls to process */
+        if ((cgi = http_cgi_find(uri, hs->req_method)) != NULL) {
+#if HTTP_RESP_CACHE_SIZE > 0
+            cache = cgi->cache_ttl > 0 && hs->req_method == HTTP_METHOD_GET
+                    && http_resp_cache_key_build(uri, req_params);
+            if (cache && (cache_uri = http_resp_cache_open(hs)) != NULL) {
+                uri = cache_uri;                /* Rendered output is available, skip handler */
+            } else
+#endif /* HTTP_RESP_CACHE_SIZE > 0 */
+            if (cgi->req_fn != NULL) {
+                uri = cgi->req_fn(hs);
+            } else if (cgi->fn != NULL) {
+                size_t params_len = http_get_params(req_params);    /* Get request params from request */
+                uri = cgi->fn(http_params, params_len);
+            }
+        }
+#if HTTP_RESP_CACHE_SIZE > 0
+        if (cache_uri != NULL) {
+            hs->rlwesp_file_opened = 1;
+        } else
+#endif /* HTTP_RESP_CACHE_SIZE > 0 */
+        {
+            hs->rlwesp_file_opened = http_open_file(hs, uri);   /* Give me a new file now */
+        }
+#if HTTP_RESP_CACHE_SIZE > 0
+        /* Only SSI output depends on request, other files are sent as they are */
+        if (cache && cache_uri == NULL && hs->rlwesp_file_opened && http_uri_is_ssi(uri)) {
+            http_resp_cache_start(hs, uri, cgi->cache_ttl);
+        }
+#endif /* HTTP_RESP_CACHE_SIZE > 0 */
     }
 
     /*
@@ -483,21 +1501,20 @@ http_get_file_from_uri(http_state_t* hs, const char* uri) {
      * Check if SSI should be supported on this file
      */
     hs->is_ssi = 0;                             /* By default no SSI is supported */
-    if (hs->rlwesp_file_opened) {
-        size_t uri_len, suffix_len;
-        const char* suffix;
-
-        uri_len = strlen(uri);                  /* Get length of URI */
-        for (size_t i = 0; i < LWESP_ARRAYSIZE(http_ssi_suffixes); ++i) {
-            suffix = http_ssi_suffixes[i];      /* Get suffix */
-            suffix_len = strlen(suffix);        /* Get length of suffix */
+    if (hs->rlwesp_file_opened
+#if HTTP_RESP_CACHE_SIZE > 0
+        && hs->resp_cache == NULL               /* Cached output is already processed */
+#endif /* HTTP_RESP_CACHE_SIZE > 0 */
+       ) {
+        hs->is_ssi = http_uri_is_ssi(uri);
+    }
 
-            if (suffix_len < uri_len && !strcmpa(suffix, &uri[uri_len - suffix_len])) {
-                hs->is_ssi = 1;                 /* We have a SSI tag */
-                break;
-            }
-        }
+#if HTTP_SSI_PRECOMPILED
+    /* Static SSI files are compiled to segments on first load */
+    if (hs->is_ssi && hs->rlwesp_file.is_static && hs->rlwesp_file.ssi_segments == NULL) {
+        http_fs_data_ssi_compile(&hs->rlwesp_file);
     }
+#endif /* HTTP_SSI_PRECOMPILED */
 
 #if HTTP_DYNAMIC_HEADERS
     /*
@@ -531,11 +1548,329 @@ http_post_send_to_user(http_state_t* hs, lwesp_pbuf_p pbuf, size_t offset) {
     if (new_pbuf != NULL) {
         lwesp_pbuf_advance(new_pbuf, offset);   /* Advance pbuf for remaining bytes */
 
-        hi->post_data_fn(hs, new_pbuf);         /* Notify user with data */
+        if (hi->post_data_fn(hs, new_pbuf) == lwespINPROG) {/* Notify user with data */
+            hs->post_defer = 1;                 /* User acknowledges data later */
+        }
     }
 }
 #endif /* HTTP_SUPPORT_POST */
 
+#if HTTP_USE_WEBSOCKET
+
+/**
+ * \brief           Write single unmasked frame to connection output
+ * \param[in]       hs: HTTP state
+ * \param[in]       opcode: Frame opcode
+ * \param[in]       data: Frame payload
+ * \param[in]       len: Length of payload in units of bytes
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+static lwespr_t
+http_ws_write_frame(http_state_t* hs, uint8_t opcode, const void* data, size_t len) {
+    uint8_t hdr[10];
+    size_t hdr_len = 2;
+    lwespr_t res;
+
+    hdr[0] = 0x80 | opcode;                     /* Server always sends final frames */
+    if (len < 126) {
+        hdr[1] = (uint8_t)len;
+    } else if (len <= 0xFFFF) {
+        hdr[1] = 126;
+        hdr[2] = (uint8_t)(len >> 8);
+        hdr[3] = (uint8_t)len;
+        hdr_len = 4;
+    } else {
+        hdr[1] = 127;
+        LWESP_MEMSET(&hdr[2], 0x00, 4);
+        hdr[6] = (uint8_t)((uint32_t)len >> 24);
+        hdr[7] = (uint8_t)((uint32_t)len >> 16);
+        hdr[8] = (uint8_t)((uint32_t)len >> 8);
+        hdr[9] = (uint8_t)len;
+        hdr_len = 10;
+    }
+    res = lwesp_conn_write(hs->conn, hdr, hdr_len, len == 0, &hs->conn_mem_available);
+    if (res == lwespOK && len > 0) {
+        res = lwesp_conn_write(hs->conn, data, len, 1, &hs->conn_mem_available);
+    }
+    return res;
+}
+
+/**
+ * \brief           Switch connection to WebSocket protocol if client requested it
+ * \param[in]       hs: HTTP state
+ * \return          `1` if connection has been switched, `0` otherwise
+ */
+static uint8_t
+http_ws_upgrade(http_state_t* hs) {
+    static const char resp[] = "HTTP/1.1 101 Switching Protocols" CRLF
+                               "Upgrade: websocket" CRLF
+                               "Connection: Upgrade" CRLF
+                               "Sec-WebSocket-Accept: ";
+
+    if (!hs->ws_upgrade || !hs->ws_key_valid || hs->req_method != HTTP_METHOD_GET || !hs->req_uri_valid
+        || hi == NULL || hi->ws_connect_fn == NULL || hi->ws_connect_fn(hs, hs->req_uri) != lwespOK) {
+        return 0;
+    }
+    lwesp_conn_write(hs->conn, resp, sizeof(resp) - 1, 0, &hs->conn_mem_available);
+    lwesp_conn_write(hs->conn, hs->ws_accept, 28, 0, &hs->conn_mem_available);
+    lwesp_conn_write(hs->conn, CRLF CRLF, 4, 1, &hs->conn_mem_available);
+
+    hs->ws = 1;
+    hs->ws_hdr_need = 2;
+    LWESP_DEBUGF(LWESP_CFG_DBG_SERVER_TRACE, "[HTTP SERVER] Connection switched to WebSocket\r\n");
+    return 1;
+}
+
+/**
+ * \brief           Stop processing received frames and close connection
+ * \param[in]       hs: HTTP state
+ */
+static void
+http_ws_abort(http_state_t* hs) {
+    LWESP_DEBUGF(LWESP_CFG_DBG_SERVER_TRACE_WARNING, "[HTTP SERVER] WebSocket protocol error, closing\r\n");
+    hs->ws_closing = 1;
+    lwesp_conn_close(hs->conn, 0);
+}
+
+/**
+ * \brief           Pass message payload to user
+ * \param[in]       hs: HTTP state
+ * \param[in]       data: Unmasked payload data
+ * \param[in]       len: Length of data in units of bytes
+ */
+static void
+http_ws_data(http_state_t* hs, const void* data, size_t len) {
+    if (hi != NULL && hi->ws_data_fn != NULL
+        && hi->ws_data_fn(hs, (http_ws_opcode_t)hs->ws_msg_opcode, data, len,
+                          hs->ws_fin && hs->ws_payload_rem == 0) != lwespOK) {
+        hs->ws_closing = 1;
+        lwesp_conn_close(hs->conn, 0);          /* User requested to close connection */
+    }
+}
+
+/**
+ * \brief           Process fully received frame
+ * \param[in]       hs: HTTP state
+ */
+static void
+http_ws_frame_end(http_state_t* hs) {
+    switch (hs->ws_opcode) {
+        case HTTP_WS_OPCODE_PING: {
+            http_ws_write_frame(hs, HTTP_WS_OPCODE_PONG, hs->ws_ctrl, hs->ws_ctrl_len);
+            break;
+        }
+        case HTTP_WS_OPCODE_CLOSE: {
+            /* Reply with the same status code, unless we started closing handshake */
+            if (!hs->ws_close_sent) {
+                http_ws_write_frame(hs, HTTP_WS_OPCODE_CLOSE, hs->ws_ctrl, hs->ws_ctrl_len >= 2 ? 2 : 0);
+                hs->ws_close_sent = 1;
+            }
+            hs->ws_closing = 1;
+            lwesp_conn_close(hs->conn, 0);
+            break;
+        }
+        case HTTP_WS_OPCODE_PONG:
+            break;
+        default: {
+            if (hs->ws_fin) {
+                hs->ws_msg_opcode = 0;          /* Message is complete */
+            }
+            break;
+        }
+    }
+    hs->ws_hdr_len = 0;
+    hs->ws_hdr_need = 2;
+}
+
+/**
+ * \brief           Process fully received frame header
+ * \param[in]       hs: HTTP state
+ * \return          `1` on success, `0` on protocol error
+ */
+static uint8_t
+http_ws_frame_start(http_state_t* hs) {
+    const uint8_t* h = hs->ws_hdr;
+    uint8_t len7 = h[1] & 0x7F;
+
+    hs->ws_fin = (h[0] & 0x80) != 0;
+    hs->ws_opcode = h[0] & 0x0F;
+    if ((h[0] & 0x70) != 0 || !(h[1] & 0x80)) { /* No extensions are negotiated, client must mask */
+        return 0;
+    }
+    if (len7 == 126) {
+        hs->ws_payload_rem = ((uint32_t)h[2] << 8) | h[3];
+    } else if (len7 == 127) {
+        if (h[2] | h[3] | h[4] | h[5]) {        /* Frames above 4 GB are not supported */
+            return 0;
+        }
+        hs->ws_payload_rem = ((uint32_t)h[6] << 24) | ((uint32_t)h[7] << 16) | ((uint32_t)h[8] << 8) | h[9];
+    } else {
+        hs->ws_payload_rem = len7;
+    }
+    LWESP_MEMCPY(hs->ws_mask, &h[hs->ws_hdr_need - 4], 4);
+    hs->ws_mask_pos = 0;
+
+    if (hs->ws_opcode & 0x08) {                 /* Control frames are short and never fragmented */
+        if (!hs->ws_fin || hs->ws_payload_rem > sizeof(hs->ws_ctrl)
+            || (hs->ws_opcode != HTTP_WS_OPCODE_CLOSE && hs->ws_opcode != HTTP_WS_OPCODE_PING
+                && hs->ws_opcode != HTTP_WS_OPCODE_PONG)) {
+            return 0;
+        }
+        hs->ws_ctrl_len = 0;
+    } else if (hs->ws_opcode == HTTP_WS_OPCODE_CONT) {
+        if (hs->ws_msg_opcode == 0) {           /* Continuation without message start */
+            return 0;
+        }
+    } else if ((hs->ws_opcode == HTTP_WS_OPCODE_TEXT || hs->ws_opcode == HTTP_WS_OPCODE_BINARY)
+               && hs->ws_msg_opcode == 0) {
+        hs->ws_msg_opcode = hs->ws_opcode;
+    } else {
+        return 0;
+    }
+
+    if (hs->ws_payload_rem == 0) {
+        if (!(hs->ws_opcode & 0x08) && hs->ws_fin) {
+            http_ws_data(hs, NULL, 0);          /* Empty final frame still completes message */
+        }
+        http_ws_frame_end(hs);
+    }
+    return 1;
+}
+
+/**
+ * \brief           Process received WebSocket data
+ *
+ * Frames are parsed as they arrive and do not have to be received in single packet.
+ * Payload is unmasked directly in packet buffer memory
+ *
+ * \param[in]       hs: HTTP state
+ * \param[in]       p: Received packet buffer
+ * \param[in]       offset: Offset in packet buffer where frame data start
+ */
+static void
+http_ws_recv(http_state_t* hs, lwesp_pbuf_p p, size_t offset) {
+    lwesp_pbuf_cursor_t cur;
+    uint8_t* d;
+    size_t len, n, i;
+
+    lwesp_pbuf_cursor_init(&cur, p, offset);
+    while (!hs->ws_closing && (d = lwesp_pbuf_cursor_peek_linear(&cur, &len)) != NULL) {
+        if (hs->ws_hdr_len < hs->ws_hdr_need) {
+            /* Collect frame header, mask and extended length are known after second byte */
+            for (n = 0; n < len && hs->ws_hdr_len < hs->ws_hdr_need;) {
+                hs->ws_hdr[hs->ws_hdr_len++] = d[n++];
+                if (hs->ws_hdr_len == 2) {
+                    i = hs->ws_hdr[1] & 0x7F;
+                    hs->ws_hdr_need = 2 + (i == 126 ? 2 : i == 127 ? 8 : 0) + ((hs->ws_hdr[1] & 0x80) ? 4 : 0);
+                }
+            }
+            if (hs->ws_hdr_len == hs->ws_hdr_need && !http_ws_frame_start(hs)) {
+                http_ws_abort(hs);
+                break;
+            }
+        } else {
+            n = LWESP_MIN(len, hs->ws_payload_rem);
+            for (i = 0; i < n; ++i) {
+                d[i] ^= hs->ws_mask[hs->ws_mask_pos++ & 0x03];
+            }
+            hs->ws_payload_rem -= (uint32_t)n;
+            if (hs->ws_opcode & 0x08) {
+                LWESP_MEMCPY(&hs->ws_ctrl[hs->ws_ctrl_len], d, n);
+                hs->ws_ctrl_len += (uint8_t)n;
+            } else {
+                http_ws_data(hs, d, n);
+            }
+            if (hs->ws_payload_rem == 0 && !hs->ws_closing) {
+                http_ws_frame_end(hs);
+            }
+        }
+        lwesp_pbuf_cursor_skip(&cur, n);
+    }
+}
+
+#endif /* HTTP_USE_WEBSOCKET */
+
+#if HTTP_FS_ASYNC
+
+static void send_response(http_state_t* hs, uint8_t ft);
+static void http_close_file(http_state_t* hs);
+
+/**
+ * \brief           Start asynchronous read of next file part if possible
+ * \param[in]       hs: HTTP state
+ */
+static void
+http_fs_async_prefetch(http_state_t* hs) {
+    uint32_t btr;
+    uint8_t idx;
+
+    if (hs->fs_pending || hs->fs_eof) {
+        return;
+    }
+
+    /* Buffer after the one with next data, or next one if it is empty */
+    idx = hs->fs_buff_len[hs->fs_next] ? (hs->fs_next ^ 1) : hs->fs_next;
+    if (hs->fs_buff_len[idx] > 0 || (hs->buff != NULL && hs->buff == hs->fs_buff[idx])) {
+        return;                                 /* Both buffers are in use */
+    }
+    btr = LWESP_MIN(hs->rlwesp_file.size - hs->rlwesp_file.fptr, HTTP_FS_ASYNC_BUFF_LEN);
+    if (btr == 0) {
+        hs->fs_eof = 1;
+        return;
+    }
+    if (hs->fs_buff[idx] == NULL
+        && (hs->fs_buff[idx] = lwesp_mem_malloc(HTTP_FS_ASYNC_BUFF_LEN)) == NULL) {
+        return;                                 /* Try again on next poll */
+    }
+    hs->fs_pending = idx + 1;
+    if (!hi->fs_read_start(&hs->rlwesp_file, hs->fs_buff[idx], btr)) {
+        hs->fs_pending = 0;
+        hs->fs_eof = 1;                         /* Read cannot be started, finish response */
+    }
+}
+
+/**
+ * \brief           Get next file part read asynchronously
+ * \param[in]       hs: HTTP state
+ * \return          `1` if buffer is ready, `0` otherwise
+ */
+static uint32_t
+read_rlwesp_file_async(http_state_t* hs) {
+    /* Release buffer which has been processed */
+    if (hs->buff != NULL) {
+        hs->buff = NULL;
+    }
+    hs->buff_ptr = 0;
+
+    if (hs->fs_buff_len[hs->fs_next] > 0) {     /* Next data are ready */
+        hs->buff = hs->fs_buff[hs->fs_next];
+        hs->buff_len = hs->fs_buff_len[hs->fs_next];
+        hs->fs_buff_len[hs->fs_next] = 0;
+        hs->fs_next ^= 1;
+    }
+    http_fs_async_prefetch(hs);                 /* Read ahead while current data are being sent */
+    return hs->buff != NULL;
+}
+
+/**
+ * \brief           Asynchronous read finished, process it in stack thread
+ * \param[in]       arg: HTTP state
+ */
+static void
+http_fs_async_done_cb(void* arg) {
+    http_state_t* hs = arg;
+
+    if (hs->fs_closed) {                        /* Connection closed during read */
+        http_close_file(hs);
+        lwesp_mem_free_s((void**)&hs);
+        --http_states_cnt;
+        return;
+    }
+    send_response(hs, 0);                       /* Continue with response */
+}
+
+#endif /* HTTP_FS_ASYNC */
+
 /**
  * \brief           Read next part of response file
  * \param[in]       hs: HTTP state
@@ -547,6 +1882,11 @@ read_rlwesp_file(http_state_t* hs) {
     if (!hs->rlwesp_file_opened) {              /* File should be opened at this point! */
         return 0;
     }
+#if HTTP_FS_ASYNC
+    if (!hs->rlwesp_file.is_static && hi != NULL && hi->fs_read_start != NULL) {
+        return read_rlwesp_file_async(hs);
+    }
+#endif /* HTTP_FS_ASYNC */
 
     hs->buff_ptr = 0;                           /* Reset buffer pointer at this point */
 
@@ -573,8 +1913,8 @@ read_rlwesp_file(http_state_t* hs) {
                     hs->buff = NULL;            /* Reset buffer */
                 }
             } else {
-                if (len > LWESP_CFG_CONN_MAX_DATA_LEN) {/* Limit to maximal length */
-                    len = LWESP_CFG_CONN_MAX_DATA_LEN;
+                if (len > lwesp_conn_get_max_data_len()) {  /* Limit to maximal length */
+                    len = lwesp_conn_get_max_data_len();
                 }
                 hs->buff_ptr = 0;               /* Reset read pointer */
                 do {
@@ -617,8 +1957,7 @@ send_response_ssi(http_state_t* hs) {
         size_t len;
         len = LWESP_MIN(hs->ssi_tag_buff_ptr - hs->ssi_tag_buff_written, hs->conn_mem_available);
         if (len > 0) {                          /* More data to send? */
-            lwesp_conn_write(hs->conn, &hs->ssi_tag_buff[hs->ssi_tag_buff_written], len, 0, &hs->conn_mem_available);
-            hs->written_total += len;           /* Increase total number of written elements */
+            http_write(hs, &hs->ssi_tag_buff[hs->ssi_tag_buff_written], len);
             hs->ssi_tag_buff_written += len;    /* Increase total number of written SSI buffer */
 
             if (hs->ssi_tag_buff_written == hs->ssi_tag_buff_ptr) {
@@ -714,16 +2053,14 @@ send_response_ssi(http_state_t* hs) {
                     size_t len;
 
                     len = LWESP_MIN(hs->ssi_tag_buff_ptr, hs->conn_mem_available);
-                    lwesp_conn_write(hs->conn, hs->ssi_tag_buff, len, 0, &hs->conn_mem_available);
-                    hs->written_total += len;   /* Increase total written length */
+                    http_write(hs, hs->ssi_tag_buff, len);
                     hs->ssi_tag_buff_written = len; /* Set length of number of written buffer */
                     if (len == hs->ssi_tag_buff_ptr) {
                         hs->ssi_tag_buff_ptr = 0;
                     }
                 }
                 if (hs->conn_mem_available > 0) {   /* Is there memory to write a current byte? */
-                    lwesp_conn_write(hs->conn, &ch, 1, 0, &hs->conn_mem_available);
-                    ++hs->written_total;
+                    http_write(hs, &ch, 1);
                     ++hs->buff_ptr;
                 }
                 hs->ssi_state = HTTP_SSI_STATE_WAIT_BEGIN;
@@ -732,9 +2069,141 @@ send_response_ssi(http_state_t* hs) {
             }
         }
     }
-    lwesp_conn_write(hs->conn, NULL, 0, 1, &hs->conn_mem_available);/* Flush to output if possible */
+#if HTTP_USE_CHUNKED
+    http_chunk_flush(hs);                       /* Do not wait for full chunk */
+#endif /* HTTP_USE_CHUNKED */
+    lwesp_conn_write(hs->conn, NULL, 0, 1, &hs->conn_mem_available);/* Flush to output if possible */
+}
+
+#if HTTP_SSI_PRECOMPILED || __DOXYGEN__
+
+/**
+ * \brief           Send response using precompiled SSI segments
+ *
+ * Literal spans are written directly from file memory,
+ * SSI callback is called only at tag boundaries
+ *
+ * \param[in]       hs: HTTP state
+ */
+static void
+send_response_ssi_compiled(http_state_t* hs) {
+    const http_fs_file_t* file = &hs->rlwesp_file;
+    const http_ssi_segment_t* seg;
+    uint32_t skip, off, end, len;
+
+    LWESP_DEBUGF(LWESP_CFG_DBG_SERVER_TRACE, "[HTTP SERVER] processing with precompiled SSI\r\n");
+
+    /* First get available memory in output buffer */
+    lwesp_conn_write(hs->conn, NULL, 0, 0, &hs->conn_mem_available);
+
+    /* Headers part may have been skipped by dynamic headers */
+    skip = (uint32_t)(file->data - file->ssi_base);
+    if (hs->buff == NULL && hs->ssi_seg_idx == 0) {
+        hs->buff = file->data;                  /* Mark response in progress */
+    }
+
+    while (hs->ssi_seg_idx < file->ssi_segments_count && hs->conn_mem_available > 0) {
+        seg = &file->ssi_segments[hs->ssi_seg_idx];
+
+        /* Write literal span, as much as output buffer allows */
+        off = LWESP_MAX(seg->offset, skip) + hs->ssi_seg_pos;
+        end = seg->offset + seg->len;
+        if (off < end) {
+            len = LWESP_MIN(end - off, (uint32_t)hs->conn_mem_available);
+            http_write(hs, &file->ssi_base[off], len);
+            hs->ssi_seg_pos += len;
+            if (off + len < end) {              /* Continue with the rest of span */
+                continue;
+            }
+        }
+
+        /* Literal span is written, process tag at its end */
+        if (seg->tag_len > 0 && seg->tag_offset >= skip) {
+            len = LWESP_MIN(seg->tag_len, (uint32_t)HTTP_SSI_TAG_MAX_LEN);
+            LWESP_MEMCPY(hs->ssi_tag_buff, &file->ssi_base[seg->tag_offset], len);
+            hs->ssi_tag_buff[len] = 0;
+
+            hs->ssi_tag_process_more = 0;
+            if (hi != NULL && hi->ssi_fn != NULL) {
+                hs->ssi_tag_process_more = !hi->ssi_fn(hs, hs->ssi_tag_buff, len);
+            }
+            if (hs->ssi_tag_process_more) {     /* Call the same tag again on next round */
+                break;
+            }
+        }
+        ++hs->ssi_seg_idx;
+        hs->ssi_seg_pos = 0;
+    }
+    if (hs->ssi_seg_idx >= file->ssi_segments_count) {
+        hs->buff = NULL;                        /* Everything has been written */
+    }
+#if HTTP_USE_CHUNKED
+    http_chunk_flush(hs);                       /* Do not wait for full chunk */
+#endif /* HTTP_USE_CHUNKED */
+    lwesp_conn_write(hs->conn, NULL, 0, 1, &hs->conn_mem_available);/* Flush to output if possible */
+}
+
+#endif /* HTTP_SSI_PRECOMPILED || __DOXYGEN__ */
+
+#if LWESP_CFG_CONN_SENDFILE
+
+/**
+ * \brief           Read next part of response file directly to connection send buffer
+ * \param[in]       arg: HTTP state
+ * \param[in]       offset: Unused, file is read in sequence from its file pointer
+ * \param[out]      buff: Buffer to read data to
+ * \param[in]       btr: Number of bytes to read
+ * \return          Number of bytes read
+ */
+static size_t
+http_sendfile_read(void* arg, size_t offset, void* buff, size_t btr) {
+    http_state_t* hs = arg;
+
+    LWESP_UNUSED(offset);
+    return http_fs_data_read_file(hi, &hs->rlwesp_file, &buff, btr, NULL);
+}
+
+/**
+ * \brief           Response file transfer finished callback
+ * \param[in]       res: Transfer result
+ * \param[in]       arg: Connection handle
+ */
+static void
+http_sendfile_evt(lwespr_t res, void* arg) {
+    if (res != lwespOK) {
+        lwesp_conn_close(arg, 0);               /* Response cannot be completed */
+    }
+}
+
+/**
+ * \brief           Start sending remaining part of dynamic response file with \ref lwesp_conn_sendfile
+ * \param[in]       hs: HTTP state
+ * \return          `1` if transfer has been started, `0` otherwise
+ */
+static uint8_t
+http_sendfile_start(http_state_t* hs) {
+    uint32_t len;
+
+    if (!hs->rlwesp_file_opened || hs->rlwesp_file.is_static
+#if HTTP_FS_ASYNC
+        || (hi != NULL && hi->fs_read_start != NULL)
+#endif /* HTTP_FS_ASYNC */
+       ) {
+        return 0;
+    }
+    len = http_fs_data_read_file(hi, &hs->rlwesp_file, NULL, 0, NULL);
+    if (len == 0 || lwesp_conn_sendfile(hs->conn, http_sendfile_read, hs, hs->rlwesp_file.fptr, len,
+                                        http_sendfile_evt, hs->conn) != lwespOK) {
+        return 0;
+    }
+    hs->sendfile = 1;
+    hs->written_total += len;
+    hs->conn_mem_available = 0;                 /* Write buffer has been flushed */
+    return 1;
 }
 
+#endif /* LWESP_CFG_CONN_SENDFILE */
+
 /**
  * \brief           Send more data without SSI tags parsing
  * \param[in]       hs: HTTP state
@@ -743,11 +2212,32 @@ static void
 send_response_no_ssi(http_state_t* hs) {
     LWESP_DEBUGF(LWESP_CFG_DBG_SERVER_TRACE, "[HTTP SERVER] processing NO SSI\r\n");
 
+#if LWESP_CFG_CONN_SENDFILE
+    /* Dynamic file is read directly to send buffers, called again once everything is sent */
+    if (hs->sendfile) {
+        hs->sendfile = 0;
+    } else if (http_sendfile_start(hs)) {
+        return;
+    }
+#endif /* LWESP_CFG_CONN_SENDFILE */
+
     /* Are we ready to read more? */
     if (hs->buff == NULL || hs->written_total == hs->sent_total) {
         read_rlwesp_file(hs);                   /* Try to read response file */
     }
 
+#if HTTP_USE_ZERO_COPY_STATIC
+    /* Static file is sent by reference, write buffer with headers is flushed first */
+    if (hs->buff != NULL && hs->rlwesp_file.is_static) {
+        hs->zc_iov.data = hs->buff;
+        hs->zc_iov.len = hs->buff_len;
+        if (lwesp_conn_sendv(hs->conn, &hs->zc_iov, 1, NULL, 0) == lwespOK) {
+            hs->written_total += hs->buff_len;
+        }
+        return;
+    }
+#endif /* HTTP_USE_ZERO_COPY_STATIC */
+
     /*
      * Do we have a file?
      * Static file should be processed only once at the end
@@ -780,6 +2270,11 @@ send_response_no_ssi(http_state_t* hs) {
     }
 }
 
+static void http_recv(http_state_t* hs, lwesp_pbuf_p p);
+#if HTTP_USE_KEEP_ALIVE
+static void http_state_next(http_state_t* hs);
+#endif /* HTTP_USE_KEEP_ALIVE */
+
 /**
  * \brief           Send response back to connection
  * \param[in]       hs: HTTP state
@@ -788,6 +2283,9 @@ send_response_no_ssi(http_state_t* hs) {
 static void
 send_response(http_state_t* hs, uint8_t ft) {
     uint8_t close = 0;
+#if HTTP_USE_KEEP_ALIVE
+    uint8_t next = 0;
+#endif /* HTTP_USE_KEEP_ALIVE */
 
     if (!hs->process_resp ||                    /* Not yet ready to process response? */
         (hs->written_total > 0 && hs->written_total != hs->sent_total)) {   /* Did we wrote something but didn't send yet? */
@@ -813,8 +2311,19 @@ send_response(http_state_t* hs, uint8_t ft) {
 #endif /* HTTP_DYNAMIC_HEADERS */
         {
             /* Process and send more data to output */
+#if HTTP_USE_CHUNKED
+            if (hs->chunked_done) {             /* Last chunk has been sent, nothing more to process */
+            } else
+#endif /* HTTP_USE_CHUNKED */
             if (hs->is_ssi) {                   /* In case of SSI request, process data using SSI */
-                send_response_ssi(hs);          /* Send response using SSI parsing */
+#if HTTP_SSI_PRECOMPILED
+                if (hs->rlwesp_file.ssi_segments != NULL) {
+                    send_response_ssi_compiled(hs); /* Send response using precompiled segments */
+                } else
+#endif /* HTTP_SSI_PRECOMPILED */
+                {
+                    send_response_ssi(hs);      /* Send response using SSI parsing */
+                }
             } else {
                 send_response_no_ssi(hs);       /* Send response without SSI parsing */
             }
@@ -825,8 +2334,37 @@ send_response(http_state_t* hs, uint8_t ft) {
              *
              * Currently this is a solution to close the file
              */
-            if (hs->buff == NULL) {             /* Sent everything or problem somehow? */
-                close = 1;
+            if (hs->buff == NULL                /* Sent everything or problem somehow? */
+#if LWESP_CFG_CONN_SENDFILE
+                && !hs->sendfile
+#endif /* LWESP_CFG_CONN_SENDFILE */
+#if HTTP_FS_ASYNC
+                && (hs->rlwesp_file.is_static || hi == NULL || hi->fs_read_start == NULL
+                    || (hs->fs_pending == 0 && hs->fs_eof && hs->fs_buff_len[hs->fs_next] == 0))
+#endif /* HTTP_FS_ASYNC */
+               ) {
+#if HTTP_RESP_CACHE_SIZE > 0
+                if (hs->resp_cache_fill != NULL) {
+                    http_resp_cache_finish(hs); /* Entire response has been rendered */
+                }
+#endif /* HTTP_RESP_CACHE_SIZE > 0 */
+#if HTTP_USE_CHUNKED
+                if (hs->chunked && !hs->chunked_done) {
+                    /* Write last chunk and finish response once it is sent */
+                    http_chunk_flush(hs);
+                    lwesp_conn_write(hs->conn, "0" CRLF CRLF, 5, 1, &hs->conn_mem_available);
+                    hs->written_total += 5;
+                    hs->chunked_done = 1;
+                } else
+#endif /* HTTP_USE_CHUNKED */
+#if HTTP_USE_KEEP_ALIVE
+                if (hs->keep_alive) {
+                    next = 1;                   /* Keep connection for next request */
+                } else
+#endif /* HTTP_USE_KEEP_ALIVE */
+                {
+                    close = 1;
+                }
             }
         }
 #if HTTP_DYNAMIC_HEADERS
@@ -863,6 +2401,246 @@ send_response(http_state_t* hs, uint8_t ft) {
     if (close) {
         lwesp_conn_close(hs->conn, 0);          /* Close the connection as no file opened in this case */
     }
+#if HTTP_USE_KEEP_ALIVE
+    if (next) {
+        http_state_next(hs);                    /* Prepare for next request */
+    }
+#endif /* HTTP_USE_KEEP_ALIVE */
+}
+
+/**
+ * \brief           Close response file and free its buffer
+ * \param[in]       hs: HTTP state
+ */
+static void
+http_close_file(http_state_t* hs) {
+#if HTTP_SUPPORT_POST
+    if (hs->post_unacked != NULL) {             /* Release data user did not acknowledge */
+        lwesp_conn_recved(hs->conn, hs->post_unacked);
+        lwesp_conn_set_receive_blocked(hs->conn, 0);
+        lwesp_pbuf_free(hs->post_unacked);
+        hs->post_unacked = NULL;
+    }
+#endif /* HTTP_SUPPORT_POST */
+#if HTTP_FS_ASYNC
+    if (hs->fs_buff[0] != NULL || hs->fs_buff[1] != NULL) {
+        hs->buff = NULL;                        /* Buffer belongs to read buffers */
+        lwesp_mem_free_s((void**)&hs->fs_buff[0]);
+        lwesp_mem_free_s((void**)&hs->fs_buff[1]);
+    }
+#endif /* HTTP_FS_ASYNC */
+    if (hs->rlwesp_file_opened) {               /* Is file opened? */
+        uint8_t is_static = hs->rlwesp_file.is_static;
+        http_fs_data_close_file(hi, &hs->rlwesp_file);  /* Close file at this point */
+        if (!is_static && hs->buff != NULL) {
+            lwesp_mem_free_s((void**)&hs->buff);
+        }
+        hs->rlwesp_file_opened = 0;             /* File is not opened anymore */
+    }
+#if HTTP_RESP_CACHE_SIZE > 0
+    if (hs->resp_cache != NULL) {
+        lwesp_pbuf_free(hs->resp_cache);
+        hs->resp_cache = NULL;
+    }
+    if (hs->resp_cache_fill != NULL) {          /* Response was not completed */
+        lwesp_pbuf_free(hs->resp_cache_fill);
+        hs->resp_cache_fill = NULL;
+    }
+#endif /* HTTP_RESP_CACHE_SIZE > 0 */
+}
+
+#if HTTP_USE_KEEP_ALIVE
+
+/**
+ * \brief           Finish current response and prepare state for next request on the same connection
+ * \param[in]       hs: HTTP state
+ */
+static void
+http_state_next(http_state_t* hs) {
+    lwesp_pbuf_p next = hs->p_next;
+    lwesp_conn_p conn = hs->conn;
+    void* arg = hs->arg;
+
+    http_close_file(hs);
+    LWESP_MEMSET(hs, 0x00, sizeof(*hs));
+    hs->conn = conn;
+    hs->arg = arg;
+    hs->ka_idle = 1;
+    hs->ka_idle_start = lwesp_sys_now();
+
+    LWESP_DEBUGF(LWESP_CFG_DBG_SERVER_TRACE, "[HTTP SERVER] Keep-alive, waiting for next request\r\n");
+
+    /* Process pipelined data as newly received */
+    if (next != NULL) {
+        http_recv(hs, next);
+        lwesp_pbuf_free(next);                  /* Release our reference, state keeps its own */
+    }
+}
+
+#endif /* HTTP_USE_KEEP_ALIVE */
+
+/**
+ * \brief           Process data received on connection
+ * \param[in]       hs: HTTP state
+ * \param[in]       p: Received packet buffer
+ */
+static void
+http_recv(http_state_t* hs, lwesp_pbuf_p p) {
+    size_t pos, tot_len;
+
+#if HTTP_USE_WEBSOCKET
+    if (hs->ws) {                               /* Connection speaks WebSocket protocol */
+        http_ws_recv(hs, p, 0);
+        return;
+    }
+#endif /* HTTP_USE_WEBSOCKET */
+#if HTTP_RATE_LIMIT_REQS > 0
+    if (hs->rejected) {                         /* Connection is being closed */
+        return;
+    }
+#endif /* HTTP_RATE_LIMIT_REQS > 0 */
+#if HTTP_USE_KEEP_ALIVE
+    if (hs->ka_idle) {                          /* Next request on persistent connection */
+        hs->ka_idle = 0;                        /* Connection is active again */
+#if HTTP_RATE_LIMIT_REQS > 0
+        if (!http_rate_admit(hs->conn)) {
+            hs->rejected = 1;
+            http_reject(hs->conn);
+            return;
+        }
+#endif /* HTTP_RATE_LIMIT_REQS > 0 */
+    }
+#endif /* HTTP_USE_KEEP_ALIVE */
+
+    tot_len = lwesp_pbuf_length(p, 1);          /* Get total length of received pbuf */
+
+    /*
+     * Check if we have to receive headers data first
+     * before we can proceed with everything else
+     */
+    if (!hs->headers_received) {                /* Are we still waiting for headers data? */
+        pos = http_parse_request(hs, p);        /* Parse new data, pos is start of body */
+        if (hs->headers_received) {
+            LWESP_DEBUGF(LWESP_CFG_DBG_SERVER_TRACE, "[HTTP SERVER] HTTP headers received!\r\n");
+
+#if HTTP_USE_KEEP_ALIVE
+            /* HTTP/1.1 is persistent by default, older versions must request it */
+            hs->keep_alive = hs->req_conn_hdr == 2 || (hs->req_http11 && hs->req_conn_hdr != 1);
+#endif /* HTTP_USE_KEEP_ALIVE */
+
+#if HTTP_USE_WEBSOCKET
+            if (http_ws_upgrade(hs)) {
+                if (tot_len > pos) {            /* Client may send first frame together with request */
+                    http_ws_recv(hs, p, pos);
+                }
+                return;
+            }
+#endif /* HTTP_USE_WEBSOCKET */
+
+#if HTTP_SUPPORT_POST
+            /* Check for request method used on this connection */
+            if (hs->req_method == HTTP_METHOD_POST) {
+                /* Check if we are expecting any data on POST request */
+                if (hs->content_length > 0) {
+                    /*
+                     * Call user POST start method here
+                     * to notify him to prepare himself to receive POST data
+                     */
+                    if (hi != NULL && hi->post_start_fn != NULL) {
+                        hi->post_start_fn(hs, hs->req_uri, hs->content_length);
+                    }
+
+                    /*
+                     * Check if there is anything to send already
+                     * to user from data part of request
+                     */
+                    if (tot_len > pos) {
+                        hs->content_received = tot_len - pos;
+
+                        /* Send data to user */
+                        http_post_send_to_user(hs, p, pos);
+
+                        /*
+                         * Did we receive everything in single packet?
+                         * Close POST loop at this point and notify user
+                         */
+                        if (hs->content_received >= hs->content_length) {
+                            hs->process_resp = 1;   /* Process with response to user */
+                            if (hi != NULL && hi->post_end_fn != NULL) {
+                                hi->post_end_fn(hs);
+                            }
+                        }
+                    }
+                } else {
+                    hs->process_resp = 1;
+                }
+            } else
+#endif /* HTTP_SUPPORT_POST */
+            {
+                hs->process_resp = 1;           /* Process with response to user */
+
+#if HTTP_USE_KEEP_ALIVE
+                /* Keep data of pipelined request received together with current one */
+                if (hs->keep_alive && tot_len > pos
+                    && (hs->p_next = lwesp_pbuf_new(tot_len - pos)) != NULL) {
+                    lwesp_pbuf_copy(p, lwesp_pbuf_data(hs->p_next), tot_len - pos, pos);
+                }
+#endif /* HTTP_USE_KEEP_ALIVE */
+            }
+
+            /*
+             * If uri was parsed succssfully and if method is allowed,
+             * then open and prepare file for future response
+             */
+            if (hs->req_uri_valid && hs->req_method != HTTP_METHOD_NOTALLOWED) {
+                http_get_file_from_uri(hs, hs->req_uri);    /* Open file */
+            }
+        }
+    } else {
+#if HTTP_SUPPORT_POST
+        /*
+         * We are receiving request data now
+         * as headers are already received
+         */
+        if (hs->req_method == HTTP_METHOD_POST) {
+            /* Did we receive all the data on POST? */
+            if (hs->content_received < hs->content_length) {
+                hs->content_received += tot_len;
+
+                http_post_send_to_user(hs, p, 0); /* Send data directly to user */
+
+                /* Check if everything received */
+                if (hs->content_received >= hs->content_length) {
+                    hs->process_resp = 1;   /* Process with response to user */
+
+                    /* Stop the response part here! */
+                    if (hi != NULL && hi->post_end_fn) {
+                        hi->post_end_fn(hs);
+                    }
+                }
+            }
+        } else
+#endif /* HTTP_SUPPORT_POST */
+#if HTTP_USE_KEEP_ALIVE
+        if (hs->keep_alive) {
+            /* Pipelined request, keep it until current response is finished */
+            if (hs->p_next == NULL) {
+                hs->p_next = p;
+            } else {
+                lwesp_pbuf_cat(hs->p_next, p);
+            }
+            lwesp_pbuf_ref(p);
+        } else
+#endif /* HTTP_USE_KEEP_ALIVE */
+        {
+            /* Protocol violation at this point! */
+        }
+    }
+
+    /* Do the processing on response */
+    if (hs->process_resp) {
+        send_response(hs, 1);               /* Send the response data */
+    }
 }
 
 /**
@@ -885,10 +2663,25 @@ http_evt(lwesp_evt_t* evt) {
         case LWESP_EVT_CONN_ACTIVE: {
             LWESP_DEBUGF(LWESP_CFG_DBG_SERVER_TRACE_WARNING, "[HTTP SERVER] Conn %d active\r\n",
                        (int)lwesp_conn_getnum(conn));
+#if HTTP_USE_ADMISSION
+            if (http_states_cnt >= HTTP_MAX_CONCURRENT_REQS
+#if HTTP_RATE_LIMIT_REQS > 0
+                || !http_rate_admit(conn)
+#endif /* HTTP_RATE_LIMIT_REQS > 0 */
+               ) {
+                http_reject(conn);              /* Reject before any memory is allocated */
+                break;
+            }
+#endif /* HTTP_USE_ADMISSION */
             hs = lwesp_mem_calloc(1, sizeof(*hs));
             if (hs != NULL) {
+                ++http_states_cnt;
                 hs->conn = conn;                /* Save connection handle */
                 lwesp_conn_set_arg(conn, hs);   /* Set argument for connection */
+#if LWESP_CFG_CONN_SEND_EVT_AGGR
+                /* Response continues only once all written data are sent, report them together */
+                lwesp_conn_set_send_evt_batch(conn, (size_t)-1);
+#endif /* LWESP_CFG_CONN_SEND_EVT_AGGR */
             } else {
                 LWESP_DEBUGF(LWESP_CFG_DBG_SERVER_TRACE_WARNING,
                            "[HTTP SERVER] Cannot allocate memory for http state\r\n");
@@ -900,168 +2693,29 @@ http_evt(lwesp_evt_t* evt) {
         /* Data received on connection */
         case LWESP_EVT_CONN_RECV: {
             lwesp_pbuf_p p;
-            size_t pos;
 
             p = lwesp_evt_conn_recv_get_buff(evt);  /* Get received buffer */
             if (hs != NULL) {                   /* Do we have a valid http state? */
-                /*
-                 * Check if we have to receive headers data first
-                 * before we can proceed with everything else
-                 */
-                if (!hs->headers_received) {    /* Are we still waiting for headers data? */
-                    if (hs->p == NULL) {
-                        hs->p = p;              /* This is a first received packet */
-                    } else {
-                        lwesp_pbuf_cat(hs->p, p);   /* Add new packet to the end of linked list of recieved data */
-                    }
-                    lwesp_pbuf_ref(p);          /* Increase reference counter */
-
-                    /*
-                     * Check if headers are fully received.
-                     * To know this, search for "\r\n\r\n" sequence in received data
-                     */
-                    if ((pos = lwesp_pbuf_strfind(hs->p, CRLF CRLF, 0)) != LWESP_SIZET_MAX) {
-                        uint8_t http_uri_parsed;
-                        LWESP_DEBUGF(LWESP_CFG_DBG_SERVER_TRACE, "[HTTP SERVER] HTTP headers received!\r\n");
-                        hs->headers_received = 1;   /* Flag received headers */
-
-                        /* Parse the URI, process request and open response file */
-                        http_uri_parsed = http_parse_uri(hs->p) == lwespOK;
-
+                http_recv(hs, p);       /* Process received data */
+            } else {
+                close = 1;
+            }
 #if HTTP_SUPPORT_POST
-                        /* Check for request method used on this connection */
-                        if (!lwesp_pbuf_strcmp(hs->p, "POST ", 0)) {
-                            size_t data_pos, pbuf_total_len;
-
-                            hs->req_method = HTTP_METHOD_POST;  /* Save a new value as POST method */
-
-                            /*
-                             * At this point, all headers are received
-                             * We can start process them into something useful
-                             */
-                            data_pos = pos + 4; /* Ignore 4 bytes of CRLF sequence */
-
-                            /*
-                             * Try to find content length on this request
-                             * search for 2 possible values "Content-Length" or "content-length" parameters
-                             */
-                            hs->content_length = 0;
-                            if (((pos = lwesp_pbuf_strfind(hs->p, "Content-Length:", 0)) != LWESP_SIZET_MAX) ||
-                                (pos = lwesp_pbuf_strfind(hs->p, "content-length:", 0)) != LWESP_SIZET_MAX) {
-                                uint8_t ch;
-
-                                pos += 15;      /* Skip this part */
-                                if (lwesp_pbuf_get_at(hs->p, pos, &ch) && ch == ' ') {
-                                    ++pos;
-                                }
-                                lwesp_pbuf_get_at(hs->p, pos, &ch);
-                                while (ch >= '0' && ch <= '9') {
-                                    hs->content_length = 10 * hs->content_length + (ch - '0');
-                                    ++pos;
-                                    if (!lwesp_pbuf_get_at(hs->p, pos, &ch)) {
-                                        break;
-                                    }
-                                }
-                            }
-
-                            /* Check if we are expecting any data on POST request */
-                            if (hs->content_length > 0) {
-                                /*
-                                 * Call user POST start method here
-                                 * to notify him to prepare himself to receive POST data
-                                 */
-                                if (hi != NULL && hi->post_start_fn != NULL) {
-                                    hi->post_start_fn(hs, http_uri, hs->content_length);
-                                }
-
-                                /*
-                                 * Check if there is anything to send already
-                                 * to user from data part of request
-                                 */
-                                pbuf_total_len = lwesp_pbuf_length(hs->p, 1);   /* Get total length of current received pbuf */
-                                if ((pbuf_total_len - data_pos) > 0) {
-                                    hs->content_received = pbuf_total_len - data_pos;
-
-                                    /* Send data to user */
-                                    http_post_send_to_user(hs, hs->p, data_pos);
-
-                                    /*
-                                     * Did we receive everything in single packet?
-                                     * Close POST loop at this point and notify user
-                                     */
-                                    if (hs->content_received >= hs->content_length) {
-                                        hs->process_resp = 1;   /* Process with response to user */
-                                        if (hi != NULL && hi->post_end_fn != NULL) {
-                                            hi->post_end_fn(hs);
-                                        }
-                                    }
-                                }
-                            } else {
-                                hs->process_resp = 1;
-                            }
-                        } else
-#else /* HTTP_SUPPORT_POST */
-                        LWESP_UNUSED(pos);
-#endif /* !HTTP_SUPPORT_POST */
-                        {
-                            if (!lwesp_pbuf_strcmp(hs->p, "GET ", 0)) {
-                                hs->req_method = HTTP_METHOD_GET;
-                                hs->process_resp = 1;   /* Process with response to user */
-                            } else {
-                                hs->req_method = HTTP_METHOD_NOTALLOWED;
-                                hs->process_resp = 1;
-                            }
-                        }
-
-                        /*
-                         * If uri was parsed succssfully and if method is allowed,
-                         * then open and prepare file for future response
-                         */
-                        if (http_uri_parsed && hs->req_method != HTTP_METHOD_NOTALLOWED) {
-                            http_get_file_from_uri(hs, http_uri);   /* Open file */
-                        }
-                    }
+            if (hs != NULL && hs->post_defer) {
+                /* User processes data later, keep it unacknowledged and stop reading more */
+                hs->post_defer = 0;
+                if (hs->post_unacked == NULL) {
+                    hs->post_unacked = p;
                 } else {
-#if HTTP_SUPPORT_POST
-                    /*
-                     * We are receiving request data now
-                     * as headers are already received
-                     */
-                    if (hs->req_method == HTTP_METHOD_POST) {
-                        /* Did we receive all the data on POST? */
-                        if (hs->content_received < hs->content_length) {
-                            size_t tot_len;
-
-                            tot_len = lwesp_pbuf_length(p, 1);  /* Get length of pbuf */
-                            hs->content_received += tot_len;
-
-                            http_post_send_to_user(hs, p, 0);   /* Send data directly to user */
-
-                            /* Check if everything received */
-                            if (hs->content_received >= hs->content_length) {
-                                hs->process_resp = 1;   /* Process with response to user */
-
-                                /* Stop the response part here! */
-                                if (hi != NULL && hi->post_end_fn) {
-                                    hi->post_end_fn(hs);
-                                }
-                            }
-                        }
-                    } else
-#endif /* HTTP_SUPPORT_POST */
-                    {
-                        /* Protocol violation at this point! */
-                    }
-                }
-
-                /* Do the processing on response */
-                if (hs->process_resp) {
-                    send_response(hs, 1);       /* Send the response data */
+                    lwesp_pbuf_cat(hs->post_unacked, p);
                 }
-            } else {
-                close = 1;
+                lwesp_pbuf_ref(p);
+                lwesp_conn_set_receive_blocked(conn, 1);
+            } else
+#endif /* HTTP_SUPPORT_POST */
+            {
+                lwesp_conn_recved(conn, p);     /* Notify stack about received data */
             }
-            lwesp_conn_recved(conn, p);         /* Notify stack about received data */
             break;
         }
 
@@ -1097,19 +2751,27 @@ http_evt(lwesp_evt_t* evt) {
                     }
                 }
 #endif /* HTTP_SUPPORT_POST */
-                if (hs->p != NULL) {
-                    lwesp_pbuf_free(hs->p);     /* Free packet buffer */
-                    hs->p = NULL;
+#if HTTP_USE_WEBSOCKET
+                if (hs->ws && hi != NULL && hi->ws_close_fn != NULL) {
+                    hi->ws_close_fn(hs);
                 }
-                if (hs->rlwesp_file_opened) {   /* Is file opened? */
-                    uint8_t is_static = hs->rlwesp_file.is_static;
-                    http_fs_data_close_file(hi, &hs->rlwesp_file);  /* Close file at this point */
-                    if (!is_static && hs->buff != NULL) {
-                        lwesp_mem_free_s((void**)&hs->buff);
-                    }
-                    hs->rlwesp_file_opened = 0; /* File is not opened anymore */
+#endif /* HTTP_USE_WEBSOCKET */
+#if HTTP_USE_KEEP_ALIVE
+                if (hs->p_next != NULL) {
+                    lwesp_pbuf_free(hs->p_next);/* Free pipelined data */
+                    hs->p_next = NULL;
+                }
+#endif /* HTTP_USE_KEEP_ALIVE */
+#if HTTP_FS_ASYNC
+                if (hs->fs_pending) {           /* Read buffer is still in use by file system */
+                    hs->fs_closed = 1;          /* State is freed once read finishes */
+                    lwesp_conn_set_arg(conn, NULL);
+                    break;
                 }
+#endif /* HTTP_FS_ASYNC */
+                http_close_file(hs);            /* Close response file */
                 lwesp_mem_free_s((void**)&hs);
+                --http_states_cnt;
             }
             break;
         }
@@ -1117,6 +2779,12 @@ http_evt(lwesp_evt_t* evt) {
         /* Poll the connection */
         case LWESP_EVT_CONN_POLL: {
             if (hs != NULL) {
+#if HTTP_USE_KEEP_ALIVE
+                if (hs->ka_idle && (lwesp_sys_now() - hs->ka_idle_start) >= HTTP_KEEP_ALIVE_TIMEOUT) {
+                    close = 1;                  /* Idle persistent connection timeout */
+                    break;
+                }
+#endif /* HTTP_USE_KEEP_ALIVE */
                 send_response(hs, 0);           /* Send more data if possible */
             } else {
                 close = 1;
@@ -1145,6 +2813,9 @@ lwesp_http_server_init(const http_init_t* init, lwesp_port_t port) {
     lwespr_t res;
     if ((res = lwesp_set_server(1, port, LWESP_CFG_MAX_CONNS, 80, http_evt, NULL, NULL, 1)) == lwespOK) {
         hi = init;
+#if HTTP_CGI_HASH_SIZE > 0
+        http_cgi_index_build();                 /* CGI table is constant, index it once */
+#endif /* HTTP_CGI_HASH_SIZE > 0 */
     }
     return res;
 }
@@ -1159,7 +2830,248 @@ lwesp_http_server_init(const http_init_t* init, lwesp_port_t port) {
  */
 size_t
 lwesp_http_server_write(http_state_t* hs, const void* data, size_t len) {
-    lwesp_conn_write(hs->conn, data, len, 0, &hs->conn_mem_available);
-    hs->written_total += len;                   /* Increase total length */
+    http_write(hs, data, len);
     return len;
 }
+
+#if HTTP_RESP_CACHE_SIZE > 0 || __DOXYGEN__
+
+/**
+ * \brief           Remove all rendered CGI responses from cache
+ *
+ * Responses being sent at the moment keep their data until completed
+ */
+void
+lwesp_http_server_resp_cache_reset(void) {
+    lwesp_core_lock();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(http_resp_cache); ++i) {
+        if (http_resp_cache[i].p != NULL) {
+            lwesp_pbuf_free(http_resp_cache[i].p);
+            http_resp_cache[i].p = NULL;
+        }
+    }
+    lwesp_core_unlock();
+}
+
+#endif /* HTTP_RESP_CACHE_SIZE > 0 || __DOXYGEN__ */
+
+#if HTTP_SUPPORT_POST || __DOXYGEN__
+
+/**
+ * \brief           Acknowledge POST data deferred by \ref http_post_data_fn callback
+ *
+ * Stack is notified that data have been processed and reading of more data is resumed.
+ *
+ * \note            Function may be called from any thread
+ * \param[in]       hs: HTTP state
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+lwespr_t
+lwesp_http_server_post_data_recved(http_state_t* hs) {
+    LWESP_ASSERT("hs != NULL", hs != NULL);
+
+    lwesp_core_lock();
+    if (hs->post_unacked != NULL) {
+        lwesp_conn_recved(hs->conn, hs->post_unacked);  /* Notify stack about processed data */
+        lwesp_pbuf_free(hs->post_unacked);
+        hs->post_unacked = NULL;
+    }
+    lwesp_conn_set_receive_blocked(hs->conn, 0);/* Resume reading data */
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* HTTP_SUPPORT_POST || __DOXYGEN__ */
+
+#if HTTP_USE_WEBSOCKET || __DOXYGEN__
+
+/**
+ * \brief           Send single WebSocket frame to client
+ *
+ * Send \ref HTTP_WS_OPCODE_CLOSE frame to start closing handshake,
+ * connection is closed when client replies with close frame.
+ *
+ * \note            Function may be called from any thread until \ref http_ws_close_fn callback is called
+ * \param[in]       hs: HTTP state of connection switched to WebSocket protocol
+ * \param[in]       opcode: Frame opcode
+ * \param[in]       data: Frame payload. Control frames are limited to `125` bytes
+ * \param[in]       len: Length of payload in units of bytes
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+lwespr_t
+lwesp_http_server_ws_send(http_state_t* hs, http_ws_opcode_t opcode, const void* data, size_t len) {
+    lwespr_t res;
+
+    LWESP_ASSERT("hs != NULL", hs != NULL);
+    LWESP_ASSERT("data != NULL || len == 0", data != NULL || len == 0);
+    LWESP_ASSERT("control frame len <= 125", !(opcode & 0x08) || len <= 125);
+
+    lwesp_core_lock();
+    if (!hs->ws || hs->ws_closing || hs->ws_close_sent) {
+        res = lwespCLOSED;
+    } else {
+        res = http_ws_write_frame(hs, (uint8_t)opcode, data, len);
+        if (opcode == HTTP_WS_OPCODE_CLOSE) {
+            hs->ws_close_sent = 1;
+        }
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+#endif /* HTTP_USE_WEBSOCKET || __DOXYGEN__ */
+
+#if HTTP_FS_ASYNC || __DOXYGEN__
+
+/**
+ * \brief           Notify server that asynchronous file read has finished
+ * \note            Function may be called from any thread, response continues in stack thread
+ * \param[in]       file: File handle passed to \ref http_fs_read_start_fn callback
+ * \param[in]       br: Number of bytes read. Set to `0` on read error or end of file
+ */
+void
+lwesp_http_server_fs_read_done(http_fs_file_t* file, size_t br) {
+    http_state_t* hs;
+    uint8_t idx;
+
+    if (file == NULL) {
+        return;
+    }
+    hs = (http_state_t*)((uint8_t*)file - offsetof(http_state_t, rlwesp_file));
+
+    lwesp_core_lock();
+    if (hs->fs_pending) {
+        idx = hs->fs_pending - 1;
+        hs->fs_buff_len[idx] = (uint32_t)br;
+        file->fptr += (uint32_t)br;
+        if (br == 0 || file->fptr >= file->size) {
+            hs->fs_eof = 1;
+        }
+        hs->fs_pending = 0;
+        if (lwesp_timeout_add(0, http_fs_async_done_cb, hs) != lwespOK) {   /* Continue in stack thread */
+            /*
+             * Timeout pool is full. Response of open connection continues
+             * on its next poll event, as read data are already marked ready.
+             * Closed connection has no more events, release its state now
+             */
+            if (hs->fs_closed) {
+                http_fs_async_done_cb(hs);
+            }
+        }
+    }
+    lwesp_core_unlock();
+}
+
+#endif /* HTTP_FS_ASYNC || __DOXYGEN__ */
+
+/**
+ * \brief           Get value of request header
+ * \note            Headers are available only when \ref HTTP_MAX_REQ_HEADERS is greater than `0`
+ *                  and all headers fit to \ref HTTP_REQ_HEADERS_BUFF_LEN memory
+ * \param[in]       hs: HTTP state
+ * \param[in]       name: Header name, case insensitive
+ * \return          Header value or `NULL` if header is not available
+ */
+const char*
+lwesp_http_server_get_header(http_state_t* hs, const char* name) {
+#if HTTP_MAX_REQ_HEADERS > 0
+    for (size_t i = 0; hs != NULL && name != NULL && i < hs->req_headers_cnt; ++i) {
+        if (!strcmpa(hs->req_headers[i].name, name)) {
+            return hs->req_headers[i].value;
+        }
+    }
+#else /* HTTP_MAX_REQ_HEADERS > 0 */
+    LWESP_UNUSED(hs);
+    LWESP_UNUSED(name);
+#endif /* !(HTTP_MAX_REQ_HEADERS > 0) */
+    return NULL;
+}
+
+/**
+ * \brief           Get value of request URI parameter
+ *
+ * Parameters are not copied nor modified, value points to request URI memory
+ * and is terminated with `&` or end of string, use `len` to get its length.
+ * Parameter without `=` sign has empty value.
+ *
+ * \note            Available while request is processed, such as from \ref http_cgi_req_fn,
+ *                  SSI or POST callback functions
+ * \param[in]       hs: HTTP state
+ * \param[in]       name: Parameter name, case sensitive
+ * \param[out]      len: Output variable to write value length to. Can be set to `NULL`
+ * \return          Pointer to parameter value or `NULL` if parameter is not available
+ */
+const char*
+lwesp_http_server_get_param(http_state_t* hs, const char* name, size_t* len) {
+    const char* p, *end;
+    size_t name_len;
+
+    if (hs == NULL || name == NULL || hs->req_params == NULL) {
+        return NULL;
+    }
+    name_len = strlen(name);
+    for (p = hs->req_params; *p != '\0'; p = *end == '&' ? end + 1 : end) {
+        for (end = p; *end != '\0' && *end != '&'; ++end) {}
+        if ((size_t)(end - p) >= name_len && !strncmp(p, name, name_len)
+            && (p[name_len] == '=' || &p[name_len] == end)) {
+            p = &p[name_len] == end ? end : &p[name_len + 1];
+            if (len != NULL) {
+                *len = (size_t)(end - p);
+            }
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Compile SSI template to list of literal spans and tags
+ *
+ * Function may be used offline to prepare segments for \ref http_fs_file_table_t
+ * or on first load of file. Tags are parsed with the same rules as runtime SSI parser.
+ * Call function with `segments` set to `NULL` first to get required number of entries.
+ *
+ * \param[in]       data: File data including optional headers part
+ * \param[in]       len: Length of data in units of bytes
+ * \param[out]      segments: Array to fill with segments. Set to `NULL` to only count them
+ * \param[in]       segments_len: Number of entries in `segments` array
+ * \return          Number of segments required for entire file
+ */
+size_t
+lwesp_http_server_ssi_compile(const void* data, size_t len, http_ssi_segment_t* segments, size_t segments_len) {
+    const uint8_t* d = data;
+    size_t i = 0, lit = 0, cnt = 0, tag, j;
+
+    if (d == NULL) {
+        return 0;
+    }
+    while (i + HTTP_SSI_TAG_START_LEN + HTTP_SSI_TAG_END_LEN <= len) {
+        if (!memcmp(&d[i], HTTP_SSI_TAG_START, HTTP_SSI_TAG_START_LEN)) {
+            tag = i + HTTP_SSI_TAG_START_LEN;
+            for (j = tag; j < len && (j - tag) <= HTTP_SSI_TAG_MAX_LEN && d[j] != HTTP_SSI_TAG_END[0]; ++j) {}
+            if (j > tag && (j - tag) <= HTTP_SSI_TAG_MAX_LEN && (j + HTTP_SSI_TAG_END_LEN) <= len
+                && !memcmp(&d[j], HTTP_SSI_TAG_END, HTTP_SSI_TAG_END_LEN)) {
+                if (segments != NULL && cnt < segments_len) {
+                    segments[cnt].offset = (uint32_t)lit;
+                    segments[cnt].len = (uint32_t)(i - lit);
+                    segments[cnt].tag_offset = (uint32_t)tag;
+                    segments[cnt].tag_len = (uint32_t)(j - tag);
+                }
+                ++cnt;
+                i = j + HTTP_SSI_TAG_END_LEN;
+                lit = i;
+                continue;
+            }
+        }
+        ++i;
+    }
+
+    /* Last literal span without tag */
+    if (segments != NULL && cnt < segments_len) {
+        segments[cnt].offset = (uint32_t)lit;
+        segments[cnt].len = (uint32_t)(len - lit);
+        segments[cnt].tag_offset = 0;
+        segments[cnt].tag_len = 0;
+    }
+    return ++cnt;
+}
@@ -117,14 +117,109 @@ responseData_404[] = ""
 const http_fs_file_table_t
 http_fs_static_files[] = {
 #if HTTP_USE_DEFAULT_STATIC_FILES
-    {"/index.html",         responseData,       sizeof(responseData) - 1},
-    {"/index.shtml",        responseData,       sizeof(responseData) - 1},
-    {"/css/style.css",      responseData_css,   sizeof(responseData_css) - 1},
-    {"/js/js.js",           responseData_js1,   sizeof(responseData_js1) - 1},
+    {"/index.html",         responseData,       sizeof(responseData) - 1,       NULL, 0},
+    {"/index.shtml",        responseData,       sizeof(responseData) - 1,       NULL, 0},
+    {"/css/style.css",      responseData_css,   sizeof(responseData_css) - 1,   NULL, 0},
+    {"/js/js.js",           responseData_js1,   sizeof(responseData_js1) - 1,   NULL, 0},
 #endif /* HTTP_USE_DEFAULT_STATIC_FILES */
-    {"/404.html",           responseData_404,   sizeof(responseData_404) - 1},
+    {"/404.html",           responseData_404,   sizeof(responseData_404) - 1,   NULL, 0},
 };
 
+#if HTTP_SSI_PRECOMPILED
+/**
+ * \brief           SSI segments of static files, compiled on first load
+ */
+static http_ssi_segment_t* http_fs_ssi_segments[LWESP_ARRAYSIZE(http_fs_static_files)];
+static size_t http_fs_ssi_segments_count[LWESP_ARRAYSIZE(http_fs_static_files)];
+#endif /* HTTP_SSI_PRECOMPILED */
+
+#if HTTP_USE_ETAG
+/**
+ * \brief           ETags of static files, calculated on first request
+ */
+static uint32_t http_fs_etags[LWESP_ARRAYSIZE(http_fs_static_files)];
+static uint8_t http_fs_etags_valid[LWESP_ARRAYSIZE(http_fs_static_files)];
+#endif /* HTTP_USE_ETAG */
+
+#if HTTP_FS_STATIC_FILES_HASH
+/**
+ * \brief           Size of static files hash index, at least twice the number of files
+ */
+#define HTTP_FS_INDEX_SIZE                  (2 * LWESP_ARRAYSIZE(http_fs_static_files) + 1)
+
+/**
+ * \brief           Open addressing hash index over static files table.
+ *                  Entry is table index plus `1`, `0` means empty slot
+ */
+static uint8_t http_fs_static_index[HTTP_FS_INDEX_SIZE];
+static uint8_t http_fs_static_index_ready;
+#endif /* HTTP_FS_STATIC_FILES_HASH */
+
+#if HTTP_FS_NEG_CACHE_SIZE > 0
+/**
+ * \brief           Hashes of paths user file system failed to open
+ */
+static uint32_t http_fs_neg_cache[HTTP_FS_NEG_CACHE_SIZE];
+static size_t http_fs_neg_cache_cnt, http_fs_neg_cache_next;
+#endif /* HTTP_FS_NEG_CACHE_SIZE > 0 */
+
+#if HTTP_FS_STATIC_FILES_HASH || HTTP_FS_NEG_CACHE_SIZE > 0
+/**
+ * \brief           Calculate FNV-1a hash of file path
+ * \param[in]       path: File path
+ * \return          Path hash
+ */
+static uint32_t
+http_fs_hash(const char* path) {
+    uint32_t h = 0x811C9DC5UL;
+
+    for (; *path != '\0'; ++path) {
+        h = (h ^ (uint8_t)*path) * 0x01000193UL;
+    }
+    return h;
+}
+#endif /* HTTP_FS_STATIC_FILES_HASH || HTTP_FS_NEG_CACHE_SIZE > 0 */
+
+/**
+ * \brief           Find file in static files table
+ * \param[in]       path: File path to find
+ * \return          Index in static files table or `-1` if not found
+ */
+static int32_t
+http_fs_static_find(const char* path) {
+#if HTTP_FS_STATIC_FILES_HASH
+    size_t i, slot;
+
+    /* Build index on first lookup, table is constant */
+    if (!http_fs_static_index_ready) {
+        for (i = 0; i < LWESP_ARRAYSIZE(http_fs_static_files); ++i) {
+            slot = http_fs_hash(http_fs_static_files[i].path) % HTTP_FS_INDEX_SIZE;
+            while (http_fs_static_index[slot] != 0) {
+                slot = (slot + 1) % HTTP_FS_INDEX_SIZE;
+            }
+            http_fs_static_index[slot] = (uint8_t)(i + 1);
+        }
+        http_fs_static_index_ready = 1;
+    }
+
+    /* Probe until empty slot, there is always at least one */
+    for (slot = http_fs_hash(path) % HTTP_FS_INDEX_SIZE; http_fs_static_index[slot] != 0;
+         slot = (slot + 1) % HTTP_FS_INDEX_SIZE) {
+        i = http_fs_static_index[slot] - 1;
+        if (!strcmp(http_fs_static_files[i].path, path)) {
+            return (int32_t)i;
+        }
+    }
+#else /* HTTP_FS_STATIC_FILES_HASH */
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(http_fs_static_files); ++i) {
+        if (!strcmp(http_fs_static_files[i].path, path)) {
+            return (int32_t)i;
+        }
+    }
+#endif /* !HTTP_FS_STATIC_FILES_HASH */
+    return -1;
+}
+
 /**
  * \brief           Open file from file system
  * \param[in]       hi: HTTP init structure
@@ -134,36 +229,167 @@ http_fs_static_files[] = {
  */
 uint8_t
 http_fs_data_open_file(const http_init_t* hi, http_fs_file_t* file, const char* path) {
-    uint8_t i, res;
+    int32_t i;
+    uint8_t res;
 
     file->fptr = 0;
     if (hi != NULL && hi->fs_open != NULL) {    /* Is user defined file system ready? */
-        file->rem_open_files = &http_fs_opened_files_cnt;   /* Set pointer to opened files */
-        res = hi->fs_open(file, path);          /* Try to read file from user file system */
-        if (res) {
-            ++http_fs_opened_files_cnt;         /* Increase number of opened files */
+#if HTTP_FS_NEG_CACHE_SIZE > 0
+        uint32_t hash = path != NULL ? http_fs_hash(path) : 0;
+        size_t n;
 
-            file->is_static = 0;                /* File is not static */
-            return 1;                           /* File is opened! */
+        for (n = 0; n < http_fs_neg_cache_cnt; ++n) {
+            if (http_fs_neg_cache[n] == hash) {
+                break;
+            }
+        }
+        if (n == http_fs_neg_cache_cnt)         /* Call user only if path is not known miss */
+#endif /* HTTP_FS_NEG_CACHE_SIZE > 0 */
+        {
+            file->rem_open_files = &http_fs_opened_files_cnt;   /* Set pointer to opened files */
+            res = hi->fs_open(file, path);      /* Try to read file from user file system */
+            if (res) {
+                ++http_fs_opened_files_cnt;     /* Increase number of opened files */
+
+                file->is_static = 0;            /* File is not static */
+                return 1;                       /* File is opened! */
+            }
+#if HTTP_FS_NEG_CACHE_SIZE > 0
+            http_fs_neg_cache[http_fs_neg_cache_next] = hash;   /* Remember miss, replace oldest entry */
+            http_fs_neg_cache_next = (http_fs_neg_cache_next + 1) % HTTP_FS_NEG_CACHE_SIZE;
+            if (http_fs_neg_cache_cnt < HTTP_FS_NEG_CACHE_SIZE) {
+                ++http_fs_neg_cache_cnt;
+            }
+#endif /* HTTP_FS_NEG_CACHE_SIZE > 0 */
         }
     }
 
     /*
      * Try to open static file if available
      */
-    for (i = 0; i < LWESP_ARRAYSIZE(http_fs_static_files); ++i) {
-        if (path != NULL && !strcmp(http_fs_static_files[i].path, path)) {
-            LWESP_MEMSET(file, 0x00, sizeof(*file));
+    if (path != NULL && (i = http_fs_static_find(path)) >= 0) {
+        LWESP_MEMSET(file, 0x00, sizeof(*file));
 
-            file->size = http_fs_static_files[i].size;
-            file->data = (uint8_t*)http_fs_static_files[i].data;
-            file->is_static = 1;                /* Set to 0 for testing purposes */
-            return 1;
+        file->size = http_fs_static_files[i].size;
+        file->data = (uint8_t*)http_fs_static_files[i].data;
+        file->is_static = 1;                    /* Set to 0 for testing purposes */
+#if HTTP_SSI_PRECOMPILED
+        file->ssi_base = file->data;
+        if (http_fs_static_files[i].ssi_segments != NULL) {
+            file->ssi_segments = http_fs_static_files[i].ssi_segments;
+            file->ssi_segments_count = http_fs_static_files[i].ssi_segments_count;
+        } else {
+            file->ssi_segments = http_fs_ssi_segments[i];
+            file->ssi_segments_count = http_fs_ssi_segments_count[i];
         }
+#endif /* HTTP_SSI_PRECOMPILED */
+        return 1;
     }
     return 0;
 }
 
+/**
+ * \brief           Clear negative cache of user file system misses
+ *
+ * Call this function after new files have been added to user file system
+ */
+void
+lwesp_http_server_fs_cache_reset(void) {
+#if HTTP_FS_NEG_CACHE_SIZE > 0
+    http_fs_neg_cache_cnt = 0;
+    http_fs_neg_cache_next = 0;
+#endif /* HTTP_FS_NEG_CACHE_SIZE > 0 */
+}
+
+#if HTTP_SSI_PRECOMPILED || __DOXYGEN__
+
+/**
+ * \brief           Compile SSI segments of opened static file and keep them for next requests
+ * \param[in]       file: Opened static file without SSI segments
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+http_fs_data_ssi_compile(http_fs_file_t* file) {
+    http_ssi_segment_t* segs;
+    size_t cnt;
+    uint8_t i;
+
+    if (!file->is_static || file->ssi_segments != NULL) {
+        return file->ssi_segments != NULL;
+    }
+    for (i = 0; i < LWESP_ARRAYSIZE(http_fs_static_files); ++i) {
+        if (http_fs_static_files[i].data == file->ssi_base) {
+            break;
+        }
+    }
+    if (i == LWESP_ARRAYSIZE(http_fs_static_files)) {
+        return 0;
+    }
+    if (http_fs_ssi_segments[i] != NULL) {      /* Other path with the same data was compiled already */
+        file->ssi_segments = http_fs_ssi_segments[i];
+        file->ssi_segments_count = http_fs_ssi_segments_count[i];
+        return 1;
+    }
+
+    /* First pass gets number of segments, second fills them */
+    cnt = lwesp_http_server_ssi_compile(file->ssi_base, http_fs_static_files[i].size, NULL, 0);
+    segs = lwesp_mem_malloc(sizeof(*segs) * cnt);
+    if (segs == NULL) {
+        return 0;
+    }
+    lwesp_http_server_ssi_compile(file->ssi_base, http_fs_static_files[i].size, segs, cnt);
+    http_fs_ssi_segments[i] = segs;
+    http_fs_ssi_segments_count[i] = cnt;
+
+    file->ssi_segments = segs;
+    file->ssi_segments_count = cnt;
+    return 1;
+}
+
+#endif /* HTTP_SSI_PRECOMPILED || __DOXYGEN__ */
+
+#if HTTP_USE_ETAG || __DOXYGEN__
+
+/**
+ * \brief           Get ETag of opened static file
+ *
+ * ETag is FNV-1a hash of file content, calculated once and kept for next requests
+ *
+ * \param[in]       file: Opened file
+ * \param[out]      etag: Pointer to save ETag value to
+ * \return          `1` on success, `0` if file has no ETag (it is not static)
+ */
+uint8_t
+http_fs_data_get_etag(const http_fs_file_t* file, uint32_t* etag) {
+    uint8_t i;
+
+    if (!file->is_static) {
+        return 0;
+    }
+    for (i = 0; i < LWESP_ARRAYSIZE(http_fs_static_files); ++i) {
+        if (http_fs_static_files[i].data == file->data) {
+            break;
+        }
+    }
+    if (i == LWESP_ARRAYSIZE(http_fs_static_files)) {
+        return 0;
+    }
+    if (!http_fs_etags_valid[i]) {
+        const uint8_t* d = http_fs_static_files[i].data;
+        uint32_t h = 0x811C9DC5UL;
+
+        for (uint32_t n = 0; n < http_fs_static_files[i].size; ++n) {
+            h = (h ^ d[n]) * 0x01000193UL;
+        }
+        http_fs_etags[i] = h;
+        http_fs_etags_valid[i] = 1;
+    }
+    *etag = http_fs_etags[i];
+    return 1;
+}
+
+#endif /* HTTP_USE_ETAG || __DOXYGEN__ */
+
 /**
  * \brief           Read part of file or check if we have more data to read
  * \param[in]       hi: HTTP init structure
@@ -182,7 +408,8 @@ http_fs_data_read_file(const http_init_t* hi, http_fs_file_t* file, void** buff,
         if (file->is_static) {                  /* Check static file */
             return len;                         /* Simply return difference */
         } else if (hi != NULL && hi->fs_read != NULL) { /* Check for read function */
-            return hi->fs_read(file, NULL, 0);  /* Call a function for dynamic file check */
+            uint32_t rem = hi->fs_read(file, NULL, 0);  /* Call a function for dynamic file check */
+            return LWESP_MIN(rem, len);         /* Never read beyond file size, it may be limited by range */
         }
         return 0;                               /* No bytes to read */
     }
@@ -202,6 +429,31 @@ http_fs_data_read_file(const http_init_t* hi, http_fs_file_t* file, void** buff,
     return len;
 }
 
+#if HTTP_USE_RANGE || __DOXYGEN__
+
+/**
+ * \brief           Set read position of opened file
+ * \param[in]       hi: HTTP init structure
+ * \param[in]       file: File handle
+ * \param[in]       offset: New read position from beginning of file
+ * \return          `1` on success, `0` if file cannot be seeked
+ */
+uint8_t
+http_fs_data_seek_file(const http_init_t* hi, http_fs_file_t* file, uint32_t offset) {
+    if (offset > file->size) {
+        return 0;
+    }
+    if (!file->is_static) {
+        if (hi == NULL || hi->fs_seek == NULL || !hi->fs_seek(file, offset)) {
+            return 0;
+        }
+    }
+    file->fptr = offset;
+    return 1;
+}
+
+#endif /* HTTP_USE_RANGE || __DOXYGEN__ */
+
 /**
  * \brief           Close file handle
  * \param[in]       hi: HTTP init structure
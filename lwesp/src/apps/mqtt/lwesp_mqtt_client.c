@@ -34,6 +34,53 @@
 #include "lwesp/apps/lwesp_mqtt_client.h"
 #include "lwesp/lwesp_mem.h"
 #include "lwesp/lwesp_pbuf.h"
+#include "lwesp/lwesp_timeout.h"
+
+#if LWESP_CFG_MQTT_PUBLISH_NOCOPY || __DOXYGEN__
+/**
+ * \brief           User-owned payload queued for send after TX buffer data
+ */
+typedef struct {
+    const void* data;                           /*!< Payload data */
+    uint16_t len;                               /*!< Payload length */
+    uint32_t buff_pos;                          /*!< Position in TX buffer stream where payload follows */
+} lwesp_mqtt_ext_payload_t;
+#endif /* LWESP_CFG_MQTT_PUBLISH_NOCOPY || __DOXYGEN__ */
+
+/**
+ * \brief           Send command started from TX buffer and waiting for completion
+ */
+typedef struct {
+    size_t buff_len;                            /*!< Number of TX buffer bytes in send command */
+#if LWESP_CFG_MQTT_PUBLISH_NOCOPY || __DOXYGEN__
+    uint8_t ext;                                /*!< Set to `1` when first unsent payload from user memory follows */
+    lwesp_conn_iov_t iov[2];                    /*!< Segments for scatter-gather send */
+#endif /* LWESP_CFG_MQTT_PUBLISH_NOCOPY || __DOXYGEN__ */
+} lwesp_mqtt_tx_send_t;
+
+/**
+ * \brief           Sent bytes watermark of QoS `0` publish packets
+ *
+ * Consecutive packets with the same user argument share one entry and complete together
+ */
+typedef struct {
+    uint32_t expected_sent_len;                 /*!< Total number of sent bytes when last packet of entry is sent */
+    void* arg;                                  /*!< User argument of packets */
+    uint16_t cnt;                               /*!< Number of packets in entry */
+} lwesp_mqtt_qos0_mark_t;
+
+#if (LWESP_CFG_MQTT_V5 && LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0) || __DOXYGEN__
+/**
+ * \brief           MQTT 5 topic alias assigned by client
+ */
+typedef struct {
+    uint16_t len;                               /*!< Length of topic, `0` when alias is not assigned */
+    char topic[LWESP_CFG_MQTT_TOPIC_ALIAS_LEN]; /*!< Copy of topic, not null-terminated */
+} lwesp_mqtt_topic_alias_t;
+#endif /* (LWESP_CFG_MQTT_V5 && LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0) || __DOXYGEN__ */
+
+/* Size of pending requests lookup table, kept at most half full */
+#define MQTT_REQUEST_HASH_SIZE          (2 * LWESP_CFG_MQTT_MAX_REQUESTS)
 
 /**
  * \brief           MQTT client connection
@@ -43,33 +90,94 @@ typedef struct lwesp_mqtt_client {
     const lwesp_mqtt_client_info_t* info;       /*!< Connection info */
     lwesp_mqtt_state_t conn_state;              /*!< MQTT connection state */
 
-    uint32_t poll_time;                         /*!< Poll time, increased every 500ms */
+    uint32_t poll_time;                         /*!< Time of last keep-alive relevant activity in units of milliseconds */
+    lwesp_timeout_id_t keep_alive_to;           /*!< Keep-alive timeout handle, `0` when not active */
 
     lwesp_mqtt_evt_t evt;                       /*!< MQTT event callback */
     lwesp_mqtt_evt_fn evt_fn;                   /*!< Event callback function */
 
     lwesp_buff_t tx_buff;                       /*!< Buffer for raw output data to transmit */
 
-    uint8_t is_sending;                         /*!< Flag if we are sending data currently */
+    lwesp_mqtt_tx_send_t tx_send[LWESP_CFG_MQTT_MAX_SENDS]; /*!< FIFO of active send commands, in send order */
+    uint8_t tx_send_r;                          /*!< Read index of send commands FIFO */
+    uint8_t tx_send_cnt;                        /*!< Number of active send commands */
+    size_t tx_inflight;                         /*!< Number of TX buffer bytes in active send commands */
+    uint8_t tx_hold;                            /*!< Set to `1` to hold sending while multiple packets are written */
     uint32_t sent_total;                        /*!< Total number of bytes sent so far on connection */
     uint32_t written_total;                     /*!< Total number of bytes written into send buffer and queued for send */
+#if LWESP_CFG_MQTT_PUBLISH_NOCOPY
+    uint32_t tx_buff_sent;                      /*!< Total number of TX buffer bytes sent */
+    lwesp_mqtt_ext_payload_t ext[LWESP_CFG_MQTT_MAX_REQUESTS];  /*!< FIFO of user-owned payloads */
+    uint8_t ext_r;                              /*!< Read index of payload FIFO */
+    uint8_t ext_cnt;                            /*!< Number of entries in payload FIFO */
+    uint8_t ext_inflight;                       /*!< Number of payloads in FIFO in active send commands */
+#endif /* LWESP_CFG_MQTT_PUBLISH_NOCOPY */
 
     uint16_t last_packet_id;                    /*!< Packet ID used on last packet */
 
     lwesp_mqtt_request_t requests[LWESP_CFG_MQTT_MAX_REQUESTS]; /*!< List of requests */
+    uint8_t req_free[LWESP_CFG_MQTT_MAX_REQUESTS];  /*!< Stack of free request indexes */
+    uint8_t req_free_cnt;                       /*!< Number of entries in free stack */
+    uint8_t req_hash[MQTT_REQUEST_HASH_SIZE];   /*!< Open-addressed table of pending requests by packet ID,
+                                                    entry is request index + 1, `0` when empty */
+    lwesp_mqtt_qos0_mark_t qos0[LWESP_CFG_MQTT_QOS0_QUEUE_LEN]; /*!< FIFO of QoS `0` publish watermarks, in send order */
+    uint8_t qos0_r;                             /*!< Read index of QoS `0` FIFO */
+    uint8_t qos0_cnt;                           /*!< Number of entries in QoS `0` FIFO */
+    uint8_t inflight;                           /*!< Number of publish packets waiting for acknowledge */
+    uint8_t writable_notify;                    /*!< Set to `1` when user shall be notified about available resources */
+#if LWESP_CFG_MQTT_V5
+    uint8_t v5;                                 /*!< Set to `1` when connection uses MQTT 5 */
+    uint16_t srv_recv_max;                      /*!< Receive maximum of server, limits publish packets waiting for acknowledge */
+    uint32_t srv_max_packet;                    /*!< Maximum packet size accepted by server, `0` when not limited */
+#if LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0
+    lwesp_mqtt_topic_alias_t alias[LWESP_CFG_MQTT_TOPIC_ALIAS_MAX]; /*!< Topic aliases, alias value is index + 1 */
+    uint8_t alias_max;                          /*!< Number of aliases allowed on current connection */
+    uint8_t alias_next;                         /*!< Index of alias to assign to next new topic */
+#endif /* LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0 */
+#endif /* LWESP_CFG_MQTT_V5 */
+#if LWESP_CFG_MQTT_PUBLISH_BACKLOG
+    uint8_t req_backlog[LWESP_CFG_MQTT_MAX_REQUESTS];   /*!< FIFO of queued publish requests */
+    uint8_t backlog_r;                          /*!< Read index of backlog FIFO */
+    uint8_t backlog_cnt;                        /*!< Number of entries in backlog FIFO */
+#endif /* LWESP_CFG_MQTT_PUBLISH_BACKLOG */
 
     uint8_t* rx_buff;                           /*!< Raw RX buffer */
     size_t rx_buff_len;                         /*!< Length of raw RX buffer */
+    lwesp_pbuf_p rx_pbuf;                       /*!< Packet buffer of current message, when processed in-place */
+    size_t rx_pbuf_offset;                      /*!< Offset of current message in `rx_pbuf` */
 
     uint8_t parser_state;                       /*!< Incoming data parser state */
     uint8_t msg_hdr_byte;                       /*!< Incoming message header byte */
     uint32_t msg_rem_len;                       /*!< Remaining length value of current message */
     uint8_t msg_rem_len_mult;                   /*!< Multiplier for remaining length */
     uint32_t msg_curr_pos;                      /*!< Current buffer write pointer */
+#if LWESP_CFG_MQTT_RECV_STREAM
+    uint32_t msg_stream_hdr_len;                /*!< Length of topic and packet ID part of streamed message, `0` when not yet known */
+#if LWESP_CFG_MQTT_V5
+    uint32_t msg_stream_props_pos;              /*!< Position of properties length of streamed message, `0` when already parsed */
+#endif /* LWESP_CFG_MQTT_V5 */
+#endif /* LWESP_CFG_MQTT_RECV_STREAM */
+#if LWESP_CFG_MQTT_SESSION_STORE
+    lwesp_mqtt_session_fn session_fn;           /*!< Session store callback, `NULL` for clean session */
+#endif /* LWESP_CFG_MQTT_SESSION_STORE */
 
     void* arg;                                  /*!< User argument */
 } lwesp_mqtt_client_t;
 
+#if LWESP_CFG_STATIC_ONLY || __DOXYGEN__
+/**
+ * \brief           Static pool entry of MQTT client with its buffers
+ */
+typedef struct {
+    lwesp_mqtt_client_t client;                 /*!< Client structure, must be first member */
+    uint8_t tx_mem[LWESP_CFG_MQTT_CLIENT_TX_BUFF_LEN];  /*!< Memory for TX buffer */
+    uint8_t rx_mem[LWESP_CFG_MQTT_CLIENT_RX_BUFF_LEN];  /*!< Memory for RX buffer */
+    uint8_t used;                               /*!< Set to `1` when entry is in use */
+} lwesp_mqtt_client_pool_t;
+
+static lwesp_mqtt_client_pool_t client_pool[LWESP_CFG_MQTT_CLIENT_POOL_SIZE];
+#endif /* LWESP_CFG_STATIC_ONLY || __DOXYGEN__ */
+
 /* Tracing debug message */
 #define LWESP_CFG_DBG_MQTT_TRACE                  (LWESP_CFG_DBG_MQTT | LWESP_DBG_TYPE_TRACE)
 #define LWESP_CFG_DBG_MQTT_STATE                  (LWESP_CFG_DBG_MQTT | LWESP_DBG_TYPE_STATE)
@@ -109,6 +217,20 @@ typedef enum {
 #define MQTT_PARSER_STATE_INIT          0x00    /*!< MQTT parser in initialized state */
 #define MQTT_PARSER_STATE_CALC_REM_LEN  0x01    /*!< MQTT parser in calculating remaining length state */
 #define MQTT_PARSER_STATE_READ_REM      0x02    /*!< MQTT parser in reading remaining bytes state */
+#define MQTT_PARSER_STATE_READ_STREAM   0x03    /*!< MQTT parser in streaming publish packet state */
+
+/* MQTT 5 property identifiers used by client */
+#define MQTT_PROP_RECEIVE_MAXIMUM       0x21    /*!< Receive maximum, 2-byte integer */
+#define MQTT_PROP_TOPIC_ALIAS_MAXIMUM   0x22    /*!< Topic alias maximum, 2-byte integer */
+#define MQTT_PROP_TOPIC_ALIAS           0x23    /*!< Topic alias, 2-byte integer */
+#define MQTT_PROP_MAXIMUM_PACKET_SIZE   0x27    /*!< Maximum packet size, 4-byte integer */
+
+/* Check if connection uses MQTT 5 protocol */
+#if LWESP_CFG_MQTT_V5
+#define MQTT_IS_V5(client)              ((client)->v5)
+#else
+#define MQTT_IS_V5(client)              0
+#endif /* LWESP_CFG_MQTT_V5 */
 
 /* Get packet type from incoming byte */
 #define MQTT_RCV_GET_PACKET_TYPE(d)     ((mqtt_msg_type_t)(((d) >> 0x04) & 0x0F))
@@ -120,6 +242,8 @@ typedef enum {
 #define MQTT_REQUEST_FLAG_PENDING       0x02    /*!< Request object is pending waiting for response from server */
 #define MQTT_REQUEST_FLAG_SUBSCRIBE     0x04    /*!< Request object has subscribe type */
 #define MQTT_REQUEST_FLAG_UNSUBSCRIBE   0x08    /*!< Request object has unsubscribe type */
+#define MQTT_REQUEST_FLAG_INFLIGHT      0x10    /*!< Request object is publish counted in in-flight window */
+#define MQTT_REQUEST_FLAG_QUEUED        0x20    /*!< Request object is publish waiting in backlog */
 
 #if LWESP_CFG_DBG
 
@@ -166,6 +290,86 @@ create_packet_id(lwesp_mqtt_client_p client) {
 /******************************************************************************************************/
 /******************************************************************************************************/
 
+/**
+ * \brief           Reset request objects and lookup structures
+ * \param[in]       client: MQTT client
+ */
+static void
+requests_init(lwesp_mqtt_client_p client) {
+    LWESP_MEMSET(client->requests, 0x00, sizeof(client->requests));
+    LWESP_MEMSET(client->req_hash, 0x00, sizeof(client->req_hash));
+    for (size_t i = 0; i < LWESP_CFG_MQTT_MAX_REQUESTS; ++i) {
+        client->req_free[i] = LWESP_U8(LWESP_CFG_MQTT_MAX_REQUESTS - 1 - i);
+    }
+    client->req_free_cnt = LWESP_CFG_MQTT_MAX_REQUESTS;
+    client->qos0_r = client->qos0_cnt = 0;
+    client->inflight = client->writable_notify = 0;
+#if LWESP_CFG_MQTT_PUBLISH_BACKLOG
+    client->backlog_r = client->backlog_cnt = 0;
+#endif /* LWESP_CFG_MQTT_PUBLISH_BACKLOG */
+}
+
+/**
+ * \brief           Add request to packet ID lookup table
+ * \param[in]       client: MQTT client
+ * \param[in]       request: Request with non-zero packet ID
+ */
+static void
+request_hash_add(lwesp_mqtt_client_p client, lwesp_mqtt_request_t* request) {
+    size_t h = request->packet_id % MQTT_REQUEST_HASH_SIZE;
+
+    while (client->req_hash[h] != 0) {          /* Linear probing, table always has free slots */
+        h = (h + 1) % MQTT_REQUEST_HASH_SIZE;
+    }
+    client->req_hash[h] = LWESP_U8((request - client->requests) + 1);
+}
+
+/**
+ * \brief           Find position of request in packet ID lookup table
+ * \param[in]       client: MQTT client
+ * \param[in]       pkt_id: Packet ID to search for
+ * \return          Position in lookup table or `-1` if not found
+ */
+static int32_t
+request_hash_find(lwesp_mqtt_client_p client, uint16_t pkt_id) {
+    size_t h = pkt_id % MQTT_REQUEST_HASH_SIZE;
+
+    while (client->req_hash[h] != 0) {
+        if (client->requests[client->req_hash[h] - 1].packet_id == pkt_id) {
+            return (int32_t)h;
+        }
+        h = (h + 1) % MQTT_REQUEST_HASH_SIZE;
+    }
+    return -1;
+}
+
+/**
+ * \brief           Remove entry from packet ID lookup table
+ *
+ * Following entries of the same probe sequence are moved back,
+ * so lookup never stops at removed entry
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       pos: Position in lookup table to remove
+ */
+static void
+request_hash_remove(lwesp_mqtt_client_p client, size_t pos) {
+    size_t next = pos;
+
+    client->req_hash[pos] = 0;
+    while (client->req_hash[next = (next + 1) % MQTT_REQUEST_HASH_SIZE] != 0) {
+        size_t home = client->requests[client->req_hash[next] - 1].packet_id % MQTT_REQUEST_HASH_SIZE;
+
+        /* Move entry to free position if its home is not between free and current position */
+        if ((next > pos && (home <= pos || home > next))
+            || (next < pos && (home <= pos && home > next))) {
+            client->req_hash[pos] = client->req_hash[next];
+            client->req_hash[next] = 0;
+            pos = next;
+        }
+    }
+}
+
 /**
  * \brief           Create and return new request object
  * \param[in]       client: MQTT client
@@ -175,17 +379,11 @@ create_packet_id(lwesp_mqtt_client_p client) {
  */
 static lwesp_mqtt_request_t*
 request_create(lwesp_mqtt_client_p client, uint16_t packet_id, void* arg) {
-    lwesp_mqtt_request_t* request;
-    uint16_t i;
+    lwesp_mqtt_request_t* request = NULL;
 
-    /* Try to find a new request which does not have IN_USE flag set */
-    for (request = NULL, i = 0; i < LWESP_CFG_MQTT_MAX_REQUESTS; ++i) {
-        if (!(client->requests[i].status & MQTT_REQUEST_FLAG_IN_USE)) {
-            request = &client->requests[i];     /* We have empty request */
-            break;
-        }
-    }
-    if (request != NULL) {
+    /* Take request from the top of free stack */
+    if (client->req_free_cnt > 0) {
+        request = &client->requests[client->req_free[--client->req_free_cnt]];
         request->packet_id = packet_id;         /* Set request packet ID */
         request->arg = arg;                     /* Set user argument */
         request->status = MQTT_REQUEST_FLAG_IN_USE; /* Reset everything at this point */
@@ -200,8 +398,26 @@ request_create(lwesp_mqtt_client_p client, uint16_t packet_id, void* arg) {
  */
 static void
 request_delete(lwesp_mqtt_client_p client, lwesp_mqtt_request_t* request) {
+    uint8_t idx = LWESP_U8(request - client->requests);
+
+    if (request->status & MQTT_REQUEST_FLAG_INFLIGHT) {
+        --client->inflight;
+    }
+#if LWESP_CFG_MQTT_PUBLISH_BACKLOG
+    if (request->status & MQTT_REQUEST_FLAG_QUEUED) {
+        lwesp_buff_free(&request->backlog);     /* Packet was never sent */
+    }
+#endif /* LWESP_CFG_MQTT_PUBLISH_BACKLOG */
+    if ((request->status & MQTT_REQUEST_FLAG_PENDING) && request->packet_id != 0) {
+        int32_t pos = request_hash_find(client, request->packet_id);
+        if (pos >= 0) {
+            request_hash_remove(client, (size_t)pos);
+        }
+    }
+    if (request->status & MQTT_REQUEST_FLAG_IN_USE) {
+        client->req_free[client->req_free_cnt++] = idx; /* Return to free stack */
+    }
     request->status = 0;                        /* Reset status to make request unused */
-    LWESP_UNUSED(client);
 }
 
 /**
@@ -213,7 +429,7 @@ static void
 request_set_pending(lwesp_mqtt_client_p client, lwesp_mqtt_request_t* request) {
     request->timeout_start_time = lwesp_sys_now();  /* Set timeout start time */
     request->status |= MQTT_REQUEST_FLAG_PENDING;   /* Set pending flag */
-    LWESP_UNUSED(client);
+    request_hash_add(client, request);          /* Acknowledge is matched by packet ID */
 }
 
 /**
@@ -224,10 +440,16 @@ request_set_pending(lwesp_mqtt_client_p client, lwesp_mqtt_request_t* request) {
  */
 static lwesp_mqtt_request_t*
 request_get_pending(lwesp_mqtt_client_p client, int32_t pkt_id) {
-    /* Try to find a new request which does not have IN_USE flag set */
+    if (pkt_id == 0) {
+        return NULL;                            /* QoS `0` publish packets are tracked without requests */
+    } else if (pkt_id > 0) {
+        int32_t pos = request_hash_find(client, (uint16_t)pkt_id);
+        return pos >= 0 ? &client->requests[client->req_hash[pos] - 1] : NULL;
+    }
+
+    /* Any pending or queued request, used on connection close only */
     for (size_t i = 0; i < LWESP_CFG_MQTT_MAX_REQUESTS; ++i) {
-        if ((client->requests[i].status & MQTT_REQUEST_FLAG_PENDING)
-            && (pkt_id == -1 || client->requests[i].packet_id == (uint16_t)pkt_id)) {
+        if (client->requests[i].status & (MQTT_REQUEST_FLAG_PENDING | MQTT_REQUEST_FLAG_QUEUED)) {
             return &client->requests[i];
         }
     }
@@ -256,10 +478,80 @@ request_send_err_callback(lwesp_mqtt_client_p client, uint8_t status, void* arg)
     } else {
         client->evt.evt.sub_unsub_scribed.arg = arg;
         client->evt.evt.sub_unsub_scribed.res = lwespERR;
+        client->evt.evt.sub_unsub_scribed.return_codes = NULL;
+        client->evt.evt.sub_unsub_scribed.return_codes_len = 0;
     }
     client->evt_fn(client, &client->evt);
 }
 
+/**
+ * \brief           Check if QoS `0` publish packet can be tracked
+ * \param[in]       client: MQTT client
+ * \param[in]       arg: User argument of packet
+ * \return          `1` if packet can be added to watermark FIFO, `0` otherwise
+ */
+static uint8_t
+qos0_mark_available(lwesp_mqtt_client_p client, void* arg) {
+    const lwesp_mqtt_qos0_mark_t* last;
+
+    if (client->qos0_cnt < LWESP_CFG_MQTT_QOS0_QUEUE_LEN) {
+        return 1;
+    }
+    last = &client->qos0[(client->qos0_r + client->qos0_cnt - 1) % LWESP_CFG_MQTT_QOS0_QUEUE_LEN];
+    return last->arg == arg && last->cnt < 0xFFFF;
+}
+
+/**
+ * \brief           Add QoS `0` publish packet to watermark FIFO
+ * \note            \ref qos0_mark_available must be checked before
+ * \param[in]       client: MQTT client
+ * \param[in]       expected_sent_len: Total number of sent bytes when packet is sent
+ * \param[in]       arg: User argument of packet
+ */
+static void
+qos0_mark_add(lwesp_mqtt_client_p client, uint32_t expected_sent_len, void* arg) {
+    lwesp_mqtt_qos0_mark_t* m;
+
+    if (client->qos0_cnt > 0) {                 /* Merge with previous packet of the same argument */
+        m = &client->qos0[(client->qos0_r + client->qos0_cnt - 1) % LWESP_CFG_MQTT_QOS0_QUEUE_LEN];
+        if (m->arg == arg && m->cnt < 0xFFFF) {
+            m->expected_sent_len = expected_sent_len;
+            ++m->cnt;
+            return;
+        }
+    }
+    m = &client->qos0[(client->qos0_r + client->qos0_cnt) % LWESP_CFG_MQTT_QOS0_QUEUE_LEN];
+    m->expected_sent_len = expected_sent_len;
+    m->arg = arg;
+    m->cnt = 1;
+    ++client->qos0_cnt;
+}
+
+/**
+ * \brief           Notify user about QoS `0` publish packets, sent or dropped
+ * \param[in]       client: MQTT client
+ * \param[in]       all: Set to `1` to complete all packets with error on connection close,
+ *                      `0` to complete sent packets only
+ */
+static void
+qos0_mark_complete(lwesp_mqtt_client_p client, uint8_t all) {
+    while (client->qos0_cnt > 0) {
+        lwesp_mqtt_qos0_mark_t m = client->qos0[client->qos0_r];
+
+        if (!all && client->sent_total < m.expected_sent_len) {
+            break;
+        }
+        client->qos0_r = LWESP_U8((client->qos0_r + 1) % LWESP_CFG_MQTT_QOS0_QUEUE_LEN);
+        --client->qos0_cnt;
+        for (; m.cnt > 0; --m.cnt) {            /* Entry is removed first, callback may publish again */
+            client->evt.type = LWESP_MQTT_EVT_PUBLISH;
+            client->evt.evt.publish.arg = m.arg;
+            client->evt.evt.publish.res = all ? lwespERR : lwespOK;
+            client->evt_fn(client, &client->evt);
+        }
+    }
+}
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /* MQTT buffer helper functions                                                                       */
@@ -345,17 +637,15 @@ write_data(lwesp_mqtt_client_p client, const void* data, size_t len) {
 }
 
 /**
- * \brief           Check if output buffer has enough memory to handle
- *                  all bytes required to encode packet to RAW format
- *
- *                  It calculates additional bytes required to encode
- *                  remaining length itself + 1 byte for packet header
+ * \brief           Check if output buffer has enough memory for packet,
+ *                  where last part of packet is not written to output buffer
  * \param[in]       client: MQTT client
  * \param[in]       rem_len: Remaining length of packet
- * \return          Number of required RAW bytes or `0` if no memory available
+ * \param[in]       ext_len: Number of bytes at the end of packet, sent from user memory
+ * \return          Number of required RAW bytes for entire packet or `0` if no memory available
  */
 static uint16_t
-output_check_enough_memory(lwesp_mqtt_client_p client, uint16_t rem_len) {
+output_check_enough_memory_ext(lwesp_mqtt_client_p client, uint16_t rem_len, uint16_t ext_len) {
     uint16_t total_len = rem_len + 1;           /* Remaining length + first (packet start) byte */
 
     do {                                        /* Calculate bytes for encoding remaining length itself */
@@ -363,7 +653,22 @@ output_check_enough_memory(lwesp_mqtt_client_p client, uint16_t rem_len) {
         rem_len >>= 7;                          /* Encoded with 7 bits per byte */
     } while (rem_len > 0);
 
-    return LWESP_U16(lwesp_buff_get_free(&client->tx_buff)) >= total_len ? total_len : 0;
+    return LWESP_U16(lwesp_buff_get_free(&client->tx_buff)) >= (total_len - ext_len) ? total_len : 0;
+}
+
+/**
+ * \brief           Check if output buffer has enough memory to handle
+ *                  all bytes required to encode packet to RAW format
+ *
+ *                  It calculates additional bytes required to encode
+ *                  remaining length itself + 1 byte for packet header
+ * \param[in]       client: MQTT client
+ * \param[in]       rem_len: Remaining length of packet
+ * \return          Number of required RAW bytes or `0` if no memory available
+ */
+static uint16_t
+output_check_enough_memory(lwesp_mqtt_client_p client, uint16_t rem_len) {
+    return output_check_enough_memory_ext(client, rem_len, 0);
 }
 
 /**
@@ -402,38 +707,310 @@ write_string(lwesp_mqtt_client_p client, const char* str, uint16_t len) {
     lwesp_buff_write(&client->tx_buff, str, len);   /* Write string to buffer */
 }
 
+#if LWESP_CFG_MQTT_PUBLISH_BACKLOG || LWESP_CFG_MQTT_V5 || __DOXYGEN__
+
+/**
+ * \brief           Get number of bytes of entire packet, including fixed header
+ * \note            Used only by publish backlog accounting and MQTT v5 maximum packet size check
+ * \param[in]       rem_len: Remaining length of packet
+ * \return          Length of packet on the line
+ */
+static uint32_t
+mqtt_packet_len(uint32_t rem_len) {
+    uint32_t len = rem_len + 2;                 /* Packet start byte + at least one length byte */
+
+    for (uint32_t l = rem_len; l > 0x7F; l >>= 7) {
+        ++len;
+    }
+    return len;
+}
+
+#endif /* LWESP_CFG_MQTT_PUBLISH_BACKLOG || LWESP_CFG_MQTT_V5 || __DOXYGEN__ */
+
+#if LWESP_CFG_MQTT_V5 || __DOXYGEN__
+
+/**
+ * \brief           Read variable byte integer from received data
+ * \param[in]       d: Received data
+ * \param[in]       len: Number of available bytes
+ * \param[out]      val: Output variable to write decoded value to
+ * \return          Number of bytes used by integer, `0` if integer is not complete or invalid
+ */
+static size_t
+mqtt_read_varint(const uint8_t* d, size_t len, uint32_t* val) {
+    *val = 0;
+    for (size_t i = 0; i < len && i < 4; ++i) {
+        *val |= LWESP_U32(d[i] & 0x7F) << (7 * i);
+        if (!(d[i] & 0x80)) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Skip properties of received packet
+ * \param[in]       client: MQTT client
+ * \param[in]       pos: Position of properties length in RX buffer
+ * \return          Position of first byte after properties, `0` if properties are not valid
+ */
+static size_t
+mqtt_skip_props(lwesp_mqtt_client_p client, size_t pos) {
+    uint32_t props_len;
+    size_t n;
+
+    if (pos >= client->msg_rem_len
+        || (n = mqtt_read_varint(&client->rx_buff[pos], client->msg_rem_len - pos, &props_len)) == 0
+        || props_len > client->msg_rem_len - pos - n) {
+        return 0;
+    }
+    return pos + n + props_len;
+}
+
+/**
+ * \brief           Get length of property value in received data
+ * \param[in]       id: Property identifier
+ * \param[in]       d: Property value data
+ * \param[in]       len: Number of available bytes
+ * \return          Length of value, `0` for unknown property or invalid data
+ */
+static size_t
+mqtt_prop_value_len(uint8_t id, const uint8_t* d, size_t len) {
+    uint32_t val;
+    size_t l;
+
+    switch (id) {
+        case 0x01: case 0x17: case 0x19: case 0x24: /* Byte */
+        case 0x25: case 0x28: case 0x29: case 0x2A:
+            l = 1;
+            break;
+        case 0x13: case 0x21: case 0x22: case 0x23: /* Two byte integer */
+            l = 2;
+            break;
+        case 0x02: case 0x11: case 0x18: case 0x27: /* Four byte integer */
+            l = 4;
+            break;
+        case 0x0B:                              /* Variable byte integer */
+            return mqtt_read_varint(d, len, &val);
+        case 0x03: case 0x08: case 0x09: case 0x12: /* UTF-8 string or binary data */
+        case 0x15: case 0x16: case 0x1A: case 0x1C: case 0x1F:
+            if (len < 2) {
+                return 0;
+            }
+            l = 2 + ((d[0] << 8) | d[1]);
+            break;
+        case 0x26:                              /* User property, string pair */
+            if (len < 2 || (l = 2 + ((d[0] << 8) | d[1])) + 2 > len) {
+                return 0;
+            }
+            l += 2 + ((d[l] << 8) | d[l + 1]);
+            break;
+        default:
+            return 0;
+    }
+    return l <= len ? l : 0;
+}
+
+/**
+ * \brief           Process CONNACK packet of MQTT 5 connection
+ *
+ * Server limits from properties are applied to client
+ *
+ * \param[in]       client: MQTT client
+ * \return          Connection status for user
+ */
+static lwesp_mqtt_conn_status_t
+mqtt_v5_process_connack(lwesp_mqtt_client_p client) {
+    size_t pos, end, len;
+    uint8_t* d = client->rx_buff;
+    uint32_t props_len;
+
+    if (client->msg_rem_len > 2
+        && (pos = mqtt_read_varint(&d[2], client->msg_rem_len - 2, &props_len)) > 0
+        && props_len <= client->msg_rem_len - 2 - pos) {
+        pos += 2;
+        end = pos + props_len;
+        while (pos < end) {
+            uint8_t id = d[pos++];
+
+            if ((len = mqtt_prop_value_len(id, &d[pos], end - pos)) == 0) {
+                break;
+            }
+            if (id == MQTT_PROP_RECEIVE_MAXIMUM) {
+                client->srv_recv_max = LWESP_U16((d[pos] << 8) | d[pos + 1]);
+#if LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0
+            } else if (id == MQTT_PROP_TOPIC_ALIAS_MAXIMUM) {
+                client->alias_max = LWESP_U8(LWESP_MIN((d[pos] << 8) | d[pos + 1], LWESP_CFG_MQTT_TOPIC_ALIAS_MAX));
+#endif /* LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0 */
+            } else if (id == MQTT_PROP_MAXIMUM_PACKET_SIZE) {
+                client->srv_max_packet = LWESP_U32(d[pos]) << 24 | LWESP_U32(d[pos + 1]) << 16
+                                         | LWESP_U32(d[pos + 2]) << 8 | LWESP_U32(d[pos + 3]);
+            }
+            pos += len;
+        }
+        LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE,
+                   "[MQTT] Server receive max: %d; max packet: %d\r\n",
+                   (int)client->srv_recv_max, (int)client->srv_max_packet);
+    }
+
+    /* Map MQTT 5 reason code to connect status, lower values come from MQTT 3.1.1 server */
+    switch (d[1]) {
+        case 0x84: return LWESP_MQTT_CONN_STATUS_REFUSED_PROTOCOL_VERSION;
+        case 0x85: return LWESP_MQTT_CONN_STATUS_REFUSED_ID;
+        case 0x86: return LWESP_MQTT_CONN_STATUS_REFUSED_USER_PASS;
+        case 0x87: return LWESP_MQTT_CONN_STATUS_REFUSED_NOT_AUTHORIZED;
+        default:
+            return d[1] < 0x80 ? (lwesp_mqtt_conn_status_t)d[1] : LWESP_MQTT_CONN_STATUS_REFUSED_SERVER;
+    }
+}
+
+#if LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0 || __DOXYGEN__
+
+/**
+ * \brief           Get topic alias for publish topic
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       len_topic: Length of topic
+ * \param[out]      is_new: Set to `1` when alias is not yet assigned to topic and topic must be sent with it
+ * \return          Alias value or `0` if packet is sent without alias
+ */
+static uint16_t
+topic_alias_get(lwesp_mqtt_client_p client, const char* topic, uint16_t len_topic, uint8_t* is_new) {
+    *is_new = 0;
+    if (client->alias_max == 0 || len_topic > LWESP_CFG_MQTT_TOPIC_ALIAS_LEN) {
+        return 0;
+    }
+    for (size_t i = 0; i < client->alias_max; ++i) {
+        if (client->alias[i].len == len_topic && !memcmp(client->alias[i].topic, topic, len_topic)) {
+            return LWESP_U16(i + 1);
+        }
+    }
+    *is_new = 1;
+    return LWESP_U16(client->alias_next + 1);
+}
+
+/**
+ * \brief           Assign topic to alias, previous topic of alias is replaced
+ * \param[in]       client: MQTT client
+ * \param[in]       alias: Alias value from \ref topic_alias_get
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       len_topic: Length of topic
+ */
+static void
+topic_alias_set(lwesp_mqtt_client_p client, uint16_t alias, const char* topic, uint16_t len_topic) {
+    lwesp_mqtt_topic_alias_t* a = &client->alias[alias - 1];
+
+    LWESP_MEMCPY(a->topic, topic, len_topic);
+    a->len = len_topic;
+    client->alias_next = LWESP_U8((client->alias_next + 1) % client->alias_max);
+}
+
+#endif /* LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0 || __DOXYGEN__ */
+
+#endif /* LWESP_CFG_MQTT_V5 || __DOXYGEN__ */
+
+/**
+ * \brief           Get linear block of TX buffer data not yet passed to send command
+ * \param[in]       client: MQTT client
+ * \param[out]      len: Output variable to write length of linear block
+ * \return          Address of linear block
+ */
+static void*
+tx_buff_get_unsent_block(lwesp_mqtt_client_p client, size_t* len) {
+    size_t r, w;
+
+    w = client->tx_buff.w;
+    if (LWESP_BUFF_IS_POW2(&client->tx_buff)) {
+        r = client->tx_buff.r + client->tx_inflight;/* Free-running pointers */
+        *len = LWESP_MIN(w - r, client->tx_buff.size - LWESP_BUFF_INDEX(&client->tx_buff, r));
+        return &client->tx_buff.buff[LWESP_BUFF_INDEX(&client->tx_buff, r)];
+    }
+    r = (client->tx_buff.r + client->tx_inflight) % client->tx_buff.size;
+    if (w > r) {
+        *len = w - r;
+    } else if (r > w) {
+        *len = client->tx_buff.size - r;        /* Until end of buffer, rest is sent after wrap */
+    } else {
+        *len = 0;
+    }
+    return &client->tx_buff.buff[r];
+}
+
 /**
  * \brief           Send the actual data to the remote
+ *
+ * Starts send commands until all written data are queued or \ref LWESP_CFG_MQTT_MAX_SENDS commands are active.
+ * Data before and after TX buffer wrap point are sent as separate commands.
+ *
  * \param[in]       client: MQTT client
  */
 static void
 send_data(lwesp_mqtt_client_p client) {
+    lwesp_mqtt_tx_send_t* s;
+    lwespr_t res;
     size_t len;
-    const void* addr;
+    void* addr;
 
-    if (client->is_sending) {                   /* We are currently sending data */
-        return;
-    }
+    while (!client->tx_hold && client->tx_send_cnt < LWESP_CFG_MQTT_MAX_SENDS) {
+        s = &client->tx_send[(client->tx_send_r + client->tx_send_cnt) % LWESP_CFG_MQTT_MAX_SENDS];
+        addr = tx_buff_get_unsent_block(client, &len);
+#if LWESP_CFG_MQTT_PUBLISH_NOCOPY
+        s->ext = 0;
+        if (client->ext_cnt > client->ext_inflight) {
+            lwesp_mqtt_ext_payload_t* ext;
+            size_t before, cnt = 0;
+
+            ext = &client->ext[(client->ext_r + client->ext_inflight) % LWESP_ARRAYSIZE(client->ext)];
+            before = ext->buff_pos - (client->tx_buff_sent + client->tx_inflight); /* TX buffer bytes to send before payload */
 
-    len = lwesp_buff_get_linear_block_read_length(&client->tx_buff);/* Get length of linear memory */
-    if (len > 0) {                              /* Anything to send? */
-        lwespr_t res;
-        addr = lwesp_buff_get_linear_block_read_address(&client->tx_buff);  /* Get address of linear memory */
-        if ((res = lwesp_conn_send(client->conn, addr, len, NULL, 0)) == lwespOK) {
+            /*
+             * Send header from TX buffer and payload from user memory in single shot,
+             * if header is in single linear block. Otherwise send first block as usual
+             */
+            if (len >= before) {
+                if (before > 0) {
+                    s->iov[cnt].data = addr;
+                    s->iov[cnt].len = before;
+                    ++cnt;
+                }
+                s->iov[cnt].data = ext->data;
+                s->iov[cnt].len = ext->len;
+                ++cnt;
+                if ((res = lwesp_conn_sendv(client->conn, s->iov, cnt, NULL, 0)) != lwespOK) {
+                    LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE_WARNING,
+                               "[MQTT] Cannot send data with error: %d\r\n", (int)res);
+                    break;
+                }
+                client->written_total += before + ext->len;
+                s->ext = 1;
+                ++client->ext_inflight;
+                len = before;
+            }
+        }
+        if (!s->ext)
+#endif /* LWESP_CFG_MQTT_PUBLISH_NOCOPY */
+        {
+            if (len == 0) {                     /* Nothing more to send */
+                if (client->tx_send_cnt == 0) {
+                    /*
+                     * If buffer is empty, reset it to default state (read & write pointers)
+                     * This is to make sure next packets do not start close to the wrap point,
+                     * which would split them to 2 send commands.
+                     */
+                    lwesp_buff_reset(&client->tx_buff);
+                }
+                break;
+            }
+            if ((res = lwesp_conn_send(client->conn, addr, len, NULL, 0)) != lwespOK) {
+                LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE_WARNING,
+                           "[MQTT] Cannot send data with error: %d\r\n", (int)res);
+                break;
+            }
             client->written_total += len;       /* Increase number of bytes written to queue */
-            client->is_sending = 1;             /* Remember active sending flag */
-        } else {
-            LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE_WARNING,
-                       "[MQTT] Cannot send data with error: %d\r\n", (int)res);
         }
-    } else {
-        /*
-         * If buffer is empty, reset it to default state (read & write pointers)
-         * This is to make sure everytime function needs to send data,
-         * it can do it in single shot rather than in 2 attempts (when read > write pointer).
-         * Effectively this means faster transmission of MQTT packets and lower latency.
-         */
-        lwesp_buff_reset(&client->tx_buff);
+        s->buff_len = len;
+        client->tx_inflight += len;
+        ++client->tx_send_cnt;
     }
 }
 
@@ -457,58 +1034,458 @@ mqtt_close(lwesp_mqtt_client_p client) {
 }
 
 /**
- * \brief           Subscribe/Unsubscribe to/from MQTT topic
+ * \brief           Write subscribe/unsubscribe packet for single topic and start send
  * \param[in]       client: MQTT client
  * \param[in]       topic: MQTT topic to (un)subscribe
+ * \param[in]       len_topic: Length of topic
  * \param[in]       qos: Quality of service, used only on subscribe part
  * \param[in]       arg: Custom argument
  * \param[in]       sub: Status set to `1` on subscribe or `0` on unsubscribe
  * \return          `1` on success, `0` otherwise
  */
 static uint8_t
-sub_unsub(lwesp_mqtt_client_p client, const char* topic, lwesp_mqtt_qos_t qos, void* arg, uint8_t sub) {
+mqtt_write_sub_unsub(lwesp_mqtt_client_p client, const char* topic, uint16_t len_topic, lwesp_mqtt_qos_t qos, void* arg, uint8_t sub) {
     lwesp_mqtt_request_t* request;
     uint32_t rem_len;
-    uint16_t len_topic, pkt_id;
-    uint8_t ret = 0;
-
-    if ((len_topic = LWESP_U16(strlen(topic))) == 0) {
-        return 0;
-    }
+    uint16_t pkt_id;
 
     /*
      * Calculate remaining length of packet
      *
-     * rem_len = 2 (topic_len) + topic_len + 2 (pkt_id) + qos (if sub)
+     * rem_len = 2 (topic_len) + topic_len + 2 (pkt_id) + qos (if sub) + 1 (MQTT 5 properties)
      */
     rem_len = 2 + len_topic + 2;
     if (sub) {
         ++rem_len;
     }
+    if (MQTT_IS_V5(client)) {
+        ++rem_len;
+    }
 
-    lwesp_core_lock();
-    if (client->conn_state == LWESP_MQTT_CONNECTED
-        && output_check_enough_memory(client, rem_len)) {   /* Check if enough memory to write packet data */
+    if (output_check_enough_memory(client, rem_len)) {  /* Check if enough memory to write packet data */
         pkt_id = create_packet_id(client);      /* Create new packet ID */
         request = request_create(client, pkt_id, arg);  /* Create request for packet */
         if (request != NULL) {                  /* Do we have a request */
             write_fixed_header(client, sub ? MQTT_MSG_TYPE_SUBSCRIBE : MQTT_MSG_TYPE_UNSUBSCRIBE, 0, (lwesp_mqtt_qos_t)1, 0, rem_len);
             write_u16(client, pkt_id);          /* Write packet ID */
+            if (MQTT_IS_V5(client)) {
+                write_u8(client, 0);            /* No properties */
+            }
             write_string(client, topic, len_topic); /* Write topic string to packet */
             if (sub) {                          /* Send quality of service only on subscribe */
                 write_u8(client, LWESP_MIN(LWESP_U8(qos), LWESP_U8(LWESP_MQTT_QOS_EXACTLY_ONCE)));  /* Write quality of service */
             }
 
-            request->status |= sub ? MQTT_REQUEST_FLAG_SUBSCRIBE : MQTT_REQUEST_FLAG_UNSUBSCRIBE;
-            request_set_pending(client, request);   /* Set request as pending waiting for server reply */
-            send_data(client);                  /* Try to send data */
-            ret = 1;
+            request->status |= sub ? MQTT_REQUEST_FLAG_SUBSCRIBE : MQTT_REQUEST_FLAG_UNSUBSCRIBE;
+            request_set_pending(client, request);   /* Set request as pending waiting for server reply */
+            send_data(client);                  /* Try to send data */
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Write subscribe packet for multiple topics and start send
+ * \param[in]       client: MQTT client
+ * \param[in]       topics: Array of topics with quality of service
+ * \param[in]       count: Number of entries in array
+ * \param[in]       arg: Custom argument
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+mqtt_write_subscribe_many(lwesp_mqtt_client_p client, const lwesp_mqtt_sub_topic_t* topics, size_t count, void* arg) {
+    lwesp_mqtt_request_t* request;
+    uint32_t rem_len;
+    uint16_t pkt_id;
+
+    /*
+     * Calculate remaining length of packet
+     *
+     * rem_len = 2 (pkt_id) + 1 (MQTT 5 properties) + for each topic: 2 (topic_len) + topic_len + 1 (qos)
+     */
+    rem_len = MQTT_IS_V5(client) ? 3 : 2;
+    for (size_t i = 0; i < count; ++i) {
+        size_t len_topic = strlen(topics[i].topic);
+        if (len_topic == 0 || len_topic > 0xFFFF) {
+            return 0;
+        }
+        rem_len += 2 + LWESP_U32(len_topic) + 1;
+    }
+    if (rem_len > 0xFFFF) {                     /* Packet length is limited by output functions */
+        return 0;
+    }
+
+    if (output_check_enough_memory(client, LWESP_U16(rem_len))) {   /* Check if enough memory to write packet data */
+        pkt_id = create_packet_id(client);      /* Create new packet ID */
+        request = request_create(client, pkt_id, arg);  /* Create request for packet */
+        if (request != NULL) {                  /* Do we have a request */
+            write_fixed_header(client, MQTT_MSG_TYPE_SUBSCRIBE, 0, (lwesp_mqtt_qos_t)1, 0, LWESP_U16(rem_len));
+            write_u16(client, pkt_id);          /* Write packet ID */
+            if (MQTT_IS_V5(client)) {
+                write_u8(client, 0);            /* No properties */
+            }
+            for (size_t i = 0; i < count; ++i) {
+                write_string(client, topics[i].topic, LWESP_U16(strlen(topics[i].topic)));
+                write_u8(client, LWESP_MIN(LWESP_U8(topics[i].qos), LWESP_U8(LWESP_MQTT_QOS_EXACTLY_ONCE)));
+            }
+
+            request->status |= MQTT_REQUEST_FLAG_SUBSCRIBE;
+            request_set_pending(client, request);   /* Set request as pending waiting for server reply */
+            send_data(client);                  /* Try to send data */
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Subscribe/Unsubscribe to/from MQTT topic
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: MQTT topic to (un)subscribe
+ * \param[in]       qos: Quality of service, used only on subscribe part
+ * \param[in]       arg: Custom argument
+ * \param[in]       sub: Status set to `1` on subscribe or `0` on unsubscribe
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+sub_unsub(lwesp_mqtt_client_p client, const char* topic, lwesp_mqtt_qos_t qos, void* arg, uint8_t sub) {
+    uint16_t len_topic;
+    uint8_t ret = 0;
+
+    if ((len_topic = LWESP_U16(strlen(topic))) == 0) {
+        return 0;
+    }
+
+    lwesp_core_lock();
+    if (client->conn_state == LWESP_MQTT_CONNECTED) {
+        ret = mqtt_write_sub_unsub(client, topic, len_topic, qos, arg, sub);
+#if LWESP_CFG_MQTT_SESSION_STORE
+        if (ret && client->session_fn != NULL) {/* Keep subscription list in session store */
+            lwesp_mqtt_session_entry_t entry = {0};
+
+            entry.type = LWESP_MQTT_SESSION_TYPE_SUBSCRIPTION;
+            entry.topic = topic;
+            entry.topic_len = len_topic;
+            entry.qos = qos;
+            client->session_fn(client, sub ? LWESP_MQTT_SESSION_OP_SAVE : LWESP_MQTT_SESSION_OP_REMOVE, &entry, 0);
+        }
+#endif /* LWESP_CFG_MQTT_SESSION_STORE */
+    }
+    lwesp_core_unlock();
+    return ret;
+}
+
+/**
+ * \brief           Check if publish with specific quality of service fits into in-flight window
+ * \param[in]       client: MQTT client
+ * \param[in]       qos: Quality of service of publish packet
+ * \return          `1` if packet may be sent, `0` otherwise
+ */
+static uint8_t
+mqtt_inflight_available(lwesp_mqtt_client_p client, uint8_t qos) {
+    if (qos == 0) {
+        return 1;
+    }
+#if LWESP_CFG_MQTT_MAX_INFLIGHT > 0
+    if (client->inflight >= LWESP_CFG_MQTT_MAX_INFLIGHT) {
+        return 0;
+    }
+#endif /* LWESP_CFG_MQTT_MAX_INFLIGHT > 0 */
+#if LWESP_CFG_MQTT_V5
+    if (client->v5 && client->inflight >= client->srv_recv_max) {   /* Server receive maximum */
+        return 0;
+    }
+#endif /* LWESP_CFG_MQTT_V5 */
+    LWESP_UNUSED(client);
+    return 1;
+}
+
+/**
+ * \brief           Calculate remaining length of publish packet
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       len_topic: Length of topic
+ * \param[in]       payload_len: Length of payload data
+ * \param[in]       qos: Quality of service
+ * \return          Remaining length of packet
+ */
+static uint32_t
+mqtt_publish_rem_len(lwesp_mqtt_client_p client, const char* topic, uint16_t len_topic, uint16_t payload_len, uint8_t qos) {
+    /* rem_len = 2 (topic_len) + topic_len + 2 (pkt_id only if qos > 0) + payload_len */
+    uint32_t rem_len = 2 + len_topic + payload_len + (qos > 0 ? 2 : 0);
+
+#if LWESP_CFG_MQTT_V5
+    if (client->v5) {
+#if LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0
+        uint8_t is_new;
+
+        if (topic_alias_get(client, topic, len_topic, &is_new) > 0) {
+            rem_len += 3;                       /* Topic alias property */
+            if (!is_new) {
+                rem_len -= len_topic;           /* Topic is replaced by alias */
+            }
+        }
+#endif /* LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0 */
+        ++rem_len;                              /* Properties length */
+    }
+#endif /* LWESP_CFG_MQTT_V5 */
+    LWESP_UNUSED(client);
+    LWESP_UNUSED(topic);
+    return rem_len;
+}
+
+/**
+ * \brief           Write publish packet to output buffer
+ * \param[in]       client: MQTT client
+ * \param[in]       pkt_id: Packet ID, used only for QoS `1` or `2`
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       len_topic: Length of topic
+ * \param[in]       payload: Message data
+ * \param[in]       payload_len: Length of payload data
+ * \param[in]       qos: Quality of service
+ * \param[in]       retain: Retian parameter value
+ * \param[in]       rem_len: Remaining length of packet from \ref mqtt_publish_rem_len
+ * \param[in]       nocopy: Set to `1` to send payload from user memory instead of TX buffer
+ */
+static void
+mqtt_write_publish(lwesp_mqtt_client_p client, uint16_t pkt_id, const char* topic, uint16_t len_topic,
+                   const void* payload, uint16_t payload_len, uint8_t qos, uint8_t retain, uint32_t rem_len, uint8_t nocopy) {
+    uint16_t alias = 0;
+    uint8_t alias_is_new = 0;
+
+#if LWESP_CFG_MQTT_V5 && LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0
+    if (client->v5 && (alias = topic_alias_get(client, topic, len_topic, &alias_is_new)) > 0 && alias_is_new) {
+        topic_alias_set(client, alias, topic, len_topic);   /* Server learns alias from this packet */
+    }
+#endif /* LWESP_CFG_MQTT_V5 && LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0 */
+    write_fixed_header(client, MQTT_MSG_TYPE_PUBLISH, 0, (lwesp_mqtt_qos_t)LWESP_MIN(qos, LWESP_U8(LWESP_MQTT_QOS_EXACTLY_ONCE)), retain, rem_len);
+    write_string(client, topic, alias > 0 && !alias_is_new ? 0 : len_topic);  /* Write topic string, empty when alias is known */
+    if (qos) {
+        write_u16(client, pkt_id);              /* Write packet ID */
+    }
+    if (MQTT_IS_V5(client)) {                   /* Write properties */
+        if (alias > 0) {
+            write_u8(client, 3);
+            write_u8(client, MQTT_PROP_TOPIC_ALIAS);
+            write_u16(client, alias);
+        } else {
+            write_u8(client, 0);
+        }
+    }
+    if (payload != NULL && payload_len) {
+#if LWESP_CFG_MQTT_PUBLISH_NOCOPY
+        if (nocopy) {                           /* Payload is sent from user memory after header */
+            lwesp_mqtt_ext_payload_t* ext;
+
+            ext = &client->ext[(client->ext_r + client->ext_cnt) % LWESP_ARRAYSIZE(client->ext)];
+            ext->data = payload;
+            ext->len = payload_len;
+            ext->buff_pos = client->tx_buff_sent + LWESP_U32(lwesp_buff_get_full(&client->tx_buff));
+            ++client->ext_cnt;
+        } else
+#endif /* LWESP_CFG_MQTT_PUBLISH_NOCOPY */
+        {
+            write_data(client, payload, payload_len);   /* Write RAW topic payload */
+        }
+    }
+#if LWESP_CFG_MQTT_SESSION_STORE
+    if (qos > 0 && client->session_fn != NULL) {/* Keep packet until acknowledged */
+        lwesp_mqtt_session_entry_t entry = {0};
+
+        entry.type = LWESP_MQTT_SESSION_TYPE_PUBLISH;
+        entry.packet_id = pkt_id;
+        entry.topic = topic;
+        entry.topic_len = len_topic;
+        entry.payload = payload;
+        entry.payload_len = payload != NULL ? payload_len : 0;
+        entry.qos = (lwesp_mqtt_qos_t)qos;
+        entry.retain = retain;
+        client->session_fn(client, LWESP_MQTT_SESSION_OP_SAVE, &entry, 0);
+    }
+#endif /* LWESP_CFG_MQTT_SESSION_STORE */
+    LWESP_UNUSED(nocopy);
+}
+
+/**
+ * \brief           Set written publish request as pending and start send
+ * \param[in]       client: MQTT client
+ * \param[in]       request: Request object for packet
+ */
+static void
+mqtt_publish_start(lwesp_mqtt_client_p client, lwesp_mqtt_request_t* request) {
+    request_set_pending(client, request);       /* Set request as pending waiting for server reply */
+    if (request->packet_id != 0) {              /* Only QoS > 0 waits for acknowledge */
+        request->status |= MQTT_REQUEST_FLAG_INFLIGHT;
+        ++client->inflight;
+    }
+    send_data(client);                          /* Try to send data */
+
+    LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE,
+               "[MQTT] Pkt publish start. pkt_id: %d\r\n", (int)request->packet_id);
+}
+
+#if LWESP_CFG_MQTT_PUBLISH_BACKLOG || __DOXYGEN__
+
+/**
+ * \brief           Serialize publish packet to heap memory and add it to backlog
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       len_topic: Length of topic
+ * \param[in]       payload: Message data
+ * \param[in]       payload_len: Length of payload data
+ * \param[in]       qos: Quality of service
+ * \param[in]       retain: Retian parameter value
+ * \param[in]       rem_len: Remaining length of packet
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+mqtt_backlog_add(lwesp_mqtt_client_p client, const char* topic, uint16_t len_topic,
+                 const void* payload, uint16_t payload_len, uint8_t qos, uint8_t retain,
+                 uint32_t rem_len, void* arg) {
+    lwesp_mqtt_request_t* request;
+    lwesp_buff_t tx_buff;
+    uint32_t raw_len = mqtt_packet_len(rem_len);
+
+    if ((request = request_create(client, qos > 0 ? create_packet_id(client) : 0, arg)) == NULL) {
+        return lwespERRMEM;
+    }
+
+    /* Temporarily replace TX buffer to serialize packet to backlog memory */
+    tx_buff = client->tx_buff;
+    if (!lwesp_buff_init(&client->tx_buff, raw_len + 1)) {
+        client->tx_buff = tx_buff;
+        request_delete(client, request);
+        return lwespERRMEM;
+    }
+    mqtt_write_publish(client, request->packet_id, topic, len_topic, payload, payload_len, qos, retain, rem_len, 0);
+    request->backlog = client->tx_buff;
+    client->tx_buff = tx_buff;
+
+    request->status |= MQTT_REQUEST_FLAG_QUEUED;
+    client->req_backlog[(client->backlog_r + client->backlog_cnt) % LWESP_CFG_MQTT_MAX_REQUESTS] = LWESP_U8(request - client->requests);
+    ++client->backlog_cnt;
+
+    LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE,
+               "[MQTT] Pkt publish queued to backlog. pkt_id: %d\r\n", (int)request->packet_id);
+    return lwespOK;
+}
+
+/**
+ * \brief           Move queued publish packets to TX buffer while resources are available
+ * \param[in]       client: MQTT client
+ */
+static void
+mqtt_backlog_process(lwesp_mqtt_client_p client) {
+    while (client->backlog_cnt > 0) {
+        lwesp_mqtt_request_t* request = &client->requests[client->req_backlog[client->backlog_r]];
+        size_t len = lwesp_buff_get_full(&request->backlog);
+
+        if (lwesp_buff_get_free(&client->tx_buff) < len
+            || !mqtt_inflight_available(client, request->packet_id != 0)
+            || (request->packet_id == 0 && !qos0_mark_available(client, request->arg))) {
+            break;
+        }
+        request->expected_sent_len = client->written_total + len;
+        lwesp_buff_write(&client->tx_buff, lwesp_buff_get_linear_block_read_address(&request->backlog), len);
+        lwesp_buff_free(&request->backlog);
+        request->status &= ~MQTT_REQUEST_FLAG_QUEUED;
+
+        client->backlog_r = LWESP_U8((client->backlog_r + 1) % LWESP_CFG_MQTT_MAX_REQUESTS);
+        --client->backlog_cnt;
+        if (request->packet_id == 0) {          /* Request is not needed once QoS 0 packet is written */
+            qos0_mark_add(client, request->expected_sent_len, request->arg);
+            request_delete(client, request);
+            send_data(client);
+        } else {
+            mqtt_publish_start(client, request);
+        }
+    }
+}
+
+#endif /* LWESP_CFG_MQTT_PUBLISH_BACKLOG || __DOXYGEN__ */
+
+/**
+ * \brief           Process backlog and notify user when resources for new publish are available again
+ * \param[in]       client: MQTT client
+ */
+static void
+mqtt_check_writable(lwesp_mqtt_client_p client) {
+#if LWESP_CFG_MQTT_PUBLISH_BACKLOG
+    mqtt_backlog_process(client);
+#endif /* LWESP_CFG_MQTT_PUBLISH_BACKLOG */
+    if (client->writable_notify
+        && client->req_free_cnt > 0
+        && mqtt_inflight_available(client, 1)
+        && lwesp_buff_get_free(&client->tx_buff) >= client->tx_buff.size / 2) {
+        client->writable_notify = 0;
+        client->evt.type = LWESP_MQTT_EVT_WRITABLE;
+        client->evt_fn(client, &client->evt);
+    }
+}
+
+#if LWESP_CFG_MQTT_SESSION_STORE || __DOXYGEN__
+
+/**
+ * \brief           Replay stored session after server accepted connection
+ *
+ * Unacknowledged publish packets are sent again with duplicate flag and their original packet ID.
+ * Subscriptions are sent again only if server has no session for this client
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       session_present: Session present flag from CONNACK packet
+ */
+static void
+mqtt_session_replay(lwesp_mqtt_client_p client, uint8_t session_present) {
+    lwesp_mqtt_session_entry_t entry;
+    size_t i;
+
+    for (i = 0;; ++i) {
+        LWESP_MEMSET(&entry, 0x00, sizeof(entry));
+        if (client->session_fn(client, LWESP_MQTT_SESSION_OP_LOAD, &entry, i) != lwespOK) {
+            break;
+        }
+        if (entry.type == LWESP_MQTT_SESSION_TYPE_SUBSCRIPTION) {
+            if (!session_present && entry.topic_len > 0
+                && !mqtt_write_sub_unsub(client, entry.topic, entry.topic_len, entry.qos, NULL, 1)) {
+                break;
+            }
+        } else if (entry.type == LWESP_MQTT_SESSION_TYPE_PUBLISH && entry.packet_id != 0) {
+            lwesp_mqtt_request_t* request;
+            uint32_t rem_len;
+            uint16_t raw_len;
+
+            /* rem_len = 2 (topic_len) + topic_len + 2 (pkt_id) + 1 (MQTT 5 properties) + payload_len */
+            rem_len = 2 + entry.topic_len + 2 + (MQTT_IS_V5(client) ? 1 : 0) + entry.payload_len;
+            if ((raw_len = output_check_enough_memory(client, rem_len)) == 0
+                || !mqtt_inflight_available(client, 1)
+                || (request = request_create(client, entry.packet_id, NULL)) == NULL) {
+                break;
+            }
+            request->expected_sent_len = client->written_total + raw_len;
+            write_fixed_header(client, MQTT_MSG_TYPE_PUBLISH, 1, (lwesp_mqtt_qos_t)LWESP_MIN(LWESP_U8(entry.qos), LWESP_U8(LWESP_MQTT_QOS_EXACTLY_ONCE)), entry.retain, rem_len);
+            write_string(client, entry.topic, entry.topic_len);
+            write_u16(client, entry.packet_id);
+            if (MQTT_IS_V5(client)) {
+                write_u8(client, 0);            /* No properties, topic is always sent in full */
+            }
+            if (entry.payload != NULL && entry.payload_len > 0) {
+                write_data(client, entry.payload, entry.payload_len);
+            }
+            mqtt_publish_start(client, request);
+
+            /* New packet IDs must not collide with replayed ones */
+            if (entry.packet_id > client->last_packet_id) {
+                client->last_packet_id = entry.packet_id;
+            }
         }
     }
-    lwesp_core_unlock();
-    return ret;
+    LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE, "[MQTT] Session replay processed %d entries\r\n", (int)i);
 }
 
+#endif /* LWESP_CFG_MQTT_SESSION_STORE || __DOXYGEN__ */
+
 /**
  * \brief           Process incoming fully received message
  * \param[in]       client: MQTT client
@@ -531,8 +1508,18 @@ mqtt_process_incoming_message(lwesp_mqtt_client_p client) {
         case MQTT_MSG_TYPE_CONNACK: {
             lwesp_mqtt_conn_status_t err = (lwesp_mqtt_conn_status_t)client->rx_buff[1];
             if (client->conn_state == LWESP_MQTT_CONNECTING) {
+#if LWESP_CFG_MQTT_V5
+                if (client->v5) {
+                    err = mqtt_v5_process_connack(client);
+                }
+#endif /* LWESP_CFG_MQTT_V5 */
                 if (err == LWESP_MQTT_CONN_STATUS_ACCEPTED) {
                     client->conn_state = LWESP_MQTT_CONNECTED;
+#if LWESP_CFG_MQTT_SESSION_STORE
+                    if (client->session_fn != NULL) {
+                        mqtt_session_replay(client, client->rx_buff[0] & 0x01);
+                    }
+#endif /* LWESP_CFG_MQTT_SESSION_STORE */
                 }
                 LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE,
                            "[MQTT] CONNACK received with result: %d\r\n", (int)err);
@@ -567,6 +1554,17 @@ mqtt_process_incoming_message(lwesp_mqtt_client_p client) {
             } else {
                 pkt_id = 0;                     /* No packet ID */
             }
+#if LWESP_CFG_MQTT_V5
+            if (client->v5) {                   /* Skip properties, client does not accept topic aliases */
+                size_t pos = mqtt_skip_props(client, data - client->rx_buff);
+
+                if (pos == 0) {
+                    LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE_WARNING, "[MQTT] Invalid publish properties\r\n");
+                    break;
+                }
+                data = &client->rx_buff[pos];
+            }
+#endif /* LWESP_CFG_MQTT_V5 */
             data_len = client->msg_rem_len - (data - client->rx_buff);  /* Calculate length of remaining data */
 
             LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE,
@@ -596,6 +1594,8 @@ mqtt_process_incoming_message(lwesp_mqtt_client_p client) {
             client->evt.evt.publish_recv.payload_len = data_len;
             client->evt.evt.publish_recv.dup = dup;
             client->evt.evt.publish_recv.qos = qos;
+            client->evt.evt.publish_recv.pbuf = client->rx_pbuf;
+            client->evt.evt.publish_recv.pbuf_offset = client->rx_pbuf != NULL ? client->rx_pbuf_offset + (data - client->rx_buff) : 0;
             client->evt_fn(client, &client->evt);
             break;
         }
@@ -612,16 +1612,33 @@ mqtt_process_incoming_message(lwesp_mqtt_client_p client) {
         case MQTT_MSG_TYPE_PUBREL:
         case MQTT_MSG_TYPE_PUBACK:
         case MQTT_MSG_TYPE_PUBCOMP: {
+            size_t codes_pos = 2;
+            uint8_t reason = 0;
+
             pkt_id = client->rx_buff[0] << 8 | client->rx_buff[1];  /* Get packet ID */
+#if LWESP_CFG_MQTT_V5
+            if (client->v5) {
+                if (msg_type == MQTT_MSG_TYPE_SUBACK || msg_type == MQTT_MSG_TYPE_UNSUBACK) {
+                    codes_pos = mqtt_skip_props(client, 2); /* Reason codes follow properties */
+                    if (codes_pos == 0) {
+                        codes_pos = client->msg_rem_len;
+                        reason = 0x80;
+                    }
+                } else if (client->msg_rem_len > 2) {
+                    reason = client->rx_buff[2];    /* Reason code, success when omitted */
+                }
+            }
+#endif /* LWESP_CFG_MQTT_V5 */
 
-            if (msg_type == MQTT_MSG_TYPE_PUBREC) { /* Publish record received from server */
+            if (msg_type == MQTT_MSG_TYPE_PUBREC && reason < 0x80) {    /* Publish record received from server */
                 write_ack_rec_rel_resp(client, MQTT_MSG_TYPE_PUBREL, pkt_id, (lwesp_mqtt_qos_t)1);  /* Send back publish release message */
             } else if (msg_type == MQTT_MSG_TYPE_PUBREL) {  /* Publish release was received */
                 write_ack_rec_rel_resp(client, MQTT_MSG_TYPE_PUBCOMP, pkt_id, (lwesp_mqtt_qos_t)0); /* Send back publish complete */
             } else if (msg_type == MQTT_MSG_TYPE_SUBACK
                        || msg_type == MQTT_MSG_TYPE_UNSUBACK
                        || msg_type == MQTT_MSG_TYPE_PUBACK
-                       || msg_type == MQTT_MSG_TYPE_PUBCOMP) {
+                       || msg_type == MQTT_MSG_TYPE_PUBCOMP
+                       || msg_type == MQTT_MSG_TYPE_PUBREC) {
                 lwesp_mqtt_request_t* request;
 
                 /*
@@ -637,21 +1654,42 @@ mqtt_process_incoming_message(lwesp_mqtt_client_p client) {
                         || msg_type == MQTT_MSG_TYPE_UNSUBACK) {
                         client->evt.type = msg_type == MQTT_MSG_TYPE_SUBACK ? LWESP_MQTT_EVT_SUBSCRIBE : LWESP_MQTT_EVT_UNSUBSCRIBE;
                         client->evt.evt.sub_unsub_scribed.arg = request->arg;
-                        client->evt.evt.sub_unsub_scribed.res = client->rx_buff[2] < 3 ? lwespOK : lwespERR;
+                        client->evt.evt.sub_unsub_scribed.res = reason < 0x80 ? lwespOK : lwespERR;
+                        client->evt.evt.sub_unsub_scribed.return_codes = NULL;
+                        client->evt.evt.sub_unsub_scribed.return_codes_len = 0;
+                        if (msg_type == MQTT_MSG_TYPE_SUBACK || MQTT_IS_V5(client)) {
+                            /* One return code per topic, in the same order as in request. UNSUBACK has them only in MQTT 5 */
+                            client->evt.evt.sub_unsub_scribed.return_codes = &client->rx_buff[codes_pos];
+                            client->evt.evt.sub_unsub_scribed.return_codes_len = client->msg_rem_len - codes_pos;
+                            for (size_t i = codes_pos; i < client->msg_rem_len; ++i) {
+                                if (client->rx_buff[i] >= (msg_type == MQTT_MSG_TYPE_SUBACK ? 3 : 0x80)) {
+                                    client->evt.evt.sub_unsub_scribed.res = lwespERR;
+                                }
+                            }
+                        }
                         client->evt_fn(client, &client->evt);
 
                         /*
                          * Final acknowledge of packet received
                          * Ack type depends on QoS level being sent to server on request
                          */
-                    } else if (msg_type == MQTT_MSG_TYPE_PUBCOMP
-                               || msg_type == MQTT_MSG_TYPE_PUBACK) {
+                    } else {                    /* PUBACK, PUBCOMP or PUBREC with failure reason */
+#if LWESP_CFG_MQTT_SESSION_STORE
+                        if (client->session_fn != NULL) {   /* Packet is delivered, remove it from session */
+                            lwesp_mqtt_session_entry_t entry = {0};
+
+                            entry.type = LWESP_MQTT_SESSION_TYPE_PUBLISH;
+                            entry.packet_id = pkt_id;
+                            client->session_fn(client, LWESP_MQTT_SESSION_OP_REMOVE, &entry, 0);
+                        }
+#endif /* LWESP_CFG_MQTT_SESSION_STORE */
                         client->evt.type = LWESP_MQTT_EVT_PUBLISH;
                         client->evt.evt.publish.arg = request->arg;
-                        client->evt.evt.publish.res = lwespOK;
+                        client->evt.evt.publish.res = reason < 0x80 ? lwespOK : lwespERR;
                         client->evt_fn(client, &client->evt);
                     }
                     request_delete(client, request);/* Delete request object */
+                    mqtt_check_writable(client);    /* Window may be open again */
                 } else {
                     /* Protocol violation at this point! */
                     LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE,
@@ -666,6 +1704,50 @@ mqtt_process_incoming_message(lwesp_mqtt_client_p client) {
     return 1;
 }
 
+#if LWESP_CFG_MQTT_RECV_STREAM || __DOXYGEN__
+
+/**
+ * \brief           Send streamed publish event to user
+ * \param[in]       client: MQTT client
+ * \param[in]       type: Event type to send
+ * \param[in]       data: Payload part or `NULL`
+ * \param[in]       len: Length of payload part
+ */
+static void
+mqtt_publish_recv_stream_evt(lwesp_mqtt_client_p client, lwesp_mqtt_evt_type_t type, const void* data, size_t len) {
+    lwesp_mqtt_qos_t qos = MQTT_RCV_GET_PACKET_QOS(client->msg_hdr_byte);
+
+    client->evt.type = type;
+    client->evt.evt.publish_recv_stream.topic = &client->rx_buff[2];
+    client->evt.evt.publish_recv_stream.topic_len = (client->rx_buff[0] << 8) | client->rx_buff[1];
+    client->evt.evt.publish_recv_stream.payload = data;
+    client->evt.evt.publish_recv_stream.payload_len = len;
+    client->evt.evt.publish_recv_stream.offset = client->msg_curr_pos - client->msg_stream_hdr_len - len;
+    client->evt.evt.publish_recv_stream.total_len = client->msg_rem_len - client->msg_stream_hdr_len;
+    client->evt.evt.publish_recv_stream.dup = MQTT_RCV_GET_PACKET_DUP(client->msg_hdr_byte);
+    client->evt.evt.publish_recv_stream.qos = qos;
+    client->evt_fn(client, &client->evt);
+}
+
+/**
+ * \brief           Finish streamed publish message, send response and notify user
+ * \param[in]       client: MQTT client
+ */
+static void
+mqtt_publish_recv_stream_end(lwesp_mqtt_client_p client) {
+    lwesp_mqtt_qos_t qos = MQTT_RCV_GET_PACKET_QOS(client->msg_hdr_byte);
+
+    if (qos > 0) {                              /* We have to reply on QoS > 0 */
+        size_t pos = 2 + ((client->rx_buff[0] << 8) | client->rx_buff[1]);  /* Packet ID follows topic */
+        uint16_t pkt_id = (client->rx_buff[pos] << 8) | client->rx_buff[pos + 1];
+        write_ack_rec_rel_resp(client, qos == 1 ? MQTT_MSG_TYPE_PUBACK : MQTT_MSG_TYPE_PUBREC, pkt_id, qos);
+    }
+    mqtt_publish_recv_stream_evt(client, LWESP_MQTT_EVT_PUBLISH_RECV_END, NULL, 0);
+    client->parser_state = MQTT_PARSER_STATE_INIT;
+}
+
+#endif /* LWESP_CFG_MQTT_RECV_STREAM || __DOXYGEN__ */
+
 /**
  * \brief           Parse incoming buffer data and try to construct clean packet from it
  * \param[in]       client: MQTT client
@@ -674,15 +1756,13 @@ mqtt_process_incoming_message(lwesp_mqtt_client_p client) {
  */
 static uint8_t
 mqtt_parse_incoming(lwesp_mqtt_client_p client, lwesp_pbuf_p pbuf) {
-    size_t buff_len = 0, buff_offset = 0;
+    lwesp_pbuf_cursor_t cur;
+    size_t buff_len = 0, buff_offset;
     uint8_t ch, *d;
 
-    do {
-        buff_offset += buff_len;                /* Calculate new offset of buffer */
-        d = lwesp_pbuf_get_linear_addr(pbuf, buff_offset, &buff_len);   /* Get address pointer */
-        if (d == NULL) {
-            break;
-        }
+    lwesp_pbuf_cursor_init(&cur, pbuf, 0);
+    while ((d = lwesp_pbuf_cursor_peek_linear(&cur, &buff_len)) != NULL) {
+        buff_offset = lwesp_pbuf_length(pbuf, 1) - lwesp_pbuf_cursor_remaining(&cur);
         for (size_t idx = 0; idx < buff_len; ++idx) {   /* Process entire linear buffer */
             ch = d[idx];
             switch (client->parser_state) {     /* Check parser state */
@@ -721,17 +1801,27 @@ mqtt_parse_incoming(lwesp_mqtt_client_p client, lwesp_pbuf_p pbuf) {
                                 /* Set new client pointer */
                                 client->rx_buff = &d[idx + 1];  /* Data are one byte after */
                                 client->rx_buff_len = client->msg_rem_len;
+                                client->rx_pbuf = pbuf;
+                                client->rx_pbuf_offset = buff_offset + idx + 1;
 
                                 mqtt_process_incoming_message(client);  /* Process new message */
 
                                 /* Reset to previous values */
                                 client->rx_buff = tmp_ptr;
                                 client->rx_buff_len = tmp_len;
+                                client->rx_pbuf = NULL;
                                 client->parser_state = MQTT_PARSER_STATE_INIT;
 
                                 idx += client->msg_rem_len; /* Skip data part only, idx is increased again in for loop */
                             } else {
                                 client->parser_state = MQTT_PARSER_STATE_READ_REM;
+#if LWESP_CFG_MQTT_RECV_STREAM
+                                if (client->msg_rem_len > client->rx_buff_len
+                                    && MQTT_RCV_GET_PACKET_TYPE(client->msg_hdr_byte) == MQTT_MSG_TYPE_PUBLISH) {
+                                    client->msg_stream_hdr_len = 0;
+                                    client->parser_state = MQTT_PARSER_STATE_READ_STREAM;
+                                }
+#endif /* LWESP_CFG_MQTT_RECV_STREAM */
                             }
                         } else {
                             mqtt_process_incoming_message(client);
@@ -762,11 +1852,83 @@ mqtt_parse_incoming(lwesp_mqtt_client_p client, lwesp_pbuf_p pbuf) {
                     }
                     break;
                 }
+#if LWESP_CFG_MQTT_RECV_STREAM
+                case MQTT_PARSER_STATE_READ_STREAM: {   /* Read topic to RX buffer, stream payload to user */
+                    if (client->msg_stream_hdr_len == 0 || client->msg_curr_pos < client->msg_stream_hdr_len) {
+                        if (client->msg_curr_pos < client->rx_buff_len) {
+                            client->rx_buff[client->msg_curr_pos] = ch;
+                        }
+                        ++client->msg_curr_pos;
+
+                        /* Topic length is known, calculate header length */
+                        if (client->msg_curr_pos == 2) {
+                            client->msg_stream_hdr_len = 2 + ((client->rx_buff[0] << 8) | client->rx_buff[1])
+                                                         + (MQTT_RCV_GET_PACKET_QOS(client->msg_hdr_byte) > 0 ? 2 : 0);
+#if LWESP_CFG_MQTT_V5
+                            client->msg_stream_props_pos = 0;
+                            if (client->v5) {   /* Properties length has at least 1 byte */
+                                client->msg_stream_props_pos = client->msg_stream_hdr_len++;
+                            }
+#endif /* LWESP_CFG_MQTT_V5 */
+                            if (client->msg_stream_hdr_len > client->rx_buff_len
+                                || client->msg_stream_hdr_len > client->msg_rem_len) {
+                                LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE_WARNING,
+                                           "[MQTT] Topic too big for rx buffer. Packet discarded\r\n");
+                                client->parser_state = MQTT_PARSER_STATE_READ_REM;  /* Skip remaining data */
+                                break;
+                            }
+                        }
+#if LWESP_CFG_MQTT_V5
+                        if (client->msg_curr_pos == client->msg_stream_hdr_len && client->msg_stream_props_pos > 0) {
+                            uint32_t props_len;
+                            size_t n = client->msg_curr_pos - client->msg_stream_props_pos;
+
+                            /* Extend header by properties once their length is complete */
+                            if (mqtt_read_varint(&client->rx_buff[client->msg_stream_props_pos], n, &props_len) == 0) {
+                                ++client->msg_stream_hdr_len;
+                            } else {
+                                client->msg_stream_props_pos = 0;
+                                client->msg_stream_hdr_len += props_len;
+                            }
+                            if ((client->msg_stream_props_pos > 0 && n >= 4)
+                                || client->msg_stream_hdr_len > client->rx_buff_len
+                                || client->msg_stream_hdr_len > client->msg_rem_len) {
+                                LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE_WARNING,
+                                           "[MQTT] Publish properties too big for rx buffer. Packet discarded\r\n");
+                                client->parser_state = MQTT_PARSER_STATE_READ_REM;  /* Skip remaining data */
+                                break;
+                            }
+                        }
+#endif /* LWESP_CFG_MQTT_V5 */
+                        if (client->msg_curr_pos == client->msg_stream_hdr_len) {
+                            LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_STATE,
+                                       "[MQTT] Streaming publish packet with %d bytes of payload\r\n",
+                                       (int)(client->msg_rem_len - client->msg_stream_hdr_len));
+                            mqtt_publish_recv_stream_evt(client, LWESP_MQTT_EVT_PUBLISH_RECV_BEGIN, NULL, 0);
+                            if (client->msg_curr_pos == client->msg_rem_len) {
+                                mqtt_publish_recv_stream_end(client);
+                            }
+                        }
+                    } else {
+                        /* Deliver payload part directly from received buffer */
+                        size_t len = LWESP_MIN(buff_len - idx, (size_t)(client->msg_rem_len - client->msg_curr_pos));
+
+                        client->msg_curr_pos += len;
+                        mqtt_publish_recv_stream_evt(client, LWESP_MQTT_EVT_PUBLISH_RECV_DATA, &d[idx], len);
+                        idx += len - 1;         /* Skip payload part, idx is increased again in for loop */
+                        if (client->msg_curr_pos == client->msg_rem_len) {
+                            mqtt_publish_recv_stream_end(client);
+                        }
+                    }
+                    break;
+                }
+#endif /* LWESP_CFG_MQTT_RECV_STREAM */
                 default:
                     client->parser_state = MQTT_PARSER_STATE_INIT;
             }
         }
-    } while (buff_len > 0);
+        lwesp_pbuf_cursor_skip(&cur, buff_len); /* Continue with next pbuf in chain */
+    }
     return 0;
 }
 
@@ -776,6 +1938,64 @@ mqtt_parse_incoming(lwesp_mqtt_client_p client, lwesp_pbuf_p pbuf) {
 /******************************************************************************************************/
 /******************************************************************************************************/
 
+static void     mqtt_keep_alive_timeout(void* arg);
+
+/**
+ * \brief           Start keep-alive timeout to expire when keep-alive interval
+ *                  since last sent data elapses
+ * \param[in]       client: MQTT client
+ */
+static void
+mqtt_keep_alive_start(lwesp_mqtt_client_p client) {
+    uint32_t interval, elapsed;
+
+    if (client->keep_alive_to != 0) {
+        lwesp_timeout_cancel(client->keep_alive_to);
+        client->keep_alive_to = 0;
+    }
+    if (client->info->keep_alive) {             /* Keep alive is in units of seconds */
+        interval = (uint32_t)client->info->keep_alive * 1000;
+        elapsed = lwesp_sys_now() - client->poll_time;
+
+        /* Retry shortly when PINGREQ could not be written */
+        client->keep_alive_to = lwesp_timeout_addex(elapsed < interval ? interval - elapsed : 100, mqtt_keep_alive_timeout, client);
+        if (client->keep_alive_to == 0) {
+            LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE_WARNING, "[MQTT] Cannot start keep-alive timeout\r\n");
+        }
+    }
+}
+
+/**
+ * \brief           Keep-alive timeout callback
+ *
+ * Data sent to server only updates time of last activity,
+ * hence PINGREQ is sent only when there was no other traffic for entire interval
+ *
+ * \param[in]       arg: MQTT client
+ */
+static void
+mqtt_keep_alive_timeout(void* arg) {
+    lwesp_mqtt_client_p client = arg;
+
+    lwesp_core_lock();
+    client->keep_alive_to = 0;
+    if (client->conn_state == LWESP_MQTT_CONNECTING || client->conn_state == LWESP_MQTT_CONNECTED) {
+        if ((lwesp_sys_now() - client->poll_time) >= (uint32_t)client->info->keep_alive * 1000) {
+            if (output_check_enough_memory(client, 0)) {/* Check if memory available in output buffer */
+                write_fixed_header(client, MQTT_MSG_TYPE_PINGREQ, 0, (lwesp_mqtt_qos_t)0, 0, 0);/* Write PINGREQ command to output buffer */
+                send_data(client);              /* Force send data */
+                client->poll_time = lwesp_sys_now();/* Reset polling time */
+
+                LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE, "[MQTT] Sending PINGREQ packet\r\n");
+            } else {
+                LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE_WARNING, "[MQTT] No memory to send PINGREQ packet\r\n");
+            }
+        }
+        mqtt_keep_alive_start(client);          /* Schedule for remaining time of interval */
+    }
+    lwesp_core_unlock();
+}
+
 /**
  * \brief           Callback when we are connected to MQTT server
  * \param[in]       client: MQTT client
@@ -785,7 +2005,12 @@ mqtt_connected_cb(lwesp_mqtt_client_p client) {
     uint16_t rem_len, len_id, len_pass = 0, len_user = 0, len_will_topic = 0, len_will_message = 0;
     uint8_t flags = 0;
 
-    flags |= MQTT_FLAG_CONNECT_CLEAN_SESSION;   /* Start as clean session */
+#if LWESP_CFG_MQTT_SESSION_STORE
+    if (client->session_fn == NULL)             /* Resume stored session when available */
+#endif /* LWESP_CFG_MQTT_SESSION_STORE */
+    {
+        flags |= MQTT_FLAG_CONNECT_CLEAN_SESSION;   /* Start as clean session */
+    }
 
     /*
      * Remaining length consist of fixed header data
@@ -794,6 +2019,20 @@ mqtt_connected_cb(lwesp_mqtt_client_p client) {
      * Minimum length consists of 2 + "MQTT" (4) + protocol_level (1) + flags (1) + keep_alive (2)
      */
     rem_len = 10;                               /* Set remaining length of fixed header */
+#if LWESP_CFG_MQTT_V5
+    client->v5 = client->info->version == 5;
+    client->srv_recv_max = 0xFFFF;              /* Server defaults, until received in CONNACK */
+    client->srv_max_packet = 0;
+#if LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0
+    client->alias_max = client->alias_next = 0;
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(client->alias); ++i) {
+        client->alias[i].len = 0;
+    }
+#endif /* LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 0 */
+    if (client->v5) {
+        ++rem_len;                              /* Empty connect properties */
+    }
+#endif /* LWESP_CFG_MQTT_V5 */
 
     len_id = LWESP_U16(strlen(client->info->id));   /* Get cliend ID length */
     rem_len += len_id + 2;                      /* Add client id length including length entries */
@@ -807,6 +2046,9 @@ mqtt_connected_cb(lwesp_mqtt_client_p client) {
 
         rem_len += len_will_topic + 2;          /* Add will topic parameter */
         rem_len += len_will_message + 2;        /* Add will message parameter */
+        if (MQTT_IS_V5(client)) {
+            ++rem_len;                          /* Empty will properties */
+        }
     }
 
     if (client->info->user != NULL) {           /* Check for username */
@@ -830,11 +2072,17 @@ mqtt_connected_cb(lwesp_mqtt_client_p client) {
     /* Write everything to output buffer */
     write_fixed_header(client, MQTT_MSG_TYPE_CONNECT, 0, (lwesp_mqtt_qos_t)0, 0, rem_len);
     write_string(client, "MQTT", 4);            /* Protocol name */
-    write_u8(client, 4);                        /* Protocol version */
+    write_u8(client, MQTT_IS_V5(client) ? 5 : 4);   /* Protocol version */
     write_u8(client, flags);                    /* Flags for CONNECT message */
     write_u16(client, client->info->keep_alive);/* Keep alive timeout in units of seconds */
+    if (MQTT_IS_V5(client)) {
+        write_u8(client, 0);                    /* Connect properties */
+    }
     write_string(client, client->info->id, len_id); /* This is client ID string */
     if (flags & MQTT_FLAG_CONNECT_WILL) {       /* Check for will topic */
+        if (MQTT_IS_V5(client)) {
+            write_u8(client, 0);                /* Will properties */
+        }
         write_string(client, client->info->will_topic, len_will_topic); /* Write topic to packet */
         write_string(client, client->info->will_message, len_will_message); /* Write message to packet */
     }
@@ -847,8 +2095,9 @@ mqtt_connected_cb(lwesp_mqtt_client_p client) {
 
     client->parser_state = MQTT_PARSER_STATE_INIT;  /* Reset parser state */
 
-    client->poll_time = 0;                      /* Reset kep alive time */
+    client->poll_time = lwesp_sys_now();        /* Reset kep alive time */
     client->conn_state = LWESP_MQTT_CONNECTING; /* MQTT is connecting to server */
+    mqtt_keep_alive_start(client);              /* Start keep-alive timer */
 
     send_data(client);                          /* Flush and send the actual data */
 }
@@ -875,12 +2124,32 @@ mqtt_data_recv_cb(lwesp_mqtt_client_p client, lwesp_pbuf_p pbuf) {
  */
 static uint8_t
 mqtt_data_sent_cb(lwesp_mqtt_client_p client, size_t sent_len, uint8_t successful) {
-    lwesp_mqtt_request_t* request;
+    lwesp_mqtt_tx_send_t* s;
 
-    client->is_sending = 0;                     /* We are not sending anymore */
+    if (client->tx_send_cnt == 0) {             /* Send command was not started by client */
+        return 0;
+    }
+    s = &client->tx_send[client->tx_send_r];
+    client->tx_send_r = LWESP_U8((client->tx_send_r + 1) % LWESP_CFG_MQTT_MAX_SENDS);
+    --client->tx_send_cnt;
     client->sent_total += sent_len;
 
-    client->poll_time = 0;                      /* Reset kep alive time */
+    client->poll_time = lwesp_sys_now();        /* Reset kep alive time */
+
+    /*
+     * Release data of completed command even if send failed,
+     * to keep accounting in sync with commands still active
+     */
+#if LWESP_CFG_MQTT_PUBLISH_NOCOPY
+    if (s->ext) {                               /* Payload from user memory was sent */
+        client->ext_r = (client->ext_r + 1) % LWESP_ARRAYSIZE(client->ext);
+        --client->ext_cnt;
+        --client->ext_inflight;
+    }
+    client->tx_buff_sent += s->buff_len;
+#endif /* LWESP_CFG_MQTT_PUBLISH_NOCOPY */
+    client->tx_inflight -= s->buff_len;
+    lwesp_buff_skip(&client->tx_buff, s->buff_len); /* Skip buffer for sent data, only TX buffer part */
 
     /*
      * In case transmit was not successful,
@@ -894,73 +2163,31 @@ mqtt_data_sent_cb(lwesp_mqtt_client_p client, size_t sent_len, uint8_t successfu
         mqtt_close(client);
         return 0;
     }
-    lwesp_buff_skip(&client->tx_buff, sent_len);/* Skip buffer for actual sent data */
 
     /*
-     * Check pending publish requests without QoS because there is no confirmation received by server.
-     * Use technique to count number of bytes sent versus expected number of bytes sent before we ack request sent
-     *
-     * Requests without QoS have packet id set to 0
+     * Check pending publish packets without QoS because there is no confirmation received by server.
+     * Use technique to count number of bytes sent versus expected number of bytes sent before we ack packet sent
      */
-    while ((request = request_get_pending(client, 0)) != NULL) {
-        if (client->sent_total >= request->expected_sent_len) {
-            void* arg = request->arg;
-
-            request_delete(client, request);    /* Delete request and make space for next command */
-
-            /* Call published callback */
-            client->evt.type = LWESP_MQTT_EVT_PUBLISH;
-            client->evt.evt.publish.arg = arg;
-            client->evt.evt.publish.res = lwespOK;
-            client->evt_fn(client, &client->evt);
-        } else {
-            break;
-        }
-    }
+    qos0_mark_complete(client, 0);
 
+    mqtt_check_writable(client);                /* Move queued packets to TX buffer */
     send_data(client);                          /* Try to send more */
     return 1;
 }
 
 /**
  * \brief           Poll for client connection
- *                  Called every LWESP_CFG_CONN_POLL_INTERVAL ms when MQTT client TCP connection is established
+ *                  Called on every poll event when MQTT client TCP connection is established
  * \param[in]       client: MQTT client
  * \return          `1` on success, `0` otherwise
  */
 static uint8_t
 mqtt_poll_cb(lwesp_mqtt_client_p client) {
-    ++client->poll_time;
-
     if (client->conn_state == LWESP_MQTT_CONN_DISCONNECTING) {
         return 0;
     }
 
-    /*
-     * Check for keep-alive time if equal or greater than
-     * keep alive time. In that case, send packet
-     * to make sure we are still alive
-     */
-    if (client->info->keep_alive                /* Keep alive must be enabled */
-        /* Poll time is in units of LWESP_CFG_CONN_POLL_INTERVAL milliseconds,
-           while keep_alive is in units of seconds */
-        && (client->poll_time * LWESP_CFG_CONN_POLL_INTERVAL) >= (uint32_t)(client->info->keep_alive * 1000)) {
-
-        if (output_check_enough_memory(client, 0)) {/* Check if memory available in output buffer */
-            write_fixed_header(client, MQTT_MSG_TYPE_PINGREQ, 0, (lwesp_mqtt_qos_t)0, 0, 0);/* Write PINGREQ command to output buffer */
-            send_data(client);                  /* Force send data */
-            client->poll_time = 0;              /* Reset polling time */
-
-            LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE, "[MQTT] Sending PINGREQ packet\r\n");
-        } else {
-            LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE_WARNING, "[MQTT] No memory to send PINGREQ packet\r\n");
-        }
-    }
-
-    /*
-     * Process all active packets and
-     * check for timeout if there was no reply from MQTT server
-     */
+    /* Keep-alive is handled by dedicated timeout, see mqtt_keep_alive_timeout */
     return 1;
 }
 
@@ -985,6 +2212,10 @@ mqtt_closed_cb(lwesp_mqtt_client_p client, lwespr_t res, uint8_t forced) {
     client->evt.type = LWESP_MQTT_EVT_DISCONNECT;   /* Connection disconnected from server */
     client->evt_fn(client, &client->evt);       /* Notify upper layer about closed connection */
     client->conn = NULL;                        /* Reset connection handle */
+    if (client->keep_alive_to != 0) {           /* Stop keep-alive timer */
+        lwesp_timeout_cancel(client->keep_alive_to);
+        client->keep_alive_to = 0;
+    }
 
     /* Check all requests */
     while ((request = request_get_pending(client, -1)) != NULL) {
@@ -994,9 +2225,16 @@ mqtt_closed_cb(lwesp_mqtt_client_p client, lwespr_t res, uint8_t forced) {
         request_delete(client, request);        /* Delete request */
         request_send_err_callback(client, status, arg); /* Send error callback to user */
     }
-    LWESP_MEMSET(client->requests, 0x00, sizeof(client->requests));
-
-    client->is_sending = client->sent_total = client->written_total = 0;
+    qos0_mark_complete(client, 1);
+    requests_init(client);
+
+    client->sent_total = client->written_total = 0;
+    client->tx_send_r = client->tx_send_cnt = 0;
+    client->tx_inflight = 0;
+#if LWESP_CFG_MQTT_PUBLISH_NOCOPY
+    client->tx_buff_sent = 0;
+    client->ext_r = client->ext_cnt = client->ext_inflight = 0;
+#endif /* LWESP_CFG_MQTT_PUBLISH_NOCOPY */
     client->parser_state = MQTT_PARSER_STATE_INIT;
     lwesp_buff_reset(&client->tx_buff);         /* Reset TX buffer */
 
@@ -1087,6 +2325,10 @@ mqtt_conn_cb(lwesp_evt_t* evt) {
 
 /**
  * \brief           Allocate a new MQTT client structure
+ *
+ * With \ref LWESP_CFG_STATIC_ONLY, client is taken from static pool and buffer lengths
+ * may not exceed \ref LWESP_CFG_MQTT_CLIENT_TX_BUFF_LEN and \ref LWESP_CFG_MQTT_CLIENT_RX_BUFF_LEN
+ *
  * \param[in]       tx_buff_len: Length of raw data output buffer
  * \param[in]       rx_buff_len: Length of raw data input buffer
  * \return          Pointer to new allocated MQTT client structure or `NULL` on failure
@@ -1095,17 +2337,46 @@ lwesp_mqtt_client_t*
 lwesp_mqtt_client_new(size_t tx_buff_len, size_t rx_buff_len) {
     lwesp_mqtt_client_p client;
 
-    client = lwesp_mem_malloc(sizeof(*client));
+#if LWESP_CFG_STATIC_ONLY
+    lwesp_mqtt_client_pool_t* entry = NULL;
+
+    if (tx_buff_len > LWESP_CFG_MQTT_CLIENT_TX_BUFF_LEN || rx_buff_len > LWESP_CFG_MQTT_CLIENT_RX_BUFF_LEN) {
+        return NULL;
+    }
+    lwesp_core_lock();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(client_pool); ++i) {
+        if (!client_pool[i].used) {
+            entry = &client_pool[i];
+            entry->used = 1;
+            break;
+        }
+    }
+    lwesp_core_unlock();
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    client = &entry->client;
+    LWESP_MEMSET(client, 0x00, sizeof(*client));
+    client->conn_state = LWESP_MQTT_CONN_DISCONNECTED;
+    requests_init(client);
+    lwesp_buff_init_mem(&client->tx_buff, entry->tx_mem, tx_buff_len);
+    client->rx_buff_len = rx_buff_len;
+    client->rx_buff = entry->rx_mem;
+    return client;
+#else /* LWESP_CFG_STATIC_ONLY */
+    client = lwesp_mem_malloc_tag(sizeof(*client), LWESP_MEM_TAG_MQTT);
     if (client != NULL) {
         LWESP_MEMSET(client, 0x00, sizeof(*client));
         client->conn_state = LWESP_MQTT_CONN_DISCONNECTED;  /* Set to disconnected mode */
+        requests_init(client);
 
         if (!lwesp_buff_init(&client->tx_buff, tx_buff_len)) {
             lwesp_mem_free_s((void**)&client);
         }
         if (client != NULL) {
             client->rx_buff_len = rx_buff_len;
-            client->rx_buff = lwesp_mem_malloc(rx_buff_len);
+            client->rx_buff = lwesp_mem_malloc_tag(rx_buff_len, LWESP_MEM_TAG_MQTT);
             if (client->rx_buff == NULL) {
                 lwesp_buff_free(&client->tx_buff);
                 lwesp_mem_free_s((void**)&client);
@@ -1113,6 +2384,7 @@ lwesp_mqtt_client_new(size_t tx_buff_len, size_t rx_buff_len) {
         }
     }
     return client;
+#endif /* !LWESP_CFG_STATIC_ONLY */
 }
 
 /**
@@ -1123,9 +2395,15 @@ lwesp_mqtt_client_new(size_t tx_buff_len, size_t rx_buff_len) {
 void
 lwesp_mqtt_client_delete(lwesp_mqtt_client_p client) {
     if (client != NULL) {
+#if LWESP_CFG_STATIC_ONLY
+        lwesp_core_lock();
+        ((lwesp_mqtt_client_pool_t*)client)->used = 0;  /* Client is first member of pool entry */
+        lwesp_core_unlock();
+#else /* LWESP_CFG_STATIC_ONLY */
         lwesp_mem_free_s((void**)&client->rx_buff);
         lwesp_buff_free(&client->tx_buff);
         lwesp_mem_free_s((void**)&client);
+#endif /* !LWESP_CFG_STATIC_ONLY */
     }
 }
 
@@ -1196,6 +2474,48 @@ lwesp_mqtt_client_subscribe(lwesp_mqtt_client_p client, const char* topic, lwesp
     return sub_unsub(client, topic, qos, arg, 1) == 1 ? lwespOK : lwespERR; /* Subscribe to topic */
 }
 
+/**
+ * \brief           Subscribe to multiple MQTT topics with single packet
+ *
+ * Single \ref LWESP_MQTT_EVT_SUBSCRIBE event is sent when server acknowledges all topics.
+ * Use \ref lwesp_mqtt_client_evt_subscribe_get_return_code to get result for each topic.
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       topics: Array of topics with quality of service. Can be released after function returns
+ * \param[in]       count: Number of topics in array
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_mqtt_client_subscribe_many(lwesp_mqtt_client_p client, const lwesp_mqtt_sub_topic_t* topics, size_t count, void* arg) {
+    lwespr_t res = lwespERR;
+
+    LWESP_ASSERT("client != NULL", client != NULL);
+    LWESP_ASSERT("topics != NULL", topics != NULL);
+    LWESP_ASSERT("count > 0", count > 0);
+
+    lwesp_core_lock();
+    if (client->conn_state == LWESP_MQTT_CONNECTED
+        && mqtt_write_subscribe_many(client, topics, count, arg)) {
+        res = lwespOK;
+#if LWESP_CFG_MQTT_SESSION_STORE
+        if (client->session_fn != NULL) {       /* Keep subscription list in session store */
+            for (size_t i = 0; i < count; ++i) {
+                lwesp_mqtt_session_entry_t entry = {0};
+
+                entry.type = LWESP_MQTT_SESSION_TYPE_SUBSCRIPTION;
+                entry.topic = topics[i].topic;
+                entry.topic_len = LWESP_U16(strlen(topics[i].topic));
+                entry.qos = topics[i].qos;
+                client->session_fn(client, LWESP_MQTT_SESSION_OP_SAVE, &entry, 0);
+            }
+        }
+#endif /* LWESP_CFG_MQTT_SESSION_STORE */
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
 /**
  * \brief           Unsubscribe from MQTT topic
  * \param[in]       client: MQTT client
@@ -1209,19 +2529,20 @@ lwesp_mqtt_client_unsubscribe(lwesp_mqtt_client_p client, const char* topic, voi
 }
 
 /**
- * \brief           Publish a new message on specific topic
+ * \brief           Write publish packet to output buffer and start send
  * \param[in]       client: MQTT client
  * \param[in]       topic: Topic to send message to
  * \param[in]       payload: Message data
  * \param[in]       payload_len: Length of payload data
- * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwesp_mqtt_qos_t enumeration
+ * \param[in]       qos: Quality of service
  * \param[in]       retain: Retian parameter value
  * \param[in]       arg: User custom argument used in callback
+ * \param[in]       nocopy: Set to `1` to send payload from user memory instead of TX buffer
  * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
  */
-lwespr_t
-lwesp_mqtt_client_publish(lwesp_mqtt_client_p client, const char* topic, const void* payload,
-                        uint16_t payload_len, lwesp_mqtt_qos_t qos, uint8_t retain, void* arg) {
+static lwespr_t
+mqtt_publish(lwesp_mqtt_client_p client, const char* topic, const void* payload,
+             uint16_t payload_len, lwesp_mqtt_qos_t qos, uint8_t retain, void* arg, uint8_t nocopy) {
     lwespr_t res = lwespOK;
     lwesp_mqtt_request_t* request = NULL;
     uint32_t rem_len, raw_len;
@@ -1232,58 +2553,148 @@ lwesp_mqtt_client_publish(lwesp_mqtt_client_p client, const char* topic, const v
         return lwespERR;
     }
 
-    /*
-     * Calculate remaining length of packet
-     *
-     * rem_len = 2 (topic_len) + topic_len + 2 (pkt_idm only if qos > 0) + payload_len
-     */
-    rem_len = 2 + len_topic + (payload != NULL ? payload_len : 0);
-    if (qos_u8 > 0) {
-        rem_len += 2;
-    }
-
     lwesp_core_lock();
+    rem_len = mqtt_publish_rem_len(client, topic, len_topic, payload != NULL ? payload_len : 0, qos_u8);
     if (client->conn_state != LWESP_MQTT_CONNECTED) {
         res = lwespCLOSED;
-    } else if ((raw_len = output_check_enough_memory(client, rem_len)) != 0) {
-        pkt_id = qos_u8 > 0 ? create_packet_id(client) : 0; /* Create new packet ID */
-        request = request_create(client, pkt_id, arg);  /* Create request for packet */
-        if (request != NULL) {
+#if LWESP_CFG_MQTT_V5
+    } else if (client->v5 && client->srv_max_packet > 0 && mqtt_packet_len(rem_len) > client->srv_max_packet) {
+        LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE_WARNING, "[MQTT] Publish packet exceeds server maximum packet size\r\n");
+        res = lwespERR;
+#endif /* LWESP_CFG_MQTT_V5 */
+    } else {
+        raw_len = output_check_enough_memory_ext(client, rem_len, nocopy && payload != NULL ? payload_len : 0);
+        if (raw_len == 0 || !mqtt_inflight_available(client, qos_u8)
+            || (qos_u8 == 0 && !qos0_mark_available(client, arg))
+#if LWESP_CFG_MQTT_PUBLISH_NOCOPY
+            || (nocopy && payload != NULL && payload_len > 0 && client->ext_cnt >= LWESP_ARRAYSIZE(client->ext))
+#endif /* LWESP_CFG_MQTT_PUBLISH_NOCOPY */
+#if LWESP_CFG_MQTT_PUBLISH_BACKLOG
+            || client->backlog_cnt > 0          /* Keep order of packets */
+#endif /* LWESP_CFG_MQTT_PUBLISH_BACKLOG */
+           ) {
+            res = lwespERRMEM;
+#if LWESP_CFG_MQTT_PUBLISH_BACKLOG
+            if (!nocopy) {                      /* User memory cannot be queued */
+                res = mqtt_backlog_add(client, topic, len_topic, payload, payload_len, qos_u8, retain, rem_len, arg);
+            }
+#endif /* LWESP_CFG_MQTT_PUBLISH_BACKLOG */
+            if (res != lwespOK) {
+                LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE, "[MQTT] Not enough memory to publish message\r\n");
+            }
+        } else if (qos_u8 == 0) {
             /*
-             * Set expected number of bytes we should send before
-             * we can say that this packet was sent.
-             * Used in case QoS is set to 0 where packet notification
-             * is not received by server. In this case, wait
-             * number of bytes sent before notifying user about success
+             * There is no acknowledge from server for QoS 0,
+             * packet is sent when number of sent bytes reaches its watermark
              */
-            request->expected_sent_len = client->written_total + raw_len;
-
-            write_fixed_header(client, MQTT_MSG_TYPE_PUBLISH, 0, (lwesp_mqtt_qos_t)LWESP_MIN(qos_u8, LWESP_U8(LWESP_MQTT_QOS_EXACTLY_ONCE)), retain, rem_len);
-            write_string(client, topic, len_topic); /* Write topic string to packet */
-            if (qos_u8) {
-                write_u16(client, pkt_id);      /* Write packet ID */
-            }
-            if (payload != NULL && payload_len) {
-                write_data(client, payload, payload_len);   /* Write RAW topic payload */
+            qos0_mark_add(client, client->written_total + raw_len, arg);
+            mqtt_write_publish(client, 0, topic, len_topic, payload, payload_len, qos_u8, retain, rem_len, nocopy);
+            send_data(client);
+        } else {
+            pkt_id = create_packet_id(client);  /* Create new packet ID */
+            request = request_create(client, pkt_id, arg);  /* Create request for packet */
+            if (request != NULL) {
+                request->expected_sent_len = client->written_total + raw_len;
+                mqtt_write_publish(client, pkt_id, topic, len_topic, payload, payload_len, qos_u8, retain, rem_len, nocopy);
+                mqtt_publish_start(client, request);
+            } else {
+                LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE, "[MQTT] No free request available to publish message\r\n");
+                res = lwespERRMEM;
             }
-            request_set_pending(client, request);   /* Set request as pending waiting for server reply */
+        }
+        if (res == lwespERRMEM) {
+            client->writable_notify = 1;        /* Notify user when resources are available */
+        }
+    }
+    lwesp_core_unlock();
+    return res;
+}
 
-            send_data(client);                  /* Try to send data */
+/**
+ * \brief           Publish a new message on specific topic
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       payload: Message data
+ * \param[in]       payload_len: Length of payload data
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwesp_mqtt_qos_t enumeration
+ * \param[in]       retain: Retian parameter value
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_mqtt_client_publish(lwesp_mqtt_client_p client, const char* topic, const void* payload,
+                        uint16_t payload_len, lwesp_mqtt_qos_t qos, uint8_t retain, void* arg) {
+    return mqtt_publish(client, topic, payload, payload_len, qos, retain, arg, 0);
+}
 
-            LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE,
-                       "[MQTT] Pkt publish start. QoS: %d, pkt_id: %d\r\n", (int)qos_u8, (int)pkt_id);
-        } else {
-            LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE, "[MQTT] No free request available to publish message\r\n");
-            res = lwespERRMEM;
+/**
+ * \brief           Publish multiple messages back-to-back with single send
+ *
+ * Packets are written to TX buffer one after another and sent together once all are written.
+ * \ref LWESP_MQTT_EVT_PUBLISH event is sent for every queued message, with `arg` member of the message.
+ *
+ * \note            Writing stops at first message which cannot be queued, due to TX buffer or request limits.
+ *                  Use `queued` parameter to know how many messages were accepted
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       msgs: Array of messages. Topics and payloads can be released after function returns
+ * \param[in]       count: Number of messages in array
+ * \param[out]      queued: Output variable to save number of queued messages. Can be set to `NULL`
+ * \return          \ref lwespOK if all messages were queued, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_mqtt_client_publish_many(lwesp_mqtt_client_p client, const lwesp_mqtt_pub_msg_t* msgs, size_t count, size_t* queued) {
+    lwespr_t res = lwespOK;
+    size_t i;
+
+    LWESP_ASSERT("client != NULL", client != NULL);
+    LWESP_ASSERT("msgs != NULL", msgs != NULL);
+    LWESP_ASSERT("count > 0", count > 0);
+
+    lwesp_core_lock();
+    client->tx_hold = 1;                        /* Write all packets first */
+    for (i = 0; i < count; ++i) {
+        if ((res = mqtt_publish(client, msgs[i].topic, msgs[i].payload, msgs[i].len,
+                                msgs[i].qos, msgs[i].retain, msgs[i].arg, 0)) != lwespOK) {
+            break;
         }
-    } else {
-        LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_TRACE, "[MQTT] Not enough memory to publish message\r\n");
-        res = lwespERRMEM;
     }
+    client->tx_hold = 0;
+    send_data(client);                          /* Send all written packets at once */
     lwesp_core_unlock();
+    if (queued != NULL) {
+        *queued = i;
+    }
     return res;
 }
 
+#if LWESP_CFG_MQTT_PUBLISH_NOCOPY || __DOXYGEN__
+
+/**
+ * \brief           Publish a new message on specific topic, without copying payload to TX buffer
+ *
+ * Only packet header and topic are written to TX buffer, payload is sent directly from user memory.
+ *
+ * \note            Payload memory must stay valid until \ref LWESP_MQTT_EVT_PUBLISH event is received
+ *                  with `arg` parameter of this call
+ *
+ * \param[in]       client: MQTT client
+ * \param[in]       topic: Topic to send message to
+ * \param[in]       payload: Message data
+ * \param[in]       payload_len: Length of payload data
+ * \param[in]       qos: Quality of service. This parameter can be a value of \ref lwesp_mqtt_qos_t enumeration
+ * \param[in]       retain: Retian parameter value
+ * \param[in]       arg: User custom argument used in callback
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_mqtt_client_publish_nocopy(lwesp_mqtt_client_p client, const char* topic, const void* payload,
+                               uint16_t payload_len, lwesp_mqtt_qos_t qos, uint8_t retain, void* arg) {
+    return mqtt_publish(client, topic, payload, payload_len, qos, retain, arg, 1);
+}
+
+#endif /* LWESP_CFG_MQTT_PUBLISH_NOCOPY || __DOXYGEN__ */
+
 /**
  * \brief           Test if client is connected to server and accepted to MQTT protocol
  * \note            Function will return error if TCP is connected but MQTT not accepted
@@ -1301,6 +2712,33 @@ lwesp_mqtt_client_is_connected(lwesp_mqtt_client_p client) {
     return res;
 }
 
+#if LWESP_CFG_MQTT_SESSION_STORE || __DOXYGEN__
+
+/**
+ * \brief           Set session store callback for persistent session
+ *
+ * When set, client connects without clean session flag. Publish packets with QoS `1` or `2`
+ * are saved until acknowledged, subscriptions until unsubscribed, and both are sent again
+ * in single burst after server accepts next connection.
+ * Events for replayed packets have user argument set to `NULL`.
+ *
+ * \note            Set callback before \ref lwesp_mqtt_client_connect is called
+ * \param[in]       client: MQTT client
+ * \param[in]       session_fn: Session store callback or `NULL` to use clean session
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_mqtt_client_set_session_fn(lwesp_mqtt_client_p client, lwesp_mqtt_session_fn session_fn) {
+    LWESP_ASSERT("client != NULL", client != NULL);
+
+    lwesp_core_lock();
+    client->session_fn = session_fn;
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_MQTT_SESSION_STORE || __DOXYGEN__ */
+
 /**
  * \brief           Set user argument on client
  * \param[in]       client: MQTT client handle
@@ -34,24 +34,65 @@
 #include "lwesp/apps/lwesp_mqtt_client_api.h"
 #include "lwesp/lwesp_mem.h"
 
+#if LWESP_CFG_STATIC_ONLY
+#error "MQTT client API allocates memory at runtime and cannot be used with LWESP_CFG_STATIC_ONLY!"
+#endif /* LWESP_CFG_STATIC_ONLY */
+
 /* Tracing debug message */
 #define LWESP_CFG_DBG_MQTT_API_TRACE              (LWESP_CFG_DBG_MQTT_API | LWESP_DBG_TYPE_TRACE)
 #define LWESP_CFG_DBG_MQTT_API_STATE              (LWESP_CFG_DBG_MQTT_API | LWESP_DBG_TYPE_STATE)
 #define LWESP_CFG_DBG_MQTT_API_TRACE_WARNING      (LWESP_CFG_DBG_MQTT_API | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING)
 #define LWESP_CFG_DBG_MQTT_API_TRACE_SEVERE       (LWESP_CFG_DBG_MQTT_API | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_SEVERE)
 
+/**
+ * \brief           MQTT API client group structure
+ */
+struct lwesp_mqtt_client_api_group {
+    lwesp_sys_mbox_t mbox;                      /*!< Received data mbox shared by all clients in group */
+    lwesp_mqtt_client_api_buf_t wakeup_buf;     /*!< Buffer written to mbox to wake up receiving thread */
+};
+
 /**
  * \brief           MQTT API client structure
  */
 struct lwesp_mqtt_client_api {
     lwesp_mqtt_client_p mc;                     /*!< MQTT client handle */
-    lwesp_sys_mbox_t rcv_mbox;                  /*!< Received data mbox */
+    lwesp_sys_mbox_t rcv_mbox;                  /*!< Received data mbox, used when client is not in group */
+    lwesp_sys_mbox_t* mbox;                     /*!< Received data mbox in use, own or group one */
+    lwesp_mqtt_client_api_group_p group;        /*!< Client group or `NULL` if not in group */
+    lwesp_mqtt_client_api_buf_t closed_buf;     /*!< Buffer written to group mbox on closed connection */
     lwesp_sys_sem_t sync_sem;                   /*!< Synchronization semaphore */
     lwesp_sys_mutex_t mutex;                    /*!< Mutex handle */
     uint8_t release_sem;                        /*!< Set to `1` to release semaphore */
     lwesp_mqtt_conn_status_t connect_resp;      /*!< Response when connecting to server */
     lwespr_t sub_pub_resp;                      /*!< Subscribe/Unsubscribe/Publish response */
-} lwesp_mqtt_client_api_t;
+    lwespr_t* sub_results;                      /*!< Per-topic results of pending subscribe, `NULL` if not used */
+    size_t sub_results_len;                     /*!< Number of entries in results array */
+    size_t pub_pending;                         /*!< Number of batched publish packets waiting for result */
+    lwesp_mqtt_client_api_recv_fn recv_fn;      /*!< Receive view callback, `NULL` if not used */
+    void* recv_fn_arg;                          /*!< User argument for receive view callback */
+    uint8_t closed_pending;                     /*!< Closed event was read together with packets and is reported by next receive */
+#if LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 || __DOXYGEN__
+    uint8_t* arena;                             /*!< Receive arena memory, allocated together with client */
+    size_t arena_head;                          /*!< Offset of next allocation */
+    size_t arena_tail;                          /*!< Offset of oldest allocated entry */
+    size_t arena_wrap;                          /*!< End of entries at the end of memory, when allocations wrapped to start */
+    size_t arena_cnt;                           /*!< Number of allocated entries */
+    uint8_t arena_wrapped;                      /*!< Set to `1` when new entries are allocated from start of memory */
+#endif /* LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 || __DOXYGEN__ */
+};
+
+#if LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 || __DOXYGEN__
+/**
+ * \brief           Receive arena entry header, followed by buffer memory
+ */
+typedef struct {
+    size_t len;                                 /*!< Length of entry including header */
+    uint8_t released;                           /*!< Set to `1` when buffer was freed by user */
+} mqtt_api_arena_hdr_t;
+
+#define MQTT_API_ARENA_HDR_LEN                  LWESP_MEM_ALIGN(sizeof(mqtt_api_arena_hdr_t))
+#endif /* LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 || __DOXYGEN__ */
 
 /**
  * \brief           Variable used as pointer for message queue when MQTT connection is closed
@@ -71,6 +112,135 @@ release_sem(lwesp_mqtt_client_api_p client) {
     }
 }
 
+#if LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 || __DOXYGEN__
+
+/**
+ * \brief           Allocate memory from client receive arena
+ * \note            Function must be called with core locked
+ * \param[in]       client: MQTT API client handle
+ * \param[in]       size: Number of bytes to allocate
+ * \return          Pointer to memory on success, `NULL` if there is no space
+ */
+static void*
+arena_alloc(lwesp_mqtt_client_api_p client, size_t size) {
+    mqtt_api_arena_hdr_t* hdr;
+    size_t len = MQTT_API_ARENA_HDR_LEN + LWESP_MEM_ALIGN(size), off;
+
+    if (client->arena_cnt == 0) {               /* Empty arena starts from beginning */
+        client->arena_head = client->arena_tail = 0;
+        client->arena_wrapped = 0;
+    }
+    if (!client->arena_wrapped) {
+        if (LWESP_CFG_MQTT_API_RX_ARENA_LEN - client->arena_head >= len) {
+            off = client->arena_head;
+        } else if (client->arena_tail >= len) { /* Wrap to start of memory */
+            client->arena_wrap = client->arena_head;
+            client->arena_wrapped = 1;
+            off = 0;
+        } else {
+            return NULL;
+        }
+    } else if (client->arena_tail - client->arena_head >= len) {
+        off = client->arena_head;
+    } else {
+        return NULL;
+    }
+    client->arena_head = off + len;
+    ++client->arena_cnt;
+
+    hdr = (void*)&client->arena[off];
+    hdr->len = len;
+    hdr->released = 0;
+    return (uint8_t*)hdr + MQTT_API_ARENA_HDR_LEN;
+}
+
+/**
+ * \brief           Release arena memory and reclaim all released entries from the oldest one
+ * \note            Function must be called with core locked
+ * \param[in]       client: MQTT API client handle
+ * \param[in]       mem: Memory returned by \ref arena_alloc
+ */
+static void
+arena_free(lwesp_mqtt_client_api_p client, void* mem) {
+    mqtt_api_arena_hdr_t* hdr = (void*)((uint8_t*)mem - MQTT_API_ARENA_HDR_LEN);
+
+    hdr->released = 1;
+    while (client->arena_cnt > 0) {
+        hdr = (void*)&client->arena[client->arena_tail];
+        if (!hdr->released) {
+            break;
+        }
+        client->arena_tail += hdr->len;
+        --client->arena_cnt;
+        if (client->arena_wrapped && client->arena_tail == client->arena_wrap) {
+            client->arena_tail = 0;
+            client->arena_wrapped = 0;
+        }
+    }
+}
+
+/**
+ * \brief           Check if buffer memory belongs to client receive arena
+ * \param[in]       p: Buffer to check
+ * \return          `1` if in arena, `0` otherwise
+ */
+static uint8_t
+arena_is_buf(lwesp_mqtt_client_api_buf_p p) {
+    return p->client != NULL && (uint8_t*)p >= p->client->arena
+           && (uint8_t*)p < p->client->arena + LWESP_CFG_MQTT_API_RX_ARENA_LEN;
+}
+
+#endif /* LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 || __DOXYGEN__ */
+
+/**
+ * \brief           Allocate zeroed memory for received buffer
+ *
+ * Memory is taken from client receive arena when there is space, from heap otherwise
+ *
+ * \param[in]       client: MQTT API client handle
+ * \param[in]       size: Number of bytes to allocate
+ * \return          Buffer on success, `NULL` otherwise
+ */
+static lwesp_mqtt_client_api_buf_p
+buf_alloc(lwesp_mqtt_client_api_p client, size_t size) {
+    lwesp_mqtt_client_api_buf_p buf;
+
+#if LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0
+    lwesp_core_lock();
+    buf = arena_alloc(client, size);
+    lwesp_core_unlock();
+    if (buf != NULL) {
+        LWESP_MEMSET(buf, 0x00, size);
+        return buf;
+    }
+#else /* LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 */
+    LWESP_UNUSED(client);
+#endif /* !(LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0) */
+    buf = lwesp_mem_calloc_tag(1, size, LWESP_MEM_TAG_MQTT);
+    return buf;
+}
+
+/**
+ * \brief           Release buffer memory and its packet buffer reference
+ * \note            Function must be called with core locked when arena is used
+ * \param[in]       p: Buffer to free
+ */
+static void
+buf_release(lwesp_mqtt_client_api_buf_p p) {
+#if LWESP_CFG_MQTT_API_ZERO_COPY
+    if (p->pbuf != NULL) {
+        lwesp_pbuf_free(p->pbuf);               /* Release packet buffer reference */
+    }
+#endif /* LWESP_CFG_MQTT_API_ZERO_COPY */
+#if LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0
+    if (arena_is_buf(p)) {
+        arena_free(p->client, p);
+        return;
+    }
+#endif /* LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 */
+    lwesp_mem_free(p);
+}
+
 /**
  * \brief           MQTT event callback function
  */
@@ -107,7 +277,7 @@ mqtt_evt(lwesp_mqtt_client_p client, lwesp_mqtt_evt_t* evt) {
         }
         case LWESP_MQTT_EVT_PUBLISH_RECV: {
             /* Check valid receive mbox */
-            if (lwesp_sys_mbox_isvalid(&api_client->rcv_mbox)) {
+            if (api_client->mbox != NULL && lwesp_sys_mbox_isvalid(api_client->mbox)) {
                 lwesp_mqtt_client_api_buf_p buf;
                 size_t size, buf_size, topic_size, payload_size;
 
@@ -122,30 +292,86 @@ mqtt_evt(lwesp_mqtt_client_p client, lwesp_mqtt_evt_t* evt) {
                 LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE,
                            "[MQTT API] New publish received on topic %.*s\r\n", (int)topic_len, topic);
 
+                /* Let user process packet in place */
+                if (api_client->recv_fn != NULL) {
+                    lwesp_mqtt_client_api_buf_t view;
+
+                    LWESP_MEMSET(&view, 0x00, sizeof(view));
+                    view.topic = (void*)topic;
+                    view.payload = (void*)payload;
+                    view.topic_len = topic_len;
+                    view.payload_len = payload_len;
+                    view.qos = qos;
+                    view.client = api_client;
+                    if ((buf = api_client->recv_fn(api_client, &view, api_client->recv_fn_arg)) != NULL) {
+                        if (!lwesp_sys_mbox_putnow(api_client->mbox, buf)) {
+                            LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE_WARNING,
+                                       "[MQTT API] Cannot put user buffer to queue\r\n");
+                        }
+                        break;
+                    }
+                }
+
+#if LWESP_CFG_MQTT_API_ZERO_COPY
+                /* Contiguous packet, keep reference to packet buffer instead of copy */
+                if (lwesp_mqtt_client_evt_publish_recv_get_pbuf(client, evt) != NULL) {
+                    size_t off = lwesp_mqtt_client_evt_publish_recv_get_pbuf_offset(client, evt);
+                    size_t hdr_len = (size_t)(payload - (const uint8_t*)topic);
+
+                    buf = buf_alloc(api_client, sizeof(*buf));
+                    if (buf != NULL) {
+                        buf->topic = (void*)topic;
+                        buf->payload = (void*)payload;
+                        buf->topic_len = topic_len;
+                        buf->payload_len = payload_len;
+                        buf->qos = qos;
+                        buf->client = api_client;
+
+                        /* Slice covers topic and payload only, rest of received chain may be released earlier */
+                        buf->pbuf = lwesp_pbuf_slice(lwesp_mqtt_client_evt_publish_recv_get_pbuf(client, evt), off - hdr_len, hdr_len + payload_len);
+                        if (buf->pbuf == NULL) {
+                            buf->pbuf = lwesp_mqtt_client_evt_publish_recv_get_pbuf(client, evt);
+                            lwesp_pbuf_ref(buf->pbuf);  /* Keep data valid until buffer is freed */
+                        }
+
+                        /* Write to receive queue */
+                        if (!lwesp_sys_mbox_putnow(api_client->mbox, buf)) {
+                            LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE_WARNING,
+                                       "[MQTT API] Cannot put new received MQTT publish to queue\r\n");
+                            lwesp_mqtt_client_api_buf_free(buf);
+                        }
+                    } else {
+                        LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE_WARNING,
+                                   "[MQTT API] Cannot allocate memory for packet buffer\r\n");
+                    }
+                    break;
+                }
+#endif /* LWESP_CFG_MQTT_API_ZERO_COPY */
+
                 /* Calculate memory sizes */
                 buf_size = LWESP_MEM_ALIGN(sizeof(*buf));
                 topic_size = LWESP_MEM_ALIGN(sizeof(*topic) * (topic_len + 1));
                 payload_size = LWESP_MEM_ALIGN(sizeof(*payload) * (payload_len + 1));
 
                 size = buf_size + topic_size + payload_size;
-                buf = lwesp_mem_malloc(size);
+                buf = buf_alloc(api_client, size);
                 if (buf != NULL) {
-                    LWESP_MEMSET(buf, 0x00, size);
                     buf->topic = (void*)((uint8_t*)buf + buf_size);
                     buf->payload = (void*)((uint8_t*)buf + buf_size + topic_size);
                     buf->topic_len = topic_len;
                     buf->payload_len = payload_len;
                     buf->qos = qos;
+                    buf->client = api_client;
 
                     /* Copy content to new memory */
                     LWESP_MEMCPY(buf->topic, topic, sizeof(*topic) * topic_len);
                     LWESP_MEMCPY(buf->payload, payload, sizeof(*payload) * payload_len);
 
                     /* Write to receive queue */
-                    if (!lwesp_sys_mbox_putnow(&api_client->rcv_mbox, buf)) {
+                    if (!lwesp_sys_mbox_putnow(api_client->mbox, buf)) {
                         LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE_WARNING,
                                    "[MQTT API] Cannot put new received MQTT publish to queue\r\n");
-                        lwesp_mem_free_s((void**)&buf);
+                        lwesp_mqtt_client_api_buf_free(buf);
                     }
                 } else {
                     LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE_WARNING,
@@ -156,18 +382,39 @@ mqtt_evt(lwesp_mqtt_client_p client, lwesp_mqtt_evt_t* evt) {
             break;
         }
         case LWESP_MQTT_EVT_PUBLISH: {
-            api_client->sub_pub_resp = lwesp_mqtt_client_evt_publish_get_result(client, evt);
+            lwespr_t res = lwesp_mqtt_client_evt_publish_get_result(client, evt);
 
             /* Print debug message */
             LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE,
-                       "[MQTT API] Publish event with response: %d\r\n",
-                       (int)api_client->sub_pub_resp);
+                       "[MQTT API] Publish event with response: %d\r\n", (int)res);
+
+            if (api_client->pub_pending > 0) {  /* Part of batch, argument points to result */
+                lwespr_t* res_ptr = lwesp_mqtt_client_evt_publish_get_argument(client, evt);
 
+                if (res_ptr != NULL) {
+                    *res_ptr = res;
+                }
+                if (res != lwespOK) {
+                    api_client->sub_pub_resp = res;
+                }
+                if (--api_client->pub_pending > 0) {
+                    break;                      /* Wait for all packets */
+                }
+            } else {
+                api_client->sub_pub_resp = res;
+            }
             release_sem(api_client);            /* Release semaphore */
             break;
         }
         case LWESP_MQTT_EVT_SUBSCRIBE: {
             api_client->sub_pub_resp = lwesp_mqtt_client_evt_subscribe_get_result(client, evt);
+            if (api_client->sub_results != NULL) {
+                size_t cnt = lwesp_mqtt_client_evt_subscribe_get_count(client, evt);
+
+                for (size_t i = 0; i < api_client->sub_results_len; ++i) {
+                    api_client->sub_results[i] = i < cnt && lwesp_mqtt_client_evt_subscribe_get_return_code(client, evt, i) < 3 ? lwespOK : lwespERR;
+                }
+            }
 
             /* Print debug message */
             LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE,
@@ -198,8 +445,8 @@ mqtt_evt(lwesp_mqtt_client_p client, lwesp_mqtt_evt_t* evt) {
                        "[MQTT API] Disconnect event\r\n");
 
             /* Write to receive mbox to wakeup receive thread */
-            if (is_accepted && lwesp_sys_mbox_isvalid(&api_client->rcv_mbox)) {
-                lwesp_sys_mbox_putnow(&api_client->rcv_mbox, &mqtt_closed);
+            if (is_accepted && api_client->mbox != NULL && lwesp_sys_mbox_isvalid(api_client->mbox)) {
+                lwesp_sys_mbox_putnow(api_client->mbox, api_client->group != NULL ? (void*)&api_client->closed_buf : (void*)&mqtt_closed);
             }
 
             release_sem(api_client);            /* Release semaphore */
@@ -211,26 +458,40 @@ mqtt_evt(lwesp_mqtt_client_p client, lwesp_mqtt_evt_t* evt) {
 }
 
 /**
- * \brief           Create new MQTT client API
+ * \brief           Create new MQTT client API with own or group receive queue
+ * \param[in]       group: Client group or `NULL` to create own receive queue
  * \param[in]       tx_buff_len: Maximal TX buffer for maximal packet length
  * \param[in]       rx_buff_len: Maximal RX buffer
  * \return          Client handle on success, `NULL` otherwise
  */
-lwesp_mqtt_client_api_p
-lwesp_mqtt_client_api_new(size_t tx_buff_len, size_t rx_buff_len) {
+static lwesp_mqtt_client_api_p
+mqtt_client_api_new(lwesp_mqtt_client_api_group_p group, size_t tx_buff_len, size_t rx_buff_len) {
     lwesp_mqtt_client_api_p client;
     size_t size;
 
     size = LWESP_MEM_ALIGN(sizeof(*client));    /* Get size of client itself */
+#if LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0
+    size += LWESP_CFG_MQTT_API_RX_ARENA_LEN;    /* Receive arena follows client structure */
+#endif /* LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 */
 
     /* Create client APi structure */
-    client = lwesp_mem_calloc(1, size);         /* Allocate client memory */
+    client = lwesp_mem_calloc_tag(1, size, LWESP_MEM_TAG_MQTT); /* Allocate client memory */
     if (client != NULL) {
+#if LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0
+        client->arena = (uint8_t*)client + LWESP_MEM_ALIGN(sizeof(*client));
+#endif /* LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 */
         /* Create MQTT raw client structure */
         client->mc = lwesp_mqtt_client_new(tx_buff_len, rx_buff_len);
         if (client->mc != NULL) {
-            /* Create receive mbox queue */
-            if (lwesp_sys_mbox_create(&client->rcv_mbox, 5)) {
+            /* Create receive mbox queue, unless group queue is used */
+            if (group != NULL) {
+                client->group = group;
+                client->mbox = &group->mbox;
+                client->closed_buf.client = client;
+            } else if (lwesp_sys_mbox_create(&client->rcv_mbox, 5)) {
+                client->mbox = &client->rcv_mbox;
+            }
+            if (client->mbox != NULL) {
                 /* Create synchronization semaphore */
                 if (lwesp_sys_sem_create(&client->sync_sem, 1)) {
                     /* Create mutex */
@@ -263,8 +524,39 @@ lwesp_mqtt_client_api_new(size_t tx_buff_len, size_t rx_buff_len) {
     return NULL;
 }
 
+/**
+ * \brief           Create new MQTT client API
+ * \param[in]       tx_buff_len: Maximal TX buffer for maximal packet length
+ * \param[in]       rx_buff_len: Maximal RX buffer
+ * \return          Client handle on success, `NULL` otherwise
+ */
+lwesp_mqtt_client_api_p
+lwesp_mqtt_client_api_new(size_t tx_buff_len, size_t rx_buff_len) {
+    return mqtt_client_api_new(NULL, tx_buff_len, rx_buff_len);
+}
+
+/**
+ * \brief           Create new MQTT client API in group with shared receive queue
+ *
+ * Received packets and closed events of all clients in group
+ * are read with \ref lwesp_mqtt_client_api_group_receive from single thread
+ *
+ * \param[in]       group: Client group created with \ref lwesp_mqtt_client_api_group_new
+ * \param[in]       tx_buff_len: Maximal TX buffer for maximal packet length
+ * \param[in]       rx_buff_len: Maximal RX buffer
+ * \return          Client handle on success, `NULL` otherwise
+ */
+lwesp_mqtt_client_api_p
+lwesp_mqtt_client_api_new_in_group(lwesp_mqtt_client_api_group_p group, size_t tx_buff_len, size_t rx_buff_len) {
+    if (group == NULL) {
+        return NULL;
+    }
+    return mqtt_client_api_new(group, tx_buff_len, rx_buff_len);
+}
+
 /**
  * \brief           Delete client from memory
+ * \note            Client in group must be deleted only after all its packets were read from group queue
  * \param[in]       client: MQTT API client handle
  */
 void
@@ -280,7 +572,7 @@ lwesp_mqtt_client_api_delete(lwesp_mqtt_client_api_p client) {
         lwesp_sys_mutex_delete(&client->mutex);
         lwesp_sys_mutex_invalid(&client->mutex);
     }
-    if (lwesp_sys_mbox_isvalid(&client->rcv_mbox)) {
+    if (client->group == NULL && lwesp_sys_mbox_isvalid(&client->rcv_mbox)) {
         void* d;
         while (lwesp_sys_mbox_getnow(&client->rcv_mbox, &d)) {
             if ((uint8_t*)d != (uint8_t*)&mqtt_closed) {
@@ -390,6 +682,49 @@ lwesp_mqtt_client_api_subscribe(lwesp_mqtt_client_api_p client, const char* topi
     return res;
 }
 
+/**
+ * \brief           Subscribe to multiple topics with single packet
+ * \param[in]       client: MQTT API client handle
+ * \param[in]       topics: Array of topics with quality of service
+ * \param[in]       count: Number of topics in array
+ * \param[out]      results: Optional array of `count` entries to write result for each topic.
+ *                      Set to `NULL` if not used
+ * \return          \ref lwespOK if all topics were accepted, member of \ref lwespr_t otherwise
+ */
+lwespr_t
+lwesp_mqtt_client_api_subscribe_many(lwesp_mqtt_client_api_p client, const lwesp_mqtt_sub_topic_t* topics,
+                                   size_t count, lwespr_t* results) {
+    lwespr_t res = lwespERR;
+
+    LWESP_ASSERT("client != NULL", client != NULL);
+    LWESP_ASSERT("topics != NULL", topics != NULL);
+    LWESP_ASSERT("count > 0", count > 0);
+
+    lwesp_sys_mutex_lock(&client->mutex);
+    lwesp_sys_sem_wait(&client->sync_sem, 0);
+    client->release_sem = 1;
+    client->sub_results = results;
+    client->sub_results_len = count;
+    if (results != NULL) {
+        for (size_t i = 0; i < count; ++i) {
+            results[i] = lwespERR;
+        }
+    }
+    if (lwesp_mqtt_client_subscribe_many(client->mc, topics, count, NULL) == lwespOK) {
+        lwesp_sys_sem_wait(&client->sync_sem, 0);
+        res = client->sub_pub_resp;
+    } else {
+        LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE_WARNING,
+                   "[MQTT API] Cannot subscribe to %d topics\r\n", (int)count);
+    }
+    client->sub_results = NULL;
+    client->release_sem = 0;
+    lwesp_sys_sem_release(&client->sync_sem);
+    lwesp_sys_mutex_unlock(&client->mutex);
+
+    return res;
+}
+
 /**
  * \brief           Unsubscribe from topic
  * \param[in]       client: MQTT API client handle
@@ -457,6 +792,71 @@ lwesp_mqtt_client_api_publish(lwesp_mqtt_client_api_p client, const char* topic,
     return res;
 }
 
+/**
+ * \brief           Publish multiple packets back-to-back and wait for all of them
+ *
+ * Packets are written to output buffer together and sent in single burst,
+ * function waits once for results of all packets.
+ *
+ * \param[in]       client: MQTT API client handle
+ * \param[in]       msgs: Array of messages to publish.
+ *                      `arg` member must be `NULL` or point to \ref lwespr_t variable to write result of message to
+ * \param[in]       count: Number of messages in array
+ * \return          \ref lwespOK if all messages were published, member of \ref lwespr_t otherwise
+ */
+lwespr_t
+lwesp_mqtt_client_api_publish_many(lwesp_mqtt_client_api_p client, const lwesp_mqtt_pub_msg_t* msgs, size_t count) {
+    lwespr_t res;
+    size_t queued;
+
+    LWESP_ASSERT("client != NULL", client != NULL);
+    LWESP_ASSERT("msgs != NULL", msgs != NULL);
+    LWESP_ASSERT("count > 0", count > 0);
+
+    for (size_t i = 0; i < count; ++i) {
+        if (msgs[i].arg != NULL) {
+            *(lwespr_t*)msgs[i].arg = lwespERR;
+        }
+    }
+
+    lwesp_sys_mutex_lock(&client->mutex);
+    lwesp_sys_sem_wait(&client->sync_sem, 0);
+    client->release_sem = 1;
+    client->sub_pub_resp = lwespOK;
+
+    /* Events are processed with core locked, pending count is valid before first event */
+    lwesp_core_lock();
+    res = lwesp_mqtt_client_publish_many(client->mc, msgs, count, &queued);
+    client->pub_pending = queued;
+    lwesp_core_unlock();
+
+    if (res != lwespOK) {
+        LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE_WARNING,
+                   "[MQTT API] Cannot publish %d packets, queued %d\r\n", (int)count, (int)queued);
+        for (size_t i = queued; i < count; ++i) {
+            if (msgs[i].arg != NULL) {
+                *(lwespr_t*)msgs[i].arg = res;
+            }
+        }
+    }
+    if (queued > 0) {
+        lwesp_sys_sem_wait(&client->sync_sem, 0);
+        if (client->pub_pending > 0) {          /* Woken up by disconnect */
+            res = lwespCLOSED;
+        } else if (res == lwespOK) {
+            res = client->sub_pub_resp;
+        }
+    }
+    lwesp_core_lock();
+    client->pub_pending = 0;                    /* Late events must not write to results anymore */
+    lwesp_core_unlock();
+    client->release_sem = 0;
+    lwesp_sys_sem_release(&client->sync_sem);
+    lwesp_sys_mutex_unlock(&client->mutex);
+
+    return res;
+}
+
 /**
  * \brief           Check if client MQTT connection is active
  * \param[in]       client: MQTT API client handle
@@ -491,8 +891,13 @@ lwesp_mqtt_client_api_receive(lwesp_mqtt_client_api_p client, lwesp_mqtt_client_
                             uint32_t timeout) {
     LWESP_ASSERT("client != NULL", client != NULL);
     LWESP_ASSERT("p != NULL", p != NULL);
+    LWESP_ASSERT("client->group == NULL", client->group == NULL);
 
     *p = NULL;
+    if (client->closed_pending) {               /* Closed event read by receive many call */
+        client->closed_pending = 0;
+        return lwespCLOSED;
+    }
 
     /* Get new entry from mbox */
     if (timeout == 0) {
@@ -514,11 +919,209 @@ lwesp_mqtt_client_api_receive(lwesp_mqtt_client_api_p client, lwesp_mqtt_client_
     return lwespOK;
 }
 
+/**
+ * \brief           Receive all pending packets, up to `max`, with single call
+ *
+ * Function waits for first packet up to `timeout` and then reads
+ * all packets already in receive queue without waiting.
+ * Buffers are released together with \ref lwesp_mqtt_client_api_buf_free_many
+ *
+ * \note            When connection closes after packets in queue,
+ *                  packets are returned first and \ref lwespCLOSED is returned by next receive call
+ * \param[in]       client: MQTT API client handle
+ * \param[out]      bufs: Array to write received buffers to
+ * \param[in]       max: Number of entries in `bufs` array
+ * \param[out]      cnt: Pointer to output variable with number of received buffers
+ * \param[in]       timeout: Maximal time to wait for first packet
+ * \return          \ref lwespOK on success, \ref lwespCLOSED if MQTT is closed, \ref lwespTIMEOUT on timeout
+ */
+lwespr_t
+lwesp_mqtt_client_api_receive_many(lwesp_mqtt_client_api_p client, lwesp_mqtt_client_api_buf_p* bufs,
+                                   size_t max, size_t* cnt, uint32_t timeout) {
+    lwesp_mqtt_client_api_buf_p p;
+    lwespr_t res;
+
+    LWESP_ASSERT("bufs != NULL", bufs != NULL);
+    LWESP_ASSERT("max > 0", max > 0);
+    LWESP_ASSERT("cnt != NULL", cnt != NULL);
+
+    *cnt = 0;
+    if ((res = lwesp_mqtt_client_api_receive(client, &bufs[0], timeout)) != lwespOK) {
+        return res;
+    }
+    for (*cnt = 1; *cnt < max && lwesp_sys_mbox_getnow(&client->rcv_mbox, (void**)&p); ++(*cnt)) {
+        if ((uint8_t*)p == (uint8_t*)&mqtt_closed) {
+            client->closed_pending = 1;         /* Report it with next call */
+            break;
+        }
+        bufs[*cnt] = p;
+    }
+    return lwespOK;
+}
+
 /**
  * \brief           Free buffer memory after usage
  * \param[in]       p: Buffer to free
  */
 void
 lwesp_mqtt_client_api_buf_free(lwesp_mqtt_client_api_buf_p p) {
-    lwesp_mem_free_s((void**)&p);
+    if (p == NULL) {
+        return;
+    }
+#if LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0
+    lwesp_core_lock();
+    buf_release(p);
+    lwesp_core_unlock();
+#else /* LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 */
+    buf_release(p);
+#endif /* !(LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0) */
+}
+
+/**
+ * \brief           Free more buffers after usage with single call
+ *
+ * Arena memory of all buffers is reclaimed at once, under single core lock
+ *
+ * \param[in]       bufs: Array of buffers, as returned by \ref lwesp_mqtt_client_api_receive_many.
+ *                      `NULL` entries are skipped
+ * \param[in]       cnt: Number of entries in `bufs` array
+ */
+void
+lwesp_mqtt_client_api_buf_free_many(lwesp_mqtt_client_api_buf_p* bufs, size_t cnt) {
+    if (bufs == NULL || cnt == 0) {
+        return;
+    }
+#if LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0
+    lwesp_core_lock();
+#endif /* LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 */
+    for (size_t i = 0; i < cnt; ++i) {
+        if (bufs[i] != NULL) {
+            buf_release(bufs[i]);
+            bufs[i] = NULL;
+        }
+    }
+#if LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0
+    lwesp_core_unlock();
+#endif /* LWESP_CFG_MQTT_API_RX_ARENA_LEN > 0 */
+}
+
+/**
+ * \brief           Set callback to process received packets before they are copied to new buffer
+ * \param[in]       client: MQTT API client handle
+ * \param[in]       fn: Receive view callback. Set to `NULL` to disable it
+ * \param[in]       arg: User argument passed to callback
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+lwespr_t
+lwesp_mqtt_client_api_set_recv_fn(lwesp_mqtt_client_api_p client, lwesp_mqtt_client_api_recv_fn fn, void* arg) {
+    LWESP_ASSERT("client != NULL", client != NULL);
+
+    lwesp_core_lock();
+    client->recv_fn = fn;
+    client->recv_fn_arg = arg;
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+/**
+ * \brief           Create new group of MQTT API clients with shared receive queue
+ * \param[in]       queue_len: Length of receive queue, shared by all clients in group
+ * \return          Group handle on success, `NULL` otherwise
+ */
+lwesp_mqtt_client_api_group_p
+lwesp_mqtt_client_api_group_new(size_t queue_len) {
+    lwesp_mqtt_client_api_group_p group;
+
+    group = lwesp_mem_calloc_tag(1, sizeof(*group), LWESP_MEM_TAG_MQTT);
+    if (group != NULL) {
+        if (!lwesp_sys_mbox_create(&group->mbox, queue_len > 0 ? queue_len : 5)) {
+            LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE_SEVERE,
+                       "[MQTT API] Cannot allocate group receive queue\r\n");
+            lwesp_mem_free_s((void**)&group);
+        }
+    } else {
+        LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE_SEVERE,
+                   "[MQTT API] Cannot allocate memory for group\r\n");
+    }
+    return group;
+}
+
+/**
+ * \brief           Delete group from memory
+ * \note            All clients in group must be deleted first
+ * \param[in]       group: Group handle
+ */
+void
+lwesp_mqtt_client_api_group_delete(lwesp_mqtt_client_api_group_p group) {
+    if (group == NULL) {
+        return;
+    }
+    if (lwesp_sys_mbox_isvalid(&group->mbox)) {
+        lwesp_mqtt_client_api_buf_p buf;
+        while (lwesp_sys_mbox_getnow(&group->mbox, (void**)&buf)) {
+            if (buf != &group->wakeup_buf && buf != &buf->client->closed_buf) {
+                lwesp_mqtt_client_api_buf_free(buf);
+            }
+        }
+        lwesp_sys_mbox_delete(&group->mbox);
+        lwesp_sys_mbox_invalid(&group->mbox);
+    }
+    lwesp_mem_free_s((void**)&group);
+}
+
+/**
+ * \brief           Receive next packet of any client in group in specific timeout time
+ * \param[in]       group: Group handle
+ * \param[out]      client: Pointer to output client handle, which received the packet or was closed
+ * \param[in]       p: Pointer to output buffer
+ * \param[in]       timeout: Maximal time to wait before function returns timeout
+ * \return          \ref lwespOK on success, \ref lwespCLOSED if MQTT of `client` is closed,
+ *                  \ref lwespTIMEOUT on timeout or wakeup with \ref lwesp_mqtt_client_api_group_wakeup
+ */
+lwespr_t
+lwesp_mqtt_client_api_group_receive(lwesp_mqtt_client_api_group_p group, lwesp_mqtt_client_api_p* client,
+                                  lwesp_mqtt_client_api_buf_p* p, uint32_t timeout) {
+    LWESP_ASSERT("group != NULL", group != NULL);
+    LWESP_ASSERT("client != NULL", client != NULL);
+    LWESP_ASSERT("p != NULL", p != NULL);
+
+    *p = NULL;
+    *client = NULL;
+
+    /* Get new entry from mbox */
+    if (timeout == 0) {
+        if (!lwesp_sys_mbox_getnow(&group->mbox, (void**)p)) {
+            return lwespTIMEOUT;
+        }
+    } else if (lwesp_sys_mbox_get(&group->mbox, (void**)p, timeout) == LWESP_SYS_TIMEOUT) {
+        return lwespTIMEOUT;
+    }
+    if (*p == &group->wakeup_buf) {             /* Woken up by application */
+        *p = NULL;
+        return lwespTIMEOUT;
+    }
+    *client = (*p)->client;
+
+    /* Check for MQTT closed event */
+    if (*p == &(*client)->closed_buf) {
+        LWESP_DEBUGF(LWESP_CFG_DBG_MQTT_API_TRACE,
+                   "[MQTT API] Closed event received from group queue\r\n");
+
+        *p = NULL;
+        return lwespCLOSED;
+    }
+    return lwespOK;
+}
+
+/**
+ * \brief           Wake up thread waiting in \ref lwesp_mqtt_client_api_group_receive
+ * \note            Function does not block and can be called from event callback
+ * \param[in]       group: Group handle
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+lwespr_t
+lwesp_mqtt_client_api_group_wakeup(lwesp_mqtt_client_api_group_p group) {
+    LWESP_ASSERT("group != NULL", group != NULL);
+
+    return lwesp_sys_mbox_putnow(&group->mbox, &group->wakeup_buf) ? lwespOK : lwespERRMEM;
 }
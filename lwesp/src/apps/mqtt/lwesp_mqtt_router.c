@@ -0,0 +1,320 @@
+/**
+ * \file            lwesp_mqtt_router.c
+ * \brief           MQTT topic filter router
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include "lwesp/apps/lwesp_mqtt_router.h"
+#include "lwesp/lwesp_mem.h"
+
+#if LWESP_CFG_STATIC_ONLY
+#error "MQTT router allocates memory at runtime and cannot be used with LWESP_CFG_STATIC_ONLY!"
+#endif /* LWESP_CFG_STATIC_ONLY */
+
+/**
+ * \brief           Single topic level of topic filter
+ */
+typedef struct lwesp_mqtt_router_node {
+    struct lwesp_mqtt_router_node* next;        /*!< Next node on the same level */
+    struct lwesp_mqtt_router_node* child;       /*!< First node on next level */
+    lwesp_mqtt_router_fn fn;                    /*!< Callback for filter ending at this node, `NULL` if none */
+    void* arg;                                  /*!< User argument for callback */
+    size_t len;                                 /*!< Length of level name, stored right after structure */
+} lwesp_mqtt_router_node_t;
+
+/* Get level name of node */
+#define NODE_NAME(n)                    ((const char*)((n) + 1))
+
+/* Check if node is single character wildcard */
+#define NODE_IS(n, c)                   ((n)->len == 1 && NODE_NAME(n)[0] == (c))
+
+/**
+ * \brief           Get length of first level in topic or filter
+ * \param[in]       str: Topic string at current position
+ * \param[in]       len: Number of remaining characters
+ * \return          Number of characters until next level separator
+ */
+static size_t
+level_len(const char* str, size_t len) {
+    const char* sep = memchr(str, '/', len);
+    return sep != NULL ? (size_t)(sep - str) : len;
+}
+
+/**
+ * \brief           Call node callback when set
+ * \param[in]       n: Node with filter
+ * \param[in]       topic: Received topic
+ * \param[in]       topic_len: Length of topic
+ * \param[in]       payload: Received payload
+ * \param[in]       payload_len: Length of payload
+ * \return          `1` if callback was called, `0` otherwise
+ */
+static size_t
+node_call(const lwesp_mqtt_router_node_t* n, const char* topic, size_t topic_len, const void* payload, size_t payload_len) {
+    if (n->fn != NULL) {
+        n->fn(topic, topic_len, payload, payload_len, n->arg);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Match topic level against list of nodes and dispatch matching filters
+ * \param[in]       n: First node on current level
+ * \param[in]       topic: Full topic
+ * \param[in]       topic_len: Length of topic
+ * \param[in]       pos: Position of current level in topic
+ * \param[in]       payload: Received payload
+ * \param[in]       payload_len: Length of payload
+ * \return          Number of called callbacks
+ */
+static size_t
+router_match(const lwesp_mqtt_router_node_t* n, const char* topic, size_t topic_len, size_t pos,
+             const void* payload, size_t payload_len) {
+    size_t len = level_len(&topic[pos], topic_len - pos), cnt = 0;
+    uint8_t last = pos + len >= topic_len;
+
+    /* Topics starting with `$` are not matched by wildcards on first level */
+    uint8_t no_wildcard = pos == 0 && topic[0] == '$';
+
+    for (; n != NULL; n = n->next) {
+        if (NODE_IS(n, '#')) {                  /* Matches all remaining levels */
+            if (!no_wildcard) {
+                cnt += node_call(n, topic, topic_len, payload, payload_len);
+            }
+        } else if ((NODE_IS(n, '+') && !no_wildcard)
+                   || (n->len == len && !strncmp(NODE_NAME(n), &topic[pos], len))) {
+            if (last) {
+                const lwesp_mqtt_router_node_t* c;
+
+                cnt += node_call(n, topic, topic_len, payload, payload_len);
+                for (c = n->child; c != NULL; c = c->next) {
+                    if (NODE_IS(c, '#')) {      /* "a/#" matches also "a" */
+                        cnt += node_call(c, topic, topic_len, payload, payload_len);
+                    }
+                }
+            } else {
+                cnt += router_match(n->child, topic, topic_len, pos + len + 1, payload, payload_len);
+            }
+        }
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Find node with level name in list
+ * \param[in]       list: Pointer to list head
+ * \param[in]       name: Level name
+ * \param[in]       len: Length of level name
+ * \return          Pointer to link pointing to found node or `NULL` if not found
+ */
+static lwesp_mqtt_router_node_t**
+node_find(lwesp_mqtt_router_node_t** list, const char* name, size_t len) {
+    for (; *list != NULL; list = &(*list)->next) {
+        if ((*list)->len == len && !strncmp(NODE_NAME(*list), name, len)) {
+            return list;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Free list of nodes with all children
+ * \param[in]       n: First node in list
+ */
+static void
+node_free_all(lwesp_mqtt_router_node_t* n) {
+    while (n != NULL) {
+        lwesp_mqtt_router_node_t* next = n->next;
+
+        node_free_all(n->child);
+        lwesp_mem_free(n);
+        n = next;
+    }
+}
+
+/**
+ * \brief           Remove filter from list of nodes and release unused nodes
+ * \param[in]       list: Pointer to list head on current level
+ * \param[in]       filter: Topic filter
+ * \param[in]       filter_len: Length of topic filter
+ * \param[in]       pos: Position of current level in filter
+ * \return          `1` if filter was found, `0` otherwise
+ */
+static uint8_t
+router_remove(lwesp_mqtt_router_node_t** list, const char* filter, size_t filter_len, size_t pos) {
+    lwesp_mqtt_router_node_t** link, *n;
+    size_t len = level_len(&filter[pos], filter_len - pos);
+    uint8_t found;
+
+    if ((link = node_find(list, &filter[pos], len)) == NULL) {
+        return 0;
+    }
+    n = *link;
+    if (pos + len >= filter_len) {
+        found = n->fn != NULL;
+        n->fn = NULL;
+    } else {
+        found = router_remove(&n->child, filter, filter_len, pos + len + 1);
+    }
+    if (n->fn == NULL && n->child == NULL) {    /* Node is not used anymore */
+        *link = n->next;
+        lwesp_mem_free(n);
+    }
+    return found;
+}
+
+/**
+ * \brief           Initialize empty router
+ * \param[in]       router: Router handle
+ */
+void
+lwesp_mqtt_router_init(lwesp_mqtt_router_t* router) {
+    if (router != NULL) {
+        router->root = NULL;
+    }
+}
+
+/**
+ * \brief           Remove all filters and release router memory
+ * \param[in]       router: Router handle
+ */
+void
+lwesp_mqtt_router_free(lwesp_mqtt_router_t* router) {
+    if (router != NULL) {
+        node_free_all(router->root);
+        router->root = NULL;
+    }
+}
+
+/**
+ * \brief           Add topic filter with callback to router
+ *
+ * Callback of existing filter is replaced with new one
+ *
+ * \param[in]       router: Router handle
+ * \param[in]       filter: Topic filter, may include `+` and `#` wildcards
+ * \param[in]       fn: Callback function called on matching topic
+ * \param[in]       arg: User argument for callback
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_mqtt_router_add(lwesp_mqtt_router_t* router, const char* filter, lwesp_mqtt_router_fn fn, void* arg) {
+    lwesp_mqtt_router_node_t** list, **link, *n = NULL;
+    size_t filter_len, pos, len;
+
+    LWESP_ASSERT("router != NULL", router != NULL);
+    LWESP_ASSERT("filter != NULL", filter != NULL);
+    LWESP_ASSERT("fn != NULL", fn != NULL);
+
+    /* Validate filter first, wildcard must use entire level and `#` must be last */
+    if ((filter_len = strlen(filter)) == 0) {
+        return lwespPARERR;
+    }
+    for (pos = 0;; pos += len + 1) {
+        len = level_len(&filter[pos], filter_len - pos);
+        if ((memchr(&filter[pos], '+', len) != NULL || memchr(&filter[pos], '#', len) != NULL)
+            && (len != 1 || (filter[pos] == '#' && pos + len < filter_len))) {
+            return lwespPARERR;
+        }
+        if (pos + len >= filter_len) {
+            break;
+        }
+    }
+
+    /* Find or create node for each level */
+    list = &router->root;
+    for (pos = 0;; pos += len + 1) {
+        len = level_len(&filter[pos], filter_len - pos);
+        if ((link = node_find(list, &filter[pos], len)) != NULL) {
+            n = *link;
+        } else {
+            n = lwesp_mem_malloc_tag(sizeof(*n) + len, LWESP_MEM_TAG_MQTT);
+            if (n == NULL) {
+                /* Release empty nodes created for previous levels of this filter */
+                if (pos > 0) {
+                    router_remove(&router->root, filter, pos - 1, 0);
+                }
+                return lwespERRMEM;
+            }
+            LWESP_MEMSET(n, 0x00, sizeof(*n));
+            n->len = len;
+            LWESP_MEMCPY((void*)(n + 1), &filter[pos], len);
+            n->next = *list;                    /* Add to the beginning of level list */
+            *list = n;
+        }
+        if (pos + len >= filter_len) {
+            break;
+        }
+        list = &n->child;
+    }
+    n->fn = fn;
+    n->arg = arg;
+    return lwespOK;
+}
+
+/**
+ * \brief           Remove topic filter from router
+ * \param[in]       router: Router handle
+ * \param[in]       filter: Topic filter as used on \ref lwesp_mqtt_router_add
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_mqtt_router_remove(lwesp_mqtt_router_t* router, const char* filter) {
+    size_t filter_len;
+
+    LWESP_ASSERT("router != NULL", router != NULL);
+    LWESP_ASSERT("filter != NULL", filter != NULL);
+
+    if ((filter_len = strlen(filter)) == 0) {
+        return lwespPARERR;
+    }
+    return router_remove(&router->root, filter, filter_len, 0) ? lwespOK : lwespERR;
+}
+
+/**
+ * \brief           Dispatch received message to callbacks of all matching filters
+ *
+ * Use it on \ref LWESP_MQTT_EVT_PUBLISH_RECV event or after \ref lwesp_mqtt_client_api_receive
+ *
+ * \param[in]       router: Router handle
+ * \param[in]       topic: Received topic, does not need to be null-terminated
+ * \param[in]       topic_len: Length of topic
+ * \param[in]       payload: Received payload
+ * \param[in]       payload_len: Length of payload
+ * \return          Number of called callbacks, `0` if no filter matches topic
+ */
+size_t
+lwesp_mqtt_router_dispatch(lwesp_mqtt_router_t* router, const char* topic, size_t topic_len, const void* payload, size_t payload_len) {
+    if (router == NULL || topic == NULL || topic_len == 0) {
+        return 0;
+    }
+    return router_match(router->root, topic, topic_len, 0, payload, payload_len);
+}
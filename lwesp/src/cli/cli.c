@@ -38,6 +38,8 @@
 
 static cli_commands_t cli_command_table[CLI_MAX_MODULES];
 static size_t num_of_modules;
+static const cli_command_t* cli_command_index[CLI_MAX_COMMANDS];    /* Commands of all modules, sorted by name */
+static size_t num_of_commands_total;
 
 static void cli_list(cli_printf cliprintf, int argc, char** argv);
 static void cli_help(cli_printf cliprintf, int argc, char** argv);
@@ -51,6 +53,30 @@ commands[] = {
     { "list",           "Lists available commands",                 cli_list },
 };
 
+/**
+ * \brief           Find first index entry with name not lower than input string
+ * \param[in]       str: String to compare with
+ * \param[in]       len: Number of characters to compare, entries with `str` prefix compare equal
+ * \param[in]       upper: Set to `true` to find first entry which is greater instead
+ * \return          Index in sorted command index
+ */
+static size_t
+cli_index_bound(const char* str, size_t len, bool upper) {
+    size_t low = 0, high = num_of_commands_total, mid;
+    int cmp;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        cmp = strncmp(cli_command_index[mid]->name, str, len);
+        if (cmp < 0 || (upper && cmp == 0)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
 /**
  * \brief           Find the CLI command that matches the input string
  * \param[in]       command: pointer to command string for which we are searching
@@ -58,13 +84,12 @@ commands[] = {
  */
 const cli_command_t*
 cli_lookup_command(char* command) {
-    uint32_t module_index, command_index;
-    for (module_index = 0; module_index < num_of_modules; ++module_index) {
-        for (command_index = 0; command_index < cli_command_table[module_index].num_of_commands; ++command_index) {
-            if (!strcmp(command, cli_command_table[module_index].commands[command_index].name)) {
-                return &cli_command_table[module_index].commands[command_index];
-            }
-        }
+    size_t index;
+
+    /* First registered command wins on duplicate names, it is first in index */
+    index = cli_index_bound(command, strlen(command) + 1, false);
+    if (index < num_of_commands_total && !strcmp(command, cli_command_index[index]->name)) {
+        return cli_command_index[index];
     }
     return NULL;
 }
@@ -79,52 +104,38 @@ cli_lookup_command(char* command) {
 void
 cli_tab_auto_complete(cli_printf cliprintf, char* cmd_buffer, uint32_t* cmd_pos, bool print_options) {
     const char* matched_command = NULL;
-    uint32_t module_index, command_index;
-    uint32_t num_of_matched_commands = 0;
+    const char* last_command;
     uint32_t common_command_len = 0;
-
-    for (module_index = 0; module_index < num_of_modules; ++module_index) {
-        for (command_index = 0; command_index < cli_command_table[module_index].num_of_commands; ++command_index) {
-            const cli_command_t* command = &cli_command_table[module_index].commands[command_index];
-            if (!strncmp(cmd_buffer, cli_command_table[module_index].commands[command_index].name, *cmd_pos)) {
-                /* Found a new command which matches the string */
-                if (num_of_matched_commands == 0) {
-                    /*
-                     * Save the first match for later tab completion in case
-                     * print_option is true (double tab)
-                     */
-                    matched_command = command->name;
-                    common_command_len = strlen(matched_command);
-                } else {
-                    /*
-                     * More then one match
-                     * in case of print_option we need to print all options
-                     */
-                    if (print_options) {
-                        /*
-                         * Because we want to print help options only when we
-                         * have multiple matches, print also the first one.
-                         */
-                        if (num_of_matched_commands == 1) {
-                            cliprintf(CLI_NL"%s"CLI_NL, matched_command);
-                        }
-                        cliprintf("%s"CLI_NL, command->name);
-                    }
-
-                    /*
-                     * Find the common prefix of all the matched commands for
-                     * partial completion
-                     */
-                    uint32_t last_common_command_len = common_command_len;
-                    common_command_len = 0;
-                    while (matched_command[common_command_len] == command->name[common_command_len]
-                           && matched_command[common_command_len] != '\0'
-                           && command->name[common_command_len] != '\0'
-                           && common_command_len < last_common_command_len) {
-                        ++common_command_len;
-                    }
+    size_t first, last;
+
+    /* Commands with typed prefix are in single range of sorted index */
+    first = cli_index_bound(cmd_buffer, *cmd_pos, false);
+    last = cli_index_bound(cmd_buffer, *cmd_pos, true);
+    if (first < last) {
+        matched_command = cli_command_index[first]->name;
+        common_command_len = strlen(matched_command);
+
+        if (last - first > 1) {
+            /*
+             * More then one match
+             * in case of print_option we need to print all options
+             */
+            if (print_options) {
+                cliprintf(CLI_NL);
+                for (size_t i = first; i < last; ++i) {
+                    cliprintf("%s"CLI_NL, cli_command_index[i]->name);
                 }
-                ++num_of_matched_commands;
+            }
+
+            /*
+             * Common prefix of first and last command in sorted range
+             * is common prefix of all matched commands
+             */
+            last_command = cli_command_index[last - 1]->name;
+            common_command_len = 0;
+            while (matched_command[common_command_len] == last_command[common_command_len]
+                   && matched_command[common_command_len] != '\0') {
+                ++common_command_len;
             }
         }
     }
@@ -132,8 +143,8 @@ cli_tab_auto_complete(cli_printf cliprintf, char* cmd_buffer, uint32_t* cmd_pos,
     /* Do the full/partial tab completion */
     if (matched_command != NULL) {
         strncpy(cmd_buffer, matched_command, common_command_len);
+        cmd_buffer[common_command_len] = '\0';
         *cmd_pos = strlen(cmd_buffer);
-        cmd_buffer[*cmd_pos] = '\0';
         cliprintf("\r"CLI_PROMPT"%s", cmd_buffer);
     }
 }
@@ -150,6 +161,10 @@ cli_register_commands(const cli_command_t* commands, size_t num_of_commands) {
         printf("Exceeded the maximum number of CLI modules\n\r");
         return false;
     }
+    if (num_of_commands_total + num_of_commands > CLI_MAX_COMMANDS) {
+        printf("Exceeded the maximum number of CLI commands\n\r");
+        return false;
+    }
 
     /*
      * Warning: Not threadsafe!
@@ -159,6 +174,15 @@ cli_register_commands(const cli_command_t* commands, size_t num_of_commands) {
     cli_command_table[num_of_modules].num_of_commands = num_of_commands;
     ++num_of_modules;
 
+    /* Insert to sorted index, after existing commands with equal name */
+    for (size_t i = 0; i < num_of_commands; ++i) {
+        size_t pos = cli_index_bound(commands[i].name, strlen(commands[i].name) + 1, true);
+
+        memmove(&cli_command_index[pos + 1], &cli_command_index[pos], (num_of_commands_total - pos) * sizeof(cli_command_index[0]));
+        cli_command_index[pos] = &commands[i];
+        ++num_of_commands_total;
+    }
+
     return true;
 }
 
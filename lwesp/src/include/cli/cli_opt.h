@@ -90,6 +90,13 @@ extern "C" {
 #define CLI_MAX_MODULES             16
 #endif
 
+/**
+ * \brief           Max commands of all modules in sorted lookup index
+ */
+#ifndef CLI_MAX_COMMANDS
+#define CLI_MAX_COMMANDS            64
+#endif
+
 /**
  * \}
  */
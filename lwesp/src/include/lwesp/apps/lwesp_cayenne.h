@@ -69,6 +69,54 @@ extern "C" {
 #define LWESP_CAYENNE_PORT                        1883
 #endif
 
+/**
+ * \brief           Number of topics cached in Cayenne handle for batched publish
+ *
+ * It is also maximal number of messages sent in single burst
+ */
+#ifndef LWESP_CAYENNE_TOPIC_CACHE_LEN
+#define LWESP_CAYENNE_TOPIC_CACHE_LEN             8
+#endif
+
+/**
+ * \brief           Maximal length of cached topic including NULL termination
+ */
+#ifndef LWESP_CAYENNE_TOPIC_LEN
+#define LWESP_CAYENNE_TOPIC_LEN                   128
+#endif
+
+/**
+ * \brief           Maximal payload length of command parsed directly in receive context
+ *
+ * Longer payloads are received to allocated buffer and parsed in Cayenne thread
+ */
+#ifndef LWESP_CAYENNE_RX_PAYLOAD_LEN
+#define LWESP_CAYENNE_RX_PAYLOAD_LEN              128
+#endif
+
+/**
+ * \brief           Delay in units of milliseconds before next connect attempt to server
+ */
+#ifndef LWESP_CAYENNE_RECONNECT_DELAY
+#define LWESP_CAYENNE_RECONNECT_DELAY             5000
+#endif
+
+/**
+ * \brief           Maximal time in units of milliseconds worker waits for event when all instances are connected
+ *
+ * New IP address and new instance wake up worker immediately
+ */
+#ifndef LWESP_CAYENNE_IDLE_TIMEOUT
+#define LWESP_CAYENNE_IDLE_TIMEOUT                60000
+#endif
+
+/**
+ * \brief           Length of receive queue shared by all Cayenne instances
+ */
+#ifndef LWESP_CAYENNE_WORKER_QUEUE_LEN
+#define LWESP_CAYENNE_WORKER_QUEUE_LEN            8
+#endif
+
 #define LWESP_CAYENNE_NO_CHANNEL                  0xFFFE/*!< No channel macro */
 #define LWESP_CAYENNE_ALL_CHANNELS                0xFFFF/*!< All channels macro */
 
@@ -141,6 +189,26 @@ typedef struct {
     } evt;                                      /*!< Event union */
 } lwesp_cayenne_evt_t;
 
+/**
+ * \brief           Channel value for batched publish
+ */
+typedef struct {
+    lwesp_cayenne_topic_t topic;                /*!< Cayenne topic */
+    uint16_t channel;                           /*!< Channel number */
+    const char* type;                           /*!< Data type, set to `NULL` if not used */
+    const char* unit;                           /*!< Data unit, set to `NULL` if not used */
+    const char* data;                           /*!< Data value string */
+} lwesp_cayenne_data_t;
+
+/**
+ * \brief           Cached topic string
+ */
+typedef struct {
+    lwesp_cayenne_topic_t topic;                /*!< Cayenne topic */
+    uint16_t channel;                           /*!< Channel number */
+    char str[LWESP_CAYENNE_TOPIC_LEN];          /*!< Built topic string, empty when entry is not used */
+} lwesp_cayenne_topic_cache_t;
+
 /**
  * \brief           Cayenne handle forward declaration
  */
@@ -166,13 +234,24 @@ typedef struct lwesp_cayenne {
     lwesp_cayenne_evt_t evt;                    /*!< Event handle */
     lwesp_cayenne_evt_fn evt_fn;                /*!< Event callback function */
 
-    lwesp_sys_thread_t thread;                  /*!< Cayenne thread handle */
-    lwesp_sys_sem_t sem;                        /*!< Sync semaphore handle */
+    struct lwesp_cayenne* next;                 /*!< Next instance served by worker */
+    uint8_t connected;                          /*!< Set to `1` when connected to server */
+
+    lwesp_cayenne_topic_cache_t topic_cache[LWESP_CAYENNE_TOPIC_CACHE_LEN]; /*!< Topics of batched publish */
+    size_t topic_cache_next;                    /*!< Next cache entry to replace */
+
+    char topic_prefix[LWESP_CAYENNE_TOPIC_LEN]; /*!< Precomputed `v1/<user>/things/<id>/` prefix of topics */
+    size_t topic_prefix_len;                    /*!< Length of topic prefix */
+    lwesp_mqtt_client_api_buf_t rx_buf;         /*!< Queue entry for message parsed in receive context */
+    lwesp_cayenne_msg_t rx_msg;                 /*!< Message parsed in receive context */
+    char rx_payload[LWESP_CAYENNE_RX_PAYLOAD_LEN];  /*!< Payload copy of message parsed in receive context */
+    uint8_t rx_busy;                            /*!< Set to `1` while parsed message waits for Cayenne thread */
 } lwesp_cayenne_t;
 
 lwespr_t    lwesp_cayenne_create(lwesp_cayenne_t* c, const lwesp_mqtt_client_info_t* client_info, lwesp_cayenne_evt_fn evt_fn);
 lwespr_t    lwesp_cayenne_subscribe(lwesp_cayenne_t* c, lwesp_cayenne_topic_t topic, uint16_t channel);
 lwespr_t    lwesp_cayenne_publish_data(lwesp_cayenne_t* c, lwesp_cayenne_topic_t topic, uint16_t channel, const char* type, const char* unit, const char* data);
+lwespr_t    lwesp_cayenne_publish_data_many(lwesp_cayenne_t* c, const lwesp_cayenne_data_t* data, size_t count, lwespr_t* results);
 lwespr_t    lwesp_cayenne_publish_float(lwesp_cayenne_t* c, lwesp_cayenne_topic_t topic, uint16_t channel, const char* type, const char* unit, float f);
 
 lwespr_t    lwesp_cayenne_publish_response(lwesp_cayenne_t* c, lwesp_cayenne_msg_t* msg, lwesp_cayenne_rlwesp_t resp, const char* message);
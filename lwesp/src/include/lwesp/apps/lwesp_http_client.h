@@ -0,0 +1,137 @@
+/**
+ * \file            lwesp_http_client.h
+ * \brief           HTTP client
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_APP_HTTP_CLIENT_H
+#define LWESP_HDR_APP_HTTP_CLIENT_H
+
+#include "lwesp/lwesp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWESP_APPS
+ * \defgroup        LWESP_APP_HTTP_CLIENT HTTP client
+ * \brief           HTTP/1.1 client with persistent connections
+ * \{
+ *
+ * Client is bound to single server. Requests are queued and executed on up to
+ * \ref LWESP_CFG_HTTP_CLIENT_MAX_CONNS connections, which are kept open between requests.
+ *
+ * Response is parsed incrementally as packet buffers arrive. Body is passed to user
+ * directly from received packet buffers with \ref LWESP_HTTP_CLIENT_EVT_BODY events,
+ * chunked transfer encoding is decoded, hence whole body is never buffered.
+ *
+ * \note            Events are called from stack processing thread with core locked.
+ *                  Callback may not call blocking stack functions
+ */
+
+struct lwesp_http_client;
+
+/**
+ * \brief           Pointer to HTTP client structure
+ */
+typedef struct lwesp_http_client* lwesp_http_client_p;
+
+/**
+ * \brief           HTTP client event types
+ */
+typedef enum {
+    LWESP_HTTP_CLIENT_EVT_HEADER,               /*!< Response header received */
+    LWESP_HTTP_CLIENT_EVT_HEADERS_DONE,         /*!< All response headers received, body follows */
+    LWESP_HTTP_CLIENT_EVT_BODY,                 /*!< Part of response body received */
+    LWESP_HTTP_CLIENT_EVT_DONE,                 /*!< Request finished, successfully or with an error */
+} lwesp_http_client_evt_type_t;
+
+/**
+ * \brief           HTTP client event
+ */
+typedef struct {
+    lwesp_http_client_evt_type_t type;          /*!< Event type */
+    void* arg;                                  /*!< User argument of request */
+    uint16_t status;                            /*!< Response status code, `0` until status line is received */
+    union {
+        struct {
+            const char* name;                   /*!< Header name, null-terminated string */
+            const char* value;                  /*!< Header value, null-terminated string */
+        } header;                               /*!< Header event. Use with \ref LWESP_HTTP_CLIENT_EVT_HEADER event */
+        struct {
+            int32_t content_length;             /*!< Body length in units of bytes, `-1` when not known in advance */
+        } headers_done;                         /*!< Headers done event. Use with \ref LWESP_HTTP_CLIENT_EVT_HEADERS_DONE event */
+        struct {
+            const void* data;                   /*!< Body data, valid only during callback */
+            size_t len;                         /*!< Length of body data in units of bytes */
+        } body;                                 /*!< Body event. Use with \ref LWESP_HTTP_CLIENT_EVT_BODY event */
+        struct {
+            lwespr_t res;                       /*!< \ref lwespOK when full response was received */
+        } done;                                 /*!< Request done event. Use with \ref LWESP_HTTP_CLIENT_EVT_DONE event */
+    } evt;                                      /*!< Event data */
+} lwesp_http_client_evt_t;
+
+/**
+ * \brief           HTTP client event callback function
+ * \param[in]       client: HTTP client
+ * \param[in]       evt: Event data
+ */
+typedef void (*lwesp_http_client_evt_fn)(lwesp_http_client_p client, const lwesp_http_client_evt_t* evt);
+
+/**
+ * \brief           HTTP request description
+ *
+ * Structure is copied on \ref lwesp_http_client_request,
+ * memory it points to must stay valid until \ref LWESP_HTTP_CLIENT_EVT_DONE event
+ */
+typedef struct {
+    const char* method;                         /*!< Request method. Set to `NULL` for `GET` */
+    const char* path;                           /*!< Path with query string. Set to `NULL` for `/` */
+    const char* headers;                        /*!< Additional headers, each of them terminated with `\r\n`. Set to `NULL` if not used */
+    const void* body;                           /*!< Request body. Set to `NULL` if not used */
+    size_t body_len;                            /*!< Length of request body in units of bytes */
+    lwesp_http_client_evt_fn evt_fn;            /*!< Callback function for events of request */
+    void* arg;                                  /*!< User custom argument */
+} lwesp_http_client_req_t;
+
+lwesp_http_client_p lwesp_http_client_new(const char* host, lwesp_port_t port, lwesp_conn_type_t type);
+lwespr_t    lwesp_http_client_delete(lwesp_http_client_p client);
+lwespr_t    lwesp_http_client_request(lwesp_http_client_p client, const lwesp_http_client_req_t* req);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWESP_HDR_APP_HTTP_CLIENT_H */
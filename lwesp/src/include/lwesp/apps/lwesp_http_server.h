@@ -77,6 +77,40 @@ extern "C" {
 #define HTTP_SSI_TAG_MAX_LEN                10
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` asynchronous file system read interface
+ *
+ * When enabled and \ref http_init_t.fs_read_start is set, files from user file system
+ * are read asynchronously into two buffers per connection.
+ * Next part of file is read while previous one is being sent.
+ * User completes every read with \ref lwesp_http_server_fs_read_done function
+ */
+#ifndef HTTP_FS_ASYNC
+#define HTTP_FS_ASYNC                       0
+#endif
+
+/**
+ * \brief           Size of each of two read buffers for asynchronous file system reads
+ */
+#ifndef HTTP_FS_ASYNC_BUFF_LEN
+#define HTTP_FS_ASYNC_BUFF_LEN              512
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` precompiled SSI templates
+ *
+ * When enabled, static SSI files are split into list of literal spans
+ * and tag positions, either offline (see \ref http_fs_file_table_t) or on first load.
+ * Literal spans are then written to connection with single write call
+ * and SSI callback is called only at tag boundaries.
+ *
+ * \note            Dynamic files from user file system are still
+ *                  processed with character based SSI parser
+ */
+#ifndef HTTP_SSI_PRECOMPILED
+#define HTTP_SSI_PRECOMPILED                0
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` support for POST request
  */
@@ -91,6 +125,35 @@ extern "C" {
 #define HTTP_MAX_URI_LEN                    256
 #endif
 
+/**
+ * \brief           Maximal length of single request header line, longer lines are truncated
+ *
+ * Request line and headers are parsed as they are received,
+ * only single line is kept in memory at a time
+ */
+#ifndef HTTP_MAX_HEADER_LINE_LEN
+#define HTTP_MAX_HEADER_LINE_LEN            64
+#endif
+
+/**
+ * \brief           Maximal number of request headers stored for \ref lwesp_http_server_get_header
+ *
+ * Set to `0` to disable storing of request headers.
+ * Headers used by server itself are always processed.
+ */
+#ifndef HTTP_MAX_REQ_HEADERS
+#define HTTP_MAX_REQ_HEADERS                0
+#endif
+
+/**
+ * \brief           Size of memory to store request header names and values, in units of bytes
+ *
+ * \note            Used only when \ref HTTP_MAX_REQ_HEADERS is greater than `0`
+ */
+#ifndef HTTP_REQ_HEADERS_BUFF_LEN
+#define HTTP_REQ_HEADERS_BUFF_LEN           256
+#endif
+
 /**
  * \brief           Maximal number of parameters in URI
  */
@@ -98,6 +161,18 @@ extern "C" {
 #define HTTP_MAX_PARAMS                     16
 #endif
 
+/**
+ * \brief           Size of CGI routing hash index in units of entries
+ *
+ * Index is built by \ref lwesp_http_server_init and makes CGI handler lookup
+ * independent of number of entries in \ref http_init_t.cgi table.
+ * Size must be greater than number of entries, otherwise linear search is used.
+ * Set to `0` to disable index
+ */
+#ifndef HTTP_CGI_HASH_SIZE
+#define HTTP_CGI_HASH_SIZE                  32
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` method not allowed response.
  *
@@ -124,6 +199,68 @@ extern "C" {
 #define HTTP_USE_DEFAULT_STATIC_FILES       1
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` hash index for static files lookup
+ *
+ * Index is built on first request and makes static file lookup
+ * independent of number of files in the table
+ */
+#ifndef HTTP_FS_STATIC_FILES_HASH
+#define HTTP_FS_STATIC_FILES_HASH           1
+#endif
+
+/**
+ * \brief           Number of user file system misses to remember
+ *
+ * Paths user `fs_open` function failed to open are not passed to it again,
+ * static files table is checked immediately instead.
+ * Set to `0` to disable negative cache.
+ *
+ * \note            Call \ref lwesp_http_server_fs_cache_reset when
+ *                  new files are added to user file system
+ */
+#ifndef HTTP_FS_NEG_CACHE_SIZE
+#define HTTP_FS_NEG_CACHE_SIZE              0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` zero-copy send of static files
+ *
+ * Static files without SSI tags are sent by reference directly from device memory,
+ * without copying any part of file to connection write buffer.
+ * Dynamic headers, if any, are flushed as separate packet before file content.
+ */
+#ifndef HTTP_USE_ZERO_COPY_STATIC
+#define HTTP_USE_ZERO_COPY_STATIC           0
+#endif
+
+/**
+ * \brief           Number of rendered CGI responses to keep in cache
+ *
+ * Output of SSI file returned by CGI handler is stored to packet buffer,
+ * keyed by request path and parameters. Next `GET` request with the same key
+ * within \ref http_cgi_t.cache_ttl is served from cache as static file,
+ * without calling CGI handler or processing SSI tags.
+ * Set to `0` to disable response cache.
+ *
+ * \note            Cached responses are sent by reference
+ *                  when \ref HTTP_USE_ZERO_COPY_STATIC is enabled
+ * \note            Call \ref lwesp_http_server_resp_cache_reset
+ *                  when data used by SSI tags changes
+ */
+#ifndef HTTP_RESP_CACHE_SIZE
+#define HTTP_RESP_CACHE_SIZE                0
+#endif
+
+/**
+ * \brief           Maximal length of rendered response body to store in cache
+ *
+ * Longer responses are sent to client normally and are not cached
+ */
+#ifndef HTTP_RESP_CACHE_MAX_LEN
+#define HTTP_RESP_CACHE_MAX_LEN             1024
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` dynamic headers support
  *
@@ -150,6 +287,164 @@ extern "C" {
 #define HTTP_DYNAMIC_HEADERS_CONTENT_LEN    1
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` pre-compressed (gzip) files support
+ *
+ * When client allows `gzip` in `Accept-Encoding` request header,
+ * server tries to open `.gz` sibling of requested file first (`/js/js.js.gz` for `/js/js.js`)
+ * and responds with `Content-Encoding: gzip` header.
+ *
+ * \note            Compressed files must not include response headers and SSI files are never compressed.
+ *                  In order to use this, \ref HTTP_DYNAMIC_HEADERS must be enabled
+ */
+#ifndef HTTP_USE_GZIP_FILES
+#define HTTP_USE_GZIP_FILES                 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` persistent connections (HTTP keep-alive)
+ *
+ * When enabled, connection is not closed after response with known content length
+ * if client did not request `Connection: close`. Requests pipelined
+ * on the same connection are processed one after another.
+ *
+ * \note            SSI responses have unknown length and always close connection.
+ *                  In order to use this, \ref HTTP_DYNAMIC_HEADERS and
+ *                  \ref HTTP_DYNAMIC_HEADERS_CONTENT_LEN must be enabled
+ */
+#ifndef HTTP_USE_KEEP_ALIVE
+#define HTTP_USE_KEEP_ALIVE                 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` chunked transfer encoding for SSI responses
+ *
+ * SSI output length is not known before it is processed.
+ * With chunked encoding, `HTTP/1.1` clients receive SSI output in chunks
+ * and connection may stay opened for next request with \ref HTTP_USE_KEEP_ALIVE
+ *
+ * \note            In order to use this, \ref HTTP_DYNAMIC_HEADERS must be enabled
+ */
+#ifndef HTTP_USE_CHUNKED
+#define HTTP_USE_CHUNKED                    0
+#endif
+
+/**
+ * \brief           Maximal chunk size in units of bytes for chunked responses
+ *
+ * Every connection with chunked response keeps buffer of this size
+ */
+#ifndef HTTP_CHUNK_BUFF_LEN
+#define HTTP_CHUNK_BUFF_LEN                 256
+#endif
+
+/**
+ * \brief           Idle time in units of milliseconds after which persistent connection is closed
+ *
+ * \note            Timeout is checked on connection poll event,
+ *                  see \ref LWESP_CFG_CONN_POLL_INTERVAL
+ */
+#ifndef HTTP_KEEP_ALIVE_TIMEOUT
+#define HTTP_KEEP_ALIVE_TIMEOUT             5000
+#endif
+
+/**
+ * \brief           Maximal number of connections served at the same time
+ *
+ * New connection above the limit is responded with constant `503 Service Unavailable`
+ * response and closed, without allocating HTTP state or opening any file.
+ * Persistent connection waiting for next request counts as served.
+ *
+ * Default value equal to \ref LWESP_CFG_MAX_CONNS disables admission control
+ */
+#ifndef HTTP_MAX_CONCURRENT_REQS
+#define HTTP_MAX_CONCURRENT_REQS            LWESP_CFG_MAX_CONNS
+#endif
+
+/**
+ * \brief           Maximal number of requests from single client IP address
+ *                  in \ref HTTP_RATE_LIMIT_WINDOW time window
+ *
+ * Requests above the limit are responded with constant `503 Service Unavailable` response
+ * and connection is closed. Set to `0` to disable rate limiting
+ */
+#ifndef HTTP_RATE_LIMIT_REQS
+#define HTTP_RATE_LIMIT_REQS                0
+#endif
+
+/**
+ * \brief           Rate limit time window in units of milliseconds
+ */
+#ifndef HTTP_RATE_LIMIT_WINDOW
+#define HTTP_RATE_LIMIT_WINDOW              1000
+#endif
+
+/**
+ * \brief           Number of client IP addresses tracked for rate limiting
+ *
+ * When table is full, client with the oldest time window is replaced
+ */
+#ifndef HTTP_RATE_LIMIT_CLIENTS
+#define HTTP_RATE_LIMIT_CLIENTS             4
+#endif
+
+/**
+ * \brief           Value of `Retry-After` header in `503 Service Unavailable` response, in units of seconds
+ */
+#ifndef HTTP_RETRY_AFTER
+#define HTTP_RETRY_AFTER                    "1"
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` ETag support for static files
+ *
+ * Static files (except SSI files) are responded with `ETag` header,
+ * calculated from file content on first request. When `If-None-Match` request header
+ * matches, `304 Not Modified` is sent without file content.
+ *
+ * \note            In order to use this, \ref HTTP_DYNAMIC_HEADERS must be enabled
+ */
+#ifndef HTTP_USE_ETAG
+#define HTTP_USE_ETAG                       0
+#endif
+
+/**
+ * \brief           Value of `Cache-Control` header sent together with `ETag` header
+ *
+ * Default value forces client to revalidate file on every request,
+ * which is cheap with `304 Not Modified` response
+ */
+#ifndef HTTP_CACHE_CONTROL
+#define HTTP_CACHE_CONTROL                  "no-cache"
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` `Range` request header support
+ *
+ * Static files and user files with \ref http_init_t.fs_seek callback (except SSI files)
+ * are responded with `206 Partial Content` when request includes single `bytes` range,
+ * which allows client to resume interrupted download.
+ * Unsatisfiable range is responded with `416 Range Not Satisfiable`
+ *
+ * \note            In order to use this, \ref HTTP_DYNAMIC_HEADERS and
+ *                  \ref HTTP_DYNAMIC_HEADERS_CONTENT_LEN must be enabled
+ */
+#ifndef HTTP_USE_RANGE
+#define HTTP_USE_RANGE                      0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` WebSocket support
+ *
+ * `GET` request with `Upgrade: websocket` header is switched to WebSocket protocol
+ * when \ref http_init_t.ws_connect_fn callback accepts it.
+ * Connection stays opened afterwards and server may push data
+ * to client with \ref lwesp_http_server_ws_send function
+ */
+#ifndef HTTP_USE_WEBSOCKET
+#define HTTP_USE_WEBSOCKET                  0
+#endif
+
 /**
  * \brief           Default server name for `Server: x` response dynamic header
  */
@@ -164,11 +459,62 @@ extern "C" {
 /**
  * \brief           Maximal number of headers we can control
  */
-#define HTTP_MAX_HEADERS                    4
+#if HTTP_USE_RANGE || __DOXYGEN__
+#define HTTP_MAX_HEADERS                    10
+#else
+#define HTTP_MAX_HEADERS                    8
+#endif /* HTTP_USE_RANGE || __DOXYGEN__ */
+
+#if HTTP_USE_GZIP_FILES && !HTTP_DYNAMIC_HEADERS
+#error "HTTP_USE_GZIP_FILES requires HTTP_DYNAMIC_HEADERS to be enabled!"
+#endif /* HTTP_USE_GZIP_FILES && !HTTP_DYNAMIC_HEADERS */
+
+#if HTTP_USE_CHUNKED && !HTTP_DYNAMIC_HEADERS
+#error "HTTP_USE_CHUNKED requires HTTP_DYNAMIC_HEADERS to be enabled!"
+#endif /* HTTP_USE_CHUNKED && !HTTP_DYNAMIC_HEADERS */
+
+#if HTTP_USE_ETAG && !HTTP_DYNAMIC_HEADERS
+#error "HTTP_USE_ETAG requires HTTP_DYNAMIC_HEADERS to be enabled!"
+#endif /* HTTP_USE_ETAG && !HTTP_DYNAMIC_HEADERS */
+
+#if HTTP_USE_RANGE && (!HTTP_DYNAMIC_HEADERS || !HTTP_DYNAMIC_HEADERS_CONTENT_LEN)
+#error "HTTP_USE_RANGE requires HTTP_DYNAMIC_HEADERS and HTTP_DYNAMIC_HEADERS_CONTENT_LEN to be enabled!"
+#endif /* HTTP_USE_RANGE && (!HTTP_DYNAMIC_HEADERS || !HTTP_DYNAMIC_HEADERS_CONTENT_LEN) */
+
+#if HTTP_USE_KEEP_ALIVE && (!HTTP_DYNAMIC_HEADERS || !HTTP_DYNAMIC_HEADERS_CONTENT_LEN)
+#error "HTTP_USE_KEEP_ALIVE requires HTTP_DYNAMIC_HEADERS and HTTP_DYNAMIC_HEADERS_CONTENT_LEN to be enabled!"
+#endif /* HTTP_USE_KEEP_ALIVE && (!HTTP_DYNAMIC_HEADERS || !HTTP_DYNAMIC_HEADERS_CONTENT_LEN) */
 
 struct http_state;
 struct http_fs_file;
 
+#if HTTP_USE_WEBSOCKET || __DOXYGEN__
+
+/**
+ * \brief           WebSocket frame opcode
+ */
+typedef enum {
+    HTTP_WS_OPCODE_CONT = 0x00,                 /*!< Continuation frame */
+    HTTP_WS_OPCODE_TEXT = 0x01,                 /*!< Text frame */
+    HTTP_WS_OPCODE_BINARY = 0x02,               /*!< Binary frame */
+    HTTP_WS_OPCODE_CLOSE = 0x08,                /*!< Connection close control frame */
+    HTTP_WS_OPCODE_PING = 0x09,                 /*!< Ping control frame */
+    HTTP_WS_OPCODE_PONG = 0x0A,                 /*!< Pong control frame */
+} http_ws_opcode_t;
+
+#endif /* HTTP_USE_WEBSOCKET || __DOXYGEN__ */
+
+/**
+ * \brief           Request method type
+ */
+typedef enum {
+    HTTP_METHOD_NOTALLOWED,                     /*!< HTTP method is not allowed */
+    HTTP_METHOD_GET,                            /*!< HTTP request method GET */
+#if HTTP_SUPPORT_POST || __DOXYGEN__
+    HTTP_METHOD_POST,                           /*!< HTTP request method POST */
+#endif /* HTTP_SUPPORT_POST || __DOXYGEN__ */
+} http_req_method_t;
+
 /**
  * \brief           HTTP parameters on http URI in format `?param1=value1&param2=value2&...`
  */
@@ -186,12 +532,32 @@ typedef struct {
  */
 typedef char*   (*http_cgi_fn)(http_param_t* params, size_t params_len);
 
+/**
+ * \brief           CGI callback function with lazy parameters access
+ *
+ * URI parameters are not parsed before call,
+ * handler gets them on demand with \ref lwesp_http_server_get_param
+ *
+ * \param[in]       hs: HTTP state
+ * \return          Function must return a new URI which is used later
+ *                  as response string, such as "/index.html" or similar
+ */
+typedef char*   (*http_cgi_req_fn)(struct http_state* hs);
+
 /**
  * \brief           CGI structure to register handlers on URI paths
  */
 typedef struct {
     const char* uri;                            /*!< URI path for CGI handler */
-    http_cgi_fn fn;                             /*!< Callback function to call when we have a CGI match */
+    http_cgi_fn fn;                             /*!< Callback function to call when we have a CGI match.
+                                                    Parameters are parsed to array before call */
+    http_req_method_t method;                   /*!< Request method handler is registered for.
+                                                    Set to \ref HTTP_METHOD_NOTALLOWED (default `0`) to match any method */
+    http_cgi_req_fn req_fn;                     /*!< Callback function used instead of `fn` when set */
+#if HTTP_RESP_CACHE_SIZE > 0 || __DOXYGEN__
+    uint32_t cache_ttl;                         /*!< Time rendered response stays in cache in units of milliseconds.
+                                                    Set to `0` (default) to render every request */
+#endif /* HTTP_RESP_CACHE_SIZE > 0 || __DOXYGEN__ */
 } http_cgi_t;
 
 /**
@@ -208,7 +574,11 @@ typedef lwespr_t  (*http_post_start_fn)(struct http_state* hs, const char* uri,
  * \note            This function may be called multiple time until content_length from \ref http_post_start_fn callback is not reached
  * \param[in]       hs: HTTP state
  * \param[in]       pbuf: Packet buffer wit reciveed data
- * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise.
+ *                  Return \ref lwespINPROG to defer acknowledge of received data
+ *                  until \ref lwesp_http_server_post_data_recved is called.
+ *                  With \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE enabled,
+ *                  no more data are read from device meanwhile and remote sender is throttled
  */
 typedef lwespr_t  (*http_post_data_fn)(struct http_state* hs, lwesp_pbuf_p pbuf);
 
@@ -219,6 +589,42 @@ typedef lwespr_t  (*http_post_data_fn)(struct http_state* hs, lwesp_pbuf_p pbuf)
  */
 typedef lwespr_t  (*http_post_end_fn)(struct http_state* hs);
 
+#if HTTP_USE_WEBSOCKET || __DOXYGEN__
+
+/**
+ * \brief           WebSocket upgrade request function prototype
+ * \param[in]       hs: HTTP state
+ * \param[in]       uri: Request URI
+ * \return          \ref lwespOK to switch connection to WebSocket protocol,
+ *                  member of \ref lwespr_t otherwise to process request as normal `GET` request
+ */
+typedef lwespr_t  (*http_ws_connect_fn)(struct http_state* hs, const char* uri);
+
+/**
+ * \brief           WebSocket message data function prototype
+ *
+ * Payload is unmasked in received packet buffer memory and passed to user as it arrives,
+ * message may therefore be split to multiple calls
+ *
+ * \param[in]       hs: HTTP state
+ * \param[in]       opcode: Message opcode, \ref HTTP_WS_OPCODE_TEXT or \ref HTTP_WS_OPCODE_BINARY
+ * \param[in]       data: Part of message payload
+ * \param[in]       len: Length of data in units of bytes
+ * \param[in]       last: Set to `1` when data are last part of message
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise to close connection
+ */
+typedef lwespr_t  (*http_ws_data_fn)(struct http_state* hs, http_ws_opcode_t opcode, const void* data, size_t len,
+                                     uint8_t last);
+
+/**
+ * \brief           WebSocket connection closed function prototype
+ * \note            HTTP state is not valid anymore after function returns
+ * \param[in]       hs: HTTP state
+ */
+typedef void    (*http_ws_close_fn)(struct http_state* hs);
+
+#endif /* HTTP_USE_WEBSOCKET || __DOXYGEN__ */
+
 /**
  * \brief           SSI (Server Side Includes) callback function prototype
  * \note            User can use server write functions to directly write to connection output
@@ -250,6 +656,31 @@ typedef uint8_t (*http_fs_open_fn)(struct http_fs_file* file, const char* path);
  */
 typedef uint32_t    (*http_fs_read_fn)(struct http_fs_file* file, void* buff, size_t btr);
 
+/**
+ * \brief           Start asynchronous file read function
+ *
+ * Function starts read operation and returns immediately.
+ * When read finishes, user must call \ref lwesp_http_server_fs_read_done,
+ * from any thread, with number of bytes read.
+ *
+ * \param[in]       file: File handle to read content
+ * \param[in]       buff: Buffer to read data to. It stays valid until read is finished
+ * \param[in]       btr: Number of bytes to read
+ * \return          `1` if read has been started, `0` otherwise
+ */
+typedef uint8_t (*http_fs_read_start_fn)(struct http_fs_file* file, void* buff, size_t btr);
+
+/**
+ * \brief           File system seek function
+ *
+ * Function is called before first read when only part of file is requested with `Range` header
+ *
+ * \param[in]       file: File handle to seek
+ * \param[in]       offset: New read position from beginning of file, in units of bytes
+ * \return          `1` on success, `0` otherwise to respond with entire file
+ */
+typedef uint8_t (*http_fs_seek_fn)(struct http_fs_file* file, uint32_t offset);
+
 /**
  * \brief           Close file callback function
  * \param[in]       file: File to close
@@ -279,18 +710,32 @@ typedef struct {
     http_fs_open_fn fs_open;                    /*!< Open file function callback */
     http_fs_read_fn fs_read;                    /*!< Read file function callback */
     http_fs_close_fn fs_close;                  /*!< Close file function callback */
+#if HTTP_USE_RANGE || __DOXYGEN__
+    http_fs_seek_fn fs_seek;                    /*!< Seek file function callback.
+                                                        Set to `NULL` to ignore `Range` header on user files */
+#endif /* HTTP_USE_RANGE || __DOXYGEN__ */
+#if HTTP_FS_ASYNC || __DOXYGEN__
+    http_fs_read_start_fn fs_read_start;        /*!< Start asynchronous read function callback.
+                                                        Set to `NULL` to use synchronous `fs_read` */
+#endif /* HTTP_FS_ASYNC || __DOXYGEN__ */
+
+    /* WebSocket related */
+#if HTTP_USE_WEBSOCKET || __DOXYGEN__
+    http_ws_connect_fn ws_connect_fn;           /*!< Upgrade request callback. Set to `NULL` to reject all upgrades */
+    http_ws_data_fn ws_data_fn;                 /*!< Message data callback function */
+    http_ws_close_fn ws_close_fn;               /*!< Connection closed callback function */
+#endif /* HTTP_USE_WEBSOCKET || __DOXYGEN__ */
 } http_init_t;
 
 /**
- * \brief           Request method type
+ * \brief           List of request parsing states
  */
 typedef enum {
-    HTTP_METHOD_NOTALLOWED,                     /*!< HTTP method is not allowed */
-    HTTP_METHOD_GET,                            /*!< HTTP request method GET */
-#if HTTP_SUPPORT_POST || __DOXYGEN__
-    HTTP_METHOD_POST,                           /*!< HTTP request method POST */
-#endif /* HTTP_SUPPORT_POST || __DOXYGEN__ */
-} http_req_method_t;
+    HTTP_REQ_PARSE_METHOD = 0x00,               /*!< Parsing request method */
+    HTTP_REQ_PARSE_URI = 0x01,                  /*!< Parsing request URI */
+    HTTP_REQ_PARSE_VERSION = 0x02,              /*!< Parsing HTTP version on request line */
+    HTTP_REQ_PARSE_HEADER = 0x03,               /*!< Parsing header lines */
+} http_req_parse_state_t;
 
 /**
  * \brief           List of SSI TAG parsing states
@@ -302,6 +747,20 @@ typedef enum {
     HTTP_SSI_STATE_END = 0x03,                  /*!< Parsing end of TAG */
 } http_ssi_state_t;
 
+/**
+ * \brief           Precompiled SSI segment
+ *
+ * Segment describes literal span of file data, optionally followed by SSI tag.
+ * All offsets are relative to beginning of file data, including headers part
+ * \sa              lwesp_http_server_ssi_compile
+ */
+typedef struct {
+    uint32_t offset;                            /*!< Literal span start offset */
+    uint32_t len;                               /*!< Literal span length in units of bytes */
+    uint32_t tag_offset;                        /*!< Tag name offset, without tag start string */
+    uint32_t tag_len;                           /*!< Tag name length. Set to `0` if segment has no tag */
+} http_ssi_segment_t;
+
 /**
  * \brief           HTTP file system table structure of static files in device memory
  */
@@ -309,6 +768,8 @@ typedef struct {
     const char* path;                           /*!< File path, ex. "/index.html" */
     const void* data;                           /*!< Pointer to file data */
     uint32_t size;                              /*!< Size of file in units of bytes */
+    const http_ssi_segment_t* ssi_segments;     /*!< Optional offline compiled SSI segments. Set to `NULL` to compile on first load */
+    size_t ssi_segments_count;                  /*!< Number of entries in SSI segments array */
 } http_fs_file_table_t;
 
 /**
@@ -324,6 +785,12 @@ typedef struct http_fs_file {
     const uint16_t* rem_open_files;             /*!< Pointer to number of remaining open files.
                                                         User can use value on this pointer to get number of other opened files */
     void* arg;                                  /*!< User custom argument, may be used for user specific file system object */
+
+#if HTTP_SSI_PRECOMPILED || __DOXYGEN__
+    const uint8_t* ssi_base;                    /*!< Start of file data SSI segment offsets are relative to */
+    const http_ssi_segment_t* ssi_segments;     /*!< Precompiled SSI segments or `NULL` if not available */
+    size_t ssi_segments_count;                  /*!< Number of SSI segments */
+#endif /* HTTP_SSI_PRECOMPILED || __DOXYGEN__ */
 } http_fs_file_t;
 
 /**
@@ -331,7 +798,6 @@ typedef struct http_fs_file {
  */
 typedef struct http_state {
     lwesp_conn_p conn;                          /*!< Connection handle */
-    lwesp_pbuf_p p;                             /*!< Header received pbuf chain */
 
     size_t conn_mem_available;                  /*!< Available memory in connection send queue */
     uint32_t written_total;                     /*!< Total number of bytes written into send buffer */
@@ -341,9 +807,27 @@ typedef struct http_state {
     uint8_t headers_received;                   /*!< Did we fully received a headers? */
     uint8_t process_resp;                       /*!< Process with response flag */
 
+    /* Request parsing */
+    http_req_parse_state_t req_parse_state;     /*!< Current request parsing state */
+    char req_uri[HTTP_MAX_URI_LEN + 1];         /*!< Request URI including parameters */
+    size_t req_uri_len;                         /*!< Length of request URI */
+    const char* req_params;                     /*!< Request URI parameters after `?` character, `NULL` if not present */
+    uint8_t req_uri_valid;                      /*!< Flag if request URI fits to memory */
+    uint8_t req_http11;                         /*!< Flag if request version is `HTTP/1.1` */
+    char hdr_line[HTTP_MAX_HEADER_LINE_LEN + 1];/*!< Currently parsed header line */
+    size_t hdr_line_len;                        /*!< Length of currently parsed header line */
+#if HTTP_MAX_REQ_HEADERS > 0 || __DOXYGEN__
+    http_param_t req_headers[HTTP_MAX_REQ_HEADERS]; /*!< Stored request headers */
+    size_t req_headers_cnt;                     /*!< Number of stored request headers */
+    char req_headers_buff[HTTP_REQ_HEADERS_BUFF_LEN];   /*!< Memory for stored header names and values */
+    size_t req_headers_buff_len;                /*!< Used memory in header storage */
+#endif /* HTTP_MAX_REQ_HEADERS > 0 || __DOXYGEN__ */
+
 #if HTTP_SUPPORT_POST || __DOXYGEN__
     uint32_t content_length;                    /*!< Total expected content length for request (on POST) (without headers) */
     uint32_t content_received;                  /*!< Content length received so far (POST request, without headers) */
+    uint8_t post_defer;                         /*!< Flag if user deferred acknowledge of last received data */
+    lwesp_pbuf_p post_unacked;                  /*!< Received data not yet acknowledged to stack */
 #endif /* HTTP_SUPPORT_POST || __DOXYGEN__ */
 
     http_fs_file_t rlwesp_file;                 /*!< Response file structure */
@@ -354,6 +838,29 @@ typedef struct http_state {
 
     void* arg;                                  /*!< User optional argument */
 
+#if HTTP_FS_ASYNC || __DOXYGEN__
+    uint8_t* fs_buff[2];                        /*!< Read buffers for asynchronous file reads */
+    uint32_t fs_buff_len[2];                    /*!< Number of valid bytes in each read buffer, `0` if empty */
+    uint8_t fs_next;                            /*!< Index of buffer with next file data in sequence */
+    uint8_t fs_pending;                         /*!< Index of buffer with read in progress plus `1`, `0` if none */
+    uint8_t fs_eof;                             /*!< Flag if entire file has been read */
+    uint8_t fs_closed;                          /*!< Flag if connection closed during read in progress */
+#endif /* HTTP_FS_ASYNC || __DOXYGEN__ */
+
+#if HTTP_USE_ZERO_COPY_STATIC || __DOXYGEN__
+    lwesp_conn_iov_t zc_iov;                    /*!< Static file segment, must stay valid until it is sent */
+#endif /* HTTP_USE_ZERO_COPY_STATIC || __DOXYGEN__ */
+#if HTTP_RESP_CACHE_SIZE > 0 || __DOXYGEN__
+    lwesp_pbuf_p resp_cache;                    /*!< Cache entry response is served from, `NULL` if not from cache */
+    lwesp_pbuf_p resp_cache_fill;               /*!< Cache entry being rendered, `NULL` if response is not cached */
+    size_t resp_cache_fill_len;                 /*!< Number of bytes written to cache entry being rendered */
+    size_t resp_cache_body;                     /*!< Offset of response body in cache entry being rendered */
+    uint32_t resp_cache_ttl;                    /*!< Time entry being rendered stays in cache */
+#endif /* HTTP_RESP_CACHE_SIZE > 0 || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SENDFILE || __DOXYGEN__
+    uint8_t sendfile;                           /*!< Flag if file is being sent with \ref lwesp_conn_sendfile */
+#endif /* LWESP_CFG_CONN_SENDFILE || __DOXYGEN__ */
+
 #if HTTP_DYNAMIC_HEADERS || __DOXYGEN__
     const char* dyn_hdr_strs[HTTP_MAX_HEADERS]; /*!< Pointer to constant strings for dynamic header outputs */
     size_t dyn_hdr_idx;                         /*!< Current header for processing on output */
@@ -361,8 +868,68 @@ typedef struct http_state {
 #if HTTP_DYNAMIC_HEADERS_CONTENT_LEN || __DOXYGEN__
     char dyn_hdr_cnt_len[30];                   /*!< Content length header response: "Content-Length: 0123456789\r\n" */
 #endif /* HTTP_DYNAMIC_HEADERS_CONTENT_LEN || __DOXYGEN__ */
+#if HTTP_USE_ETAG || __DOXYGEN__
+    char dyn_hdr_etag[24];                      /*!< ETag header response: "ETag: \"0123abcd\"\r\n" */
+    uint32_t if_none_match;                     /*!< ETag value from `If-None-Match` request header */
+    uint8_t has_if_none_match;                  /*!< Flag if request includes `If-None-Match` header */
+#endif /* HTTP_USE_ETAG || __DOXYGEN__ */
+#if HTTP_USE_RANGE || __DOXYGEN__
+    char dyn_hdr_range[56];                     /*!< Content range header response: "Content-Range: bytes 0-9/10\r\n" */
+    uint8_t range;                              /*!< Request `Range` header: `0` = none, `1` = first-last, `2` = suffix length */
+    uint32_t range_first;                       /*!< First byte position or suffix length of requested range */
+    uint32_t range_last;                        /*!< Last byte position of requested range */
+    uint8_t range_if;                           /*!< Flag if request includes `If-Range` header */
+#if HTTP_USE_ETAG || __DOXYGEN__
+    uint8_t has_if_range;                       /*!< Flag if `If-Range` header includes valid ETag */
+    uint32_t if_range;                          /*!< ETag value from `If-Range` request header */
+#endif /* HTTP_USE_ETAG || __DOXYGEN__ */
+#endif /* HTTP_USE_RANGE || __DOXYGEN__ */
 #endif /* HTTP_DYNAMIC_HEADERS || __DOXYGEN__ */
 
+#if HTTP_USE_KEEP_ALIVE || __DOXYGEN__
+    uint8_t keep_alive;                         /*!< Flag if connection stays opened after current response */
+    uint8_t ka_idle;                            /*!< Flag if persistent connection waits for next request */
+    uint32_t ka_idle_start;                     /*!< Time when connection became idle, in units of milliseconds */
+    uint8_t req_conn_hdr;                       /*!< Request `Connection` header: `0` = none, `1` = close, `2` = keep-alive */
+    lwesp_pbuf_p p_next;                        /*!< Pipelined data received during current response */
+#endif /* HTTP_USE_KEEP_ALIVE || __DOXYGEN__ */
+
+#if HTTP_USE_CHUNKED || __DOXYGEN__
+    uint8_t chunked;                            /*!< Flag if response uses chunked transfer encoding */
+    uint8_t chunked_done;                       /*!< Flag if last chunk has been written */
+    uint8_t chunk_buff[HTTP_CHUNK_BUFF_LEN];    /*!< Chunk data collected before write to connection */
+    size_t chunk_len;                           /*!< Number of bytes in chunk buffer */
+#endif /* HTTP_USE_CHUNKED || __DOXYGEN__ */
+
+#if HTTP_USE_GZIP_FILES || __DOXYGEN__
+    uint8_t accept_gzip;                        /*!< Flag if client accepts gzip content encoding */
+    uint8_t is_gzip;                            /*!< Flag if response file is gzip compressed sibling */
+#endif /* HTTP_USE_GZIP_FILES || __DOXYGEN__ */
+
+#if HTTP_RATE_LIMIT_REQS > 0 || __DOXYGEN__
+    uint8_t rejected;                           /*!< Flag if request has been rejected and received data are ignored */
+#endif /* HTTP_RATE_LIMIT_REQS > 0 || __DOXYGEN__ */
+
+#if HTTP_USE_WEBSOCKET || __DOXYGEN__
+    uint8_t ws_upgrade;                         /*!< Flag if request includes `Upgrade: websocket` header */
+    uint8_t ws_key_valid;                       /*!< Flag if request includes valid `Sec-WebSocket-Key` header */
+    char ws_accept[29];                         /*!< `Sec-WebSocket-Accept` value calculated from request key */
+    uint8_t ws;                                 /*!< Flag if connection has been switched to WebSocket protocol */
+    uint8_t ws_closing;                         /*!< Flag if connection is closing and received data are ignored */
+    uint8_t ws_close_sent;                      /*!< Flag if close frame has been sent to client */
+    uint8_t ws_hdr[14];                         /*!< Currently received frame header */
+    uint8_t ws_hdr_len;                         /*!< Number of received frame header bytes */
+    uint8_t ws_hdr_need;                        /*!< Number of frame header bytes required for current frame */
+    uint8_t ws_opcode;                          /*!< Current frame opcode */
+    uint8_t ws_fin;                             /*!< Flag if current frame is final frame of message */
+    uint8_t ws_msg_opcode;                      /*!< Opcode of currently received fragmented message, `0` if none */
+    uint8_t ws_mask[4];                         /*!< Current frame masking key */
+    uint8_t ws_mask_pos;                        /*!< Position in masking key for next payload byte */
+    uint32_t ws_payload_rem;                    /*!< Remaining payload bytes of current frame */
+    uint8_t ws_ctrl[125];                       /*!< Control frame payload */
+    uint8_t ws_ctrl_len;                        /*!< Length of control frame payload */
+#endif /* HTTP_USE_WEBSOCKET || __DOXYGEN__ */
+
     /* SSI tag parsing */
     uint8_t is_ssi;                             /*!< Flag if current request is SSI enabled */
     http_ssi_state_t ssi_state;                 /*!< Current SSI state when parsing SSI tags */
@@ -371,6 +938,10 @@ typedef struct http_state {
     size_t ssi_tag_buff_written;                /*!< Number of bytes written so far to output buffer in case tag is not valid */
     size_t ssi_tag_len;                         /*!< Length of SSI tag */
     size_t ssi_tag_process_more;                /*!< Set to `1` when we have to process tag multiple times */
+#if HTTP_SSI_PRECOMPILED || __DOXYGEN__
+    size_t ssi_seg_idx;                         /*!< Current precompiled SSI segment index */
+    uint32_t ssi_seg_pos;                       /*!< Number of literal bytes already written in current segment */
+#endif /* HTTP_SSI_PRECOMPILED || __DOXYGEN__ */
 } http_state_t;
 
 /**
@@ -385,6 +956,18 @@ typedef struct http_state {
 
 lwespr_t    lwesp_http_server_init(const http_init_t* init, lwesp_port_t port);
 size_t      lwesp_http_server_write(http_state_t* hs, const void* data, size_t len);
+lwespr_t    lwesp_http_server_post_data_recved(http_state_t* hs);
+void        lwesp_http_server_fs_read_done(http_fs_file_t* file, size_t br);
+const char* lwesp_http_server_get_header(http_state_t* hs, const char* name);
+const char* lwesp_http_server_get_param(http_state_t* hs, const char* name, size_t* len);
+void        lwesp_http_server_fs_cache_reset(void);
+#if HTTP_RESP_CACHE_SIZE > 0 || __DOXYGEN__
+void        lwesp_http_server_resp_cache_reset(void);
+#endif /* HTTP_RESP_CACHE_SIZE > 0 || __DOXYGEN__ */
+size_t      lwesp_http_server_ssi_compile(const void* data, size_t len, http_ssi_segment_t* segments, size_t segments_len);
+#if HTTP_USE_WEBSOCKET || __DOXYGEN__
+lwespr_t    lwesp_http_server_ws_send(http_state_t* hs, http_ws_opcode_t opcode, const void* data, size_t len);
+#endif /* HTTP_USE_WEBSOCKET || __DOXYGEN__ */
 
 /**
  * \}
@@ -49,6 +49,7 @@ extern "C" {
 
 uint8_t     http_fs_open(http_fs_file_t* file, const char* path);
 uint32_t    http_fs_read(http_fs_file_t* file, void* buff, size_t btr);
+uint8_t     http_fs_seek(http_fs_file_t* file, uint32_t offset);
 uint8_t     http_fs_close(http_fs_file_t* file);
 
 /**
@@ -90,8 +90,32 @@ typedef struct {
     const char* will_topic;                     /*!< Will topic */
     const char* will_message;                   /*!< Will message */
     lwesp_mqtt_qos_t will_qos;                  /*!< Will topic quality of service */
+#if LWESP_CFG_MQTT_V5 || __DOXYGEN__
+    uint8_t version;                            /*!< Protocol version. Set to `5` for MQTT 5,
+                                                    `0` or `4` for MQTT 3.1.1 */
+#endif /* LWESP_CFG_MQTT_V5 || __DOXYGEN__ */
 } lwesp_mqtt_client_info_t;
 
+/**
+ * \brief           Topic filter with quality of service for subscribe to multiple topics
+ */
+typedef struct {
+    const char* topic;                          /*!< Topic filter, null-terminated string */
+    lwesp_mqtt_qos_t qos;                       /*!< Requested quality of service */
+} lwesp_mqtt_sub_topic_t;
+
+/**
+ * \brief           Publish message for publishing multiple messages in single burst
+ */
+typedef struct {
+    const char* topic;                          /*!< Topic to send message to, null-terminated string */
+    const void* payload;                        /*!< Message data */
+    uint16_t len;                               /*!< Length of payload data */
+    lwesp_mqtt_qos_t qos;                       /*!< Quality of service */
+    uint8_t retain;                             /*!< Retain parameter value */
+    void* arg;                                  /*!< User custom argument used in callback */
+} lwesp_mqtt_pub_msg_t;
+
 /**
  * \brief           MQTT request object
  */
@@ -104,6 +128,9 @@ typedef struct {
                                                     on connection before we can say "packet was sent". */
 
     uint32_t timeout_start_time;                /*!< Timeout start time in units of milliseconds */
+#if LWESP_CFG_MQTT_PUBLISH_BACKLOG || __DOXYGEN__
+    lwesp_buff_t backlog;                       /*!< Serialized publish packet waiting in backlog */
+#endif /* LWESP_CFG_MQTT_PUBLISH_BACKLOG || __DOXYGEN__ */
 } lwesp_mqtt_request_t;
 
 /**
@@ -118,8 +145,14 @@ typedef enum {
                                                             you may not receive event, even if packet was successfully sent,
                                                             thus do not rely on this event for packet with `qos = LWESP_MQTT_QOS_AT_MOST_ONCE` */
     LWESP_MQTT_EVT_PUBLISH_RECV,                /*!< MQTT client received a publish message from server */
+#if LWESP_CFG_MQTT_RECV_STREAM || __DOXYGEN__
+    LWESP_MQTT_EVT_PUBLISH_RECV_BEGIN,          /*!< MQTT client started to receive publish message too big for RX buffer */
+    LWESP_MQTT_EVT_PUBLISH_RECV_DATA,           /*!< MQTT client received part of streamed publish message payload */
+    LWESP_MQTT_EVT_PUBLISH_RECV_END,            /*!< MQTT client received last part of streamed publish message */
+#endif /* LWESP_CFG_MQTT_RECV_STREAM || __DOXYGEN__ */
     LWESP_MQTT_EVT_DISCONNECT,                  /*!< MQTT client disconnected from MQTT server */
     LWESP_MQTT_EVT_KEEP_ALIVE,                  /*!< MQTT keep-alive sent to server and reply received */
+    LWESP_MQTT_EVT_WRITABLE,                    /*!< MQTT client has resources again after publish failed with \ref lwespERRMEM */
 } lwesp_mqtt_evt_type_t;
 
 /**
@@ -149,7 +182,10 @@ typedef struct {
         } disconnect;                           /*!< Event for disconnecting from server */
         struct {
             void* arg;                          /*!< User argument for callback function */
-            lwespr_t res;                       /*!< Response status */
+            lwespr_t res;                       /*!< Response status, \ref lwespOK only if all topics were accepted */
+            const uint8_t* return_codes;        /*!< Subscribe return code for each topic, in request order.
+                                                    Granted QoS or `0x80` on failure. `NULL` if not available */
+            size_t return_codes_len;            /*!< Number of return codes */
         } sub_unsub_scribed;                    /*!< Event for (un)subscribe to/from topics */
         struct {
             void* arg;                          /*!< User argument for callback function */
@@ -162,7 +198,23 @@ typedef struct {
             size_t payload_len;                 /*!< Length of topic payload */
             uint8_t dup;                        /*!< Duplicate flag if message was sent again */
             lwesp_mqtt_qos_t qos;               /*!< Received packet quality of service */
+            lwesp_pbuf_p pbuf;                  /*!< Packet buffer holding topic and payload,
+                                                    or `NULL` if message was reassembled in RX buffer.
+                                                    Use \ref lwesp_pbuf_ref to keep data valid after event callback */
+            size_t pbuf_offset;                 /*!< Payload offset in `pbuf` */
         } publish_recv;                         /*!< Publish received event */
+#if LWESP_CFG_MQTT_RECV_STREAM || __DOXYGEN__
+        struct {
+            const uint8_t* topic;               /*!< Pointer to topic identifier, valid for all events of single message */
+            size_t topic_len;                   /*!< Length of topic */
+            const void* payload;                /*!< Payload part, valid only during callback. `NULL` for begin and end events */
+            size_t payload_len;                 /*!< Length of payload part */
+            size_t offset;                      /*!< Offset of payload part in entire payload */
+            size_t total_len;                   /*!< Total length of payload */
+            uint8_t dup;                        /*!< Duplicate flag if message was sent again */
+            lwesp_mqtt_qos_t qos;               /*!< Received packet quality of service */
+        } publish_recv_stream;                  /*!< Streamed publish received events */
+#endif /* LWESP_CFG_MQTT_RECV_STREAM || __DOXYGEN__ */
     } evt;                                      /*!< Event data parameters */
 } lwesp_mqtt_evt_t;
 
@@ -173,6 +225,53 @@ typedef struct {
  */
 typedef void        (*lwesp_mqtt_evt_fn)(lwesp_mqtt_client_p client, lwesp_mqtt_evt_t* evt);
 
+#if LWESP_CFG_MQTT_SESSION_STORE || __DOXYGEN__
+
+/**
+ * \brief           Session store operation
+ */
+typedef enum {
+    LWESP_MQTT_SESSION_OP_SAVE,                 /*!< Save entry to storage. Entry data are valid only during callback */
+    LWESP_MQTT_SESSION_OP_REMOVE,               /*!< Remove entry from storage. Publish is identified by packet ID,
+                                                    subscription by topic */
+    LWESP_MQTT_SESSION_OP_LOAD,                 /*!< Fill entry at `index` position. Return \ref lwespOK while entry exists.
+                                                    Topic and payload memory must stay valid until next load call */
+} lwesp_mqtt_session_op_t;
+
+/**
+ * \brief           Session store entry type
+ */
+typedef enum {
+    LWESP_MQTT_SESSION_TYPE_PUBLISH,            /*!< Publish packet with QoS `1` or `2` waiting for acknowledge */
+    LWESP_MQTT_SESSION_TYPE_SUBSCRIPTION,       /*!< Active subscription */
+} lwesp_mqtt_session_type_t;
+
+/**
+ * \brief           Session store entry
+ */
+typedef struct {
+    lwesp_mqtt_session_type_t type;             /*!< Entry type */
+    uint16_t packet_id;                         /*!< Packet ID of publish entry */
+    const char* topic;                          /*!< Topic of publish or subscription topic filter, not null-terminated */
+    uint16_t topic_len;                         /*!< Length of topic */
+    const void* payload;                        /*!< Payload of publish entry */
+    uint16_t payload_len;                       /*!< Length of payload */
+    lwesp_mqtt_qos_t qos;                       /*!< Quality of service */
+    uint8_t retain;                             /*!< Retain flag of publish entry */
+} lwesp_mqtt_session_entry_t;
+
+/**
+ * \brief           MQTT session store callback function
+ * \param[in]       client: MQTT client
+ * \param[in]       op: Operation to execute
+ * \param[in,out]   entry: Entry to save or remove, or entry to fill on load
+ * \param[in]       index: Entry index for \ref LWESP_MQTT_SESSION_OP_LOAD operation
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+typedef lwespr_t    (*lwesp_mqtt_session_fn)(lwesp_mqtt_client_p client, lwesp_mqtt_session_op_t op, lwesp_mqtt_session_entry_t* entry, size_t index);
+
+#endif /* LWESP_CFG_MQTT_SESSION_STORE || __DOXYGEN__ */
+
 lwesp_mqtt_client_p   lwesp_mqtt_client_new(size_t tx_buff_len, size_t rx_buff_len);
 void                lwesp_mqtt_client_delete(lwesp_mqtt_client_p client);
 
@@ -181,9 +280,18 @@ lwespr_t              lwesp_mqtt_client_disconnect(lwesp_mqtt_client_p client);
 uint8_t             lwesp_mqtt_client_is_connected(lwesp_mqtt_client_p client);
 
 lwespr_t              lwesp_mqtt_client_subscribe(lwesp_mqtt_client_p client, const char* topic, lwesp_mqtt_qos_t qos, void* arg);
+lwespr_t              lwesp_mqtt_client_subscribe_many(lwesp_mqtt_client_p client, const lwesp_mqtt_sub_topic_t* topics, size_t count, void* arg);
 lwespr_t              lwesp_mqtt_client_unsubscribe(lwesp_mqtt_client_p client, const char* topic, void* arg);
 
 lwespr_t              lwesp_mqtt_client_publish(lwesp_mqtt_client_p client, const char* topic, const void* payload, uint16_t len, lwesp_mqtt_qos_t qos, uint8_t retain, void* arg);
+lwespr_t              lwesp_mqtt_client_publish_many(lwesp_mqtt_client_p client, const lwesp_mqtt_pub_msg_t* msgs, size_t count, size_t* queued);
+#if LWESP_CFG_MQTT_PUBLISH_NOCOPY || __DOXYGEN__
+lwespr_t              lwesp_mqtt_client_publish_nocopy(lwesp_mqtt_client_p client, const char* topic, const void* payload, uint16_t len, lwesp_mqtt_qos_t qos, uint8_t retain, void* arg);
+#endif /* LWESP_CFG_MQTT_PUBLISH_NOCOPY || __DOXYGEN__ */
+
+#if LWESP_CFG_MQTT_SESSION_STORE || __DOXYGEN__
+lwespr_t              lwesp_mqtt_client_set_session_fn(lwesp_mqtt_client_p client, lwesp_mqtt_session_fn session_fn);
+#endif /* LWESP_CFG_MQTT_SESSION_STORE || __DOXYGEN__ */
 
 void*               lwesp_mqtt_client_get_arg(lwesp_mqtt_client_p client);
 void                lwesp_mqtt_client_set_arg(lwesp_mqtt_client_p client, void* arg);
@@ -53,6 +53,11 @@ extern "C" {
  */
 struct lwesp_mqtt_client_api;
 
+/**
+ * \brief           MQTT API client group with shared receive queue
+ */
+struct lwesp_mqtt_client_api_group;
+
 /**
  * \brief           MQTT API RX buffer
  */
@@ -62,6 +67,11 @@ typedef struct lwesp_mqtt_client_api_buf {
     uint8_t* payload;                           /*!< Payload data */
     size_t payload_len;                         /*!< Payload length */
     lwesp_mqtt_qos_t qos;                       /*!< Quality of service */
+    struct lwesp_mqtt_client_api* client;       /*!< Client which received the packet */
+#if LWESP_CFG_MQTT_API_ZERO_COPY || __DOXYGEN__
+    lwesp_pbuf_p pbuf;                          /*!< Referenced packet buffer holding topic and payload,
+                                                    `NULL` when data are copied to buffer memory */
+#endif /* LWESP_CFG_MQTT_API_ZERO_COPY || __DOXYGEN__ */
 } lwesp_mqtt_client_api_buf_t;
 
 /**
@@ -74,16 +84,45 @@ typedef struct lwesp_mqtt_client_api* lwesp_mqtt_client_api_p;
  */
 typedef struct lwesp_mqtt_client_api_buf* lwesp_mqtt_client_api_buf_p;
 
+/**
+ * \brief           Pointer to \ref lwesp_mqtt_client_api_group structure
+ */
+typedef struct lwesp_mqtt_client_api_group* lwesp_mqtt_client_api_group_p;
+
+/**
+ * \brief           Receive view callback, called for every received publish before buffer is allocated
+ * \note            Function is called from MQTT event context and must not block
+ * \param[in]       client: MQTT API client handle
+ * \param[in]       view: Received packet. Topic and payload point to receive memory and are valid during call only
+ * \param[in]       arg: User argument
+ * \return          User owned buffer to put to receive queue instead of allocated copy,
+ *                  `NULL` to continue with default processing.
+ *                  Returned buffer must not be freed with \ref lwesp_mqtt_client_api_buf_free
+ *                  and is dropped if receive queue is full
+ */
+typedef lwesp_mqtt_client_api_buf_p (*lwesp_mqtt_client_api_recv_fn)(lwesp_mqtt_client_api_p client, const lwesp_mqtt_client_api_buf_t* view, void* arg);
+
 lwesp_mqtt_client_api_p   lwesp_mqtt_client_api_new(size_t tx_buff_len, size_t rx_buff_len);
 void                    lwesp_mqtt_client_api_delete(lwesp_mqtt_client_api_p client);
 lwesp_mqtt_conn_status_t  lwesp_mqtt_client_api_connect(lwesp_mqtt_client_api_p client, const char* host, lwesp_port_t port, const lwesp_mqtt_client_info_t* info);
 lwespr_t                  lwesp_mqtt_client_api_close(lwesp_mqtt_client_api_p client);
 lwespr_t                  lwesp_mqtt_client_api_subscribe(lwesp_mqtt_client_api_p client, const char* topic, lwesp_mqtt_qos_t qos);
+lwespr_t                  lwesp_mqtt_client_api_subscribe_many(lwesp_mqtt_client_api_p client, const lwesp_mqtt_sub_topic_t* topics, size_t count, lwespr_t* results);
 lwespr_t                  lwesp_mqtt_client_api_unsubscribe(lwesp_mqtt_client_api_p client, const char* topic);
 lwespr_t                  lwesp_mqtt_client_api_publish(lwesp_mqtt_client_api_p client, const char* topic, const void* data, size_t btw, lwesp_mqtt_qos_t qos, uint8_t retain);
+lwespr_t                  lwesp_mqtt_client_api_publish_many(lwesp_mqtt_client_api_p client, const lwesp_mqtt_pub_msg_t* msgs, size_t count);
 uint8_t                 lwesp_mqtt_client_api_is_connected(lwesp_mqtt_client_api_p client);
 lwespr_t                  lwesp_mqtt_client_api_receive(lwesp_mqtt_client_api_p client, lwesp_mqtt_client_api_buf_p* p, uint32_t timeout);
+lwespr_t                  lwesp_mqtt_client_api_receive_many(lwesp_mqtt_client_api_p client, lwesp_mqtt_client_api_buf_p* bufs, size_t max, size_t* cnt, uint32_t timeout);
 void                    lwesp_mqtt_client_api_buf_free(lwesp_mqtt_client_api_buf_p p);
+void                    lwesp_mqtt_client_api_buf_free_many(lwesp_mqtt_client_api_buf_p* bufs, size_t cnt);
+lwespr_t                  lwesp_mqtt_client_api_set_recv_fn(lwesp_mqtt_client_api_p client, lwesp_mqtt_client_api_recv_fn fn, void* arg);
+
+lwesp_mqtt_client_api_group_p lwesp_mqtt_client_api_group_new(size_t queue_len);
+void                    lwesp_mqtt_client_api_group_delete(lwesp_mqtt_client_api_group_p group);
+lwesp_mqtt_client_api_p   lwesp_mqtt_client_api_new_in_group(lwesp_mqtt_client_api_group_p group, size_t tx_buff_len, size_t rx_buff_len);
+lwespr_t                  lwesp_mqtt_client_api_group_receive(lwesp_mqtt_client_api_group_p group, lwesp_mqtt_client_api_p* client, lwesp_mqtt_client_api_buf_p* p, uint32_t timeout);
+lwespr_t                  lwesp_mqtt_client_api_group_wakeup(lwesp_mqtt_client_api_group_p group);
 
 /**
  * \}
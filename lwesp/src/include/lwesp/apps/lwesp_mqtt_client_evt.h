@@ -124,6 +124,25 @@ extern "C" {
  */
 #define lwesp_mqtt_client_evt_subscribe_get_result(client, evt)       ((lwespr_t)(evt)->evt.sub_unsub_scribed.res)
 
+/**
+ * \brief           Get number of topic return codes in subscribe event
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Number of topics acknowledged by server, `0` if connection was closed before
+ * \hideinitializer
+ */
+#define lwesp_mqtt_client_evt_subscribe_get_count(client, evt)        ((size_t)(evt)->evt.sub_unsub_scribed.return_codes_len)
+
+/**
+ * \brief           Get return code for specific topic in subscribe event
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \param[in]       index: Topic index as used on \ref lwesp_mqtt_client_subscribe_many
+ * \return          Granted quality of service or `0x80` on failure
+ * \hideinitializer
+ */
+#define lwesp_mqtt_client_evt_subscribe_get_return_code(client, evt, index)   ((uint8_t)(evt)->evt.sub_unsub_scribed.return_codes[(index)])
+
 /**
  * \brief           Get user argument used on \ref lwesp_mqtt_client_unsubscribe
  * \param[in]       client: MQTT client
@@ -208,6 +227,24 @@ extern "C" {
  */
 #define lwesp_mqtt_client_evt_publish_recv_get_qos(client, evt)       ((evt)->evt.publish_recv.qos)
 
+/**
+ * \brief           Get packet buffer holding received topic and payload
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Packet buffer or `NULL` if message was copied to RX buffer
+ * \hideinitializer
+ */
+#define lwesp_mqtt_client_evt_publish_recv_get_pbuf(client, evt)      ((evt)->evt.publish_recv.pbuf)
+
+/**
+ * \brief           Get payload offset in packet buffer from received publish packet
+ * \param[in]       client: MQTT client
+ * \param[in]       evt: Event handle
+ * \return          Payload offset, valid only when packet buffer is not `NULL`
+ * \hideinitializer
+ */
+#define lwesp_mqtt_client_evt_publish_recv_get_pbuf_offset(client, evt)   (LWESP_SZ((evt)->evt.publish_recv.pbuf_offset))
+
 /**
  * \}
  */
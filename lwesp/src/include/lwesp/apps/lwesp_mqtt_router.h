@@ -0,0 +1,90 @@
+/**
+ * \file            lwesp_mqtt_router.h
+ * \brief           MQTT topic filter router
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_APP_MQTT_ROUTER_H
+#define LWESP_HDR_APP_MQTT_ROUTER_H
+
+#include "lwesp/lwesp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWESP_APP_MQTT_CLIENT
+ * \defgroup        LWESP_APP_MQTT_ROUTER Topic filter router
+ * \brief           Dispatch received messages to callbacks by topic filter
+ * \{
+ *
+ * Topic filters are stored in a trie with one node per topic level,
+ * with support for `+` and `#` wildcards.
+ * Cost of dispatch depends on topic depth rather than on number of filters.
+ *
+ * \note            Router is not thread-safe. Add, remove and dispatch from the same thread,
+ *                  typically from MQTT event callback or MQTT API receive thread
+ */
+
+struct lwesp_mqtt_router_node;
+
+/**
+ * \brief           Router callback function, called for every filter matching received topic
+ * \param[in]       topic: Received topic, not null-terminated
+ * \param[in]       topic_len: Length of topic
+ * \param[in]       payload: Received payload
+ * \param[in]       payload_len: Length of payload
+ * \param[in]       arg: User argument used on \ref lwesp_mqtt_router_add
+ */
+typedef void        (*lwesp_mqtt_router_fn)(const char* topic, size_t topic_len, const void* payload, size_t payload_len, void* arg);
+
+/**
+ * \brief           MQTT topic filter router
+ */
+typedef struct {
+    struct lwesp_mqtt_router_node* root;        /*!< List of first level nodes */
+} lwesp_mqtt_router_t;
+
+void        lwesp_mqtt_router_init(lwesp_mqtt_router_t* router);
+void        lwesp_mqtt_router_free(lwesp_mqtt_router_t* router);
+lwespr_t    lwesp_mqtt_router_add(lwesp_mqtt_router_t* router, const char* filter, lwesp_mqtt_router_fn fn, void* arg);
+lwespr_t    lwesp_mqtt_router_remove(lwesp_mqtt_router_t* router, const char* filter);
+size_t      lwesp_mqtt_router_dispatch(lwesp_mqtt_router_t* router, const char* topic, size_t topic_len, const void* payload, size_t payload_len);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWESP_HDR_APP_MQTT_ROUTER_H */
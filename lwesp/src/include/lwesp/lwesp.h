@@ -49,9 +49,11 @@ extern "C" {
 lwespr_t    lwesp_init(lwesp_evt_fn cb_func, const uint32_t blocking);
 lwespr_t    lwesp_reset(const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwespr_t    lwesp_reset_with_delay(uint32_t delay, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+lwespr_t    lwesp_reset_warm(const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 
 lwespr_t    lwesp_restore(const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwespr_t    lwesp_set_at_baudrate(uint32_t baud, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+lwespr_t    lwesp_set_at_baudrate_auto(const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwespr_t    lwesp_set_wifi_mode(lwesp_mode_t mode, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwespr_t    lwesp_get_wifi_mode(lwesp_mode_t* mode, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 
@@ -62,6 +64,17 @@ lwespr_t    lwesp_update_sw(const lwesp_api_cmd_evt_fn evt_fn, void* const evt_a
 lwespr_t    lwesp_core_lock(void);
 lwespr_t    lwesp_core_unlock(void);
 
+#if LWESP_CFG_POLL || __DOXYGEN__
+lwespr_t    lwesp_poll(void);
+#endif /* LWESP_CFG_POLL || __DOXYGEN__ */
+
+lwespr_t    lwesp_batch_begin(lwesp_batch_t* batch);
+lwespr_t    lwesp_batch_submit(lwesp_batch_t* batch, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#if LWESP_CFG_CMD_CANCEL || __DOXYGEN__
+lwespr_t    lwesp_batch_set_deadline(lwesp_batch_t* batch, uint32_t timeout);
+lwespr_t    lwesp_cmd_cancel(const lwesp_batch_t* batch);
+#endif /* LWESP_CFG_CMD_CANCEL || __DOXYGEN__ */
+
 lwespr_t    lwesp_device_set_present(uint8_t present, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 uint8_t     lwesp_device_is_present(void);
 
@@ -69,6 +82,18 @@ uint8_t     lwesp_device_is_esp8266(void);
 uint8_t     lwesp_device_is_esp32(void);
 
 uint8_t     lwesp_delay(const uint32_t ms);
+lwespr_t    lwesp_wait_for(uint32_t flags, uint32_t timeout);
+
+#if LWESP_CFG_STATIC_ONLY || __DOXYGEN__
+size_t      lwesp_get_static_ram_size(void);
+#endif /* LWESP_CFG_STATIC_ONLY || __DOXYGEN__ */
+#if LWESP_CFG_SYS_THREAD_STACK_INFO || __DOXYGEN__
+lwespr_t    lwesp_get_thread_stack_free(size_t* producer, size_t* process);
+#endif /* LWESP_CFG_SYS_THREAD_STACK_INFO || __DOXYGEN__ */
+#if LWESP_CFG_RUNTIME_PARAMS || __DOXYGEN__
+lwespr_t    lwesp_set_param(lwesp_param_t param, uint32_t value);
+uint32_t    lwesp_get_param(lwesp_param_t param);
+#endif /* LWESP_CFG_RUNTIME_PARAMS || __DOXYGEN__ */
 
 uint8_t     lwesp_get_current_at_fw_version(lwesp_sw_version_t* const version);
 
@@ -0,0 +1,587 @@
+/**
+ * \file            lwesp.hpp
+ * \brief           Header-only C++ layer for LwESP
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_HPP
+#define LWESP_HDR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "lwesp/lwesp.h"
+#include "lwesp/lwesp_conn.h"
+#include "lwesp/lwesp_dns.h"
+#include "lwesp/lwesp_evt.h"
+#include "lwesp/lwesp_pbuf.h"
+#include "system/lwesp_sys.h"
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#define LWESP_CPP_COROUTINES                1
+#endif /* __has_include(<coroutine>) */
+#endif /* defined(__cpp_impl_coroutine) && defined(__has_include) */
+
+#ifndef LWESP_CPP_COROUTINES
+#define LWESP_CPP_COROUTINES                0
+#endif /* LWESP_CPP_COROUTINES */
+
+/**
+ * \defgroup        LWESP_CPP C++ layer
+ * \brief           Header-only C++17 layer with RAII packet buffers and C++20 awaitable operations
+ * \{
+ *
+ * \ref lwesp::Pbuf and \ref lwesp::Span are available with C++17.
+ * Awaitable operations are available when compiler supports C++20 coroutines.
+ *
+ * Awaitable operations start commands in non-blocking mode.
+ * Completion is reported from library thread, which only posts coroutine handle to \ref lwesp::Executor.
+ * Coroutines are always resumed by thread running the executor, one thread can drive many concurrent operations.
+ */
+
+/**
+ * \brief           Number of received packet buffers queued per \ref lwesp::Connection
+ */
+#ifndef LWESP_CPP_RECEIVE_QUEUE_LEN
+#define LWESP_CPP_RECEIVE_QUEUE_LEN         4
+#endif
+
+namespace lwesp {
+
+/**
+ * \brief           Read-only view over contiguous memory
+ */
+class Span {
+  public:
+    constexpr Span() noexcept = default;
+    constexpr Span(const uint8_t* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    constexpr const uint8_t* data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr const uint8_t* begin() const noexcept { return data_; }
+    constexpr const uint8_t* end() const noexcept { return data_ + size_; }
+    constexpr uint8_t operator[](size_t i) const noexcept { return data_[i]; }
+
+  private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * \brief           Move-only owner of single packet buffer reference
+ *
+ * Object holds one reference, released with \ref lwesp_pbuf_free on destruction.
+ * Copies are not possible, use \ref Pbuf::ref to explicitly take another reference.
+ */
+class Pbuf {
+  public:
+    /**
+     * \brief           Iterator over contiguous segments of packet buffer chain
+     */
+    class SegmentIterator {
+      public:
+        SegmentIterator(lwesp_pbuf_p p, size_t offset) noexcept : p_(p), offset_(offset) { load(); }
+
+        Span operator*() const noexcept { return seg_; }
+        SegmentIterator& operator++() noexcept {
+            offset_ += seg_.size();
+            load();
+            return *this;
+        }
+        bool operator!=(const SegmentIterator& other) const noexcept { return offset_ != other.offset_; }
+
+      private:
+        void load() noexcept {
+            size_t len = 0;
+            const void* d = p_ != nullptr ? lwesp_pbuf_get_linear_addr(p_, offset_, &len) : nullptr;
+            seg_ = d != nullptr ? Span(static_cast<const uint8_t*>(d), len) : Span();
+        }
+
+        lwesp_pbuf_p p_;
+        size_t offset_;
+        Span seg_;
+    };
+
+    /**
+     * \brief           Range of contiguous segments, use with range based `for` loop
+     */
+    class Segments {
+      public:
+        explicit Segments(lwesp_pbuf_p p) noexcept : p_(p) {}
+        SegmentIterator begin() const noexcept { return SegmentIterator(p_, 0); }
+        SegmentIterator end() const noexcept { return SegmentIterator(nullptr, p_ != nullptr ? lwesp_pbuf_length(p_, 1) : 0); }
+
+      private:
+        lwesp_pbuf_p p_;
+    };
+
+    Pbuf() noexcept = default;
+
+    /**
+     * \brief           Take ownership of existing reference
+     * \param[in]       p: Packet buffer, reference is released by this object
+     */
+    explicit Pbuf(lwesp_pbuf_p p) noexcept : p_(p) {}
+    Pbuf(const Pbuf&) = delete;
+    Pbuf& operator=(const Pbuf&) = delete;
+    Pbuf(Pbuf&& other) noexcept : p_(other.release()) {}
+    Pbuf& operator=(Pbuf&& other) noexcept {
+        if (this != &other) {
+            reset(other.release());
+        }
+        return *this;
+    }
+    ~Pbuf() { reset(); }
+
+    /**
+     * \brief           Take new reference of packet buffer, owned by caller as well
+     * \param[in]       p: Packet buffer
+     * \return          Object holding new reference
+     */
+    static Pbuf ref(lwesp_pbuf_p p) noexcept {
+        if (p != nullptr) {
+            lwesp_pbuf_ref(p);
+        }
+        return Pbuf(p);
+    }
+
+    /**
+     * \brief           Allocate new packet buffer
+     * \param[in]       len: Length of payload in units of bytes
+     * \return          Object with allocated packet buffer, empty on failure
+     */
+    static Pbuf alloc(size_t len) noexcept { return Pbuf(lwesp_pbuf_new(len)); }
+
+    /**
+     * \brief           Release owned reference and optionally take ownership of new one
+     * \param[in]       p: New packet buffer to own
+     */
+    void reset(lwesp_pbuf_p p = nullptr) noexcept {
+        if (p_ != nullptr) {
+            lwesp_pbuf_free(p_);
+        }
+        p_ = p;
+    }
+
+    /**
+     * \brief           Give up ownership without releasing reference
+     * \return          Packet buffer, caller is responsible to free it
+     */
+    lwesp_pbuf_p release() noexcept {
+        lwesp_pbuf_p p = p_;
+        p_ = nullptr;
+        return p;
+    }
+
+    lwesp_pbuf_p get() const noexcept { return p_; }
+    explicit operator bool() const noexcept { return p_ != nullptr; }
+
+    /**
+     * \brief           Get total length of packet buffer chain
+     * \return          Length in units of bytes
+     */
+    size_t size() const noexcept { return p_ != nullptr ? lwesp_pbuf_length(p_, 1) : 0; }
+
+    /**
+     * \brief           Get contiguous segments of packet buffer chain
+     * \return          Range of \ref Span objects
+     */
+    Segments segments() const noexcept { return Segments(p_); }
+
+    /**
+     * \brief           Copy data out of packet buffer chain
+     * \param[out]      data: Output memory
+     * \param[in]       len: Number of bytes to copy
+     * \param[in]       offset: Start offset in packet buffer
+     * \return          Number of bytes copied
+     */
+    size_t copy(void* data, size_t len, size_t offset = 0) const noexcept {
+        return p_ != nullptr ? lwesp_pbuf_copy(p_, data, len, offset) : 0;
+    }
+
+  private:
+    lwesp_pbuf_p p_ = nullptr;
+};
+
+#if LWESP_CPP_COROUTINES || __DOXYGEN__
+
+/**
+ * \brief           Executor resuming coroutines in its own thread
+ *
+ * Library thread posts coroutine handle when operation completes, thread calling \ref run
+ * or \ref run_one resumes it. Every suspended operation posts exactly once, queue length
+ * must therefore be at least maximal number of concurrently awaited operations,
+ * otherwise library thread blocks until executor thread makes space.
+ */
+class Executor {
+  public:
+    /**
+     * \brief           Create executor
+     * \param[in]       queue_len: Number of handles that may wait to be resumed
+     */
+    explicit Executor(size_t queue_len = 16) noexcept { lwesp_sys_mbox_create(&mbox_, queue_len); }
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+    ~Executor() { lwesp_sys_mbox_delete(&mbox_); }
+
+    /**
+     * \brief           Schedule coroutine to be resumed by executor thread
+     * \param[in]       h: Coroutine handle
+     */
+    void post(std::coroutine_handle<> h) noexcept { lwesp_sys_mbox_put(&mbox_, h.address()); }
+
+    /**
+     * \brief           Resume one scheduled coroutine
+     * \param[in]       timeout: Maximal time to wait in units of milliseconds, `0` to wait forever
+     * \return          `true` if coroutine was resumed, `false` on timeout
+     */
+    bool run_one(uint32_t timeout = 0) noexcept {
+        void* m;
+        if (lwesp_sys_mbox_get(&mbox_, &m, timeout) == LWESP_SYS_TIMEOUT) {
+            return false;
+        }
+        std::coroutine_handle<>::from_address(m).resume();
+        return true;
+    }
+
+    /**
+     * \brief           Resume scheduled coroutines forever
+     */
+    [[noreturn]] void run() noexcept {
+        while (true) {
+            run_one(0);
+        }
+    }
+
+  private:
+    lwesp_sys_mbox_t mbox_;
+};
+
+/**
+ * \brief           Detached coroutine type, starts immediately and frees itself on completion
+ */
+struct Task {
+    struct promise_type {
+        Task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+/**
+ * \brief           Pending operation state, completed from library thread
+ */
+struct Waiter {
+    std::coroutine_handle<> h;
+    lwespr_t res = lwespOK;
+    bool active = false;
+
+    /**
+     * \brief           Complete operation and schedule coroutine, called with core lock held
+     * \param[in]       exec: Executor to resume coroutine
+     * \param[in]       r: Operation result
+     */
+    void complete(Executor& exec, lwespr_t r) noexcept {
+        if (active) {
+            active = false;
+            res = r;
+            exec.post(h);
+        }
+    }
+};
+
+/**
+ * \brief           Awaitable DNS resolve operation
+ */
+class DnsAwaiter {
+  public:
+    DnsAwaiter(Executor& exec, const char* host, lwesp_ip_t& ip) noexcept : exec_(exec), host_(host), ip_(ip) {}
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> h) noexcept {
+        lwespr_t res;
+
+        lwesp_core_lock();
+        w_.h = h;
+        w_.active = true;
+        if ((res = lwesp_dns_gethostbyname(host_, &ip_, cmd_evt_fn, this, 0)) != lwespOK) {
+            w_.active = false;
+            w_.res = res;
+        }
+        lwesp_core_unlock();
+        return res == lwespOK;
+    }
+    lwespr_t await_resume() const noexcept { return w_.res; }
+
+  private:
+    static void cmd_evt_fn(lwespr_t res, void* arg) {
+        auto self = static_cast<DnsAwaiter*>(arg);
+        self->w_.complete(self->exec_, res);
+    }
+
+    Executor& exec_;
+    const char* host_;
+    lwesp_ip_t& ip_;
+    Waiter w_;
+};
+
+/**
+ * \brief           Resolve host name to IP address
+ * \param[in]       exec: Executor to resume coroutine
+ * \param[in]       host: Host name, must stay valid until operation completes
+ * \param[out]      ip: Output IP address
+ * \return          Awaitable, result of `co_await` is \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+inline DnsAwaiter
+dns_gethostbyname(Executor& exec, const char* host, lwesp_ip_t& ip) noexcept {
+    return DnsAwaiter(exec, host, ip);
+}
+
+/**
+ * \brief           Client connection with awaitable connect, send, receive and close
+ *
+ * Object must stay valid until connection is closed, connection events refer to it.
+ * Only one operation of each kind may be awaited at a time.
+ */
+class Connection {
+  public:
+    explicit Connection(Executor& exec) noexcept : exec_(exec) {}
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+    ~Connection() {
+        for (; recv_cnt_ > 0; --recv_cnt_, recv_r_ = (recv_r_ + 1) % LWESP_CPP_RECEIVE_QUEUE_LEN) {
+            lwesp_pbuf_free(recv_queue_[recv_r_]);
+        }
+    }
+
+    lwesp_conn_p get() const noexcept { return conn_; }
+
+    /**
+     * \brief           Generic awaitable connection operation
+     */
+    template<typename Start>
+    class Awaiter {
+      public:
+        Awaiter(Waiter& w, Start start) noexcept : w_(w), start_(start) {}
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) noexcept {
+            lwespr_t res;
+
+            lwesp_core_lock();
+            w_.h = h;
+            w_.active = true;
+            if ((res = start_()) != lwespOK) {
+                w_.active = false;
+                w_.res = res;
+            }
+            lwesp_core_unlock();
+            return res == lwespOK;
+        }
+        lwespr_t await_resume() const noexcept { return w_.res; }
+
+      private:
+        Waiter& w_;
+        Start start_;
+    };
+
+    /**
+     * \brief           Start client connection
+     * \param[in]       type: Connection type
+     * \param[in]       host: Remote host, must stay valid until operation completes
+     * \param[in]       port: Remote port
+     * \return          Awaitable, result of `co_await` is \ref lwespOK when connection is active
+     */
+    auto connect(lwesp_conn_type_t type, const char* host, lwesp_port_t port) noexcept {
+        auto start = [this, type, host, port]() noexcept {
+            closed_ = false;
+            return lwesp_conn_start(nullptr, type, host, port, this, evt_fn, 0);
+        };
+        return Awaiter<decltype(start)>(connect_, start);
+    }
+
+    /**
+     * \brief           Send data
+     * \param[in]       data: Data to send
+     * \param[in]       len: Number of bytes to send
+     * \return          Awaitable, result of `co_await` is send result reported by device
+     */
+    auto send(const void* data, size_t len) noexcept {
+        auto start = [this, data, len]() noexcept {
+            return conn_ != nullptr ? lwesp_conn_send(conn_, data, len, nullptr, 0) : lwespCLOSED;
+        };
+        return Awaiter<decltype(start)>(send_, start);
+    }
+
+    /**
+     * \brief           Close connection
+     * \return          Awaitable, result of `co_await` is \ref lwespOK when connection is closed
+     */
+    auto close() noexcept {
+        auto start = [this]() noexcept {
+            return conn_ != nullptr ? lwesp_conn_close(conn_, 0) : lwespCLOSED;
+        };
+        return Awaiter<decltype(start)>(close_, start);
+    }
+
+    /**
+     * \brief           Awaitable receive operation
+     */
+    class ReceiveAwaiter {
+      public:
+        ReceiveAwaiter(Connection& c, Pbuf& out) noexcept : c_(c), out_(out) {}
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) noexcept {
+            bool suspend = false;
+
+            lwesp_core_lock();
+            if (c_.recv_cnt_ == 0 && !c_.closed_) {
+                c_.recv_.h = h;
+                c_.recv_.active = true;
+                suspend = true;
+            }
+            lwesp_core_unlock();
+            return suspend;
+        }
+        lwespr_t await_resume() noexcept {
+            lwespr_t res = lwespCLOSED;
+
+            lwesp_core_lock();
+            if (c_.recv_cnt_ > 0) {
+                out_.reset(c_.recv_queue_[c_.recv_r_]);
+                c_.recv_r_ = (c_.recv_r_ + 1) % LWESP_CPP_RECEIVE_QUEUE_LEN;
+                --c_.recv_cnt_;
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+                if (c_.conn_ != nullptr) {
+                    lwesp_conn_recved(c_.conn_, out_.get());
+                }
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+                res = lwespOK;
+            }
+            lwesp_core_unlock();
+            return res;
+        }
+
+      private:
+        Connection& c_;
+        Pbuf& out_;
+    };
+
+    /**
+     * \brief           Receive next packet buffer
+     * \param[out]      out: Output object, takes ownership of received packet buffer
+     * \return          Awaitable, result of `co_await` is \ref lwespOK on success,
+     *                      \ref lwespCLOSED when connection is closed and no data are queued
+     */
+    ReceiveAwaiter receive(Pbuf& out) noexcept { return ReceiveAwaiter(*this, out); }
+
+  private:
+    /**
+     * \brief           Connection event callback, called by library thread with core lock held
+     */
+    static lwespr_t evt_fn(lwesp_evt_t* evt) {
+        Connection* self;
+        lwesp_conn_p conn;
+
+        if (lwesp_evt_get_type(evt) == LWESP_EVT_CONN_ERROR) {
+            self = static_cast<Connection*>(lwesp_evt_conn_error_get_arg(evt));
+            if (self != nullptr) {
+                self->closed_ = true;
+                self->connect_.complete(self->exec_, lwesp_evt_conn_error_get_error(evt));
+            }
+            return lwespOK;
+        }
+        if ((conn = lwesp_conn_get_from_evt(evt)) == nullptr
+            || (self = static_cast<Connection*>(lwesp_conn_get_arg(conn))) == nullptr) {
+            return lwespOK;
+        }
+        switch (lwesp_evt_get_type(evt)) {
+            case LWESP_EVT_CONN_ACTIVE: {
+                self->conn_ = conn;
+                self->connect_.complete(self->exec_, lwespOK);
+                break;
+            }
+            case LWESP_EVT_CONN_RECV: {
+                lwesp_pbuf_p pbuf = lwesp_evt_conn_recv_get_buff(evt);
+
+#if !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+                lwesp_conn_recved(conn, pbuf);
+#endif /* !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+                if (self->recv_cnt_ == LWESP_CPP_RECEIVE_QUEUE_LEN) {
+                    return lwespOKIGNOREMORE;   /* Queue is full, ignore more data */
+                }
+                lwesp_pbuf_ref(pbuf);
+                self->recv_queue_[self->recv_w_] = pbuf;
+                self->recv_w_ = (self->recv_w_ + 1) % LWESP_CPP_RECEIVE_QUEUE_LEN;
+                ++self->recv_cnt_;
+                self->recv_.complete(self->exec_, lwespOK);
+                break;
+            }
+            case LWESP_EVT_CONN_SEND: {
+                self->send_.complete(self->exec_, lwesp_evt_conn_send_get_result(evt));
+                break;
+            }
+            case LWESP_EVT_CONN_CLOSE: {
+                self->conn_ = nullptr;
+                self->closed_ = true;
+                self->send_.complete(self->exec_, lwespCLOSED);
+                self->recv_.complete(self->exec_, lwespCLOSED);
+                self->close_.complete(self->exec_, lwesp_evt_conn_close_get_result(evt));
+                break;
+            }
+            default:
+                break;
+        }
+        return lwespOK;
+    }
+
+    Executor& exec_;
+    lwesp_conn_p conn_ = nullptr;
+    bool closed_ = true;
+    Waiter connect_, send_, recv_, close_;
+    lwesp_pbuf_p recv_queue_[LWESP_CPP_RECEIVE_QUEUE_LEN] = {};
+    size_t recv_r_ = 0, recv_w_ = 0, recv_cnt_ = 0;
+};
+
+#endif /* LWESP_CPP_COROUTINES || __DOXYGEN__ */
+
+} /* namespace lwesp */
+
+/**
+ * \}
+ */
+
+#endif /* LWESP_HDR_HPP */
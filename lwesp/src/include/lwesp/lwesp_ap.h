@@ -62,6 +62,12 @@ lwespr_t    lwesp_ap_set_config(const char* ssid, const char* pwd, uint8_t ch, l
 lwespr_t    lwesp_ap_list_sta(lwesp_sta_t* sta, size_t stal, size_t* staf, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwespr_t    lwesp_ap_disconn_sta(const lwesp_mac_t* mac, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 
+#if LWESP_CFG_AP_STA_TABLE > 0 || __DOXYGEN__
+size_t      lwesp_ap_sta_table_get(lwesp_sta_t* sta, size_t stal);
+lwespr_t    lwesp_ap_sta_table_get_by_mac(const lwesp_mac_t* mac, lwesp_sta_t* sta);
+lwespr_t    lwesp_ap_sta_table_sync(const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#endif /* LWESP_CFG_AP_STA_TABLE > 0 || __DOXYGEN__ */
+
 /**
  * \}
  */
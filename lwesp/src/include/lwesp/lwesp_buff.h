@@ -59,7 +59,26 @@ extern "C" {
 #define BUF_PREF(x)                     lwesp_ ## x
 /* --- Buffer unique part ends --- */
 
+#if LWESP_CFG_BUFF_POW2 || __DOXYGEN__
+/**
+ * \brief           Check if buffer uses power-of-two variant with free-running pointers
+ * \param[in]       b: Buffer handle
+ */
+#define LWESP_BUFF_IS_POW2(b)           ((b)->mask > 0)
+
+/**
+ * \brief           Get memory index of buffer read or write pointer
+ * \param[in]       b: Buffer handle
+ * \param[in]       p: Read or write pointer
+ */
+#define LWESP_BUFF_INDEX(b, p)          (LWESP_BUFF_IS_POW2(b) ? ((p) & (b)->mask) : (p))
+#else
+#define LWESP_BUFF_IS_POW2(b)           0
+#define LWESP_BUFF_INDEX(b, p)          (p)
+#endif /* LWESP_CFG_BUFF_POW2 || __DOXYGEN__ */
+
 uint8_t     BUF_PREF(buff_init)(BUF_PREF(buff_t)* buff, size_t size);
+uint8_t     BUF_PREF(buff_init_mem)(BUF_PREF(buff_t)* buff, void* mem, size_t size);
 void        BUF_PREF(buff_free)(BUF_PREF(buff_t)* buff);
 void        BUF_PREF(buff_reset)(BUF_PREF(buff_t)* buff);
 
@@ -0,0 +1,92 @@
+/**
+ * \file            lwesp_capture.h
+ * \brief           AT port capture
+ */
+
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_CAPTURE_H
+#define LWESP_HDR_CAPTURE_H
+
+#include "lwesp/lwesp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWESP
+ * \defgroup        LWESP_CAPTURE AT port capture
+ * \brief           Timestamped capture of AT port traffic
+ * \{
+ *
+ * Capture is a stream of records, each starting with \ref LWESP_CAPTURE_HDR_LEN bytes long header:
+ *
+ *  - `1` byte record type, member of \ref lwesp_capture_type_t
+ *  - `4` bytes time of record in units of milliseconds, \ref lwesp_sys_now, little endian
+ *  - `2` bytes length of data following the header, little endian
+ *
+ * Received data are recorded when they are passed to the parser,
+ * sent data when the low-level driver accepts them.
+ * To capture complete session, including device reset, start capture in \ref LWESP_EVT_INIT_FINISH event.
+ * Stream can be stored to a file as is and replayed later with `lwesp_ll_replay.c` driver.
+ */
+
+#if LWESP_CFG_CAPTURE || __DOXYGEN__
+
+#define LWESP_CAPTURE_HDR_LEN               7   /*!< Length of record header in units of bytes */
+
+/**
+ * \brief           Capture record type
+ */
+typedef enum {
+    LWESP_CAPTURE_TYPE_START = 0x00,            /*!< Capture started, record has no data */
+    LWESP_CAPTURE_TYPE_RX,                      /*!< Data received from AT port */
+    LWESP_CAPTURE_TYPE_TX,                      /*!< Data sent to AT port */
+    LWESP_CAPTURE_TYPE_LOST,                    /*!< Records before were dropped as buffer was full, record has no data */
+    LWESP_CAPTURE_TYPE_RESET,                   /*!< Hardware reset of device released, record has no data */
+} lwesp_capture_type_t;
+
+lwespr_t    lwesp_capture_start(void);
+lwespr_t    lwesp_capture_stop(void);
+size_t      lwesp_capture_read(void* data, size_t btr);
+uint32_t    lwesp_capture_get_dropped(void);
+
+#endif /* LWESP_CFG_CAPTURE || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWESP_HDR_CAPTURE_H */
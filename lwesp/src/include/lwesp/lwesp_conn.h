@@ -51,9 +51,18 @@ lwespr_t    lwesp_conn_start(lwesp_conn_p* conn, lwesp_conn_type_t type, const c
 lwespr_t    lwesp_conn_startex(lwesp_conn_p* conn, lwesp_conn_start_t* start_struct, void* const arg, lwesp_evt_fn conn_evt_fn, const uint32_t blocking);
 
 lwespr_t    lwesp_conn_close(lwesp_conn_p conn, const uint32_t blocking);
+lwespr_t    lwesp_conn_close_many(const lwesp_conn_p* conns, size_t count, const uint32_t blocking);
+lwespr_t    lwesp_conn_close_all(const uint32_t blocking);
 lwespr_t    lwesp_conn_send(lwesp_conn_p conn, const void* data, size_t btw, size_t* const bw, const uint32_t blocking);
 lwespr_t    lwesp_conn_sendto(lwesp_conn_p conn, const lwesp_ip_t* const ip, lwesp_port_t port, const void* data, size_t btw, size_t* bw, const uint32_t blocking);
+lwespr_t    lwesp_conn_send_pbuf(lwesp_conn_p conn, lwesp_pbuf_p pbuf, size_t* const bw, const uint32_t blocking);
+lwespr_t    lwesp_conn_sendv(lwesp_conn_p conn, const lwesp_conn_iov_t* iov, size_t iov_cnt, size_t* const bw, const uint32_t blocking);
+#if LWESP_CFG_CONN_SENDFILE || __DOXYGEN__
+lwespr_t    lwesp_conn_sendfile(lwesp_conn_p conn, lwesp_conn_read_fn read_fn, void* arg, size_t offset, size_t len,
+                                const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg);
+#endif /* LWESP_CFG_CONN_SENDFILE || __DOXYGEN__ */
 lwespr_t    lwesp_conn_set_arg(lwesp_conn_p conn, void* const arg);
+lwespr_t    lwesp_conn_set_evt_fn(lwesp_conn_p conn, lwesp_evt_fn evt_fn);
 void*       lwesp_conn_get_arg(lwesp_conn_p conn);
 uint8_t     lwesp_conn_is_client(lwesp_conn_p conn);
 uint8_t     lwesp_conn_is_server(lwesp_conn_p conn);
@@ -64,8 +73,32 @@ lwespr_t    lwesp_conn_set_ssl_buffersize(size_t size, const uint32_t blocking);
 lwespr_t    lwesp_get_conns_status(const uint32_t blocking);
 lwesp_conn_p  lwesp_conn_get_from_evt(lwesp_evt_t* evt);
 lwespr_t    lwesp_conn_write(lwesp_conn_p conn, const void* data, size_t btw, uint8_t flush, size_t* const mem_available);
+lwespr_t    lwesp_conn_write_ref(lwesp_conn_p conn, const void* data, size_t btw, uint8_t flush, size_t* const mem_available);
 lwespr_t    lwesp_conn_recved(lwesp_conn_p conn, lwesp_pbuf_p pbuf);
+lwespr_t    lwesp_conn_set_receive_blocked(lwesp_conn_p conn, uint8_t blocked);
+lwespr_t    lwesp_conn_set_receive_window(lwesp_conn_p conn, size_t window);
+lwespr_t    lwesp_conn_set_poll_interval(lwesp_conn_p conn, uint32_t interval);
+#if LWESP_CFG_CONN_IPD_FILTER || __DOXYGEN__
+lwespr_t    lwesp_conn_set_ipd_filter(lwesp_conn_p conn, lwesp_conn_ipd_filter_fn filter_fn);
+#endif /* LWESP_CFG_CONN_IPD_FILTER || __DOXYGEN__ */
+#if LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 || __DOXYGEN__
+lwespr_t    lwesp_conn_set_write_flush_time(lwesp_conn_p conn, uint32_t time);
+#endif /* LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 || __DOXYGEN__ */
+#if LWESP_CFG_CMD_PRIORITY || __DOXYGEN__
+lwespr_t    lwesp_conn_set_priority(lwesp_conn_p conn, lwesp_cmd_prio_t prio);
+#endif /* LWESP_CFG_CMD_PRIORITY || __DOXYGEN__ */
 size_t      lwesp_conn_get_total_recved_count(lwesp_conn_p conn);
+size_t      lwesp_conn_get_max_data_len(void);
+#if LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__
+size_t      lwesp_conn_get_tx_queued(lwesp_conn_p conn);
+lwespr_t    lwesp_conn_set_tx_watermark(lwesp_conn_p conn, size_t high, size_t low);
+#endif /* LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SEND_EVT_AGGR || __DOXYGEN__
+lwespr_t    lwesp_conn_set_send_evt_batch(lwesp_conn_p conn, size_t len);
+#endif /* LWESP_CFG_CONN_SEND_EVT_AGGR || __DOXYGEN__ */
+
+lwesp_conn_handle_t lwesp_conn_get_handle(lwesp_conn_p conn);
+lwesp_conn_p lwesp_conn_from_handle(lwesp_conn_handle_t handle);
 
 uint8_t     lwesp_conn_get_remote_ip(lwesp_conn_p conn, lwesp_ip_t* ip);
 lwesp_port_t  lwesp_conn_get_remote_port(lwesp_conn_p conn);
@@ -50,6 +50,10 @@ extern "C" {
 lwespr_t    lwesp_dns_gethostbyname(const char* host, lwesp_ip_t* const ip, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwespr_t    lwesp_dns_get_config(lwesp_ip_t* s1, lwesp_ip_t* s2, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwespr_t    lwesp_dns_set_config(uint8_t en, const char* s1, const char* s2, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#if LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__
+void        lwesp_dns_cache_flush(void);
+lwespr_t    lwesp_dns_prefetch(const char* const* hosts, size_t hosts_len, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__ */
 
 /**
  * \}
@@ -47,7 +47,23 @@ extern "C" {
  * \{
  */
 
+/**
+ * \brief           Get event mask bit for specific event type
+ * \param[in]       type: Event type, member of \ref lwesp_evt_type_t enumeration
+ */
+#define LWESP_EVT_MASK(type)            ((uint32_t)1 << (uint32_t)(type))
+
+/**
+ * \brief           Event mask for all event types
+ */
+#define LWESP_EVT_MASK_ALL              ((uint32_t)0xFFFFFFFF)
+
 lwespr_t          lwesp_evt_register(lwesp_evt_fn fn);
+lwespr_t          lwesp_evt_register_ex(lwesp_evt_fn fn, uint32_t mask);
+#if LWESP_CFG_EVT_DEFERRED || __DOXYGEN__
+lwespr_t          lwesp_evt_register_deferred(lwesp_evt_fn fn, uint32_t mask);
+lwespr_t          lwesp_evt_deferred_process(uint32_t timeout);
+#endif /* LWESP_CFG_EVT_DEFERRED || __DOXYGEN__ */
 lwespr_t          lwesp_evt_unregister(lwesp_evt_fn fn);
 lwesp_evt_type_t  lwesp_evt_get_type(lwesp_evt_t* cc);
 
@@ -191,6 +207,58 @@ lwesp_conn_p  lwesp_evt_conn_poll_get_conn(lwesp_evt_t* cc);
  * \}
  */
 
+#if LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__
+
+/**
+ * \anchor          LWESP_EVT_CONN_TX_WATERMARK
+ * \name            Connection send queue watermark
+ * \brief           Event helper functions for \ref LWESP_EVT_CONN_TX_WATERMARK event
+ */
+
+lwesp_conn_p  lwesp_evt_conn_tx_watermark_get_conn(lwesp_evt_t* cc);
+size_t      lwesp_evt_conn_tx_watermark_get_queued(lwesp_evt_t* cc);
+uint8_t     lwesp_evt_conn_tx_watermark_is_high(lwesp_evt_t* cc);
+
+/**
+ * \}
+ */
+
+#endif /* LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__ */
+
+#if LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__
+
+/**
+ * \anchor          LWESP_EVT_CONN_SEND_ACK
+ * \name            Connection buffered send acknowledge
+ * \brief           Event helper functions for \ref LWESP_EVT_CONN_SEND_ACK event
+ */
+
+lwesp_conn_p  lwesp_evt_conn_send_ack_get_conn(lwesp_evt_t* cc);
+size_t      lwesp_evt_conn_send_ack_get_length(lwesp_evt_t* cc);
+lwespr_t    lwesp_evt_conn_send_ack_get_result(lwesp_evt_t* cc);
+
+/**
+ * \}
+ */
+
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__ */
+
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+
+/**
+ * \anchor          LWESP_EVT_CONN_RESYNC
+ * \name            Connection resync
+ * \brief           Event helper functions for \ref LWESP_EVT_CONN_RESYNC event
+ */
+
+lwesp_conn_p  lwesp_evt_conn_resync_get_conn(lwesp_evt_t* cc);
+
+/**
+ * \}
+ */
+
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
+
 /**
  * \anchor          LWESP_EVT_CONN_ERROR
  * \name            Connection error
@@ -73,6 +73,18 @@
 #include "lwesp/lwesp_smart.h"
 #endif /* LWESP_CFG_SMART || __DOXYGEN__ */
 #include "lwesp/lwesp_dhcp.h"
+#if LWESP_CFG_STATS || LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_STATS_THREAD || __DOXYGEN__
+#include "lwesp/lwesp_stats.h"
+#endif /* LWESP_CFG_STATS || LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_STATS_THREAD || __DOXYGEN__ */
+#if LWESP_CFG_CAPTURE || __DOXYGEN__
+#include "lwesp/lwesp_capture.h"
+#endif /* LWESP_CFG_CAPTURE || __DOXYGEN__ */
+#if LWESP_CFG_TRACE || __DOXYGEN__
+#include "lwesp/lwesp_trace.h"
+#endif /* LWESP_CFG_TRACE || __DOXYGEN__ */
+#if LWESP_CFG_STA_MGR || __DOXYGEN__
+#include "lwesp/lwesp_sta_mgr.h"
+#endif /* LWESP_CFG_STA_MGR || __DOXYGEN__ */
 
 #ifdef __cplusplus
 extern "C" {
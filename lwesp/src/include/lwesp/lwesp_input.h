@@ -49,6 +49,10 @@ extern "C" {
  */
 
 lwespr_t    lwesp_input(const void* data, size_t len);
+lwespr_t    lwesp_input_isr(const void* data, size_t len);
+lwespr_t    lwesp_input_notify(void);
+void*       lwesp_input_get_write_buff(size_t* len);
+lwespr_t    lwesp_input_commit(size_t len);
 lwespr_t    lwesp_input_process(const void* data, size_t len);
 
 /**
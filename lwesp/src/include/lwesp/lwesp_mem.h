@@ -47,6 +47,19 @@ extern "C" {
  * \{
  */
 
+/**
+ * \brief           Memory allocation tag, used to attribute allocations to subsystems
+ */
+typedef enum {
+    LWESP_MEM_TAG_OTHER = 0x00,                 /*!< Untagged allocation */
+    LWESP_MEM_TAG_MSG,                          /*!< Command message */
+    LWESP_MEM_TAG_PBUF,                         /*!< Packet buffer */
+    LWESP_MEM_TAG_CONN_BUFF,                    /*!< Connection send buffer */
+    LWESP_MEM_TAG_MQTT,                         /*!< MQTT client */
+    LWESP_MEM_TAG_PBUF_HDR,                     /*!< Packet buffer header without payload memory */
+    LWESP_MEM_TAG_END,                          /*!< Last tag entry, number of tags */
+} lwesp_mem_tag_t;
+
 #if !LWESP_CFG_MEM_CUSTOM || __DOXYGEN__
 
 /**
@@ -55,9 +68,50 @@ extern "C" {
 typedef struct {
     void* start_addr;                           /*!< Start address of region */
     size_t size;                                /*!< Size in units of bytes of region */
+#if LWESP_CFG_MEM_PLACEMENT || __DOXYGEN__
+    uint8_t fast;                               /*!< Set to `1` for fast memory, not reachable by DMA (DTCM, CCM),
+                                                        `0` for general purpose memory */
+#endif /* LWESP_CFG_MEM_PLACEMENT || __DOXYGEN__ */
 } lwesp_mem_region_t;
 
+#if LWESP_CFG_MEM_STATS || __DOXYGEN__
+
+/**
+ * \brief           Memory statistics for single allocation tag
+ */
+typedef struct {
+    size_t bytes_in_use;                        /*!< Currently allocated bytes */
+    size_t bytes_peak;                          /*!< Maximal allocated bytes at the same time */
+    uint32_t alloc_count;                       /*!< Number of successful allocations */
+} lwesp_mem_tag_stats_t;
+
+/**
+ * \brief           Memory manager statistics
+ */
+typedef struct {
+    uint32_t alloc_count;                       /*!< Number of successful allocations */
+    uint32_t free_count;                        /*!< Number of freed blocks */
+    uint32_t fail_count;                        /*!< Number of failed allocations */
+    size_t bytes_in_use;                        /*!< Currently allocated user bytes */
+    size_t bytes_peak;                          /*!< Maximal allocated user bytes at the same time */
+    size_t bytes_free;                          /*!< Currently available bytes */
+    size_t bytes_min_free;                      /*!< Minimal available bytes ever (low watermark) */
+    size_t largest_free_block;                  /*!< Largest single free block, indicates fragmentation */
+    lwesp_mem_tag_stats_t tags[LWESP_MEM_TAG_END];  /*!< Per-tag statistics */
+} lwesp_mem_stats_t;
+
+lwespr_t    lwesp_mem_get_stats(lwesp_mem_stats_t* stats);
+
+#endif /* LWESP_CFG_MEM_STATS || __DOXYGEN__ */
+
 uint8_t lwesp_mem_assignmemory(const lwesp_mem_region_t* regions, size_t size);
+void*   lwesp_mem_malloc_tag(size_t size, lwesp_mem_tag_t tag);
+void*   lwesp_mem_calloc_tag(size_t num, size_t size, lwesp_mem_tag_t tag);
+
+#else /* !LWESP_CFG_MEM_CUSTOM || __DOXYGEN__ */
+
+#define lwesp_mem_malloc_tag(size, tag)         lwesp_mem_malloc(size)
+#define lwesp_mem_calloc_tag(num, size, tag)    lwesp_mem_calloc((num), (size))
 
 #endif /* !LWESP_CFG_MEM_CUSTOM || __DOXYGEN__ */
 
@@ -69,16 +69,98 @@ typedef enum {
     LWESP_NETCONN_TYPE_UDP = LWESP_CONN_TYPE_UDP,   /*!< UDP connection */
 } lwesp_netconn_type_t;
 
+#if LWESP_CFG_NETCONN_SELECT || __DOXYGEN__
+
+struct lwesp_netconn_set;
+
+/**
+ * \brief           Netconn set object for waiting on multiple netconns
+ */
+typedef struct lwesp_netconn_set* lwesp_netconn_set_p;
+
+#endif /* LWESP_CFG_NETCONN_SELECT || __DOXYGEN__ */
+
+/**
+ * \brief           Datagram descriptor for \ref lwesp_netconn_sendto_many
+ */
+typedef struct {
+    const lwesp_ip_t* ip;                       /*!< Remote IP address. Set to `NULL` to use default remote of connection */
+    lwesp_port_t port;                          /*!< Remote port, used when `ip` is not `NULL` */
+    const void* data;                           /*!< Datagram data */
+    size_t len;                                 /*!< Datagram length in units of bytes */
+} lwesp_netconn_dgram_t;
+
+#if LWESP_CFG_NETCONN_MUX || __DOXYGEN__
+
+/**
+ * \brief           Netconn operations of one stack copy, used by \ref LWESP_NETCONN_MUX
+ *
+ * Handles and return values belong to stack copy which exported the operations.
+ */
+typedef struct {
+    lwesp_netconn_p (*nc_new)(lwesp_netconn_type_t type);   /*!< Create netconn, see \ref lwesp_netconn_new */
+    lwespr_t (*nc_delete)(lwesp_netconn_p nc);  /*!< Delete netconn, see \ref lwesp_netconn_delete */
+    lwespr_t (*nc_connect)(lwesp_netconn_p nc, const char* host, lwesp_port_t port);    /*!< Connect, see \ref lwesp_netconn_connect */
+    lwespr_t (*nc_write)(lwesp_netconn_p nc, const void* data, size_t btw); /*!< Write data, see \ref lwesp_netconn_write */
+    lwespr_t (*nc_flush)(lwesp_netconn_p nc);   /*!< Flush data, see \ref lwesp_netconn_flush */
+    lwespr_t (*nc_read)(lwesp_netconn_p nc, void* buf, size_t len, size_t min_len, size_t* br);    /*!< Read data, see \ref lwesp_netconn_read */
+    lwespr_t (*nc_close)(lwesp_netconn_p nc);   /*!< Close connection, see \ref lwesp_netconn_close */
+    uint8_t (*is_ready)(void);                  /*!< Check if device is present, not in reset and has IP in station mode */
+    uint32_t (*get_reset_count)(void);          /*!< Get number of device resets detected since start */
+} lwesp_netconn_mux_ops_t;
+
+extern const lwesp_netconn_mux_ops_t lwesp_netconn_mux_ops;
+
+#endif /* LWESP_CFG_NETCONN_MUX || __DOXYGEN__ */
+
+#if LWESP_CFG_NETCONN_REACTOR || __DOXYGEN__
+
+/**
+ * \brief           Reactor event type
+ */
+typedef enum {
+    LWESP_NETCONN_REACTOR_ACCEPT,               /*!< New client accepted on listening netconn, available in `client` */
+    LWESP_NETCONN_REACTOR_RECV,                 /*!< Data received, available in `pbuf`. Application must free it */
+    LWESP_NETCONN_REACTOR_WRITABLE,             /*!< Write budget available again for non-blocking write */
+    LWESP_NETCONN_REACTOR_TIMEOUT,              /*!< Idle deadline expired */
+    LWESP_NETCONN_REACTOR_CLOSED,               /*!< Connection closed by remote side or listening stopped with `res` error */
+} lwesp_netconn_reactor_evt_type_t;
+
+/**
+ * \brief           Reactor event
+ */
+typedef struct {
+    lwesp_netconn_reactor_evt_type_t type;      /*!< Event type */
+    lwesp_netconn_p nc;                         /*!< Netconn handle of event */
+    lwesp_netconn_p client;                     /*!< New client for \ref LWESP_NETCONN_REACTOR_ACCEPT */
+    lwesp_pbuf_p pbuf;                          /*!< Received data for \ref LWESP_NETCONN_REACTOR_RECV */
+    lwespr_t res;                               /*!< Result for \ref LWESP_NETCONN_REACTOR_CLOSED */
+} lwesp_netconn_reactor_evt_t;
+
+/**
+ * \brief           Reactor event callback function
+ * \param[in]       evt: Event information
+ * \param[in]       arg: Custom argument set with \ref lwesp_netconn_reactor_add
+ */
+typedef void (*lwesp_netconn_reactor_fn)(const lwesp_netconn_reactor_evt_t* evt, void* arg);
+
+#endif /* LWESP_CFG_NETCONN_REACTOR || __DOXYGEN__ */
+
 lwesp_netconn_p lwesp_netconn_new(lwesp_netconn_type_t type);
 lwespr_t        lwesp_netconn_delete(lwesp_netconn_p nc);
 lwespr_t        lwesp_netconn_bind(lwesp_netconn_p nc, lwesp_port_t port);
 lwespr_t        lwesp_netconn_connect(lwesp_netconn_p nc, const char* host, lwesp_port_t port);
 lwespr_t        lwesp_netconn_receive(lwesp_netconn_p nc, lwesp_pbuf_p* pbuf);
+lwespr_t        lwesp_netconn_receive_many(lwesp_netconn_p nc, lwesp_pbuf_p* pbufs, size_t max_pbufs, size_t* cnt);
+lwespr_t        lwesp_netconn_read(lwesp_netconn_p nc, void* buf, size_t len, size_t min_len, size_t* br);
 lwespr_t        lwesp_netconn_close(lwesp_netconn_p nc);
 int8_t          lwesp_netconn_get_connnum(lwesp_netconn_p nc);
 lwesp_conn_p    lwesp_netconn_get_conn(lwesp_netconn_p nc);
 void            lwesp_netconn_set_receive_timeout(lwesp_netconn_p nc, uint32_t timeout);
 uint32_t        lwesp_netconn_get_receive_timeout(lwesp_netconn_p nc);
+#if LWESP_CFG_NETCONN_DEADLINE || __DOXYGEN__
+lwespr_t        lwesp_netconn_set_idle_deadline(lwesp_netconn_p nc, uint32_t idle_time);
+#endif /* LWESP_CFG_NETCONN_DEADLINE || __DOXYGEN__ */
 
 lwespr_t        lwesp_netconn_connect_ex(lwesp_netconn_p nc, const char* host, lwesp_port_t port,
                                        uint16_t keep_alive, const char* local_ip, lwesp_port_t local_port, uint8_t mode);
@@ -88,12 +170,39 @@ lwespr_t        lwesp_netconn_listen(lwesp_netconn_p nc);
 lwespr_t        lwesp_netconn_listen_with_max_conn(lwesp_netconn_p nc, uint16_t max_connections);
 lwespr_t        lwesp_netconn_set_listen_conn_timeout(lwesp_netconn_p nc, uint16_t timeout);
 lwespr_t        lwesp_netconn_accept(lwesp_netconn_p nc, lwesp_netconn_p* client);
+lwespr_t        lwesp_netconn_accept_many(lwesp_netconn_p nc, lwesp_netconn_p* clients, size_t max_clients, size_t* cnt);
+lwespr_t        lwesp_netconn_set_accept_prealloc(lwesp_netconn_p nc, size_t count);
 lwespr_t        lwesp_netconn_write(lwesp_netconn_p nc, const void* data, size_t btw);
 lwespr_t        lwesp_netconn_flush(lwesp_netconn_p nc);
+#if LWESP_CFG_NETCONN_WRITE_NONBLOCK || __DOXYGEN__
+lwespr_t        lwesp_netconn_write_nonblock(lwesp_netconn_p nc, const void* data, size_t btw, size_t* const bw);
+size_t          lwesp_netconn_get_write_available(lwesp_netconn_p nc);
+#endif /* LWESP_CFG_NETCONN_WRITE_NONBLOCK || __DOXYGEN__ */
 
 /* UDP only */
 lwespr_t        lwesp_netconn_send(lwesp_netconn_p nc, const void* data, size_t btw);
 lwespr_t        lwesp_netconn_sendto(lwesp_netconn_p nc, const lwesp_ip_t* ip, lwesp_port_t port, const void* data, size_t btw);
+lwespr_t        lwesp_netconn_sendto_many(lwesp_netconn_p nc, const lwesp_netconn_dgram_t* dgrams, size_t cnt);
+
+#if LWESP_CFG_NETCONN_SELECT || __DOXYGEN__
+lwesp_netconn_set_p lwesp_netconn_set_new(void);
+lwespr_t        lwesp_netconn_set_delete(lwesp_netconn_set_p set);
+lwespr_t        lwesp_netconn_set_add(lwesp_netconn_set_p set, lwesp_netconn_p nc);
+lwespr_t        lwesp_netconn_set_remove(lwesp_netconn_set_p set, lwesp_netconn_p nc);
+lwespr_t        lwesp_netconn_select(lwesp_netconn_set_p set, uint32_t timeout);
+uint8_t         lwesp_netconn_is_ready(lwesp_netconn_p nc);
+#endif /* LWESP_CFG_NETCONN_SELECT || __DOXYGEN__ */
+
+#if LWESP_CFG_NETCONN_REACTOR || __DOXYGEN__
+lwespr_t        lwesp_netconn_reactor_add(lwesp_netconn_set_p set, lwesp_netconn_p nc, lwesp_netconn_reactor_fn fn, void* arg);
+lwespr_t        lwesp_netconn_reactor_run(lwesp_netconn_set_p set, uint32_t timeout);
+#endif /* LWESP_CFG_NETCONN_REACTOR || __DOXYGEN__ */
+
+#if LWESP_CFG_NETCONN_PREWARM || __DOXYGEN__
+lwespr_t        lwesp_netconn_prewarm_add(lwesp_netconn_type_t type, const char* host, lwesp_port_t port, size_t count);
+lwespr_t        lwesp_netconn_prewarm_remove(const char* host, lwesp_port_t port);
+size_t          lwesp_netconn_prewarm_get_ready(const char* host, lwesp_port_t port);
+#endif /* LWESP_CFG_NETCONN_PREWARM || __DOXYGEN__ */
 
 /**
  * \}
@@ -0,0 +1,91 @@
+/**
+ * \file            lwesp_netconn_mux.h
+ * \brief           Netconn multiplexer over multiple stack copies
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_NETCONN_MUX_H
+#define LWESP_HDR_NETCONN_MUX_H
+
+#include "lwesp/lwesp_netconn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWESP_API
+ * \defgroup        LWESP_NETCONN_MUX Netconn multiplexer
+ * \brief           Spread connections over multiple ESP devices
+ * \{
+ *
+ * Every ESP device is driven by own copy of the stack, built with different \ref LWESP_CFG_PREFIX.
+ * Application attaches \ref lwesp_netconn_mux_ops of every copy with \ref lwesp_netconn_mux_attach,
+ * from translation unit compiled with prefix of that copy.
+ *
+ * Each connection is opened on ready device with lowest number of multiplexed connections,
+ * devices with equal load are used in round-robin order. Independent connections and parallel
+ * upload streams thus share total UART bandwidth of all devices.
+ *
+ * Device which is reset loses its connections. Operations on them return \ref lwespCLOSED
+ * and device is skipped until reset sequence finishes (and station has IP again).
+ * Calling \ref lwesp_netconn_mux_connect again opens connection on other ready device.
+ */
+
+#if LWESP_CFG_NETCONN_MUX || __DOXYGEN__
+
+struct lwesp_netconn_mux_conn;
+
+/**
+ * \brief           Multiplexed connection handle
+ */
+typedef struct lwesp_netconn_mux_conn* lwesp_netconn_mux_conn_p;
+
+lwespr_t        lwesp_netconn_mux_attach(const lwesp_netconn_mux_ops_t* ops);
+lwesp_netconn_mux_conn_p lwesp_netconn_mux_new(lwesp_netconn_type_t type);
+lwespr_t        lwesp_netconn_mux_delete(lwesp_netconn_mux_conn_p mc);
+lwespr_t        lwesp_netconn_mux_connect(lwesp_netconn_mux_conn_p mc, const char* host, lwesp_port_t port);
+lwespr_t        lwesp_netconn_mux_write(lwesp_netconn_mux_conn_p mc, const void* data, size_t btw);
+lwespr_t        lwesp_netconn_mux_flush(lwesp_netconn_mux_conn_p mc);
+lwespr_t        lwesp_netconn_mux_read(lwesp_netconn_mux_conn_p mc, void* buf, size_t len, size_t min_len, size_t* br);
+lwespr_t        lwesp_netconn_mux_close(lwesp_netconn_mux_conn_p mc);
+int8_t          lwesp_netconn_mux_get_instance(lwesp_netconn_mux_conn_p mc);
+
+#endif /* LWESP_CFG_NETCONN_MUX || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWESP_HDR_NETCONN_MUX_H */
@@ -74,6 +74,110 @@
 #define LWESP_CFG_OS                          1
 #endif
 
+/**
+ * \brief           Prefix added to every global symbol of the library
+ *
+ * Stack state is a single global structure, one copy of the library drives one ESP device.
+ * To drive multiple devices, compile the library (including low-level driver and system port)
+ * once per device, each time with different prefix, for example `-DLWESP_CFG_PREFIX=esp2_`.
+ * Every copy has own state, threads and low-level driver, devices work in parallel.
+ *
+ * Application code for each device must be compiled with the same prefix,
+ * library functions are then called by their usual names.
+ * Options may differ between copies, for example one in station and one in access point mode.
+ *
+ * \note            Not defined by default, library symbols keep their names
+ * \note            Application translation unit may only use one copy of the library
+ *                  and must not use `esp` identifier for own purposes when prefix is defined
+ */
+#if __DOXYGEN__
+#define LWESP_CFG_PREFIX
+#endif /* __DOXYGEN__ */
+
+/**
+ * \brief           Enables `1` or disables `0` per-thread notifications for blocking API calls
+ *
+ * When enabled, thread calling blocking API function waits for completion
+ * with its own thread notification instead of semaphore created for each command.
+ * No kernel object is allocated per blocking call.
+ *
+ * \note            System port must implement \ref lwesp_sys_thread_notify_get,
+ *                  \ref lwesp_sys_thread_notify_wait and \ref lwesp_sys_thread_notify functions
+ * \note            Threads calling blocking API functions must not use the same
+ *                  notification (task notification, thread flag) for other purposes
+ */
+#ifndef LWESP_CFG_SYS_THREAD_NOTIFY
+#define LWESP_CFG_SYS_THREAD_NOTIFY           0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` thread stack usage query
+ *
+ * When enabled, \ref lwesp_get_thread_stack_free reports lowest amount of free stack
+ * (high-water mark) of producer and process threads since they were started.
+ * Use it to reduce \ref LWESP_CFG_THREAD_PRODUCER_SS and \ref LWESP_CFG_THREAD_PROCESS_SS safely.
+ *
+ * \note            System port must implement \ref lwesp_sys_thread_stack_free function
+ */
+#ifndef LWESP_CFG_SYS_THREAD_STACK_INFO
+#define LWESP_CFG_SYS_THREAD_STACK_INFO       0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` microsecond timestamp source
+ *
+ * When enabled, statistics counters and trace timestamps use \ref lwesp_sys_now_us
+ * instead of millisecond \ref lwesp_sys_now, so that short commands and thread busy periods
+ * are not rounded to `0`. Counters in units of microseconds wrap around after approximately `71` minutes.
+ *
+ * \note            System port must implement \ref lwesp_sys_now_us function
+ */
+#ifndef LWESP_CFG_SYS_NOW_US
+#define LWESP_CFG_SYS_NOW_US                  0
+#endif
+
+/**
+ * \brief           Thread placement hook, called by host system ports for every created thread
+ *
+ * Win32 and POSIX ports call it from \ref lwesp_sys_thread_create with native handle of new thread,
+ * (`HANDLE` on Win32, `pthread_t` on POSIX), before thread starts on Win32 and right after start on POSIX.
+ * This includes producer and process threads and AT port receive thread of low-level driver.
+ *
+ * Use it to set CPU affinity and priority, so that all threads of one stack instance stay on the same core
+ * and do not bounce cache lines of shared stack data between cores, for example on Win32:
+ *
+ * `#define LWESP_CFG_SYS_THREAD_CREATE_HOOK(t, name, prio)  SetThreadAffinityMask(*(t), (DWORD_PTR)1 << my_core)`
+ *
+ * and on Linux:
+ *
+ * `#define LWESP_CFG_SYS_THREAD_CREATE_HOOK(t, name, prio)  my_thread_place(*(t), (name), (prio))`
+ *
+ * \param[in]       t: Pointer to native thread handle
+ * \param[in]       name: Thread name passed to \ref lwesp_sys_thread_create
+ * \param[in]       prio: Thread priority passed to \ref lwesp_sys_thread_create
+ */
+#ifndef LWESP_CFG_SYS_THREAD_CREATE_HOOK
+#define LWESP_CFG_SYS_THREAD_CREATE_HOOK(t, name, prio)
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` cooperative run-to-completion mode
+ *
+ * When enabled, producer and process threads are not created.
+ * Application must periodically call \ref lwesp_poll from its main loop,
+ * which runs one step of input processing, timeouts and command execution without blocking.
+ *
+ * Blocking API calls drive \ref lwesp_poll internally until command finishes.
+ *
+ * \note            System port must still implement protection, semaphores and message queues.
+ *                  On bare-metal systems they may be implemented without operating system,
+ *                  thread functions are not used.
+ * \note            Netconn API is not available in this mode
+ */
+#ifndef LWESP_CFG_POLL
+#define LWESP_CFG_POLL                        0
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` custom memory management functions
  *
@@ -92,6 +196,260 @@
 #define LWESP_CFG_MEM_CUSTOM                  0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` two-level segregated fit backend for built-in allocator
+ *
+ * When enabled, free blocks are kept in lists segregated by size class,
+ * allowing allocation and free in constant time, regardless of number of free blocks.
+ * When disabled, first-fit allocation over single address-ordered free list is used.
+ *
+ * \note            Used only when \ref LWESP_CFG_MEM_CUSTOM is disabled
+ */
+#ifndef LWESP_CFG_MEM_TLSF
+#define LWESP_CFG_MEM_TLSF                    0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` placement of allocations to fast or general purpose memory regions
+ *
+ * Regions passed to \ref lwesp_mem_assignmemory may be marked as fast memory (DTCM, CCM),
+ * which is usually not reachable by DMA. Command messages and packet buffer headers
+ * without payload are allocated from fast regions first and fall back to general purpose regions.
+ * All other allocations, including packet buffer payloads and connection send buffers,
+ * are only placed to general purpose regions, to keep them reachable by DMA.
+ *
+ * \note            Used only when \ref LWESP_CFG_MEM_CUSTOM is disabled
+ * \note            Allocation from fast region may need to walk free blocks, it is not constant time
+ *                  with \ref LWESP_CFG_MEM_TLSF enabled
+ */
+#ifndef LWESP_CFG_MEM_PLACEMENT
+#define LWESP_CFG_MEM_PLACEMENT               0
+#endif
+
+/**
+ * \brief           Maximal number of fast memory regions
+ * \sa              LWESP_CFG_MEM_PLACEMENT
+ */
+#ifndef LWESP_CFG_MEM_PLACEMENT_FAST_REGIONS
+#define LWESP_CFG_MEM_PLACEMENT_FAST_REGIONS  2
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` allocation statistics in built-in memory manager
+ *
+ * When enabled, every allocation is tagged with subsystem it belongs to
+ * and statistics can be read with \ref lwesp_mem_get_stats function.
+ *
+ * \note            Valid only when \ref LWESP_CFG_MEM_CUSTOM is set to `0`
+ */
+#ifndef LWESP_CFG_MEM_STATS
+#define LWESP_CFG_MEM_STATS                   0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` heap-free profile
+ *
+ * When enabled, stack does not call \ref lwesp_mem_malloc at any time.
+ * Command messages, packet buffers, connection write buffers, event functions,
+ * deferred events, netconn objects and MQTT clients are taken from static pools,
+ * sized with configuration maxima, and allocation fails when pool is empty.
+ * Timeouts always use static pool of \ref LWESP_CFG_TIMEOUT_POOL_SIZE entries.
+ *
+ * Inconsistent pool configuration is reported at compile time,
+ * total size of static pools is returned by \ref lwesp_get_static_ram_size.
+ *
+ * \note            Modules which need variable size memory (HTTP server, HTTP client, MQTT router,
+ *                  MQTT client API, netconn select, MQTT publish backlog) cannot be used.
+ *                  System port must provide statically allocated OS objects
+ */
+#ifndef LWESP_CFG_STATIC_ONLY
+#define LWESP_CFG_STATIC_ONLY                 0
+#endif
+
+/**
+ * \brief           Number of connection write buffers of \ref LWESP_CFG_CONN_MAX_DATA_LEN bytes in static pool
+ *
+ * Every connection, which uses \ref lwesp_conn_write or netconn write, holds one buffer,
+ * while full buffers are held until data are sent
+ *
+ * \note            Used only when \ref LWESP_CFG_STATIC_ONLY or \ref LWESP_CFG_CONN_BUFF_POOL is enabled
+ */
+#ifndef LWESP_CFG_CONN_BUFF_POOL_SIZE
+#define LWESP_CFG_CONN_BUFF_POOL_SIZE         (LWESP_CFG_MAX_CONNS + 2)
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` static pool of connection write buffers with heap fallback
+ *
+ * Write buffers of \ref lwesp_conn_write are taken from pool of \ref LWESP_CFG_CONN_BUFF_POOL_SIZE entries first,
+ * heap is only used when pool is empty. It avoids heap allocation and fragmentation for every sent buffer.
+ *
+ * \note            With \ref LWESP_CFG_STATIC_ONLY, pool is always used and there is no heap fallback
+ */
+#ifndef LWESP_CFG_CONN_BUFF_POOL
+#define LWESP_CFG_CONN_BUFF_POOL              0
+#endif
+
+/**
+ * \brief           Number of registered event functions in static pool
+ *
+ * Global callback of \ref lwesp_init is not part of the pool
+ *
+ * \note            Used only when \ref LWESP_CFG_STATIC_ONLY is enabled
+ */
+#ifndef LWESP_CFG_EVT_FUNC_POOL_SIZE
+#define LWESP_CFG_EVT_FUNC_POOL_SIZE          4
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` runtime statistics
+ *
+ * When enabled, every AT command is timestamped when it is queued, started,
+ * when first response byte arrives and when it finishes.
+ * Latency histograms per command type can be read with \ref lwesp_stats_get_cmd function.
+ *
+ * \note            Statistics require approximately `(7 + LWESP_CFG_STATS_HIST_BUCKETS) * 4` bytes of RAM per command type
+ */
+#ifndef LWESP_CFG_STATS
+#define LWESP_CFG_STATS                       0
+#endif
+
+/**
+ * \brief           Number of log-bucketed entries in command latency histogram
+ *
+ * Last bucket counts all executions longer than `2^(LWESP_CFG_STATS_HIST_BUCKETS - 2)` milliseconds.
+ * Histogram is kept in milliseconds regardless of \ref LWESP_CFG_SYS_NOW_US
+ */
+#ifndef LWESP_CFG_STATS_HIST_BUCKETS
+#define LWESP_CFG_STATS_HIST_BUCKETS          12
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` traffic statistics
+ *
+ * When enabled, library counts AT port bytes in both directions,
+ * bytes and packets per connection, `CIPSEND` retries, `SEND FAIL` events
+ * and received packets dropped due to allocation failure.
+ * Statistics can be read with \ref lwesp_stats_get and \ref lwesp_stats_get_conn functions.
+ *
+ * Counters are plain 32-bit increments without extra locking,
+ * so they are cheap enough to be left enabled in production builds.
+ */
+#ifndef LWESP_CFG_STATS_TRAFFIC
+#define LWESP_CFG_STATS_TRAFFIC               0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` thread and mailbox utilization statistics
+ *
+ * When enabled, library counts depth high-water mark and write failures
+ * of producer and process mailboxes and accounts time producer and process threads
+ * spend working, waiting for new message and, for producer, waiting for command to finish.
+ * Statistics are part of \ref lwesp_stats_get output
+ * and are passed to \ref LWESP_THREAD_PRODUCER_STATS_HOOK and \ref LWESP_THREAD_PROCESS_STATS_HOOK.
+ *
+ * \note            Time is measured with \ref lwesp_sys_now, in units of milliseconds
+ */
+#ifndef LWESP_CFG_STATS_THREAD
+#define LWESP_CFG_STATS_THREAD                0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` AT port capture
+ *
+ * When enabled, every chunk of data received from and sent to AT port
+ * can be recorded with timestamp to capture ring buffer and read by application,
+ * for example to store it to file and replay it later with `lwesp_ll_replay.c` driver.
+ *
+ * \sa              LWESP_CAPTURE
+ */
+#ifndef LWESP_CFG_CAPTURE
+#define LWESP_CFG_CAPTURE                     0
+#endif
+
+/**
+ * \brief           Size of AT port capture ring buffer in units of bytes
+ *
+ * Buffer is allocated when capture is started for the first time.
+ * Records that do not fit to buffer are dropped until application reads data out
+ */
+#ifndef LWESP_CFG_CAPTURE_BUFF_SIZE
+#define LWESP_CFG_CAPTURE_BUFF_SIZE           0x2000
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` trace points
+ *
+ * Trace points record event ID and integer arguments to ring buffer,
+ * without locking and without formatting, to follow timing of the stack in production builds.
+ * When disabled, trace points compile to nothing.
+ *
+ * \sa              LWESP_TRACE
+ */
+#ifndef LWESP_CFG_TRACE
+#define LWESP_CFG_TRACE                       0
+#endif
+
+/**
+ * \brief           Number of events in trace ring buffer
+ *
+ * \note            Value must be power of `2`
+ */
+#ifndef LWESP_CFG_TRACE_BUFF_LEN
+#define LWESP_CFG_TRACE_BUFF_LEN              256
+#endif
+
+/**
+ * \brief           Get current time for trace event
+ *
+ * Default uses \ref lwesp_sys_now, which has millisecond resolution,
+ * or \ref lwesp_sys_now_us when \ref LWESP_CFG_SYS_NOW_US is enabled.
+ * For finer resolution, define it to hardware counter, such as `DWT->CYCCNT` on ARM Cortex-M,
+ * and set \ref LWESP_CFG_TRACE_TIME_FREQ accordingly
+ */
+#ifndef LWESP_CFG_TRACE_TIME
+#if LWESP_CFG_SYS_NOW_US
+#define LWESP_CFG_TRACE_TIME()                lwesp_sys_now_us()
+#else /* LWESP_CFG_SYS_NOW_US */
+#define LWESP_CFG_TRACE_TIME()                lwesp_sys_now()
+#endif /* !LWESP_CFG_SYS_NOW_US */
+#endif
+
+/**
+ * \brief           Frequency of \ref LWESP_CFG_TRACE_TIME counter in units of Hz
+ */
+#ifndef LWESP_CFG_TRACE_TIME_FREQ
+#if LWESP_CFG_SYS_NOW_US
+#define LWESP_CFG_TRACE_TIME_FREQ             1000000
+#else /* LWESP_CFG_SYS_NOW_US */
+#define LWESP_CFG_TRACE_TIME_FREQ             1000
+#endif /* !LWESP_CFG_SYS_NOW_US */
+#endif
+
+/**
+ * \brief           Atomically increment 32-bit variable and return its previous value
+ *
+ * Used to reserve slot in trace buffer, as trace points are called from multiple threads.
+ * Default is \ref LWESP_CFG_ATOMIC_INC
+ */
+#ifndef LWESP_CFG_TRACE_ATOMIC_INC
+#define LWESP_CFG_TRACE_ATOMIC_INC(ptr)       LWESP_CFG_ATOMIC_INC(ptr)
+#endif
+
+/**
+ * \brief           Trace hook, called for every recorded event
+ *
+ * It can be used to forward events to live tracer, for example
+ * to SEGGER SystemView with `SEGGER_SYSVIEW_RecordU32x2(user_id_base + (id), (a), (b))`
+ *
+ * \param[in]       id: Event ID, member of \ref lwesp_trace_id_t
+ * \param[in]       a: First event argument
+ * \param[in]       b: Second event argument
+ */
+#ifndef LWESP_CFG_TRACE_HOOK
+#define LWESP_CFG_TRACE_HOOK(id, a, b)
+#endif
+
 /**
  * \brief           Memory alignment for dynamic memory allocations
  *
@@ -120,6 +478,8 @@
 /**
  * \brief           Maximal number of connections AT software can support on ESP device
  * \note            In case of official AT software, leave this on default value (`5`)
+ *
+ * Connection status is kept in bitmap, values up to `255` are supported
  */
 #ifndef LWESP_CFG_MAX_CONNS
 #define LWESP_CFG_MAX_CONNS                   5
@@ -139,6 +499,37 @@
 #define LWESP_CFG_CONN_MAX_DATA_LEN           2048
 #endif
 
+/**
+ * \brief           Upper limit of bytes sent with single command, when device firmware accepts more
+ *
+ * When set above \ref LWESP_CFG_CONN_MAX_DATA_LEN, stack detects maximal length
+ * of `AT+CIPSEND` from device type and AT version after reset (`8192` bytes on ESP32 with AT `v2` or later)
+ * and sizes send chunks and connection write buffers at runtime,
+ * up to this value. Current value is read with \ref lwesp_conn_get_max_data_len
+ *
+ * \note            \ref LWESP_CFG_CONN_MAX_DATA_LEN is used until device is detected
+ *                  and on firmware without larger send support
+ */
+#ifndef LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT
+#define LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT     LWESP_CFG_CONN_MAX_DATA_LEN
+#endif
+
+/**
+ * \brief           Default time in units of milliseconds, after which partially filled
+ *                  write buffer of \ref lwesp_conn_write is sent automatically
+ *
+ * Timer starts with first byte written to empty buffer and is not restarted by following writes,
+ * many small writes are combined into single `AT+CIPSEND` with bounded latency.
+ * Time is set per connection with \ref lwesp_conn_set_write_flush_time
+ *
+ * Set to `0` to disable feature, data then wait in buffer until it is full or flushed
+ *
+ * \note            Each connection with pending data uses one entry of \ref LWESP_CFG_TIMEOUT_POOL_SIZE
+ */
+#ifndef LWESP_CFG_CONN_WRITE_FLUSH_TIME
+#define LWESP_CFG_CONN_WRITE_FLUSH_TIME       0
+#endif
+
 /**
  * \brief           Set number of retries for send data command.
  *
@@ -150,382 +541,1630 @@
 #endif
 
 /**
- * \brief           Maximum single buffer size for network receive data on active connection
- *
- * \note            When ESP sends buffer bigger than maximal, multiple buffers are created
+ * \brief           Maximal time in units of milliseconds to send data with `AT+CIPSEND`,
+ *                  including time spent waiting in producer queue
  */
-#ifndef LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE
-#define LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE     1460
+#ifndef LWESP_CFG_CONN_SEND_TIMEOUT
+#define LWESP_CFG_CONN_SEND_TIMEOUT           60000
 #endif
 
 /**
- * \brief           Default baudrate used for AT port
+ * \brief           Enables `1` or disables `0` runtime tuning of performance parameters
  *
- * \note            User may call API function to change to desired baudrate if necessary
+ * When enabled, \ref lwesp_set_param changes poll interval, send chunk length, send retries,
+ * receive buffer size and send timeout without rebuilding the application.
+ * Compile time options are used as default values and as upper bounds,
+ * where they define size of static resources.
+ *
+ * \sa              lwesp_param_t
  */
-#ifndef LWESP_CFG_AT_PORT_BAUDRATE
-#define LWESP_CFG_AT_PORT_BAUDRATE            115200
+#ifndef LWESP_CFG_RUNTIME_PARAMS
+#define LWESP_CFG_RUNTIME_PARAMS              0
 #endif
 
 /**
- * \brief           Enables `1` or disables `0` ESP acting as station
+ * \brief           Enables `1` or disables `0` coalescing of queued send commands
  *
- * \note            When device is in station mode, it can connect to other access points
+ * When enabled, producer thread merges consecutive non-blocking send commands
+ * for the same connection, already waiting in the queue, into command being started.
+ * Merged data are sent with the same `AT+CIPSEND` commands, up to \ref LWESP_CFG_CONN_MAX_DATA_LEN bytes each,
+ * and next `AT+CIPSEND` is issued immediately after `SEND OK` is received,
+ * without going back to the message queue.
+ *
+ * \note            Send event of merged command is reported as soon as all its data are sent,
+ *                  while event of the first command is reported when complete group has finished
  */
-#ifndef LWESP_CFG_MODE_STATION
-#define LWESP_CFG_MODE_STATION                1
+#ifndef LWESP_CFG_CONN_SEND_COALESCE
+#define LWESP_CFG_CONN_SEND_COALESCE          0
 #endif
 
 /**
- * \brief           Enables `1` or disables `0` ESP acting as access point
+ * \brief           Enables `1` or disables `0` buffered send mode for TCP connections
  *
- * \note            When device is in access point mode, it can accept connections from other stations
+ * When enabled, data on TCP connections are sent with `AT+CIPSENDBUF` command.
+ * Chunk is complete as soon as device copies it to its internal buffer (`Recv x bytes`),
+ * next chunk is sent immediately, without waiting for `SEND OK` from remote side.
+ *
+ * Device later reports acknowledge of each segment asynchronously,
+ * which is forwarded to application with \ref LWESP_EVT_CONN_SEND_ACK event.
+ *
+ * \note            `AT+CIPSENDBUF` is available on ESP8266 AT firmware `1.x` only.
+ *                  UDP and SSL connections always use regular `AT+CIPSEND` command
+ * \sa              LWESP_CFG_CONN_SEND_BUFFERED_SEGMENTS
  */
-#ifndef LWESP_CFG_MODE_ACCESS_POINT
-#define LWESP_CFG_MODE_ACCESS_POINT           1
+#ifndef LWESP_CFG_CONN_SEND_BUFFERED
+#define LWESP_CFG_CONN_SEND_BUFFERED          0
 #endif
 
 /**
- * \brief           Buffer size for received data waiting to be processed
- * \note            When server mode is active and a lot of connections are in queue
- *                  this should be set high otherwise your buffer may overflow
+ * \brief           Maximal number of not yet acknowledged segments per connection in buffered send mode
  *
- * \note            Buffer size also depends on TX user driver if it uses DMA or blocking mode.
- *                  In case of DMA (CPU can work other tasks), buffer may be smaller as CPU
- *                  will have more time to process all the incoming bytes
+ * When all segments are in flight, stack polls `AT+CIPBUFSTATUS` for acknowledged ones
+ * before it queues new chunk to device buffer.
  *
- * \note            This parameter has no meaning when \ref LWESP_CFG_INPUT_USE_PROCESS is enabled
+ * \note            Used when \ref LWESP_CFG_CONN_SEND_BUFFERED is enabled
  */
-#ifndef LWESP_CFG_RCV_BUFF_SIZE
-#define LWESP_CFG_RCV_BUFF_SIZE               0x400
+#ifndef LWESP_CFG_CONN_SEND_BUFFERED_SEGMENTS
+#define LWESP_CFG_CONN_SEND_BUFFERED_SEGMENTS 8
 #endif
 
 /**
- * \brief           Enables `1` or disables `0` reset sequence after \ref lwesp_init call
+ * \brief           Enables `1` or disables `0` send queue tracking per connection
  *
- * \note            When this functionality is disabled, user must manually call \ref lwesp_reset to send
- *                  reset sequence to ESP device.
+ * When enabled, stack counts bytes accepted by send functions but not yet reported
+ * with \ref LWESP_EVT_CONN_SEND event. Application reads it with \ref lwesp_conn_get_tx_queued
+ * and receives \ref LWESP_EVT_CONN_TX_WATERMARK event when queue crosses high or low watermark.
+ *
+ * \sa              LWESP_CFG_CONN_TX_QUEUE_HIGH, LWESP_CFG_CONN_TX_QUEUE_LOW
  */
-#ifndef LWESP_CFG_RESET_ON_INIT
-#define LWESP_CFG_RESET_ON_INIT               1
+#ifndef LWESP_CFG_CONN_TX_QUEUE
+#define LWESP_CFG_CONN_TX_QUEUE               0
 #endif
 
 /**
- * \brief           Enables `1` or disables `0` device restore after \ref lwesp_init call
+ * \brief           Default high watermark of connection send queue, in units of bytes
  *
- * \note            When this feature is enabled, it will automatically
- *                  restore and clear any settings stored as \em default in ESP device
+ * Reaching this level sends \ref LWESP_EVT_CONN_TX_WATERMARK event with high status.
+ * Set to `0` to disable watermark events by default
+ *
+ * \note            Used when \ref LWESP_CFG_CONN_TX_QUEUE is enabled.
+ *                  Watermarks may be changed per connection with \ref lwesp_conn_set_tx_watermark
  */
-#ifndef LWESP_CFG_RESTORE_ON_INIT
-#define LWESP_CFG_RESTORE_ON_INIT             1
+#ifndef LWESP_CFG_CONN_TX_QUEUE_HIGH
+#define LWESP_CFG_CONN_TX_QUEUE_HIGH          8192
 #endif
 
 /**
- * \brief           Enables `1` or disables `0` reset sequence after \ref lwesp_device_set_present call
+ * \brief           Default low watermark of connection send queue, in units of bytes
  *
- * \note            When this functionality is disabled, user must manually call \ref lwesp_reset to send
- *                  reset sequence to ESP device.
+ * After high watermark was reached, dropping to this level or below
+ * sends \ref LWESP_EVT_CONN_TX_WATERMARK event with low status.
+ *
+ * \note            Used when \ref LWESP_CFG_CONN_TX_QUEUE is enabled
  */
-#ifndef LWESP_CFG_RESET_ON_DEVICE_PRESENT
-#define LWESP_CFG_RESET_ON_DEVICE_PRESENT     1
+#ifndef LWESP_CFG_CONN_TX_QUEUE_LOW
+#define LWESP_CFG_CONN_TX_QUEUE_LOW           2048
 #endif
 
 /**
- * \brief           Default delay (milliseconds unit) before sending first AT command on reset sequence
+ * \brief           Enables `1` or disables `0` aggregated send events
  *
+ * Connection opted in with \ref lwesp_conn_set_send_evt_batch reports
+ * \ref LWESP_EVT_CONN_SEND event with cumulative number of sent bytes,
+ * once batch size is reached, when connection send queue becomes empty or on error,
+ * instead of once per every send command.
+ *
+ * \note            In order to use this, \ref LWESP_CFG_CONN_TX_QUEUE must be enabled
  */
-#ifndef LWESP_CFG_RESET_DELAY_DEFAULT
-#define LWESP_CFG_RESET_DELAY_DEFAULT         1000
+#ifndef LWESP_CFG_CONN_SEND_EVT_AGGR
+#define LWESP_CFG_CONN_SEND_EVT_AGGR          0
 #endif
 
 /**
- * \brief           Maximum length of SSID for access point scan
+ * \brief           Enables `1` or disables `0` \ref lwesp_conn_sendfile function
  *
- * \note            This parameter must include trailling zero
+ * Data source is read directly into connection send buffers,
+ * which are handed to `AT+CIPSEND` without another copy.
+ *
+ * \sa              LWESP_CFG_CONN_SENDFILE_READ_AHEAD
  */
-#ifndef LWESP_CFG_MAX_SSID_LENGTH
-#define LWESP_CFG_MAX_SSID_LENGTH             21
+#ifndef LWESP_CFG_CONN_SENDFILE
+#define LWESP_CFG_CONN_SENDFILE               0
 #endif
 
 /**
- * \brief           Maximum length of PWD for access point
+ * \brief           Number of send buffers read ahead and queued per connection by \ref lwesp_conn_sendfile
  *
- * \note            This parameter must include trailling zero
+ * Next buffer is read while previous ones are being sent.
+ * Each buffer is \ref LWESP_CFG_CONN_MAX_DATA_LEN bytes long
+ *
+ * \note            Used when \ref LWESP_CFG_CONN_SENDFILE is enabled
  */
-#ifndef LWESP_CFG_MAX_PWD_LENGTH
-#define LWESP_CFG_MAX_PWD_LENGTH             65
+#ifndef LWESP_CFG_CONN_SENDFILE_READ_AHEAD
+#define LWESP_CFG_CONN_SENDFILE_READ_AHEAD    2
 #endif
 
 /**
- * \defgroup        LWESP_OPT_DBG Debugging
- * \brief           Debugging configurations
- * \{
- */
-
-/**
- * \brief           Set global debug support
+ * \brief           Enables `1` or disables `0` transparent transmission (passthrough) mode
  *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ * When enabled, single client connection may be started in `AT+CIPMODE=1` mode,
+ * where all data are sent and received without `AT+CIPSEND` and `+IPD` framing.
  *
- * \note            Set to \ref LWESP_DBG_OFF to globally disable all debugs
+ * \note            ESP device supports passthrough only in single connection mode (`AT+CIPMUX=0`).
+ *                  No other connection may be active while passthrough mode is used
+ *                  and no other AT commands are accepted until it is stopped
  */
-#ifndef LWESP_CFG_DBG
-#define LWESP_CFG_DBG                         LWESP_DBG_OFF
+#ifndef LWESP_CFG_CONN_PASSTHROUGH
+#define LWESP_CFG_CONN_PASSTHROUGH            0
 #endif
 
 /**
- * \brief           Debugging output function
+ * \brief           Guard time in units of milliseconds before and after `+++` exit sequence
  *
- * Called with format and optional parameters for printf-like debug
+ * ESP device requires silent period on AT port for exit sequence to be recognized
  */
-#ifndef LWESP_CFG_DBG_OUT
-#define LWESP_CFG_DBG_OUT(fmt, ...)           do { extern int printf( const char * format, ... ); printf(fmt, ## __VA_ARGS__); } while (0)
+#ifndef LWESP_CFG_CONN_PASSTHROUGH_GUARD_TIME
+#define LWESP_CFG_CONN_PASSTHROUGH_GUARD_TIME 1000
 #endif
 
 /**
- * \brief           Minimal debug level
+ * \brief           Maximum single buffer size for network receive data on active connection
  *
- * Check \ref LWESP_DBG_LVL for possible values
+ * \note            When ESP sends buffer bigger than maximal, multiple buffers are created
  */
-#ifndef LWESP_CFG_DBG_LVL_MIN
-#define LWESP_CFG_DBG_LVL_MIN                 LWESP_DBG_LVL_ALL
+#ifndef LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE
+#define LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE     1460
 #endif
 
 /**
- * \brief           Enabled debug types
+ * \brief           Minimal number of bytes to collect on TCP or SSL connection
+ *                  before \ref LWESP_EVT_CONN_RECV event is sent to application
  *
- * When debug is globally enabled with \ref LWESP_CFG_DBG parameter,
- * user must enable debug types such as TRACE or STATE messages.
+ * When ESP splits data stream to many short `+IPD` packets, their packet buffers are chained together
+ * and delivered with single event, once at least this number of bytes is received,
+ * \ref LWESP_CFG_CONN_RECV_COALESCE_TIME expires or connection is closed.
  *
- * Check \ref LWESP_DBG_TYPE for possible options. Separate values with `bitwise OR` operator
+ * Set to `0` to disable coalescing and deliver every packet buffer immediately
+ *
+ * \note            Received packet buffer may be a chain, application must not rely on linear memory
+ */
+#ifndef LWESP_CFG_CONN_RECV_COALESCE_LEN
+#define LWESP_CFG_CONN_RECV_COALESCE_LEN      0
+#endif
+
+/**
+ * \brief           Maximal time in units of milliseconds received data may wait for coalescing
+ * \sa              LWESP_CFG_CONN_RECV_COALESCE_LEN
+ */
+#ifndef LWESP_CFG_CONN_RECV_COALESCE_TIME
+#define LWESP_CFG_CONN_RECV_COALESCE_TIME     5
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` cache of remote IP and port in `+IPD` header
+ *
+ * With `AT+CIPDINFO=1`, every received packet reports remote IP and port.
+ * When enabled, last reported string is kept per connection and parsing is skipped
+ * for packets from the same remote, such as high-rate UDP stream from single peer
+ */
+#ifndef LWESP_CFG_CONN_IPD_INFO_CACHE
+#define LWESP_CFG_CONN_IPD_INFO_CACHE         0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` per-connection filter of received `+IPD` data
+ *
+ * Filter set with \ref lwesp_conn_set_ipd_filter is called once `+IPD` header is parsed,
+ * before packet buffer is allocated. It may accept, drop or cap packet,
+ * dropped data are skipped without memory allocation and without \ref LWESP_EVT_CONN_RECV event.
+ *
+ * \note            Data read manually with \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE are not filtered
+ */
+#ifndef LWESP_CFG_CONN_IPD_FILTER
+#define LWESP_CFG_CONN_IPD_FILTER             0
+#endif
+
+/**
+ * \brief           Number of preallocated packet buffers in each pool size class
+ *
+ * When set to value greater than `0`, \ref lwesp_pbuf_new takes memory from
+ * static pools first and falls back to generic memory allocator,
+ * when size is too big or pool is empty.
+ * With \ref LWESP_CFG_STATIC_ONLY, there is no fallback and allocation fails instead.
+ * Pool memory is fixed-size which prevents heap fragmentation under sustained receive load.
+ *
+ * Size classes are defined with \ref LWESP_CFG_PBUF_POOL_SMALL_LEN,
+ * \ref LWESP_CFG_PBUF_POOL_MEDIUM_LEN and \ref LWESP_CFG_PBUF_POOL_LARGE_LEN
+ *
+ * \note            Set to `0` to disable pools
+ */
+#ifndef LWESP_CFG_PBUF_POOL_SIZE
+#if LWESP_CFG_STATIC_ONLY
+#define LWESP_CFG_PBUF_POOL_SIZE              (2 * LWESP_CFG_MAX_CONNS)
+#else /* LWESP_CFG_STATIC_ONLY */
+#define LWESP_CFG_PBUF_POOL_SIZE              0
+#endif /* !LWESP_CFG_STATIC_ONLY */
+#endif
+
+/**
+ * \brief           Payload length of small packet buffer pool class
+ * \sa              LWESP_CFG_PBUF_POOL_SIZE
+ */
+#ifndef LWESP_CFG_PBUF_POOL_SMALL_LEN
+#define LWESP_CFG_PBUF_POOL_SMALL_LEN         128
+#endif
+
+/**
+ * \brief           Payload length of medium packet buffer pool class
+ * \sa              LWESP_CFG_PBUF_POOL_SIZE
+ */
+#ifndef LWESP_CFG_PBUF_POOL_MEDIUM_LEN
+#define LWESP_CFG_PBUF_POOL_MEDIUM_LEN        512
+#endif
+
+/**
+ * \brief           Payload length of large packet buffer pool class
+ * \note            It should be aligned with \ref LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE
+ * \sa              LWESP_CFG_PBUF_POOL_SIZE
+ */
+#ifndef LWESP_CFG_PBUF_POOL_LARGE_LEN
+#define LWESP_CFG_PBUF_POOL_LARGE_LEN         LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE
+#endif
+
+/**
+ * \brief           Default baudrate used for AT port
+ *
+ * \note            User may call API function to change to desired baudrate if necessary
+ */
+#ifndef LWESP_CFG_AT_PORT_BAUDRATE
+#define LWESP_CFG_AT_PORT_BAUDRATE            115200
+#endif
+
+/**
+ * \brief           Hardware flow control mode used for AT port
+ *
+ * Value is sent to device with `AT+UART_CUR` command during reset sequence
+ * and is set to \ref lwesp_ll_t.uart `flow_control` once device applies it.
+ *
+ *  - `0`: Flow control disabled
+ *  - `1`: Device uses `RTS` line, host must enable `CTS` input
+ *  - `2`: Device uses `CTS` line, host must enable `RTS` output
+ *  - `3`: Both `RTS` and `CTS` lines are used
+ *
+ * \note            Low-level driver must support selected mode in \ref lwesp_ll_init
+ */
+#ifndef LWESP_CFG_AT_PORT_FLOW_CONTROL
+#define LWESP_CFG_AT_PORT_FLOW_CONTROL        0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` automatic AT port baudrate negotiation after \ref lwesp_init
+ *
+ * When enabled, \ref lwesp_set_at_baudrate_auto is called after reset sequence,
+ * to move the link to the highest rate from \ref LWESP_CFG_AT_PORT_AUTOBAUD_RATES
+ * list, supported by device and by host (\ref lwesp_ll_t.uart `max_baudrate`).
+ */
+#ifndef LWESP_CFG_AT_PORT_AUTOBAUD
+#define LWESP_CFG_AT_PORT_AUTOBAUD            0
+#endif
+
+/**
+ * \brief           Comma separated list of candidate baudrates for automatic negotiation, highest first
+ */
+#ifndef LWESP_CFG_AT_PORT_AUTOBAUD_RATES
+#define LWESP_CFG_AT_PORT_AUTOBAUD_RATES      2000000, 1500000, 1152000, 921600, 460800, 230400
+#endif
+
+/**
+ * \brief           Time in units of milliseconds to wait for `AT` response after baudrate change,
+ *                  before link at new baudrate is considered unstable
+ */
+#ifndef LWESP_CFG_AT_PORT_AUTOBAUD_VERIFY_TIME
+#define LWESP_CFG_AT_PORT_AUTOBAUD_VERIFY_TIME  100
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` ESP acting as station
+ *
+ * \note            When device is in station mode, it can connect to other access points
+ */
+#ifndef LWESP_CFG_MODE_STATION
+#define LWESP_CFG_MODE_STATION                1
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` fast join to last joined access point
+ *
+ * BSSID of access point is cached after successful join or \ref lwesp_sta_get_ap_info call.
+ * Next \ref lwesp_sta_join to the same SSID without explicit MAC address targets cached BSSID
+ * and uses fast scan, which stops at first matching access point instead of scanning all channels.
+ * When fast attempt fails, cache is invalidated and join is repeated with full scan.
+ *
+ * \note            This feature requires \ref LWESP_CFG_MODE_STATION
+ */
+#ifndef LWESP_CFG_STA_FAST_JOIN
+#define LWESP_CFG_STA_FAST_JOIN               0
+#endif
+
+/**
+ * \brief           Timeout of fast join attempt in units of seconds, before full scan join is used
+ *
+ * \note            Value must be between `3` and `600`. Used with AT firmware `2.2` or later,
+ *                  older firmware only receives cached BSSID
+ */
+#ifndef LWESP_CFG_STA_FAST_JOIN_TIMEOUT
+#define LWESP_CFG_STA_FAST_JOIN_TIMEOUT       5
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` station manager
+ *
+ * Manager scans for known networks in background while station is connected,
+ * keeps candidates ranked by RSSI and joins best one with cached BSSID when link is lost
+ *
+ * \note            This feature requires \ref LWESP_CFG_MODE_STATION and \ref LWESP_CFG_USE_API_FUNC_EVT
+ * \sa              LWESP_STA_MGR
+ */
+#ifndef LWESP_CFG_STA_MGR
+#define LWESP_CFG_STA_MGR                     0
+#endif
+
+/**
+ * \brief           Maximal number of candidate access points kept by station manager
+ */
+#ifndef LWESP_CFG_STA_MGR_CANDIDATES
+#define LWESP_CFG_STA_MGR_CANDIDATES          4
+#endif
+
+/**
+ * \brief           RSSI of current access point, below which station manager roams to stronger candidate
+ *
+ * Set to `-128` to roam only when link is lost
+ */
+#ifndef LWESP_CFG_STA_MGR_ROAM_RSSI
+#define LWESP_CFG_STA_MGR_ROAM_RSSI           -75
+#endif
+
+/**
+ * \brief           Minimal RSSI difference in units of `dB`, candidate must be stronger by to roam to it
+ */
+#ifndef LWESP_CFG_STA_MGR_ROAM_HYST
+#define LWESP_CFG_STA_MGR_ROAM_HYST           8
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` ESP acting as access point
+ *
+ * \note            When device is in access point mode, it can accept connections from other stations
+ */
+#ifndef LWESP_CFG_MODE_ACCESS_POINT
+#define LWESP_CFG_MODE_ACCESS_POINT           1
+#endif
+
+/**
+ * \brief           Maximal number of stations in local table of stations connected to access point
+ *
+ * Table is maintained from `+STA_CONNECTED`, `+STA_DISCONNECTED` and `+DIST_STA_IP` messages
+ * and reconciled with every `AT+CWLIF` response. Set to `0` to disable the table.
+ *
+ * \note            \ref LWESP_CFG_MODE_ACCESS_POINT must be enabled
+ * \sa              lwesp_ap_sta_table_get
+ */
+#ifndef LWESP_CFG_AP_STA_TABLE
+#define LWESP_CFG_AP_STA_TABLE                0
+#endif
+
+/**
+ * \brief           Buffer size for received data waiting to be processed
+ * \note            When server mode is active and a lot of connections are in queue
+ *                  this should be set high otherwise your buffer may overflow
+ *
+ * \note            Buffer size also depends on TX user driver if it uses DMA or blocking mode.
+ *                  In case of DMA (CPU can work other tasks), buffer may be smaller as CPU
+ *                  will have more time to process all the incoming bytes
+ *
+ * \note            This parameter has no meaning when \ref LWESP_CFG_INPUT_USE_PROCESS is enabled
+ */
+#ifndef LWESP_CFG_RCV_BUFF_SIZE
+#define LWESP_CFG_RCV_BUFF_SIZE               0x400
+#endif
+
+/**
+ * \brief           Maximal size of input buffer when it grows on overflow
+ *
+ * When \ref lwesp_input cannot write all data, input buffer is reallocated
+ * to double size, up to this value. Set equal to \ref LWESP_CFG_RCV_BUFF_SIZE to disable growth.
+ *
+ * \note            Buffer is not grown from \ref lwesp_input_isr,
+ *                  with \ref LWESP_CFG_STATIC_ONLY, or while zero-copy packet buffers reference its memory
+ * \note            This parameter has no meaning when \ref LWESP_CFG_INPUT_USE_PROCESS is enabled
+ */
+#ifndef LWESP_CFG_RCV_BUFF_SIZE_MAX
+#define LWESP_CFG_RCV_BUFF_SIZE_MAX           LWESP_CFG_RCV_BUFF_SIZE
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` power-of-two ring buffer variant
+ *
+ * When enabled, every \ref LWESP_BUFF buffer initialized with size of power of two
+ * uses free-running read and write pointers with mask indexing.
+ * Wrap checks are not needed and full buffer capacity is available, instead of `size - 1`.
+ * Other buffers keep generic implementation.
+ */
+#ifndef LWESP_CFG_BUFF_POW2
+#define LWESP_CFG_BUFF_POW2                   0
+#endif
+
+/**
+ * \brief           Size of AT command assembly buffer in units of bytes
+ *
+ * Command line (`AT`, parameters and `CRLF`) is first formatted into this buffer
+ * and then passed to low-level send function with single call, followed by flush.
+ * Commands longer than buffer are split into multiple low-level writes,
+ * while connection payload larger than buffer is passed to low-level driver directly.
+ *
+ * Set to `0` to disable buffering and send every command part separately
+ *
+ * \note            Buffer is statically allocated
+ */
+#ifndef LWESP_CFG_AT_CMD_BUFF_LEN
+#define LWESP_CFG_AT_CMD_BUFF_LEN             128
+#endif
+
+/**
+ * \brief           Size of receive line buffer in units of bytes
+ *
+ * Every response line from device (up to and including `\n` character) is collected
+ * into this buffer before it is parsed. Characters beyond buffer size are dropped,
+ * line is still parsed and truncation is counted in \ref lwesp_stats_t.
+ *
+ * Increase it when long `+CWLAP` (long SSIDs), `+CIPSTATUS` or `+CIPDOMAIN` lines get truncated
+ *
+ * \note            Buffer is statically allocated
+ */
+#ifndef LWESP_CFG_RECV_LINE_BUFF_LEN
+#define LWESP_CFG_RECV_LINE_BUFF_LEN          128
+#endif
+
+/**
+ * \brief           Number of bytes written with \ref lwesp_input before processing thread is woken-up
+ *
+ * Processing thread is notified only once until it processes input buffer,
+ * regardless of number of \ref lwesp_input calls in between.
+ * Data below threshold are processed on next periodic wakeup of processing thread,
+ * or immediately after \ref lwesp_input_notify call (for example on UART idle line event)
+ *
+ * \note            Value `1` notifies processing thread on every burst of data.
+ *                  This parameter has no meaning when \ref LWESP_CFG_INPUT_USE_PROCESS is enabled
+ */
+#ifndef LWESP_CFG_INPUT_WAKEUP_THRESHOLD
+#define LWESP_CFG_INPUT_WAKEUP_THRESHOLD      1
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` tickless operation of processing thread
+ *
+ * By default, processing thread wakes up every `10` milliseconds to process input buffer
+ * when there is no active timeout. When enabled, processing thread sleeps
+ * until next timeout expires or until it is notified by \ref lwesp_input or \ref lwesp_input_notify.
+ * Use \ref lwesp_timeout_next_deadline to get maximal sleep time for tickless idle of the RTOS.
+ *
+ * \note            Data below \ref LWESP_CFG_INPUT_WAKEUP_THRESHOLD stay in buffer
+ *                  until \ref lwesp_input_notify is called, for example on UART idle line event
+ * \note            Connection poll events still wake up processing thread,
+ *                  use \ref LWESP_CFG_CONN_POLL_INTERVAL_MAX to reduce their rate.
+ *                  This parameter has no meaning when \ref LWESP_CFG_INPUT_USE_PROCESS is enabled
+ */
+#ifndef LWESP_CFG_TICKLESS_IDLE
+#define LWESP_CFG_TICKLESS_IDLE               0
+#endif
+
+/**
+ * \brief           Maximal number of input bytes processed with core locked at a time
+ *
+ * Input data are parsed in slices of up to this length.
+ * Core lock is released between slices, so application threads,
+ * writing to connections or starting commands, do not wait for large bursts to be parsed.
+ *
+ * \note            Set to `0` to process all available data under single lock
+ */
+#ifndef LWESP_CFG_INPUT_PROCESS_SLICE
+#define LWESP_CFG_INPUT_PROCESS_SLICE         256
+#endif
+
+/**
+ * \brief           Number of input bytes processed before expired timeouts are executed
+ *
+ * During long bursts of received data, processing thread parses input buffer
+ * until it is empty and timeouts wait behind it. Once this number of bytes is processed,
+ * expired timeouts are executed before parsing continues,
+ * to keep keep-alive and poll timers accurate under load.
+ *
+ * \note            Used only when \ref LWESP_CFG_INPUT_USE_PROCESS is disabled.
+ *                  With input process mode, processing thread executes timeouts
+ *                  while input thread releases core lock between slices
+ * \note            Set to `0` to execute timeouts only after all available data are processed
+ */
+#ifndef LWESP_CFG_INPUT_PROCESS_BUDGET
+#define LWESP_CFG_INPUT_PROCESS_BUDGET        (16 * LWESP_CFG_INPUT_PROCESS_SLICE)
+#endif
+
+/**
+ * \brief           Full memory barrier, used by lock-free ring buffer
+ *
+ * Barrier guarantees that buffer data are in memory before read or write pointer is published,
+ * which allows \ref lwesp_input to be called from interrupt context, concurrently with processing thread.
+ *
+ * \note            Default implementation uses compiler builtin on GCC compatible compilers.
+ *                  For other compilers, define it to platform barrier, such as `__DMB()` on ARM Cortex-M
+ */
+#ifndef LWESP_CFG_MEMORY_BARRIER
+#if defined(__GNUC__) || defined(__clang__)
+#define LWESP_CFG_MEMORY_BARRIER()            __sync_synchronize()
+#else
+#define LWESP_CFG_MEMORY_BARRIER()            do {} while (0)
+#endif
+#endif
+
+/**
+ * \brief           Atomically increment 32-bit variable and return its previous value
+ *
+ * Used by counters written from multiple threads or interrupt context without core lock,
+ * such as trace buffer and mailbox statistics.
+ *
+ * \note            Default implementation uses compiler builtin on GCC compatible compilers and MSVC.
+ *                  For other compilers, define it to platform primitive
+ */
+#ifndef LWESP_CFG_ATOMIC_INC
+#if defined(__GNUC__) || defined(__clang__)
+#define LWESP_CFG_ATOMIC_INC(ptr)             __atomic_fetch_add((ptr), 1, __ATOMIC_RELAXED)
+#elif defined(_MSC_VER)
+#define LWESP_CFG_ATOMIC_INC(ptr)             ((uint32_t)_InterlockedIncrement((volatile long*)(ptr)) - 1)
+#else
+#define LWESP_CFG_ATOMIC_INC(ptr)             ((*(ptr))++)
+#endif
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` reset sequence after \ref lwesp_init call
+ *
+ * \note            When this functionality is disabled, user must manually call \ref lwesp_reset to send
+ *                  reset sequence to ESP device.
+ */
+#ifndef LWESP_CFG_RESET_ON_INIT
+#define LWESP_CFG_RESET_ON_INIT               1
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` device restore after \ref lwesp_init call
+ *
+ * \note            When this feature is enabled, it will automatically
+ *                  restore and clear any settings stored as \em default in ESP device
+ */
+#ifndef LWESP_CFG_RESTORE_ON_INIT
+#define LWESP_CFG_RESTORE_ON_INIT             1
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` warm init of already configured device
+ *
+ * When enabled and low-level layer provides \ref lwesp_ll_t.warm_state_fn callback,
+ * reset sequence after \ref lwesp_init does not reset device. Instead, it reads `AT+GMR` version
+ * and compares fingerprint (version and library configuration) with the one stored after last full reset.
+ * When they match, live configuration is queried (`AT+CIPMUX?`, `AT+CIPDINFO?`, `AT+CWMODE?`
+ * and `AT+CIPRECVMODE?` with manual TCP receive) and only settings that differ are sent to device.
+ * Otherwise full reset sequence is executed and new fingerprint is stored.
+ *
+ * Device that was restarted meanwhile (power cycle, `ready` message) loses volatile `AT+CIPMUX` setting,
+ * which is detected and full reset sequence is executed.
+ *
+ * Device state includes station join status and IP address (`AT+CWJAP?` and `AT+CIPSTA?`),
+ * reported with \ref LWESP_EVT_WIFI_CONNECTED and \ref LWESP_EVT_WIFI_IP_ACQUIRED events,
+ * and connections still open on device (`AT+CIPSTATUS`). Each connection is reported
+ * with \ref LWESP_EVT_CONN_RESYNC event, where application reattaches to it with \ref lwesp_conn_set_evt_fn.
+ * Connections not claimed by application are closed.
+ *
+ * \note            Useful when host restarts while ESP device keeps running
+ * \note            \ref LWESP_CFG_RESTORE_ON_INIT should be disabled to take advantage of this feature
+ */
+#ifndef LWESP_CFG_WARM_INIT
+#define LWESP_CFG_WARM_INIT                   0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` fast recovery after unexpected device reset
+ *
+ * When `ready` is received without reset being requested (watchdog or brown-out reset on device),
+ * reset sequence starts directly with configuration commands, without another `AT+RST`.
+ * Wifi mode setting, stored in device flash, is not written again.
+ * Station rejoins access point stored on device by itself, which is reported with usual wifi events.
+ *
+ * When disabled, full reset sequence, same as \ref lwesp_reset, is executed instead
+ */
+#ifndef LWESP_CFG_RESET_RECOVERY
+#define LWESP_CFG_RESET_RECOVERY              0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` reset sequence after \ref lwesp_device_set_present call
+ *
+ * \note            When this functionality is disabled, user must manually call \ref lwesp_reset to send
+ *                  reset sequence to ESP device.
+ */
+#ifndef LWESP_CFG_RESET_ON_DEVICE_PRESENT
+#define LWESP_CFG_RESET_ON_DEVICE_PRESENT     1
+#endif
+
+/**
+ * \brief           Default delay (milliseconds unit) before sending first AT command on reset sequence
+ *
+ */
+#ifndef LWESP_CFG_RESET_DELAY_DEFAULT
+#define LWESP_CFG_RESET_DELAY_DEFAULT         1000
+#endif
+
+/**
+ * \brief           Maximum length of SSID for access point scan
+ *
+ * \note            This parameter must include trailling zero
+ */
+#ifndef LWESP_CFG_MAX_SSID_LENGTH
+#define LWESP_CFG_MAX_SSID_LENGTH             21
+#endif
+
+/**
+ * \brief           Maximum length of PWD for access point
+ *
+ * \note            This parameter must include trailling zero
+ */
+#ifndef LWESP_CFG_MAX_PWD_LENGTH
+#define LWESP_CFG_MAX_PWD_LENGTH             65
+#endif
+
+/**
+ * \defgroup        LWESP_OPT_DBG Debugging
+ * \brief           Debugging configurations
+ * \{
+ */
+
+/**
+ * \brief           Set global debug support
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ *
+ * \note            Set to \ref LWESP_DBG_OFF to globally disable all debugs
+ */
+#ifndef LWESP_CFG_DBG
+#define LWESP_CFG_DBG                         LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Debugging output function
+ *
+ * Called with format and optional parameters for printf-like debug
+ */
+#ifndef LWESP_CFG_DBG_OUT
+#define LWESP_CFG_DBG_OUT(fmt, ...)           do { extern int printf( const char * format, ... ); printf(fmt, ## __VA_ARGS__); } while (0)
+#endif
+
+/**
+ * \brief           Minimal debug level
+ *
+ * Check \ref LWESP_DBG_LVL for possible values
+ */
+#ifndef LWESP_CFG_DBG_LVL_MIN
+#define LWESP_CFG_DBG_LVL_MIN                 LWESP_DBG_LVL_ALL
+#endif
+
+/**
+ * \brief           Enabled debug types
+ *
+ * When debug is globally enabled with \ref LWESP_CFG_DBG parameter,
+ * user must enable debug types such as TRACE or STATE messages.
+ *
+ * Check \ref LWESP_DBG_TYPE for possible options. Separate values with `bitwise OR` operator
+ */
+#ifndef LWESP_CFG_DBG_TYPES_ON
+#define LWESP_CFG_DBG_TYPES_ON                0
+#endif
+
+/**
+ * \brief           Set debug level for init function
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ */
+#ifndef LWESP_CFG_DBG_INIT
+#define LWESP_CFG_DBG_INIT                    LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Set debug level for memory manager
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ */
+#ifndef LWESP_CFG_DBG_MEM
+#define LWESP_CFG_DBG_MEM                     LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Set debug level for input module
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ */
+#ifndef LWESP_CFG_DBG_INPUT
+#define LWESP_CFG_DBG_INPUT                   LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Set debug level for ESP threads
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ */
+#ifndef LWESP_CFG_DBG_THREAD
+#define LWESP_CFG_DBG_THREAD                  LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Set debug level for asserting of input variables
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ */
+#ifndef LWESP_CFG_DBG_ASSERT
+#define LWESP_CFG_DBG_ASSERT                  LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Set debug level for incoming data received from device
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ */
+#ifndef LWESP_CFG_DBG_IPD
+#define LWESP_CFG_DBG_IPD                     LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Set debug level for netconn sequential API
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ */
+#ifndef LWESP_CFG_DBG_NETCONN
+#define LWESP_CFG_DBG_NETCONN                 LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Set debug level for packet buffer manager
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ */
+#ifndef LWESP_CFG_DBG_PBUF
+#define LWESP_CFG_DBG_PBUF                    LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Set debug level for connections
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ */
+#ifndef LWESP_CFG_DBG_CONN
+#define LWESP_CFG_DBG_CONN                    LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Set debug level for station manager
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ */
+#ifndef LWESP_CFG_DBG_STA_MGR
+#define LWESP_CFG_DBG_STA_MGR                 LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Set debug level for dynamic variable allocations
+ *
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ */
+#ifndef LWESP_CFG_DBG_VAR
+#define LWESP_CFG_DBG_VAR                     LWESP_DBG_OFF
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` echo mode on AT commands
+ *                  sent to ESP device.
+ *
+ * \note            This mode is useful when debugging ESP communication
+ */
+#ifndef LWESP_CFG_AT_ECHO
+#define LWESP_CFG_AT_ECHO                     0
+#endif
+
+/**
+ * \}
+ */
+
+/**
+ * \defgroup        LWESP_OPT_OS OS configuration
+ * \brief           Operating system dependant configuration
+ * \{
+ */
+
+/**
+ * \brief           Set number of message queue entries for procuder thread
+ *
+ * Message queue is used for storing memory address to command data
+ */
+#ifndef LWESP_CFG_THREAD_PRODUCER_MBOX_SIZE
+#define LWESP_CFG_THREAD_PRODUCER_MBOX_SIZE   16
+#endif
+
+/**
+ * \brief           Set number of message queue entries for processing thread
+ *
+ * Message queue is used to notify processing thread about new received data on AT port
+ */
+#ifndef LWESP_CFG_THREAD_PROCESS_MBOX_SIZE
+#define LWESP_CFG_THREAD_PROCESS_MBOX_SIZE    16
+#endif
+
+/**
+ * \brief           Stack size of producer thread, in units of system port stack size
+ *
+ * \note            Defaults to system port \ref LWESP_SYS_THREAD_SS
+ */
+#ifndef LWESP_CFG_THREAD_PRODUCER_SS
+#define LWESP_CFG_THREAD_PRODUCER_SS          LWESP_SYS_THREAD_SS
+#endif
+
+/**
+ * \brief           Priority of producer thread
+ *
+ * \note            Defaults to system port \ref LWESP_SYS_THREAD_PRIO
+ */
+#ifndef LWESP_CFG_THREAD_PRODUCER_PRIO
+#define LWESP_CFG_THREAD_PRODUCER_PRIO        LWESP_SYS_THREAD_PRIO
+#endif
+
+/**
+ * \brief           Stack size of process thread, in units of system port stack size
+ *
+ * Process thread parses received data and calls user event functions,
+ * set stack according to user callbacks
+ *
+ * \note            Defaults to system port \ref LWESP_SYS_THREAD_SS
+ */
+#ifndef LWESP_CFG_THREAD_PROCESS_SS
+#define LWESP_CFG_THREAD_PROCESS_SS           LWESP_SYS_THREAD_SS
+#endif
+
+/**
+ * \brief           Priority of process thread
+ *
+ * \note            Defaults to system port \ref LWESP_SYS_THREAD_PRIO
+ */
+#ifndef LWESP_CFG_THREAD_PROCESS_PRIO
+#define LWESP_CFG_THREAD_PROCESS_PRIO         LWESP_SYS_THREAD_PRIO
+#endif
+
+/**
+ * \brief           Number of worker threads for connection event callbacks
+ *
+ * When set to value greater than `0`, connection callbacks (connection API, netconn, HTTP, MQTT)
+ * are not called from processing thread. Event is copied to queue of one worker thread instead,
+ * selected by connection number. Events of single connection are always handled
+ * by the same worker and in order, while different connections run in parallel on multi-core hosts.
+ *
+ * Received packet buffer is referenced for the worker and freed after callback returns.
+ * Callbacks run without core lock and their return value is ignored,
+ * \ref lwespOKIGNOREMORE has no effect.
+ * Pointers in event structure other than connection and packet buffer
+ * (strings, user arrays) may not be valid anymore when callback is called.
+ * Connection state (argument, status) is read at the time of callback,
+ * when connection may already be closed.
+ *
+ * Set to `0` to call connection callbacks directly from processing thread
+ *
+ * \note            Worker threads use \ref LWESP_CFG_THREAD_PROCESS_SS and \ref LWESP_CFG_THREAD_PROCESS_PRIO
+ */
+#ifndef LWESP_CFG_CONN_EVT_WORKERS
+#define LWESP_CFG_CONN_EVT_WORKERS            0
+#endif
+
+/**
+ * \brief           Number of entries in queue of each connection event worker
+ *
+ * When queue is full, new events for connections of that worker are dropped,
+ * set it according to traffic and callback processing time
+ *
+ * \note            Used only when \ref LWESP_CFG_CONN_EVT_WORKERS is greater than `0`
  */
-#ifndef LWESP_CFG_DBG_TYPES_ON
-#define LWESP_CFG_DBG_TYPES_ON                0
+#ifndef LWESP_CFG_CONN_EVT_WORKER_QUEUE_LEN
+#define LWESP_CFG_CONN_EVT_WORKER_QUEUE_LEN   16
 #endif
 
 /**
- * \brief           Set debug level for init function
+ * \brief           Enables `1` or disables `0` command priority classes
  *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ * Producer thread starts queued commands with higher priority first,
+ * commands of the same priority are started in order they were queued.
+ * Slow scan commands run with low priority, connection commands use priority
+ * set with \ref lwesp_conn_set_priority
  */
-#ifndef LWESP_CFG_DBG_INIT
-#define LWESP_CFG_DBG_INIT                    LWESP_DBG_OFF
+#ifndef LWESP_CFG_CMD_PRIORITY
+#define LWESP_CFG_CMD_PRIORITY                0
 #endif
 
 /**
- * \brief           Set debug level for memory manager
+ * \brief           Enables `1` or disables `0` fair scheduling of connection send commands
  *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ * Send and close commands of each connection wait in per-connection queue,
+ * only one of them is in its priority lane at a time.
+ * Connections are served round-robin, each gets \ref LWESP_CFG_CONN_SEND_FAIR_QUANTUM bytes per turn.
+ * Long send command gives up its turn between `AT+CIPSEND` chunks when other commands wait,
+ * and continues with remaining data in its next turn.
+ *
+ * \note            Scheduler extends priority lanes, \ref LWESP_CFG_CMD_PRIORITY must be enabled.
+ *                  It cannot be used together with \ref LWESP_CFG_CONN_SEND_COALESCE
  */
-#ifndef LWESP_CFG_DBG_MEM
-#define LWESP_CFG_DBG_MEM                     LWESP_DBG_OFF
+#ifndef LWESP_CFG_CONN_SEND_FAIR
+#define LWESP_CFG_CONN_SEND_FAIR              0
+#endif
+
+/**
+ * \brief           Number of bytes each connection may send in one scheduler turn
+ *
+ * Unused part is kept for next turn while connection has commands in queue (deficit round-robin).
+ *
+ * \note            Used when \ref LWESP_CFG_CONN_SEND_FAIR is enabled
+ */
+#ifndef LWESP_CFG_CONN_SEND_FAIR_QUANTUM
+#define LWESP_CFG_CONN_SEND_FAIR_QUANTUM      LWESP_CFG_CONN_MAX_DATA_LEN
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` command deadlines and cancellation
+ *
+ * Commands recorded in batch may get absolute deadline with \ref lwesp_batch_set_deadline
+ * and may be cancelled with \ref lwesp_cmd_cancel while still waiting in queue.
+ * Both are checked when producer thread takes command from queue
+ */
+#ifndef LWESP_CFG_CMD_CANCEL
+#define LWESP_CFG_CMD_CANCEL                  0
+#endif
+
+/**
+ * \brief           Number of pending cancel requests stack can remember
+ *
+ * \note            Used only when \ref LWESP_CFG_CMD_CANCEL is enabled
+ */
+#ifndef LWESP_CFG_CMD_CANCEL_SLOTS
+#define LWESP_CFG_CMD_CANCEL_SLOTS            4
+#endif
+
+/**
+ * \brief           Default maximal time command may wait in queue, in units of milliseconds
+ *
+ * Command not started within this time after it was queued fails with \ref lwespTIMEOUT,
+ * without being sent to device. It applies to commands without explicit deadline.
+ *
+ * \note            Set to `0` to disable. Used only when \ref LWESP_CFG_CMD_CANCEL is enabled
+ */
+#ifndef LWESP_CFG_CMD_QUEUE_TIMEOUT
+#define LWESP_CFG_CMD_QUEUE_TIMEOUT           0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` merging of identical concurrent query commands
+ *
+ * Query of station or access point IP, connected access point info or connections status,
+ * started while the same query is still waiting in queue or being executed,
+ * is not sent to device again. It waits for running query instead
+ * and finishes with its result and output data.
+ *
+ * \note            Commands recorded in a batch are never merged
+ */
+#ifndef LWESP_CFG_CMD_SINGLE_FLIGHT
+#define LWESP_CFG_CMD_SINGLE_FLIGHT           0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` deferred delivery of global events
+ *
+ * Listeners registered with \ref lwesp_evt_register_deferred are not called from processing thread.
+ * Events are copied to queue instead and delivered by \ref lwesp_evt_deferred_process,
+ * called from application thread of choice
+ */
+#ifndef LWESP_CFG_EVT_DEFERRED
+#define LWESP_CFG_EVT_DEFERRED                0
+#endif
+
+/**
+ * \brief           Number of entries in deferred events queue
+ *
+ * When queue is full, new events for deferred listeners are dropped
+ *
+ * \note            Used only when \ref LWESP_CFG_EVT_DEFERRED is enabled
+ */
+#ifndef LWESP_CFG_EVT_DEFERRED_QUEUE_LEN
+#define LWESP_CFG_EVT_DEFERRED_QUEUE_LEN      16
+#endif
+
+/**
+ * \brief           Number of preallocated command messages
+ *
+ * When set to value greater than `0`, API functions take message objects
+ * from static pool instead of allocating them on every call.
+ * Semaphores for blocking calls are created only once per pool entry and reused afterwards.
+ *
+ * When pool is empty, message is allocated with \ref lwesp_mem_malloc as usual,
+ * except with \ref LWESP_CFG_STATIC_ONLY, where API function fails with \ref lwespERRMEM.
+ *
+ * \note            Set to `0` to disable message pool
+ */
+#ifndef LWESP_CFG_MSG_POOL_SIZE
+#if LWESP_CFG_STATIC_ONLY
+#define LWESP_CFG_MSG_POOL_SIZE               (2 * LWESP_CFG_MAX_CONNS + 4)
+#else /* LWESP_CFG_STATIC_ONLY */
+#define LWESP_CFG_MSG_POOL_SIZE               0
+#endif /* !LWESP_CFG_STATIC_ONLY */
+#endif
+
+/**
+ * \brief           Number of preallocated compact command messages
+ *
+ * Compact message holds common message header and command payload
+ * of up to \ref LWESP_CFG_MSG_SMALL_PAYLOAD_LEN bytes, instead of the full payload union.
+ * Commands with small payload, such as connection close or manual receive,
+ * take message from this pool first and fall back to \ref LWESP_CFG_MSG_POOL_SIZE pool or heap.
+ *
+ * \note            Set to `0` to disable compact message pool
+ */
+#ifndef LWESP_CFG_MSG_POOL_SMALL_SIZE
+#define LWESP_CFG_MSG_POOL_SMALL_SIZE         0
+#endif
+
+/**
+ * \brief           Maximal command payload length of compact message, in units of bytes
+ *
+ * \note            Used only when \ref LWESP_CFG_MSG_POOL_SMALL_SIZE is greater than `0`
+ */
+#ifndef LWESP_CFG_MSG_SMALL_PAYLOAD_LEN
+#define LWESP_CFG_MSG_SMALL_PAYLOAD_LEN       (4 * sizeof(void*))
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` direct support for processing input data
+ *
+ * When this mode is enabled, no overhead is included for copying data
+ * to receive buffer because bytes are processed directly by \ref lwesp_input_process function
+ *
+ * If this mode is not enabled, then user have to send every received byte via \ref lwesp_input
+ * function to the internal buffer for future processing. This may introduce additional overhead
+ * with data copy and may decrease library performance
+ *
+ * \note            This mode can only be used when \ref LWESP_CFG_OS is enabled
+ *
+ * \note            When using this mode, separate thread must be dedicated only
+ *                  for reading data on AT port. It is usually implemented in LL driver
+ *
+ * \note            Best case for using this mode is if DMA receive is supported by host device
+ */
+#ifndef LWESP_CFG_INPUT_USE_PROCESS
+#define LWESP_CFG_INPUT_USE_PROCESS           0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` zero-copy receive of `+IPD` data
+ *
+ * When enabled, packet buffer passed to \ref LWESP_EVT_CONN_RECV event
+ * references memory in input buffer directly, instead of copying data to newly allocated memory.
+ * Input buffer memory is not reclaimed until all referencing packet buffers are freed with \ref lwesp_pbuf_free.
+ *
+ * Zero-copy is only used when complete `+IPD` payload is available in linear part of input buffer,
+ * otherwise stack falls back to standard copy mode.
+ *
+ * \note            This mode can only be used when \ref LWESP_CFG_INPUT_USE_PROCESS is disabled
+ *
+ * \note            Application must free received packet buffers as soon as possible,
+ *                  otherwise input buffer may get full and new received data are lost.
+ *                  Set \ref LWESP_CFG_RCV_BUFF_SIZE accordingly
+ */
+#ifndef LWESP_CFG_IPD_ZERO_COPY
+#define LWESP_CFG_IPD_ZERO_COPY               0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` direct write of `+IPD` payload to packet buffer
+ *
+ * When processing thread parsed `+IPD` header, consumed all data of input buffer and still waits for payload,
+ * it hands remaining space of packet buffer over to input context.
+ * \ref lwesp_input then copies following payload bytes directly to packet buffer instead of to input buffer,
+ * saving one copy of every such byte. Command data continue to go through input buffer.
+ *
+ * \note            This mode can only be used when \ref LWESP_CFG_INPUT_USE_PROCESS
+ *                  and \ref LWESP_CFG_IPD_ZERO_COPY are disabled
+ */
+#ifndef LWESP_CFG_IPD_DIRECT
+#define LWESP_CFG_IPD_DIRECT                  0
+#endif
+
+/**
+ * \brief           Producer thread hook, called each time thread wakes-up and does the processing.
+ *
+ * It can be used to check if thread is alive.
+ */
+#ifndef LWESP_THREAD_PRODUCER_HOOK
+#define LWESP_THREAD_PRODUCER_HOOK()
+#endif
+
+/**
+ * \brief           Process thread hook, called each time thread wakes-up and does the processing.
+ *
+ * It can be used to check if thread is alive.
+ */
+#ifndef LWESP_THREAD_PROCESS_HOOK
+#define LWESP_THREAD_PROCESS_HOOK()
+#endif
+
+/**
+ * \brief           Producer thread statistics hook, called after \ref LWESP_THREAD_PRODUCER_HOOK
+ *
+ * It can be used to monitor thread utilization without polling statistics API.
+ *
+ * \note            \ref LWESP_CFG_STATS_THREAD must be enabled
+ * \param[in]       st: Pointer to `const` \ref lwesp_stats_thread_t structure of producer thread
+ */
+#ifndef LWESP_THREAD_PRODUCER_STATS_HOOK
+#define LWESP_THREAD_PRODUCER_STATS_HOOK(st)
+#endif
+
+/**
+ * \brief           Process thread statistics hook, called after \ref LWESP_THREAD_PROCESS_HOOK
+ *
+ * \note            \ref LWESP_CFG_STATS_THREAD must be enabled
+ * \param[in]       st: Pointer to `const` \ref lwesp_stats_thread_t structure of process thread
+ */
+#ifndef LWESP_THREAD_PROCESS_STATS_HOOK
+#define LWESP_THREAD_PROCESS_STATS_HOOK(st)
+#endif
+
+/**
+ * \}
+ */
+
+/**
+ * \defgroup        LWESP_OPT_MODULES Modules
+ * \brief           Configuration of specific modules
+ * \{
+ */
+
+/**
+ * \defgroup        LWESP_OPT_MODULES_NETCONN Netconn module
+ * \brief           Configuration of netconn API module
+ * \{
+ */
+
+/**
+ * \brief           Enables `1` or disables `0` NETCONN sequential API support for OS systems
+ *
+ * \note            To use this feature, OS support is mandatory.
+ * \sa              LWESP_CFG_OS
+ */
+#ifndef LWESP_CFG_NETCONN
+#define LWESP_CFG_NETCONN                     0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` receive timeout feature
+ *
+ * When this option is enabled, user will get an option
+ * to set timeout value for receive data on netconn,
+ * before function returns timeout error.
+ *
+ * \note            Even if this option is enabled, user must still manually set timeout,
+ *                  by default time will be set to 0 which means no timeout.
+ */
+#ifndef LWESP_CFG_NETCONN_RECEIVE_TIMEOUT
+#define LWESP_CFG_NETCONN_RECEIVE_TIMEOUT     1
+#endif
+
+/**
+ * \brief           Accept queue length for new client when netconn server is used
+ *
+ * Defines number of maximal clients waiting in accept queue of server connection
+ */
+#ifndef LWESP_CFG_NETCONN_ACCEPT_QUEUE_LEN
+#define LWESP_CFG_NETCONN_ACCEPT_QUEUE_LEN    5
+#endif
+
+/**
+ * \brief           Receive queue length for pbuf entries
+ *
+ * Defines maximal number of pbuf data packet references for receive
+ */
+#ifndef LWESP_CFG_NETCONN_RECEIVE_QUEUE_LEN
+#define LWESP_CFG_NETCONN_RECEIVE_QUEUE_LEN   8
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` netconn idle deadline feature
+ *
+ * When enabled, \ref lwesp_netconn_set_idle_deadline sets time without traffic
+ * after which receive function returns \ref lwespTIMEOUT.
+ * Deadlines of all netconns are served by single stack timer,
+ * instead of timed waits in every receiving thread.
+ */
+#ifndef LWESP_CFG_NETCONN_DEADLINE
+#define LWESP_CFG_NETCONN_DEADLINE            0
+#endif
+
+/**
+ * \brief           Receive queue high watermark in units of bytes
+ *
+ * When number of bytes in netconn receive queue reaches this value,
+ * stack stops reading data from device for this connection
+ * and TCP window on device side throttles the remote sender.
+ *
+ * \note            Used only when \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE is enabled
+ */
+#ifndef LWESP_CFG_NETCONN_RECEIVE_HIGH_WATERMARK
+#define LWESP_CFG_NETCONN_RECEIVE_HIGH_WATERMARK  (4 * 1460)
+#endif
+
+/**
+ * \brief           Receive queue low watermark in units of bytes
+ *
+ * Reading of data is resumed once number of bytes in receive queue drops to this value
+ *
+ * \note            Used only when \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE is enabled
+ */
+#ifndef LWESP_CFG_NETCONN_RECEIVE_LOW_WATERMARK
+#define LWESP_CFG_NETCONN_RECEIVE_LOW_WATERMARK   (LWESP_CFG_NETCONN_RECEIVE_HIGH_WATERMARK / 2)
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` static pool of netconn objects
+ *
+ * When enabled, netconn objects are taken from statically allocated pool
+ * instead of heap. Message boxes are created on first use and kept for reuse,
+ * they are only drained when netconn is closed or deleted.
+ */
+#ifndef LWESP_CFG_NETCONN_POOL
+#define LWESP_CFG_NETCONN_POOL                LWESP_CFG_STATIC_ONLY
+#endif
+
+/**
+ * \brief           Number of netconn objects in static pool
+ *
+ * Default value allows netconn for every connection and one listening netconn.
+ * Increase it when preallocated netconns for incoming clients are used
+ *
+ * \sa              LWESP_CFG_NETCONN_POOL
+ */
+#ifndef LWESP_CFG_NETCONN_POOL_SIZE
+#define LWESP_CFG_NETCONN_POOL_SIZE           (LWESP_CFG_MAX_CONNS + 1)
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` netconn select feature
+ *
+ * When enabled, single thread can wait for data or new clients
+ * on multiple netconns at a time, using \ref lwesp_netconn_select function
+ */
+#ifndef LWESP_CFG_NETCONN_SELECT
+#define LWESP_CFG_NETCONN_SELECT              0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` netconn reactor
+ *
+ * Reactor runs per-netconn callbacks for accept, receive, write and close events
+ * from single application thread, see \ref lwesp_netconn_reactor_run
+ *
+ * \note            Requires \ref LWESP_CFG_NETCONN_SELECT
+ */
+#ifndef LWESP_CFG_NETCONN_REACTOR
+#define LWESP_CFG_NETCONN_REACTOR             0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` netconn multiplexer over multiple stack copies
+ *
+ * Multiplexer opens every new connection on least loaded ready ESP device
+ * and moves new connections away from device which was reset, see \ref LWESP_NETCONN_MUX.
+ * Every stack copy exports its netconn operations as \ref lwesp_netconn_mux_ops.
+ *
+ * \note            Multiplexer module `lwesp_netconn_mux.c` is compiled once, without \ref LWESP_CFG_PREFIX
+ */
+#ifndef LWESP_CFG_NETCONN_MUX
+#define LWESP_CFG_NETCONN_MUX                 0
+#endif
+
+/**
+ * \brief           Maximal number of stack copies attached to netconn multiplexer
+ *
+ * \note            Used only when \ref LWESP_CFG_NETCONN_MUX is enabled
+ */
+#ifndef LWESP_CFG_NETCONN_MUX_INSTANCES
+#define LWESP_CFG_NETCONN_MUX_INSTANCES       2
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` BSD-style socket API on top of netconn
+ *
+ * \note            Requires \ref LWESP_CFG_NETCONN, \ref LWESP_CFG_NETCONN_SELECT
+ *                  and \ref LWESP_CFG_NETCONN_RECEIVE_TIMEOUT
+ */
+#ifndef LWESP_CFG_SOCKETS
+#define LWESP_CFG_SOCKETS                     0
+#endif
+
+/**
+ * \brief           Maximal number of socket descriptors
+ *
+ * \sa              LWESP_CFG_SOCKETS
+ */
+#ifndef LWESP_CFG_SOCKETS_MAX
+#define LWESP_CFG_SOCKETS_MAX                 (LWESP_CFG_MAX_CONNS + 1)
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` non-blocking netconn write
+ *
+ * When enabled, \ref lwesp_netconn_write_nonblock queues data for send
+ * and returns immediately, up to \ref LWESP_CFG_NETCONN_WRITE_BUDGET bytes per netconn
+ */
+#ifndef LWESP_CFG_NETCONN_WRITE_NONBLOCK
+#define LWESP_CFG_NETCONN_WRITE_NONBLOCK      0
 #endif
 
 /**
- * \brief           Set debug level for input module
+ * \brief           Maximal number of bytes queued for send and not yet sent per netconn
  *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ * Used with non-blocking write, see \ref LWESP_CFG_NETCONN_WRITE_NONBLOCK
  */
-#ifndef LWESP_CFG_DBG_INPUT
-#define LWESP_CFG_DBG_INPUT                   LWESP_DBG_OFF
+#ifndef LWESP_CFG_NETCONN_WRITE_BUDGET
+#define LWESP_CFG_NETCONN_WRITE_BUDGET        (4 * LWESP_CFG_CONN_MAX_DATA_LEN)
 #endif
 
 /**
- * \brief           Set debug level for ESP threads
+ * \brief           Number of pre-warmed client connections kept open by netconn
  *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ * Idle connections to endpoints set with \ref lwesp_netconn_prewarm_add are opened in background
+ * and handed out by \ref lwesp_netconn_connect, saving connection (and SSL handshake) time.
+ * Set to `0` to disable the feature
  */
-#ifndef LWESP_CFG_DBG_THREAD
-#define LWESP_CFG_DBG_THREAD                  LWESP_DBG_OFF
+#ifndef LWESP_CFG_NETCONN_PREWARM
+#define LWESP_CFG_NETCONN_PREWARM             0
 #endif
 
 /**
- * \brief           Set debug level for asserting of input variables
+ * \brief           Maximal time in units of milliseconds pre-warmed connection stays idle
  *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ * Older connections are closed and opened again, so that server never sees
+ * idle connection longer than its keep-alive timeout. Set to `0` to keep them open
+ *
+ * \sa              LWESP_CFG_NETCONN_PREWARM
  */
-#ifndef LWESP_CFG_DBG_ASSERT
-#define LWESP_CFG_DBG_ASSERT                  LWESP_DBG_OFF
+#ifndef LWESP_CFG_NETCONN_PREWARM_IDLE_TIME
+#define LWESP_CFG_NETCONN_PREWARM_IDLE_TIME   30000
 #endif
 
 /**
- * \brief           Set debug level for incoming data received from device
+ * \brief           Time in units of milliseconds before pre-warmed connection is opened again after failure
  *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ * \sa              LWESP_CFG_NETCONN_PREWARM
  */
-#ifndef LWESP_CFG_DBG_IPD
-#define LWESP_CFG_DBG_IPD                     LWESP_DBG_OFF
+#ifndef LWESP_CFG_NETCONN_PREWARM_RETRY_TIME
+#define LWESP_CFG_NETCONN_PREWARM_RETRY_TIME  5000
 #endif
 
 /**
- * \brief           Set debug level for netconn sequential API
- *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ * \}
  */
-#ifndef LWESP_CFG_DBG_NETCONN
-#define LWESP_CFG_DBG_NETCONN                 LWESP_DBG_OFF
-#endif
 
 /**
- * \brief           Set debug level for packet buffer manager
+ * \defgroup        LWESP_OPT_MODULES_MQTT MQTT client module
+ * \brief           Configuration of MQTT and MQTT API client modules
+ * \{
+ */
+
+/**
+ * \brief           Maximal number of open MQTT requests at a time
  *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
  */
-#ifndef LWESP_CFG_DBG_PBUF
-#define LWESP_CFG_DBG_PBUF                    LWESP_DBG_OFF
+#ifndef LWESP_CFG_MQTT_MAX_REQUESTS
+#define LWESP_CFG_MQTT_MAX_REQUESTS           8
 #endif
 
 /**
- * \brief           Set debug level for connections
+ * \brief           Maximal number of publish packets with QoS `1` or `2` waiting for server acknowledge
  *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ * This is in-flight window, equivalent to server `receive maximum` property.
+ * Set to `0` to limit only by \ref LWESP_CFG_MQTT_MAX_REQUESTS
  */
-#ifndef LWESP_CFG_DBG_CONN
-#define LWESP_CFG_DBG_CONN                    LWESP_DBG_OFF
+#ifndef LWESP_CFG_MQTT_MAX_INFLIGHT
+#define LWESP_CFG_MQTT_MAX_INFLIGHT           0
 #endif
 
 /**
- * \brief           Set debug level for dynamic variable allocations
+ * \brief           Maximal number of QoS `0` publish groups waiting to be sent to network
  *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ * QoS `0` publish does not use request object. Client only remembers number of bytes
+ * to be sent before packet is reported as published to user.
+ * Consecutive packets with the same user argument share one entry.
  */
-#ifndef LWESP_CFG_DBG_VAR
-#define LWESP_CFG_DBG_VAR                     LWESP_DBG_OFF
+#ifndef LWESP_CFG_MQTT_QOS0_QUEUE_LEN
+#define LWESP_CFG_MQTT_QOS0_QUEUE_LEN         8
 #endif
 
 /**
- * \brief           Enables `1` or disables `0` echo mode on AT commands
- *                  sent to ESP device.
+ * \brief           Maximal number of send commands active at a time on MQTT connection
  *
- * \note            This mode is useful when debugging ESP communication
+ * More commands keep transmit pipe full while previous data are still being sent.
+ * Data before and after TX buffer wrap point are sent with separate commands.
+ * Set to `1` to wait for each send to complete before next one is started.
  */
-#ifndef LWESP_CFG_AT_ECHO
-#define LWESP_CFG_AT_ECHO                     0
+#ifndef LWESP_CFG_MQTT_MAX_SENDS
+#define LWESP_CFG_MQTT_MAX_SENDS              2
 #endif
 
 /**
- * \}
+ * \brief           Enables `1` or disables `0` publish backlog in MQTT client module
+ *
+ * When enabled, publish that cannot be sent immediately, because in-flight window or TX buffer is full,
+ * is copied to heap memory and sent automatically in order once resources are available.
+ * Each queued packet uses one request object.
  */
+#ifndef LWESP_CFG_MQTT_PUBLISH_BACKLOG
+#define LWESP_CFG_MQTT_PUBLISH_BACKLOG        0
+#endif
 
 /**
- * \defgroup        LWESP_OPT_OS OS configuration
- * \brief           Operating system dependant configuration
- * \{
+ * \brief           Number of MQTT clients in static pool
+ * \note            Used only when \ref LWESP_CFG_STATIC_ONLY is enabled
  */
+#ifndef LWESP_CFG_MQTT_CLIENT_POOL_SIZE
+#define LWESP_CFG_MQTT_CLIENT_POOL_SIZE       1
+#endif
 
 /**
- * \brief           Set number of message queue entries for procuder thread
+ * \brief           Size of TX buffer of every MQTT client in static pool, in units of bytes
  *
- * Message queue is used for storing memory address to command data
+ * \ref lwesp_mqtt_client_new fails when requested TX buffer length is larger
+ *
+ * \note            Used only when \ref LWESP_CFG_STATIC_ONLY is enabled
  */
-#ifndef LWESP_CFG_THREAD_PRODUCER_MBOX_SIZE
-#define LWESP_CFG_THREAD_PRODUCER_MBOX_SIZE   16
+#ifndef LWESP_CFG_MQTT_CLIENT_TX_BUFF_LEN
+#define LWESP_CFG_MQTT_CLIENT_TX_BUFF_LEN     256
 #endif
 
 /**
- * \brief           Set number of message queue entries for processing thread
+ * \brief           Size of RX buffer of every MQTT client in static pool, in units of bytes
  *
- * Message queue is used to notify processing thread about new received data on AT port
+ * \ref lwesp_mqtt_client_new fails when requested RX buffer length is larger
+ *
+ * \note            Used only when \ref LWESP_CFG_STATIC_ONLY is enabled
  */
-#ifndef LWESP_CFG_THREAD_PROCESS_MBOX_SIZE
-#define LWESP_CFG_THREAD_PROCESS_MBOX_SIZE    16
+#ifndef LWESP_CFG_MQTT_CLIENT_RX_BUFF_LEN
+#define LWESP_CFG_MQTT_CLIENT_RX_BUFF_LEN     256
 #endif
 
 /**
- * \brief           Enables `1` or disables `0` direct support for processing input data
- *
- * When this mode is enabled, no overhead is included for copying data
- * to receive buffer because bytes are processed directly by \ref lwesp_input_process function
- *
- * If this mode is not enabled, then user have to send every received byte via \ref lwesp_input
- * function to the internal buffer for future processing. This may introduce additional overhead
- * with data copy and may decrease library performance
- *
- * \note            This mode can only be used when \ref LWESP_CFG_OS is enabled
- *
- * \note            When using this mode, separate thread must be dedicated only
- *                  for reading data on AT port. It is usually implemented in LL driver
+ * \brief           Set debug level for MQTT client module
  *
- * \note            Best case for using this mode is if DMA receive is supported by host device
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
  */
-#ifndef LWESP_CFG_INPUT_USE_PROCESS
-#define LWESP_CFG_INPUT_USE_PROCESS           0
+#ifndef LWESP_CFG_DBG_MQTT
+#define LWESP_CFG_DBG_MQTT                    LWESP_DBG_OFF
 #endif
 
 /**
- * \brief           Producer thread hook, called each time thread wakes-up and does the processing.
+ * \brief           Set debug level for MQTT API client module
  *
- * It can be used to check if thread is alive.
+ * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
  */
-#ifndef LWESP_THREAD_PRODUCER_HOOK
-#define LWESP_THREAD_PRODUCER_HOOK()
+#ifndef LWESP_CFG_DBG_MQTT_API
+#define LWESP_CFG_DBG_MQTT_API                LWESP_DBG_OFF
 #endif
 
 /**
- * \brief           Process thread hook, called each time thread wakes-up and does the processing.
+ * \brief           Enables `1` or disables `0` streaming receive of large publish packets in MQTT client module
  *
- * It can be used to check if thread is alive.
+ * When enabled, publish packet that does not fit into client RX buffer is not discarded.
+ * Topic is stored to RX buffer and payload is delivered in pieces as it arrives,
+ * with \ref LWESP_MQTT_EVT_PUBLISH_RECV_BEGIN, \ref LWESP_MQTT_EVT_PUBLISH_RECV_DATA
+ * and \ref LWESP_MQTT_EVT_PUBLISH_RECV_END events.
+ *
+ * \note            RX buffer must still be big enough for topic and packet ID
  */
-#ifndef LWESP_THREAD_PROCESS_HOOK
-#define LWESP_THREAD_PROCESS_HOOK()
+#ifndef LWESP_CFG_MQTT_RECV_STREAM
+#define LWESP_CFG_MQTT_RECV_STREAM            0
 #endif
 
 /**
- * \}
+ * \brief           Enables `1` or disables `0` publish with user-owned payload in MQTT client module
+ *
+ * When enabled, \ref lwesp_mqtt_client_publish_nocopy may be used.
+ * Only packet header and topic are written to TX buffer,
+ * payload is sent directly from user memory with scatter-gather send.
  */
+#ifndef LWESP_CFG_MQTT_PUBLISH_NOCOPY
+#define LWESP_CFG_MQTT_PUBLISH_NOCOPY         0
+#endif
 
 /**
- * \defgroup        LWESP_OPT_MODULES Modules
- * \brief           Configuration of specific modules
- * \{
+ * \brief           Enables `1` or disables `0` zero-copy receive in MQTT API client module
+ *
+ * When enabled, received publish packet, which is contiguous in received packet buffer,
+ * is not copied to new memory. \ref lwesp_mqtt_client_api_buf_t holds slice of packet buffer with topic and payload instead
+ * until \ref lwesp_mqtt_client_api_buf_free is called.
+ * Packets split between multiple packet buffers are still copied.
+ *
+ * \note            Topic and payload are not `NULL` terminated in zero-copy mode
  */
+#ifndef LWESP_CFG_MQTT_API_ZERO_COPY
+#define LWESP_CFG_MQTT_API_ZERO_COPY          0
+#endif
 
 /**
- * \defgroup        LWESP_OPT_MODULES_NETCONN Netconn module
- * \brief           Configuration of netconn API module
- * \{
+ * \brief           Size of receive arena of each MQTT API client, in units of bytes
+ *
+ * When set to value greater than `0`, received publish buffers are allocated
+ * from arena memory, allocated together with client, instead of separate heap allocation.
+ * Arena is used in first-in, first-out order and memory is reused once all older buffers are freed.
+ * Buffers are allocated from heap when arena is full.
+ *
+ * Use \ref lwesp_mqtt_client_api_receive_many and \ref lwesp_mqtt_client_api_buf_free_many
+ * to read and release more buffers with one call.
+ *
+ * Set to `0` to allocate every buffer from heap
  */
+#ifndef LWESP_CFG_MQTT_API_RX_ARENA_LEN
+#define LWESP_CFG_MQTT_API_RX_ARENA_LEN       0
+#endif
 
 /**
- * \brief           Enables `1` or disables `0` NETCONN sequential API support for OS systems
+ * \brief           Enables `1` or disables `0` persistent session store in MQTT client module
  *
- * \note            To use this feature, OS support is mandatory.
- * \sa              LWESP_CFG_OS
+ * When enabled and session callback is set with \ref lwesp_mqtt_client_set_session_fn,
+ * client connects without clean session flag, keeps unacknowledged publish packets
+ * and subscriptions in user storage and replays them after reconnect
  */
-#ifndef LWESP_CFG_NETCONN
-#define LWESP_CFG_NETCONN                     0
+#ifndef LWESP_CFG_MQTT_SESSION_STORE
+#define LWESP_CFG_MQTT_SESSION_STORE          0
 #endif
 
 /**
- * \brief           Enables `1` or disables `0` receive timeout feature
- *
- * When this option is enabled, user will get an option
- * to set timeout value for receive data on netconn,
- * before function returns timeout error.
+ * \brief           Enables `1` or disables `0` MQTT 5 protocol support in MQTT client module
  *
- * \note            Even if this option is enabled, user must still manually set timeout,
- *                  by default time will be set to 0 which means no timeout.
+ * Protocol is selected per connection with `version` member of \ref lwesp_mqtt_client_info_t.
+ * Client follows server receive maximum and maximum packet size and uses topic aliases for publish.
  */
-#ifndef LWESP_CFG_NETCONN_RECEIVE_TIMEOUT
-#define LWESP_CFG_NETCONN_RECEIVE_TIMEOUT     1
+#ifndef LWESP_CFG_MQTT_V5
+#define LWESP_CFG_MQTT_V5                     0
 #endif
 
 /**
- * \brief           Accept queue length for new client when netconn server is used
+ * \brief           Maximal number of MQTT 5 topic aliases used by client for publish
  *
- * Defines number of maximal clients waiting in accept queue of server connection
+ * Actual number is limited by topic alias maximum received from server.
+ * When all aliases are used, the oldest is assigned to new topic.
+ * Set to `0` to disable topic aliases
+ *
+ * \note            Used only when \ref LWESP_CFG_MQTT_V5 is enabled
  */
-#ifndef LWESP_CFG_NETCONN_ACCEPT_QUEUE_LEN
-#define LWESP_CFG_NETCONN_ACCEPT_QUEUE_LEN    5
+#ifndef LWESP_CFG_MQTT_TOPIC_ALIAS_MAX
+#define LWESP_CFG_MQTT_TOPIC_ALIAS_MAX        4
 #endif
 
 /**
- * \brief           Receive queue length for pbuf entries
+ * \brief           Maximal length of topic with MQTT 5 topic alias, in units of bytes
  *
- * Defines maximal number of pbuf data packet references for receive
+ * Client keeps copy of every aliased topic. Longer topics are always sent in full
+ *
+ * \note            Used only when \ref LWESP_CFG_MQTT_V5 is enabled
  */
-#ifndef LWESP_CFG_NETCONN_RECEIVE_QUEUE_LEN
-#define LWESP_CFG_NETCONN_RECEIVE_QUEUE_LEN   8
+#ifndef LWESP_CFG_MQTT_TOPIC_ALIAS_LEN
+#define LWESP_CFG_MQTT_TOPIC_ALIAS_LEN        128
 #endif
 
 /**
@@ -533,35 +2172,59 @@
  */
 
 /**
- * \defgroup        LWESP_OPT_MODULES_MQTT MQTT client module
- * \brief           Configuration of MQTT and MQTT API client modules
+ * \defgroup        LWESP_OPT_MODULES_HTTP_CLIENT HTTP client module
+ * \brief           Configuration of HTTP client module
  * \{
  */
 
 /**
- * \brief           Maximal number of open MQTT requests at a time
+ * \brief           Maximal number of persistent connections of single HTTP client
  *
+ * Requests are sent in parallel on up to this number of connections to the same server
  */
-#ifndef LWESP_CFG_MQTT_MAX_REQUESTS
-#define LWESP_CFG_MQTT_MAX_REQUESTS           8
+#ifndef LWESP_CFG_HTTP_CLIENT_MAX_CONNS
+#define LWESP_CFG_HTTP_CLIENT_MAX_CONNS       2
 #endif
 
 /**
- * \brief           Set debug level for MQTT client module
+ * \brief           Maximal number of requests waiting for free connection on single HTTP client
+ */
+#ifndef LWESP_CFG_HTTP_CLIENT_MAX_REQUESTS
+#define LWESP_CFG_HTTP_CLIENT_MAX_REQUESTS    4
+#endif
+
+/**
+ * \brief           Length of buffer for status line, header and chunk size lines, in units of bytes
  *
- * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
+ * It is allocated for every connection. Longer header lines are truncated
  */
-#ifndef LWESP_CFG_DBG_MQTT
-#define LWESP_CFG_DBG_MQTT                    LWESP_DBG_OFF
+#ifndef LWESP_CFG_HTTP_CLIENT_LINE_LEN
+#define LWESP_CFG_HTTP_CLIENT_LINE_LEN        128
 #endif
 
 /**
- * \brief           Set debug level for MQTT API client module
+ * \brief           Time in units of milliseconds idle persistent connection is kept open
+ *
+ * Set to `0` to close connection after every response
+ */
+#ifndef LWESP_CFG_HTTP_CLIENT_IDLE_TIME
+#define LWESP_CFG_HTTP_CLIENT_IDLE_TIME       30000
+#endif
+
+/**
+ * \brief           Time in units of milliseconds without data from server before request fails
+ */
+#ifndef LWESP_CFG_HTTP_CLIENT_RESP_TIMEOUT
+#define LWESP_CFG_HTTP_CLIENT_RESP_TIMEOUT    10000
+#endif
+
+/**
+ * \brief           Set debug level for HTTP client module
  *
  * Possible values are \ref LWESP_DBG_ON or \ref LWESP_DBG_OFF
  */
-#ifndef LWESP_CFG_DBG_MQTT_API
-#define LWESP_CFG_DBG_MQTT_API                LWESP_DBG_OFF
+#ifndef LWESP_CFG_DBG_HTTP_CLIENT
+#define LWESP_CFG_DBG_HTTP_CLIENT             LWESP_DBG_OFF
 #endif
 
 /**
@@ -595,6 +2258,37 @@
 #define LWESP_CFG_DNS                         0
 #endif
 
+/**
+ * \brief           Number of entries in host-side DNS cache. Set to `0` to disable the cache
+ *
+ * Addresses resolved with \ref lwesp_dns_gethostbyname are kept on host side
+ * and reused by next queries and by connections started with the same host name,
+ * without sending `AT+CIPDOMAIN` to device. When cache is full, least recently used entry is replaced.
+ *
+ * \note            This feature requires \ref LWESP_CFG_DNS
+ */
+#ifndef LWESP_CFG_DNS_CACHE_SIZE
+#define LWESP_CFG_DNS_CACHE_SIZE              0
+#endif
+
+/**
+ * \brief           Time in units of milliseconds cached DNS entry is valid
+ *
+ * Device does not report TTL of DNS records, hence the same value is used for all entries
+ */
+#ifndef LWESP_CFG_DNS_CACHE_TTL
+#define LWESP_CFG_DNS_CACHE_TTL               60000
+#endif
+
+/**
+ * \brief           Maximal length of host name in DNS cache, including `NULL` termination
+ *
+ * Longer host names are not cached
+ */
+#ifndef LWESP_CFG_DNS_CACHE_HOST_LEN
+#define LWESP_CFG_DNS_CACHE_HOST_LEN          48
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` support for WPS functions
  *
@@ -611,6 +2305,36 @@
 #define LWESP_CFG_SNTP                        0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` local clock synchronized from SNTP
+ *
+ * Clock is periodically synchronized with `AT+CIPSNTPTIME?` and interpolated
+ * between synchronizations from \ref lwesp_sys_now, with drift compensation.
+ * Time is then read with \ref lwesp_sntp_clock_gettime without AT traffic.
+ *
+ * \note            \ref LWESP_CFG_SNTP must be enabled
+ */
+#ifndef LWESP_CFG_SNTP_CLOCK
+#define LWESP_CFG_SNTP_CLOCK                  0
+#endif
+
+/**
+ * \brief           Default interval between local clock synchronizations in units of milliseconds
+ *
+ * Used by \ref lwesp_sntp_clock_start when `0` is passed as interval
+ */
+#ifndef LWESP_CFG_SNTP_CLOCK_SYNC_INTERVAL
+#define LWESP_CFG_SNTP_CLOCK_SYNC_INTERVAL    3600000
+#endif
+
+/**
+ * \brief           Maximal absolute local clock drift accepted by estimation, in units of ppm
+ *
+ */
+#ifndef LWESP_CFG_SNTP_CLOCK_DRIFT_MAX
+#define LWESP_CFG_SNTP_CLOCK_DRIFT_MAX        500
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` support for hostname with AT commands
  *
@@ -619,6 +2343,28 @@
 #define LWESP_CFG_HOSTNAME                    0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` local cache of IP, MAC and hostname settings
+ *
+ * When enabled, \ref lwesp_sta_getip, \ref lwesp_sta_getmac, \ref lwesp_ap_getip,
+ * \ref lwesp_ap_getmac and \ref lwesp_hostname_get return value read from device earlier,
+ * without AT command. Cached value is invalidated on Wi-Fi events,
+ * device reset and commands that change the setting.
+ */
+#ifndef LWESP_CFG_IP_MAC_CACHE
+#define LWESP_CFG_IP_MAC_CACHE                0
+#endif
+
+/**
+ * \brief           Size of hostname cache buffer, including `NULL` termination
+ *
+ * Longer hostnames are not cached.
+ * This parameter has no meaning when \ref LWESP_CFG_IP_MAC_CACHE or \ref LWESP_CFG_HOSTNAME is disabled
+ */
+#ifndef LWESP_CFG_IP_MAC_CACHE_HOSTNAME_LEN
+#define LWESP_CFG_IP_MAC_CACHE_HOSTNAME_LEN   33
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` support for ping functions
  *
@@ -627,6 +2373,18 @@
 #define LWESP_CFG_PING                        0
 #endif
 
+/**
+ * \brief           Maximal number of hosts monitored with periodic ping in background
+ *
+ * Set to `0` to disable ping monitor
+ *
+ * \note            \ref LWESP_CFG_PING must be enabled
+ * \sa              lwesp_ping_monitor_add
+ */
+#ifndef LWESP_CFG_PING_MONITOR
+#define LWESP_CFG_PING_MONITOR                0
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` support for mDNS
  *
@@ -658,6 +2416,39 @@
 #define LWESP_CFG_CONN_POLL_INTERVAL          500
 #endif
 
+/**
+ * \brief           Maximal poll interval for idle connections in units of milliseconds
+ *
+ * Poll interval of connection without data activity is doubled after every poll event,
+ * up to this value, and is reset to \ref LWESP_CFG_CONN_POLL_INTERVAL on first send or receive event.
+ * Polls of all connections are batched to single timer event.
+ *
+ * \note            Set it equal to \ref LWESP_CFG_CONN_POLL_INTERVAL to poll at fixed interval
+ */
+#ifndef LWESP_CFG_CONN_POLL_INTERVAL_MAX
+#define LWESP_CFG_CONN_POLL_INTERVAL_MAX      LWESP_CFG_CONN_POLL_INTERVAL
+#endif
+
+/**
+ * \brief           Maximal number of timeouts active at the same time
+ *
+ * Timeout entries are preallocated and kept in min-heap, ordered by expiry time.
+ * Default size is derived from enabled options:
+ *
+ *  - One entry per connection for poll events
+ *  - One entry per connection for each of write flush (\ref LWESP_CFG_CONN_WRITE_FLUSH_TIME)
+ *      and receive coalescing (\ref LWESP_CFG_CONN_RECV_COALESCE_LEN) timers
+ *  - One entry per ping monitor host (\ref LWESP_CFG_PING_MONITOR)
+ *  - One entry for AT port autobaud and for each of SNTP clock, station manager,
+ *      netconn deadline and pre-warm timers
+ *  - `8` entries for application, such as HTTP server asynchronous file reads and MQTT keep-alive
+ */
+#ifndef LWESP_CFG_TIMEOUT_POOL_SIZE
+#define LWESP_CFG_TIMEOUT_POOL_SIZE           (LWESP_CFG_MAX_CONNS * (1 + (LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0) + (LWESP_CFG_CONN_RECV_COALESCE_LEN > 0))  \
+                                                + (LWESP_CFG_PING ? LWESP_CFG_PING_MONITOR : 0) + 1 + (LWESP_CFG_SNTP_CLOCK != 0)      \
+                                                + (LWESP_CFG_STA_MGR != 0) + (LWESP_CFG_NETCONN_DEADLINE != 0) + (LWESP_CFG_NETCONN_PREWARM != 0) + 8)
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` manual `TCP` data receive from ESP device
  *
@@ -674,6 +2465,45 @@
 #define LWESP_CFG_CONN_MANUAL_TCP_RECEIVE     0
 #endif
 
+/**
+ * \brief           Default receive window of connection in manual `TCP` receive mode, in units of bytes
+ *
+ * Stack reads from device at most as many bytes as fit into window,
+ * reduced by bytes application did not yet acknowledge with \ref lwesp_conn_recved.
+ * Window is set per connection with \ref lwesp_conn_set_receive_window
+ *
+ * \note            Used only when \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE is enabled
+ */
+#ifndef LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_WINDOW
+#define LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_WINDOW  LWESP_CFG_NETCONN_RECEIVE_HIGH_WATERMARK
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` automatic manual `TCP` receive under memory pressure
+ *
+ * Device is kept in automatic receive mode, where data is sent to host with `+IPD` as it arrives.
+ * When packet buffer for received data cannot be allocated, stack switches device
+ * to manual receive mode and ESP buffers further data until host reads it.
+ * Automatic mode is restored once all buffered data were read
+ * and buffer of \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO_RESUME_LEN bytes can be allocated again.
+ *
+ * \note            Requires \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE to be enabled
+ * \note            Data of `+IPD` that failed allocation is still lost, fallback protects following data only
+ */
+#ifndef LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+#define LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO    0
+#endif
+
+/**
+ * \brief           Packet buffer length in units of bytes, that must be allocatable to resume automatic receive mode
+ *
+ * Acts as memory watermark for \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO,
+ * larger value keeps device longer in manual mode after memory pressure
+ */
+#ifndef LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO_RESUME_LEN
+#define LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO_RESUME_LEN LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE
+#endif
+
 /**
  * \defgroup        LWESP_OPT_STD_LIB Standard library
  * \brief           Standard C library configuration
@@ -683,6 +2513,32 @@
  * in case of better implementation with hardware (for example DMA for data copy).
  */
 
+/**
+ * \brief           Enables `1` or disables `0` library memory copy and set functions
+ *
+ * When enabled, \ref LWESP_MEMCPY and \ref LWESP_MEMSET default to \ref lwesp_memcpy and \ref lwesp_memset,
+ * which process data in word units with unrolled loop when alignment permits.
+ * Useful on targets where C library implementation is size optimized and copies byte by byte.
+ *
+ * \note            Has no effect when \ref LWESP_MEMCPY or \ref LWESP_MEMSET are defined by user
+ */
+#ifndef LWESP_CFG_MEM_FAST_COPY
+#define LWESP_CFG_MEM_FAST_COPY               0
+#endif
+
+/**
+ * \brief           Minimal length of data for \ref lwesp_memcpy to offload copy to low-level driver
+ *
+ * Copies of at least this number of bytes are passed to \ref lwesp_ll_memcpy,
+ * which may use DMA for transfer. Set to `0` to disable low-level copy.
+ *
+ * \note            Low-level driver must implement \ref lwesp_ll_memcpy function
+ * \note            Used only when \ref LWESP_CFG_MEM_FAST_COPY is enabled
+ */
+#ifndef LWESP_CFG_MEM_FAST_COPY_LL_LEN
+#define LWESP_CFG_MEM_FAST_COPY_LL_LEN        0
+#endif
+
 /**
  * \brief           Memory copy function declaration
  *
@@ -701,7 +2557,11 @@ void *  my_memcpy(void* dst, const void* src, size_t len);
  * \return          Destination memory start address
  */
 #ifndef LWESP_MEMCPY
+#if LWESP_CFG_MEM_FAST_COPY
+#define LWESP_MEMCPY(dst, src, len)           lwesp_memcpy(dst, src, len)
+#else
 #define LWESP_MEMCPY(dst, src, len)           memcpy(dst, src, len)
+#endif /* LWESP_CFG_MEM_FAST_COPY */
 #endif
 
 /**
@@ -719,7 +2579,11 @@ void *  my_memset(void* dst, int b, size_t len);
  * \return          Destination memory start address
  */
 #ifndef LWESP_MEMSET
+#if LWESP_CFG_MEM_FAST_COPY
+#define LWESP_MEMSET(dst, b, len)             lwesp_memset(dst, b, len)
+#else
 #define LWESP_MEMSET(dst, b, len)             memset(dst, b, len)
+#endif /* LWESP_CFG_MEM_FAST_COPY */
 #endif
 
 /**
@@ -754,6 +2618,56 @@ void *  my_memset(void* dst, int b, size_t len);
 #endif /* LWESP_CFG_INPUT_USE_PROCESS */
 #endif /* !LWESP_CFG_OS */
 
+#if LWESP_CFG_POLL && LWESP_CFG_NETCONN
+#error "LWESP_CFG_NETCONN cannot be used with LWESP_CFG_POLL, netconn API requires threads!"
+#endif /* LWESP_CFG_POLL && LWESP_CFG_NETCONN */
+
+#if LWESP_CFG_POLL && LWESP_CFG_CONN_EVT_WORKERS > 0
+#error "LWESP_CFG_CONN_EVT_WORKERS cannot be used with LWESP_CFG_POLL, workers require threads!"
+#endif /* LWESP_CFG_POLL && LWESP_CFG_CONN_EVT_WORKERS > 0 */
+
+#if LWESP_CFG_CONN_EVT_WORKERS > LWESP_CFG_MAX_CONNS
+#error "LWESP_CFG_CONN_EVT_WORKERS must not be greater than LWESP_CFG_MAX_CONNS!"
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > LWESP_CFG_MAX_CONNS */
+
+#if LWESP_CFG_NETCONN_MUX && !LWESP_CFG_NETCONN
+#error "LWESP_CFG_NETCONN_MUX requires LWESP_CFG_NETCONN to be enabled!"
+#endif /* LWESP_CFG_NETCONN_MUX && !LWESP_CFG_NETCONN */
+
+#if LWESP_CFG_INPUT_WAKEUP_THRESHOLD < 1 || LWESP_CFG_INPUT_WAKEUP_THRESHOLD >= LWESP_CFG_RCV_BUFF_SIZE
+#error "LWESP_CFG_INPUT_WAKEUP_THRESHOLD must be at least 1 and lower than LWESP_CFG_RCV_BUFF_SIZE!"
+#endif /* LWESP_CFG_INPUT_WAKEUP_THRESHOLD < 1 || LWESP_CFG_INPUT_WAKEUP_THRESHOLD >= LWESP_CFG_RCV_BUFF_SIZE */
+
+#if LWESP_CFG_RCV_BUFF_SIZE_MAX < LWESP_CFG_RCV_BUFF_SIZE
+#error "LWESP_CFG_RCV_BUFF_SIZE_MAX must not be lower than LWESP_CFG_RCV_BUFF_SIZE!"
+#endif /* LWESP_CFG_RCV_BUFF_SIZE_MAX < LWESP_CFG_RCV_BUFF_SIZE */
+
+#if LWESP_CFG_MQTT_MAX_REQUESTS < 1 || LWESP_CFG_MQTT_MAX_REQUESTS > 254
+#error "LWESP_CFG_MQTT_MAX_REQUESTS must be in range 1-254!"
+#endif /* LWESP_CFG_MQTT_MAX_REQUESTS < 1 || LWESP_CFG_MQTT_MAX_REQUESTS > 254 */
+#if LWESP_CFG_MQTT_QOS0_QUEUE_LEN < 1 || LWESP_CFG_MQTT_QOS0_QUEUE_LEN > 255
+#error "LWESP_CFG_MQTT_QOS0_QUEUE_LEN must be in range 1-255!"
+#endif /* LWESP_CFG_MQTT_QOS0_QUEUE_LEN < 1 || LWESP_CFG_MQTT_QOS0_QUEUE_LEN > 255 */
+#if LWESP_CFG_MQTT_MAX_SENDS < 1 || LWESP_CFG_MQTT_MAX_SENDS > 255
+#error "LWESP_CFG_MQTT_MAX_SENDS must be in range 1-255!"
+#endif /* LWESP_CFG_MQTT_MAX_SENDS < 1 || LWESP_CFG_MQTT_MAX_SENDS > 255 */
+#if LWESP_CFG_MQTT_V5 && LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 255
+#error "LWESP_CFG_MQTT_TOPIC_ALIAS_MAX must be in range 0-255!"
+#endif /* LWESP_CFG_MQTT_V5 && LWESP_CFG_MQTT_TOPIC_ALIAS_MAX > 255 */
+
+#if LWESP_CFG_AT_PORT_FLOW_CONTROL < 0 || LWESP_CFG_AT_PORT_FLOW_CONTROL > 3
+#error "LWESP_CFG_AT_PORT_FLOW_CONTROL must be in range 0-3!"
+#endif /* LWESP_CFG_AT_PORT_FLOW_CONTROL < 0 || LWESP_CFG_AT_PORT_FLOW_CONTROL > 3 */
+
+/* Zero-copy receive config */
+#if LWESP_CFG_IPD_ZERO_COPY && LWESP_CFG_INPUT_USE_PROCESS
+#error "LWESP_CFG_IPD_ZERO_COPY may only be used when LWESP_CFG_INPUT_USE_PROCESS is disabled!"
+#endif /* LWESP_CFG_IPD_ZERO_COPY && LWESP_CFG_INPUT_USE_PROCESS */
+
+#if LWESP_CFG_IPD_DIRECT && (LWESP_CFG_INPUT_USE_PROCESS || LWESP_CFG_IPD_ZERO_COPY)
+#error "LWESP_CFG_IPD_DIRECT may only be used when LWESP_CFG_INPUT_USE_PROCESS and LWESP_CFG_IPD_ZERO_COPY are disabled!"
+#endif /* LWESP_CFG_IPD_DIRECT && (LWESP_CFG_INPUT_USE_PROCESS || LWESP_CFG_IPD_ZERO_COPY) */
+
 /* Device config */
 #if !LWESP_CFG_ESP8266 && !LWESP_CFG_ESP32
 #error "At least one of LWESP_CFG_ESP8266 or LWESP_CFG_ESP32 must be set to 1!"
@@ -764,8 +2678,160 @@ void *  my_memset(void* dst, int b, size_t len);
 #error "WPS function may only be used when station mode is enabled!"
 #endif /* LWESP_CFG_WPS && !LWESP_CFG_MODE_STATION */
 
+/* Memory config */
+#if LWESP_CFG_MEM_TLSF && LWESP_CFG_MEM_ALIGNMENT < 4
+#error "LWESP_CFG_MEM_TLSF requires LWESP_CFG_MEM_ALIGNMENT of at least 4 bytes!"
+#endif /* LWESP_CFG_MEM_TLSF && LWESP_CFG_MEM_ALIGNMENT < 4 */
+
+#if LWESP_CFG_MEM_PLACEMENT && LWESP_CFG_MEM_PLACEMENT_FAST_REGIONS < 1
+#error "LWESP_CFG_MEM_PLACEMENT_FAST_REGIONS must be at least 1!"
+#endif /* LWESP_CFG_MEM_PLACEMENT && LWESP_CFG_MEM_PLACEMENT_FAST_REGIONS < 1 */
+
+#if LWESP_CFG_MEM_FAST_COPY_LL_LEN && !LWESP_CFG_MEM_FAST_COPY
+#error "LWESP_CFG_MEM_FAST_COPY_LL_LEN requires LWESP_CFG_MEM_FAST_COPY to be enabled!"
+#endif /* LWESP_CFG_MEM_FAST_COPY_LL_LEN && !LWESP_CFG_MEM_FAST_COPY */
+
+#if LWESP_CFG_MEM_STATS && LWESP_CFG_MEM_CUSTOM
+#error "LWESP_CFG_MEM_STATS is available only with built-in memory manager!"
+#endif /* LWESP_CFG_MEM_STATS && LWESP_CFG_MEM_CUSTOM */
+
+#if LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT < LWESP_CFG_CONN_MAX_DATA_LEN
+#error "LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT must not be smaller than LWESP_CFG_CONN_MAX_DATA_LEN!"
+#endif /* LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT < LWESP_CFG_CONN_MAX_DATA_LEN */
+
+#if LWESP_CFG_CONN_SEND_FAIR && !LWESP_CFG_CMD_PRIORITY
+#error "LWESP_CFG_CONN_SEND_FAIR requires LWESP_CFG_CMD_PRIORITY!"
+#endif /* LWESP_CFG_CONN_SEND_FAIR && !LWESP_CFG_CMD_PRIORITY */
+#if LWESP_CFG_CONN_SEND_FAIR && LWESP_CFG_CONN_SEND_COALESCE
+#error "LWESP_CFG_CONN_SEND_FAIR cannot be used together with LWESP_CFG_CONN_SEND_COALESCE!"
+#endif /* LWESP_CFG_CONN_SEND_FAIR && LWESP_CFG_CONN_SEND_COALESCE */
+#if LWESP_CFG_CONN_SEND_FAIR && LWESP_CFG_CONN_SEND_FAIR_QUANTUM < 1
+#error "LWESP_CFG_CONN_SEND_FAIR_QUANTUM must be at least 1!"
+#endif /* LWESP_CFG_CONN_SEND_FAIR && LWESP_CFG_CONN_SEND_FAIR_QUANTUM < 1 */
+
+#if LWESP_CFG_CONN_SEND_BUFFERED && (LWESP_CFG_CONN_SEND_BUFFERED_SEGMENTS < 1 || LWESP_CFG_CONN_SEND_BUFFERED_SEGMENTS > 255)
+#error "LWESP_CFG_CONN_SEND_BUFFERED_SEGMENTS must be between 1 and 255!"
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED && (LWESP_CFG_CONN_SEND_BUFFERED_SEGMENTS < 1 || LWESP_CFG_CONN_SEND_BUFFERED_SEGMENTS > 255) */
+
+#if LWESP_CFG_MAX_CONNS < 1 || LWESP_CFG_MAX_CONNS > 255
+#error "LWESP_CFG_MAX_CONNS must be between 1 and 255!"
+#endif /* LWESP_CFG_MAX_CONNS < 1 || LWESP_CFG_MAX_CONNS > 255 */
+
+/* Timeout config */
+#if LWESP_CFG_TIMEOUT_POOL_SIZE < LWESP_CFG_MAX_CONNS * (1 + (LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0) + (LWESP_CFG_CONN_RECV_COALESCE_LEN > 0)) + 1
+#error "LWESP_CFG_TIMEOUT_POOL_SIZE must hold LWESP_CFG_MAX_CONNS entries for each enabled per-connection timer plus autobaud timer!"
+#endif /* LWESP_CFG_TIMEOUT_POOL_SIZE < LWESP_CFG_MAX_CONNS * (1 + (LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0) + (LWESP_CFG_CONN_RECV_COALESCE_LEN > 0)) + 1 */
+#if LWESP_CFG_TIMEOUT_POOL_SIZE > 0xFFFF
+#error "LWESP_CFG_TIMEOUT_POOL_SIZE must be less than 65536!"
+#endif /* LWESP_CFG_TIMEOUT_POOL_SIZE > 0xFFFF */
+
+#if LWESP_CFG_CONN_POLL_INTERVAL_MAX < LWESP_CFG_CONN_POLL_INTERVAL
+#error "LWESP_CFG_CONN_POLL_INTERVAL_MAX must not be lower than LWESP_CFG_CONN_POLL_INTERVAL!"
+#endif /* LWESP_CFG_CONN_POLL_INTERVAL_MAX < LWESP_CFG_CONN_POLL_INTERVAL */
+
+/* Manual receive fallback config */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO && !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+#error "LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO requires LWESP_CFG_CONN_MANUAL_TCP_RECEIVE to be enabled!"
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO && !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+
+/* Passthrough config */
+#if LWESP_CFG_CONN_PASSTHROUGH && !LWESP_CFG_MODE_STATION
+#error "Passthrough mode may only be used when station mode is enabled!"
+#endif /* LWESP_CFG_CONN_PASSTHROUGH && !LWESP_CFG_MODE_STATION */
+
+/* DNS cache config */
+#if LWESP_CFG_DNS_CACHE_SIZE > 0 && !LWESP_CFG_DNS
+#error "LWESP_CFG_DNS_CACHE_SIZE requires LWESP_CFG_DNS to be enabled!"
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 && !LWESP_CFG_DNS */
+
+/* Station table config */
+#if LWESP_CFG_AP_STA_TABLE > 0 && !LWESP_CFG_MODE_ACCESS_POINT
+#error "LWESP_CFG_AP_STA_TABLE may only be used when access point mode is enabled!"
+#endif /* LWESP_CFG_AP_STA_TABLE > 0 && !LWESP_CFG_MODE_ACCESS_POINT */
+
+/* Sendfile config */
+#if LWESP_CFG_CONN_SENDFILE && (LWESP_CFG_CONN_SENDFILE_READ_AHEAD < 1 || LWESP_CFG_CONN_SENDFILE_READ_AHEAD > 255)
+#error "LWESP_CFG_CONN_SENDFILE_READ_AHEAD must be between 1 and 255!"
+#endif /* LWESP_CFG_CONN_SENDFILE && (LWESP_CFG_CONN_SENDFILE_READ_AHEAD < 1 || LWESP_CFG_CONN_SENDFILE_READ_AHEAD > 255) */
+
+/* Ping monitor config */
+#if LWESP_CFG_PING_MONITOR > 0 && !LWESP_CFG_PING
+#error "LWESP_CFG_PING_MONITOR requires LWESP_CFG_PING to be enabled!"
+#endif /* LWESP_CFG_PING_MONITOR > 0 && !LWESP_CFG_PING */
+
+/* SNTP clock config */
+#if LWESP_CFG_SNTP_CLOCK && !LWESP_CFG_SNTP
+#error "LWESP_CFG_SNTP_CLOCK requires LWESP_CFG_SNTP to be enabled!"
+#endif /* LWESP_CFG_SNTP_CLOCK && !LWESP_CFG_SNTP */
+#if LWESP_CFG_SNTP_CLOCK && (LWESP_CFG_SNTP_CLOCK_SYNC_INTERVAL < 10000 || LWESP_CFG_SNTP_CLOCK_SYNC_INTERVAL > 86400000)
+#error "LWESP_CFG_SNTP_CLOCK_SYNC_INTERVAL must be between 10 seconds and 1 day!"
+#endif /* LWESP_CFG_SNTP_CLOCK && (LWESP_CFG_SNTP_CLOCK_SYNC_INTERVAL < 10000 || LWESP_CFG_SNTP_CLOCK_SYNC_INTERVAL > 86400000) */
+
+/* Fast join config */
+#if LWESP_CFG_STA_FAST_JOIN && !LWESP_CFG_MODE_STATION
+#error "Fast join may only be used when station mode is enabled!"
+#endif /* LWESP_CFG_STA_FAST_JOIN && !LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_STA_MGR && (!LWESP_CFG_MODE_STATION || !LWESP_CFG_USE_API_FUNC_EVT)
+#error "LWESP_CFG_STA_MGR requires LWESP_CFG_MODE_STATION and LWESP_CFG_USE_API_FUNC_EVT!"
+#endif /* LWESP_CFG_STA_MGR && (!LWESP_CFG_MODE_STATION || !LWESP_CFG_USE_API_FUNC_EVT) */
+#if LWESP_CFG_STA_MGR && (LWESP_CFG_STA_MGR_CANDIDATES < 1 || LWESP_CFG_STA_MGR_CANDIDATES > 255)
+#error "LWESP_CFG_STA_MGR_CANDIDATES must be between 1 and 255!"
+#endif /* LWESP_CFG_STA_MGR && (LWESP_CFG_STA_MGR_CANDIDATES < 1 || LWESP_CFG_STA_MGR_CANDIDATES > 255) */
+#if LWESP_CFG_STA_FAST_JOIN && (LWESP_CFG_STA_FAST_JOIN_TIMEOUT < 3 || LWESP_CFG_STA_FAST_JOIN_TIMEOUT > 600)
+#error "LWESP_CFG_STA_FAST_JOIN_TIMEOUT must be between 3 and 600 seconds!"
+#endif /* LWESP_CFG_STA_FAST_JOIN && (LWESP_CFG_STA_FAST_JOIN_TIMEOUT < 3 || LWESP_CFG_STA_FAST_JOIN_TIMEOUT > 600) */
+
+/* Send queue watermarks */
+#if LWESP_CFG_CONN_TX_QUEUE && LWESP_CFG_CONN_TX_QUEUE_HIGH > 0 && LWESP_CFG_CONN_TX_QUEUE_LOW >= LWESP_CFG_CONN_TX_QUEUE_HIGH
+#error "LWESP_CFG_CONN_TX_QUEUE_LOW must be lower than LWESP_CFG_CONN_TX_QUEUE_HIGH!"
+#endif /* LWESP_CFG_CONN_TX_QUEUE && LWESP_CFG_CONN_TX_QUEUE_HIGH > 0 && LWESP_CFG_CONN_TX_QUEUE_LOW >= LWESP_CFG_CONN_TX_QUEUE_HIGH */
+
+#if LWESP_CFG_CONN_SEND_EVT_AGGR && !LWESP_CFG_CONN_TX_QUEUE
+#error "LWESP_CFG_CONN_SEND_EVT_AGGR requires LWESP_CFG_CONN_TX_QUEUE to be enabled!"
+#endif /* LWESP_CFG_CONN_SEND_EVT_AGGR && !LWESP_CFG_CONN_TX_QUEUE */
+
+/* Receive line buffer */
+#if LWESP_CFG_RECV_LINE_BUFF_LEN < 64
+#error "LWESP_CFG_RECV_LINE_BUFF_LEN must be at least 64 bytes!"
+#endif /* LWESP_CFG_RECV_LINE_BUFF_LEN < 64 */
+
+/* Heap-free profile */
+#if LWESP_CFG_STATIC_ONLY
+#if LWESP_CFG_MSG_POOL_SIZE < 1
+#error "LWESP_CFG_STATIC_ONLY requires LWESP_CFG_MSG_POOL_SIZE of at least 1!"
+#endif /* LWESP_CFG_MSG_POOL_SIZE < 1 */
+#if LWESP_CFG_PBUF_POOL_SIZE < 1
+#error "LWESP_CFG_STATIC_ONLY requires LWESP_CFG_PBUF_POOL_SIZE of at least 1!"
+#endif /* LWESP_CFG_PBUF_POOL_SIZE < 1 */
+#if LWESP_CFG_PBUF_POOL_LARGE_LEN < LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE
+#error "LWESP_CFG_STATIC_ONLY requires LWESP_CFG_PBUF_POOL_LARGE_LEN of at least LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE!"
+#endif /* LWESP_CFG_PBUF_POOL_LARGE_LEN < LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE */
+#if LWESP_CFG_CONN_BUFF_POOL_SIZE < 1
+#error "LWESP_CFG_STATIC_ONLY requires LWESP_CFG_CONN_BUFF_POOL_SIZE of at least 1!"
+#endif /* LWESP_CFG_CONN_BUFF_POOL_SIZE < 1 */
+#if LWESP_CFG_NETCONN && !LWESP_CFG_NETCONN_POOL
+#error "LWESP_CFG_STATIC_ONLY requires LWESP_CFG_NETCONN_POOL when LWESP_CFG_NETCONN is enabled!"
+#endif /* LWESP_CFG_NETCONN && !LWESP_CFG_NETCONN_POOL */
+#if LWESP_CFG_NETCONN && LWESP_CFG_NETCONN_POOL_SIZE < LWESP_CFG_MAX_CONNS
+#error "LWESP_CFG_STATIC_ONLY requires LWESP_CFG_NETCONN_POOL_SIZE of at least LWESP_CFG_MAX_CONNS!"
+#endif /* LWESP_CFG_NETCONN && LWESP_CFG_NETCONN_POOL_SIZE < LWESP_CFG_MAX_CONNS */
+#if LWESP_CFG_NETCONN_SELECT
+#error "LWESP_CFG_NETCONN_SELECT allocates wait sets and cannot be used with LWESP_CFG_STATIC_ONLY!"
+#endif /* LWESP_CFG_NETCONN_SELECT */
+#if LWESP_CFG_NETCONN_MUX
+#error "LWESP_CFG_NETCONN_MUX allocates multiplexed connections and cannot be used with LWESP_CFG_STATIC_ONLY!"
+#endif /* LWESP_CFG_NETCONN_MUX */
+#if LWESP_CFG_MQTT_PUBLISH_BACKLOG
+#error "LWESP_CFG_MQTT_PUBLISH_BACKLOG allocates packet copies and cannot be used with LWESP_CFG_STATIC_ONLY!"
+#endif /* LWESP_CFG_MQTT_PUBLISH_BACKLOG */
+#if LWESP_CFG_MQTT_CLIENT_POOL_SIZE < 1 || LWESP_CFG_MQTT_CLIENT_TX_BUFF_LEN < 16 || LWESP_CFG_MQTT_CLIENT_RX_BUFF_LEN < 16
+#error "LWESP_CFG_STATIC_ONLY requires at least 1 MQTT client in pool with buffers of at least 16 bytes!"
+#endif /* LWESP_CFG_MQTT_CLIENT_POOL_SIZE < 1 || LWESP_CFG_MQTT_CLIENT_TX_BUFF_LEN < 16 || LWESP_CFG_MQTT_CLIENT_RX_BUFF_LEN < 16 */
+#endif /* LWESP_CFG_STATIC_ONLY */
+
 #endif /* !__DOXYGEN__ */
 
+#include "lwesp/lwesp_prefix.h"
 #include "lwesp/lwesp_debug.h"
 
 #endif /* LWESP_HDR_DEFAULT_CONFIG_H */
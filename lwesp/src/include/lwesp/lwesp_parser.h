@@ -40,15 +40,51 @@ extern "C" {
 
 #include "lwesp/lwesp.h"
 
+/**
+ * \brief           List of known `+` response keywords
+ */
+typedef enum {
+    LWESP_RESP_KW_NONE = 0x00,                  /*!< Unknown or not present keyword */
+    LWESP_RESP_KW_IPD,                          /*!< `+IPD` response */
+    LWESP_RESP_KW_CIPRECVDATA,                  /*!< `+CIPRECVDATA` response */
+    LWESP_RESP_KW_CIPRECVLEN,                   /*!< `+CIPRECVLEN` response */
+    LWESP_RESP_KW_STA_CONNECTED,                /*!< `+STA_CONNECTED` response */
+    LWESP_RESP_KW_STA_DISCONNECTED,             /*!< `+STA_DISCONNECTED` response */
+    LWESP_RESP_KW_DIST_STA_IP,                  /*!< `+DIST_STA_IP` response */
+    LWESP_RESP_KW_CIPSTAMAC,                    /*!< `+CIPSTAMAC` response */
+    LWESP_RESP_KW_CIPAPMAC,                     /*!< `+CIPAPMAC` response */
+    LWESP_RESP_KW_CIPSTA,                       /*!< `+CIPSTA` response */
+    LWESP_RESP_KW_CIPAP,                        /*!< `+CIPAP` response */
+    LWESP_RESP_KW_CWLAP,                        /*!< `+CWLAP` response */
+    LWESP_RESP_KW_CWJAP,                        /*!< `+CWJAP` response */
+    LWESP_RESP_KW_CWLIF,                        /*!< `+CWLIF` response */
+    LWESP_RESP_KW_CWSAP,                        /*!< `+CWSAP` response */
+    LWESP_RESP_KW_CIPDOMAIN,                    /*!< `+CIPDOMAIN` response */
+    LWESP_RESP_KW_CIPDNS,                       /*!< `+CIPDNS` response */
+    LWESP_RESP_KW_PING,                         /*!< `+PING` response */
+    LWESP_RESP_KW_CIPSNTPTIME,                  /*!< `+CIPSNTPTIME` response */
+    LWESP_RESP_KW_CWHOSTNAME,                   /*!< `+CWHOSTNAME` response */
+    LWESP_RESP_KW_CWDHCP,                       /*!< `+CWDHCP` response */
+    LWESP_RESP_KW_CWMODE,                       /*!< `+CWMODE` response */
+    LWESP_RESP_KW_CIPSTATUS,                    /*!< `+CIPSTATUS` response */
+    LWESP_RESP_KW_LINK_CONN,                    /*!< `+LINK_CONN` response */
+    LWESP_RESP_KW_END,                          /*!< Last entry indicator */
+} lwespi_resp_kw_t;
+
+lwespi_resp_kw_t lwespi_parse_get_resp_kw(const char* str);
+
 int32_t     lwespi_parse_number(const char** str);
 uint8_t     lwespi_parse_string(const char** src, char* dst, size_t dst_len, uint8_t trim);
 uint8_t     lwespi_parse_ip(const char** src, lwesp_ip_t* ip);
 uint8_t     lwespi_parse_mac(const char** src, lwesp_mac_t* mac);
 
 lwespr_t    lwespi_parse_cipstatus(const char* str);
-lwespr_t    lwespi_parse_ipd(const char* str);
+lwespr_t    lwespi_parse_ipd(const char* str, size_t str_len);
 lwespr_t    lwespi_parse_ciprecvdata(const char* str);
 lwespr_t    lwespi_parse_ciprecvlen(const char* str);
+lwespr_t    lwespi_parse_cipsendbuf(const char* str, lwesp_msg_t* msg);
+lwespr_t    lwespi_parse_cipbufstatus(const char* str, lwesp_msg_t* msg);
+lwespr_t    lwespi_parse_send_ack(const char* str);
 
 uint8_t     lwespi_parse_cwlap(const char* str, lwesp_msg_t* msg);
 uint8_t     lwespi_parse_cwjap(const char* str, lwesp_msg_t* msg);
@@ -47,7 +47,20 @@ extern "C" {
  * \{
  */
 
+/**
+ * \brief           Cursor to traverse packet buffer chain
+ *
+ * Cursor keeps current pbuf and offset in it, so that
+ * consecutive reads do not scan the chain from its head again
+ */
+typedef struct {
+    lwesp_pbuf_p p;                             /*!< Current pbuf in chain */
+    size_t off;                                 /*!< Offset in current pbuf */
+    size_t rem;                                 /*!< Number of bytes from cursor to the end of chain */
+} lwesp_pbuf_cursor_t;
+
 lwesp_pbuf_p      lwesp_pbuf_new(size_t len);
+lwesp_pbuf_p      lwesp_pbuf_new_ex(size_t len, size_t headroom);
 size_t          lwesp_pbuf_free(lwesp_pbuf_p pbuf);
 void*           lwesp_pbuf_data(const lwesp_pbuf_p pbuf);
 size_t          lwesp_pbuf_length(const lwesp_pbuf_p pbuf, uint8_t tot);
@@ -59,6 +72,7 @@ lwespr_t          lwesp_pbuf_cat(lwesp_pbuf_p head, const lwesp_pbuf_p tail);
 lwespr_t          lwesp_pbuf_chain(lwesp_pbuf_p head, lwesp_pbuf_p tail);
 lwesp_pbuf_p      lwesp_pbuf_unchain(lwesp_pbuf_p head);
 lwespr_t          lwesp_pbuf_ref(lwesp_pbuf_p pbuf);
+lwesp_pbuf_p      lwesp_pbuf_slice(const lwesp_pbuf_p pbuf, size_t offset, size_t len);
 
 uint8_t         lwesp_pbuf_get_at(const lwesp_pbuf_p pbuf, size_t pos, uint8_t* el);
 size_t          lwesp_pbuf_memcmp(const lwesp_pbuf_p pbuf, const void* data, size_t len, size_t offset);
@@ -67,11 +81,21 @@ size_t          lwesp_pbuf_memfind(const lwesp_pbuf_p pbuf, const void* data, si
 size_t          lwesp_pbuf_strfind(const lwesp_pbuf_p pbuf, const char* str, size_t off);
 
 uint8_t         lwesp_pbuf_advance(lwesp_pbuf_p pbuf, int len);
+uint8_t         lwesp_pbuf_header(lwesp_pbuf_p pbuf, int delta);
+size_t          lwesp_pbuf_headroom(const lwesp_pbuf_p pbuf);
 lwesp_pbuf_p      lwesp_pbuf_skip(lwesp_pbuf_p pbuf, size_t offset, size_t* new_offset);
 
 void*           lwesp_pbuf_get_linear_addr(const lwesp_pbuf_p pbuf, size_t offset, size_t* new_len);
 
+uint8_t         lwesp_pbuf_cursor_init(lwesp_pbuf_cursor_t* cur, const lwesp_pbuf_p pbuf, size_t offset);
+uint8_t         lwesp_pbuf_cursor_next_byte(lwesp_pbuf_cursor_t* cur, uint8_t* el);
+size_t          lwesp_pbuf_cursor_read(lwesp_pbuf_cursor_t* cur, void* data, size_t len);
+void*           lwesp_pbuf_cursor_peek_linear(const lwesp_pbuf_cursor_t* cur, size_t* len);
+size_t          lwesp_pbuf_cursor_skip(lwesp_pbuf_cursor_t* cur, size_t len);
+size_t          lwesp_pbuf_cursor_remaining(const lwesp_pbuf_cursor_t* cur);
+
 void            lwesp_pbuf_set_ip(lwesp_pbuf_p pbuf, const lwesp_ip_t* ip, lwesp_port_t port);
+uint8_t         lwesp_pbuf_get_ip(const lwesp_pbuf_p pbuf, lwesp_ip_t* ip, lwesp_port_t* port);
 
 void            lwesp_pbuf_dump(lwesp_pbuf_p p, uint8_t seq);
 
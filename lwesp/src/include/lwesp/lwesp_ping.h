@@ -49,6 +49,28 @@ extern "C" {
 
 lwespr_t    lwesp_ping(const char* host, uint32_t* time, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 
+#if LWESP_CFG_PING_MONITOR > 0 || __DOXYGEN__
+
+/**
+ * \brief           Round trip time statistics of monitored host
+ */
+typedef struct {
+    uint32_t sent;                              /*!< Number of pings sent */
+    uint32_t received;                          /*!< Number of successful pings. Difference to `sent` is loss */
+    uint32_t last;                              /*!< Last round trip time in units of milliseconds */
+    uint32_t min;                               /*!< Minimal round trip time in units of milliseconds */
+    uint32_t max;                               /*!< Maximal round trip time in units of milliseconds */
+    uint32_t avg;                               /*!< Average round trip time in units of milliseconds */
+    uint32_t jitter;                            /*!< Interarrival jitter as in RFC 3550, in units of milliseconds */
+} lwesp_ping_stats_t;
+
+lwespr_t    lwesp_ping_monitor_add(const char* host, uint32_t interval);
+lwespr_t    lwesp_ping_monitor_remove(const char* host);
+lwespr_t    lwesp_ping_monitor_get_stats(const char* host, lwesp_ping_stats_t* stats);
+lwespr_t    lwesp_ping_monitor_reset_stats(const char* host);
+
+#endif /* LWESP_CFG_PING_MONITOR > 0 || __DOXYGEN__ */
+
 /**
  * \}
  */
@@ -0,0 +1,591 @@
+/**
+ * \file            lwesp_prefix.h
+ * \brief           Global symbol prefix for multiple stack instances
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_PREFIX_H
+#define LWESP_HDR_PREFIX_H
+
+/*
+ * Every global symbol of the library is renamed when \ref LWESP_CFG_PREFIX is defined.
+ * Stack may then be compiled and linked multiple times, once per ESP device,
+ * each copy with own state, threads, low-level driver and system port.
+ *
+ * List covers library, applications, CLI and low-level/system port functions.
+ * Regenerate it with `nm -g --defined-only` on library objects when global function is added.
+ */
+#if defined(LWESP_CFG_PREFIX) && !__DOXYGEN__
+
+#define LWESP_PREFIX_CAT_(a, b)               a ## b
+#define LWESP_PREFIX_CAT(a, b)                LWESP_PREFIX_CAT_(a, b)
+#define LWESP_PREFIX_NAME(x)                  LWESP_PREFIX_CAT(LWESP_CFG_PREFIX, x)
+
+#define cli_in_data                                 LWESP_PREFIX_NAME(cli_in_data)
+#define cli_init                                    LWESP_PREFIX_NAME(cli_init)
+#define cli_lookup_command                          LWESP_PREFIX_NAME(cli_lookup_command)
+#define cli_register_commands                       LWESP_PREFIX_NAME(cli_register_commands)
+#define cli_tab_auto_complete                       LWESP_PREFIX_NAME(cli_tab_auto_complete)
+#define esp                                         LWESP_PREFIX_NAME(esp)
+#define http_fs_close                               LWESP_PREFIX_NAME(http_fs_close)
+#define http_fs_data_close_file                     LWESP_PREFIX_NAME(http_fs_data_close_file)
+#define http_fs_data_get_etag                       LWESP_PREFIX_NAME(http_fs_data_get_etag)
+#define http_fs_data_open_file                      LWESP_PREFIX_NAME(http_fs_data_open_file)
+#define http_fs_data_read_file                      LWESP_PREFIX_NAME(http_fs_data_read_file)
+#define http_fs_data_seek_file                      LWESP_PREFIX_NAME(http_fs_data_seek_file)
+#define http_fs_data_ssi_compile                    LWESP_PREFIX_NAME(http_fs_data_ssi_compile)
+#define http_fs_open                                LWESP_PREFIX_NAME(http_fs_open)
+#define http_fs_opened_files_cnt                    LWESP_PREFIX_NAME(http_fs_opened_files_cnt)
+#define http_fs_read                                LWESP_PREFIX_NAME(http_fs_read)
+#define http_fs_seek                                LWESP_PREFIX_NAME(http_fs_seek)
+#define http_fs_static_files                        LWESP_PREFIX_NAME(http_fs_static_files)
+#define http_get_file_from_uri                      LWESP_PREFIX_NAME(http_get_file_from_uri)
+#define lwesp_accept                                LWESP_PREFIX_NAME(lwesp_accept)
+#define lwesp_ap_disconn_sta                        LWESP_PREFIX_NAME(lwesp_ap_disconn_sta)
+#define lwesp_ap_get_config                         LWESP_PREFIX_NAME(lwesp_ap_get_config)
+#define lwesp_ap_getip                              LWESP_PREFIX_NAME(lwesp_ap_getip)
+#define lwesp_ap_getmac                             LWESP_PREFIX_NAME(lwesp_ap_getmac)
+#define lwesp_ap_list_sta                           LWESP_PREFIX_NAME(lwesp_ap_list_sta)
+#define lwesp_ap_set_config                         LWESP_PREFIX_NAME(lwesp_ap_set_config)
+#define lwesp_ap_setip                              LWESP_PREFIX_NAME(lwesp_ap_setip)
+#define lwesp_ap_setmac                             LWESP_PREFIX_NAME(lwesp_ap_setmac)
+#define lwesp_ap_sta_table_get                      LWESP_PREFIX_NAME(lwesp_ap_sta_table_get)
+#define lwesp_ap_sta_table_get_by_mac               LWESP_PREFIX_NAME(lwesp_ap_sta_table_get_by_mac)
+#define lwesp_ap_sta_table_sync                     LWESP_PREFIX_NAME(lwesp_ap_sta_table_sync)
+#define lwesp_batch_begin                           LWESP_PREFIX_NAME(lwesp_batch_begin)
+#define lwesp_batch_set_deadline                    LWESP_PREFIX_NAME(lwesp_batch_set_deadline)
+#define lwesp_batch_submit                          LWESP_PREFIX_NAME(lwesp_batch_submit)
+#define lwesp_bind                                  LWESP_PREFIX_NAME(lwesp_bind)
+#define lwesp_buff_advance                          LWESP_PREFIX_NAME(lwesp_buff_advance)
+#define lwesp_buff_free                             LWESP_PREFIX_NAME(lwesp_buff_free)
+#define lwesp_buff_get_free                         LWESP_PREFIX_NAME(lwesp_buff_get_free)
+#define lwesp_buff_get_full                         LWESP_PREFIX_NAME(lwesp_buff_get_full)
+#define lwesp_buff_get_linear_block_read_address    LWESP_PREFIX_NAME(lwesp_buff_get_linear_block_read_address)
+#define lwesp_buff_get_linear_block_read_length     LWESP_PREFIX_NAME(lwesp_buff_get_linear_block_read_length)
+#define lwesp_buff_get_linear_block_write_address   LWESP_PREFIX_NAME(lwesp_buff_get_linear_block_write_address)
+#define lwesp_buff_get_linear_block_write_length    LWESP_PREFIX_NAME(lwesp_buff_get_linear_block_write_length)
+#define lwesp_buff_init                             LWESP_PREFIX_NAME(lwesp_buff_init)
+#define lwesp_buff_init_mem                         LWESP_PREFIX_NAME(lwesp_buff_init_mem)
+#define lwesp_buff_peek                             LWESP_PREFIX_NAME(lwesp_buff_peek)
+#define lwesp_buff_read                             LWESP_PREFIX_NAME(lwesp_buff_read)
+#define lwesp_buff_reset                            LWESP_PREFIX_NAME(lwesp_buff_reset)
+#define lwesp_buff_skip                             LWESP_PREFIX_NAME(lwesp_buff_skip)
+#define lwesp_buff_write                            LWESP_PREFIX_NAME(lwesp_buff_write)
+#define lwesp_capture_get_dropped                   LWESP_PREFIX_NAME(lwesp_capture_get_dropped)
+#define lwesp_capture_read                          LWESP_PREFIX_NAME(lwesp_capture_read)
+#define lwesp_capture_start                         LWESP_PREFIX_NAME(lwesp_capture_start)
+#define lwesp_capture_stop                          LWESP_PREFIX_NAME(lwesp_capture_stop)
+#define lwesp_cayenne_create                        LWESP_PREFIX_NAME(lwesp_cayenne_create)
+#define lwesp_cayenne_evt_data_get_msg              LWESP_PREFIX_NAME(lwesp_cayenne_evt_data_get_msg)
+#define lwesp_cayenne_evt_get_type                  LWESP_PREFIX_NAME(lwesp_cayenne_evt_get_type)
+#define lwesp_cayenne_publish_data                  LWESP_PREFIX_NAME(lwesp_cayenne_publish_data)
+#define lwesp_cayenne_publish_data_many             LWESP_PREFIX_NAME(lwesp_cayenne_publish_data_many)
+#define lwesp_cayenne_publish_float                 LWESP_PREFIX_NAME(lwesp_cayenne_publish_float)
+#define lwesp_cayenne_publish_response              LWESP_PREFIX_NAME(lwesp_cayenne_publish_response)
+#define lwesp_cayenne_subscribe                     LWESP_PREFIX_NAME(lwesp_cayenne_subscribe)
+#define lwesp_cayenne_unsubscribe                   LWESP_PREFIX_NAME(lwesp_cayenne_unsubscribe)
+#define lwesp_cli_register_commands                 LWESP_PREFIX_NAME(lwesp_cli_register_commands)
+#define lwesp_cmd_cancel                            LWESP_PREFIX_NAME(lwesp_cmd_cancel)
+#define lwesp_conn_close                            LWESP_PREFIX_NAME(lwesp_conn_close)
+#define lwesp_conn_close_all                        LWESP_PREFIX_NAME(lwesp_conn_close_all)
+#define lwesp_conn_close_many                       LWESP_PREFIX_NAME(lwesp_conn_close_many)
+#define lwesp_conn_from_handle                      LWESP_PREFIX_NAME(lwesp_conn_from_handle)
+#define lwesp_conn_get_arg                          LWESP_PREFIX_NAME(lwesp_conn_get_arg)
+#define lwesp_conn_get_from_evt                     LWESP_PREFIX_NAME(lwesp_conn_get_from_evt)
+#define lwesp_conn_get_handle                       LWESP_PREFIX_NAME(lwesp_conn_get_handle)
+#define lwesp_conn_get_local_port                   LWESP_PREFIX_NAME(lwesp_conn_get_local_port)
+#define lwesp_conn_get_max_data_len                 LWESP_PREFIX_NAME(lwesp_conn_get_max_data_len)
+#define lwesp_conn_get_remote_ip                    LWESP_PREFIX_NAME(lwesp_conn_get_remote_ip)
+#define lwesp_conn_get_remote_port                  LWESP_PREFIX_NAME(lwesp_conn_get_remote_port)
+#define lwesp_conn_get_total_recved_count           LWESP_PREFIX_NAME(lwesp_conn_get_total_recved_count)
+#define lwesp_conn_get_tx_queued                    LWESP_PREFIX_NAME(lwesp_conn_get_tx_queued)
+#define lwesp_conn_getnum                           LWESP_PREFIX_NAME(lwesp_conn_getnum)
+#define lwesp_conn_is_active                        LWESP_PREFIX_NAME(lwesp_conn_is_active)
+#define lwesp_conn_is_client                        LWESP_PREFIX_NAME(lwesp_conn_is_client)
+#define lwesp_conn_is_closed                        LWESP_PREFIX_NAME(lwesp_conn_is_closed)
+#define lwesp_conn_is_server                        LWESP_PREFIX_NAME(lwesp_conn_is_server)
+#define lwesp_conn_recved                           LWESP_PREFIX_NAME(lwesp_conn_recved)
+#define lwesp_conn_send                             LWESP_PREFIX_NAME(lwesp_conn_send)
+#define lwesp_conn_send_pbuf                        LWESP_PREFIX_NAME(lwesp_conn_send_pbuf)
+#define lwesp_conn_sendfile                         LWESP_PREFIX_NAME(lwesp_conn_sendfile)
+#define lwesp_conn_sendto                           LWESP_PREFIX_NAME(lwesp_conn_sendto)
+#define lwesp_conn_sendv                            LWESP_PREFIX_NAME(lwesp_conn_sendv)
+#define lwesp_conn_set_arg                          LWESP_PREFIX_NAME(lwesp_conn_set_arg)
+#define lwesp_conn_set_evt_fn                       LWESP_PREFIX_NAME(lwesp_conn_set_evt_fn)
+#define lwesp_conn_set_ipd_filter                   LWESP_PREFIX_NAME(lwesp_conn_set_ipd_filter)
+#define lwesp_conn_set_poll_interval                LWESP_PREFIX_NAME(lwesp_conn_set_poll_interval)
+#define lwesp_conn_set_priority                     LWESP_PREFIX_NAME(lwesp_conn_set_priority)
+#define lwesp_conn_set_receive_blocked              LWESP_PREFIX_NAME(lwesp_conn_set_receive_blocked)
+#define lwesp_conn_set_receive_window               LWESP_PREFIX_NAME(lwesp_conn_set_receive_window)
+#define lwesp_conn_set_send_evt_batch               LWESP_PREFIX_NAME(lwesp_conn_set_send_evt_batch)
+#define lwesp_conn_set_ssl_buffersize               LWESP_PREFIX_NAME(lwesp_conn_set_ssl_buffersize)
+#define lwesp_conn_set_tx_watermark                 LWESP_PREFIX_NAME(lwesp_conn_set_tx_watermark)
+#define lwesp_conn_set_write_flush_time             LWESP_PREFIX_NAME(lwesp_conn_set_write_flush_time)
+#define lwesp_conn_ssl_set_config                   LWESP_PREFIX_NAME(lwesp_conn_ssl_set_config)
+#define lwesp_conn_start                            LWESP_PREFIX_NAME(lwesp_conn_start)
+#define lwesp_conn_startex                          LWESP_PREFIX_NAME(lwesp_conn_startex)
+#define lwesp_conn_write                            LWESP_PREFIX_NAME(lwesp_conn_write)
+#define lwesp_conn_write_ref                        LWESP_PREFIX_NAME(lwesp_conn_write_ref)
+#define lwesp_connect                               LWESP_PREFIX_NAME(lwesp_connect)
+#define lwesp_core_lock                             LWESP_PREFIX_NAME(lwesp_core_lock)
+#define lwesp_core_unlock                           LWESP_PREFIX_NAME(lwesp_core_unlock)
+#define lwesp_delay                                 LWESP_PREFIX_NAME(lwesp_delay)
+#define lwesp_device_is_esp32                       LWESP_PREFIX_NAME(lwesp_device_is_esp32)
+#define lwesp_device_is_esp8266                     LWESP_PREFIX_NAME(lwesp_device_is_esp8266)
+#define lwesp_device_is_present                     LWESP_PREFIX_NAME(lwesp_device_is_present)
+#define lwesp_device_set_present                    LWESP_PREFIX_NAME(lwesp_device_set_present)
+#define lwesp_dhcp_set_config                       LWESP_PREFIX_NAME(lwesp_dhcp_set_config)
+#define lwesp_dns_cache_flush                       LWESP_PREFIX_NAME(lwesp_dns_cache_flush)
+#define lwesp_dns_get_config                        LWESP_PREFIX_NAME(lwesp_dns_get_config)
+#define lwesp_dns_gethostbyname                     LWESP_PREFIX_NAME(lwesp_dns_gethostbyname)
+#define lwesp_dns_prefetch                          LWESP_PREFIX_NAME(lwesp_dns_prefetch)
+#define lwesp_dns_set_config                        LWESP_PREFIX_NAME(lwesp_dns_set_config)
+#define lwesp_evt_ap_connected_sta_get_mac          LWESP_PREFIX_NAME(lwesp_evt_ap_connected_sta_get_mac)
+#define lwesp_evt_ap_disconnected_sta_get_mac       LWESP_PREFIX_NAME(lwesp_evt_ap_disconnected_sta_get_mac)
+#define lwesp_evt_ap_ip_sta_get_ip                  LWESP_PREFIX_NAME(lwesp_evt_ap_ip_sta_get_ip)
+#define lwesp_evt_ap_ip_sta_get_mac                 LWESP_PREFIX_NAME(lwesp_evt_ap_ip_sta_get_mac)
+#define lwesp_evt_conn_active_get_conn              LWESP_PREFIX_NAME(lwesp_evt_conn_active_get_conn)
+#define lwesp_evt_conn_active_is_client             LWESP_PREFIX_NAME(lwesp_evt_conn_active_is_client)
+#define lwesp_evt_conn_close_get_conn               LWESP_PREFIX_NAME(lwesp_evt_conn_close_get_conn)
+#define lwesp_evt_conn_close_get_result             LWESP_PREFIX_NAME(lwesp_evt_conn_close_get_result)
+#define lwesp_evt_conn_close_is_client              LWESP_PREFIX_NAME(lwesp_evt_conn_close_is_client)
+#define lwesp_evt_conn_close_is_forced              LWESP_PREFIX_NAME(lwesp_evt_conn_close_is_forced)
+#define lwesp_evt_conn_error_get_arg                LWESP_PREFIX_NAME(lwesp_evt_conn_error_get_arg)
+#define lwesp_evt_conn_error_get_error              LWESP_PREFIX_NAME(lwesp_evt_conn_error_get_error)
+#define lwesp_evt_conn_error_get_host               LWESP_PREFIX_NAME(lwesp_evt_conn_error_get_host)
+#define lwesp_evt_conn_error_get_port               LWESP_PREFIX_NAME(lwesp_evt_conn_error_get_port)
+#define lwesp_evt_conn_error_get_type               LWESP_PREFIX_NAME(lwesp_evt_conn_error_get_type)
+#define lwesp_evt_conn_poll_get_conn                LWESP_PREFIX_NAME(lwesp_evt_conn_poll_get_conn)
+#define lwesp_evt_conn_recv_get_buff                LWESP_PREFIX_NAME(lwesp_evt_conn_recv_get_buff)
+#define lwesp_evt_conn_recv_get_conn                LWESP_PREFIX_NAME(lwesp_evt_conn_recv_get_conn)
+#define lwesp_evt_conn_resync_get_conn              LWESP_PREFIX_NAME(lwesp_evt_conn_resync_get_conn)
+#define lwesp_evt_conn_send_ack_get_conn            LWESP_PREFIX_NAME(lwesp_evt_conn_send_ack_get_conn)
+#define lwesp_evt_conn_send_ack_get_length          LWESP_PREFIX_NAME(lwesp_evt_conn_send_ack_get_length)
+#define lwesp_evt_conn_send_ack_get_result          LWESP_PREFIX_NAME(lwesp_evt_conn_send_ack_get_result)
+#define lwesp_evt_conn_send_get_conn                LWESP_PREFIX_NAME(lwesp_evt_conn_send_get_conn)
+#define lwesp_evt_conn_send_get_length              LWESP_PREFIX_NAME(lwesp_evt_conn_send_get_length)
+#define lwesp_evt_conn_send_get_result              LWESP_PREFIX_NAME(lwesp_evt_conn_send_get_result)
+#define lwesp_evt_conn_tx_watermark_get_conn        LWESP_PREFIX_NAME(lwesp_evt_conn_tx_watermark_get_conn)
+#define lwesp_evt_conn_tx_watermark_get_queued      LWESP_PREFIX_NAME(lwesp_evt_conn_tx_watermark_get_queued)
+#define lwesp_evt_conn_tx_watermark_is_high         LWESP_PREFIX_NAME(lwesp_evt_conn_tx_watermark_is_high)
+#define lwesp_evt_deferred_process                  LWESP_PREFIX_NAME(lwesp_evt_deferred_process)
+#define lwesp_evt_dns_hostbyname_get_host           LWESP_PREFIX_NAME(lwesp_evt_dns_hostbyname_get_host)
+#define lwesp_evt_dns_hostbyname_get_ip             LWESP_PREFIX_NAME(lwesp_evt_dns_hostbyname_get_ip)
+#define lwesp_evt_dns_hostbyname_get_result         LWESP_PREFIX_NAME(lwesp_evt_dns_hostbyname_get_result)
+#define lwesp_evt_get_type                          LWESP_PREFIX_NAME(lwesp_evt_get_type)
+#define lwesp_evt_ping_get_host                     LWESP_PREFIX_NAME(lwesp_evt_ping_get_host)
+#define lwesp_evt_ping_get_result                   LWESP_PREFIX_NAME(lwesp_evt_ping_get_result)
+#define lwesp_evt_ping_get_time                     LWESP_PREFIX_NAME(lwesp_evt_ping_get_time)
+#define lwesp_evt_register                          LWESP_PREFIX_NAME(lwesp_evt_register)
+#define lwesp_evt_register_deferred                 LWESP_PREFIX_NAME(lwesp_evt_register_deferred)
+#define lwesp_evt_register_ex                       LWESP_PREFIX_NAME(lwesp_evt_register_ex)
+#define lwesp_evt_reset_detected_is_forced          LWESP_PREFIX_NAME(lwesp_evt_reset_detected_is_forced)
+#define lwesp_evt_reset_get_result                  LWESP_PREFIX_NAME(lwesp_evt_reset_get_result)
+#define lwesp_evt_restore_get_result                LWESP_PREFIX_NAME(lwesp_evt_restore_get_result)
+#define lwesp_evt_server_get_port                   LWESP_PREFIX_NAME(lwesp_evt_server_get_port)
+#define lwesp_evt_server_get_result                 LWESP_PREFIX_NAME(lwesp_evt_server_get_result)
+#define lwesp_evt_server_is_enable                  LWESP_PREFIX_NAME(lwesp_evt_server_is_enable)
+#define lwesp_evt_sta_info_ap_get_channel           LWESP_PREFIX_NAME(lwesp_evt_sta_info_ap_get_channel)
+#define lwesp_evt_sta_info_ap_get_mac               LWESP_PREFIX_NAME(lwesp_evt_sta_info_ap_get_mac)
+#define lwesp_evt_sta_info_ap_get_result            LWESP_PREFIX_NAME(lwesp_evt_sta_info_ap_get_result)
+#define lwesp_evt_sta_info_ap_get_rssi              LWESP_PREFIX_NAME(lwesp_evt_sta_info_ap_get_rssi)
+#define lwesp_evt_sta_info_ap_get_ssid              LWESP_PREFIX_NAME(lwesp_evt_sta_info_ap_get_ssid)
+#define lwesp_evt_sta_join_ap_get_result            LWESP_PREFIX_NAME(lwesp_evt_sta_join_ap_get_result)
+#define lwesp_evt_sta_list_ap_get_aps               LWESP_PREFIX_NAME(lwesp_evt_sta_list_ap_get_aps)
+#define lwesp_evt_sta_list_ap_get_length            LWESP_PREFIX_NAME(lwesp_evt_sta_list_ap_get_length)
+#define lwesp_evt_sta_list_ap_get_result            LWESP_PREFIX_NAME(lwesp_evt_sta_list_ap_get_result)
+#define lwesp_evt_unregister                        LWESP_PREFIX_NAME(lwesp_evt_unregister)
+#define lwesp_fcntl                                 LWESP_PREFIX_NAME(lwesp_fcntl)
+#define lwesp_get_conns_status                      LWESP_PREFIX_NAME(lwesp_get_conns_status)
+#define lwesp_get_current_at_fw_version             LWESP_PREFIX_NAME(lwesp_get_current_at_fw_version)
+#define lwesp_get_param                             LWESP_PREFIX_NAME(lwesp_get_param)
+#define lwesp_get_static_ram_size                   LWESP_PREFIX_NAME(lwesp_get_static_ram_size)
+#define lwesp_get_thread_stack_free                 LWESP_PREFIX_NAME(lwesp_get_thread_stack_free)
+#define lwesp_get_wifi_mode                         LWESP_PREFIX_NAME(lwesp_get_wifi_mode)
+#define lwesp_hostname_get                          LWESP_PREFIX_NAME(lwesp_hostname_get)
+#define lwesp_hostname_set                          LWESP_PREFIX_NAME(lwesp_hostname_set)
+#define lwesp_http_client_delete                    LWESP_PREFIX_NAME(lwesp_http_client_delete)
+#define lwesp_http_client_new                       LWESP_PREFIX_NAME(lwesp_http_client_new)
+#define lwesp_http_client_request                   LWESP_PREFIX_NAME(lwesp_http_client_request)
+#define lwesp_http_server_fs_cache_reset            LWESP_PREFIX_NAME(lwesp_http_server_fs_cache_reset)
+#define lwesp_http_server_fs_read_done              LWESP_PREFIX_NAME(lwesp_http_server_fs_read_done)
+#define lwesp_http_server_get_header                LWESP_PREFIX_NAME(lwesp_http_server_get_header)
+#define lwesp_http_server_get_param                 LWESP_PREFIX_NAME(lwesp_http_server_get_param)
+#define lwesp_http_server_init                      LWESP_PREFIX_NAME(lwesp_http_server_init)
+#define lwesp_http_server_post_data_recved          LWESP_PREFIX_NAME(lwesp_http_server_post_data_recved)
+#define lwesp_http_server_resp_cache_reset          LWESP_PREFIX_NAME(lwesp_http_server_resp_cache_reset)
+#define lwesp_http_server_ssi_compile               LWESP_PREFIX_NAME(lwesp_http_server_ssi_compile)
+#define lwesp_http_server_write                     LWESP_PREFIX_NAME(lwesp_http_server_write)
+#define lwesp_http_server_ws_send                   LWESP_PREFIX_NAME(lwesp_http_server_ws_send)
+#define lwesp_i32_to_gen_str                        LWESP_PREFIX_NAME(lwesp_i32_to_gen_str)
+#define lwesp_init                                  LWESP_PREFIX_NAME(lwesp_init)
+#define lwesp_input                                 LWESP_PREFIX_NAME(lwesp_input)
+#define lwesp_input_commit                          LWESP_PREFIX_NAME(lwesp_input_commit)
+#define lwesp_input_get_write_buff                  LWESP_PREFIX_NAME(lwesp_input_get_write_buff)
+#define lwesp_input_isr                             LWESP_PREFIX_NAME(lwesp_input_isr)
+#define lwesp_input_notify                          LWESP_PREFIX_NAME(lwesp_input_notify)
+#define lwesp_input_process                         LWESP_PREFIX_NAME(lwesp_input_process)
+#define lwesp_listen                                LWESP_PREFIX_NAME(lwesp_listen)
+#define lwesp_ll_deinit                             LWESP_PREFIX_NAME(lwesp_ll_deinit)
+#define lwesp_ll_init                               LWESP_PREFIX_NAME(lwesp_ll_init)
+#define lwesp_ll_memcpy                             LWESP_PREFIX_NAME(lwesp_ll_memcpy)
+#define lwesp_mdns_set_config                       LWESP_PREFIX_NAME(lwesp_mdns_set_config)
+#define lwesp_mem_assignmemory                      LWESP_PREFIX_NAME(lwesp_mem_assignmemory)
+#define lwesp_mem_calloc                            LWESP_PREFIX_NAME(lwesp_mem_calloc)
+#define lwesp_mem_calloc_tag                        LWESP_PREFIX_NAME(lwesp_mem_calloc_tag)
+#define lwesp_mem_free                              LWESP_PREFIX_NAME(lwesp_mem_free)
+#define lwesp_mem_free_s                            LWESP_PREFIX_NAME(lwesp_mem_free_s)
+#define lwesp_mem_get_stats                         LWESP_PREFIX_NAME(lwesp_mem_get_stats)
+#define lwesp_mem_malloc                            LWESP_PREFIX_NAME(lwesp_mem_malloc)
+#define lwesp_mem_malloc_tag                        LWESP_PREFIX_NAME(lwesp_mem_malloc_tag)
+#define lwesp_mem_realloc                           LWESP_PREFIX_NAME(lwesp_mem_realloc)
+#define lwesp_memcpy                                LWESP_PREFIX_NAME(lwesp_memcpy)
+#define lwesp_memset                                LWESP_PREFIX_NAME(lwesp_memset)
+#define lwesp_mqtt_client_api_buf_free              LWESP_PREFIX_NAME(lwesp_mqtt_client_api_buf_free)
+#define lwesp_mqtt_client_api_buf_free_many         LWESP_PREFIX_NAME(lwesp_mqtt_client_api_buf_free_many)
+#define lwesp_mqtt_client_api_close                 LWESP_PREFIX_NAME(lwesp_mqtt_client_api_close)
+#define lwesp_mqtt_client_api_connect               LWESP_PREFIX_NAME(lwesp_mqtt_client_api_connect)
+#define lwesp_mqtt_client_api_delete                LWESP_PREFIX_NAME(lwesp_mqtt_client_api_delete)
+#define lwesp_mqtt_client_api_group_delete          LWESP_PREFIX_NAME(lwesp_mqtt_client_api_group_delete)
+#define lwesp_mqtt_client_api_group_new             LWESP_PREFIX_NAME(lwesp_mqtt_client_api_group_new)
+#define lwesp_mqtt_client_api_group_receive         LWESP_PREFIX_NAME(lwesp_mqtt_client_api_group_receive)
+#define lwesp_mqtt_client_api_group_wakeup          LWESP_PREFIX_NAME(lwesp_mqtt_client_api_group_wakeup)
+#define lwesp_mqtt_client_api_is_connected          LWESP_PREFIX_NAME(lwesp_mqtt_client_api_is_connected)
+#define lwesp_mqtt_client_api_new                   LWESP_PREFIX_NAME(lwesp_mqtt_client_api_new)
+#define lwesp_mqtt_client_api_new_in_group          LWESP_PREFIX_NAME(lwesp_mqtt_client_api_new_in_group)
+#define lwesp_mqtt_client_api_publish               LWESP_PREFIX_NAME(lwesp_mqtt_client_api_publish)
+#define lwesp_mqtt_client_api_publish_many          LWESP_PREFIX_NAME(lwesp_mqtt_client_api_publish_many)
+#define lwesp_mqtt_client_api_receive               LWESP_PREFIX_NAME(lwesp_mqtt_client_api_receive)
+#define lwesp_mqtt_client_api_receive_many          LWESP_PREFIX_NAME(lwesp_mqtt_client_api_receive_many)
+#define lwesp_mqtt_client_api_set_recv_fn           LWESP_PREFIX_NAME(lwesp_mqtt_client_api_set_recv_fn)
+#define lwesp_mqtt_client_api_subscribe             LWESP_PREFIX_NAME(lwesp_mqtt_client_api_subscribe)
+#define lwesp_mqtt_client_api_subscribe_many        LWESP_PREFIX_NAME(lwesp_mqtt_client_api_subscribe_many)
+#define lwesp_mqtt_client_api_unsubscribe           LWESP_PREFIX_NAME(lwesp_mqtt_client_api_unsubscribe)
+#define lwesp_mqtt_client_connect                   LWESP_PREFIX_NAME(lwesp_mqtt_client_connect)
+#define lwesp_mqtt_client_delete                    LWESP_PREFIX_NAME(lwesp_mqtt_client_delete)
+#define lwesp_mqtt_client_disconnect                LWESP_PREFIX_NAME(lwesp_mqtt_client_disconnect)
+#define lwesp_mqtt_client_get_arg                   LWESP_PREFIX_NAME(lwesp_mqtt_client_get_arg)
+#define lwesp_mqtt_client_is_connected              LWESP_PREFIX_NAME(lwesp_mqtt_client_is_connected)
+#define lwesp_mqtt_client_new                       LWESP_PREFIX_NAME(lwesp_mqtt_client_new)
+#define lwesp_mqtt_client_publish                   LWESP_PREFIX_NAME(lwesp_mqtt_client_publish)
+#define lwesp_mqtt_client_publish_many              LWESP_PREFIX_NAME(lwesp_mqtt_client_publish_many)
+#define lwesp_mqtt_client_publish_nocopy            LWESP_PREFIX_NAME(lwesp_mqtt_client_publish_nocopy)
+#define lwesp_mqtt_client_set_arg                   LWESP_PREFIX_NAME(lwesp_mqtt_client_set_arg)
+#define lwesp_mqtt_client_set_session_fn            LWESP_PREFIX_NAME(lwesp_mqtt_client_set_session_fn)
+#define lwesp_mqtt_client_subscribe                 LWESP_PREFIX_NAME(lwesp_mqtt_client_subscribe)
+#define lwesp_mqtt_client_subscribe_many            LWESP_PREFIX_NAME(lwesp_mqtt_client_subscribe_many)
+#define lwesp_mqtt_client_unsubscribe               LWESP_PREFIX_NAME(lwesp_mqtt_client_unsubscribe)
+#define lwesp_mqtt_router_add                       LWESP_PREFIX_NAME(lwesp_mqtt_router_add)
+#define lwesp_mqtt_router_dispatch                  LWESP_PREFIX_NAME(lwesp_mqtt_router_dispatch)
+#define lwesp_mqtt_router_free                      LWESP_PREFIX_NAME(lwesp_mqtt_router_free)
+#define lwesp_mqtt_router_init                      LWESP_PREFIX_NAME(lwesp_mqtt_router_init)
+#define lwesp_mqtt_router_remove                    LWESP_PREFIX_NAME(lwesp_mqtt_router_remove)
+#define lwesp_netconn_accept                        LWESP_PREFIX_NAME(lwesp_netconn_accept)
+#define lwesp_netconn_accept_many                   LWESP_PREFIX_NAME(lwesp_netconn_accept_many)
+#define lwesp_netconn_bind                          LWESP_PREFIX_NAME(lwesp_netconn_bind)
+#define lwesp_netconn_close                         LWESP_PREFIX_NAME(lwesp_netconn_close)
+#define lwesp_netconn_connect                       LWESP_PREFIX_NAME(lwesp_netconn_connect)
+#define lwesp_netconn_connect_ex                    LWESP_PREFIX_NAME(lwesp_netconn_connect_ex)
+#define lwesp_netconn_delete                        LWESP_PREFIX_NAME(lwesp_netconn_delete)
+#define lwesp_netconn_flush                         LWESP_PREFIX_NAME(lwesp_netconn_flush)
+#define lwesp_netconn_get_conn                      LWESP_PREFIX_NAME(lwesp_netconn_get_conn)
+#define lwesp_netconn_get_connnum                   LWESP_PREFIX_NAME(lwesp_netconn_get_connnum)
+#define lwesp_netconn_get_receive_timeout           LWESP_PREFIX_NAME(lwesp_netconn_get_receive_timeout)
+#define lwesp_netconn_get_write_available           LWESP_PREFIX_NAME(lwesp_netconn_get_write_available)
+#define lwesp_netconn_is_ready                      LWESP_PREFIX_NAME(lwesp_netconn_is_ready)
+#define lwesp_netconn_listen                        LWESP_PREFIX_NAME(lwesp_netconn_listen)
+#define lwesp_netconn_listen_with_max_conn          LWESP_PREFIX_NAME(lwesp_netconn_listen_with_max_conn)
+#define lwesp_netconn_mux_ops                       LWESP_PREFIX_NAME(lwesp_netconn_mux_ops)
+#define lwesp_netconn_new                           LWESP_PREFIX_NAME(lwesp_netconn_new)
+#define lwesp_netconn_prewarm_add                   LWESP_PREFIX_NAME(lwesp_netconn_prewarm_add)
+#define lwesp_netconn_prewarm_get_ready             LWESP_PREFIX_NAME(lwesp_netconn_prewarm_get_ready)
+#define lwesp_netconn_prewarm_remove                LWESP_PREFIX_NAME(lwesp_netconn_prewarm_remove)
+#define lwesp_netconn_reactor_add                   LWESP_PREFIX_NAME(lwesp_netconn_reactor_add)
+#define lwesp_netconn_reactor_run                   LWESP_PREFIX_NAME(lwesp_netconn_reactor_run)
+#define lwesp_netconn_read                          LWESP_PREFIX_NAME(lwesp_netconn_read)
+#define lwesp_netconn_receive                       LWESP_PREFIX_NAME(lwesp_netconn_receive)
+#define lwesp_netconn_receive_many                  LWESP_PREFIX_NAME(lwesp_netconn_receive_many)
+#define lwesp_netconn_select                        LWESP_PREFIX_NAME(lwesp_netconn_select)
+#define lwesp_netconn_send                          LWESP_PREFIX_NAME(lwesp_netconn_send)
+#define lwesp_netconn_sendto                        LWESP_PREFIX_NAME(lwesp_netconn_sendto)
+#define lwesp_netconn_sendto_many                   LWESP_PREFIX_NAME(lwesp_netconn_sendto_many)
+#define lwesp_netconn_set_accept_prealloc           LWESP_PREFIX_NAME(lwesp_netconn_set_accept_prealloc)
+#define lwesp_netconn_set_add                       LWESP_PREFIX_NAME(lwesp_netconn_set_add)
+#define lwesp_netconn_set_delete                    LWESP_PREFIX_NAME(lwesp_netconn_set_delete)
+#define lwesp_netconn_set_idle_deadline             LWESP_PREFIX_NAME(lwesp_netconn_set_idle_deadline)
+#define lwesp_netconn_set_listen_conn_timeout       LWESP_PREFIX_NAME(lwesp_netconn_set_listen_conn_timeout)
+#define lwesp_netconn_set_new                       LWESP_PREFIX_NAME(lwesp_netconn_set_new)
+#define lwesp_netconn_set_receive_timeout           LWESP_PREFIX_NAME(lwesp_netconn_set_receive_timeout)
+#define lwesp_netconn_set_remove                    LWESP_PREFIX_NAME(lwesp_netconn_set_remove)
+#define lwesp_netconn_write                         LWESP_PREFIX_NAME(lwesp_netconn_write)
+#define lwesp_netconn_write_nonblock                LWESP_PREFIX_NAME(lwesp_netconn_write_nonblock)
+#define lwesp_pbuf_advance                          LWESP_PREFIX_NAME(lwesp_pbuf_advance)
+#define lwesp_pbuf_cat                              LWESP_PREFIX_NAME(lwesp_pbuf_cat)
+#define lwesp_pbuf_chain                            LWESP_PREFIX_NAME(lwesp_pbuf_chain)
+#define lwesp_pbuf_copy                             LWESP_PREFIX_NAME(lwesp_pbuf_copy)
+#define lwesp_pbuf_cursor_init                      LWESP_PREFIX_NAME(lwesp_pbuf_cursor_init)
+#define lwesp_pbuf_cursor_next_byte                 LWESP_PREFIX_NAME(lwesp_pbuf_cursor_next_byte)
+#define lwesp_pbuf_cursor_peek_linear               LWESP_PREFIX_NAME(lwesp_pbuf_cursor_peek_linear)
+#define lwesp_pbuf_cursor_read                      LWESP_PREFIX_NAME(lwesp_pbuf_cursor_read)
+#define lwesp_pbuf_cursor_remaining                 LWESP_PREFIX_NAME(lwesp_pbuf_cursor_remaining)
+#define lwesp_pbuf_cursor_skip                      LWESP_PREFIX_NAME(lwesp_pbuf_cursor_skip)
+#define lwesp_pbuf_data                             LWESP_PREFIX_NAME(lwesp_pbuf_data)
+#define lwesp_pbuf_dump                             LWESP_PREFIX_NAME(lwesp_pbuf_dump)
+#define lwesp_pbuf_free                             LWESP_PREFIX_NAME(lwesp_pbuf_free)
+#define lwesp_pbuf_get_at                           LWESP_PREFIX_NAME(lwesp_pbuf_get_at)
+#define lwesp_pbuf_get_ip                           LWESP_PREFIX_NAME(lwesp_pbuf_get_ip)
+#define lwesp_pbuf_get_linear_addr                  LWESP_PREFIX_NAME(lwesp_pbuf_get_linear_addr)
+#define lwesp_pbuf_header                           LWESP_PREFIX_NAME(lwesp_pbuf_header)
+#define lwesp_pbuf_headroom                         LWESP_PREFIX_NAME(lwesp_pbuf_headroom)
+#define lwesp_pbuf_length                           LWESP_PREFIX_NAME(lwesp_pbuf_length)
+#define lwesp_pbuf_memcmp                           LWESP_PREFIX_NAME(lwesp_pbuf_memcmp)
+#define lwesp_pbuf_memfind                          LWESP_PREFIX_NAME(lwesp_pbuf_memfind)
+#define lwesp_pbuf_new                              LWESP_PREFIX_NAME(lwesp_pbuf_new)
+#define lwesp_pbuf_new_ex                           LWESP_PREFIX_NAME(lwesp_pbuf_new_ex)
+#define lwesp_pbuf_ref                              LWESP_PREFIX_NAME(lwesp_pbuf_ref)
+#define lwesp_pbuf_set_ip                           LWESP_PREFIX_NAME(lwesp_pbuf_set_ip)
+#define lwesp_pbuf_set_length                       LWESP_PREFIX_NAME(lwesp_pbuf_set_length)
+#define lwesp_pbuf_skip                             LWESP_PREFIX_NAME(lwesp_pbuf_skip)
+#define lwesp_pbuf_slice                            LWESP_PREFIX_NAME(lwesp_pbuf_slice)
+#define lwesp_pbuf_strcmp                           LWESP_PREFIX_NAME(lwesp_pbuf_strcmp)
+#define lwesp_pbuf_strfind                          LWESP_PREFIX_NAME(lwesp_pbuf_strfind)
+#define lwesp_pbuf_take                             LWESP_PREFIX_NAME(lwesp_pbuf_take)
+#define lwesp_pbuf_unchain                          LWESP_PREFIX_NAME(lwesp_pbuf_unchain)
+#define lwesp_ping                                  LWESP_PREFIX_NAME(lwesp_ping)
+#define lwesp_ping_monitor_add                      LWESP_PREFIX_NAME(lwesp_ping_monitor_add)
+#define lwesp_ping_monitor_get_stats                LWESP_PREFIX_NAME(lwesp_ping_monitor_get_stats)
+#define lwesp_ping_monitor_remove                   LWESP_PREFIX_NAME(lwesp_ping_monitor_remove)
+#define lwesp_ping_monitor_reset_stats              LWESP_PREFIX_NAME(lwesp_ping_monitor_reset_stats)
+#define lwesp_poll                                  LWESP_PREFIX_NAME(lwesp_poll)
+#define lwesp_recv                                  LWESP_PREFIX_NAME(lwesp_recv)
+#define lwesp_recv_zc                               LWESP_PREFIX_NAME(lwesp_recv_zc)
+#define lwesp_recv_zc_done                          LWESP_PREFIX_NAME(lwesp_recv_zc_done)
+#define lwesp_recvfrom                              LWESP_PREFIX_NAME(lwesp_recvfrom)
+#define lwesp_reset                                 LWESP_PREFIX_NAME(lwesp_reset)
+#define lwesp_reset_warm                            LWESP_PREFIX_NAME(lwesp_reset_warm)
+#define lwesp_reset_with_delay                      LWESP_PREFIX_NAME(lwesp_reset_with_delay)
+#define lwesp_restore                               LWESP_PREFIX_NAME(lwesp_restore)
+#define lwesp_select                                LWESP_PREFIX_NAME(lwesp_select)
+#define lwesp_send                                  LWESP_PREFIX_NAME(lwesp_send)
+#define lwesp_sendto                                LWESP_PREFIX_NAME(lwesp_sendto)
+#define lwesp_set_at_baudrate                       LWESP_PREFIX_NAME(lwesp_set_at_baudrate)
+#define lwesp_set_at_baudrate_auto                  LWESP_PREFIX_NAME(lwesp_set_at_baudrate_auto)
+#define lwesp_set_param                             LWESP_PREFIX_NAME(lwesp_set_param)
+#define lwesp_set_server                            LWESP_PREFIX_NAME(lwesp_set_server)
+#define lwesp_set_wifi_mode                         LWESP_PREFIX_NAME(lwesp_set_wifi_mode)
+#define lwesp_smart_set_config                      LWESP_PREFIX_NAME(lwesp_smart_set_config)
+#define lwesp_sntp_clock_get_epoch                  LWESP_PREFIX_NAME(lwesp_sntp_clock_get_epoch)
+#define lwesp_sntp_clock_gettime                    LWESP_PREFIX_NAME(lwesp_sntp_clock_gettime)
+#define lwesp_sntp_clock_start                      LWESP_PREFIX_NAME(lwesp_sntp_clock_start)
+#define lwesp_sntp_clock_stop                       LWESP_PREFIX_NAME(lwesp_sntp_clock_stop)
+#define lwesp_sntp_gettime                          LWESP_PREFIX_NAME(lwesp_sntp_gettime)
+#define lwesp_sntp_set_config                       LWESP_PREFIX_NAME(lwesp_sntp_set_config)
+#define lwesp_sock_close                            LWESP_PREFIX_NAME(lwesp_sock_close)
+#define lwesp_sock_get_error                        LWESP_PREFIX_NAME(lwesp_sock_get_error)
+#define lwesp_sock_get_netconn                      LWESP_PREFIX_NAME(lwesp_sock_get_netconn)
+#define lwesp_socket                                LWESP_PREFIX_NAME(lwesp_socket)
+#define lwesp_sta_autojoin                          LWESP_PREFIX_NAME(lwesp_sta_autojoin)
+#define lwesp_sta_copy_ip                           LWESP_PREFIX_NAME(lwesp_sta_copy_ip)
+#define lwesp_sta_get_ap_info                       LWESP_PREFIX_NAME(lwesp_sta_get_ap_info)
+#define lwesp_sta_getip                             LWESP_PREFIX_NAME(lwesp_sta_getip)
+#define lwesp_sta_getmac                            LWESP_PREFIX_NAME(lwesp_sta_getmac)
+#define lwesp_sta_has_ip                            LWESP_PREFIX_NAME(lwesp_sta_has_ip)
+#define lwesp_sta_is_ap_802_11b                     LWESP_PREFIX_NAME(lwesp_sta_is_ap_802_11b)
+#define lwesp_sta_is_ap_802_11g                     LWESP_PREFIX_NAME(lwesp_sta_is_ap_802_11g)
+#define lwesp_sta_is_ap_802_11n                     LWESP_PREFIX_NAME(lwesp_sta_is_ap_802_11n)
+#define lwesp_sta_is_joined                         LWESP_PREFIX_NAME(lwesp_sta_is_joined)
+#define lwesp_sta_join                              LWESP_PREFIX_NAME(lwesp_sta_join)
+#define lwesp_sta_list_ap                           LWESP_PREFIX_NAME(lwesp_sta_list_ap)
+#define lwesp_sta_list_ap_stream                    LWESP_PREFIX_NAME(lwesp_sta_list_ap_stream)
+#define lwesp_sta_mgr_get_candidates                LWESP_PREFIX_NAME(lwesp_sta_mgr_get_candidates)
+#define lwesp_sta_mgr_roam                          LWESP_PREFIX_NAME(lwesp_sta_mgr_roam)
+#define lwesp_sta_mgr_start                         LWESP_PREFIX_NAME(lwesp_sta_mgr_start)
+#define lwesp_sta_mgr_stop                          LWESP_PREFIX_NAME(lwesp_sta_mgr_stop)
+#define lwesp_sta_quit                              LWESP_PREFIX_NAME(lwesp_sta_quit)
+#define lwesp_sta_reconnect_set_config              LWESP_PREFIX_NAME(lwesp_sta_reconnect_set_config)
+#define lwesp_sta_setip                             LWESP_PREFIX_NAME(lwesp_sta_setip)
+#define lwesp_sta_setmac                            LWESP_PREFIX_NAME(lwesp_sta_setmac)
+#define lwesp_stats_get                             LWESP_PREFIX_NAME(lwesp_stats_get)
+#define lwesp_stats_get_cmd                         LWESP_PREFIX_NAME(lwesp_stats_get_cmd)
+#define lwesp_stats_get_conn                        LWESP_PREFIX_NAME(lwesp_stats_get_conn)
+#define lwesp_stats_reset                           LWESP_PREFIX_NAME(lwesp_stats_reset)
+#define lwesp_sys_init                              LWESP_PREFIX_NAME(lwesp_sys_init)
+#define lwesp_sys_mbox_create                       LWESP_PREFIX_NAME(lwesp_sys_mbox_create)
+#define lwesp_sys_mbox_delete                       LWESP_PREFIX_NAME(lwesp_sys_mbox_delete)
+#define lwesp_sys_mbox_get                          LWESP_PREFIX_NAME(lwesp_sys_mbox_get)
+#define lwesp_sys_mbox_getnow                       LWESP_PREFIX_NAME(lwesp_sys_mbox_getnow)
+#define lwesp_sys_mbox_invalid                      LWESP_PREFIX_NAME(lwesp_sys_mbox_invalid)
+#define lwesp_sys_mbox_isvalid                      LWESP_PREFIX_NAME(lwesp_sys_mbox_isvalid)
+#define lwesp_sys_mbox_put                          LWESP_PREFIX_NAME(lwesp_sys_mbox_put)
+#define lwesp_sys_mbox_putnow                       LWESP_PREFIX_NAME(lwesp_sys_mbox_putnow)
+#define lwesp_sys_mutex_create                      LWESP_PREFIX_NAME(lwesp_sys_mutex_create)
+#define lwesp_sys_mutex_delete                      LWESP_PREFIX_NAME(lwesp_sys_mutex_delete)
+#define lwesp_sys_mutex_invalid                     LWESP_PREFIX_NAME(lwesp_sys_mutex_invalid)
+#define lwesp_sys_mutex_isvalid                     LWESP_PREFIX_NAME(lwesp_sys_mutex_isvalid)
+#define lwesp_sys_mutex_lock                        LWESP_PREFIX_NAME(lwesp_sys_mutex_lock)
+#define lwesp_sys_mutex_unlock                      LWESP_PREFIX_NAME(lwesp_sys_mutex_unlock)
+#define lwesp_sys_now                               LWESP_PREFIX_NAME(lwesp_sys_now)
+#define lwesp_sys_now_us                            LWESP_PREFIX_NAME(lwesp_sys_now_us)
+#define lwesp_sys_protect                           LWESP_PREFIX_NAME(lwesp_sys_protect)
+#define lwesp_sys_sem_create                        LWESP_PREFIX_NAME(lwesp_sys_sem_create)
+#define lwesp_sys_sem_delete                        LWESP_PREFIX_NAME(lwesp_sys_sem_delete)
+#define lwesp_sys_sem_invalid                       LWESP_PREFIX_NAME(lwesp_sys_sem_invalid)
+#define lwesp_sys_sem_isvalid                       LWESP_PREFIX_NAME(lwesp_sys_sem_isvalid)
+#define lwesp_sys_sem_release                       LWESP_PREFIX_NAME(lwesp_sys_sem_release)
+#define lwesp_sys_sem_wait                          LWESP_PREFIX_NAME(lwesp_sys_sem_wait)
+#define lwesp_sys_thread_create                     LWESP_PREFIX_NAME(lwesp_sys_thread_create)
+#define lwesp_sys_thread_notify                     LWESP_PREFIX_NAME(lwesp_sys_thread_notify)
+#define lwesp_sys_thread_notify_get                 LWESP_PREFIX_NAME(lwesp_sys_thread_notify_get)
+#define lwesp_sys_thread_notify_wait                LWESP_PREFIX_NAME(lwesp_sys_thread_notify_wait)
+#define lwesp_sys_thread_stack_free                 LWESP_PREFIX_NAME(lwesp_sys_thread_stack_free)
+#define lwesp_sys_thread_terminate                  LWESP_PREFIX_NAME(lwesp_sys_thread_terminate)
+#define lwesp_sys_thread_yield                      LWESP_PREFIX_NAME(lwesp_sys_thread_yield)
+#define lwesp_sys_unprotect                         LWESP_PREFIX_NAME(lwesp_sys_unprotect)
+#define lwesp_thread_conn_evt                       LWESP_PREFIX_NAME(lwesp_thread_conn_evt)
+#define lwesp_thread_process                        LWESP_PREFIX_NAME(lwesp_thread_process)
+#define lwesp_thread_produce                        LWESP_PREFIX_NAME(lwesp_thread_produce)
+#define lwesp_timeout_add                           LWESP_PREFIX_NAME(lwesp_timeout_add)
+#define lwesp_timeout_addex                         LWESP_PREFIX_NAME(lwesp_timeout_addex)
+#define lwesp_timeout_cancel                        LWESP_PREFIX_NAME(lwesp_timeout_cancel)
+#define lwesp_timeout_next_deadline                 LWESP_PREFIX_NAME(lwesp_timeout_next_deadline)
+#define lwesp_timeout_remove                        LWESP_PREFIX_NAME(lwesp_timeout_remove)
+#define lwesp_trace_export                          LWESP_PREFIX_NAME(lwesp_trace_export)
+#define lwesp_trace_get_lost                        LWESP_PREFIX_NAME(lwesp_trace_get_lost)
+#define lwesp_trace_get_name                        LWESP_PREFIX_NAME(lwesp_trace_get_name)
+#define lwesp_trace_read                            LWESP_PREFIX_NAME(lwesp_trace_read)
+#define lwesp_trace_write                           LWESP_PREFIX_NAME(lwesp_trace_write)
+#define lwesp_u32_to_dec_str                        LWESP_PREFIX_NAME(lwesp_u32_to_dec_str)
+#define lwesp_u32_to_gen_str                        LWESP_PREFIX_NAME(lwesp_u32_to_gen_str)
+#define lwesp_update_sw                             LWESP_PREFIX_NAME(lwesp_update_sw)
+#define lwesp_wait_for                              LWESP_PREFIX_NAME(lwesp_wait_for)
+#define lwesp_wps_set_config                        LWESP_PREFIX_NAME(lwesp_wps_set_config)
+#define lwespi_ap_sta_table_remove                  LWESP_PREFIX_NAME(lwespi_ap_sta_table_remove)
+#define lwespi_ap_sta_table_set                     LWESP_PREFIX_NAME(lwespi_ap_sta_table_set)
+#define lwespi_ap_sta_table_sync_done               LWESP_PREFIX_NAME(lwespi_ap_sta_table_sync_done)
+#define lwespi_ap_sta_table_sync_start              LWESP_PREFIX_NAME(lwespi_ap_sta_table_sync_start)
+#define lwespi_capture_write                        LWESP_PREFIX_NAME(lwespi_capture_write)
+#define lwespi_check_msg_start                      LWESP_PREFIX_NAME(lwespi_check_msg_start)
+#define lwespi_cmd_sf_release                       LWESP_PREFIX_NAME(lwespi_cmd_sf_release)
+#define lwespi_conn_buff_alloc                      LWESP_PREFIX_NAME(lwespi_conn_buff_alloc)
+#define lwespi_conn_buff_free                       LWESP_PREFIX_NAME(lwespi_conn_buff_free)
+#define lwespi_conn_check_available_rx_data         LWESP_PREFIX_NAME(lwespi_conn_check_available_rx_data)
+#define lwespi_conn_evt_work_free                   LWESP_PREFIX_NAME(lwespi_conn_evt_work_free)
+#define lwespi_conn_get_val_id                      LWESP_PREFIX_NAME(lwespi_conn_get_val_id)
+#define lwespi_conn_init                            LWESP_PREFIX_NAME(lwespi_conn_init)
+#define lwespi_conn_manual_tcp_auto_enter           LWESP_PREFIX_NAME(lwespi_conn_manual_tcp_auto_enter)
+#define lwespi_conn_manual_tcp_read_len             LWESP_PREFIX_NAME(lwespi_conn_manual_tcp_read_len)
+#define lwespi_conn_manual_tcp_try_read_data        LWESP_PREFIX_NAME(lwespi_conn_manual_tcp_try_read_data)
+#define lwespi_conn_sched_release                   LWESP_PREFIX_NAME(lwespi_conn_sched_release)
+#define lwespi_conn_sched_requeue                   LWESP_PREFIX_NAME(lwespi_conn_sched_requeue)
+#define lwespi_conn_sched_yield                     LWESP_PREFIX_NAME(lwespi_conn_sched_yield)
+#define lwespi_conn_send_coalesce                   LWESP_PREFIX_NAME(lwespi_conn_send_coalesce)
+#define lwespi_conn_send_coalesce_release           LWESP_PREFIX_NAME(lwespi_conn_send_coalesce_release)
+#define lwespi_conn_send_evt_aggr                   LWESP_PREFIX_NAME(lwespi_conn_send_evt_aggr)
+#define lwespi_conn_sendbuf_ack                     LWESP_PREFIX_NAME(lwespi_conn_sendbuf_ack)
+#define lwespi_conn_sendbuf_add                     LWESP_PREFIX_NAME(lwespi_conn_sendbuf_add)
+#define lwespi_conn_sendfile_release                LWESP_PREFIX_NAME(lwespi_conn_sendfile_release)
+#define lwespi_conn_start_next_cmd                  LWESP_PREFIX_NAME(lwespi_conn_start_next_cmd)
+#define lwespi_conn_start_timeout                   LWESP_PREFIX_NAME(lwespi_conn_start_timeout)
+#define lwespi_conn_tx_queue_release                LWESP_PREFIX_NAME(lwespi_conn_tx_queue_release)
+#define lwespi_dbg_msg_to_string                    LWESP_PREFIX_NAME(lwespi_dbg_msg_to_string)
+#define lwespi_dns_cache_get                        LWESP_PREFIX_NAME(lwespi_dns_cache_get)
+#define lwespi_dns_cache_put                        LWESP_PREFIX_NAME(lwespi_dns_cache_put)
+#define lwespi_dns_cache_remove                     LWESP_PREFIX_NAME(lwespi_dns_cache_remove)
+#define lwespi_dns_prefetch_next                    LWESP_PREFIX_NAME(lwespi_dns_prefetch_next)
+#define lwespi_evt_deferred_alloc                   LWESP_PREFIX_NAME(lwespi_evt_deferred_alloc)
+#define lwespi_evt_deferred_free                    LWESP_PREFIX_NAME(lwespi_evt_deferred_free)
+#define lwespi_get_from_mbox_with_timeout_checks    LWESP_PREFIX_NAME(lwespi_get_from_mbox_with_timeout_checks)
+#define lwespi_get_producer_msg                     LWESP_PREFIX_NAME(lwespi_get_producer_msg)
+#define lwespi_hostname_cache_set                   LWESP_PREFIX_NAME(lwespi_hostname_cache_set)
+#define lwespi_initiate_cmd                         LWESP_PREFIX_NAME(lwespi_initiate_cmd)
+#define lwespi_ip_mac_cache_get_ip                  LWESP_PREFIX_NAME(lwespi_ip_mac_cache_get_ip)
+#define lwespi_ip_mac_cache_get_mac                 LWESP_PREFIX_NAME(lwespi_ip_mac_cache_get_mac)
+#define lwespi_is_valid_conn_ptr                    LWESP_PREFIX_NAME(lwespi_is_valid_conn_ptr)
+#define lwespi_msg_alloc                            LWESP_PREFIX_NAME(lwespi_msg_alloc)
+#define lwespi_msg_free                             LWESP_PREFIX_NAME(lwespi_msg_free)
+#define lwespi_parse_ap_conn_disconn_sta            LWESP_PREFIX_NAME(lwespi_parse_ap_conn_disconn_sta)
+#define lwespi_parse_ap_ip_sta                      LWESP_PREFIX_NAME(lwespi_parse_ap_ip_sta)
+#define lwespi_parse_at_sdk_version                 LWESP_PREFIX_NAME(lwespi_parse_at_sdk_version)
+#define lwespi_parse_cipbufstatus                   LWESP_PREFIX_NAME(lwespi_parse_cipbufstatus)
+#define lwespi_parse_cipdomain                      LWESP_PREFIX_NAME(lwespi_parse_cipdomain)
+#define lwespi_parse_ciprecvdata                    LWESP_PREFIX_NAME(lwespi_parse_ciprecvdata)
+#define lwespi_parse_ciprecvlen                     LWESP_PREFIX_NAME(lwespi_parse_ciprecvlen)
+#define lwespi_parse_cipsendbuf                     LWESP_PREFIX_NAME(lwespi_parse_cipsendbuf)
+#define lwespi_parse_cipsntptime                    LWESP_PREFIX_NAME(lwespi_parse_cipsntptime)
+#define lwespi_parse_cipstatus                      LWESP_PREFIX_NAME(lwespi_parse_cipstatus)
+#define lwespi_parse_cwdhcp                         LWESP_PREFIX_NAME(lwespi_parse_cwdhcp)
+#define lwespi_parse_cwjap                          LWESP_PREFIX_NAME(lwespi_parse_cwjap)
+#define lwespi_parse_cwlap                          LWESP_PREFIX_NAME(lwespi_parse_cwlap)
+#define lwespi_parse_cwlif                          LWESP_PREFIX_NAME(lwespi_parse_cwlif)
+#define lwespi_parse_cwsap                          LWESP_PREFIX_NAME(lwespi_parse_cwsap)
+#define lwespi_parse_get_resp_kw                    LWESP_PREFIX_NAME(lwespi_parse_get_resp_kw)
+#define lwespi_parse_hexnumber                      LWESP_PREFIX_NAME(lwespi_parse_hexnumber)
+#define lwespi_parse_hostname                       LWESP_PREFIX_NAME(lwespi_parse_hostname)
+#define lwespi_parse_ip                             LWESP_PREFIX_NAME(lwespi_parse_ip)
+#define lwespi_parse_ipd                            LWESP_PREFIX_NAME(lwespi_parse_ipd)
+#define lwespi_parse_link_conn                      LWESP_PREFIX_NAME(lwespi_parse_link_conn)
+#define lwespi_parse_mac                            LWESP_PREFIX_NAME(lwespi_parse_mac)
+#define lwespi_parse_number                         LWESP_PREFIX_NAME(lwespi_parse_number)
+#define lwespi_parse_ping_time                      LWESP_PREFIX_NAME(lwespi_parse_ping_time)
+#define lwespi_parse_port                           LWESP_PREFIX_NAME(lwespi_parse_port)
+#define lwespi_parse_send_ack                       LWESP_PREFIX_NAME(lwespi_parse_send_ack)
+#define lwespi_parse_string                         LWESP_PREFIX_NAME(lwespi_parse_string)
+#define lwespi_pbuf_get_static_ram_size             LWESP_PREFIX_NAME(lwespi_pbuf_get_static_ram_size)
+#define lwespi_pbuf_new_ref                         LWESP_PREFIX_NAME(lwespi_pbuf_new_ref)
+#define lwespi_process                              LWESP_PREFIX_NAME(lwespi_process)
+#define lwespi_process_buffer                       LWESP_PREFIX_NAME(lwespi_process_buffer)
+#define lwespi_process_buffer_ref_release           LWESP_PREFIX_NAME(lwespi_process_buffer_ref_release)
+#define lwespi_process_events_for_timeout_or_error  LWESP_PREFIX_NAME(lwespi_process_events_for_timeout_or_error)
+#define lwespi_process_resync                       LWESP_PREFIX_NAME(lwespi_process_resync)
+#define lwespi_reset_everything                     LWESP_PREFIX_NAME(lwespi_reset_everything)
+#define lwespi_send_batch_to_producer_mbox          LWESP_PREFIX_NAME(lwespi_send_batch_to_producer_mbox)
+#define lwespi_send_cb                              LWESP_PREFIX_NAME(lwespi_send_cb)
+#define lwespi_send_conn_cb                         LWESP_PREFIX_NAME(lwespi_send_conn_cb)
+#define lwespi_send_ip_mac                          LWESP_PREFIX_NAME(lwespi_send_ip_mac)
+#define lwespi_send_msg_to_producer_mbox            LWESP_PREFIX_NAME(lwespi_send_msg_to_producer_mbox)
+#define lwespi_send_number                          LWESP_PREFIX_NAME(lwespi_send_number)
+#define lwespi_send_port                            LWESP_PREFIX_NAME(lwespi_send_port)
+#define lwespi_send_signed_number                   LWESP_PREFIX_NAME(lwespi_send_signed_number)
+#define lwespi_send_string                          LWESP_PREFIX_NAME(lwespi_send_string)
+#define lwespi_sntp_clock_sync                      LWESP_PREFIX_NAME(lwespi_sntp_clock_sync)
+#define lwespi_stats_cmd_done                       LWESP_PREFIX_NAME(lwespi_stats_cmd_done)
+#define lwespi_stats_cmd_enqueue                    LWESP_PREFIX_NAME(lwespi_stats_cmd_enqueue)
+#define lwespi_stats_cmd_resp                       LWESP_PREFIX_NAME(lwespi_stats_cmd_resp)
+#define lwespi_stats_cmd_start                      LWESP_PREFIX_NAME(lwespi_stats_cmd_start)
+#define lwespi_stats_mbox_write                     LWESP_PREFIX_NAME(lwespi_stats_mbox_write)
+#define lwespi_stats_thread_mark                    LWESP_PREFIX_NAME(lwespi_stats_thread_mark)
+#define lwespi_timeout_process                      LWESP_PREFIX_NAME(lwespi_timeout_process)
+#define lwespi_unicode_decode                       LWESP_PREFIX_NAME(lwespi_unicode_decode)
+#define lwespi_unicode_get_run_len                  LWESP_PREFIX_NAME(lwespi_unicode_get_run_len)
+#define strcmpa                                     LWESP_PREFIX_NAME(strcmpa)
+
+#endif /* defined(LWESP_CFG_PREFIX) && !__DOXYGEN__ */
+
+#endif /* LWESP_HDR_PREFIX_H */
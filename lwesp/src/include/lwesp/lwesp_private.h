@@ -34,9 +34,13 @@
 #ifndef LWESP_HDR_PRIV_H
 #define LWESP_HDR_PRIV_H
 
+#include <stddef.h>
 #include "lwesp/lwesp.h"
 #include "lwesp/lwesp_typedefs.h"
 #include "lwesp/lwesp_debug.h"
+#if defined(_MSC_VER)
+#include <intrin.h>                             /* Interlocked functions for LWESP_CFG_ATOMIC_INC */
+#endif /* defined(_MSC_VER) */
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,6 +65,8 @@ typedef enum {
     LWESP_CMD_GSLP,                             /*!< Set ESP to sleep mode */
     LWESP_CMD_RESTORE,                          /*!< Restore ESP internal settings to default values */
     LWESP_CMD_UART,
+    LWESP_CMD_UART_AUTOBAUD,                    /*!< Negotiate highest stable AT port baudrate */
+    LWESP_CMD_AT,                               /*!< Test AT port communication */
     LWESP_CMD_SLEEP,
     LWESP_CMD_WAKEUPGPIO,
     LWESP_CMD_RFPOWER,
@@ -121,17 +127,31 @@ typedef enum {
     LWESP_CMD_TCPIP_CIPSTATUS,                  /*!< Get status of connections */
     LWESP_CMD_TCPIP_CIPSTART,                   /*!< Start client connection */
     LWESP_CMD_TCPIP_CIPSEND,                    /*!< Send network data */
+#if LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__
+    LWESP_CMD_TCPIP_CIPBUFSTATUS,               /*!< Get status of segments in device send buffer */
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__ */
     LWESP_CMD_TCPIP_CIPCLOSE,                   /*!< Close active connection */
     LWESP_CMD_TCPIP_CIPSSLSIZE,                 /*!< Set SSL buffer size for SSL connection */
     LWESP_CMD_TCPIP_CIPSSLCCONF,                /*!< Set the SSL configuration */
+    LWESP_CMD_TCPIP_CIPSSLCSNI,                 /*!< Set SSL server name indication for connection */
     LWESP_CMD_TCPIP_CIFSR,                      /*!< Get local IP */
     LWESP_CMD_TCPIP_CIPMUX,                     /*!< Set single or multiple connections */
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+    LWESP_CMD_TCPIP_CIPMUX_GET,                 /*!< Get single or multiple connections mode */
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
     LWESP_CMD_TCPIP_CIPSERVER,                  /*!< Enables/Disables server mode */
     LWESP_CMD_TCPIP_CIPSERVERMAXCONN,           /*!< Sets maximal number of connections allowed for server population */
     LWESP_CMD_TCPIP_CIPMODE,                    /*!< Transmission mode, either transparent or normal one */
+#if LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__
+    LWESP_CMD_TCPIP_CIPSEND_PASSTHROUGH,        /*!< Start sending data in passthrough mode */
+    LWESP_CMD_TCPIP_PASSTHROUGH_EXIT,           /*!< Exit passthrough mode with `+++` sequence */
+#endif /* LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__ */
     LWESP_CMD_TCPIP_CIPSTO,                     /*!< Sets connection timeout */
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE || __DOXYGEN__
     LWESP_CMD_TCPIP_CIPRECVMODE,                /*!< Sets mode for TCP data receive (manual or automatic) */
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+    LWESP_CMD_TCPIP_CIPRECVMODE_GET,            /*!< Gets mode for TCP data receive */
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
     LWESP_CMD_TCPIP_CIPRECVDATA,                /*!< Manually reads TCP data from device */
     LWESP_CMD_TCPIP_CIPRECVLEN,                 /*!< Gets number of available bytes in connection to be read */
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE || __DOXYGEN__ */
@@ -141,6 +161,9 @@ typedef enum {
     LWESP_CMD_TCPIP_CIPSNTPTIME,                /*!< Get current time using SNTP */
 #endif /* LWESP_SNT || __DOXYGEN__ */
     LWESP_CMD_TCPIP_CIPDINFO,                   /*!< Configure what data are received on +IPD statement */
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+    LWESP_CMD_TCPIP_CIPDINFO_GET,               /*!< Get what data are received on +IPD statement */
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
 #if LWESP_CFG_PING || __DOXYGEN__
     LWESP_CMD_TCPIP_PING,                       /*!< Ping domain */
 #endif /* LWESP_CFG_PING || __DOXYGEN__ */
@@ -153,6 +176,8 @@ typedef enum {
 #if LWESP_CFG_ESP32 || __DOXYGEN__
     LWESP_CMD_BLEINIT_GET,                      /*!< Get BLE status */
 #endif /* LWESP_CFG_ESP32 || __DOXYGEN__ */
+
+    LWESP_CMD_END,                              /*!< Last command entry, number of commands */
 } lwesp_cmd_t;
 
 /**
@@ -167,16 +192,46 @@ typedef struct lwesp_conn {
     lwesp_evt_fn    evt_func;                   /*!< Callback function for connection */
     void*           arg;                        /*!< User custom argument */
 
-    uint8_t         val_id;                     /*!< Validation ID number. It is increased each time
+    uint32_t        val_id;                     /*!< Validation ID (generation) number. It is increased each time
                                                         a new connection is established.
                                                         It protects sending data to wrong connection
                                                         in case we have data in send queue,
                                                         and connection was closed and active
-                                                        again in between. */
+                                                        again in between. See \ref lwesp_conn_handle_t */
 
     lwesp_linbuff_t buff;                       /*!< Linear buffer structure */
 
     size_t          total_recved;               /*!< Total number of bytes received */
+#if LWESP_CFG_CONN_IPD_INFO_CACHE || __DOXYGEN__
+    struct {
+        char        str[24];                    /*!< Remote IP and port part of last `+IPD` header, as `"ip",port` */
+        uint8_t     len;                        /*!< Length of string, `0` when cache is empty */
+        lwesp_ip_t  ip;                         /*!< Remote IP parsed from string */
+        lwesp_port_t port;                      /*!< Remote port parsed from string */
+    } ipd_info;                                 /*!< Cache of remote information in `+IPD` header */
+#endif /* LWESP_CFG_CONN_IPD_INFO_CACHE || __DOXYGEN__ */
+#if LWESP_CFG_CONN_IPD_FILTER || __DOXYGEN__
+    lwesp_conn_ipd_filter_fn ipd_filter;        /*!< Filter of received data, `NULL` to accept everything */
+#endif /* LWESP_CFG_CONN_IPD_FILTER || __DOXYGEN__ */
+#if LWESP_CFG_CONN_RECV_COALESCE_LEN > 0 || __DOXYGEN__
+    lwesp_pbuf_p    rx_coalesce;                /*!< Received data chain, not yet delivered to application */
+    lwesp_timeout_id_t rx_coalesce_to;          /*!< Timeout to deliver received data chain */
+#endif /* LWESP_CFG_CONN_RECV_COALESCE_LEN > 0 || __DOXYGEN__ */
+#if LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 || __DOXYGEN__
+    uint32_t        write_flush_time;           /*!< Time after which partially filled write buffer is sent, `0` when disabled */
+    lwesp_timeout_id_t write_flush_to;          /*!< Timeout to send write buffer, `0` when not running */
+#endif /* LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 || __DOXYGEN__ */
+#if LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__
+    lwesp_stats_conn_t stats;                   /*!< Traffic statistics, reset together with connection */
+#endif /* LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__ */
+
+    uint32_t        poll_base;                  /*!< Base poll interval in units of milliseconds, `0` when poll is disabled */
+    uint32_t        poll_interval;              /*!< Last poll interval in units of milliseconds, grows when connection is idle.
+                                                        Set to `0` on data activity */
+    uint32_t        poll_next;                  /*!< Absolute time of next poll event in units of milliseconds */
+#if LWESP_CFG_CMD_PRIORITY || __DOXYGEN__
+    uint8_t         prio;                       /*!< Priority of connection commands, member of \ref lwesp_cmd_prio_t enumeration */
+#endif /* LWESP_CFG_CMD_PRIORITY || __DOXYGEN__ */
 
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE || __DOXYGEN__
     size_t          tcp_available_bytes;        /*!< Number of bytes in ESP ready to be read on connection.
@@ -186,7 +241,38 @@ typedef struct lwesp_conn {
                                                         This variable is increased everytime new packet is
                                                         read to be sent to application and decreased
                                                         when application acknowledges it */
+    size_t          tcp_recv_window;            /*!< Maximal number of not acknowledged bytes application accepts */
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE || __DOXYGEN__ */
+#if LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__
+    size_t          tx_queued;                  /*!< Number of bytes accepted by send functions and not yet reported as sent */
+    size_t          tx_wm_high;                 /*!< High watermark of send queue. Set to `0` to disable watermark events */
+    size_t          tx_wm_low;                  /*!< Low watermark of send queue */
+#endif /* LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SEND_EVT_AGGR || __DOXYGEN__
+    size_t          send_evt_batch;             /*!< Number of sent bytes reported with single send event, `0` to report every send */
+    size_t          send_evt_acc;               /*!< Number of sent bytes not yet reported to application */
+#endif /* LWESP_CFG_CONN_SEND_EVT_AGGR || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__
+    struct {
+        uint32_t    id[LWESP_CFG_CONN_SEND_BUFFERED_SEGMENTS];  /*!< IDs of segments in device send buffer, not yet acknowledged */
+        size_t      len[LWESP_CFG_CONN_SEND_BUFFERED_SEGMENTS]; /*!< Length of each segment in units of bytes */
+        uint8_t     r;                          /*!< Index of oldest segment */
+        uint8_t     cnt;                        /*!< Number of segments waiting for acknowledge */
+    } sendbuf;                                  /*!< Segments queued with `AT+CIPSENDBUF` */
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SENDFILE || __DOXYGEN__
+    struct {
+        lwesp_conn_read_fn read_fn;             /*!< Data source read function, `NULL` when no transfer is active */
+        void*       arg;                        /*!< Custom argument for read function */
+        size_t      offset;                     /*!< Offset of next data to read */
+        size_t      rem;                        /*!< Remaining bytes to read */
+        uint8_t     in_flight;                  /*!< Number of send messages in queue */
+        uint8_t     busy;                       /*!< Set to `1` while buffers are being read and queued */
+        lwespr_t    res;                        /*!< Transfer result, first error stops reading */
+        lwesp_api_cmd_evt_fn evt_fn;            /*!< Transfer finished callback function */
+        void*       evt_arg;                    /*!< Custom argument for callback function */
+    } sendfile;                                 /*!< Transfer started with \ref lwesp_conn_sendfile */
+#endif /* LWESP_CFG_CONN_SENDFILE || __DOXYGEN__ */
 
     union {
         struct {
@@ -198,8 +284,10 @@ typedef struct lwesp_conn {
                                                     received data from function */
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE || __DOXYGEN__
             uint8_t receive_blocked: 1;         /*!< Status whether we should block manual receive for some time */
-            uint8_t receive_is_command_queued: 1;   /*!< Status whether manual read command is in the queue already */
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE || __DOXYGEN__ */
+#if LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__
+            uint8_t tx_wm_is_high: 1;           /*!< Status whether send queue reached high watermark and low one was not reached yet */
+#endif /* LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__ */
         } f;                                    /*!< Connection flags */
     } status;                                   /*!< Connection status union with flag bits */
 } lwesp_conn_t;
@@ -214,8 +302,12 @@ typedef struct lwesp_pbuf {
     size_t len;                                 /*!< Length of payload */
     size_t ref;                                 /*!< Number of references to this structure */
     uint8_t* payload;                           /*!< Pointer to payload memory */
+    struct lwesp_pbuf* parent;                  /*!< Pbuf owning payload memory when this one is a slice, `NULL` otherwise */
     lwesp_ip_t ip;                              /*!< Remote address for received IPD data */
     lwesp_port_t port;                          /*!< Remote port for received IPD data */
+#if LWESP_CFG_IPD_ZERO_COPY || __DOXYGEN__
+    uint8_t is_ref;                             /*!< Set to `1` when payload references input buffer memory */
+#endif /* LWESP_CFG_IPD_ZERO_COPY || __DOXYGEN__ */
 } lwesp_pbuf_t;
 
 /**
@@ -226,6 +318,9 @@ typedef struct {
                                                         data as connection data */
     size_t              tot_len;                /*!< Total length of packet */
     size_t              rem_len;                /*!< Remaining bytes to read in current +IPD statement */
+#if LWESP_CFG_CONN_IPD_FILTER || __DOXYGEN__
+    size_t              accept;                 /*!< Number of bytes from packet start to deliver, rest is skipped */
+#endif /* LWESP_CFG_CONN_IPD_FILTER || __DOXYGEN__ */
     lwesp_conn_p        conn;                   /*!< Pointer to connection for network data */
     lwesp_ip_t          ip;                     /*!< Remote IP address on from IPD data */
     lwesp_port_t        port;                   /*!< Remote port on IPD data */
@@ -234,8 +329,48 @@ typedef struct {
                                                         When set to `NULL` while `read = 1`,
                                                         reading should ignore incoming data */
     lwesp_pbuf_p        buff;                   /*!< Pointer to data buffer used for receiving data */
+#if LWESP_CFG_IPD_ZERO_COPY || __DOXYGEN__
+    uint8_t             zero_copy;              /*!< Set to `1` when `buff` references input buffer memory directly */
+#endif /* LWESP_CFG_IPD_ZERO_COPY || __DOXYGEN__ */
 } lwesp_ipd_t;
 
+/**
+ * \brief           State of direct `+IPD` payload write, \ref LWESP_CFG_IPD_DIRECT
+ */
+typedef enum {
+    LWESP_IPD_DIRECT_IDLE = 0x00,               /*!< No target is set */
+    LWESP_IPD_DIRECT_ARMED,                     /*!< Target set by processing thread, input context did not see it yet */
+    LWESP_IPD_DIRECT_ACTIVE,                    /*!< Input context writes payload to target */
+    LWESP_IPD_DIRECT_DONE,                      /*!< Target is filled, processing thread must take it over */
+    LWESP_IPD_DIRECT_REJECTED,                  /*!< New data were written to input buffer before target was seen */
+} lwesp_ipd_direct_state_t;
+
+/**
+ * \brief           Number of 32-bit words in connection bitmap
+ */
+#define LWESPI_CONN_BITMAP_LEN              ((LWESP_CFG_MAX_CONNS + 31) / 32)
+
+/**
+ * \brief           Number of low bits of \ref lwesp_conn_handle_t with connection number
+ */
+#define LWESPI_CONN_HANDLE_NUM_BITS         8
+
+/**
+ * \brief           Mask of connection generation (validation ID) kept in \ref lwesp_conn_handle_t
+ */
+#define LWESPI_CONN_GEN_MASK                (0xFFFFFFFFUL >> LWESPI_CONN_HANDLE_NUM_BITS)
+
+/**
+ * \brief           Get next connection generation, `0` is never used to keep handle `0` invalid
+ * \param[in]       g: Current generation
+ */
+#define LWESPI_CONN_GEN_NEXT(g)             ((((g) + 1) & LWESPI_CONN_GEN_MASK) != 0 ? (((g) + 1) & LWESPI_CONN_GEN_MASK) : 1)
+
+/**
+ * \brief           Link ID to close all connections with single `AT+CIPCLOSE` command
+ */
+#define LWESPI_CONN_CLOSE_ALL_ID            (LWESP_CFG_MAX_CONNS > 5 ? LWESP_CFG_MAX_CONNS : 5)
+
 /**
  * \brief           Message queue structure to share between threads
  */
@@ -245,11 +380,39 @@ typedef struct lwesp_msg {
                                                         subcommands, sub command is used here */
     uint8_t           i;                        /*!< Variable to indicate order number of subcommands */
     lwesp_sys_sem_t   sem;                      /*!< Semaphore for the message */
+#if LWESP_CFG_SYS_THREAD_NOTIFY || __DOXYGEN__
+    lwesp_sys_thread_notify_t notify;           /*!< Notification handle of thread waiting for blocking command */
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY || __DOXYGEN__ */
+#if LWESP_CFG_STATS || __DOXYGEN__
+    uint32_t          stats_enqueue;            /*!< Time when message was written to producer queue */
+    uint32_t          stats_start;              /*!< Time when current command was sent to device */
+    uint32_t          stats_resp;               /*!< Time when first response byte was received for current command */
+    uint8_t           stats_flags;              /*!< Statistics flags of message */
+#endif /* LWESP_CFG_STATS || __DOXYGEN__ */
+#if LWESP_CFG_POLL || __DOXYGEN__
+    volatile uint8_t  poll_done;                /*!< Set to `1` when blocking command finished in poll mode */
+#endif /* LWESP_CFG_POLL || __DOXYGEN__ */
     uint8_t           is_blocking;              /*!< Status if command is blocking */
     uint32_t          block_time;               /*!< Maximal blocking time in units of milliseconds.
                                                         Use `0` to for non-blocking call */
     lwespr_t          res;                      /*!< Result of message operation */
     lwespr_t          (*fn)(struct lwesp_msg*); /*!< Processing callback function to process packet */
+    struct lwesp_msg* batch_next;               /*!< Next command in the same batch */
+#if LWESP_CFG_CMD_CANCEL || __DOXYGEN__
+    uint32_t          cmd_id;                   /*!< Identifier of batch command belongs to. `0` when not used */
+    uint32_t          deadline;                 /*!< Absolute time command must be started before. `0` when not used */
+#endif /* LWESP_CFG_CMD_CANCEL || __DOXYGEN__ */
+#if LWESP_CFG_CMD_PRIORITY || __DOXYGEN__
+    uint8_t           prio;                     /*!< Command priority, member of \ref lwesp_cmd_prio_t enumeration */
+    struct lwesp_msg* prio_next;                /*!< Next message in the same priority lane */
+#endif /* LWESP_CFG_CMD_PRIORITY || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SEND_FAIR || __DOXYGEN__
+    uint8_t           sched;                    /*!< Set to `1` when message holds turn of its connection in fair scheduler */
+#endif /* LWESP_CFG_CONN_SEND_FAIR || __DOXYGEN__ */
+#if LWESP_CFG_CMD_SINGLE_FLIGHT || __DOXYGEN__
+    struct lwesp_msg* sf_next;                  /*!< Next running query in list or next waiter of the same query */
+    struct lwesp_msg* sf_waiters;               /*!< Merged queries waiting for result of this one */
+#endif /* LWESP_CFG_CMD_SINGLE_FLIGHT || __DOXYGEN__ */
 
 #if LWESP_CFG_USE_API_FUNC_EVT
     lwesp_api_cmd_evt_fn evt_fn;                /*!< Command callback API function */
@@ -259,9 +422,22 @@ typedef struct lwesp_msg {
     union {
         struct {
             uint32_t delay;                     /*!< Delay in units of milliseconds before executing first RESET command */
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+            uint8_t warm;                       /*!< Warm init state. `1` when cached state is to be verified,
+                                                        `2` when it matches and configuration is skipped */
+            uint8_t warm_match;                 /*!< Bit mask of configuration found as expected on device */
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
+#if LWESP_CFG_RESET_RECOVERY || __DOXYGEN__
+            uint8_t recover;                    /*!< Set to `1` when recovering from unexpected device reset */
+#endif /* LWESP_CFG_RESET_RECOVERY || __DOXYGEN__ */
         } reset;                                /*!< Reset device */
         struct {
             uint32_t baudrate;                  /*!< Baudrate for AT port */
+            uint32_t baudrate_prev;             /*!< Last verified baudrate, used as fallback on autobaud */
+            uint8_t idx;                        /*!< Index of next autobaud candidate baudrate */
+            uint8_t final;                      /*!< Set to `1` when last autobaud verification is in progress */
+            uint8_t fallback;                   /*!< Set to `1` while device returns to last verified baudrate */
+            lwesp_timeout_id_t verify_id;       /*!< Autobaud verification timeout */
         } uart;                                 /*!< UART configuration */
         struct {
             lwesp_mode_t mode;                  /*!< Mode of operation */
@@ -273,6 +449,10 @@ typedef struct lwesp_msg {
             const char* pass;                   /*!< AP password */
             const lwesp_mac_t* mac;             /*!< Specific MAC address to use when connecting to AP */
             uint8_t error_num;                  /*!< Error number on connecting */
+#if LWESP_CFG_STA_FAST_JOIN || __DOXYGEN__
+            uint8_t fast;                       /*!< Set to `1` when join targets cached access point */
+            uint8_t full_scan;                  /*!< Set to `1` when fast join failed and full scan is used */
+#endif /* LWESP_CFG_STA_FAST_JOIN || __DOXYGEN__ */
         } sta_join;                             /*!< Message for joining to access point */
         struct {
             uint16_t interval;                  /*!< Interval in units of seconds */
@@ -291,6 +471,12 @@ typedef struct lwesp_msg {
             size_t apsi;                        /*!< Current access point array */
             size_t* apf;                        /*!< Pointer to output variable holding
                                                         number of access points found */
+            lwesp_sta_list_ap_fn ap_fn;         /*!< Function called for every access point found.
+                                                        When set, entries are not saved to array */
+            void* ap_fn_arg;                    /*!< Custom argument for access point function */
+            uint8_t fields;                     /*!< Bit mask of \ref LWESP_STA_AP_FIELD reported by device */
+            uint8_t stop;                       /*!< Set to `1` when application stopped the scan */
+            uint8_t err;                        /*!< Set to `1` when scan command failed */
         } ap_list;                              /*!< List for available access points to connect to */
 #endif /* LWESP_CFG_MODE_STATION || __DOXYGEN__ */
 #if LWESP_CFG_MODE_ACCESS_POINT || __DOXYGEN__
@@ -355,20 +541,42 @@ typedef struct lwesp_msg {
             uint16_t tcp_ssl_keep_alive;        /*!< Keep alive parameter for TCP */
             uint8_t udp_mode;                   /*!< UDP mode */
             lwesp_port_t udp_local_port;        /*!< UDP local port */
+            uint16_t ssl_buff_size;             /*!< SSL buffer size to set before connecting, `0` when not used */
+            uint8_t ssl_cfg;                    /*!< Set to `1` to configure SSL authentication for link before connecting */
+            uint8_t ssl_auth_mode;              /*!< SSL authentication mode */
+            uint8_t ssl_pki_number;             /*!< Index of certificate and private key */
+            uint8_t ssl_ca_number;              /*!< Index of CA */
+            const char* ssl_sni;                /*!< SSL server name indication, `NULL` when not used */
             void* arg;                          /*!< Connection custom argument */
             lwesp_evt_fn evt_func;              /*!< Callback function to use on connection */
+            uint32_t poll_interval;             /*!< Base poll interval of connection, `0` when poll is disabled */
             uint8_t num;                        /*!< Connection number used for start */
             uint8_t success;                    /*!< Status if connection AT+CIPSTART succedded */
+#if LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__
+            uint8_t dns_cached;                 /*!< Set to `1` when cached address was used instead of host name */
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__ */
+#if LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__
+            uint8_t passthrough;                /*!< Status if connection is started in passthrough mode */
+#endif /* LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__ */
         } conn_start;                           /*!< Structure for starting new connection */
         struct {
-            lwesp_conn_t* conn;                 /*!< Pointer to connection to close */
-            uint8_t val_id;                     /*!< Connection current validation ID when command was sent to queue */
+            lwesp_conn_t* conn;                 /*!< Pointer to connection to close.
+                                                    Set to `NULL` to close all connections from `conns` bitmap */
+            uint32_t val_id;                    /*!< Connection current validation ID when command was sent to queue */
+            uint32_t conns[LWESPI_CONN_BITMAP_LEN]; /*!< Bitmap of connections to close when `conn` is `NULL` */
+            uint32_t val_ids[LWESP_CFG_MAX_CONNS];  /*!< Validation IDs of connections in `conns` bitmap */
+            uint8_t num;                        /*!< Link ID of current `AT+CIPCLOSE` command when `conn` is `NULL`.
+                                                    Set to \ref LWESPI_CONN_CLOSE_ALL_ID when closing all at once */
+            uint8_t failed;                     /*!< Set to `1` when closing of any connection from bitmap failed */
         } conn_close;                           /*!< Close connection */
         struct {
             lwesp_conn_t* conn;                 /*!< Pointer to connection to send data */
             size_t btw;                         /*!< Number of remaining bytes to write */
             size_t ptr;                         /*!< Current write pointer for data */
             const uint8_t* data;                /*!< Data to send */
+            lwesp_pbuf_p pbuf;                  /*!< Packet buffer chain to send, used instead of `data` when set */
+            const lwesp_conn_iov_t* iov;        /*!< Array of segments to send, used instead of `data` when set */
+            size_t iov_cnt;                     /*!< Number of entries in `iov` array */
             size_t sent;                        /*!< Number of bytes sent in last packet */
             size_t sent_all;                    /*!< Number of bytes sent all together */
             uint8_t tries;                      /*!< Number of tries used for last packet */
@@ -377,19 +585,42 @@ typedef struct lwesp_msg {
             lwesp_port_t remote_port;           /*!< Remote port address for UDP connection */
             uint8_t fau;                        /*!< Free after use flag to free memory after data are sent (or not) */
             size_t* bw;                         /*!< Number of bytes written so far */
-            uint8_t val_id;                     /*!< Connection current validation ID when command was sent to queue */
+            uint32_t val_id;                    /*!< Connection current validation ID when command was sent to queue */
+#if LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__
+            size_t queued;                      /*!< Number of bytes added to connection send queue by this message,
+                                                        `0` once they were removed from it */
+#endif /* LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SEND_COALESCE || __DOXYGEN__
+            struct lwesp_msg* next;             /*!< Next send message, merged to this one */
+#endif /* LWESP_CFG_CONN_SEND_COALESCE || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__
+            uint8_t buffered;                   /*!< Set to `1` when last packet is sent with `AT+CIPSENDBUF` */
+            uint32_t seg_id;                    /*!< Segment ID of last packet, reported by device */
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SENDFILE || __DOXYGEN__
+            uint8_t sendfile;                   /*!< Set to `1` when message is part of \ref lwesp_conn_sendfile transfer,
+                                                        `0` once it was released from transfer */
+#endif /* LWESP_CFG_CONN_SENDFILE || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SEND_FAIR || __DOXYGEN__
+            uint8_t yield;                      /*!< Set to `1` when command stopped between chunks to let other commands run */
+#endif /* LWESP_CFG_CONN_SEND_FAIR || __DOXYGEN__ */
         } conn_send;                            /*!< Structure to send data on connection */
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
         struct {
-            lwesp_conn_t* conn;                 /*!< Connection handle */
+            lwesp_conn_t* conn;                 /*!< Connection handle of current read */
             size_t len;                         /*!< Number of bytes to read */
             lwesp_pbuf_p buff;                  /*!< Buffer handle */
+            size_t idx;                         /*!< Index of connection currently served */
+            size_t rem;                         /*!< Number of bytes reported by `+CIPRECVLEN` still to read on current connection */
             uint8_t ipd_recv;                   /*!< Status indicating `+IPD` has been received during `AT+CIPRECVLEN` command.
                                                         When this happens, we need to repeat same command */
-            uint8_t is_last_check;              /*!< Status indicating check for data length is at the end of command.
-                                                        Do nothing after successful command */
-        } ciprecvdata;                          /*!< Structure to manually read TCP data */
+        } ciprecvdata;                          /*!< Structure to manually read TCP data of all connections */
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+        struct {
+            uint8_t manual;                     /*!< Set to `1` for manual receive mode, `0` for automatic mode */
+        } ciprecvmode;                          /*!< Structure to switch TCP receive mode at runtime */
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
 
         /* TCP/IP based commands */
         struct {
@@ -406,6 +637,13 @@ typedef struct lwesp_msg {
         struct {
             const char* host;                   /*!< Hostname to resolve IP address for */
             lwesp_ip_t* ip;                     /*!< Pointer to IP address to save result */
+#if LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__
+            const char* const* hosts;           /*!< List of host names to prefetch. Set to `NULL` for single query */
+            size_t hosts_len;                   /*!< Number of entries in `hosts` list */
+            size_t hosts_idx;                   /*!< Index of next host name in list to check */
+            lwesp_ip_t ip_tmp;                  /*!< Address of host name being prefetched */
+            uint8_t err;                        /*!< Set to `1` when any of host names failed to resolve */
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__ */
         } dns_getbyhostname;                    /*!< DNS function */
         struct {
             uint8_t en;                         /*!< Enable/Disable status */
@@ -470,6 +708,10 @@ typedef struct {
     uint8_t dhcp;                               /*!< Flag indicating DHCP is enabled */
     uint8_t has_ip;                             /*!< Flag indicating ESP has IP */
     uint8_t is_connected;                       /*!< Flag indicating ESP is connected to wifi */
+#if LWESP_CFG_IP_MAC_CACHE || __DOXYGEN__
+    uint8_t ip_valid;                           /*!< Flag indicating IP, gateway and netmask match device */
+    uint8_t mac_valid;                          /*!< Flag indicating MAC address matches device */
+#endif /* LWESP_CFG_IP_MAC_CACHE || __DOXYGEN__ */
 } lwesp_ip_mac_t;
 
 /**
@@ -491,8 +733,101 @@ typedef struct {
 typedef struct lwesp_evt_func {
     struct lwesp_evt_func* next;                /*!< Next function in the list */
     lwesp_evt_fn fn;                            /*!< Function pointer itself */
+    uint32_t mask;                              /*!< Mask of event types function is subscribed to */
+#if LWESP_CFG_EVT_DEFERRED || __DOXYGEN__
+    uint8_t deferred;                           /*!< Flag indicating function is called from deferred queue */
+#endif /* LWESP_CFG_EVT_DEFERRED || __DOXYGEN__ */
 } lwesp_evt_func_t;
 
+/**
+ * \brief           Thread waiting for stack state, see \ref lwesp_wait_for
+ */
+typedef struct lwesp_state_waiter {
+    struct lwesp_state_waiter* next;            /*!< Next waiter in the list */
+    uint32_t flags;                             /*!< State flags thread waits for, all must be set */
+    lwesp_sys_sem_t sem;                        /*!< Semaphore released when state is reached */
+} lwesp_state_waiter_t;
+
+#if LWESP_CFG_EVT_DEFERRED || __DOXYGEN__
+/**
+ * \brief           Deferred event queue entry
+ */
+typedef struct {
+    lwesp_evt_fn fn;                            /*!< Function to call */
+    lwesp_evt_t evt;                            /*!< Copy of event */
+} lwesp_evt_deferred_t;
+#endif /* LWESP_CFG_EVT_DEFERRED || __DOXYGEN__ */
+
+#if LWESP_CFG_CONN_EVT_WORKERS > 0 || __DOXYGEN__
+/**
+ * \brief           Connection event queued to worker thread
+ */
+typedef struct {
+    lwesp_evt_fn fn;                            /*!< Connection callback function at the time of event */
+    lwesp_evt_t evt;                            /*!< Copy of event */
+} lwesp_conn_evt_work_t;
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > 0 || __DOXYGEN__ */
+
+#if LWESP_CFG_STATS_THREAD || __DOXYGEN__
+/**
+ * \brief           Mailbox statistics counters
+ *
+ * Counters only increase, current depth is `writes - fails - reads`
+ */
+typedef struct {
+    volatile uint32_t writes;                   /*!< Number of write attempts, incremented before write from any context */
+    volatile uint32_t fails;                    /*!< Number of failed writes, incremented from any context */
+    uint32_t reads;                             /*!< Number of entries read, written by single consumer only */
+    volatile uint32_t depth_max;                /*!< Maximal depth */
+    uint32_t writes_reset;                      /*!< Successful writes at last statistics reset */
+    uint32_t fails_reset;                       /*!< Failed writes at last statistics reset */
+} lwesp_stats_mbox_cnt_t;
+#endif /* LWESP_CFG_STATS_THREAD || __DOXYGEN__ */
+
+#if LWESP_CFG_CONN_SEND_FAIR || __DOXYGEN__
+/**
+ * \brief           Fair scheduler state of single connection
+ *
+ * Kept outside connection structure as it must survive connection reset
+ */
+typedef struct {
+    lwesp_msg_t*          first;                /*!< First command waiting behind the one in priority lane */
+    lwesp_msg_t*          last;                 /*!< Last waiting command */
+    size_t                deficit;              /*!< Number of bytes connection may still send in current turn */
+    uint8_t               busy;                 /*!< Set to `1` when command of connection is in lane or running */
+    uint8_t               cont;                 /*!< Set to `1` when next command continues current turn */
+} lwespi_conn_sched_t;
+#endif /* LWESP_CFG_CONN_SEND_FAIR || __DOXYGEN__ */
+
+#if LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__
+/**
+ * \brief           Host-side DNS cache entry
+ */
+typedef struct {
+    char                  host[LWESP_CFG_DNS_CACHE_HOST_LEN];   /*!< Host name. Empty string when entry is not used */
+    lwesp_ip_t            ip;                   /*!< Resolved IP address */
+    uint32_t              time;                 /*!< Time when address was resolved */
+    uint32_t              used;                 /*!< Time of last use, for least recently used replacement */
+} lwespi_dns_cache_entry_t;
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__ */
+
+#if LWESP_CFG_SNTP_CLOCK || __DOXYGEN__
+/**
+ * \brief           Local clock synchronized from SNTP
+ */
+typedef struct {
+    uint64_t              base_ms;              /*!< Milliseconds since `1970-01-01` at last synchronization */
+    uint32_t              base_time;            /*!< Value of \ref lwesp_sys_now at last synchronization */
+    int32_t               drift_ppm;            /*!< Estimated drift of local time base. Positive when local clock runs slow */
+    uint32_t              drift_time;           /*!< Value of \ref lwesp_sys_now when corrections started to accumulate */
+    int32_t               drift_err;            /*!< Sum of corrections in units of milliseconds since `drift_time` */
+    uint32_t              interval;             /*!< Periodic synchronization interval, `0` when stopped */
+    lwesp_timeout_id_t    sync_id;              /*!< Timeout of next periodic synchronization */
+    lwesp_datetime_t      dt;                   /*!< Result buffer for periodic synchronization */
+    uint8_t               valid;                /*!< Set to `1` after first successful synchronization */
+} lwespi_sntp_clock_t;
+#endif /* LWESP_CFG_SNTP_CLOCK || __DOXYGEN__ */
+
 /**
  * \brief           ESP modules structure
  */
@@ -501,13 +836,26 @@ typedef struct {
 
     lwesp_sw_version_t    version_at;           /*!< Version of AT command software on ESP device */
     lwesp_sw_version_t    version_sdk;          /*!< Version of SDK used to build AT software */
+#if LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT > LWESP_CFG_CONN_MAX_DATA_LEN || __DOXYGEN__
+    size_t                conn_max_data_len;    /*!< Maximal number of bytes sent with single command, detected from firmware */
+#endif /* LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT > LWESP_CFG_CONN_MAX_DATA_LEN || __DOXYGEN__ */
 
-    uint32_t            active_conns;           /*!< Bit field of currently active connections, @todo: In case user has more than 32 connections, single variable is not enough */
-    uint32_t            active_conns_last;      /*!< The same as previous but status before last check */
+    uint32_t            active_conns[LWESPI_CONN_BITMAP_LEN];   /*!< Bitmap of currently active connections */
+    uint32_t            active_conns_last[LWESPI_CONN_BITMAP_LEN];  /*!< The same as previous but status before last check */
 
     lwesp_link_conn_t     link_conn;            /*!< Link connection handle */
+    uint8_t               link_conn_urc;        /*!< Status if device reports connection changes with `+LINK_CONN` */
+    uint8_t               conn_status_stale;    /*!< Status if local connection state may differ from device, refreshed with `AT+CIPSTATUS` */
+    uint16_t              ssl_buff_size;        /*!< Last SSL buffer size set with `AT+CIPSSLSIZE`, `0` when unknown */
     lwesp_ipd_t           ipd;                  /*!< Connection incoming data structure */
     lwesp_conn_t          conns[LWESP_CFG_MAX_CONNS];   /*!< Array of all connection structures */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO || __DOXYGEN__
+    uint8_t               tcp_recv_manual;      /*!< Status if device is currently in manual TCP receive mode */
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO || __DOXYGEN__ */
+#if LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__
+    uint8_t               passthrough;          /*!< Status if passthrough mode is active. All received data belong to first connection */
+    uint8_t               passthrough_exit;     /*!< Set to `1` while exit sequence is in progress and AT port must stay silent */
+#endif /* LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__ */
 
 #if LWESP_CFG_MODE_STATION || __DOXYGEN__
     lwesp_ip_mac_t        sta;                  /*!< Station IP and MAC addressed */
@@ -515,6 +863,15 @@ typedef struct {
 #if LWESP_CFG_MODE_ACCESS_POINT || __DOXYGEN__
     lwesp_ip_mac_t        ap;                   /*!< Access point IP and MAC addressed */
 #endif /* LWESP_CFG_MODE_ACCESS_POINT || __DOXYGEN__ */
+#if (LWESP_CFG_IP_MAC_CACHE && LWESP_CFG_HOSTNAME) || __DOXYGEN__
+    char                  hostname[LWESP_CFG_IP_MAC_CACHE_HOSTNAME_LEN];    /*!< Cached hostname */
+    uint8_t               hostname_valid;       /*!< Flag indicating cached hostname matches device */
+#endif /* (LWESP_CFG_IP_MAC_CACHE && LWESP_CFG_HOSTNAME) || __DOXYGEN__ */
+#if LWESP_CFG_AP_STA_TABLE > 0 || __DOXYGEN__
+    lwesp_sta_t           ap_stas[LWESP_CFG_AP_STA_TABLE];  /*!< Stations connected to access point, packed from the start */
+    uint8_t               ap_stas_seen[LWESP_CFG_AP_STA_TABLE]; /*!< Station was reported since start of last `AT+CWLIF` */
+    size_t                ap_stas_cnt;          /*!< Number of valid entries in station table */
+#endif /* LWESP_CFG_AP_STA_TABLE > 0 || __DOXYGEN__ */
 } lwesp_modules_t;
 
 /**
@@ -524,22 +881,109 @@ typedef struct {
     size_t              locked_cnt;             /*!< Counter how many times (recursive) stack is currently locked */
 
     lwesp_sys_sem_t       sem_sync;             /*!< Synchronization semaphore between threads */
+#if LWESP_CFG_POLL || __DOXYGEN__
+    uint8_t               cmd_sync;             /*!< Set to `1` when active command finished, replaces `sem_sync` in poll mode */
+    uint32_t              cmd_start_time;       /*!< Time when active command started in poll mode */
+#endif /* LWESP_CFG_POLL || __DOXYGEN__ */
     lwesp_sys_mbox_t      mbox_producer;        /*!< Producer message queue handle */
+#if LWESP_CFG_CMD_PRIORITY || __DOXYGEN__
+    lwesp_msg_t*          prio_first[LWESP_CMD_PRIO_END];   /*!< First message in each priority lane.
+                                                            Lanes are only accessed by producer thread */
+    lwesp_msg_t*          prio_last[LWESP_CMD_PRIO_END];    /*!< Last message in each priority lane */
+#endif /* LWESP_CFG_CMD_PRIORITY || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SEND_FAIR || __DOXYGEN__
+    lwespi_conn_sched_t   conn_sched[LWESP_CFG_MAX_CONNS];  /*!< Fair scheduler state per connection.
+                                                            Accessed together with priority lanes */
+#endif /* LWESP_CFG_CONN_SEND_FAIR || __DOXYGEN__ */
     lwesp_sys_mbox_t      mbox_process;         /*!< Consumer message queue handle */
     lwesp_sys_thread_t    thread_produce;       /*!< Producer thread handle */
     lwesp_sys_thread_t    thread_process;       /*!< Processing thread handle */
+#if LWESP_CFG_CONN_EVT_WORKERS > 0 || __DOXYGEN__
+    lwesp_sys_thread_t    thread_conn_evt[LWESP_CFG_CONN_EVT_WORKERS];  /*!< Connection event worker thread handles */
+    lwesp_sys_mbox_t      mbox_conn_evt[LWESP_CFG_CONN_EVT_WORKERS];    /*!< Connection event queue of each worker */
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > 0 || __DOXYGEN__ */
 #if !LWESP_CFG_INPUT_USE_PROCESS || __DOXYGEN__
     lwesp_buff_t          buff;                 /*!< Input processing buffer */
+    volatile uint8_t      input_wake_pending;   /*!< Set to `1` when process thread was notified
+                                                        and did not process input buffer yet */
+    size_t                input_wake_len;       /*!< Number of bytes written to input buffer since last notification */
+    volatile uint8_t      input_overflow;       /*!< Set to `1` by input context when data were lost,
+                                                        input is dropped until processing thread resynchronizes */
 #endif /* !LWESP_CFG_INPUT_USE_PROCESS || __DOXYGEN__ */
+#if LWESP_CFG_IPD_DIRECT || __DOXYGEN__
+    struct {
+        lwesp_pbuf_p      pbuf;                 /*!< Packet buffer of `+IPD` target belongs to */
+        uint8_t*          dst;                  /*!< Packet buffer memory to write payload to */
+        size_t            len;                  /*!< Number of payload bytes to write */
+        size_t            filled;               /*!< Number of bytes written by input context */
+        size_t            mark;                 /*!< Input buffer write pointer when target was armed */
+        volatile uint8_t  state;                /*!< Member of \ref lwesp_ipd_direct_state_t enumeration */
+    } ipd_direct;                               /*!< Direct write of `+IPD` payload from input context */
+#endif /* LWESP_CFG_IPD_DIRECT || __DOXYGEN__ */
+#if LWESP_CFG_IPD_ZERO_COPY || __DOXYGEN__
+    size_t                buff_proc_r;          /*!< Processing pointer of input buffer.
+                                                        Read pointer of buffer follows it when no data are referenced */
+    size_t                buff_ref_cnt;         /*!< Number of packet buffers referencing input buffer memory */
+#endif /* LWESP_CFG_IPD_ZERO_COPY || __DOXYGEN__ */
     lwesp_ll_t            ll;                   /*!< Low level functions */
+#if LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__
+    volatile uint32_t     stats_uart_rx;        /*!< Number of bytes received from AT port, written by input context only */
+    volatile uint32_t     stats_uart_rx_drop;   /*!< Number of received bytes lost on input buffer overflow, written by input context only */
+    volatile uint32_t     stats_uart_rx_overflows;  /*!< Number of input buffer overflows, written by input context only */
+    uint32_t              stats_recv_line_trunc;    /*!< Number of response lines truncated to receive line buffer */
+    uint32_t              stats_uart_tx;        /*!< Number of bytes sent to AT port, written with core locked */
+    lwesp_stats_conn_t    stats_conn;           /*!< Traffic totals of all connections */
+#endif /* LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__ */
+#if LWESP_CFG_STATS_THREAD || __DOXYGEN__
+    lwesp_stats_thread_t  stats_producer;       /*!< Producer thread utilization, written by producer thread only */
+    lwesp_stats_thread_t  stats_process;        /*!< Process thread utilization, written by process thread only */
+    uint32_t              stats_producer_mark;  /*!< Time of last producer thread state change */
+    uint32_t              stats_process_mark;   /*!< Time of last process thread state change */
+    lwesp_stats_mbox_cnt_t stats_mbox_producer; /*!< Producer mailbox counters */
+    lwesp_stats_mbox_cnt_t stats_mbox_process;  /*!< Process mailbox counters */
+#endif /* LWESP_CFG_STATS_THREAD || __DOXYGEN__ */
 
     lwesp_msg_t*          msg;                  /*!< Pointer to current user message being executed */
+#if LWESP_CFG_CMD_CANCEL || __DOXYGEN__
+    uint32_t              cmd_id_next;          /*!< Next batch identifier */
+    uint32_t              cmd_cancel[LWESP_CFG_CMD_CANCEL_SLOTS];   /*!< Identifiers of batches to cancel */
+    uint8_t               cmd_cancel_idx;       /*!< Next entry in `cmd_cancel` to write */
+#endif /* LWESP_CFG_CMD_CANCEL || __DOXYGEN__ */
+    lwesp_batch_t*        batch;                /*!< Batch being recorded. Messages are appended to it
+                                                        instead of being written to producer queue */
+#if LWESP_CFG_RUNTIME_PARAMS || __DOXYGEN__
+    uint32_t              params[LWESP_PARAM_END];  /*!< Performance parameters, set with \ref lwesp_set_param */
+#endif /* LWESP_CFG_RUNTIME_PARAMS || __DOXYGEN__ */
+#if LWESP_CFG_CMD_SINGLE_FLIGHT || __DOXYGEN__
+    lwesp_msg_t*          sf_msgs;              /*!< Queued or running queries, new identical queries wait for them */
+#endif /* LWESP_CFG_CMD_SINGLE_FLIGHT || __DOXYGEN__ */
 
     lwesp_evt_t           evt;                  /*!< Callback processing structure */
     lwesp_evt_func_t*     evt_func;             /*!< Callback function linked list */
+    lwesp_evt_func_t**    evt_dispatch;         /*!< Functions grouped per event type, built from `evt_func` list */
+    uint8_t               evt_dispatch_idx[LWESP_EVT_END + 1];  /*!< Start index in `evt_dispatch` for each event type */
+    uint8_t               evt_dispatch_dirty;   /*!< Flag indicating dispatch table must be rebuilt */
+    uint8_t               evt_dispatch_depth;   /*!< Nesting level of event dispatching in progress */
+#if LWESP_CFG_EVT_DEFERRED || __DOXYGEN__
+    lwesp_sys_mbox_t      mbox_evt_deferred;    /*!< Queue of events for deferred listeners */
+#endif /* LWESP_CFG_EVT_DEFERRED || __DOXYGEN__ */
     lwesp_evt_fn          evt_server;           /*!< Default callback function for server connections */
+    lwesp_state_waiter_t* state_waiters;        /*!< Threads waiting for stack state */
 
     lwesp_modules_t       m;                    /*!< All modules. When resetting, reset structure */
+#if LWESP_CFG_STA_FAST_JOIN || __DOXYGEN__
+    struct {
+        char              ssid[LWESP_CFG_MAX_SSID_LENGTH];  /*!< SSID of last joined access point */
+        lwesp_mac_t       bssid;                /*!< BSSID of last joined access point */
+        uint8_t           valid;                /*!< Set to `1` when cached information is valid */
+    } sta_fast_join;                            /*!< Cache of last joined access point, kept over device reset */
+#endif /* LWESP_CFG_STA_FAST_JOIN || __DOXYGEN__ */
+#if LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__
+    lwespi_dns_cache_entry_t dns_cache[LWESP_CFG_DNS_CACHE_SIZE];   /*!< Host-side DNS cache */
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__ */
+#if LWESP_CFG_SNTP_CLOCK || __DOXYGEN__
+    lwespi_sntp_clock_t   sntp_clock;           /*!< Local clock synchronized from SNTP, kept over device reset */
+#endif /* LWESP_CFG_SNTP_CLOCK || __DOXYGEN__ */
 
     union {
         struct {
@@ -580,25 +1024,49 @@ typedef struct {
 extern lwesp_t esp;
 
 #define LWESP_MSG_VAR_DEFINE(name)                lwesp_msg_t* name
-#define LWESP_MSG_VAR_ALLOC(name, blocking)       do {\
-        (name) = lwesp_mem_malloc(sizeof(*(name)));       \
-        LWESP_DEBUGW(LWESP_CFG_DBG_VAR | LWESP_DBG_TYPE_TRACE, (name) != NULL, "[MSG VAR] Allocated %d bytes at %p\r\n", sizeof(*(name)), (name)); \
-        LWESP_DEBUGW(LWESP_CFG_DBG_VAR | LWESP_DBG_TYPE_TRACE, (name) == NULL, "[MSG VAR] Error allocating %d bytes\r\n", sizeof(*(name))); \
+#define LWESP_MSG_SIZE(member)                    (offsetof(lwesp_msg_t, msg) + sizeof(((lwesp_msg_t *)0)->msg.member))
+#if LWESP_CFG_MSG_POOL_SIZE > 0 || LWESP_CFG_MSG_POOL_SMALL_SIZE > 0
+#define LWESP_MSG_VAR_ALLOC_SIZE(name, blocking, size)  do {\
+        (name) = lwespi_msg_alloc(size);                \
+        LWESP_DEBUGW(LWESP_CFG_DBG_VAR | LWESP_DBG_TYPE_TRACE, (name) == NULL, "[MSG VAR] Error allocating %d bytes\r\n", (int)(size)); \
         if ((name) == NULL) {                           \
             return lwespERRMEM;                           \
         }                                               \
-        LWESP_MEMSET((name), 0x00, sizeof(*(name)));      \
         (name)->is_blocking = LWESP_U8((blocking) > 0);   \
     } while (0)
-#define LWESP_MSG_VAR_REF(name)                   (*(name))
 #define LWESP_MSG_VAR_FREE(name)                  do {\
         LWESP_DEBUGF(LWESP_CFG_DBG_VAR | LWESP_DBG_TYPE_TRACE, "[MSG VAR] Free memory: %p\r\n", (name)); \
+        LWESPI_CONN_TX_QUEUE_RELEASE(name);             \
+        LWESPI_CONN_SENDFILE_RELEASE(name, lwespERR);   \
+        lwespi_msg_free(name);                          \
+        (name) = NULL;                                  \
+    } while (0)
+#else /* LWESP_CFG_MSG_POOL_SIZE > 0 || LWESP_CFG_MSG_POOL_SMALL_SIZE > 0 */
+#define LWESP_MSG_VAR_ALLOC_SIZE(name, blocking, size)  do {\
+        (name) = lwesp_mem_malloc_tag((size), LWESP_MEM_TAG_MSG);\
+        LWESP_DEBUGW(LWESP_CFG_DBG_VAR | LWESP_DBG_TYPE_TRACE, (name) != NULL, "[MSG VAR] Allocated %d bytes at %p\r\n", (int)(size), (name)); \
+        LWESP_DEBUGW(LWESP_CFG_DBG_VAR | LWESP_DBG_TYPE_TRACE, (name) == NULL, "[MSG VAR] Error allocating %d bytes\r\n", (int)(size)); \
+        if ((name) == NULL) {                           \
+            return lwespERRMEM;                           \
+        }                                               \
+        LWESP_MEMSET((name), 0x00, (size));               \
+        (name)->is_blocking = LWESP_U8((blocking) > 0);   \
+    } while (0)
+#define LWESP_MSG_VAR_FREE(name)                  do {\
+        LWESP_DEBUGF(LWESP_CFG_DBG_VAR | LWESP_DBG_TYPE_TRACE, "[MSG VAR] Free memory: %p\r\n", (name)); \
+        LWESPI_CONN_TX_QUEUE_RELEASE(name);             \
+        LWESPI_CONN_SENDFILE_RELEASE(name, lwespERR);   \
         if (lwesp_sys_sem_isvalid(&((name)->sem))) {      \
             lwesp_sys_sem_delete(&((name)->sem));         \
             lwesp_sys_sem_invalid(&((name)->sem));        \
         }                                               \
         lwesp_mem_free_s((void **)&(name));               \
     } while (0)
+#endif /* !(LWESP_CFG_MSG_POOL_SIZE > 0 || LWESP_CFG_MSG_POOL_SMALL_SIZE > 0) */
+#define LWESP_MSG_VAR_ALLOC(name, blocking)       LWESP_MSG_VAR_ALLOC_SIZE(name, blocking, sizeof(*(name)))
+/* Allocate message with payload of command `member` only, other union members must not be accessed */
+#define LWESP_MSG_VAR_ALLOC_CMD(name, blocking, member) LWESP_MSG_VAR_ALLOC_SIZE(name, blocking, LWESP_MSG_SIZE(member))
+#define LWESP_MSG_VAR_REF(name)                   (*(name))
 #if LWESP_CFG_USE_API_FUNC_EVT
 #define LWESP_MSG_VAR_SET_EVT(name, e_fn, e_arg)  do {\
         (name)->evt_fn = (e_fn);                        \
@@ -614,11 +1082,178 @@ extern lwesp_t esp;
 #define LWESP_CHARHEXTONUM(x)                 (((x) >= '0' && (x) <= '9') ? ((x) - '0') : (((x) >= 'a' && (x) <= 'f') ? ((x) - 'a' + 10) : (((x) >= 'A' && (x) <= 'F') ? ((x) - 'A' + 10) : 0)))
 #define LWESP_ISVALIDASCII(x)                 (((x) >= 32 && (x) <= 126) || (x) == '\r' || (x) == '\n')
 
+/* Performance parameter, set at runtime or fixed to compile time option */
+#if LWESP_CFG_RUNTIME_PARAMS
+#define LWESPI_PARAM(name)                  (esp.params[LWESP_PARAM_ ## name])
+#else /* LWESP_CFG_RUNTIME_PARAMS */
+#define LWESPI_PARAM(name)                  ((uint32_t)LWESP_CFG_ ## name)
+#endif /* !LWESP_CFG_RUNTIME_PARAMS */
+
+/* Maximal number of bytes sent with single command */
+#if LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT > LWESP_CFG_CONN_MAX_DATA_LEN
+#define LWESPI_CONN_MAX_DATA_LEN_FW()       (esp.m.conn_max_data_len)
+#else /* LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT > LWESP_CFG_CONN_MAX_DATA_LEN */
+#define LWESPI_CONN_MAX_DATA_LEN_FW()       ((size_t)LWESP_CFG_CONN_MAX_DATA_LEN)
+#endif /* !(LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT > LWESP_CFG_CONN_MAX_DATA_LEN) */
+#if LWESP_CFG_RUNTIME_PARAMS
+#define LWESPI_CONN_MAX_DATA_LEN()          LWESP_MIN(LWESPI_CONN_MAX_DATA_LEN_FW(), (size_t)LWESPI_PARAM(CONN_MAX_DATA_LEN))
+#else /* LWESP_CFG_RUNTIME_PARAMS */
+#define LWESPI_CONN_MAX_DATA_LEN()          LWESPI_CONN_MAX_DATA_LEN_FW()
+#endif /* !LWESP_CFG_RUNTIME_PARAMS */
+
+/* Connection bitmap manipulation */
+#define LWESPI_CONN_BIT_SET(bm, n)          ((bm)[(n) >> 5] |= (uint32_t)1 << ((n) & 0x1F))
+#define LWESPI_CONN_BIT_CLR(bm, n)          ((bm)[(n) >> 5] &= ~((uint32_t)1 << ((n) & 0x1F)))
+#define LWESPI_CONN_BIT_GET(bm, n)          (((bm)[(n) >> 5] >> ((n) & 0x1F)) & 0x01)
+
 #define CMD_IS_CUR(c)                       (esp.msg != NULL && esp.msg->cmd == (c))
 #define CMD_IS_DEF(c)                       (esp.msg != NULL && esp.msg->cmd_def == (c))
 #define CMD_GET_CUR()                       ((lwesp_cmd_t)(((esp.msg != NULL) ? esp.msg->cmd : LWESP_CMD_IDLE)))
 #define CMD_GET_DEF()                       ((lwesp_cmd_t)(((esp.msg != NULL) ? esp.msg->cmd_def : LWESP_CMD_IDLE)))
 
+/* Time base of statistics counters, in units of LWESP_STATS_TIME_UNIT */
+#if LWESP_CFG_SYS_NOW_US
+#define LWESPI_STATS_NOW()                  lwesp_sys_now_us()
+#else /* LWESP_CFG_SYS_NOW_US */
+#define LWESPI_STATS_NOW()                  lwesp_sys_now()
+#endif /* !LWESP_CFG_SYS_NOW_US */
+
+/* Command statistics hooks */
+#if LWESP_CFG_STATS
+#define LWESPI_STATS_CMD_ENQUEUE(msg)       lwespi_stats_cmd_enqueue(msg)
+#define LWESPI_STATS_CMD_START(msg)         lwespi_stats_cmd_start(msg)
+#define LWESPI_STATS_CMD_RESP(msg)          lwespi_stats_cmd_resp(msg)
+#define LWESPI_STATS_CMD_DONE(msg, res)     lwespi_stats_cmd_done((msg), (res))
+#else /* LWESP_CFG_STATS */
+#define LWESPI_STATS_CMD_ENQUEUE(msg)       do {} while (0)
+#define LWESPI_STATS_CMD_START(msg)         do {} while (0)
+#define LWESPI_STATS_CMD_RESP(msg)          do {} while (0)
+#define LWESPI_STATS_CMD_DONE(msg, res)     do {} while (0)
+#endif /* !LWESP_CFG_STATS */
+
+/* Traffic statistics hooks, counters are written with core locked except AT port RX */
+#if LWESP_CFG_STATS_TRAFFIC
+#define LWESPI_STATS_UART_RX(len)           (esp.stats_uart_rx += (uint32_t)(len))
+#define LWESPI_STATS_UART_RX_DROP(len)      (esp.stats_uart_rx_drop += (uint32_t)(len))
+#define LWESPI_STATS_UART_RX_OVERFLOW()     (++esp.stats_uart_rx_overflows)
+#define LWESPI_STATS_RECV_LINE_TRUNC()      (++esp.stats_recv_line_trunc)
+#define LWESPI_STATS_UART_TX(len)           (esp.stats_uart_tx += (uint32_t)(len))
+#define LWESPI_STATS_CONN_ADD(conn, field, val) do {        \
+        (conn)->stats.field += (uint32_t)(val);             \
+        esp.stats_conn.field += (uint32_t)(val);            \
+    } while (0)
+#else /* LWESP_CFG_STATS_TRAFFIC */
+#define LWESPI_STATS_UART_RX(len)           do {} while (0)
+#define LWESPI_STATS_UART_RX_DROP(len)      do {} while (0)
+#define LWESPI_STATS_UART_RX_OVERFLOW()     do {} while (0)
+#define LWESPI_STATS_RECV_LINE_TRUNC()      do {} while (0)
+#define LWESPI_STATS_UART_TX(len)           do {} while (0)
+#define LWESPI_STATS_CONN_ADD(conn, field, val) do {} while (0)
+#endif /* !LWESP_CFG_STATS_TRAFFIC */
+
+/*
+ * Thread and mailbox utilization hooks
+ *
+ * Thread time elapsed since previous mark is added to busy, idle or sync time.
+ * Mailbox write is counted before entry is written, to keep depth non-negative
+ */
+#if LWESP_CFG_STATS_THREAD
+#define LWESPI_STATS_THREAD_BUSY(th)        lwespi_stats_thread_mark(&esp.stats_ ## th ## _mark, &esp.stats_ ## th.busy_time)
+#define LWESPI_STATS_THREAD_IDLE(th)        lwespi_stats_thread_mark(&esp.stats_ ## th ## _mark, &esp.stats_ ## th.idle_time)
+#define LWESPI_STATS_THREAD_SYNC(th)        lwespi_stats_thread_mark(&esp.stats_ ## th ## _mark, &esp.stats_ ## th.sync_time)
+#define LWESPI_STATS_THREAD_WAKEUP(th)      (++esp.stats_ ## th.wakeups)
+#define LWESPI_STATS_MBOX_WRITE(mb, size)   lwespi_stats_mbox_write(&esp.stats_ ## mb, (size))
+#define LWESPI_STATS_MBOX_WRITE_FAIL(mb)    ((void)LWESP_CFG_ATOMIC_INC(&esp.stats_ ## mb.fails))
+#define LWESPI_STATS_MBOX_READ(mb)          (++esp.stats_ ## mb.reads)
+#else /* LWESP_CFG_STATS_THREAD */
+#define LWESPI_STATS_THREAD_BUSY(th)        do {} while (0)
+#define LWESPI_STATS_THREAD_IDLE(th)        do {} while (0)
+#define LWESPI_STATS_THREAD_SYNC(th)        do {} while (0)
+#define LWESPI_STATS_THREAD_WAKEUP(th)      do {} while (0)
+#define LWESPI_STATS_MBOX_WRITE(mb, size)   do {} while (0)
+#define LWESPI_STATS_MBOX_WRITE_FAIL(mb)    do {} while (0)
+#define LWESPI_STATS_MBOX_READ(mb)          do {} while (0)
+#endif /* !LWESP_CFG_STATS_THREAD */
+
+/* AT port capture hooks, called with core locked */
+#if LWESP_CFG_CAPTURE
+#define LWESPI_CAPTURE_RX(d, l)             lwespi_capture_write(LWESP_CAPTURE_TYPE_RX, (d), (l))
+#define LWESPI_CAPTURE_TX(d, l)             lwespi_capture_write(LWESP_CAPTURE_TYPE_TX, (d), (l))
+#define LWESPI_CAPTURE_RESET()              lwespi_capture_write(LWESP_CAPTURE_TYPE_RESET, NULL, 0)
+#else /* LWESP_CFG_CAPTURE */
+#define LWESPI_CAPTURE_RX(d, l)             do {} while (0)
+#define LWESPI_CAPTURE_TX(d, l)             do {} while (0)
+#define LWESPI_CAPTURE_RESET()              do {} while (0)
+#endif /* !LWESP_CFG_CAPTURE */
+
+/* Trace points, may be called from any thread */
+#if LWESP_CFG_TRACE
+#define LWESPI_TRACE(id, a, b)              lwesp_trace_write(LWESP_TRACE_ID_ ## id, (uint32_t)(a), (uint32_t)(b))
+#else /* LWESP_CFG_TRACE */
+#define LWESPI_TRACE(id, a, b)              do {} while (0)
+#endif /* !LWESP_CFG_TRACE */
+
+/* Connection send queue accounting, released at the latest when message is freed */
+#if LWESP_CFG_CONN_TX_QUEUE
+#define LWESPI_CONN_TX_QUEUE_INIT(c)        do {                \
+        (c)->tx_wm_high = LWESP_CFG_CONN_TX_QUEUE_HIGH;         \
+        (c)->tx_wm_low = LWESP_CFG_CONN_TX_QUEUE_LOW;           \
+    } while (0)
+#define LWESPI_CONN_TX_QUEUE_RELEASE(m)     lwespi_conn_tx_queue_release(m)
+#else /* LWESP_CFG_CONN_TX_QUEUE */
+#define LWESPI_CONN_TX_QUEUE_INIT(c)        do {} while (0)
+#define LWESPI_CONN_TX_QUEUE_RELEASE(m)     do {} while (0)
+#endif /* !LWESP_CFG_CONN_TX_QUEUE */
+
+/* Send event aggregation, decides if send event is reported and sets reported length */
+#if LWESP_CFG_CONN_SEND_EVT_AGGR
+#define LWESPI_CONN_SEND_EVT_REPORT(m, err, sent)   lwespi_conn_send_evt_aggr((m), (err), &(sent))
+#else /* LWESP_CFG_CONN_SEND_EVT_AGGR */
+#define LWESPI_CONN_SEND_EVT_REPORT(m, err, sent)   ((sent) = (m)->msg.conn_send.sent_all, 1)
+#endif /* !LWESP_CFG_CONN_SEND_EVT_AGGR */
+
+/* Sendfile transfer accounting, released with send result or at the latest when message is freed */
+#if LWESP_CFG_CONN_SENDFILE
+#define LWESPI_CONN_SENDFILE_RELEASE(m, res)    lwespi_conn_sendfile_release((m), (res))
+#else /* LWESP_CFG_CONN_SENDFILE */
+#define LWESPI_CONN_SENDFILE_RELEASE(m, res)    do {} while (0)
+#endif /* !LWESP_CFG_CONN_SENDFILE */
+
+/* Send command stopped between chunks by fair scheduler, it is not finished yet */
+#if LWESP_CFG_CONN_SEND_FAIR
+#define LWESPI_CONN_SEND_YIELDED(m)         ((m)->msg.conn_send.yield)
+#else /* LWESP_CFG_CONN_SEND_FAIR */
+#define LWESPI_CONN_SEND_YIELDED(m)         0
+#endif /* !LWESP_CFG_CONN_SEND_FAIR */
+
+/* Connection write buffer auto-flush time */
+#if LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0
+#define LWESPI_CONN_WRITE_FLUSH_INIT(c)     ((c)->write_flush_time = LWESP_CFG_CONN_WRITE_FLUSH_TIME)
+#else /* LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 */
+#define LWESPI_CONN_WRITE_FLUSH_INIT(c)     do {} while (0)
+#endif /* !(LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0) */
+
+/* Connection manual receive window */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+#define LWESPI_CONN_MANUAL_RECV_INIT(c)     ((c)->tcp_recv_window = LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_WINDOW)
+#else /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+#define LWESPI_CONN_MANUAL_RECV_INIT(c)     do {} while (0)
+#endif /* !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+
+/* Device currently operates in manual TCP receive mode */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+#define LWESPI_CONN_MANUAL_RECV_ACTIVE()    (esp.m.tcp_recv_manual)
+#else /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
+#define LWESPI_CONN_MANUAL_RECV_ACTIVE()    (LWESP_CFG_CONN_MANUAL_TCP_RECEIVE)
+#endif /* !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
+
+/* Notify producer that active command finished */
+#if LWESP_CFG_POLL
+#define LWESPI_CMD_SYNC_RELEASE()           (esp.cmd_sync = 1)
+#else /* LWESP_CFG_POLL */
+#define LWESPI_CMD_SYNC_RELEASE()           lwesp_sys_sem_release(&esp.sem_sync)
+#endif /* !LWESP_CFG_POLL */
+
 #define CRLF                                "\r\n"
 #define CRLF_LEN                            2
 
@@ -627,18 +1262,115 @@ extern lwesp_t esp;
 const char* lwespi_dbg_msg_to_string(lwesp_cmd_t cmd);
 lwespr_t    lwespi_process(const void* data, size_t len);
 lwespr_t    lwespi_process_buffer(void);
+#if !LWESP_CFG_INPUT_USE_PROCESS
+void        lwespi_process_resync(void);
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+#if LWESP_CFG_CONN_SEND_COALESCE
+void        lwespi_conn_send_coalesce(lwesp_msg_t* msg, lwesp_msg_t** pending);
+void        lwespi_conn_send_coalesce_release(lwesp_msg_t* msg, lwespr_t res);
+#endif /* LWESP_CFG_CONN_SEND_COALESCE */
+#if LWESP_CFG_CONN_SEND_BUFFERED
+lwespr_t    lwespi_conn_sendbuf_add(lwesp_conn_p conn, uint32_t seg_id, size_t len);
+void        lwespi_conn_sendbuf_ack(lwesp_conn_p conn, uint32_t seg_id, lwespr_t res);
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED */
+#if LWESP_CFG_CONN_SEND_FAIR
+uint8_t     lwespi_conn_sched_yield(lwesp_msg_t* msg);
+uint8_t     lwespi_conn_sched_requeue(lwesp_msg_t* msg);
+void        lwespi_conn_sched_release(lwesp_msg_t* msg);
+#endif /* LWESP_CFG_CONN_SEND_FAIR */
+#if LWESP_CFG_MSG_POOL_SIZE > 0 || LWESP_CFG_MSG_POOL_SMALL_SIZE > 0
+lwesp_msg_t* lwespi_msg_alloc(size_t size);
+void        lwespi_msg_free(lwesp_msg_t* msg);
+#endif /* LWESP_CFG_MSG_POOL_SIZE > 0 || LWESP_CFG_MSG_POOL_SMALL_SIZE > 0 */
+#if LWESP_CFG_IPD_ZERO_COPY
+lwesp_pbuf_p lwespi_pbuf_new_ref(void* payload, size_t len);
+void        lwespi_process_buffer_ref_release(void);
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
 lwespr_t    lwespi_initiate_cmd(lwesp_msg_t* msg);
 uint8_t     lwespi_is_valid_conn_ptr(lwesp_conn_p conn);
 lwespr_t    lwespi_send_cb(lwesp_evt_type_t type);
 lwespr_t    lwespi_send_conn_cb(lwesp_conn_t* conn, lwesp_evt_fn cb);
+uint32_t    lwespi_get_state(void);
+void        lwespi_state_notify(void);
 void        lwespi_conn_init(void);
 void        lwespi_conn_start_timeout(lwesp_conn_p conn);
+#if LWESP_CFG_STATIC_ONLY
+size_t      lwespi_pbuf_get_static_ram_size(void);
+#endif /* LWESP_CFG_STATIC_ONLY */
+uint8_t*    lwespi_conn_buff_alloc(size_t len);
+void        lwespi_conn_buff_free(const uint8_t* buff);
+#if LWESP_CFG_EVT_DEFERRED
+lwesp_evt_deferred_t* lwespi_evt_deferred_alloc(void);
+void        lwespi_evt_deferred_free(lwesp_evt_deferred_t* item);
+#endif /* LWESP_CFG_EVT_DEFERRED */
+#if LWESP_CFG_CONN_EVT_WORKERS > 0
+void        lwespi_conn_evt_work_free(lwesp_conn_evt_work_t* item);
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > 0 */
+#if LWESP_CFG_CONN_TX_QUEUE
+void        lwespi_conn_tx_queue_release(lwesp_msg_t* msg);
+#endif /* LWESP_CFG_CONN_TX_QUEUE */
+#if LWESP_CFG_CONN_SEND_EVT_AGGR
+uint8_t     lwespi_conn_send_evt_aggr(lwesp_msg_t* msg, lwespr_t err, size_t* sent);
+#endif /* LWESP_CFG_CONN_SEND_EVT_AGGR */
+#if LWESP_CFG_CONN_SENDFILE
+void        lwespi_conn_sendfile_release(lwesp_msg_t* msg, lwespr_t res);
+#endif /* LWESP_CFG_CONN_SENDFILE */
+#if LWESP_CFG_DNS_CACHE_SIZE > 0
+uint8_t     lwespi_dns_cache_get(const char* host, lwesp_ip_t* ip);
+void        lwespi_dns_cache_put(const char* host, const lwesp_ip_t* ip);
+void        lwespi_dns_cache_remove(const char* host);
+uint8_t     lwespi_dns_prefetch_next(lwesp_msg_t* msg);
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 */
+#if LWESP_CFG_IP_MAC_CACHE
+uint8_t     lwespi_ip_mac_cache_get_ip(const lwesp_ip_mac_t* im, lwesp_ip_t* ip, lwesp_ip_t* gw, lwesp_ip_t* nm, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg);
+uint8_t     lwespi_ip_mac_cache_get_mac(const lwesp_ip_mac_t* im, lwesp_mac_t* mac, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg);
+#if LWESP_CFG_HOSTNAME
+void        lwespi_hostname_cache_set(const char* str);
+#endif /* LWESP_CFG_HOSTNAME */
+#endif /* LWESP_CFG_IP_MAC_CACHE */
+#if LWESP_CFG_AP_STA_TABLE > 0
+void        lwespi_ap_sta_table_set(const lwesp_mac_t* mac, const lwesp_ip_t* ip);
+void        lwespi_ap_sta_table_remove(const lwesp_mac_t* mac);
+void        lwespi_ap_sta_table_sync_start(void);
+void        lwespi_ap_sta_table_sync_done(void);
+#endif /* LWESP_CFG_AP_STA_TABLE > 0 */
+#if LWESP_CFG_SNTP_CLOCK
+void        lwespi_sntp_clock_sync(const lwesp_datetime_t* dt);
+#endif /* LWESP_CFG_SNTP_CLOCK */
+lwesp_cmd_t lwespi_conn_start_next_cmd(lwesp_msg_t* msg, lwesp_cmd_t cmd);
 lwespr_t    lwespi_conn_check_available_rx_data(void);
 lwespr_t    lwespi_conn_manual_tcp_try_read_data(lwesp_conn_p conn);
+size_t      lwespi_conn_manual_tcp_read_len(lwesp_conn_p conn);
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+lwespr_t    lwespi_conn_manual_tcp_auto_enter(void);
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
 lwespr_t    lwespi_send_msg_to_producer_mbox(lwesp_msg_t* msg, lwespr_t (*process_fn)(lwesp_msg_t*), uint32_t max_block_time);
+lwespr_t    lwespi_send_batch_to_producer_mbox(lwesp_msg_t* first, lwesp_msg_t* last);
+#if LWESP_CFG_CMD_SINGLE_FLIGHT
+lwesp_msg_t* lwespi_cmd_sf_release(lwesp_msg_t* msg);
+#endif /* LWESP_CFG_CMD_SINGLE_FLIGHT */
 uint32_t    lwespi_get_from_mbox_with_timeout_checks(lwesp_sys_mbox_t* b, void** m, uint32_t timeout);
+void        lwespi_timeout_process(void);
+#if LWESP_CFG_STATS
+void        lwespi_stats_cmd_enqueue(lwesp_msg_t* msg);
+void        lwespi_stats_cmd_start(lwesp_msg_t* msg);
+void        lwespi_stats_cmd_resp(lwesp_msg_t* msg);
+void        lwespi_stats_cmd_done(lwesp_msg_t* msg, lwespr_t res);
+#endif /* LWESP_CFG_STATS */
+#if LWESP_CFG_STATS_THREAD
+void        lwespi_stats_thread_mark(uint32_t* mark, uint32_t* field);
+void        lwespi_stats_mbox_write(lwesp_stats_mbox_cnt_t* cnt, uint32_t size);
+#endif /* LWESP_CFG_STATS_THREAD */
+#if LWESP_CFG_CAPTURE
+void        lwespi_capture_write(lwesp_capture_type_t type, const void* data, size_t len);
+#endif /* LWESP_CFG_CAPTURE */
+uint8_t     lwespi_get_producer_msg(lwesp_msg_t** msg, uint8_t block);
+lwespr_t    lwespi_check_msg_start(lwesp_msg_t* msg);
 
 void        lwespi_reset_everything(uint8_t forced);
+#if LWESP_CFG_RESET_RECOVERY || __DOXYGEN__
+lwespr_t    lwespi_reset_recover(void);
+#endif /* LWESP_CFG_RESET_RECOVERY || __DOXYGEN__ */
 void        lwespi_process_events_for_timeout_or_error(lwesp_msg_t* msg, lwespr_t err);
 
 /**
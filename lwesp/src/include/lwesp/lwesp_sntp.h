@@ -49,6 +49,12 @@ extern "C" {
 
 lwespr_t    lwesp_sntp_set_config(uint8_t en, int8_t tz, const char* h1, const char* h2, const char* h3, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwespr_t    lwesp_sntp_gettime(lwesp_datetime_t* dt, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+#if LWESP_CFG_SNTP_CLOCK || __DOXYGEN__
+lwespr_t    lwesp_sntp_clock_start(uint32_t interval);
+lwespr_t    lwesp_sntp_clock_stop(void);
+lwespr_t    lwesp_sntp_clock_gettime(lwesp_datetime_t* dt);
+lwespr_t    lwesp_sntp_clock_get_epoch(uint32_t* sec, uint16_t* ms);
+#endif /* LWESP_CFG_SNTP_CLOCK || __DOXYGEN__ */
 
 /**
  * \}
@@ -0,0 +1,114 @@
+/**
+ * \file            lwesp_sockets.h
+ * \brief           BSD-style socket API on top of netconn
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_SOCKETS_H
+#define LWESP_HDR_SOCKETS_H
+
+#include "lwesp/lwesp.h"
+#include "lwesp/lwesp_netconn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWESP_API
+ * \defgroup        LWESP_SOCKETS Sockets
+ * \brief           BSD-style socket API on top of netconn
+ * \{
+ *
+ * Functions follow BSD socket semantics with `lwesp_` prefix.
+ * They return `-1` on failure and last error of socket is available with \ref lwesp_sock_get_error
+ */
+
+#if LWESP_CFG_SOCKETS || __DOXYGEN__
+
+#define LWESP_AF_INET               2           /*!< IPv4 address family */
+
+#define LWESP_SOCK_STREAM           1           /*!< TCP stream socket */
+#define LWESP_SOCK_DGRAM            2           /*!< UDP datagram socket */
+
+#define LWESP_MSG_DONTWAIT          0x40        /*!< Do not block in send or receive function */
+
+#define LWESP_F_GETFL               3           /*!< Get socket flags command for \ref lwesp_fcntl */
+#define LWESP_F_SETFL               4           /*!< Set socket flags command for \ref lwesp_fcntl */
+#define LWESP_O_NONBLOCK            0x01        /*!< Non-blocking socket flag */
+
+/**
+ * \brief           Socket address
+ */
+typedef struct {
+    lwesp_ip_t ip;                              /*!< IP address */
+    lwesp_port_t port;                          /*!< Port number */
+} lwesp_sockaddr_in_t;
+
+/**
+ * \brief           Set of sockets for \ref lwesp_select function
+ */
+typedef struct {
+    uint32_t bits[(LWESP_CFG_SOCKETS_MAX + 31) / 32];   /*!< One bit per socket descriptor */
+} lwesp_fd_set_t;
+
+#define LWESP_FD_ZERO(set)          LWESP_MEMSET((set), 0x00, sizeof(*(set)))   /*!< Clear socket set */
+#define LWESP_FD_SET(fd, set)       ((set)->bits[(fd) / 32] |= (1UL << ((fd) % 32)))    /*!< Add socket to set */
+#define LWESP_FD_CLR(fd, set)       ((set)->bits[(fd) / 32] &= ~(1UL << ((fd) % 32)))   /*!< Remove socket from set */
+#define LWESP_FD_ISSET(fd, set)     (((set)->bits[(fd) / 32] & (1UL << ((fd) % 32))) != 0)  /*!< Check if socket is in set */
+
+int         lwesp_socket(int domain, int type, int protocol);
+int         lwesp_sock_close(int fd);
+int         lwesp_bind(int fd, const lwesp_sockaddr_in_t* addr);
+int         lwesp_listen(int fd, int backlog);
+int         lwesp_accept(int fd, lwesp_sockaddr_in_t* addr);
+int         lwesp_connect(int fd, const lwesp_sockaddr_in_t* addr);
+int         lwesp_send(int fd, const void* data, size_t len, int flags);
+int         lwesp_sendto(int fd, const void* data, size_t len, int flags, const lwesp_sockaddr_in_t* addr);
+int         lwesp_recv(int fd, void* buf, size_t len, int flags);
+int         lwesp_recvfrom(int fd, void* buf, size_t len, int flags, lwesp_sockaddr_in_t* addr);
+int         lwesp_recv_zc(int fd, const void** data, int flags);
+int         lwesp_recv_zc_done(int fd, size_t len);
+int         lwesp_fcntl(int fd, int cmd, int val);
+int         lwesp_select(int nfds, lwesp_fd_set_t* readfds, lwesp_fd_set_t* writefds, lwesp_fd_set_t* exceptfds, uint32_t timeout);
+lwespr_t    lwesp_sock_get_error(int fd);
+lwesp_netconn_p lwesp_sock_get_netconn(int fd);
+
+#endif /* LWESP_CFG_SOCKETS || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWESP_HDR_SOCKETS_H */
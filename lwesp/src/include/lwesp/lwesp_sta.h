@@ -47,6 +47,24 @@ extern "C" {
  * \{
  */
 
+/**
+ * \anchor          LWESP_STA_AP_FIELD
+ * \name            Access point fields
+ * \brief           Fields of \ref lwesp_ap_t reported by device during scan, used as bit mask
+ * \{
+ */
+
+#define LWESP_STA_AP_FIELD_ECN        0x01      /*!< Encryption type */
+#define LWESP_STA_AP_FIELD_SSID       0x02      /*!< Access point name */
+#define LWESP_STA_AP_FIELD_RSSI       0x04      /*!< Received signal strength */
+#define LWESP_STA_AP_FIELD_MAC        0x08      /*!< MAC address */
+#define LWESP_STA_AP_FIELD_CH         0x10      /*!< WiFi channel */
+#define LWESP_STA_AP_FIELD_ALL        0x1F      /*!< All supported fields */
+
+/**
+ * \}
+ */
+
 lwespr_t    lwesp_sta_join(const char* name, const char* pass, const lwesp_mac_t* mac, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwespr_t    lwesp_sta_quit(const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwespr_t    lwesp_sta_autojoin(uint8_t en, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
@@ -59,6 +77,7 @@ uint8_t     lwesp_sta_has_ip(void);
 uint8_t     lwesp_sta_is_joined(void);
 lwespr_t    lwesp_sta_copy_ip(lwesp_ip_t* ip, lwesp_ip_t* gw, lwesp_ip_t* nm, uint8_t* is_dhcp);
 lwespr_t    lwesp_sta_list_ap(const char* ssid, lwesp_ap_t* aps, size_t apsl, size_t* apf, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+lwespr_t    lwesp_sta_list_ap_stream(const char* ssid, uint8_t fields, lwesp_sta_list_ap_fn ap_fn, void* const ap_fn_arg, size_t* apf, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 lwespr_t    lwesp_sta_get_ap_info(lwesp_sta_info_ap_t* info, const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 uint8_t     lwesp_sta_is_ap_802_11b(lwesp_ap_t* ap);
 uint8_t     lwesp_sta_is_ap_802_11g(lwesp_ap_t* ap);
@@ -0,0 +1,99 @@
+/**
+ * \file            lwesp_sta_mgr.h
+ * \brief           Station manager with background scan and roaming
+ */
+
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_STA_MGR_H
+#define LWESP_HDR_STA_MGR_H
+
+#include "lwesp/lwesp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWESP
+ * \defgroup        LWESP_STA_MGR Station manager
+ * \brief           Background scan while connected and roaming to best known access point
+ * \{
+ *
+ * Manager keeps list of candidate access points, which match list of known networks,
+ * ranked by RSSI. List is refreshed with background scan every scan interval while station is connected.
+ * Scan is streamed and does not need array of access points.
+ * With \ref LWESP_CFG_CMD_PRIORITY enabled, scan runs in low priority lane and does not delay data commands.
+ *
+ * When station disconnects, manager immediately joins best candidate with its cached BSSID,
+ * without new scan. Full scan is only started when all candidates fail.
+ * When signal of current access point drops below \ref LWESP_CFG_STA_MGR_ROAM_RSSI,
+ * manager roams to candidate, stronger by at least \ref LWESP_CFG_STA_MGR_ROAM_HYST.
+ *
+ * \note            Disable auto reconnect of device with \ref lwesp_sta_reconnect_set_config
+ *                  to let manager select access point after disconnect
+ */
+
+#if LWESP_CFG_STA_MGR || __DOXYGEN__
+
+/**
+ * \brief           Known network
+ */
+typedef struct {
+    const char* ssid;                           /*!< Access point name */
+    const char* pass;                           /*!< Access point password, `NULL` for open network */
+} lwesp_sta_mgr_ap_t;
+
+/**
+ * \brief           Candidate access point found by scan
+ */
+typedef struct {
+    lwesp_mac_t bssid;                          /*!< Access point MAC address */
+    int16_t rssi;                               /*!< RSSI in last scan */
+    uint8_t ch;                                 /*!< WiFi channel */
+    uint8_t ap_idx;                             /*!< Index of matching entry in known networks list */
+} lwesp_sta_mgr_cand_t;
+
+lwespr_t    lwesp_sta_mgr_start(const lwesp_sta_mgr_ap_t* aps, size_t len, uint32_t scan_interval);
+lwespr_t    lwesp_sta_mgr_stop(void);
+lwespr_t    lwesp_sta_mgr_roam(void);
+size_t      lwesp_sta_mgr_get_candidates(lwesp_sta_mgr_cand_t* cands, size_t len);
+
+#endif /* LWESP_CFG_STA_MGR || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWESP_HDR_STA_MGR_H */
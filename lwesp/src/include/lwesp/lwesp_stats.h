@@ -0,0 +1,183 @@
+/**
+ * \file            lwesp_stats.h
+ * \brief           Runtime statistics
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_STATS_H
+#define LWESP_HDR_STATS_H
+
+#include "lwesp/lwesp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWESP
+ * \defgroup        LWESP_STATS Runtime statistics
+ * \brief           Command latency and traffic statistics
+ * \{
+ */
+
+#if LWESP_CFG_STATS || LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_STATS_THREAD || __DOXYGEN__
+
+/**
+ * \brief           Frequency of time base for statistics counters in units of Hz
+ *
+ * Microseconds when \ref LWESP_CFG_SYS_NOW_US is enabled, milliseconds otherwise
+ */
+#if LWESP_CFG_SYS_NOW_US || __DOXYGEN__
+#define LWESP_STATS_TIME_FREQ               1000000
+#else /* LWESP_CFG_SYS_NOW_US || __DOXYGEN__ */
+#define LWESP_STATS_TIME_FREQ               1000
+#endif /* !(LWESP_CFG_SYS_NOW_US || __DOXYGEN__) */
+
+/**
+ * \brief           Unit of statistics time counters as string, `"us"` or `"ms"`
+ */
+#if LWESP_CFG_SYS_NOW_US || __DOXYGEN__
+#define LWESP_STATS_TIME_UNIT               "us"
+#else /* LWESP_CFG_SYS_NOW_US || __DOXYGEN__ */
+#define LWESP_STATS_TIME_UNIT               "ms"
+#endif /* !(LWESP_CFG_SYS_NOW_US || __DOXYGEN__) */
+
+#if LWESP_CFG_STATS || __DOXYGEN__
+
+/**
+ * \brief           Latency statistics of single AT command type
+ *
+ * Times are in units of \ref LWESP_STATS_TIME_UNIT.
+ * Histogram is log-bucketed in units of milliseconds, bucket `0` counts executions below `1 ms`,
+ * bucket `i` counts executions in range `[2^(i - 1), 2^i)` and last bucket counts all longer executions
+ */
+typedef struct {
+    uint32_t count;                             /*!< Number of finished executions */
+    uint32_t err_count;                         /*!< Number of executions finished with error */
+    uint32_t timeout_count;                     /*!< Number of executions finished with timeout */
+    uint32_t time_sum;                          /*!< Sum of execution times from start to `OK` or `ERROR` */
+    uint32_t time_max;                          /*!< Maximal execution time */
+    uint32_t resp_time_max;                     /*!< Maximal time from start to first response byte */
+    uint32_t queue_time_max;                    /*!< Maximal time message waited in producer queue */
+    uint32_t hist[LWESP_CFG_STATS_HIST_BUCKETS];/*!< Execution time histogram */
+} lwesp_stats_cmd_t;
+
+#endif /* LWESP_CFG_STATS || __DOXYGEN__ */
+
+#if LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__
+
+/**
+ * \brief           Traffic statistics of connection
+ *
+ * Used for single connection and for totals of all connections.
+ * Connection counters are reset each time connection becomes active
+ */
+typedef struct {
+    uint32_t tx_bytes;                          /*!< Number of bytes confirmed with `SEND OK` */
+    uint32_t rx_bytes;                          /*!< Number of bytes passed to application */
+    uint32_t tx_packets;                        /*!< Number of `CIPSEND` commands confirmed with `SEND OK` */
+    uint32_t rx_packets;                        /*!< Number of packet buffers passed to application */
+    uint32_t send_retries;                      /*!< Number of `CIPSEND` retries, see \ref LWESP_CFG_MAX_SEND_RETRIES */
+    uint32_t send_fails;                        /*!< Number of `SEND FAIL` or `CIPSEND` errors */
+    uint32_t ipd_drops;                         /*!< Number of received packets dropped due to packet buffer allocation failure */
+} lwesp_stats_conn_t;
+
+#endif /* LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__ */
+
+#if LWESP_CFG_STATS_THREAD || __DOXYGEN__
+
+/**
+ * \brief           Utilization statistics of stack thread
+ *
+ * Times are accumulated in units of \ref LWESP_STATS_TIME_UNIT and wrap around on overflow
+ */
+typedef struct {
+    uint32_t busy_time;                         /*!< Time spent processing */
+    uint32_t idle_time;                         /*!< Time spent waiting for new message or data */
+    uint32_t sync_time;                         /*!< Time producer spent waiting on `sem_sync` for command to finish, `0` for process thread */
+    uint32_t wakeups;                           /*!< Number of thread wake-ups */
+} lwesp_stats_thread_t;
+
+/**
+ * \brief           Utilization statistics of system mailbox
+ */
+typedef struct {
+    uint32_t size;                              /*!< Mailbox size in number of entries */
+    uint32_t depth;                             /*!< Number of entries currently in mailbox */
+    uint32_t depth_max;                         /*!< Maximal number of entries in mailbox */
+    uint32_t writes;                            /*!< Number of successful writes */
+    uint32_t write_fails;                       /*!< Number of writes failed as mailbox was full */
+} lwesp_stats_mbox_t;
+
+#endif /* LWESP_CFG_STATS_THREAD || __DOXYGEN__ */
+
+/**
+ * \brief           Global statistics
+ */
+typedef struct {
+#if LWESP_CFG_STATS || __DOXYGEN__
+    size_t cmd_count;                           /*!< Number of command types, valid indexes for \ref lwesp_stats_get_cmd */
+#endif /* LWESP_CFG_STATS || __DOXYGEN__ */
+#if LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__
+    uint32_t uart_rx_bytes;                     /*!< Number of bytes received from AT port */
+    uint32_t uart_rx_dropped;                   /*!< Number of received bytes lost on input buffer overflow */
+    uint32_t uart_rx_overflows;                 /*!< Number of input buffer overflows */
+    uint32_t recv_lines_truncated;              /*!< Number of response lines longer than \ref LWESP_CFG_RECV_LINE_BUFF_LEN */
+    uint32_t uart_tx_bytes;                     /*!< Number of bytes sent to AT port */
+    lwesp_stats_conn_t conn;                    /*!< Totals of all connections */
+#endif /* LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__ */
+#if LWESP_CFG_STATS_THREAD || __DOXYGEN__
+    lwesp_stats_thread_t producer;              /*!< Producer thread utilization */
+    lwesp_stats_thread_t process;               /*!< Process thread utilization */
+    lwesp_stats_mbox_t mbox_producer;           /*!< Producer mailbox, \ref LWESP_CFG_THREAD_PRODUCER_MBOX_SIZE */
+    lwesp_stats_mbox_t mbox_process;            /*!< Process mailbox, \ref LWESP_CFG_THREAD_PROCESS_MBOX_SIZE */
+#endif /* LWESP_CFG_STATS_THREAD || __DOXYGEN__ */
+} lwesp_stats_t;
+
+lwespr_t    lwesp_stats_get(lwesp_stats_t* stats);
+#if LWESP_CFG_STATS || __DOXYGEN__
+lwespr_t    lwesp_stats_get_cmd(size_t cmd, lwesp_stats_cmd_t* stats);
+#endif /* LWESP_CFG_STATS || __DOXYGEN__ */
+#if LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__
+lwespr_t    lwesp_stats_get_conn(lwesp_conn_p conn, lwesp_stats_conn_t* stats);
+#endif /* LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__ */
+void        lwesp_stats_reset(void);
+
+#endif /* LWESP_CFG_STATS || LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_STATS_THREAD || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWESP_HDR_STATS_H */
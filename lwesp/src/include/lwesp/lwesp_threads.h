@@ -40,8 +40,13 @@
 extern "C" {
 #endif /* __cplusplus */
 
+#if !LWESP_CFG_POLL
 void    lwesp_thread_produce(void* const arg);
 void    lwesp_thread_process(void* const arg);
+#if LWESP_CFG_CONN_EVT_WORKERS > 0
+void    lwesp_thread_conn_evt(void* const arg);
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > 0 */
+#endif /* !LWESP_CFG_POLL */
 
 #ifdef __cplusplus
 }
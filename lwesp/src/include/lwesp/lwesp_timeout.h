@@ -49,6 +49,9 @@ extern "C" {
 
 lwespr_t          lwesp_timeout_add(uint32_t time, lwesp_timeout_fn fn, void* arg);
 lwespr_t          lwesp_timeout_remove(lwesp_timeout_fn fn);
+lwesp_timeout_id_t  lwesp_timeout_addex(uint32_t time, lwesp_timeout_fn fn, void* arg);
+lwespr_t          lwesp_timeout_cancel(lwesp_timeout_id_t id);
+uint32_t          lwesp_timeout_next_deadline(void);
 
 /**
  * \}
@@ -0,0 +1,115 @@
+/**
+ * \file            lwesp_trace.h
+ * \brief           Trace points
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_TRACE_H
+#define LWESP_HDR_TRACE_H
+
+#include "lwesp/lwesp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         LWESP
+ * \defgroup        LWESP_TRACE Trace points
+ * \brief           Structured low-overhead trace of stack internals
+ * \{
+ *
+ * Trace point records event ID, timestamp and two integer arguments to ring buffer
+ * of \ref LWESP_CFG_TRACE_BUFF_LEN events. Slot is reserved with atomic increment,
+ * no lock is taken and no formatting is done when event is recorded.
+ * When buffer is full, oldest events are overwritten.
+ *
+ * Events can be read in binary form with \ref lwesp_trace_read
+ * or streamed out as JSON trace with \ref lwesp_trace_export,
+ * which can be opened in Perfetto UI or `chrome://tracing`.
+ * To forward events to SEGGER SystemView or other live tracer, use \ref LWESP_CFG_TRACE_HOOK.
+ *
+ * When \ref LWESP_CFG_TRACE is disabled, trace points compile to nothing.
+ */
+
+#if LWESP_CFG_TRACE || __DOXYGEN__
+
+/**
+ * \brief           Trace event ID
+ */
+typedef enum {
+    LWESP_TRACE_ID_PROCESS = 0x00,              /*!< Data passed to parser. `a` = length */
+    LWESP_TRACE_ID_IPD_START,                   /*!< Start of IPD data. `a` = connection number, `b` = length */
+    LWESP_TRACE_ID_IPD_DONE,                    /*!< All IPD data received. `a` = connection number, `b` = length */
+    LWESP_TRACE_ID_CMD_START,                   /*!< Producer started command. `a` = command, `b` = `0` */
+    LWESP_TRACE_ID_CMD_DONE,                    /*!< Producer finished command. `a` = command, `b` = result */
+    LWESP_TRACE_ID_CONN_SEND,                   /*!< Send requested on connection. `a` = connection number, `b` = length */
+    LWESP_TRACE_ID_PBUF_NEW,                    /*!< Packet buffer allocation. `a` = length, `b` = `1` on success, `0` on failure */
+    LWESP_TRACE_ID_TIMEOUT_ADD,                 /*!< Timeout added. `a` = time in milliseconds, `b` = `1` on success, `0` on failure */
+    LWESP_TRACE_ID_TIMEOUT_START,               /*!< Timeout callback called. `a` = milliseconds late, `b` = pending timeouts */
+    LWESP_TRACE_ID_TIMEOUT_DONE,                /*!< Timeout callback returned */
+    LWESP_TRACE_ID_END,                         /*!< Last element, used for array size */
+} lwesp_trace_id_t;
+
+/**
+ * \brief           Trace event
+ */
+typedef struct {
+    uint32_t time;                              /*!< Event time, \ref LWESP_CFG_TRACE_TIME, units of \ref LWESP_CFG_TRACE_TIME_FREQ */
+    lwesp_trace_id_t id;                        /*!< Event ID */
+    uint32_t a;                                 /*!< First event argument */
+    uint32_t b;                                 /*!< Second event argument */
+} lwesp_trace_evt_t;
+
+/**
+ * \brief           Trace export output function
+ * \param[in]       str: Chunk of output string, not `NULL` terminated
+ * \param[in]       len: Length of chunk in units of bytes
+ * \param[in]       arg: User argument passed to \ref lwesp_trace_export
+ */
+typedef void (*lwesp_trace_out_fn)(const char* str, size_t len, void* arg);
+
+void        lwesp_trace_write(lwesp_trace_id_t id, uint32_t a, uint32_t b);
+size_t      lwesp_trace_read(lwesp_trace_evt_t* evts, size_t max);
+lwespr_t    lwesp_trace_export(lwesp_trace_out_fn out_fn, void* arg);
+const char* lwesp_trace_get_name(lwesp_trace_id_t id);
+uint32_t    lwesp_trace_get_lost(void);
+
+#endif /* LWESP_CFG_TRACE || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWESP_HDR_TRACE_H */
@@ -78,6 +78,7 @@ typedef enum {
     lwespERRWIFINOTCONNECTED,                   /*!< Wifi not connected to access point */
     lwespERRNODEVICE,                           /*!< Device is not present */
     lwespERRBLOCKING,                           /*!< Blocking mode command is not allowed */
+    lwespERRCANCELLED,                          /*!< Command cancelled before it was started */
 } lwespr_t;
 
 /**
@@ -94,6 +95,28 @@ typedef enum {
     LWESP_DEVICE_UNKNOWN,                       /*!< Unknown device */
 } lwesp_device_t;
 
+/**
+ * \ingroup         LWESP_TYPEDEFS
+ * \brief           Performance parameters, changed at runtime with \ref lwesp_set_param
+ *
+ * Each parameter starts with value of its compile time option
+ * \sa              LWESP_CFG_RUNTIME_PARAMS
+ */
+typedef enum {
+    LWESP_PARAM_CONN_POLL_INTERVAL = 0x00,      /*!< Base poll interval of connections in units of milliseconds,
+                                                    \ref LWESP_CFG_CONN_POLL_INTERVAL. Range is `10` to `3600000` */
+    LWESP_PARAM_CONN_MAX_DATA_LEN,              /*!< Maximal number of bytes sent with single command, range is `1` to
+                                                    \ref LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT, which is also default value.
+                                                    Length detected from device firmware still applies */
+    LWESP_PARAM_MAX_SEND_RETRIES,               /*!< Number of tries of single send command, \ref LWESP_CFG_MAX_SEND_RETRIES.
+                                                    Range is `1` to `255` */
+    LWESP_PARAM_CONN_MAX_RECV_BUFF_SIZE,        /*!< Maximal size of received packet buffer, range is `64` to
+                                                    \ref LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE, which is also default value */
+    LWESP_PARAM_CONN_SEND_TIMEOUT,              /*!< Maximal time of send command in units of milliseconds,
+                                                    \ref LWESP_CFG_CONN_SEND_TIMEOUT. Range is `100` to `3600000` */
+    LWESP_PARAM_END,                            /*!< Last entry, number of parameters */
+} lwesp_param_t;
+
 /**
  * \ingroup         LWESP_TYPEDEFS
  * \brief           List of encryptions of access point
@@ -147,6 +170,21 @@ typedef struct {
     uint8_t patch;                              /*!< Patch version */
 } lwesp_sw_version_t;
 
+/**
+ * \ingroup         LWESP_TYPEDEFS
+ * \brief           Batch of API commands, submitted to producer thread at once
+ * \note            Structure content is private and shall not be modified by application
+ */
+typedef struct {
+    struct lwesp_msg* first;                    /*!< First recorded command */
+    struct lwesp_msg* last;                     /*!< Last recorded command */
+    size_t count;                               /*!< Number of recorded commands */
+#if LWESP_CFG_CMD_CANCEL || __DOXYGEN__
+    uint32_t id;                                /*!< Batch identifier, used for cancellation */
+    uint32_t deadline;                          /*!< Absolute deadline for commands to start. `0` when not used */
+#endif /* LWESP_CFG_CMD_CANCEL || __DOXYGEN__ */
+} lwesp_batch_t;
+
 /**
  * \ingroup         LWESP_AP
  * \brief           Access point data structure
@@ -254,6 +292,32 @@ typedef enum {
     LWESP_CONN_TYPE_SSL,                        /*!< Connection type is SSL */
 } lwesp_conn_type_t;
 
+#if LWESP_CFG_CMD_PRIORITY || __DOXYGEN__
+
+/**
+ * \ingroup         LWESP_CONN
+ * \brief           Command priority classes
+ */
+typedef enum {
+    LWESP_CMD_PRIO_NORMAL = 0x00,               /*!< Default priority, for data transfer and regular commands */
+    LWESP_CMD_PRIO_HIGH,                        /*!< High priority, for latency critical control traffic */
+    LWESP_CMD_PRIO_LOW,                         /*!< Low priority, for slow background commands such as scans */
+    LWESP_CMD_PRIO_END,                         /*!< Number of priority classes. Not a valid priority */
+} lwesp_cmd_prio_t;
+
+#endif /* LWESP_CFG_CMD_PRIORITY || __DOXYGEN__ */
+
+/**
+ * \ingroup         LWESP
+ * \brief           Stack state flags to wait for with \ref lwesp_wait_for
+ */
+typedef enum {
+    LWESP_STATE_DEVICE_PRESENT = 0x01,          /*!< Device is present and initialized */
+    LWESP_STATE_WIFI_CONNECTED = 0x02,          /*!< Station is connected to access point */
+    LWESP_STATE_HAS_IP = 0x04,                  /*!< Station has IP address */
+    LWESP_STATE_CONN_ACTIVE = 0x08,             /*!< At least one connection is active */
+} lwesp_state_t;
+
 /* Forward declarations */
 struct lwesp_evt;
 struct lwesp_conn;
@@ -265,6 +329,18 @@ struct lwesp_pbuf;
  */
 typedef struct lwesp_conn* lwesp_conn_p;
 
+/**
+ * \ingroup         LWESP_CONN
+ * \brief           Generation tagged connection handle
+ *
+ * Handle keeps connection number in low `8` bits and connection generation in upper bits.
+ * Generation changes each time connection becomes active, so handle of closed
+ * connection does not match connection reused later. Value `0` is never valid handle
+ *
+ * \sa              lwesp_conn_get_handle, lwesp_conn_from_handle
+ */
+typedef uint32_t lwesp_conn_handle_t;
+
 /**
  * \ingroup         LWESP_PBUF
  * \brief           Pointer to \ref lwesp_pbuf_t structure
@@ -304,6 +380,16 @@ typedef enum lwesp_evt_type_t {
     LWESP_EVT_CONN_ERROR,                       /*!< Client connection start was not successful */
     LWESP_EVT_CONN_CLOSE,                       /*!< Connection close event. Check status if successful */
     LWESP_EVT_CONN_POLL,                        /*!< Poll for connection if there are any changes */
+#if LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__
+    LWESP_EVT_CONN_TX_WATERMARK,                /*!< Connection send queue crossed high or low watermark */
+#endif /* LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__
+    LWESP_EVT_CONN_SEND_ACK,                    /*!< Data sent in buffered mode were acknowledged by remote side */
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__ */
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+    LWESP_EVT_CONN_RESYNC,                      /*!< Connection kept by device over host restart was found on warm init.
+                                                    Set callback with \ref lwesp_conn_set_evt_fn to keep it, otherwise it is closed */
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
 
     LWESP_EVT_SERVER,                           /*!< Server status changed */
 
@@ -332,6 +418,8 @@ typedef enum lwesp_evt_type_t {
 #if LWESP_CFG_PING || __DOXYGEN__
     LWESP_EVT_PING,                             /*!< PING service finished */
 #endif /* LWESP_CFG_PING || __DOXYGEN__ */
+
+    LWESP_EVT_END,                              /*!< Number of event types. Not an event, must stay last */
 } lwesp_evt_type_t;
 
 /**
@@ -383,6 +471,25 @@ typedef struct lwesp_evt {
             lwesp_conn_p conn;                  /*!< Set connection pointer */
         } conn_poll;                            /*!< Polling active connection to check for timeouts.
                                                         Use with \ref LWESP_EVT_CONN_POLL event */
+#if LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__
+        struct {
+            lwesp_conn_p conn;                  /*!< Connection handle */
+            size_t queued;                      /*!< Number of bytes in send queue at the time of event */
+            uint8_t high;                       /*!< Set to `1` when high watermark was reached, `0` when queue dropped to low watermark */
+        } conn_tx_watermark;                    /*!< Send queue watermark crossed. Use with \ref LWESP_EVT_CONN_TX_WATERMARK event */
+#endif /* LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__ */
+#if LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__
+        struct {
+            lwesp_conn_p conn;                  /*!< Connection handle */
+            size_t len;                         /*!< Number of bytes acknowledged (or failed) with this event */
+            lwespr_t res;                       /*!< Result of acknowledge, \ref lwespOK on `SEND OK` */
+        } conn_send_ack;                        /*!< Buffered data acknowledge. Use with \ref LWESP_EVT_CONN_SEND_ACK event */
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__ */
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+        struct {
+            lwesp_conn_p conn;                  /*!< Connection handle */
+        } conn_resync;                          /*!< Connection found on warm init. Use with \ref LWESP_EVT_CONN_RESYNC event */
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
 
         struct {
             lwespr_t res;                       /*!< Status of command */
@@ -456,6 +563,26 @@ typedef size_t (*lwesp_ll_send_fn)(const void* data, size_t len);
  */
 typedef uint8_t (*lwesp_ll_reset_fn)(uint8_t state);
 
+/**
+ * \ingroup         LWESP_LL
+ * \brief           Cached device state, used for warm init
+ */
+typedef struct {
+    uint32_t fingerprint;                       /*!< Hash of AT firmware version and library configuration.
+                                                    Value `0` means state is not valid */
+    lwesp_device_t device;                      /*!< Device type */
+    uint8_t link_conn_urc;                      /*!< Device reports connection changes with `+LINK_CONN` */
+} lwesp_warm_state_t;
+
+/**
+ * \ingroup         LWESP_LL
+ * \brief           Function prototype to load or store cached device state in non-volatile memory
+ * \param[in,out]   state: State to store when `save == 1` or output to load state to when `save == 0`
+ * \param[in]       save: Set to `1` when state shall be stored, `0` when it shall be loaded
+ * \return          `1` on successful action, `0` otherwise
+ */
+typedef uint8_t (*lwesp_ll_warm_state_fn)(lwesp_warm_state_t* state, uint8_t save);
+
 /**
  * \ingroup         LWESP_LL
  * \brief           Low level user specific functions
@@ -463,8 +590,16 @@ typedef uint8_t (*lwesp_ll_reset_fn)(uint8_t state);
 typedef struct {
     lwesp_ll_send_fn send_fn;                   /*!< Callback function to transmit data */
     lwesp_ll_reset_fn reset_fn;                 /*!< Reset callback function */
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+    lwesp_ll_warm_state_fn warm_state_fn;       /*!< Callback to load and store cached device state.
+                                                    Set to `NULL` to always use full reset sequence */
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
     struct {
         uint32_t baudrate;                      /*!< UART baudrate value */
+        uint32_t max_baudrate;                  /*!< Maximal baudrate host UART supports, used by
+                                                    \ref lwesp_set_at_baudrate_auto. Set to `0` for no limit */
+        uint8_t flow_control;                   /*!< Hardware flow control mode, see \ref LWESP_CFG_AT_PORT_FLOW_CONTROL.
+                                                    Set by library to mode currently active on device side */
     } uart;                                     /*!< UART communication parameters */
 } lwesp_ll_t;
 
@@ -475,15 +610,24 @@ typedef struct {
  */
 typedef void (*lwesp_timeout_fn)(void* arg);
 
+/**
+ * \ingroup         LWESP_TIMEOUT
+ * \brief           Timeout handle, used to cancel specific timeout.
+ *                  Value `0` is never used for valid timeout
+ */
+typedef uint32_t lwesp_timeout_id_t;
+
 /**
  * \ingroup         LWESP_TIMEOUT
  * \brief           Timeout structure
  */
 typedef struct lwesp_timeout {
-    struct lwesp_timeout* next;                 /*!< Pointer to next timeout entry */
-    uint32_t time;                              /*!< Time difference from previous entry */
+    struct lwesp_timeout* next;                 /*!< Pointer to next free timeout entry */
+    uint32_t time;                              /*!< Absolute time of expiry in units of milliseconds */
     void* arg;                                  /*!< Argument to pass to callback function */
     lwesp_timeout_fn fn;                        /*!< Callback function for timeout */
+    uint16_t pos;                               /*!< Position in timeout heap */
+    uint16_t gen;                               /*!< Generation counter to detect stale handles */
 } lwesp_timeout_t;
 
 /**
@@ -495,10 +639,15 @@ typedef struct {
                                                     Buffer is considered initialized when `buff != NULL` */
     size_t size;                                /*!< Size of buffer data. Size of actual buffer is
                                                         `1` byte less than this value */
-    size_t r;                                   /*!< Next read pointer. Buffer is considered empty
+    volatile size_t r;                          /*!< Next read pointer. Buffer is considered empty
                                                         when `r == w` and full when `w == r - 1` */
-    size_t w;                                   /*!< Next write pointer. Buffer is considered empty
+    volatile size_t w;                          /*!< Next write pointer. Buffer is considered empty
                                                         when `r == w` and full when `w == r - 1` */
+#if LWESP_CFG_BUFF_POW2 || __DOXYGEN__
+    size_t mask;                                /*!< Index mask when size is power of two, `0` otherwise.
+                                                    When set, `r` and `w` are free-running, buffer is
+                                                    empty when `r == w` and full when `w - r == size` */
+#endif /* LWESP_CFG_BUFF_POW2 || __DOXYGEN__ */
 } lwesp_buff_t;
 
 /**
@@ -519,6 +668,22 @@ typedef struct {
  */
 typedef void (*lwesp_api_cmd_evt_fn) (lwespr_t res, void* arg);
 
+/**
+ * \ingroup         LWESP_STA
+ * \brief           Function called for every access point found with \ref lwesp_sta_list_ap_stream
+ * \param[in]       ap: Access point information, valid only during function call.
+ *                      Fields not requested with scan are set to `0`
+ * \param[in]       arg: Custom user argument
+ * \return          `1` to continue, `0` to ignore all remaining access points of the scan
+ */
+typedef uint8_t (*lwesp_sta_list_ap_fn)(const lwesp_ap_t* ap, void* arg);
+
+/**
+ * \ingroup         LWESP_CONN
+ * \brief           Poll interval value to disable \ref LWESP_EVT_CONN_POLL event for connection
+ */
+#define LWESP_CONN_POLL_OFF                     ((uint32_t)0xFFFFFFFF)
+
 /**
  * \ingroup         LWESP_CONN
  * \brief           Connection start structure, used to start the connection in extended mode
@@ -528,10 +693,26 @@ typedef struct {
     const char* remote_host;                    /*!< Host name or IP address in string format */
     lwesp_port_t remote_port;                   /*!< Remote server port */
     const char* local_ip;                       /*!< Local IP. Optional parameter, set to NULL if not used (most cases) */
+    uint32_t poll_interval;                     /*!< Base interval of \ref LWESP_EVT_CONN_POLL event in units of milliseconds.
+                                                    Set to `0` to use \ref LWESP_CFG_CONN_POLL_INTERVAL,
+                                                    or to \ref LWESP_CONN_POLL_OFF to disable poll events */
+#if LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__
+    uint8_t passthrough;                        /*!< Set to `1` to start connection in passthrough mode.
+                                                    Check \ref LWESP_CFG_CONN_PASSTHROUGH for restrictions */
+#endif /* LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__ */
     union {
         struct {
             uint16_t keep_alive;                /*!< Keep alive parameter for TCP/SSL connection in units of seconds.
                                                     Value can be between `0 - 7200` where `0` means no keep alive */
+            uint16_t ssl_buff_size;             /*!< SSL buffer size on ESP8266, between `2048` and `4096` bytes.
+                                                    Set to `0` to keep current size. Command is only sent when size changes */
+            uint8_t ssl_cfg;                    /*!< Set to `1` to configure `ssl_auth_mode`, `ssl_pki_number`
+                                                    and `ssl_ca_number` for the link before connecting */
+            uint8_t ssl_auth_mode;              /*!< SSL authentication mode, check \ref lwesp_conn_ssl_set_config */
+            uint8_t ssl_pki_number;             /*!< Index of certificate and private key */
+            uint8_t ssl_ca_number;              /*!< Index of CA */
+            const char* ssl_sni;                /*!< Server name indication for the link, ESP32 only. Set to `NULL` if not used.
+                                                    String must stay valid until connection start command finishes */
         } tcp_ssl;                              /*!< TCP/SSL specific features */
         struct {
             lwesp_port_t local_port;            /*!< Custom local port for UDP */
@@ -540,6 +721,45 @@ typedef struct {
     } ext;                                      /*!< Extended support union */
 } lwesp_conn_start_t;
 
+/**
+ * \ingroup         LWESP_CONN
+ * \brief           Single data segment for scatter-gather send with \ref lwesp_conn_sendv
+ */
+typedef struct {
+    const void* data;                           /*!< Pointer to segment data */
+    size_t len;                                 /*!< Length of segment in units of bytes */
+} lwesp_conn_iov_t;
+
+/**
+ * \ingroup         LWESP_CONN
+ * \brief           Data source read function for \ref lwesp_conn_sendfile
+ * \param[in]       arg: Custom user argument
+ * \param[in]       offset: Offset of data to read in units of bytes. Data are always read in sequence
+ * \param[out]      buff: Connection send buffer to read data to
+ * \param[in]       btr: Number of bytes to read
+ * \return          Number of bytes read, `0` on read error
+ */
+typedef size_t (*lwesp_conn_read_fn)(void* arg, size_t offset, void* buff, size_t btr);
+
+#if LWESP_CFG_CONN_IPD_FILTER || __DOXYGEN__
+
+/**
+ * \ingroup         LWESP_CONN
+ * \brief           Filter function for received data, set with \ref lwesp_conn_set_ipd_filter
+ *
+ * Function is called from processing thread with core locked, it must not wait
+ *
+ * \param[in]       conn: Connection handle data were received on
+ * \param[in]       len: Number of bytes in received packet
+ * \param[in]       ip: Remote IP address of packet
+ * \param[in]       port: Remote port of packet
+ * \return          Number of bytes from start of packet to deliver to application.
+ *                  Return `len` to accept packet or `0` to drop it
+ */
+typedef size_t (*lwesp_conn_ipd_filter_fn)(lwesp_conn_p conn, size_t len, const lwesp_ip_t* ip, lwesp_port_t port);
+
+#endif /* LWESP_CFG_CONN_IPD_FILTER || __DOXYGEN__ */
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -48,6 +48,7 @@ extern "C" {
  */
 
 lwespr_t          lwespi_unicode_decode(lwesp_unicode_t* uni, uint8_t ch);
+size_t            lwespi_unicode_get_run_len(const uint8_t* d, size_t len);
 
 /**
  * \}
@@ -240,8 +240,14 @@ extern "C" {
 #define lwesp_i8_to_str(num, out)             lwesp_i32_to_gen_str(LWESP_I32(LWESP_I8(num)), (out))
 
 char*       lwesp_u32_to_gen_str(uint32_t num, char* out, uint8_t is_hex, uint8_t padding);
+size_t      lwesp_u32_to_dec_str(uint32_t num, char* out);
 char*       lwesp_i32_to_gen_str(int32_t num, char* out);
 
+#if LWESP_CFG_MEM_FAST_COPY || __DOXYGEN__
+void*       lwesp_memcpy(void* dst, const void* src, size_t len);
+void*       lwesp_memset(void* dst, int b, size_t len);
+#endif /* LWESP_CFG_MEM_FAST_COPY || __DOXYGEN__ */
+
 /**
  * \}
  */
@@ -49,6 +49,10 @@ extern "C" {
 lwespr_t    lwesp_ll_init(lwesp_ll_t* ll);
 lwespr_t    lwesp_ll_deinit(lwesp_ll_t* ll);
 
+#if LWESP_CFG_MEM_FAST_COPY_LL_LEN || __DOXYGEN__
+uint8_t     lwesp_ll_memcpy(void* dst, const void* src, size_t len);
+#endif /* LWESP_CFG_MEM_FAST_COPY_LL_LEN || __DOXYGEN__ */
+
 /**
  * \}
  */
@@ -133,6 +133,53 @@ uint8_t     lwesp_sys_thread_yield(void);
  * \}
  */
 
+#if LWESP_CFG_SYS_THREAD_NOTIFY || __DOXYGEN__
+
+/**
+ * \anchor          LWESP_SYS_THREAD_NOTIFY
+ * \name            Thread notifications
+ */
+
+uint8_t     lwesp_sys_thread_notify_get(lwesp_sys_thread_notify_t* n);
+uint32_t    lwesp_sys_thread_notify_wait(uint32_t timeout);
+uint8_t     lwesp_sys_thread_notify(lwesp_sys_thread_notify_t* n);
+
+/**
+ * \}
+ */
+
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY || __DOXYGEN__ */
+
+#if LWESP_CFG_SYS_THREAD_STACK_INFO || __DOXYGEN__
+
+/**
+ * \anchor          LWESP_SYS_THREAD_STACK_INFO
+ * \name            Thread stack information
+ */
+
+uint8_t     lwesp_sys_thread_stack_free(lwesp_sys_thread_t* t, size_t* free_ss);
+
+/**
+ * \}
+ */
+
+#endif /* LWESP_CFG_SYS_THREAD_STACK_INFO || __DOXYGEN__ */
+
+#if LWESP_CFG_SYS_NOW_US || __DOXYGEN__
+
+/**
+ * \anchor          LWESP_SYS_NOW_US
+ * \name            High-resolution time
+ */
+
+uint32_t    lwesp_sys_now_us(void);
+
+/**
+ * \}
+ */
+
+#endif /* LWESP_CFG_SYS_NOW_US || __DOXYGEN__ */
+
 /**
  * \}
  */
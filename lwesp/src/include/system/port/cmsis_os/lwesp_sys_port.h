@@ -50,6 +50,7 @@ typedef osSemaphoreId_t             lwesp_sys_sem_t;
 typedef osMessageQueueId_t          lwesp_sys_mbox_t;
 typedef osThreadId_t                lwesp_sys_thread_t;
 typedef osPriority_t                lwesp_sys_thread_prio_t;
+typedef osThreadId_t                lwesp_sys_thread_notify_t;
 
 #define LWESP_SYS_MUTEX_NULL          ((lwesp_sys_mutex_t)0)
 #define LWESP_SYS_SEM_NULL            ((lwesp_sys_sem_t)0)
@@ -57,6 +58,7 @@ typedef osPriority_t                lwesp_sys_thread_prio_t;
 #define LWESP_SYS_TIMEOUT             ((uint32_t)osWaitForever)
 #define LWESP_SYS_THREAD_PRIO         (osPriorityNormal)
 #define LWESP_SYS_THREAD_SS           (512)
+#define LWESP_SYS_THREAD_NOTIFY_FLAG  (0x00010000UL)
 
 #endif /* LWESP_CFG_OS && !__DOXYGEN__ */
 
@@ -53,6 +53,7 @@ typedef SemaphoreHandle_t           lwesp_sys_sem_t;
 typedef QueueHandle_t               lwesp_sys_mbox_t;
 typedef TaskHandle_t                lwesp_sys_thread_t;
 typedef UBaseType_t                 lwesp_sys_thread_prio_t;
+typedef TaskHandle_t                lwesp_sys_thread_notify_t;
 
 #define LWESP_SYS_MUTEX_NULL          ((SemaphoreHandle_t)0)
 #define LWESP_SYS_SEM_NULL            ((SemaphoreHandle_t)0)
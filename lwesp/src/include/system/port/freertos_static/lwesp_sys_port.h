@@ -0,0 +1,101 @@
+/**
+ * \file            lwesp_sys_port.h
+ * \brief           FreeRTOS native port with static allocation
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef LWESP_HDR_SYSTEM_PORT_H
+#define LWESP_HDR_SYSTEM_PORT_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "lwesp/lwesp_opt.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#if LWESP_CFG_OS && !__DOXYGEN__
+
+struct lwesp_sys_freertos_sem;
+
+typedef SemaphoreHandle_t           lwesp_sys_mutex_t;
+typedef struct lwesp_sys_freertos_sem* lwesp_sys_sem_t;
+typedef QueueHandle_t               lwesp_sys_mbox_t;
+typedef TaskHandle_t                lwesp_sys_thread_t;
+typedef UBaseType_t                 lwesp_sys_thread_prio_t;
+typedef TaskHandle_t                lwesp_sys_thread_notify_t;
+
+#define LWESP_SYS_MUTEX_NULL          ((SemaphoreHandle_t)0)
+#define LWESP_SYS_SEM_NULL            ((lwesp_sys_sem_t)0)
+#define LWESP_SYS_MBOX_NULL           ((QueueHandle_t)0)
+#define LWESP_SYS_TIMEOUT             ((TickType_t)portMAX_DELAY)
+#define LWESP_SYS_THREAD_PRIO         (configMAX_PRIORITIES - 1)
+#define LWESP_SYS_THREAD_SS           (1024)
+
+/* Number of statically allocated objects of each type */
+#ifndef LWESP_SYS_STATIC_MUTEX_COUNT
+#define LWESP_SYS_STATIC_MUTEX_COUNT  4
+#endif
+#ifndef LWESP_SYS_STATIC_SEM_COUNT
+#define LWESP_SYS_STATIC_SEM_COUNT    (8 + LWESP_CFG_MSG_POOL_SIZE)
+#endif
+#ifndef LWESP_SYS_STATIC_MBOX_COUNT
+#define LWESP_SYS_STATIC_MBOX_COUNT   (3 + 2 * LWESP_CFG_MAX_CONNS)
+#endif
+#ifndef LWESP_SYS_STATIC_MBOX_LEN
+#define LWESP_SYS_STATIC_MBOX_LEN     16    /* Maximal number of entries in one message box */
+#endif
+#ifndef LWESP_SYS_STATIC_THREAD_COUNT
+#define LWESP_SYS_STATIC_THREAD_COUNT 2
+#endif
+
+/* Index of task notification used by semaphores and thread notifications */
+#ifndef LWESP_SYS_NOTIFY_INDEX
+#define LWESP_SYS_NOTIFY_INDEX        1
+#endif
+
+#if configSUPPORT_STATIC_ALLOCATION == 0
+#error "configSUPPORT_STATIC_ALLOCATION must be enabled for static FreeRTOS port"
+#endif
+#if !defined(configTASK_NOTIFICATION_ARRAY_ENTRIES) || configTASK_NOTIFICATION_ARRAY_ENTRIES <= LWESP_SYS_NOTIFY_INDEX
+#error "configTASK_NOTIFICATION_ARRAY_ENTRIES must be greater than LWESP_SYS_NOTIFY_INDEX"
+#endif
+
+#endif /* LWESP_CFG_OS && !__DOXYGEN__ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* LWESP_HDR_SYSTEM_PORT_H */
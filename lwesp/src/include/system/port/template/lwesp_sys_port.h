@@ -84,6 +84,13 @@ typedef osThreadId_t        lwesp_sys_thread_t;
  */
 typedef osPriority          lwesp_sys_thread_prio_t;
 
+/**
+ * \brief           Thread notification handle type
+ *
+ * It identifies thread to notify with \ref lwesp_sys_thread_notify.
+ */
+typedef osThreadId_t        lwesp_sys_thread_notify_t;
+
 /**
  * \brief           Mutex invalid value
  *
@@ -128,6 +135,11 @@ typedef osPriority          lwesp_sys_thread_prio_t;
  */
 #define LWESP_SYS_THREAD_SS           (1024)
 
+/**
+ * \brief           Signal flag used for thread notifications
+ */
+#define LWESP_SYS_THREAD_NOTIFY_FLAG  (0x01)
+
 #endif /* LWESP_CFG_OS || __DOXYGEN__ */
 
 /**
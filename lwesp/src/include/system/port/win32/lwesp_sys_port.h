@@ -50,6 +50,7 @@ typedef HANDLE                      lwesp_sys_sem_t;
 typedef HANDLE                      lwesp_sys_mbox_t;
 typedef HANDLE                      lwesp_sys_thread_t;
 typedef int                         lwesp_sys_thread_prio_t;
+typedef HANDLE                      lwesp_sys_thread_notify_t;
 
 #define LWESP_SYS_MBOX_NULL           ((HANDLE)0)
 #define LWESP_SYS_SEM_NULL            ((HANDLE)0)
@@ -47,9 +47,34 @@
 
 static lwespr_t           def_callback(lwesp_evt_t* evt);
 static lwesp_evt_func_t   def_evt_link;
+#if LWESP_CFG_STATIC_ONLY && !LWESP_CFG_INPUT_USE_PROCESS
+static uint8_t            rcv_buff_mem[LWESP_CFG_RCV_BUFF_SIZE];
+#endif /* LWESP_CFG_STATIC_ONLY && !LWESP_CFG_INPUT_USE_PROCESS */
 
 lwesp_t esp;
 
+#if LWESP_CFG_RUNTIME_PARAMS
+
+/**
+ * \brief           Default value and bounds of performance parameter
+ */
+typedef struct {
+    uint32_t def;                               /*!< Default value, set on init */
+    uint32_t min;                               /*!< Minimal accepted value */
+    uint32_t max;                               /*!< Maximal accepted value */
+} lwesp_param_desc_t;
+
+static const lwesp_param_desc_t
+params_desc[LWESP_PARAM_END] = {
+    [LWESP_PARAM_CONN_POLL_INTERVAL] = {LWESP_CFG_CONN_POLL_INTERVAL, 10, 3600000},
+    [LWESP_PARAM_CONN_MAX_DATA_LEN] = {LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT, 1, LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT},
+    [LWESP_PARAM_MAX_SEND_RETRIES] = {LWESP_CFG_MAX_SEND_RETRIES, 1, 255},
+    [LWESP_PARAM_CONN_MAX_RECV_BUFF_SIZE] = {LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE, LWESP_MIN(64, LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE), LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE},
+    [LWESP_PARAM_CONN_SEND_TIMEOUT] = {LWESP_CFG_CONN_SEND_TIMEOUT, 100, 3600000},
+};
+
+#endif /* LWESP_CFG_RUNTIME_PARAMS */
+
 /**
  * \brief           Default callback function for events
  * \param[in]       evt: Pointer to callback data structure
@@ -81,9 +106,16 @@ lwesp_init(lwesp_evt_fn evt_func, const uint32_t blocking) {
     esp.status.f.initialized = 0;               /* Clear possible init flag */
 
     def_evt_link.fn = evt_func != NULL ? evt_func : def_callback;
+    def_evt_link.mask = LWESP_EVT_MASK_ALL;
+    esp.evt_dispatch_dirty = 1;
     esp.evt_func = &def_evt_link;               /* Set callback function */
 
     esp.evt_server = NULL;                      /* Set default server callback function */
+#if LWESP_CFG_RUNTIME_PARAMS
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(params_desc); ++i) {
+        esp.params[i] = params_desc[i].def;     /* Start with compile time values */
+    }
+#endif /* LWESP_CFG_RUNTIME_PARAMS */
 
     if (!lwesp_sys_init()) {                    /* Init low-level system */
         goto cleanup;
@@ -106,17 +138,34 @@ lwesp_init(lwesp_evt_fn evt_func, const uint32_t blocking) {
                    "[CORE] Cannot allocate process mbox queue!\r\n");
         goto cleanup;
     }
+#if LWESP_CFG_EVT_DEFERRED
+    if (!lwesp_sys_mbox_create(&esp.mbox_evt_deferred, LWESP_CFG_EVT_DEFERRED_QUEUE_LEN)) {
+        LWESP_DEBUGF(LWESP_CFG_DBG_INIT | LWESP_DBG_LVL_SEVERE | LWESP_DBG_TYPE_TRACE,
+                   "[CORE] Cannot allocate deferred events mbox queue!\r\n");
+        goto cleanup;
+    }
+#endif /* LWESP_CFG_EVT_DEFERRED */
+#if LWESP_CFG_CONN_EVT_WORKERS > 0
+    for (size_t i = 0; i < LWESP_CFG_CONN_EVT_WORKERS; ++i) {
+        if (!lwesp_sys_mbox_create(&esp.mbox_conn_evt[i], LWESP_CFG_CONN_EVT_WORKER_QUEUE_LEN)) {
+            LWESP_DEBUGF(LWESP_CFG_DBG_INIT | LWESP_DBG_LVL_SEVERE | LWESP_DBG_TYPE_TRACE,
+                       "[CORE] Cannot allocate connection event worker mbox queue!\r\n");
+            goto cleanup;
+        }
+    }
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > 0 */
 
+#if !LWESP_CFG_POLL
     /* Create threads */
     lwesp_sys_sem_wait(&esp.sem_sync, 0);       /* Lock semaphore */
-    if (!lwesp_sys_thread_create(&esp.thread_produce, "lwesp_produce", lwesp_thread_produce, &esp.sem_sync, LWESP_SYS_THREAD_SS, LWESP_SYS_THREAD_PRIO)) {
+    if (!lwesp_sys_thread_create(&esp.thread_produce, "lwesp_produce", lwesp_thread_produce, &esp.sem_sync, LWESP_CFG_THREAD_PRODUCER_SS, LWESP_CFG_THREAD_PRODUCER_PRIO)) {
         LWESP_DEBUGF(LWESP_CFG_DBG_INIT | LWESP_DBG_LVL_SEVERE | LWESP_DBG_TYPE_TRACE,
                    "[CORE] Cannot create producing thread!\r\n");
         lwesp_sys_sem_release(&esp.sem_sync);   /* Release semaphore and return */
         goto cleanup;
     }
     lwesp_sys_sem_wait(&esp.sem_sync, 0);       /* Wait semaphore, should be unlocked in process thread */
-    if (!lwesp_sys_thread_create(&esp.thread_process, "lwesp_process", lwesp_thread_process, &esp.sem_sync, LWESP_SYS_THREAD_SS, LWESP_SYS_THREAD_PRIO)) {
+    if (!lwesp_sys_thread_create(&esp.thread_process, "lwesp_process", lwesp_thread_process, &esp.sem_sync, LWESP_CFG_THREAD_PROCESS_SS, LWESP_CFG_THREAD_PROCESS_PRIO)) {
         LWESP_DEBUGF(LWESP_CFG_DBG_INIT | LWESP_DBG_LVL_SEVERE | LWESP_DBG_TYPE_TRACE,
                    "[CORE] Cannot create processing thread!\r\n");
         lwesp_sys_thread_terminate(&esp.thread_produce);/* Delete produce thread */
@@ -125,13 +174,32 @@ lwesp_init(lwesp_evt_fn evt_func, const uint32_t blocking) {
     }
     lwesp_sys_sem_wait(&esp.sem_sync, 0);       /* Wait semaphore, should be unlocked in produce thread */
     lwesp_sys_sem_release(&esp.sem_sync);       /* Release semaphore manually */
+#if LWESP_CFG_CONN_EVT_WORKERS > 0
+    for (size_t i = 0; i < LWESP_CFG_CONN_EVT_WORKERS; ++i) {
+        if (!lwesp_sys_thread_create(&esp.thread_conn_evt[i], "lwesp_conn_evt", lwesp_thread_conn_evt, &esp.mbox_conn_evt[i], LWESP_CFG_THREAD_PROCESS_SS, LWESP_CFG_THREAD_PROCESS_PRIO)) {
+            LWESP_DEBUGF(LWESP_CFG_DBG_INIT | LWESP_DBG_LVL_SEVERE | LWESP_DBG_TYPE_TRACE,
+                       "[CORE] Cannot create connection event worker thread!\r\n");
+            while (i-- > 0) {
+                lwesp_sys_thread_terminate(&esp.thread_conn_evt[i]);
+            }
+            lwesp_sys_thread_terminate(&esp.thread_process);
+            lwesp_sys_thread_terminate(&esp.thread_produce);
+            goto cleanup;
+        }
+    }
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > 0 */
+#endif /* !LWESP_CFG_POLL */
 
     lwesp_core_lock();
     esp.ll.uart.baudrate = LWESP_CFG_AT_PORT_BAUDRATE;  /* Set default baudrate value */
     lwesp_ll_init(&esp.ll);                     /* Init low-level communication */
 
 #if !LWESP_CFG_INPUT_USE_PROCESS
+#if LWESP_CFG_STATIC_ONLY
+    lwesp_buff_init_mem(&esp.buff, rcv_buff_mem, sizeof(rcv_buff_mem));
+#else /* LWESP_CFG_STATIC_ONLY */
     lwesp_buff_init(&esp.buff, LWESP_CFG_RCV_BUFF_SIZE);/* Init buffer for input data */
+#endif /* !LWESP_CFG_STATIC_ONLY */
 #endif /* !LWESP_CFG_INPUT_USE_PROCESS */
 
     esp.status.f.initialized = 1;               /* We are initialized now */
@@ -155,10 +223,21 @@ lwesp_init(lwesp_evt_fn evt_func, const uint32_t blocking) {
 #if LWESP_CFG_RESET_ON_INIT
     if (esp.status.f.dev_present) {
         lwesp_core_unlock();
+#if LWESP_CFG_WARM_INIT
+        res = lwesp_reset_warm(NULL, NULL, blocking);   /* Skip configuration if device is already configured */
+#else /* LWESP_CFG_WARM_INIT */
         res = lwesp_reset_with_delay(LWESP_CFG_RESET_DELAY_DEFAULT, NULL, NULL, blocking);  /* Send reset sequence with delay */
+#endif /* !LWESP_CFG_WARM_INIT */
         lwesp_core_lock();
     }
 #endif /* LWESP_CFG_RESET_ON_INIT */
+#if LWESP_CFG_AT_PORT_AUTOBAUD
+    if (res == lwespOK && esp.status.f.dev_present) {
+        lwesp_core_unlock();
+        res = lwesp_set_at_baudrate_auto(NULL, NULL, blocking); /* Move to highest stable baudrate */
+        lwesp_core_lock();
+    }
+#endif /* LWESP_CFG_AT_PORT_AUTOBAUD */
     LWESP_UNUSED(blocking);                     /* Prevent compiler warnings */
     lwesp_core_unlock();
 
@@ -173,6 +252,20 @@ cleanup:
         lwesp_sys_mbox_delete(&esp.mbox_process);
         lwesp_sys_mbox_invalid(&esp.mbox_process);
     }
+#if LWESP_CFG_EVT_DEFERRED
+    if (lwesp_sys_mbox_isvalid(&esp.mbox_evt_deferred)) {
+        lwesp_sys_mbox_delete(&esp.mbox_evt_deferred);
+        lwesp_sys_mbox_invalid(&esp.mbox_evt_deferred);
+    }
+#endif /* LWESP_CFG_EVT_DEFERRED */
+#if LWESP_CFG_CONN_EVT_WORKERS > 0
+    for (size_t i = 0; i < LWESP_CFG_CONN_EVT_WORKERS; ++i) {
+        if (lwesp_sys_mbox_isvalid(&esp.mbox_conn_evt[i])) {
+            lwesp_sys_mbox_delete(&esp.mbox_conn_evt[i]);
+            lwesp_sys_mbox_invalid(&esp.mbox_conn_evt[i]);
+        }
+    }
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > 0 */
     if (lwesp_sys_sem_isvalid(&esp.sem_sync)) {
         lwesp_sys_sem_delete(&esp.sem_sync);
         lwesp_sys_sem_invalid(&esp.sem_sync);
@@ -213,6 +306,35 @@ lwesp_reset_with_delay(uint32_t delay,
     return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 5000);
 }
 
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+
+/**
+ * \brief           Execute warm init of already configured device
+ *
+ * Device is not reset when cached state from \ref lwesp_ll_t.warm_state_fn matches firmware
+ * version and library configuration and device was not restarted since.
+ * Only configuration that differs on device is sent and device state is read then.
+ * Otherwise it falls back to full reset sequence, same as \ref lwesp_reset.
+ *
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_reset_warm(const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWESP_MSG_VAR_DEFINE(msg);
+
+    LWESP_MSG_VAR_ALLOC(msg, blocking);
+    LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_RESET;
+    LWESP_MSG_VAR_REF(msg).msg.reset.warm = 1;
+
+    return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 5000);
+}
+
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
+
 /**
  * \brief           Execute restore command and set module to default values
  * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
@@ -299,6 +421,31 @@ lwesp_set_at_baudrate(uint32_t baud,
     return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 2000);
 }
 
+/**
+ * \brief           Negotiate highest stable baudrate of AT port (usually UART)
+ *
+ * Candidates from \ref LWESP_CFG_AT_PORT_AUTOBAUD_RATES, higher than current baudrate and
+ * not higher than \ref lwesp_ll_t.uart `max_baudrate`, are tried from highest to lowest.
+ * Each one is set with `AT+UART_CUR`, low-level layer is reconfigured and link is verified with `AT` command.
+ * When verification fails, device and host go back to last verified baudrate and next candidate is tried.
+ *
+ * \note            Baudrate is not stored in device and is lost after device reset
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_set_at_baudrate_auto(const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWESP_MSG_VAR_DEFINE(msg);
+
+    LWESP_MSG_VAR_ALLOC(msg, blocking);
+    LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_UART_AUTOBAUD;
+
+    return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 10000);
+}
+
 /**
  * \brief           Enables or disables server mode
  * \param[in]       en: Set to `1` to enable server, `0` otherwise
@@ -391,6 +538,139 @@ lwesp_core_unlock(void) {
     return lwespOK;
 }
 
+/**
+ * \brief           Start recording batch of API commands
+ *
+ * All API commands called after this function and before \ref lwesp_batch_submit
+ * are not sent to producer queue, but appended to the batch.
+ * They are later submitted with single queue write and executed back-to-back by producer thread.
+ *
+ * \note            Stack stays locked until \ref lwesp_batch_submit is called, to prevent
+ *                  commands from other threads being recorded to the batch.
+ *                  Function must always be followed by \ref lwesp_batch_submit from the same thread
+ * \note            Commands are recorded as non-blocking, `blocking` parameter of API functions is ignored
+ *                  and their output parameters must stay valid until batch completes
+ *
+ * \param[in]       batch: Batch handle to record commands to
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_batch_begin(lwesp_batch_t* batch) {
+    LWESP_ASSERT("batch != NULL", batch != NULL);
+
+    lwesp_core_lock();
+    if (esp.batch != NULL) {                    /* Nested batches are not allowed */
+        lwesp_core_unlock();
+        return lwespERR;
+    }
+    LWESP_MEMSET(batch, 0x00, sizeof(*batch));
+#if LWESP_CFG_CMD_CANCEL
+    if (++esp.cmd_id_next == 0) {               /* `0` is reserved for commands without batch */
+        ++esp.cmd_id_next;
+    }
+    batch->id = esp.cmd_id_next;
+#endif /* LWESP_CFG_CMD_CANCEL */
+    esp.batch = batch;
+    return lwespOK;                             /* Stack stays locked until batch is submitted */
+}
+
+/**
+ * \brief           Submit recorded batch of API commands to producer thread
+ *
+ * Commands are executed in recorded order. When one of them fails,
+ * remaining commands are not executed and report the same error.
+ *
+ * \param[in]       batch: Batch handle, previously started with \ref lwesp_batch_begin
+ * \param[in]       evt_fn: Callback function called when last command has finished
+ *                      or when batch failed. Result is first error or \ref lwespOK. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_batch_submit(lwesp_batch_t* batch,
+                   const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    lwesp_msg_t* last;
+
+    LWESP_ASSERT("batch != NULL", batch != NULL);
+
+    if (esp.batch != batch) {                   /* Batch was not started, stack is not locked by it */
+        return lwespERR;
+    }
+    esp.batch = NULL;
+    last = batch->last;
+    if (last != NULL) {
+        LWESP_MSG_VAR_SET_EVT(last, evt_fn, evt_arg);
+        last->is_blocking = LWESP_U8(blocking > 0);
+    }
+#if LWESP_CFG_CMD_CANCEL
+    for (lwesp_msg_t* m = batch->first; m != NULL; m = m->batch_next) {
+        m->cmd_id = batch->id;
+        m->deadline = batch->deadline;
+    }
+#endif /* LWESP_CFG_CMD_CANCEL */
+    lwesp_core_unlock();                        /* Unlock stack, locked by begin function */
+
+    if (last == NULL) {                         /* Empty batch */
+        return lwespOK;
+    }
+    return lwespi_send_batch_to_producer_mbox(batch->first, last);
+}
+
+#if LWESP_CFG_CMD_CANCEL || __DOXYGEN__
+
+/**
+ * \brief           Set deadline for commands in batch
+ *
+ * Commands not started within `timeout` from now fail with \ref lwespTIMEOUT
+ * and are not sent to device. Command already started is not affected.
+ *
+ * \note            Function must be called between \ref lwesp_batch_begin and \ref lwesp_batch_submit
+ * \param[in]       batch: Batch handle
+ * \param[in]       timeout: Maximal time from now for commands to start, in units of milliseconds.
+ *                      Set to `0` to disable deadline
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_batch_set_deadline(lwesp_batch_t* batch, uint32_t timeout) {
+    LWESP_ASSERT("batch != NULL", batch != NULL);
+
+    if (esp.batch != batch) {                   /* Batch was not started */
+        return lwespERR;
+    }
+    batch->deadline = timeout > 0 ? lwesp_sys_now() + timeout : 0;
+    if (timeout > 0 && batch->deadline == 0) {
+        batch->deadline = 1;                    /* `0` means no deadline */
+    }
+    return lwespOK;
+}
+
+/**
+ * \brief           Cancel commands of submitted batch, not yet started
+ *
+ * Cancelled commands fail with \ref lwespERRCANCELLED when producer thread takes them from queue,
+ * without being sent to device. Command already in progress is not affected
+ * and cancel request is ignored once batch has completed.
+ *
+ * \note            Up to \ref LWESP_CFG_CMD_CANCEL_SLOTS cancel requests may be pending at a time,
+ *                  oldest request is forgotten afterwards
+ * \param[in]       batch: Batch handle used as command handle, previously submitted with \ref lwesp_batch_submit
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_cmd_cancel(const lwesp_batch_t* batch) {
+    LWESP_ASSERT("batch != NULL", batch != NULL);
+    LWESP_ASSERT("batch->id > 0", batch->id > 0);
+
+    lwesp_core_lock();
+    esp.cmd_cancel[esp.cmd_cancel_idx] = batch->id;
+    esp.cmd_cancel_idx = (uint8_t)((esp.cmd_cancel_idx + 1) % LWESP_CFG_CMD_CANCEL_SLOTS);
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_CMD_CANCEL || __DOXYGEN__ */
+
 /**
  * \brief           Notify stack if device is present or not
  *
@@ -503,6 +783,12 @@ lwesp_get_current_at_fw_version(lwesp_sw_version_t* const version) {
  */
 uint8_t
 lwesp_delay(const uint32_t ms) {
+#if LWESP_CFG_POLL
+    uint32_t start = lwesp_sys_now();
+
+    while ((lwesp_sys_now() - start) < ms) {}   /* Nothing else may run in cooperative mode */
+    return 1;
+#else /* LWESP_CFG_POLL */
     lwesp_sys_sem_t sem;
     if (ms == 0) {
         return 1;
@@ -514,4 +800,198 @@ lwesp_delay(const uint32_t ms) {
         return 1;
     }
     return 0;
+#endif /* !LWESP_CFG_POLL */
 }
+
+/**
+ * \brief           Wait for stack to reach state
+ *
+ * Thread is woken up from event processing as soon as state changes,
+ * without polling state with \ref lwesp_delay
+ *
+ * \code{c}
+ * if (lwesp_wait_for(LWESP_STATE_HAS_IP, 10000) == lwespOK) {
+ *     // Station is connected and has IP
+ * }
+ * \endcode
+ *
+ * \param[in]       flags: Bitwise OR of \ref lwesp_state_t flags, all must be set
+ * \param[in]       timeout: Maximal time to wait in units of milliseconds.
+ *                      Set to `0` to wait forever
+ * \return          \ref lwespOK when state is reached, \ref lwespTIMEOUT on timeout,
+ *                      member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_wait_for(uint32_t flags, uint32_t timeout) {
+    lwespr_t res = lwespOK;
+#if LWESP_CFG_POLL
+    uint32_t start = lwesp_sys_now();
+
+    LWESP_ASSERT("flags != 0", flags != 0);
+
+    /* Nothing else may run in cooperative mode, stack is processed while waiting */
+    while ((lwespi_get_state() & flags) != flags) {
+        if (timeout > 0 && (lwesp_sys_now() - start) >= timeout) {
+            res = lwespTIMEOUT;
+            break;
+        }
+        lwesp_poll();
+    }
+#else /* LWESP_CFG_POLL */
+    lwesp_state_waiter_t w;
+    uint32_t time;
+
+    LWESP_ASSERT("flags != 0", flags != 0);
+
+    lwesp_core_lock();
+    if ((lwespi_get_state() & flags) != flags) {
+        if (lwesp_sys_sem_create(&w.sem, 0)) {
+            w.flags = flags;
+            w.next = esp.state_waiters;
+            esp.state_waiters = &w;
+            lwesp_core_unlock();
+            time = lwesp_sys_sem_wait(&w.sem, timeout);
+            lwesp_core_lock();
+            if (time == LWESP_SYS_TIMEOUT) {
+                /* Remove from list, unless state was reached just after timeout */
+                for (lwesp_state_waiter_t** l = &esp.state_waiters; *l != NULL; l = &(*l)->next) {
+                    if (*l == &w) {
+                        *l = w.next;
+                        res = lwespTIMEOUT;
+                        break;
+                    }
+                }
+            }
+            lwesp_sys_sem_delete(&w.sem);
+        } else {
+            res = lwespERRMEM;
+        }
+    }
+    lwesp_core_unlock();
+#endif /* !LWESP_CFG_POLL */
+    return res;
+}
+
+#if LWESP_CFG_STATIC_ONLY || __DOXYGEN__
+
+/**
+ * \brief           Get total size of static pools used by stack core
+ *
+ * Includes command messages, packet buffers, timeouts, connection write buffers,
+ * event functions, deferred events, connection event worker queues and input buffer.
+ * Netconn and MQTT client pools are part of their modules and are not included
+ *
+ * \return          Size in units of bytes
+ */
+size_t
+lwesp_get_static_ram_size(void) {
+    size_t size = 0;
+
+    size += LWESP_CFG_MSG_POOL_SIZE * (sizeof(lwesp_msg_t) + sizeof(lwesp_msg_t*));
+#if LWESP_CFG_MSG_POOL_SMALL_SIZE > 0
+    size += LWESP_CFG_MSG_POOL_SMALL_SIZE * (offsetof(lwesp_msg_t, msg) + LWESP_CFG_MSG_SMALL_PAYLOAD_LEN + sizeof(lwesp_msg_t*));
+#endif /* LWESP_CFG_MSG_POOL_SMALL_SIZE > 0 */
+    size += lwespi_pbuf_get_static_ram_size();
+    size += LWESP_CFG_TIMEOUT_POOL_SIZE * (sizeof(lwesp_timeout_t) + sizeof(lwesp_timeout_t*));
+    size += LWESP_CFG_CONN_BUFF_POOL_SIZE * (LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT + sizeof(uint8_t*));
+    size += LWESP_CFG_EVT_FUNC_POOL_SIZE * sizeof(lwesp_evt_func_t);
+    size += LWESP_CFG_AT_CMD_BUFF_LEN;
+    size += LWESP_CFG_RECV_LINE_BUFF_LEN;
+#if LWESP_CFG_EVT_DEFERRED
+    size += LWESP_CFG_EVT_DEFERRED_QUEUE_LEN * (sizeof(lwesp_evt_deferred_t) + sizeof(lwesp_evt_deferred_t*));
+#endif /* LWESP_CFG_EVT_DEFERRED */
+#if LWESP_CFG_CONN_EVT_WORKERS > 0
+    size += LWESP_CFG_CONN_EVT_WORKERS * LWESP_CFG_CONN_EVT_WORKER_QUEUE_LEN * (sizeof(lwesp_conn_evt_work_t) + sizeof(lwesp_conn_evt_work_t*));
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > 0 */
+#if !LWESP_CFG_INPUT_USE_PROCESS
+    size += sizeof(rcv_buff_mem);
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+#if LWESP_CFG_CAPTURE
+    size += LWESP_CFG_CAPTURE_BUFF_SIZE;
+#endif /* LWESP_CFG_CAPTURE */
+    return size;
+}
+
+#endif /* LWESP_CFG_STATIC_ONLY || __DOXYGEN__ */
+
+#if LWESP_CFG_SYS_THREAD_STACK_INFO || __DOXYGEN__
+
+/**
+ * \brief           Get lowest free stack of stack threads since they were started
+ *
+ * Values are in units of system port stack size, same as \ref LWESP_CFG_THREAD_PRODUCER_SS
+ * and \ref LWESP_CFG_THREAD_PROCESS_SS
+ *
+ * \param[out]      producer: Pointer to output variable for producer thread. Set to `NULL` if not used
+ * \param[out]      process: Pointer to output variable for process thread. Set to `NULL` if not used
+ * \return          \ref lwespOK on success, \ref lwespERR when threads do not exist
+ *                      or system port cannot report stack usage
+ */
+lwespr_t
+lwesp_get_thread_stack_free(size_t* producer, size_t* process) {
+#if LWESP_CFG_POLL
+    LWESP_UNUSED(producer);
+    LWESP_UNUSED(process);
+    return lwespERR;                            /* Stack runs in caller threads */
+#else /* LWESP_CFG_POLL */
+    size_t ss;
+
+    if (!esp.status.f.initialized) {
+        return lwespERR;
+    }
+    if (producer != NULL) {
+        if (!lwesp_sys_thread_stack_free(&esp.thread_produce, &ss)) {
+            return lwespERR;
+        }
+        *producer = ss;
+    }
+    if (process != NULL) {
+        if (!lwesp_sys_thread_stack_free(&esp.thread_process, &ss)) {
+            return lwespERR;
+        }
+        *process = ss;
+    }
+    return lwespOK;
+#endif /* !LWESP_CFG_POLL */
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_STACK_INFO || __DOXYGEN__ */
+
+#if LWESP_CFG_RUNTIME_PARAMS || __DOXYGEN__
+
+/**
+ * \brief           Set performance parameter at runtime
+ *
+ * New value applies to commands started after the call, connection poll interval
+ * applies to connections started after the call and to connections without own interval
+ *
+ * \param[in]       param: Parameter to set, member of \ref lwesp_param_t enumeration
+ * \param[in]       value: New value. It must be within bounds of parameter
+ * \return          \ref lwespOK on success, \ref lwespPARERR for unknown parameter or value out of bounds
+ */
+lwespr_t
+lwesp_set_param(lwesp_param_t param, uint32_t value) {
+    if ((size_t)param >= LWESP_ARRAYSIZE(params_desc)
+        || value < params_desc[param].min || value > params_desc[param].max) {
+        return lwespPARERR;
+    }
+    lwesp_core_lock();
+    esp.params[param] = value;
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+/**
+ * \brief           Get current value of performance parameter
+ * \param[in]       param: Parameter to read, member of \ref lwesp_param_t enumeration
+ * \return          Parameter value, `0` for unknown parameter
+ */
+uint32_t
+lwesp_get_param(lwesp_param_t param) {
+    if ((size_t)param >= LWESP_ARRAYSIZE(params_desc)) {
+        return 0;
+    }
+    return esp.params[param];
+}
+
+#endif /* LWESP_CFG_RUNTIME_PARAMS || __DOXYGEN__ */
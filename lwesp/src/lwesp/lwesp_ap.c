@@ -39,6 +39,7 @@
 
 /**
  * \brief           Get IP of access point
+ * \note            With \ref LWESP_CFG_IP_MAC_CACHE enabled, cached value is returned when valid
  * \param[out]      ip: Pointer to variable to write IP address
  * \param[out]      gw: Pointer to variable to write gateway address
  * \param[out]      nm: Pointer to variable to write netmask address
@@ -52,6 +53,12 @@ lwesp_ap_getip(lwesp_ip_t* ip, lwesp_ip_t* gw, lwesp_ip_t* nm,
              const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
     LWESP_MSG_VAR_DEFINE(msg);
 
+#if LWESP_CFG_IP_MAC_CACHE
+    if (lwespi_ip_mac_cache_get_ip(&esp.m.ap, ip, gw, nm, evt_fn, evt_arg)) {
+        return lwespOK;
+    }
+#endif /* LWESP_CFG_IP_MAC_CACHE */
+
     LWESP_MSG_VAR_ALLOC(msg, blocking);
     LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_WIFI_CIPAP_GET;
@@ -94,6 +101,7 @@ lwesp_ap_setip(const lwesp_ip_t* ip, const lwesp_ip_t* gw, const lwesp_ip_t* nm,
 
 /**
  * \brief           Get MAC of access point
+ * \note            With \ref LWESP_CFG_IP_MAC_CACHE enabled, cached value is returned when valid
  * \param[out]      mac: Pointer to output variable to save MAC address
  * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
  * \param[in]       evt_arg: Custom argument for event callback function
@@ -105,6 +113,12 @@ lwesp_ap_getmac(lwesp_mac_t* mac,
               const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
     LWESP_MSG_VAR_DEFINE(msg);
 
+#if LWESP_CFG_IP_MAC_CACHE
+    if (lwespi_ip_mac_cache_get_mac(&esp.m.ap, mac, evt_fn, evt_arg)) {
+        return lwespOK;
+    }
+#endif /* LWESP_CFG_IP_MAC_CACHE */
+
     LWESP_MSG_VAR_ALLOC(msg, blocking);
     LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_WIFI_CIPAPMAC_GET;
@@ -262,4 +276,158 @@ lwesp_ap_disconn_sta(const lwesp_mac_t* mac,
     return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 1000);
 }
 
+#if LWESP_CFG_AP_STA_TABLE > 0 || __DOXYGEN__
+
+/**
+ * \brief           Find station in local table
+ * \note            Function must be called with core locked
+ * \param[in]       mac: MAC address of station
+ * \return          Index of station, or number of stations in table when not found
+ */
+static size_t
+ap_sta_table_find(const lwesp_mac_t* mac) {
+    size_t i;
+
+    for (i = 0; i < esp.m.ap_stas_cnt; ++i) {
+        if (!memcmp(&esp.m.ap_stas[i].mac, mac, sizeof(*mac))) {
+            break;
+        }
+    }
+    return i;
+}
+
+/**
+ * \brief           Add station to local table or update its IP address
+ * \note            Function must be called with core locked
+ * \param[in]       mac: MAC address of station
+ * \param[in]       ip: IP address of station. Set to `NULL` when not known yet
+ */
+void
+lwespi_ap_sta_table_set(const lwesp_mac_t* mac, const lwesp_ip_t* ip) {
+    size_t i = ap_sta_table_find(mac);
+
+    if (i == esp.m.ap_stas_cnt) {
+        if (i == LWESP_ARRAYSIZE(esp.m.ap_stas)) {
+            return;                             /* Table is full, station is not tracked */
+        }
+        LWESP_MEMSET(&esp.m.ap_stas[i], 0x00, sizeof(esp.m.ap_stas[i]));
+        LWESP_MEMCPY(&esp.m.ap_stas[i].mac, mac, sizeof(*mac));
+        ++esp.m.ap_stas_cnt;
+    }
+    if (ip != NULL) {
+        LWESP_MEMCPY(&esp.m.ap_stas[i].ip, ip, sizeof(*ip));
+    }
+    esp.m.ap_stas_seen[i] = 1;
+}
+
+/**
+ * \brief           Remove station from local table
+ * \note            Function must be called with core locked
+ * \param[in]       mac: MAC address of station
+ */
+void
+lwespi_ap_sta_table_remove(const lwesp_mac_t* mac) {
+    size_t i = ap_sta_table_find(mac);
+
+    if (i < esp.m.ap_stas_cnt) {                /* Move last entry to its place to keep table packed */
+        --esp.m.ap_stas_cnt;
+        esp.m.ap_stas[i] = esp.m.ap_stas[esp.m.ap_stas_cnt];
+        esp.m.ap_stas_seen[i] = esp.m.ap_stas_seen[esp.m.ap_stas_cnt];
+    }
+}
+
+/**
+ * \brief           Start reconciliation of local table with `AT+CWLIF` response
+ * \note            Function must be called with core locked
+ */
+void
+lwespi_ap_sta_table_sync_start(void) {
+    LWESP_MEMSET(esp.m.ap_stas_seen, 0x00, sizeof(esp.m.ap_stas_seen));
+}
+
+/**
+ * \brief           Finish reconciliation and remove stations not reported since start
+ * \note            Function must be called with core locked
+ */
+void
+lwespi_ap_sta_table_sync_done(void) {
+    for (size_t i = esp.m.ap_stas_cnt; i > 0; --i) {
+        if (!esp.m.ap_stas_seen[i - 1]) {
+            lwespi_ap_sta_table_remove(&esp.m.ap_stas[i - 1].mac);
+        }
+    }
+}
+
+/**
+ * \brief           Get stations connected to access point from local table
+ *
+ * Function reads table maintained from device messages and does not send any command.
+ * IP address is all zeros until device assigns one to the station.
+ *
+ * \param[out]      sta: Pointer to array to fill with stations. Set to `NULL` to only get number of stations
+ * \param[in]       stal: Number of array entries of sta parameter
+ * \return          Number of stations in table, may be greater than `stal`
+ */
+size_t
+lwesp_ap_sta_table_get(lwesp_sta_t* sta, size_t stal) {
+    size_t cnt;
+
+    lwesp_core_lock();
+    cnt = esp.m.ap_stas_cnt;
+    if (sta != NULL) {
+        LWESP_MEMCPY(sta, esp.m.ap_stas, LWESP_MIN(cnt, stal) * sizeof(*sta));
+    }
+    lwesp_core_unlock();
+    return cnt;
+}
+
+/**
+ * \brief           Get station with specific MAC address from local table
+ * \param[in]       mac: MAC address of station
+ * \param[out]      sta: Pointer to output station data. Set to `NULL` to only check if station is connected
+ * \return          \ref lwespOK when station is connected, \ref lwespERR otherwise
+ */
+lwespr_t
+lwesp_ap_sta_table_get_by_mac(const lwesp_mac_t* mac, lwesp_sta_t* sta) {
+    lwespr_t res = lwespERR;
+    size_t i;
+
+    LWESP_ASSERT("mac != NULL", mac != NULL);
+
+    lwesp_core_lock();
+    if ((i = ap_sta_table_find(mac)) < esp.m.ap_stas_cnt) {
+        if (sta != NULL) {
+            *sta = esp.m.ap_stas[i];
+        }
+        res = lwespOK;
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Reconcile local station table with list reported by device
+ *
+ * Table is kept up-to-date with device messages. Synchronization is only needed
+ * after messages may have been missed, or when table was full.
+ * Every \ref lwesp_ap_list_sta call synchronizes the table too.
+ *
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_ap_sta_table_sync(const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWESP_MSG_VAR_DEFINE(msg);
+
+    LWESP_MSG_VAR_ALLOC(msg, blocking);
+    LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_WIFI_CWLIF;
+
+    return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 1000);
+}
+
+#endif /* LWESP_CFG_AP_STA_TABLE > 0 || __DOXYGEN__ */
+
 #endif /* LWESP_CFG_MODE_ACCESS_POINT || __DOXYGEN__ */
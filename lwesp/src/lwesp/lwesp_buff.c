@@ -46,6 +46,57 @@
 #define BUF_IS_VALID(b)                 ((b) != NULL && (b)->buff != NULL && (b)->size > 0)
 #define BUF_MIN(x, y)                   ((x) < (y) ? (x) : (y))
 #define BUF_MAX(x, y)                   ((x) > (y) ? (x) : (y))
+#define BUF_MEMORY_BARRIER()            LWESP_CFG_MEMORY_BARRIER()
+#define BUF_IS_POW2(b)                  LWESP_BUFF_IS_POW2(b)
+#define BUF_INDEX(b, p)                 LWESP_BUFF_INDEX(b, p)
+
+/*
+ * Buffer is lock-free for single producer and single consumer.
+ *
+ * Producer (write, advance) only modifies write pointer and consumer (read, skip)
+ * only modifies read pointer. Each side takes single snapshot of both pointers,
+ * and publishes its own pointer with single store, after memory barrier,
+ * once data have been copied. Writer can therefore run from interrupt context
+ * while reader runs in thread, without any lock.
+ *
+ * Init, free and reset functions are not thread-safe and must not run concurrently with others.
+ *
+ * With \ref LWESP_CFG_BUFF_POW2 enabled and buffer size being power of two,
+ * pointers are free-running and only masked on memory access.
+ * Difference `w - r` is then number of bytes in buffer, also after pointer integer overflow,
+ * hence no slot has to be kept empty to distinguish full from empty buffer.
+ */
+
+/**
+ * \brief           Set index mask for power-of-two buffer size
+ * \param[in]       buff: Pointer to buffer structure
+ */
+static void
+buff_init_mask(BUF_PREF(buff_t)* buff) {
+#if LWESP_CFG_BUFF_POW2
+    if (buff->size > 1 && (buff->size & (buff->size - 1)) == 0) {
+        buff->mask = buff->size - 1;
+    }
+#else /* LWESP_CFG_BUFF_POW2 */
+    LWESP_UNUSED(buff);
+#endif /* !LWESP_CFG_BUFF_POW2 */
+}
+
+/**
+ * \brief           Move read or write pointer forward
+ * \param[in]       buff: Pointer to buffer structure
+ * \param[in]       p: Current pointer value
+ * \param[in]       len: Number of bytes to move pointer for. Must not exceed buffer size
+ * \return          New pointer value
+ */
+static size_t
+buff_ptr_add(BUF_PREF(buff_t)* buff, size_t p, size_t len) {
+    p += len;
+    if (!BUF_IS_POW2(buff) && p >= buff->size) {
+        p -= buff->size;
+    }
+    return p;
+}
 
 /**
  * \brief           Initialize buffer
@@ -62,6 +113,7 @@ BUF_PREF(buff_init)(BUF_PREF(buff_t)* buff, size_t size) {
 
     buff->size = size;                          /* Set default values */
     buff->buff = lwesp_mem_malloc(sizeof(*buff->buff) * size);  /* Allocate memory for buffer */
+    buff_init_mask(buff);
 
     if (buff->buff == NULL) {                   /* Check allocation */
         return 0;
@@ -69,6 +121,27 @@ BUF_PREF(buff_init)(BUF_PREF(buff_t)* buff, size_t size) {
     return 1;                                   /* Initialized OK */
 }
 
+/**
+ * \brief           Initialize buffer on user provided memory
+ * \note            Memory is owned by caller, \ref lwesp_buff_free must not be called for this buffer
+ * \param[in]       buff: Pointer to buffer structure
+ * \param[in]       mem: Pointer to memory to use for buffer data
+ * \param[in]       size: Size of memory in units of bytes
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+BUF_PREF(buff_init_mem)(BUF_PREF(buff_t)* buff, void* mem, size_t size) {
+    if (buff == NULL || mem == NULL || size == 0) {
+        return 0;
+    }
+    BUF_MEMSET(buff, 0, sizeof(*buff));
+
+    buff->size = size;
+    buff->buff = mem;
+    buff_init_mask(buff);
+    return 1;
+}
+
 /**
  * \brief           Free dynamic allocation if used on memory
  * \param[in]       buff: Pointer to buffer structure
@@ -92,7 +165,7 @@ BUF_PREF(buff_free)(BUF_PREF(buff_t)* buff) {
  */
 size_t
 BUF_PREF(buff_write)(BUF_PREF(buff_t)* buff, const void* data, size_t btw) {
-    size_t tocopy, free;
+    size_t tocopy, free, w, i;
     const uint8_t* d = data;
 
     if (!BUF_IS_VALID(buff) || btw == 0) {
@@ -100,6 +173,7 @@ BUF_PREF(buff_write)(BUF_PREF(buff_t)* buff, const void* data, size_t btw) {
     }
 
     /* Calculate maximum number of bytes available to write */
+    w = buff->w;
     free = BUF_PREF(buff_get_free)(buff);
     btw = BUF_MIN(free, btw);
     if (btw == 0) {
@@ -107,20 +181,20 @@ BUF_PREF(buff_write)(BUF_PREF(buff_t)* buff, const void* data, size_t btw) {
     }
 
     /* Step 1: Write data to linear part of buffer */
-    tocopy = BUF_MIN(buff->size - buff->w, btw);
-    BUF_MEMCPY(&buff->buff[buff->w], d, tocopy);
-    buff->w += tocopy;
+    i = BUF_INDEX(buff, w);
+    tocopy = BUF_MIN(buff->size - i, btw);
+    BUF_MEMCPY(&buff->buff[i], d, tocopy);
     btw -= tocopy;
 
     /* Step 2: Write data to beginning of buffer (overflow part) */
     if (btw > 0) {
         BUF_MEMCPY(buff->buff, (void*)&d[tocopy], btw);
-        buff->w = btw;
     }
+    w = buff_ptr_add(buff, w, tocopy + btw);
 
-    if (buff->w >= buff->size) {
-        buff->w = 0;
-    }
+    /* Step 3: Publish write pointer once data are in memory */
+    BUF_MEMORY_BARRIER();
+    buff->w = w;
     return tocopy + btw;
 }
 
@@ -134,7 +208,7 @@ BUF_PREF(buff_write)(BUF_PREF(buff_t)* buff, const void* data, size_t btw) {
  */
 size_t
 BUF_PREF(buff_read)(BUF_PREF(buff_t)* buff, void* data, size_t btr) {
-    size_t tocopy, full;
+    size_t tocopy, full, r, i;
     uint8_t* d = data;
 
     if (!BUF_IS_VALID(buff) || btr == 0) {
@@ -142,28 +216,31 @@ BUF_PREF(buff_read)(BUF_PREF(buff_t)* buff, void* data, size_t btr) {
     }
 
     /* Calculate maximum number of bytes available to read */
+    r = buff->r;
     full = BUF_PREF(buff_get_full)(buff);
     btr = BUF_MIN(full, btr);
     if (btr == 0) {
         return 0;
     }
+    BUF_MEMORY_BARRIER();                       /* Read data only after write pointer */
 
     /* Step 1: Read data from linear part of buffer */
-    tocopy = BUF_MIN(buff->size - buff->r, btr);
-    BUF_MEMCPY(d, &buff->buff[buff->r], tocopy);
-    buff->r += tocopy;
+    i = BUF_INDEX(buff, r);
+    tocopy = BUF_MIN(buff->size - i, btr);
+    BUF_MEMCPY(d, &buff->buff[i], tocopy);
     btr -= tocopy;
 
     /* Step 2: Read data from beginning of buffer (overflow part) */
     if (btr > 0) {
         BUF_MEMCPY(&d[tocopy], buff->buff, btr);
-        buff->r = btr;
     }
 
-    /* Step 3: Check end of buffer */
-    if (buff->r >= buff->size) {
-        buff->r = 0;
-    }
+    /* Step 3: Move read pointer, wrap at end of buffer */
+    r = buff_ptr_add(buff, r, tocopy + btr);
+
+    /* Step 4: Release memory to writer once data are copied */
+    BUF_MEMORY_BARRIER();
+    buff->r = r;
     return tocopy + btr;
 }
 
@@ -193,17 +270,15 @@ BUF_PREF(buff_peek)(BUF_PREF(buff_t)* buff, size_t skip_count, void* data, size_
     if (skip_count >= full) {
         return 0;
     }
-    r += skip_count;
+    r = BUF_INDEX(buff, buff_ptr_add(buff, r, skip_count));
     full -= skip_count;
-    if (r >= buff->size) {
-        r -= buff->size;
-    }
 
     /* Check maximum number of bytes available to read after skip */
     btp = BUF_MIN(full, btp);
     if (btp == 0) {
         return 0;
     }
+    BUF_MEMORY_BARRIER();                       /* Read data only after write pointer */
 
     /* Step 1: Read data from linear part of buffer */
     tocopy = BUF_MIN(buff->size - r, btp);
@@ -233,7 +308,9 @@ BUF_PREF(buff_get_free)(BUF_PREF(buff_t)* buff) {
     /* Use temporary values in case they are changed during operations */
     w = buff->w;
     r = buff->r;
-    if (w == r) {
+    if (BUF_IS_POW2(buff)) {
+        return buff->size - (w - r);            /* Full capacity is available */
+    } else if (w == r) {
         size = buff->size;
     } else if (r > w) {
         size = r - w;
@@ -261,7 +338,9 @@ BUF_PREF(buff_get_full)(BUF_PREF(buff_t)* buff) {
     /* Use temporary values in case they are changed during operations */
     w = buff->w;
     r = buff->r;
-    if (w == r) {
+    if (BUF_IS_POW2(buff)) {
+        size = w - r;
+    } else if (w == r) {
         size = 0;
     } else if (w > r) {
         size = w - r;
@@ -293,7 +372,7 @@ BUF_PREF(buff_get_linear_block_read_address)(BUF_PREF(buff_t)* buff) {
     if (!BUF_IS_VALID(buff)) {
         return NULL;
     }
-    return &buff->buff[buff->r];
+    return &buff->buff[BUF_INDEX(buff, buff->r)];
 }
 
 /**
@@ -312,13 +391,16 @@ BUF_PREF(buff_get_linear_block_read_length)(BUF_PREF(buff_t)* buff) {
     /* Use temporary values in case they are changed during operations */
     w = buff->w;
     r = buff->r;
-    if (w > r) {
+    if (BUF_IS_POW2(buff)) {
+        len = BUF_MIN(w - r, buff->size - BUF_INDEX(buff, r));
+    } else if (w > r) {
         len = w - r;
     } else if (r > w) {
         len = buff->size - r;
     } else {
         len = 0;
     }
+    BUF_MEMORY_BARRIER();                       /* Read data only after write pointer */
     return len;
 }
 
@@ -332,17 +414,17 @@ BUF_PREF(buff_get_linear_block_read_length)(BUF_PREF(buff_t)* buff) {
  */
 size_t
 BUF_PREF(buff_skip)(BUF_PREF(buff_t)* buff, size_t len) {
-    size_t full;
+    size_t full, r;
 
     if (!BUF_IS_VALID(buff) || len == 0) {
         return 0;
     }
 
+    r = buff->r;
     full = BUF_PREF(buff_get_full)(buff);       /* Get buffer used length */
-    buff->r += BUF_MIN(len, full);              /* Advance read pointer */
-    if (buff->r >= buff->size) {                /* Subtract possible overflow */
-        buff->r -= buff->size;
-    }
+    r = buff_ptr_add(buff, r, BUF_MIN(len, full)); /* Advance read pointer */
+    BUF_MEMORY_BARRIER();                       /* Finish data access before memory is released */
+    buff->r = r;
     return len;
 }
 
@@ -356,7 +438,7 @@ BUF_PREF(buff_get_linear_block_write_address)(BUF_PREF(buff_t)* buff) {
     if (!BUF_IS_VALID(buff)) {
         return NULL;
     }
-    return &buff->buff[buff->w];
+    return &buff->buff[BUF_INDEX(buff, buff->w)];
 }
 
 /**
@@ -375,7 +457,9 @@ BUF_PREF(buff_get_linear_block_write_length)(BUF_PREF(buff_t)* buff) {
     /* Use temporary values in case they are changed during operations */
     w = buff->w;
     r = buff->r;
-    if (w >= r) {
+    if (BUF_IS_POW2(buff)) {
+        len = BUF_MIN(buff->size - (w - r), buff->size - BUF_INDEX(buff, w));
+    } else if (w >= r) {
         len = buff->size - w;
         /*
          * When read pointer is 0,
@@ -407,16 +491,16 @@ BUF_PREF(buff_get_linear_block_write_length)(BUF_PREF(buff_t)* buff) {
  */
 size_t
 BUF_PREF(buff_advance)(BUF_PREF(buff_t)* buff, size_t len) {
-    size_t free;
+    size_t free, w;
 
     if (!BUF_IS_VALID(buff) || len == 0) {
         return 0;
     }
 
+    w = buff->w;
     free = BUF_PREF(buff_get_free)(buff);       /* Get buffer free length */
-    buff->w += BUF_MIN(len, free);              /* Advance write pointer */
-    if (buff->w >= buff->size) {                /* Subtract possible overflow */
-        buff->w -= buff->size;
-    }
+    w = buff_ptr_add(buff, w, BUF_MIN(len, free)); /* Advance write pointer */
+    BUF_MEMORY_BARRIER();                       /* Publish data before write pointer */
+    buff->w = w;
     return len;
 }
@@ -0,0 +1,184 @@
+/**
+ * \file            lwesp_capture.c
+ * \brief           AT port capture
+ */
+
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include "lwesp/lwesp_private.h"
+#include "lwesp/lwesp_capture.h"
+
+#if LWESP_CFG_CAPTURE || __DOXYGEN__
+
+#define CAPTURE_MAX_CHUNK               0xFFFF  /* Maximal length of data in single record */
+
+static lwesp_buff_t capture_buff;
+static uint8_t capture_active;
+static uint8_t capture_lost;
+static uint32_t capture_dropped;
+#if LWESP_CFG_STATIC_ONLY
+static uint8_t capture_mem[LWESP_CFG_CAPTURE_BUFF_SIZE];
+#endif /* LWESP_CFG_STATIC_ONLY */
+
+/**
+ * \brief           Write record header to capture buffer
+ * \param[in]       type: Record type
+ * \param[in]       len: Length of data following the header
+ */
+static void
+capture_write_hdr(lwesp_capture_type_t type, size_t len) {
+    uint8_t hdr[LWESP_CAPTURE_HDR_LEN];
+    uint32_t time = lwesp_sys_now();
+
+    hdr[0] = (uint8_t)type;
+    hdr[1] = (uint8_t)time;
+    hdr[2] = (uint8_t)(time >> 8);
+    hdr[3] = (uint8_t)(time >> 16);
+    hdr[4] = (uint8_t)(time >> 24);
+    hdr[5] = (uint8_t)len;
+    hdr[6] = (uint8_t)(len >> 8);
+    lwesp_buff_write(&capture_buff, hdr, sizeof(hdr));
+}
+
+/**
+ * \brief           Record chunk of AT port data
+ *
+ * Record is written completely or dropped, when there is not enough space in buffer.
+ * First record written after drop is preceded by \ref LWESP_CAPTURE_TYPE_LOST record
+ *
+ * \note            Function must be called with core locked
+ * \param[in]       type: Record type, \ref LWESP_CAPTURE_TYPE_RX, \ref LWESP_CAPTURE_TYPE_TX
+ *                      or \ref LWESP_CAPTURE_TYPE_RESET
+ * \param[in]       data: Data to record, `NULL` for record without data
+ * \param[in]       len: Length of data in units of bytes
+ */
+void
+lwespi_capture_write(lwesp_capture_type_t type, const void* data, size_t len) {
+    const uint8_t* d = data;
+    size_t chunk;
+
+    if (!capture_active) {
+        return;
+    }
+    do {
+        chunk = LWESP_MIN(len, CAPTURE_MAX_CHUNK);
+        if (lwesp_buff_get_free(&capture_buff) < (chunk + LWESP_CAPTURE_HDR_LEN * (capture_lost ? 2 : 1))) {
+            capture_lost = 1;
+            ++capture_dropped;
+            return;
+        }
+        if (capture_lost) {
+            capture_write_hdr(LWESP_CAPTURE_TYPE_LOST, 0);
+            capture_lost = 0;
+        }
+        capture_write_hdr(type, chunk);
+        if (chunk > 0) {
+            lwesp_buff_write(&capture_buff, d, chunk);
+            d += chunk;
+            len -= chunk;
+        }
+    } while (len > 0);
+}
+
+/**
+ * \brief           Start AT port capture
+ *
+ * Buffer of \ref LWESP_CFG_CAPTURE_BUFF_SIZE bytes is allocated on first call,
+ * or is static when \ref LWESP_CFG_STATIC_ONLY is enabled.
+ * Any data not read from previous capture are discarded
+ * and stream starts with \ref LWESP_CAPTURE_TYPE_START record
+ *
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_capture_start(void) {
+    lwespr_t res = lwespOK;
+
+    lwesp_core_lock();
+#if LWESP_CFG_STATIC_ONLY
+    if (capture_buff.buff == NULL && !lwesp_buff_init_mem(&capture_buff, capture_mem, sizeof(capture_mem))) {
+#else /* LWESP_CFG_STATIC_ONLY */
+    if (capture_buff.buff == NULL && !lwesp_buff_init(&capture_buff, LWESP_CFG_CAPTURE_BUFF_SIZE)) {
+#endif /* !LWESP_CFG_STATIC_ONLY */
+        res = lwespERRMEM;
+    } else {
+        lwesp_buff_reset(&capture_buff);
+        capture_lost = 0;
+        capture_dropped = 0;
+        capture_write_hdr(LWESP_CAPTURE_TYPE_START, 0);
+        capture_active = 1;
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Stop AT port capture
+ *
+ * Recorded data remain in buffer and can still be read with \ref lwesp_capture_read
+ *
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_capture_stop(void) {
+    lwesp_core_lock();
+    capture_active = 0;
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+/**
+ * \brief           Read recorded data from capture buffer
+ *
+ * Function does not lock the core and may be called concurrently with recording,
+ * from single thread only. Data are read as byte stream, records may span multiple reads
+ *
+ * \param[out]      data: Output memory to copy data to
+ * \param[in]       btr: Maximal number of bytes to read
+ * \return          Number of bytes read
+ */
+size_t
+lwesp_capture_read(void* data, size_t btr) {
+    if (data == NULL || capture_buff.buff == NULL) {
+        return 0;
+    }
+    return lwesp_buff_read(&capture_buff, data, btr);
+}
+
+/**
+ * \brief           Get number of records dropped since capture started
+ * \return          Number of dropped records
+ */
+uint32_t
+lwesp_capture_get_dropped(void) {
+    return capture_dropped;
+}
+
+#endif /* LWESP_CFG_CAPTURE || __DOXYGEN__ */
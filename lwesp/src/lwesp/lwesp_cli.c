@@ -31,23 +31,57 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lwesp/lwesp_private.h"
 #include "lwesp/lwesp.h"
+#include "lwesp/lwesp_mem.h"
 #if LWESP_CFG_MODE_STATION
 #include "lwesp/lwesp_sta.h"
 #endif /* LWESP_CFG_MODE_STATION */
 #include "cli/cli.h"
 #include "cli/cli_opt.h"
 
+#define CLI_STATS_ANY               (LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_STATS_THREAD || LWESP_CFG_TRACE)
+#define CLI_MEM_STATS               (LWESP_CFG_MEM_STATS && !LWESP_CFG_MEM_CUSTOM)
+#define CLI_TRACE_CHUNK             48  /* Maximal length of single trace print, fits small printf buffers */
+#define CLI_LAT_BAR_LEN             32  /* Length of histogram bar for the largest bucket */
+
 #if LWESP_CFG_MODE_STATION
 static void cli_station_info(cli_printf cliprintf, int argc, char** argv);
 #endif /* LWESP_CFG_MODE_STATION */
+#if CLI_STATS_ANY
+static void cli_stats(cli_printf cliprintf, int argc, char** argv);
+#endif /* CLI_STATS_ANY */
+#if CLI_MEM_STATS
+static void cli_mem(cli_printf cliprintf, int argc, char** argv);
+#endif /* CLI_MEM_STATS */
+static void cli_conns(cli_printf cliprintf, int argc, char** argv);
+#if LWESP_CFG_STATS
+static void cli_lat(cli_printf cliprintf, int argc, char** argv);
+#endif /* LWESP_CFG_STATS */
+#if LWESP_CFG_TRACE
+static void cli_trace(cli_printf cliprintf, int argc, char** argv);
+#endif /* LWESP_CFG_TRACE */
 
 static const cli_command_t
 commands[] = {
 #if LWESP_CFG_MODE_STATION
     { "station-info",       "Get current station info",                 cli_station_info },
 #endif /* LWESP_CFG_MODE_STATION */
-
+#if CLI_STATS_ANY
+    { "stats",              "Dump traffic, thread and mailbox statistics",  cli_stats },
+#endif /* CLI_STATS_ANY */
+#if CLI_MEM_STATS
+    { "mem",                "Dump memory usage per allocation tag",     cli_mem },
+#endif /* CLI_MEM_STATS */
+    { "conns",              "Dump connections and throughput since last call",  cli_conns },
+#if LWESP_CFG_STATS
+    { "lat",                "Dump AT command latency, `lat [cmd]` for histogram",   cli_lat },
+#endif /* LWESP_CFG_STATS */
+#if LWESP_CFG_TRACE
+    { "trace",              "`trace dump` exports trace as JSON, `trace lost` prints lost events",  cli_trace },
+#endif /* LWESP_CFG_TRACE */
 };
 
 /**
@@ -87,3 +121,280 @@ cli_station_info(cli_printf cliprintf, int argc, char** argv) {
 }
 
 #endif /* LWESP_CFG_MODE_STATION || __DOXYGEN__ */
+
+#if CLI_STATS_ANY || __DOXYGEN__
+
+/**
+ * \brief           CLI command for dumping global statistics
+ * \param[in]       cliprintf: Pointer to CLI printf function
+ * \param[in]       argc: Number fo arguments in argv
+ * \param[in]       argv: Pointer to the commands arguments
+ */
+static void
+cli_stats(cli_printf cliprintf, int argc, char** argv) {
+#if LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_STATS_THREAD
+    lwesp_stats_t stats;
+
+    lwesp_stats_get(&stats);
+#endif /* LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_STATS_THREAD */
+#if LWESP_CFG_STATS_TRAFFIC
+    cliprintf("  UART RX:      %u bytes, %u dropped in %u overflows"CLI_NL, (unsigned)stats.uart_rx_bytes,
+              (unsigned)stats.uart_rx_dropped, (unsigned)stats.uart_rx_overflows);
+    cliprintf("  UART TX:      %u bytes"CLI_NL, (unsigned)stats.uart_tx_bytes);
+    cliprintf("  Lines cut:    %u"CLI_NL, (unsigned)stats.recv_lines_truncated);
+    cliprintf("  Conn RX:      %u bytes, %u packets"CLI_NL, (unsigned)stats.conn.rx_bytes, (unsigned)stats.conn.rx_packets);
+    cliprintf("  Conn TX:      %u bytes, %u packets"CLI_NL, (unsigned)stats.conn.tx_bytes, (unsigned)stats.conn.tx_packets);
+    cliprintf("  Send retries: %u"CLI_NL, (unsigned)stats.conn.send_retries);
+    cliprintf("  Send fails:   %u"CLI_NL, (unsigned)stats.conn.send_fails);
+    cliprintf("  IPD drops:    %u"CLI_NL, (unsigned)stats.conn.ipd_drops);
+#endif /* LWESP_CFG_STATS_TRAFFIC */
+#if LWESP_CFG_STATS_THREAD
+    cliprintf("  THREAD    BUSY["LWESP_STATS_TIME_UNIT"]  IDLE["LWESP_STATS_TIME_UNIT"]  SYNC["LWESP_STATS_TIME_UNIT"]   WAKEUPS"CLI_NL);
+    cliprintf("  producer %9u %9u %9u %9u"CLI_NL, (unsigned)stats.producer.busy_time, (unsigned)stats.producer.idle_time,
+              (unsigned)stats.producer.sync_time, (unsigned)stats.producer.wakeups);
+    cliprintf("  process  %9u %9u %9u %9u"CLI_NL, (unsigned)stats.process.busy_time, (unsigned)stats.process.idle_time,
+              (unsigned)stats.process.sync_time, (unsigned)stats.process.wakeups);
+    cliprintf("  MBOX      SIZE DEPTH   MAX    WRITES  FAILS"CLI_NL);
+    cliprintf("  producer %5u %5u %5u %9u %6u"CLI_NL, (unsigned)stats.mbox_producer.size, (unsigned)stats.mbox_producer.depth,
+              (unsigned)stats.mbox_producer.depth_max, (unsigned)stats.mbox_producer.writes, (unsigned)stats.mbox_producer.write_fails);
+    cliprintf("  process  %5u %5u %5u %9u %6u"CLI_NL, (unsigned)stats.mbox_process.size, (unsigned)stats.mbox_process.depth,
+              (unsigned)stats.mbox_process.depth_max, (unsigned)stats.mbox_process.writes, (unsigned)stats.mbox_process.write_fails);
+#endif /* LWESP_CFG_STATS_THREAD */
+#if LWESP_CFG_TRACE
+    cliprintf("  Trace lost:   %u events"CLI_NL, (unsigned)lwesp_trace_get_lost());
+#endif /* LWESP_CFG_TRACE */
+
+    LWESP_UNUSED(argc);
+    LWESP_UNUSED(argv);
+}
+
+#endif /* CLI_STATS_ANY || __DOXYGEN__ */
+
+#if CLI_MEM_STATS || __DOXYGEN__
+
+static const char* const
+mem_tag_names[LWESP_MEM_TAG_END] = {
+    [LWESP_MEM_TAG_OTHER] = "other",
+    [LWESP_MEM_TAG_MSG] = "msg",
+    [LWESP_MEM_TAG_PBUF] = "pbuf",
+    [LWESP_MEM_TAG_CONN_BUFF] = "conn_buff",
+    [LWESP_MEM_TAG_MQTT] = "mqtt",
+    [LWESP_MEM_TAG_PBUF_HDR] = "pbuf_hdr",
+};
+
+/**
+ * \brief           CLI command for dumping memory statistics
+ * \param[in]       cliprintf: Pointer to CLI printf function
+ * \param[in]       argc: Number fo arguments in argv
+ * \param[in]       argv: Pointer to the commands arguments
+ */
+static void
+cli_mem(cli_printf cliprintf, int argc, char** argv) {
+    lwesp_mem_stats_t ms;
+
+    lwesp_mem_get_stats(&ms);
+    cliprintf("  In use:       %u bytes, peak %u bytes"CLI_NL, (unsigned)ms.bytes_in_use, (unsigned)ms.bytes_peak);
+    cliprintf("  Free:         %u bytes, min %u bytes"CLI_NL, (unsigned)ms.bytes_free, (unsigned)ms.bytes_min_free);
+    cliprintf("  Largest free: %u bytes"CLI_NL, (unsigned)ms.largest_free_block);
+    cliprintf("  Allocations:  %u, frees %u, fails %u"CLI_NL, (unsigned)ms.alloc_count, (unsigned)ms.free_count, (unsigned)ms.fail_count);
+#if LWESP_CFG_STATIC_ONLY
+    cliprintf("  Static pools: %u bytes"CLI_NL, (unsigned)lwesp_get_static_ram_size());
+#endif /* LWESP_CFG_STATIC_ONLY */
+    cliprintf("  TAG          IN USE     PEAK   ALLOCS"CLI_NL);
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(ms.tags); ++i) {
+        cliprintf("  %-10s %8u %8u %8u"CLI_NL, mem_tag_names[i], (unsigned)ms.tags[i].bytes_in_use,
+                  (unsigned)ms.tags[i].bytes_peak, (unsigned)ms.tags[i].alloc_count);
+    }
+
+    LWESP_UNUSED(argc);
+    LWESP_UNUSED(argv);
+}
+
+#endif /* CLI_MEM_STATS || __DOXYGEN__ */
+
+/**
+ * \brief           CLI command for dumping connections
+ *
+ * With \ref LWESP_CFG_STATS_TRAFFIC enabled, throughput is calculated
+ * from traffic counters since previous call of this command
+ *
+ * \param[in]       cliprintf: Pointer to CLI printf function
+ * \param[in]       argc: Number fo arguments in argv
+ * \param[in]       argv: Pointer to the commands arguments
+ */
+static void
+cli_conns(cli_printf cliprintf, int argc, char** argv) {
+    static const char* const type_names[] = {"TCP", "UDP", "SSL"};
+#if LWESP_CFG_STATS_TRAFFIC
+    static uint32_t last_rx[LWESP_CFG_MAX_CONNS], last_tx[LWESP_CFG_MAX_CONNS], last_time;
+    uint32_t now, diff;
+#endif /* LWESP_CFG_STATS_TRAFFIC */
+    lwesp_conn_t* c;
+    lwesp_conn_t conn;
+
+#if LWESP_CFG_STATS_TRAFFIC
+    now = lwesp_sys_now();
+    diff = now - last_time;
+    last_time = now;
+    cliprintf("  NUM TYPE REMOTE                LPORT     RX[B]     TX[B] RX[B/s] TX[B/s]"CLI_NL);
+#else /* LWESP_CFG_STATS_TRAFFIC */
+    cliprintf("  NUM TYPE REMOTE                LPORT     RX[B]"CLI_NL);
+#endif /* !LWESP_CFG_STATS_TRAFFIC */
+    for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+        /* Copy connection with core locked, print without lock as output may use connection API */
+        c = &esp.m.conns[i];
+        lwesp_core_lock();
+        conn = *c;
+        lwesp_core_unlock();
+        if (!conn.status.f.active) {
+            continue;
+        }
+        cliprintf("  %3u %-4s %3u.%3u.%3u.%3u:%-5u %5u %9u", (unsigned)conn.num,
+                  (size_t)conn.type < LWESP_ARRAYSIZE(type_names) ? type_names[conn.type] : "?",
+                  (unsigned)conn.remote_ip.ip[0], (unsigned)conn.remote_ip.ip[1], (unsigned)conn.remote_ip.ip[2],
+                  (unsigned)conn.remote_ip.ip[3], (unsigned)conn.remote_port, (unsigned)conn.local_port,
+                  (unsigned)conn.total_recved);
+#if LWESP_CFG_STATS_TRAFFIC
+        /* Counters are reset when connection becomes active */
+        if (conn.stats.rx_bytes < last_rx[i] || conn.stats.tx_bytes < last_tx[i]) {
+            last_rx[i] = last_tx[i] = 0;
+        }
+        cliprintf(" %9u %7u %7u", (unsigned)conn.stats.tx_bytes,
+                  (unsigned)(diff > 0 ? (uint32_t)(((uint64_t)(conn.stats.rx_bytes - last_rx[i]) * 1000) / diff) : 0),
+                  (unsigned)(diff > 0 ? (uint32_t)(((uint64_t)(conn.stats.tx_bytes - last_tx[i]) * 1000) / diff) : 0));
+        last_rx[i] = conn.stats.rx_bytes;
+        last_tx[i] = conn.stats.tx_bytes;
+#endif /* LWESP_CFG_STATS_TRAFFIC */
+        cliprintf(CLI_NL);
+    }
+
+    LWESP_UNUSED(argc);
+    LWESP_UNUSED(argv);
+}
+
+#if LWESP_CFG_STATS || __DOXYGEN__
+
+/**
+ * \brief           Print latency histogram of single command
+ * \param[in]       cliprintf: Pointer to CLI printf function
+ * \param[in]       cs: Command statistics
+ */
+static void
+cli_lat_hist(cli_printf cliprintf, const lwesp_stats_cmd_t* cs) {
+    char bar[CLI_LAT_BAR_LEN + 1];
+    uint32_t max_cnt = 1;
+    size_t bar_len;
+
+    for (size_t b = 0; b < LWESP_CFG_STATS_HIST_BUCKETS; ++b) {
+        max_cnt = LWESP_MAX(max_cnt, cs->hist[b]);
+    }
+    for (size_t b = 0; b < LWESP_CFG_STATS_HIST_BUCKETS; ++b) {
+        bar_len = (size_t)(((uint64_t)cs->hist[b] * CLI_LAT_BAR_LEN) / max_cnt);
+        LWESP_MEMSET(bar, '#', bar_len);
+        bar[bar_len] = '\0';
+        if (b == 0) {
+            cliprintf("  %13s ms %8u |%s"CLI_NL, "< 1", (unsigned)cs->hist[b], bar);
+        } else if (b == (LWESP_CFG_STATS_HIST_BUCKETS - 1)) {
+            cliprintf("  %8s%5u ms %8u |%s"CLI_NL, ">=", (unsigned)(1UL << (b - 1)), (unsigned)cs->hist[b], bar);
+        } else {
+            cliprintf("  %5u - %5u ms %8u |%s"CLI_NL, (unsigned)(1UL << (b - 1)), (unsigned)(1UL << b), (unsigned)cs->hist[b], bar);
+        }
+    }
+}
+
+/**
+ * \brief           CLI command for dumping command latency statistics
+ *
+ * Without argument, summary of all executed commands is printed,
+ * `lat <cmd>` prints histogram of single command
+ *
+ * \param[in]       cliprintf: Pointer to CLI printf function
+ * \param[in]       argc: Number fo arguments in argv
+ * \param[in]       argv: Pointer to the commands arguments
+ */
+static void
+cli_lat(cli_printf cliprintf, int argc, char** argv) {
+    lwesp_stats_t stats;
+    lwesp_stats_cmd_t cs;
+
+    lwesp_stats_get(&stats);
+    if (argc > 1) {
+        size_t cmd = (size_t)strtoul(argv[1], NULL, 0);
+
+        if (cmd >= stats.cmd_count) {
+            cliprintf("Error: Command index must be smaller than %u"CLI_NL, (unsigned)stats.cmd_count);
+            return;
+        }
+        lwesp_stats_get_cmd(cmd, &cs);
+        cliprintf("  CMD %u: %u done, %u errors, %u timeouts, avg %u "LWESP_STATS_TIME_UNIT", max %u "LWESP_STATS_TIME_UNIT CLI_NL, (unsigned)cmd,
+                  (unsigned)cs.count, (unsigned)cs.err_count, (unsigned)cs.timeout_count,
+                  (unsigned)(cs.count > 0 ? cs.time_sum / cs.count : 0), (unsigned)cs.time_max);
+        cli_lat_hist(cliprintf, &cs);
+        return;
+    }
+    cliprintf("  CMD    COUNT   ERR   TMO  AVG["LWESP_STATS_TIME_UNIT"]  MAX["LWESP_STATS_TIME_UNIT"] RESP["LWESP_STATS_TIME_UNIT"] QUEUE["LWESP_STATS_TIME_UNIT"]  HIST"CLI_NL);
+    for (size_t i = 0; i < stats.cmd_count; ++i) {
+        lwesp_stats_get_cmd(i, &cs);
+        if (cs.count == 0 && cs.timeout_count == 0) {
+            continue;
+        }
+        cliprintf("  %3u %8u %5u %5u %8u %8u %8u %9u ", (unsigned)i, (unsigned)cs.count,
+                  (unsigned)cs.err_count, (unsigned)cs.timeout_count,
+                  (unsigned)(cs.count > 0 ? cs.time_sum / cs.count : 0), (unsigned)cs.time_max,
+                  (unsigned)cs.resp_time_max, (unsigned)cs.queue_time_max);
+        for (size_t b = 0; b < LWESP_CFG_STATS_HIST_BUCKETS; ++b) {
+            cliprintf(" %u", (unsigned)cs.hist[b]);
+        }
+        cliprintf(CLI_NL);
+    }
+}
+
+#endif /* LWESP_CFG_STATS || __DOXYGEN__ */
+
+#if LWESP_CFG_TRACE || __DOXYGEN__
+
+static cli_printf* trace_cliprintf;             /* Output for trace export, valid during export only */
+
+/**
+ * \brief           Trace export output function, prints chunk in small pieces
+ * \param[in]       str: Chunk of output string
+ * \param[in]       len: Length of chunk
+ * \param[in]       arg: Unused
+ */
+static void
+cli_trace_out(const char* str, size_t len, void* arg) {
+    size_t chunk;
+
+    while (len > 0) {
+        chunk = LWESP_MIN(len, CLI_TRACE_CHUNK);
+        trace_cliprintf("%.*s", (int)chunk, str);
+        str += chunk;
+        len -= chunk;
+    }
+    LWESP_UNUSED(arg);
+}
+
+/**
+ * \brief           CLI command for trace buffer
+ *
+ * `trace dump` streams and consumes recorded events as JSON trace,
+ * to be opened in Perfetto UI or `chrome://tracing`
+ *
+ * \param[in]       cliprintf: Pointer to CLI printf function
+ * \param[in]       argc: Number fo arguments in argv
+ * \param[in]       argv: Pointer to the commands arguments
+ */
+static void
+cli_trace(cli_printf cliprintf, int argc, char** argv) {
+    if (argc > 1 && !strcmp(argv[1], "dump")) {
+        trace_cliprintf = cliprintf;
+        lwesp_trace_export(cli_trace_out, NULL);
+        trace_cliprintf = NULL;
+    } else if (argc > 1 && !strcmp(argv[1], "lost")) {
+        cliprintf("  Trace lost:   %u events"CLI_NL, (unsigned)lwesp_trace_get_lost());
+    } else {
+        cliprintf("Usage: trace dump|lost"CLI_NL);
+    }
+}
+
+#endif /* LWESP_CFG_TRACE || __DOXYGEN__ */
@@ -53,27 +53,168 @@
         }                                           \
     } while (0)
 
+static lwesp_timeout_id_t conn_poll_id;         /*!< Handle of poll timer, shared by all connections */
+static uint32_t conn_poll_time;                 /*!< Absolute time when poll timer expires */
+
+#if LWESP_CFG_STATIC_ONLY || LWESP_CFG_CONN_BUFF_POOL
+static uint8_t conn_buff_pool[LWESP_CFG_CONN_BUFF_POOL_SIZE][LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT];    /*!< Static pool of write buffers */
+static uint8_t* conn_buff_pool_free[LWESP_CFG_CONN_BUFF_POOL_SIZE];   /*!< Free write buffers */
+static size_t conn_buff_pool_free_cnt;
+static uint8_t conn_buff_pool_initialized;
+#endif /* LWESP_CFG_STATIC_ONLY || LWESP_CFG_CONN_BUFF_POOL */
+
+static void conn_timeout_cb(void* arg);
+
+/**
+ * \brief           Allocate connection write buffer
+ * \param[in]       len: Buffer length, up to \ref lwesp_conn_get_max_data_len.
+ *                      Callers pass value they use for the buffer, as limit may change at runtime
+ * \return          Pointer to buffer on success, `NULL` otherwise
+ */
+uint8_t*
+lwespi_conn_buff_alloc(size_t len) {
+#if LWESP_CFG_STATIC_ONLY || LWESP_CFG_CONN_BUFF_POOL
+    uint8_t* buff = NULL;
+
+    lwesp_core_lock();
+    if (!conn_buff_pool_initialized) {
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(conn_buff_pool); ++i) {
+            conn_buff_pool_free[i] = conn_buff_pool[i];
+        }
+        conn_buff_pool_free_cnt = LWESP_ARRAYSIZE(conn_buff_pool);
+        conn_buff_pool_initialized = 1;
+    }
+    if (conn_buff_pool_free_cnt > 0) {
+        buff = conn_buff_pool_free[--conn_buff_pool_free_cnt];
+    }
+    lwesp_core_unlock();
+#if !LWESP_CFG_STATIC_ONLY
+    if (buff == NULL) {                         /* Pool is empty, fall back to heap */
+        buff = lwesp_mem_malloc_tag(sizeof(uint8_t) * len, LWESP_MEM_TAG_CONN_BUFF);
+    }
+#endif /* !LWESP_CFG_STATIC_ONLY */
+    LWESP_UNUSED(len);
+    return buff;
+#else /* LWESP_CFG_STATIC_ONLY || LWESP_CFG_CONN_BUFF_POOL */
+    return lwesp_mem_malloc_tag(sizeof(uint8_t) * len, LWESP_MEM_TAG_CONN_BUFF);
+#endif /* !(LWESP_CFG_STATIC_ONLY || LWESP_CFG_CONN_BUFF_POOL) */
+}
+
+/**
+ * \brief           Free connection write buffer allocated with \ref lwespi_conn_buff_alloc
+ * \param[in]       buff: Buffer to free. `NULL` is ignored
+ */
+void
+lwespi_conn_buff_free(const uint8_t* buff) {
+    if (buff == NULL) {
+        return;
+    }
+    LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
+               "[CONN] Free write buffer: %p\r\n", (const void*)buff);
+#if LWESP_CFG_STATIC_ONLY || LWESP_CFG_CONN_BUFF_POOL
+#if !LWESP_CFG_STATIC_ONLY
+    if (buff < conn_buff_pool[0] || buff >= conn_buff_pool[0] + sizeof(conn_buff_pool)) {
+        lwesp_mem_free((void*)buff);            /* Allocated from heap when pool was empty */
+        return;
+    }
+#endif /* !LWESP_CFG_STATIC_ONLY */
+    lwesp_core_lock();
+    conn_buff_pool_free[conn_buff_pool_free_cnt++] = (uint8_t*)buff;
+    lwesp_core_unlock();
+#else /* LWESP_CFG_STATIC_ONLY || LWESP_CFG_CONN_BUFF_POOL */
+    lwesp_mem_free((void*)buff);
+#endif /* !(LWESP_CFG_STATIC_ONLY || LWESP_CFG_CONN_BUFF_POOL) */
+}
+
+/**
+ * \brief           Make sure poll timer expires no later than specific time
+ * \param[in]       time: Absolute time in units of milliseconds
+ */
+static void
+conn_poll_schedule(uint32_t time) {
+    int32_t diff;
+
+    if (conn_poll_id != 0) {
+        if ((int32_t)(time - conn_poll_time) >= 0) {
+            return;                             /* Timer already expires on time */
+        }
+        lwesp_timeout_cancel(conn_poll_id);     /* Restart timer with earlier time */
+    }
+    diff = (int32_t)(time - lwesp_sys_now());
+    conn_poll_time = time;
+    conn_poll_id = lwesp_timeout_addex(diff > 0 ? (uint32_t)diff : 0, conn_timeout_cb, NULL);
+}
+
+/**
+ * \brief           Get effective base poll interval of connection
+ *
+ * Manual receive mode relies on poll timer to retry pending reads,
+ * hence timer keeps running on connections with poll event disabled
+ *
+ * \param[in]       conn: Connection handle
+ * \return          Base interval in units of milliseconds, `0` when connection needs no timer
+ */
+static uint32_t
+conn_poll_base(lwesp_conn_p conn) {
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+    return conn->poll_base > 0 ? conn->poll_base : LWESPI_PARAM(CONN_POLL_INTERVAL);
+#else /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+    return conn->poll_base;
+#endif /* !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+}
+
 /**
- * \brief           Timeout callback for connection
+ * \brief           Timeout callback for connection polling
+ *
+ * Single timer serves all active connections. Connections due for poll
+ * within half of base interval are polled together, to reduce number of wakeups
+ *
  * \param[in]       arg: Timeout callback custom argument
  */
 static void
 conn_timeout_cb(void* arg) {
-    lwesp_conn_p conn = arg;                    /* Argument is actual connection */
+    uint32_t now, next = 0;
+    uint8_t has_next = 0;
 
-    if (conn->status.f.active) {                /* Handle only active connections */
-        esp.evt.type = LWESP_EVT_CONN_POLL;     /* Poll connection event */
-        esp.evt.evt.conn_poll.conn = conn;      /* Set connection pointer */
-        lwespi_send_conn_cb(conn, NULL);        /* Send connection callback */
+    conn_poll_id = 0;
+    now = lwesp_sys_now();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(esp.m.conns); ++i) {
+        lwesp_conn_p conn = &esp.m.conns[i];
+        uint32_t base = conn_poll_base(conn);
 
-        lwespi_conn_start_timeout(conn);        /* Schedule new timeout */
-        LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
-                   "[CONN] Poll event: %p\r\n", conn);
-    }
+        if (!conn->status.f.active || base == 0) {  /* Handle only active connections with poll enabled */
+            continue;
+        }
+        if ((int32_t)(conn->poll_next - now) <= (int32_t)(LWESPI_PARAM(CONN_POLL_INTERVAL) / 2)) {
+            /* Back-off only when there was no data activity since last poll */
+            if (conn->poll_interval == 0) {
+                conn->poll_interval = base;
+            } else {
+                conn->poll_interval = LWESP_MIN(2 * conn->poll_interval, LWESP_MAX(base, LWESP_CFG_CONN_POLL_INTERVAL_MAX));
+            }
+            conn->poll_next = now + conn->poll_interval;
+
+            if (conn->poll_base > 0) {
+                esp.evt.type = LWESP_EVT_CONN_POLL; /* Poll connection event */
+                esp.evt.evt.conn_poll.conn = conn;  /* Set connection pointer */
+                lwespi_send_conn_cb(conn, NULL);    /* Send connection callback */
+                LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
+                           "[CONN] Poll event: %p\r\n", conn);
+            }
 
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
-    lwespi_conn_manual_tcp_try_read_data(conn); /* Try to read data manually */
+            lwespi_conn_manual_tcp_try_read_data(conn); /* Try to read data manually */
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+        }
+        if (conn->status.f.active && (!has_next || (int32_t)(conn->poll_next - next) < 0)) {
+            next = conn->poll_next;
+            has_next = 1;
+        }
+    }
+    if (has_next) {                             /* Schedule new timeout for earliest connection */
+        conn_poll_schedule(next);
+    }
+    LWESP_UNUSED(arg);
 }
 
 /**
@@ -82,76 +223,112 @@ conn_timeout_cb(void* arg) {
  */
 void
 lwespi_conn_start_timeout(lwesp_conn_p conn) {
-    lwesp_timeout_add(LWESP_CFG_CONN_POLL_INTERVAL, conn_timeout_cb, conn); /* Add connection timeout */
+    uint32_t base = conn_poll_base(conn);
+
+    conn->poll_interval = 0;
+    if (base > 0) {                             /* Idle connection without poll needs no timer */
+        conn->poll_next = lwesp_sys_now() + base;
+        conn_poll_schedule(conn->poll_next);    /* Add connection timeout */
+    }
 }
 
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
 
+static uint8_t manual_tcp_read_queued;          /*!< Status whether batched read command is in the queue already */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+static uint8_t manual_tcp_mode_queued;          /*!< Status whether receive mode switch command is in the queue already */
+static void conn_manual_tcp_auto_resume(void);
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
+
+/**
+ * \brief           Get number of bytes to read with next `AT+CIPRECVDATA` command on connection
+ *
+ * Length is limited by known available data on device,
+ * maximal command length and free space in application receive window
+ *
+ * \param[in]       conn: Connection handle
+ * \return          Number of bytes to read, `0` if connection cannot be read at the moment
+ */
+size_t
+lwespi_conn_manual_tcp_read_len(lwesp_conn_p conn) {
+    size_t len;
+
+    if (!conn->status.f.active || conn->status.f.in_closing
+        || conn->status.f.receive_blocked
+        || conn->tcp_not_ack_bytes >= conn->tcp_recv_window) {
+        return 0;
+    }
+    len = LWESP_MIN(LWESP_CFG_CONN_MAX_DATA_LEN, conn->tcp_available_bytes);
+    return LWESP_MIN(len, conn->tcp_recv_window - conn->tcp_not_ack_bytes);
+}
+
 /**
- * \brief           Callback function when manual TCP receive finishes
+ * \brief           Callback function when batched manual TCP receive finishes
  * \param[in]       res: Result of reading
  * \param[in]       arg: Custom user argument
  */
 static void
 manual_tcp_read_data_evt_fn(lwespr_t res, void* arg) {
-    lwesp_conn_p conn = arg;
+    manual_tcp_read_queued = 0;
 
-    conn->status.f.receive_is_command_queued = 0;
-    lwespi_conn_manual_tcp_try_read_data(conn);
+    /* New data may have arrived in the meantime */
+    for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+        lwespi_conn_manual_tcp_try_read_data(&esp.m.conns[i]);
+    }
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+    conn_manual_tcp_auto_resume();              /* Everything read, check if automatic mode can be restored */
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
+    LWESP_UNUSED(res);
+    LWESP_UNUSED(arg);
 }
 
 /**
- * \brief           Manually start data read operation with desired length on specific connection
- * \param[in]       conn: Connection handle
- * \param[in]       len: Number of bytes to read
+ * \brief           Queue batched read command for all connections
+ *
+ * Command polls device with `AT+CIPRECVLEN?` and then
+ * chains `AT+CIPRECVDATA` commands for every connection with data
+ *
+ * \param[in]       blocking: Status whether command should be blocking or not
  * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
  */
-lwespr_t
-lwespi_conn_manual_tcp_try_read_data(lwesp_conn_p conn) {
-    uint32_t blocking = 0;
-    lwespr_t res = lwespOK;
+static lwespr_t
+conn_manual_tcp_read_start(const uint32_t blocking) {
+    lwespr_t res;
     LWESP_MSG_VAR_DEFINE(msg);
 
-    LWESP_ASSERT("conn != NULL", conn != NULL);
-
-    /* Receive must not be blocked and other command must not be in queue to read data */
-    if (conn->status.f.receive_blocked
-        || conn->status.f.receive_is_command_queued) {
+    if (manual_tcp_read_queued) {               /* Queued command serves all connections */
         return lwespINPROG;
     }
 
-    /* Any available data to process? */
-    if (conn->tcp_available_bytes == 0
-        || !conn->status.f.active) {
-        return lwespERR;
-    }
-
-    LWESP_MSG_VAR_ALLOC(msg, blocking);         /* Allocate first, will return on failure */
-    LWESP_MSG_VAR_SET_EVT(msg, manual_tcp_read_data_evt_fn, conn);  /* Set event callback function */
+    LWESP_MSG_VAR_ALLOC_CMD(msg, blocking, ciprecvdata); /* Allocate first, will return on failure */
+    LWESP_MSG_VAR_SET_EVT(msg, manual_tcp_read_data_evt_fn, NULL);  /* Set event callback function */
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPRECVDATA;
     LWESP_MSG_VAR_REF(msg).cmd = LWESP_CMD_TCPIP_CIPRECVLEN;
-    LWESP_MSG_VAR_REF(msg).msg.ciprecvdata.len = 0; /* Filled after RECVLEN received */
-    LWESP_MSG_VAR_REF(msg).msg.ciprecvdata.buff = NULL; /* Filled after RECVLEN received */
-    LWESP_MSG_VAR_REF(msg).msg.ciprecvdata.conn = conn;
 
     /* Try to start command */
     if ((res = lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 60000)) == lwespOK) {
-        conn->status.f.receive_is_command_queued = 1;   /* Command queued */
+        manual_tcp_read_queued = 1;             /* Command queued */
     }
     return res;
 }
 
 /**
- * \brief           Callback function for checking receive length in manual TCP receive buffer
- * \param[in]       res: Result of reading
- * \param[in]       arg: Custom user argument
+ * \brief           Start data read operation if connection has data to read
+ * \param[in]       conn: Connection handle
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
  */
-static void
-check_available_rx_data_evt_fn(lwespr_t res, void* arg) {
-    /* Try to read data if possible */
-    for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
-        lwespi_conn_manual_tcp_try_read_data(&esp.m.conns[i]);
+lwespr_t
+lwespi_conn_manual_tcp_try_read_data(lwesp_conn_p conn) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+
+    /* Receive must not be blocked and application must have space for data */
+    if (conn->status.f.receive_blocked) {
+        return lwespINPROG;
+    }
+    if (lwespi_conn_manual_tcp_read_len(conn) == 0) {
+        return lwespERR;
     }
+    return conn_manual_tcp_read_start(0);
 }
 
 /**
@@ -160,30 +337,354 @@ check_available_rx_data_evt_fn(lwespr_t res, void* arg) {
  */
 lwespr_t
 lwespi_conn_check_available_rx_data(void) {
+    return conn_manual_tcp_read_start(0);
+}
+
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+
+/**
+ * \brief           Callback function when receive mode switch finishes
+ * \param[in]       res: Result of command
+ * \param[in]       arg: Custom user argument
+ */
+static void
+manual_tcp_mode_evt_fn(lwespr_t res, void* arg) {
+    manual_tcp_mode_queued = 0;
+    if (res == lwespOK && esp.m.tcp_recv_manual) {
+        lwespi_conn_check_available_rx_data();  /* Read data device buffered in the meantime */
+    }
+    LWESP_UNUSED(arg);
+}
+
+/**
+ * \brief           Queue `AT+CIPRECVMODE` command to switch receive mode of device
+ * \param[in]       manual: Set to `1` for manual receive mode, `0` for automatic mode
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+conn_manual_tcp_mode_set(uint8_t manual) {
+    lwespr_t res;
     LWESP_MSG_VAR_DEFINE(msg);
 
-    LWESP_MSG_VAR_ALLOC(msg, 0);                /* Allocate first, will return on failure */
-    LWESP_MSG_VAR_SET_EVT(msg, check_available_rx_data_evt_fn, NULL);   /* Set event callback function */
-    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPRECVLEN;
+    if (manual_tcp_mode_queued) {               /* Wait for previous switch to finish */
+        return lwespINPROG;
+    }
+
+    LWESP_MSG_VAR_ALLOC_CMD(msg, 0, ciprecvmode);
+    LWESP_MSG_VAR_SET_EVT(msg, manual_tcp_mode_evt_fn, NULL);
+    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPRECVMODE;
+    LWESP_MSG_VAR_REF(msg).msg.ciprecvmode.manual = manual;
 
-    return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 1000);
+    if ((res = lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 1000)) == lwespOK) {
+        manual_tcp_mode_queued = 1;
+    }
+    return res;
+}
+
+/**
+ * \brief           Restore automatic receive mode when memory pressure is gone
+ *
+ * Mode is restored once device holds no more data for active connections
+ * and buffer of \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO_RESUME_LEN bytes can be allocated
+ */
+static void
+conn_manual_tcp_auto_resume(void) {
+    lwesp_pbuf_p p;
+
+    if (!esp.m.tcp_recv_manual || manual_tcp_read_queued || manual_tcp_mode_queued) {
+        return;
+    }
+    for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+        if (esp.m.conns[i].status.f.active && esp.m.conns[i].tcp_available_bytes > 0) {
+            return;                             /* Device still buffers data */
+        }
+    }
+    if ((p = lwesp_pbuf_new(LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO_RESUME_LEN)) == NULL) {
+        return;                                 /* Memory did not recover yet */
+    }
+    lwesp_pbuf_free(p);
+    LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
+               "[CONN] Memory recovered, restoring automatic TCP receive mode\r\n");
+    conn_manual_tcp_mode_set(0);
+}
+
+/**
+ * \brief           Switch device to manual receive mode after received data could not be stored
+ *
+ * Device buffers further data until host reads it with `AT+CIPRECVDATA`
+ *
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwespi_conn_manual_tcp_auto_enter(void) {
+    if (esp.m.tcp_recv_manual) {
+        return lwespOK;
+    }
+    LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING,
+               "[CONN] Low memory, switching to manual TCP receive mode\r\n");
+    return conn_manual_tcp_mode_set(1);
 }
+
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
 
 /**
  * \brief           Get connection validation ID
+ *
+ * Validation ID is single word, written only by stack thread
+ * when connection becomes active, it is read without core lock
+ *
  * \param[in]       conn: Connection handle
  * \return          Connection current validation ID
  */
-uint8_t
+uint32_t
 lwespi_conn_get_val_id(lwesp_conn_p conn) {
-    uint8_t val_id;
+    return *(volatile const uint32_t*)&conn->val_id;
+}
+
+#if LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__
+
+/**
+ * \brief           Send watermark event for connection send queue
+ *
+ * Event may be raised from inside another connection callback,
+ * current event data are restored after it has been processed
+ *
+ * \note            Core must be locked when function is called
+ * \param[in]       conn: Connection handle
+ * \param[in]       high: Set to `1` when high watermark was reached, `0` for low watermark
+ */
+static void
+conn_tx_watermark_evt(lwesp_conn_p conn, uint8_t high) {
+    lwesp_evt_t evt = esp.evt;                  /* Save event, which may be in progress */
+
+    conn->status.f.tx_wm_is_high = high;
+    esp.evt.type = LWESP_EVT_CONN_TX_WATERMARK;
+    esp.evt.evt.conn_tx_watermark.conn = conn;
+    esp.evt.evt.conn_tx_watermark.queued = conn->tx_queued;
+    esp.evt.evt.conn_tx_watermark.high = high;
+    lwespi_send_conn_cb(conn, NULL);
+    esp.evt = evt;
+}
+
+/**
+ * \brief           Add data of send message to connection send queue
+ * \param[in]       msg: Send message with validation ID already set
+ */
+static void
+conn_tx_queue_add(lwesp_msg_t* msg) {
+    lwesp_conn_p conn = msg->msg.conn_send.conn;
+
+    lwesp_core_lock();
+    if (conn->val_id == msg->msg.conn_send.val_id) {/* Connection may have been reused in the meantime */
+        msg->msg.conn_send.queued = msg->msg.conn_send.btw;
+        conn->tx_queued += msg->msg.conn_send.btw;
+        if (conn->tx_wm_high > 0 && !conn->status.f.tx_wm_is_high && conn->tx_queued >= conn->tx_wm_high) {
+            conn_tx_watermark_evt(conn, 1);
+        }
+    }
+    lwesp_core_unlock();
+}
+
+/**
+ * \brief           Remove data of send message from connection send queue
+ *
+ * Called when send event is reported and again when message is freed,
+ * only first call for the message has an effect
+ *
+ * \param[in]       msg: Message to release, may be of any command type
+ */
+void
+lwespi_conn_tx_queue_release(lwesp_msg_t* msg) {
+    lwesp_conn_p conn;
+
+    if (msg->cmd_def != LWESP_CMD_TCPIP_CIPSEND || msg->msg.conn_send.queued == 0) {
+        return;
+    }
+    conn = msg->msg.conn_send.conn;
+
+    lwesp_core_lock();
+    if (conn->val_id == msg->msg.conn_send.val_id) {/* Counter was reset when connection was reused */
+        conn->tx_queued -= LWESP_MIN(msg->msg.conn_send.queued, conn->tx_queued);
+        if (conn->status.f.tx_wm_is_high && conn->tx_queued <= conn->tx_wm_low) {
+            conn_tx_watermark_evt(conn, 0);
+        }
+    }
+    msg->msg.conn_send.queued = 0;
+    lwesp_core_unlock();
+}
+
+#endif /* LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__ */
+
+#if LWESP_CFG_CONN_SEND_EVT_AGGR || __DOXYGEN__
+
+/**
+ * \brief           Add finished send command to connection send event batch
+ *
+ * Called after send command data were released from send queue
+ *
+ * \note            Core must be locked when function is called
+ * \param[in]       msg: Finished send message
+ * \param[in]       err: Send command result
+ * \param[out]      sent: Number of bytes to report with send event
+ * \return          `1` if send event shall be reported, `0` otherwise
+ */
+uint8_t
+lwespi_conn_send_evt_aggr(lwesp_msg_t* msg, lwespr_t err, size_t* sent) {
+    lwesp_conn_p conn = msg->msg.conn_send.conn;
+
+    *sent = msg->msg.conn_send.sent_all;
+    if (conn->send_evt_batch == 0 || conn->val_id != msg->msg.conn_send.val_id) {
+        return 1;                               /* Connection reports every send */
+    }
+    conn->send_evt_acc += *sent;
+    if (err == lwespOK && conn->send_evt_acc < conn->send_evt_batch && conn->tx_queued > 0) {
+        return 0;                               /* More data are queued, report them together */
+    }
+    *sent = conn->send_evt_acc;
+    conn->send_evt_acc = 0;
+    return 1;
+}
+
+/**
+ * \brief           Set number of sent bytes reported with single \ref LWESP_EVT_CONN_SEND event
+ *
+ * Sent bytes of consecutive send commands are accumulated and reported once `len` bytes is reached,
+ * when no more data are queued for connection or when send fails.
+ * Event length is then cumulative number of bytes, sent since previous event.
+ * Setting is reset to `0` when connection becomes active
+ *
+ * \note            Application must not count send events, only reported number of bytes
+ * \param[in]       conn: Connection handle
+ * \param[in]       len: Batch size in units of bytes. Set to `0` to report every send command
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_set_send_evt_batch(lwesp_conn_p conn, size_t len) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+
+    lwesp_core_lock();
+    conn->send_evt_batch = len;
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_CONN_SEND_EVT_AGGR || __DOXYGEN__ */
+
+#if LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__
+
+/**
+ * \brief           Track new segment, queued to device buffer with `AT+CIPSENDBUF`
+ * \note            Core must be locked when function is called
+ * \param[in]       conn: Connection handle
+ * \param[in]       seg_id: Segment ID as reported by device
+ * \param[in]       len: Segment length in units of bytes
+ * \return          \ref lwespOK on success, \ref lwespERRMEM if all segment slots are in use
+ */
+lwespr_t
+lwespi_conn_sendbuf_add(lwesp_conn_p conn, uint32_t seg_id, size_t len) {
+    uint8_t w;
+
+    if (conn->sendbuf.cnt >= LWESP_ARRAYSIZE(conn->sendbuf.id)) {
+        return lwespERRMEM;
+    }
+    w = LWESP_U8((conn->sendbuf.r + conn->sendbuf.cnt) % LWESP_ARRAYSIZE(conn->sendbuf.id));
+    conn->sendbuf.id[w] = seg_id;
+    conn->sendbuf.len[w] = len;
+    ++conn->sendbuf.cnt;
+    return lwespOK;
+}
+
+/**
+ * \brief           Release all segments up to and including `seg_id`
+ *                  and notify application with \ref LWESP_EVT_CONN_SEND_ACK event
+ *
+ * Event may be raised from inside another connection callback,
+ * current event data are restored after it has been processed
+ *
+ * \note            Core must be locked when function is called
+ * \param[in]       conn: Connection handle
+ * \param[in]       seg_id: Last segment ID acknowledged by device
+ * \param[in]       res: Acknowledge result
+ */
+void
+lwespi_conn_sendbuf_ack(lwesp_conn_p conn, uint32_t seg_id, lwespr_t res) {
+    size_t len = 0;
+
+    /* Segment IDs are increasing, compare with wrap-around */
+    while (conn->sendbuf.cnt > 0 && (int32_t)(seg_id - conn->sendbuf.id[conn->sendbuf.r]) >= 0) {
+        len += conn->sendbuf.len[conn->sendbuf.r];
+        conn->sendbuf.r = LWESP_U8((conn->sendbuf.r + 1) % LWESP_ARRAYSIZE(conn->sendbuf.id));
+        --conn->sendbuf.cnt;
+    }
+    if (len > 0 && conn->status.f.active) {
+        lwesp_evt_t evt = esp.evt;              /* Save event, which may be in progress */
+
+        esp.evt.type = LWESP_EVT_CONN_SEND_ACK;
+        esp.evt.evt.conn_send_ack.conn = conn;
+        esp.evt.evt.conn_send_ack.len = len;
+        esp.evt.evt.conn_send_ack.res = res;
+        lwespi_send_conn_cb(conn, NULL);
+        esp.evt = evt;
+    }
+}
+
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__ */
+
+#if LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__
+/**
+ * \brief           Check if connection is currently used in passthrough mode
+ * \param[in]       conn: Connection handle
+ * \return          `1` if passthrough, `0` otherwise
+ */
+static uint8_t
+conn_is_passthrough(lwesp_conn_p conn) {
+    uint8_t res;
+
     lwesp_core_lock();
-    val_id = conn->val_id;
+    res = esp.m.passthrough && conn == &esp.m.conns[0];
     lwesp_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Write raw data to AT port for connection in passthrough mode
+ * \param[in]       conn: Connection handle
+ * \param[in]       data: Pointer to data to send
+ * \param[in]       btw: Number of bytes to send
+ * \param[out]      bw: Pointer to output variable to save number of sent data
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+conn_passthrough_send(lwesp_conn_p conn, const void* data, size_t btw, size_t* const bw) {
+    const uint8_t* d = data;
+    size_t sent, total = 0;
+    lwespr_t res = lwespCLOSED;
 
-    return val_id;
+    lwesp_core_lock();
+    if (esp.m.passthrough_exit) {
+        res = lwespINPROG;                      /* AT port must stay silent around exit sequence */
+    } else if (esp.m.passthrough && conn->status.f.active) {
+        res = lwespOK;
+        while (total < btw) {
+            if ((sent = esp.ll.send_fn(&d[total], btw - total)) == 0) {
+                res = lwespERR;                 /* Low-level driver refused data */
+                break;
+            }
+            LWESPI_CAPTURE_TX(&d[total], sent);
+            total += sent;
+        }
+        LWESPI_STATS_UART_TX(total);
+        LWESPI_STATS_CONN_ADD(conn, tx_bytes, total);
+        esp.ll.send_fn(NULL, 0);                /* Flush data */
+    }
+    lwesp_core_unlock();
+    if (bw != NULL) {
+        *bw = total;
+    }
+    return res;
 }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__ */
 
 /**
  * \brief           Send data on already active connection of type UDP to specific remote IP and port
@@ -212,6 +713,7 @@ conn_send(lwesp_conn_p conn, const lwesp_ip_t* const ip, lwesp_port_t port, cons
     }
 
     CONN_CHECK_CLOSED_IN_CLOSING(conn);         /* Check if we can continue */
+    LWESPI_TRACE(CONN_SEND, conn->num, btw);
 
     LWESP_MSG_VAR_ALLOC(msg, blocking);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPSEND;
@@ -224,10 +726,69 @@ conn_send(lwesp_conn_p conn, const lwesp_ip_t* const ip, lwesp_port_t port, cons
     LWESP_MSG_VAR_REF(msg).msg.conn_send.remote_port = port;
     LWESP_MSG_VAR_REF(msg).msg.conn_send.fau = fau;
     LWESP_MSG_VAR_REF(msg).msg.conn_send.val_id = lwespi_conn_get_val_id(conn);
+#if LWESP_CFG_CONN_TX_QUEUE
+    conn_tx_queue_add(&LWESP_MSG_VAR_REF(msg));
+#endif /* LWESP_CFG_CONN_TX_QUEUE */
 
-    return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 60000);
+    return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, LWESPI_PARAM(CONN_SEND_TIMEOUT));
+}
+
+/**
+ * \brief           Send segmented data on already active connection
+ * \param[in]       conn: Pointer to connection to send data
+ * \param[in]       pbuf: Packet buffer chain to send. Set to `NULL` when `iov` is used
+ * \param[in]       iov: Array of segments to send. Set to `NULL` when `pbuf` is used
+ * \param[in]       iov_cnt: Number of entries in `iov` array
+ * \param[in]       btw: Total number of bytes to send
+ * \param[out]      bw: Pointer to output variable to save number of sent data when successfully sent
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+conn_send_segments(lwesp_conn_p conn, lwesp_pbuf_p pbuf, const lwesp_conn_iov_t* iov, size_t iov_cnt,
+                   size_t btw, size_t* const bw, const uint32_t blocking) {
+    LWESP_MSG_VAR_DEFINE(msg);
+
+    if (bw != NULL) {
+        *bw = 0;
+    }
+
+    CONN_CHECK_CLOSED_IN_CLOSING(conn);         /* Check if we can continue */
+    LWESPI_TRACE(CONN_SEND, conn->num, btw);
+
+    LWESP_MSG_VAR_ALLOC(msg, blocking);
+    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPSEND;
+
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.conn = conn;
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.pbuf = pbuf;
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.iov = iov;
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.iov_cnt = iov_cnt;
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.btw = btw;
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.bw = bw;
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.val_id = lwespi_conn_get_val_id(conn);
+#if LWESP_CFG_CONN_TX_QUEUE
+    conn_tx_queue_add(&LWESP_MSG_VAR_REF(msg));
+#endif /* LWESP_CFG_CONN_TX_QUEUE */
+
+    return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, LWESPI_PARAM(CONN_SEND_TIMEOUT));
+}
+
+#if LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 || __DOXYGEN__
+
+/**
+ * \brief           Stop auto-flush timer of connection write buffer
+ * \param[in]       conn: Connection handle
+ */
+static void
+conn_write_flush_stop(lwesp_conn_p conn) {
+    if (conn->write_flush_to != 0) {
+        lwesp_timeout_cancel(conn->write_flush_to);
+        conn->write_flush_to = 0;
+    }
 }
 
+#endif /* LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 || __DOXYGEN__ */
+
 /**
  * \brief           Flush buffer on connection
  * \param[in]       conn: Connection to flush buffer on
@@ -237,6 +798,11 @@ static lwespr_t
 flush_buff(lwesp_conn_p conn) {
     lwespr_t res = lwespOK;
     lwesp_core_lock();
+#if LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0
+    if (conn != NULL) {
+        conn_write_flush_stop(conn);
+    }
+#endif /* LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 */
     if (conn != NULL && conn->buff.buff != NULL) {  /* Do we have something ready? */
         /*
          * If there is nothing to write or if write was not successful,
@@ -248,9 +814,7 @@ flush_buff(lwesp_conn_p conn) {
             res = lwespERR;
         }
         if (res != lwespOK) {
-            LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
-                       "[CONN] Free write buffer: %p\r\n", (void*)conn->buff.buff);
-            lwesp_mem_free_s((void**)&conn->buff.buff);
+            lwespi_conn_buff_free(conn->buff.buff);
         }
         conn->buff.buff = NULL;
     }
@@ -258,6 +822,43 @@ flush_buff(lwesp_conn_p conn) {
     return res;
 }
 
+#if LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 || __DOXYGEN__
+
+/**
+ * \brief           Timeout callback to send partially filled write buffer
+ * \param[in]       arg: Connection handle
+ */
+static void
+conn_write_flush_timeout_cb(void* arg) {
+    lwesp_conn_p conn = arg;
+
+    if (conn->write_flush_to == 0) {            /* Stale timeout, connection was reset in the meantime */
+        return;
+    }
+    conn->write_flush_to = 0;
+    if (conn->status.f.active) {
+        flush_buff(conn);
+    }
+}
+
+/**
+ * \brief           Start auto-flush timer when write buffer holds data
+ *
+ * Timer is not restarted by following writes, to keep latency of first byte bounded
+ *
+ * \param[in]       conn: Connection handle
+ */
+static void
+conn_write_flush_start(lwesp_conn_p conn) {
+    if (conn->write_flush_time > 0 && conn->write_flush_to == 0
+        && conn->buff.buff != NULL && conn->buff.ptr > 0) {
+        /* On failure, data wait in buffer until it is full or flushed */
+        conn->write_flush_to = lwesp_timeout_addex(conn->write_flush_time, conn_write_flush_timeout_cb, conn);
+    }
+}
+
+#endif /* LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 || __DOXYGEN__ */
+
 /**
  * \brief           Initialize connection module
  */
@@ -266,6 +867,65 @@ lwespi_conn_init(void) {
 
 }
 
+/**
+ * \brief           Get next command of connection start sequence after SSL setup step
+ *
+ * SSL connections may set buffer size, authentication configuration
+ * and server name indication for the link before `AT+CIPSTART` is sent.
+ * Buffer size is only set when it differs from last size set on device
+ *
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Connection start message
+ * \param[in]       cmd: Command just finished, or \ref LWESP_CMD_IDLE to get first setup command
+ * \return          Next command to execute, `AT+CIPSTART` when setup is done
+ */
+lwesp_cmd_t
+lwespi_conn_start_next_cmd(lwesp_msg_t* msg, lwesp_cmd_t cmd) {
+    uint8_t step = 0;
+
+    if (msg->msg.conn_start.type != LWESP_CONN_TYPE_SSL) {
+        return LWESP_CMD_TCPIP_CIPSTART;
+    }
+    if (cmd == LWESP_CMD_TCPIP_CIPSSLSIZE) {
+        step = 1;
+    } else if (cmd == LWESP_CMD_TCPIP_CIPSSLCCONF) {
+        step = 2;
+    } else if (cmd == LWESP_CMD_TCPIP_CIPSSLCSNI) {
+        step = 3;
+    }
+    if (step < 1 && msg->msg.conn_start.ssl_buff_size > 0
+        && msg->msg.conn_start.ssl_buff_size != esp.m.ssl_buff_size) {
+        return LWESP_CMD_TCPIP_CIPSSLSIZE;
+    }
+    if (step < 2 && msg->msg.conn_start.ssl_cfg) {
+        return LWESP_CMD_TCPIP_CIPSSLCCONF;
+    }
+    if (step < 3 && msg->msg.conn_start.ssl_sni != NULL) {
+        return LWESP_CMD_TCPIP_CIPSSLCSNI;
+    }
+    return LWESP_CMD_TCPIP_CIPSTART;
+}
+
+/**
+ * \brief           Get first command of connection start sequence
+ *
+ * Link ID is selected from local connection state and `AT+CIPSTART` is sent directly
+ * when device reports connection changes with `+LINK_CONN`.
+ * Status of connections is refreshed with `AT+CIPSTATUS` first when device does not report changes
+ * or when local state is marked stale, after reset, failed close or untracked `+LINK_CONN`
+ *
+ * \return          First command to execute
+ */
+static lwesp_cmd_t
+conn_start_first_cmd(void) {
+    lwesp_cmd_t cmd;
+
+    lwesp_core_lock();
+    cmd = esp.m.link_conn_urc && !esp.m.conn_status_stale ? LWESP_CMD_TCPIP_CIPSTART : LWESP_CMD_TCPIP_CIPSTATUS;
+    lwesp_core_unlock();
+    return cmd;
+}
+
 /**
  * \brief           Start a new connection of specific type
  * \param[out]      conn: Pointer to connection handle to set new connection reference in case of successfully connected
@@ -288,7 +948,7 @@ lwesp_conn_start(lwesp_conn_p* conn, lwesp_conn_type_t type, const char* const r
 
     LWESP_MSG_VAR_ALLOC(msg, blocking);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPSTART;
-    LWESP_MSG_VAR_REF(msg).cmd = LWESP_CMD_TCPIP_CIPSTATUS;
+    LWESP_MSG_VAR_REF(msg).cmd = conn_start_first_cmd();
     LWESP_MSG_VAR_REF(msg).msg.conn_start.num = LWESP_CFG_MAX_CONNS;/* Set maximal value as invalid number */
     LWESP_MSG_VAR_REF(msg).msg.conn_start.conn = conn;
     LWESP_MSG_VAR_REF(msg).msg.conn_start.type = type;
@@ -296,6 +956,7 @@ lwesp_conn_start(lwesp_conn_p* conn, lwesp_conn_type_t type, const char* const r
     LWESP_MSG_VAR_REF(msg).msg.conn_start.remote_port = remote_port;
     LWESP_MSG_VAR_REF(msg).msg.conn_start.evt_func = conn_evt_fn;
     LWESP_MSG_VAR_REF(msg).msg.conn_start.arg = arg;
+    LWESP_MSG_VAR_REF(msg).msg.conn_start.poll_interval = LWESPI_PARAM(CONN_POLL_INTERVAL);
 
     return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 60000);
 }
@@ -321,7 +982,7 @@ lwesp_conn_startex(lwesp_conn_p* conn, lwesp_conn_start_t* start_struct,
 
     LWESP_MSG_VAR_ALLOC(msg, blocking);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPSTART;
-    LWESP_MSG_VAR_REF(msg).cmd = LWESP_CMD_TCPIP_CIPSTATUS;
+    LWESP_MSG_VAR_REF(msg).cmd = conn_start_first_cmd();
     LWESP_MSG_VAR_REF(msg).msg.conn_start.num = LWESP_CFG_MAX_CONNS;/* Set maximal value as invalid number */
     LWESP_MSG_VAR_REF(msg).msg.conn_start.conn = conn;
     LWESP_MSG_VAR_REF(msg).msg.conn_start.type = start_struct->type;
@@ -330,10 +991,39 @@ lwesp_conn_startex(lwesp_conn_p* conn, lwesp_conn_start_t* start_struct,
     LWESP_MSG_VAR_REF(msg).msg.conn_start.local_ip = start_struct->local_ip;
     LWESP_MSG_VAR_REF(msg).msg.conn_start.evt_func = conn_evt_fn;
     LWESP_MSG_VAR_REF(msg).msg.conn_start.arg = arg;
+    if (start_struct->poll_interval == LWESP_CONN_POLL_OFF) {
+        LWESP_MSG_VAR_REF(msg).msg.conn_start.poll_interval = 0;
+    } else if (start_struct->poll_interval == 0) {
+        LWESP_MSG_VAR_REF(msg).msg.conn_start.poll_interval = LWESPI_PARAM(CONN_POLL_INTERVAL);
+    } else {
+        LWESP_MSG_VAR_REF(msg).msg.conn_start.poll_interval = start_struct->poll_interval;
+    }
+
+#if LWESP_CFG_CONN_PASSTHROUGH
+    if (start_struct->passthrough) {            /* Start with switch to single connection mode */
+        LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPMODE;
+        LWESP_MSG_VAR_REF(msg).cmd = LWESP_CMD_TCPIP_CIPMUX;
+        LWESP_MSG_VAR_REF(msg).msg.conn_start.num = 0;
+        LWESP_MSG_VAR_REF(msg).msg.conn_start.passthrough = 1;
+    }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
 
     /* Add connection type specific features */
     if (start_struct->type != LWESP_CONN_TYPE_UDP) {
         LWESP_MSG_VAR_REF(msg).msg.conn_start.tcp_ssl_keep_alive = start_struct->ext.tcp_ssl.keep_alive;
+        if (start_struct->type == LWESP_CONN_TYPE_SSL) {
+            LWESP_MSG_VAR_REF(msg).msg.conn_start.ssl_buff_size = start_struct->ext.tcp_ssl.ssl_buff_size;
+            LWESP_MSG_VAR_REF(msg).msg.conn_start.ssl_cfg = start_struct->ext.tcp_ssl.ssl_cfg;
+            LWESP_MSG_VAR_REF(msg).msg.conn_start.ssl_auth_mode = LWESP_MIN(start_struct->ext.tcp_ssl.ssl_auth_mode, 3);
+            LWESP_MSG_VAR_REF(msg).msg.conn_start.ssl_pki_number = start_struct->ext.tcp_ssl.ssl_pki_number;
+            LWESP_MSG_VAR_REF(msg).msg.conn_start.ssl_ca_number = start_struct->ext.tcp_ssl.ssl_ca_number;
+            LWESP_MSG_VAR_REF(msg).msg.conn_start.ssl_sni = start_struct->ext.tcp_ssl.ssl_sni;
+            if (LWESP_MSG_VAR_REF(msg).cmd == LWESP_CMD_TCPIP_CIPSTART) {   /* SSL setup goes before CIPSTART */
+                lwesp_core_lock();
+                LWESP_MSG_VAR_REF(msg).cmd = lwespi_conn_start_next_cmd(&LWESP_MSG_VAR_REF(msg), LWESP_CMD_IDLE);
+                lwesp_core_unlock();
+            }
+        }
     } else {
         LWESP_MSG_VAR_REF(msg).msg.conn_start.udp_local_port = start_struct->ext.udp.local_port;
         LWESP_MSG_VAR_REF(msg).msg.conn_start.udp_mode = start_struct->ext.udp.mode;
@@ -343,38 +1033,428 @@ lwesp_conn_startex(lwesp_conn_p* conn, lwesp_conn_start_t* start_struct,
 }
 
 /**
- * \brief           Close specific or all connections
- * \param[in]       conn: Connection handle to close. Set to NULL if you want to close all connections.
+ * \brief           Close specific connection
+ * \note            Use \ref lwesp_conn_close_all or \ref lwesp_conn_close_many to close multiple connections
+ * \param[in]       conn: Connection handle to close
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_close(lwesp_conn_p conn, const uint32_t blocking) {
+    lwespr_t res;
+    LWESP_MSG_VAR_DEFINE(msg);
+
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+
+    CONN_CHECK_CLOSED_IN_CLOSING(conn);         /* Check if we can continue */
+
+    /* Proceed with close event at this point! */
+    LWESP_MSG_VAR_ALLOC_CMD(msg, blocking, conn_close);
+    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPCLOSE;
+#if LWESP_CFG_CONN_PASSTHROUGH
+    if (conn_is_passthrough(conn)) {            /* Exit passthrough mode first */
+        LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_PASSTHROUGH_EXIT;
+    }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
+    LWESP_MSG_VAR_REF(msg).msg.conn_close.conn = conn;
+    LWESP_MSG_VAR_REF(msg).msg.conn_close.val_id = lwespi_conn_get_val_id(conn);
+
+    flush_buff(conn);                           /* First flush buffer */
+    res = lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 1000);
+    if (res == lwespOK && !blocking) {          /* Function succedded in non-blocking mode */
+        lwesp_core_lock();
+        LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
+                   "[CONN] Connection %d set to closing state\r\n", (int)conn->num);
+        conn->status.f.in_closing = 1;          /* Connection is in closing mode but not yet closed */
+        lwesp_core_unlock();
+    }
+    return res;
+}
+
+/**
+ * \brief           Close multiple connections with single command message
+ * \param[in]       conns: Array of connections to close. Set to `NULL` to close all connections
+ * \param[in]       count: Number of connections in array. Not used when `conns` is `NULL`
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+conn_close_many(const lwesp_conn_p* conns, size_t count, const uint32_t blocking) {
+    lwespr_t res;
+    size_t cnt = 0;
+    uint8_t stale;
+    LWESP_MSG_VAR_DEFINE(msg);
+
+    LWESP_MSG_VAR_ALLOC_CMD(msg, blocking, conn_close);
+    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPCLOSE;
+    LWESP_MSG_VAR_REF(msg).msg.conn_close.conn = NULL;
+    LWESP_MSG_VAR_REF(msg).msg.conn_close.num = conns == NULL ? LWESPI_CONN_CLOSE_ALL_ID : 0;
+
+    /* Take snapshot of connections to close */
+    lwesp_core_lock();
+    for (size_t i = 0; i < (conns == NULL ? LWESP_CFG_MAX_CONNS : count); ++i) {
+        lwesp_conn_p c = conns == NULL ? &esp.m.conns[i] : conns[i];
+
+        if (c != NULL && lwespi_is_valid_conn_ptr(c) && c->status.f.active
+            && (conns == NULL || !c->status.f.in_closing)) {
+            LWESPI_CONN_BIT_SET(LWESP_MSG_VAR_REF(msg).msg.conn_close.conns, c->num);
+            LWESP_MSG_VAR_REF(msg).msg.conn_close.val_ids[c->num] = c->val_id;
+            ++cnt;
+        }
+    }
+    stale = esp.m.conn_status_stale;
+    lwesp_core_unlock();
+
+    /* Device may hold links unknown to the stack, close all of them in this case */
+    if (cnt == 0 && (conns != NULL || !stale)) {
+        LWESP_MSG_VAR_FREE(msg);
+        return conns == NULL ? lwespOK : lwespCLOSED;
+    }
+    for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+        if (LWESPI_CONN_BIT_GET(LWESP_MSG_VAR_REF(msg).msg.conn_close.conns, i)) {
+            flush_buff(&esp.m.conns[i]);        /* First flush buffer */
+        }
+    }
+
+    res = lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 1000);
+    if (res == lwespOK && !blocking) {          /* Function succedded in non-blocking mode */
+        lwesp_core_lock();
+        for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+            if (LWESPI_CONN_BIT_GET(LWESP_MSG_VAR_REF(msg).msg.conn_close.conns, i)) {
+                esp.m.conns[i].status.f.in_closing = 1;
+            }
+        }
+        lwesp_core_unlock();
+    }
+    return res;
+}
+
+/**
+ * \brief           Close multiple connections
+ *
+ * When connections cover all active connections, they are closed with single `AT+CIPCLOSE` command,
+ * otherwise commands for each connection are executed back-to-back as part of single command message.
+ * \ref LWESP_EVT_CONN_CLOSE event is sent for every connection, on success and on failure
+ *
+ * \param[in]       conns: Array of connection handles to close. Closed or closing connections are ignored
+ * \param[in]       count: Number of connections in array
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, \ref lwespCLOSED if none of connections is active,
+ *                      member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_close_many(const lwesp_conn_p* conns, size_t count, const uint32_t blocking) {
+    LWESP_ASSERT("conns != NULL", conns != NULL);
+    LWESP_ASSERT("count > 0", count > 0);
+
+    return conn_close_many(conns, count, blocking);
+}
+
+/**
+ * \brief           Close all connections with single `AT+CIPCLOSE` command
+ *
+ * Connections not reported closed by device are closed by the stack in single pass,
+ * once command succeeds, each with \ref LWESP_EVT_CONN_CLOSE event
+ *
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_close_all(const uint32_t blocking) {
+    return conn_close_many(NULL, 0, blocking);
+}
+
+/**
+ * \brief           Send packet buffer chain on already active connection without copying it to linear memory
+ *
+ * Every buffer in the chain is streamed to device in sequence.
+ * Packet buffer is not freed by the stack and must stay valid until send operation finishes
+ *
+ * \param[in]       conn: Connection handle to send data
+ * \param[in]       pbuf: Packet buffer chain with data to send
+ * \param[out]      bw: Pointer to output variable to save number of sent data when successfully sent
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_send_pbuf(lwesp_conn_p conn, lwesp_pbuf_p pbuf, size_t* const bw, const uint32_t blocking) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+    LWESP_ASSERT("pbuf != NULL", pbuf != NULL);
+    LWESP_ASSERT("pbuf->tot_len > 0", pbuf->tot_len > 0);
+
+#if LWESP_CFG_CONN_PASSTHROUGH
+    if (conn_is_passthrough(conn)) {            /* Raw data go directly to AT port */
+        lwespr_t res = lwespOK;
+        size_t sent;
+
+        if (bw != NULL) {
+            *bw = 0;
+        }
+        for (; pbuf != NULL && res == lwespOK; pbuf = pbuf->next) {
+            res = conn_passthrough_send(conn, pbuf->payload, pbuf->len, &sent);
+            if (bw != NULL) {
+                *bw += sent;
+            }
+        }
+        LWESP_UNUSED(blocking);
+        return res;
+    }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
+
+    flush_buff(conn);                           /* Keep order with data in write buffer */
+    return conn_send_segments(conn, pbuf, NULL, 0, pbuf->tot_len, bw, blocking);
+}
+
+/**
+ * \brief           Send array of data segments on already active connection without copying them to linear memory
+ *
+ * Segments are streamed to device in sequence, as they were one contiguous block.
+ * Array and segment data must stay valid until send operation finishes
+ *
+ * \param[in]       conn: Connection handle to send data
+ * \param[in]       iov: Array of data segments to send
+ * \param[in]       iov_cnt: Number of entries in `iov` array
+ * \param[out]      bw: Pointer to output variable to save number of sent data when successfully sent
  * \param[in]       blocking: Status whether command should be blocking or not
  * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
  */
 lwespr_t
-lwesp_conn_close(lwesp_conn_p conn, const uint32_t blocking) {
-    lwespr_t res;
-    LWESP_MSG_VAR_DEFINE(msg);
+lwesp_conn_sendv(lwesp_conn_p conn, const lwesp_conn_iov_t* iov, size_t iov_cnt, size_t* const bw,
+               const uint32_t blocking) {
+    size_t btw = 0;
+
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+    LWESP_ASSERT("iov != NULL", iov != NULL);
+    LWESP_ASSERT("iov_cnt > 0", iov_cnt > 0);
+
+    for (size_t i = 0; i < iov_cnt; ++i) {
+        btw += iov[i].len;
+    }
+    LWESP_ASSERT("btw > 0", btw > 0);
+
+#if LWESP_CFG_CONN_PASSTHROUGH
+    if (conn_is_passthrough(conn)) {            /* Raw data go directly to AT port */
+        lwespr_t res = lwespOK;
+        size_t sent;
+
+        if (bw != NULL) {
+            *bw = 0;
+        }
+        for (size_t i = 0; i < iov_cnt && res == lwespOK; ++i) {
+            if (iov[i].len > 0) {
+                res = conn_passthrough_send(conn, iov[i].data, iov[i].len, &sent);
+                if (bw != NULL) {
+                    *bw += sent;
+                }
+            }
+        }
+        LWESP_UNUSED(blocking);
+        return res;
+    }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
+
+    flush_buff(conn);                           /* Keep order with data in write buffer */
+    return conn_send_segments(conn, NULL, iov, iov_cnt, btw, bw, blocking);
+}
+
+#if LWESP_CFG_CONN_SENDFILE || __DOXYGEN__
+
+/**
+ * \brief           Queue single buffer of sendfile transfer
+ * \note            Core must be locked when function is called
+ * \param[in]       conn: Connection handle
+ * \param[in]       buff: Buffer allocated with \ref lwespi_conn_buff_alloc, freed after it is sent
+ * \param[in]       btw: Number of bytes to send
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+conn_sendfile_send(lwesp_conn_p conn, const uint8_t* buff, size_t btw) {
+    LWESP_MSG_VAR_DEFINE(msg);
+
+    LWESPI_TRACE(CONN_SEND, conn->num, btw);
+
+    LWESP_MSG_VAR_ALLOC(msg, 0);
+    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPSEND;
+
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.conn = conn;
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.data = buff;
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.btw = btw;
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.fau = 1;
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.val_id = conn->val_id;
+    LWESP_MSG_VAR_REF(msg).msg.conn_send.sendfile = 1;
+#if LWESP_CFG_CONN_TX_QUEUE
+    conn_tx_queue_add(&LWESP_MSG_VAR_REF(msg));
+#endif /* LWESP_CFG_CONN_TX_QUEUE */
+    ++conn->sendfile.in_flight;                 /* Released with send result or when message is freed */
+
+    /* Buffer is freed by stack only if message was successfully queued */
+    return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, LWESPI_PARAM(CONN_SEND_TIMEOUT));
+}
+
+/**
+ * \brief           Read and queue next buffers of sendfile transfer, up to read-ahead limit
+ * \note            Core must be locked when function is called
+ * \param[in]       conn: Connection handle
+ */
+static void
+conn_sendfile_fill(lwesp_conn_p conn) {
+    size_t len, br;
+    uint8_t* buff;
+
+    if (conn->sendfile.busy) {                  /* Message freed during queue operation */
+        return;
+    }
+    conn->sendfile.busy = 1;
+    if (!conn->status.f.active || conn->status.f.in_closing) {
+        conn->sendfile.res = lwespCLOSED;       /* Read function argument may not be valid anymore */
+    }
+    while (conn->sendfile.res == lwespOK && conn->sendfile.rem > 0
+           && conn->sendfile.in_flight < LWESP_CFG_CONN_SENDFILE_READ_AHEAD) {
+        len = LWESP_MIN(conn->sendfile.rem, LWESPI_CONN_MAX_DATA_LEN());
+        if ((buff = lwespi_conn_buff_alloc(len)) == NULL) {
+            if (conn->sendfile.in_flight == 0) {/* Nothing to retry on when it is sent */
+                conn->sendfile.res = lwespERRMEM;
+            }
+            break;
+        }
+        br = conn->sendfile.read_fn(conn->sendfile.arg, conn->sendfile.offset, buff, len);
+        if (br == 0 || br > len) {
+            lwespi_conn_buff_free(buff);
+            conn->sendfile.res = lwespERR;
+            break;
+        }
+        conn->sendfile.offset += br;
+        conn->sendfile.rem -= br;
+        if (conn_sendfile_send(conn, buff, br) != lwespOK) {
+            lwespi_conn_buff_free(buff);
+            if (conn->sendfile.res == lwespOK) {
+                conn->sendfile.res = lwespERRMEM;
+            }
+            break;
+        }
+    }
+    conn->sendfile.busy = 0;
+}
+
+/**
+ * \brief           Finish sendfile transfer when nothing is in flight anymore
+ * \note            Core must be locked when function is called
+ * \param[in]       conn: Connection handle
+ */
+static void
+conn_sendfile_check_done(lwesp_conn_p conn) {
+    lwesp_api_cmd_evt_fn evt_fn;
+    lwespr_t res;
+
+    if (conn->sendfile.read_fn == NULL || conn->sendfile.busy || conn->sendfile.in_flight > 0
+        || (conn->sendfile.rem > 0 && conn->sendfile.res == lwespOK)) {
+        return;
+    }
+    evt_fn = conn->sendfile.evt_fn;
+    res = conn->sendfile.res;
+    conn->sendfile.read_fn = NULL;              /* Connection accepts new transfer from callback */
+    LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
+               "[CONN] Sendfile finished on conn %d with result %d\r\n", (int)conn->num, (int)res);
+    if (evt_fn != NULL) {
+        evt_fn(res, conn->sendfile.evt_arg);
+    }
+}
+
+/**
+ * \brief           Release send message from sendfile transfer and continue with reading
+ *
+ * Called when send event is reported and again when message is freed,
+ * only first call for the message has an effect
+ *
+ * \param[in]       msg: Message to release, may be of any command type
+ * \param[in]       res: Send result. Message freed without result is reported as error
+ */
+void
+lwespi_conn_sendfile_release(lwesp_msg_t* msg, lwespr_t res) {
+    lwesp_conn_p conn;
+
+    if (msg->cmd_def != LWESP_CMD_TCPIP_CIPSEND || !msg->msg.conn_send.sendfile) {
+        return;
+    }
+    msg->msg.conn_send.sendfile = 0;
+    conn = msg->msg.conn_send.conn;
+
+    lwesp_core_lock();
+    if (conn->val_id == msg->msg.conn_send.val_id && conn->sendfile.read_fn != NULL) {
+        if (conn->sendfile.in_flight > 0) {
+            --conn->sendfile.in_flight;
+        }
+        if (res != lwespOK && conn->sendfile.res == lwespOK) {
+            conn->sendfile.res = res;           /* Stop reading, wait for remaining buffers */
+        }
+        conn_sendfile_fill(conn);
+        conn_sendfile_check_done(conn);
+    }
+    lwesp_core_unlock();
+}
+
+/**
+ * \brief           Send data from user data source, read directly into connection send buffers
+ *
+ * Up to \ref LWESP_CFG_CONN_SENDFILE_READ_AHEAD buffers are read and queued at a time.
+ * Every time one of them is sent, next part of data is read from stack thread.
+ * Each sent buffer is reported with \ref LWESP_EVT_CONN_SEND event.
+ *
+ * \note            Read function is called from stack thread, it should not block for long time
+ * \note            Transfer is not available in passthrough mode
+ * \param[in]       conn: Connection handle to send data
+ * \param[in]       read_fn: Data source read function
+ * \param[in]       arg: Custom argument for read function
+ * \param[in]       offset: Offset of first byte to read
+ * \param[in]       len: Number of bytes to send
+ * \param[in]       evt_fn: Callback function called when all data are sent or transfer failed
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise.
+ *                  Callback function is not called when transfer could not be started
+ */
+lwespr_t
+lwesp_conn_sendfile(lwesp_conn_p conn, lwesp_conn_read_fn read_fn, void* arg, size_t offset, size_t len,
+                    const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg) {
+    lwespr_t res = lwespOK;
 
     LWESP_ASSERT("conn != NULL", conn != NULL);
+    LWESP_ASSERT("read_fn != NULL", read_fn != NULL);
+    LWESP_ASSERT("len > 0", len > 0);
 
-    CONN_CHECK_CLOSED_IN_CLOSING(conn);         /* Check if we can continue */
+#if LWESP_CFG_CONN_PASSTHROUGH
+    if (conn_is_passthrough(conn)) {
+        return lwespERR;
+    }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
 
-    /* Proceed with close event at this point! */
-    LWESP_MSG_VAR_ALLOC(msg, blocking);
-    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPCLOSE;
-    LWESP_MSG_VAR_REF(msg).msg.conn_close.conn = conn;
-    LWESP_MSG_VAR_REF(msg).msg.conn_close.val_id = lwespi_conn_get_val_id(conn);
+    flush_buff(conn);                           /* Keep order with data in write buffer */
 
-    flush_buff(conn);                           /* First flush buffer */
-    res = lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 1000);
-    if (res == lwespOK && !blocking) {          /* Function succedded in non-blocking mode */
-        lwesp_core_lock();
-        LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
-                   "[CONN] Connection %d set to closing state\r\n", (int)conn->num);
-        conn->status.f.in_closing = 1;          /* Connection is in closing mode but not yet closed */
-        lwesp_core_unlock();
+    lwesp_core_lock();
+    if (conn->status.f.in_closing || !conn->status.f.active) {
+        res = lwespCLOSED;
+    } else if (conn->sendfile.read_fn != NULL) {
+        res = lwespINPROG;                      /* Only one transfer per connection */
+    } else {
+        conn->sendfile.read_fn = read_fn;
+        conn->sendfile.arg = arg;
+        conn->sendfile.offset = offset;
+        conn->sendfile.rem = len;
+        conn->sendfile.in_flight = 0;
+        conn->sendfile.res = lwespOK;
+        conn->sendfile.evt_fn = evt_fn;
+        conn->sendfile.evt_arg = evt_arg;
+        conn_sendfile_fill(conn);
+        if (conn->sendfile.in_flight == 0) {    /* Nothing queued, report error to caller only */
+            res = conn->sendfile.res != lwespOK ? conn->sendfile.res : lwespERR;
+            conn->sendfile.read_fn = NULL;
+        }
     }
+    lwesp_core_unlock();
     return res;
 }
 
+#endif /* LWESP_CFG_CONN_SENDFILE || __DOXYGEN__ */
+
 /**
  * \brief           Send data on active connection of type UDP to specific remote IP and port
  * \note            In case IP and port values are not set, it will behave as normal send function (suitable for TCP too)
@@ -416,6 +1496,13 @@ lwesp_conn_send(lwesp_conn_p conn, const void* data, size_t btw, size_t* const b
     LWESP_ASSERT("data != NULL", data != NULL);
     LWESP_ASSERT("btw > 0", btw > 0);
 
+#if LWESP_CFG_CONN_PASSTHROUGH
+    if (conn_is_passthrough(conn)) {            /* Raw data go directly to AT port */
+        LWESP_UNUSED(blocking);
+        return conn_passthrough_send(conn, data, btw, bw);
+    }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
+
     lwesp_core_lock();
     if (conn->buff.buff != NULL) {              /* Check if memory available */
         size_t to_copy;
@@ -460,6 +1547,9 @@ lwesp_conn_recved(lwesp_conn_p conn, lwesp_pbuf_p pbuf) {
         /* Warning here, de-sync happened somewhere! */
     }
     lwespi_conn_manual_tcp_try_read_data(conn); /* Try to read more connection data */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+    conn_manual_tcp_auto_resume();              /* Application released memory */
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
 #else /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
     LWESP_UNUSED(conn);
     LWESP_UNUSED(pbuf);
@@ -467,6 +1557,177 @@ lwesp_conn_recved(lwesp_conn_p conn, lwesp_pbuf_p pbuf) {
     return lwespOK;
 }
 
+/**
+ * \brief           Block or resume manual reading of received data on connection
+ *
+ * While blocked, stack does not read more data from ESP device
+ * and TCP window on device side throttles the remote sender.
+ *
+ * \note            Function is effective only when \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE is enabled
+ * \note            Function is not thread safe and may only be called from connection event function
+ *                  or with core lock acquired
+ *
+ * \param[in]       conn: Connection handle
+ * \param[in]       blocked: Set to `1` to block reading, `0` to resume it
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_set_receive_blocked(lwesp_conn_p conn, uint8_t blocked) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+    conn->status.f.receive_blocked = blocked ? 1 : 0;
+    if (!blocked) {
+        lwespi_conn_manual_tcp_try_read_data(conn); /* Try to read more connection data */
+    }
+#else /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+    LWESP_UNUSED(blocked);
+#endif /* !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+    return lwespOK;
+}
+
+/**
+ * \brief           Set receive window of connection in manual `TCP` receive mode
+ *
+ * Stack does not read more data from ESP device when number of bytes
+ * not yet acknowledged with \ref lwesp_conn_recved reaches window size.
+ * Size of each read is limited to free space in window.
+ * Window is reset to \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_WINDOW when connection becomes active
+ *
+ * \note            Function is effective only when \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE is enabled
+ * \note            Function is not thread safe and may only be called from connection event function
+ *                  or with core lock acquired
+ *
+ * \param[in]       conn: Connection handle
+ * \param[in]       window: Receive window in units of bytes
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_set_receive_window(lwesp_conn_p conn, size_t window) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+    conn->tcp_recv_window = window;
+    lwespi_conn_manual_tcp_try_read_data(conn); /* Window may have grown */
+#else /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+    LWESP_UNUSED(window);
+#endif /* !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+    return lwespOK;
+}
+
+/**
+ * \brief           Set base interval of \ref LWESP_EVT_CONN_POLL event for connection
+ *
+ * Poll interval doubles on each poll without data activity, up to \ref LWESP_CFG_CONN_POLL_INTERVAL_MAX.
+ * Connection with disabled poll does not wake up processing thread when idle.
+ * Interval is reset to \ref LWESP_CFG_CONN_POLL_INTERVAL when server connection becomes active,
+ * client connection uses value from \ref lwesp_conn_start_t structure
+ *
+ * \note            With \ref LWESP_CFG_CONN_MANUAL_TCP_RECEIVE, internal timer keeps running
+ *                  on connection with disabled poll, to retry pending reads
+ *
+ * \param[in]       conn: Connection handle
+ * \param[in]       interval: Poll interval in units of milliseconds. Set to `0` to disable poll events
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_set_poll_interval(lwesp_conn_p conn, uint32_t interval) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+
+    if (interval == LWESP_CONN_POLL_OFF) {
+        interval = 0;
+    }
+    lwesp_core_lock();
+    conn->poll_base = interval;
+    conn->poll_interval = 0;
+    interval = conn_poll_base(conn);
+    if (interval > 0 && conn->status.f.active) {
+        conn->poll_next = lwesp_sys_now() + interval;
+        conn_poll_schedule(conn->poll_next);
+    }
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#if LWESP_CFG_CONN_IPD_FILTER || __DOXYGEN__
+
+/**
+ * \brief           Set filter of received data on connection
+ *
+ * Filter is called for every received packet before memory for it is allocated
+ * and decides how many bytes are delivered to application with \ref LWESP_EVT_CONN_RECV event.
+ * Filter is cleared when connection becomes active, set it in \ref LWESP_EVT_CONN_ACTIVE event
+ *
+ * \param[in]       conn: Connection handle
+ * \param[in]       filter_fn: Filter function. Set to `NULL` to accept all data
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_set_ipd_filter(lwesp_conn_p conn, lwesp_conn_ipd_filter_fn filter_fn) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+
+    lwesp_core_lock();
+    conn->ipd_filter = filter_fn;
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_CONN_IPD_FILTER || __DOXYGEN__ */
+
+#if LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 || __DOXYGEN__
+
+/**
+ * \brief           Set time after which partially filled write buffer of \ref lwesp_conn_write is sent
+ *
+ * Small writes are combined in connection write buffer and sent with single command,
+ * at the latest `time` milliseconds after first byte was written.
+ * Time is reset to \ref LWESP_CFG_CONN_WRITE_FLUSH_TIME when connection becomes active
+ *
+ * \param[in]       conn: Connection handle
+ * \param[in]       time: Time in units of milliseconds. Set to `0` to keep data in buffer until it is full or flushed
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_set_write_flush_time(lwesp_conn_p conn, uint32_t time) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+
+    lwesp_core_lock();
+    conn->write_flush_time = time;
+    if (time == 0) {
+        conn_write_flush_stop(conn);
+    }
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 || __DOXYGEN__ */
+
+#if LWESP_CFG_CMD_PRIORITY || __DOXYGEN__
+
+/**
+ * \brief           Set priority of commands for connection
+ *
+ * Send, close and manual receive commands of connection are queued with this priority.
+ * Priority is reset to \ref LWESP_CMD_PRIO_NORMAL when connection becomes active
+ *
+ * \note            Commands already in queue keep previous priority
+ * \param[in]       conn: Connection handle
+ * \param[in]       prio: Priority class, member of \ref lwesp_cmd_prio_t enumeration
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_set_priority(lwesp_conn_p conn, lwesp_cmd_prio_t prio) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+    LWESP_ASSERT("prio < LWESP_CMD_PRIO_END", prio < LWESP_CMD_PRIO_END);
+
+    lwesp_core_lock();
+    conn->prio = (uint8_t)prio;
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_CMD_PRIORITY || __DOXYGEN__ */
+
 /**
  * \brief           Set argument variable for connection
  * \param[in]       conn: Connection handle to set argument
@@ -482,6 +1743,27 @@ lwesp_conn_set_arg(lwesp_conn_p conn, void* const arg) {
     return lwespOK;
 }
 
+/**
+ * \brief           Set callback function for connection events
+ *
+ * Used to take over connection not started by application,
+ * such as one reported with \ref LWESP_EVT_CONN_RESYNC event
+ *
+ * \param[in]       conn: Connection handle
+ * \param[in]       evt_fn: Connection event callback function
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_set_evt_fn(lwesp_conn_p conn, lwesp_evt_fn evt_fn) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+    LWESP_ASSERT("evt_fn != NULL", evt_fn != NULL);
+
+    lwesp_core_lock();
+    conn->evt_func = evt_fn;
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
 /**
  * \brief           Get user defined connection argument
  * \param[in]       conn: Connection handle to get argument
@@ -602,7 +1884,7 @@ lwespr_t
 lwesp_conn_set_ssl_buffersize(size_t size, const uint32_t blocking) {
     LWESP_MSG_VAR_DEFINE(msg);
 
-    LWESP_MSG_VAR_ALLOC(msg, blocking);
+    LWESP_MSG_VAR_ALLOC_CMD(msg, blocking, tcpip_sslsize);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPSSLSIZE;
     LWESP_MSG_VAR_REF(msg).msg.tcpip_sslsize.size = size;
 
@@ -627,28 +1909,33 @@ lwesp_conn_get_from_evt(lwesp_evt_t* evt) {
             return lwesp_evt_conn_send_get_conn(evt);
         case LWESP_EVT_CONN_POLL:
             return lwesp_evt_conn_poll_get_conn(evt);
+#if LWESP_CFG_CONN_TX_QUEUE
+        case LWESP_EVT_CONN_TX_WATERMARK:
+            return lwesp_evt_conn_tx_watermark_get_conn(evt);
+#endif /* LWESP_CFG_CONN_TX_QUEUE */
+#if LWESP_CFG_CONN_SEND_BUFFERED
+        case LWESP_EVT_CONN_SEND_ACK:
+            return lwesp_evt_conn_send_ack_get_conn(evt);
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED */
         default:
             return NULL;
     }
 }
 
 /**
- * \brief           Write data to connection buffer and if it is full, send it non-blocking way
- * \note            This function may only be called from core (connection callbacks)
+ * \brief           Write data to connection buffer and send full buffers
  * \param[in]       conn: Connection to write
- * \param[in]       data: Data to copy to write buffer
+ * \param[in]       data: Data to write
  * \param[in]       btw: Number of bytes to write
- * \param[in]       flush: Flush flag. Set to `1` if you want to send data immediately after copying
- * \param[out]      mem_available: Available memory size available in current write buffer.
- *                  When the buffer length is reached, current one is sent and a new one is automatically created.
- *                  If function returns \ref lwespOK and `*mem_available = 0`, there was a problem
- *                  allocating a new buffer for next operation
+ * \param[in]       flush: Flush flag. Set to `1` to send data immediately after copying
+ * \param[out]      mem_available: Available memory size in current write buffer
+ * \param[in]       by_ref: Set to `1` to send full size blocks directly from `data` memory
  * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
  */
-lwespr_t
-lwesp_conn_write(lwesp_conn_p conn, const void* data, size_t btw, uint8_t flush,
-               size_t* const mem_available) {
-    size_t len;
+static lwespr_t
+conn_write(lwesp_conn_p conn, const void* data, size_t btw, uint8_t flush,
+           size_t* const mem_available, uint8_t by_ref) {
+    size_t len, max_len = LWESPI_CONN_MAX_DATA_LEN();
 
     const uint8_t* d = data;
 
@@ -678,40 +1965,47 @@ lwesp_conn_write(lwesp_conn_p conn, const void* data, size_t btw, uint8_t flush,
 
         /* Step 1.1 */
         if (conn->buff.ptr == conn->buff.len || flush) {
+#if LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0
+            conn_write_flush_stop(conn);
+#endif /* LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 */
             /* Try to send to processing queue in non-blocking way */
             if (conn_send(conn, NULL, 0, conn->buff.buff, conn->buff.ptr, NULL, 1, 0) != lwespOK) {
-                LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
-                           "[CONN] Free write buffer: %p\r\n", conn->buff.buff);
-                lwesp_mem_free_s((void**)&conn->buff.buff);
+                lwespi_conn_buff_free(conn->buff.buff);
             }
             conn->buff.buff = NULL;
         }
     }
 
     /* Step 2 */
-    while (btw >= LWESP_CFG_CONN_MAX_DATA_LEN) {
+    if (by_ref && btw >= max_len) {
+        len = btw - btw % max_len;              /* All full size blocks with single command */
+        if (conn_send(conn, NULL, 0, d, len, NULL, 0, 0) != lwespOK) {
+            return lwespERRMEM;
+        }
+        btw -= len;
+        d += len;
+    }
+    while (btw >= max_len) {
         uint8_t* buff;
-        buff = lwesp_mem_malloc(sizeof(*buff) * LWESP_CFG_CONN_MAX_DATA_LEN);
+        buff = lwespi_conn_buff_alloc(max_len);
         if (buff != NULL) {
-            LWESP_MEMCPY(buff, d, LWESP_CFG_CONN_MAX_DATA_LEN); /* Copy data to buffer */
-            if (conn_send(conn, NULL, 0, buff, LWESP_CFG_CONN_MAX_DATA_LEN, NULL, 1, 0) != lwespOK) {
-                LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
-                           "[CONN] Free write buffer: %p\r\n", (void*)buff);
-                lwesp_mem_free_s((void**)&buff);
+            LWESP_MEMCPY(buff, d, max_len);     /* Copy data to buffer */
+            if (conn_send(conn, NULL, 0, buff, max_len, NULL, 1, 0) != lwespOK) {
+                lwespi_conn_buff_free(buff);
                 return lwespERRMEM;
             }
         } else {
             return lwespERRMEM;
         }
 
-        btw -= LWESP_CFG_CONN_MAX_DATA_LEN;     /* Decrease remaining length */
-        d += LWESP_CFG_CONN_MAX_DATA_LEN;       /* Advance data pointer */
+        btw -= max_len;                         /* Decrease remaining length */
+        d += max_len;                           /* Advance data pointer */
     }
 
     /* Step 3 */
     if (conn->buff.buff == NULL) {
-        conn->buff.buff = lwesp_mem_malloc(sizeof(*conn->buff.buff) * LWESP_CFG_CONN_MAX_DATA_LEN);
-        conn->buff.len = LWESP_CFG_CONN_MAX_DATA_LEN;
+        conn->buff.buff = lwespi_conn_buff_alloc(max_len);
+        conn->buff.len = max_len;
         conn->buff.ptr = 0;
 
         LWESP_DEBUGW(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE, conn->buff.buff != NULL,
@@ -732,6 +2026,9 @@ lwesp_conn_write(lwesp_conn_p conn, const void* data, size_t btw, uint8_t flush,
     if (flush && conn->buff.buff != NULL) {
         flush_buff(conn);
     }
+#if LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0
+    conn_write_flush_start(conn);               /* Send remaining data later if not flushed */
+#endif /* LWESP_CFG_CONN_WRITE_FLUSH_TIME > 0 */
 
     /* Calculate number of available memory after write operation */
     if (mem_available != NULL) {
@@ -744,6 +2041,47 @@ lwesp_conn_write(lwesp_conn_p conn, const void* data, size_t btw, uint8_t flush,
     return lwespOK;
 }
 
+/**
+ * \brief           Write data to connection buffer and if it is full, send it non-blocking way
+ * \note            This function may only be called from core (connection callbacks)
+ * \param[in]       conn: Connection to write
+ * \param[in]       data: Data to copy to write buffer
+ * \param[in]       btw: Number of bytes to write
+ * \param[in]       flush: Flush flag. Set to `1` if you want to send data immediately after copying
+ * \param[out]      mem_available: Available memory size available in current write buffer.
+ *                  When the buffer length is reached, current one is sent and a new one is automatically created.
+ *                  If function returns \ref lwespOK and `*mem_available = 0`, there was a problem
+ *                  allocating a new buffer for next operation
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_write(lwesp_conn_p conn, const void* data, size_t btw, uint8_t flush,
+               size_t* const mem_available) {
+    return conn_write(conn, data, btw, flush, mem_available, 0);
+}
+
+/**
+ * \brief           Write data to connection buffer, send full size blocks directly from caller memory
+ *
+ * Works as \ref lwesp_conn_write, except that blocks of \ref lwesp_conn_get_max_data_len bytes
+ * are not copied to write buffers, but sent by reference. Only head and tail of data are copied.
+ *
+ * \note            This function may only be called from core (connection callbacks)
+ * \note            Caller guarantees `data` memory stays valid and unchanged
+ *                  until \ref LWESP_EVT_CONN_SEND event for it is received
+ * \param[in]       conn: Connection to write
+ * \param[in]       data: Data to write
+ * \param[in]       btw: Number of bytes to write
+ * \param[in]       flush: Flush flag. Set to `1` if you want to send data immediately after copying
+ * \param[out]      mem_available: Available memory size available in current write buffer
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_write_ref(lwesp_conn_p conn, const void* data, size_t btw, uint8_t flush,
+                   size_t* const mem_available) {
+    return conn_write(conn, data, btw, flush, mem_available, 1);
+}
+
 /**
  * \brief           Get total number of bytes ever received on connection and sent to user
  * \param[in]       conn: Connection handle
@@ -761,6 +2099,121 @@ lwesp_conn_get_total_recved_count(lwesp_conn_p conn) {
     return tot;
 }
 
+/**
+ * \brief           Get maximal number of bytes sent to device with single command
+ *
+ * Value equals \ref LWESP_CFG_CONN_MAX_DATA_LEN, or is larger when device firmware
+ * supports it and \ref LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT allows it.
+ * Writing data in multiples of this value gives best throughput
+ *
+ * \return          Maximal data length in units of bytes
+ */
+size_t
+lwesp_conn_get_max_data_len(void) {
+    size_t len;
+
+    lwesp_core_lock();
+    len = LWESPI_CONN_MAX_DATA_LEN();
+    lwesp_core_unlock();
+    return len;
+}
+
+#if LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__
+
+/**
+ * \brief           Get number of bytes accepted by send functions and not yet reported as sent
+ *
+ * Data still in connection write buffer of \ref lwesp_conn_write are not included
+ *
+ * \param[in]       conn: Connection handle
+ * \return          Number of queued bytes
+ */
+size_t
+lwesp_conn_get_tx_queued(lwesp_conn_p conn) {
+    size_t queued = 0;
+
+    if (conn != NULL) {
+        lwesp_core_lock();
+        queued = conn->tx_queued;
+        lwesp_core_unlock();
+    }
+    return queued;
+}
+
+/**
+ * \brief           Set send queue watermarks for connection
+ *
+ * \ref LWESP_EVT_CONN_TX_WATERMARK event is sent when queue reaches `high` bytes
+ * and again when it drops to `low` bytes or below.
+ * Watermarks are reset to \ref LWESP_CFG_CONN_TX_QUEUE_HIGH and \ref LWESP_CFG_CONN_TX_QUEUE_LOW
+ * when connection becomes active
+ *
+ * \param[in]       conn: Connection handle
+ * \param[in]       high: High watermark in units of bytes. Set to `0` to disable events
+ * \param[in]       low: Low watermark in units of bytes, must be lower than `high`
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_conn_set_tx_watermark(lwesp_conn_p conn, size_t high, size_t low) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+    LWESP_ASSERT("high == 0 || low < high", high == 0 || low < high);
+
+    lwesp_core_lock();
+    conn->tx_wm_high = high;
+    conn->tx_wm_low = low;
+    conn->status.f.tx_wm_is_high = 0;           /* Next crossing is reported against new levels */
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__ */
+
+/**
+ * \brief           Get generation tagged handle of connection
+ *
+ * Handle may be stored instead of connection pointer
+ * and checked later with \ref lwesp_conn_from_handle without core lock
+ *
+ * \param[in]       conn: Connection handle
+ * \return          Connection handle, `0` if connection is not valid
+ */
+lwesp_conn_handle_t
+lwesp_conn_get_handle(lwesp_conn_p conn) {
+    uint32_t gen;
+
+    if (conn == NULL || !lwespi_is_valid_conn_ptr(conn)
+        || (gen = lwespi_conn_get_val_id(conn)) == 0) {
+        return 0;
+    }
+    return (lwesp_conn_handle_t)((gen << LWESPI_CONN_HANDLE_NUM_BITS) | conn->num);
+}
+
+/**
+ * \brief           Get connection from generation tagged handle
+ *
+ * Check takes constant time and does not lock the core.
+ * Connection is returned only if it has not been closed and reused since handle was taken.
+ * It may still be closed at any time later, which is reported by connection functions
+ *
+ * \param[in]       handle: Handle from \ref lwesp_conn_get_handle
+ * \return          Connection handle on success, `NULL` if handle is stale or invalid
+ */
+lwesp_conn_p
+lwesp_conn_from_handle(lwesp_conn_handle_t handle) {
+    uint32_t num = handle & ((1UL << LWESPI_CONN_HANDLE_NUM_BITS) - 1);
+    lwesp_conn_p conn;
+
+    if (handle == 0 || num >= LWESP_ARRAYSIZE(esp.m.conns)) {
+        return NULL;
+    }
+    conn = &esp.m.conns[num];
+    if (lwespi_conn_get_val_id(conn) != (handle >> LWESPI_CONN_HANDLE_NUM_BITS)
+        || !((volatile lwesp_conn_t*)conn)->status.f.active) {
+        return NULL;
+    }
+    return conn;
+}
+
 /**
  * \brief           Get connection remote IP address
  * \param[in]       conn: Connection handle
@@ -37,8 +37,190 @@
 
 #if LWESP_CFG_DNS || __DOXYGEN__
 
+#if LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__
+
+/**
+ * \brief           Find valid cache entry for host name
+ *
+ * Expired entries found during search are released
+ *
+ * \note            Function must be called with core locked
+ * \param[in]       host: Host name to search for
+ * \return          Pointer to entry on success, `NULL` otherwise
+ */
+static lwespi_dns_cache_entry_t*
+dns_cache_find(const char* host) {
+    uint32_t now = lwesp_sys_now();
+
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(esp.dns_cache); ++i) {
+        lwespi_dns_cache_entry_t* e = &esp.dns_cache[i];
+
+        if (e->host[0] == '\0') {
+            continue;
+        }
+        if ((uint32_t)(now - e->time) >= LWESP_CFG_DNS_CACHE_TTL) {
+            e->host[0] = '\0';                  /* Entry expired */
+        } else if (!strcmp(e->host, host)) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Get cached IP address of host name
+ * \note            Function must be called with core locked
+ * \param[in]       host: Host name to get IP for
+ * \param[out]      ip: Pointer to output variable to save IP
+ * \return          `1` when valid address is in cache, `0` otherwise
+ */
+uint8_t
+lwespi_dns_cache_get(const char* host, lwesp_ip_t* ip) {
+    lwespi_dns_cache_entry_t* e;
+
+    if ((e = dns_cache_find(host)) == NULL) {
+        return 0;
+    }
+    e->used = lwesp_sys_now();
+    *ip = e->ip;
+    return 1;
+}
+
+/**
+ * \brief           Save resolved IP address of host name to cache
+ *
+ * Existing entry is refreshed, otherwise free or least recently used entry is replaced
+ *
+ * \note            Function must be called with core locked
+ * \param[in]       host: Host name
+ * \param[in]       ip: Resolved IP address
+ */
+void
+lwespi_dns_cache_put(const char* host, const lwesp_ip_t* ip) {
+    lwespi_dns_cache_entry_t* e;
+    size_t len = strlen(host);
+
+    if (len == 0 || len >= LWESP_CFG_DNS_CACHE_HOST_LEN) {
+        return;                                 /* Host name cannot be cached */
+    }
+    if ((e = dns_cache_find(host)) == NULL) {
+        e = &esp.dns_cache[0];
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(esp.dns_cache) && e->host[0] != '\0'; ++i) {
+            if (esp.dns_cache[i].host[0] == '\0'
+                || (int32_t)(esp.dns_cache[i].used - e->used) < 0) {
+                e = &esp.dns_cache[i];
+            }
+        }
+        LWESP_MEMCPY(e->host, host, len + 1);
+    }
+    e->ip = *ip;
+    e->time = e->used = lwesp_sys_now();
+}
+
+/**
+ * \brief           Remove host name from cache, when its cached address did not work
+ * \note            Function must be called with core locked
+ * \param[in]       host: Host name
+ */
+void
+lwespi_dns_cache_remove(const char* host) {
+    lwespi_dns_cache_entry_t* e;
+
+    if ((e = dns_cache_find(host)) != NULL) {
+        e->host[0] = '\0';
+    }
+}
+
+/**
+ * \brief           Remove all entries from host-side DNS cache
+ *
+ * Next \ref lwesp_dns_gethostbyname calls resolve host names on device again
+ */
+void
+lwesp_dns_cache_flush(void) {
+    lwesp_core_lock();
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(esp.dns_cache); ++i) {
+        esp.dns_cache[i].host[0] = '\0';
+    }
+    lwesp_core_unlock();
+}
+
+/**
+ * \brief           Select next host name of prefetch list which is not yet in cache
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Prefetch message
+ * \return          `1` when host name to resolve has been set, `0` when list is finished
+ */
+uint8_t
+lwespi_dns_prefetch_next(lwesp_msg_t* msg) {
+    lwesp_ip_t ip;
+    const char* host;
+
+    while (msg->msg.dns_getbyhostname.hosts_idx < msg->msg.dns_getbyhostname.hosts_len) {
+        host = msg->msg.dns_getbyhostname.hosts[msg->msg.dns_getbyhostname.hosts_idx++];
+        if (host != NULL && strlen(host) < LWESP_CFG_DNS_CACHE_HOST_LEN && !lwespi_dns_cache_get(host, &ip)) {
+            msg->msg.dns_getbyhostname.host = host;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Resolve list of host names to DNS cache, ahead of connections to them
+ *
+ * Host names not yet in cache are resolved back-to-back within single command,
+ * so other commands do not wait between them. With \ref LWESP_CFG_CMD_PRIORITY enabled,
+ * command has low priority and runs when there is nothing more urgent to do.
+ *
+ * \note            Number of host names kept in cache is limited to \ref LWESP_CFG_DNS_CACHE_SIZE
+ * \param[in]       hosts: Array of host names. Array and strings must stay valid until command finishes
+ * \param[in]       hosts_len: Number of host names in array
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise.
+ *                      Command fails when any of host names could not be resolved
+ */
+lwespr_t
+lwesp_dns_prefetch(const char* const* hosts, size_t hosts_len,
+                   const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWESP_MSG_VAR_DEFINE(msg);
+    uint8_t pending;
+
+    LWESP_ASSERT("hosts != NULL", hosts != NULL);
+    LWESP_ASSERT("hosts_len > 0", hosts_len > 0);
+
+    LWESP_MSG_VAR_ALLOC(msg, blocking);
+    LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPDOMAIN;
+    LWESP_MSG_VAR_REF(msg).msg.dns_getbyhostname.hosts = hosts;
+    LWESP_MSG_VAR_REF(msg).msg.dns_getbyhostname.hosts_len = hosts_len;
+    LWESP_MSG_VAR_REF(msg).msg.dns_getbyhostname.ip = &LWESP_MSG_VAR_REF(msg).msg.dns_getbyhostname.ip_tmp;
+
+    lwesp_core_lock();
+    pending = lwespi_dns_prefetch_next(&LWESP_MSG_VAR_REF(msg));
+    lwesp_core_unlock();
+    if (!pending) {                             /* All host names are already cached */
+        LWESP_MSG_VAR_FREE(msg);
+        if (evt_fn != NULL) {
+            evt_fn(lwespOK, evt_arg);
+        }
+        return lwespOK;
+    }
+    return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, LWESP_U32(20000 * hosts_len));
+}
+
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 || __DOXYGEN__ */
+
 /**
  * \brief           Get IP address from host name
+ *
+ * When \ref LWESP_CFG_DNS_CACHE_SIZE is enabled and host is in cache,
+ * address is returned immediately without command to device.
+ * In this case `evt_fn` is called before function returns
+ * and \ref LWESP_EVT_DNS_HOSTBYNAME event is not sent
+ *
  * \param[in]       host: Pointer to host name to get IP for
  * \param[out]      ip: Pointer to \ref lwesp_ip_t variable to save IP
  * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
@@ -50,10 +232,25 @@ lwespr_t
 lwesp_dns_gethostbyname(const char* host, lwesp_ip_t* const ip,
                       const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
     LWESP_MSG_VAR_DEFINE(msg);
+#if LWESP_CFG_DNS_CACHE_SIZE > 0
+    uint8_t cached;
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 */
 
     LWESP_ASSERT("host != NULL", host != NULL);
     LWESP_ASSERT("ip != NULL", ip != NULL);
 
+#if LWESP_CFG_DNS_CACHE_SIZE > 0
+    lwesp_core_lock();
+    cached = lwespi_dns_cache_get(host, ip);
+    lwesp_core_unlock();
+    if (cached) {
+        if (evt_fn != NULL) {
+            evt_fn(lwespOK, evt_arg);
+        }
+        return lwespOK;
+    }
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 */
+
     LWESP_MSG_VAR_ALLOC(msg, blocking);
     LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_TCPIP_CIPDOMAIN;
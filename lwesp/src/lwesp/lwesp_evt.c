@@ -35,13 +35,68 @@
 #include "lwesp/lwesp_evt.h"
 #include "lwesp/lwesp_mem.h"
 
+#if LWESP_CFG_STATIC_ONLY
+static lwesp_evt_func_t evt_func_pool[LWESP_CFG_EVT_FUNC_POOL_SIZE];   /*!< Static pool of registered functions */
+static lwesp_evt_func_t* evt_func_pool_free;    /*!< List of free pool entries, linked with `next` */
+static uint8_t evt_func_pool_initialized;
+#if LWESP_CFG_EVT_DEFERRED
+static lwesp_evt_deferred_t evt_deferred_pool[LWESP_CFG_EVT_DEFERRED_QUEUE_LEN];   /*!< Static pool of queued events */
+static lwesp_evt_deferred_t* evt_deferred_pool_free[LWESP_CFG_EVT_DEFERRED_QUEUE_LEN];
+static size_t evt_deferred_pool_free_cnt;
+static uint8_t evt_deferred_pool_initialized;
+#endif /* LWESP_CFG_EVT_DEFERRED */
+#endif /* LWESP_CFG_STATIC_ONLY */
+
+/**
+ * \brief           Allocate entry for registered function
+ * \note            Core must be locked when function is called
+ * \return          New entry on success, `NULL` otherwise
+ */
+static lwesp_evt_func_t*
+evt_func_alloc(void) {
+#if LWESP_CFG_STATIC_ONLY
+    lwesp_evt_func_t* func;
+
+    if (!evt_func_pool_initialized) {
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(evt_func_pool); ++i) {
+            evt_func_pool[i].next = evt_func_pool_free;
+            evt_func_pool_free = &evt_func_pool[i];
+        }
+        evt_func_pool_initialized = 1;
+    }
+    if ((func = evt_func_pool_free) != NULL) {
+        evt_func_pool_free = func->next;
+    }
+    return func;
+#else /* LWESP_CFG_STATIC_ONLY */
+    return lwesp_mem_malloc(sizeof(lwesp_evt_func_t));
+#endif /* !LWESP_CFG_STATIC_ONLY */
+}
+
 /**
- * \brief           Register event function for global (non-connection based) events
+ * \brief           Free entry of registered function
+ * \note            Core must be locked when function is called
+ * \param[in]       func: Entry to free
+ */
+static void
+evt_func_free(lwesp_evt_func_t* func) {
+#if LWESP_CFG_STATIC_ONLY
+    func->next = evt_func_pool_free;
+    evt_func_pool_free = func;
+#else /* LWESP_CFG_STATIC_ONLY */
+    lwesp_mem_free(func);
+#endif /* !LWESP_CFG_STATIC_ONLY */
+}
+
+/**
+ * \brief           Add function to list of global event functions
  * \param[in]       fn: Callback function to call on specific event
+ * \param[in]       mask: Mask of event types
+ * \param[in]       deferred: Set to `1` to call function from deferred queue
  * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
  */
-lwespr_t
-lwesp_evt_register(lwesp_evt_fn fn) {
+static lwespr_t
+evt_register(lwesp_evt_fn fn, uint32_t mask, uint8_t deferred) {
     lwespr_t res = lwespOK;
     lwesp_evt_func_t* func, *new_func;
 
@@ -58,16 +113,23 @@ lwesp_evt_register(lwesp_evt_fn fn) {
     }
 
     if (res == lwespOK) {
-        new_func = lwesp_mem_malloc(sizeof(*new_func));
+        new_func = evt_func_alloc();
         if (new_func != NULL) {
             LWESP_MEMSET(new_func, 0x00, sizeof(*new_func));
             new_func->fn = fn;                  /* Set function pointer */
+            new_func->mask = mask;
+#if LWESP_CFG_EVT_DEFERRED
+            new_func->deferred = deferred;
+#else /* LWESP_CFG_EVT_DEFERRED */
+            LWESP_UNUSED(deferred);
+#endif /* !LWESP_CFG_EVT_DEFERRED */
             for (func = esp.evt_func; func != NULL && func->next != NULL; func = func->next) {}
             if (func != NULL) {
                 func->next = new_func;          /* Set new function as next */
+                esp.evt_dispatch_dirty = 1;     /* Rebuild dispatch table */
                 res = lwespOK;
             } else {
-                lwesp_mem_free_s((void**)&new_func);
+                evt_func_free(new_func);
                 res = lwespERRMEM;
             }
         } else {
@@ -78,6 +140,113 @@ lwesp_evt_register(lwesp_evt_fn fn) {
     return res;
 }
 
+/**
+ * \brief           Register event function for global (non-connection based) events
+ * \param[in]       fn: Callback function to call on specific event
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_evt_register(lwesp_evt_fn fn) {
+    return lwesp_evt_register_ex(fn, LWESP_EVT_MASK_ALL);
+}
+
+/**
+ * \brief           Register event function for selected global events only
+ *
+ * Function is only called for event types set in `mask`,
+ * which avoids calls for high-rate events listener is not interested in.
+ *
+ * \param[in]       fn: Callback function to call on specific event
+ * \param[in]       mask: Mask of event types, built with \ref LWESP_EVT_MASK macro.
+ *                      Use \ref LWESP_EVT_MASK_ALL to subscribe to all events
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_evt_register_ex(lwesp_evt_fn fn, uint32_t mask) {
+    return evt_register(fn, mask, 0);
+}
+
+#if LWESP_CFG_EVT_DEFERRED || __DOXYGEN__
+
+/**
+ * \brief           Allocate deferred event queue entry
+ * \note            Core must be locked when function is called
+ * \return          New entry on success, `NULL` otherwise
+ */
+lwesp_evt_deferred_t*
+lwespi_evt_deferred_alloc(void) {
+#if LWESP_CFG_STATIC_ONLY
+    if (!evt_deferred_pool_initialized) {
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(evt_deferred_pool); ++i) {
+            evt_deferred_pool_free[i] = &evt_deferred_pool[i];
+        }
+        evt_deferred_pool_free_cnt = LWESP_ARRAYSIZE(evt_deferred_pool);
+        evt_deferred_pool_initialized = 1;
+    }
+    return evt_deferred_pool_free_cnt > 0 ? evt_deferred_pool_free[--evt_deferred_pool_free_cnt] : NULL;
+#else /* LWESP_CFG_STATIC_ONLY */
+    return lwesp_mem_malloc(sizeof(lwesp_evt_deferred_t));
+#endif /* !LWESP_CFG_STATIC_ONLY */
+}
+
+/**
+ * \brief           Free deferred event queue entry
+ * \param[in]       item: Entry to free
+ */
+void
+lwespi_evt_deferred_free(lwesp_evt_deferred_t* item) {
+#if LWESP_CFG_STATIC_ONLY
+    lwesp_core_lock();
+    evt_deferred_pool_free[evt_deferred_pool_free_cnt++] = item;
+    lwesp_core_unlock();
+#else /* LWESP_CFG_STATIC_ONLY */
+    lwesp_mem_free(item);
+#endif /* !LWESP_CFG_STATIC_ONLY */
+}
+
+/**
+ * \brief           Register event function called from application thread instead of processing thread
+ *
+ * Events are copied to queue and function is called by \ref lwesp_evt_deferred_process.
+ * Slow listener does not stall processing of AT responses this way.
+ *
+ * \note            Pointers in event structure (strings, user arrays) are not copied
+ *                  and may only be valid while originating operation is in progress
+ * \param[in]       fn: Callback function to call on specific event
+ * \param[in]       mask: Mask of event types, built with \ref LWESP_EVT_MASK macro
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_evt_register_deferred(lwesp_evt_fn fn, uint32_t mask) {
+    return evt_register(fn, mask, 1);
+}
+
+/**
+ * \brief           Deliver queued events to deferred listeners
+ *
+ * Function waits for first event and then delivers all queued events.
+ * Listeners are called from caller thread, without core lock.
+ *
+ * \param[in]       timeout: Maximal time to wait for first event in units of milliseconds.
+ *                      Set to `0` to wait forever
+ * \return          \ref lwespOK when at least one event was delivered, \ref lwespTIMEOUT otherwise
+ */
+lwespr_t
+lwesp_evt_deferred_process(uint32_t timeout) {
+    lwesp_evt_deferred_t* item;
+
+    if (lwesp_sys_mbox_get(&esp.mbox_evt_deferred, (void**)&item, timeout) == LWESP_SYS_TIMEOUT) {
+        return lwespTIMEOUT;
+    }
+    do {
+        item->fn(&item->evt);
+        lwespi_evt_deferred_free(item);
+    } while (lwesp_sys_mbox_getnow(&esp.mbox_evt_deferred, (void**)&item));
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_EVT_DEFERRED || __DOXYGEN__ */
+
 /**
  * \brief           Unregister callback function for global (non-connection based) events
  * \note            Function must be first registered using \ref lwesp_evt_register
@@ -94,7 +263,8 @@ lwesp_evt_unregister(lwesp_evt_fn fn) {
     for (prev = esp.evt_func, func = esp.evt_func->next; func != NULL; prev = func, func = func->next) {
         if (func->fn == fn) {
             prev->next = func->next;
-            lwesp_mem_free_s((void**)&func);
+            evt_func_free(func);
+            esp.evt_dispatch_dirty = 1;         /* Rebuild dispatch table */
             break;
         }
     }
@@ -306,6 +476,88 @@ lwesp_evt_conn_poll_get_conn(lwesp_evt_t* cc) {
     return cc->evt.conn_poll.conn;
 }
 
+#if LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__
+
+/**
+ * \brief           Get connection handle
+ * \param[in]       cc: Event handle
+ * \return          Connection handle
+ */
+lwesp_conn_p
+lwesp_evt_conn_tx_watermark_get_conn(lwesp_evt_t* cc) {
+    return cc->evt.conn_tx_watermark.conn;
+}
+
+/**
+ * \brief           Get number of bytes in connection send queue at the time of event
+ * \param[in]       cc: Event handle
+ * \return          Number of queued bytes
+ */
+size_t
+lwesp_evt_conn_tx_watermark_get_queued(lwesp_evt_t* cc) {
+    return cc->evt.conn_tx_watermark.queued;
+}
+
+/**
+ * \brief           Check if high watermark was reached
+ * \param[in]       cc: Event handle
+ * \return          `1` when high watermark was reached, `0` when queue dropped to low watermark
+ */
+uint8_t
+lwesp_evt_conn_tx_watermark_is_high(lwesp_evt_t* cc) {
+    return cc->evt.conn_tx_watermark.high;
+}
+
+#endif /* LWESP_CFG_CONN_TX_QUEUE || __DOXYGEN__ */
+
+#if LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__
+
+/**
+ * \brief           Get connection handle
+ * \param[in]       cc: Event handle
+ * \return          Connection handle
+ */
+lwesp_conn_p
+lwesp_evt_conn_send_ack_get_conn(lwesp_evt_t* cc) {
+    return cc->evt.conn_send_ack.conn;
+}
+
+/**
+ * \brief           Get number of bytes acknowledged by remote side
+ * \param[in]       cc: Event handle
+ * \return          Number of acknowledged bytes
+ */
+size_t
+lwesp_evt_conn_send_ack_get_length(lwesp_evt_t* cc) {
+    return cc->evt.conn_send_ack.len;
+}
+
+/**
+ * \brief           Get result of buffered send
+ * \param[in]       cc: Event handle
+ * \return          \ref lwespOK on `SEND OK`, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_evt_conn_send_ack_get_result(lwesp_evt_t* cc) {
+    return cc->evt.conn_send_ack.res;
+}
+
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__ */
+
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+
+/**
+ * \brief           Get connection handle found on warm init
+ * \param[in]       cc: Event handle
+ * \return          Connection handle
+ */
+lwesp_conn_p
+lwesp_evt_conn_resync_get_conn(lwesp_evt_t* cc) {
+    return cc->evt.conn_resync.conn;
+}
+
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
+
 /**
  * \brief           Get connection error type
  * \param[in]       cc: Event handle
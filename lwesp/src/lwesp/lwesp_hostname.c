@@ -37,6 +37,31 @@
 
 #if LWESP_CFG_HOSTNAME || __DOXYGEN__
 
+#if LWESP_CFG_IP_MAC_CACHE || __DOXYGEN__
+
+/**
+ * \brief           Save hostname received from device to local cache
+ * \note            Function must be called with core locked
+ * \param[in]       str: Input string starting with `+CWHOSTNAME:`
+ */
+void
+lwespi_hostname_cache_set(const char* str) {
+    size_t i;
+
+    if (*str == '+') {
+        str += 12;
+    }
+    for (i = 0; i < sizeof(esp.m.hostname) && str[i] != '\0' && str[i] != '\r'; ++i) {
+        esp.m.hostname[i] = str[i];
+    }
+    esp.m.hostname_valid = i < sizeof(esp.m.hostname); /* Hostname is not cached when too long */
+    if (esp.m.hostname_valid) {
+        esp.m.hostname[i] = '\0';
+    }
+}
+
+#endif /* LWESP_CFG_IP_MAC_CACHE || __DOXYGEN__ */
+
 /**
  * \brief           Set hostname of WiFi station
  * \param[in]       hostname: Name of ESP host
@@ -62,6 +87,7 @@ lwesp_hostname_set(const char* hostname,
 
 /**
  * \brief           Get hostname of WiFi station
+ * \note            With \ref LWESP_CFG_IP_MAC_CACHE enabled, cached hostname is returned when valid
  * \param[in]       hostname: Pointer to output variable holding memory to save hostname
  * \param[in]       size: Size of buffer for hostname. Size includes memory for `NULL` termination
  * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
@@ -73,10 +99,30 @@ lwespr_t
 lwesp_hostname_get(char* hostname, size_t size,
                  const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
     LWESP_MSG_VAR_DEFINE(msg);
+#if LWESP_CFG_IP_MAC_CACHE
+    uint8_t cached;
+#endif /* LWESP_CFG_IP_MAC_CACHE */
 
     LWESP_ASSERT("hostname != NULL", hostname != NULL);
     LWESP_ASSERT("size > 0", size > 0);
 
+#if LWESP_CFG_IP_MAC_CACHE
+    lwesp_core_lock();
+    if ((cached = esp.m.hostname_valid) != 0) {
+        size_t len = LWESP_MIN(strlen(esp.m.hostname), size - 1);
+
+        LWESP_MEMCPY(hostname, esp.m.hostname, len);
+        hostname[len] = '\0';
+    }
+    lwesp_core_unlock();
+    if (cached) {
+        if (evt_fn != NULL) {
+            evt_fn(lwespOK, evt_arg);
+        }
+        return lwespOK;
+    }
+#endif /* LWESP_CFG_IP_MAC_CACHE */
+
     LWESP_MSG_VAR_ALLOC(msg, blocking);
     LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_WIFI_CWHOSTNAME_GET;
@@ -36,30 +36,294 @@
 #include "lwesp/lwesp_input.h"
 #include "lwesp/lwesp_buff.h"
 
-static uint32_t lwesp_recv_total_len;
-static uint32_t lwesp_recv_calls;
-
 #if !LWESP_CFG_INPUT_USE_PROCESS || __DOXYGEN__
 
+/**
+ * \brief           Notify processing thread about new data, unless it is already notified
+ * \return          `1` if notification is pending, `0` otherwise
+ */
+static uint8_t
+input_wakeup(void) {
+    if (!esp.input_wake_pending) {
+        esp.input_wake_pending = 1;
+        esp.input_wake_len = 0;
+        LWESP_CFG_MEMORY_BARRIER();
+        LWESPI_STATS_MBOX_WRITE(mbox_process, LWESP_CFG_THREAD_PROCESS_MBOX_SIZE);
+        if (!lwesp_sys_mbox_putnow(&esp.mbox_process, NULL)) {
+            LWESPI_STATS_MBOX_WRITE_FAIL(mbox_process);
+            esp.input_wake_pending = 0;         /* Try again on next call */
+        }
+    }
+    return esp.input_wake_pending;
+}
+
+#if LWESP_CFG_RCV_BUFF_SIZE_MAX > LWESP_CFG_RCV_BUFF_SIZE && !LWESP_CFG_STATIC_ONLY
+
+/**
+ * \brief           Grow input buffer to fit more data
+ *
+ * Core is locked, so processing thread does not read the buffer while it is replaced.
+ * Unprocessed data are moved to the beginning of new buffer
+ *
+ * \param[in]       need: Number of bytes which did not fit to buffer
+ * \return          `1` if buffer was grown, `0` otherwise
+ */
+static uint8_t
+input_grow(size_t need) {
+    lwesp_buff_t nb;
+    size_t full, size;
+    uint8_t res = 0;
+
+    lwesp_core_lock();
+    full = lwesp_buff_get_full(&esp.buff);
+    for (size = esp.buff.size; size < LWESP_CFG_RCV_BUFF_SIZE_MAX && size - 1 - full < need; size *= 2) {}
+    size = LWESP_MIN(size, LWESP_CFG_RCV_BUFF_SIZE_MAX);
+    if (size > esp.buff.size
+#if LWESP_CFG_IPD_ZERO_COPY
+        && esp.buff_ref_cnt == 0                /* Packet buffers point to current memory */
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
+        && lwesp_buff_init(&nb, size)) {
+        nb.w = lwesp_buff_read(&esp.buff, nb.buff, full);
+        lwesp_buff_free(&esp.buff);
+#if LWESP_CFG_IPD_ZERO_COPY
+        esp.buff_proc_r = 0;
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
+        LWESP_CFG_MEMORY_BARRIER();
+        esp.buff = nb;
+        res = 1;
+        LWESP_DEBUGF(LWESP_CFG_DBG_INPUT | LWESP_DBG_TYPE_TRACE,
+                   "[INPUT] Input buffer grown to %d bytes\r\n", (int)size);
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+#endif /* LWESP_CFG_RCV_BUFF_SIZE_MAX > LWESP_CFG_RCV_BUFF_SIZE && !LWESP_CFG_STATIC_ONLY */
+
+#if LWESP_CFG_IPD_DIRECT || __DOXYGEN__
+/**
+ * \brief           Copy data to armed or active direct IPD target
+ * \param[in]       data: Pointer to data to write
+ * \param[in]       len: Number of data elements in units of bytes
+ * \return          Number of bytes consumed by direct target
+ */
+static size_t
+input_direct(const void* data, size_t len) {
+    size_t written = 0;
+
+    if (esp.ipd_direct.state == LWESP_IPD_DIRECT_ARMED) {
+        /* Target is valid only if nothing was written to input buffer after it was armed */
+        esp.ipd_direct.state = esp.buff.w == esp.ipd_direct.mark ? LWESP_IPD_DIRECT_ACTIVE : LWESP_IPD_DIRECT_REJECTED;
+    }
+    if (esp.ipd_direct.state == LWESP_IPD_DIRECT_ACTIVE) {
+        written = LWESP_MIN(len, esp.ipd_direct.len - esp.ipd_direct.filled);
+        LWESP_MEMCPY(&esp.ipd_direct.dst[esp.ipd_direct.filled], data, written);
+        esp.ipd_direct.filled += written;
+        if (esp.ipd_direct.filled == esp.ipd_direct.len) {
+            LWESP_CFG_MEMORY_BARRIER();         /* Payload must be visible before state */
+            esp.ipd_direct.state = LWESP_IPD_DIRECT_DONE;
+        }
+    }
+    return written;
+}
+#endif /* LWESP_CFG_IPD_DIRECT || __DOXYGEN__ */
+
+/**
+ * \brief           Write data to input buffer and detect overflow
+ *
+ * When data do not fit, the rest of the stream is dropped until processing thread
+ * consumed data written before the loss and resynchronized parser with \ref lwespi_process_resync
+ *
+ * \param[in]       data: Pointer to data to write
+ * \param[in]       len: Number of data elements in units of bytes
+ * \param[in]       grow: Set to `1` to try to grow buffer on overflow
+ * \return          Number of bytes written to buffer
+ */
+static size_t
+input_write(const void* data, size_t len, uint8_t grow) {
+    size_t written = 0;
+
+    LWESP_UNUSED(grow);
+#if LWESP_CFG_IPD_DIRECT
+    if ((written = input_direct(data, len)) == len) {
+        return written;
+    }
+#endif /* LWESP_CFG_IPD_DIRECT */
+    if (!esp.input_overflow) {
+        written += lwesp_buff_write(&esp.buff, (const uint8_t*)data + written, len - written);
+#if LWESP_CFG_RCV_BUFF_SIZE_MAX > LWESP_CFG_RCV_BUFF_SIZE && !LWESP_CFG_STATIC_ONLY
+        if (written < len && grow && input_grow(len - written)) {
+            written += lwesp_buff_write(&esp.buff, (const uint8_t*)data + written, len - written);
+        }
+#endif /* LWESP_CFG_RCV_BUFF_SIZE_MAX > LWESP_CFG_RCV_BUFF_SIZE && !LWESP_CFG_STATIC_ONLY */
+        if (written < len) {
+            LWESP_CFG_MEMORY_BARRIER();         /* Written data must be visible before flag */
+            esp.input_overflow = 1;
+            LWESPI_STATS_UART_RX_OVERFLOW();
+        }
+    }
+    if (written < len) {
+        LWESPI_STATS_UART_RX_DROP(len - written);
+    }
+    return written;
+}
+
+/**
+ * \brief           Account received data and notify processing thread when necessary
+ * \param[in]       len: Number of received bytes
+ * \param[in]       written: Number of bytes accepted by input buffer
+ */
+static void
+input_received(size_t len, size_t written) {
+    esp.input_wake_len += written;              /* Only data in buffer is waiting for processing */
+    if (esp.input_wake_len >= LWESP_CFG_INPUT_WAKEUP_THRESHOLD || written < len
+#if LWESP_CFG_IPD_DIRECT
+        || esp.ipd_direct.state == LWESP_IPD_DIRECT_DONE
+#endif /* LWESP_CFG_IPD_DIRECT */
+       ) {
+        input_wakeup();                         /* Notify processing thread, once per burst */
+    }
+    LWESPI_STATS_UART_RX(len);                  /* Update total number of received bytes */
+}
+
 /**
  * \brief           Write data to input buffer
+ *
+ * Input buffer is lock-free single-producer single-consumer ring buffer.
+ * Single producer (thread or interrupt) may write to it concurrently with processing thread.
+ *
  * \note            \ref LWESP_CFG_INPUT_USE_PROCESS must be disabled to use this function
+ * \note            Function notifies processing thread with system mailbox,
+ *                  use \ref lwesp_input_isr when called from interrupt context
+ * \note            When buffer is full, it is grown up to \ref LWESP_CFG_RCV_BUFF_SIZE_MAX.
+ *                  If data still do not fit, they are dropped and parser resynchronizes on next line
  * \param[in]       data: Pointer to data to write
  * \param[in]       len: Number of data elements in units of bytes
- * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ * \return          \ref lwespOK on success, \ref lwespERRMEM if buffer could not accept all data,
+ *                  member of \ref lwespr_t enumeration otherwise
  */
 lwespr_t
 lwesp_input(const void* data, size_t len) {
+    size_t written;
+
     if (!esp.status.f.initialized || esp.buff.buff == NULL) {
         return lwespERR;
     }
-    lwesp_buff_write(&esp.buff, data, len);     /* Write data to buffer */
-    lwesp_sys_mbox_putnow(&esp.mbox_process, NULL); /* Write empty box, don't care if write fails */
-    lwesp_recv_total_len += len;                /* Update total number of received bytes */
-    ++lwesp_recv_calls;                         /* Update number of calls */
+    written = input_write(data, len, 1);        /* Write data to buffer */
+    input_received(len, written);
+    return written == len ? lwespOK : lwespERRMEM;
+}
+
+/**
+ * \brief           Get linear memory block of input buffer to receive data into
+ *
+ * Low-level driver may read or DMA data directly to returned memory
+ * and publish them with \ref lwesp_input_commit, without intermediate copy.
+ * When function returns `NULL`, driver receives data to its own memory and writes them with \ref lwesp_input,
+ * which handles buffer growth and overflow.
+ *
+ * \note            \ref LWESP_CFG_INPUT_USE_PROCESS must be disabled to use this function
+ * \note            Only one producer may write to input buffer at a time,
+ *                  reservation must be committed before \ref lwesp_input is called again
+ * \param[out]      len: Output variable to save length of linear memory block in units of bytes
+ * \return          Pointer to memory to write data to, `NULL` if buffer is full or in overflow state
+ */
+void*
+lwesp_input_get_write_buff(size_t* len) {
+    *len = 0;
+    if (!esp.status.f.initialized || esp.buff.buff == NULL || esp.input_overflow
+        || (*len = lwesp_buff_get_linear_block_write_length(&esp.buff)) == 0) {
+        return NULL;
+    }
+    return lwesp_buff_get_linear_block_write_address(&esp.buff);
+}
+
+/**
+ * \brief           Publish data written to memory returned by \ref lwesp_input_get_write_buff
+ *
+ * Function only advances write index of input buffer and notifies processing thread
+ * the same way as \ref lwesp_input does.
+ *
+ * \note            \ref LWESP_CFG_INPUT_USE_PROCESS must be disabled to use this function
+ * \param[in]       len: Number of bytes written to reserved memory,
+ *                      must not exceed length returned by \ref lwesp_input_get_write_buff
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_input_commit(size_t len) {
+    size_t direct = 0;
+
+    if (!esp.status.f.initialized || esp.buff.buff == NULL) {
+        return lwespERR;
+    }
+    if (len > lwesp_buff_get_linear_block_write_length(&esp.buff)) {
+        return lwespPARERR;
+    }
+#if LWESP_CFG_IPD_DIRECT
+    if (len > 0) {
+        uint8_t* d = lwesp_buff_get_linear_block_write_address(&esp.buff);
+
+        /* Move payload of direct IPD to its target, rest of data stays in buffer */
+        if ((direct = input_direct(d, len)) > 0 && direct < len) {
+            memmove(d, d + direct, len - direct);
+        }
+    }
+#endif /* LWESP_CFG_IPD_DIRECT */
+    lwesp_buff_advance(&esp.buff, len - direct);
+    input_received(len, len);
     return lwespOK;
 }
 
+/**
+ * \brief           Write data to input buffer from interrupt context
+ *
+ * Data are written to lock-free input buffer without any system call.
+ * Processing thread picks them up on its next periodic wakeup,
+ * or when notified with \ref lwesp_input_notify.
+ *
+ * \note            With \ref LWESP_CFG_TICKLESS_IDLE enabled, processing thread has no periodic wakeup
+ *                  and caller must call \ref lwesp_input_notify for data to be processed
+ *
+ * \note            \ref LWESP_CFG_INPUT_USE_PROCESS must be disabled to use this function
+ * \note            Only one producer may write to input buffer at a time,
+ *                  do not mix calls from different contexts with \ref lwesp_input
+ * \param[in]       data: Pointer to data to write
+ * \param[in]       len: Number of data elements in units of bytes
+ * \return          \ref lwespOK on success, \ref lwespERRMEM if buffer could not accept all data,
+ *                  member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_input_isr(const void* data, size_t len) {
+    size_t written;
+
+    if (!esp.status.f.initialized || esp.buff.buff == NULL) {
+        return lwespERR;
+    }
+    written = input_write(data, len, 0);        /* Write data to buffer */
+    LWESPI_STATS_UART_RX(len);                  /* Update total number of received bytes */
+    return written == len ? lwespOK : lwespERRMEM;
+}
+
+/**
+ * \brief           Notify processing thread to process input buffer immediately
+ *
+ * Use it at the end of data burst, such as on UART idle line event,
+ * when less than \ref LWESP_CFG_INPUT_WAKEUP_THRESHOLD bytes are waiting in input buffer.
+ * Notification is skipped when processing thread has already been notified.
+ *
+ * \note            \ref LWESP_CFG_INPUT_USE_PROCESS must be disabled to use this function
+ * \note            Function must be called from the same context as \ref lwesp_input.
+ *                  It may be called from interrupt only if \ref lwesp_sys_mbox_putnow is interrupt-safe on the port
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_input_notify(void) {
+    if (!esp.status.f.initialized || esp.buff.buff == NULL) {
+        return lwespERR;
+    }
+    return input_wakeup() ? lwespOK : lwespERRMEM;
+}
+
 #endif /* !LWESP_CFG_INPUT_USE_PROCESS || __DOXYGEN__ */
 
 #if LWESP_CFG_INPUT_USE_PROCESS || __DOXYGEN__
@@ -83,14 +347,26 @@ lwesp_input_process(const void* data, size_t len) {
         return lwespERR;
     }
 
-    lwesp_recv_total_len += len;                /* Update total number of received bytes */
-    ++lwesp_recv_calls;                         /* Update number of calls */
+    LWESPI_STATS_UART_RX(len);                  /* Update total number of received bytes */
+
+#if LWESP_CFG_INPUT_PROCESS_SLICE > 0
+    /* Process in slices, other threads may take core lock in between */
+    for (const uint8_t* d = data; len > 0 && res == lwespOK; ) {
+        size_t slice = LWESP_MIN(len, LWESP_CFG_INPUT_PROCESS_SLICE);
 
+        lwesp_core_lock();
+        res = lwespi_process(d, slice);         /* Process input data */
+        lwesp_core_unlock();
+        d += slice;
+        len -= slice;
+    }
+#else /* LWESP_CFG_INPUT_PROCESS_SLICE > 0 */
     if (len > 0) {
         lwesp_core_lock();
         res = lwespi_process(data, len);        /* Process input data */
         lwesp_core_unlock();
     }
+#endif /* !(LWESP_CFG_INPUT_PROCESS_SLICE > 0) */
     return res;
 }
 
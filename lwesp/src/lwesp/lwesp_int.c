@@ -37,6 +37,7 @@
 #include "lwesp/lwesp_mem.h"
 #include "lwesp/lwesp_parser.h"
 #include "lwesp/lwesp_unicode.h"
+#include "lwesp/lwesp_timeout.h"
 #include "system/lwesp_ll.h"
 
 #if !__DOXYGEN__
@@ -44,22 +45,36 @@
  * \brief           Receive character structure to handle full line terminated with `\n` character
  */
 typedef struct {
-    char data[128];                             /*!< Received characters */
+    char data[LWESP_CFG_RECV_LINE_BUFF_LEN];    /*!< Received characters */
     size_t len;                                 /*!< Length of valid characters */
+    uint8_t truncated;                          /*!< Set to `1` when characters were dropped from current line */
 } lwesp_recv_t;
 
 /* Receive character macros */
-#define RECV_ADD(ch)                        do { if (recv_buff.len < (sizeof(recv_buff.data)) - 1) { recv_buff.data[recv_buff.len++] = ch; recv_buff.data[recv_buff.len] = 0; } } while (0)
-#define RECV_RESET()                        do { recv_buff.len = 0; recv_buff.data[0] = 0; } while (0)
+#define RECV_ADD(ch)                        do { if (recv_buff.len < (sizeof(recv_buff.data)) - 1) { recv_buff.data[recv_buff.len++] = ch; recv_buff.data[recv_buff.len] = 0; } else { recv_buff.truncated = 1; } } while (0)
+#define RECV_RESET()                        do { recv_buff.len = 0; recv_buff.data[0] = 0; recv_buff.truncated = 0; } while (0)
 #define RECV_LEN()                          ((size_t)recv_buff.len)
 #define RECV_IDX(index)                     recv_buff.data[index]
 
+/* Write data to low-level driver */
+#if LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_CAPTURE
+#define AT_PORT_WRITE_FN(d, l)              at_port_send_hook((d), (l))
+#else /* LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_CAPTURE */
+#define AT_PORT_WRITE_FN(d, l)              esp.ll.send_fn((d), (l))
+#endif /* !(LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_CAPTURE) */
+
 /* Send data over AT port */
-#define AT_PORT_SEND_STR(str)               esp.ll.send_fn((const void *)(str), (size_t)strlen(str))
-#define AT_PORT_SEND_CONST_STR(str)         esp.ll.send_fn((const void *)(str), (size_t)(sizeof(str) - 1))
-#define AT_PORT_SEND_CHR(str)               esp.ll.send_fn((const void *)(str), (size_t)1)
+#if LWESP_CFG_AT_CMD_BUFF_LEN > 0
+#define AT_PORT_SEND_FN(d, l)               at_port_buff_write((d), (l))
+#define AT_PORT_SEND_FLUSH()                do { at_port_buff_flush(); esp.ll.send_fn(NULL, 0); } while (0)
+#else /* LWESP_CFG_AT_CMD_BUFF_LEN > 0 */
+#define AT_PORT_SEND_FN(d, l)               AT_PORT_WRITE_FN((d), (l))
 #define AT_PORT_SEND_FLUSH()                esp.ll.send_fn(NULL, 0)
-#define AT_PORT_SEND(d, l)                  esp.ll.send_fn((const void *)(d), (size_t)(l))
+#endif /* !(LWESP_CFG_AT_CMD_BUFF_LEN > 0) */
+#define AT_PORT_SEND_STR(str)               AT_PORT_SEND_FN((const void *)(str), (size_t)strlen(str))
+#define AT_PORT_SEND_CONST_STR(str)         AT_PORT_SEND_FN((const void *)(str), (size_t)(sizeof(str) - 1))
+#define AT_PORT_SEND_CHR(str)               AT_PORT_SEND_FN((const void *)(str), (size_t)1)
+#define AT_PORT_SEND(d, l)                  AT_PORT_SEND_FN((const void *)(d), (size_t)(l))
 #define AT_PORT_SEND_WITH_FLUSH(d, l)       do { AT_PORT_SEND((d), (l)); AT_PORT_SEND_FLUSH(); } while (0)
 
 /* Beginning and end of every AT command */
@@ -70,10 +85,103 @@ typedef struct {
 #define AT_PORT_SEND_QUOTE_COND(q)          do { if ((q)) { AT_PORT_SEND_CONST_STR("\""); } } while (0)
 #define AT_PORT_SEND_COMMA_COND(c)          do { if ((c)) { AT_PORT_SEND_CONST_STR(","); } } while (0)
 #define AT_PORT_SEND_EQUAL_COND(e)          do { if ((e)) { AT_PORT_SEND_CONST_STR("="); } } while (0)
+
+/* Send connection data command from constant template, `AT` is prepended */
+#define AT_PORT_SEND_CONN_DATA_CMD(tmpl, num, len)  lwespi_send_conn_data_cmd((tmpl), sizeof(tmpl) - 1, LWESP_U32(num), LWESP_U32(len))
 #endif /* !__DOXYGEN__ */
 
 static lwesp_recv_t recv_buff;
+#if LWESP_CFG_IPD_ZERO_COPY
+static uint8_t process_from_buff;               /* Set to `1` when data are processed directly from input buffer */
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
+#if !LWESP_CFG_INPUT_USE_PROCESS
+static uint8_t process_resync;                  /* Set to `1` to drop input data until end of line after input overflow */
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+#if LWESP_CFG_CONN_EVT_WORKERS > 0 && LWESP_CFG_STATIC_ONLY
+static lwesp_conn_evt_work_t conn_evt_work_pool[LWESP_CFG_CONN_EVT_WORKERS * LWESP_CFG_CONN_EVT_WORKER_QUEUE_LEN];
+static lwesp_conn_evt_work_t* conn_evt_work_pool_free[LWESP_CFG_CONN_EVT_WORKERS * LWESP_CFG_CONN_EVT_WORKER_QUEUE_LEN];
+static size_t conn_evt_work_pool_free_cnt;
+static uint8_t conn_evt_work_pool_initialized;
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > 0 && LWESP_CFG_STATIC_ONLY */
 static lwespr_t lwespi_process_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, uint8_t* is_ready);
+#if LWESP_CFG_WARM_INIT
+static void lwespi_warm_state_parse(const char* str);
+#endif /* LWESP_CFG_WARM_INIT */
+
+#if LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_CAPTURE || __DOXYGEN__
+/**
+ * \brief           Send data to AT port, count and capture bytes accepted by low-level driver
+ * \param[in]       d: Data to send
+ * \param[in]       l: Length of data in units of bytes
+ * \return          Number of bytes accepted by low-level driver
+ */
+static size_t
+at_port_send_hook(const void* d, size_t l) {
+    size_t sent = esp.ll.send_fn(d, l);
+
+    LWESPI_STATS_UART_TX(sent);
+    LWESPI_CAPTURE_TX(d, sent);
+    return sent;
+}
+#endif /* LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_CAPTURE || __DOXYGEN__ */
+
+#if LWESP_CFG_AT_CMD_BUFF_LEN > 0 || __DOXYGEN__
+static uint8_t at_cmd_buff[LWESP_CFG_AT_CMD_BUFF_LEN];  /*!< AT command assembly buffer */
+static size_t at_cmd_buff_len;                  /*!< Number of bytes waiting in assembly buffer */
+
+/**
+ * \brief           Write all bytes to low-level driver
+ * \param[in]       d: Data to send
+ * \param[in]       l: Length of data in units of bytes
+ * \return          Number of bytes accepted by low-level driver
+ */
+static size_t
+at_port_write_all(const uint8_t* d, size_t l) {
+    size_t sent, total = 0;
+
+    while (total < l) {
+        if ((sent = AT_PORT_WRITE_FN(&d[total], l - total)) == 0) {
+            break;                              /* Low-level driver refused data */
+        }
+        total += sent;
+    }
+    return total;
+}
+
+/**
+ * \brief           Send content of AT command assembly buffer to low-level driver
+ */
+static void
+at_port_buff_flush(void) {
+    if (at_cmd_buff_len > 0) {
+        at_port_write_all(at_cmd_buff, at_cmd_buff_len);
+        at_cmd_buff_len = 0;
+    }
+}
+
+/**
+ * \brief           Write data to AT command assembly buffer
+ *
+ * Buffer is sent to low-level driver when new data do not fit into it.
+ * Data longer than buffer itself (connection payload) bypass the buffer
+ *
+ * \param[in]       d: Data to send
+ * \param[in]       l: Length of data in units of bytes
+ * \return          Number of bytes accepted
+ */
+static size_t
+at_port_buff_write(const void* d, size_t l) {
+    if (l > sizeof(at_cmd_buff) - at_cmd_buff_len) {
+        at_port_buff_flush();
+    }
+    if (l >= sizeof(at_cmd_buff)) {
+        return at_port_write_all(d, l);
+    }
+    LWESP_MEMCPY(&at_cmd_buff[at_cmd_buff_len], d, l);
+    at_cmd_buff_len += l;
+    return l;
+}
+#endif /* LWESP_CFG_AT_CMD_BUFF_LEN > 0 || __DOXYGEN__ */
 
 /**
  * \brief           Free connection send data memory
@@ -82,11 +190,8 @@ static lwespr_t lwespi_process_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t
 #define CONN_SEND_DATA_FREE(m)      do {            \
         if ((m) != NULL && (m)->msg.conn_send.fau) {    \
             (m)->msg.conn_send.fau = 0;                 \
-            if ((m)->msg.conn_send.data != NULL) {      \
-                LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,   \
-                           "[CONN] Free write buffer fau: %p\r\n", (void *)(m)->msg.conn_send.data);   \
-                lwesp_mem_free_s((void **)&((m)->msg.conn_send.data));\
-            }                                           \
+            lwespi_conn_buff_free((m)->msg.conn_send.data); \
+            (m)->msg.conn_send.data = NULL;             \
         }                                               \
     } while (0)
 
@@ -97,11 +202,14 @@ static lwespr_t lwespi_process_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t
  */
 #define CONN_SEND_DATA_SEND_EVT(m, err)  do {       \
         CONN_SEND_DATA_FREE(m);                         \
-        esp.evt.type = LWESP_EVT_CONN_SEND;               \
-        esp.evt.evt.conn_data_send.res = err;           \
-        esp.evt.evt.conn_data_send.conn = (m)->msg.conn_send.conn;  \
-        esp.evt.evt.conn_data_send.sent = (m)->msg.conn_send.sent_all;   \
-        lwespi_send_conn_cb((m)->msg.conn_send.conn, NULL);   \
+        LWESPI_CONN_TX_QUEUE_RELEASE(m);                \
+        if (LWESPI_CONN_SEND_EVT_REPORT(m, err, esp.evt.evt.conn_data_send.sent)) {  \
+            esp.evt.type = LWESP_EVT_CONN_SEND;           \
+            esp.evt.evt.conn_data_send.res = err;       \
+            esp.evt.evt.conn_data_send.conn = (m)->msg.conn_send.conn;  \
+            lwespi_send_conn_cb((m)->msg.conn_send.conn, NULL);   \
+        }                                               \
+        LWESPI_CONN_SENDFILE_RELEASE(m, err);           \
     } while (0)
 
 /**
@@ -253,15 +361,43 @@ lwespi_send_string(const char* str, uint8_t e, uint8_t q, uint8_t c) {
 void
 lwespi_send_number(uint32_t num, uint8_t q, uint8_t c) {
     char str[11];
+    size_t len;
 
-    lwesp_u32_to_str(num, str);                 /* Convert digit to decimal string */
+    len = lwesp_u32_to_dec_str(num, str);       /* Convert digit to decimal string */
 
     AT_PORT_SEND_COMMA_COND(c);                 /* Send comma */
     AT_PORT_SEND_QUOTE_COND(q);                 /* Send quote */
-    AT_PORT_SEND_STR(str);                      /* Send string with number */
+    AT_PORT_SEND(str, len);                     /* Send string with number */
     AT_PORT_SEND_QUOTE_COND(q);                 /* Send quote */
 }
 
+/**
+ * \brief           Send beginning of connection data command, `AT<tmpl><num>,<len>`,
+ *                  such as `AT+CIPSEND=0,2048`, with single write to AT port
+ *
+ * Command template is copied as is, only numbers are formatted.
+ * Caller sends optional parameters and finishes command with \ref AT_PORT_SEND_END_AT
+ *
+ * \param[in]       tmpl: Command template after `AT`, including `=` character
+ * \param[in]       tmpl_len: Length of template in units of bytes
+ * \param[in]       num: Connection number
+ * \param[in]       len: Data length
+ */
+static void
+lwespi_send_conn_data_cmd(const char* tmpl, size_t tmpl_len, uint32_t num, uint32_t len) {
+    char cmd[32];
+    size_t i;
+
+    cmd[0] = 'A';
+    cmd[1] = 'T';
+    LWESP_MEMCPY(&cmd[2], tmpl, tmpl_len);
+    i = 2 + tmpl_len;
+    i += lwesp_u32_to_dec_str(num, &cmd[i]);
+    cmd[i++] = ',';
+    i += lwesp_u32_to_dec_str(len, &cmd[i]);
+    AT_PORT_SEND(cmd, i);
+}
+
 /**
  * \brief           Send port number to AT port
  * \param[in]       port: Port number to send
@@ -346,13 +482,21 @@ lwespi_reset_everything(uint8_t forced) {
 #endif /* LWESP_CFG_MODE_STATION */
 
     /* Check if IPD active */
-    if (esp.m.ipd.buff != NULL) {
+    if (esp.m.ipd.buff != NULL
+#if LWESP_CFG_IPD_DIRECT
+        && esp.ipd_direct.state == LWESP_IPD_DIRECT_IDLE  /* Otherwise freed once input context releases it */
+#endif /* LWESP_CFG_IPD_DIRECT */
+       ) {
         lwesp_pbuf_free(esp.m.ipd.buff);
-        esp.m.ipd.buff = NULL;
     }
+    esp.m.ipd.buff = NULL;
 
     /* Invalid ESP modules */
     LWESP_MEMSET(&esp.m, 0x00, sizeof(esp.m));
+    esp.m.conn_status_stale = 1;                /* Connection state is unknown until first status query */
+#if LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT > LWESP_CFG_CONN_MAX_DATA_LEN
+    esp.m.conn_max_data_len = LWESP_CFG_CONN_MAX_DATA_LEN;  /* Safe default until firmware is known */
+#endif /* LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT > LWESP_CFG_CONN_MAX_DATA_LEN */
 
     /* Set default device */
 #if LWESP_CFG_ESP8266 && !LWESP_CFG_ESP32
@@ -363,14 +507,118 @@ lwespi_reset_everything(uint8_t forced) {
     esp.m.device = LWESP_DEVICE_UNKNOWN;
 #endif  /* LWESP_CFG_ESP8266 && !LWESP_CFG_ESP32 */
 
-    /* Reset baudrate to default */
+    /* Reset baudrate and flow control to default */
     esp.ll.uart.baudrate = LWESP_CFG_AT_PORT_BAUDRATE;
+    esp.ll.uart.flow_control = 0;
     lwesp_ll_init(&esp.ll);
 
     /* If reset was not forced by user, repeat with manual reset */
     if (!forced) {
+#if LWESP_CFG_RESET_RECOVERY
+        lwespi_reset_recover();
+#else /* LWESP_CFG_RESET_RECOVERY */
         lwesp_reset(NULL, NULL, 0);
+#endif /* !LWESP_CFG_RESET_RECOVERY */
+    }
+}
+
+#if LWESP_CFG_RESET_RECOVERY || __DOXYGEN__
+
+/**
+ * \brief           Configure device again after unexpected reset
+ *
+ * Device has just reported `ready`, hence it is not reset again
+ * and sequence starts with first configuration command
+ *
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwespi_reset_recover(void) {
+    LWESP_MSG_VAR_DEFINE(msg);
+
+    LWESP_MSG_VAR_ALLOC(msg, 0);
+    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_RESET;
+    LWESP_MSG_VAR_REF(msg).cmd = LWESP_CFG_AT_ECHO ? LWESP_CMD_ATE1 : LWESP_CMD_ATE0;
+    LWESP_MSG_VAR_REF(msg).msg.reset.recover = 1;
+
+    LWESP_DEBUGF(LWESP_CFG_DBG_INIT | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING,
+               "[LWESP] Unexpected device reset, recovering\r\n");
+    return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 5000);
+}
+
+#endif /* LWESP_CFG_RESET_RECOVERY || __DOXYGEN__ */
+
+#if !LWESP_CFG_STATIC_ONLY
+
+/**
+ * \brief           Rebuild per event type dispatch table from registered functions
+ *
+ * On memory allocation failure, table is not available
+ * and dispatching falls back to registered functions list
+ *
+ * \note            Table is not used with \ref LWESP_CFG_STATIC_ONLY
+ */
+static void
+evt_dispatch_rebuild(void) {
+    lwesp_evt_func_t** table;
+    size_t cnt = 0, idx = 0;
+
+    esp.evt_dispatch_dirty = 0;
+    lwesp_mem_free_s((void**)&esp.evt_dispatch);
+
+    /* Count all subscriptions first */
+    for (lwesp_evt_func_t* link = esp.evt_func; link != NULL; link = link->next) {
+        for (size_t t = 0; t < LWESP_EVT_END; ++t) {
+            cnt += (link->mask & LWESP_EVT_MASK(t)) ? 1 : 0;
+        }
+    }
+    if (cnt == 0 || cnt > 0xFF
+        || (table = lwesp_mem_malloc(sizeof(*table) * cnt)) == NULL) {
+        return;
+    }
+
+    /* Group functions per event type, keep registration order */
+    for (size_t t = 0; t < LWESP_EVT_END; ++t) {
+        esp.evt_dispatch_idx[t] = (uint8_t)idx;
+        for (lwesp_evt_func_t* link = esp.evt_func; link != NULL; link = link->next) {
+            if (link->mask & LWESP_EVT_MASK(t)) {
+                table[idx++] = link;
+            }
+        }
+    }
+    esp.evt_dispatch_idx[LWESP_EVT_END] = (uint8_t)idx;
+    esp.evt_dispatch = table;
+}
+
+#endif /* !LWESP_CFG_STATIC_ONLY */
+
+/**
+ * \brief           Call registered event function
+ * \param[in]       link: Registered function entry
+ */
+static void
+evt_call(lwesp_evt_func_t* link) {
+#if LWESP_CFG_EVT_DEFERRED
+    if (link->deferred) {
+        lwesp_evt_deferred_t* item;
+
+        /* Copy event to queue, listener is called later from application thread */
+        if ((item = lwespi_evt_deferred_alloc()) != NULL) {
+            item->fn = link->fn;
+            LWESP_MEMCPY(&item->evt, &esp.evt, sizeof(item->evt));
+            if (!lwesp_sys_mbox_putnow(&esp.mbox_evt_deferred, item)) {
+                lwespi_evt_deferred_free(item);
+                item = NULL;
+            }
+        }
+        if (item == NULL) {
+            LWESP_DEBUGF(LWESP_CFG_DBG_THREAD | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING,
+                       "[CORE] Deferred event %d dropped\r\n", (int)esp.evt.type);
+        }
+        return;
     }
+#endif /* LWESP_CFG_EVT_DEFERRED */
+    link->fn(&esp.evt);
 }
 
 /**
@@ -382,13 +630,243 @@ lwespr_t
 lwespi_send_cb(lwesp_evt_type_t type) {
     esp.evt.type = type;                        /* Set callback type to process */
 
-    /* Call callback function for all registered functions */
-    for (lwesp_evt_func_t* link = esp.evt_func; link != NULL; link = link->next) {
-        link->fn(&esp.evt);
+#if !LWESP_CFG_STATIC_ONLY
+    /* Table cannot be rebuilt while nested dispatch is using it */
+    if (esp.evt_dispatch_dirty && esp.evt_dispatch_depth == 0) {
+        evt_dispatch_rebuild();
+    }
+#endif /* !LWESP_CFG_STATIC_ONLY */
+    ++esp.evt_dispatch_depth;
+    if (esp.evt_dispatch != NULL && !esp.evt_dispatch_dirty) {
+        /* Call only functions subscribed to this event type */
+        for (size_t i = esp.evt_dispatch_idx[type]; i < esp.evt_dispatch_idx[type + 1]; ++i) {
+            evt_call(esp.evt_dispatch[i]);
+        }
+    } else {
+        /* Call callback function for all registered functions */
+        for (lwesp_evt_func_t* link = esp.evt_func; link != NULL; link = link->next) {
+            if (link->mask & LWESP_EVT_MASK(type)) {
+                evt_call(link);
+            }
+        }
     }
+    --esp.evt_dispatch_depth;
+    lwespi_state_notify();                      /* Event may follow state change */
     return lwespOK;
 }
 
+/**
+ * \brief           Get current stack state
+ * \note            Function must be called with core locked
+ * \return          Bitwise OR of \ref lwesp_state_t flags
+ */
+uint32_t
+lwespi_get_state(void) {
+    uint32_t state = 0;
+
+    if (esp.status.f.dev_present) {
+        state |= LWESP_STATE_DEVICE_PRESENT;
+    }
+#if LWESP_CFG_MODE_STATION
+    if (esp.m.sta.is_connected) {
+        state |= LWESP_STATE_WIFI_CONNECTED;
+    }
+    if (esp.m.sta.has_ip) {
+        state |= LWESP_STATE_HAS_IP;
+    }
+#endif /* LWESP_CFG_MODE_STATION */
+    for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+        if (esp.m.conns[i].status.f.active) {
+            state |= LWESP_STATE_CONN_ACTIVE;
+            break;
+        }
+    }
+    return state;
+}
+
+/**
+ * \brief           Wake up threads waiting for current stack state
+ * \note            Function must be called with core locked
+ */
+void
+lwespi_state_notify(void) {
+    lwesp_state_waiter_t** w = &esp.state_waiters;
+    uint32_t state;
+
+    if (*w == NULL) {
+        return;
+    }
+    state = lwespi_get_state();
+    while (*w != NULL) {
+        if (((*w)->flags & state) == (*w)->flags) {
+            lwesp_state_waiter_t* done = *w;
+
+            *w = done->next;                    /* Remove from list before waiter wakes up */
+            lwesp_sys_sem_release(&done->sem);
+        } else {
+            w = &(*w)->next;
+        }
+    }
+}
+
+#if LWESP_CFG_CONN_RECV_COALESCE_LEN > 0 || __DOXYGEN__
+
+/**
+ * \brief           Deliver received data chain, collected on connection, to application
+ * \param[in]       conn: Connection handle
+ * \return          Member of \ref lwespr_t enumeration returned by connection callback
+ */
+static lwespr_t
+conn_recv_coalesce_flush(lwesp_conn_p conn) {
+    lwesp_pbuf_p p = conn->rx_coalesce;
+    lwespr_t res;
+
+    if (p == NULL) {
+        return lwespOK;
+    }
+    if (conn->rx_coalesce_to != 0) {
+        lwesp_timeout_cancel(conn->rx_coalesce_to);
+        conn->rx_coalesce_to = 0;
+    }
+    conn->rx_coalesce = NULL;
+
+    esp.evt.type = LWESP_EVT_CONN_RECV;
+    esp.evt.evt.conn_data_recv.buff = p;
+    esp.evt.evt.conn_data_recv.conn = conn;
+    res = lwespi_send_conn_cb(conn, NULL);
+    lwesp_pbuf_free(p);
+    return res;
+}
+
+/**
+ * \brief           Timeout callback to deliver received data chain
+ * \param[in]       arg: Connection handle
+ */
+static void
+conn_recv_coalesce_timeout_cb(void* arg) {
+    lwesp_conn_p conn = arg;
+
+    conn->rx_coalesce_to = 0;
+    conn_recv_coalesce_flush(conn);
+}
+
+/**
+ * \brief           Add received packet buffer to connection data chain
+ *
+ * Chain is delivered to application when it reaches \ref LWESP_CFG_CONN_RECV_COALESCE_LEN bytes
+ *
+ * \param[in]       conn: Connection handle
+ * \param[in]       p: Received packet buffer. Ownership is passed to connection on success
+ * \param[out]      res: Result of connection callback if chain was delivered, \ref lwespOK otherwise
+ * \return          `1` if packet buffer was taken, `0` if it must be delivered immediately
+ */
+static uint8_t
+conn_recv_coalesce(lwesp_conn_p conn, lwesp_pbuf_p p, lwespr_t* res) {
+    if (conn->type == LWESP_CONN_TYPE_UDP) {    /* Datagram boundaries must be kept */
+        return 0;
+    }
+#if LWESP_CFG_IPD_ZERO_COPY
+    if (p->is_ref) {                            /* Input buffer memory must be released soon */
+        *res = conn_recv_coalesce_flush(conn);  /* Keep order of received data */
+        return 0;
+    }
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
+    if (conn->rx_coalesce == NULL) {
+        if (p->tot_len >= LWESP_CFG_CONN_RECV_COALESCE_LEN) {
+            return 0;                           /* Large enough, no need to wait */
+        }
+        conn->rx_coalesce = p;
+        conn->rx_coalesce_to = lwesp_timeout_addex(LWESP_CFG_CONN_RECV_COALESCE_TIME, conn_recv_coalesce_timeout_cb, conn);
+    } else {
+        lwesp_pbuf_cat(conn->rx_coalesce, p);
+    }
+    *res = lwespOK;
+    if (conn->rx_coalesce->tot_len >= LWESP_CFG_CONN_RECV_COALESCE_LEN || conn->rx_coalesce_to == 0) {
+        *res = conn_recv_coalesce_flush(conn);
+    }
+    return 1;
+}
+
+#endif /* LWESP_CFG_CONN_RECV_COALESCE_LEN > 0 || __DOXYGEN__ */
+
+#if LWESP_CFG_CONN_EVT_WORKERS > 0 || __DOXYGEN__
+
+/**
+ * \brief           Allocate connection event worker queue entry
+ * \note            Core must be locked when function is called
+ * \return          New entry on success, `NULL` otherwise
+ */
+static lwesp_conn_evt_work_t*
+conn_evt_work_alloc(void) {
+#if LWESP_CFG_STATIC_ONLY
+    if (!conn_evt_work_pool_initialized) {
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(conn_evt_work_pool); ++i) {
+            conn_evt_work_pool_free[i] = &conn_evt_work_pool[i];
+        }
+        conn_evt_work_pool_free_cnt = LWESP_ARRAYSIZE(conn_evt_work_pool);
+        conn_evt_work_pool_initialized = 1;
+    }
+    return conn_evt_work_pool_free_cnt > 0 ? conn_evt_work_pool_free[--conn_evt_work_pool_free_cnt] : NULL;
+#else /* LWESP_CFG_STATIC_ONLY */
+    return lwesp_mem_malloc(sizeof(lwesp_conn_evt_work_t));
+#endif /* !LWESP_CFG_STATIC_ONLY */
+}
+
+/**
+ * \brief           Free connection event worker queue entry
+ *
+ * Packet buffer of receive event, referenced when event was queued, is released too
+ *
+ * \param[in]       item: Entry to free
+ */
+void
+lwespi_conn_evt_work_free(lwesp_conn_evt_work_t* item) {
+    if (item->evt.type == LWESP_EVT_CONN_RECV) {
+        lwesp_pbuf_free(item->evt.evt.conn_data_recv.buff);
+    }
+#if LWESP_CFG_STATIC_ONLY
+    lwesp_core_lock();
+    conn_evt_work_pool_free[conn_evt_work_pool_free_cnt++] = item;
+    lwesp_core_unlock();
+#else /* LWESP_CFG_STATIC_ONLY */
+    lwesp_mem_free(item);
+#endif /* !LWESP_CFG_STATIC_ONLY */
+}
+
+/**
+ * \brief           Queue connection event to worker thread of connection
+ *
+ * Worker is selected by connection number, all events of one connection
+ * are handled by the same thread in the order they were queued
+ *
+ * \note            Core must be locked when function is called
+ * \param[in]       conn: Connection handle
+ * \param[in]       fn: Connection callback function
+ */
+static void
+conn_evt_work_post(lwesp_conn_p conn, lwesp_evt_fn fn) {
+    lwesp_conn_evt_work_t* item;
+
+    if ((item = conn_evt_work_alloc()) != NULL) {
+        item->fn = fn;
+        LWESP_MEMCPY(&item->evt, &esp.evt, sizeof(item->evt));
+        if (item->evt.type == LWESP_EVT_CONN_RECV) {
+            lwesp_pbuf_ref(item->evt.evt.conn_data_recv.buff);  /* Worker owns its own reference */
+        }
+        if (!lwesp_sys_mbox_putnow(&esp.mbox_conn_evt[conn->num % LWESP_CFG_CONN_EVT_WORKERS], item)) {
+            lwespi_conn_evt_work_free(item);
+            item = NULL;
+        }
+    }
+    if (item == NULL) {
+        LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING,
+                   "[CONN] Connection %d event %d dropped, worker queue is full\r\n",
+                   (int)conn->num, (int)esp.evt.type);
+    }
+}
+
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > 0 || __DOXYGEN__ */
+
 /**
  * \brief           Process connection callback
  * \note            Before calling function, callback structure must be prepared
@@ -401,11 +879,30 @@ lwespi_send_conn_cb(lwesp_conn_t* conn, lwesp_evt_fn evt) {
     if (conn->status.f.in_closing && esp.evt.type != LWESP_EVT_CONN_CLOSE) {/* Do not continue if in closing mode */
         /* return lwespOK; */
     }
+    if (conn != NULL && (esp.evt.type == LWESP_EVT_CONN_RECV || esp.evt.type == LWESP_EVT_CONN_SEND)) {
+        conn->poll_interval = 0;                /* Data activity resets poll back-off */
+    }
+#if LWESP_CFG_CONN_RECV_COALESCE_LEN > 0
+    if (conn != NULL && conn->rx_coalesce != NULL && esp.evt.type == LWESP_EVT_CONN_CLOSE) {
+        lwesp_evt_t evt_close = esp.evt;        /* Data must reach application before close event */
+
+        conn_recv_coalesce_flush(conn);
+        esp.evt = evt_close;
+    }
+#endif /* LWESP_CFG_CONN_RECV_COALESCE_LEN > 0 */
+    if (esp.evt.type == LWESP_EVT_CONN_ACTIVE) {
+        lwespi_state_notify();                  /* Threads may wait for active connection */
+    }
 
     if (evt != NULL) {                          /* Try with user connection */
         return evt(&esp.evt);                   /* Call temporary function */
     } else if (conn != NULL && conn->evt_func != NULL) {/* Connection custom callback? */
+#if LWESP_CFG_CONN_EVT_WORKERS > 0
+        conn_evt_work_post(conn, conn->evt_func);   /* Callback is called from worker thread */
+        return lwespOK;
+#else /* LWESP_CFG_CONN_EVT_WORKERS > 0 */
         return conn->evt_func(&esp.evt);        /* Process callback function */
+#endif /* !(LWESP_CFG_CONN_EVT_WORKERS > 0) */
     } else if (conn == NULL) {
         return lwespOK;
     }
@@ -426,6 +923,163 @@ lwespi_send_conn_cb(lwesp_conn_t* conn, lwesp_evt_fn evt) {
     return lwesp_conn_close(conn, 0);
 }
 
+#if LWESP_CFG_CONN_SEND_COALESCE || __DOXYGEN__
+
+/**
+ * \brief           Get number of remaining bytes to send for message and all merged messages
+ * \param[in]       msg: Head send message
+ * \return          Number of bytes to send
+ */
+static size_t
+lwespi_conn_send_chain_btw(lwesp_msg_t* msg) {
+    size_t btw = 0;
+    for (; msg != NULL; msg = msg->msg.conn_send.next) {
+        btw += msg->msg.conn_send.btw;
+    }
+    return btw;
+}
+
+/**
+ * \brief           Finish merged send message and notify user
+ * \param[in]       msg: Merged message, not part of chain anymore
+ * \param[in]       res: Result of send operation
+ */
+static void
+lwespi_conn_send_msg_done(lwesp_msg_t* msg, lwespr_t res) {
+    if (res == lwespOK || msg->msg.conn_send.conn->status.f.active) {
+        CONN_SEND_DATA_SEND_EVT(msg, res);
+    } else {
+        CONN_SEND_DATA_FREE(msg);
+    }
+    msg->res = res;
+#if LWESP_CFG_USE_API_FUNC_EVT
+    if (msg->evt_fn != NULL) {
+        msg->evt_fn(msg->res, msg->evt_arg);
+    }
+#endif /* LWESP_CFG_USE_API_FUNC_EVT */
+    LWESP_MSG_VAR_FREE(msg);                    /* Merged messages are always non-blocking */
+}
+
+/**
+ * \brief           Merge queued send messages for the same connection to message being started
+ *
+ * Messages are taken from producer queue until first message, which cannot be merged,
+ * is found, or until total length reaches maximal data length of single command.
+ * First message that cannot be merged is returned in `pending` and must be processed next
+ *
+ * \note            Function must be called from producer thread only
+ * \param[in]       msg: Send message to be started
+ * \param[out]      pending: Pointer to save first non-merged message to
+ */
+void
+lwespi_conn_send_coalesce(lwesp_msg_t* msg, lwesp_msg_t** pending) {
+    lwesp_msg_t *last = msg, *n;
+    size_t total = msg->msg.conn_send.btw;
+
+    msg->msg.conn_send.next = NULL;
+    while (*pending == NULL && total < LWESPI_CONN_MAX_DATA_LEN()
+           && lwespi_get_producer_msg(&n, 0)) {
+        if (n->cmd_def == LWESP_CMD_TCPIP_CIPSEND && !n->is_blocking
+            && n->batch_next == NULL            /* Batch head must run its chain */
+            && n->msg.conn_send.conn == msg->msg.conn_send.conn
+            && n->msg.conn_send.val_id == msg->msg.conn_send.val_id
+            && n->msg.conn_send.remote_ip == msg->msg.conn_send.remote_ip
+            && n->msg.conn_send.remote_port == msg->msg.conn_send.remote_port) {
+            n->msg.conn_send.next = NULL;
+            last->msg.conn_send.next = n;       /* Add to the end of chain */
+            last = n;
+            total += n->msg.conn_send.btw;
+            LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
+                       "[CONN] Merged send of %d bytes on connection %d\r\n",
+                       (int)n->msg.conn_send.btw, (int)n->msg.conn_send.conn->num);
+        } else {
+            *pending = n;                       /* Different message, process it next */
+        }
+    }
+}
+
+/**
+ * \brief           Release all merged messages, still linked to head message
+ * \note            Function must be called when head message has finished
+ * \param[in]       msg: Head send message
+ * \param[in]       res: Result of head message
+ */
+void
+lwespi_conn_send_coalesce_release(lwesp_msg_t* msg, lwespr_t res) {
+    lwesp_msg_t* n;
+
+    while ((n = msg->msg.conn_send.next) != NULL) {
+        msg->msg.conn_send.next = n->msg.conn_send.next;
+        lwespi_conn_send_msg_done(n, res == lwespOK ? lwespERR : res);
+    }
+}
+
+#endif /* LWESP_CFG_CONN_SEND_COALESCE || __DOXYGEN__ */
+
+/**
+ * \brief           Send part of message data to AT port
+ *
+ * Data may be linear, packet buffer chain or array of segments
+ * \param[in]       m: Send message
+ * \param[in]       off: Offset from beginning of message data in units of bytes
+ * \param[in]       len: Number of bytes to send
+ */
+static void
+lwespi_conn_send_data_range(lwesp_msg_t* m, size_t off, size_t len) {
+    if (m->msg.conn_send.iov != NULL) {
+        for (size_t i = 0; i < m->msg.conn_send.iov_cnt && len > 0; ++i) {
+            const lwesp_conn_iov_t* v = &m->msg.conn_send.iov[i];
+            size_t l;
+
+            if (off >= v->len) {                /* Skip segments already sent */
+                off -= v->len;
+                continue;
+            }
+            l = LWESP_MIN(len, v->len - off);
+            AT_PORT_SEND((const uint8_t*)v->data + off, l);
+            len -= l;
+            off = 0;
+        }
+    } else if (m->msg.conn_send.pbuf != NULL) {
+        for (lwesp_pbuf_p p = m->msg.conn_send.pbuf; p != NULL && len > 0; p = p->next) {
+            size_t l;
+
+            if (off >= p->len) {                /* Skip buffers already sent */
+                off -= p->len;
+                continue;
+            }
+            l = LWESP_MIN(len, p->len - off);
+            AT_PORT_SEND(&p->payload[off], l);
+            len -= l;
+            off = 0;
+        }
+    } else {
+        AT_PORT_SEND(&m->msg.conn_send.data[off], len);
+    }
+}
+
+/**
+ * \brief           Send data for current `AT+CIPSEND` command, after `>` has been received
+ */
+static void
+lwespi_tcpip_send_data_chunk(void) {
+#if LWESP_CFG_CONN_SEND_COALESCE
+    size_t rem = esp.msg->msg.conn_send.sent;
+
+    /* Data may be split across merged messages */
+    for (lwesp_msg_t* m = esp.msg; m != NULL && rem > 0; m = m->msg.conn_send.next) {
+        size_t len = LWESP_MIN(rem, m->msg.conn_send.btw);
+        if (len > 0) {
+            lwespi_conn_send_data_range(m, m->msg.conn_send.ptr, len);
+            rem -= len;
+        }
+    }
+#else /* LWESP_CFG_CONN_SEND_COALESCE */
+    lwespi_conn_send_data_range(esp.msg, esp.msg->msg.conn_send.ptr, esp.msg->msg.conn_send.sent);
+#endif /* !LWESP_CFG_CONN_SEND_COALESCE */
+    AT_PORT_SEND_FLUSH();
+}
+
 /**
  * \brief           Process and send data from device buffer
  * \return          Member of \ref lwespr_t enumeration
@@ -440,12 +1094,31 @@ lwespi_tcpip_process_send_data(void) {
         CONN_SEND_DATA_SEND_EVT(esp.msg, lwespCLOSED);
         return lwespERR;
     }
-    esp.msg->msg.conn_send.sent = LWESP_MIN(esp.msg->msg.conn_send.btw, LWESP_CFG_CONN_MAX_DATA_LEN);
+#if LWESP_CFG_CONN_SEND_COALESCE
+    esp.msg->msg.conn_send.sent = LWESP_MIN(lwespi_conn_send_chain_btw(esp.msg), LWESPI_CONN_MAX_DATA_LEN());
+#else /* LWESP_CFG_CONN_SEND_COALESCE */
+    esp.msg->msg.conn_send.sent = LWESP_MIN(esp.msg->msg.conn_send.btw, LWESPI_CONN_MAX_DATA_LEN());
+#endif /* !LWESP_CFG_CONN_SEND_COALESCE */
+
+#if LWESP_CFG_CONN_SEND_BUFFERED
+    /* TCP data are copied to device buffer, remote acknowledge is reported asynchronously */
+    esp.msg->msg.conn_send.buffered = c->type == LWESP_CONN_TYPE_TCP;
+    if (esp.msg->msg.conn_send.buffered) {
+        if (c->sendbuf.cnt >= LWESP_ARRAYSIZE(c->sendbuf.id)) { /* All segments in flight, check which were acknowledged */
+            esp.msg->cmd = LWESP_CMD_TCPIP_CIPBUFSTATUS;
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CIPBUFSTATUS=");
+            lwespi_send_number(LWESP_U32(c->num), 0, 0);
+            AT_PORT_SEND_END_AT();
+            return lwespOK;
+        }
+        AT_PORT_SEND_CONN_DATA_CMD("+CIPSENDBUF=", c->num, esp.msg->msg.conn_send.sent);
+        AT_PORT_SEND_END_AT();
+        return lwespOK;
+    }
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED */
 
-    AT_PORT_SEND_BEGIN_AT();
-    AT_PORT_SEND_CONST_STR("+CIPSEND=");
-    lwespi_send_number(LWESP_U32(c->num), 0, 0);/* Send connection number */
-    lwespi_send_number(LWESP_U32(esp.msg->msg.conn_send.sent), 0, 1);   /* Send length number */
+    AT_PORT_SEND_CONN_DATA_CMD("+CIPSEND=", c->num, esp.msg->msg.conn_send.sent);/* Send connection number and length */
 
     /* On UDP connections, IP address and port may be included */
     if (c->type == LWESP_CONN_TYPE_UDP) {
@@ -467,20 +1140,61 @@ lwespi_tcpip_process_send_data(void) {
 static uint8_t
 lwespi_tcpip_process_data_sent(uint8_t sent) {
     if (sent) {                                 /* Data were successfully sent */
+#if LWESP_CFG_CONN_SEND_COALESCE
+        size_t rem = esp.msg->msg.conn_send.sent;
+
+        /*
+         * Sent data are accounted to head message first,
+         * then to merged messages, which are finished once all their data are sent
+         */
+        for (lwesp_msg_t* m = esp.msg, *prev = NULL; m != NULL && rem > 0;) {
+            size_t len = LWESP_MIN(rem, m->msg.conn_send.btw);
+            m->msg.conn_send.sent_all += len;
+            m->msg.conn_send.btw -= len;
+            m->msg.conn_send.ptr += len;
+            if (m->msg.conn_send.bw != NULL) {
+                *m->msg.conn_send.bw += len;
+            }
+            rem -= len;
+            if (m != esp.msg && m->msg.conn_send.btw == 0) {
+                lwesp_msg_t* n = m->msg.conn_send.next;
+                prev->msg.conn_send.next = n;   /* Remove from chain */
+                lwespi_conn_send_msg_done(m, lwespOK);
+                m = n;
+            } else {
+                prev = m;
+                m = m->msg.conn_send.next;
+            }
+        }
+#else /* LWESP_CFG_CONN_SEND_COALESCE */
         esp.msg->msg.conn_send.sent_all += esp.msg->msg.conn_send.sent;
         esp.msg->msg.conn_send.btw -= esp.msg->msg.conn_send.sent;
         esp.msg->msg.conn_send.ptr += esp.msg->msg.conn_send.sent;
         if (esp.msg->msg.conn_send.bw != NULL) {
             *esp.msg->msg.conn_send.bw += esp.msg->msg.conn_send.sent;
         }
+#endif /* !LWESP_CFG_CONN_SEND_COALESCE */
         esp.msg->msg.conn_send.tries = 0;
+        LWESPI_STATS_CONN_ADD(esp.msg->msg.conn_send.conn, tx_bytes, esp.msg->msg.conn_send.sent);
+        LWESPI_STATS_CONN_ADD(esp.msg->msg.conn_send.conn, tx_packets, 1);
+#if LWESP_CFG_CONN_SEND_FAIR
+        if (lwespi_conn_sched_yield(esp.msg)) {
+            return 1;                           /* Remaining data are sent in next turn of connection */
+        }
+#endif /* LWESP_CFG_CONN_SEND_FAIR */
     } else {                                    /* We were not successful */
         ++esp.msg->msg.conn_send.tries;         /* Increase number of tries */
-        if (esp.msg->msg.conn_send.tries == LWESP_CFG_MAX_SEND_RETRIES) {   /* In case we reached max number of retransmissions */
+        LWESPI_STATS_CONN_ADD(esp.msg->msg.conn_send.conn, send_fails, 1);
+        if (esp.msg->msg.conn_send.tries >= LWESPI_PARAM(MAX_SEND_RETRIES)) {   /* In case we reached max number of retransmissions */
             return 1;                           /* Return 1 and indicate error */
         }
+        LWESPI_STATS_CONN_ADD(esp.msg->msg.conn_send.conn, send_retries, 1);
     }
+#if LWESP_CFG_CONN_SEND_COALESCE
+    if (lwespi_conn_send_chain_btw(esp.msg) > 0) {  /* Do we still have data to send, including merged messages? */
+#else /* LWESP_CFG_CONN_SEND_COALESCE */
     if (esp.msg->msg.conn_send.btw > 0) {       /* Do we still have data to send? */
+#endif /* !LWESP_CFG_CONN_SEND_COALESCE */
         if (lwespi_tcpip_process_send_data() != lwespOK) {  /* Check if we can continue */
             return 1;                           /* Finish at this point */
         }
@@ -509,12 +1223,157 @@ lwespi_send_conn_error_cb(lwesp_msg_t* msg, lwespr_t error) {
 }
 
 /**
- * \brief           Process received string from ESP
- * \param[in]       rcv: Pointer to \ref lwesp_recv_t structure with input string
+ * \brief           Get baudrate for `AT+UART_CUR` command
+ *
+ * When command is part of reset sequence (flow control setup), current baudrate is kept
+ *
+ * \param[in]       msg: Current message
+ * \return          Baudrate to use
  */
-static void
-lwespi_parse_received(lwesp_recv_t* rcv) {
+static uint32_t
+lwespi_uart_cmd_baudrate(lwesp_msg_t* msg) {
+    if (msg->cmd_def == LWESP_CMD_UART || msg->cmd_def == LWESP_CMD_UART_AUTOBAUD) {
+        return msg->msg.uart.baudrate;
+    }
+    return esp.ll.uart.baudrate;
+}
+
+/**
+ * \brief           Get Wi-Fi mode set by reset sequence
+ * \return          Member of \ref lwesp_mode_t enumeration
+ */
+static lwesp_mode_t
+lwespi_reset_wifi_mode(void) {
+#if LWESP_CFG_MODE_STATION_ACCESS_POINT
+    return LWESP_MODE_STA_AP;                   /* Set station and access point mode */
+#elif LWESP_CFG_MODE_STATION
+    return LWESP_MODE_STA;                      /* Set station mode */
+#else /* LWESP_CFG_MODE_STATION */
+    return LWESP_MODE_AP;                       /* Set access point mode */
+#endif /* !LWESP_CFG_MODE_STATION_ACCESS_POINT */
+}
+
+#if (LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT > LWESP_CFG_CONN_MAX_DATA_LEN && LWESP_CFG_MODE_STATION) || __DOXYGEN__
+/**
+ * \brief           Get maximal number of bytes device firmware accepts with single `AT+CIPSEND` command
+ * \note            Device type and AT version must be known
+ * \return          Maximal length in units of bytes
+ */
+static size_t
+lwespi_get_fw_max_data_len(void) {
+#if LWESP_CFG_ESP32
+    if (esp.m.device == LWESP_DEVICE_ESP32 && esp.m.version_at.major >= 2) {
+        return 8192;
+    }
+#endif /* LWESP_CFG_ESP32 */
+    return 2048;
+}
+#endif /* (LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT > LWESP_CFG_CONN_MAX_DATA_LEN && LWESP_CFG_MODE_STATION) || __DOXYGEN__ */
+
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+
+/**
+ * \brief           Adopt connection found active on device during warm init
+ *
+ * Application gets \ref LWESP_EVT_CONN_RESYNC event first, where it shall set callback
+ * with \ref lwesp_conn_set_evt_fn to keep the connection.
+ * Connections left without callback are closed
+ *
+ * \param[in]       conn: Connection reported by `AT+CIPSTATUS`
+ */
+static void
+lwespi_conn_resync(lwesp_conn_p conn) {
+    conn->val_id = LWESPI_CONN_GEN_NEXT(conn->val_id);  /* Set new validation ID */
+    LWESPI_CONN_TX_QUEUE_INIT(conn);
+    LWESPI_CONN_MANUAL_RECV_INIT(conn);
+    LWESPI_CONN_WRITE_FLUSH_INIT(conn);
+    conn->status.f.active = 1;
+    conn->evt_func = conn->status.f.client ? NULL : esp.evt_server;
+    conn->arg = NULL;
+    conn->poll_base = LWESPI_PARAM(CONN_POLL_INTERVAL);
+
+    esp.evt.evt.conn_resync.conn = conn;
+    lwespi_send_cb(LWESP_EVT_CONN_RESYNC);      /* Let application reattach to connection */
+
+    if (conn->evt_func == NULL) {               /* Nobody claimed the connection */
+        lwesp_conn_close(conn, 0);
+        return;
+    }
+    esp.evt.type = LWESP_EVT_CONN_ACTIVE;
+    esp.evt.evt.conn_active_close.conn = conn;
+    esp.evt.evt.conn_active_close.client = conn->status.f.client;
+    esp.evt.evt.conn_active_close.forced = 0;   /* Connection was not opened by this run */
+    lwespi_send_conn_cb(conn, NULL);
+}
+
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
+
+/**
+ * \brief           Update connections after `AT+CIPSTATUS` response
+ *
+ * New bitmap is compared with status before command,
+ * only connections with changed status are processed
+ */
+static void
+lwespi_conn_status_diff(void) {
+    for (size_t w = 0; w < LWESPI_CONN_BITMAP_LEN; ++w) {
+        uint32_t diff = esp.m.active_conns[w] ^ esp.m.active_conns_last[w];
+
+        for (size_t num = w * 32; diff != 0 && num < LWESP_CFG_MAX_CONNS; ++num, diff >>= 1) {
+            lwesp_conn_p conn = &esp.m.conns[num];
+
+            if (!(diff & 0x01)) {
+                continue;
+            }
+            if (LWESPI_CONN_BIT_GET(esp.m.active_conns, num)) {
+#if LWESP_CFG_WARM_INIT
+                if (!conn->status.f.active && CMD_IS_DEF(LWESP_CMD_RESET) && esp.msg->msg.reset.warm == 2) {
+                    lwespi_conn_resync(conn);   /* Connection survived host restart */
+                    continue;
+                }
+#endif /* LWESP_CFG_WARM_INIT */
+                conn->status.f.active = 1;
+            } else if (conn->status.f.active) { /* Closed without notification */
+                conn->status.f.active = 0;
+
+                esp.evt.type = LWESP_EVT_CONN_CLOSE;
+                esp.evt.evt.conn_active_close.conn = conn;
+                esp.evt.evt.conn_active_close.client = conn->status.f.client;
+                esp.evt.evt.conn_active_close.forced = 0;
+                esp.evt.evt.conn_active_close.res = lwespOK;
+                lwespi_send_conn_cb(conn, NULL);
+
+                if (conn->buff.buff != NULL) {  /* Check if write buffer is set */
+                    lwespi_conn_buff_free(conn->buff.buff);
+                    conn->buff.buff = NULL;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Finish line which did not fit into receive buffer
+ *
+ * Line end is restored, so that parsers see complete (although shortened) line
+ */
+static void
+lwespi_recv_line_truncated(void) {
+    recv_buff.data[recv_buff.len - 2] = '\r';
+    recv_buff.data[recv_buff.len - 1] = '\n';
+    LWESPI_STATS_RECV_LINE_TRUNC();
+    LWESP_DEBUGF(LWESP_CFG_DBG_INPUT | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING,
+               "[LWESP] Received line truncated to %d bytes, increase LWESP_CFG_RECV_LINE_BUFF_LEN\r\n", (int)recv_buff.len);
+}
+
+/**
+ * \brief           Process received string from ESP
+ * \param[in]       rcv: Pointer to \ref lwesp_recv_t structure with input string
+ */
+static void
+lwespi_parse_received(lwesp_recv_t* rcv) {
     uint8_t is_ok = 0, is_error = 0, is_ready = 0;
+    lwespi_resp_kw_t kw;
     const char* s;
 
     /* Try to remove non-parsable strings */
@@ -533,13 +1392,28 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
         return;
     }
 
-    /* Detect most common responses from device */
-    is_ok = !strcmp(rcv->data, "OK" CRLF);      /* Check if received string is OK */
-    if (!is_ok) {
-        is_error = !strcmp(rcv->data, "ERROR" CRLF) || !strcmp(rcv->data, "FAIL" CRLF); /* Check if received string is error */
-        if (!is_error) {
-            is_ready = !strcmp(rcv->data, "ready" CRLF);/* Check if received string is ready */
-        }
+    /*
+     * Detect most common responses from device
+     *
+     * Length selects single candidate string, so that
+     * any line is compared to at most one status response
+     */
+    switch (rcv->len) {
+        case sizeof("OK" CRLF) - 1:
+            is_ok = !strcmp(rcv->data, "OK" CRLF);
+            break;
+        case sizeof("FAIL" CRLF) - 1:
+            is_error = !strcmp(rcv->data, "FAIL" CRLF);
+            break;
+        case sizeof("ERROR" CRLF) - 1:          /* Same length as "ready" */
+            if (rcv->data[0] == 'E') {
+                is_error = !strcmp(rcv->data, "ERROR" CRLF);
+            } else {
+                is_ready = !strcmp(rcv->data, "ready" CRLF);
+            }
+            break;
+        default:
+            break;
     }
 
     /*
@@ -561,40 +1435,70 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
         lwespi_send_cb(LWESP_EVT_RESET_DETECTED);   /* Call user callback function */
     }
 
-    /* Read and process statements starting with '+' character */
+    /*
+     * Read and process statements starting with '+' character
+     *
+     * Keyword is found with single hash table lookup,
+     * instead of comparing line against every known statement
+     */
+    kw = lwespi_parse_get_resp_kw(rcv->data);
+
+    /*
+     * Network data is most frequent statement during data transfer.
+     * Line carries no other information, skip all remaining checks
+     */
+    if (kw == LWESP_RESP_KW_IPD) {
+        lwespi_parse_ipd(rcv->data, rcv->len);  /* Parse IPD statement and start receiving network data */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+        if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPRECVDATA) && CMD_IS_CUR(LWESP_CMD_TCPIP_CIPRECVLEN)) {
+            esp.msg->msg.ciprecvdata.ipd_recv = 1;  /* Command repeat, try again */
+        }
+        /* IPD message notification? */
+        lwespi_conn_manual_tcp_try_read_data(esp.m.ipd.conn);
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+        return;
+    }
     if (rcv->data[0] == '+') {
-        if (!strncmp("+IPD", rcv->data, 4)) {   /* Check received network data */
-            lwespi_parse_ipd(rcv->data);        /* Parse IPD statement and start receiving network data */
+        switch (kw) {
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
-            if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPRECVDATA) && CMD_IS_CUR(LWESP_CMD_TCPIP_CIPRECVLEN)) {
-                esp.msg->msg.ciprecvdata.ipd_recv = 1;  /* Command repeat, try again */
-            }
-            /* IPD message notification? */
-            lwespi_conn_manual_tcp_try_read_data(esp.m.ipd.conn);
-        } else if (!strncmp("+CIPRECVDATA", rcv->data, 12)) {
-            lwespi_parse_ciprecvdata(rcv->data);/* Parse CIPRECVDATA statement and start receiving network data */
-        } else if (!strncmp("+CIPRECVLEN", rcv->data, 11)) {
-            lwespi_parse_ciprecvlen(rcv->data); /* Parse CIPRECVLEN statement */
+            case LWESP_RESP_KW_CIPRECVDATA: {
+                lwespi_parse_ciprecvdata(rcv->data);/* Parse CIPRECVDATA statement and start receiving network data */
+                break;
+            }
+            case LWESP_RESP_KW_CIPRECVLEN: {
+                lwespi_parse_ciprecvlen(rcv->data); /* Parse CIPRECVLEN statement */
+                break;
+            }
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
 #if LWESP_CFG_MODE_ACCESS_POINT
-        } else if (!strncmp(rcv->data, "+STA_CONNECTED", 14)) {
-            lwespi_parse_ap_conn_disconn_sta(&rcv->data[15], 1);/* Parse string and send to user layer */
-        } else if (!strncmp(rcv->data, "+STA_DISCONNECTED", 17)) {
-            lwespi_parse_ap_conn_disconn_sta(&rcv->data[18], 0);/* Parse string and send to user layer */
-        } else if (!strncmp(rcv->data, "+DIST_STA_IP", 12)) {
-            lwespi_parse_ap_ip_sta(&rcv->data[13]); /* Parse string and send to user layer */
+            case LWESP_RESP_KW_STA_CONNECTED: {
+                lwespi_parse_ap_conn_disconn_sta(&rcv->data[15], 1);/* Parse string and send to user layer */
+                break;
+            }
+            case LWESP_RESP_KW_STA_DISCONNECTED: {
+                lwespi_parse_ap_conn_disconn_sta(&rcv->data[18], 0);/* Parse string and send to user layer */
+                break;
+            }
+            case LWESP_RESP_KW_DIST_STA_IP: {
+                lwespi_parse_ap_ip_sta(&rcv->data[13]); /* Parse string and send to user layer */
+                break;
+            }
 #endif /* LWESP_CFG_MODE_ACCESS_POINT */
-        } else if (esp.msg != NULL) {
-            if (0
+            case LWESP_RESP_KW_CIPSTAMAC:
+            case LWESP_RESP_KW_CIPAPMAC: {
+                const char* tmp;
+                lwesp_mac_t mac;
+
+                if (!(0
 #if LWESP_CFG_MODE_STATION
-                || (CMD_IS_CUR(LWESP_CMD_WIFI_CIPSTAMAC_GET) && !strncmp(rcv->data, "+CIPSTAMAC", 10))
+                      || (CMD_IS_CUR(LWESP_CMD_WIFI_CIPSTAMAC_GET) && kw == LWESP_RESP_KW_CIPSTAMAC)
 #endif /* LWESP_CFG_MODE_STATION */
 #if LWESP_CFG_MODE_ACCESS_POINT
-                || (CMD_IS_CUR(LWESP_CMD_WIFI_CIPAPMAC_GET) && !strncmp(rcv->data, "+CIPAPMAC", 9))
+                      || (CMD_IS_CUR(LWESP_CMD_WIFI_CIPAPMAC_GET) && kw == LWESP_RESP_KW_CIPAPMAC)
 #endif /* LWESP_CFG_MODE_ACCESS_POINT */
-               ) {
-                const char* tmp;
-                lwesp_mac_t mac;
+                     )) {
+                    break;
+                }
 
                 if (rcv->data[9] == ':') {
                     tmp = &rcv->data[10];
@@ -616,26 +1520,22 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
                 if (esp.msg->msg.sta_ap_getmac.mac != NULL && CMD_IS_CUR(CMD_GET_DEF())) {
                     LWESP_MEMCPY(esp.msg->msg.sta_ap_getmac.mac, &mac, sizeof(mac));/* Copy to current setup */
                 }
-            } else if (0
-#if LWESP_CFG_MODE_STATION
-                       || (CMD_IS_CUR(LWESP_CMD_WIFI_CIPSTA_GET) && !strncmp(rcv->data, "+CIPSTA", 7))
-#endif /* LWESP_CFG_MODE_STATION */
-#if LWESP_CFG_MODE_ACCESS_POINT
-                       || (CMD_IS_CUR(LWESP_CMD_WIFI_CIPAP_GET) && !strncmp(rcv->data, "+CIPAP", 6))
-#endif /* LWESP_CFG_MODE_ACCESS_POINT */
-                      ) {
+                break;
+            }
+            case LWESP_RESP_KW_CIPSTA:
+            case LWESP_RESP_KW_CIPAP: {
                 const char* tmp = NULL;
                 lwesp_ip_t ip, *a = NULL, *b = NULL;
-                lwesp_ip_mac_t* im;
+                lwesp_ip_mac_t* im = NULL;
                 uint8_t ch = 0;
 
 #if LWESP_CFG_MODE_STATION
-                if (CMD_IS_CUR(LWESP_CMD_WIFI_CIPSTA_GET)) {
+                if (CMD_IS_CUR(LWESP_CMD_WIFI_CIPSTA_GET) && kw == LWESP_RESP_KW_CIPSTA) {
                     im = &esp.m.sta;            /* Get IP and MAC structure first */
                 }
 #endif /* LWESP_CFG_MODE_STATION */
 #if LWESP_CFG_MODE_ACCESS_POINT
-                if (CMD_IS_CUR(LWESP_CMD_WIFI_CIPAP_GET)) {
+                if (CMD_IS_CUR(LWESP_CMD_WIFI_CIPAP_GET) && kw == LWESP_RESP_KW_CIPAP) {
                     im = &esp.m.ap;             /* Get IP and MAC structure first */
                 }
 #endif /* LWESP_CFG_MODE_ACCESS_POINT */
@@ -680,58 +1580,127 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
                         }
                     }
                 }
+                break;
+            }
 #if LWESP_CFG_MODE_STATION
-            } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CWLAP) && !strncmp(rcv->data, "+CWLAP", 6)) {
-                lwespi_parse_cwlap(rcv->data, esp.msg); /* Parse CWLAP entry */
-            } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CWJAP) && !strncmp(rcv->data, "+CWJAP", 6)) {
-                const char* tmp = &rcv->data[7];/* Go to the number position */
-                esp.msg->msg.sta_join.error_num = (uint8_t)lwespi_parse_number(&tmp);
-            } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CWJAP_GET) && !strncmp(rcv->data, "+CWJAP", 6)) {
-                lwespi_parse_cwjap(rcv->data, esp.msg); /* Parse CWJAP */
+            case LWESP_RESP_KW_CWLAP: {
+                if (CMD_IS_CUR(LWESP_CMD_WIFI_CWLAP)) {
+                    lwespi_parse_cwlap(rcv->data, esp.msg); /* Parse CWLAP entry */
+                }
+                break;
+            }
+            case LWESP_RESP_KW_CWJAP: {
+                if (CMD_IS_CUR(LWESP_CMD_WIFI_CWJAP)) {
+                    const char* tmp = &rcv->data[7];/* Go to the number position */
+                    esp.msg->msg.sta_join.error_num = (uint8_t)lwespi_parse_number(&tmp);
+                } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CWJAP_GET)) {
+                    if (lwespi_parse_cwjap(rcv->data, esp.msg) && CMD_IS_DEF(LWESP_CMD_RESET)) {
+                        esp.m.sta.is_connected = 1; /* Station stayed joined over warm init */
+                    }
+                }
+                break;
+            }
 #endif /* LWESP_CFG_MODE_STATION */
 #if LWESP_CFG_MODE_ACCESS_POINT
-            } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CWLIF) && !strncmp(rcv->data, "+CWLIF", 6)) {
-                lwespi_parse_cwlif(rcv->data, esp.msg); /* Parse CWLIF entry */
-            } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CWSAP_GET) && !strncmp(rcv->data, "+CWSAP", 6)) {
-                lwespi_parse_cwsap(rcv->data, esp.msg);
+            case LWESP_RESP_KW_CWLIF: {
+                if (CMD_IS_CUR(LWESP_CMD_WIFI_CWLIF)) {
+                    lwespi_parse_cwlif(rcv->data, esp.msg); /* Parse CWLIF entry */
+                }
+                break;
+            }
+            case LWESP_RESP_KW_CWSAP: {
+                if (CMD_IS_CUR(LWESP_CMD_WIFI_CWSAP_GET)) {
+                    lwespi_parse_cwsap(rcv->data, esp.msg);
+                }
+                break;
+            }
 #endif /* LWESP_CFG_MODE_ACCESS_POINT */
 #if LWESP_CFG_DNS
-            } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPDOMAIN) && !strncmp(rcv->data, "+CIPDOMAIN", 10)) {
-                lwespi_parse_cipdomain(rcv->data, esp.msg); /* Parse CIPDOMAIN entry */
-            } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPDNS_GET) && !strncmp(rcv->data, "+CIPDNS", 7)) {
-                const char* tmp = &rcv->data[8];/* Go to the ip position */
-                lwesp_ip_t ip;
-                uint8_t index = lwespi_parse_number(&tmp);
-                esp.msg->msg.dns_getconf.dnsi = index;
-                lwespi_parse_ip(&tmp, &ip);     /* Parse DNS address */
-                if (esp.msg->msg.dns_getconf.s1 != NULL) {
-                    *esp.msg->msg.dns_getconf.s1 = ip;
-                }
-                if (esp.msg->msg.dns_getconf.s2 != NULL && lwespi_parse_ip(&tmp, &ip)) {
-                    *esp.msg->msg.dns_getconf.s2 = ip;
+            case LWESP_RESP_KW_CIPDOMAIN: {
+                if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPDOMAIN)) {
+                    lwespi_parse_cipdomain(rcv->data, esp.msg); /* Parse CIPDOMAIN entry */
+                }
+                break;
+            }
+            case LWESP_RESP_KW_CIPDNS: {
+                if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPDNS_GET)) {
+                    const char* tmp = &rcv->data[8];/* Go to the ip position */
+                    lwesp_ip_t ip;
+                    uint8_t index = lwespi_parse_number(&tmp);
+                    esp.msg->msg.dns_getconf.dnsi = index;
+                    lwespi_parse_ip(&tmp, &ip); /* Parse DNS address */
+                    if (esp.msg->msg.dns_getconf.s1 != NULL) {
+                        *esp.msg->msg.dns_getconf.s1 = ip;
+                    }
+                    if (esp.msg->msg.dns_getconf.s2 != NULL && lwespi_parse_ip(&tmp, &ip)) {
+                        *esp.msg->msg.dns_getconf.s2 = ip;
+                    }
                 }
+                break;
+            }
 #endif /* LWESP_CFG_DNS */
 #if LWESP_CFG_PING
-            } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_PING) && !strncmp(rcv->data, "+PING", 5)) {
-                lwespi_parse_ping_time(rcv->data, esp.msg); /* Parse ping time */
+            case LWESP_RESP_KW_PING: {
+                if (CMD_IS_CUR(LWESP_CMD_TCPIP_PING)) {
+                    lwespi_parse_ping_time(rcv->data, esp.msg); /* Parse ping time */
+                }
+                break;
+            }
 #endif /* LWESP_CFG_PING */
 #if LWESP_CFG_SNTP
-            } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSNTPTIME) && !strncmp(rcv->data, "+CIPSNTPTIME", 12)) {
-                lwespi_parse_cipsntptime(rcv->data, esp.msg);   /* Parse CIPSNTPTIME entry */
+            case LWESP_RESP_KW_CIPSNTPTIME: {
+                if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSNTPTIME)
+                    && lwespi_parse_cipsntptime(rcv->data, esp.msg)) {  /* Parse CIPSNTPTIME entry */
+#if LWESP_CFG_SNTP_CLOCK
+                    lwespi_sntp_clock_sync(esp.msg->msg.tcpip_sntp_time.dt);
+#endif /* LWESP_CFG_SNTP_CLOCK */
+                }
+                break;
+            }
 #endif /* LWESP_CFG_SNTP */
 #if LWESP_CFG_HOSTNAME
-            } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CWHOSTNAME_GET) && !strncmp(rcv->data, "+CWHOSTNAME", 11)) {
-                lwespi_parse_hostname(rcv->data, esp.msg);  /* Parse HOSTNAME entry */
+            case LWESP_RESP_KW_CWHOSTNAME: {
+                if (CMD_IS_CUR(LWESP_CMD_WIFI_CWHOSTNAME_GET)) {
+                    lwespi_parse_hostname(rcv->data, esp.msg);  /* Parse HOSTNAME entry */
+#if LWESP_CFG_IP_MAC_CACHE
+                    lwespi_hostname_cache_set(rcv->data);   /* Keep local copy */
+#endif /* LWESP_CFG_IP_MAC_CACHE */
+                }
+                break;
+            }
 #endif /* LWESP_CFG_HOSTNAME */
-            } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CWDHCP_GET) && !strncmp(rcv->data, "+CWDHCP", 7)) {
-                lwespi_parse_cwdhcp(rcv->data); /* Parse CWDHCP state */
-            } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CWMODE_GET) && !strncmp(rcv->data, "+CWMODE", 7)) {
-                const char* tmp = &rcv->data[8];/* Go to the number position */
-                *esp.msg->msg.wifi_mode.mode_get = (uint8_t)lwespi_parse_number(&tmp);
+            case LWESP_RESP_KW_CWDHCP: {
+                if (CMD_IS_CUR(LWESP_CMD_WIFI_CWDHCP_GET)) {
+                    lwespi_parse_cwdhcp(rcv->data); /* Parse CWDHCP state */
+                }
+                break;
+            }
+            case LWESP_RESP_KW_CWMODE: {
+#if LWESP_CFG_WARM_INIT
+                if (CMD_IS_DEF(LWESP_CMD_RESET)) {
+                    lwespi_warm_state_parse(rcv->data); /* Compare with mode set by reset sequence */
+                    break;
+                }
+#endif /* LWESP_CFG_WARM_INIT */
+                if (CMD_IS_CUR(LWESP_CMD_WIFI_CWMODE_GET)) {
+                    const char* tmp = &rcv->data[8];/* Go to the number position */
+                    *esp.msg->msg.wifi_mode.mode_get = (uint8_t)lwespi_parse_number(&tmp);
+                }
+                break;
             }
+            default:
+#if LWESP_CFG_WARM_INIT
+                if (CMD_IS_DEF(LWESP_CMD_RESET) && esp.msg->msg.reset.warm == 1) {
+                    lwespi_warm_state_parse(rcv->data); /* Configuration queried on warm init */
+                }
+#endif /* LWESP_CFG_WARM_INIT */
+                break;
         }
 #if LWESP_CFG_MODE_STATION
-    } else if (strlen(rcv->data) > 4 && !strncmp(rcv->data, "WIFI", 4)) {
+    } else if (rcv->len > 4 && !strncmp(rcv->data, "WIFI", 4)) {
+#if LWESP_CFG_IP_MAC_CACHE
+        esp.m.sta.ip_valid = 0;                 /* Any Wi-Fi event may change IP settings */
+#endif /* LWESP_CFG_IP_MAC_CACHE */
         if (!strncmp(&rcv->data[5], "CONNECTED", 9)) {
             esp.m.sta.is_connected = 1;         /* Wifi is connected */
             lwespi_send_cb(LWESP_EVT_WIFI_CONNECTED);   /* Call user callback function */
@@ -785,6 +1754,10 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
             if (!ok) {
                 lwespi_send_cb(LWESP_EVT_AT_VERSION_NOT_SUPPORTED);
             }
+#if LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT > LWESP_CFG_CONN_MAX_DATA_LEN
+            esp.m.conn_max_data_len = LWESP_MAX(LWESP_CFG_CONN_MAX_DATA_LEN,
+                                                LWESP_MIN(lwespi_get_fw_max_data_len(), LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT));
+#endif /* LWESP_CFG_CONN_MAX_DATA_LEN_LIMIT > LWESP_CFG_CONN_MAX_DATA_LEN */
         } else if (!strncmp(rcv->data, "SDK version", 11)) {
             lwespi_parse_at_sdk_version(&rcv->data[12], &esp.m.version_sdk);
         }
@@ -796,14 +1769,14 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
         if ((CMD_IS_CUR(LWESP_CMD_RESET) || CMD_IS_CUR(LWESP_CMD_RESTORE)) && is_ok) {  /* Check for reset/restore command */
             is_ok = 0;                          /* We must wait for "ready", not only "OK" */
             esp.ll.uart.baudrate = LWESP_CFG_AT_PORT_BAUDRATE;  /* Save user baudrate */
+            esp.ll.uart.flow_control = 0;       /* Device starts without flow control */
             lwesp_ll_init(&esp.ll);             /* Set new baudrate */
         } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSTATUS)) {
-            if (!strncmp(rcv->data, "+CIPSTATUS", 10)) {
+            if (kw == LWESP_RESP_KW_CIPSTATUS) {
                 lwespi_parse_cipstatus(rcv->data + 11); /* Parse CIPSTATUS response */
             } else if (is_ok) {
-                for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {  /* Set current connection statuses */
-                    esp.m.conns[i].status.f.active = !!(esp.m.active_conns & (1 << i));
-                }
+                lwespi_conn_status_diff();      /* Process only connections with changed status */
+                esp.m.conn_status_stale = 0;
             }
         } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSTART)) {
             /*
@@ -818,15 +1791,33 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
 
             }
             */
+#if LWESP_CFG_CONN_PASSTHROUGH
+        } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSEND_PASSTHROUGH)) {
+            is_ok = 0;                          /* Wait for "> " statement after OK */
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
+#if LWESP_CFG_CONN_SEND_BUFFERED
+        } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPBUFSTATUS)) {
+            lwespi_parse_cipbufstatus(rcv->data, esp.msg);  /* Release acknowledged segments */
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED */
         } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSEND)) {
             if (is_ok) {                        /* Check for OK and clear as we have to check for "> " statement after OK */
                 is_ok = 0;                      /* Do not reach on OK */
             }
             if (esp.msg->msg.conn_send.wait_send_ok_err) {
-                if (!strncmp("SEND OK", rcv->data, 7)) {/* Data were sent successfully */
+                uint8_t sent_ok = !strncmp("SEND OK", rcv->data, 7);
+#if LWESP_CFG_CONN_SEND_BUFFERED
+                /* Buffered chunk is done once device copied it, acknowledge is reported asynchronously */
+                if (esp.msg->msg.conn_send.buffered) {
+                    sent_ok = !strncmp("Recv ", rcv->data, 5);
+                    if (sent_ok) {
+                        lwespi_conn_sendbuf_add(esp.msg->msg.conn_send.conn, esp.msg->msg.conn_send.seg_id, esp.msg->msg.conn_send.sent);
+                    }
+                }
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED */
+                if (sent_ok) {                  /* Data were sent successfully */
                     esp.msg->msg.conn_send.wait_send_ok_err = 0;
                     is_ok = lwespi_tcpip_process_data_sent(1);  /* Process as data were sent */
-                    if (is_ok && esp.msg->msg.conn_send.conn->status.f.active) {
+                    if (is_ok && esp.msg->msg.conn_send.conn->status.f.active && !LWESPI_CONN_SEND_YIELDED(esp.msg)) {
                         CONN_SEND_DATA_SEND_EVT(esp.msg, lwespOK);
                     }
                 } else if (is_error || !strncmp("SEND FAIL", rcv->data, 9)) {
@@ -836,17 +1827,33 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
                         CONN_SEND_DATA_SEND_EVT(esp.msg, lwespERR);
                     }
                 }
+#if LWESP_CFG_CONN_SEND_BUFFERED
+            } else if (esp.msg->msg.conn_send.buffered && !is_error) {
+                lwespi_parse_cipsendbuf(rcv->data, esp.msg);/* Segment ID is reported before "> " */
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED */
             } else if (is_error) {
                 CONN_SEND_DATA_SEND_EVT(esp.msg, lwespERR);
             }
         } else if (CMD_IS_CUR(LWESP_CMD_UART)) {/* In case of UART command */
-            if (is_ok) {                        /* We have valid OK result */
-                esp.ll.uart.baudrate = esp.msg->msg.uart.baudrate;  /* Save user baudrate */
-                lwesp_ll_init(&esp.ll);         /* Set new baudrate */
+            if (CMD_IS_DEF(LWESP_CMD_UART_AUTOBAUD) && esp.msg->msg.uart.fallback) {
+                is_ok = 0;                      /* Response at unstable baudrate cannot be trusted, */
+                is_error = 0;                   /* wait for switch timeout instead */
+            } else if (is_ok) {                 /* We have valid OK result */
+                esp.ll.uart.baudrate = lwespi_uart_cmd_baudrate(esp.msg);   /* Save user baudrate */
+                esp.ll.uart.flow_control = LWESP_CFG_AT_PORT_FLOW_CONTROL;
+                lwesp_ll_init(&esp.ll);         /* Set new baudrate and flow control */
             }
         }
     }
 
+#if LWESP_CFG_CONN_SEND_BUFFERED
+    /* Acknowledge of segment sent with `AT+CIPSENDBUF` may be received at any time */
+    if (LWESP_CHARISNUM(rcv->data[0])
+        && (strstr(rcv->data, ",SEND OK" CRLF) != NULL || strstr(rcv->data, ",SEND FAIL" CRLF) != NULL)) {
+        lwespi_parse_send_ack(rcv->data);
+    }
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED */
+
     /*
      * Check if connection is just active (or closed):
      *
@@ -856,11 +1863,15 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
      * Check LINK_CONN messages
      */
     if (rcv->len > 20 && (s = strstr(rcv->data, "+LINK_CONN:")) != NULL) {
-        if (lwespi_parse_link_conn(s) && esp.m.link_conn.num < LWESP_CFG_MAX_CONNS) {
-            uint8_t id;
+        if (!lwespi_parse_link_conn(s)) {
+            esp.m.conn_status_stale = 1;        /* Connection change was not tracked */
+        } else if (esp.m.link_conn.num < LWESP_CFG_MAX_CONNS) {
+            uint32_t id;
             lwesp_conn_t* conn = &esp.m.conns[esp.m.link_conn.num]; /* Get connection pointer */
+            esp.m.link_conn_urc = 1;            /* Device reports connection changes */
             if (esp.m.link_conn.failed && conn->status.f.active) {  /* Connection failed and now closed? */
                 conn->status.f.active = 0;      /* Connection was just closed */
+                LWESPI_CONN_BIT_CLR(esp.m.active_conns, conn->num);
 
                 esp.evt.type = LWESP_EVT_CONN_CLOSE;
                 esp.evt.evt.conn_active_close.conn = conn;
@@ -872,16 +1883,19 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
 
                 /* Check if write buffer is set */
                 if (conn->buff.buff != NULL) {
-                    LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
-                               "[CONN] Free write buffer: %p\r\n", conn->buff.buff);
-                    lwesp_mem_free_s((void**)&conn->buff.buff);
+                    lwespi_conn_buff_free(conn->buff.buff);
+                    conn->buff.buff = NULL;
                 }
             } else if (!esp.m.link_conn.failed && !conn->status.f.active) {
                 id = conn->val_id;
                 LWESP_MEMSET(conn, 0x00, sizeof(*conn));/* Reset connection parameters */
                 conn->num = esp.m.link_conn.num;/* Set connection number */
                 conn->status.f.active = !esp.m.link_conn.failed;/* Check if connection active */
-                conn->val_id = ++id;            /* Set new validation ID */
+                LWESPI_CONN_BIT_SET(esp.m.active_conns, conn->num);
+                conn->val_id = LWESPI_CONN_GEN_NEXT(id);/* Set new validation ID */
+                LWESPI_CONN_TX_QUEUE_INIT(conn);
+                LWESPI_CONN_MANUAL_RECV_INIT(conn);
+                LWESPI_CONN_WRITE_FLUSH_INIT(conn);
 
                 conn->type = esp.m.link_conn.type;  /* Set connection type */
                 LWESP_MEMCPY(&conn->remote_ip, &esp.m.link_conn.remote_ip, sizeof(conn->remote_ip));
@@ -895,10 +1909,12 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
                     conn->status.f.client = 1;  /* Go to client mode */
                     conn->evt_func = esp.msg->msg.conn_start.evt_func;  /* Set callback function */
                     conn->arg = esp.msg->msg.conn_start.arg;/* Set argument for function */
+                    conn->poll_base = esp.msg->msg.conn_start.poll_interval;
                     esp.msg->msg.conn_start.success = 1;
                 } else {                        /* Server connection start */
                     conn->evt_func = esp.evt_server;/* Set server default callback */
                     conn->arg = NULL;
+                    conn->poll_base = LWESPI_PARAM(CONN_POLL_INTERVAL);
                     conn->type = LWESP_CONN_TYPE_TCP;   /* Set connection type to TCP. @todo: Wait for ESP team to upgrade AT commands to set other type */
                 }
 
@@ -909,7 +1925,9 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
                 lwespi_send_conn_cb(conn, NULL);/* Send event */
                 lwespi_conn_start_timeout(conn);/* Start connection timeout timer */
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
-                lwespi_conn_check_available_rx_data();
+                if (LWESPI_CONN_MANUAL_RECV_ACTIVE()) {
+                    lwespi_conn_check_available_rx_data();
+                }
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
             }
         }
@@ -927,6 +1945,7 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
         if (num < LWESP_CFG_MAX_CONNS) {
             lwesp_conn_t* conn = &esp.m.conns[num]; /* Parse received data */
             conn->num = num;                    /* Set connection number */
+            LWESPI_CONN_BIT_CLR(esp.m.active_conns, num);
             if (conn->status.f.active) {        /* Is connection actually active? */
                 conn->status.f.active = 0;      /* Connection was just closed */
 
@@ -951,9 +1970,8 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
 
             /* Check if write buffer is set */
             if (conn->buff.buff != NULL) {
-                LWESP_DEBUGF(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE,
-                           "[CONN] Free write buffer: %p\r\n", conn->buff.buff);
-                lwesp_mem_free_s((void**)&conn->buff.buff);
+                lwespi_conn_buff_free(conn->buff.buff);
+                conn->buff.buff = NULL;
             }
         }
     } else if (is_error && CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSTART)) {
@@ -977,6 +1995,7 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
     if (is_ok || is_error || is_ready) {
         lwespr_t res = lwespOK;
         if (esp.msg != NULL) {                  /* Do we have active message? */
+            LWESPI_STATS_CMD_DONE(esp.msg, (is_ok || is_ready) ? lwespOK : lwespERR);
             res = lwespi_process_sub_cmd(esp.msg, &is_ok, &is_error, &is_ready);
             if (res != lwespCONT) {             /* Shall we continue with next subcommand under this one? */
                 if (is_ok || is_ready) {        /* Check ready or ok status */
@@ -994,28 +2013,326 @@ lwespi_parse_received(lwesp_recv_t* rcv) {
              * from user thread and start with next command
              */
             if (res != lwespCONT) {             /* Do we have to continue to wait for command? */
-                lwesp_sys_sem_release(&esp.sem_sync);   /* Release semaphore */
+                LWESPI_CMD_SYNC_RELEASE();              /* Release semaphore */
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Get number of remaining bytes of current `+IPD` to deliver to application
+ * \return          Number of bytes, smaller than remaining length when packet was capped by filter
+ */
+static size_t
+ipd_accept_rem(void) {
+#if LWESP_CFG_CONN_IPD_FILTER
+    size_t done = esp.m.ipd.tot_len - esp.m.ipd.rem_len;
+
+    return esp.m.ipd.accept > done ? LWESP_MIN(esp.m.ipd.accept - done, esp.m.ipd.rem_len) : 0;
+#else /* LWESP_CFG_CONN_IPD_FILTER */
+    return esp.m.ipd.rem_len;
+#endif /* !LWESP_CFG_CONN_IPD_FILTER */
+}
+
+/**
+ * \brief           Deliver filled IPD packet buffer to application and prepare next one
+ *
+ * Called when packet buffer is full or all data of current `+IPD` were received
+ */
+static void
+ipd_buff_done(void) {
+    lwespr_t res = lwespOK;
+
+    /* Call user callback function with received data */
+    if (esp.m.ipd.buff != NULL) {           /* Do we have valid buffer? */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+        size_t pbuf_len;
+
+        pbuf_len = lwesp_pbuf_length(esp.m.ipd.buff, 1);
+        esp.m.ipd.conn->tcp_not_ack_bytes += pbuf_len;
+        if (esp.m.ipd.conn->tcp_available_bytes >= pbuf_len) {
+            esp.m.ipd.conn->tcp_available_bytes -= pbuf_len;
+        }
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+
+        esp.m.ipd.conn->total_recved += esp.m.ipd.buff->tot_len;/* Increase number of bytes received */
+        LWESPI_STATS_CONN_ADD(esp.m.ipd.conn, rx_bytes, esp.m.ipd.buff->tot_len);
+        LWESPI_STATS_CONN_ADD(esp.m.ipd.conn, rx_packets, 1);
+
+        /*
+         * Send data buffer to upper layer
+         *
+         * From this moment, user is responsible for packet
+         * buffer and must free it manually
+         */
+#if LWESP_CFG_CONN_RECV_COALESCE_LEN > 0
+        if (conn_recv_coalesce(esp.m.ipd.conn, esp.m.ipd.buff, &res)) {
+            LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
+                       "[IPD] Packet buffer added to receive chain\r\n");
+        } else
+#endif /* LWESP_CFG_CONN_RECV_COALESCE_LEN > 0 */
+        {
+            esp.evt.type = LWESP_EVT_CONN_RECV;
+            esp.evt.evt.conn_data_recv.buff = esp.m.ipd.buff;
+            esp.evt.evt.conn_data_recv.conn = esp.m.ipd.conn;
+            res = lwespi_send_conn_cb(esp.m.ipd.conn, NULL);
+
+            lwesp_pbuf_free(esp.m.ipd.buff);/* Free packet buffer at this point */
+            LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
+                       "[IPD] Free packet buffer\r\n");
+        }
+        if (res == lwespOKIGNOREMORE) {     /* We should ignore more data */
+            LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
+                       "[IPD] Ignoring more data from this IPD if available\r\n");
+            esp.m.ipd.buff = NULL;          /* Set to NULL to ignore more data if possibly available */
+        }
+
+        /*
+         * Create new data packet if case if:
+         *
+         *  - Previous one was successful and more data to read and
+         *  - Connection is not in closing state
+         */
+        if (esp.m.ipd.buff != NULL && ipd_accept_rem() > 0 && !esp.m.ipd.conn->status.f.in_closing) {
+            size_t new_len = LWESP_MIN(ipd_accept_rem(), LWESPI_PARAM(CONN_MAX_RECV_BUFF_SIZE));   /* Calculate new buffer length */
+
+            LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
+                       "[IPD] Allocating new packet buffer of size: %d bytes\r\n", (int)new_len);
+            esp.m.ipd.buff = lwesp_pbuf_new(new_len); /* Allocate new packet buffer */
+
+            LWESP_DEBUGW(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING,
+                       esp.m.ipd.buff == NULL, "[IPD] Buffer allocation failed for %d bytes\r\n", (int)new_len);
+
+            if (esp.m.ipd.buff != NULL) {
+                lwesp_pbuf_set_ip(esp.m.ipd.buff, &esp.m.ipd.ip, esp.m.ipd.port); /* Set IP and port for received data */
+            } else {
+                LWESPI_STATS_CONN_ADD(esp.m.ipd.conn, ipd_drops, 1);
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+                lwespi_conn_manual_tcp_auto_enter();/* Let device buffer further data */
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
             }
+        } else {
+            esp.m.ipd.buff = NULL;          /* Reset it */
         }
     }
+    if (esp.m.ipd.rem_len == 0) {           /* Check if we read everything */
+        LWESPI_TRACE(IPD_DONE, esp.m.ipd.conn != NULL ? esp.m.ipd.conn->num : 0xFF, esp.m.ipd.tot_len);
+        esp.m.ipd.buff = NULL;              /* Reset buffer pointer */
+        esp.m.ipd.read = 0;                 /* Stop reading data */
+#if LWESP_CFG_IPD_ZERO_COPY
+        esp.m.ipd.zero_copy = 0;
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
+    }
+    esp.m.ipd.buff_ptr = 0;                 /* Reset input buffer pointer */
+    RECV_RESET();                           /* Reset receive data */
 }
 
 #if !LWESP_CFG_INPUT_USE_PROCESS || __DOXYGEN__
+#if LWESP_CFG_INPUT_PROCESS_SLICE > 0
+/**
+ * \brief           Release core lock between processed slices of input data
+ *
+ * Parser state is kept in stack structure,
+ * data may be processed in any slice boundaries
+ */
+#define LWESPI_PROCESS_YIELD()              do { lwesp_core_unlock(); lwesp_core_lock(); } while (0)
+#else /* LWESP_CFG_INPUT_PROCESS_SLICE > 0 */
+#define LWESPI_PROCESS_YIELD()              do {} while (0)
+#endif /* !(LWESP_CFG_INPUT_PROCESS_SLICE > 0) */
+
+#if LWESP_CFG_INPUT_PROCESS_BUDGET > 0 || __DOXYGEN__
+/**
+ * \brief           Execute expired timeouts once processing budget is used
+ * \param[in,out]   used: Number of bytes processed since timeouts were last checked
+ * \param[in]       len: Number of bytes just processed
+ */
+static void
+process_budget_check(size_t* used, size_t len) {
+    *used += len;
+    if (*used >= LWESP_CFG_INPUT_PROCESS_BUDGET) {
+        *used = 0;
+        lwespi_timeout_process();
+    }
+}
+#endif /* LWESP_CFG_INPUT_PROCESS_BUDGET > 0 || __DOXYGEN__ */
+
+/**
+ * \brief           Resynchronize parser after input data were lost
+ *
+ * Incomplete `+IPD` is dropped and remaining data are ignored until end of current line
+ *
+ * \note            This function must be called with core locked
+ */
+void
+lwespi_process_resync(void) {
+    if (esp.m.ipd.read) {
+        LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING,
+                   "[IPD] Input data lost, dropping %d bytes of IPD\r\n", (int)esp.m.ipd.tot_len);
+        if (esp.m.ipd.buff != NULL) {
+            lwesp_pbuf_free(esp.m.ipd.buff);
+            esp.m.ipd.buff = NULL;
+        }
+        if (esp.m.ipd.conn != NULL) {
+            LWESPI_STATS_CONN_ADD(esp.m.ipd.conn, ipd_drops, 1);
+        }
+        esp.m.ipd.read = 0;
+        esp.m.ipd.rem_len = 0;
+        esp.m.ipd.buff_ptr = 0;
+#if LWESP_CFG_IPD_ZERO_COPY
+        esp.m.ipd.zero_copy = 0;
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
+    }
+    RECV_RESET();
+    process_resync = 1;
+}
+
+/**
+ * \brief           Check for input overflow once all data written before it were processed
+ * \return          `0` when overflow is pending and data before it are still in buffer, `1` otherwise
+ */
+static uint8_t
+process_overflow_check(void) {
+    if (!esp.input_overflow) {
+        return 1;
+    }
+    LWESP_CFG_MEMORY_BARRIER();                 /* Read write pointer only after flag */
+#if LWESP_CFG_IPD_ZERO_COPY
+    if (esp.buff.w != esp.buff_proc_r) {
+#else /* LWESP_CFG_IPD_ZERO_COPY */
+    if (lwesp_buff_get_full(&esp.buff) > 0) {
+#endif /* !LWESP_CFG_IPD_ZERO_COPY */
+        return 0;
+    }
+    lwespi_process_resync();
+    LWESP_CFG_MEMORY_BARRIER();
+    esp.input_overflow = 0;                     /* Input context may write again */
+    return 1;
+}
+
+#if LWESP_CFG_IPD_DIRECT || __DOXYGEN__
+
+/**
+ * \brief           Take over `+IPD` payload written directly to packet buffer by input context
+ * \return          `0` when input context still writes payload and there is nothing else to process, `1` otherwise
+ */
+static uint8_t
+process_ipd_direct(void) {
+    uint8_t state = esp.ipd_direct.state;
+
+    if (state == LWESP_IPD_DIRECT_ARMED || state == LWESP_IPD_DIRECT_ACTIVE) {
+        return 0;
+    } else if (state == LWESP_IPD_DIRECT_DONE || state == LWESP_IPD_DIRECT_REJECTED) {
+        LWESP_CFG_MEMORY_BARRIER();             /* Read payload only after state */
+        esp.ipd_direct.state = LWESP_IPD_DIRECT_IDLE;
+        if (esp.ipd_direct.pbuf != esp.m.ipd.buff) {/* Stack was reset in between */
+            lwesp_pbuf_free(esp.ipd_direct.pbuf);
+        } else if (state == LWESP_IPD_DIRECT_DONE) {
+            LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
+                       "[IPD] Bytes written directly: %d\r\n", (int)esp.ipd_direct.len);
+            esp.m.ipd.buff_ptr += esp.ipd_direct.len;
+            esp.m.ipd.rem_len -= esp.ipd_direct.len;
+            ipd_buff_done();                    /* Target always ends with packet buffer or payload */
+        }
+        esp.ipd_direct.pbuf = NULL;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Hand remaining space of current `+IPD` packet buffer over to input context
+ * \note            Called once all data of input buffer were processed
+ */
+static void
+process_ipd_direct_arm(void) {
+    size_t w;
+
+    if (!esp.m.ipd.read || esp.m.ipd.buff == NULL || esp.input_overflow
+        || esp.ipd_direct.state != LWESP_IPD_DIRECT_IDLE) {
+        return;
+    }
+    w = esp.buff.w;
+    LWESP_CFG_MEMORY_BARRIER();
+    if (w != esp.buff.r) {                      /* More data arrived meanwhile */
+        return;
+    }
+    esp.ipd_direct.pbuf = esp.m.ipd.buff;
+    esp.ipd_direct.dst = &esp.m.ipd.buff->payload[esp.m.ipd.buff_ptr];
+    esp.ipd_direct.len = LWESP_MIN(esp.m.ipd.buff->len - esp.m.ipd.buff_ptr, esp.m.ipd.rem_len);
+    esp.ipd_direct.filled = 0;
+    esp.ipd_direct.mark = w;
+    LWESP_CFG_MEMORY_BARRIER();                 /* Target must be visible before state */
+    esp.ipd_direct.state = LWESP_IPD_DIRECT_ARMED;
+}
+
+#endif /* LWESP_CFG_IPD_DIRECT || __DOXYGEN__ */
+
 /**
  * \brief           Process data from input buffer
  * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
  */
 lwespr_t
 lwespi_process_buffer(void) {
-    void* data;
     size_t len;
+#if LWESP_CFG_INPUT_PROCESS_BUDGET > 0
+    size_t budget_used = 0;
+#endif /* LWESP_CFG_INPUT_PROCESS_BUDGET > 0 */
 
+#if LWESP_CFG_IPD_ZERO_COPY
+    /*
+     * In zero-copy mode, processing pointer is used to read data.
+     * Buffer read pointer follows it only when no pbuf references buffer memory,
+     * otherwise memory is not released and writer cannot overwrite it
+     */
+    do {
+        size_t w = esp.buff.w, r = esp.buff_proc_r, i = LWESP_BUFF_INDEX(&esp.buff, r);
+
+        if (LWESP_BUFF_IS_POW2(&esp.buff)) {
+            len = LWESP_MIN(w - r, esp.buff.size - i);
+        } else {
+            len = w >= r ? (w - r) : (esp.buff.size - r);
+        }
+        LWESP_CFG_MEMORY_BARRIER();             /* Read data only after write pointer */
+#if LWESP_CFG_INPUT_PROCESS_SLICE > 0
+        len = LWESP_MIN(len, LWESP_CFG_INPUT_PROCESS_SLICE);
+#endif /* LWESP_CFG_INPUT_PROCESS_SLICE > 0 */
+        if (len > 0) {
+            process_from_buff = 1;
+            lwespi_process(&esp.buff.buff[i], len);
+            process_from_buff = 0;
+
+            r += len;
+            if (!LWESP_BUFF_IS_POW2(&esp.buff) && r >= esp.buff.size) {
+                r = 0;
+            }
+            esp.buff_proc_r = r;
+            if (esp.buff_ref_cnt == 0) {
+                LWESP_CFG_MEMORY_BARRIER();
+                esp.buff.r = r;                 /* Release processed memory */
+            }
+            LWESPI_PROCESS_YIELD();
+#if LWESP_CFG_INPUT_PROCESS_BUDGET > 0
+            process_budget_check(&budget_used, len);
+#endif /* LWESP_CFG_INPUT_PROCESS_BUDGET > 0 */
+        }
+    } while (len || !process_overflow_check());
+    return lwespOK;
+#else /* LWESP_CFG_IPD_ZERO_COPY */
+    void* data;
+
+#if LWESP_CFG_IPD_DIRECT
+    if (!process_ipd_direct()) {
+        return lwespOK;                         /* Payload is written directly to packet buffer */
+    }
+#endif /* LWESP_CFG_IPD_DIRECT */
     do {
         /*
          * Get length of linear memory in buffer
          * we can process directly as memory
          */
         len = lwesp_buff_get_linear_block_read_length(&esp.buff);
+#if LWESP_CFG_INPUT_PROCESS_SLICE > 0
+        len = LWESP_MIN(len, LWESP_CFG_INPUT_PROCESS_SLICE);
+#endif /* LWESP_CFG_INPUT_PROCESS_SLICE > 0 */
         if (len > 0) {
             /*
              * Get memory address of first element
@@ -1031,11 +2348,186 @@ lwespi_process_buffer(void) {
              * the buffer memory and start over
              */
             lwesp_buff_skip(&esp.buff, len);
+            LWESPI_PROCESS_YIELD();
+#if LWESP_CFG_INPUT_PROCESS_BUDGET > 0
+            process_budget_check(&budget_used, len);
+#endif /* LWESP_CFG_INPUT_PROCESS_BUDGET > 0 */
         }
-    } while (len);
+    } while (len || !process_overflow_check());
+#if LWESP_CFG_IPD_DIRECT
+    process_ipd_direct_arm();
+#endif /* LWESP_CFG_IPD_DIRECT */
     return lwespOK;
+#endif /* !LWESP_CFG_IPD_ZERO_COPY */
 }
-#endif /* !LWESP_CFG_INPUT_USE_PROCESS || __DOXYGEN__ */
+
+#if LWESP_CFG_IPD_ZERO_COPY || __DOXYGEN__
+
+/**
+ * \brief           Release input buffer memory held by zero-copy packet buffer
+ *
+ * Memory is released in bulk, when last referencing packet buffer is freed
+ *
+ * \note            This function must be called with core locked
+ */
+void
+lwespi_process_buffer_ref_release(void) {
+    if (esp.buff_ref_cnt > 0 && --esp.buff_ref_cnt == 0) {
+        LWESP_CFG_MEMORY_BARRIER();
+        esp.buff.r = esp.buff_proc_r;           /* Release all processed memory */
+    }
+}
+
+#endif /* LWESP_CFG_IPD_ZERO_COPY || __DOXYGEN__ */
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS || __DOXYGEN__ */
+
+/**
+ * \brief           Get length of plain ASCII run at the beginning of input data
+ *
+ * Plain run is a sequence of valid ASCII characters and complete UTF-8 sequences,
+ * that do not have any special meaning for command mode state machine and may be
+ * appended to receive buffer at once, without per-character processing.
+ *
+ * \param[in]       d: Pointer to data to scan
+ * \param[in]       len: Length of data to scan in units of bytes
+ * \return          Number of bytes in plain run, `0` if first byte needs full processing
+ */
+static size_t
+lwespi_get_plain_run_len(const uint8_t* d, size_t len) {
+    const uint8_t* s = d;
+    const uint8_t* e = d + len;
+
+    /*
+     * Stop on first character that may start or terminate
+     * any sequence, processed by state machine:
+     *
+     *  - '\n' terminates every line
+     *  - ':' terminates +IPD statement
+     *  - '>' is part of CIPSEND prompt
+     *  - ',' terminates +CIPRECVDATA statement
+     *  - Every non-printable character, invalid or incomplete UTF-8 sequence
+     */
+    while (s < e) {
+        uint8_t ch = *s;
+        if (ch < 32 || ch > 126) {
+            if (ch >= 0x80) {
+                size_t n = lwespi_unicode_get_run_len(s, (size_t)(e - s));
+                if (n == 0) {
+                    break;
+                }
+                s += n;
+                continue;
+            } else if (ch != '\r') {
+                break;
+            }
+        } else if (ch == ':' || ch == '>'
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+                   || ch == ','
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+                  ) {
+            break;
+        }
+        ++s;
+    }
+    return (size_t)(s - d);
+}
+
+#if LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__
+/**
+ * \brief           Forward raw data received in passthrough mode to connection
+ * \param[in]       d: Pointer to received data
+ * \param[in]       d_len: Length of data in units of bytes
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+lwespi_conn_passthrough_recv(const uint8_t* d, size_t d_len) {
+    lwesp_conn_p conn = &esp.m.conns[0];
+    lwesp_pbuf_p p;
+    size_t len;
+
+    while (d_len > 0) {
+        len = LWESP_MIN(d_len, LWESPI_PARAM(CONN_MAX_RECV_BUFF_SIZE));
+        if (conn->status.f.active && (p = lwesp_pbuf_new(len)) != NULL) {
+            lwesp_pbuf_take(p, d, len, 0);      /* Copy data to packet buffer */
+            conn->total_recved += len;
+            conn->status.f.data_received = 1;
+            LWESPI_STATS_CONN_ADD(conn, rx_bytes, len);
+            LWESPI_STATS_CONN_ADD(conn, rx_packets, 1);
+
+            esp.evt.type = LWESP_EVT_CONN_RECV;
+            esp.evt.evt.conn_data_recv.buff = p;
+            esp.evt.evt.conn_data_recv.conn = conn;
+            lwespi_send_conn_cb(conn, NULL);
+            lwesp_pbuf_free(p);                 /* Free packet buffer, user must reference it to keep it */
+        } else {
+            if (conn->status.f.active) {
+                LWESPI_STATS_CONN_ADD(conn, ipd_drops, 1);
+            }
+            LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING,
+                       "[PASSTHROUGH] Dropping %d bytes of data\r\n", (int)len);
+        }
+        d += len;
+        d_len -= len;
+    }
+    return lwespOK;
+}
+
+/**
+ * \brief           Activate first connection after successful start in passthrough mode
+ *
+ * Used when ESP device did not report `+LINK_CONN` in single connection mode
+ * \param[in]       msg: Connection start message
+ */
+static void
+lwespi_conn_passthrough_activate(lwesp_msg_t* msg) {
+    lwesp_conn_p conn = &esp.m.conns[0];
+    uint32_t id;
+
+    id = conn->val_id;
+    LWESP_MEMSET(conn, 0x00, sizeof(*conn));    /* Reset connection parameters */
+    conn->num = 0;
+    conn->val_id = LWESPI_CONN_GEN_NEXT(id);    /* Set new validation ID */
+    LWESPI_CONN_TX_QUEUE_INIT(conn);
+    LWESPI_CONN_MANUAL_RECV_INIT(conn);
+    LWESPI_CONN_WRITE_FLUSH_INIT(conn);
+    conn->type = msg->msg.conn_start.type;
+    conn->remote_port = msg->msg.conn_start.remote_port;
+    conn->status.f.active = 1;
+    conn->status.f.client = 1;
+    conn->evt_func = msg->msg.conn_start.evt_func;
+    conn->arg = msg->msg.conn_start.arg;
+    conn->poll_base = msg->msg.conn_start.poll_interval;
+    LWESPI_CONN_BIT_SET(esp.m.active_conns, 0);
+    msg->msg.conn_start.success = 1;
+
+    esp.evt.type = LWESP_EVT_CONN_ACTIVE;
+    esp.evt.evt.conn_active_close.conn = conn;
+    esp.evt.evt.conn_active_close.client = 1;
+    esp.evt.evt.conn_active_close.forced = 1;
+    lwespi_send_conn_cb(conn, NULL);
+    lwespi_conn_start_timeout(conn);
+}
+
+/**
+ * \brief           Notify user about closed connection after passthrough mode has been stopped
+ */
+static void
+lwespi_conn_passthrough_closed(void) {
+    lwesp_conn_p conn = &esp.m.conns[0];
+
+    if (conn->status.f.active) {
+        conn->status.f.active = 0;
+        LWESPI_CONN_BIT_CLR(esp.m.active_conns, 0);
+
+        esp.evt.type = LWESP_EVT_CONN_CLOSE;
+        esp.evt.evt.conn_active_close.conn = conn;
+        esp.evt.evt.conn_active_close.client = conn->status.f.client;
+        esp.evt.evt.conn_active_close.forced = 1;
+        esp.evt.evt.conn_active_close.res = lwespOK;
+        lwespi_send_conn_cb(conn, NULL);
+    }
+}
+#endif /* LWESP_CFG_CONN_PASSTHROUGH || __DOXYGEN__ */
 
 /**
  * \brief           Process input data received from ESP device
@@ -1051,12 +2543,70 @@ lwespi_process(const void* data, size_t data_len) {
     static uint8_t ch_prev1, ch_prev2;
     static lwesp_unicode_t unicode;
 
+    LWESPI_CAPTURE_RX(data, data_len);          /* Record data as received from device */
+    LWESPI_TRACE(PROCESS, data_len, 0);
+
     /* Check status if device is available */
     if (!esp.status.f.dev_present) {
         return lwespERRNODEVICE;
     }
+    if (esp.msg != NULL && data_len > 0) {
+        LWESPI_STATS_CMD_RESP(esp.msg);
+    }
+
+#if LWESP_CFG_CONN_PASSTHROUGH
+    if (esp.m.passthrough) {                    /* In passthrough mode, all data belong to connection */
+        return lwespi_conn_passthrough_recv(d, d_len);
+    }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
 
     while (d_len > 0) {                         /* Read entire set of characters from buffer */
+#if !LWESP_CFG_INPUT_USE_PROCESS
+        if (process_resync) {                   /* Data were lost, skip to the beginning of next line */
+            const uint8_t* lf = memchr(d, '\n', d_len);
+
+            if (lf == NULL) {
+                break;
+            }
+            ++lf;
+            d_len -= (size_t)(lf - d);
+            d = lf;
+            process_resync = 0;
+            unicode.r = 0;
+            ch_prev1 = ch_prev2 = '\n';
+            RECV_RESET();
+            continue;
+        }
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+
+        /*
+         * Fast path for command mode
+         *
+         * Find run of plain ASCII characters and copy them to receive buffer at once.
+         * Only characters with special meaning are processed by state machine below
+         */
+        if (!esp.m.ipd.read && unicode.r == 0) {
+            size_t len = lwespi_get_plain_run_len(d, d_len);
+            if (len > 0) {
+                size_t to_copy = LWESP_MIN(len, sizeof(recv_buff.data) - 1 - recv_buff.len);
+
+                LWESP_MEMCPY(&recv_buff.data[recv_buff.len], d, to_copy);
+                recv_buff.len += to_copy;
+                recv_buff.data[recv_buff.len] = 0;
+                if (to_copy < len) {
+                    recv_buff.truncated = 1;
+                }
+
+                /* Keep history for CIPSEND prompt detection */
+                ch_prev2 = len > 1 ? d[len - 2] : ch_prev1;
+                ch_prev1 = d[len - 1];
+                unicode.t = 1;
+                d += len;
+                d_len -= len;
+                continue;
+            }
+        }
+
         ch = *d;                                /* Get next character */
         ++d;                                    /* Go to next character, must be here as it is used later on */
         --d_len;                                /* Decrease remaining length, must be here as it is decreased later too */
@@ -1068,7 +2618,11 @@ lwespi_process(const void* data, size_t data_len) {
         if (esp.m.ipd.read) {                   /* Do we have to read incoming IPD data? */
             size_t len;
 
-            if (esp.m.ipd.buff != NULL) {       /* Do we have active buffer? */
+            if (esp.m.ipd.buff != NULL          /* Do we have active buffer? */
+#if LWESP_CFG_IPD_ZERO_COPY
+                && !esp.m.ipd.zero_copy         /* Data already in place for zero-copy */
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
+               ) {
                 esp.m.ipd.buff->payload[esp.m.ipd.buff_ptr] = ch;   /* Save data character */
             }
             ++esp.m.ipd.buff_ptr;
@@ -1079,6 +2633,12 @@ lwespi_process(const void* data, size_t data_len) {
             LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
                        "[IPD] New length to read: %d bytes\r\n", (int)len);
             if (len > 0) {
+#if LWESP_CFG_IPD_ZERO_COPY
+                if (esp.m.ipd.buff != NULL && esp.m.ipd.zero_copy) {
+                    LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
+                               "[IPD] Bytes referenced: %d\r\n", (int)len);
+                } else
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
                 if (esp.m.ipd.buff != NULL) {   /* Is buffer valid? */
                     LWESP_MEMCPY(&esp.m.ipd.buff->payload[esp.m.ipd.buff_ptr], d, len);
                     LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
@@ -1095,71 +2655,7 @@ lwespi_process(const void* data, size_t data_len) {
 
             /* Did we reach end of buffer or no more data? */
             if (esp.m.ipd.rem_len == 0 || (esp.m.ipd.buff != NULL && esp.m.ipd.buff_ptr == esp.m.ipd.buff->len)) {
-                lwespr_t res = lwespOK;
-
-                /* Call user callback function with received data */
-                if (esp.m.ipd.buff != NULL) {   /* Do we have valid buffer? */
-#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
-                    size_t pbuf_len;
-
-                    pbuf_len = lwesp_pbuf_length(esp.m.ipd.buff, 1);
-                    esp.m.ipd.conn->tcp_not_ack_bytes += pbuf_len;
-                    if (esp.m.ipd.conn->tcp_available_bytes >= pbuf_len) {
-                        esp.m.ipd.conn->tcp_available_bytes -= pbuf_len;
-                    }
-#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
-
-                    esp.m.ipd.conn->total_recved += esp.m.ipd.buff->tot_len;/* Increase number of bytes received */
-
-                    /*
-                     * Send data buffer to upper layer
-                     *
-                     * From this moment, user is responsible for packet
-                     * buffer and must free it manually
-                     */
-                    esp.evt.type = LWESP_EVT_CONN_RECV;
-                    esp.evt.evt.conn_data_recv.buff = esp.m.ipd.buff;
-                    esp.evt.evt.conn_data_recv.conn = esp.m.ipd.conn;
-                    res = lwespi_send_conn_cb(esp.m.ipd.conn, NULL);
-
-                    lwesp_pbuf_free(esp.m.ipd.buff);/* Free packet buffer at this point */
-                    LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
-                               "[IPD] Free packet buffer\r\n");
-                    if (res == lwespOKIGNOREMORE) { /* We should ignore more data */
-                        LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
-                                   "[IPD] Ignoring more data from this IPD if available\r\n");
-                        esp.m.ipd.buff = NULL;  /* Set to NULL to ignore more data if possibly available */
-                    }
-
-                    /*
-                     * Create new data packet if case if:
-                     *
-                     *  - Previous one was successful and more data to read and
-                     *  - Connection is not in closing state
-                     */
-                    if (esp.m.ipd.buff != NULL && esp.m.ipd.rem_len > 0 && !esp.m.ipd.conn->status.f.in_closing) {
-                        size_t new_len = LWESP_MIN(esp.m.ipd.rem_len, LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE);   /* Calculate new buffer length */
-
-                        LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
-                                   "[IPD] Allocating new packet buffer of size: %d bytes\r\n", (int)new_len);
-                        esp.m.ipd.buff = lwesp_pbuf_new(new_len);   /* Allocate new packet buffer */
-
-                        LWESP_DEBUGW(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING,
-                                   esp.m.ipd.buff == NULL, "[IPD] Buffer allocation failed for %d bytes\r\n", (int)new_len);
-
-                        if (esp.m.ipd.buff != NULL) {
-                            lwesp_pbuf_set_ip(esp.m.ipd.buff, &esp.m.ipd.ip, esp.m.ipd.port);   /* Set IP and port for received data */
-                        }
-                    } else {
-                        esp.m.ipd.buff = NULL;  /* Reset it */
-                    }
-                }
-                if (esp.m.ipd.rem_len == 0) {   /* Check if we read everything */
-                    esp.m.ipd.buff = NULL;      /* Reset buffer pointer */
-                    esp.m.ipd.read = 0;         /* Stop reading data */
-                }
-                esp.m.ipd.buff_ptr = 0;         /* Reset input buffer pointer */
-                RECV_RESET();                   /* Reset receive data */
+                ipd_buff_done();
             }
 
             /*
@@ -1187,6 +2683,9 @@ lwespi_process(const void* data, size_t data_len) {
                     switch (ch) {
                         case '\n':
                             RECV_ADD(ch);       /* Add character to input buffer */
+                            if (recv_buff.truncated) {
+                                lwespi_recv_line_truncated();
+                            }
                             lwespi_parse_received(&recv_buff);  /* Parse received string */
                             RECV_RESET();       /* Reset received string */
                             break;
@@ -1201,10 +2700,23 @@ lwespi_process(const void* data, size_t data_len) {
                             RECV_RESET();       /* Reset received object */
 
                             /* Now actually send the data prepared before */
-                            AT_PORT_SEND_WITH_FLUSH(&esp.msg->msg.conn_send.data[esp.msg->msg.conn_send.ptr], esp.msg->msg.conn_send.sent);
+                            lwespi_tcpip_send_data_chunk();
                             esp.msg->msg.conn_send.wait_send_ok_err = 1;/* Now we are waiting for "SEND OK" or "SEND ERROR" */
                         }
                     }
+#if LWESP_CFG_CONN_PASSTHROUGH
+                    if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSEND_PASSTHROUGH)) {
+                        if (ch_prev2 == '\r' && ch_prev1 == '\n' && ch == '>') {
+                            RECV_RESET();       /* Reset received object */
+
+                            /* From now on, everything is raw connection data */
+                            esp.m.passthrough = 1;
+                            esp.msg->res = lwespOK;
+                            LWESPI_CMD_SYNC_RELEASE();
+                            return lwespi_conn_passthrough_recv(d, d_len);
+                        }
+                    }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
 
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
                     /*
@@ -1230,6 +2742,7 @@ lwespi_process(const void* data, size_t data_len) {
                             esp.m.ipd.buff = esp.msg->msg.ciprecvdata.buff;
                             esp.m.ipd.conn = esp.msg->msg.ciprecvdata.conn;
                             lwesp_pbuf_set_length(esp.m.ipd.buff, esp.m.ipd.tot_len);   /* Set new length of buffer */
+                            LWESPI_TRACE(IPD_START, esp.m.ipd.conn->num, esp.m.ipd.tot_len);
                             esp.msg->msg.ciprecvdata.buff = NULL;   /* Clear reference for this pbuf */
                         } else {
                             /* ERROR handling */
@@ -1248,27 +2761,47 @@ lwespi_process(const void* data, size_t data_len) {
                                 LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
                                            "[IPD] Data on connection %d with total size %d byte(s)\r\n",
                                            (int)esp.m.ipd.conn->num, (int)esp.m.ipd.tot_len);
+                                LWESPI_TRACE(IPD_START, esp.m.ipd.conn->num, esp.m.ipd.tot_len);
 
-                                len = LWESP_MIN(esp.m.ipd.rem_len, LWESP_CFG_CONN_MAX_RECV_BUFF_SIZE);
+                                len = LWESP_MIN(ipd_accept_rem(), LWESPI_PARAM(CONN_MAX_RECV_BUFF_SIZE));
 
                                 /*
                                  * Read received data in case of:
                                  *
                                  *  - Connection is active and
-                                 *  - Connection is not in closing mode
+                                 *  - Connection is not in closing mode and
+                                 *  - Data were not dropped by connection filter
                                  */
-                                if (esp.m.ipd.conn->status.f.active && !esp.m.ipd.conn->status.f.in_closing) {
+                                if (esp.m.ipd.conn->status.f.active && !esp.m.ipd.conn->status.f.in_closing && len > 0) {
+#if LWESP_CFG_IPD_ZERO_COPY
+                                    /*
+                                     * Reference input buffer memory directly,
+                                     * if complete payload is available in linear block
+                                     */
+                                    esp.m.ipd.zero_copy = process_from_buff && esp.m.ipd.rem_len <= d_len
+                                                          && ipd_accept_rem() == esp.m.ipd.rem_len;
+                                    if (esp.m.ipd.zero_copy) {
+                                        len = esp.m.ipd.rem_len;
+                                        esp.m.ipd.buff = lwespi_pbuf_new_ref((void*)d, len);
+                                        esp.m.ipd.zero_copy = esp.m.ipd.buff != NULL;
+                                    } else
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
                                     esp.m.ipd.buff = lwesp_pbuf_new(len);   /* Allocate new packet buffer */
                                     if (esp.m.ipd.buff != NULL) {
                                         lwesp_pbuf_set_ip(esp.m.ipd.buff, &esp.m.ipd.ip, esp.m.ipd.port);   /* Set IP and port for received data */
+                                    } else {
+                                        LWESPI_STATS_CONN_ADD(esp.m.ipd.conn, ipd_drops, 1);
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+                                        lwespi_conn_manual_tcp_auto_enter();    /* Let device buffer further data */
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
                                     }
                                     LWESP_DEBUGW(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_WARNING, esp.m.ipd.buff == NULL,
                                                "[IPD] Buffer allocation failed for %d byte(s)\r\n", (int)len);
                                 } else {
                                     esp.m.ipd.buff = NULL;  /* Ignore reading on closed connection */
                                     LWESP_DEBUGF(LWESP_CFG_DBG_IPD | LWESP_DBG_TYPE_TRACE,
-                                               "[IPD] Connection %d closed or in closing, skipping %d byte(s)\r\n",
-                                               (int)esp.m.ipd.conn->num, (int)len);
+                                               "[IPD] Connection %d closed, in closing or filtered, skipping %d byte(s)\r\n",
+                                               (int)esp.m.ipd.conn->num, (int)esp.m.ipd.rem_len);
                                 }
                                 esp.m.ipd.conn->status.f.data_received = 1; /* We have first received data */
                                 esp.m.ipd.buff_ptr = 0; /* Reset buffer write pointer */
@@ -1316,6 +2849,156 @@ lwespi_process(const void* data, size_t data_len) {
         }                                           \
     } while (0)
 
+#if LWESP_CFG_WARM_INIT || __DOXYGEN__
+
+static lwesp_warm_state_t warm_state;           /*!< Cached device state loaded at warm init */
+
+/**
+ * \brief           Calculate fingerprint of current device firmware and library configuration
+ * \return          Fingerprint value, never `0`
+ */
+static uint32_t
+lwespi_warm_state_fingerprint(void) {
+    uint32_t hash = 0x811C9DC5UL;               /* FNV-1a hash */
+    const uint32_t vals[] = {
+        esp.m.version_at.major, esp.m.version_at.minor, esp.m.version_at.patch,
+        esp.m.version_sdk.major, esp.m.version_sdk.minor, esp.m.version_sdk.patch,
+        (uint32_t)esp.m.device, esp.ll.uart.baudrate, LWESP_CFG_AT_PORT_FLOW_CONTROL,
+        LWESP_CFG_AT_ECHO, LWESP_CFG_MODE_STATION, LWESP_CFG_MODE_ACCESS_POINT,
+        LWESP_CFG_CONN_MANUAL_TCP_RECEIVE,
+    };
+
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(vals); ++i) {
+        for (size_t b = 0; b < 4; ++b) {
+            hash = (hash ^ ((vals[i] >> (8 * b)) & 0xFF)) * 0x01000193UL;
+        }
+    }
+    return hash != 0 ? hash : 1;
+}
+
+/**
+ * \brief           Load cached device state and apply it before warm init
+ * \return          `1` if valid state was loaded, `0` otherwise
+ */
+static uint8_t
+lwespi_warm_state_load(void) {
+    LWESP_MEMSET(&warm_state, 0x00, sizeof(warm_state));
+    if (esp.ll.warm_state_fn == NULL
+        || !esp.ll.warm_state_fn(&warm_state, 0)
+        || warm_state.fingerprint == 0) {
+        return 0;
+    }
+    esp.m.device = warm_state.device;           /* Device detection runs before GMR, restore it */
+#if LWESP_CFG_AT_PORT_FLOW_CONTROL
+    esp.ll.uart.flow_control = LWESP_CFG_AT_PORT_FLOW_CONTROL;
+    lwesp_ll_init(&esp.ll);                     /* Device keeps flow control enabled, match it */
+#endif /* LWESP_CFG_AT_PORT_FLOW_CONTROL */
+    return 1;
+}
+
+/**
+ * \brief           Store current device state after full reset sequence
+ * \param[in]       valid: Set to `1` to store current state, `0` to invalidate cached state
+ */
+static void
+lwespi_warm_state_save(uint8_t valid) {
+    if (esp.ll.warm_state_fn != NULL) {
+        LWESP_MEMSET(&warm_state, 0x00, sizeof(warm_state));
+        if (valid) {
+            warm_state.fingerprint = lwespi_warm_state_fingerprint();
+            warm_state.device = esp.m.device;
+            warm_state.link_conn_urc = esp.m.link_conn_urc;
+        }
+        esp.ll.warm_state_fn(&warm_state, 1);
+    }
+}
+
+/* Configuration found on device as set by reset sequence */
+#define LWESPI_WARM_MATCH_CWMODE            0x01
+#define LWESPI_WARM_MATCH_CIPMUX            0x02
+#define LWESPI_WARM_MATCH_CIPDINFO          0x04
+#define LWESPI_WARM_MATCH_CIPRECVMODE       0x08
+
+/**
+ * \brief           Parse configuration queried from device on warm init
+ *
+ * Values matching reset sequence configuration are marked in warm match mask,
+ * only configuration commands with different value are sent to device afterwards
+ *
+ * \param[in]       str: Received line, starting with `+` character
+ */
+static void
+lwespi_warm_state_parse(const char* str) {
+    lwesp_msg_t* msg = esp.msg;
+    const char* tmp;
+
+    if (CMD_IS_CUR(LWESP_CMD_WIFI_CWMODE_GET) && !strncmp(str, "+CWMODE:", 8)) {
+        tmp = &str[8];
+        if (lwespi_parse_number(&tmp) == (int32_t)lwespi_reset_wifi_mode()) {
+            msg->msg.reset.warm_match |= LWESPI_WARM_MATCH_CWMODE;
+        }
+    } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPMUX_GET) && !strncmp(str, "+CIPMUX:", 8)) {
+        tmp = &str[8];
+        if (lwespi_parse_number(&tmp) == 1) {
+            msg->msg.reset.warm_match |= LWESPI_WARM_MATCH_CIPMUX;
+        }
+    } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPDINFO_GET) && !strncmp(str, "+CIPDINFO:", 10)) {
+        /* Enabled state is reported as "1" or "true", depending on firmware */
+        if (str[10] == '1' || str[10] == 't' || str[10] == 'T') {
+            msg->msg.reset.warm_match |= LWESPI_WARM_MATCH_CIPDINFO;
+        }
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE && !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+    } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPRECVMODE_GET) && !strncmp(str, "+CIPRECVMODE:", 13)) {
+        tmp = &str[13];
+        if (lwespi_parse_number(&tmp) == 1) {
+            msg->msg.reset.warm_match |= LWESPI_WARM_MATCH_CIPRECVMODE;
+        }
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE && !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
+    }
+}
+
+/**
+ * \brief           Check if configuration command can be skipped on warm init
+ *
+ * Command is skipped only when live value queried from device matches the one it sets.
+ * `AT+CWLAPOPT` has no query command, it is skipped as device kept
+ * volatile `AT+CIPMUX` setting and was therefore not restarted since last full reset
+ *
+ * \param[in]       msg: Reset message
+ * \param[in]       cmd: Command to check
+ * \return          `1` if command can be skipped, `0` otherwise
+ */
+static uint8_t
+lwespi_warm_state_is_configured(lwesp_msg_t* msg, lwesp_cmd_t cmd) {
+    uint8_t match;
+
+    switch (cmd) {
+        case LWESP_CMD_WIFI_CWMODE:
+            match = LWESPI_WARM_MATCH_CWMODE;
+            break;
+        case LWESP_CMD_TCPIP_CIPMUX:
+            match = LWESPI_WARM_MATCH_CIPMUX;
+            break;
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE && !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+        case LWESP_CMD_TCPIP_CIPRECVMODE:       /* Mode may change at runtime with automatic fallback */
+            match = LWESPI_WARM_MATCH_CIPRECVMODE;
+            break;
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE && !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
+#if LWESP_CFG_MODE_STATION
+        case LWESP_CMD_WIFI_CWLAPOPT:
+            return 1;
+#endif /* LWESP_CFG_MODE_STATION */
+        case LWESP_CMD_TCPIP_CIPDINFO:
+            match = LWESPI_WARM_MATCH_CIPDINFO;
+            break;
+        default:
+            return 0;
+    }
+    return (msg->msg.reset.warm_match & match) == match;
+}
+
+#endif /* LWESP_CFG_WARM_INIT || __DOXYGEN__ */
+
 /**
  * \brief           Get next sub command for reset or restore sequence
  * \param[in]       msg: Pointer to current message
@@ -1334,9 +3017,15 @@ lwespi_get_reset_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, ui
             break;
         case LWESP_CMD_ATE0:
         case LWESP_CMD_ATE1:
+#if LWESP_CFG_AT_PORT_FLOW_CONTROL
+            SET_NEW_CMD(LWESP_CMD_UART);        /* Enable flow control on both sides */
+            break;
+        case LWESP_CMD_UART:
+#endif /* LWESP_CFG_AT_PORT_FLOW_CONTROL */
             SET_NEW_CMD(LWESP_CMD_SYSMSG);
             break;
         case LWESP_CMD_SYSMSG:
+            esp.m.link_conn_urc = *is_ok;       /* Connection changes are reported with +LINK_CONN */
             SET_NEW_CMD(LWESP_CMD_SYSLOG);
             break;
         case LWESP_CMD_SYSLOG:
@@ -1353,8 +3042,48 @@ lwespi_get_reset_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, ui
             SET_NEW_CMD(LWESP_CMD_GMR);
             break;
         case LWESP_CMD_GMR:
+#if LWESP_CFG_WARM_INIT
+            if (CMD_IS_DEF(LWESP_CMD_RESET) && msg->msg.reset.warm == 1) {
+                if (*is_ok && lwespi_warm_state_fingerprint() == warm_state.fingerprint) {
+                    msg->msg.reset.warm_match = 0;
+                    SET_NEW_CMD(LWESP_CMD_TCPIP_CIPMUX_GET);
+                } else {
+                    msg->msg.reset.warm = 0;    /* Unknown state, start over with full reset */
+                    SET_NEW_CMD(LWESP_CMD_RESET);
+                }
+                break;                          /* Verify live configuration of device */
+            }
+#endif /* LWESP_CFG_WARM_INIT */
+            SET_NEW_CMD(LWESP_CMD_WIFI_CWMODE);
+            break;
+#if LWESP_CFG_WARM_INIT
+        case LWESP_CMD_TCPIP_CIPMUX_GET:
+            /*
+             * Multiple connections mode is not kept over device restart.
+             * When lost, device was power cycled or reset meanwhile
+             * and none of cached state can be trusted
+             */
+            if (!(msg->msg.reset.warm_match & LWESPI_WARM_MATCH_CIPMUX)) {
+                msg->msg.reset.warm = 0;        /* Start over with full reset */
+                SET_NEW_CMD(LWESP_CMD_RESET);
+                break;
+            }
+            SET_NEW_CMD(LWESP_CMD_TCPIP_CIPDINFO_GET);
+            break;
+        case LWESP_CMD_TCPIP_CIPDINFO_GET:
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE && !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+            SET_NEW_CMD(LWESP_CMD_TCPIP_CIPRECVMODE_GET);
+            break;
+        case LWESP_CMD_TCPIP_CIPRECVMODE_GET:
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE && !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
+            SET_NEW_CMD(LWESP_CMD_WIFI_CWMODE_GET);
+            break;
+        case LWESP_CMD_WIFI_CWMODE_GET:
+            msg->msg.reset.warm = 2;            /* Device kept its state, send only differing configuration */
+            esp.m.link_conn_urc = warm_state.link_conn_urc;
             SET_NEW_CMD(LWESP_CMD_WIFI_CWMODE);
             break;
+#endif /* LWESP_CFG_WARM_INIT */
         case LWESP_CMD_WIFI_CWMODE:
             SET_NEW_CMD(LWESP_CMD_WIFI_CWDHCP_GET);
             break;
@@ -1366,6 +3095,9 @@ lwespi_get_reset_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, ui
             SET_NEW_CMD(LWESP_CMD_TCPIP_CIPRECVMODE);
             break;
         case LWESP_CMD_TCPIP_CIPRECVMODE:
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+            esp.m.tcp_recv_manual = 0;          /* Device starts in automatic mode */
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
 #if LWESP_CFG_MODE_STATION
             SET_NEW_CMD(LWESP_CMD_WIFI_CWLAPOPT);
@@ -1373,7 +3105,32 @@ lwespi_get_reset_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, ui
         case LWESP_CMD_WIFI_CWLAPOPT:
             SET_NEW_CMD(LWESP_CMD_TCPIP_CIPSTATUS);
             break;                              /* Get connection status */
+#if LWESP_CFG_WARM_INIT
+        case LWESP_CMD_WIFI_CWJAP_GET:
+            if (esp.m.sta.is_connected) {
+                lwespi_send_cb(LWESP_EVT_WIFI_CONNECTED);
+            }
+            SET_NEW_CMD(LWESP_CMD_WIFI_CIPSTA_GET);
+            break;                              /* Get station IP */
+        case LWESP_CMD_WIFI_CIPSTA_GET:
+            if (esp.m.sta.is_connected && esp.m.sta.ip.ip[0] != 0) {
+                esp.m.sta.has_ip = 1;
+                lwespi_send_cb(LWESP_EVT_WIFI_IP_ACQUIRED);
+            }
+#if LWESP_CFG_MODE_ACCESS_POINT
+            SET_NEW_CMD(LWESP_CMD_WIFI_CIPAP_GET);
+#else /* LWESP_CFG_MODE_ACCESS_POINT */
+            SET_NEW_CMD(LWESP_CMD_TCPIP_CIPDINFO);
+#endif /* !LWESP_CFG_MODE_ACCESS_POINT */
+            break;                              /* Continue with access point part */
+#endif /* LWESP_CFG_WARM_INIT */
         case LWESP_CMD_TCPIP_CIPSTATUS:
+#if LWESP_CFG_WARM_INIT
+            if (CMD_IS_DEF(LWESP_CMD_RESET) && msg->msg.reset.warm == 2) {
+                SET_NEW_CMD(LWESP_CMD_WIFI_CWJAP_GET);
+                break;                          /* Read station state kept by device */
+            }
+#endif /* LWESP_CFG_WARM_INIT */
 #endif /* LWESP_CFG_MODE_STATION */
 #if LWESP_CFG_MODE_ACCESS_POINT
             SET_NEW_CMD(LWESP_CMD_WIFI_CIPAP_GET);
@@ -1395,40 +3152,456 @@ lwespi_get_reset_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, ui
     return n_cmd;
 }
 
+/* Candidate baudrates for automatic negotiation, highest first */
+static const uint32_t autobaud_rates[] = { LWESP_CFG_AT_PORT_AUTOBAUD_RATES };
+
 /**
- * \brief           Process current command with known execution status and start another if necessary
- * \param[in]       msg: Pointer to current message
- * \param[in]       is_ok: Status whether last command result was OK
- * \param[in]       is_error: Status whether last command result was ERROR
- * \param[in]       is_ready: Status whether last command result was ready
- * \return          lwespCONT if you sent more data and we need to process more data, or lwespOK on success, or lwespERR on error
+ * \brief           Select next candidate baudrate for automatic negotiation
+ *
+ * Candidate must be higher than last verified baudrate and supported by host
+ *
+ * \param[in]       msg: Autobaud message
+ * \return          `1` if candidate is available and written to `msg->msg.uart.baudrate`, `0` otherwise
  */
-static lwespr_t
-lwespi_process_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, uint8_t* is_ready) {
-    lwesp_cmd_t n_cmd = LWESP_CMD_IDLE;
-    if (CMD_IS_DEF(LWESP_CMD_RESET)) {          /* Device is in reset mode */
-        n_cmd = lwespi_get_reset_sub_cmd(msg, is_ok, is_error, is_ready);
-        if (n_cmd == LWESP_CMD_IDLE) {          /* Last command? */
-            RESET_SEND_EVT(msg, *is_ok ? lwespOK : lwespERR);
+static uint8_t
+lwespi_uart_autobaud_next(lwesp_msg_t* msg) {
+    while (msg->msg.uart.idx < LWESP_ARRAYSIZE(autobaud_rates)) {
+        uint32_t rate = autobaud_rates[msg->msg.uart.idx++];
+
+        if (rate > msg->msg.uart.baudrate_prev
+            && (esp.ll.uart.max_baudrate == 0 || rate <= esp.ll.uart.max_baudrate)) {
+            msg->msg.uart.baudrate = rate;
+            return 1;
         }
-    } else if (CMD_IS_DEF(LWESP_CMD_RESTORE)) {
-        if ((CMD_IS_CUR(LWESP_CMD_RESET)) && *is_ready) {
-            SET_NEW_CMD(LWESP_CMD_RESTORE);
-        } else if ((CMD_IS_CUR(LWESP_CMD_RESTORE) && *is_ready)
-                   || !CMD_IS_CUR(LWESP_CMD_RESTORE)) {
-            SET_NEW_CMD(lwespi_get_reset_sub_cmd(msg, is_ok, is_error, is_ready));
+    }
+    return 0;
+}
+
+/**
+ * \brief           Return AT port to last verified baudrate after failed verification
+ *
+ * Device response cannot be trusted at unstable baudrate,
+ * command response is ignored and host switches back
+ * from \ref lwespi_uart_autobaud_switch timeout callback
+ *
+ * \param[in]       msg: Autobaud message
+ * \return          Next command to execute
+ */
+static lwesp_cmd_t
+lwespi_uart_autobaud_fallback(lwesp_msg_t* msg) {
+    msg->msg.uart.baudrate = msg->msg.uart.baudrate_prev;
+    msg->msg.uart.fallback = 1;
+    return LWESP_CMD_UART;
+}
+
+/**
+ * \brief           Timeout callback to switch host to last verified baudrate,
+ *                  once device had time to process fallback command
+ * \param[in]       arg: Autobaud message
+ */
+static void
+lwespi_uart_autobaud_switch(void* arg) {
+    lwesp_msg_t* msg = arg;
+
+    if (esp.msg != msg || !CMD_IS_DEF(LWESP_CMD_UART_AUTOBAUD) || !CMD_IS_CUR(LWESP_CMD_UART) || !msg->msg.uart.fallback) {
+        return;
+    }
+    msg->msg.uart.verify_id = 0;
+    msg->msg.uart.fallback = 0;
+    esp.ll.uart.baudrate = msg->msg.uart.baudrate_prev;
+    lwesp_ll_init(&esp.ll);                     /* Set previous baudrate */
+
+    if (lwespi_uart_autobaud_next(msg)) {       /* Try next lower candidate */
+        msg->cmd = LWESP_CMD_UART;
+    } else {
+        msg->msg.uart.final = 1;                /* Verify previous baudrate and finish */
+        msg->cmd = LWESP_CMD_AT;
+    }
+    if (msg->fn(msg) != lwespOK) {
+        msg->cmd = LWESP_CMD_IDLE;
+        msg->res = lwespERR;
+        LWESPI_CMD_SYNC_RELEASE();
+    }
+}
+
+/**
+ * \brief           Timeout callback for autobaud verification, when device does not respond
+ * \param[in]       arg: Autobaud message
+ */
+static void
+lwespi_uart_autobaud_timeout(void* arg) {
+    lwesp_msg_t* msg = arg;
+
+    if (esp.msg != msg || !CMD_IS_DEF(LWESP_CMD_UART_AUTOBAUD) || !CMD_IS_CUR(LWESP_CMD_AT)) {
+        return;
+    }
+    msg->msg.uart.verify_id = 0;
+    if (!msg->msg.uart.final) {
+        msg->cmd = lwespi_uart_autobaud_fallback(msg);
+        if (msg->fn(msg) == lwespOK) {
+            return;
         }
-        if (n_cmd == LWESP_CMD_IDLE) {
-            RESTORE_SEND_EVT(msg, *is_ok ? lwespOK : lwespERR);
+    }
+    msg->cmd = LWESP_CMD_IDLE;                  /* Link is not working, finish with error */
+    msg->res = lwespTIMEOUT;
+    LWESPI_CMD_SYNC_RELEASE();
+}
+
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE || __DOXYGEN__
+/**
+ * \brief           Prepare next `AT+CIPRECVDATA` read in batched manual receive message
+ *
+ * Connections are served in order, each at most for number of bytes reported
+ * by last `+CIPRECVLEN` poll, in chunks limited by application receive window
+ *
+ * \param[in]       msg: Manual receive message
+ * \return          `1` when read is prepared, `0` when there is nothing more to read
+ */
+static uint8_t
+lwespi_conn_manual_tcp_read_next(lwesp_msg_t* msg) {
+    for (; msg->msg.ciprecvdata.idx < LWESP_CFG_MAX_CONNS; ++msg->msg.ciprecvdata.idx) {
+        lwesp_conn_p c = &esp.m.conns[msg->msg.ciprecvdata.idx];
+        lwesp_pbuf_p p = NULL;
+        size_t len;
+
+        if (msg->msg.ciprecvdata.rem == SIZE_MAX) { /* First visit of connection */
+            msg->msg.ciprecvdata.rem = c->tcp_available_bytes;
         }
-#if LWESP_CFG_MODE_STATION
-    } else if (CMD_IS_DEF(LWESP_CMD_WIFI_CWJAP)) {  /* Is our intention to join to access point? */
-        if (CMD_IS_CUR(LWESP_CMD_WIFI_CWJAP)) { /* Is the current command join? */
-            if (*is_ok) {                       /* Did we join successfully? */
-                SET_NEW_CMD(LWESP_CMD_WIFI_CWDHCP_GET); /* Check IP address status */
-            } else {
-                esp.m.sta.is_connected = 0;     /* Force disconnected status */
-                /*
+        len = LWESP_MIN(msg->msg.ciprecvdata.rem, lwespi_conn_manual_tcp_read_len(c));
+        if (len == 0) {
+            msg->msg.ciprecvdata.rem = SIZE_MAX;/* Continue with next connection */
+            continue;
+        }
+
+        /* Try to allocate packet buffer, use half of length on failure */
+        while ((p = lwesp_pbuf_new(len)) == NULL) {
+            len /= 2;
+            if (len < 10) {                     /* Stop when not even small buffer is available */
+                return 0;
+            }
+        }
+        msg->msg.ciprecvdata.conn = c;
+        msg->msg.ciprecvdata.buff = p;
+        msg->msg.ciprecvdata.len = len;
+        msg->msg.ciprecvdata.rem -= len;
+        return 1;
+    }
+    return 0;
+}
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE || __DOXYGEN__ */
+
+#if LWESP_CFG_IP_MAC_CACHE || __DOXYGEN__
+
+/**
+ * \brief           Mark cached setting as valid after successful read from device
+ * \param[in]       cmd: Finished command
+ */
+static void
+ip_mac_cache_validate(lwesp_cmd_t cmd) {
+    switch (cmd) {
+#if LWESP_CFG_MODE_STATION
+        case LWESP_CMD_WIFI_CIPSTA_GET:
+            esp.m.sta.ip_valid = 1;
+            break;
+        case LWESP_CMD_WIFI_CIPSTAMAC_GET:
+            esp.m.sta.mac_valid = 1;
+            break;
+#endif /* LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_MODE_ACCESS_POINT
+        case LWESP_CMD_WIFI_CIPAP_GET:
+            esp.m.ap.ip_valid = 1;
+            break;
+        case LWESP_CMD_WIFI_CIPAPMAC_GET:
+            esp.m.ap.mac_valid = 1;
+            break;
+#endif /* LWESP_CFG_MODE_ACCESS_POINT */
+        default:
+            break;
+    }
+}
+
+/**
+ * \brief           Invalidate cached settings modified by command
+ * \param[in]       cmd: Command to be sent to device
+ */
+static void
+ip_mac_cache_invalidate(lwesp_cmd_t cmd) {
+    switch (cmd) {
+        case LWESP_CMD_WIFI_CWMODE:
+        case LWESP_CMD_WIFI_CWDHCP_SET:
+#if LWESP_CFG_MODE_STATION
+            esp.m.sta.ip_valid = 0;
+#endif /* LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_MODE_ACCESS_POINT
+            esp.m.ap.ip_valid = 0;
+#endif /* LWESP_CFG_MODE_ACCESS_POINT */
+            break;
+#if LWESP_CFG_MODE_STATION
+        case LWESP_CMD_WIFI_CIPSTA_SET:
+            esp.m.sta.ip_valid = 0;
+            break;
+        case LWESP_CMD_WIFI_CIPSTAMAC_SET:
+            esp.m.sta.mac_valid = 0;
+            break;
+#endif /* LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_MODE_ACCESS_POINT
+        case LWESP_CMD_WIFI_CIPAP_SET:
+            esp.m.ap.ip_valid = 0;
+            break;
+        case LWESP_CMD_WIFI_CIPAPMAC_SET:
+            esp.m.ap.mac_valid = 0;
+            break;
+#endif /* LWESP_CFG_MODE_ACCESS_POINT */
+#if LWESP_CFG_HOSTNAME
+        case LWESP_CMD_WIFI_CWHOSTNAME_SET:
+            esp.m.hostname_valid = 0;
+            break;
+#endif /* LWESP_CFG_HOSTNAME */
+        default:
+            break;
+    }
+}
+
+/**
+ * \brief           Get cached IP settings and finish API call without AT command
+ * \param[in]       im: Station or access point settings
+ * \param[out]      ip: Pointer to output IP variable. Set to `NULL` if not interested
+ * \param[out]      gw: Pointer to output gateway variable. Set to `NULL` if not interested
+ * \param[out]      nm: Pointer to output netmask variable. Set to `NULL` if not interested
+ * \param[in]       evt_fn: Callback function called on success. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \return          `1` when cached values are valid and were copied, `0` otherwise
+ */
+uint8_t
+lwespi_ip_mac_cache_get_ip(const lwesp_ip_mac_t* im, lwesp_ip_t* ip, lwesp_ip_t* gw, lwesp_ip_t* nm,
+                           const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg) {
+    uint8_t valid;
+
+    lwesp_core_lock();
+    if ((valid = im->ip_valid) != 0) {
+        if (ip != NULL) {
+            LWESP_MEMCPY(ip, &im->ip, sizeof(*ip));
+        }
+        if (gw != NULL) {
+            LWESP_MEMCPY(gw, &im->gw, sizeof(*gw));
+        }
+        if (nm != NULL) {
+            LWESP_MEMCPY(nm, &im->nm, sizeof(*nm));
+        }
+    }
+    lwesp_core_unlock();
+    if (valid && evt_fn != NULL) {
+        evt_fn(lwespOK, evt_arg);
+    }
+    return valid;
+}
+
+/**
+ * \brief           Get cached MAC address and finish API call without AT command
+ * \param[in]       im: Station or access point settings
+ * \param[out]      mac: Pointer to output MAC variable. Set to `NULL` if not interested
+ * \param[in]       evt_fn: Callback function called on success. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \return          `1` when cached value is valid and was copied, `0` otherwise
+ */
+uint8_t
+lwespi_ip_mac_cache_get_mac(const lwesp_ip_mac_t* im, lwesp_mac_t* mac,
+                            const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg) {
+    uint8_t valid;
+
+    lwesp_core_lock();
+    if ((valid = im->mac_valid) != 0 && mac != NULL) {
+        LWESP_MEMCPY(mac, &im->mac, sizeof(*mac));
+    }
+    lwesp_core_unlock();
+    if (valid && evt_fn != NULL) {
+        evt_fn(lwespOK, evt_arg);
+    }
+    return valid;
+}
+
+#endif /* LWESP_CFG_IP_MAC_CACHE || __DOXYGEN__ */
+
+/**
+ * \brief           Notify upper layer about failed close of connection
+ * \param[in]       conn: Connection which may still be open on device
+ */
+static void
+conn_close_failed(lwesp_conn_p conn) {
+    esp.m.conn_status_stale = 1;                /* Link may still be open on device */
+
+    esp.evt.type = LWESP_EVT_CONN_CLOSE;
+    esp.evt.evt.conn_active_close.conn = conn;
+    esp.evt.evt.conn_active_close.forced = 1;
+    esp.evt.evt.conn_active_close.res = lwespERR;
+    esp.evt.evt.conn_active_close.client = conn->status.f.active && conn->status.f.client;
+    lwespi_send_conn_cb(conn, NULL);
+}
+
+/**
+ * \brief           Get link ID of next connection to close by multi-connection close message
+ * \param[in]       msg: Close message with connection bitmap
+ * \param[in]       from: Link ID to start search with
+ * \return          Link ID of active connection, or \ref LWESP_CFG_MAX_CONNS if there is none
+ */
+static uint8_t
+conn_close_many_next(lwesp_msg_t* msg, size_t from) {
+    for (; from < LWESP_CFG_MAX_CONNS; ++from) {
+        if (LWESPI_CONN_BIT_GET(msg->msg.conn_close.conns, from) && esp.m.conns[from].status.f.active
+            && esp.m.conns[from].val_id == msg->msg.conn_close.val_ids[from]) {
+            break;
+        }
+    }
+    return LWESP_U8(from);
+}
+
+/**
+ * \brief           Get link ID for first `AT+CIPCLOSE` command of multi-connection close message
+ *
+ * When bitmap covers every active connection, all are closed with single command
+ *
+ * \note            Bitmap must hold at least one active connection
+ * \param[in]       msg: Close message with connection bitmap
+ * \return          Link ID of first connection or \ref LWESPI_CONN_CLOSE_ALL_ID
+ */
+static uint8_t
+conn_close_many_first(lwesp_msg_t* msg) {
+    uint8_t first = conn_close_many_next(msg, 0), cnt = 0;
+
+    for (size_t i = first; i < LWESP_CFG_MAX_CONNS; ++i) {
+        if (!esp.m.conns[i].status.f.active) {
+            continue;
+        } else if (conn_close_many_next(msg, i) != i) {
+            return first;                       /* Connection must stay open */
+        }
+        ++cnt;
+    }
+    return cnt > 1 ? LWESPI_CONN_CLOSE_ALL_ID : first;
+}
+
+/**
+ * \brief           Finish `AT+CIPCLOSE` command for all connections
+ *
+ * Connections not reported as closed by device meanwhile are closed in single pass.
+ * On failure, every active connection gets failed close event
+ *
+ * \param[in]       is_ok: Set to `1` when device closed all connections
+ */
+static void
+conn_close_all_done(uint8_t is_ok) {
+    for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+        lwesp_conn_t* conn = &esp.m.conns[i];
+
+        if (!conn->status.f.active) {
+            continue;
+        } else if (!is_ok) {
+            conn_close_failed(conn);
+            continue;
+        }
+        conn->status.f.active = 0;
+        LWESPI_CONN_BIT_CLR(esp.m.active_conns, i);
+
+        esp.evt.type = LWESP_EVT_CONN_CLOSE;
+        esp.evt.evt.conn_active_close.conn = conn;
+        esp.evt.evt.conn_active_close.client = conn->status.f.client;
+        esp.evt.evt.conn_active_close.forced = 1;
+        esp.evt.evt.conn_active_close.res = lwespOK;
+        lwespi_send_conn_cb(conn, NULL);
+
+        if (conn->buff.buff != NULL) {
+            lwespi_conn_buff_free(conn->buff.buff);
+            conn->buff.buff = NULL;
+        }
+    }
+    if (is_ok) {
+        esp.m.conn_status_stale = 0;            /* Device has no open link anymore */
+    }
+}
+
+/**
+ * \brief           Process current command with known execution status and start another if necessary
+ * \param[in]       msg: Pointer to current message
+ * \param[in]       is_ok: Status whether last command result was OK
+ * \param[in]       is_error: Status whether last command result was ERROR
+ * \param[in]       is_ready: Status whether last command result was ready
+ * \return          lwespCONT if you sent more data and we need to process more data, or lwespOK on success, or lwespERR on error
+ */
+static lwespr_t
+lwespi_process_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, uint8_t* is_ready) {
+    lwesp_cmd_t n_cmd = LWESP_CMD_IDLE;
+
+#if LWESP_CFG_IP_MAC_CACHE
+    if (*is_ok) {
+        ip_mac_cache_validate(CMD_GET_CUR());
+    }
+#endif /* LWESP_CFG_IP_MAC_CACHE */
+    if (CMD_IS_DEF(LWESP_CMD_RESET)) {          /* Device is in reset mode */
+        n_cmd = lwespi_get_reset_sub_cmd(msg, is_ok, is_error, is_ready);
+#if LWESP_CFG_WARM_INIT
+        /* Skip configuration commands already matching on device */
+        while (msg->msg.reset.warm == 2 && lwespi_warm_state_is_configured(msg, n_cmd)) {
+            msg->cmd = n_cmd;
+            n_cmd = lwespi_get_reset_sub_cmd(msg, is_ok, is_error, is_ready);
+        }
+        if (n_cmd == LWESP_CMD_IDLE && msg->msg.reset.warm != 2) {
+            lwespi_warm_state_save(*is_ok);     /* Store state after full reset */
+        }
+#endif /* LWESP_CFG_WARM_INIT */
+#if LWESP_CFG_RESET_RECOVERY
+        /* Wifi mode is kept in device flash over reset */
+        if (msg->msg.reset.recover && n_cmd == LWESP_CMD_WIFI_CWMODE) {
+            msg->cmd = n_cmd;
+            n_cmd = lwespi_get_reset_sub_cmd(msg, is_ok, is_error, is_ready);
+        }
+#endif /* LWESP_CFG_RESET_RECOVERY */
+        if (n_cmd == LWESP_CMD_IDLE) {          /* Last command? */
+            RESET_SEND_EVT(msg, *is_ok ? lwespOK : lwespERR);
+        }
+    } else if (CMD_IS_DEF(LWESP_CMD_UART_AUTOBAUD)) {
+        if (CMD_IS_CUR(LWESP_CMD_UART)) {
+            if (*is_ok) {
+                SET_NEW_CMD(LWESP_CMD_AT);      /* Verify link at new baudrate */
+            } else if (lwespi_uart_autobaud_next(msg)) {
+                SET_NEW_CMD(LWESP_CMD_UART);    /* Device refused baudrate, try lower one */
+            } else {
+                *is_ok = 1;                     /* Stay at last verified baudrate */
+                *is_error = 0;
+            }
+        } else if (CMD_IS_CUR(LWESP_CMD_AT)) {
+            lwesp_timeout_cancel(msg->msg.uart.verify_id);
+            msg->msg.uart.verify_id = 0;
+            if (*is_ok) {
+                msg->msg.uart.baudrate_prev = esp.ll.uart.baudrate; /* Highest stable baudrate found */
+            } else if (!msg->msg.uart.final) {
+                SET_NEW_CMD(lwespi_uart_autobaud_fallback(msg));
+            }
+        }
+    } else if (CMD_IS_DEF(LWESP_CMD_RESTORE)) {
+        if ((CMD_IS_CUR(LWESP_CMD_RESET)) && *is_ready) {
+            SET_NEW_CMD(LWESP_CMD_RESTORE);
+        } else if ((CMD_IS_CUR(LWESP_CMD_RESTORE) && *is_ready)
+                   || !CMD_IS_CUR(LWESP_CMD_RESTORE)) {
+            SET_NEW_CMD(lwespi_get_reset_sub_cmd(msg, is_ok, is_error, is_ready));
+        }
+        if (n_cmd == LWESP_CMD_IDLE) {
+            RESTORE_SEND_EVT(msg, *is_ok ? lwespOK : lwespERR);
+        }
+#if LWESP_CFG_MODE_STATION
+    } else if (CMD_IS_DEF(LWESP_CMD_WIFI_CWJAP)) {  /* Is our intention to join to access point? */
+        if (CMD_IS_CUR(LWESP_CMD_WIFI_CWJAP)) { /* Is the current command join? */
+            if (*is_ok) {                       /* Did we join successfully? */
+                SET_NEW_CMD(LWESP_CMD_WIFI_CWDHCP_GET); /* Check IP address status */
+#if LWESP_CFG_STA_FAST_JOIN
+            } else if (msg->msg.sta_join.fast && msg->msg.sta_join.error_num != 2) {
+                /* Cached access point not reachable, repeat with full scan unless password is wrong */
+                esp.sta_fast_join.valid = 0;
+                msg->msg.sta_join.full_scan = 1;
+                msg->msg.sta_join.error_num = 0;
+                SET_NEW_CMD(LWESP_CMD_WIFI_CWJAP);
+#endif /* LWESP_CFG_STA_FAST_JOIN */
+            } else {
+                esp.m.sta.is_connected = 0;     /* Force disconnected status */
+                /*
                  * Parse received error message,
                  * if final result was error, decide what type
                  * of error should be returned for user
@@ -1455,6 +3628,10 @@ lwespi_process_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, uint
         } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CIPSTA_GET)) {
             lwespi_send_cb(LWESP_EVT_WIFI_IP_ACQUIRED); /* Notify upper layer */
             SET_NEW_CMD(LWESP_CMD_WIFI_CIPSTAMAC_GET);  /* Go to next command to get MAC address */
+#if LWESP_CFG_STA_FAST_JOIN
+        } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CIPSTAMAC_GET)) {
+            SET_NEW_CMD(LWESP_CMD_WIFI_CWJAP_GET);  /* Cache joined access point for next fast join */
+#endif /* LWESP_CFG_STA_FAST_JOIN */
         } else {
             esp.evt.evt.sta_join_ap.res = lwespOK;  /* Connected ok */
         }
@@ -1464,7 +3641,21 @@ lwespi_process_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, uint
             STA_JOIN_AP_SEND_EVT(msg, esp.evt.evt.sta_join_ap.res);
         }
     } else if (CMD_IS_DEF(LWESP_CMD_WIFI_CWLAP)) {
-        STA_LIST_AP_SEND_EVT(msg, *is_ok ? lwespOK : lwespERR);
+        if (CMD_IS_CUR(LWESP_CMD_WIFI_CWLAPOPT)) {
+            /* Format set before scan, or restored after it */
+            if (msg->msg.ap_list.fields != LWESP_STA_AP_FIELD_ALL) {
+                SET_NEW_CMD_CHECK_ERROR(LWESP_CMD_WIFI_CWLAP);
+            } else if (msg->msg.ap_list.err) {
+                *is_ok = 0;
+            }
+        } else if (msg->msg.ap_list.fields != LWESP_STA_AP_FIELD_ALL) {
+            msg->msg.ap_list.err = !*is_ok;     /* Restore default format regardless of scan result */
+            msg->msg.ap_list.fields = LWESP_STA_AP_FIELD_ALL;
+            SET_NEW_CMD(LWESP_CMD_WIFI_CWLAPOPT);
+        }
+        if (n_cmd == LWESP_CMD_IDLE) {
+            STA_LIST_AP_SEND_EVT(msg, *is_ok ? lwespOK : lwespERR);
+        }
     } else if (CMD_IS_DEF(LWESP_CMD_WIFI_CWJAP_GET)) {
         STA_INFO_AP_SEND_EVT(msg, *is_ok ? lwespOK : lwespERR);
     } else if (CMD_IS_DEF(LWESP_CMD_WIFI_CIPSTA_SET)) {
@@ -1496,108 +3687,192 @@ lwespi_process_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, uint
         } else if (CMD_IS_CUR(LWESP_CMD_WIFI_CWDHCP_GET)) {
             SET_NEW_CMD_COND(LWESP_CMD_WIFI_CIPAPMAC_GET, *is_ok);
         }
+#if LWESP_CFG_AP_STA_TABLE > 0
+    } else if (CMD_IS_DEF(LWESP_CMD_WIFI_CWLIF)) {
+        if (*is_ok) {
+            lwespi_ap_sta_table_sync_done();    /* Drop stations device did not list */
+        }
+#endif /* LWESP_CFG_AP_STA_TABLE > 0 */
 #endif /* LWESP_CFG_MODE_ACCESS_POINT */
 #if LWESP_CFG_DNS
     } else if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPDOMAIN)) {
-        CIPDOMAIN_SEND_EVT(esp.msg, *is_ok ? lwespOK : lwespERR);
+#if LWESP_CFG_DNS_CACHE_SIZE > 0
+        if (msg->msg.dns_getbyhostname.hosts != NULL) { /* Prefetch continues with next host regardless of result */
+            msg->msg.dns_getbyhostname.err |= !*is_ok;
+            if (lwespi_dns_prefetch_next(msg)) {
+                SET_NEW_CMD(LWESP_CMD_TCPIP_CIPDOMAIN);
+            } else if (msg->msg.dns_getbyhostname.err) {
+                *is_ok = 0;
+            }
+        } else
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 */
+        {
+            CIPDOMAIN_SEND_EVT(esp.msg, *is_ok ? lwespOK : lwespERR);
+        }
 #endif /* LWESP_CFG_DNS */
 #if LWESP_CFG_PING
     } else if (CMD_IS_DEF(LWESP_CMD_TCPIP_PING)) {
         PING_SEND_EVT(esp.msg, *is_ok ? lwespOK : lwespERR);
 #endif
     } else if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPSTART)) {  /* Is our intention to join to access point? */
-        if (msg->i == 0 && CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSTATUS)) { /* Was the current command status info? */
-            SET_NEW_CMD_COND(LWESP_CMD_TCPIP_CIPSTART, *is_ok); /* Now actually start connection */
-        } else if (msg->i == 1 && CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSTART)) {
-            SET_NEW_CMD(LWESP_CMD_TCPIP_CIPSTATUS); /* Go to status mode */
-        } else if (msg->i == 2 && CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSTATUS)) {
+        /*
+         * Connection number is set once CIPSTART is initiated.
+         * Status check after start is only needed when +LINK_CONN did not confirm connection
+         */
+        if (msg->msg.conn_start.num == LWESP_CFG_MAX_CONNS && CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSTATUS)) {
+            /* SSL setup, if any, is done before connection is actually started */
+            SET_NEW_CMD_COND(lwespi_conn_start_next_cmd(msg, LWESP_CMD_TCPIP_CIPSTATUS), *is_ok);
+        } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSSLSIZE)) {
+            if (*is_ok) {
+                esp.m.ssl_buff_size = msg->msg.conn_start.ssl_buff_size;
+            }
+            SET_NEW_CMD(lwespi_conn_start_next_cmd(msg, LWESP_CMD_TCPIP_CIPSSLSIZE));  /* Size is only a hint */
+        } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSSLCCONF) || CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSSLCSNI)) {
+            /* Never connect with weaker security than requested */
+            SET_NEW_CMD_COND(lwespi_conn_start_next_cmd(msg, CMD_GET_CUR()), *is_ok);
+        } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSTART)) {
+            SET_NEW_CMD_COND(LWESP_CMD_TCPIP_CIPSTATUS, !msg->msg.conn_start.success);  /* Go to status mode */
+        } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSTATUS)) {
             /* Check if connect actually succeeded */
             if (!msg->msg.conn_start.success) {
                 *is_ok = 0;
                 *is_error = 1;
             }
         }
+#if LWESP_CFG_DNS_CACHE_SIZE > 0
+        if (n_cmd == LWESP_CMD_IDLE && !*is_ok && msg->msg.conn_start.dns_cached) {
+            lwespi_dns_cache_remove(msg->msg.conn_start.remote_host);   /* Cached address may be stale */
+        }
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 */
+    } else if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPSSLSIZE)) {
+        if (*is_ok) {
+            esp.m.ssl_buff_size = msg->msg.tcpip_sslsize.size;
+        }
+#if LWESP_CFG_CONN_PASSTHROUGH
+    } else if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPMODE)) {   /* Start connection in passthrough mode */
+        /*
+         * Sequence is CIPMUX=0, CIPMODE=1, CIPSTART and CIPSEND.
+         * On failure, device is put back to multiple connections mode
+         * with passthrough flag cleared
+         */
+        if (msg->msg.conn_start.passthrough) {
+            if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPMUX)) {
+                SET_NEW_CMD_COND(LWESP_CMD_TCPIP_CIPMODE, *is_ok);
+            } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPMODE)) {
+                if (*is_ok) {
+                    SET_NEW_CMD(LWESP_CMD_TCPIP_CIPSTART);
+                } else {
+                    msg->msg.conn_start.passthrough = 0;
+                    SET_NEW_CMD(LWESP_CMD_TCPIP_CIPMUX);
+                }
+            } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSTART)) {
+                if (*is_ok) {
+                    if (!msg->msg.conn_start.success) {
+                        lwespi_conn_passthrough_activate(msg);
+                    }
+                    SET_NEW_CMD(LWESP_CMD_TCPIP_CIPSEND_PASSTHROUGH);
+                } else {
+                    msg->msg.conn_start.passthrough = 0;
+                    SET_NEW_CMD(LWESP_CMD_TCPIP_CIPMODE);
+                }
+            } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPSEND_PASSTHROUGH)) {
+                msg->msg.conn_start.passthrough = 0;/* Prompt not received */
+                SET_NEW_CMD(LWESP_CMD_TCPIP_CIPCLOSE);
+            }
+        } else {
+            if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPCLOSE)) {
+                lwespi_conn_passthrough_closed();
+                SET_NEW_CMD(LWESP_CMD_TCPIP_CIPMODE);
+            } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPMODE)) {
+                SET_NEW_CMD(LWESP_CMD_TCPIP_CIPMUX);
+            } else {
+                *is_ok = 0;                     /* Report failed start after recovery */
+                *is_error = 1;
+            }
+        }
+    } else if (CMD_IS_DEF(LWESP_CMD_TCPIP_PASSTHROUGH_EXIT)) {
+        /* Sequence is +++ with CIPMODE=0, CIPCLOSE and CIPMUX=1 */
+        if (CMD_IS_CUR(LWESP_CMD_TCPIP_PASSTHROUGH_EXIT)) {
+            SET_NEW_CMD(LWESP_CMD_TCPIP_CIPCLOSE);
+        } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPCLOSE)) {
+            lwespi_conn_passthrough_closed();   /* Connection may have been closed already */
+            SET_NEW_CMD(LWESP_CMD_TCPIP_CIPMUX);
+        }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
     } else if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPCLOSE)) {
-        if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPCLOSE) && *is_error) {
-            /* Notify upper layer about failed close event */
-            esp.evt.type = LWESP_EVT_CONN_CLOSE;
-            esp.evt.evt.conn_active_close.conn = msg->msg.conn_close.conn;
-            esp.evt.evt.conn_active_close.forced = 1;
-            esp.evt.evt.conn_active_close.res = lwespERR;
-            esp.evt.evt.conn_active_close.client = msg->msg.conn_close.conn->status.f.active && msg->msg.conn_close.conn->status.f.client;
-            lwespi_send_conn_cb(msg->msg.conn_close.conn, NULL);
+        if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPCLOSE) && msg->msg.conn_close.conn == NULL) {
+            uint8_t num = msg->msg.conn_close.num;
+
+            if (num == LWESPI_CONN_CLOSE_ALL_ID) {
+                conn_close_all_done(*is_ok);
+            } else {
+                if (*is_error) {
+                    msg->msg.conn_close.failed = 1;
+                    conn_close_failed(&esp.m.conns[num]);
+                }
+                if ((num = conn_close_many_next(msg, num + 1)) < LWESP_CFG_MAX_CONNS) {
+                    msg->msg.conn_close.num = num;
+                    SET_NEW_CMD(LWESP_CMD_TCPIP_CIPCLOSE);  /* Close next connection from bitmap */
+                } else if (msg->msg.conn_close.failed) {
+                    *is_ok = 0;                 /* Report failure of any connection */
+                    *is_error = 1;
+                }
+            }
+        } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPCLOSE) && *is_error) {
+            conn_close_failed(msg->msg.conn_close.conn);/* Notify upper layer about failed close event */
+        }
+#if LWESP_CFG_CONN_SEND_BUFFERED
+    } else if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPSEND) && CMD_IS_CUR(LWESP_CMD_TCPIP_CIPBUFSTATUS)) {
+        if (*is_ok) {
+            SET_NEW_CMD(LWESP_CMD_TCPIP_CIPSEND);   /* Continue sending, polls again if no segment was released */
+        } else {
+            CONN_SEND_DATA_SEND_EVT(msg, lwespERR);
         }
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED */
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
     } else if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPRECVDATA)) {
-        if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPRECVLEN) && msg->msg.ciprecvdata.is_last_check == 0) {
-            uint8_t set_error = 0;
+        if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPRECVLEN)) {
             LWESP_DEBUGW(LWESP_CFG_DBG_CONN | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_SEVERE, *is_error,
                        "[CONN] CIPRECVLEN returned ERROR\r\n");
 
-            /* If command is OK */
             if (*is_ok) {
-                size_t len;
-
                 /* Check if `+IPD` received during data length check */
-                if (esp.msg->msg.ciprecvdata.ipd_recv) {
-                    esp.msg->msg.ciprecvdata.ipd_recv = 0;
+                if (msg->msg.ciprecvdata.ipd_recv) {
+                    msg->msg.ciprecvdata.ipd_recv = 0;
                     SET_NEW_CMD(LWESP_CMD_TCPIP_CIPRECVLEN);
                 } else {
-                    /* Number of bytes to read */
-                    len = LWESP_MIN(LWESP_CFG_CONN_MAX_DATA_LEN, msg->msg.ciprecvdata.conn->tcp_available_bytes);
-                    if (len > 0) {
-                        lwesp_pbuf_p p = NULL;
-
-                        /* Try to allocate packet buffer */
-                        while (p == NULL) {
-                            p = lwesp_pbuf_new(len);/* Try to allocate buffer */
-                            if (p == NULL) {    /* In case of failure */
-                                len /= 2;       /* Try with half of value on next try */
-                                if (len < 10) { /* If not possible to allocate at least 10 bytes from first try, stop immediately */
-                                    break;
-                                }
-                            }
-                        }
-
-                        /* Start reading procedure */
-                        if (p != NULL) {
-                            msg->msg.ciprecvdata.buff = p;
-                            msg->msg.ciprecvdata.len = len;
-                            SET_NEW_CMD(LWESP_CMD_TCPIP_CIPRECVDATA);
-                        } else {
-                            set_error = 1;
-                        }
-                    } else {
-                        /* No error if buffer empty */
-                    }
+                    /* Single poll drives reads for all connections */
+                    msg->msg.ciprecvdata.idx = 0;
+                    msg->msg.ciprecvdata.rem = SIZE_MAX;
+                    SET_NEW_CMD_COND(LWESP_CMD_TCPIP_CIPRECVDATA, lwespi_conn_manual_tcp_read_next(msg));
                 }
-            } else {
-                set_error = 1;
-            }
-            if (set_error) {
-                *is_ok = 0;
-                *is_error = 1;
             }
         } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPRECVDATA)) {
-            /* Read failed? Handle queue len */
+            /* Read failed? Release buffer and skip connection */
             if (*is_error) {
                 if (msg->msg.ciprecvdata.buff != NULL) {
                     lwesp_pbuf_free(msg->msg.ciprecvdata.buff);
                     msg->msg.ciprecvdata.buff = NULL;
                 }
+                ++msg->msg.ciprecvdata.idx;
+                msg->msg.ciprecvdata.rem = SIZE_MAX;
             }
 
-            /* This one is optional, to check for more data just at the end */
-            SET_NEW_CMD(LWESP_CMD_TCPIP_CIPRECVLEN);/* Inquiry for latest status on data */
-            msg->msg.ciprecvdata.is_last_check = 1;
-        } else if (CMD_IS_CUR(LWESP_CMD_TCPIP_CIPRECVLEN) && msg->msg.ciprecvdata.is_last_check == 0) {
-            /* Do nothing */
-            if (*is_error) {
-                *is_error = 0;
+            /* Chain next read, for the same or next ready connection */
+            if (lwespi_conn_manual_tcp_read_next(msg)) {
+                SET_NEW_CMD(LWESP_CMD_TCPIP_CIPRECVDATA);
+            } else if (*is_error) {
+                *is_error = 0;                  /* Failed read of one connection does not fail others */
                 *is_ok = 1;
             }
         }
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+    } else if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPRECVMODE)) {
+        if (*is_ok) {
+            esp.m.tcp_recv_manual = msg->msg.ciprecvmode.manual;
+        }
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
     } else if (CMD_IS_DEF(LWESP_CMD_WIFI_CWDHCP_SET)) {
         if (CMD_IS_CUR(LWESP_CMD_WIFI_CWDHCP_SET)) {
             SET_NEW_CMD(LWESP_CMD_WIFI_CWDHCP_GET);
@@ -1644,6 +3919,115 @@ lwespi_process_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, uint
     return *is_ok || *is_ready ? lwespOK : lwespERR;
 }
 
+#if LWESP_CFG_MODE_STATION || __DOXYGEN__
+/**
+ * \brief           Get connection to use for connection start message
+ *
+ * Once selected, the same connection is reused by all commands of the message,
+ * so that SSL setup and `AT+CIPSTART` target the same link ID
+ *
+ * \param[in]       msg: Connection start message
+ * \return          Connection handle on success, `NULL` if there is no free connection
+ */
+static lwesp_conn_t*
+conn_start_get_free(lwesp_msg_t* msg) {
+    lwesp_conn_t* c = NULL;
+    uint8_t num = msg->msg.conn_start.num;
+
+#if LWESP_CFG_CONN_PASSTHROUGH
+    if (msg->msg.conn_start.passthrough) {
+        num = 0;                                /* Single connection mode always uses first connection */
+    } else
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
+    if (num < LWESP_CFG_MAX_CONNS
+        && esp.m.conns[num].status.f.active && LWESPI_CONN_BIT_GET(esp.m.active_conns, num)) {
+        num = LWESP_CFG_MAX_CONNS;              /* Selected link got active in the meantime */
+    }
+    for (int16_t i = LWESP_CFG_MAX_CONNS - 1; num == LWESP_CFG_MAX_CONNS && i >= 0; --i) {/* Find available connection */
+        if (!esp.m.conns[i].status.f.active
+            || !LWESPI_CONN_BIT_GET(esp.m.active_conns, i)) {
+            num = LWESP_U8(i);
+        }
+    }
+    if (num < LWESP_CFG_MAX_CONNS) {
+        c = &esp.m.conns[num];
+        c->num = num;
+        msg->msg.conn_start.num = num;          /* Set connection number for message structure */
+    }
+    return c;
+}
+#endif /* LWESP_CFG_MODE_STATION || __DOXYGEN__ */
+
+/**
+ * \brief           Descriptor of AT command sent without run-time parameters
+ */
+typedef struct {
+    const char* body;                           /*!< Command body, sent between `AT` and `CRLF` */
+    uint8_t len;                                /*!< Length of body in units of bytes */
+} lwespi_cmd_desc_t;
+
+#define CMD_DESC(body)                      { (body), (uint8_t)(sizeof(body) - 1) }
+
+/**
+ * \brief           Static command table, indexed by \ref lwesp_cmd_t
+ * \note            Commands with `NULL` body are built in \ref lwespi_initiate_cmd switch
+ */
+static const lwespi_cmd_desc_t cmd_desc[LWESP_CMD_END] = {
+    [LWESP_CMD_RESTORE] = CMD_DESC("+RESTORE"),
+    [LWESP_CMD_ATE0] = CMD_DESC("E0"),
+    [LWESP_CMD_ATE1] = CMD_DESC("E1"),
+    [LWESP_CMD_GMR] = CMD_DESC("+GMR"),
+    [LWESP_CMD_SYSMSG] = CMD_DESC("+SYSMSG=3"),
+    [LWESP_CMD_SYSLOG] = CMD_DESC("+SYSLOG=1"),
+    [LWESP_CMD_WIFI_CWMODE_GET] = CMD_DESC("+CWMODE?"),
+    [LWESP_CMD_WIFI_CWDHCP_GET] = CMD_DESC("+CWDHCP?"),
+#if LWESP_CFG_MODE_STATION
+    [LWESP_CMD_WIFI_CWJAP_GET] = CMD_DESC("+CWJAP?"),
+    [LWESP_CMD_WIFI_CWQAP] = CMD_DESC("+CWQAP"),
+    [LWESP_CMD_WIFI_CIPSTA_GET] = CMD_DESC("+CIPSTA?"),
+    [LWESP_CMD_WIFI_CIPSTAMAC_GET] = CMD_DESC("+CIPSTAMAC?"),
+    [LWESP_CMD_TCPIP_CIUPDATE] = CMD_DESC("+CIUPDATE"),
+#endif /* LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_MODE_ACCESS_POINT
+    [LWESP_CMD_WIFI_CWSAP_GET] = CMD_DESC("+CWSAP?"),
+    [LWESP_CMD_WIFI_CIPAP_GET] = CMD_DESC("+CIPAP?"),
+    [LWESP_CMD_WIFI_CIPAPMAC_GET] = CMD_DESC("+CIPAPMAC?"),
+#endif /* LWESP_CFG_MODE_ACCESS_POINT */
+#if LWESP_CFG_HOSTNAME
+    [LWESP_CMD_WIFI_CWHOSTNAME_GET] = CMD_DESC("+CWHOSTNAME?"),
+#endif /* LWESP_CFG_HOSTNAME */
+    [LWESP_CMD_TCPIP_CIPDINFO] = CMD_DESC("+CIPDINFO=1"),
+#if LWESP_CFG_WARM_INIT
+    [LWESP_CMD_TCPIP_CIPMUX_GET] = CMD_DESC("+CIPMUX?"),
+    [LWESP_CMD_TCPIP_CIPDINFO_GET] = CMD_DESC("+CIPDINFO?"),
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE && !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+    [LWESP_CMD_TCPIP_CIPRECVMODE_GET] = CMD_DESC("+CIPRECVMODE?"),
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE && !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
+#endif /* LWESP_CFG_WARM_INIT */
+#if LWESP_CFG_CONN_PASSTHROUGH
+    [LWESP_CMD_TCPIP_CIPSEND_PASSTHROUGH] = CMD_DESC("+CIPSEND"),
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+#if !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+    [LWESP_CMD_TCPIP_CIPRECVMODE] = CMD_DESC("+CIPRECVMODE=1"),
+#endif /* !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
+    [LWESP_CMD_TCPIP_CIPRECVLEN] = CMD_DESC("+CIPRECVLEN?"),
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+#if LWESP_CFG_DNS
+    [LWESP_CMD_TCPIP_CIPDNS_GET] = CMD_DESC("+CIPDNS?"),
+#endif /* LWESP_CFG_DNS */
+#if LWESP_CFG_SNTP
+    [LWESP_CMD_TCPIP_CIPSNTPTIME] = CMD_DESC("+CIPSNTPTIME?"),
+#endif /* LWESP_CFG_SNTP */
+#if LWESP_CFG_SMART
+    [LWESP_CMD_WIFI_SMART_START] = CMD_DESC("+CWSTARTSMART"),
+    [LWESP_CMD_WIFI_SMART_STOP] = CMD_DESC("+CWSTOPSMART"),
+#endif /* LWESP_CFG_SMART */
+#if LWESP_CFG_ESP32
+    [LWESP_CMD_BLEINIT_GET] = CMD_DESC("+BLEINIT?"),
+#endif /* LWESP_CFG_ESP32 */
+};
+
 /**
  * \brief           Function to initialize every AT command
  * \note            Never call this function directly. Set as initialization function for command and use `msg->fn(msg)`
@@ -1652,17 +4036,39 @@ lwespi_process_sub_cmd(lwesp_msg_t* msg, uint8_t* is_ok, uint8_t* is_error, uint
  */
 lwespr_t
 lwespi_initiate_cmd(lwesp_msg_t* msg) {
+    LWESPI_STATS_CMD_START(msg);
+#if LWESP_CFG_IP_MAC_CACHE
+    ip_mac_cache_invalidate(CMD_GET_CUR());
+#endif /* LWESP_CFG_IP_MAC_CACHE */
+    if (CMD_GET_CUR() < LWESP_CMD_END && cmd_desc[CMD_GET_CUR()].body != NULL) {
+        AT_PORT_SEND_BEGIN_AT();                /* Fixed command, no switch needed */
+        AT_PORT_SEND(cmd_desc[CMD_GET_CUR()].body, cmd_desc[CMD_GET_CUR()].len);
+        AT_PORT_SEND_END_AT();
+        return lwespOK;
+    }
     switch (CMD_GET_CUR()) {                    /* Check current message we want to send over AT */
         case LWESP_CMD_RESET: {                 /* Reset MCU with AT commands */
+#if LWESP_CFG_WARM_INIT
+            /* Verify cached state with version command first, device is not reset */
+            if (msg->msg.reset.warm == 1) {
+                if (lwespi_warm_state_load()) {
+                    msg->cmd = LWESP_CMD_GMR;
+                    return lwespi_initiate_cmd(msg);
+                }
+                msg->msg.reset.warm = 0;
+            }
+#endif /* LWESP_CFG_WARM_INIT */
             /* Try hardware reset first */
             if (esp.ll.reset_fn != NULL && esp.ll.reset_fn(1)) {
 
-                /* Set baudrate to default one */
+                /* Set baudrate and flow control to default one */
                 esp.ll.uart.baudrate = LWESP_CFG_AT_PORT_BAUDRATE;
+                esp.ll.uart.flow_control = 0;
                 lwesp_ll_init(&esp.ll);         /* Set new baudrate */
 
                 lwesp_delay(10);                /* Wait some time */
                 esp.ll.reset_fn(0);             /* Release reset */
+                LWESPI_CAPTURE_RESET();
             } else {
                 AT_PORT_SEND_BEGIN_AT();
                 AT_PORT_SEND_CONST_STR("+RST");
@@ -1671,56 +4077,60 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
             }
             break;
         }
-        case LWESP_CMD_RESTORE: {               /* Reset MCU with AT commands */
+        case LWESP_CMD_UART_AUTOBAUD: {         /* Start baudrate negotiation */
+            msg->msg.uart.baudrate_prev = esp.ll.uart.baudrate;
+            if (lwespi_uart_autobaud_next(msg)) {
+                msg->cmd = LWESP_CMD_UART;
+            } else {
+                msg->cmd = LWESP_CMD_AT;        /* No better candidate, only verify link */
+                msg->msg.uart.final = 1;
+            }
+            return lwespi_initiate_cmd(msg);
+        }
+        case LWESP_CMD_AT: {                    /* Test AT port communication */
             AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+RESTORE");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWESP_CMD_ATE0: {                  /* Disable AT echo mode */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("E0");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWESP_CMD_ATE1: {                  /* Enable AT echo mode */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("E1");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWESP_CMD_GMR: {                   /* Get AT version */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+GMR");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWESP_CMD_SYSMSG: {                /* Enable system messages */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+SYSMSG=3");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWESP_CMD_SYSLOG: {                /* Enable system error logs */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+SYSLOG=1");
             AT_PORT_SEND_END_AT();
+            if (msg->cmd_def == LWESP_CMD_UART_AUTOBAUD) {
+                msg->msg.uart.verify_id = lwesp_timeout_addex(LWESP_CFG_AT_PORT_AUTOBAUD_VERIFY_TIME,
+                                          lwespi_uart_autobaud_timeout, msg);
+            }
             break;
         }
         case LWESP_CMD_UART: {                  /* Change UART parameters for AT port */
+#if LWESP_CFG_WARM_INIT
+            lwespi_warm_state_save(0);          /* Device state changes, invalidate cache */
+#endif /* LWESP_CFG_WARM_INIT */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+UART_CUR=");
-            lwespi_send_number(LWESP_U32(msg->msg.uart.baudrate), 0, 0);
-            AT_PORT_SEND_CONST_STR(",8,1,0,0");
+            lwespi_send_number(LWESP_U32(lwespi_uart_cmd_baudrate(msg)), 0, 0);
+            AT_PORT_SEND_CONST_STR(",8,1,0,");
+            lwespi_send_number(LWESP_U32(LWESP_CFG_AT_PORT_FLOW_CONTROL), 0, 0);
             AT_PORT_SEND_END_AT();
+            if (msg->cmd_def == LWESP_CMD_UART_AUTOBAUD && msg->msg.uart.fallback) {
+                msg->msg.uart.verify_id = lwesp_timeout_addex(20, lwespi_uart_autobaud_switch, msg);  /* Give device time to switch */
+                if (msg->msg.uart.verify_id == 0) {
+                    /* No timeout to switch later, return host to verified baudrate now and stop */
+                    msg->msg.uart.fallback = 0;
+                    esp.ll.uart.baudrate = msg->msg.uart.baudrate_prev;
+                    lwesp_ll_init(&esp.ll);
+                    return lwespERRMEM;
+                }
+            }
             break;
         }
+#if LWESP_CFG_MODE_STATION
         case LWESP_CMD_WIFI_CWLAPOPT: {         /* Set visible data on CWLAP command */
             AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CWLAPOPT=1,31");
+            AT_PORT_SEND_CONST_STR("+CWLAPOPT=1");
+            if (CMD_IS_DEF(LWESP_CMD_WIFI_CWLAP)) {
+                lwespi_send_number(LWESP_U32(msg->msg.ap_list.fields), 0, 1);
+            } else {
+                lwespi_send_number(LWESP_U32(LWESP_STA_AP_FIELD_ALL), 0, 1);
+            }
             AT_PORT_SEND_END_AT();
             break;
         }
+#endif /* LWESP_CFG_MODE_STATION */
 
             /* WiFi related commands */
 
@@ -1730,6 +4140,18 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
             AT_PORT_SEND_CONST_STR("+CWJAP=");
             lwespi_send_string(msg->msg.sta_join.name, 1, 1, 0);
             lwespi_send_string(msg->msg.sta_join.pass, 1, 1, 1);
+#if LWESP_CFG_STA_FAST_JOIN
+            msg->msg.sta_join.fast = msg->msg.sta_join.mac == NULL && !msg->msg.sta_join.full_scan
+                                     && esp.sta_fast_join.valid && !strcmp(esp.sta_fast_join.ssid, msg->msg.sta_join.name);
+            if (msg->msg.sta_join.fast) {
+                lwespi_send_ip_mac(&esp.sta_fast_join.bssid, 0, 1, 1);
+                if (esp.m.version_at.major > 2 || (esp.m.version_at.major == 2 && esp.m.version_at.minor >= 2)) {
+                    /* Default pci_en, reconn_interval and listen_interval, fast scan and short timeout */
+                    AT_PORT_SEND_CONST_STR(",0,1,3,0");
+                    lwespi_send_number(LWESP_U32(LWESP_CFG_STA_FAST_JOIN_TIMEOUT), 0, 1);
+                }
+            } else
+#endif /* LWESP_CFG_STA_FAST_JOIN */
             if (msg->msg.sta_join.mac != NULL) {
                 lwespi_send_ip_mac(msg->msg.sta_join.mac, 0, 1, 1);
             }
@@ -1746,18 +4168,6 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWESP_CMD_WIFI_CWJAP_GET: {        /* Get the info of the connected access point */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CWJAP?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWESP_CMD_WIFI_CWQAP: {            /* Quit from access point */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CWQAP");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
         case LWESP_CMD_WIFI_CWLAP: {            /* List access points */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CWLAP");
@@ -1775,27 +4185,18 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWESP_CMD_TCPIP_CIUPDATE: {        /* Update ESP software remotely */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIUPDATE");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
 #endif /* LWESP_CFG_MODE_STATION */
         case LWESP_CMD_WIFI_CWMODE: {           /* Set WIFI mode */
             lwesp_mode_t m;
 
             if (!CMD_IS_DEF(LWESP_CMD_WIFI_CWMODE)) {   /* Is this command part of reset sequence? */
-#if LWESP_CFG_MODE_STATION_ACCESS_POINT
-                m = LWESP_MODE_STA_AP;          /* Set station and access point mode */
-#elif LWESP_CFG_MODE_STATION
-                m = LWESP_MODE_STA;             /* Set station mode */
-#else /* LWESP_CFG_MODE_STATION */
-                m = LWESP_MODE_AP;              /* Set access point mode */
-#endif /* !LWESP_CFG_MODE_STATION_ACCESS_POINT */
+                m = lwespi_reset_wifi_mode();
             } else {
                 /* Use user setup */
                 m = msg->msg.wifi_mode.mode;
+#if LWESP_CFG_WARM_INIT
+                lwespi_warm_state_save(0);      /* Device state changes, invalidate cache */
+#endif /* LWESP_CFG_WARM_INIT */
             }
 
             AT_PORT_SEND_BEGIN_AT();
@@ -1804,58 +4205,6 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWESP_CMD_WIFI_CWMODE_GET: {       /* Get WIFI mode */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CWMODE?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-#if LWESP_CFG_MODE_STATION
-        case LWESP_CMD_WIFI_CIPSTA_GET:         /* Get station IP address */
-#endif /* LWESP_CFG_MODE_STATION */
-#if LWESP_CFG_MODE_ACCESS_POINT
-        case LWESP_CMD_WIFI_CIPAP_GET:          /* Get access point IP address */
-#endif /* LWESP_CFG_MODE_ACCESS_POINT */
-            {
-                AT_PORT_SEND_BEGIN_AT();
-                AT_PORT_SEND_CONST_STR("+CIP");
-#if LWESP_CFG_MODE_STATION
-                if (CMD_IS_CUR(LWESP_CMD_WIFI_CIPSTA_GET)) {
-                    AT_PORT_SEND_CONST_STR("STA");
-                }
-#endif /* LWESP_CFG_MODE_STATION */
-#if LWESP_CFG_MODE_ACCESS_POINT
-                if (CMD_IS_CUR(LWESP_CMD_WIFI_CIPAP_GET)) {
-                    AT_PORT_SEND_CONST_STR("AP");
-                }
-#endif /* LWESP_CFG_MODE_ACCESS_POINT */
-                AT_PORT_SEND_CONST_STR("?");
-                AT_PORT_SEND_END_AT();
-                break;
-            }
-#if LWESP_CFG_MODE_STATION
-        case LWESP_CMD_WIFI_CIPSTAMAC_GET:      /* Get station MAC address */
-#endif /* LWESP_CFG_MODE_STATION */
-#if LWESP_CFG_MODE_ACCESS_POINT
-        case LWESP_CMD_WIFI_CIPAPMAC_GET:       /* Get access point MAC address */
-#endif /* LWESP_CFG_MODE_ACCESS_POINT */
-            {
-                AT_PORT_SEND_BEGIN_AT();
-                AT_PORT_SEND_CONST_STR("+CIP");
-#if LWESP_CFG_MODE_STATION
-                if (CMD_IS_CUR(LWESP_CMD_WIFI_CIPSTAMAC_GET)) {
-                    AT_PORT_SEND_CONST_STR("STA");
-                }
-#endif /* LWESP_CFG_MODE_STATION */
-#if LWESP_CFG_MODE_ACCESS_POINT
-                if (CMD_IS_CUR(LWESP_CMD_WIFI_CIPAPMAC_GET)) {
-                    AT_PORT_SEND_CONST_STR("AP");
-                }
-#endif /* LWESP_CFG_MODE_ACCESS_POINT */
-                AT_PORT_SEND_CONST_STR("MAC?");
-                AT_PORT_SEND_END_AT();
-                break;
-            }
 #if LWESP_CFG_MODE_STATION
         case LWESP_CMD_WIFI_CIPSTA_SET:         /* Set station IP address */
 #endif /* LWESP_CFG_MODE_STATION */
@@ -1910,12 +4259,6 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
                 AT_PORT_SEND_END_AT();
                 break;
             }
-        case LWESP_CMD_WIFI_CWDHCP_GET: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CWDHCP?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
         case LWESP_CMD_WIFI_CWDHCP_SET: {
             uint32_t num = 0;
 
@@ -1944,13 +4287,10 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWESP_CMD_WIFI_CWSAP_GET: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CWSAP?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
         case LWESP_CMD_WIFI_CWLIF: {            /* List stations connected on soft-access point */
+#if LWESP_CFG_AP_STA_TABLE > 0
+            lwespi_ap_sta_table_sync_start();
+#endif /* LWESP_CFG_AP_STA_TABLE > 0 */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CWLIF");
             AT_PORT_SEND_END_AT();
@@ -1982,12 +4322,6 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWESP_CMD_WIFI_CWHOSTNAME_GET: {   /* List stations connected on access point */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CWHOSTNAME?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
 #endif /* LWESP_CFG_HOSTNAME */
 #if LWESP_CFG_MDNS
         case LWESP_CMD_WIFI_MDNS: {             /* Set mDNS parameters */
@@ -2049,6 +4383,10 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
 #if LWESP_CFG_MODE_STATION
         case LWESP_CMD_TCPIP_CIPSTART: {        /* Start a new connection */
             lwesp_conn_t* c = NULL;
+            uint8_t pt = 0;
+#if LWESP_CFG_DNS_CACHE_SIZE > 0
+            lwesp_ip_t ip;
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 */
 
             /* Do we have wifi connection? */
             if (!lwesp_sta_has_ip()) {
@@ -2056,17 +4394,10 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
                 return lwespERRNOIP;
             }
 
-            msg->msg.conn_start.num = 0;
-            for (int16_t i = LWESP_CFG_MAX_CONNS - 1; i >= 0; --i) {/* Find available connection */
-                if (!esp.m.conns[i].status.f.active
-                    || !(esp.m.active_conns & (1 << i))) {
-                    c = &esp.m.conns[i];
-                    c->num = LWESP_U8(i);
-                    msg->msg.conn_start.num = LWESP_U8(i);  /* Set connection number for message structure */
-                    break;
-                }
-            }
-            if (c == NULL) {
+#if LWESP_CFG_CONN_PASSTHROUGH
+            pt = msg->msg.conn_start.passthrough;
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
+            if ((c = conn_start_get_free(msg)) == NULL) {
                 lwespi_send_conn_error_cb(msg, lwespERRNOFREECONN);
                 return lwespERRNOFREECONN;      /* We don't have available connection */
             }
@@ -2077,15 +4408,25 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
 
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CIPSTART=");
-            lwespi_send_number(LWESP_U32(c->num), 0, 0);
+            if (!pt) {                          /* Link ID is not used in single connection mode */
+                lwespi_send_number(LWESP_U32(c->num), 0, 0);
+            }
             if (msg->msg.conn_start.type == LWESP_CONN_TYPE_SSL) {
-                lwespi_send_string("SSL", 0, 1, 1);
+                lwespi_send_string("SSL", 0, 1, !pt);
             } else if (msg->msg.conn_start.type == LWESP_CONN_TYPE_TCP) {
-                lwespi_send_string("TCP", 0, 1, 1);
+                lwespi_send_string("TCP", 0, 1, !pt);
             } else if (msg->msg.conn_start.type == LWESP_CONN_TYPE_UDP) {
-                lwespi_send_string("UDP", 0, 1, 1);
+                lwespi_send_string("UDP", 0, 1, !pt);
+            }
+#if LWESP_CFG_DNS_CACHE_SIZE > 0
+            if (lwespi_dns_cache_get(msg->msg.conn_start.remote_host, &ip)) {
+                lwespi_send_ip_mac(&ip, 1, 1, 1);   /* Use cached address, device does not resolve host again */
+                msg->msg.conn_start.dns_cached = 1;
+            } else
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 */
+            {
+                lwespi_send_string(msg->msg.conn_start.remote_host, 0, 1, 1);
             }
-            lwespi_send_string(msg->msg.conn_start.remote_host, 0, 1, 1);
             lwespi_send_port(msg->msg.conn_start.remote_port, 0, 1);
 
             /* Connection-type specific features */
@@ -2108,7 +4449,16 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
 #endif /* LWESP_CFG_MODE_STATION */
 
         case LWESP_CMD_TCPIP_CIPCLOSE: {        /* Close the connection */
-            lwesp_conn_p c = msg->msg.conn_close.conn;
+            lwesp_conn_p c;
+#if LWESP_CFG_CONN_PASSTHROUGH
+            if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPMODE) || CMD_IS_DEF(LWESP_CMD_TCPIP_PASSTHROUGH_EXIT)) {
+                AT_PORT_SEND_BEGIN_AT();        /* Single connection mode has no link ID */
+                AT_PORT_SEND_CONST_STR("+CIPCLOSE");
+                AT_PORT_SEND_END_AT();
+                break;
+            }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
+            c = msg->msg.conn_close.conn;
             if (c != NULL &&
                 /*
                  * Is connection already closed or command
@@ -2117,9 +4467,15 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
                 (!lwesp_conn_is_active(c) || c->val_id != msg->msg.conn_close.val_id)) {
                 return lwespERR;
             }
+            if (c == NULL && msg->i == 0 && msg->msg.conn_close.num != LWESPI_CONN_CLOSE_ALL_ID) {
+                if (conn_close_many_next(msg, 0) == LWESP_CFG_MAX_CONNS) {
+                    return lwespCLOSED;         /* All connections were closed while waiting in queue */
+                }
+                msg->msg.conn_close.num = conn_close_many_first(msg);
+            }
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CIPCLOSE=");
-            lwespi_send_number(LWESP_U32(msg->msg.conn_close.conn ? msg->msg.conn_close.conn->num : LWESP_CFG_MAX_CONNS), 0, 0);
+            lwespi_send_number(LWESP_U32(c != NULL ? c->num : msg->msg.conn_close.num), 0, 0);
             AT_PORT_SEND_END_AT();
             break;
         }
@@ -2127,60 +4483,123 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
             return lwespi_tcpip_process_send_data();/* Process send data */
         }
         case LWESP_CMD_TCPIP_CIPSTATUS: {       /* Get status of device and all connections */
-            esp.m.active_conns_last = esp.m.active_conns;   /* Save as last status */
-            esp.m.active_conns = 0;             /* Reset new status before parsing starts */
+            LWESP_MEMCPY(esp.m.active_conns_last, esp.m.active_conns, sizeof(esp.m.active_conns_last)); /* Save as last status */
+            LWESP_MEMSET(esp.m.active_conns, 0x00, sizeof(esp.m.active_conns)); /* Reset new status before parsing starts */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CIPSTATUS");
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWESP_CMD_TCPIP_CIPDINFO: {        /* Set info data on +IPD command */
+        case LWESP_CMD_TCPIP_CIPMUX: {          /* Set multiple connections */
+            AT_PORT_SEND_BEGIN_AT();
+#if LWESP_CFG_CONN_PASSTHROUGH
+            if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPMODE) && msg->msg.conn_start.passthrough) {
+                AT_PORT_SEND_CONST_STR("+CIPMUX=0");/* Passthrough requires single connection */
+            } else
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
+            {
+                AT_PORT_SEND_CONST_STR("+CIPMUX=1");
+            }
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+#if LWESP_CFG_CONN_PASSTHROUGH
+        case LWESP_CMD_TCPIP_CIPMODE: {         /* Set transmission mode */
             AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPDINFO=1");
+            AT_PORT_SEND_CONST_STR("+CIPMODE=");
+            lwespi_send_number(LWESP_U32(CMD_IS_DEF(LWESP_CMD_TCPIP_CIPMODE) && msg->msg.conn_start.passthrough), 0, 0);
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWESP_CMD_TCPIP_CIPMUX: {          /* Set multiple connections */
+        case LWESP_CMD_TCPIP_PASSTHROUGH_EXIT: {/* Exit passthrough mode */
+            /*
+             * Exit sequence must be surrounded by silent period on AT port.
+             * Core is unlocked during guard time, so that other threads
+             * and received data processing are not blocked by it.
+             * Raw sends from other threads are refused meanwhile
+             */
+            esp.m.passthrough_exit = 1;
+            lwesp_core_unlock();
+            lwesp_delay(LWESP_CFG_CONN_PASSTHROUGH_GUARD_TIME);
+            lwesp_core_lock();
+            AT_PORT_SEND_WITH_FLUSH("+++", 3);
+            lwesp_core_unlock();
+            lwesp_delay(LWESP_CFG_CONN_PASSTHROUGH_GUARD_TIME);
+            lwesp_core_lock();
+            esp.m.passthrough = 0;              /* Device is back in command mode */
+            esp.m.passthrough_exit = 0;
+
             AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPMUX=1");
+            AT_PORT_SEND_CONST_STR("+CIPMODE=0");
             AT_PORT_SEND_END_AT();
             break;
         }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
         case LWESP_CMD_TCPIP_CIPSSLSIZE: {      /* Set SSL size */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CIPSSLSIZE=");
-            lwespi_send_number(LWESP_U32(msg->msg.tcpip_sslsize.size), 0, 0);
+            if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPSTART)) {
+                lwespi_send_number(LWESP_U32(msg->msg.conn_start.ssl_buff_size), 0, 0);
+            } else {
+                lwespi_send_number(LWESP_U32(msg->msg.tcpip_sslsize.size), 0, 0);
+            }
             AT_PORT_SEND_END_AT();
             break;
         }
         case LWESP_CMD_TCPIP_CIPSSLCCONF: {     /* Set SSL Configuration */
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CIPSSLCCONF=");
-            lwespi_send_number(LWESP_U32(msg->msg.tcpip_ssl_cfg.link_id), 0, 0);
-            lwespi_send_number(LWESP_U32(msg->msg.tcpip_ssl_cfg.auth_mode), 0, 1);
-            lwespi_send_number(LWESP_U32(msg->msg.tcpip_ssl_cfg.pki_number), 0, 1);
-            lwespi_send_number(LWESP_U32(msg->msg.tcpip_ssl_cfg.ca_number), 0, 1);
+#if LWESP_CFG_MODE_STATION
+            if (CMD_IS_DEF(LWESP_CMD_TCPIP_CIPSTART)) { /* Configuration of link about to be started */
+                lwesp_conn_t* c = conn_start_get_free(msg);
+
+                if (c == NULL) {
+                    lwespi_send_conn_error_cb(msg, lwespERRNOFREECONN);
+                    return lwespERRNOFREECONN;
+                }
+                lwespi_send_number(LWESP_U32(c->num), 0, 0);
+                lwespi_send_number(LWESP_U32(msg->msg.conn_start.ssl_auth_mode), 0, 1);
+                lwespi_send_number(LWESP_U32(msg->msg.conn_start.ssl_pki_number), 0, 1);
+                lwespi_send_number(LWESP_U32(msg->msg.conn_start.ssl_ca_number), 0, 1);
+            } else
+#endif /* LWESP_CFG_MODE_STATION */
+            {
+                lwespi_send_number(LWESP_U32(msg->msg.tcpip_ssl_cfg.link_id), 0, 0);
+                lwespi_send_number(LWESP_U32(msg->msg.tcpip_ssl_cfg.auth_mode), 0, 1);
+                lwespi_send_number(LWESP_U32(msg->msg.tcpip_ssl_cfg.pki_number), 0, 1);
+                lwespi_send_number(LWESP_U32(msg->msg.tcpip_ssl_cfg.ca_number), 0, 1);
+            }
             AT_PORT_SEND_END_AT();
             break;
         }
-#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
-        case LWESP_CMD_TCPIP_CIPRECVMODE: {     /* Set TCP data receive mode */
+#if LWESP_CFG_MODE_STATION
+        case LWESP_CMD_TCPIP_CIPSSLCSNI: {      /* Set SSL server name indication */
+            lwesp_conn_t* c = conn_start_get_free(msg);
+
+            if (c == NULL) {
+                lwespi_send_conn_error_cb(msg, lwespERRNOFREECONN);
+                return lwespERRNOFREECONN;
+            }
             AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPRECVMODE=1");
+            AT_PORT_SEND_CONST_STR("+CIPSSLCSNI=");
+            lwespi_send_number(LWESP_U32(c->num), 0, 0);
+            lwespi_send_string(msg->msg.conn_start.ssl_sni, 1, 1, 1);
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWESP_CMD_TCPIP_CIPRECVDATA: {     /* Manually read data */
+#endif /* LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+        case LWESP_CMD_TCPIP_CIPRECVMODE: {     /* Set receive mode, automatic on reset */
             AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPRECVDATA=");
-            lwespi_send_number(LWESP_U32(msg->msg.ciprecvdata.conn->num), 0, 0);
-            lwespi_send_number(LWESP_U32(msg->msg.ciprecvdata.len), 0, 1);
+            AT_PORT_SEND_CONST_STR("+CIPRECVMODE=");
+            lwespi_send_number(LWESP_U32(CMD_IS_DEF(LWESP_CMD_TCPIP_CIPRECVMODE) ? msg->msg.ciprecvmode.manual : 0), 0, 0);
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWESP_CMD_TCPIP_CIPRECVLEN: {      /* Get length to read */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPRECVLEN?");
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+        case LWESP_CMD_TCPIP_CIPRECVDATA: {     /* Manually read data */
+            AT_PORT_SEND_CONN_DATA_CMD("+CIPRECVDATA=", msg->msg.ciprecvdata.conn->num, msg->msg.ciprecvdata.len);
             AT_PORT_SEND_END_AT();
             break;
         }
@@ -2208,12 +4627,6 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWESP_CMD_TCPIP_CIPDNS_GET: {      /* DNS get config */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPDNS?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
 #endif /* LWESP_CFG_DNS */
 #if LWESP_CFG_PING
         case LWESP_CMD_TCPIP_PING: {            /* Ping hostname or IP address */
@@ -2242,35 +4655,7 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
-        case LWESP_CMD_TCPIP_CIPSNTPTIME: {     /* Get time over SNTP */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CIPSNTPTIME?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
 #endif /* LWESP_CFG_SNTP */
-#if LWESP_CFG_SMART
-        case LWESP_CMD_WIFI_SMART_START: {      /* Start smart config */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CWSTARTSMART");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-        case LWESP_CMD_WIFI_SMART_STOP: {       /* Stop smart config */
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+CWSTOPSMART");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-#endif /* LWESP_CFG_SMART */
-#if LWESP_CFG_ESP32
-        case LWESP_CMD_BLEINIT_GET: {
-            AT_PORT_SEND_BEGIN_AT();
-            AT_PORT_SEND_CONST_STR("+BLEINIT?");
-            AT_PORT_SEND_END_AT();
-            break;
-        }
-#endif /* LWESP_CFG_ESP32 */
 
         default:
             return lwespERR;                    /* Invalid command */
@@ -2285,14 +4670,130 @@ lwespi_initiate_cmd(lwesp_msg_t* msg) {
  */
 uint8_t
 lwespi_is_valid_conn_ptr(lwesp_conn_p conn) {
-    for (size_t i = 0; i < LWESP_ARRAYSIZE(esp.m.conns); ++i) {
-        if (conn == &esp.m.conns[i]) {
-            return 1;
+    const uint8_t* p = (const uint8_t*)conn;
+    const uint8_t* s = (const uint8_t*)esp.m.conns;
+
+    /* Connections are members of single array, address must be aligned to one of them */
+    return p >= s && p < (const uint8_t*)&esp.m.conns[LWESP_ARRAYSIZE(esp.m.conns)]
+           && ((size_t)(p - s) % sizeof(esp.m.conns[0])) == 0;
+}
+
+#if LWESP_CFG_MSG_POOL_SIZE > 0 || LWESP_CFG_MSG_POOL_SMALL_SIZE > 0 || __DOXYGEN__
+
+#if LWESP_CFG_MSG_POOL_SIZE > 0
+static lwesp_msg_t msg_pool[LWESP_CFG_MSG_POOL_SIZE];
+static lwesp_msg_t* msg_pool_free[LWESP_CFG_MSG_POOL_SIZE];
+static size_t msg_pool_free_cnt;
+#endif /* LWESP_CFG_MSG_POOL_SIZE > 0 */
+#if LWESP_CFG_MSG_POOL_SMALL_SIZE > 0
+
+#define MSG_SMALL_SIZE                      (offsetof(lwesp_msg_t, msg) + LWESP_CFG_MSG_SMALL_PAYLOAD_LEN)
+
+/* Compact message storage, aligned for message header */
+typedef union {
+    uint8_t data[MSG_SMALL_SIZE];
+    uint64_t align_u64;
+    void* align_ptr;
+} msg_small_t;
+
+static msg_small_t msg_small_pool[LWESP_CFG_MSG_POOL_SMALL_SIZE];
+static lwesp_msg_t* msg_small_free[LWESP_CFG_MSG_POOL_SMALL_SIZE];
+static size_t msg_small_free_cnt;
+#endif /* LWESP_CFG_MSG_POOL_SMALL_SIZE > 0 */
+static uint8_t msg_pool_initialized;
+
+/**
+ * \brief           Allocate new message object, from pool if available
+ *
+ * Message with payload up to \ref LWESP_CFG_MSG_SMALL_PAYLOAD_LEN bytes
+ * is taken from compact pool first, then from full message pool.
+ * Message is cleared to zero, except semaphore of pool message,
+ * which is created once and reused for all blocking calls
+ *
+ * \param[in]       size: Size of message including command payload, see \ref LWESP_MSG_SIZE
+ * \return          Pointer to message on success, `NULL` otherwise
+ */
+lwesp_msg_t*
+lwespi_msg_alloc(size_t size) {
+    lwesp_msg_t* msg = NULL;
+
+    lwesp_core_lock();
+    if (!msg_pool_initialized) {
+#if LWESP_CFG_MSG_POOL_SIZE > 0
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(msg_pool); ++i) {
+            lwesp_sys_sem_invalid(&msg_pool[i].sem);
+            msg_pool_free[i] = &msg_pool[i];
         }
+        msg_pool_free_cnt = LWESP_ARRAYSIZE(msg_pool);
+#endif /* LWESP_CFG_MSG_POOL_SIZE > 0 */
+#if LWESP_CFG_MSG_POOL_SMALL_SIZE > 0
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(msg_small_pool); ++i) {
+            msg_small_free[i] = (lwesp_msg_t*)&msg_small_pool[i];
+            lwesp_sys_sem_invalid(&msg_small_free[i]->sem);
+        }
+        msg_small_free_cnt = LWESP_ARRAYSIZE(msg_small_pool);
+#endif /* LWESP_CFG_MSG_POOL_SMALL_SIZE > 0 */
+        msg_pool_initialized = 1;
+    }
+#if LWESP_CFG_MSG_POOL_SMALL_SIZE > 0
+    if (size <= MSG_SMALL_SIZE && msg_small_free_cnt > 0) {
+        msg = msg_small_free[--msg_small_free_cnt];
+    }
+#endif /* LWESP_CFG_MSG_POOL_SMALL_SIZE > 0 */
+#if LWESP_CFG_MSG_POOL_SIZE > 0
+    if (msg == NULL && msg_pool_free_cnt > 0) {
+        msg = msg_pool_free[--msg_pool_free_cnt];
+    }
+#endif /* LWESP_CFG_MSG_POOL_SIZE > 0 */
+    lwesp_core_unlock();
+
+    if (msg != NULL) {
+        lwesp_sys_sem_t sem = msg->sem;         /* Keep semaphore for reuse */
+
+        LWESP_MEMSET(msg, 0x00, size);
+        msg->sem = sem;
+#if !LWESP_CFG_STATIC_ONLY
+    } else {
+        msg = lwesp_mem_malloc_tag(size, LWESP_MEM_TAG_MSG);/* Pool is empty, use heap */
+        if (msg != NULL) {
+            LWESP_MEMSET(msg, 0x00, size);
+        }
+#endif /* !LWESP_CFG_STATIC_ONLY */
+    }
+    return msg;
+}
+
+/**
+ * \brief           Free message object previously allocated with \ref lwespi_msg_alloc
+ * \param[in]       msg: Message to free
+ */
+void
+lwespi_msg_free(lwesp_msg_t* msg) {
+#if LWESP_CFG_MSG_POOL_SMALL_SIZE > 0
+    if ((void*)msg >= (void*)&msg_small_pool[0] && (void*)msg < (void*)&msg_small_pool[LWESP_ARRAYSIZE(msg_small_pool)]) {
+        lwesp_core_lock();
+        msg_small_free[msg_small_free_cnt++] = msg; /* Return to compact pool, keep semaphore */
+        lwesp_core_unlock();
+    } else
+#endif /* LWESP_CFG_MSG_POOL_SMALL_SIZE > 0 */
+#if LWESP_CFG_MSG_POOL_SIZE > 0
+    if (msg >= &msg_pool[0] && msg < &msg_pool[LWESP_ARRAYSIZE(msg_pool)]) {
+        lwesp_core_lock();
+        msg_pool_free[msg_pool_free_cnt++] = msg;   /* Return to pool, keep semaphore */
+        lwesp_core_unlock();
+    } else
+#endif /* LWESP_CFG_MSG_POOL_SIZE > 0 */
+    {
+        if (lwesp_sys_sem_isvalid(&msg->sem)) {
+            lwesp_sys_sem_delete(&msg->sem);
+            lwesp_sys_sem_invalid(&msg->sem);
+        }
+        lwesp_mem_free_s((void**)&msg);
     }
-    return 0;
 }
 
+#endif /* LWESP_CFG_MSG_POOL_SIZE > 0 || LWESP_CFG_MSG_POOL_SMALL_SIZE > 0 || __DOXYGEN__ */
+
 /**
  * \brief           Send message from API function to producer queue for further processing
  * \param[in]       msg: New message to process
@@ -2302,7 +4803,554 @@ lwespi_is_valid_conn_ptr(lwesp_conn_p conn) {
  */
 lwespr_t
 lwespi_send_msg_to_producer_mbox(lwesp_msg_t* msg, lwespr_t (*process_fn)(lwesp_msg_t*), uint32_t max_block_time) {
-    lwespr_t res = msg->res = lwespOK;
+    msg->res = lwespOK;
+    if (!msg->cmd) {                            /* Set start command if not set by user */
+        msg->cmd = msg->cmd_def;                /* Set it as default */
+    }
+    msg->block_time = max_block_time;           /* Set blocking status if necessary */
+    msg->fn = process_fn;                       /* Save processing function to be called as callback */
+
+    /* Batch is being recorded, append message instead of sending it */
+    lwesp_core_lock();
+    if (esp.batch != NULL) {
+        msg->is_blocking = 0;                   /* Batch completes at once, with last command */
+        if (esp.batch->last != NULL) {
+            esp.batch->last->batch_next = msg;
+        } else {
+            esp.batch->first = msg;
+        }
+        esp.batch->last = msg;
+        ++esp.batch->count;
+        lwesp_core_unlock();
+        return lwespOK;
+    }
+    lwesp_core_unlock();
+    return lwespi_send_batch_to_producer_mbox(msg, msg);
+}
+
+/**
+ * \brief           Free all messages in a batch, starting with input message
+ * \param[in]       msg: First message to free
+ */
+static void
+lwespi_batch_free(lwesp_msg_t* msg) {
+    lwesp_msg_t* next;
+
+    for (; msg != NULL; msg = next) {
+        next = msg->batch_next;
+        LWESP_MSG_VAR_FREE(msg);
+    }
+}
+
+#if LWESP_CFG_CMD_PRIORITY || __DOXYGEN__
+
+/**
+ * \brief           Get priority class for new message
+ * \param[in]       msg: Message to check
+ * \return          Member of \ref lwesp_cmd_prio_t enumeration
+ */
+static uint8_t
+lwespi_get_msg_prio(lwesp_msg_t* msg) {
+    lwesp_conn_t* conn = NULL;
+
+    switch (msg->cmd_def) {
+        case LWESP_CMD_TCPIP_CIPSEND:
+            conn = msg->msg.conn_send.conn;
+            break;
+        case LWESP_CMD_TCPIP_CIPCLOSE:
+            conn = msg->msg.conn_close.conn;
+            break;
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+        case LWESP_CMD_TCPIP_CIPRECVDATA:
+            conn = msg->msg.ciprecvdata.conn;
+            break;
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+#if LWESP_CFG_MODE_STATION
+        case LWESP_CMD_WIFI_CWLAP:
+#endif /* LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_PING
+        case LWESP_CMD_TCPIP_PING:
+#endif /* LWESP_CFG_PING */
+            return LWESP_CMD_PRIO_LOW;
+#if LWESP_CFG_DNS_CACHE_SIZE > 0
+        case LWESP_CMD_TCPIP_CIPDOMAIN:
+            if (msg->msg.dns_getbyhostname.hosts != NULL) {
+                return LWESP_CMD_PRIO_LOW;      /* Prefetch runs when nothing more urgent is queued */
+            }
+            break;
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 */
+        default:
+            break;
+    }
+    /* All commands of one connection share priority and remain in order */
+    return conn != NULL ? conn->prio : LWESP_CMD_PRIO_NORMAL;
+}
+
+/**
+ * \brief           Add message to the end of its priority lane
+ * \param[in]       msg: Message to add
+ */
+static void
+lwespi_prio_lane_push(lwesp_msg_t* msg) {
+    msg->prio_next = NULL;
+    if (esp.prio_last[msg->prio] != NULL) {
+        esp.prio_last[msg->prio]->prio_next = msg;
+    } else {
+        esp.prio_first[msg->prio] = msg;
+    }
+    esp.prio_last[msg->prio] = msg;
+}
+
+static void lwespi_prio_lane_add(lwesp_msg_t* msg);
+
+/**
+ * \brief           Move all messages from producer queue to scheduler
+ */
+static void
+lwespi_prio_lane_fetch(void) {
+    lwesp_msg_t* m;
+
+    while (lwesp_sys_mbox_getnow(&esp.mbox_producer, (void**)&m)) {
+        LWESPI_STATS_MBOX_READ(mbox_producer);
+        if (m != NULL) {
+            lwespi_prio_lane_add(m);
+        }
+    }
+}
+
+#if LWESP_CFG_CONN_SEND_FAIR || __DOXYGEN__
+
+/**
+ * \brief           Get connection of message, handled by fair scheduler
+ * \param[in]       msg: Message to check
+ * \return          Connection handle for send and close commands, `NULL` otherwise
+ */
+static lwesp_conn_t*
+lwespi_conn_sched_get_conn(lwesp_msg_t* msg) {
+    if (msg->cmd_def == LWESP_CMD_TCPIP_CIPSEND) {
+        return msg->msg.conn_send.conn;
+    } else if (msg->cmd_def == LWESP_CMD_TCPIP_CIPCLOSE) {
+        return msg->msg.conn_close.conn;
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Check if any priority lane holds message to start
+ * \return          `1` if message is waiting, `0` otherwise
+ */
+static uint8_t
+lwespi_prio_lane_is_pending(void) {
+    lwespi_prio_lane_fetch();                   /* Commands queued in the meantime compete for the same turn */
+    for (size_t i = 0; i < LWESP_CMD_PRIO_END; ++i) {
+        if (esp.prio_first[i] != NULL) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Charge sent chunk to connection turn and check
+ *                  if send command shall give up its turn before next `AT+CIPSEND` chunk
+ * \note            Function is called from processing thread while command is active,
+ *                  when producer thread does not access priority lanes
+ * \param[in]       msg: Active send message, after chunk was sent
+ * \return          `1` if message shall stop and continue later, `0` to send next chunk now
+ */
+uint8_t
+lwespi_conn_sched_yield(lwesp_msg_t* msg) {
+    lwespi_conn_sched_t* s = &esp.conn_sched[msg->msg.conn_send.conn->num];
+
+    if (!msg->sched) {
+        return 0;
+    }
+    s->deficit -= LWESP_MIN(s->deficit, msg->msg.conn_send.sent);
+    if (msg->msg.conn_send.btw == 0             /* Command is finished anyway */
+        || s->deficit >= LWESP_MIN(msg->msg.conn_send.btw, LWESPI_CONN_MAX_DATA_LEN())
+        || !lwespi_prio_lane_is_pending()) {
+        return 0;
+    }
+    msg->msg.conn_send.yield = 1;
+    return 1;
+}
+
+/**
+ * \brief           Put send message, which gave up its turn, back to its priority lane
+ * \note            Function must be called from producer thread
+ * \param[in]       msg: Finished message
+ * \return          `1` if message was queued again and may not be released, `0` otherwise
+ */
+uint8_t
+lwespi_conn_sched_requeue(lwesp_msg_t* msg) {
+    if (msg->cmd_def != LWESP_CMD_TCPIP_CIPSEND || !msg->msg.conn_send.yield) {
+        return 0;
+    }
+    msg->msg.conn_send.yield = 0;
+    msg->cmd = msg->cmd_def;                    /* Start from beginning in next turn */
+#if LWESP_CFG_CMD_CANCEL
+    msg->deadline = 0;                          /* Command has started already */
+#endif /* LWESP_CFG_CMD_CANCEL */
+    lwespi_prio_lane_push(msg);                 /* Connection keeps its place, behind others */
+    return 1;
+}
+
+/**
+ * \brief           Release turn of connection, when its command has finished
+ *
+ * Next waiting command of the connection is moved to its priority lane.
+ * It continues current turn if remaining quantum covers its first chunk,
+ * otherwise it waits behind all other commands
+ *
+ * \note            Function must be called from producer thread
+ * \param[in]       msg: Finished message
+ */
+void
+lwespi_conn_sched_release(lwesp_msg_t* msg) {
+    lwespi_conn_sched_t* s;
+    lwesp_msg_t* n;
+    size_t cost = 0;
+
+    if (!msg->sched) {
+        return;
+    }
+    msg->sched = 0;
+    s = &esp.conn_sched[lwespi_conn_sched_get_conn(msg)->num];
+    if ((n = s->first) == NULL) {               /* Nothing more to send on connection */
+        s->busy = 0;
+        s->deficit = 0;
+        return;
+    }
+    s->first = n->prio_next;
+    if (s->first == NULL) {
+        s->last = NULL;
+    }
+    n->sched = 1;
+    if (n->cmd_def == LWESP_CMD_TCPIP_CIPSEND) {
+        cost = LWESP_MIN(n->msg.conn_send.btw, LWESPI_CONN_MAX_DATA_LEN());
+    }
+    if (s->deficit > 0 && s->deficit >= cost) {
+        s->cont = 1;                            /* Start it next, turn is not over yet */
+        n->prio_next = esp.prio_first[n->prio];
+        esp.prio_first[n->prio] = n;
+        if (esp.prio_last[n->prio] == NULL) {
+            esp.prio_last[n->prio] = n;
+        }
+    } else {
+        lwespi_prio_lane_fetch();               /* Commands queued during this turn go first */
+        lwespi_prio_lane_push(n);
+    }
+}
+
+#endif /* LWESP_CFG_CONN_SEND_FAIR || __DOXYGEN__ */
+
+/**
+ * \brief           Add new message to scheduler
+ *
+ * With fair scheduler, only one command per connection is in priority lane,
+ * others wait in connection queue and keep their order
+ *
+ * \param[in]       msg: Message to add
+ */
+static void
+lwespi_prio_lane_add(lwesp_msg_t* msg) {
+#if LWESP_CFG_CONN_SEND_FAIR
+    lwesp_conn_t* conn = lwespi_conn_sched_get_conn(msg);
+
+    if (conn != NULL) {
+        lwespi_conn_sched_t* s = &esp.conn_sched[conn->num];
+
+        if (s->busy) {                          /* Wait for current command of connection */
+            msg->prio_next = NULL;
+            if (s->last != NULL) {
+                s->last->prio_next = msg;
+            } else {
+                s->first = msg;
+            }
+            s->last = msg;
+            return;
+        }
+        s->busy = 1;
+        msg->sched = 1;
+    }
+#endif /* LWESP_CFG_CONN_SEND_FAIR */
+    lwespi_prio_lane_push(msg);
+}
+
+#endif /* LWESP_CFG_CMD_PRIORITY || __DOXYGEN__ */
+
+/**
+ * \brief           Get next message to start from producer queue
+ *
+ * When command priorities are enabled, all queued messages are moved
+ * to priority lanes first and message from highest non-empty lane is returned
+ *
+ * \note            Function must be called from producer thread only
+ * \param[out]      msg: Pointer to save message to
+ * \param[in]       block: Set to `1` to wait for new message, `0` to return immediately
+ * \return          `1` if message is available, `0` otherwise
+ */
+uint8_t
+lwespi_get_producer_msg(lwesp_msg_t** msg, uint8_t block) {
+#if LWESP_CFG_CMD_PRIORITY
+    static const uint8_t order[] = {LWESP_CMD_PRIO_HIGH, LWESP_CMD_PRIO_NORMAL, LWESP_CMD_PRIO_LOW};
+    lwesp_msg_t* m;
+
+    lwespi_prio_lane_fetch();                   /* Move all queued messages to lanes */
+    while (1) {
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(order); ++i) {
+            if ((m = esp.prio_first[order[i]]) != NULL) {
+                esp.prio_first[order[i]] = m->prio_next;
+                if (m->prio_next == NULL) {
+                    esp.prio_last[order[i]] = NULL;
+                }
+#if LWESP_CFG_CONN_SEND_FAIR
+                if (m->sched) {                 /* New turn of connection gets new quantum */
+                    lwespi_conn_sched_t* s = &esp.conn_sched[lwespi_conn_sched_get_conn(m)->num];
+                    if (s->cont) {
+                        s->cont = 0;
+                    } else {
+                        s->deficit += LWESP_CFG_CONN_SEND_FAIR_QUANTUM;
+                    }
+                }
+#endif /* LWESP_CFG_CONN_SEND_FAIR */
+                *msg = m;
+                return 1;
+            }
+        }
+        if (!block) {
+            return 0;
+        }
+        if (lwesp_sys_mbox_get(&esp.mbox_producer, (void**)&m, 0) != LWESP_SYS_TIMEOUT) {
+            LWESPI_STATS_MBOX_READ(mbox_producer);
+            if (m != NULL) {
+                lwespi_prio_lane_add(m);
+            }
+        }
+    }
+#else /* LWESP_CFG_CMD_PRIORITY */
+    if (block) {
+        uint32_t time;
+        do {
+            time = lwesp_sys_mbox_get(&esp.mbox_producer, (void**)msg, 0);
+            if (time != LWESP_SYS_TIMEOUT) {
+                LWESPI_STATS_MBOX_READ(mbox_producer);
+            }
+        } while (time == LWESP_SYS_TIMEOUT || *msg == NULL);
+        return 1;
+    }
+    if (!lwesp_sys_mbox_getnow(&esp.mbox_producer, (void**)msg)) {
+        return 0;
+    }
+    LWESPI_STATS_MBOX_READ(mbox_producer);
+    return *msg != NULL;
+#endif /* !LWESP_CFG_CMD_PRIORITY */
+}
+
+/**
+ * \brief           Check if message taken from producer queue may still be started
+ *
+ * Messages for connections closed in the meantime, expired
+ * and cancelled messages fail without being sent to device
+ *
+ * \note            Function must be called from producer thread with core locked
+ * \param[in]       msg: Message to check
+ * \return          \ref lwespOK if message may start, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwespi_check_msg_start(lwesp_msg_t* msg) {
+    lwesp_conn_t* c;
+
+#if LWESP_CFG_CMD_CANCEL
+    if (msg->cmd_id != 0) {
+        for (size_t i = 0; i < LWESP_CFG_CMD_CANCEL_SLOTS; ++i) {
+            if (esp.cmd_cancel[i] == msg->cmd_id) {
+                esp.cmd_cancel[i] = 0;          /* Rest of batch fails with the same error */
+                return lwespERRCANCELLED;
+            }
+        }
+    }
+    if (msg->deadline != 0 && (int32_t)(lwesp_sys_now() - msg->deadline) >= 0) {
+        return lwespTIMEOUT;                    /* Waited too long in queue */
+    }
+#endif /* LWESP_CFG_CMD_CANCEL */
+
+    /* Purge commands for connections, closed while waiting in queue */
+    if (msg->cmd_def == LWESP_CMD_TCPIP_CIPSEND) {
+        c = msg->msg.conn_send.conn;
+        if (!lwesp_conn_is_active(c) || c->val_id != msg->msg.conn_send.val_id) {
+            return lwespCLOSED;
+        }
+    } else if (msg->cmd_def == LWESP_CMD_TCPIP_CIPCLOSE) {
+        c = msg->msg.conn_close.conn;
+        if (c != NULL && (!lwesp_conn_is_active(c) || c->val_id != msg->msg.conn_close.val_id)) {
+            return lwespCLOSED;
+        }
+    }
+    return lwespOK;
+}
+
+#if LWESP_CFG_CMD_SINGLE_FLIGHT || __DOXYGEN__
+
+/**
+ * \brief           Check if message is idempotent query, that may be merged with identical one
+ * \param[in]       msg: Message to check
+ * \return          `1` if mergeable, `0` otherwise
+ */
+static uint8_t
+lwespi_cmd_sf_is_query(lwesp_msg_t* msg) {
+    switch (msg->cmd_def) {
+#if LWESP_CFG_MODE_STATION
+        case LWESP_CMD_WIFI_CIPSTA_GET:
+        case LWESP_CMD_WIFI_CWJAP_GET:
+#endif /* LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_MODE_ACCESS_POINT
+        case LWESP_CMD_WIFI_CIPAP_GET:
+#endif /* LWESP_CFG_MODE_ACCESS_POINT */
+        case LWESP_CMD_TCPIP_CIPSTATUS:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * \brief           Attach query to identical query already queued or running
+ *
+ * When there is no such query, message is registered as running query instead
+ *
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Query message to attach
+ * \return          `1` if message waits for another query, `0` if it must be sent to producer queue
+ */
+static uint8_t
+lwespi_cmd_sf_attach(lwesp_msg_t* msg) {
+    lwesp_msg_t** w;
+
+    msg->sf_next = NULL;
+    msg->sf_waiters = NULL;
+    for (lwesp_msg_t* m = esp.sf_msgs; m != NULL; m = m->sf_next) {
+        if (m->cmd_def == msg->cmd_def && m->cmd == msg->cmd) {
+            for (w = &m->sf_waiters; *w != NULL; w = &(*w)->sf_next) {}
+            *w = msg;                           /* Waiters finish in order of arrival */
+            return 1;
+        }
+    }
+    msg->sf_next = esp.sf_msgs;
+    esp.sf_msgs = msg;
+    return 0;
+}
+
+/**
+ * \brief           Remove query from list of running queries
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Query message to remove
+ * \return          `1` if message was in the list, `0` otherwise
+ */
+static uint8_t
+lwespi_cmd_sf_remove(lwesp_msg_t* msg) {
+    for (lwesp_msg_t** m = &esp.sf_msgs; *m != NULL; m = &(*m)->sf_next) {
+        if (*m == msg) {
+            *m = msg->sf_next;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Detach waiters from finished query and give them its result
+ *
+ * Output data of query is copied to variables of each waiter.
+ * Caller then completes each of returned messages, linked with `sf_next`
+ *
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Finished query message
+ * \return          First waiting message or `NULL` if there is none
+ */
+lwesp_msg_t*
+lwespi_cmd_sf_release(lwesp_msg_t* msg) {
+    lwesp_msg_t* waiters;
+
+    if (!lwespi_cmd_sf_is_query(msg) || !lwespi_cmd_sf_remove(msg)) {
+        return NULL;
+    }
+    waiters = msg->sf_waiters;
+    msg->sf_waiters = NULL;
+    for (lwesp_msg_t* w = waiters; w != NULL; w = w->sf_next) {
+        w->res = msg->res;
+        if (msg->res != lwespOK) {
+            continue;
+        }
+        switch (msg->cmd_def) {
+#if LWESP_CFG_MODE_STATION
+            case LWESP_CMD_WIFI_CWJAP_GET:
+                if (w->msg.sta_info_ap.info != msg->msg.sta_info_ap.info) {
+                    LWESP_MEMCPY(w->msg.sta_info_ap.info, msg->msg.sta_info_ap.info, sizeof(*w->msg.sta_info_ap.info));
+                }
+                break;
+#endif /* LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_MODE_STATION || LWESP_CFG_MODE_ACCESS_POINT
+#if LWESP_CFG_MODE_STATION
+            case LWESP_CMD_WIFI_CIPSTA_GET:
+#endif /* LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_MODE_ACCESS_POINT
+            case LWESP_CMD_WIFI_CIPAP_GET:
+#endif /* LWESP_CFG_MODE_ACCESS_POINT */
+            {
+                lwesp_ip_mac_t* im = NULL;
+#if LWESP_CFG_MODE_STATION
+                if (msg->cmd_def == LWESP_CMD_WIFI_CIPSTA_GET) {
+                    im = &esp.m.sta;
+                }
+#endif /* LWESP_CFG_MODE_STATION */
+#if LWESP_CFG_MODE_ACCESS_POINT
+                if (msg->cmd_def == LWESP_CMD_WIFI_CIPAP_GET) {
+                    im = &esp.m.ap;
+                }
+#endif /* LWESP_CFG_MODE_ACCESS_POINT */
+                if (im == NULL) {
+                    break;
+                }
+                if (w->msg.sta_ap_getip.ip != NULL) {
+                    LWESP_MEMCPY(w->msg.sta_ap_getip.ip, &im->ip, sizeof(im->ip));
+                }
+                if (w->msg.sta_ap_getip.gw != NULL) {
+                    LWESP_MEMCPY(w->msg.sta_ap_getip.gw, &im->gw, sizeof(im->gw));
+                }
+                if (w->msg.sta_ap_getip.nm != NULL) {
+                    LWESP_MEMCPY(w->msg.sta_ap_getip.nm, &im->nm, sizeof(im->nm));
+                }
+                break;
+            }
+#endif /* LWESP_CFG_MODE_STATION || LWESP_CFG_MODE_ACCESS_POINT */
+            default:
+                break;
+        }
+    }
+    return waiters;
+}
+
+#endif /* LWESP_CFG_CMD_SINGLE_FLIGHT || __DOXYGEN__ */
+
+/**
+ * \brief           Send chain of messages to producer queue for back-to-back processing
+ *
+ * Only first message is written to producer queue, others are linked with `batch_next`.
+ * Last message holds blocking status and is the one reporting completion
+ *
+ * \note            Message command, block time and process function must already be set
+ * \param[in]       first: First message in chain
+ * \param[in]       last: Last message in chain. Set to `first` for single message
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwespi_send_batch_to_producer_mbox(lwesp_msg_t* first, lwesp_msg_t* last) {
+    lwesp_msg_t* msg = last;
+    lwespr_t res = lwespOK;
+#if LWESP_CFG_CMD_SINGLE_FLIGHT
+    uint8_t sf = first == last && lwespi_cmd_sf_is_query(first), sf_wait = 0;
+#endif /* LWESP_CFG_CMD_SINGLE_FLIGHT */
 
     /* Check here if stack is even enabled or shall we disable new command entry? */
     lwesp_core_lock();
@@ -2314,34 +5362,100 @@ lwespi_send_msg_to_producer_mbox(lwesp_msg_t* msg, lwespr_t (*process_fn)(lwesp_
     if (res == lwespOK && !esp.status.f.dev_present) {
         res = lwespERRNODEVICE;                 /* No device connected */
     }
+#if LWESP_CFG_CONN_PASSTHROUGH
+    /* AT commands cannot be sent while device is in passthrough mode */
+    if (res == lwespOK && esp.m.passthrough && first->cmd_def != LWESP_CMD_TCPIP_PASSTHROUGH_EXIT) {
+        res = lwespERR;
+    }
+#endif /* LWESP_CFG_CONN_PASSTHROUGH */
     lwesp_core_unlock();
     if (res != lwespOK) {
-        LWESP_MSG_VAR_FREE(msg);                /* Free memory and return */
+        lwespi_batch_free(first);               /* Free memory and return */
         return res;
     }
 
+#if !LWESP_CFG_POLL
     if (msg->is_blocking) {                     /* In case message is blocking */
-        if (!lwesp_sys_sem_create(&msg->sem, 0)) {  /* Create semaphore and lock it immediately */
-            LWESP_MSG_VAR_FREE(msg);            /* Release memory and return */
+#if LWESP_CFG_SYS_THREAD_NOTIFY
+        if (!lwesp_sys_thread_notify_get(&msg->notify)) {   /* Completion is signalled to calling thread */
+#else /* LWESP_CFG_SYS_THREAD_NOTIFY */
+        if (!lwesp_sys_sem_isvalid(&msg->sem)   /* Pool messages may already have semaphore */
+            && !lwesp_sys_sem_create(&msg->sem, 0)) {   /* Create semaphore and lock it immediately */
+#endif /* !LWESP_CFG_SYS_THREAD_NOTIFY */
+            lwespi_batch_free(first);           /* Release memory and return */
             return lwespERRMEM;
         }
     }
-    if (!msg->cmd) {                            /* Set start command if not set by user */
-        msg->cmd = msg->cmd_def;                /* Set it as default */
+#endif /* !LWESP_CFG_POLL */
+#if LWESP_CFG_STATS
+    for (lwesp_msg_t* m = first; m != NULL; m = m->batch_next) {
+        LWESPI_STATS_CMD_ENQUEUE(m);
     }
-    msg->block_time = max_block_time;           /* Set blocking status if necessary */
-    msg->fn = process_fn;                       /* Save processing function to be called as callback */
-    if (msg->is_blocking) {
-        lwesp_sys_mbox_put(&esp.mbox_producer, msg);/* Write message to producer queue and wait forever */
-    } else {
-        if (!lwesp_sys_mbox_putnow(&esp.mbox_producer, msg)) {  /* Write message to producer queue immediately */
-            LWESP_MSG_VAR_FREE(msg);            /* Release message */
-            return lwespERRMEM;
+#endif /* LWESP_CFG_STATS */
+#if LWESP_CFG_CMD_PRIORITY
+    first->prio = lwespi_get_msg_prio(first);   /* Batch is started as one unit */
+#endif /* LWESP_CFG_CMD_PRIORITY */
+#if LWESP_CFG_CMD_CANCEL && LWESP_CFG_CMD_QUEUE_TIMEOUT > 0
+    if (first->deadline == 0) {
+        first->deadline = lwesp_sys_now() + LWESP_CFG_CMD_QUEUE_TIMEOUT;
+        if (first->deadline == 0) {
+            first->deadline = 1;                /* `0` means no deadline */
+        }
+    }
+#endif /* LWESP_CFG_CMD_CANCEL && LWESP_CFG_CMD_QUEUE_TIMEOUT > 0 */
+#if LWESP_CFG_CMD_SINGLE_FLIGHT
+    /*
+     * Core stays locked until non-blocking query is written to queue,
+     * so no new waiter attaches to query that fails to be written
+     */
+    if (sf) {
+        lwesp_core_lock();
+        sf_wait = lwespi_cmd_sf_attach(first);  /* Identical query already queued or running? */
+        if (sf_wait || msg->is_blocking) {
+            lwesp_core_unlock();
+            sf = 0;
         }
     }
+    if (!sf_wait)
+#endif /* LWESP_CFG_CMD_SINGLE_FLIGHT */
+    {
+        LWESPI_STATS_MBOX_WRITE(mbox_producer, LWESP_CFG_THREAD_PRODUCER_MBOX_SIZE);
+#if !LWESP_CFG_POLL
+        if (msg->is_blocking) {
+            lwesp_sys_mbox_put(&esp.mbox_producer, first);  /* Write message to producer queue and wait forever */
+        } else
+#endif /* !LWESP_CFG_POLL */
+        {
+            if (!lwesp_sys_mbox_putnow(&esp.mbox_producer, first)) {/* Write message to producer queue immediately */
+                LWESPI_STATS_MBOX_WRITE_FAIL(mbox_producer);
+#if LWESP_CFG_CMD_SINGLE_FLIGHT
+                if (sf) {
+                    lwespi_cmd_sf_remove(first);/* Query did not start, nobody waits for it */
+                    lwesp_core_unlock();
+                }
+#endif /* LWESP_CFG_CMD_SINGLE_FLIGHT */
+                lwespi_batch_free(first);       /* Release message */
+                return lwespERRMEM;
+            }
+        }
+#if LWESP_CFG_CMD_SINGLE_FLIGHT
+        if (sf) {
+            lwesp_core_unlock();
+        }
+#endif /* LWESP_CFG_CMD_SINGLE_FLIGHT */
+    }
     if (res == lwespOK && msg->is_blocking) {   /* In case we have blocking request */
         uint32_t time;
+#if LWESP_CFG_POLL
+        while (!msg->poll_done) {               /* Run the stack until command finishes */
+            lwesp_poll();
+        }
+        time = 0;
+#elif LWESP_CFG_SYS_THREAD_NOTIFY
+        time = lwesp_sys_thread_notify_wait(0); /* Wait forever for notification */
+#else /* LWESP_CFG_SYS_THREAD_NOTIFY */
         time = lwesp_sys_sem_wait(&msg->sem, 0);/* Wait forever for semaphore */
+#endif /* !LWESP_CFG_SYS_THREAD_NOTIFY */
         if (time == LWESP_SYS_TIMEOUT) {        /* If semaphore was not accessed within given time */
             res = lwespTIMEOUT;                 /* Semaphore not released in time */
         } else {
@@ -2421,6 +5535,11 @@ lwespi_process_events_for_timeout_or_error(lwesp_msg_t* msg, lwespr_t err) {
 #if LWESP_CFG_DNS
         case LWESP_CMD_TCPIP_CIPDOMAIN: {
             /* DNS error */
+#if LWESP_CFG_DNS_CACHE_SIZE > 0
+            if (msg->msg.dns_getbyhostname.hosts != NULL) {
+                break;                          /* Prefetch has no event */
+            }
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 */
             CIPDOMAIN_SEND_EVT(msg, err);
             break;
         }
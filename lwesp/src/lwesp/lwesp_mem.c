@@ -32,15 +32,387 @@
  * Version:         $_version_$
  */
 #include <limits.h>
+#include <stddef.h>
 #include "lwesp/lwesp_private.h"
 #include "lwesp/lwesp_mem.h"
 
 #if !LWESP_CFG_MEM_CUSTOM || __DOXYGEN__
 
+#if LWESP_CFG_MEM_PLACEMENT || __DOXYGEN__
+
+/**
+ * \brief           Address range of fast memory region
+ */
+typedef struct {
+    const uint8_t* start;                       /*!< Start address of region */
+    const uint8_t* end;                         /*!< End address of region, first address not in region */
+} mem_fast_region_t;
+
+static mem_fast_region_t mem_fast_regions[LWESP_CFG_MEM_PLACEMENT_FAST_REGIONS];/*!< Fast memory regions */
+static size_t mem_fast_regions_cnt;             /*!< Number of valid entries in fast regions array */
+
+/**
+ * \brief           Check if memory address belongs to fast region
+ * \param[in]       addr: Address to check
+ * \return          `1` if address is in fast region, `0` otherwise
+ */
+static uint8_t
+mem_is_fast(const void* addr) {
+    const uint8_t* a = addr;
+
+    for (size_t i = 0; i < mem_fast_regions_cnt; ++i) {
+        if (a >= mem_fast_regions[i].start && a < mem_fast_regions[i].end) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Check if block is placed in requested memory type */
+#define MEM_BLOCK_PLACE_OK(b, fast)         (mem_is_fast(b) == (fast))
+#else /* LWESP_CFG_MEM_PLACEMENT || __DOXYGEN__ */
+#define MEM_BLOCK_PLACE_OK(b, fast)         1
+#endif /* !(LWESP_CFG_MEM_PLACEMENT || __DOXYGEN__) */
+
+#if LWESP_CFG_MEM_TLSF
+
+/*
+ * Two-level segregated fit allocator
+ *
+ * Free blocks are kept in segregated lists, indexed by first level (power of 2 range)
+ * and second level (linear subdivision of range). Bitmaps of non-empty lists
+ * allow to find suitable block with constant number of operations.
+ * Every block knows its physical previous block for constant time merging on free
+ */
+
+#if !__DOXYGEN__
+typedef struct mem_block {
+    struct mem_block* prev_phys;                /*!< Physically previous block in region, `NULL` for first block */
+    size_t size;                                /*!< Size of block payload and free flag in lowest bit */
+#if LWESP_CFG_MEM_STATS
+    uint8_t tag;                                /*!< Allocation tag, member of \ref lwesp_mem_tag_t */
+#endif /* LWESP_CFG_MEM_STATS */
+    struct mem_block* next_free;                /*!< Next free block in the same list. Valid only when block is free */
+    struct mem_block* prev_free;                /*!< Previous free block in the same list. Valid only when block is free */
+} mem_block_t;
+#endif /* !__DOXYGEN__ */
+
+#define MEM_ALIGN_NUM               LWESP_SZ(LWESP_CFG_MEM_ALIGNMENT)
+#define MEM_ALIGN(x)                LWESP_MEM_ALIGN(x)
+
+#define MEM_SL_LOG2                 4
+#define MEM_SL_COUNT                (1U << MEM_SL_LOG2)
+#define MEM_FL_COUNT                28
+#define MEM_SMALL_SIZE              (MEM_SL_COUNT * MEM_ALIGN_NUM)
+
+#define MEM_FREE_BIT                ((size_t)1)
+#define MEMBLOCK_METASIZE           MEM_ALIGN(offsetof(mem_block_t, next_free))
+#define MEMBLOCK_MIN_SIZE           MEM_ALIGN(sizeof(mem_block_t) - offsetof(mem_block_t, next_free))
+
+#define MEM_BLOCK_SIZE(b)           ((b)->size & ~MEM_FREE_BIT)
+#define MEM_BLOCK_IS_FREE(b)        (((b)->size & MEM_FREE_BIT) != 0)
+#define MEM_BLOCK_NEXT(b)           ((mem_block_t *)((uint8_t *)(b) + MEMBLOCK_METASIZE + MEM_BLOCK_SIZE(b)))
+#define MEM_BLOCK_FROM_PTR(ptr)     ((mem_block_t *)(((uint8_t *)(ptr)) - MEMBLOCK_METASIZE))
+#define MEM_BLOCK_TO_PTR(b)         ((void *)((uint8_t *)(b) + MEMBLOCK_METASIZE))
+#define MEM_BLOCK_USER_SIZE(ptr)    MEM_BLOCK_SIZE(MEM_BLOCK_FROM_PTR(ptr))
+#define MEM_BLOCK_IS_ALLOCATED(ptr) (!MEM_BLOCK_IS_FREE(MEM_BLOCK_FROM_PTR(ptr)) && MEM_BLOCK_SIZE(MEM_BLOCK_FROM_PTR(ptr)) > 0)
+
+static uint32_t fl_bitmap;                      /*!< Bitmap of first level lists with free blocks */
+static uint32_t sl_bitmap[MEM_FL_COUNT];        /*!< Bitmaps of second level lists with free blocks */
+static mem_block_t* free_blocks[MEM_FL_COUNT][MEM_SL_COUNT];/*!< Heads of free lists */
+static uint8_t mem_initialized;                 /*!< Status if regions are assigned */
+static size_t mem_available_bytes;              /*!< Number of available bytes for allocations */
+
+/**
+ * \brief           Get index of most significant set bit
+ * \param[in]       x: Value, must not be `0`
+ * \return          Bit index
+ */
+static uint32_t
+mem_fls(size_t x) {
+    uint32_t r = 0;
+
+    /* Binary search, fixed number of steps */
+    for (uint32_t s = sizeof(size_t) * CHAR_BIT / 2; s > 0; s >>= 1) {
+        if (x >> s) {
+            x >>= s;
+            r += s;
+        }
+    }
+    return r;
+}
+
+/**
+ * \brief           Get index of least significant set bit
+ * \param[in]       x: Value, must not be `0`
+ * \return          Bit index
+ */
+static uint32_t
+mem_ffs(uint32_t x) {
+    return mem_fls((size_t)(x & (~x + 1)));
+}
+
+/**
+ * \brief           Get list indexes for block size
+ * \param[in]       size: Block payload size
+ * \param[out]      fl: First level index
+ * \param[out]      sl: Second level index
+ */
+static void
+mem_mapping(size_t size, uint32_t* fl, uint32_t* sl) {
+    if (size < MEM_SMALL_SIZE) {
+        *fl = 0;
+        *sl = (uint32_t)(size / MEM_ALIGN_NUM);
+    } else {
+        uint32_t f = mem_fls(size);
+        *sl = (uint32_t)(size >> (f - MEM_SL_LOG2)) ^ MEM_SL_COUNT;
+        *fl = f - mem_fls(MEM_SMALL_SIZE) + 1;
+    }
+}
+
+/**
+ * \brief           Insert block to free list
+ * \param[in]       b: Free block
+ */
+static void
+mem_insertfreeblock(mem_block_t* b) {
+    uint32_t fl, sl;
+
+    mem_mapping(MEM_BLOCK_SIZE(b), &fl, &sl);
+    b->size |= MEM_FREE_BIT;
+    b->prev_free = NULL;
+    b->next_free = free_blocks[fl][sl];
+    if (b->next_free != NULL) {
+        b->next_free->prev_free = b;
+    }
+    free_blocks[fl][sl] = b;
+    fl_bitmap |= 1UL << fl;
+    sl_bitmap[fl] |= 1UL << sl;
+}
+
+/**
+ * \brief           Remove block from free list
+ * \param[in]       b: Free block
+ */
+static void
+mem_removefreeblock(mem_block_t* b) {
+    uint32_t fl, sl;
+
+    mem_mapping(MEM_BLOCK_SIZE(b), &fl, &sl);
+    if (b->prev_free != NULL) {
+        b->prev_free->next_free = b->next_free;
+    } else {
+        free_blocks[fl][sl] = b->next_free;
+    }
+    if (b->next_free != NULL) {
+        b->next_free->prev_free = b->prev_free;
+    }
+    if (free_blocks[fl][sl] == NULL) {          /* List is now empty */
+        sl_bitmap[fl] &= ~(1UL << sl);
+        if (sl_bitmap[fl] == 0) {
+            fl_bitmap &= ~(1UL << fl);
+        }
+    }
+    b->size &= ~MEM_FREE_BIT;
+}
+
+/**
+ * \brief           Assign memory for HEAP allocations
+ * \param[in]       regions: Pointer to list of regions.
+ *                  Set regions in ascending order by address
+ * \param[in]       len: Number of regions to assign
+ */
+static uint8_t
+mem_assignmem(const lwesp_mem_region_t* regions, size_t len) {
+    if (mem_initialized) {                      /* Regions already defined */
+        return 0;
+    }
+
+    for (; len > 0; --len, ++regions) {
+        uint8_t* addr = regions->start_addr;
+        size_t size = regions->size;
+        mem_block_t* first, *last;
+
+        /* Align start address and size */
+        if (LWESP_SZ(addr) & (MEM_ALIGN_NUM - 1)) {
+            size_t diff = MEM_ALIGN_NUM - (LWESP_SZ(addr) & (MEM_ALIGN_NUM - 1));
+            if (size < diff) {
+                continue;
+            }
+            addr += diff;
+            size -= diff;
+        }
+        size &= ~(MEM_ALIGN_NUM - 1);
+
+        /* Region must fit first block and end sentinel */
+        if (size < 2 * MEMBLOCK_METASIZE + MEMBLOCK_MIN_SIZE) {
+            continue;
+        }
+
+        first = (mem_block_t*)addr;
+        first->prev_phys = NULL;
+        first->size = size - 2 * MEMBLOCK_METASIZE;
+
+        last = MEM_BLOCK_NEXT(first);           /* Sentinel block, always allocated */
+        last->prev_phys = first;
+        last->size = 0;
+
+        mem_insertfreeblock(first);
+        mem_available_bytes += MEM_BLOCK_SIZE(first);
+        mem_initialized = 1;
+    }
+    return mem_initialized;
+}
+
+/**
+ * \brief           Allocate memory of specific size
+ * \param[in]       size: Number of bytes to allocate
+ * \param[in]       fast: Set to `1` to allocate from fast region, `0` from general purpose region.
+ *                      Used only with \ref LWESP_CFG_MEM_PLACEMENT
+ * \return          Memory address on success, `NULL` otherwise
+ */
+static void*
+mem_alloc(size_t size, uint8_t fast) {
+    mem_block_t* b;
+    uint32_t fl, sl, map;
+    size_t search;
+
+    if (!mem_initialized || size == 0 || size > (((size_t)1) << (sizeof(size_t) * CHAR_BIT - 2))) {
+        return NULL;
+    }
+
+    size = LWESP_MAX(MEM_ALIGN(size), MEMBLOCK_MIN_SIZE);
+    if (size > mem_available_bytes) {           /* Check if we have enough memory available */
+        return NULL;
+    }
+
+    /* Round up to next list, so that any block in the list is big enough */
+    search = size;
+    if (search >= MEM_SMALL_SIZE) {
+        search += (((size_t)1) << (mem_fls(search) - MEM_SL_LOG2)) - 1;
+    }
+    mem_mapping(search, &fl, &sl);
+    if (fl >= MEM_FL_COUNT) {
+        return NULL;
+    }
+
+    /* Find first non-empty list, starting at selected one */
+    map = sl_bitmap[fl] & (~0UL << sl);
+    if (map == 0) {
+        uint32_t fl_map = fl + 1 < 32 ? fl_bitmap & (~0UL << (fl + 1)) : 0;
+        if (fl_map == 0) {
+            return NULL;                        /* No block big enough */
+        }
+        fl = mem_ffs(fl_map);
+        map = sl_bitmap[fl];
+    }
+    sl = mem_ffs(map);
+    b = free_blocks[fl][sl];
+
+    /* Continue with next blocks and larger lists until block in requested memory is found */
+    while (!MEM_BLOCK_PLACE_OK(b, fast)) {
+        if ((b = b->next_free) == NULL) {
+            map = sl + 1 < MEM_SL_COUNT ? sl_bitmap[fl] & (~0UL << (sl + 1)) : 0;
+            if (map == 0) {
+                uint32_t fl_map = fl + 1 < 32 ? fl_bitmap & (~0UL << (fl + 1)) : 0;
+                if (fl_map == 0) {
+                    return NULL;
+                }
+                fl = mem_ffs(fl_map);
+                map = sl_bitmap[fl];
+            }
+            sl = mem_ffs(map);
+            b = free_blocks[fl][sl];
+        }
+    }
+    LWESP_UNUSED(fast);
+
+    mem_removefreeblock(b);
+
+    /* Split block when remaining part can be used as separate block */
+    if (MEM_BLOCK_SIZE(b) >= size + MEMBLOCK_METASIZE + MEMBLOCK_MIN_SIZE) {
+        mem_block_t* rest = (mem_block_t*)((uint8_t*)b + MEMBLOCK_METASIZE + size);
+
+        rest->size = MEM_BLOCK_SIZE(b) - size - MEMBLOCK_METASIZE;
+        rest->prev_phys = b;
+        MEM_BLOCK_NEXT(rest)->prev_phys = rest;
+        b->size = size;
+        mem_insertfreeblock(rest);
+        mem_available_bytes -= MEMBLOCK_METASIZE;
+    }
+    mem_available_bytes -= MEM_BLOCK_SIZE(b);
+    return MEM_BLOCK_TO_PTR(b);
+}
+
+/**
+ * \brief           Free memory
+ * \param[in]       ptr: Pointer to memory previously returned using \ref lwesp_mem_malloc,
+ *                      \ref lwesp_mem_calloc or \ref lwesp_mem_realloc functions
+ */
+static void
+mem_free(void* ptr) {
+    mem_block_t* b, *n;
+
+    if (ptr == NULL) {                          /* To be in compliance with C free function */
+        return;
+    }
+
+    b = MEM_BLOCK_FROM_PTR(ptr);
+    if (MEM_BLOCK_IS_FREE(b) || MEM_BLOCK_SIZE(b) == 0) {   /* Already free or sentinel */
+        return;
+    }
+    mem_available_bytes += MEM_BLOCK_SIZE(b);
+
+    /* Merge with previous block */
+    if (b->prev_phys != NULL && MEM_BLOCK_IS_FREE(b->prev_phys)) {
+        mem_block_t* p = b->prev_phys;
+        mem_removefreeblock(p);
+        p->size += MEMBLOCK_METASIZE + MEM_BLOCK_SIZE(b);
+        b = p;
+        mem_available_bytes += MEMBLOCK_METASIZE;
+    }
+
+    /* Merge with next block */
+    n = MEM_BLOCK_NEXT(b);
+    if (MEM_BLOCK_IS_FREE(n)) {
+        mem_removefreeblock(n);
+        b->size += MEMBLOCK_METASIZE + MEM_BLOCK_SIZE(n);
+        mem_available_bytes += MEMBLOCK_METASIZE;
+    }
+    MEM_BLOCK_NEXT(b)->prev_phys = b;
+    mem_insertfreeblock(b);
+}
+
+#if LWESP_CFG_MEM_STATS || __DOXYGEN__
+/**
+ * \brief           Get size of largest free block
+ * \return          Size of largest block available for allocation
+ */
+static size_t
+mem_get_largest_free(void) {
+    size_t max = 0;
+    uint32_t fl;
+
+    if (fl_bitmap == 0) {
+        return 0;
+    }
+    fl = mem_fls(fl_bitmap);                    /* Only top non-empty list must be checked */
+    for (mem_block_t* b = free_blocks[fl][mem_fls(sl_bitmap[fl])]; b != NULL; b = b->next_free) {
+        max = LWESP_MAX(max, MEM_BLOCK_SIZE(b));
+    }
+    return max;
+}
+#endif /* LWESP_CFG_MEM_STATS || __DOXYGEN__ */
+
+#else /* LWESP_CFG_MEM_TLSF */
+
 #if !__DOXYGEN__
 typedef struct mem_block {
     struct mem_block* next;                     /*!< Pointer to next free block */
     size_t size;                                /*!< Size of block */
+#if LWESP_CFG_MEM_STATS
+    uint8_t tag;                                /*!< Allocation tag, member of \ref lwesp_mem_tag_t */
+#endif /* LWESP_CFG_MEM_STATS */
 } mem_block_t;
 #endif /* !__DOXYGEN__ */
 
@@ -56,6 +428,7 @@ typedef struct mem_block {
 #define MEM_ALLOC_BIT               ((size_t)((size_t)1 << (sizeof(size_t) * CHAR_BIT - 1)))
 #define MEM_BLOCK_FROM_PTR(ptr)     ((mem_block_t *)(((uint8_t *)(ptr)) - MEMBLOCK_METASIZE))
 #define MEM_BLOCK_USER_SIZE(ptr)    ((MEM_BLOCK_FROM_PTR(ptr)->size & ~MEM_ALLOC_BIT) - MEMBLOCK_METASIZE)
+#define MEM_BLOCK_IS_ALLOCATED(ptr) ((MEM_BLOCK_FROM_PTR(ptr)->size & MEM_ALLOC_BIT) && MEM_BLOCK_FROM_PTR(ptr)->next == NULL)
 
 static mem_block_t start_block;                 /*!< First block data for allocations */
 static mem_block_t* end_block;                  /*!< Pointer to last block in linked list */
@@ -203,10 +576,12 @@ mem_assignmem(const lwesp_mem_region_t* regions, size_t len) {
 /**
  * \brief           Allocate memory of specific size
  * \param[in]       size: Number of bytes to allocate
+ * \param[in]       fast: Set to `1` to allocate from fast region, `0` from general purpose region.
+ *                      Used only with \ref LWESP_CFG_MEM_PLACEMENT
  * \return          Memory address on success, `NULL` otherwise
  */
 static void*
-mem_alloc(size_t size) {
+mem_alloc(size_t size, uint8_t fast) {
     mem_block_t* prev, *curr, *next;
     void* retval = NULL;
 
@@ -230,10 +605,11 @@ mem_alloc(size_t size) {
      */
     prev = &start_block;                        /* Set first first block as previous */
     curr = prev->next;                          /* Set next block as current */
-    while ((curr->size < size) && (curr->next != NULL)) {
+    while ((curr->size < size || !MEM_BLOCK_PLACE_OK(curr, fast)) && (curr->next != NULL)) {
         prev = curr;
         curr = curr->next;
     }
+    LWESP_UNUSED(fast);
 
     /*
      * Possible improvements
@@ -301,18 +677,110 @@ mem_free(void* ptr) {
     }
 }
 
+#if LWESP_CFG_MEM_STATS || __DOXYGEN__
+/**
+ * \brief           Get size of largest free block
+ * \return          Size of largest block available for allocation
+ */
+static size_t
+mem_get_largest_free(void) {
+    size_t max = 0;
+
+    if (end_block == NULL) {
+        return 0;
+    }
+    for (mem_block_t* b = start_block.next; b != NULL; b = b->next) {
+        if (b->size > MEMBLOCK_METASIZE) {
+            max = LWESP_MAX(max, b->size - MEMBLOCK_METASIZE);
+        }
+    }
+    return max;
+}
+#endif /* LWESP_CFG_MEM_STATS || __DOXYGEN__ */
+
+#endif /* !LWESP_CFG_MEM_TLSF */
+
+#if LWESP_CFG_MEM_STATS || __DOXYGEN__
+static lwesp_mem_stats_t mem_stats;             /*!< Allocation statistics */
+#endif /* LWESP_CFG_MEM_STATS || __DOXYGEN__ */
+
+/**
+ * \brief           Allocate memory and update statistics
+ * \param[in]       size: Number of bytes to allocate
+ * \param[in]       tag: Allocation tag, member of \ref lwesp_mem_tag_t
+ * \return          Memory address on success, `NULL` otherwise
+ */
+static void*
+mem_alloc_tag(size_t size, lwesp_mem_tag_t tag) {
+    void* ptr = NULL;
+
+#if LWESP_CFG_MEM_PLACEMENT
+    /* Hot structures, never accessed by DMA, prefer fast memory */
+    if (mem_fast_regions_cnt > 0 && (tag == LWESP_MEM_TAG_MSG || tag == LWESP_MEM_TAG_PBUF_HDR)) {
+        ptr = mem_alloc(size, 1);
+    }
+    if (ptr == NULL) {
+        ptr = mem_alloc(size, 0);
+    }
+#else /* LWESP_CFG_MEM_PLACEMENT */
+    ptr = mem_alloc(size, 0);
+#endif /* !LWESP_CFG_MEM_PLACEMENT */
+#if LWESP_CFG_MEM_STATS
+    if (ptr != NULL) {
+        size_t len = MEM_BLOCK_USER_SIZE(ptr);
+
+        if ((size_t)tag >= LWESP_MEM_TAG_END) {
+            tag = LWESP_MEM_TAG_OTHER;
+        }
+        MEM_BLOCK_FROM_PTR(ptr)->tag = (uint8_t)tag;
+        ++mem_stats.alloc_count;
+        mem_stats.bytes_in_use += len;
+        mem_stats.bytes_peak = LWESP_MAX(mem_stats.bytes_peak, mem_stats.bytes_in_use);
+        mem_stats.bytes_min_free = LWESP_MIN(mem_stats.bytes_min_free, mem_available_bytes);
+        ++mem_stats.tags[tag].alloc_count;
+        mem_stats.tags[tag].bytes_in_use += len;
+        mem_stats.tags[tag].bytes_peak = LWESP_MAX(mem_stats.tags[tag].bytes_peak, mem_stats.tags[tag].bytes_in_use);
+    } else if (size > 0) {
+        ++mem_stats.fail_count;
+    }
+#else /* LWESP_CFG_MEM_STATS */
+    LWESP_UNUSED(tag);
+#endif /* !LWESP_CFG_MEM_STATS */
+    return ptr;
+}
+
+/**
+ * \brief           Free memory and update statistics
+ * \param[in]       ptr: Pointer to allocated memory
+ */
+static void
+mem_free_tag(void* ptr) {
+#if LWESP_CFG_MEM_STATS
+    if (ptr != NULL && MEM_BLOCK_IS_ALLOCATED(ptr)) {
+        size_t len = MEM_BLOCK_USER_SIZE(ptr);
+        uint8_t tag = MEM_BLOCK_FROM_PTR(ptr)->tag;
+
+        ++mem_stats.free_count;
+        mem_stats.bytes_in_use -= len;
+        mem_stats.tags[tag].bytes_in_use -= len;
+    }
+#endif /* LWESP_CFG_MEM_STATS */
+    mem_free(ptr);
+}
+
 /**
  * \brief           Allocate memory of specific size
  * \param[in]       num: Number of elements to allocate
  * \param[in]       size: Size of element in units of bytes
+ * \param[in]       tag: Allocation tag, member of \ref lwesp_mem_tag_t
  * \return          Memory address on success, `NULL` otherwise
  */
 static void*
-mem_calloc(size_t num, size_t size) {
+mem_calloc(size_t num, size_t size, lwesp_mem_tag_t tag) {
     void* ptr;
     size_t tot_len = num * size;
 
-    if ((ptr = mem_alloc(tot_len)) != NULL) {   /* Try to allocate memory */
+    if ((ptr = mem_alloc_tag(tot_len, tag)) != NULL) {  /* Try to allocate memory */
         LWESP_MEMSET(ptr, 0x00, tot_len);       /* Reset entire memory */
     }
     return ptr;
@@ -328,33 +796,38 @@ mem_calloc(size_t num, size_t size) {
  */
 static void*
 mem_realloc(void* ptr, size_t size) {
+    lwesp_mem_tag_t tag = LWESP_MEM_TAG_OTHER;
     void* new_ptr;
     size_t old_size;
 
     if (ptr == NULL) {                          /* If pointer is not valid */
-        return mem_alloc(size);                 /* Only allocate memory */
+        return mem_alloc_tag(size, tag);        /* Only allocate memory */
     }
 
+#if LWESP_CFG_MEM_STATS
+    tag = (lwesp_mem_tag_t)MEM_BLOCK_FROM_PTR(ptr)->tag;/* Keep tag of original allocation */
+#endif /* LWESP_CFG_MEM_STATS */
     old_size = MEM_BLOCK_USER_SIZE(ptr);        /* Get size of old pointer */
-    new_ptr = mem_alloc(size);                  /* Try to allocate new memory block */
+    new_ptr = mem_alloc_tag(size, tag);         /* Try to allocate new memory block */
     if (new_ptr != NULL) {
         LWESP_MEMCPY(new_ptr, ptr, LWESP_MIN(size, old_size));  /* Copy old data to new array */
-        mem_free(ptr);                          /* Free old pointer */
+        mem_free_tag(ptr);                      /* Free old pointer */
     }
     return new_ptr;
 }
 
 /**
- * \brief           Allocate memory of specific size
+ * \brief           Allocate memory of specific size and assign tag to it
  * \param[in]       size: Number of bytes to allocate
+ * \param[in]       tag: Allocation tag, used for statistics when \ref LWESP_CFG_MEM_STATS is enabled
  * \return          Memory address on success, `NULL` otherwise
- * \note            Function is not available when \ref LWESP_CFG_MEM_CUSTOM is `1` and must be implemented by user
+ * \note            Function is not available when \ref LWESP_CFG_MEM_CUSTOM is `1`
  */
 void*
-lwesp_mem_malloc(size_t size) {
+lwesp_mem_malloc_tag(size_t size, lwesp_mem_tag_t tag) {
     void* ptr;
     lwesp_core_lock();
-    ptr = mem_calloc(1, size);                  /* Allocate memory and return pointer */
+    ptr = mem_calloc(1, size, tag);             /* Allocate memory and return pointer */
     lwesp_core_unlock();
     LWESP_DEBUGW(LWESP_CFG_DBG_MEM | LWESP_DBG_TYPE_TRACE, ptr == NULL,
                "[MEM] Allocation failed: %d bytes\r\n", (int)size);
@@ -363,6 +836,17 @@ lwesp_mem_malloc(size_t size) {
     return ptr;
 }
 
+/**
+ * \brief           Allocate memory of specific size
+ * \param[in]       size: Number of bytes to allocate
+ * \return          Memory address on success, `NULL` otherwise
+ * \note            Function is not available when \ref LWESP_CFG_MEM_CUSTOM is `1` and must be implemented by user
+ */
+void*
+lwesp_mem_malloc(size_t size) {
+    return lwesp_mem_malloc_tag(size, LWESP_MEM_TAG_OTHER);
+}
+
 /**
  * \brief           Reallocate memory to specific size
  * \note            After new memory is allocated, content of old one is copied to new memory
@@ -385,17 +869,18 @@ lwesp_mem_realloc(void* ptr, size_t size) {
 }
 
 /**
- * \brief           Allocate memory of specific size and set memory to zero
+ * \brief           Allocate memory of specific size, set memory to zero and assign tag to it
  * \param[in]       num: Number of elements to allocate
  * \param[in]       size: Size of each element
+ * \param[in]       tag: Allocation tag, used for statistics when \ref LWESP_CFG_MEM_STATS is enabled
  * \return          Memory address on success, `NULL` otherwise
- * \note            Function is not available when \ref LWESP_CFG_MEM_CUSTOM is `1` and must be implemented by user
+ * \note            Function is not available when \ref LWESP_CFG_MEM_CUSTOM is `1`
  */
 void*
-lwesp_mem_calloc(size_t num, size_t size) {
+lwesp_mem_calloc_tag(size_t num, size_t size, lwesp_mem_tag_t tag) {
     void* ptr;
     lwesp_core_lock();
-    ptr = mem_calloc(num, size);                /* Allocate memory and clear it to 0. Then return pointer */
+    ptr = mem_calloc(num, size, tag);           /* Allocate memory and clear it to 0. Then return pointer */
     lwesp_core_unlock();
     LWESP_DEBUGW(LWESP_CFG_DBG_MEM | LWESP_DBG_TYPE_TRACE, ptr == NULL,
                "[MEM] Callocation failed: %d bytes\r\n", (int)size * (int)num);
@@ -404,6 +889,18 @@ lwesp_mem_calloc(size_t num, size_t size) {
     return ptr;
 }
 
+/**
+ * \brief           Allocate memory of specific size and set memory to zero
+ * \param[in]       num: Number of elements to allocate
+ * \param[in]       size: Size of each element
+ * \return          Memory address on success, `NULL` otherwise
+ * \note            Function is not available when \ref LWESP_CFG_MEM_CUSTOM is `1` and must be implemented by user
+ */
+void*
+lwesp_mem_calloc(size_t num, size_t size) {
+    return lwesp_mem_calloc_tag(num, size, LWESP_MEM_TAG_OTHER);
+}
+
 /**
  * \brief           Free memory
  * \param[in]       ptr: Pointer to memory previously returned using \ref lwesp_mem_malloc,
@@ -419,10 +916,31 @@ lwesp_mem_free(void* ptr) {
                "[MEM] Free size: %d, address: %p\r\n",
                (int)MEM_BLOCK_USER_SIZE(ptr), ptr);
     lwesp_core_lock();
-    mem_free(ptr);
+    mem_free_tag(ptr);
     lwesp_core_unlock();
 }
 
+#if LWESP_CFG_MEM_STATS || __DOXYGEN__
+
+/**
+ * \brief           Get memory allocation statistics
+ * \param[out]      stats: Pointer to output structure to fill
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_mem_get_stats(lwesp_mem_stats_t* stats) {
+    LWESP_ASSERT("stats != NULL", stats != NULL);
+
+    lwesp_core_lock();
+    LWESP_MEMCPY(stats, &mem_stats, sizeof(*stats));
+    stats->bytes_free = mem_available_bytes;
+    stats->largest_free_block = mem_get_largest_free();
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_MEM_STATS || __DOXYGEN__ */
+
 /**
  * \brief           Assign memory region(s) for allocation functions
  * \note            You can allocate multiple regions by assigning start address and region size in units of bytes
@@ -430,11 +948,35 @@ lwesp_mem_free(void* ptr) {
  * \param[in]       len: Number of regions to use
  * \return          `1` on success, `0` otherwise
  * \note            Function is not available when \ref LWESP_CFG_MEM_CUSTOM is `1`
+ * \note            With \ref LWESP_CFG_MEM_PLACEMENT, regions with `fast` member set are used as fast memory.
+ *                  Function fails when there are more than \ref LWESP_CFG_MEM_PLACEMENT_FAST_REGIONS fast regions
  */
 uint8_t
 lwesp_mem_assignmemory(const lwesp_mem_region_t* regions, size_t len) {
     uint8_t ret;
+#if LWESP_CFG_MEM_PLACEMENT
+    size_t fast_cnt = 0;
+
+    for (size_t i = 0; i < len; ++i) {
+        fast_cnt += regions[i].fast ? 1 : 0;
+    }
+    if (fast_cnt > LWESP_ARRAYSIZE(mem_fast_regions)) {
+        return 0;                               /* Fast region must never be used as general purpose memory */
+    }
+#endif /* LWESP_CFG_MEM_PLACEMENT */
     ret = mem_assignmem(regions, len);          /* Assign memory */
+#if LWESP_CFG_MEM_PLACEMENT
+    for (size_t i = 0; ret && i < len; ++i) {
+        if (regions[i].fast) {
+            mem_fast_regions[mem_fast_regions_cnt].start = regions[i].start_addr;
+            mem_fast_regions[mem_fast_regions_cnt].end = (const uint8_t*)regions[i].start_addr + regions[i].size;
+            ++mem_fast_regions_cnt;
+        }
+    }
+#endif /* LWESP_CFG_MEM_PLACEMENT */
+#if LWESP_CFG_MEM_STATS
+    mem_stats.bytes_min_free = mem_available_bytes;
+#endif /* LWESP_CFG_MEM_STATS */
     return ret;
 }
 
@@ -36,17 +36,116 @@
 #include "lwesp/lwesp_mem.h"
 
 /**
- * \brief           Parse number from string
- * \note            Input string pointer is changed and number is skipped
- * \param[in,out]   str: Pointer to pointer to string to parse
- * \return          Parsed number
+ * \brief           List of known keywords, indexed by \ref lwespi_resp_kw_t
  */
-int32_t
-lwespi_parse_number(const char** str) {
-    int32_t val = 0;
-    uint8_t minus = 0;
-    const char* p = *str;                       /*  */
+static const char* const
+resp_kw_str[LWESP_RESP_KW_END] = {
+    [LWESP_RESP_KW_IPD] = "IPD",
+    [LWESP_RESP_KW_CIPRECVDATA] = "CIPRECVDATA",
+    [LWESP_RESP_KW_CIPRECVLEN] = "CIPRECVLEN",
+    [LWESP_RESP_KW_STA_CONNECTED] = "STA_CONNECTED",
+    [LWESP_RESP_KW_STA_DISCONNECTED] = "STA_DISCONNECTED",
+    [LWESP_RESP_KW_DIST_STA_IP] = "DIST_STA_IP",
+    [LWESP_RESP_KW_CIPSTAMAC] = "CIPSTAMAC",
+    [LWESP_RESP_KW_CIPAPMAC] = "CIPAPMAC",
+    [LWESP_RESP_KW_CIPSTA] = "CIPSTA",
+    [LWESP_RESP_KW_CIPAP] = "CIPAP",
+    [LWESP_RESP_KW_CWLAP] = "CWLAP",
+    [LWESP_RESP_KW_CWJAP] = "CWJAP",
+    [LWESP_RESP_KW_CWLIF] = "CWLIF",
+    [LWESP_RESP_KW_CWSAP] = "CWSAP",
+    [LWESP_RESP_KW_CIPDOMAIN] = "CIPDOMAIN",
+    [LWESP_RESP_KW_CIPDNS] = "CIPDNS",
+    [LWESP_RESP_KW_PING] = "PING",
+    [LWESP_RESP_KW_CIPSNTPTIME] = "CIPSNTPTIME",
+    [LWESP_RESP_KW_CWHOSTNAME] = "CWHOSTNAME",
+    [LWESP_RESP_KW_CWDHCP] = "CWDHCP",
+    [LWESP_RESP_KW_CWMODE] = "CWMODE",
+    [LWESP_RESP_KW_CIPSTATUS] = "CIPSTATUS",
+    [LWESP_RESP_KW_LINK_CONN] = "LINK_CONN",
+};
+
+/**
+ * \brief           Perfect hash table for known keywords
+ *
+ * Table maps result of \ref LWESP_RESP_KW_HASH to keyword ID.
+ * When adding new keyword, hash must be recalculated to make sure there is no collision
+ */
+static const uint8_t
+resp_kw_hash_table[64] = {
+    [6] = LWESP_RESP_KW_PING,
+    [8] = LWESP_RESP_KW_CWHOSTNAME,
+    [12] = LWESP_RESP_KW_CIPSTA,
+    [17] = LWESP_RESP_KW_CIPRECVDATA,
+    [21] = LWESP_RESP_KW_CWLAP,
+    [25] = LWESP_RESP_KW_CWLIF,
+    [26] = LWESP_RESP_KW_CIPAPMAC,
+    [27] = LWESP_RESP_KW_CIPSTAMAC,
+    [29] = LWESP_RESP_KW_CIPDOMAIN,
+    [30] = LWESP_RESP_KW_CIPRECVLEN,
+    [33] = LWESP_RESP_KW_CWSAP,
+    [37] = LWESP_RESP_KW_CIPAP,
+    [39] = LWESP_RESP_KW_DIST_STA_IP,
+    [40] = LWESP_RESP_KW_CWMODE,
+    [41] = LWESP_RESP_KW_CIPSNTPTIME,
+    [43] = LWESP_RESP_KW_IPD,
+    [45] = LWESP_RESP_KW_CWJAP,
+    [53] = LWESP_RESP_KW_LINK_CONN,
+    [54] = LWESP_RESP_KW_CWDHCP,
+    [56] = LWESP_RESP_KW_CIPDNS,
+    [57] = LWESP_RESP_KW_STA_CONNECTED,
+    [59] = LWESP_RESP_KW_CIPSTATUS,
+    [60] = LWESP_RESP_KW_STA_DISCONNECTED,
+};
+
+/**
+ * \brief           Get keyword hash index
+ * \param[in]       kw: Pointer to keyword, without leading `+` character
+ * \param[in]       len: Length of keyword in units of bytes, must be at least `3`
+ */
+#define LWESP_RESP_KW_HASH(kw, len)         (((size_t)(len) + (size_t)(6 * (uint8_t)(kw)[(len) - 1]) + (size_t)(20 * (uint8_t)(kw)[2])) & 0x3F)
+
+/**
+ * \brief           Get keyword of response starting with `+` character
+ *
+ * Keyword is part of response between `+` and first `:`, `,` or end of line character.
+ * Lookup is done with perfect hash and takes constant time regardless of number of keywords
+ *
+ * \param[in]       str: Input string starting with `+` character
+ * \return          Member of \ref lwespi_resp_kw_t enumeration
+ */
+lwespi_resp_kw_t
+lwespi_parse_get_resp_kw(const char* str) {
+    const char* kw;
+    size_t len;
+    uint8_t id;
+
+    if (*str != '+') {
+        return LWESP_RESP_KW_NONE;
+    }
+    kw = ++str;
+    while (*str != '\0' && *str != ':' && *str != ',' && *str != '\r' && *str != '\n') {
+        ++str;
+    }
+    len = (size_t)(str - kw);
+    if (len < 3) {
+        return LWESP_RESP_KW_NONE;
+    }
+    id = resp_kw_hash_table[LWESP_RESP_KW_HASH(kw, len)];
+    if (id != LWESP_RESP_KW_NONE
+        && !strncmp(resp_kw_str[id], kw, len) && resp_kw_str[id][len] == '\0') {
+        return (lwespi_resp_kw_t)id;
+    }
+    return LWESP_RESP_KW_NONE;
+}
 
+/**
+ * \brief           Skip optional leading `"`, `,` and `"` characters before value
+ * \param[in]       p: Pointer to string
+ * \return          Pointer to first character of value
+ */
+static const char*
+parse_skip_value_prefix(const char* p) {
     if (*p == '"') {                            /* Skip leading quotes */
         ++p;
     }
@@ -56,20 +155,73 @@ lwespi_parse_number(const char** str) {
     if (*p == '"') {                            /* Skip leading quotes */
         ++p;
     }
+    return p;
+}
+
+/**
+ * \brief           Get value of hexadecimal character
+ *
+ * Lower-case conversion with `0x20` maps `A-F` and `a-f` to the same range,
+ * so each range is tested with single unsigned comparison
+ *
+ * \param[in]       ch: Character to convert
+ * \return          Value between `0` and `15` or `0xFF` if character is not hexadecimal digit
+ */
+static uint8_t
+parse_hex_char(char ch) {
+    uint8_t d;
+
+    d = (uint8_t)((uint8_t)ch - (uint8_t)'0');
+    if (d < 10) {
+        return d;
+    }
+    d = (uint8_t)(((uint8_t)ch | 0x20) - (uint8_t)'a');
+    return d < 6 ? (uint8_t)(d + 10) : 0xFF;
+}
+
+/**
+ * \brief           Parse decimal digits until first non-digit character
+ * \note            Digit test is single unsigned comparison per character
+ * \param[in,out]   str: Pointer to pointer to first digit. Set to first non-digit character on return
+ * \return          Parsed value
+ */
+static uint32_t
+parse_dec_digits(const char** str) {
+    const char* p = *str;
+    uint32_t val = 0;
+    uint8_t d;
+
+    for (d = (uint8_t)((uint8_t)*p - (uint8_t)'0'); d < 10; d = (uint8_t)((uint8_t)*++p - (uint8_t)'0')) {
+        val = val * 10 + d;
+    }
+    *str = p;
+    return val;
+}
+
+/**
+ * \brief           Parse number from string
+ * \note            Input string pointer is changed and number is skipped
+ * \param[in,out]   str: Pointer to pointer to string to parse
+ * \return          Parsed number
+ */
+int32_t
+lwespi_parse_number(const char** str) {
+    uint32_t val;
+    uint8_t minus = 0;
+    const char* p;
+
+    p = parse_skip_value_prefix(*str);
     if (*p == '-') {                            /* Check negative number */
         minus = 1;
         ++p;
     }
-    while (LWESP_CHARISNUM(*p)) {               /* Parse until character is valid number */
-        val = val * 10 + LWESP_CHARTONUM(*p);
-        ++p;
-    }
+    val = parse_dec_digits(&p);                 /* Parse until character is valid number */
     if (*p == ',') {                            /* Go to next entry if possible */
         ++p;
     }
     *str = p;                                   /* Save new pointer with new offset */
 
-    return minus ? -val : val;
+    return minus ? -(int32_t)val : (int32_t)val;
 }
 
 /**
@@ -94,20 +246,13 @@ lwespi_parse_port(const char** str) {
  */
 uint32_t
 lwespi_parse_hexnumber(const char** str) {
-    int32_t val = 0;
-    const char* p = *str;                       /*  */
+    uint32_t val = 0;
+    uint8_t d;
+    const char* p;
 
-    if (*p == '"') {                            /* Skip leading quotes */
-        ++p;
-    }
-    if (*p == ',') {                            /* Skip leading comma */
-        ++p;
-    }
-    if (*p == '"') {                            /* Skip leading quotes */
-        ++p;
-    }
-    while (LWESP_CHARISHEXNUM(*p)) {            /* Parse until character is valid number */
-        val = val * 16 + LWESP_CHARHEXTONUM(*p);
+    p = parse_skip_value_prefix(*str);
+    while ((d = parse_hex_char(*p)) != 0xFF) {  /* Parse until character is valid number */
+        val = (val << 4) | d;
         ++p;
     }
     if (*p == ',') {                            /* Go to next entry if possible */
@@ -131,7 +276,8 @@ lwespi_parse_hexnumber(const char** str) {
 uint8_t
 lwespi_parse_string(const char** src, char* dst, size_t dst_len, uint8_t trim) {
     const char* p = *src;
-    size_t i;
+    const char* s;
+    size_t len;
 
     if (*p == ',') {
         ++p;
@@ -139,28 +285,28 @@ lwespi_parse_string(const char** src, char* dst, size_t dst_len, uint8_t trim) {
     if (*p == '"') {
         ++p;
     }
-    i = 0;
     if (dst_len > 0) {
         --dst_len;
     }
-    while (*p) {
-        if ((*p == '"' && (p[1] == ',' || *p == '\r' || *p == '\n'))
-            || (*p == '\r' || *p == '\n')) {
-            ++p;
-            break;
-        }
-        if (dst != NULL) {
-            if (i < dst_len) {
-                *dst++ = *p;
-                ++i;
-            } else if (!trim) {
-                break;
-            }
-        }
+
+    /* Find end of string first, then copy it at once */
+    s = p;
+    while (*p != '\0' && *p != '\r' && *p != '\n' && (*p != '"' || p[1] != ',')) {
+        ++p;
+    }
+    len = (size_t)(p - s);
+    if (*p != '\0') {                           /* Skip string termination character */
         ++p;
     }
     if (dst != NULL) {
-        *dst = 0;
+        if (len > dst_len) {
+            if (!trim) {                        /* Stop at first character which did not fit */
+                p = s + dst_len;
+            }
+            len = dst_len;
+        }
+        LWESP_MEMCPY(dst, s, len);
+        dst[len] = 0;
     }
     *src = p;
     return 1;
@@ -174,18 +320,18 @@ lwespi_parse_string(const char** src, char* dst, size_t dst_len, uint8_t trim) {
  */
 uint8_t
 lwespi_parse_ip(const char** src, lwesp_ip_t* ip) {
-    const char* p = *src;
+    const char* p;
 
-    if (*p == '"') {
+    p = parse_skip_value_prefix(*src);
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(ip->ip); ++i) {
+        if (i > 0 && *p == '.') {               /* Skip octet separator */
+            ++p;
+        }
+        ip->ip[i] = (uint8_t)parse_dec_digits(&p);
+    }
+    if (*p == ',') {                            /* Go to next entry if possible */
         ++p;
     }
-    ip->ip[0] = lwespi_parse_number(&p);
-    ++p;
-    ip->ip[1] = lwespi_parse_number(&p);
-    ++p;
-    ip->ip[2] = lwespi_parse_number(&p);
-    ++p;
-    ip->ip[3] = lwespi_parse_number(&p);
     if (*p == '"') {
         ++p;
     }
@@ -202,22 +348,28 @@ lwespi_parse_ip(const char** src, lwesp_ip_t* ip) {
  */
 uint8_t
 lwespi_parse_mac(const char** src, lwesp_mac_t* mac) {
-    const char* p = *src;
+    const char* p;
+    uint8_t hi, lo;
 
-    if (*p == '"') {                            /* Go to next entry if possible */
+    p = parse_skip_value_prefix(*src);
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(mac->mac); ++i) {
+        if (i > 0 && *p == ':') {               /* Skip byte separator */
+            ++p;
+        }
+        mac->mac[i] = 0;
+        if ((hi = parse_hex_char(p[0])) != 0xFF) {  /* Byte is written as hex pair */
+            if ((lo = parse_hex_char(p[1])) != 0xFF) {
+                mac->mac[i] = (uint8_t)((hi << 4) | lo);
+                p += 2;
+            } else {
+                mac->mac[i] = hi;
+                ++p;
+            }
+        }
+    }
+    if (*p == ',') {                            /* Go to next entry if possible */
         ++p;
     }
-    mac->mac[0] = lwespi_parse_hexnumber(&p);
-    ++p;
-    mac->mac[1] = lwespi_parse_hexnumber(&p);
-    ++p;
-    mac->mac[2] = lwespi_parse_hexnumber(&p);
-    ++p;
-    mac->mac[3] = lwespi_parse_hexnumber(&p);
-    ++p;
-    mac->mac[4] = lwespi_parse_hexnumber(&p);
-    ++p;
-    mac->mac[5] = lwespi_parse_hexnumber(&p);
     if (*p == '"') {                            /* Skip quotes if possible */
         ++p;
     }
@@ -235,12 +387,25 @@ lwespi_parse_mac(const char** src, lwesp_mac_t* mac) {
  */
 lwespr_t
 lwespi_parse_cipstatus(const char* str) {
-    uint8_t cn_num = 0;
+    int32_t cn_num;
+    char type[8];                               /* "TCPv6" and "UDPv6" need 6 bytes */
 
     cn_num = lwespi_parse_number(&str);         /* Parse connection number */
-    esp.m.active_conns |= 1 << cn_num;          /* Set flag as active */
-
-    lwespi_parse_string(&str, NULL, 0, 1);      /* Parse string and ignore result */
+    if (cn_num < 0 || cn_num >= LWESP_CFG_MAX_CONNS) {
+        return lwespERR;
+    }
+    LWESPI_CONN_BIT_SET(esp.m.active_conns, cn_num);/* Set flag as active */
+
+    lwespi_parse_string(&str, type, sizeof(type), 1);
+    if (!esp.m.conns[cn_num].status.f.active) { /* Type of unknown connection, e.g. after warm init */
+        if (!strncmp(type, "UDP", 3)) {         /* "UDP" or "UDPv6" */
+            esp.m.conns[cn_num].type = LWESP_CONN_TYPE_UDP;
+        } else if (!strncmp(type, "SSL", 3)) {
+            esp.m.conns[cn_num].type = LWESP_CONN_TYPE_SSL;
+        } else {
+            esp.m.conns[cn_num].type = LWESP_CONN_TYPE_TCP;
+        }
+    }
 
     lwespi_parse_ip(&str, &esp.m.conns[cn_num].remote_ip);
     esp.m.conns[cn_num].remote_port = lwespi_parse_number(&str);
@@ -272,6 +437,9 @@ lwespi_parse_ciprecvdata(const char* str) {
         esp.m.ipd.read = 1;                     /* Start reading network data */
         esp.m.ipd.tot_len = len;                /* Total number of bytes in this received packet */
         esp.m.ipd.rem_len = len;                /* Number of remaining bytes to read */
+#if LWESP_CFG_CONN_IPD_FILTER
+        esp.m.ipd.accept = len;                 /* Manual read is never filtered */
+#endif /* LWESP_CFG_CONN_IPD_FILTER */
 
         lwespi_parse_ip(&str, &ip);
         port = lwespi_parse_port(&str);
@@ -304,17 +472,115 @@ lwespi_parse_ciprecvlen(const char* str) {
 }
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE || __DOXYGEN__ */
 
+#if LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__
+
+/**
+ * \brief           Parse `AT+CIPSENDBUF` response with segment IDs, received before `>`
+ *
+ * Format is `<segment ID>,<last acknowledged segment ID>`
+ *
+ * \param[in]       str: Input string to parse
+ * \param[in]       msg: Send message with active `AT+CIPSENDBUF` command
+ * \return          Member of \ref lwespr_t enumeration
+ */
+lwespr_t
+lwespi_parse_cipsendbuf(const char* str, lwesp_msg_t* msg) {
+    uint32_t seg_id, ack_id;
+
+    if (!LWESP_CHARISNUM(*str)) {
+        return lwespERR;
+    }
+    seg_id = LWESP_U32(lwespi_parse_number(&str));
+    if (!LWESP_CHARISNUM(*str)) {
+        return lwespERR;
+    }
+    ack_id = LWESP_U32(lwespi_parse_number(&str));
+    if (*str != '\r') {
+        return lwespERR;
+    }
+
+    msg->msg.conn_send.seg_id = seg_id;
+    lwespi_conn_sendbuf_ack(msg->msg.conn_send.conn, ack_id, lwespOK);
+    return lwespOK;
+}
+
+/**
+ * \brief           Parse `AT+CIPBUFSTATUS` response
+ *
+ * Format is `<next segment ID>,<last sent segment ID>,<last acknowledged segment ID>,<remaining buffer size>,<queue number>`
+ *
+ * \param[in]       str: Input string to parse
+ * \param[in]       msg: Send message with active `AT+CIPBUFSTATUS` command
+ * \return          Member of \ref lwespr_t enumeration
+ */
+lwespr_t
+lwespi_parse_cipbufstatus(const char* str, lwesp_msg_t* msg) {
+    uint32_t ack_id = 0;
+
+    if (*str == '+') {
+        str += 14;
+    }
+    for (size_t i = 0; i < 5; ++i) {
+        if (!LWESP_CHARISNUM(*str)) {
+            return lwespERR;
+        }
+        if (i == 2) {
+            ack_id = LWESP_U32(lwespi_parse_number(&str));
+        } else {
+            lwespi_parse_number(&str);
+        }
+    }
+    lwespi_conn_sendbuf_ack(msg->msg.conn_send.conn, ack_id, lwespOK);
+    return lwespOK;
+}
+
+/**
+ * \brief           Parse asynchronous `<link ID>,<segment ID>,SEND OK` or `SEND FAIL` statement
+ * \param[in]       str: Input string to parse
+ * \return          Member of \ref lwespr_t enumeration
+ */
+lwespr_t
+lwespi_parse_send_ack(const char* str) {
+    int32_t num;
+    uint32_t seg_id;
+
+    num = lwespi_parse_number(&str);
+    if (num < 0 || num >= LWESP_CFG_MAX_CONNS || !LWESP_CHARISNUM(*str)) {
+        return lwespERR;
+    }
+    seg_id = LWESP_U32(lwespi_parse_number(&str));
+    if (!strncmp(str, "SEND OK", 7)) {
+        lwespi_conn_sendbuf_ack(&esp.m.conns[num], seg_id, lwespOK);
+    } else if (!strncmp(str, "SEND FAIL", 9)) {
+        lwespi_conn_sendbuf_ack(&esp.m.conns[num], seg_id, lwespERR);
+    } else {
+        return lwespERR;
+    }
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_CONN_SEND_BUFFERED || __DOXYGEN__ */
+
 /**
  * \brief           Parse +IPD statement
  * \param[in]       str: Input string to parse
+ * \param[in]       str_len: Length of input string, excluding `NULL` termination
  * \return          Member of \ref lwespr_t enumeration
  */
 lwespr_t
-lwespi_parse_ipd(const char* str) {
+lwespi_parse_ipd(const char* str, size_t str_len) {
     uint8_t conn, is_data_ipd;
     size_t len;
     lwesp_conn_p c;
+#if LWESP_CFG_CONN_IPD_INFO_CACHE
+    const char* str_end = str + str_len - 1;    /* Position of ':' character for data packet */
+#endif /* LWESP_CFG_CONN_IPD_INFO_CACHE */
 
+    /*
+     * Data packet is parsed as soon as ':' character is received,
+     * hence it is always last character in the string
+     */
+    is_data_ipd = str_len > 0 && str[str_len - 1] == ':';
     if (*str == '+') {
         str += 5;
     }
@@ -337,8 +603,9 @@ lwespi_parse_ipd(const char* str) {
      *                                                              as response on manual TCP read or if AT+CIPDINFO=0
      * +IPD,conn_num,bytes_in_packet,remote_ip,remote_port:data : Data packet w/ remote ip/port,
      *                                                              as response on automatic read of all connection types
+     *
+     * Check is done at the beginning of the function, using known string length
      */
-    is_data_ipd = strchr(str, ':') != NULL;     /* Check if we have ':' in string */
 
 #if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
     /*
@@ -346,6 +613,9 @@ lwespi_parse_ipd(const char* str) {
      */
     if (!is_data_ipd) {                         /* If not data packet */
         c->tcp_available_bytes = len;           /* Set new value for number of bytes available to read from device */
+#if LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO
+        esp.m.tcp_recv_manual = 1;              /* Notification proves device buffers data */
+#endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE_AUTO */
     } else
 #endif /* LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
         /*
@@ -358,8 +628,32 @@ lwespi_parse_ipd(const char* str) {
          * Check for ':' character if it is end of string and determine how to proceed
          */
         if (*str != ':') {
-            lwespi_parse_ip(&str, &esp.m.ipd.ip);   /* Parse incoming packet IP */
-            esp.m.ipd.port = lwespi_parse_port(&str);   /* Get port on IPD data */
+#if LWESP_CFG_CONN_IPD_INFO_CACHE
+            size_t info_len = is_data_ipd && str < str_end ? (size_t)(str_end - str) : 0;
+
+            if (info_len > 0 && info_len == c->ipd_info.len
+                && !memcmp(str, c->ipd_info.str, info_len)) {
+                esp.m.ipd.ip = c->ipd_info.ip;  /* Same remote as in previous packet */
+                esp.m.ipd.port = c->ipd_info.port;
+            } else
+#endif /* LWESP_CFG_CONN_IPD_INFO_CACHE */
+            {
+#if LWESP_CFG_CONN_IPD_INFO_CACHE
+                const char* info = str;
+#endif /* LWESP_CFG_CONN_IPD_INFO_CACHE */
+
+                lwespi_parse_ip(&str, &esp.m.ipd.ip);   /* Parse incoming packet IP */
+                esp.m.ipd.port = lwespi_parse_port(&str);   /* Get port on IPD data */
+#if LWESP_CFG_CONN_IPD_INFO_CACHE
+                c->ipd_info.len = 0;
+                if (info_len > 0 && info_len <= sizeof(c->ipd_info.str)) {
+                    LWESP_MEMCPY(c->ipd_info.str, info, info_len);
+                    c->ipd_info.len = LWESP_U8(info_len);
+                    c->ipd_info.ip = esp.m.ipd.ip;
+                    c->ipd_info.port = esp.m.ipd.port;
+                }
+#endif /* LWESP_CFG_CONN_IPD_INFO_CACHE */
+            }
 
             LWESP_MEMCPY(&esp.m.conns[conn].remote_ip, &esp.m.ipd.ip, sizeof(esp.m.ipd.ip));
             LWESP_MEMCPY(&esp.m.conns[conn].remote_port, &esp.m.ipd.port, sizeof(esp.m.ipd.port));
@@ -376,6 +670,14 @@ lwespi_parse_ipd(const char* str) {
     if (is_data_ipd) {                          /* Shall we start IPD read procedure? */
         esp.m.ipd.read = 1;                     /* Start reading network data */
         esp.m.ipd.rem_len = len;                /* Number of remaining bytes to read */
+#if LWESP_CFG_CONN_IPD_FILTER
+        esp.m.ipd.accept = len;
+        if (c->ipd_filter != NULL && c->status.f.active) {
+            size_t accept = c->ipd_filter(c, len, &esp.m.ipd.ip, esp.m.ipd.port);
+
+            esp.m.ipd.accept = LWESP_MIN(accept, len);
+        }
+#endif /* LWESP_CFG_CONN_IPD_FILTER */
     }
 
     return lwespOK;
@@ -439,10 +741,21 @@ lwespi_parse_link_conn(const char* str) {
  */
 uint8_t
 lwespi_parse_cwlap(const char* str, lwesp_msg_t* msg) {
-    if (!CMD_IS_DEF(LWESP_CMD_WIFI_CWLAP) ||    /* Do we have valid message here and enough memory to save everything? */
-        msg->msg.ap_list.aps == NULL || msg->msg.ap_list.apsi >= msg->msg.ap_list.apsl) {
+    lwesp_ap_t ap_tmp, *ap;
+    uint8_t fields;
+
+    if (!CMD_IS_DEF(LWESP_CMD_WIFI_CWLAP) || msg->msg.ap_list.stop) {
         return 0;
     }
+
+    /* Streamed entries are parsed to temporary entry, others directly to user array */
+    if (msg->msg.ap_list.ap_fn != NULL) {
+        ap = &ap_tmp;
+    } else if (msg->msg.ap_list.aps != NULL && msg->msg.ap_list.apsi < msg->msg.ap_list.apsl) {
+        ap = &msg->msg.ap_list.aps[msg->msg.ap_list.apsi];
+    } else {
+        return 0;                               /* No memory to save entry, skip it */
+    }
     if (*str == '+') {                          /* Does string contain '+' as first character */
         str += 7;                               /* Skip this part */
     }
@@ -451,22 +764,38 @@ lwespi_parse_cwlap(const char* str, lwesp_msg_t* msg) {
     }
     ++str;
 
-    msg->msg.ap_list.aps[msg->msg.ap_list.apsi].ecn = (lwesp_ecn_t)lwespi_parse_number(&str);
-    lwespi_parse_string(&str, msg->msg.ap_list.aps[msg->msg.ap_list.apsi].ssid, sizeof(msg->msg.ap_list.aps[msg->msg.ap_list.apsi].ssid), 1);
-    msg->msg.ap_list.aps[msg->msg.ap_list.apsi].rssi = lwespi_parse_number(&str);
-    lwespi_parse_mac(&str, &msg->msg.ap_list.aps[msg->msg.ap_list.apsi].mac);
-    msg->msg.ap_list.aps[msg->msg.ap_list.apsi].ch = lwespi_parse_number(&str);
-
-    msg->msg.ap_list.aps[msg->msg.ap_list.apsi].bgn = 0;
+    /* Device only reports fields enabled with CWLAPOPT command */
+    LWESP_MEMSET(ap, 0x00, sizeof(*ap));
+    fields = msg->msg.ap_list.fields;
+    if (fields & LWESP_STA_AP_FIELD_ECN) {
+        ap->ecn = (lwesp_ecn_t)lwespi_parse_number(&str);
+    }
+    if (fields & LWESP_STA_AP_FIELD_SSID) {
+        lwespi_parse_string(&str, ap->ssid, sizeof(ap->ssid), 1);
+    }
+    if (fields & LWESP_STA_AP_FIELD_RSSI) {
+        ap->rssi = lwespi_parse_number(&str);
+    }
+    if (fields & LWESP_STA_AP_FIELD_MAC) {
+        lwespi_parse_mac(&str, &ap->mac);
+    }
+    if (fields & LWESP_STA_AP_FIELD_CH) {
+        ap->ch = lwespi_parse_number(&str);
+    }
 
-    //msg->msg.ap_list.aps[msg->msg.ap_list.apsi].offset = lwespi_parse_number(&str);
-    //msg->msg.ap_list.aps[msg->msg.ap_list.apsi].cal = lwespi_parse_number(&str);
+    //ap->offset = lwespi_parse_number(&str);
+    //ap->cal = lwespi_parse_number(&str);
 
     //lwespi_parse_number(&str);                /* Parse pwc */
     //lwespi_parse_number(&str);                /* Parse gc */
-    //msg->msg.ap_list.aps[msg->msg.ap_list.apsi].bgn = lwespi_parse_number(&str);
-    //msg->msg.ap_list.aps[msg->msg.ap_list.apsi].wps = lwespi_parse_number(&str);
+    //ap->bgn = lwespi_parse_number(&str);
+    //ap->wps = lwespi_parse_number(&str);
 
+    if (msg->msg.ap_list.ap_fn != NULL) {
+        if (!msg->msg.ap_list.ap_fn(ap, msg->msg.ap_list.ap_fn_arg)) {
+            msg->msg.ap_list.stop = 1;          /* Ignore remaining entries */
+        }
+    }
     ++msg->msg.ap_list.apsi;                    /* Increase number of found elements */
     if (msg->msg.ap_list.apf != NULL) {         /* Set pointer if necessary */
         *msg->msg.ap_list.apf = msg->msg.ap_list.apsi;
@@ -482,7 +811,9 @@ lwespi_parse_cwlap(const char* str, lwesp_msg_t* msg) {
  */
 uint8_t
 lwespi_parse_cwjap(const char* str, lwesp_msg_t* msg) {
-    if (!CMD_IS_DEF(LWESP_CMD_WIFI_CWJAP_GET)) {/* Do we have valid message here and enough memory to save everything? */
+    lwesp_sta_info_ap_t info_tmp, *info;
+
+    if (!CMD_IS_CUR(LWESP_CMD_WIFI_CWJAP_GET)) {/* Do we have valid message here and enough memory to save everything? */
         return 0;
     }
     if (*str == '+') {                          /* Does string contain '+' as first character */
@@ -491,12 +822,19 @@ lwespi_parse_cwjap(const char* str, lwesp_msg_t* msg) {
     if (*str != '"') {                          /* We must start with quotation mark */
         return 0;
     }
-    lwespi_parse_string(&str, esp.msg->msg.sta_info_ap.info->ssid, LWESP_CFG_MAX_SSID_LENGTH, 1);
-    lwespi_parse_mac(&str, &esp.msg->msg.sta_info_ap.info->mac);
-    esp.msg->msg.sta_info_ap.info->ch = lwespi_parse_number(&str);
-    esp.msg->msg.sta_info_ap.info->rssi = lwespi_parse_number(&str);
 
-    LWESP_UNUSED(msg);
+    /* Command may also be part of join procedure, without user structure */
+    info = CMD_IS_DEF(LWESP_CMD_WIFI_CWJAP_GET) ? msg->msg.sta_info_ap.info : &info_tmp;
+    lwespi_parse_string(&str, info->ssid, LWESP_CFG_MAX_SSID_LENGTH, 1);
+    lwespi_parse_mac(&str, &info->mac);
+    info->ch = lwespi_parse_number(&str);
+    info->rssi = lwespi_parse_number(&str);
+
+#if LWESP_CFG_STA_FAST_JOIN
+    LWESP_MEMCPY(esp.sta_fast_join.ssid, info->ssid, sizeof(esp.sta_fast_join.ssid));
+    esp.sta_fast_join.bssid = info->mac;
+    esp.sta_fast_join.valid = 1;
+#endif /* LWESP_CFG_STA_FAST_JOIN */
 
     return 1;
 }
@@ -513,8 +851,9 @@ lwespi_parse_cwjap(const char* str, lwesp_msg_t* msg) {
  */
 uint8_t
 lwespi_parse_cwlif(const char* str, lwesp_msg_t* msg) {
-    if (!CMD_IS_DEF(LWESP_CMD_WIFI_CWLIF)       /* Do we have valid message here and enough memory to save everything? */
-        || msg->msg.sta_list.stas == NULL || msg->msg.sta_list.stai >= msg->msg.sta_list.stal) {
+    lwesp_sta_t sta;
+
+    if (!CMD_IS_DEF(LWESP_CMD_WIFI_CWLIF)) {    /* Do we have valid message here? */
         return 0;
     }
 
@@ -522,12 +861,19 @@ lwespi_parse_cwlif(const char* str, lwesp_msg_t* msg) {
         str += 7;
     }
 
-    lwespi_parse_ip(&str, &msg->msg.sta_list.stas[msg->msg.sta_list.stai].ip);
-    lwespi_parse_mac(&str, &msg->msg.sta_list.stas[msg->msg.sta_list.stai].mac);
-
-    ++msg->msg.sta_list.stai;                   /* Increase number of found elements */
-    if (msg->msg.sta_list.staf != NULL) {       /* Set pointer if necessary */
-        *msg->msg.sta_list.staf = msg->msg.sta_list.stai;
+    lwespi_parse_ip(&str, &sta.ip);
+    lwespi_parse_mac(&str, &sta.mac);
+#if LWESP_CFG_AP_STA_TABLE > 0
+    lwespi_ap_sta_table_set(&sta.mac, &sta.ip); /* Every listed station is kept in local table */
+#endif /* LWESP_CFG_AP_STA_TABLE > 0 */
+
+    /* Save to user array when there is enough memory */
+    if (msg->msg.sta_list.stas != NULL && msg->msg.sta_list.stai < msg->msg.sta_list.stal) {
+        msg->msg.sta_list.stas[msg->msg.sta_list.stai] = sta;
+        ++msg->msg.sta_list.stai;               /* Increase number of found elements */
+        if (msg->msg.sta_list.staf != NULL) {   /* Set pointer if necessary */
+            *msg->msg.sta_list.staf = msg->msg.sta_list.stai;
+        }
     }
     return 1;
 }
@@ -543,6 +889,13 @@ lwespi_parse_ap_conn_disconn_sta(const char* str, uint8_t is_conn) {
     lwesp_mac_t mac;
 
     lwespi_parse_mac(&str, &mac);               /* Parse MAC address */
+#if LWESP_CFG_AP_STA_TABLE > 0
+    if (is_conn) {
+        lwespi_ap_sta_table_set(&mac, NULL);
+    } else {
+        lwespi_ap_sta_table_remove(&mac);
+    }
+#endif /* LWESP_CFG_AP_STA_TABLE > 0 */
 
     esp.evt.evt.ap_conn_disconn_sta.mac = &mac;
     lwespi_send_cb(is_conn ? LWESP_EVT_AP_CONNECTED_STA : LWESP_EVT_AP_DISCONNECTED_STA);   /* Send event function */
@@ -561,6 +914,9 @@ lwespi_parse_ap_ip_sta(const char* str) {
 
     lwespi_parse_mac(&str, &mac);               /* Parse MAC address */
     lwespi_parse_ip(&str, &ip);                 /* Parse IP address */
+#if LWESP_CFG_AP_STA_TABLE > 0
+    lwespi_ap_sta_table_set(&mac, &ip);
+#endif /* LWESP_CFG_AP_STA_TABLE > 0 */
 
     esp.evt.evt.ap_ip_sta.mac = &mac;
     esp.evt.evt.ap_ip_sta.ip = &ip;
@@ -640,6 +996,9 @@ lwespi_parse_cipdomain(const char* str, lwesp_msg_t* msg) {
         str += 11;
     }
     lwespi_parse_ip(&str, msg->msg.dns_getbyhostname.ip);   /* Parse IP address */
+#if LWESP_CFG_DNS_CACHE_SIZE > 0
+    lwespi_dns_cache_put(msg->msg.dns_getbyhostname.host, msg->msg.dns_getbyhostname.ip);
+#endif /* LWESP_CFG_DNS_CACHE_SIZE > 0 */
     return 1;
 }
 
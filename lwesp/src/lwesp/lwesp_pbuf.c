@@ -39,6 +39,103 @@
 #define SIZEOF_PBUF_STRUCT          LWESP_MEM_ALIGN(sizeof(lwesp_pbuf_t))
 #define SET_NEW_LEN(v, len)         do { if ((v) != NULL) { *(v) = (len); } } while (0)
 
+#if LWESP_CFG_PBUF_POOL_SIZE > 0 || __DOXYGEN__
+
+/* Number of `size_t` words for single pool entry of specific payload length */
+#define PBUF_POOL_ENTRY_WORDS(len)  ((SIZEOF_PBUF_STRUCT + LWESP_MEM_ALIGN(len) + sizeof(size_t) - 1) / sizeof(size_t))
+
+/**
+ * \brief           Packet buffer pool size class
+ */
+typedef struct {
+    size_t len;                                 /*!< Payload length of every entry */
+    size_t entry_size;                          /*!< Size of single entry, including pbuf structure */
+    uint8_t* start;                             /*!< Start address of pool memory */
+    uint8_t* end;                               /*!< End address of pool memory */
+    lwesp_pbuf_p free_list;                     /*!< List of free entries, linked with `next` member */
+} pbuf_pool_t;
+
+/* Pool memory, size_t type keeps alignment */
+static size_t pool_mem_small[LWESP_CFG_PBUF_POOL_SIZE * PBUF_POOL_ENTRY_WORDS(LWESP_CFG_PBUF_POOL_SMALL_LEN)];
+static size_t pool_mem_medium[LWESP_CFG_PBUF_POOL_SIZE * PBUF_POOL_ENTRY_WORDS(LWESP_CFG_PBUF_POOL_MEDIUM_LEN)];
+static size_t pool_mem_large[LWESP_CFG_PBUF_POOL_SIZE * PBUF_POOL_ENTRY_WORDS(LWESP_CFG_PBUF_POOL_LARGE_LEN)];
+
+/* List of pools, sorted by payload length */
+static pbuf_pool_t pools[] = {
+    { LWESP_CFG_PBUF_POOL_SMALL_LEN, PBUF_POOL_ENTRY_WORDS(LWESP_CFG_PBUF_POOL_SMALL_LEN) * sizeof(size_t), (uint8_t*)pool_mem_small, (uint8_t*)pool_mem_small + sizeof(pool_mem_small), NULL },
+    { LWESP_CFG_PBUF_POOL_MEDIUM_LEN, PBUF_POOL_ENTRY_WORDS(LWESP_CFG_PBUF_POOL_MEDIUM_LEN) * sizeof(size_t), (uint8_t*)pool_mem_medium, (uint8_t*)pool_mem_medium + sizeof(pool_mem_medium), NULL },
+    { LWESP_CFG_PBUF_POOL_LARGE_LEN, PBUF_POOL_ENTRY_WORDS(LWESP_CFG_PBUF_POOL_LARGE_LEN) * sizeof(size_t), (uint8_t*)pool_mem_large, (uint8_t*)pool_mem_large + sizeof(pool_mem_large), NULL },
+};
+static uint8_t pools_initialized;
+
+/**
+ * \brief           Get packet buffer from pool
+ * \note            Function must be called with core locked
+ * \param[in]       len: Required payload length
+ * \return          Pointer to pbuf on success, `NULL` if no pool entry available
+ */
+static lwesp_pbuf_p
+pbuf_pool_get(size_t len) {
+    lwesp_pbuf_p p;
+
+    /* Build free lists on first use */
+    if (!pools_initialized) {
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(pools); ++i) {
+            for (uint8_t* m = pools[i].start; m + pools[i].entry_size <= pools[i].end; m += pools[i].entry_size) {
+                p = (void*)m;
+                p->next = pools[i].free_list;
+                pools[i].free_list = p;
+            }
+        }
+        pools_initialized = 1;
+    }
+
+    /* Use smallest class with free entry */
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(pools); ++i) {
+        if (pools[i].len >= len && pools[i].free_list != NULL) {
+            p = pools[i].free_list;
+            pools[i].free_list = p->next;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Return packet buffer to pool it belongs to
+ * \note            Function must be called with core locked
+ * \param[in]       p: Packet buffer to return
+ * \return          `1` if pbuf was part of pool, `0` otherwise
+ */
+static uint8_t
+pbuf_pool_put(lwesp_pbuf_p p) {
+    uint8_t* m = (void*)p;
+
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(pools); ++i) {
+        if (m >= pools[i].start && m < pools[i].end) {
+            p->next = pools[i].free_list;
+            pools[i].free_list = p;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#if LWESP_CFG_STATIC_ONLY
+
+/**
+ * \brief           Get size of static packet buffer pools
+ * \return          Size in units of bytes
+ */
+size_t
+lwespi_pbuf_get_static_ram_size(void) {
+    return sizeof(pool_mem_small) + sizeof(pool_mem_medium) + sizeof(pool_mem_large) + sizeof(pools);
+}
+
+#endif /* LWESP_CFG_STATIC_ONLY */
+
+#endif /* LWESP_CFG_PBUF_POOL_SIZE > 0 || __DOXYGEN__ */
+
 /**
  * \brief           Skip pbufs for desired offset
  * \param[in]       p: Source pbuf to skip
@@ -62,6 +159,31 @@ pbuf_skip(lwesp_pbuf_p p, size_t off, size_t* new_off) {
     return p;
 }
 
+/**
+ * \brief           Check if data match pbuf chain memory at offset in specific pbuf
+ *
+ * Comparison continues over next pbufs in chain when data cross pbuf boundary
+ *
+ * \param[in]       p: Pbuf where comparison starts
+ * \param[in]       off: Offset in `p` where comparison starts
+ * \param[in]       d: Data to compare with
+ * \param[in]       len: Length of data in units of bytes
+ * \return          `1` if memory matches, `0` otherwise
+ */
+static uint8_t
+pbuf_match(lwesp_pbuf_p p, size_t off, const uint8_t* d, size_t len) {
+    for (size_t i = 0, n; i < len; i += n, p = p->next, off = 0) {
+        if (p == NULL) {
+            return 0;
+        }
+        n = LWESP_MIN(p->len - off, len - i);
+        if (memcmp(&p->payload[off], &d[i], n)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
 /**
  * \brief           Allocate packet buffer for network data of specific size
  * \param[in]       len: Length of payload memory to allocate
@@ -69,9 +191,34 @@ pbuf_skip(lwesp_pbuf_p p, size_t off, size_t* new_off) {
  */
 lwesp_pbuf_p
 lwesp_pbuf_new(size_t len) {
-    lwesp_pbuf_p p;
+    return lwesp_pbuf_new_ex(len, 0);
+}
+
+/**
+ * \brief           Allocate packet buffer with reserved headroom in front of payload
+ *
+ * Headroom is not part of payload length. It can be claimed later with \ref lwesp_pbuf_header
+ * to prepend protocol header in place, without copying payload to new buffer
+ *
+ * \param[in]       len: Length of payload memory to allocate
+ * \param[in]       headroom: Number of bytes to reserve in front of payload
+ * \return          Pointer to allocated memory, `NULL` otherwise
+ */
+lwesp_pbuf_p
+lwesp_pbuf_new_ex(size_t len, size_t headroom) {
+    lwesp_pbuf_p p = NULL;
 
-    p = lwesp_mem_malloc(SIZEOF_PBUF_STRUCT + sizeof(*p->payload) * len);
+#if LWESP_CFG_PBUF_POOL_SIZE > 0
+    lwesp_core_lock();
+    p = pbuf_pool_get(headroom + len);          /* Try pool first */
+    lwesp_core_unlock();
+#endif /* LWESP_CFG_PBUF_POOL_SIZE > 0 */
+#if !LWESP_CFG_STATIC_ONLY
+    if (p == NULL) {
+        p = lwesp_mem_malloc_tag(SIZEOF_PBUF_STRUCT + sizeof(*p->payload) * (headroom + len), LWESP_MEM_TAG_PBUF);
+    }
+#endif /* !LWESP_CFG_STATIC_ONLY */
+    LWESPI_TRACE(PBUF_NEW, len, p != NULL);
     LWESP_DEBUGW(LWESP_CFG_DBG_PBUF | LWESP_DBG_TYPE_TRACE, p == NULL,
                "[PBUF] Failed to allocate %d bytes\r\n", (int)len);
     LWESP_DEBUGW(LWESP_CFG_DBG_PBUF | LWESP_DBG_TYPE_TRACE, p != NULL,
@@ -80,12 +227,74 @@ lwesp_pbuf_new(size_t len) {
         p->next = NULL;                         /* No next element in chain */
         p->tot_len = len;                       /* Set total length of pbuf chain */
         p->len = len;                           /* Set payload length */
-        p->payload = (void*)(((char*)p) + SIZEOF_PBUF_STRUCT);  /* Set pointer to payload data */
+        p->payload = (void*)(((char*)p) + SIZEOF_PBUF_STRUCT + headroom);   /* Set pointer to payload data */
         p->ref = 1;                             /* Single reference is used on this pbuf */
+        p->parent = NULL;                       /* Payload memory is owned by this pbuf */
+#if LWESP_CFG_IPD_ZERO_COPY
+        p->is_ref = 0;                          /* Payload is part of pbuf memory */
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
+    }
+    return p;
+}
+
+/**
+ * \brief           Allocate packet buffer structure without payload memory
+ *
+ * With \ref LWESP_CFG_STATIC_ONLY, entry of smallest pool class is used.
+ *
+ * \return          Pointer to allocated memory, `NULL` otherwise
+ */
+static lwesp_pbuf_p
+pbuf_new_hdr(void) {
+    lwesp_pbuf_p p;
+
+#if LWESP_CFG_STATIC_ONLY
+    lwesp_core_lock();
+    p = pbuf_pool_get(0);                       /* Smallest class, its payload memory stays unused */
+    lwesp_core_unlock();
+#else /* LWESP_CFG_STATIC_ONLY */
+    p = lwesp_mem_malloc_tag(SIZEOF_PBUF_STRUCT, LWESP_MEM_TAG_PBUF_HDR);
+#endif /* !LWESP_CFG_STATIC_ONLY */
+    if (p != NULL) {
+        LWESP_MEMSET(p, 0x00, sizeof(*p));
+    }
+    return p;
+}
+
+#if LWESP_CFG_IPD_ZERO_COPY || __DOXYGEN__
+
+/**
+ * \brief           Allocate packet buffer which references existing input buffer memory
+ *
+ * Only pbuf structure is allocated, payload points directly to input buffer.
+ * With \ref LWESP_CFG_STATIC_ONLY, entry of smallest pool class is used.
+ * Input buffer memory is held until pbuf is freed with \ref lwesp_pbuf_free
+ *
+ * \note            This function may only be called from processing thread with core locked
+ * \param[in]       payload: Pointer to payload in input buffer
+ * \param[in]       len: Length of payload in units of bytes
+ * \return          Pointer to allocated memory, `NULL` otherwise
+ */
+lwesp_pbuf_p
+lwespi_pbuf_new_ref(void* payload, size_t len) {
+    lwesp_pbuf_p p;
+
+    p = pbuf_new_hdr();
+    LWESP_DEBUGW(LWESP_CFG_DBG_PBUF | LWESP_DBG_TYPE_TRACE, p == NULL,
+               "[PBUF] Failed to allocate reference pbuf for %d bytes\r\n", (int)len);
+    if (p != NULL) {
+        p->tot_len = len;
+        p->len = len;
+        p->payload = payload;                   /* Reference existing memory */
+        p->ref = 1;
+        p->is_ref = 1;
+        ++esp.buff_ref_cnt;                     /* Hold input buffer memory */
     }
     return p;
 }
 
+#endif /* LWESP_CFG_IPD_ZERO_COPY || __DOXYGEN__ */
+
 /**
  * \brief           Free previously allocated packet buffer
  * \param[in]       pbuf: Packet buffer to free
@@ -111,7 +320,27 @@ lwesp_pbuf_free(lwesp_pbuf_p pbuf) {
             LWESP_DEBUGF(LWESP_CFG_DBG_PBUF | LWESP_DBG_TYPE_TRACE,
                        "[PBUF] Deallocating %p with len/tot_len: %d/%d\r\n", p, (int)p->len, (int)p->tot_len);
             pn = p->next;                       /* Save next entry */
-            lwesp_mem_free_s((void**)&p);       /* Free memory for pbuf */
+#if LWESP_CFG_IPD_ZERO_COPY
+            if (p->is_ref) {
+                lwesp_core_lock();
+                lwespi_process_buffer_ref_release();/* Release input buffer memory */
+                lwesp_core_unlock();
+            }
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
+            if (p->parent != NULL) {            /* Slice releases pbuf owning its payload */
+                lwesp_pbuf_free(p->parent);
+            }
+#if LWESP_CFG_PBUF_POOL_SIZE > 0
+            lwesp_core_lock();
+            if (pbuf_pool_put(p)) {             /* Return to pool if it belongs to one */
+                p = NULL;
+            }
+            lwesp_core_unlock();
+            if (p != NULL)
+#endif /* LWESP_CFG_PBUF_POOL_SIZE > 0 */
+            {
+                lwesp_mem_free_s((void**)&p);   /* Free memory for pbuf */
+            }
             p = pn;                             /* Restore with next entry */
             ++cnt;                              /* Increase number of freed pbufs */
         } else {
@@ -121,6 +350,57 @@ lwesp_pbuf_free(lwesp_pbuf_p pbuf) {
     return cnt;
 }
 
+/**
+ * \brief           Create view of part of packet buffer chain without copying payload
+ *
+ * Function allocates only pbuf structures, one for every pbuf in chain covered by range.
+ * Their payload points to memory of original chain, which is referenced
+ * and kept valid until slice is freed with \ref lwesp_pbuf_free.
+ * Original chain may be freed by its owner before slice
+ *
+ * \note            Payload memory is shared, writing to slice modifies original chain
+ * \param[in]       pbuf: Packet buffer chain to slice
+ * \param[in]       offset: Start offset of slice in chain
+ * \param[in]       len: Length of slice in units of bytes
+ * \return          New pbuf chain on success, `NULL` otherwise
+ */
+lwesp_pbuf_p
+lwesp_pbuf_slice(const lwesp_pbuf_p pbuf, size_t offset, size_t len) {
+    lwesp_pbuf_p p, s, head = NULL, last = NULL;
+
+    if (pbuf == NULL || len == 0 || offset > pbuf->tot_len || len > pbuf->tot_len - offset) {
+        return NULL;
+    }
+    p = pbuf_skip(pbuf, offset, &offset);
+    for (size_t rem = len, n; rem > 0; rem -= n, p = p->next, offset = 0) {
+        n = LWESP_MIN(p->len - offset, rem);
+        if ((s = pbuf_new_hdr()) == NULL) {
+            if (head != NULL) {
+                lwesp_pbuf_free(head);
+            }
+            return NULL;
+        }
+        s->tot_len = rem;
+        s->len = n;
+        s->payload = p->payload + offset;
+        s->ref = 1;
+        s->parent = p->parent != NULL ? p->parent : p;  /* Slice of slice references the owner directly */
+        s->ip = p->ip;
+        s->port = p->port;
+        lwesp_core_lock();
+        ++s->parent->ref;                       /* Keep owner and its payload alive */
+        lwesp_core_unlock();
+
+        if (last == NULL) {
+            head = s;
+        } else {
+            last->next = s;
+        }
+        last = s;
+    }
+    return head;
+}
+
 /**
  * \brief           Concatenate `2` packet buffers together to one big packet
  * \note            After `tail` pbuf has been added to `head` pbuf chain,
@@ -334,15 +614,46 @@ lwesp_pbuf_get_at(const lwesp_pbuf_p pbuf, size_t pos, uint8_t* el) {
  */
 size_t
 lwesp_pbuf_memfind(const lwesp_pbuf_p pbuf, const void* needle, size_t len, size_t off) {
-    if (pbuf != NULL && needle != NULL && pbuf->tot_len >= (len + off)) {   /* Check if valid entries */
-        /*
-         * Try entire buffer element by element
-         * and in case we have a match, report it
-         */
-        for (size_t i = off; i <= pbuf->tot_len - len; ++i) {
-            if (!lwesp_pbuf_memcmp(pbuf, needle, len, i)) { /* Check if identical */
-                return i;                       /* We have a match! */
+    const uint8_t* n = needle;
+    const uint8_t* f;
+    lwesp_pbuf_p p;
+    size_t pos, last;
+
+    if (pbuf == NULL || needle == NULL || len == 0  /* Check if valid entries */
+        || pbuf->tot_len < (len + off)) {
+        return LWESP_SIZET_MAX;
+    }
+    last = pbuf->tot_len - len;                 /* Last position where needle may start */
+
+    /* Find pbuf with start offset, `pos` is offset of its first byte in chain */
+    for (p = pbuf, pos = 0; p != NULL && p->len <= off; p = p->next) {
+        pos += p->len;
+        off -= p->len;
+    }
+
+    /*
+     * Single pass over the chain with pbuf cursor:
+     * find candidate by first needle byte in current pbuf,
+     * then compare remaining bytes, which may continue in next pbufs
+     */
+    while (p != NULL && pos + off <= last) {
+        f = memchr(&p->payload[off], n[0], p->len - off);
+        if (f != NULL) {
+            off = (size_t)(f - p->payload);
+            if (pos + off > last) {
+                break;
+            }
+            if (pbuf_match(p, off, n, len)) {
+                return pos + off;               /* We have a match! */
             }
+            ++off;
+        } else {
+            off = p->len;
+        }
+        if (off >= p->len) {                    /* Continue in next pbuf */
+            pos += p->len;
+            off = 0;
+            p = p->next;
         }
     }
     return LWESP_SIZET_MAX;                     /* Return maximal value of size_t variable to indicate error */
@@ -374,7 +685,6 @@ lwesp_pbuf_strfind(const lwesp_pbuf_p pbuf, const char* str, size_t off) {
 size_t
 lwesp_pbuf_memcmp(const lwesp_pbuf_p pbuf, const void* data, size_t len, size_t offset) {
     lwesp_pbuf_p p;
-    uint8_t el;
     const uint8_t* d = data;
 
     if (pbuf == NULL || data == NULL || len == 0/* Input parameters check */
@@ -392,16 +702,9 @@ lwesp_pbuf_memcmp(const lwesp_pbuf_p pbuf, const void* data, size_t len, size_t
 
     /*
      * We have known starting pbuf.
-     * Now it is time to check byte by byte from pbuf and memory
-     *
-     * Use byte by byte read function to inspect bytes separatelly
+     * Compare memory pbuf by pbuf, without walking the chain again
      */
-    for (size_t i = 0; i < len; ++i) {
-        if (!lwesp_pbuf_get_at(p, offset + i, &el) || el != d[i]) { /* Get value from pbuf at specific offset */
-            return offset + 1;                  /* Return value from offset where it failed */
-        }
-    }
-    return 0;                                   /* Memory matches at this point */
+    return pbuf_match(p, offset, d, len) ? 0 : offset + 1;
 }
 
 /**
@@ -447,6 +750,131 @@ lwesp_pbuf_get_linear_addr(const lwesp_pbuf_p pbuf, size_t offset, size_t* new_l
     return &p->payload[offset];                 /* Return memory at desired offset */
 }
 
+/**
+ * \brief           Move cursor forward
+ * \param[in]       cur: Cursor to move
+ * \param[in]       len: Number of bytes to move, must not exceed remaining bytes
+ */
+static void
+pbuf_cursor_advance(lwesp_pbuf_cursor_t* cur, size_t len) {
+    cur->rem -= len;
+    len += cur->off;
+    while (cur->p != NULL && len >= cur->p->len) {  /* Current pbuf is consumed, go to next one */
+        len -= cur->p->len;
+        cur->p = cur->p->next;
+    }
+    cur->off = len;
+}
+
+/**
+ * \brief           Initialize cursor at specific offset in pbuf chain
+ * \param[out]      cur: Cursor to initialize
+ * \param[in]       pbuf: Pbuf chain to traverse
+ * \param[in]       offset: Start offset in pbuf chain
+ * \return          `1` on success, `0` if offset is too big for pbuf chain
+ */
+uint8_t
+lwesp_pbuf_cursor_init(lwesp_pbuf_cursor_t* cur, const lwesp_pbuf_p pbuf, size_t offset) {
+    if (cur == NULL) {
+        return 0;
+    }
+    cur->p = NULL;
+    cur->off = 0;
+    cur->rem = 0;
+    if (pbuf == NULL || pbuf->tot_len < offset) {
+        return 0;
+    }
+    cur->rem = pbuf->tot_len - offset;
+    cur->p = pbuf_skip(pbuf, offset, &cur->off);
+    return 1;
+}
+
+/**
+ * \brief           Read single byte at cursor and move cursor forward
+ * \param[in,out]   cur: Cursor
+ * \param[out]      el: Output variable to save byte value
+ * \return          `1` on success, `0` if there are no more bytes
+ */
+uint8_t
+lwesp_pbuf_cursor_next_byte(lwesp_pbuf_cursor_t* cur, uint8_t* el) {
+    if (cur == NULL || cur->rem == 0) {
+        return 0;
+    }
+    *el = cur->p->payload[cur->off];
+    pbuf_cursor_advance(cur, 1);
+    return 1;
+}
+
+/**
+ * \brief           Copy bytes at cursor to linear memory and move cursor forward
+ * \param[in,out]   cur: Cursor
+ * \param[out]      data: Memory to copy data to
+ * \param[in]       len: Number of bytes to copy
+ * \return          Number of bytes copied, lower than `len` if chain ends before
+ */
+size_t
+lwesp_pbuf_cursor_read(lwesp_pbuf_cursor_t* cur, void* data, size_t len) {
+    uint8_t* d = data;
+    size_t tot, n;
+
+    if (cur == NULL || data == NULL) {
+        return 0;
+    }
+    len = tot = LWESP_MIN(len, cur->rem);
+    for (; len > 0; len -= n, d += n) {
+        n = LWESP_MIN(cur->p->len - cur->off, len);
+        LWESP_MEMCPY(d, &cur->p->payload[cur->off], n);
+        pbuf_cursor_advance(cur, n);
+    }
+    return tot;
+}
+
+/**
+ * \brief           Get linear memory at cursor position, without moving cursor
+ *
+ * Memory ends at the end of current pbuf, use \ref lwesp_pbuf_cursor_skip
+ * to move to data in next pbuf
+ *
+ * \param[in]       cur: Cursor
+ * \param[out]      len: Output variable to save length of linear memory in units of bytes
+ * \return          Pointer to memory on success, `NULL` if there are no more bytes
+ */
+void*
+lwesp_pbuf_cursor_peek_linear(const lwesp_pbuf_cursor_t* cur, size_t* len) {
+    if (cur == NULL || cur->rem == 0) {
+        SET_NEW_LEN(len, 0);
+        return NULL;
+    }
+    SET_NEW_LEN(len, LWESP_MIN(cur->p->len - cur->off, cur->rem));
+    return &cur->p->payload[cur->off];
+}
+
+/**
+ * \brief           Move cursor forward
+ * \param[in,out]   cur: Cursor
+ * \param[in]       len: Number of bytes to skip
+ * \return          Number of bytes skipped, lower than `len` if chain ends before
+ */
+size_t
+lwesp_pbuf_cursor_skip(lwesp_pbuf_cursor_t* cur, size_t len) {
+    if (cur == NULL) {
+        return 0;
+    }
+    len = LWESP_MIN(len, cur->rem);
+    pbuf_cursor_advance(cur, len);
+    return len;
+}
+
+/**
+ * \brief           Get number of bytes from cursor to the end of pbuf chain
+ * \param[in]       cur: Cursor
+ * \return          Number of remaining bytes
+ */
+size_t
+lwesp_pbuf_cursor_remaining(const lwesp_pbuf_cursor_t* cur) {
+    return cur != NULL ? cur->rem : 0;
+}
+
 /**
  * \brief           Get data pointer from packet buffer
  * \param[in]       pbuf: Packet buffer
@@ -503,6 +931,74 @@ lwesp_pbuf_set_ip(lwesp_pbuf_p pbuf, const lwesp_ip_t* ip, lwesp_port_t port) {
     }
 }
 
+/**
+ * \brief           Get IP address and port number of remote side for received data
+ * \param[in]       pbuf: Packet buffer
+ * \param[out]      ip: Output variable to save IP address to. Can be set to `NULL`
+ * \param[out]      port: Output variable to save port number to. Can be set to `NULL`
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwesp_pbuf_get_ip(const lwesp_pbuf_p pbuf, lwesp_ip_t* ip, lwesp_port_t* port) {
+    if (pbuf == NULL) {
+        return 0;
+    }
+    if (ip != NULL) {
+        LWESP_MEMCPY(ip, &pbuf->ip, sizeof(*ip));
+    }
+    if (port != NULL) {
+        *port = pbuf->port;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Get number of free bytes in front of pbuf payload
+ * \param[in]       pbuf: Packet buffer
+ * \return          Headroom in units of bytes, `0` for referenced payload or slice
+ */
+size_t
+lwesp_pbuf_headroom(const lwesp_pbuf_p pbuf) {
+    if (pbuf == NULL || pbuf->parent != NULL) {  /* Memory in front of slice belongs to its owner */
+        return 0;
+    }
+#if LWESP_CFG_IPD_ZERO_COPY
+    if (pbuf->is_ref) {                         /* Memory in front belongs to input buffer */
+        return 0;
+    }
+#endif /* LWESP_CFG_IPD_ZERO_COPY */
+    return (size_t)(pbuf->payload - ((uint8_t*)pbuf + SIZEOF_PBUF_STRUCT));
+}
+
+/**
+ * \brief           Move payload start of first pbuf in chain to push or pull protocol header
+ *
+ * Positive `delta` grows payload towards its front into headroom, so that header can be written in place.
+ * Negative `delta` removes bytes from payload front and returns them to headroom
+ *
+ * \note            Only first pbuf is modified, other pbufs in chain are not adjusted
+ * \param[in]       pbuf: Packet buffer
+ * \param[in]       delta: Number of bytes to push (positive) or pull (negative)
+ * \return          `1` on success, `0` when there is not enough headroom or payload
+ */
+uint8_t
+lwesp_pbuf_header(lwesp_pbuf_p pbuf, int delta) {
+    if (pbuf == NULL) {
+        return 0;
+    }
+    if (delta > 0) {
+        if ((size_t)delta > lwesp_pbuf_headroom(pbuf)) {
+            return 0;
+        }
+    } else if ((size_t)(-delta) > pbuf->len) {
+        return 0;
+    }
+    pbuf->payload -= delta;
+    pbuf->len += delta;
+    pbuf->tot_len += delta;
+    return 1;
+}
+
 /**
  * \brief           Advance pbuf payload pointer by number of len bytes.
  *                  It can only advance single pbuf in a chain
@@ -517,26 +1013,10 @@ lwesp_pbuf_set_ip(lwesp_pbuf_p pbuf, const lwesp_ip_t* ip, lwesp_port_t port) {
  */
 uint8_t
 lwesp_pbuf_advance(lwesp_pbuf_p pbuf, int len) {
-    uint8_t process = 0;
-    if (pbuf == NULL || len == 0) {
+    if (len == 0) {
         return 0;
     }
-    if (len > 0) {                              /* When we want to decrease size */
-        if ((size_t)len <= pbuf->len) {         /* Is there space to decrease? */
-            process = 1;
-        }
-    } else {
-        /* Is current payload + new len still higher than pbuf structure? */
-        if (((uint8_t*)pbuf + SIZEOF_PBUF_STRUCT) < (pbuf->payload + len)) {
-            process = 1;
-        }
-    }
-    if (process) {
-        pbuf->payload += len;                   /* Increase payload pointer */
-        pbuf->tot_len -= len;                   /* Decrease length of pbuf chain */
-        pbuf->len -= len;                       /* Decrease length of current pbuf */
-    }
-    return process;
+    return lwesp_pbuf_header(pbuf, -len);
 }
 
 /**
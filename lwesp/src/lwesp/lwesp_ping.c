@@ -34,6 +34,7 @@
 #include "lwesp/lwesp_private.h"
 #include "lwesp/lwesp_ping.h"
 #include "lwesp/lwesp_mem.h"
+#include "lwesp/lwesp_timeout.h"
 
 #if LWESP_CFG_PING || __DOXYGEN__
 
@@ -62,4 +63,201 @@ lwesp_ping(const char* host, uint32_t* time,
     return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 30000);
 }
 
+#if LWESP_CFG_PING_MONITOR > 0 || __DOXYGEN__
+
+/**
+ * \brief           Monitored host
+ */
+typedef struct {
+    const char* host;                           /*!< Monitored host. `NULL` when entry is not used */
+    uint32_t interval;                          /*!< Time between pings in units of milliseconds */
+    lwesp_timeout_id_t timeout_id;              /*!< Timeout of next ping */
+    uint32_t time;                              /*!< Result of ping in progress */
+    uint8_t pending;                            /*!< Ping command is in queue or in progress */
+    uint64_t sum;                               /*!< Sum of all round trip times for average */
+    uint32_t jitter_x16;                        /*!< Jitter estimation, multiplied by `16` */
+    lwesp_ping_stats_t stats;                   /*!< Statistics */
+} ping_monitor_t;
+
+static ping_monitor_t monitors[LWESP_CFG_PING_MONITOR];
+
+/**
+ * \brief           Find monitor entry for host
+ * \note            Function must be called with core locked
+ * \param[in]       host: Host name or IP address
+ * \return          Entry on success, `NULL` otherwise
+ */
+static ping_monitor_t*
+ping_monitor_find(const char* host) {
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(monitors); ++i) {
+        if (monitors[i].host != NULL && !strcmp(monitors[i].host, host)) {
+            return &monitors[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Ping command finished callback
+ * \param[in]       res: Result of command
+ * \param[in]       arg: Monitor entry
+ */
+static void
+ping_monitor_done_cb(lwespr_t res, void* arg) {
+    ping_monitor_t* m = arg;
+    lwesp_ping_stats_t* s = &m->stats;
+
+    lwesp_core_lock();
+    m->pending = 0;
+    if (m->host != NULL && res == lwespOK) {    /* Entry may be removed in the meantime */
+        if (s->received > 0) {
+            uint32_t d = m->time > s->last ? m->time - s->last : s->last - m->time;
+
+            /* J = J + (|D| - J) / 16, kept in fixed point to not lose small changes */
+            m->jitter_x16 = m->jitter_x16 + d - ((m->jitter_x16 + 8) >> 4);
+            s->min = LWESP_MIN(s->min, m->time);
+            s->max = LWESP_MAX(s->max, m->time);
+        } else {
+            s->min = s->max = m->time;
+        }
+        ++s->received;
+        s->last = m->time;
+        m->sum += m->time;
+        s->avg = (uint32_t)(m->sum / s->received);
+        s->jitter = (m->jitter_x16 + 8) >> 4;
+    }
+    lwesp_core_unlock();
+}
+
+/**
+ * \brief           Timeout callback to send next ping
+ * \param[in]       arg: Monitor entry
+ */
+static void
+ping_monitor_timeout_cb(void* arg) {
+    ping_monitor_t* m = arg;
+
+    m->timeout_id = lwesp_timeout_addex(m->interval, ping_monitor_timeout_cb, m);
+    if (!m->pending) {                          /* At most one ping per host is queued */
+        m->pending = 1;
+        if (lwesp_ping(m->host, &m->time, ping_monitor_done_cb, m, 0) == lwespOK) {
+            ++m->stats.sent;
+        } else {
+            m->pending = 0;
+        }
+    }
+}
+
+/**
+ * \brief           Start monitoring round trip time to host in background
+ *
+ * Host is pinged periodically at low command priority, with at most one ping
+ * per host in the queue at any time. Statistics are read with \ref lwesp_ping_monitor_get_stats.
+ *
+ * \param[in]       host: Host name or IP address. String must stay valid until \ref lwesp_ping_monitor_remove is called
+ * \param[in]       interval: Time between pings in units of milliseconds
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_ping_monitor_add(const char* host, uint32_t interval) {
+    ping_monitor_t* m = NULL;
+    lwespr_t res = lwespOK;
+
+    LWESP_ASSERT("host != NULL", host != NULL);
+    LWESP_ASSERT("interval > 0", interval > 0);
+
+    lwesp_core_lock();
+    if (ping_monitor_find(host) != NULL) {
+        res = lwespERR;                         /* Host is already monitored */
+    } else {
+        for (size_t i = 0; i < LWESP_ARRAYSIZE(monitors); ++i) {
+            if (monitors[i].host == NULL && !monitors[i].pending) {
+                m = &monitors[i];
+                break;
+            }
+        }
+        if (m == NULL) {
+            res = lwespERRMEM;
+        } else {
+            LWESP_MEMSET(m, 0x00, sizeof(*m));
+            m->host = host;
+            m->interval = interval;
+            m->timeout_id = lwesp_timeout_addex(0, ping_monitor_timeout_cb, m);
+            if (m->timeout_id == 0) {
+                m->host = NULL;
+                res = lwespERRMEM;
+            }
+        }
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Stop monitoring host
+ * \param[in]       host: Host name or IP address, as passed to \ref lwesp_ping_monitor_add
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_ping_monitor_remove(const char* host) {
+    ping_monitor_t* m;
+
+    LWESP_ASSERT("host != NULL", host != NULL);
+
+    lwesp_core_lock();
+    if ((m = ping_monitor_find(host)) != NULL) {
+        lwesp_timeout_cancel(m->timeout_id);
+        m->host = NULL;                         /* Entry is reused once pending ping finishes */
+    }
+    lwesp_core_unlock();
+    return m != NULL ? lwespOK : lwespERR;
+}
+
+/**
+ * \brief           Get round trip time statistics of monitored host
+ *
+ * Function does not block and does not send any command
+ *
+ * \param[in]       host: Host name or IP address, as passed to \ref lwesp_ping_monitor_add
+ * \param[out]      stats: Pointer to output statistics
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_ping_monitor_get_stats(const char* host, lwesp_ping_stats_t* stats) {
+    ping_monitor_t* m;
+
+    LWESP_ASSERT("host != NULL", host != NULL);
+    LWESP_ASSERT("stats != NULL", stats != NULL);
+
+    lwesp_core_lock();
+    if ((m = ping_monitor_find(host)) != NULL) {
+        LWESP_MEMCPY(stats, &m->stats, sizeof(*stats));
+    }
+    lwesp_core_unlock();
+    return m != NULL ? lwespOK : lwespERR;
+}
+
+/**
+ * \brief           Reset round trip time statistics of monitored host
+ * \param[in]       host: Host name or IP address, as passed to \ref lwesp_ping_monitor_add
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_ping_monitor_reset_stats(const char* host) {
+    ping_monitor_t* m;
+
+    LWESP_ASSERT("host != NULL", host != NULL);
+
+    lwesp_core_lock();
+    if ((m = ping_monitor_find(host)) != NULL) {
+        LWESP_MEMSET(&m->stats, 0x00, sizeof(m->stats));
+        m->sum = 0;
+        m->jitter_x16 = 0;
+    }
+    lwesp_core_unlock();
+    return m != NULL ? lwespOK : lwespERR;
+}
+
+#endif /* LWESP_CFG_PING_MONITOR > 0 || __DOXYGEN__ */
+
 #endif /* LWESP_CFG_PING || __DOXYGEN__ */
@@ -34,6 +34,7 @@
 #include "lwesp/lwesp_private.h"
 #include "lwesp/lwesp_sntp.h"
 #include "lwesp/lwesp_mem.h"
+#include "lwesp/lwesp_timeout.h"
 
 #if LWESP_CFG_SNTP || __DOXYGEN__
 
@@ -87,4 +88,244 @@ lwesp_sntp_gettime(lwesp_datetime_t* dt,
     return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 10000);
 }
 
+#if LWESP_CFG_SNTP_CLOCK || __DOXYGEN__
+
+/* Larger difference is treated as time change instead of drift */
+#define SNTP_CLOCK_STEP_MS                  60000
+/* Minimal time to accumulate corrections before drift estimation is updated */
+#define SNTP_CLOCK_DRIFT_MIN_TIME           60000
+
+/**
+ * \brief           Convert date and time to seconds since `1970-01-01 00:00:00`
+ * \param[in]       dt: Date and time
+ * \return          Number of seconds
+ */
+static uint32_t
+sntp_clock_dt_to_sec(const lwesp_datetime_t* dt) {
+    uint32_t y = dt->year, m = dt->month, days;
+
+    if (m <= 2) {                               /* Count years from March, leap day is last in a year */
+        --y;
+        m += 12;
+    }
+    days = 365 * y + y / 4 - y / 100 + y / 400 + (153 * (m - 3) + 2) / 5 + dt->date - 719469;
+    return days * 86400 + dt->hours * 3600 + dt->minutes * 60 + dt->seconds;
+}
+
+/**
+ * \brief           Convert seconds since `1970-01-01 00:00:00` to date and time
+ * \param[in]       sec: Number of seconds
+ * \param[out]      dt: Date and time to fill
+ */
+static void
+sntp_clock_sec_to_dt(uint32_t sec, lwesp_datetime_t* dt) {
+    uint32_t days = sec / 86400, era, doe, yoe, doy, mp;
+
+    sec %= 86400;
+    dt->hours = (uint8_t)(sec / 3600);
+    dt->minutes = (uint8_t)((sec / 60) % 60);
+    dt->seconds = (uint8_t)(sec % 60);
+    dt->day = (uint8_t)((days + 3) % 7 + 1);    /* 1970-01-01 was Thursday */
+
+    days += 719468;                             /* Shift to 0000-03-01 */
+    era = days / 146097;
+    doe = days - era * 146097;
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+    dt->date = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+    dt->month = (uint8_t)(mp < 10 ? mp + 3 : mp - 9);
+    dt->year = (uint16_t)(era * 400 + yoe + (dt->month <= 2));
+}
+
+/**
+ * \brief           Get interpolated clock value
+ * \note            Function must be called with core locked
+ * \param[in]       now: Current value of \ref lwesp_sys_now
+ * \return          Milliseconds since `1970-01-01 00:00:00`
+ */
+static uint64_t
+sntp_clock_now_ms(uint32_t now) {
+    uint32_t elapsed = now - esp.sntp_clock.base_time;
+
+    return esp.sntp_clock.base_ms + elapsed
+           + (int64_t)elapsed * esp.sntp_clock.drift_ppm / 1000000;
+}
+
+/**
+ * \brief           Timeout callback for periodic synchronization
+ * \param[in]       arg: Custom user argument
+ */
+static void
+sntp_clock_timeout_cb(void* arg) {
+    LWESP_UNUSED(arg);
+
+    esp.sntp_clock.sync_id = lwesp_timeout_addex(esp.sntp_clock.interval, sntp_clock_timeout_cb, NULL);
+    lwesp_sntp_gettime(&esp.sntp_clock.dt, NULL, NULL, 0);
+}
+
+/**
+ * \brief           Synchronize local clock with time received from device
+ *
+ * Device reports time with resolution of one second. When interpolated clock
+ * is within reported second, it is kept as-is. Otherwise it is moved to the
+ * nearest edge of reported second. Corrections are accumulated and used
+ * to update drift estimation once enough time passed, to average out response latency.
+ *
+ * \note            Function must be called with core locked
+ * \param[in]       dt: Date and time reported by device
+ */
+void
+lwespi_sntp_clock_sync(const lwesp_datetime_t* dt) {
+    uint32_t now = lwesp_sys_now(), elapsed;
+    uint64_t rep_ms, pred_ms;
+    int64_t err_ms;
+
+    if (dt->year < 2000) {                      /* Device has not received time from server yet */
+        return;
+    }
+    rep_ms = (uint64_t)sntp_clock_dt_to_sec(dt) * 1000;
+    if (!esp.sntp_clock.valid) {
+        esp.sntp_clock.base_ms = rep_ms;
+        esp.sntp_clock.base_time = now;
+        esp.sntp_clock.drift_ppm = 0;
+        esp.sntp_clock.drift_time = now;
+        esp.sntp_clock.drift_err = 0;
+        esp.sntp_clock.valid = 1;
+        return;
+    }
+
+    pred_ms = sntp_clock_now_ms(now);
+    if (pred_ms < rep_ms) {
+        err_ms = (int64_t)(rep_ms - pred_ms);   /* Local clock is behind */
+    } else if (pred_ms > rep_ms + 999) {
+        err_ms = -(int64_t)(pred_ms - (rep_ms + 999));  /* Local clock is ahead */
+    } else {
+        err_ms = 0;
+    }
+
+    if (err_ms > SNTP_CLOCK_STEP_MS || err_ms < -SNTP_CLOCK_STEP_MS) {
+        esp.sntp_clock.base_ms = rep_ms;        /* Time or time zone was changed, start over */
+        esp.sntp_clock.drift_ppm = 0;
+        esp.sntp_clock.drift_time = now;
+        esp.sntp_clock.drift_err = 0;
+    } else {
+        esp.sntp_clock.drift_err += (int32_t)err_ms;
+        elapsed = now - esp.sntp_clock.drift_time;
+        if (elapsed >= SNTP_CLOCK_DRIFT_MIN_TIME) {
+            /* Apply half of measured rate, corrections are quantized to edges of reported seconds */
+            int64_t drift = esp.sntp_clock.drift_ppm + (int64_t)esp.sntp_clock.drift_err * 500000 / elapsed;
+
+            if (drift > LWESP_CFG_SNTP_CLOCK_DRIFT_MAX) {
+                drift = LWESP_CFG_SNTP_CLOCK_DRIFT_MAX;
+            } else if (drift < -LWESP_CFG_SNTP_CLOCK_DRIFT_MAX) {
+                drift = -LWESP_CFG_SNTP_CLOCK_DRIFT_MAX;
+            }
+            esp.sntp_clock.drift_ppm = (int32_t)drift;
+            esp.sntp_clock.drift_time = now;
+            esp.sntp_clock.drift_err = 0;
+        }
+        esp.sntp_clock.base_ms = pred_ms + err_ms;
+    }
+    esp.sntp_clock.base_time = now;
+}
+
+/**
+ * \brief           Start periodic synchronization of local clock
+ *
+ * First synchronization is started immediately. SNTP must be enabled
+ * on device with \ref lwesp_sntp_set_config for time to become available.
+ * Any result of \ref lwesp_sntp_gettime synchronizes local clock too.
+ *
+ * \param[in]       interval: Synchronization interval in units of milliseconds.
+ *                      Set to `0` to use \ref LWESP_CFG_SNTP_CLOCK_SYNC_INTERVAL
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_sntp_clock_start(uint32_t interval) {
+    lwespr_t res = lwespOK;
+
+    lwesp_core_lock();
+    if (esp.sntp_clock.interval > 0) {
+        lwesp_timeout_cancel(esp.sntp_clock.sync_id);
+    }
+    esp.sntp_clock.interval = interval > 0 ? interval : LWESP_CFG_SNTP_CLOCK_SYNC_INTERVAL;
+    esp.sntp_clock.sync_id = lwesp_timeout_addex(0, sntp_clock_timeout_cb, NULL);
+    if (esp.sntp_clock.sync_id == 0) {
+        esp.sntp_clock.interval = 0;
+        res = lwespERRMEM;
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Stop periodic synchronization of local clock
+ *
+ * Clock keeps running from last synchronization
+ *
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_sntp_clock_stop(void) {
+    lwesp_core_lock();
+    if (esp.sntp_clock.interval > 0) {
+        lwesp_timeout_cancel(esp.sntp_clock.sync_id);
+        esp.sntp_clock.interval = 0;
+    }
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+/**
+ * \brief           Get seconds and milliseconds since `1970-01-01 00:00:00` from local clock
+ *
+ * Time is in time zone configured with \ref lwesp_sntp_set_config. No AT command is sent.
+ *
+ * \note            Interpolation needs at least one synchronization in about 49 days
+ * \param[out]      sec: Pointer to output variable for seconds
+ * \param[out]      ms: Pointer to output variable for milliseconds in a second. Set to `NULL` when not used
+ * \return          \ref lwespOK on success, \ref lwespERR when clock was not synchronized yet
+ */
+lwespr_t
+lwesp_sntp_clock_get_epoch(uint32_t* sec, uint16_t* ms) {
+    uint64_t now_ms;
+
+    LWESP_ASSERT("sec != NULL", sec != NULL);
+
+    lwesp_core_lock();
+    if (!esp.sntp_clock.valid) {
+        lwesp_core_unlock();
+        return lwespERR;
+    }
+    now_ms = sntp_clock_now_ms(lwesp_sys_now());
+    lwesp_core_unlock();
+
+    *sec = (uint32_t)(now_ms / 1000);
+    if (ms != NULL) {
+        *ms = (uint16_t)(now_ms % 1000);
+    }
+    return lwespOK;
+}
+
+/**
+ * \brief           Get date and time from local clock, without AT traffic
+ * \param[out]      dt: Pointer to \ref lwesp_datetime_t structure to fill with date and time values
+ * \return          \ref lwespOK on success, \ref lwespERR when clock was not synchronized yet
+ */
+lwespr_t
+lwesp_sntp_clock_gettime(lwesp_datetime_t* dt) {
+    uint32_t sec;
+    lwespr_t res;
+
+    LWESP_ASSERT("dt != NULL", dt != NULL);
+
+    if ((res = lwesp_sntp_clock_get_epoch(&sec, NULL)) == lwespOK) {
+        sntp_clock_sec_to_dt(sec, dt);
+    }
+    return res;
+}
+
+#endif /* LWESP_CFG_SNTP_CLOCK || __DOXYGEN__ */
+
 #endif /* LWESP_CFG_SNTP || __DOXYGEN__ */
@@ -102,7 +102,7 @@ lwesp_sta_autojoin(uint8_t en,
                  const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
     LWESP_MSG_VAR_DEFINE(msg);
 
-    LWESP_MSG_VAR_ALLOC(msg, blocking);
+    LWESP_MSG_VAR_ALLOC_CMD(msg, blocking, sta_autojoin);
     LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_WIFI_CWAUTOCONN;
     LWESP_MSG_VAR_REF(msg).msg.sta_autojoin.en = en;
@@ -164,6 +164,7 @@ lwesp_sta_get_ap_info(lwesp_sta_info_ap_t* info,
 
 /**
  * \brief           Get station IP address
+ * \note            With \ref LWESP_CFG_IP_MAC_CACHE enabled, cached value is returned when valid
  * \param[out]      ip: Pointer to variable to save IP address
  * \param[out]      gw: Pointer to output variable to save gateway address
  * \param[out]      nm: Pointer to output variable to save netmask address
@@ -177,6 +178,12 @@ lwesp_sta_getip(lwesp_ip_t* ip, lwesp_ip_t* gw, lwesp_ip_t* nm,
               const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
     LWESP_MSG_VAR_DEFINE(msg);
 
+#if LWESP_CFG_IP_MAC_CACHE
+    if (lwespi_ip_mac_cache_get_ip(&esp.m.sta, ip, gw, nm, evt_fn, evt_arg)) {
+        return lwespOK;
+    }
+#endif /* LWESP_CFG_IP_MAC_CACHE */
+
     LWESP_MSG_VAR_ALLOC(msg, blocking);
     LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_WIFI_CIPSTA_GET;
@@ -227,6 +234,7 @@ lwesp_sta_setip(const lwesp_ip_t* ip, const lwesp_ip_t* gw, const lwesp_ip_t* nm
 
 /**
  * \brief           Get station MAC address
+ * \note            With \ref LWESP_CFG_IP_MAC_CACHE enabled, cached value is returned when valid
  * \param[out]      mac: Pointer to output variable to save MAC address
  * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
  * \param[in]       evt_arg: Custom argument for event callback function
@@ -238,6 +246,12 @@ lwesp_sta_getmac(lwesp_mac_t* mac,
                const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
     LWESP_MSG_VAR_DEFINE(msg);
 
+#if LWESP_CFG_IP_MAC_CACHE
+    if (lwespi_ip_mac_cache_get_mac(&esp.m.sta, mac, evt_fn, evt_arg)) {
+        return lwespOK;
+    }
+#endif /* LWESP_CFG_IP_MAC_CACHE */
+
     LWESP_MSG_VAR_ALLOC(msg, blocking);
     LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_WIFI_CIPSTAMAC_GET;
@@ -354,6 +368,59 @@ lwesp_sta_list_ap(const char* ssid, lwesp_ap_t* aps, size_t apsl, size_t* apf,
     LWESP_MSG_VAR_REF(msg).msg.ap_list.aps = aps;
     LWESP_MSG_VAR_REF(msg).msg.ap_list.apsl = apsl;
     LWESP_MSG_VAR_REF(msg).msg.ap_list.apf = apf;
+    LWESP_MSG_VAR_REF(msg).msg.ap_list.fields = LWESP_STA_AP_FIELD_ALL;
+
+    return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 30000);
+}
+
+/**
+ * \brief           List available access points and report each of them as soon as it is received
+ *
+ * Unlike \ref lwesp_sta_list_ap, no array is needed. Function `ap_fn` is called from processing thread
+ * for every access point in the scan result and may stop the listing by returning `0`,
+ * for example when access point of interest has been found.
+ * Device cannot abort scan already in progress, remaining entries are ignored and command finishes
+ * as soon as device completes the scan.
+ *
+ * \note            When `fields` differ from \ref LWESP_STA_AP_FIELD_ALL,
+ *                      device report format is changed for this scan only and restored afterwards
+ *
+ * \param[in]       ssid: Optional SSID name to search for. Set to `NULL` to disable filter
+ * \param[in]       fields: Bit mask of \ref LWESP_STA_AP_FIELD fields device shall report.
+ *                      Set to `0` to report all fields
+ * \param[in]       ap_fn: Function called for every access point found
+ * \param[in]       ap_fn_arg: Custom argument for `ap_fn` function
+ * \param[out]      apf: Pointer to output variable to save number of access points reported
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_sta_list_ap_stream(const char* ssid, uint8_t fields, lwesp_sta_list_ap_fn ap_fn, void* const ap_fn_arg, size_t* apf,
+                         const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    LWESP_MSG_VAR_DEFINE(msg);
+
+    LWESP_ASSERT("ap_fn != NULL", ap_fn != NULL);
+    fields &= LWESP_STA_AP_FIELD_ALL;
+    if (fields == 0) {
+        fields = LWESP_STA_AP_FIELD_ALL;
+    }
+    if (apf != NULL) {
+        *apf = 0;
+    }
+
+    LWESP_MSG_VAR_ALLOC(msg, blocking);
+    LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_WIFI_CWLAP;
+    if (fields != LWESP_STA_AP_FIELD_ALL) {
+        LWESP_MSG_VAR_REF(msg).cmd = LWESP_CMD_WIFI_CWLAPOPT;   /* Set report format first */
+    }
+    LWESP_MSG_VAR_REF(msg).msg.ap_list.ssid = ssid;
+    LWESP_MSG_VAR_REF(msg).msg.ap_list.apf = apf;
+    LWESP_MSG_VAR_REF(msg).msg.ap_list.ap_fn = ap_fn;
+    LWESP_MSG_VAR_REF(msg).msg.ap_list.ap_fn_arg = ap_fn_arg;
+    LWESP_MSG_VAR_REF(msg).msg.ap_list.fields = fields;
 
     return lwespi_send_msg_to_producer_mbox(&LWESP_MSG_VAR_REF(msg), lwespi_initiate_cmd, 30000);
 }
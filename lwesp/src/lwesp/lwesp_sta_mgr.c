@@ -0,0 +1,428 @@
+/**
+ * \file            lwesp_sta_mgr.c
+ * \brief           Station manager with background scan and roaming
+ */
+
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include "lwesp/lwesp_private.h"
+#include "lwesp/lwesp_sta_mgr.h"
+#include "lwesp/lwesp_timeout.h"
+
+#if LWESP_CFG_STA_MGR || __DOXYGEN__
+
+#define STA_MGR_SCAN_FIELDS             (LWESP_STA_AP_FIELD_SSID | LWESP_STA_AP_FIELD_RSSI | LWESP_STA_AP_FIELD_MAC | LWESP_STA_AP_FIELD_CH)
+
+/* Manager state, protected by core lock */
+static const lwesp_sta_mgr_ap_t* mgr_aps;      /* List of known networks */
+static size_t mgr_aps_len;                      /* Number of entries in known networks list */
+static uint32_t mgr_interval;                   /* Background scan interval in units of milliseconds */
+static uint8_t mgr_active;                      /* Set to `1` when manager is running */
+static uint8_t mgr_scanning;                    /* Set to `1` when scan is in progress */
+static uint8_t mgr_joining;                     /* Set to `1` when join to candidate is in progress */
+static uint8_t mgr_rescanned;                   /* Set to `1` when full scan after failed candidates was done */
+static uint8_t mgr_scan_gen;                    /* Scan generation, to detect candidates not seen in last scan */
+static lwesp_timeout_id_t mgr_scan_to;          /* Timeout of next background scan */
+static lwesp_sta_mgr_cand_t mgr_cands[LWESP_CFG_STA_MGR_CANDIDATES];   /* Candidates, sorted by RSSI */
+static uint8_t mgr_cands_gen[LWESP_CFG_STA_MGR_CANDIDATES];    /* Scan generation each candidate was last seen in */
+static size_t mgr_cands_cnt;                    /* Number of valid candidates */
+static lwesp_sta_info_ap_t mgr_cur;             /* Access point station is connected to */
+static uint8_t mgr_cur_valid;                   /* Set to `1` when `mgr_cur` has valid data */
+static lwesp_mac_t mgr_join_bssid;              /* BSSID of join in progress */
+
+static void sta_mgr_scan(void);
+static void sta_mgr_join_next(void);
+static void sta_mgr_scan_to_cb(void* arg);
+
+/**
+ * \brief           Remove candidate from list
+ * \param[in]       idx: Index of candidate
+ */
+static void
+sta_mgr_cand_remove(size_t idx) {
+    for (; idx + 1 < mgr_cands_cnt; ++idx) {
+        mgr_cands[idx] = mgr_cands[idx + 1];
+        mgr_cands_gen[idx] = mgr_cands_gen[idx + 1];
+    }
+    --mgr_cands_cnt;
+}
+
+/**
+ * \brief           Move candidate to its position by RSSI, strongest first
+ * \param[in]       idx: Index of candidate with changed RSSI
+ */
+static void
+sta_mgr_cand_sort(size_t idx) {
+    lwesp_sta_mgr_cand_t c = mgr_cands[idx];
+    uint8_t gen = mgr_cands_gen[idx];
+
+    for (; idx > 0 && mgr_cands[idx - 1].rssi < c.rssi; --idx) {
+        mgr_cands[idx] = mgr_cands[idx - 1];
+        mgr_cands_gen[idx] = mgr_cands_gen[idx - 1];
+    }
+    for (; idx + 1 < mgr_cands_cnt && mgr_cands[idx + 1].rssi > c.rssi; ++idx) {
+        mgr_cands[idx] = mgr_cands[idx + 1];
+        mgr_cands_gen[idx] = mgr_cands_gen[idx + 1];
+    }
+    mgr_cands[idx] = c;
+    mgr_cands_gen[idx] = gen;
+}
+
+/**
+ * \brief           Join command finished callback
+ * \param[in]       res: Join result
+ * \param[in]       arg: Unused
+ */
+static void
+sta_mgr_join_cb(lwespr_t res, void* arg) {
+    LWESP_UNUSED(arg);
+
+    if (!mgr_active) {
+        mgr_joining = 0;
+        return;
+    }
+    if (res == lwespOK) {
+        mgr_joining = 0;
+        LWESP_DEBUGF(LWESP_CFG_DBG_STA_MGR | LWESP_DBG_TYPE_TRACE,
+                   "[STA MGR] Joined candidate\r\n");
+        return;
+    }
+
+    /* Candidate is not reachable anymore */
+    for (size_t i = 0; i < mgr_cands_cnt; ++i) {
+        if (!memcmp(&mgr_cands[i].bssid, &mgr_join_bssid, sizeof(mgr_join_bssid))) {
+            sta_mgr_cand_remove(i);
+            break;
+        }
+    }
+    sta_mgr_join_next();
+}
+
+/**
+ * \brief           Join strongest candidate, full scan is started when there are none left
+ */
+static void
+sta_mgr_join_next(void) {
+    while (mgr_cands_cnt > 0) {
+        lwesp_sta_mgr_cand_t* c = &mgr_cands[0];
+        const lwesp_sta_mgr_ap_t* ap = &mgr_aps[c->ap_idx];
+
+        LWESP_DEBUGF(LWESP_CFG_DBG_STA_MGR | LWESP_DBG_TYPE_TRACE,
+                   "[STA MGR] Joining %s on channel %d, RSSI %d\r\n", ap->ssid, (int)c->ch, (int)c->rssi);
+        LWESP_MEMCPY(&mgr_join_bssid, &c->bssid, sizeof(mgr_join_bssid));
+        mgr_joining = 1;
+        if (lwesp_sta_join(ap->ssid, ap->pass, &mgr_join_bssid, sta_mgr_join_cb, NULL, 0) == lwespOK) {
+            return;
+        }
+        sta_mgr_cand_remove(0);
+    }
+    mgr_joining = 0;
+    if (!lwesp_sta_is_joined()) {
+        if (!mgr_rescanned) {
+            mgr_rescanned = 1;
+            sta_mgr_scan();                     /* Refresh list with full scan */
+        } else if (mgr_scan_to == 0 && !mgr_scanning) {
+            mgr_scan_to = lwesp_timeout_addex(mgr_interval, sta_mgr_scan_to_cb, NULL);  /* Retry later */
+        }
+    }
+}
+
+/**
+ * \brief           Access point found during scan
+ * \param[in]       ap: Access point information
+ * \param[in]       arg: Unused
+ * \return          `1` to continue scan
+ */
+static uint8_t
+sta_mgr_scan_ap_fn(const lwesp_ap_t* ap, void* arg) {
+    size_t i, ap_idx;
+
+    LWESP_UNUSED(arg);
+
+    if (mgr_cur_valid && !memcmp(&mgr_cur.mac, &ap->mac, sizeof(ap->mac))) {
+        mgr_cur.rssi = ap->rssi;                /* Refresh signal of current access point */
+    }
+    for (ap_idx = 0; ap_idx < mgr_aps_len; ++ap_idx) {
+        if (!strcmp(mgr_aps[ap_idx].ssid, ap->ssid)) {
+            break;
+        }
+    }
+    if (ap_idx == mgr_aps_len) {                /* Not a known network */
+        return 1;
+    }
+
+    /* Update existing candidate or add new one, replacing the weakest */
+    for (i = 0; i < mgr_cands_cnt; ++i) {
+        if (!memcmp(&mgr_cands[i].bssid, &ap->mac, sizeof(ap->mac))) {
+            break;
+        }
+    }
+    if (i == mgr_cands_cnt) {
+        if (mgr_cands_cnt < LWESP_ARRAYSIZE(mgr_cands)) {
+            ++mgr_cands_cnt;
+        } else if (mgr_cands[--i].rssi >= ap->rssi) {
+            return 1;
+        }
+        LWESP_MEMCPY(&mgr_cands[i].bssid, &ap->mac, sizeof(ap->mac));
+    }
+    mgr_cands[i].rssi = ap->rssi;
+    mgr_cands[i].ch = ap->ch;
+    mgr_cands[i].ap_idx = (uint8_t)ap_idx;
+    mgr_cands_gen[i] = mgr_scan_gen;
+    sta_mgr_cand_sort(i);
+    return 1;
+}
+
+/**
+ * \brief           Scan finished callback
+ * \param[in]       res: Scan result
+ * \param[in]       arg: Unused
+ */
+static void
+sta_mgr_scan_cb(lwespr_t res, void* arg) {
+    uint8_t joined = lwesp_sta_is_joined();
+
+    LWESP_UNUSED(arg);
+
+    mgr_scanning = 0;
+    if (!mgr_active) {
+        return;
+    }
+    if (res == lwespOK) {
+        for (size_t i = mgr_cands_cnt; i > 0; --i) {
+            if (mgr_cands_gen[i - 1] != mgr_scan_gen) {
+                sta_mgr_cand_remove(i - 1);     /* Not visible anymore */
+            }
+        }
+    }
+    LWESP_DEBUGF(LWESP_CFG_DBG_STA_MGR | LWESP_DBG_TYPE_TRACE,
+               "[STA MGR] Scan finished with %d candidates\r\n", (int)mgr_cands_cnt);
+
+    if (!mgr_joining) {
+        if (!joined) {
+            if (mgr_cands_cnt > 0) {
+                sta_mgr_join_next();
+                return;
+            }
+        } else if (mgr_cur_valid && mgr_cands_cnt > 0 && mgr_cur.rssi < LWESP_CFG_STA_MGR_ROAM_RSSI
+                   && memcmp(&mgr_cands[0].bssid, &mgr_cur.mac, sizeof(mgr_cur.mac))
+                   && mgr_cands[0].rssi >= mgr_cur.rssi + LWESP_CFG_STA_MGR_ROAM_HYST) {
+            LWESP_DEBUGF(LWESP_CFG_DBG_STA_MGR | LWESP_DBG_TYPE_TRACE,
+                       "[STA MGR] Roaming from RSSI %d to %d\r\n", (int)mgr_cur.rssi, (int)mgr_cands[0].rssi);
+            sta_mgr_join_next();
+        }
+    }
+    if (mgr_scan_to == 0) {
+        mgr_scan_to = lwesp_timeout_addex(mgr_interval, sta_mgr_scan_to_cb, NULL);
+    }
+}
+
+/**
+ * \brief           Start scan for known networks, unless it is already in progress
+ */
+static void
+sta_mgr_scan(void) {
+    if (mgr_scan_to != 0) {
+        lwesp_timeout_cancel(mgr_scan_to);
+        mgr_scan_to = 0;
+    }
+    if (!mgr_active || mgr_scanning) {
+        return;
+    }
+    ++mgr_scan_gen;
+    mgr_scanning = 1;
+    if (lwesp_sta_list_ap_stream(NULL, STA_MGR_SCAN_FIELDS, sta_mgr_scan_ap_fn, NULL, NULL, sta_mgr_scan_cb, NULL, 0) != lwespOK) {
+        mgr_scanning = 0;
+        mgr_scan_to = lwesp_timeout_addex(mgr_interval, sta_mgr_scan_to_cb, NULL);
+    }
+}
+
+/**
+ * \brief           Background scan timeout callback
+ * \param[in]       arg: Unused
+ */
+static void
+sta_mgr_scan_to_cb(void* arg) {
+    LWESP_UNUSED(arg);
+
+    mgr_scan_to = 0;                            /* Timeout entry is released after callback */
+    sta_mgr_scan();
+}
+
+/**
+ * \brief           Current access point information received
+ * \param[in]       res: Command result
+ * \param[in]       arg: Unused
+ */
+static void
+sta_mgr_info_cb(lwespr_t res, void* arg) {
+    LWESP_UNUSED(arg);
+
+    mgr_cur_valid = res == lwespOK;
+}
+
+/**
+ * \brief           Global event callback of manager
+ * \param[in]       evt: Event information
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+sta_mgr_evt(lwesp_evt_t* evt) {
+    switch (lwesp_evt_get_type(evt)) {
+        case LWESP_EVT_WIFI_CONNECTED: {
+            mgr_cur_valid = 0;
+            mgr_rescanned = 0;
+            lwesp_sta_get_ap_info(&mgr_cur, sta_mgr_info_cb, NULL, 0);
+            if (mgr_scan_to == 0 && !mgr_scanning) {
+                mgr_scan_to = lwesp_timeout_addex(mgr_interval, sta_mgr_scan_to_cb, NULL);
+            }
+            break;
+        }
+        case LWESP_EVT_WIFI_DISCONNECTED: {
+            mgr_cur_valid = 0;
+            if (!mgr_joining) {                 /* Link lost, join next candidate immediately */
+                LWESP_DEBUGF(LWESP_CFG_DBG_STA_MGR | LWESP_DBG_TYPE_TRACE,
+                           "[STA MGR] Disconnected, %d candidates\r\n", (int)mgr_cands_cnt);
+                sta_mgr_join_next();
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return lwespOK;
+}
+
+/**
+ * \brief           Start station manager
+ *
+ * When station is not connected, scan is started first and best known network is joined
+ *
+ * \param[in]       aps: List of known networks. List must stay valid until manager is stopped.
+ *                      Its order does not matter, candidates are ranked by RSSI
+ * \param[in]       len: Number of entries in `aps` list
+ * \param[in]       scan_interval: Background scan interval in units of milliseconds
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_sta_mgr_start(const lwesp_sta_mgr_ap_t* aps, size_t len, uint32_t scan_interval) {
+    lwespr_t res;
+
+    LWESP_ASSERT("aps != NULL", aps != NULL);
+    LWESP_ASSERT("len > 0 && len < 256", len > 0 && len < 256);
+    LWESP_ASSERT("scan_interval > 0", scan_interval > 0);
+
+    lwesp_core_lock();
+    if (mgr_active) {
+        lwesp_core_unlock();
+        return lwespERR;
+    }
+    if ((res = lwesp_evt_register_ex(sta_mgr_evt, LWESP_EVT_MASK(LWESP_EVT_WIFI_CONNECTED)
+                                     | LWESP_EVT_MASK(LWESP_EVT_WIFI_DISCONNECTED))) == lwespOK) {
+        mgr_aps = aps;
+        mgr_aps_len = len;
+        mgr_interval = scan_interval;
+        mgr_cands_cnt = 0;
+        mgr_cur_valid = 0;
+        mgr_rescanned = 0;
+        mgr_active = 1;
+        if (lwesp_sta_is_joined()) {
+            lwesp_sta_get_ap_info(&mgr_cur, sta_mgr_info_cb, NULL, 0);
+        }
+        sta_mgr_scan();
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Stop station manager
+ *
+ * Station stays connected, background scans and roaming are stopped
+ *
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_sta_mgr_stop(void) {
+    lwesp_core_lock();
+    if (!mgr_active) {
+        lwesp_core_unlock();
+        return lwespERR;
+    }
+    mgr_active = 0;
+    if (mgr_scan_to != 0) {
+        lwesp_timeout_cancel(mgr_scan_to);
+        mgr_scan_to = 0;
+    }
+    lwesp_evt_unregister(sta_mgr_evt);
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+/**
+ * \brief           Join best candidate now, without waiting for disconnect or weak signal
+ * \return          \ref lwespOK when join was started, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_sta_mgr_roam(void) {
+    lwespr_t res = lwespOK;
+
+    lwesp_core_lock();
+    if (!mgr_active || mgr_joining) {
+        res = lwespERR;
+    } else if (mgr_cands_cnt == 0) {
+        res = lwespERRNOAP;
+    } else {
+        sta_mgr_join_next();
+    }
+    lwesp_core_unlock();
+    return res;
+}
+
+/**
+ * \brief           Get copy of candidate list, strongest first
+ * \param[out]      cands: Array to write candidates to
+ * \param[in]       len: Number of entries in `cands` array
+ * \return          Number of candidates written
+ */
+size_t
+lwesp_sta_mgr_get_candidates(lwesp_sta_mgr_cand_t* cands, size_t len) {
+    size_t cnt;
+
+    LWESP_ASSERT("cands != NULL", cands != NULL);
+
+    lwesp_core_lock();
+    cnt = LWESP_MIN(len, mgr_cands_cnt);
+    LWESP_MEMCPY(cands, mgr_cands, cnt * sizeof(*cands));
+    lwesp_core_unlock();
+    return cnt;
+}
+
+#endif /* LWESP_CFG_STA_MGR || __DOXYGEN__ */
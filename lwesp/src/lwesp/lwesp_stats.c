@@ -0,0 +1,316 @@
+/**
+ * \file            lwesp_stats.c
+ * \brief           Runtime statistics
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include "lwesp/lwesp_private.h"
+#include "lwesp/lwesp_stats.h"
+
+#if LWESP_CFG_STATS || LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_STATS_THREAD || __DOXYGEN__
+
+#if LWESP_CFG_STATS || __DOXYGEN__
+
+/* Message timestamp flags */
+#define STATS_F_QUEUED                  0x01    /* Enqueue time is valid, queue time not recorded yet */
+#define STATS_F_RESP                    0x02    /* First response byte received for current command */
+
+static lwesp_stats_cmd_t cmd_stats[LWESP_CMD_END];
+
+/**
+ * \brief           Get histogram bucket for execution time
+ * \param[in]       time: Time in units of \ref LWESP_STATS_TIME_UNIT
+ * \return          Bucket index
+ */
+static size_t
+stats_get_bucket(uint32_t time) {
+    size_t b = 0;
+
+#if LWESP_STATS_TIME_FREQ > 1000
+    time /= LWESP_STATS_TIME_FREQ / 1000;       /* Histogram is in units of milliseconds */
+#endif /* LWESP_STATS_TIME_FREQ > 1000 */
+    while (time > 0 && b < (LWESP_CFG_STATS_HIST_BUCKETS - 1)) {
+        time >>= 1;
+        ++b;
+    }
+    return b;
+}
+
+/**
+ * \brief           Save time when message was written to producer queue
+ * \param[in]       msg: Message
+ */
+void
+lwespi_stats_cmd_enqueue(lwesp_msg_t* msg) {
+    msg->stats_enqueue = LWESPI_STATS_NOW();
+    msg->stats_flags = STATS_F_QUEUED;
+}
+
+/**
+ * \brief           Save time when command was sent to device
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Message
+ */
+void
+lwespi_stats_cmd_start(lwesp_msg_t* msg) {
+    lwesp_stats_cmd_t* s;
+
+    msg->stats_start = LWESPI_STATS_NOW();
+    msg->stats_flags &= ~STATS_F_RESP;
+    if ((msg->stats_flags & STATS_F_QUEUED) && msg->cmd < LWESP_CMD_END) {
+        s = &cmd_stats[msg->cmd];
+        s->queue_time_max = LWESP_MAX(s->queue_time_max, msg->stats_start - msg->stats_enqueue);
+        msg->stats_flags &= ~STATS_F_QUEUED;
+    }
+}
+
+/**
+ * \brief           Save time of first response byte for active command
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Message
+ */
+void
+lwespi_stats_cmd_resp(lwesp_msg_t* msg) {
+    if (!(msg->stats_flags & STATS_F_RESP)) {
+        msg->stats_resp = LWESPI_STATS_NOW();
+        msg->stats_flags |= STATS_F_RESP;
+    }
+}
+
+/**
+ * \brief           Record finished execution of active command
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Message
+ * \param[in]       res: Execution result. \ref lwespTIMEOUT is only counted
+ */
+void
+lwespi_stats_cmd_done(lwesp_msg_t* msg, lwespr_t res) {
+    lwesp_stats_cmd_t* s;
+    uint32_t time;
+
+    if (msg->cmd >= LWESP_CMD_END) {
+        return;
+    }
+    s = &cmd_stats[msg->cmd];
+    if (res == lwespTIMEOUT) {
+        ++s->timeout_count;
+        return;
+    }
+    time = LWESPI_STATS_NOW() - msg->stats_start;
+    ++s->count;
+    if (res != lwespOK) {
+        ++s->err_count;
+    }
+    s->time_sum += time;
+    s->time_max = LWESP_MAX(s->time_max, time);
+    if (msg->stats_flags & STATS_F_RESP) {
+        s->resp_time_max = LWESP_MAX(s->resp_time_max, msg->stats_resp - msg->stats_start);
+    }
+    ++s->hist[stats_get_bucket(time)];
+}
+
+#endif /* LWESP_CFG_STATS || __DOXYGEN__ */
+
+#if LWESP_CFG_STATS_THREAD || __DOXYGEN__
+
+/**
+ * \brief           Add time elapsed since previous mark to thread time counter
+ * \note            Function must be called from thread owning the counters
+ * \param[in,out]   mark: Time of previous mark, updated to current time
+ * \param[out]      field: Time counter to add elapsed time to
+ */
+void
+lwespi_stats_thread_mark(uint32_t* mark, uint32_t* field) {
+    uint32_t now = LWESPI_STATS_NOW();
+
+    *field += now - *mark;
+    *mark = now;
+}
+
+/**
+ * \brief           Count mailbox write and update depth high-water mark
+ *
+ * Function is called before entry is written, from any context.
+ * High-water mark update is not atomic and may miss concurrent maximum
+ *
+ * \param[in]       cnt: Mailbox counters
+ * \param[in]       size: Mailbox size
+ */
+void
+lwespi_stats_mbox_write(lwesp_stats_mbox_cnt_t* cnt, uint32_t size) {
+    uint32_t depth;
+
+    depth = LWESP_CFG_ATOMIC_INC(&cnt->writes) + 1 - cnt->fails - cnt->reads;
+    depth = LWESP_MIN(depth, size);             /* Write to full mailbox fails or waits */
+    if (depth > cnt->depth_max) {
+        cnt->depth_max = depth;
+    }
+}
+
+/**
+ * \brief           Fill public mailbox statistics from counters
+ * \param[in]       cnt: Mailbox counters
+ * \param[in]       size: Mailbox size
+ * \param[out]      stats: Output structure
+ */
+static void
+stats_mbox_get(const lwesp_stats_mbox_cnt_t* cnt, uint32_t size, lwesp_stats_mbox_t* stats) {
+    uint32_t writes = cnt->writes, fails = cnt->fails;
+
+    stats->size = size;
+    stats->depth = LWESP_MIN(writes - fails - cnt->reads, size);
+    stats->depth_max = cnt->depth_max;
+    stats->writes = writes - fails - cnt->writes_reset;
+    stats->write_fails = fails - cnt->fails_reset;
+}
+
+/**
+ * \brief           Reset public view of mailbox counters
+ * \param[in]       cnt: Mailbox counters
+ */
+static void
+stats_mbox_reset(lwesp_stats_mbox_cnt_t* cnt) {
+    uint32_t writes = cnt->writes, fails = cnt->fails;
+
+    cnt->writes_reset = writes - fails;
+    cnt->fails_reset = fails;
+    cnt->depth_max = writes - fails - cnt->reads;
+}
+
+#endif /* LWESP_CFG_STATS_THREAD || __DOXYGEN__ */
+
+/**
+ * \brief           Get global statistics
+ *
+ * Traffic and utilization counters are read without core lock,
+ * each of them is consistent, but they may not be from the same moment
+ *
+ * \param[out]      stats: Pointer to output structure to fill
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_stats_get(lwesp_stats_t* stats) {
+    LWESP_ASSERT("stats != NULL", stats != NULL);
+
+    LWESP_MEMSET(stats, 0x00, sizeof(*stats));
+#if LWESP_CFG_STATS
+    stats->cmd_count = LWESP_ARRAYSIZE(cmd_stats);
+#endif /* LWESP_CFG_STATS */
+#if LWESP_CFG_STATS_TRAFFIC
+    stats->uart_rx_bytes = esp.stats_uart_rx;
+    stats->uart_rx_dropped = esp.stats_uart_rx_drop;
+    stats->uart_rx_overflows = esp.stats_uart_rx_overflows;
+    stats->recv_lines_truncated = esp.stats_recv_line_trunc;
+    stats->uart_tx_bytes = esp.stats_uart_tx;
+    stats->conn = esp.stats_conn;
+#endif /* LWESP_CFG_STATS_TRAFFIC */
+#if LWESP_CFG_STATS_THREAD
+    stats->producer = esp.stats_producer;
+    stats->process = esp.stats_process;
+    stats_mbox_get(&esp.stats_mbox_producer, LWESP_CFG_THREAD_PRODUCER_MBOX_SIZE, &stats->mbox_producer);
+    stats_mbox_get(&esp.stats_mbox_process, LWESP_CFG_THREAD_PROCESS_MBOX_SIZE, &stats->mbox_process);
+#endif /* LWESP_CFG_STATS_THREAD */
+    return lwespOK;
+}
+
+#if LWESP_CFG_STATS || __DOXYGEN__
+
+/**
+ * \brief           Get latency statistics for single command type
+ * \param[in]       cmd: Command index, smaller than `cmd_count` of \ref lwesp_stats_t
+ * \param[out]      stats: Pointer to output structure to fill
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_stats_get_cmd(size_t cmd, lwesp_stats_cmd_t* stats) {
+    LWESP_ASSERT("cmd < LWESP_CMD_END", cmd < LWESP_ARRAYSIZE(cmd_stats));
+    LWESP_ASSERT("stats != NULL", stats != NULL);
+
+    lwesp_core_lock();
+    LWESP_MEMCPY(stats, &cmd_stats[cmd], sizeof(*stats));
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_STATS || __DOXYGEN__ */
+
+#if LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__
+
+/**
+ * \brief           Get traffic statistics of connection
+ *
+ * Counters are read without core lock and are reset each time connection becomes active
+ *
+ * \param[in]       conn: Connection handle
+ * \param[out]      stats: Pointer to output structure to fill
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_stats_get_conn(lwesp_conn_p conn, lwesp_stats_conn_t* stats) {
+    LWESP_ASSERT("conn != NULL", conn != NULL);
+    LWESP_ASSERT("stats != NULL", stats != NULL);
+
+    *stats = conn->stats;
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_STATS_TRAFFIC || __DOXYGEN__ */
+
+/**
+ * \brief           Reset all statistics to zero
+ */
+void
+lwesp_stats_reset(void) {
+    lwesp_core_lock();
+#if LWESP_CFG_STATS
+    LWESP_MEMSET(cmd_stats, 0x00, sizeof(cmd_stats));
+#endif /* LWESP_CFG_STATS */
+#if LWESP_CFG_STATS_TRAFFIC
+    esp.stats_uart_rx = 0;
+    esp.stats_uart_rx_drop = 0;
+    esp.stats_uart_rx_overflows = 0;
+    esp.stats_recv_line_trunc = 0;
+    esp.stats_uart_tx = 0;
+    LWESP_MEMSET(&esp.stats_conn, 0x00, sizeof(esp.stats_conn));
+    for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+        LWESP_MEMSET(&esp.m.conns[i].stats, 0x00, sizeof(esp.m.conns[i].stats));
+    }
+#endif /* LWESP_CFG_STATS_TRAFFIC */
+#if LWESP_CFG_STATS_THREAD
+    /* Thread counters are owned by threads, they are only cleared here */
+    LWESP_MEMSET(&esp.stats_producer, 0x00, sizeof(esp.stats_producer));
+    LWESP_MEMSET(&esp.stats_process, 0x00, sizeof(esp.stats_process));
+    stats_mbox_reset(&esp.stats_mbox_producer);
+    stats_mbox_reset(&esp.stats_mbox_process);
+#endif /* LWESP_CFG_STATS_THREAD */
+    lwesp_core_unlock();
+}
+
+#endif /* LWESP_CFG_STATS || LWESP_CFG_STATS_TRAFFIC || LWESP_CFG_STATS_THREAD || __DOXYGEN__ */
@@ -40,6 +40,193 @@
 #include "lwesp/lwesp_mem.h"
 #include "system/lwesp_sys.h"
 
+/* Producer state, shared between producer thread and poll mode */
+static lwesp_msg_t* msg_batch;                  /* Next command from batch, runs back-to-back */
+static lwespr_t batch_res = lwespOK;            /* Result of previous command in batch */
+#if LWESP_CFG_CONN_SEND_COALESCE
+static lwesp_msg_t* msg_pending;                /* Message taken from queue during merge */
+#endif /* LWESP_CFG_CONN_SEND_COALESCE */
+
+/**
+ * \brief           Get next message to start in producer
+ * \param[in]       block: Set to `1` to wait for new message, `0` to return immediately
+ * \return          Message to start or `NULL` if there is none
+ */
+static lwesp_msg_t*
+producer_get_msg(uint8_t block) {
+    lwesp_msg_t* msg = NULL;
+
+    if (msg_batch != NULL) {                    /* Next command from batch runs back-to-back */
+        msg = msg_batch;
+        msg_batch = NULL;
+    } else
+#if LWESP_CFG_CONN_SEND_COALESCE
+    if (msg_pending != NULL) {                  /* Message taken from queue during merge has priority */
+        msg = msg_pending;
+        msg_pending = NULL;
+    } else
+#endif /* LWESP_CFG_CONN_SEND_COALESCE */
+    if (!lwespi_get_producer_msg(&msg, block)) {/* Get message from queue */
+        msg = NULL;
+    }
+    return msg;
+}
+
+/**
+ * \brief           Prepare message for execution
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Message to prepare
+ * \return          \ref lwespOK if message processing function may be called,
+ *                      member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+producer_prepare(lwesp_msg_t* msg) {
+    lwespr_t res = batch_res;                   /* Start with OK or with error of previous command in batch */
+
+    batch_res = lwespOK;
+    esp.msg = msg;                              /* Set message handle */
+
+    /*
+     * This check is performed when adding command to queue
+     * Do it again here to prevent long timeouts,
+     * if device present flag changes
+     */
+    if (!esp.status.f.dev_present) {
+        res = lwespERRNODEVICE;
+    }
+    if (res == lwespOK) {
+        res = lwespi_check_msg_start(msg);      /* Skip stale, expired or cancelled commands */
+    }
+
+    /* For reset message, we can have delay! */
+    if (res == lwespOK && msg->cmd_def == LWESP_CMD_RESET) {
+        if (msg->msg.reset.delay > 0) {
+            lwesp_delay(msg->msg.reset.delay);
+        }
+        lwespi_reset_everything(1);             /* Reset stack before trying to reset */
+    }
+
+#if LWESP_CFG_CONN_SEND_COALESCE
+    /* Merge queued sends for the same connection */
+    if (msg->cmd_def == LWESP_CMD_TCPIP_CIPSEND) {
+        lwespi_conn_send_coalesce(msg, &msg_pending);
+    }
+#endif /* LWESP_CFG_CONN_SEND_COALESCE */
+
+    if (res == lwespOK && msg->fn == NULL) {
+        res = lwespERR;                         /* Simply set error message */
+    }
+    return res;
+}
+
+/**
+ * \brief           Report result of finished message to its caller
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Finished message
+ */
+static void
+producer_complete(lwesp_msg_t* msg) {
+#if LWESP_CFG_USE_API_FUNC_EVT
+    /* Send event function to user */
+    if (msg->evt_fn != NULL) {
+        msg->evt_fn(msg->res, msg->evt_arg);    /* Send event with user argument */
+    }
+#endif /* LWESP_CFG_USE_API_FUNC_EVT */
+
+    /*
+     * In case message is blocking,
+     * release semaphore and notify finished with processing
+     * otherwise directly free memory of message structure
+     */
+    if (msg->is_blocking) {
+#if LWESP_CFG_POLL
+        msg->poll_done = 1;                     /* Caller polls the stack until this is set */
+#elif LWESP_CFG_SYS_THREAD_NOTIFY
+        lwesp_sys_thread_notify(&msg->notify);  /* Wake-up waiting thread */
+#else /* LWESP_CFG_SYS_THREAD_NOTIFY */
+        lwesp_sys_sem_release(&msg->sem);
+#endif /* !LWESP_CFG_SYS_THREAD_NOTIFY */
+    } else {
+        LWESP_MSG_VAR_FREE(msg);
+    }
+}
+
+/**
+ * \brief           Finish message execution and report result
+ * \note            Function must be called with core locked
+ * \param[in]       msg: Message to finish
+ * \param[in]       res: Execution result
+ * \param[in]       started: Set to `1` if message processing function was called
+ */
+static void
+producer_finish(lwesp_msg_t* msg, lwespr_t res, uint8_t started) {
+#if LWESP_CFG_CMD_SINGLE_FLIGHT
+    lwesp_msg_t *w, *w_next;
+#endif /* LWESP_CFG_CMD_SINGLE_FLIGHT */
+
+#if LWESP_CFG_CONN_SEND_FAIR
+    /* Send gave up its turn, it continues later with remaining data */
+    if (res == lwespOK && lwespi_conn_sched_requeue(msg)) {
+        LWESPI_TRACE(CMD_DONE, msg->cmd_def, lwespCONT);
+        esp.msg = NULL;
+        return;
+    }
+#endif /* LWESP_CFG_CONN_SEND_FAIR */
+    if (started) {
+        LWESPI_TRACE(CMD_DONE, msg->cmd_def, res);
+
+        /* Notify application on command timeout */
+        if (res == lwespTIMEOUT) {
+            LWESPI_STATS_CMD_DONE(msg, res);
+            lwespi_send_cb(LWESP_EVT_CMD_TIMEOUT);
+        }
+
+        LWESP_DEBUGW(LWESP_CFG_DBG_THREAD | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_SEVERE,
+                   res == lwespTIMEOUT,
+                   "[THREAD] Timeout in produce thread waiting for command to finish in process thread\r\n");
+        LWESP_DEBUGW(LWESP_CFG_DBG_THREAD | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_SEVERE,
+                   res != lwespOK && res != lwespTIMEOUT,
+                   "[THREAD] Could not start execution for command %d\r\n", (int)msg->cmd);
+    }
+    if (res != lwespOK) {
+        /* Process global callbacks */
+        lwespi_process_events_for_timeout_or_error(msg, res);
+
+        msg->res = res;                         /* Save response */
+    }
+#if LWESP_CFG_CONN_SEND_COALESCE
+    if (msg->cmd_def == LWESP_CMD_TCPIP_CIPSEND) {
+        lwespi_conn_send_coalesce_release(msg, msg->res);   /* Release merged messages not sent yet */
+    }
+#endif /* LWESP_CFG_CONN_SEND_COALESCE */
+
+    /*
+     * Continue with next command in batch.
+     * On error, remaining commands are not executed and report the same error
+     */
+    if (msg->batch_next != NULL) {
+        msg_batch = msg->batch_next;
+        batch_res = msg->res;
+    }
+#if LWESP_CFG_CONN_SEND_FAIR
+    lwespi_conn_sched_release(msg);             /* Next command of the same connection may run */
+#endif /* LWESP_CFG_CONN_SEND_FAIR */
+
+#if LWESP_CFG_CMD_SINGLE_FLIGHT
+    w = lwespi_cmd_sf_release(msg);             /* Merged identical queries finish with the same result */
+#endif /* LWESP_CFG_CMD_SINGLE_FLIGHT */
+    producer_complete(msg);
+#if LWESP_CFG_CMD_SINGLE_FLIGHT
+    for (; w != NULL; w = w_next) {
+        w_next = w->sf_next;
+        producer_complete(w);
+    }
+#endif /* LWESP_CFG_CMD_SINGLE_FLIGHT */
+    esp.msg = NULL;
+}
+
+#if !LWESP_CFG_POLL || __DOXYGEN__
+
 /**
  * \brief           User thread to process input packets from API functions
  * \param[in]       arg: User argument. Semaphore to release when thread starts
@@ -51,46 +238,37 @@ lwesp_thread_produce(void* const arg) {
     lwesp_msg_t* msg;
     lwespr_t res;
     uint32_t time;
+    uint8_t started;
 
     /* Thread is running, unlock semaphore */
     if (lwesp_sys_sem_isvalid(sem)) {
         lwesp_sys_sem_release(sem);             /* Release semaphore */
     }
 
+#if LWESP_CFG_STATS_THREAD
+    e->stats_producer_mark = LWESPI_STATS_NOW();
+#endif /* LWESP_CFG_STATS_THREAD */
     lwesp_core_lock();
     while (1) {
         lwesp_core_unlock();
-        do {
-            time = lwesp_sys_mbox_get(&e->mbox_producer, (void**)&msg, 0);  /* Get message from queue */
-        } while (time == LWESP_SYS_TIMEOUT || msg == NULL);
+        LWESPI_STATS_THREAD_BUSY(producer);
+        msg = producer_get_msg(1);
+        LWESPI_STATS_THREAD_IDLE(producer);
+        LWESPI_STATS_THREAD_WAKEUP(producer);
         LWESP_THREAD_PRODUCER_HOOK();           /* Execute producer thread hook */
+#if LWESP_CFG_STATS_THREAD
+        LWESP_THREAD_PRODUCER_STATS_HOOK(&e->stats_producer);
+#endif /* LWESP_CFG_STATS_THREAD */
         lwesp_core_lock();
 
-        res = lwespOK;                          /* Start with OK */
-        e->msg = msg;                           /* Set message handle */
-
-        /*
-         * This check is performed when adding command to queue
-         * Do it again here to prevent long timeouts,
-         * if device present flag changes
-         */
-        if (!e->status.f.dev_present) {
-            res = lwespERRNODEVICE;
-        }
-
-        /* For reset message, we can have delay! */
-        if (res == lwespOK && msg->cmd_def == LWESP_CMD_RESET) {
-            if (msg->msg.reset.delay > 0) {
-                lwesp_delay(msg->msg.reset.delay);
-            }
-            lwespi_reset_everything(1);         /* Reset stack before trying to reset */
-        }
+        res = producer_prepare(msg);
+        started = 0;
 
         /*
          * Try to call function to process this message
          * Usually it should be function to transmit data to AT port
          */
-        if (res == lwespOK && msg->fn != NULL) {/* Check for callback processing function */
+        if (res == lwespOK) {
             /*
              * Obtain semaphore
              * This code should not block at any point.
@@ -98,31 +276,25 @@ lwesp_thread_produce(void* const arg) {
              * immediate terminate
              */
             lwesp_core_unlock();
+            LWESPI_STATS_THREAD_BUSY(producer);
             lwesp_sys_sem_wait(&e->sem_sync, 0);/* First call */
+            LWESPI_STATS_THREAD_SYNC(producer);
             lwesp_core_lock();
+            started = 1;
+            LWESPI_TRACE(CMD_START, msg->cmd_def, 0);
             res = msg->fn(msg);                 /* Process this message, check if command started at least */
             time = ~LWESP_SYS_TIMEOUT;          /* Reset time */
             if (res == lwespOK) {               /* We have valid data and data were sent */
                 lwesp_core_unlock();
+                LWESPI_STATS_THREAD_BUSY(producer);
                 time = lwesp_sys_sem_wait(&e->sem_sync, msg->block_time);   /* Second call; Wait for synchronization semaphore from processing thread or timeout */
+                LWESPI_STATS_THREAD_SYNC(producer);
                 lwesp_core_lock();
                 if (time == LWESP_SYS_TIMEOUT) {/* Sync timeout occurred? */
                     res = lwespTIMEOUT;         /* Timeout on command */
                 }
             }
 
-            /* Notify application on command timeout */
-            if (res == lwespTIMEOUT) {
-                lwespi_send_cb(LWESP_EVT_CMD_TIMEOUT);
-            }
-
-            LWESP_DEBUGW(LWESP_CFG_DBG_THREAD | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_SEVERE,
-                       res == lwespTIMEOUT,
-                       "[THREAD] Timeout in produce thread waiting for command to finish in process thread\r\n");
-            LWESP_DEBUGW(LWESP_CFG_DBG_THREAD | LWESP_DBG_TYPE_TRACE | LWESP_DBG_LVL_SEVERE,
-                       res != lwespOK && res != lwespTIMEOUT,
-                       "[THREAD] Could not start execution for command %d\r\n", (int)msg->cmd);
-
             /*
              * Manually release semaphore in all cases:
              *
@@ -140,36 +312,8 @@ lwesp_thread_produce(void* const arg) {
              * because semaphore would be still locked
              */
             lwesp_sys_sem_release(&e->sem_sync);
-        } else {
-            if (res == lwespOK) {
-                res = lwespERR;                 /* Simply set error message */
-            }
-        }
-        if (res != lwespOK) {
-            /* Process global callbacks */
-            lwespi_process_events_for_timeout_or_error(msg, res);
-
-            msg->res = res;                     /* Save response */
         }
-
-#if LWESP_CFG_USE_API_FUNC_EVT
-        /* Send event function to user */
-        if (msg->evt_fn != NULL) {
-            msg->evt_fn(msg->res, msg->evt_arg);/* Send event with user argument */
-        }
-#endif /* LWESP_CFG_USE_API_FUNC_EVT */
-
-        /*
-         * In case message is blocking,
-         * release semaphore and notify finished with processing
-         * otherwise directly free memory of message structure
-         */
-        if (msg->is_blocking) {
-            lwesp_sys_sem_release(&msg->sem);
-        } else {
-            LWESP_MSG_VAR_FREE(msg);
-        }
-        e->msg = NULL;
+        producer_finish(msg, res, started);
     }
 }
 
@@ -194,17 +338,33 @@ lwesp_thread_process(void* const arg) {
         lwesp_sys_sem_release(sem);             /* Release semaphore */
     }
 
+#if LWESP_CFG_STATS_THREAD
+    e->stats_process_mark = LWESPI_STATS_NOW();
+#endif /* LWESP_CFG_STATS_THREAD */
 #if !LWESP_CFG_INPUT_USE_PROCESS
     lwesp_core_lock();
     while (1) {
         lwesp_core_unlock();
-        time = lwespi_get_from_mbox_with_timeout_checks(&e->mbox_process, (void**)&msg, 10);
+        LWESPI_STATS_THREAD_BUSY(process);
+        time = lwespi_get_from_mbox_with_timeout_checks(&e->mbox_process, (void**)&msg, LWESP_CFG_TICKLESS_IDLE ? 0 : 10);
+        LWESPI_STATS_THREAD_IDLE(process);
+        LWESPI_STATS_THREAD_WAKEUP(process);
         LWESP_THREAD_PROCESS_HOOK();            /* Execute process thread hook */
+#if LWESP_CFG_STATS_THREAD
+        LWESP_THREAD_PROCESS_STATS_HOOK(&e->stats_process);
+#endif /* LWESP_CFG_STATS_THREAD */
         lwesp_core_lock();
 
         if (time == LWESP_SYS_TIMEOUT || msg == NULL) {
             LWESP_UNUSED(time);                 /* Unused variable */
         }
+
+        /*
+         * Clear notification flag before buffer is processed,
+         * data written from now on trigger new notification
+         */
+        e->input_wake_pending = 0;
+        LWESP_CFG_MEMORY_BARRIER();
         lwespi_process_buffer();                /* Process input data */
 #else /* LWESP_CFG_INPUT_USE_PROCESS */
     while (1) {
@@ -214,9 +374,125 @@ lwesp_thread_process(void* const arg) {
          * If there are no timeouts to process, we can wait unlimited time.
          * In case new timeout occurs, thread will wake up by writing new element to mbox process queue
          */
+        LWESPI_STATS_THREAD_BUSY(process);
         time = lwespi_get_from_mbox_with_timeout_checks(&e->mbox_process, (void**)&msg, 0);
+        LWESPI_STATS_THREAD_IDLE(process);
+        LWESPI_STATS_THREAD_WAKEUP(process);
         LWESP_THREAD_PROCESS_HOOK();            /* Execute process thread hook */
+#if LWESP_CFG_STATS_THREAD
+        LWESP_THREAD_PROCESS_STATS_HOOK(&e->stats_process);
+#endif /* LWESP_CFG_STATS_THREAD */
         LWESP_UNUSED(time);
 #endif /* !LWESP_CFG_INPUT_USE_PROCESS */
     }
 }
+
+#if LWESP_CFG_CONN_EVT_WORKERS > 0 || __DOXYGEN__
+
+/**
+ * \brief           Connection event worker thread
+ *
+ * Thread calls connection callbacks for events queued by processing thread,
+ * without core lock. Packet buffer of receive event is released after callback returns,
+ * callback references it with \ref lwesp_pbuf_ref to keep it longer.
+ *
+ * \param[in]       arg: Pointer to worker event queue
+ * \sa              LWESP_CFG_CONN_EVT_WORKERS
+ */
+void
+lwesp_thread_conn_evt(void* const arg) {
+    lwesp_sys_mbox_t* mbox = arg;
+    lwesp_conn_evt_work_t* item;
+
+    while (1) {
+        if (lwesp_sys_mbox_get(mbox, (void**)&item, 0) == LWESP_SYS_TIMEOUT || item == NULL) {
+            continue;
+        }
+        item->fn(&item->evt);                   /* Call connection callback */
+        lwespi_conn_evt_work_free(item);
+    }
+}
+
+#endif /* LWESP_CFG_CONN_EVT_WORKERS > 0 || __DOXYGEN__ */
+
+#endif /* !LWESP_CFG_POLL || __DOXYGEN__ */
+
+#if LWESP_CFG_POLL || __DOXYGEN__
+
+/**
+ * \brief           Run one step of producer state machine without blocking
+ * \note            Function must be called with core locked
+ */
+static void
+poll_produce(void) {
+    lwesp_msg_t* msg = esp.msg;
+    lwespr_t res;
+
+    /* Check active command for completion or timeout */
+    if (msg != NULL) {
+        if (esp.cmd_sync) {
+            res = lwespOK;
+        } else if (msg->block_time > 0 && (lwesp_sys_now() - esp.cmd_start_time) >= msg->block_time) {
+            res = lwespTIMEOUT;                 /* Timeout on command */
+        } else {
+            return;                             /* Still waiting for device response */
+        }
+        producer_finish(msg, res, 1);
+        return;
+    }
+
+    /* Start new command */
+    if ((msg = producer_get_msg(0)) == NULL) {
+        return;
+    }
+    res = producer_prepare(msg);
+    if (res == lwespOK) {
+        esp.cmd_sync = 0;
+        esp.cmd_start_time = lwesp_sys_now();
+        res = msg->fn(msg);                     /* Process this message, check if command started at least */
+        if (res == lwespOK) {
+            return;                             /* Wait for response in next steps */
+        }
+        producer_finish(msg, res, 1);
+    } else {
+        producer_finish(msg, res, 0);
+    }
+}
+
+/**
+ * \brief           Run one step of the stack in cooperative mode
+ *
+ * Function processes received data, expired timeouts
+ * and starts or finishes one command. It never blocks.
+ *
+ * \note            Function must be called periodically from main loop
+ *                  and may not be called from interrupt or callback context
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ * \sa              LWESP_CFG_POLL
+ */
+lwespr_t
+lwesp_poll(void) {
+    void* m;
+
+    if (!esp.status.f.initialized) {
+        return lwespERR;
+    }
+    lwesp_core_lock();
+
+    /* Wake-up entries are not needed in this mode, only drain them */
+    while (lwesp_sys_mbox_getnow(&esp.mbox_process, &m)) {
+        LWESPI_STATS_MBOX_READ(mbox_process);
+    }
+#if !LWESP_CFG_INPUT_USE_PROCESS
+    esp.input_wake_pending = 0;
+    LWESP_CFG_MEMORY_BARRIER();
+    lwespi_process_buffer();                    /* Process input data */
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+    lwespi_timeout_process();                   /* Process expired timeouts */
+    poll_produce();                             /* Run command state machine */
+
+    lwesp_core_unlock();
+    return lwespOK;
+}
+
+#endif /* LWESP_CFG_POLL || __DOXYGEN__ */
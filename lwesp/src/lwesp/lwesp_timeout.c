@@ -33,10 +33,128 @@
  */
 #include "lwesp/lwesp_private.h"
 #include "lwesp/lwesp_timeout.h"
-#include "lwesp/lwesp_mem.h"
 
-static lwesp_timeout_t* first_timeout;
-static uint32_t last_timeout_time;
+/* Check if time `a` expires before time `b`, overflow safe */
+#define TIMEOUT_BEFORE(a, b)            ((int32_t)((a) - (b)) < 0)
+
+/* Create handle from timeout entry and get entry from handle */
+#define TIMEOUT_ID(to)                  (((lwesp_timeout_id_t)(to)->gen << 16) | (lwesp_timeout_id_t)((to) - timeouts + 1))
+#define TIMEOUT_ID_IDX(id)              ((size_t)((id) & 0xFFFF) - 1)
+#define TIMEOUT_ID_GEN(id)              ((uint16_t)((id) >> 16))
+
+static lwesp_timeout_t timeouts[LWESP_CFG_TIMEOUT_POOL_SIZE];
+static lwesp_timeout_t* heap[LWESP_CFG_TIMEOUT_POOL_SIZE];
+static size_t heap_len;
+static lwesp_timeout_t* free_timeouts;
+static uint8_t timeouts_initialized;
+static volatile uint32_t next_deadline;         /* Expiry time of earliest timeout, copy of heap root for lock-free read */
+static volatile uint8_t next_deadline_valid;    /* Set to `1` when at least one timeout is active */
+
+/**
+ * \brief           Copy expiry time of earliest timeout after heap was modified
+ */
+static void
+deadline_update(void) {
+    if (heap_len > 0) {
+        next_deadline = heap[0]->time;
+        next_deadline_valid = 1;
+    } else {
+        next_deadline_valid = 0;
+    }
+}
+
+/**
+ * \brief           Put all timeout entries to free list
+ */
+static void
+timeouts_init(void) {
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(timeouts); ++i) {
+        timeouts[i].next = free_timeouts;
+        free_timeouts = &timeouts[i];
+    }
+    timeouts_initialized = 1;
+}
+
+/**
+ * \brief           Set entry to heap position and save position to entry
+ * \param[in]       pos: Position in heap
+ * \param[in]       to: Timeout entry
+ */
+static void
+heap_set(size_t pos, lwesp_timeout_t* to) {
+    heap[pos] = to;
+    to->pos = (uint16_t)pos;
+}
+
+/**
+ * \brief           Move entry towards root until heap order is restored
+ * \param[in]       pos: Position of entry in heap
+ */
+static void
+heap_up(size_t pos) {
+    lwesp_timeout_t* to = heap[pos];
+
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (!TIMEOUT_BEFORE(to->time, heap[parent]->time)) {
+            break;
+        }
+        heap_set(pos, heap[parent]);
+        pos = parent;
+    }
+    heap_set(pos, to);
+}
+
+/**
+ * \brief           Move entry towards leaves until heap order is restored
+ * \param[in]       pos: Position of entry in heap
+ */
+static void
+heap_down(size_t pos) {
+    lwesp_timeout_t* to = heap[pos];
+
+    while (1) {
+        size_t child = 2 * pos + 1;
+        if (child >= heap_len) {
+            break;
+        }
+        if (child + 1 < heap_len && TIMEOUT_BEFORE(heap[child + 1]->time, heap[child]->time)) {
+            ++child;                            /* Use earlier of both children */
+        }
+        if (!TIMEOUT_BEFORE(heap[child]->time, to->time)) {
+            break;
+        }
+        heap_set(pos, heap[child]);
+        pos = child;
+    }
+    heap_set(pos, to);
+}
+
+/**
+ * \brief           Remove entry from heap and return it to free list
+ * \param[in]       to: Timeout entry to remove
+ */
+static void
+heap_remove(lwesp_timeout_t* to) {
+    size_t pos = to->pos;
+
+    --heap_len;
+    if (pos < heap_len) {                       /* Fill the gap with last entry */
+        heap_set(pos, heap[heap_len]);
+        if (pos > 0 && TIMEOUT_BEFORE(heap[pos]->time, heap[(pos - 1) / 2]->time)) {
+            heap_up(pos);
+        } else {
+            heap_down(pos);
+        }
+    }
+    heap[heap_len] = NULL;
+    deadline_update();
+
+    ++to->gen;                                  /* Invalidate all handles to this entry */
+    to->fn = NULL;
+    to->next = free_timeouts;
+    free_timeouts = to;
+}
 
 /**
  * \brief           Get time we have to wait before we can process next timeout
@@ -44,44 +162,39 @@ static uint32_t last_timeout_time;
  */
 static uint32_t
 get_next_timeout_diff(void) {
-    uint32_t diff;
-    if (first_timeout == NULL) {
+    int32_t diff;
+    if (heap_len == 0) {
         return 0xFFFFFFFF;
     }
-    diff = lwesp_sys_now() - last_timeout_time; /* Get difference between current time and last process time */
-    if (diff >= first_timeout->time) {          /* Are we over already? */
-        return 0;                               /* We have to immediately process this timeout */
-    }
-    return first_timeout->time - diff;          /* Return remaining time for sleep */
+    diff = (int32_t)(heap[0]->time - lwesp_sys_now());
+    return diff > 0 ? (uint32_t)diff : 0;
 }
 
 /**
- * \brief           Process next timeout in a linked list
+ * \brief           Process all expired timeouts
  */
 static void
 process_next_timeout(void) {
     uint32_t time;
 
     time = lwesp_sys_now();
-
-    /*
-     * Before calling timeout callback, update variable
-     * to make sure we have correct timing in case
-     * callback creates timeout value again
-     */
-    last_timeout_time = time;                   /* Reset variable when we were last processed */
-
-    if (first_timeout != NULL) {
-        lwesp_timeout_t* to = first_timeout;
+    while (heap_len > 0 && !TIMEOUT_BEFORE(time, heap[0]->time)) {
+        lwesp_timeout_t* to = heap[0];
+        lwesp_timeout_fn fn = to->fn;
+        void* arg = to->arg;
+#if LWESP_CFG_TRACE
+        uint32_t to_time = to->time;
+#endif /* LWESP_CFG_TRACE */
 
         /*
-         * Before calling callback remove current timeout from list
+         * Before calling callback remove current timeout from heap
          * to make sure we are safe in case callback function
-         * adds a new timeout entry to list
+         * adds a new timeout entry
          */
-        first_timeout = first_timeout->next;    /* Set next timeout on a list as first timeout */
-        to->fn(to->arg);                        /* Call user callback function */
-        lwesp_mem_free_s((void**)&to);
+        heap_remove(to);
+        LWESPI_TRACE(TIMEOUT_START, time - to_time, heap_len);
+        fn(arg);                                /* Call user callback function */
+        LWESPI_TRACE(TIMEOUT_DONE, 0, 0);
     }
 }
 
@@ -96,14 +209,22 @@ uint32_t
 lwespi_get_from_mbox_with_timeout_checks(lwesp_sys_mbox_t* b, void** m, uint32_t timeout) {
     uint32_t wait_time;
     do {
-        if (first_timeout == NULL) {            /* We have no timeouts ready? */
-            return lwesp_sys_mbox_get(b, m, timeout);   /* Get entry from message queue */
+        if (heap_len == 0) {                    /* We have no timeouts ready? */
+            wait_time = lwesp_sys_mbox_get(b, m, timeout);  /* Get entry from message queue */
+            if (wait_time != LWESP_SYS_TIMEOUT) {
+                LWESPI_STATS_MBOX_READ(mbox_process);
+            }
+            return wait_time;
         }
         wait_time = get_next_timeout_diff();    /* Get time to wait for next timeout execution */
         if (wait_time == 0 || lwesp_sys_mbox_get(b, m, wait_time) == LWESP_SYS_TIMEOUT) {
+            LWESPI_STATS_THREAD_IDLE(process);  /* Timeout callbacks are process thread work */
             lwesp_core_lock();
             process_next_timeout();             /* Process with next timeout */
             lwesp_core_unlock();
+            LWESPI_STATS_THREAD_BUSY(process);
+        } else {
+            LWESPI_STATS_MBOX_READ(mbox_process);
         }
         break;
     } while (1);
@@ -111,120 +232,143 @@ lwespi_get_from_mbox_with_timeout_checks(lwesp_sys_mbox_t* b, void** m, uint32_t
 }
 
 /**
- * \brief           Add new timeout to processing list
+ * \brief           Process all expired timeouts without waiting
+ */
+void
+lwespi_timeout_process(void) {
+    lwesp_core_lock();
+    process_next_timeout();
+    lwesp_core_unlock();
+}
+
+/**
+ * \brief           Add new timeout to processing list and get handle to it
  * \param[in]       time: Time in units of milliseconds for timeout execution
  * \param[in]       fn: Callback function to call when timeout expires
  * \param[in]       arg: Pointer to user specific argument to call when timeout callback function is executed
- * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ * \return          Timeout handle on success to be used with \ref lwesp_timeout_cancel, `0` otherwise
  */
-lwespr_t
-lwesp_timeout_add(uint32_t time, lwesp_timeout_fn fn, void* arg) {
+lwesp_timeout_id_t
+lwesp_timeout_addex(uint32_t time, lwesp_timeout_fn fn, void* arg) {
     lwesp_timeout_t* to;
-    uint32_t now;
-
-    LWESP_ASSERT("fn != NULL", fn != NULL);
+    lwesp_timeout_id_t id = 0;
+    uint8_t is_first = 0;
 
-    to = lwesp_mem_calloc(1, sizeof(*to));      /* Allocate memory for timeout structure */
-    if (to == NULL) {
-        return lwespERR;
+    if (fn == NULL) {
+        return 0;
     }
 
     lwesp_core_lock();
-    now = lwesp_sys_now();                      /* Get current time */
-    if (first_timeout != NULL) {
-        /*
-         * Since we want timeout value to start from NOW,
-         * we have to add time when we last processed our timeouts
-         */
-        time += now - last_timeout_time;        /* Add difference between now and last processed time */
+    if (!timeouts_initialized) {
+        timeouts_init();
+    }
+    if ((to = free_timeouts) != NULL) {
+        free_timeouts = to->next;
+        to->next = NULL;
+        to->time = lwesp_sys_now() + time;
+        to->arg = arg;
+        to->fn = fn;
+
+        heap_set(heap_len, to);                 /* Add to the end and restore heap order */
+        heap_up(heap_len++);
+        deadline_update();
+        id = TIMEOUT_ID(to);
+        is_first = to->pos == 0;
     }
-    to->time = time;
-    to->arg = arg;
-    to->fn = fn;
+    lwesp_core_unlock();
+    LWESPI_TRACE(TIMEOUT_ADD, time, id != 0);
 
     /*
-     * Add new timeout to proper place on linked list
-     * and align times to have correct values between timeouts
+     * Process thread waits until earliest timeout expires,
+     * wake it up only when new timeout expires before all others
      */
-    if (first_timeout == NULL) {
-        first_timeout = to;                     /* Set as first element */
-        last_timeout_time = now;                /* Reset last timeout time to current time */
-    } else {                                    /* Find where to place a new timeout */
-        /*
-         * First check if we have to put new timeout
-         * to beginning of linked list.
-         * In this case just align new value for current first element
-         */
-        if (first_timeout->time > to->time) {
-            first_timeout->time -= time;        /* Decrease first timeout value to match difference */
-            to->next = first_timeout;           /* Set first timeout as next of new one */
-            first_timeout = to;                 /* Set new timeout as first */
-        } else {                                /* Go somewhere in between current list */
-            for (lwesp_timeout_t* t = first_timeout; t != NULL; t = t->next) {
-                to->time -= t->time;            /* Decrease new timeout time by time in a linked list */
-                /*
-                 * Enter between 2 entries on a list in case:
-                 *
-                 * - We reached end of linked list
-                 * - Our time is less than diff between 2 entries in list
-                 */
-                if (t->next == NULL || t->next->time > to->time) {
-                    if (t->next != NULL) {      /* Check if there is next element */
-                        t->next->time -= to->time;  /* Decrease difference time to next one */
-                    } else if (to->time > time) {   /* Overflow of time check */
-                        to->time = time + first_timeout->time;
-                    }
-                    to->next = t->next;         /* Change order of elements */
-                    t->next = to;               /* Add new element to linked list */
-                    break;
-                }
-            }
+    if (is_first) {
+        LWESPI_STATS_MBOX_WRITE(mbox_process, LWESP_CFG_THREAD_PROCESS_MBOX_SIZE);
+        if (!lwesp_sys_mbox_putnow(&esp.mbox_process, NULL)) {  /* Write message to process queue to wakeup process thread and to start */
+            LWESPI_STATS_MBOX_WRITE_FAIL(mbox_process);
         }
     }
+    return id;
+}
+
+/**
+ * \brief           Add new timeout to processing list
+ * \param[in]       time: Time in units of milliseconds for timeout execution
+ * \param[in]       fn: Callback function to call when timeout expires
+ * \param[in]       arg: Pointer to user specific argument to call when timeout callback function is executed
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_timeout_add(uint32_t time, lwesp_timeout_fn fn, void* arg) {
+    LWESP_ASSERT("fn != NULL", fn != NULL);
+
+    return lwesp_timeout_addex(time, fn, arg) != 0 ? lwespOK : lwespERRMEM;
+}
+
+/**
+ * \brief           Get time until earliest active timeout expires
+ *
+ * Function does not lock the core and may be called from idle hook of the RTOS,
+ * to decide for how long system may sleep in tickless idle mode.
+ * Process thread does not wake up before this time, unless new data are received
+ * or new command or timeout is added
+ *
+ * \return          Time in units of milliseconds, `0` if timeout already expired,
+ *                      `0xFFFFFFFF` when there is no active timeout
+ */
+uint32_t
+lwesp_timeout_next_deadline(void) {
+    int32_t diff;
+
+    if (!next_deadline_valid) {
+        return 0xFFFFFFFF;
+    }
+    diff = (int32_t)(next_deadline - lwesp_sys_now());
+    return diff > 0 ? (uint32_t)diff : 0;
+}
+
+/**
+ * \brief           Cancel specific timeout
+ * \param[in]       id: Timeout handle returned by \ref lwesp_timeout_addex
+ * \return          \ref lwespOK on success, \ref lwespERR if timeout already expired or was cancelled
+ */
+lwespr_t
+lwesp_timeout_cancel(lwesp_timeout_id_t id) {
+    lwespr_t res = lwespERR;
+    size_t idx = TIMEOUT_ID_IDX(id);
+
+    lwesp_core_lock();
+    if (id != 0 && idx < LWESP_ARRAYSIZE(timeouts)
+        && timeouts[idx].fn != NULL && timeouts[idx].gen == TIMEOUT_ID_GEN(id)) {
+        heap_remove(&timeouts[idx]);
+        res = lwespOK;
+    }
     lwesp_core_unlock();
-    lwesp_sys_mbox_putnow(&esp.mbox_process, NULL); /* Write message to process queue to wakeup process thread and to start */
-    return lwespOK;
+    return res;
 }
 
 /**
  * \brief           Remove callback from timeout list
+ *
+ * When more timeouts use the same callback, one that expires first is removed.
+ * Use \ref lwesp_timeout_cancel to remove specific timeout
+ *
  * \param[in]       fn: Callback function to identify timeout to remove
  * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
  */
 lwespr_t
 lwesp_timeout_remove(lwesp_timeout_fn fn) {
-    uint8_t success = 0;
+    lwesp_timeout_t* to = NULL;
 
     lwesp_core_lock();
-    for (lwesp_timeout_t* t = first_timeout, *t_prev = NULL; t != NULL;
-         t_prev = t, t = t->next) {             /* Check all entries */
-        if (t->fn == fn) {                      /* Do we have a match from callback point of view? */
-
-            /*
-             * We have to first increase
-             * difference time between current and next one
-             * to be aligned for correct wait time
-             */
-            if (t->next != NULL) {              /* Do we have next element? */
-                t->next->time += t->time;       /* Increase timeout time for next element */
-            }
-
-            /*
-             * In case we have previous element on a list,
-             * set next element of previous to next of current one
-             * otherwise we were first element so simply set
-             * next of current as first one
-             */
-            if (t_prev != NULL) {
-                t_prev->next = t->next;
-            } else {
-                first_timeout = t->next;
-            }
-            lwesp_mem_free_s((void**)&t);
-            success = 1;
-            break;
+    for (size_t i = 0; i < heap_len; ++i) {     /* Check all entries */
+        if (heap[i]->fn == fn && (to == NULL || TIMEOUT_BEFORE(heap[i]->time, to->time))) {
+            to = heap[i];
         }
     }
+    if (to != NULL) {
+        heap_remove(to);
+    }
     lwesp_core_unlock();
-    return success ? lwespOK : lwespERR;
+    return to != NULL ? lwespOK : lwespERR;
 }
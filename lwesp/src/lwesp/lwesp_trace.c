@@ -0,0 +1,279 @@
+/**
+ * \file            lwesp_trace.c
+ * \brief           Trace points
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include "lwesp/lwesp_private.h"
+#include "lwesp/lwesp_trace.h"
+
+#if LWESP_CFG_TRACE || __DOXYGEN__
+
+#if (LWESP_CFG_TRACE_BUFF_LEN & (LWESP_CFG_TRACE_BUFF_LEN - 1)) != 0
+#error "LWESP_CFG_TRACE_BUFF_LEN must be power of 2"
+#endif
+
+#define TRACE_MASK                      (LWESP_CFG_TRACE_BUFF_LEN - 1)
+#define TRACE_READ_CHUNK                8       /* Number of events read at a time during export */
+
+/* Single slot of trace buffer */
+typedef struct {
+    volatile uint32_t seq;                      /* Index of event plus one, `0` while event is written */
+    lwesp_trace_evt_t evt;                      /* Event data */
+} trace_slot_t;
+
+/* Event description for export */
+typedef struct {
+    const char* name;                           /* Event name */
+    char ph;                                    /* Event phase, `B` = begin, `E` = end, `i` = instant */
+    uint8_t tid;                                /* Track to show event on, index in trace_tracks */
+} trace_desc_t;
+
+static trace_slot_t trace_buff[LWESP_CFG_TRACE_BUFF_LEN];
+static volatile uint32_t trace_head;            /* Index of next event to write */
+static uint32_t trace_tail;                     /* Index of next event to read */
+static uint32_t trace_lost;                     /* Number of events overwritten before being read */
+
+static const char* const trace_tracks[] = {
+    "", "process", "producer", "api", "timeout",
+};
+
+static const trace_desc_t trace_desc[LWESP_TRACE_ID_END] = {
+    [LWESP_TRACE_ID_PROCESS] = {"process", 'i', 1},
+    [LWESP_TRACE_ID_IPD_START] = {"ipd", 'B', 1},
+    [LWESP_TRACE_ID_IPD_DONE] = {"ipd_done", 'E', 1},
+    [LWESP_TRACE_ID_CMD_START] = {"cmd", 'B', 2},
+    [LWESP_TRACE_ID_CMD_DONE] = {"cmd_done", 'E', 2},
+    [LWESP_TRACE_ID_CONN_SEND] = {"conn_send", 'i', 3},
+    [LWESP_TRACE_ID_PBUF_NEW] = {"pbuf_new", 'i', 3},
+    [LWESP_TRACE_ID_TIMEOUT_ADD] = {"timeout_add", 'i', 3},
+    [LWESP_TRACE_ID_TIMEOUT_START] = {"timeout", 'B', 4},
+    [LWESP_TRACE_ID_TIMEOUT_DONE] = {"timeout_done", 'E', 4},
+};
+
+/**
+ * \brief           Record trace event
+ *
+ * Slot is reserved with \ref LWESP_CFG_TRACE_ATOMIC_INC, core is not locked.
+ * Function may be called from any thread
+ *
+ * \note            Use trace points inside library instead of calling this function directly,
+ *                  they compile to nothing when \ref LWESP_CFG_TRACE is disabled
+ * \param[in]       id: Event ID
+ * \param[in]       a: First event argument
+ * \param[in]       b: Second event argument
+ */
+void
+lwesp_trace_write(lwesp_trace_id_t id, uint32_t a, uint32_t b) {
+    uint32_t idx = LWESP_CFG_TRACE_ATOMIC_INC(&trace_head);
+    trace_slot_t* s = &trace_buff[idx & TRACE_MASK];
+
+    s->seq = 0;                                 /* Invalidate slot while it is written */
+    LWESP_CFG_MEMORY_BARRIER();
+    s->evt.time = LWESP_CFG_TRACE_TIME();
+    s->evt.id = id;
+    s->evt.a = a;
+    s->evt.b = b;
+    LWESP_CFG_MEMORY_BARRIER();
+    s->seq = idx + 1;                           /* Publish event */
+    LWESP_CFG_TRACE_HOOK(id, a, b);
+}
+
+/**
+ * \brief           Read recorded events from trace buffer
+ *
+ * Events are read in order they were recorded.
+ * Events overwritten before they were read are counted, see \ref lwesp_trace_get_lost.
+ * Function does not lock the core and may be called from single thread only
+ *
+ * \param[out]      evts: Array to copy events to
+ * \param[in]       max: Maximal number of events to read
+ * \return          Number of events read
+ */
+size_t
+lwesp_trace_read(lwesp_trace_evt_t* evts, size_t max) {
+    trace_slot_t* s;
+    uint32_t head, seq;
+    size_t cnt = 0;
+
+    if (evts == NULL) {
+        return 0;
+    }
+    while (cnt < max) {
+        head = trace_head;
+        if ((head - trace_tail) > LWESP_CFG_TRACE_BUFF_LEN) {   /* Writers went around the buffer */
+            trace_lost += head - trace_tail - LWESP_CFG_TRACE_BUFF_LEN;
+            trace_tail = head - LWESP_CFG_TRACE_BUFF_LEN;
+        }
+        if (trace_tail == head) {
+            break;
+        }
+        s = &trace_buff[trace_tail & TRACE_MASK];
+        seq = s->seq;
+        if (seq != trace_tail + 1) {
+            if ((int32_t)(seq - (trace_tail + 1)) > 0) {/* Slot already holds newer event */
+                ++trace_lost;
+                ++trace_tail;
+                continue;
+            }
+            break;                              /* Event is still being written */
+        }
+        LWESP_CFG_MEMORY_BARRIER();
+        evts[cnt] = s->evt;
+        LWESP_CFG_MEMORY_BARRIER();
+        if (s->seq != seq) {                    /* Overwritten while copying */
+            ++trace_lost;
+        } else {
+            ++cnt;
+        }
+        ++trace_tail;
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Copy string to output buffer
+ * \param[in]       p: Output buffer position
+ * \param[in]       str: String to copy
+ * \return          Position after copied string
+ */
+static char*
+trace_put_str(char* p, const char* str) {
+    while (*str != '\0') {
+        *p++ = *str++;
+    }
+    return p;
+}
+
+/**
+ * \brief           Write unsigned number to output buffer
+ * \param[in]       p: Output buffer position
+ * \param[in]       num: Number to write
+ * \param[in]       width: Minimal number of digits, padded with leading zeros
+ * \return          Position after written number
+ */
+static char*
+trace_put_u32(char* p, uint32_t num, size_t width) {
+    char tmp[11];
+    size_t len;
+
+    lwesp_u32_to_str(num, tmp);
+    for (len = strlen(tmp); len < width; ++len) {
+        *p++ = '0';
+    }
+    return trace_put_str(p, tmp);
+}
+
+/**
+ * \brief           Export trace buffer as JSON trace
+ *
+ * Output uses Trace Event Format and can be opened in Perfetto UI or `chrome://tracing`.
+ * Each stack context is shown as separate track, commands, IPD data and timeout callbacks as slices.
+ * Output is streamed in small chunks, events are consumed as with \ref lwesp_trace_read
+ *
+ * \param[in]       out_fn: Output function, called for every chunk of output
+ * \param[in]       arg: User argument passed to output function
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_trace_export(lwesp_trace_out_fn out_fn, void* arg) {
+    lwesp_trace_evt_t evts[TRACE_READ_CHUNK];
+    const trace_desc_t* d;
+    char line[160], *p;
+    uint64_t us;
+    size_t cnt;
+
+    LWESP_ASSERT("out_fn != NULL", out_fn != NULL);
+
+    p = trace_put_str(line, "{\"traceEvents\":[\n");
+    out_fn(line, p - line, arg);
+    for (size_t i = 1; i < LWESP_ARRAYSIZE(trace_tracks); ++i) {
+        p = trace_put_str(line, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+        p = trace_put_u32(p, (uint32_t)i, 0);
+        p = trace_put_str(p, ",\"args\":{\"name\":\"");
+        p = trace_put_str(p, trace_tracks[i]);
+        p = trace_put_str(p, "\"}},\n");
+        out_fn(line, p - line, arg);
+    }
+    while ((cnt = lwesp_trace_read(evts, LWESP_ARRAYSIZE(evts))) > 0) {
+        for (size_t i = 0; i < cnt; ++i) {
+            if ((size_t)evts[i].id >= LWESP_ARRAYSIZE(trace_desc)) {
+                continue;
+            }
+            d = &trace_desc[evts[i].id];
+            us = (uint64_t)evts[i].time * 1000000 / LWESP_CFG_TRACE_TIME_FREQ;
+
+            p = trace_put_str(line, "{\"name\":\"");
+            p = trace_put_str(p, d->name);
+            p = trace_put_str(p, "\",\"ph\":\"");
+            *p++ = d->ph;
+            p = trace_put_str(p, d->ph == 'i' ? "\",\"s\":\"t\",\"ts\":" : "\",\"ts\":");
+            if (us >= 1000000) {                /* Split to fit 32-bit conversion */
+                p = trace_put_u32(p, (uint32_t)(us / 1000000), 0);
+                p = trace_put_u32(p, (uint32_t)(us % 1000000), 6);
+            } else {
+                p = trace_put_u32(p, (uint32_t)us, 0);
+            }
+            p = trace_put_str(p, ",\"pid\":1,\"tid\":");
+            p = trace_put_u32(p, d->tid, 0);
+            p = trace_put_str(p, ",\"args\":{\"a\":");
+            p = trace_put_u32(p, evts[i].a, 0);
+            p = trace_put_str(p, ",\"b\":");
+            p = trace_put_u32(p, evts[i].b, 0);
+            p = trace_put_str(p, "}},\n");
+            out_fn(line, p - line, arg);
+        }
+    }
+    /* Close with metadata object, no trailing comma is allowed in JSON */
+    p = trace_put_str(line, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"lwesp\"}}\n],\"displayTimeUnit\":\"ms\"}\n");
+    out_fn(line, p - line, arg);
+    return lwespOK;
+}
+
+/**
+ * \brief           Get name of trace event, as used in export
+ * \param[in]       id: Event ID
+ * \return          Event name
+ */
+const char*
+lwesp_trace_get_name(lwesp_trace_id_t id) {
+    return (size_t)id < LWESP_ARRAYSIZE(trace_desc) ? trace_desc[id].name : "unknown";
+}
+
+/**
+ * \brief           Get number of events overwritten before they were read
+ * \return          Number of lost events
+ */
+uint32_t
+lwesp_trace_get_lost(void) {
+    return trace_lost;
+}
+
+#endif /* LWESP_CFG_TRACE || __DOXYGEN__ */
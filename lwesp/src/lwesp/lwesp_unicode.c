@@ -73,3 +73,40 @@ lwespi_unicode_decode(lwesp_unicode_t* s, uint8_t c) {
     }
     return lwespERR;                            /* An error, unknown UTF-8 character entered */
 }
+
+/**
+ * \brief           Get length of run of complete UTF-8 multi-byte sequences
+ *
+ * Bulk counterpart of \ref lwespi_unicode_decode, sequences are validated with the same rules.
+ * Run stops at first single-byte character, invalid byte or sequence not complete in input data,
+ * these are left to \ref lwespi_unicode_decode
+ *
+ * \param[in]       d: Pointer to data to scan
+ * \param[in]       len: Length of data to scan in units of bytes
+ * \return          Number of bytes in complete multi-byte sequences at the beginning of data
+ */
+size_t
+lwespi_unicode_get_run_len(const uint8_t* d, size_t len) {
+    size_t i = 0, n, k;
+
+    while (i < len) {
+        if ((d[i] & 0xE0) == 0xC0) {            /* 110x xxxx, 2 bytes in sequence */
+            n = 2;
+        } else if ((d[i] & 0xF0) == 0xE0) {     /* 1110 xxxx, 3 bytes in sequence */
+            n = 3;
+        } else if ((d[i] & 0xF8) == 0xF0) {     /* 1111 0xxx, 4 bytes in sequence */
+            n = 4;
+        } else {
+            break;
+        }
+        if (len - i < n) {                      /* Sequence continues in next data */
+            break;
+        }
+        for (k = 1; k < n && (d[i + k] & 0xC0) == 0x80; ++k) {}
+        if (k < n) {                            /* Invalid continuation byte */
+            break;
+        }
+        i += n;
+    }
+    return i;
+}
@@ -34,6 +34,57 @@
 #include <stdint.h>
 #include "lwesp/lwesp_private.h"
 #include "lwesp/lwesp_utils.h"
+#if LWESP_CFG_MEM_FAST_COPY_LL_LEN
+#include "system/lwesp_ll.h"
+#endif /* LWESP_CFG_MEM_FAST_COPY_LL_LEN */
+
+/* Decimal representation of numbers `00` to `99` */
+static const char dec_digits[200] = {
+    '0', '0', '0', '1', '0', '2', '0', '3', '0', '4', '0', '5', '0', '6', '0', '7', '0', '8', '0', '9',
+    '1', '0', '1', '1', '1', '2', '1', '3', '1', '4', '1', '5', '1', '6', '1', '7', '1', '8', '1', '9',
+    '2', '0', '2', '1', '2', '2', '2', '3', '2', '4', '2', '5', '2', '6', '2', '7', '2', '8', '2', '9',
+    '3', '0', '3', '1', '3', '2', '3', '3', '3', '4', '3', '5', '3', '6', '3', '7', '3', '8', '3', '9',
+    '4', '0', '4', '1', '4', '2', '4', '3', '4', '4', '4', '5', '4', '6', '4', '7', '4', '8', '4', '9',
+    '5', '0', '5', '1', '5', '2', '5', '3', '5', '4', '5', '5', '5', '6', '5', '7', '5', '8', '5', '9',
+    '6', '0', '6', '1', '6', '2', '6', '3', '6', '4', '6', '5', '6', '6', '6', '7', '6', '8', '6', '9',
+    '7', '0', '7', '1', '7', '2', '7', '3', '7', '4', '7', '5', '7', '6', '7', '7', '7', '8', '7', '9',
+    '8', '0', '8', '1', '8', '2', '8', '3', '8', '4', '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',
+    '9', '0', '9', '1', '9', '2', '9', '3', '9', '4', '9', '5', '9', '6', '9', '7', '9', '8', '9', '9',
+};
+
+/**
+ * \brief           Convert `unsigned 32-bit` number to decimal string
+ *
+ * Two digits are converted at a time with lookup table
+ * and written from the end, no reordering is necessary.
+ *
+ * \param[in]       num: Number to convert
+ * \param[out]      out: Output variable to save string, at least `11` bytes long
+ * \return          Number of characters written, excluding `NULL` termination
+ */
+size_t
+lwesp_u32_to_dec_str(uint32_t num, char* out) {
+    char tmp[10];
+    char* p = &tmp[sizeof(tmp)];
+    size_t len;
+
+    while (num >= 100) {
+        uint32_t r = (num % 100) * 2;
+        num /= 100;
+        *--p = dec_digits[r + 1];
+        *--p = dec_digits[r];
+    }
+    if (num >= 10) {
+        *--p = dec_digits[num * 2 + 1];
+        *--p = dec_digits[num * 2];
+    } else {
+        *--p = (char)('0' + num);
+    }
+    len = (size_t)(&tmp[sizeof(tmp)] - p);
+    LWESP_MEMCPY(out, p, len);
+    out[len] = '\0';
+    return len;
+}
 
 /**
  * \brief           Convert `unsigned 32-bit` number to string
@@ -50,38 +101,33 @@ lwesp_u32_to_gen_str(uint32_t num, char* out, uint8_t is_hex, uint8_t width) {
     char* tmp = out;
     uint8_t i, y;
 
+    if (!is_hex) {                              /* Decimal numbers use fast conversion */
+        lwesp_u32_to_dec_str(num, out);
+        return out;
+    }
+
     /* Convert number to string */
     i = 0;
     tmp[0] = '0';
     if (num == 0) {
         ++i;
     } else {
-        if (is_hex) {
-            uint8_t mod;
-            while (num > 0) {
-                mod = num & 0x0F;
-                if (mod < 10) {
-                    tmp[i] = mod + '0';
-                } else {
-                    tmp[i] = mod - 10 + 'A';
-                }
-                num >>= 4;
-                ++i;
-            }
-        } else {
-            while (num > 0) {
-                tmp[i] = (num % 10) + '0';
-                num /= 10;
-                ++i;
+        uint8_t mod;
+        while (num > 0) {
+            mod = num & 0x0F;
+            if (mod < 10) {
+                tmp[i] = mod + '0';
+            } else {
+                tmp[i] = mod - 10 + 'A';
             }
-        }
-    }
-    if (is_hex) {
-        while (i < width) {
-            tmp[i] = '0';
+            num >>= 4;
             ++i;
         }
     }
+    while (i < width) {
+        tmp[i] = '0';
+        ++i;
+    }
     tmp[i] = 0;
 
     /* Rotate string */
@@ -112,3 +158,102 @@ lwesp_i32_to_gen_str(int32_t num, char* out) {
         return lwesp_u32_to_gen_str(LWESP_U32(num), out, 0, 0);
     }
 }
+
+#if LWESP_CFG_MEM_FAST_COPY || __DOXYGEN__
+
+/* Mask of address bits below word boundary */
+#define WORD_MASK                   (sizeof(uint32_t) - 1)
+
+/**
+ * \brief           Copy memory, in word units when alignment permits
+ *
+ * Words are copied when source and destination have the same offset to word boundary,
+ * leading bytes are copied one by one until boundary is reached.
+ * Other combinations are copied in bytes.
+ *
+ * \note            Memory areas must not overlap
+ * \param[out]      dst: Destination memory start address
+ * \param[in]       src: Source memory start address
+ * \param[in]       len: Number of bytes to copy
+ * \return          Destination memory start address
+ */
+void*
+lwesp_memcpy(void* dst, const void* src, size_t len) {
+    uint8_t* d = dst;
+    const uint8_t* s = src;
+
+#if LWESP_CFG_MEM_FAST_COPY_LL_LEN
+    if (len >= LWESP_CFG_MEM_FAST_COPY_LL_LEN && lwesp_ll_memcpy(dst, src, len)) {
+        return dst;
+    }
+#endif /* LWESP_CFG_MEM_FAST_COPY_LL_LEN */
+
+    if (len >= 2 * sizeof(uint32_t) && (((uintptr_t)d ^ (uintptr_t)s) & WORD_MASK) == 0) {
+        uint32_t* dw;
+        const uint32_t* sw;
+
+        for (; ((uintptr_t)d & WORD_MASK) != 0; --len) {
+            *d++ = *s++;
+        }
+        dw = (uint32_t*)d;
+        sw = (const uint32_t*)s;
+        for (; len >= 4 * sizeof(uint32_t); len -= 4 * sizeof(uint32_t), dw += 4, sw += 4) {
+            dw[0] = sw[0];
+            dw[1] = sw[1];
+            dw[2] = sw[2];
+            dw[3] = sw[3];
+        }
+        for (; len >= sizeof(uint32_t); len -= sizeof(uint32_t)) {
+            *dw++ = *sw++;
+        }
+        d = (uint8_t*)dw;
+        s = (const uint8_t*)sw;
+    }
+    for (; len >= 4; len -= 4, d += 4, s += 4) {
+        d[0] = s[0];
+        d[1] = s[1];
+        d[2] = s[2];
+        d[3] = s[3];
+    }
+    for (; len > 0; --len) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+/**
+ * \brief           Set memory to value, in word units after destination is aligned
+ * \param[out]      dst: Destination memory start address
+ * \param[in]       b: Value (byte) to set in memory
+ * \param[in]       len: Number of bytes to set
+ * \return          Destination memory start address
+ */
+void*
+lwesp_memset(void* dst, int b, size_t len) {
+    uint8_t* d = dst;
+
+    if (len >= 2 * sizeof(uint32_t)) {
+        uint32_t* dw, w = 0x01010101UL * (uint8_t)b;
+
+        for (; ((uintptr_t)d & WORD_MASK) != 0; --len) {
+            *d++ = (uint8_t)b;
+        }
+        dw = (uint32_t*)d;
+        for (; len >= 4 * sizeof(uint32_t); len -= 4 * sizeof(uint32_t), dw += 4) {
+            dw[0] = w;
+            dw[1] = w;
+            dw[2] = w;
+            dw[3] = w;
+        }
+        for (; len >= sizeof(uint32_t); len -= sizeof(uint32_t)) {
+            *dw++ = w;
+        }
+        d = (uint8_t*)dw;
+    }
+    for (; len > 0; --len) {
+        *d++ = (uint8_t)b;
+    }
+    return dst;
+}
+
+#endif /* LWESP_CFG_MEM_FAST_COPY || __DOXYGEN__ */
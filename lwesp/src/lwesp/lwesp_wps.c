@@ -50,7 +50,7 @@ lwesp_wps_set_config(uint8_t en,
                   const lwesp_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
     LWESP_MSG_VAR_DEFINE(msg);
 
-    LWESP_MSG_VAR_ALLOC(msg, blocking);
+    LWESP_MSG_VAR_ALLOC_CMD(msg, blocking, wps_cfg);
     LWESP_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     LWESP_MSG_VAR_REF(msg).cmd_def = LWESP_CMD_WIFI_WPS;
     LWESP_MSG_VAR_REF(msg).msg.wps_cfg.en = en;
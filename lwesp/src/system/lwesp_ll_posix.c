@@ -0,0 +1,351 @@
+/**
+ * \file            lwesp_ll_posix.c
+ * \brief           Low-level communication with ESP device for POSIX
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "system/lwesp_ll.h"
+#include "lwesp/lwesp.h"
+#include "lwesp/lwesp_mem.h"
+#include "lwesp/lwesp_input.h"
+
+/*
+ * How it works
+ *
+ * Serial device is opened in raw mode, name is taken from `LWESP_LL_POSIX_PORT`
+ * environment variable and defaults to `/dev/ttyUSB0`.
+ *
+ * Receive thread sleeps in `epoll_wait` until data are available,
+ * then reads all available data in bulk and passes them to upper layer.
+ * Second descriptor in the same epoll set (eventfd) wakes the thread up on de-init.
+ *
+ * Transmit data are written directly, kernel buffers them in the TTY layer.
+ */
+#if !__DOXYGEN__
+
+#ifndef LWESP_LL_POSIX_PORT_DEFAULT
+#define LWESP_LL_POSIX_PORT_DEFAULT         "/dev/ttyUSB0"
+#endif /* LWESP_LL_POSIX_PORT_DEFAULT */
+
+static uint8_t initialized = 0;
+static lwesp_sys_thread_t thread_handle;
+static uint8_t thread_running;
+static int com_port = -1;                       /*!< Serial device descriptor */
+static int epoll_fd = -1;                       /*!< Epoll instance for receive thread */
+static int stop_fd = -1;                        /*!< Event descriptor to stop receive thread */
+static uint8_t data_buffer[0x10000];            /*!< Received data array */
+
+static void uart_thread(void* param);
+
+/**
+ * \brief           Send data to ESP device, function called from ESP stack when we have data to send
+ */
+static size_t
+send_data(const void* data, size_t len) {
+    const uint8_t* d = data;
+    size_t sent = 0;
+    ssize_t res;
+
+    if (com_port < 0 || data == NULL || len == 0) { /* Flush request not needed, writes are not buffered here */
+        return 0;
+    }
+    while (sent < len) {
+        res = write(com_port, &d[sent], len - sent);
+        if (res < 0) {
+            if (errno == EINTR || errno == EAGAIN) {
+                continue;
+            }
+            printf("Cannot write to serial port\r\n");
+            break;
+        }
+        sent += (size_t)res;
+    }
+    return sent;
+}
+
+/**
+ * \brief           Convert numeric baudrate to termios speed
+ * \param[in]       baudrate: UART baudrate
+ * \return          Speed constant, `B0` if not supported
+ */
+static speed_t
+get_speed(uint32_t baudrate) {
+    switch (baudrate) {
+        case 9600:      return B9600;
+        case 19200:     return B19200;
+        case 38400:     return B38400;
+        case 57600:     return B57600;
+        case 115200:    return B115200;
+        case 230400:    return B230400;
+#ifdef B460800
+        case 460800:    return B460800;
+#endif /* B460800 */
+#ifdef B921600
+        case 921600:    return B921600;
+#endif /* B921600 */
+#ifdef B1000000
+        case 1000000:   return B1000000;
+#endif /* B1000000 */
+#ifdef B2000000
+        case 2000000:   return B2000000;
+#endif /* B2000000 */
+#ifdef B3000000
+        case 3000000:   return B3000000;
+#endif /* B3000000 */
+        default:        return B0;
+    }
+}
+
+/**
+ * \brief           Configure UART (USB to UART)
+ * \param[in]       baudrate: UART baudrate
+ * \param[in]       flow_control: ESP side flow control mode, see \ref LWESP_CFG_AT_PORT_FLOW_CONTROL
+ */
+static void
+configure_uart(uint32_t baudrate, uint8_t flow_control) {
+    struct termios tty;
+    speed_t speed;
+
+    /*
+     * On first call,
+     * open serial device and create epoll set for receive thread
+     */
+    if (!initialized) {
+        const char* name = getenv("LWESP_LL_POSIX_PORT");
+        struct epoll_event ev = { 0 };
+
+        if (name == NULL) {
+            name = LWESP_LL_POSIX_PORT_DEFAULT;
+        }
+        com_port = open(name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+        if (com_port < 0) {
+            printf("Cannot open serial port %s\r\n", name);
+            return;
+        }
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+        ev.events = EPOLLIN;
+        ev.data.fd = com_port;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, com_port, &ev);
+        ev.data.fd = stop_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_fd, &ev);
+    }
+    if (com_port < 0) {
+        return;
+    }
+    tcdrain(com_port);                          /* Finish pending write before port is reconfigured */
+
+    /* Configure serial port parameters */
+    if (tcgetattr(com_port, &tty) == 0) {
+        cfmakeraw(&tty);
+        tty.c_cflag |= CLOCAL | CREAD;
+        tty.c_cflag &= ~(CSTOPB | PARENB);
+
+        /*
+         * Termios has single setting for both directions,
+         * enable it when ESP uses any flow control line
+         */
+        if (flow_control) {
+            tty.c_cflag |= CRTSCTS;
+        } else {
+            tty.c_cflag &= ~CRTSCTS;
+        }
+
+        /* Return immediately from read function with all available data */
+        tty.c_cc[VMIN] = 0;
+        tty.c_cc[VTIME] = 0;
+
+        speed = get_speed(baudrate);
+        if (speed != B0) {
+            cfsetispeed(&tty, speed);
+            cfsetospeed(&tty, speed);
+        } else {
+            printf("Unsupported baudrate %u\r\n", (unsigned)baudrate);
+        }
+        if (tcsetattr(com_port, TCSANOW, &tty) != 0) {
+            printf("Cannot set serial port info\r\n");
+        }
+    } else {
+        printf("Cannot get serial port info\r\n");
+    }
+
+    /* On first function call, create a thread to read data from serial port */
+    if (!initialized) {
+        thread_running = lwesp_sys_thread_create(&thread_handle, "lwesp_ll_thread", uart_thread, NULL, 0, 0);
+    }
+}
+
+/**
+ * \brief           UART thread
+ */
+static void
+uart_thread(void* param) {
+    struct epoll_event evs[2];
+    ssize_t bytes_read;
+    size_t to_read;
+    uint8_t* d;
+    int cnt;
+
+    LWESP_UNUSED(param);
+    while (1) {
+        /* Sleep until data are received or stop is requested */
+        cnt = epoll_wait(epoll_fd, evs, LWESP_ARRAYSIZE(evs), -1);
+        if (cnt < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (int i = 0; i < cnt; ++i) {
+            if (evs[i].data.fd == stop_fd) {
+                return;
+            }
+        }
+
+        /*
+         * Read all available data from serial port
+         * and send it to upper layer for processing
+         */
+        do {
+            d = data_buffer;
+            to_read = sizeof(data_buffer);
+#if !LWESP_CFG_INPUT_USE_PROCESS
+            /* Read directly to input buffer, local buffer is used only when it is full */
+            if ((d = lwesp_input_get_write_buff(&to_read)) == NULL) {
+                d = data_buffer;
+                to_read = sizeof(data_buffer);
+            }
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+            bytes_read = read(com_port, d, to_read);
+            if (bytes_read > 0) {
+                /* Send received data to input processing module */
+#if LWESP_CFG_INPUT_USE_PROCESS
+                lwesp_input_process(d, (size_t)bytes_read);
+#else /* LWESP_CFG_INPUT_USE_PROCESS */
+                if (d != data_buffer) {
+                    lwesp_input_commit((size_t)bytes_read);
+                } else {
+                    lwesp_input(d, (size_t)bytes_read);
+                }
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+            }
+        } while (bytes_read == (ssize_t)to_read);
+    }
+}
+
+/**
+ * \brief           Reset device GPIO management
+ */
+static uint8_t
+reset_device(uint8_t state) {
+    LWESP_UNUSED(state);
+    return 0;                                   /* Hardware reset was not successful */
+}
+
+/**
+ * \brief           Callback function called from initialization process
+ */
+lwespr_t
+lwesp_ll_init(lwesp_ll_t* ll) {
+#if !LWESP_CFG_MEM_CUSTOM
+    /* Step 1: Configure memory for dynamic allocations */
+    static uint8_t memory[0x10000];             /* Create memory for dynamic allocations with specific size */
+
+    /*
+     * Create memory region(s) of memory.
+     * If device has internal/external memory available,
+     * multiple memories may be used
+     */
+    lwesp_mem_region_t mem_regions[] = {
+        { .start_addr = memory, .size = sizeof(memory) }
+    };
+    if (!initialized) {
+        lwesp_mem_assignmemory(mem_regions, LWESP_ARRAYSIZE(mem_regions));  /* Assign memory for allocations to ESP library */
+    }
+#endif /* !LWESP_CFG_MEM_CUSTOM */
+
+    /* Step 2: Set AT port send function to use when we have data to transmit */
+    if (!initialized) {
+        ll->send_fn = send_data;                /* Set callback function to send data */
+        ll->reset_fn = reset_device;
+    }
+
+    /* Step 3: Configure AT port to be able to send/receive data to/from ESP device */
+    configure_uart(ll->uart.baudrate, ll->uart.flow_control);   /* Initialize UART for communication */
+    if (com_port < 0) {
+        return lwespERR;
+    }
+    initialized = 1;
+    return lwespOK;
+}
+
+/**
+ * \brief           Callback function to de-init low-level communication part
+ */
+lwespr_t
+lwesp_ll_deinit(lwesp_ll_t* ll) {
+    LWESP_UNUSED(ll);
+    if (thread_running) {
+        uint64_t v = 1;
+
+        if (write(stop_fd, &v, sizeof(v)) == (ssize_t)sizeof(v)) {  /* Wake up thread to exit by itself */
+            pthread_join(thread_handle, NULL);
+        }
+        thread_running = 0;
+    }
+    if (stop_fd >= 0) {
+        close(stop_fd);
+        stop_fd = -1;
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        epoll_fd = -1;
+    }
+    if (com_port >= 0) {
+        close(com_port);
+        com_port = -1;
+    }
+    initialized = 0;                            /* Clear initialized flag */
+    return lwespOK;
+}
+
+#endif /* !__DOXYGEN__ */
@@ -0,0 +1,286 @@
+/**
+ * \file            lwesp_ll_replay.c
+ * \brief           Low-level communication replaying captured AT port traffic
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include <stdio.h>
+#include <string.h>
+#include "system/lwesp_ll.h"
+#include "lwesp/lwesp.h"
+#include "lwesp/lwesp_mem.h"
+#include "lwesp/lwesp_input.h"
+
+/*
+ * How it works
+ *
+ * Driver replaces real device with capture file, written from stream
+ * of \ref lwesp_capture_read function (see \ref LWESP_CAPTURE for format).
+ * Received data records are passed to the stack as fast as possible,
+ * which makes it suitable for profiling of the parser and upper layers offline.
+ *
+ * Replayed responses must not overtake commands they belong to,
+ * otherwise parser would match them to wrong command.
+ * Before each received data record, replay thread waits until the stack has sent
+ * at least as many bytes and released hardware reset at least as many times
+ * as it did before the record during the capture.
+ * Capture should therefore start with stack initialization,
+ * for example in \ref LWESP_EVT_INIT_FINISH event, and application should replay
+ * the same sequence of API calls. If the stack does not send expected data in
+ * \ref LWESP_LL_REPLAY_SYNC_TIMEOUT milliseconds, replay continues without it.
+ * Reset method must match driver used for capture, see \ref LWESP_LL_REPLAY_HW_RESET.
+ *
+ * When replay finishes, number of bytes and time of replay are printed.
+ */
+#if !__DOXYGEN__
+
+#if !LWESP_CFG_INPUT_USE_PROCESS
+#error "LWESP_CFG_INPUT_USE_PROCESS must be enabled to replay data at full speed"
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+
+#ifndef LWESP_LL_REPLAY_FILE
+#define LWESP_LL_REPLAY_FILE                "lwesp_capture.bin" /* Path to capture file */
+#endif /* LWESP_LL_REPLAY_FILE */
+
+#ifndef LWESP_LL_REPLAY_SYNC_TIMEOUT
+#define LWESP_LL_REPLAY_SYNC_TIMEOUT        1000    /* Maximal time to wait for the stack to send data in units of milliseconds */
+#endif /* LWESP_LL_REPLAY_SYNC_TIMEOUT */
+
+#ifndef LWESP_LL_REPLAY_HW_RESET
+#define LWESP_LL_REPLAY_HW_RESET            1   /* Set to `0` if capture driver had no reset function and device was reset with `AT+RST` */
+#endif /* LWESP_LL_REPLAY_HW_RESET */
+
+#ifndef LWESP_LL_REPLAY_REALTIME
+#define LWESP_LL_REPLAY_REALTIME            0   /* Set to `1` to keep captured timing of received data */
+#endif /* LWESP_LL_REPLAY_REALTIME */
+
+/* Capture record format, see lwesp_capture.h */
+#define REPLAY_HDR_LEN                      7
+#define REPLAY_TYPE_START                   0x00
+#define REPLAY_TYPE_RX                      0x01
+#define REPLAY_TYPE_TX                      0x02
+#define REPLAY_TYPE_LOST                    0x03
+#define REPLAY_TYPE_RESET                   0x04
+
+#define REPLAY_CHUNK_SIZE                   1024
+
+static uint8_t initialized = 0;
+static FILE* replay_file;
+static lwesp_sys_sem_t replay_sem;
+static volatile uint32_t replay_tx;             /* Number of bytes sent by the stack */
+static volatile uint32_t replay_tx_wait;        /* Number of bytes replay thread waits for */
+static volatile uint32_t replay_resets;         /* Number of hardware resets released by the stack */
+static volatile uint8_t replay_running;
+
+/**
+ * \brief           Wait until the stack sent expected number of bytes and resets
+ * \param[in]       tx: Expected number of bytes
+ * \param[in]       resets: Expected number of hardware resets
+ * \return          `1` when data were sent, `0` on timeout
+ */
+static uint8_t
+replay_wait_tx(uint32_t tx, uint32_t resets) {
+    uint32_t start = lwesp_sys_now();
+
+    replay_tx_wait = tx;
+    while ((int32_t)(replay_tx - tx) < 0 || (int32_t)(replay_resets - resets) < 0) {
+        if (!replay_running || (lwesp_sys_now() - start) >= LWESP_LL_REPLAY_SYNC_TIMEOUT) {
+            return 0;
+        }
+        lwesp_sys_sem_wait(&replay_sem, 10);
+    }
+    return 1;
+}
+
+/**
+ * \brief           Replay thread, passes captured received data to the stack
+ * \param[in]       arg: Thread argument
+ */
+static void
+replay_thread(void* arg) {
+    uint8_t hdr[REPLAY_HDR_LEN], chunk[REPLAY_CHUNK_SIZE];
+    uint32_t trace_tx = 0, trace_resets = 0, rx_bytes = 0, time_start = lwesp_sys_now();
+    uint32_t rec_time, rec_first = 0, records = 0, sync_lost = 0, timeouts = 0;
+    size_t len, btr;
+
+    while (replay_running && fread(hdr, 1, sizeof(hdr), replay_file) == sizeof(hdr)) {
+        rec_time = (uint32_t)hdr[1] | ((uint32_t)hdr[2] << 8) | ((uint32_t)hdr[3] << 16) | ((uint32_t)hdr[4] << 24);
+        len = (size_t)hdr[5] | ((size_t)hdr[6] << 8);
+        if (records++ == 0) {
+            rec_first = rec_time;
+        }
+        switch (hdr[0]) {
+            case REPLAY_TYPE_TX:                /* Data sent by the stack during capture */
+                trace_tx += (uint32_t)len;
+                fseek(replay_file, (long)len, SEEK_CUR);
+                break;
+            case REPLAY_TYPE_RX: {              /* Data received from device during capture */
+                if (!sync_lost && !replay_wait_tx(trace_tx, trace_resets)) {
+                    ++timeouts;
+                }
+#if LWESP_LL_REPLAY_REALTIME
+                while ((lwesp_sys_now() - time_start) < (rec_time - rec_first) && replay_running) {
+                    lwesp_delay(1);
+                }
+#endif /* LWESP_LL_REPLAY_REALTIME */
+                while (len > 0) {
+                    btr = LWESP_MIN(len, sizeof(chunk));
+                    if (fread(chunk, 1, btr, replay_file) != btr) {
+                        len = 0;
+                        break;
+                    }
+                    lwesp_input_process(chunk, btr);
+                    rx_bytes += (uint32_t)btr;
+                    len -= btr;
+                }
+                break;
+            }
+            case REPLAY_TYPE_RESET:             /* Hardware reset released during capture */
+                ++trace_resets;
+                break;
+            case REPLAY_TYPE_LOST:              /* Records missing in capture, TX counts cannot be trusted anymore */
+                sync_lost = 1;
+                break;
+            case REPLAY_TYPE_START:
+            default:
+                fseek(replay_file, (long)len, SEEK_CUR);
+                break;
+        }
+    }
+    printf("[LL REPLAY] Finished: %u records, %u bytes received in %u ms, %u sync timeouts%s\r\n",
+           (unsigned)records, (unsigned)rx_bytes, (unsigned)(lwesp_sys_now() - time_start),
+           (unsigned)timeouts, sync_lost ? ", capture incomplete" : "");
+    LWESP_UNUSED(arg);
+    LWESP_UNUSED(rec_first);
+    replay_running = 0;
+    lwesp_sys_thread_terminate(NULL);
+}
+
+/**
+ * \brief           Send data to device, data are counted and discarded
+ * \param[in]       data: Pointer to data to send
+ * \param[in]       len: Number of bytes to send
+ * \return          Number of bytes sent
+ */
+static size_t
+send_data(const void* data, size_t len) {
+    if (data == NULL || len == 0) {
+        return 0;
+    }
+    replay_tx += (uint32_t)len;
+    if ((int32_t)(replay_tx - replay_tx_wait) >= 0) {
+        lwesp_sys_sem_release(&replay_sem);     /* Wake up replay thread */
+    }
+    return len;
+}
+
+#if LWESP_LL_REPLAY_HW_RESET
+/**
+ * \brief           Hardware reset callback, counts released resets
+ * \param[in]       state: `1` to activate reset, `0` to release it
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+reset_device(uint8_t state) {
+    if (!state) {
+        ++replay_resets;
+        lwesp_sys_sem_release(&replay_sem);     /* Wake up replay thread */
+    }
+    return 1;
+}
+#endif /* LWESP_LL_REPLAY_HW_RESET */
+
+/**
+ * \brief           Callback function called from initialization process
+ * \note            This function may be called multiple times if AT baudrate is changed from application
+ * \param[in,out]   ll: Pointer to \ref lwesp_ll_t structure to fill data for communication functions
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_ll_init(lwesp_ll_t* ll) {
+#if !LWESP_CFG_MEM_CUSTOM
+    static uint8_t memory[0x10000];
+    lwesp_mem_region_t mem_regions[] = {
+        { .start_addr = memory, .size = sizeof(memory) }
+    };
+    if (!initialized) {
+        lwesp_mem_assignmemory(mem_regions, LWESP_ARRAYSIZE(mem_regions));  /* Assign memory for allocations to ESP library */
+    }
+#endif /* !LWESP_CFG_MEM_CUSTOM */
+
+    if (!initialized) {
+        ll->send_fn = send_data;                /* Set callback function to send data */
+#if LWESP_LL_REPLAY_HW_RESET
+        ll->reset_fn = reset_device;
+#endif /* LWESP_LL_REPLAY_HW_RESET */
+
+        if ((replay_file = fopen(LWESP_LL_REPLAY_FILE, "rb")) == NULL) {
+            printf("[LL REPLAY] Cannot open capture file \"%s\"\r\n", LWESP_LL_REPLAY_FILE);
+            return lwespERR;
+        }
+        if (!lwesp_sys_sem_create(&replay_sem, 0)) {
+            fclose(replay_file);
+            return lwespERRMEM;
+        }
+        replay_tx = 0;
+        replay_tx_wait = 0;
+        replay_resets = 0;
+        replay_running = 1;
+        if (!lwesp_sys_thread_create(NULL, "lwesp_ll_replay", replay_thread, NULL, LWESP_SYS_THREAD_SS, LWESP_SYS_THREAD_PRIO)) {
+            replay_running = 0;
+            lwesp_sys_sem_delete(&replay_sem);
+            fclose(replay_file);
+            return lwespERR;
+        }
+    }
+    initialized = 1;
+    return lwespOK;
+}
+
+/**
+ * \brief           Callback function to de-init low-level communication part
+ * \param[in,out]   ll: Pointer to \ref lwesp_ll_t structure to fill data for communication functions
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+lwespr_t
+lwesp_ll_deinit(lwesp_ll_t* ll) {
+    if (initialized) {
+        replay_running = 0;
+        lwesp_sys_sem_release(&replay_sem);
+        lwesp_delay(20);                        /* Give replay thread time to exit */
+        lwesp_sys_sem_delete(&replay_sem);
+        fclose(replay_file);
+    }
+    initialized = 0;
+    LWESP_UNUSED(ll);
+    return lwespOK;
+}
+
+#endif /* !__DOXYGEN__ */
@@ -0,0 +1,1186 @@
+/**
+ * \file            lwesp_ll_sim.c
+ * \brief           Low-level communication with simulated ESP device
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "system/lwesp_ll.h"
+#include "lwesp/lwesp.h"
+#include "lwesp/lwesp_mem.h"
+#include "lwesp/lwesp_input.h"
+#include "lwesp/lwesp_buff.h"
+
+/*
+ * How it works
+ *
+ * Instead of talking to real device, driver talks to simulated ESP AT device,
+ * implementing subset of AT commands needed for throughput and latency measurements:
+ * reset, `AT+GMR`, `AT+CWJAP`, `AT+CIPSTART`, `AT+CIPSEND` with `>` prompt, `AT+CIPCLOSE`,
+ * `AT+CIPSTATUS`, `+IPD` in automatic and manual receive mode,
+ * `AT+CIPRECVLEN`, `AT+CIPRECVDATA`, `AT+CIPSENDBUF`, `AT+CIPBUFSTATUS`,
+ * `AT+CIPSNTPCFG`, `AT+CIPSNTPTIME?` and `AT+PING`.
+ * Every other command is acknowledged with `OK`.
+ *
+ * Remote side of every connection is an echo server,
+ * data sent with `AT+CIPSEND` are received back on the same connection after network latency.
+ * Segments sent with `AT+CIPSENDBUF` are acknowledged with `<link>,<segment>,SEND OK` after network latency.
+ * Connections to port \ref LWESP_LL_SIM_MQTT_PORT talk to minimal MQTT broker instead.
+ * It accepts every connection and subscription and, once client subscribed to any topic,
+ * delivers every published message back to the client with QoS `0`.
+ *
+ * Device thread reads AT commands written by the stack and prepares responses,
+ * UART thread passes responses to the stack, the same way as receive thread of real driver.
+ * Both directions are paced independently to emulate wire time at current baudrate,
+ * which is changed with `AT+UART_CUR` command as on real device.
+ * There is no hardware in the loop, results are repeatable and suitable for CI.
+ */
+#if !__DOXYGEN__
+
+#ifndef LWESP_LL_SIM_BAUD_EMULATION
+#define LWESP_LL_SIM_BAUD_EMULATION         1   /* Set to `0` to transfer data without wire time */
+#endif /* LWESP_LL_SIM_BAUD_EMULATION */
+
+#ifndef LWESP_LL_SIM_CMD_LATENCY
+#define LWESP_LL_SIM_CMD_LATENCY            0   /* Processing time of every AT command in units of milliseconds */
+#endif /* LWESP_LL_SIM_CMD_LATENCY */
+
+#ifndef LWESP_LL_SIM_NET_LATENCY
+#define LWESP_LL_SIM_NET_LATENCY            2   /* Round trip time to echo server in units of milliseconds */
+#endif /* LWESP_LL_SIM_NET_LATENCY */
+
+#ifndef LWESP_LL_SIM_RESET_TIME
+#define LWESP_LL_SIM_RESET_TIME             10  /* Time from reset to `ready` message in units of milliseconds */
+#endif /* LWESP_LL_SIM_RESET_TIME */
+
+#ifndef LWESP_LL_SIM_JOIN_TIME
+#define LWESP_LL_SIM_JOIN_TIME              50  /* Time to join access point in units of milliseconds */
+#endif /* LWESP_LL_SIM_JOIN_TIME */
+
+#ifndef LWESP_LL_SIM_DNS_TIME
+#define LWESP_LL_SIM_DNS_TIME               200 /* Time to resolve host name in units of milliseconds */
+#endif /* LWESP_LL_SIM_DNS_TIME */
+
+#ifndef LWESP_LL_SIM_SCAN_TIME
+#define LWESP_LL_SIM_SCAN_TIME              100 /* Time to scan for access points in units of milliseconds */
+#endif /* LWESP_LL_SIM_SCAN_TIME */
+
+#ifndef LWESP_LL_SIM_SNTP_EPOCH
+#define LWESP_LL_SIM_SNTP_EPOCH             1791979200  /* Time in seconds since 1970 when SNTP is enabled */
+#endif /* LWESP_LL_SIM_SNTP_EPOCH */
+
+#ifndef LWESP_LL_SIM_SNTP_DRIFT
+#define LWESP_LL_SIM_SNTP_DRIFT             0   /* Rate of device time against host time in units of ppm */
+#endif /* LWESP_LL_SIM_SNTP_DRIFT */
+
+#ifndef LWESP_LL_SIM_MQTT_PORT
+#define LWESP_LL_SIM_MQTT_PORT              1883/* Remote port of simulated MQTT broker */
+#endif /* LWESP_LL_SIM_MQTT_PORT */
+
+#ifndef LWESP_LL_SIM_UART_BUFF_SIZE
+#define LWESP_LL_SIM_UART_BUFF_SIZE         0x2400  /* Buffer size of each UART direction, holds complete `8192` bytes CIPSEND */
+#endif /* LWESP_LL_SIM_UART_BUFF_SIZE */
+
+#ifndef LWESP_LL_SIM_CONN_BUFF_SIZE
+#define LWESP_LL_SIM_CONN_BUFF_SIZE         0x1000  /* Size of received and sent data buffers per connection */
+#endif /* LWESP_LL_SIM_CONN_BUFF_SIZE */
+
+#define SIM_CHUNK_SIZE                      64  /* Number of bytes transferred between two pacing points */
+#define SIM_IPD_MAX_LEN                     1460/* Maximal length of single +IPD packet */
+#define SIM_SEND_MAX_LEN                    8192/* Maximal length of single CIPSEND */
+#define SIM_MQTT_ALIAS_MAX                  2   /* Topic alias maximum of MQTT 5 broker */
+#define SIM_MQTT_ALIAS_LEN                  128 /* Maximal topic length with alias in MQTT 5 broker */
+
+/**
+ * \brief           Simulated connection
+ */
+typedef struct {
+    uint8_t active;                             /*!< Connection is active */
+    char type[4];                               /*!< Connection type string */
+    char ip[16];                                /*!< Remote IP address string */
+    uint16_t port;                              /*!< Remote port */
+    uint16_t local_port;                        /*!< Local port */
+    uint8_t data[LWESP_LL_SIM_CONN_BUFF_SIZE];  /*!< Data from remote side on the way to host */
+    size_t len;                                 /*!< Number of bytes in data buffer */
+    size_t avail;                               /*!< Number of bytes already arrived from network */
+    uint32_t due;                               /*!< Time when remaining data arrive from network */
+    uint8_t mqtt;                               /*!< Remote side is MQTT broker */
+    uint8_t mqtt_sub;                           /*!< Client subscribed to at least one topic */
+    uint8_t mqtt_v5;                            /*!< Client connected with MQTT 5 protocol */
+    uint8_t mqtt_alias[SIM_MQTT_ALIAS_MAX][SIM_MQTT_ALIAS_LEN]; /*!< Topics of MQTT 5 topic aliases */
+    size_t mqtt_alias_len[SIM_MQTT_ALIAS_MAX];  /*!< Topic length of each alias, `0` when not set */
+    uint8_t srv[LWESP_LL_SIM_CONN_BUFF_SIZE];   /*!< Incomplete MQTT packet received by broker */
+    size_t srv_len;                             /*!< Number of bytes in broker buffer */
+    uint32_t seg_sent;                          /*!< Last segment ID received with CIPSENDBUF */
+    uint32_t seg_acked;                         /*!< Last segment ID acknowledged by remote side */
+    uint32_t seg_due;                           /*!< Time when pending segments are acknowledged */
+} sim_conn_t;
+
+/**
+ * \brief           Simulated device
+ */
+typedef struct {
+    lwesp_buff_t in;                            /*!< Data from host to device */
+    lwesp_buff_t out;                           /*!< Data from device to host */
+    lwesp_sys_sem_t sem_dev;                    /*!< Wakes up device thread */
+    lwesp_sys_sem_t sem_uart;                   /*!< Wakes up UART thread */
+    lwesp_sys_sem_t sem_exit;                   /*!< Released by each thread on exit */
+    volatile uint8_t running;                   /*!< Threads are running */
+    volatile uint8_t reset_hold;                /*!< Device is held in reset by reset line */
+    volatile uint8_t reset_req;                 /*!< Reset line was released */
+    volatile uint32_t baudrate;                 /*!< Current baudrate for wire time emulation */
+
+    char line[256];                             /*!< AT command being received */
+    size_t line_len;                            /*!< Length of AT command */
+    uint8_t send_buf[SIM_SEND_MAX_LEN];         /*!< CIPSEND data */
+    size_t send_len;                            /*!< Length of CIPSEND data */
+    size_t send_rem;                            /*!< Remaining CIPSEND data to receive */
+    uint8_t send_conn;                          /*!< Connection for CIPSEND data */
+    uint8_t send_buffered;                      /*!< Data are sent with CIPSENDBUF command */
+
+    uint8_t echo;                               /*!< Command echo is enabled */
+    uint8_t dinfo;                              /*!< Remote IP and port are part of +IPD */
+    uint8_t recv_manual;                        /*!< Manual TCP receive mode */
+    uint8_t link_conn;                          /*!< +LINK_CONN messages are enabled */
+    uint8_t wifi;                               /*!< Station is connected to access point */
+    uint8_t lap_mask;                           /*!< Fields reported in +CWLAP, set with CWLAPOPT */
+    uint8_t sntp;                               /*!< SNTP is enabled with CIPSNTPCFG */
+    uint32_t sntp_start;                        /*!< Host time when SNTP was enabled */
+    uint16_t local_port;                        /*!< Next local port */
+    sim_conn_t conns[LWESP_CFG_MAX_CONNS];      /*!< Connections */
+} sim_t;
+
+static uint8_t initialized = 0;
+static sim_t sim;
+
+/**
+ * \brief           Emulate wire time of data at current baudrate
+ * \param[in,out]   acc: Accumulated wire time not yet waited for, in units of bit-milliseconds
+ * \param[in]       len: Number of bytes transferred
+ */
+static void
+sim_pace(uint32_t* acc, size_t len) {
+#if LWESP_LL_SIM_BAUD_EMULATION
+    uint32_t baud = sim.baudrate, ms;
+
+    if (baud > 0) {
+        *acc += (uint32_t)len * 10UL * 1000UL;  /* 10 bits per byte with start and stop bits */
+        ms = *acc / baud;
+        *acc -= ms * baud;
+        if (ms > 0) {
+            lwesp_delay(ms);
+        }
+    }
+#else /* LWESP_LL_SIM_BAUD_EMULATION */
+    LWESP_UNUSED(acc);
+    LWESP_UNUSED(len);
+#endif /* !LWESP_LL_SIM_BAUD_EMULATION */
+}
+
+/**
+ * \brief           Write device response, wait if UART buffer is full
+ * \param[in]       data: Data to write
+ * \param[in]       len: Length of data in units of bytes
+ */
+static void
+sim_out(const void* data, size_t len) {
+    const uint8_t* d = data;
+    size_t w;
+
+    while (len > 0 && sim.running) {
+        w = lwesp_buff_write(&sim.out, d, len);
+        d += w;
+        len -= w;
+        lwesp_sys_sem_release(&sim.sem_uart);
+        if (len > 0) {
+            lwesp_delay(1);
+        }
+    }
+}
+
+/**
+ * \brief           Write formatted device response
+ * \param[in]       fmt: Format string
+ */
+static void
+sim_out_fmt(const char* fmt, ...) {
+    char str[128];
+    va_list va;
+    int len;
+
+    va_start(va, fmt);
+    len = vsnprintf(str, sizeof(str), fmt, va);
+    va_end(va);
+    if (len > 0) {
+        sim_out(str, LWESP_MIN((size_t)len, sizeof(str) - 1));
+    }
+}
+
+#define sim_out_str(str)                    sim_out((str), strlen(str))
+
+/**
+ * \brief           Parse next quoted string from command
+ * \param[in,out]   s: Pointer to pointer to command, moved after string
+ * \param[out]      out: Output buffer
+ * \param[in]       out_len: Size of output buffer
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+sim_parse_str(const char** s, char* out, size_t out_len) {
+    const char* p = strchr(*s, '"');
+    size_t i = 0;
+
+    if (p == NULL) {
+        return 0;
+    }
+    for (++p; *p != '\0' && *p != '"'; ++p) {
+        if (i < out_len - 1) {
+            out[i++] = *p;
+        }
+    }
+    out[i] = '\0';
+    *s = *p == '"' ? p + 1 : p;
+    return 1;
+}
+
+/**
+ * \brief           Parse next number from command
+ * \param[in,out]   s: Pointer to pointer to command, moved after number and following comma
+ * \return          Parsed number, `-1` if there is no number
+ */
+static long
+sim_parse_num(const char** s) {
+    char* end;
+    long num;
+
+    num = strtol(*s, &end, 10);
+    if (end == *s) {
+        return -1;
+    }
+    *s = *end == ',' ? end + 1 : end;
+    return num;
+}
+
+/**
+ * \brief           Put device to state after reset and send `ready` message
+ */
+static void
+sim_reset(void) {
+    LWESP_MEMSET(sim.conns, 0x00, sizeof(sim.conns));
+    sim.line_len = 0;
+    sim.send_rem = 0;
+    sim.echo = 1;
+    sim.dinfo = 0;
+    sim.recv_manual = 0;
+    sim.link_conn = 0;
+    sim.wifi = 0;
+    sim.lap_mask = 0x1F;
+    sim.sntp = 0;
+    lwesp_delay(LWESP_LL_SIM_RESET_TIME);
+    sim_out_str("\r\nready\r\n");
+}
+
+/**
+ * \brief           Send data from remote side to host, data arrive after network latency
+ * \param[in]       c: Connection
+ * \param[in]       data: Data to send
+ * \param[in]       len: Length of data in units of bytes
+ */
+static void
+sim_conn_push(sim_conn_t* c, const void* data, size_t len) {
+    len = LWESP_MIN(len, sizeof(c->data) - c->len);
+    if (len == 0) {
+        return;
+    }
+    if (c->len == c->avail) {                   /* First byte on the way back starts network latency */
+        c->due = lwesp_sys_now() + LWESP_LL_SIM_NET_LATENCY;
+    }
+    memcpy(&c->data[c->len], data, len);
+    c->len += len;
+}
+
+/**
+ * \brief           Process complete MQTT packet received by simulated broker
+ * \param[in]       c: Connection
+ * \param[in]       hdr: First byte of fixed header
+ * \param[in]       d: Variable header and payload
+ * \param[in]       len: Length of variable header and payload
+ */
+static void
+sim_mqtt_packet(sim_conn_t* c, uint8_t hdr, const uint8_t* d, size_t len) {
+    /* MQTT 5 CONNACK with receive maximum 2, topic alias maximum and maximum packet size 512 */
+    static const uint8_t connack_v5[] = {
+        0x20, 0x0E, 0x00, 0x00, 0x0B,
+        0x21, 0x00, 0x02, 0x22, 0x00, SIM_MQTT_ALIAS_MAX, 0x27, 0x00, 0x00, 0x02, 0x00
+    };
+    uint8_t resp[8];
+    size_t i, n, topic_len, off, rem, props, pkt_id_pos;
+
+    switch (hdr >> 4) {
+        case 1:                                 /* CONNECT, always accepted */
+            c->mqtt_v5 = len > 6 && d[6] == 5;
+            if (c->mqtt_v5) {
+                sim_conn_push(c, connack_v5, sizeof(connack_v5));
+                break;
+            }
+            resp[0] = 0x20;
+            resp[1] = 0x02;
+            resp[2] = 0x00;
+            resp[3] = 0x00;
+            sim_conn_push(c, resp, 4);
+            break;
+        case 3: {                               /* PUBLISH */
+            uint8_t qos = (hdr >> 1) & 0x03;
+            const uint8_t* topic;
+
+            if (len < 2) {
+                break;
+            }
+            topic_len = ((size_t)d[0] << 8) | d[1];
+            topic = &d[2];
+            pkt_id_pos = 2 + topic_len;
+            off = 2 + topic_len + (qos > 0 ? 2 : 0);
+            if (c->mqtt_v5) {                   /* Properties with 1-byte length, resolve topic alias */
+                if (len <= off) {
+                    break;
+                }
+                props = d[off++];
+                for (i = off; i + 3 <= off + props && i + 3 <= len; i += 3) {
+                    size_t alias = (((size_t)d[i + 1] << 8) | d[i + 2]) - 1;
+
+                    if (d[i] != 0x23 || alias >= SIM_MQTT_ALIAS_MAX) {
+                        break;
+                    }
+                    if (topic_len > 0 && topic_len <= SIM_MQTT_ALIAS_LEN) {
+                        memcpy(c->mqtt_alias[alias], topic, topic_len);
+                        c->mqtt_alias_len[alias] = topic_len;
+                    } else if (topic_len == 0) {
+                        topic = c->mqtt_alias[alias];
+                        topic_len = c->mqtt_alias_len[alias];
+                    }
+                }
+                off += props;
+            }
+            if (len < off || topic_len == 0) {
+                break;
+            }
+            if (qos > 0) {                      /* PUBACK or PUBREC */
+                resp[0] = qos == 1 ? 0x40 : 0x50;
+                resp[1] = 0x02;
+                resp[2] = d[pkt_id_pos];
+                resp[3] = d[pkt_id_pos + 1];
+                sim_conn_push(c, resp, 4);
+            }
+            if (c->mqtt_sub) {                  /* Deliver back to client with QoS 0 and full topic */
+                rem = 2 + topic_len + (c->mqtt_v5 ? 1 : 0) + len - off;
+                resp[0] = 0x30;
+                for (i = 1; i < 5; ++i) {
+                    resp[i] = (uint8_t)((rem & 0x7F) | (rem > 0x7F ? 0x80 : 0x00));
+                    rem >>= 7;
+                    if (rem == 0) {
+                        break;
+                    }
+                }
+                n = i + 1;
+                resp[n++] = (uint8_t)(topic_len >> 8);
+                resp[n++] = (uint8_t)topic_len;
+                sim_conn_push(c, resp, n);
+                sim_conn_push(c, topic, topic_len);
+                if (c->mqtt_v5) {
+                    resp[0] = 0x00;             /* No properties */
+                    sim_conn_push(c, resp, 1);
+                }
+                sim_conn_push(c, &d[off], len - off);
+            }
+            break;
+        }
+        case 6:                                 /* PUBREL */
+            if (len >= 2) {
+                resp[0] = 0x70;
+                resp[1] = 0x02;
+                resp[2] = d[0];
+                resp[3] = d[1];
+                sim_conn_push(c, resp, 4);
+            }
+            break;
+        case 8:                                 /* SUBSCRIBE, grant QoS 0 to every topic */
+        case 10:                                /* UNSUBSCRIBE */
+            if (len < 2 || (c->mqtt_v5 && len < 3)) {
+                break;
+            }
+            off = c->mqtt_v5 ? 3 + d[2] : 2;    /* Topics follow packet ID and properties */
+            for (n = 0; off + 2 <= len; ++n) {
+                off += 2 + (((size_t)d[off] << 8) | d[off + 1]) + ((hdr >> 4) == 8 ? 1 : 0);
+            }
+            if ((hdr >> 4) == 10 && !c->mqtt_v5) {
+                n = 0;                          /* UNSUBACK has no reason codes in MQTT 3.1.1 */
+            }
+            resp[0] = (hdr >> 4) == 8 ? 0x90 : 0xB0;
+            resp[1] = (uint8_t)(2 + (c->mqtt_v5 ? 1 : 0) + n);
+            resp[2] = d[0];
+            resp[3] = d[1];
+            resp[4] = 0x00;                     /* Properties in MQTT 5 */
+            sim_conn_push(c, resp, c->mqtt_v5 ? 5 : 4);
+            for (i = 0, resp[0] = 0x00; i < n; ++i) {
+                sim_conn_push(c, resp, 1);
+            }
+            if ((hdr >> 4) == 8) {
+                c->mqtt_sub = 1;
+            }
+            break;
+        case 12:                                /* PINGREQ */
+            resp[0] = 0xD0;
+            resp[1] = 0x00;
+            sim_conn_push(c, resp, 2);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * \brief           Process data received by simulated MQTT broker
+ * \param[in]       c: Connection
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data in units of bytes
+ */
+static void
+sim_mqtt_recv(sim_conn_t* c, const uint8_t* data, size_t len) {
+    size_t i, rem, hdr_len, mul;
+
+    len = LWESP_MIN(len, sizeof(c->srv) - c->srv_len);
+    memcpy(&c->srv[c->srv_len], data, len);
+    c->srv_len += len;
+
+    /* Process all complete packets */
+    while (c->srv_len >= 2) {
+        rem = 0;
+        mul = 1;
+        hdr_len = 0;
+        for (i = 1; i < 5 && i < c->srv_len; ++i) {
+            rem += (size_t)(c->srv[i] & 0x7F) * mul;
+            mul <<= 7;
+            if (!(c->srv[i] & 0x80)) {
+                hdr_len = i + 1;
+                break;
+            }
+        }
+        if (hdr_len == 0) {
+            if (i == 5) {                       /* Malformed remaining length */
+                c->srv_len = 0;
+            }
+            return;
+        }
+        if (c->srv_len < hdr_len + rem) {       /* Wait for the rest of packet */
+            return;
+        }
+        sim_mqtt_packet(c, c->srv[0], &c->srv[hdr_len], rem);
+        c->srv_len -= hdr_len + rem;
+        memmove(c->srv, &c->srv[hdr_len + rem], c->srv_len);
+    }
+}
+
+/**
+ * \brief           Close connection and report it
+ * \param[in]       num: Connection number
+ */
+static void
+sim_conn_close(size_t num) {
+    sim.conns[num].active = 0;
+    sim.conns[num].len = 0;
+    sim.conns[num].avail = 0;
+    sim_out_fmt("%d,CLOSED\r\n", (int)num);
+}
+
+/**
+ * \brief           Process AT+CIPSTART command
+ * \param[in]       s: Command parameters
+ */
+static void
+sim_cmd_cipstart(const char* s) {
+    sim_conn_t* c;
+    char host[64];
+    long num = 0;
+
+    if (*s != '"') {                            /* Link ID is not used in single connection mode */
+        num = sim_parse_num(&s);
+    }
+    if (!sim.wifi) {
+        sim_out_str("no ip\r\n\r\nERROR\r\n");
+        return;
+    }
+    if (num < 0 || num >= LWESP_CFG_MAX_CONNS) {
+        sim_out_str("\r\nERROR\r\n");
+        return;
+    }
+    c = &sim.conns[num];
+    if (c->active) {
+        sim_out_str("ALREADY CONNECTED\r\n\r\nERROR\r\n");
+        return;
+    }
+    if (!sim_parse_str(&s, c->type, sizeof(c->type)) || !sim_parse_str(&s, host, sizeof(host))) {
+        sim_out_str("\r\nERROR\r\n");
+        return;
+    }
+    if (*s == ',') {
+        ++s;
+    }
+    c->port = (uint16_t)sim_parse_num(&s);
+    if (strspn(host, "0123456789.") == strlen(host) && strlen(host) < sizeof(c->ip)) {
+        strcpy(c->ip, host);                    /* Host is IP address already */
+    } else {
+        lwesp_delay(LWESP_LL_SIM_DNS_TIME);
+        strcpy(c->ip, "10.0.0.100");            /* Host name is resolved to the same server */
+    }
+    c->local_port = sim.local_port++;
+    c->len = 0;
+    c->avail = 0;
+    c->seg_sent = 0;
+    c->seg_acked = 0;
+    c->mqtt = c->port == LWESP_LL_SIM_MQTT_PORT;
+    c->mqtt_sub = 0;
+    c->mqtt_v5 = 0;
+    memset(c->mqtt_alias_len, 0x00, sizeof(c->mqtt_alias_len));
+    c->srv_len = 0;
+    c->active = 1;
+
+    if (sim.link_conn) {
+        sim_out_fmt("+LINK_CONN:0,%d,\"%s\",0,\"%s\",%u,%u\r\n", (int)num, c->type, c->ip,
+                    (unsigned)c->port, (unsigned)c->local_port);
+    }
+    sim_out_fmt("%d,CONNECT\r\n\r\nOK\r\n", (int)num);
+}
+
+/**
+ * \brief           Process AT+CIPSEND or AT+CIPSENDBUF command, start waiting for data after prompt
+ * \param[in]       s: Command parameters
+ * \param[in]       buffered: Set to `1` for AT+CIPSENDBUF command
+ */
+static void
+sim_cmd_cipsend(const char* s, uint8_t buffered) {
+    long num, len;
+
+    num = sim_parse_num(&s);
+    len = sim_parse_num(&s);
+    if (num < 0 || num >= LWESP_CFG_MAX_CONNS || !sim.conns[num].active) {
+        sim_out_str("link is not valid\r\n\r\nERROR\r\n");
+        return;
+    }
+    if (len <= 0 || len > SIM_SEND_MAX_LEN || (buffered && strcmp(sim.conns[num].type, "TCP"))) {
+        sim_out_str("\r\nERROR\r\n");
+        return;
+    }
+    sim.send_conn = (uint8_t)num;
+    sim.send_len = (size_t)len;
+    sim.send_rem = (size_t)len;
+    sim.send_buffered = buffered;
+    if (buffered) {
+        sim_out_fmt("%u,%u\r\n", (unsigned)(sim.conns[num].seg_sent + 1), (unsigned)sim.conns[num].seg_acked);
+    }
+    sim_out_str("\r\nOK\r\n\r\n>");
+}
+
+/**
+ * \brief           Process AT+CIPRECVDATA command
+ * \param[in]       s: Command parameters
+ */
+static void
+sim_cmd_ciprecvdata(const char* s) {
+    sim_conn_t* c;
+    long num, len;
+
+    num = sim_parse_num(&s);
+    len = sim_parse_num(&s);
+    if (num < 0 || num >= LWESP_CFG_MAX_CONNS || len <= 0
+        || !sim.conns[num].active || sim.conns[num].avail == 0) {
+        sim_out_str("\r\nERROR\r\n");
+        return;
+    }
+    c = &sim.conns[num];
+    len = (long)LWESP_MIN((size_t)len, c->avail);
+    sim_out_fmt("+CIPRECVDATA:%d,\"%s\",%u,", (int)len, c->ip, (unsigned)c->port);
+    sim_out(c->data, (size_t)len);
+    sim_out_str("\r\n\r\nOK\r\n");
+    memmove(c->data, &c->data[len], c->len - (size_t)len);
+    c->len -= (size_t)len;
+    c->avail -= (size_t)len;
+}
+
+/**
+ * \brief           Process CWLAP command and report simulated access points
+ * \param[in]       args: Command arguments after `+CWLAP`
+ */
+static void
+sim_cmd_cwlap(const char* args) {
+    static const struct {
+        int ecn;
+        const char* ssid;
+        int rssi;
+        const char* mac;
+        int ch;
+    } aps[] = {
+        {3, "lwesp-sim", -40, "02:00:00:00:00:01", 1},
+        {4, "office", -55, "02:00:00:00:00:11", 6},
+        {0, "guest", -67, "02:00:00:00:00:21", 11},
+        {3, "neighbour", -82, "02:00:00:00:00:31", 13},
+    };
+    char ssid[33] = "";
+
+    if (*args == '=') {
+        sim_parse_str(&args, ssid, sizeof(ssid));
+    }
+    lwesp_delay(LWESP_LL_SIM_SCAN_TIME);
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(aps); ++i) {
+        const char* sep = "";
+
+        if (ssid[0] != '\0' && strcmp(ssid, aps[i].ssid)) {
+            continue;
+        }
+        sim_out_str("+CWLAP:(");
+        if (sim.lap_mask & 0x01) {
+            sim_out_fmt("%s%d", sep, aps[i].ecn);
+            sep = ",";
+        }
+        if (sim.lap_mask & 0x02) {
+            sim_out_fmt("%s\"%s\"", sep, aps[i].ssid);
+            sep = ",";
+        }
+        if (sim.lap_mask & 0x04) {
+            sim_out_fmt("%s%d", sep, aps[i].rssi);
+            sep = ",";
+        }
+        if (sim.lap_mask & 0x08) {
+            sim_out_fmt("%s\"%s\"", sep, aps[i].mac);
+            sep = ",";
+        }
+        if (sim.lap_mask & 0x10) {
+            sim_out_fmt("%s%d", sep, aps[i].ch);
+        }
+        sim_out_str(")\r\n");
+    }
+}
+
+/**
+ * \brief           Process single AT command received from host
+ * \param[in]       cmd: Command string without line ending
+ */
+static void
+sim_cmd(const char* cmd) {
+    if (sim.echo) {
+        sim_out_str(cmd);
+        sim_out_str("\r\n");
+    }
+    if (strncmp(cmd, "AT", 2)) {                /* Not an AT command */
+        sim_out_str("\r\nERROR\r\n");
+        return;
+    }
+    cmd += 2;
+    if (LWESP_LL_SIM_CMD_LATENCY > 0) {
+        lwesp_delay(LWESP_LL_SIM_CMD_LATENCY);
+    }
+
+    if (!strcmp(cmd, "+RST") || !strcmp(cmd, "+RESTORE")) {
+        sim_out_str("\r\nOK\r\n");
+        sim_reset();
+        return;
+    } else if (!strcmp(cmd, "E0") || !strcmp(cmd, "E1")) {
+        sim.echo = cmd[1] == '1';
+    } else if (!strcmp(cmd, "+GMR")) {
+        sim_out_str("AT version:2.2.0.0(sim)\r\nSDK version:sim\r\ncompile time:" __DATE__ "\r\nBin version:2.2.0(SIM)\r\n");
+    } else if (!strncmp(cmd, "+SYSMSG=", 8)) {
+        sim.link_conn = (atoi(&cmd[8]) & 0x02) != 0;
+    } else if (!strncmp(cmd, "+CIPDINFO=", 10)) {
+        sim.dinfo = atoi(&cmd[10]) != 0;
+    } else if (!strncmp(cmd, "+CIPRECVMODE=", 13)) {
+        sim.recv_manual = atoi(&cmd[13]) != 0;
+    } else if (!strncmp(cmd, "+CWJAP=", 7)) {
+        const char* s = &cmd[7];
+        char str[33];
+        long scan_mode = 1;
+
+        sim_parse_str(&s, str, sizeof(str)); /* SSID */
+        sim_parse_str(&s, str, sizeof(str)); /* Password */
+        if (sim_parse_str(&s, str, sizeof(str))) {  /* Optional BSSID */
+            if (strcmp(str, "02:00:00:00:00:01")) {
+                lwesp_delay(LWESP_LL_SIM_JOIN_TIME);
+                sim_out_str("+CWJAP:3\r\n\r\nFAIL\r\n");
+                return;
+            }
+            if (*s == ',') {                    /* Skip pci_en, reconn_interval and listen_interval */
+                ++s;
+                sim_parse_num(&s);
+                sim_parse_num(&s);
+                sim_parse_num(&s);
+                scan_mode = sim_parse_num(&s);
+            }
+        }
+        lwesp_delay(scan_mode == 0 ? LWESP_LL_SIM_JOIN_TIME / 5 : LWESP_LL_SIM_JOIN_TIME);
+        sim.wifi = 1;
+        sim_out_str("WIFI CONNECTED\r\nWIFI GOT IP\r\n");
+    } else if (!strcmp(cmd, "+CWJAP?")) {
+        if (sim.wifi) {
+            sim_out_str("+CWJAP:\"lwesp-sim\",\"02:00:00:00:00:01\",1,-40\r\n");
+        } else {
+            sim_out_str("No AP\r\n");
+        }
+    } else if (!strcmp(cmd, "+CWQAP")) {
+        for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+            if (sim.conns[i].active) {
+                sim_conn_close(i);
+            }
+        }
+        if (sim.wifi) {
+            sim.wifi = 0;
+            sim_out_str("WIFI DISCONNECT\r\n");
+        }
+    } else if (!strncmp(cmd, "+CWLAPOPT=", 10)) {
+        const char* s = &cmd[10];
+
+        sim_parse_num(&s);                      /* Sort option is ignored */
+        sim.lap_mask = (uint8_t)sim_parse_num(&s);
+    } else if (!strcmp(cmd, "+CWLAP") || !strncmp(cmd, "+CWLAP=", 7)) {
+        sim_cmd_cwlap(&cmd[6]);
+    } else if (!strcmp(cmd, "+CWDHCP?")) {
+        sim_out_str("+CWDHCP:3\r\n");
+    } else if (!strcmp(cmd, "+CIPSTA?")) {
+        if (sim.wifi) {
+            sim_out_str("+CIPSTA:ip:\"10.0.0.2\"\r\n+CIPSTA:gateway:\"10.0.0.1\"\r\n+CIPSTA:netmask:\"255.255.255.0\"\r\n");
+        } else {
+            sim_out_str("+CIPSTA:ip:\"0.0.0.0\"\r\n+CIPSTA:gateway:\"0.0.0.0\"\r\n+CIPSTA:netmask:\"0.0.0.0\"\r\n");
+        }
+    } else if (!strcmp(cmd, "+CIPSTAMAC?")) {
+        sim_out_str("+CIPSTAMAC:\"02:00:00:00:00:02\"\r\n");
+    } else if (!strcmp(cmd, "+CIPSTATUS")) {
+        uint8_t any = 0;
+
+        for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+            any |= sim.conns[i].active;
+        }
+        sim_out_fmt("STATUS:%d\r\n", sim.wifi ? (any ? 3 : 2) : 5);
+        for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+            sim_conn_t* c = &sim.conns[i];
+            if (c->active) {
+                sim_out_fmt("+CIPSTATUS:%d,\"%s\",\"%s\",%u,%u,0\r\n", (int)i, c->type, c->ip,
+                            (unsigned)c->port, (unsigned)c->local_port);
+            }
+        }
+    } else if (!strncmp(cmd, "+PING=", 6)) {
+        uint32_t rtt = LWESP_LL_SIM_NET_LATENCY + (uint32_t)rand() % (LWESP_LL_SIM_NET_LATENCY + 1);
+
+        if (!sim.wifi) {
+            sim_out_str("+PING:TIMEOUT\r\n\r\nERROR\r\n");
+            return;
+        }
+        lwesp_delay(rtt);
+        sim_out_fmt("+PING:%u\r\n", (unsigned)rtt);
+    } else if (!strncmp(cmd, "+CIPSNTPCFG=", 12)) {
+        sim.sntp = atoi(&cmd[12]) != 0;
+        sim.sntp_start = lwesp_sys_now();
+    } else if (!strcmp(cmd, "+CIPSNTPTIME?")) {
+        time_t t = 0;
+        char str[32];
+
+        if (sim.sntp) {
+            int64_t elapsed = (int64_t)(uint32_t)(lwesp_sys_now() - sim.sntp_start);
+
+            t = (time_t)(LWESP_LL_SIM_SNTP_EPOCH + (elapsed + elapsed * LWESP_LL_SIM_SNTP_DRIFT / 1000000) / 1000);
+        }
+        strftime(str, sizeof(str), "%a %b %d %H:%M:%S %Y", gmtime(&t));
+        sim_out_fmt("+CIPSNTPTIME:%s\r\n", str);
+        lwesp_delay(LWESP_LL_SIM_DNS_TIME);
+        if (!sim.wifi) {
+            sim_out_str("\r\nERROR\r\n");
+            return;
+        }
+        sim_out_str("+CIPDOMAIN:\"10.0.0.100\"\r\n");  /* Every host resolves to the same server */
+    } else if (!strncmp(cmd, "+CIPSTART=", 10)) {
+        sim_cmd_cipstart(&cmd[10]);
+        return;
+    } else if (!strncmp(cmd, "+CIPSEND=", 9)) {
+        sim_cmd_cipsend(&cmd[9], 0);
+        return;
+    } else if (!strncmp(cmd, "+CIPSENDBUF=", 12)) {
+        sim_cmd_cipsend(&cmd[12], 1);
+        return;
+    } else if (!strncmp(cmd, "+CIPBUFSTATUS=", 14)) {
+        const char* s = &cmd[14];
+        long num = sim_parse_num(&s);
+
+        if (num < 0 || num >= LWESP_CFG_MAX_CONNS || !sim.conns[num].active) {
+            sim_out_str("\r\nERROR\r\n");
+            return;
+        }
+        sim_out_fmt("%u,%u,%u,%u,%u\r\n", (unsigned)(sim.conns[num].seg_sent + 1), (unsigned)sim.conns[num].seg_sent,
+                    (unsigned)sim.conns[num].seg_acked, (unsigned)LWESP_LL_SIM_CONN_BUFF_SIZE,
+                    (unsigned)(sim.conns[num].seg_sent - sim.conns[num].seg_acked));
+    } else if (!strncmp(cmd, "+CIPCLOSE=", 10)) {
+        const char* s = &cmd[10];
+        long num = sim_parse_num(&s);
+
+        if (num == (LWESP_CFG_MAX_CONNS > 5 ? LWESP_CFG_MAX_CONNS : 5)) {/* Close all connections */
+            for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+                if (sim.conns[i].active) {
+                    sim_conn_close(i);
+                }
+            }
+        } else if (num >= 0 && num < LWESP_CFG_MAX_CONNS && sim.conns[num].active) {
+            sim_conn_close((size_t)num);
+        } else {
+            sim_out_str("UNLINK\r\n\r\nERROR\r\n");
+            return;
+        }
+    } else if (!strcmp(cmd, "+CIPRECVLEN?")) {
+        sim_out_str("+CIPRECVLEN:");
+        for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+            sim_out_fmt(i > 0 ? ",%d" : "%d", sim.conns[i].active ? (int)sim.conns[i].avail : -1);
+        }
+        sim_out_str("\r\n");
+    } else if (!strncmp(cmd, "+CIPRECVDATA=", 13)) {
+        sim_cmd_ciprecvdata(&cmd[13]);
+        return;
+    } else if (!strcmp(cmd, "+CIPSEND") || !strncmp(cmd, "+CIPMODE=1", 10)) {
+        sim_out_str("\r\nERROR\r\n");           /* Passthrough mode is not simulated */
+        return;
+    }
+    sim_out_str("\r\nOK\r\n");
+}
+
+/**
+ * \brief           Process single byte received from host
+ * \param[in]       ch: Received byte
+ */
+static void
+sim_input_byte(uint8_t ch) {
+    if (sim.send_rem > 0) {                     /* Data of CIPSEND command */
+        sim_conn_t* c = &sim.conns[sim.send_conn];
+
+        sim.send_buf[sim.send_len - sim.send_rem] = ch;
+        if (--sim.send_rem == 0) {
+            if (sim.send_buffered) {            /* Remote side acknowledges segment after network latency */
+                if (c->seg_acked == c->seg_sent) {
+                    c->seg_due = lwesp_sys_now() + LWESP_LL_SIM_NET_LATENCY;
+                }
+                ++c->seg_sent;
+                sim_out_fmt("\r\nRecv %d bytes\r\n", (int)sim.send_len);
+            } else {
+                sim_out_fmt("\r\nRecv %d bytes\r\n\r\nSEND OK\r\n", (int)sim.send_len);
+            }
+            if (c->active) {                    /* Pass data to remote side */
+                if (c->mqtt) {
+                    sim_mqtt_recv(c, sim.send_buf, sim.send_len);
+                } else {
+                    sim_conn_push(c, sim.send_buf, sim.send_len);   /* Echo server sends data back */
+                }
+            }
+        }
+        return;
+    }
+    if (ch == '\n') {
+        sim.line[sim.line_len] = '\0';
+        if (sim.line_len > 0) {
+            sim_cmd(sim.line);
+        }
+        sim.line_len = 0;
+    } else if (ch != '\r' && sim.line_len < sizeof(sim.line) - 1) {
+        sim.line[sim.line_len++] = (char)ch;
+    }
+}
+
+/**
+ * \brief           Deliver echoed data which arrived from network to host
+ * \return          Time to next arrival in units of milliseconds, `0` if nothing is on the way
+ */
+static uint32_t
+sim_conn_process(void) {
+    uint32_t now = lwesp_sys_now(), next = 0, t;
+
+    for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+        sim_conn_t* c = &sim.conns[i];
+
+        if (c->active && c->seg_acked != c->seg_sent) {
+            t = c->seg_due - now;
+            if ((int32_t)t > 0) {
+                if (next == 0 || t < next) {
+                    next = t;
+                }
+            } else {
+                while (c->seg_acked != c->seg_sent) {
+                    sim_out_fmt("%d,%u,SEND OK\r\n", (int)i, (unsigned)++c->seg_acked);
+                }
+            }
+        }
+        if (!c->active || c->len == c->avail) {
+            continue;
+        }
+        t = c->due - now;
+        if ((int32_t)t > 0) {
+            if (next == 0 || t < next) {
+                next = t;
+            }
+            continue;
+        }
+        c->avail = c->len;
+        if (sim.recv_manual && !strcmp(c->type, "TCP")) {
+            sim_out_fmt("+IPD,%d,%d\r\n", (int)i, (int)c->avail);   /* Notify host, data are read with CIPRECVDATA */
+        } else {
+            for (size_t off = 0, len; off < c->len; off += len) {
+                len = LWESP_MIN(c->len - off, SIM_IPD_MAX_LEN);
+                if (sim.dinfo) {
+                    sim_out_fmt("\r\n+IPD,%d,%d,\"%s\",%u:", (int)i, (int)len, c->ip, (unsigned)c->port);
+                } else {
+                    sim_out_fmt("\r\n+IPD,%d,%d:", (int)i, (int)len);
+                }
+                sim_out(&c->data[off], len);
+            }
+            c->len = 0;
+            c->avail = 0;
+        }
+    }
+    return next;
+}
+
+/**
+ * \brief           Simulated device thread
+ * \param[in]       arg: Thread argument
+ */
+static void
+sim_dev_thread(void* arg) {
+    uint8_t chunk[SIM_CHUNK_SIZE];
+    uint32_t acc = 0, next;
+    size_t len;
+
+    while (sim.running) {
+        if (sim.reset_req) {                    /* Hardware reset released */
+            sim.reset_req = 0;
+            sim_reset();
+        }
+        len = lwesp_buff_read(&sim.in, chunk, sizeof(chunk));
+        if (len > 0) {
+            sim_pace(&acc, len);                /* Wire time from host to device */
+            for (size_t i = 0; i < len && !sim.reset_hold; ++i) {
+                sim_input_byte(chunk[i]);
+            }
+        }
+        next = sim_conn_process();
+        if (len == 0) {
+            lwesp_sys_sem_wait(&sim.sem_dev, next > 0 && next < 10 ? next : 10);
+        }
+    }
+    LWESP_UNUSED(arg);
+    lwesp_sys_sem_release(&sim.sem_exit);
+    lwesp_sys_thread_terminate(NULL);
+}
+
+/**
+ * \brief           Simulated UART receive thread
+ * \param[in]       arg: Thread argument
+ */
+static void
+sim_uart_thread(void* arg) {
+    uint8_t chunk[SIM_CHUNK_SIZE];
+    uint8_t* d;
+    uint32_t acc = 0;
+    size_t len;
+
+    while (sim.running) {
+        d = chunk;
+        len = sizeof(chunk);
+#if !LWESP_CFG_INPUT_USE_PROCESS
+        /* Receive directly to input buffer, local buffer is used only when it is full */
+        if ((d = lwesp_input_get_write_buff(&len)) == NULL) {
+            d = chunk;
+            len = sizeof(chunk);
+        }
+        len = LWESP_MIN(len, sizeof(chunk));
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+        len = lwesp_buff_read(&sim.out, d, len);
+        if (len == 0) {
+            lwesp_sys_sem_wait(&sim.sem_uart, 10);
+            continue;
+        }
+        sim_pace(&acc, len);                    /* Wire time from device to host */
+
+        /* Send received data to input processing module */
+#if LWESP_CFG_INPUT_USE_PROCESS
+        lwesp_input_process(d, len);
+#else /* LWESP_CFG_INPUT_USE_PROCESS */
+        if (d != chunk) {
+            lwesp_input_commit(len);
+        } else {
+            lwesp_input(d, len);
+        }
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+    }
+    LWESP_UNUSED(arg);
+    lwesp_sys_sem_release(&sim.sem_exit);
+    lwesp_sys_thread_terminate(NULL);
+}
+
+/**
+ * \brief           Send data to simulated device, function called from ESP stack when we have data to send
+ * \param[in]       data: Pointer to data to send
+ * \param[in]       len: Number of bytes to send
+ * \return          Number of bytes sent
+ */
+static size_t
+send_data(const void* data, size_t len) {
+    const uint8_t* d = data;
+    size_t sent = 0;
+
+    if (data == NULL || len == 0) {             /* Flush, wake up device to process command */
+        lwesp_sys_sem_release(&sim.sem_dev);
+        return 0;
+    }
+    while (sent < len && sim.running) {
+        sent += lwesp_buff_write(&sim.in, &d[sent], len - sent);
+        if (sent < len) {                       /* Wait for device to process data */
+            lwesp_sys_sem_release(&sim.sem_dev);
+            lwesp_delay(1);
+        }
+    }
+    return sent;
+}
+
+/**
+ * \brief           Reset simulated device with reset line
+ * \param[in]       state: `1` to hold device in reset, `0` to release it
+ * \return          `1` as reset is always successful
+ */
+static uint8_t
+reset_device(uint8_t state) {
+    sim.reset_hold = state;
+    if (!state) {
+        sim.reset_req = 1;
+        lwesp_sys_sem_release(&sim.sem_dev);
+    }
+    return 1;
+}
+
+/**
+ * \brief           Release all simulator resources
+ */
+static void
+sim_free(void) {
+    if (lwesp_sys_sem_isvalid(&sim.sem_dev)) {
+        lwesp_sys_sem_delete(&sim.sem_dev);
+    }
+    if (lwesp_sys_sem_isvalid(&sim.sem_uart)) {
+        lwesp_sys_sem_delete(&sim.sem_uart);
+    }
+    if (lwesp_sys_sem_isvalid(&sim.sem_exit)) {
+        lwesp_sys_sem_delete(&sim.sem_exit);
+    }
+    lwesp_buff_free(&sim.in);
+    lwesp_buff_free(&sim.out);
+    LWESP_MEMSET(&sim, 0x00, sizeof(sim));
+}
+
+/**
+ * \brief           Callback function called from initialization process
+ */
+lwespr_t
+lwesp_ll_init(lwesp_ll_t* ll) {
+#if !LWESP_CFG_MEM_CUSTOM
+    /* Step 1: Configure memory for dynamic allocations */
+    static uint8_t memory[0x10000];             /* Create memory for dynamic allocations with specific size */
+
+    /*
+     * Create memory region(s) of memory.
+     * If device has internal/external memory available,
+     * multiple memories may be used
+     */
+    lwesp_mem_region_t mem_regions[] = {
+        { .start_addr = memory, .size = sizeof(memory) }
+    };
+    if (!initialized) {
+        lwesp_mem_assignmemory(mem_regions, LWESP_ARRAYSIZE(mem_regions));  /* Assign memory for allocations to ESP library */
+    }
+#endif /* !LWESP_CFG_MEM_CUSTOM */
+
+    /* Step 2: Set AT port send function to use when we have data to transmit */
+    if (!initialized) {
+        ll->send_fn = send_data;                /* Set callback function to send data */
+        ll->reset_fn = reset_device;
+
+        /* Step 3: Create simulated device with its threads */
+        LWESP_MEMSET(&sim, 0x00, sizeof(sim));
+        if (!lwesp_buff_init(&sim.in, LWESP_LL_SIM_UART_BUFF_SIZE)
+            || !lwesp_buff_init(&sim.out, LWESP_LL_SIM_UART_BUFF_SIZE)
+            || !lwesp_sys_sem_create(&sim.sem_dev, 0)
+            || !lwesp_sys_sem_create(&sim.sem_uart, 0)
+            || !lwesp_sys_sem_create(&sim.sem_exit, 0)) {
+            sim_free();
+            return lwespERRMEM;
+        }
+        sim.echo = 1;
+        sim.local_port = 50000;
+        sim.running = 1;
+        if (!lwesp_sys_thread_create(NULL, "lwesp_sim_dev", sim_dev_thread, NULL, LWESP_SYS_THREAD_SS, LWESP_SYS_THREAD_PRIO)) {
+            sim_free();
+            return lwespERR;
+        }
+        if (!lwesp_sys_thread_create(NULL, "lwesp_sim_uart", sim_uart_thread, NULL, LWESP_SYS_THREAD_SS, LWESP_SYS_THREAD_PRIO)) {
+            sim.running = 0;
+            lwesp_sys_sem_wait(&sim.sem_exit, 100);
+            sim_free();
+            return lwespERR;
+        }
+    }
+
+    /* Both directions use the same baudrate */
+    sim.baudrate = ll->uart.baudrate;
+    initialized = 1;
+    return lwespOK;
+}
+
+/**
+ * \brief           Callback function to de-init low-level communication part
+ */
+lwespr_t
+lwesp_ll_deinit(lwesp_ll_t* ll) {
+    if (initialized) {
+        sim.running = 0;
+        lwesp_sys_sem_release(&sim.sem_dev);
+        lwesp_sys_sem_release(&sim.sem_uart);
+        for (size_t i = 0; i < 2; ++i) {        /* Wait for both threads to exit */
+            lwesp_sys_sem_wait(&sim.sem_exit, 100);
+        }
+        sim_free();
+    }
+    initialized = 0;                            /* Clear initialized flag */
+    LWESP_UNUSED(ll);
+    return lwespOK;
+}
+
+#endif /* !__DOXYGEN__ */
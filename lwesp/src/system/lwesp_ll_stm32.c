@@ -38,10 +38,31 @@
  * On first call to \ref lwesp_ll_init, new thread is created and processed in usart_ll_thread function.
  * USART is configured in RX DMA mode and any incoming bytes are processed inside thread function.
  * DMA and USART implement interrupt handlers to notify main thread about new data ready to send to upper layer.
+ * Notification is a thread flag, multiple interrupts before thread wakes up are coalesced into single processing pass.
  *
  * More about UART + RX DMA: https://github.com/MaJerle/stm32-usart-dma-rx-tx
  *
  * \ref LWESP_CFG_INPUT_USE_PROCESS must be enabled in `lwesp_config.h` to use this driver.
+ *
+ * When `LWESP_USART_DMA_TX_CH` is defined in the driver variant file, data are transmitted with DMA.
+ * Two transmit buffers are used; one is filled by \ref lwesp_ll_send_fn while other is sent by DMA.
+ * Transmission starts when buffer is full or on flush request, thread only waits when both buffers are in use.
+ *
+ * Hardware flow control requires `LWESP_USART_RTS_*` and/or `LWESP_USART_CTS_*` pin definitions
+ * in the driver variant file. Lines without pin definition are not used.
+ *
+ * When \ref LWESP_CFG_MEM_FAST_COPY_LL_LEN is enabled and `LWESP_MEMCPY_DMA_STREAM` is defined in the driver variant file,
+ * large word aligned copies are executed by memory-to-memory DMA stream, calling thread waits for completion.
+ * Data cache is not maintained, use it only on cores without data cache or with non-cacheable buffers.
+ *
+ * When `LWESP_USART_DMA_DCACHE` is defined to `1` in the driver variant file (Cortex-M7 with data cache enabled),
+ * USART DMA buffers are aligned to cache line and their size must be multiple of cache line size.
+ * Received range is invalidated before it is processed and TX buffer is cleaned before DMA transmission starts,
+ * DMA buffers may therefore stay in cacheable memory.
+ *
+ * When \ref LWESP_CFG_SYS_NOW_US is enabled, driver implements \ref lwesp_sys_now_us with DWT cycle counter,
+ * enabled in \ref lwesp_ll_init. Cycle counter wraps within seconds, time is therefore accumulated in software
+ * and resynchronized to \ref lwesp_sys_now after longer periods without call.
  */
 #include "lwesp/lwesp.h"
 #include "lwesp/lwesp_mem.h"
@@ -66,17 +87,138 @@
 #define LWESP_USART_RDR_NAME              RDR
 #endif /* !defined(LWESP_USART_RDR_NAME) */
 
+#if defined(LWESP_USART_DMA_TX_CH)
+#define LWESP_USART_DMA_TX                1
+
+#if !defined(LWESP_USART_DMA_TX_BUFF_SIZE)
+#define LWESP_USART_DMA_TX_BUFF_SIZE      0x800
+#endif /* !defined(LWESP_USART_DMA_TX_BUFF_SIZE) */
+
+#if !defined(LWESP_USART_TDR_NAME)
+#define LWESP_USART_TDR_NAME              TDR
+#endif /* !defined(LWESP_USART_TDR_NAME) */
+#else
+#define LWESP_USART_DMA_TX                0
+#endif /* defined(LWESP_USART_DMA_TX_CH) */
+
+#if !defined(LWESP_USART_DMA_DCACHE)
+#define LWESP_USART_DMA_DCACHE            0
+#endif /* !defined(LWESP_USART_DMA_DCACHE) */
+
+#if LWESP_USART_DMA_DCACHE
+#if !defined(LWESP_USART_DMA_DCACHE_LINE)
+#if defined(__SCB_DCACHE_LINE_SIZE)
+#define LWESP_USART_DMA_DCACHE_LINE       __SCB_DCACHE_LINE_SIZE
+#else
+#define LWESP_USART_DMA_DCACHE_LINE       32
+#endif /* defined(__SCB_DCACHE_LINE_SIZE) */
+#endif /* !defined(LWESP_USART_DMA_DCACHE_LINE) */
+
+#if (LWESP_USART_DMA_RX_BUFF_SIZE % LWESP_USART_DMA_DCACHE_LINE) != 0
+#error "LWESP_USART_DMA_RX_BUFF_SIZE must be multiple of data cache line size"
+#endif
+#if LWESP_USART_DMA_TX && (LWESP_USART_DMA_TX_BUFF_SIZE % LWESP_USART_DMA_DCACHE_LINE) != 0
+#error "LWESP_USART_DMA_TX_BUFF_SIZE must be multiple of data cache line size"
+#endif
+
+#define LWESP_USART_DMA_MEM_ALIGN         __ALIGNED(LWESP_USART_DMA_DCACHE_LINE)
+#else
+#define LWESP_USART_DMA_MEM_ALIGN
+#endif /* LWESP_USART_DMA_DCACHE */
+
 /* USART memory */
-static uint8_t      usart_mem[LWESP_USART_DMA_RX_BUFF_SIZE];
+LWESP_USART_DMA_MEM_ALIGN static uint8_t usart_mem[LWESP_USART_DMA_RX_BUFF_SIZE];
 static uint8_t      is_running, initialized;
 static size_t       old_pos;
 
-/* USART thread */
+/* USART thread and its flag, set from interrupts on new data */
 static void usart_ll_thread(void* arg);
 static osThreadId_t usart_ll_thread_id;
+#define USART_LL_THREAD_FLAG_RX           0x01U
 
-/* Message queue */
-static osMessageQueueId_t usart_ll_mbox_id;
+#if LWESP_USART_DMA_TX
+/* USART TX double buffer */
+LWESP_USART_DMA_MEM_ALIGN static uint8_t usart_tx_mem[2][LWESP_USART_DMA_TX_BUFF_SIZE];
+static uint8_t      usart_tx_idx;
+static size_t       usart_tx_len;
+
+/* Semaphore, available when TX DMA is idle */
+static osSemaphoreId_t usart_tx_sem_id;
+#endif /* LWESP_USART_DMA_TX */
+
+#if LWESP_CFG_MEM_FAST_COPY_LL_LEN && defined(LWESP_MEMCPY_DMA_STREAM)
+#define LWESP_MEMCPY_DMA_EN               1
+
+#if !defined(LWESP_MEMCPY_DMA_ADDR_OK)
+#define LWESP_MEMCPY_DMA_ADDR_OK(addr)    1
+#endif /* !defined(LWESP_MEMCPY_DMA_ADDR_OK) */
+
+/* Mutex for DMA stream access and semaphore, released on transfer complete */
+static osMutexId_t memcpy_dma_mutex_id;
+static osSemaphoreId_t memcpy_dma_sem_id;
+#else
+#define LWESP_MEMCPY_DMA_EN               0
+#endif /* LWESP_CFG_MEM_FAST_COPY_LL_LEN && defined(LWESP_MEMCPY_DMA_STREAM) */
+
+#if LWESP_USART_DMA_DCACHE
+/**
+ * \brief           Align memory range to data cache lines
+ * \param[in]       addr: Range start address
+ * \param[in]       len: Range length in units of bytes
+ * \param[out]      start: Output cache line aligned start address
+ * \return          Cache line aligned range length in units of bytes
+ */
+static int32_t
+dcache_range(const void* addr, size_t len, uint32_t* start) {
+    uint32_t end = ((uint32_t)addr + len + LWESP_USART_DMA_DCACHE_LINE - 1) & ~(uint32_t)(LWESP_USART_DMA_DCACHE_LINE - 1);
+
+    *start = (uint32_t)addr & ~(uint32_t)(LWESP_USART_DMA_DCACHE_LINE - 1);
+    return (int32_t)(end - *start);
+}
+
+/**
+ * \brief           Invalidate data cache for memory written by DMA, before CPU reads it
+ *
+ * CPU never writes to RX buffer, partially received lines at range edges
+ * are therefore safe to invalidate; they are fetched again on next read.
+ *
+ * \param[in]       addr: Range start address
+ * \param[in]       len: Range length in units of bytes
+ */
+static void
+dcache_invalidate(const void* addr, size_t len) {
+    uint32_t start;
+    int32_t size = dcache_range(addr, len, &start);
+
+    SCB_InvalidateDCache_by_Addr((void*)start, size);
+}
+
+/**
+ * \brief           Clean data cache for memory written by CPU, before DMA reads it
+ * \param[in]       addr: Range start address
+ * \param[in]       len: Range length in units of bytes
+ */
+static void
+dcache_clean(const void* addr, size_t len) {
+    uint32_t start;
+    int32_t size = dcache_range(addr, len, &start);
+
+    SCB_CleanDCache_by_Addr((void*)start, size);
+}
+
+/**
+ * \brief           Process received DMA data after invalidating its cache lines
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data in units of bytes
+ */
+static void
+usart_input_process(const void* data, size_t len) {
+    dcache_invalidate(data, len);
+    lwesp_input_process(data, len);
+}
+#else
+#define usart_input_process(data, len)    lwesp_input_process((data), (len))
+#endif /* LWESP_USART_DMA_DCACHE */
 
 /**
  * \brief           USART data processing
@@ -88,23 +230,25 @@ usart_ll_thread(void* arg) {
     LWESP_UNUSED(arg);
 
     while (1) {
-        void* d;
-        /* Wait for the event message from DMA or USART */
-        osMessageQueueGet(usart_ll_mbox_id, &d, NULL, osWaitForever);
+        /* Wait for notification from DMA or USART, flags set meanwhile are coalesced */
+        osThreadFlagsWait(USART_LL_THREAD_FLAG_RX, osFlagsWaitAny, osWaitForever);
 
-        /* Read data */
+        /* Process everything received up to now, including data received during processing */
+        while (1) {
 #if defined(LWESP_USART_DMA_RX_STREAM)
-        pos = sizeof(usart_mem) - LL_DMA_GetDataLength(LWESP_USART_DMA, LWESP_USART_DMA_RX_STREAM);
+            pos = sizeof(usart_mem) - LL_DMA_GetDataLength(LWESP_USART_DMA, LWESP_USART_DMA_RX_STREAM);
 #else
-        pos = sizeof(usart_mem) - LL_DMA_GetDataLength(LWESP_USART_DMA, LWESP_USART_DMA_RX_CH);
+            pos = sizeof(usart_mem) - LL_DMA_GetDataLength(LWESP_USART_DMA, LWESP_USART_DMA_RX_CH);
 #endif /* defined(LWESP_USART_DMA_RX_STREAM) */
-        if (pos != old_pos && is_running) {
+            if (pos == old_pos || !is_running) {
+                break;
+            }
             if (pos > old_pos) {
-                lwesp_input_process(&usart_mem[old_pos], pos - old_pos);
+                usart_input_process(&usart_mem[old_pos], pos - old_pos);
             } else {
-                lwesp_input_process(&usart_mem[old_pos], sizeof(usart_mem) - old_pos);
+                usart_input_process(&usart_mem[old_pos], sizeof(usart_mem) - old_pos);
                 if (pos > 0) {
-                    lwesp_input_process(&usart_mem[0], pos);
+                    usart_input_process(&usart_mem[0], pos);
                 }
             }
             old_pos = pos;
@@ -115,11 +259,36 @@ usart_ll_thread(void* arg) {
     }
 }
 
+/**
+ * \brief           Get USART hardware flow control setup for ESP flow control mode
+ * \param[in]       flow_control: ESP side flow control mode, see \ref LWESP_CFG_AT_PORT_FLOW_CONTROL
+ * \return          USART hardware flow control value
+ */
+static uint32_t
+get_usart_flow_control(uint8_t flow_control) {
+    uint32_t hw = LL_USART_HWCONTROL_NONE;
+
+#if defined(LWESP_USART_CTS_PIN)
+    if (flow_control & 0x01) {                  /* ESP RTS is connected to host CTS */
+        hw |= LL_USART_HWCONTROL_CTS;
+    }
+#endif /* defined(LWESP_USART_CTS_PIN) */
+#if defined(LWESP_USART_RTS_PIN)
+    if (flow_control & 0x02) {                  /* ESP CTS is connected to host RTS */
+        hw |= LL_USART_HWCONTROL_RTS;
+    }
+#endif /* defined(LWESP_USART_RTS_PIN) */
+    LWESP_UNUSED(flow_control);
+    return hw;
+}
+
 /**
  * \brief           Configure UART using DMA for receive in double buffer mode and IDLE line detection
+ * \param[in]       baudrate: UART baudrate
+ * \param[in]       flow_control: ESP side flow control mode, see \ref LWESP_CFG_AT_PORT_FLOW_CONTROL
  */
 static void
-configure_uart(uint32_t baudrate) {
+configure_uart(uint32_t baudrate, uint8_t flow_control) {
     static LL_USART_InitTypeDef usart_init;
     static LL_DMA_InitTypeDef dma_init;
     LL_GPIO_InitTypeDef gpio_init;
@@ -131,6 +300,14 @@ configure_uart(uint32_t baudrate) {
         LWESP_USART_TX_PORT_CLK;
         LWESP_USART_RX_PORT_CLK;
 
+#if defined(LWESP_USART_RTS_PIN)
+        LWESP_USART_RTS_PORT_CLK;
+#endif /* defined(LWESP_USART_RTS_PIN) */
+
+#if defined(LWESP_USART_CTS_PIN)
+        LWESP_USART_CTS_PORT_CLK;
+#endif /* defined(LWESP_USART_CTS_PIN) */
+
 #if defined(LWESP_RESET_PIN)
         LWESP_RESET_PORT_CLK;
 #endif /* defined(LWESP_RESET_PIN) */
@@ -194,12 +371,26 @@ configure_uart(uint32_t baudrate) {
         gpio_init.Pin = LWESP_USART_RX_PIN;
         LL_GPIO_Init(LWESP_USART_RX_PORT, &gpio_init);
 
+#if defined(LWESP_USART_RTS_PIN)
+        /* RTS PIN */
+        gpio_init.Alternate = LWESP_USART_RTS_PIN_AF;
+        gpio_init.Pin = LWESP_USART_RTS_PIN;
+        LL_GPIO_Init(LWESP_USART_RTS_PORT, &gpio_init);
+#endif /* defined(LWESP_USART_RTS_PIN) */
+
+#if defined(LWESP_USART_CTS_PIN)
+        /* CTS PIN */
+        gpio_init.Alternate = LWESP_USART_CTS_PIN_AF;
+        gpio_init.Pin = LWESP_USART_CTS_PIN;
+        LL_GPIO_Init(LWESP_USART_CTS_PORT, &gpio_init);
+#endif /* defined(LWESP_USART_CTS_PIN) */
+
         /* Configure UART */
         LL_USART_DeInit(LWESP_USART);
         LL_USART_StructInit(&usart_init);
         usart_init.BaudRate = baudrate;
         usart_init.DataWidth = LL_USART_DATAWIDTH_8B;
-        usart_init.HardwareFlowControl = LL_USART_HWCONTROL_NONE;
+        usart_init.HardwareFlowControl = get_usart_flow_control(flow_control);
         usart_init.OverSampling = LL_USART_OVERSAMPLING_16;
         usart_init.Parity = LL_USART_PARITY_NONE;
         usart_init.StopBits = LL_USART_STOPBITS_1;
@@ -258,6 +449,39 @@ configure_uart(uint32_t baudrate) {
         NVIC_SetPriority(LWESP_USART_DMA_RX_IRQ, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 0x07, 0x00));
         NVIC_EnableIRQ(LWESP_USART_DMA_RX_IRQ);
 
+#if LWESP_USART_DMA_TX
+        /* Configure TX DMA, memory address and length are set for each transfer */
+#if defined(LWESP_USART_DMA_TX_STREAM)
+        LL_DMA_DeInit(LWESP_USART_DMA, LWESP_USART_DMA_TX_STREAM);
+        dma_init.Channel = LWESP_USART_DMA_TX_CH;
+#else
+        LL_DMA_DeInit(LWESP_USART_DMA, LWESP_USART_DMA_TX_CH);
+        dma_init.PeriphRequest = LWESP_USART_DMA_TX_REQ_NUM;
+#endif /* defined(LWESP_USART_DMA_TX_STREAM) */
+        dma_init.PeriphOrM2MSrcAddress = (uint32_t)&LWESP_USART->LWESP_USART_TDR_NAME;
+        dma_init.MemoryOrM2MDstAddress = (uint32_t)usart_tx_mem[0];
+        dma_init.Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+        dma_init.Mode = LL_DMA_MODE_NORMAL;
+        dma_init.NbData = 0;
+#if defined(LWESP_USART_DMA_TX_STREAM)
+        LL_DMA_Init(LWESP_USART_DMA, LWESP_USART_DMA_TX_STREAM, &dma_init);
+        LL_DMA_EnableIT_TC(LWESP_USART_DMA, LWESP_USART_DMA_TX_STREAM);
+#else
+        LL_DMA_Init(LWESP_USART_DMA, LWESP_USART_DMA_TX_CH, &dma_init);
+        LL_DMA_EnableIT_TC(LWESP_USART_DMA, LWESP_USART_DMA_TX_CH);
+#endif /* defined(LWESP_USART_DMA_TX_STREAM) */
+        LL_USART_EnableDMAReq_TX(LWESP_USART);
+
+        NVIC_SetPriority(LWESP_USART_DMA_TX_IRQ, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 0x07, 0x00));
+        NVIC_EnableIRQ(LWESP_USART_DMA_TX_IRQ);
+
+        usart_tx_idx = 0;
+        usart_tx_len = 0;
+        if (usart_tx_sem_id == NULL) {
+            usart_tx_sem_id = osSemaphoreNew(1, 1, NULL);
+        }
+#endif /* LWESP_USART_DMA_TX */
+
         old_pos = 0;
         is_running = 1;
 
@@ -269,24 +493,104 @@ configure_uart(uint32_t baudrate) {
 #endif /* defined(LWESP_USART_DMA_RX_STREAM) */
         LL_USART_Enable(LWESP_USART);
     } else {
+#if LWESP_USART_DMA_TX
+        /* Wait for pending transmission before USART is reconfigured */
+        osSemaphoreAcquire(usart_tx_sem_id, osWaitForever);
+        while (!LL_USART_IsActiveFlag_TC(LWESP_USART)) {}
+        osSemaphoreRelease(usart_tx_sem_id);
+#endif /* LWESP_USART_DMA_TX */
         osDelay(10);
         LL_USART_Disable(LWESP_USART);
         usart_init.BaudRate = baudrate;
+        usart_init.HardwareFlowControl = get_usart_flow_control(flow_control);
         LL_USART_Init(LWESP_USART, &usart_init);
         LL_USART_Enable(LWESP_USART);
     }
 
-    /* Create mbox and start thread */
-    if (usart_ll_mbox_id == NULL) {
-        usart_ll_mbox_id = osMessageQueueNew(10, sizeof(void*), NULL);
-    }
+    /* Start thread */
     if (usart_ll_thread_id == NULL) {
         const osThreadAttr_t attr = {
             .stack_size = 1024
         };
-        usart_ll_thread_id = osThreadNew(usart_ll_thread, usart_ll_mbox_id, &attr);
+        usart_ll_thread_id = osThreadNew(usart_ll_thread, NULL, &attr);
+    }
+}
+
+#if LWESP_MEMCPY_DMA_EN
+/**
+ * \brief           Configure memory-to-memory DMA stream for \ref lwesp_ll_memcpy
+ */
+static void
+configure_memcpy_dma(void) {
+    LWESP_MEMCPY_DMA_CLK;
+    LL_DMA_DeInit(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM);
+    LL_DMA_ConfigTransfer(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM,
+                          LL_DMA_DIRECTION_MEMORY_TO_MEMORY | LL_DMA_MODE_NORMAL
+                          | LL_DMA_PERIPH_INCREMENT | LL_DMA_MEMORY_INCREMENT
+                          | LL_DMA_PDATAALIGN_WORD | LL_DMA_MDATAALIGN_WORD | LL_DMA_PRIORITY_LOW);
+    LL_DMA_EnableFifoMode(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM);
+    LL_DMA_SetFIFOThreshold(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM, LL_DMA_FIFOTHRESHOLD_FULL);
+    LL_DMA_SetMemoryBurstxfer(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM, LL_DMA_MBURST_INC4);
+    LL_DMA_SetPeriphBurstxfer(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM, LL_DMA_PBURST_INC4);
+    LL_DMA_EnableIT_TC(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM);
+    LL_DMA_EnableIT_TE(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM);
+
+    NVIC_SetPriority(LWESP_MEMCPY_DMA_IRQ, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 0x07, 0x00));
+    NVIC_EnableIRQ(LWESP_MEMCPY_DMA_IRQ);
+
+    if (memcpy_dma_mutex_id == NULL) {
+        memcpy_dma_mutex_id = osMutexNew(NULL);
+    }
+    if (memcpy_dma_sem_id == NULL) {
+        memcpy_dma_sem_id = osSemaphoreNew(1, 0, NULL);
     }
 }
+#endif /* LWESP_MEMCPY_DMA_EN */
+
+#if LWESP_CFG_MEM_FAST_COPY_LL_LEN
+/**
+ * \brief           Copy memory with DMA
+ *
+ * Only word aligned copies of word multiple length are executed,
+ * CPU copy is used for other cases or when DMA is not ready.
+ *
+ * \param[out]      dst: Destination memory start address
+ * \param[in]       src: Source memory start address
+ * \param[in]       len: Number of bytes to copy
+ * \return          `1` if data were copied, `0` otherwise
+ */
+uint8_t
+lwesp_ll_memcpy(void* dst, const void* src, size_t len) {
+#if LWESP_MEMCPY_DMA_EN
+    uint8_t ok;
+
+    if (memcpy_dma_sem_id == NULL || ((uint32_t)dst | (uint32_t)src | len) & 0x03
+        || len / 4 > 0xFFFF || !LWESP_MEMCPY_DMA_ADDR_OK(dst) || !LWESP_MEMCPY_DMA_ADDR_OK(src)
+        || __get_IPSR() != 0) {
+        return 0;
+    }
+
+    osMutexAcquire(memcpy_dma_mutex_id, osWaitForever);
+    LWESP_MEMCPY_DMA_CLEAR_ALL;
+    LL_DMA_SetM2MSrcAddress(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM, (uint32_t)src);
+    LL_DMA_SetM2MDstAddress(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM, (uint32_t)dst);
+    LL_DMA_SetDataLength(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM, len / 4);
+    LL_DMA_EnableStream(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM);
+    osSemaphoreAcquire(memcpy_dma_sem_id, osWaitForever);
+    ok = LL_DMA_GetDataLength(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM) == 0;
+    osMutexRelease(memcpy_dma_mutex_id);
+    if (!ok) {                                  /* Transfer error, copy with CPU */
+        return 0;
+    }
+    return 1;
+#else /* LWESP_MEMCPY_DMA_EN */
+    LWESP_UNUSED(dst);
+    LWESP_UNUSED(src);
+    LWESP_UNUSED(len);
+    return 0;
+#endif /* !LWESP_MEMCPY_DMA_EN */
+}
+#endif /* LWESP_CFG_MEM_FAST_COPY_LL_LEN */
 
 #if defined(LWESP_RESET_PIN)
 /**
@@ -303,6 +607,40 @@ reset_device(uint8_t state) {
 }
 #endif /* defined(LWESP_RESET_PIN) */
 
+#if LWESP_USART_DMA_TX
+/**
+ * \brief           Start DMA transmission of currently filled TX buffer
+ *
+ * Function waits for previous transmission to finish,
+ * then switches to other buffer for next data
+ */
+static void
+send_data_dma_start(void) {
+    if (usart_tx_len == 0) {
+        return;
+    }
+
+#if LWESP_USART_DMA_DCACHE
+    dcache_clean(usart_tx_mem[usart_tx_idx], usart_tx_len);    /* Write buffer to memory for DMA */
+#endif /* LWESP_USART_DMA_DCACHE */
+
+    /* Wait until DMA is done with other buffer */
+    osSemaphoreAcquire(usart_tx_sem_id, osWaitForever);
+#if defined(LWESP_USART_DMA_TX_STREAM)
+    LL_DMA_SetMemoryAddress(LWESP_USART_DMA, LWESP_USART_DMA_TX_STREAM, (uint32_t)usart_tx_mem[usart_tx_idx]);
+    LL_DMA_SetDataLength(LWESP_USART_DMA, LWESP_USART_DMA_TX_STREAM, usart_tx_len);
+    LL_DMA_EnableStream(LWESP_USART_DMA, LWESP_USART_DMA_TX_STREAM);
+#else
+    LL_DMA_SetMemoryAddress(LWESP_USART_DMA, LWESP_USART_DMA_TX_CH, (uint32_t)usart_tx_mem[usart_tx_idx]);
+    LL_DMA_SetDataLength(LWESP_USART_DMA, LWESP_USART_DMA_TX_CH, usart_tx_len);
+    LL_DMA_EnableChannel(LWESP_USART_DMA, LWESP_USART_DMA_TX_CH);
+#endif /* defined(LWESP_USART_DMA_TX_STREAM) */
+
+    usart_tx_idx ^= 1;                          /* Fill other buffer now */
+    usart_tx_len = 0;
+}
+#endif /* LWESP_USART_DMA_TX */
+
 /**
  * \brief           Send data to ESP device
  * \param[in]       data: Pointer to data to send
@@ -313,13 +651,73 @@ static size_t
 send_data(const void* data, size_t len) {
     const uint8_t* d = data;
 
+#if LWESP_USART_DMA_TX
+    if (d == NULL || len == 0) {                /* Flush request */
+        send_data_dma_start();
+        return 0;
+    }
+    for (size_t i = 0, to_copy; i < len; i += to_copy) {
+        to_copy = LWESP_MIN(len - i, sizeof(usart_tx_mem[0]) - usart_tx_len);
+        LWESP_MEMCPY(&usart_tx_mem[usart_tx_idx][usart_tx_len], &d[i], to_copy);
+        usart_tx_len += to_copy;
+        if (usart_tx_len == sizeof(usart_tx_mem[0])) {
+            send_data_dma_start();              /* Buffer is full, start transmission */
+        }
+    }
+#else /* LWESP_USART_DMA_TX */
     for (size_t i = 0; i < len; ++i, ++d) {
         LL_USART_TransmitData8(LWESP_USART, *d);
         while (!LL_USART_IsActiveFlag_TXE(LWESP_USART)) {}
     }
+#endif /* !LWESP_USART_DMA_TX */
     return len;
 }
 
+#if LWESP_CFG_SYS_NOW_US
+
+static uint32_t     now_us, now_us_cyc, now_us_rem, now_us_ms;
+
+/**
+ * \brief           Enable DWT cycle counter used as microsecond time base
+ */
+static void
+configure_cycle_counter(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    now_us_cyc = 0;
+    now_us_ms = lwesp_sys_now();
+}
+
+/**
+ * \brief           Get current time in units of microseconds from DWT cycle counter
+ * \return          Current time in units of microseconds
+ */
+uint32_t
+lwesp_sys_now_us(void) {
+    uint32_t cyc, ms, cpu, primask, ret;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    cyc = DWT->CYCCNT;
+    ms = lwesp_sys_now();
+    cpu = SystemCoreClock / 1000000U;           /* Cycles per microsecond */
+    if ((ms - now_us_ms) >= (0xFFFFFFFFU / (SystemCoreClock / 1000U)) / 2) {
+        now_us += (ms - now_us_ms) * 1000U;     /* Counter may have wrapped, resync to kernel tick */
+    } else {
+        now_us_rem += cyc - now_us_cyc;
+        now_us += now_us_rem / cpu;
+        now_us_rem %= cpu;
+    }
+    now_us_cyc = cyc;
+    now_us_ms = ms;
+    ret = now_us;
+    __set_PRIMASK(primask);
+    return ret;
+}
+
+#endif /* LWESP_CFG_SYS_NOW_US */
+
 /**
  * \brief           Callback function called from initialization process
  */
@@ -328,7 +726,7 @@ lwesp_ll_init(lwesp_ll_t* ll) {
 #if !LWESP_CFG_MEM_CUSTOM
     static uint8_t memory[LWESP_MEM_SIZE];
     lwesp_mem_region_t mem_regions[] = {
-        { memory, sizeof(memory) }
+        { .start_addr = memory, .size = sizeof(memory) }
     };
 
     if (!initialized) {
@@ -343,7 +741,18 @@ lwesp_ll_init(lwesp_ll_t* ll) {
 #endif /* defined(LWESP_RESET_PIN) */
     }
 
-    configure_uart(ll->uart.baudrate);          /* Initialize UART for communication */
+#if LWESP_MEMCPY_DMA_EN
+    if (!initialized) {
+        configure_memcpy_dma();
+    }
+#endif /* LWESP_MEMCPY_DMA_EN */
+#if LWESP_CFG_SYS_NOW_US
+    if (!initialized) {
+        configure_cycle_counter();
+    }
+#endif /* LWESP_CFG_SYS_NOW_US */
+
+    configure_uart(ll->uart.baudrate, ll->uart.flow_control);   /* Initialize UART for communication */
     initialized = 1;
     return lwespOK;
 }
@@ -353,16 +762,30 @@ lwesp_ll_init(lwesp_ll_t* ll) {
  */
 lwespr_t
 lwesp_ll_deinit(lwesp_ll_t* ll) {
-    if (usart_ll_mbox_id != NULL) {
-        osMessageQueueId_t tmp = usart_ll_mbox_id;
-        usart_ll_mbox_id = NULL;
-        osMessageQueueDelete(tmp);
-    }
     if (usart_ll_thread_id != NULL) {
         osThreadId_t tmp = usart_ll_thread_id;
         usart_ll_thread_id = NULL;
         osThreadTerminate(tmp);
     }
+#if LWESP_USART_DMA_TX
+    if (usart_tx_sem_id != NULL) {
+        osSemaphoreId_t tmp = usart_tx_sem_id;
+        usart_tx_sem_id = NULL;
+        osSemaphoreDelete(tmp);
+    }
+#endif /* LWESP_USART_DMA_TX */
+#if LWESP_MEMCPY_DMA_EN
+    if (memcpy_dma_sem_id != NULL) {
+        osSemaphoreId_t tmp = memcpy_dma_sem_id;
+        memcpy_dma_sem_id = NULL;
+        osSemaphoreDelete(tmp);
+    }
+    if (memcpy_dma_mutex_id != NULL) {
+        osMutexId_t tmp = memcpy_dma_mutex_id;
+        memcpy_dma_mutex_id = NULL;
+        osMutexDelete(tmp);
+    }
+#endif /* LWESP_MEMCPY_DMA_EN */
     initialized = 0;
     LWESP_UNUSED(ll);
     return lwespOK;
@@ -379,9 +802,8 @@ LWESP_USART_IRQHANDLER(void) {
     LL_USART_ClearFlag_ORE(LWESP_USART);
     LL_USART_ClearFlag_NE(LWESP_USART);
 
-    if (usart_ll_mbox_id != NULL) {
-        void* d = (void*)1;
-        osMessageQueuePut(usart_ll_mbox_id, &d, 0, 0);
+    if (usart_ll_thread_id != NULL) {
+        osThreadFlagsSet(usart_ll_thread_id, USART_LL_THREAD_FLAG_RX);
     }
 }
 
@@ -393,10 +815,43 @@ LWESP_USART_DMA_RX_IRQHANDLER(void) {
     LWESP_USART_DMA_RX_CLEAR_TC;
     LWESP_USART_DMA_RX_CLEAR_HT;
 
-    if (usart_ll_mbox_id != NULL) {
-        void* d = (void*)1;
-        osMessageQueuePut(usart_ll_mbox_id, &d, 0, 0);
+    if (usart_ll_thread_id != NULL) {
+        osThreadFlagsSet(usart_ll_thread_id, USART_LL_THREAD_FLAG_RX);
+    }
+}
+
+#if LWESP_USART_DMA_TX
+/**
+ * \brief           UART TX DMA stream/channel handler
+ */
+void
+LWESP_USART_DMA_TX_IRQHANDLER(void) {
+    if (LWESP_USART_DMA_TX_IS_TC) {
+        LWESP_USART_DMA_TX_CLEAR_TC;
+#if defined(LWESP_USART_DMA_TX_STREAM)
+        LL_DMA_DisableStream(LWESP_USART_DMA, LWESP_USART_DMA_TX_STREAM);
+#else
+        LL_DMA_DisableChannel(LWESP_USART_DMA, LWESP_USART_DMA_TX_CH);
+#endif /* defined(LWESP_USART_DMA_TX_STREAM) */
+        if (usart_tx_sem_id != NULL) {
+            osSemaphoreRelease(usart_tx_sem_id);
+        }
+    }
+}
+#endif /* LWESP_USART_DMA_TX */
+
+#if LWESP_MEMCPY_DMA_EN
+/**
+ * \brief           Memory copy DMA stream handler
+ */
+void
+LWESP_MEMCPY_DMA_IRQHANDLER(void) {
+    LWESP_MEMCPY_DMA_CLEAR_ALL;
+    LL_DMA_DisableStream(LWESP_MEMCPY_DMA, LWESP_MEMCPY_DMA_STREAM);
+    if (memcpy_dma_sem_id != NULL) {
+        osSemaphoreRelease(memcpy_dma_sem_id);
     }
 }
+#endif /* LWESP_MEMCPY_DMA_EN */
 
 #endif /* !__DOXYGEN__ */
@@ -0,0 +1,603 @@
+/**
+ * \file            lwesp_ll_stm32_spi.c
+ * \brief           Generic STM32 SPI driver, included in various STM32 SPI driver variants
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+
+/*
+ * How it works
+ *
+ * Driver is alternative to UART based lwesp_ll_stm32.c, for ESP-AT firmware built with SPI AT interface.
+ * Host is SPI master, ESP device is slave and notifies host with handshake line (rising edge) when
+ * it has data to send or when it is ready to receive data, previously requested by host.
+ *
+ * Every transaction starts with command, address and dummy byte, followed by optional data phase, executed by DMA:
+ *
+ *  - Host requests to send: `WRBUF` to address `0x00`, data `{0xFE, seq, len_lo, len_hi}`
+ *  - Host reads slave status after handshake: `RDBUF` from address `0x04`, data `{dir, seq, len_lo, len_hi}`
+ *  - Slave is ready to receive (`dir == 2`, `seq` matches request): `WRDMA` with data, followed by `WR_DONE`
+ *  - Slave has data (`dir == 1`, `seq` differs from last read frame): `RDDMA` with `len` data bytes, followed by `RD_DONE`
+ *
+ * Received frames are passed to \ref lwesp_input_process as byte stream, parser is not aware of transport.
+ * Data to send are copied to one of two transmit buffers by \ref lwesp_ll_send_fn, while other is sent by driver thread.
+ * Frame is sent when buffer is full or on flush request.
+ *
+ * Driver thread owns the bus, all transactions are executed by it. When data are sent as part of
+ * input processing (in driver thread), previously pending frame is sent immediately and frames received meanwhile
+ * are queued and processed once current frame processing is finished.
+ *
+ * Only STM32 families with DMA streams (F4, F7) are supported by this driver.
+ *
+ * \ref LWESP_CFG_INPUT_USE_PROCESS must be enabled in `lwesp_config.h` to use this driver.
+ */
+#include "lwesp/lwesp.h"
+#include "lwesp/lwesp_mem.h"
+#include "lwesp/lwesp_input.h"
+#include "system/lwesp_ll.h"
+
+#if !__DOXYGEN__
+
+#if !LWESP_CFG_INPUT_USE_PROCESS
+#error "LWESP_CFG_INPUT_USE_PROCESS must be enabled in `lwesp_config.h` to use this driver."
+#endif /* LWESP_CFG_INPUT_USE_PROCESS */
+
+#if !defined(LWESP_SPI_DMA_RX_STREAM) || !defined(LWESP_SPI_DMA_TX_STREAM)
+#error "SPI driver requires DMA streams, define LWESP_SPI_DMA_RX_STREAM and LWESP_SPI_DMA_TX_STREAM"
+#endif /* !defined(LWESP_SPI_DMA_RX_STREAM) || !defined(LWESP_SPI_DMA_TX_STREAM) */
+
+/* Maximal frame length supported by ESP-AT SPI interface */
+#define SPI_FRAME_MAX_LEN                 4092
+
+#if !defined(LWESP_SPI_TX_BUFF_SIZE)
+#define LWESP_SPI_TX_BUFF_SIZE            0x800
+#endif /* !defined(LWESP_SPI_TX_BUFF_SIZE) */
+
+#if LWESP_SPI_TX_BUFF_SIZE > SPI_FRAME_MAX_LEN
+#error "LWESP_SPI_TX_BUFF_SIZE must not exceed maximal SPI frame length"
+#endif /* LWESP_SPI_TX_BUFF_SIZE > SPI_FRAME_MAX_LEN */
+
+#if !defined(LWESP_SPI_PRESCALER)
+#define LWESP_SPI_PRESCALER               LL_SPI_BAUDRATEPRESCALER_DIV4
+#endif /* !defined(LWESP_SPI_PRESCALER) */
+
+#if !defined(LWESP_SPI_TIMEOUT)
+#define LWESP_SPI_TIMEOUT                 100
+#endif /* !defined(LWESP_SPI_TIMEOUT) */
+
+#if !defined(LWESP_SPI_TX_RETRIES)
+#define LWESP_SPI_TX_RETRIES              10
+#endif /* !defined(LWESP_SPI_TX_RETRIES) */
+
+#if !defined(LWESP_MEM_SIZE)
+#define LWESP_MEM_SIZE                    0x1000
+#endif /* !defined(LWESP_MEM_SIZE) */
+
+/* Transaction commands and addresses */
+#define SPI_CMD_WRBUF                     0x01
+#define SPI_CMD_RDBUF                     0x02
+#define SPI_CMD_WRDMA                     0x03
+#define SPI_CMD_RDDMA                     0x04
+#define SPI_CMD_WR_DONE                   0x07
+#define SPI_CMD_RD_DONE                   0x08
+#define SPI_ADDR_WRBUF                    0x00
+#define SPI_ADDR_RDBUF                    0x04
+#define SPI_SEND_MAGIC                    0xFE
+
+/* Slave status direction */
+#define SPI_DIR_READ                      0x01  /* Slave has data for host */
+#define SPI_DIR_WRITE                     0x02  /* Slave is ready to receive data from host */
+
+/* Thread flags */
+#define SPI_LL_THREAD_FLAG_HS             0x01U /* Handshake line activated */
+#define SPI_LL_THREAD_FLAG_TX             0x02U /* Transmit frame is pending */
+#define SPI_LL_THREAD_FLAG_DMA            0x04U /* Data phase finished */
+
+/* Number of received frames that may wait for processing */
+#define SPI_RX_FRAMES                     2
+
+/* Receive frames queue */
+static uint8_t      spi_rx_mem[SPI_RX_FRAMES][SPI_FRAME_MAX_LEN];
+static size_t       spi_rx_len[SPI_RX_FRAMES];
+static uint8_t      spi_rx_r, spi_rx_w, spi_rx_cnt, spi_rx_seq;
+
+/* Transmit double buffer, pending frame and semaphore, available when no frame is pending */
+static uint8_t      spi_tx_mem[2][LWESP_SPI_TX_BUFF_SIZE];
+static uint8_t      spi_tx_idx, spi_tx_seq;
+static size_t       spi_tx_len;
+static const uint8_t* spi_tx_frame;
+static size_t       spi_tx_frame_len;
+static osSemaphoreId_t spi_tx_sem_id;
+
+/* Dummy byte for transmit and receive direction of data phase */
+static uint8_t      spi_dummy;
+
+static uint8_t      initialized;
+
+/* SPI thread */
+static void spi_ll_thread(void* arg);
+static osThreadId_t spi_ll_thread_id;
+
+/**
+ * \brief           Transfer single byte in polling mode
+ * \param[in]       b: Byte to send
+ * \return          Received byte
+ */
+static uint8_t
+spi_transfer_byte(uint8_t b) {
+    while (!LL_SPI_IsActiveFlag_TXE(LWESP_SPI)) {}
+    LL_SPI_TransmitData8(LWESP_SPI, b);
+    while (!LL_SPI_IsActiveFlag_RXNE(LWESP_SPI)) {}
+    return LL_SPI_ReceiveData8(LWESP_SPI);
+}
+
+/**
+ * \brief           Execute single SPI transaction
+ *
+ * Command, address and dummy byte are sent in polling mode, data phase is executed by DMA.
+ *
+ * \param[in]       cmd: Transaction command
+ * \param[in]       addr: Transaction address
+ * \param[in]       tx: Data to send in data phase. Set to `NULL` to send dummy bytes
+ * \param[out]      rx: Memory for received data in data phase. Set to `NULL` to ignore received data
+ * \param[in]       len: Length of data phase in units of bytes. Set to `0` for no data phase
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+spi_transaction(uint8_t cmd, uint8_t addr, const void* tx, void* rx, size_t len) {
+    uint8_t ok = 1;
+
+    LL_GPIO_ResetOutputPin(LWESP_SPI_CS_PORT, LWESP_SPI_CS_PIN);
+    spi_transfer_byte(cmd);
+    spi_transfer_byte(addr);
+    spi_transfer_byte(0x00);
+
+    if (len > 0) {
+        osThreadFlagsClear(SPI_LL_THREAD_FLAG_DMA);
+        LWESP_SPI_DMA_RX_CLEAR_ALL;
+        LWESP_SPI_DMA_TX_CLEAR_ALL;
+
+        /* Receive stream is started first, transmit stream generates clock */
+        LL_DMA_SetMemoryAddress(LWESP_SPI_DMA, LWESP_SPI_DMA_RX_STREAM, (uint32_t)(rx != NULL ? rx : &spi_dummy));
+        LL_DMA_SetMemoryIncMode(LWESP_SPI_DMA, LWESP_SPI_DMA_RX_STREAM, rx != NULL ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT);
+        LL_DMA_SetDataLength(LWESP_SPI_DMA, LWESP_SPI_DMA_RX_STREAM, len);
+        LL_DMA_SetMemoryAddress(LWESP_SPI_DMA, LWESP_SPI_DMA_TX_STREAM, (uint32_t)(tx != NULL ? tx : &spi_dummy));
+        LL_DMA_SetMemoryIncMode(LWESP_SPI_DMA, LWESP_SPI_DMA_TX_STREAM, tx != NULL ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT);
+        LL_DMA_SetDataLength(LWESP_SPI_DMA, LWESP_SPI_DMA_TX_STREAM, len);
+        LL_DMA_EnableStream(LWESP_SPI_DMA, LWESP_SPI_DMA_RX_STREAM);
+        LL_DMA_EnableStream(LWESP_SPI_DMA, LWESP_SPI_DMA_TX_STREAM);
+        LL_SPI_EnableDMAReq_RX(LWESP_SPI);
+        LL_SPI_EnableDMAReq_TX(LWESP_SPI);
+
+        /* Wait for last byte to be received */
+        if (osThreadFlagsWait(SPI_LL_THREAD_FLAG_DMA, osFlagsWaitAny, LWESP_SPI_TIMEOUT) & osFlagsError
+            || LL_DMA_GetDataLength(LWESP_SPI_DMA, LWESP_SPI_DMA_RX_STREAM) != 0) {
+            ok = 0;
+        }
+        LL_SPI_DisableDMAReq_TX(LWESP_SPI);
+        LL_SPI_DisableDMAReq_RX(LWESP_SPI);
+        LL_DMA_DisableStream(LWESP_SPI_DMA, LWESP_SPI_DMA_TX_STREAM);
+        LL_DMA_DisableStream(LWESP_SPI_DMA, LWESP_SPI_DMA_RX_STREAM);
+        while (LL_DMA_IsEnabledStream(LWESP_SPI_DMA, LWESP_SPI_DMA_TX_STREAM)
+               || LL_DMA_IsEnabledStream(LWESP_SPI_DMA, LWESP_SPI_DMA_RX_STREAM)) {}
+    }
+
+    while (LL_SPI_IsActiveFlag_BSY(LWESP_SPI)) {}
+    while (LL_SPI_IsActiveFlag_RXNE(LWESP_SPI)) {  /* Flush data left after failed transfer */
+        (void)LL_SPI_ReceiveData8(LWESP_SPI);
+    }
+    LL_GPIO_SetOutputPin(LWESP_SPI_CS_PORT, LWESP_SPI_CS_PIN);
+    return ok;
+}
+
+/**
+ * \brief           Read slave status and serve its receive request
+ *
+ * When slave has data for host and receive queue is not full, frame is read to the queue.
+ *
+ * \return          \ref SPI_DIR_WRITE when slave is ready to receive pending transmit frame,
+ *                      \ref SPI_DIR_READ when frame has been received, `0` otherwise
+ */
+static uint8_t
+spi_poll(void) {
+    uint8_t status[4];
+    size_t len;
+
+    if (!spi_transaction(SPI_CMD_RDBUF, SPI_ADDR_RDBUF, NULL, status, sizeof(status))) {
+        return 0;
+    }
+    len = (size_t)status[2] | ((size_t)status[3] << 8);
+    if (status[0] == SPI_DIR_WRITE && spi_tx_frame != NULL && status[1] == spi_tx_seq) {
+        return SPI_DIR_WRITE;
+    } else if (status[0] == SPI_DIR_READ && status[1] != spi_rx_seq /* Same sequence is already read frame */
+               && len > 0 && len <= SPI_FRAME_MAX_LEN && spi_rx_cnt < SPI_RX_FRAMES) {
+        if (spi_transaction(SPI_CMD_RDDMA, 0x00, NULL, spi_rx_mem[spi_rx_w], len)) {
+            spi_transaction(SPI_CMD_RD_DONE, 0x00, NULL, NULL, 0);
+            spi_rx_seq = status[1];
+            spi_rx_len[spi_rx_w] = len;
+            spi_rx_w = (spi_rx_w + 1) % SPI_RX_FRAMES;
+            ++spi_rx_cnt;
+            return SPI_DIR_READ;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Send pending transmit frame
+ *
+ * Function requests transfer and waits for slave to become ready,
+ * frames received meanwhile are only queued to keep processing order.
+ * Request is repeated on timeout, frame is dropped when slave does not respond.
+ */
+static void
+spi_tx_process(void) {
+    uint8_t req[4], ready = 0;
+
+    if (spi_tx_frame == NULL) {
+        return;
+    }
+
+    ++spi_tx_seq;
+    req[0] = SPI_SEND_MAGIC;
+    req[1] = spi_tx_seq;
+    req[2] = LWESP_U8(spi_tx_frame_len);
+    req[3] = LWESP_U8(spi_tx_frame_len >> 8);
+    spi_transaction(SPI_CMD_WRBUF, SPI_ADDR_WRBUF, req, NULL, sizeof(req));
+
+    for (size_t retries = LWESP_SPI_TX_RETRIES; retries > 0;) {
+        if (spi_poll() == SPI_DIR_WRITE) {
+            ready = 1;
+            break;
+        }
+        if (osThreadFlagsWait(SPI_LL_THREAD_FLAG_HS, osFlagsWaitAny, LWESP_SPI_TIMEOUT) & osFlagsError) {
+            /* Request may have been lost, repeat it */
+            spi_transaction(SPI_CMD_WRBUF, SPI_ADDR_WRBUF, req, NULL, sizeof(req));
+            --retries;
+        }
+    }
+    if (ready) {
+        spi_transaction(SPI_CMD_WRDMA, 0x00, spi_tx_frame, NULL, spi_tx_frame_len);
+        spi_transaction(SPI_CMD_WR_DONE, 0x00, NULL, NULL, 0);
+    }
+
+    spi_tx_frame = NULL;
+    spi_tx_frame_len = 0;
+    osSemaphoreRelease(spi_tx_sem_id);
+}
+
+/**
+ * \brief           Process queued received frames
+ */
+static void
+spi_rx_process(void) {
+    while (spi_rx_cnt > 0) {
+        lwesp_input_process(spi_rx_mem[spi_rx_r], spi_rx_len[spi_rx_r]);
+        spi_rx_r = (spi_rx_r + 1) % SPI_RX_FRAMES;
+        --spi_rx_cnt;
+    }
+}
+
+/**
+ * \brief           SPI bus processing thread
+ */
+static void
+spi_ll_thread(void* arg) {
+    LWESP_UNUSED(arg);
+
+    while (1) {
+        uint8_t full;
+
+        osThreadFlagsWait(SPI_LL_THREAD_FLAG_HS | SPI_LL_THREAD_FLAG_TX, osFlagsWaitAny, osWaitForever);
+        do {
+            spi_tx_process();
+
+            /* Read frames until status reports no new frame, sequence number prevents double read */
+            while (spi_rx_cnt < SPI_RX_FRAMES && spi_poll() == SPI_DIR_READ) {}
+            full = spi_rx_cnt == SPI_RX_FRAMES;
+            spi_rx_process();
+        } while (spi_tx_frame != NULL || full);
+    }
+}
+
+/**
+ * \brief           Configure SPI, DMA streams, chip select and handshake pins
+ */
+static void
+configure_spi(void) {
+    LL_SPI_InitTypeDef spi_init;
+    LL_DMA_InitTypeDef dma_init;
+    LL_GPIO_InitTypeDef gpio_init;
+    LL_EXTI_InitTypeDef exti_init;
+
+    /* Enable peripheral clocks */
+    LWESP_SPI_CLK;
+    LWESP_SPI_DMA_CLK;
+    LWESP_SPI_SCK_PORT_CLK;
+    LWESP_SPI_MISO_PORT_CLK;
+    LWESP_SPI_MOSI_PORT_CLK;
+    LWESP_SPI_CS_PORT_CLK;
+    LWESP_SPI_HS_PORT_CLK;
+    LL_APB2_GRP1_EnableClock(LL_APB2_GRP1_PERIPH_SYSCFG);
+
+#if defined(LWESP_RESET_PIN)
+    LWESP_RESET_PORT_CLK;
+#endif /* defined(LWESP_RESET_PIN) */
+
+    /* Configure output pins */
+    LL_GPIO_StructInit(&gpio_init);
+    gpio_init.OutputType = LL_GPIO_OUTPUT_PUSHPULL;
+    gpio_init.Pull = LL_GPIO_PULL_UP;
+    gpio_init.Speed = LL_GPIO_SPEED_FREQ_VERY_HIGH;
+    gpio_init.Mode = LL_GPIO_MODE_OUTPUT;
+
+#if defined(LWESP_RESET_PIN)
+    /* Configure RESET pin */
+    gpio_init.Pin = LWESP_RESET_PIN;
+    LL_GPIO_Init(LWESP_RESET_PORT, &gpio_init);
+#endif /* defined(LWESP_RESET_PIN) */
+
+    /* Configure CS pin, inactive high */
+    LL_GPIO_SetOutputPin(LWESP_SPI_CS_PORT, LWESP_SPI_CS_PIN);
+    gpio_init.Pin = LWESP_SPI_CS_PIN;
+    LL_GPIO_Init(LWESP_SPI_CS_PORT, &gpio_init);
+
+    /* Configure SPI pins */
+    gpio_init.Mode = LL_GPIO_MODE_ALTERNATE;
+    gpio_init.Pull = LL_GPIO_PULL_NO;
+    gpio_init.Alternate = LWESP_SPI_SCK_PIN_AF;
+    gpio_init.Pin = LWESP_SPI_SCK_PIN;
+    LL_GPIO_Init(LWESP_SPI_SCK_PORT, &gpio_init);
+    gpio_init.Alternate = LWESP_SPI_MISO_PIN_AF;
+    gpio_init.Pin = LWESP_SPI_MISO_PIN;
+    LL_GPIO_Init(LWESP_SPI_MISO_PORT, &gpio_init);
+    gpio_init.Alternate = LWESP_SPI_MOSI_PIN_AF;
+    gpio_init.Pin = LWESP_SPI_MOSI_PIN;
+    LL_GPIO_Init(LWESP_SPI_MOSI_PORT, &gpio_init);
+
+    /* Configure handshake pin with rising edge interrupt */
+    gpio_init.Mode = LL_GPIO_MODE_INPUT;
+    gpio_init.Pull = LL_GPIO_PULL_DOWN;
+    gpio_init.Pin = LWESP_SPI_HS_PIN;
+    LL_GPIO_Init(LWESP_SPI_HS_PORT, &gpio_init);
+    LWESP_SPI_HS_EXTI_SOURCE;
+    LL_EXTI_StructInit(&exti_init);
+    exti_init.Line_0_31 = LWESP_SPI_HS_EXTI_LINE;
+    exti_init.LineCommand = ENABLE;
+    exti_init.Mode = LL_EXTI_MODE_IT;
+    exti_init.Trigger = LL_EXTI_TRIGGER_RISING;
+    LL_EXTI_Init(&exti_init);
+    NVIC_SetPriority(LWESP_SPI_HS_EXTI_IRQ, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 0x07, 0x00));
+    NVIC_EnableIRQ(LWESP_SPI_HS_EXTI_IRQ);
+
+    /* Configure SPI in master mode 0 */
+    LL_SPI_DeInit(LWESP_SPI);
+    LL_SPI_StructInit(&spi_init);
+    spi_init.TransferDirection = LL_SPI_FULL_DUPLEX;
+    spi_init.Mode = LL_SPI_MODE_MASTER;
+    spi_init.DataWidth = LL_SPI_DATAWIDTH_8BIT;
+    spi_init.ClockPolarity = LL_SPI_POLARITY_LOW;
+    spi_init.ClockPhase = LL_SPI_PHASE_1EDGE;
+    spi_init.NSS = LL_SPI_NSS_SOFT;
+    spi_init.BaudRate = LWESP_SPI_PRESCALER;
+    spi_init.BitOrder = LL_SPI_MSB_FIRST;
+    LL_SPI_Init(LWESP_SPI, &spi_init);
+#if defined(SPI_CR2_FRXTH)
+    LL_SPI_SetRxFIFOThreshold(LWESP_SPI, LL_SPI_RX_FIFO_TH_QUARTER);
+#endif /* defined(SPI_CR2_FRXTH) */
+
+    /* Configure DMA streams, memory address and length are set for each transfer */
+    LL_DMA_StructInit(&dma_init);
+    LL_DMA_DeInit(LWESP_SPI_DMA, LWESP_SPI_DMA_RX_STREAM);
+    dma_init.Channel = LWESP_SPI_DMA_RX_CH;
+    dma_init.PeriphOrM2MSrcAddress = (uint32_t)&LWESP_SPI->DR;
+    dma_init.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+    dma_init.Mode = LL_DMA_MODE_NORMAL;
+    dma_init.PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT;
+    dma_init.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT;
+    dma_init.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+    dma_init.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+    dma_init.Priority = LL_DMA_PRIORITY_HIGH;
+    LL_DMA_Init(LWESP_SPI_DMA, LWESP_SPI_DMA_RX_STREAM, &dma_init);
+    LL_DMA_EnableIT_TC(LWESP_SPI_DMA, LWESP_SPI_DMA_RX_STREAM);
+    LL_DMA_EnableIT_TE(LWESP_SPI_DMA, LWESP_SPI_DMA_RX_STREAM);
+
+    LL_DMA_DeInit(LWESP_SPI_DMA, LWESP_SPI_DMA_TX_STREAM);
+    dma_init.Channel = LWESP_SPI_DMA_TX_CH;
+    dma_init.Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+    dma_init.Priority = LL_DMA_PRIORITY_MEDIUM;
+    LL_DMA_Init(LWESP_SPI_DMA, LWESP_SPI_DMA_TX_STREAM, &dma_init);
+
+    NVIC_SetPriority(LWESP_SPI_DMA_RX_IRQ, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 0x07, 0x00));
+    NVIC_EnableIRQ(LWESP_SPI_DMA_RX_IRQ);
+
+    LL_SPI_Enable(LWESP_SPI);
+
+    spi_rx_r = spi_rx_w = spi_rx_cnt = 0;
+    spi_rx_seq = 0;
+    spi_tx_seq = 0;
+    spi_tx_idx = 0;
+    spi_tx_len = 0;
+    spi_tx_frame = NULL;
+    if (spi_tx_sem_id == NULL) {
+        spi_tx_sem_id = osSemaphoreNew(1, 1, NULL);
+    }
+
+    /* Start thread */
+    if (spi_ll_thread_id == NULL) {
+        const osThreadAttr_t attr = {
+            .stack_size = 1024
+        };
+        spi_ll_thread_id = osThreadNew(spi_ll_thread, NULL, &attr);
+    }
+}
+
+#if defined(LWESP_RESET_PIN)
+/**
+ * \brief           Hardware reset callback
+ */
+static uint8_t
+reset_device(uint8_t state) {
+    if (state) {                                /* Activate reset line */
+        LL_GPIO_ResetOutputPin(LWESP_RESET_PORT, LWESP_RESET_PIN);
+    } else {
+        LL_GPIO_SetOutputPin(LWESP_RESET_PORT, LWESP_RESET_PIN);
+    }
+    return 1;
+}
+#endif /* defined(LWESP_RESET_PIN) */
+
+/**
+ * \brief           Pass currently filled transmit buffer to driver thread
+ *
+ * When called from driver thread (during input processing), previous pending frame is sent first.
+ * Other threads wait until previous frame is sent.
+ */
+static void
+send_data_frame_start(void) {
+    if (spi_tx_len == 0) {
+        return;
+    }
+
+    if (osThreadGetId() == spi_ll_thread_id) {
+        spi_tx_process();                       /* Thread cannot wait for itself, send previous frame now */
+    }
+    osSemaphoreAcquire(spi_tx_sem_id, osWaitForever);
+    spi_tx_frame_len = spi_tx_len;
+    spi_tx_frame = spi_tx_mem[spi_tx_idx];
+    if (osThreadGetId() != spi_ll_thread_id) {
+        osThreadFlagsSet(spi_ll_thread_id, SPI_LL_THREAD_FLAG_TX);
+    }
+
+    spi_tx_idx ^= 1;                            /* Fill other buffer now */
+    spi_tx_len = 0;
+}
+
+/**
+ * \brief           Send data to ESP device
+ * \param[in]       data: Pointer to data to send
+ * \param[in]       len: Number of bytes to send
+ * \return          Number of bytes sent
+ */
+static size_t
+send_data(const void* data, size_t len) {
+    const uint8_t* d = data;
+
+    if (d == NULL || len == 0) {                /* Flush request */
+        send_data_frame_start();
+        return 0;
+    }
+    for (size_t i = 0, to_copy; i < len; i += to_copy) {
+        to_copy = LWESP_MIN(len - i, sizeof(spi_tx_mem[0]) - spi_tx_len);
+        LWESP_MEMCPY(&spi_tx_mem[spi_tx_idx][spi_tx_len], &d[i], to_copy);
+        spi_tx_len += to_copy;
+        if (spi_tx_len == sizeof(spi_tx_mem[0])) {
+            send_data_frame_start();            /* Buffer is full, start transmission */
+        }
+    }
+    return len;
+}
+
+/**
+ * \brief           Callback function called from initialization process
+ */
+lwespr_t
+lwesp_ll_init(lwesp_ll_t* ll) {
+#if !LWESP_CFG_MEM_CUSTOM
+    static uint8_t memory[LWESP_MEM_SIZE];
+    lwesp_mem_region_t mem_regions[] = {
+        { .start_addr = memory, .size = sizeof(memory) }
+    };
+
+    if (!initialized) {
+        lwesp_mem_assignmemory(mem_regions, LWESP_ARRAYSIZE(mem_regions));  /* Assign memory for allocations */
+    }
+#endif /* !LWESP_CFG_MEM_CUSTOM */
+
+    /* UART parameters are not used, interface is always SPI */
+    if (!initialized) {
+        ll->send_fn = send_data;                /* Set callback function to send data */
+#if defined(LWESP_RESET_PIN)
+        ll->reset_fn = reset_device;            /* Set callback for hardware reset */
+#endif /* defined(LWESP_RESET_PIN) */
+        configure_spi();
+    }
+    initialized = 1;
+    return lwespOK;
+}
+
+/**
+ * \brief           Callback function to de-init low-level communication part
+ */
+lwespr_t
+lwesp_ll_deinit(lwesp_ll_t* ll) {
+    NVIC_DisableIRQ(LWESP_SPI_HS_EXTI_IRQ);
+    NVIC_DisableIRQ(LWESP_SPI_DMA_RX_IRQ);
+    if (spi_ll_thread_id != NULL) {
+        osThreadId_t tmp = spi_ll_thread_id;
+        spi_ll_thread_id = NULL;
+        osThreadTerminate(tmp);
+    }
+    if (spi_tx_sem_id != NULL) {
+        osSemaphoreId_t tmp = spi_tx_sem_id;
+        spi_tx_sem_id = NULL;
+        osSemaphoreDelete(tmp);
+    }
+    LL_SPI_Disable(LWESP_SPI);
+    initialized = 0;
+    LWESP_UNUSED(ll);
+    return lwespOK;
+}
+
+/**
+ * \brief           Handshake line interrupt handler
+ */
+void
+LWESP_SPI_HS_EXTI_IRQHANDLER(void) {
+    if (LL_EXTI_IsActiveFlag_0_31(LWESP_SPI_HS_EXTI_LINE)) {
+        LL_EXTI_ClearFlag_0_31(LWESP_SPI_HS_EXTI_LINE);
+        if (spi_ll_thread_id != NULL) {
+            osThreadFlagsSet(spi_ll_thread_id, SPI_LL_THREAD_FLAG_HS);
+        }
+    }
+}
+
+/**
+ * \brief           SPI receive DMA stream handler, last byte of data phase has been received
+ */
+void
+LWESP_SPI_DMA_RX_IRQHANDLER(void) {
+    LWESP_SPI_DMA_RX_CLEAR_ALL;
+    if (spi_ll_thread_id != NULL) {
+        osThreadFlagsSet(spi_ll_thread_id, SPI_LL_THREAD_FLAG_DMA);
+    }
+}
+
+#endif /* !__DOXYGEN__ */
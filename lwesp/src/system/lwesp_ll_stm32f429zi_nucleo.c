@@ -62,6 +62,7 @@
 #define LWESP_USART_IRQ                       USART2_IRQn
 #define LWESP_USART_IRQHANDLER                USART2_IRQHandler
 #define LWESP_USART_RDR_NAME                  DR
+#define LWESP_USART_TDR_NAME                  DR
 
 /* DMA settings */
 #define LWESP_USART_DMA                       DMA1
@@ -70,12 +71,33 @@
 #define LWESP_USART_DMA_RX_CH                 LL_DMA_CHANNEL_4
 #define LWESP_USART_DMA_RX_IRQ                DMA1_Stream5_IRQn
 #define LWESP_USART_DMA_RX_IRQHANDLER         DMA1_Stream5_IRQHandler
+#define LWESP_USART_DMA_TX_STREAM             LL_DMA_STREAM_6
+#define LWESP_USART_DMA_TX_CH                 LL_DMA_CHANNEL_4
+#define LWESP_USART_DMA_TX_IRQ                DMA1_Stream6_IRQn
+#define LWESP_USART_DMA_TX_IRQHANDLER         DMA1_Stream6_IRQHandler
 
 /* DMA flags management */
 #define LWESP_USART_DMA_RX_IS_TC              LL_DMA_IsActiveFlag_TC5(LWESP_USART_DMA)
 #define LWESP_USART_DMA_RX_IS_HT              LL_DMA_IsActiveFlag_HT5(LWESP_USART_DMA)
 #define LWESP_USART_DMA_RX_CLEAR_TC           LL_DMA_ClearFlag_TC5(LWESP_USART_DMA)
 #define LWESP_USART_DMA_RX_CLEAR_HT           LL_DMA_ClearFlag_HT5(LWESP_USART_DMA)
+#define LWESP_USART_DMA_TX_IS_TC              LL_DMA_IsActiveFlag_TC6(LWESP_USART_DMA)
+#define LWESP_USART_DMA_TX_CLEAR_TC           LL_DMA_ClearFlag_TC6(LWESP_USART_DMA)
+
+/* Memory copy DMA settings, only DMA2 supports memory-to-memory transfers, CCM RAM is not accessible */
+#define LWESP_MEMCPY_DMA                      DMA2
+#define LWESP_MEMCPY_DMA_CLK                  LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA2)
+#define LWESP_MEMCPY_DMA_STREAM               LL_DMA_STREAM_0
+#define LWESP_MEMCPY_DMA_IRQ                  DMA2_Stream0_IRQn
+#define LWESP_MEMCPY_DMA_IRQHANDLER           DMA2_Stream0_IRQHandler
+#define LWESP_MEMCPY_DMA_ADDR_OK(addr)        (((uint32_t)(addr) & 0xFFFF0000UL) != CCMDATARAM_BASE)
+#define LWESP_MEMCPY_DMA_CLEAR_ALL            do {                                \
+        LL_DMA_ClearFlag_TC0(LWESP_MEMCPY_DMA);                                     \
+        LL_DMA_ClearFlag_HT0(LWESP_MEMCPY_DMA);                                     \
+        LL_DMA_ClearFlag_TE0(LWESP_MEMCPY_DMA);                                     \
+        LL_DMA_ClearFlag_FE0(LWESP_MEMCPY_DMA);                                     \
+        LL_DMA_ClearFlag_DME0(LWESP_MEMCPY_DMA);                                    \
+    } while (0)
 
 /* USART TX PIN */
 #define LWESP_USART_TX_PORT_CLK               LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_GPIOD)
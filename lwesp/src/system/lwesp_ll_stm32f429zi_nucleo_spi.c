@@ -0,0 +1,133 @@
+/**
+ * \file            lwesp_ll_stm32f429zi_nucleo_spi.c
+ * \brief           Low-level communication with ESP device for STM32F429ZI-Nucleo using SPI interface and DMA
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+
+/*
+ * Default SPI configuration is (Arduino connector on board):
+ *
+ * SPI:                 SPI1
+ * SCK:                 GPIOA, GPIO_PIN_5
+ * MISO:                GPIOA, GPIO_PIN_6
+ * MOSI:                GPIOA, GPIO_PIN_7
+ * CS:                  GPIOD, GPIO_PIN_14
+ * HANDSHAKE:           GPIOF, GPIO_PIN_12
+ * RESET:               GPIOD, GPIO_PIN_1
+ *
+ * SPI_DMA:             DMA2
+ * SPI_DMA_RX_STREAM:   DMA_STREAM_2
+ * SPI_DMA_TX_STREAM:   DMA_STREAM_3
+ * SPI_DMA_CHANNEL:     DMA_CHANNEL_3
+ */
+
+#if !__DOXYGEN__
+
+#include "stm32f4xx_ll_bus.h"
+#include "stm32f4xx_ll_spi.h"
+#include "stm32f4xx_ll_gpio.h"
+#include "stm32f4xx_ll_dma.h"
+#include "stm32f4xx_ll_exti.h"
+#include "stm32f4xx_ll_system.h"
+#include "stm32f4xx_ll_rcc.h"
+
+/* SPI */
+#define LWESP_SPI                             SPI1
+#define LWESP_SPI_CLK                         LL_APB2_GRP1_EnableClock(LL_APB2_GRP1_PERIPH_SPI1)
+#define LWESP_SPI_PRESCALER                   LL_SPI_BAUDRATEPRESCALER_DIV4
+
+/* DMA settings */
+#define LWESP_SPI_DMA                         DMA2
+#define LWESP_SPI_DMA_CLK                     LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA2)
+#define LWESP_SPI_DMA_RX_STREAM               LL_DMA_STREAM_2
+#define LWESP_SPI_DMA_RX_CH                   LL_DMA_CHANNEL_3
+#define LWESP_SPI_DMA_RX_IRQ                  DMA2_Stream2_IRQn
+#define LWESP_SPI_DMA_RX_IRQHANDLER           DMA2_Stream2_IRQHandler
+#define LWESP_SPI_DMA_TX_STREAM               LL_DMA_STREAM_3
+#define LWESP_SPI_DMA_TX_CH                   LL_DMA_CHANNEL_3
+
+/* DMA flags management */
+#define LWESP_SPI_DMA_RX_CLEAR_ALL            do {                                \
+        LL_DMA_ClearFlag_TC2(LWESP_SPI_DMA);                                        \
+        LL_DMA_ClearFlag_HT2(LWESP_SPI_DMA);                                        \
+        LL_DMA_ClearFlag_TE2(LWESP_SPI_DMA);                                        \
+        LL_DMA_ClearFlag_FE2(LWESP_SPI_DMA);                                        \
+        LL_DMA_ClearFlag_DME2(LWESP_SPI_DMA);                                       \
+    } while (0)
+#define LWESP_SPI_DMA_TX_CLEAR_ALL            do {                                \
+        LL_DMA_ClearFlag_TC3(LWESP_SPI_DMA);                                        \
+        LL_DMA_ClearFlag_HT3(LWESP_SPI_DMA);                                        \
+        LL_DMA_ClearFlag_TE3(LWESP_SPI_DMA);                                        \
+        LL_DMA_ClearFlag_FE3(LWESP_SPI_DMA);                                        \
+        LL_DMA_ClearFlag_DME3(LWESP_SPI_DMA);                                       \
+    } while (0)
+
+/* SPI SCK PIN */
+#define LWESP_SPI_SCK_PORT_CLK                LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_GPIOA)
+#define LWESP_SPI_SCK_PORT                    GPIOA
+#define LWESP_SPI_SCK_PIN                     LL_GPIO_PIN_5
+#define LWESP_SPI_SCK_PIN_AF                  LL_GPIO_AF_5
+
+/* SPI MISO PIN */
+#define LWESP_SPI_MISO_PORT_CLK               LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_GPIOA)
+#define LWESP_SPI_MISO_PORT                   GPIOA
+#define LWESP_SPI_MISO_PIN                    LL_GPIO_PIN_6
+#define LWESP_SPI_MISO_PIN_AF                 LL_GPIO_AF_5
+
+/* SPI MOSI PIN */
+#define LWESP_SPI_MOSI_PORT_CLK               LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_GPIOA)
+#define LWESP_SPI_MOSI_PORT                   GPIOA
+#define LWESP_SPI_MOSI_PIN                    LL_GPIO_PIN_7
+#define LWESP_SPI_MOSI_PIN_AF                 LL_GPIO_AF_5
+
+/* SPI CS PIN */
+#define LWESP_SPI_CS_PORT_CLK                 LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_GPIOD)
+#define LWESP_SPI_CS_PORT                     GPIOD
+#define LWESP_SPI_CS_PIN                      LL_GPIO_PIN_14
+
+/* Handshake PIN */
+#define LWESP_SPI_HS_PORT_CLK                 LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_GPIOF)
+#define LWESP_SPI_HS_PORT                     GPIOF
+#define LWESP_SPI_HS_PIN                      LL_GPIO_PIN_12
+#define LWESP_SPI_HS_EXTI_LINE                LL_EXTI_LINE_12
+#define LWESP_SPI_HS_EXTI_SOURCE              LL_SYSCFG_SetEXTISource(LL_SYSCFG_EXTI_PORTF, LL_SYSCFG_EXTI_LINE12)
+#define LWESP_SPI_HS_EXTI_IRQ                 EXTI15_10_IRQn
+#define LWESP_SPI_HS_EXTI_IRQHANDLER          EXTI15_10_IRQHandler
+
+/* RESET PIN */
+#define LWESP_RESET_PORT_CLK                  LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_GPIOD)
+#define LWESP_RESET_PORT                      GPIOD
+#define LWESP_RESET_PIN                       LL_GPIO_PIN_1
+
+/* Include STM32 generic SPI driver */
+#include "../system/lwesp_ll_stm32_spi.c"
+
+#endif /* !__DOXYGEN__ */
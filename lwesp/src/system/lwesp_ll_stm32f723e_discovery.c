@@ -75,6 +75,9 @@
 #define LWESP_USART_DMA_RX_CLEAR_TC           LL_DMA_ClearFlag_TC0(LWESP_USART_DMA)
 #define LWESP_USART_DMA_RX_CLEAR_HT           LL_DMA_ClearFlag_HT0(LWESP_USART_DMA)
 
+/* Data cache maintenance for DMA buffers */
+#define LWESP_USART_DMA_DCACHE                1
+
 /* USART TX PIN */
 #define LWESP_USART_TX_PORT_CLK               LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_GPIOC)
 #define LWESP_USART_TX_PORT                   GPIOC
@@ -76,7 +76,7 @@ lwesp_ll_init(lwesp_ll_t* ll) {
      * multiple memories may be used
      */
     lwesp_mem_region_t mem_regions[] = {
-        { memory, sizeof(memory) }
+        { .start_addr = memory, .size = sizeof(memory) }
     };
     if (!initialized) {
         lwesp_mem_assignmemory(mem_regions, LWESP_ARRAYSIZE(mem_regions));  /* Assign memory for allocations to ESP library */
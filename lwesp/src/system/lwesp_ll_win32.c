@@ -36,23 +36,76 @@
 #include "lwesp/lwesp_mem.h"
 #include "lwesp/lwesp_input.h"
 
+/*
+ * How it works
+ *
+ * COM port is opened in overlapped mode. Receive thread sleeps in `WaitCommEvent`
+ * until first character arrives, then reads all available data in bulk and passes them to upper layer.
+ *
+ * Transmit data are copied to one of two buffers and written asynchronously,
+ * when buffer is full or on flush request. Caller only waits when previous write is still in progress.
+ */
 #if !__DOXYGEN__
 
 volatile uint8_t lwesp_ll_win32_driver_ignore_data;
 static uint8_t initialized = 0;
 static HANDLE thread_handle;
 static volatile HANDLE com_port;                /*!< COM port handle */
-static uint8_t data_buffer[0x1000];             /*!< Received data array */
+static uint8_t data_buffer[0x10000];            /*!< Received data array */
+
+static uint8_t tx_buffer[2][0x1000];            /*!< Transmit double buffer */
+static uint8_t tx_idx;                          /*!< Index of buffer currently being filled */
+static size_t tx_len;                           /*!< Number of bytes in buffer currently being filled */
+static OVERLAPPED tx_ov;                        /*!< Overlapped structure for write operation */
+static uint8_t tx_pending;                      /*!< Set to `1` when write operation is in progress */
 
 static void uart_thread(void* param);
 
+/**
+ * \brief           Wait for pending asynchronous write to finish
+ */
+static void
+send_data_wait(void) {
+    DWORD written;
+
+    if (tx_pending) {
+        GetOverlappedResult(com_port, &tx_ov, &written, TRUE);
+        tx_pending = 0;
+    }
+}
+
+/**
+ * \brief           Start asynchronous write of currently filled transmit buffer
+ */
+static void
+send_data_start(void) {
+    if (tx_len == 0) {
+        return;
+    }
+    send_data_wait();                           /* Other buffer must be sent before it is reused */
+
+    tx_ov.Offset = 0;
+    tx_ov.OffsetHigh = 0;
+    if (WriteFile(com_port, tx_buffer[tx_idx], (DWORD)tx_len, NULL, &tx_ov)
+        || GetLastError() == ERROR_IO_PENDING) {
+        tx_pending = 1;
+    } else {
+        printf("Cannot write to COM PORT\r\n");
+    }
+    tx_idx ^= 1;                                /* Fill other buffer now */
+    tx_len = 0;
+}
+
 /**
  * \brief           Send data to ESP device, function called from ESP stack when we have data to send
  */
 static size_t
 send_data(const void* data, size_t len) {
-    DWORD written;
     if (com_port != NULL) {
+        if (data == NULL || len == 0) {         /* Flush request */
+            send_data_start();
+            return 0;
+        }
 #if !LWESP_CFG_AT_ECHO
         const uint8_t* d = data;
         HANDLE hConsole;
@@ -65,18 +118,26 @@ send_data(const void* data, size_t len) {
         SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
 #endif /* !LWESP_CFG_AT_ECHO */
 
-        WriteFile(com_port, data, len, &written, NULL);
-        FlushFileBuffers(com_port);
-        return written;
+        for (size_t i = 0, to_copy; i < len; i += to_copy) {
+            to_copy = LWESP_MIN(len - i, sizeof(tx_buffer[0]) - tx_len);
+            LWESP_MEMCPY(&tx_buffer[tx_idx][tx_len], &((const uint8_t*)data)[i], to_copy);
+            tx_len += to_copy;
+            if (tx_len == sizeof(tx_buffer[0])) {
+                send_data_start();              /* Buffer is full, start write */
+            }
+        }
+        return len;
     }
     return 0;
 }
 
 /**
  * \brief           Configure UART (USB to UART)
+ * \param[in]       baudrate: UART baudrate
+ * \param[in]       flow_control: ESP side flow control mode, see \ref LWESP_CFG_AT_PORT_FLOW_CONTROL
  */
 static void
-configure_uart(uint32_t baudrate) {
+configure_uart(uint32_t baudrate, uint8_t flow_control) {
     DCB dcb = { 0 };
     dcb.DCBlength = sizeof(dcb);
 
@@ -91,10 +152,14 @@ configure_uart(uint32_t baudrate) {
                               0,
                               0,
                               OPEN_EXISTING,
-                              0,
+                              FILE_FLAG_OVERLAPPED,
                               NULL
                              );
+        if (tx_ov.hEvent == NULL) {
+            tx_ov.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+        }
     }
+    send_data_wait();                           /* Finish pending write before port is reconfigured */
 
     /* Configure COM port parameters */
     if (GetCommState(com_port, &dcb)) {
@@ -105,6 +170,10 @@ configure_uart(uint32_t baudrate) {
         dcb.Parity = NOPARITY;
         dcb.StopBits = ONESTOPBIT;
 
+        /* ESP RTS drives host CTS, ESP CTS is driven by host RTS */
+        dcb.fOutxCtsFlow = (flow_control & 0x01) ? TRUE : FALSE;
+        dcb.fRtsControl = (flow_control & 0x02) ? RTS_CONTROL_HANDSHAKE : RTS_CONTROL_ENABLE;
+
         if (!SetCommState(com_port, &dcb)) {
             printf("Cannot set COM PORT info\r\n");
         }
@@ -120,6 +189,7 @@ configure_uart(uint32_t baudrate) {
         } else {
             printf("Cannot get COM PORT timeouts\r\n");
         }
+        SetCommMask(com_port, EV_RXCHAR);       /* Wake up receive thread on new characters */
     } else {
         printf("Cannot get COM PORT info\r\n");
     }
@@ -135,7 +205,9 @@ configure_uart(uint32_t baudrate) {
  */
 static void
 uart_thread(void* param) {
-    DWORD bytes_read;
+    DWORD bytes_read, to_read, evt_mask;
+    uint8_t* d;
+    OVERLAPPED ov_evt = { 0 }, ov_read = { 0 };
     lwesp_sys_sem_t sem;
     FILE* file = NULL;
 
@@ -144,21 +216,50 @@ uart_thread(void* param) {
     while (com_port == NULL) {
         lwesp_sys_sem_wait(&sem, 1);            /* Add some delay with yield */
     }
+    ov_evt.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    ov_read.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
 
     fopen_s(&file, "log_file.txt", "w+");       /* Open debug file in write mode */
     while (1) {
+        /* Sleep until at least one character is received */
+        if (!WaitCommEvent(com_port, &evt_mask, &ov_evt)) {
+            if (GetLastError() != ERROR_IO_PENDING
+                || !GetOverlappedResult(com_port, &ov_evt, &bytes_read, TRUE)) {
+                lwesp_sys_sem_wait(&sem, 1);    /* Port not ready, add some delay with yield */
+                continue;
+            }
+        }
+
         /*
-         * Try to read data from COM port
+         * Read all available data from COM port
          * and send it to upper layer for processing
          */
         do {
-            ReadFile(com_port, data_buffer, sizeof(data_buffer), &bytes_read, NULL);
+            d = data_buffer;
+            to_read = (DWORD)sizeof(data_buffer);
+#if !LWESP_CFG_INPUT_USE_PROCESS
+            {
+                size_t len;
+
+                /* Read directly to input buffer, local buffer is used only when it is full */
+                if ((d = lwesp_input_get_write_buff(&len)) != NULL) {
+                    to_read = (DWORD)len;
+                } else {
+                    d = data_buffer;
+                }
+            }
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+            bytes_read = 0;
+            if (!ReadFile(com_port, d, to_read, &bytes_read, &ov_read)
+                && GetLastError() == ERROR_IO_PENDING) {
+                GetOverlappedResult(com_port, &ov_read, &bytes_read, TRUE);
+            }
             if (bytes_read > 0) {
                 HANDLE hConsole;
                 hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
                 SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN);
                 for (DWORD i = 0; i < bytes_read; ++i) {
-                    printf("%c", data_buffer[i]);
+                    printf("%c", d[i]);
                 }
                 SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
 
@@ -168,22 +269,24 @@ uart_thread(void* param) {
                 }
 
                 /* Send received data to input processing module */
-#if LWESP_CFG_INPUT_USE_PROCESS
-                lwesp_input_process(data_buffer, (size_t)bytes_read);
-#else /* LWESP_CFG_INPUT_USE_PROCESS */
-                lwesp_input(data_buffer, (size_t)bytes_read);
-#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
-
-                /* Write received data to output debug file */
+                /* Write received data to output debug file, before they are published to processing thread */
                 if (file != NULL) {
-                    fwrite(data_buffer, 1, bytes_read, file);
+                    fwrite(d, 1, bytes_read, file);
                     fflush(file);
                 }
-            }
-        } while (bytes_read == (DWORD)sizeof(data_buffer));
 
-        /* Implement delay to allow other tasks processing */
-        lwesp_sys_sem_wait(&sem, 1);
+                /* Send received data to input processing module */
+#if LWESP_CFG_INPUT_USE_PROCESS
+                lwesp_input_process(d, (size_t)bytes_read);
+#else /* LWESP_CFG_INPUT_USE_PROCESS */
+                if (d != data_buffer) {
+                    lwesp_input_commit((size_t)bytes_read);
+                } else {
+                    lwesp_input(d, (size_t)bytes_read);
+                }
+#endif /* !LWESP_CFG_INPUT_USE_PROCESS */
+            }
+        } while (bytes_read == to_read);
     }
 }
 
@@ -210,7 +313,7 @@ lwesp_ll_init(lwesp_ll_t* ll) {
      * multiple memories may be used
      */
     lwesp_mem_region_t mem_regions[] = {
-        { memory, sizeof(memory) }
+        { .start_addr = memory, .size = sizeof(memory) }
     };
     if (!initialized) {
         lwesp_mem_assignmemory(mem_regions, LWESP_ARRAYSIZE(mem_regions));  /* Assign memory for allocations to ESP library */
@@ -224,7 +327,7 @@ lwesp_ll_init(lwesp_ll_t* ll) {
     }
 
     /* Step 3: Configure AT port to be able to send/receive data to/from ESP device */
-    configure_uart(ll->uart.baudrate);          /* Initialize UART for communication */
+    configure_uart(ll->uart.baudrate, ll->uart.flow_control);   /* Initialize UART for communication */
     initialized = 1;
     return lwespOK;
 }
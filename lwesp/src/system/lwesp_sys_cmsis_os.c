@@ -206,4 +206,36 @@ lwesp_sys_thread_yield(void) {
     return 1;
 }
 
+#if LWESP_CFG_SYS_THREAD_NOTIFY
+
+uint8_t
+lwesp_sys_thread_notify_get(lwesp_sys_thread_notify_t* n) {
+    *n = osThreadGetId();
+    return *n != NULL;
+}
+
+uint32_t
+lwesp_sys_thread_notify_wait(uint32_t timeout) {
+    uint32_t tick = osKernelSysTick();
+    uint32_t flags = osThreadFlagsWait(LWESP_SYS_THREAD_NOTIFY_FLAG, osFlagsWaitAny, timeout == 0 ? osWaitForever : timeout);
+    return (flags & osFlagsError) ? LWESP_SYS_TIMEOUT : (osKernelSysTick() - tick);
+}
+
+uint8_t
+lwesp_sys_thread_notify(lwesp_sys_thread_notify_t* n) {
+    return (osThreadFlagsSet(*n, LWESP_SYS_THREAD_NOTIFY_FLAG) & osFlagsError) == 0;
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY */
+
+#if LWESP_CFG_SYS_THREAD_STACK_INFO
+
+uint8_t
+lwesp_sys_thread_stack_free(lwesp_sys_thread_t* t, size_t* free_ss) {
+    *free_ss = (size_t)osThreadGetStackSpace(*t);   /* Lowest free stack in bytes */
+    return 1;
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_STACK_INFO */
+
 #endif /* !__DOXYGEN__ */
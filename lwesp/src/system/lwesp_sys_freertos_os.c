@@ -223,4 +223,36 @@ lwesp_sys_thread_yield(void) {
     return 1;
 }
 
+#if LWESP_CFG_SYS_THREAD_NOTIFY
+
+uint8_t
+lwesp_sys_thread_notify_get(lwesp_sys_thread_notify_t* n) {
+    *n = xTaskGetCurrentTaskHandle();
+    return *n != NULL;
+}
+
+uint32_t
+lwesp_sys_thread_notify_wait(uint32_t timeout) {
+    uint32_t t = xTaskGetTickCount();
+    return ulTaskNotifyTake(pdTRUE, !timeout ? portMAX_DELAY : timeout) > 0 ? (xTaskGetTickCount() - t) : LWESP_SYS_TIMEOUT;
+}
+
+uint8_t
+lwesp_sys_thread_notify(lwesp_sys_thread_notify_t* n) {
+    xTaskNotifyGive(*n);
+    return 1;
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY */
+
+#if LWESP_CFG_SYS_THREAD_STACK_INFO
+
+uint8_t
+lwesp_sys_thread_stack_free(lwesp_sys_thread_t* t, size_t* free_ss) {
+    *free_ss = (size_t)uxTaskGetStackHighWaterMark(*t); /* Requires INCLUDE_uxTaskGetStackHighWaterMark */
+    return 1;
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_STACK_INFO */
+
 #endif /* !__DOXYGEN__ */
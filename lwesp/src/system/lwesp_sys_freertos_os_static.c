@@ -0,0 +1,433 @@
+/**
+ * \file            lwesp_sys_freertos_os_static.c
+ * \brief           System dependant functions for FreeRTOS with static allocation
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+
+/*
+ * All kernel objects are taken from static pools, sized in port header.
+ * No memory is allocated from FreeRTOS heap.
+ *
+ * Semaphores are not kernel objects. They are implemented with
+ * direct-to-task notifications: waiting threads are linked in FIFO list
+ * on their own stack and released thread is notified directly.
+ */
+#include "system/lwesp_sys.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#if !__DOXYGEN__
+
+/* Thread waiting for semaphore */
+typedef struct sem_waiter {
+    struct sem_waiter* next;                    /* Next waiting thread */
+    TaskHandle_t task;                          /* Task to notify */
+    volatile uint8_t signaled;                  /* Set to `1` when semaphore was given to this waiter */
+} sem_waiter_t;
+
+/* Semaphore object */
+typedef struct lwesp_sys_freertos_sem {
+    uint8_t used;                               /* Pool entry is in use */
+    uint8_t count;                              /* Semaphore count, binary semaphore */
+    sem_waiter_t* first;                        /* First waiting thread */
+    sem_waiter_t* last;                         /* Last waiting thread */
+} sem_t;
+
+typedef struct {
+    StaticSemaphore_t buff;
+    SemaphoreHandle_t handle;
+} mutex_entry_t;
+
+typedef struct {
+    StaticQueue_t buff;
+    uint8_t storage[LWESP_SYS_STATIC_MBOX_LEN * sizeof(void*)];
+    QueueHandle_t handle;
+} mbox_entry_t;
+
+typedef struct {
+    StaticTask_t tcb;
+    StackType_t stack[LWESP_SYS_THREAD_SS];
+    TaskHandle_t handle;
+} thread_entry_t;
+
+static StaticSemaphore_t sys_mutex_buff;
+static SemaphoreHandle_t sys_mutex;             /* Mutex ID for main protection */
+
+static mutex_entry_t mutexes[LWESP_SYS_STATIC_MUTEX_COUNT];
+static sem_t sems[LWESP_SYS_STATIC_SEM_COUNT];
+static mbox_entry_t mboxes[LWESP_SYS_STATIC_MBOX_COUNT];
+static thread_entry_t threads[LWESP_SYS_STATIC_THREAD_COUNT];
+
+uint8_t
+lwesp_sys_init(void) {
+    sys_mutex = xSemaphoreCreateRecursiveMutexStatic(&sys_mutex_buff);
+    return sys_mutex == NULL ? 0 : 1;
+}
+
+uint32_t
+lwesp_sys_now(void) {
+    return xTaskGetTickCount();
+}
+
+uint8_t
+lwesp_sys_protect(void) {
+    lwesp_sys_mutex_lock(&sys_mutex);
+    return 1;
+}
+
+uint8_t
+lwesp_sys_unprotect(void) {
+    lwesp_sys_mutex_unlock(&sys_mutex);
+    return 1;
+}
+
+uint8_t
+lwesp_sys_mutex_create(lwesp_sys_mutex_t* p) {
+    *p = NULL;
+    taskENTER_CRITICAL();
+    for (size_t i = 0; i < LWESP_SYS_STATIC_MUTEX_COUNT; ++i) {
+        if (mutexes[i].handle == NULL) {
+            *p = mutexes[i].handle = xSemaphoreCreateRecursiveMutexStatic(&mutexes[i].buff);
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return *p != NULL;
+}
+
+uint8_t
+lwesp_sys_mutex_delete(lwesp_sys_mutex_t* p) {
+    vSemaphoreDelete(*p);
+    taskENTER_CRITICAL();
+    for (size_t i = 0; i < LWESP_SYS_STATIC_MUTEX_COUNT; ++i) {
+        if (mutexes[i].handle == *p) {
+            mutexes[i].handle = NULL;           /* Return entry to pool */
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return 1;
+}
+
+uint8_t
+lwesp_sys_mutex_lock(lwesp_sys_mutex_t* p) {
+    return xSemaphoreTakeRecursive(*p, portMAX_DELAY) == pdPASS;
+}
+
+uint8_t
+lwesp_sys_mutex_unlock(lwesp_sys_mutex_t* p) {
+    return xSemaphoreGiveRecursive(*p) == pdPASS;
+}
+
+uint8_t
+lwesp_sys_mutex_isvalid(lwesp_sys_mutex_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+uint8_t
+lwesp_sys_mutex_invalid(lwesp_sys_mutex_t* p) {
+    *p = LWESP_SYS_MUTEX_NULL;
+    return 1;
+}
+
+uint8_t
+lwesp_sys_sem_create(lwesp_sys_sem_t* p, uint8_t cnt) {
+    *p = NULL;
+    taskENTER_CRITICAL();
+    for (size_t i = 0; i < LWESP_SYS_STATIC_SEM_COUNT; ++i) {
+        if (!sems[i].used) {
+            sems[i].used = 1;
+            sems[i].count = cnt > 0 ? 1 : 0;
+            sems[i].first = sems[i].last = NULL;
+            *p = &sems[i];
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return *p != NULL;
+}
+
+uint8_t
+lwesp_sys_sem_delete(lwesp_sys_sem_t* p) {
+    taskENTER_CRITICAL();
+    (*p)->used = 0;                             /* Return entry to pool */
+    taskEXIT_CRITICAL();
+    return 1;
+}
+
+uint32_t
+lwesp_sys_sem_wait(lwesp_sys_sem_t* p, uint32_t timeout) {
+    sem_t* s = *p;
+    sem_waiter_t w, **pw;
+    uint32_t t = xTaskGetTickCount();
+
+    taskENTER_CRITICAL();
+    if (s->count > 0) {                         /* Semaphore available, no need to wait */
+        s->count = 0;
+        taskEXIT_CRITICAL();
+        return 0;
+    }
+    w.next = NULL;
+    w.task = xTaskGetCurrentTaskHandle();
+    w.signaled = 0;
+    if (s->last != NULL) {
+        s->last->next = &w;
+    } else {
+        s->first = &w;
+    }
+    s->last = &w;
+    taskEXIT_CRITICAL();
+
+    while (1) {
+        if (ulTaskNotifyTakeIndexed(LWESP_SYS_NOTIFY_INDEX, pdTRUE, !timeout ? portMAX_DELAY : timeout) > 0) {
+            if (w.signaled) {
+                break;                          /* Semaphore given to this thread */
+            }
+            continue;                           /* Unrelated notification, wait again */
+        }
+
+        /* Timeout, remove from list unless semaphore was given meanwhile */
+        taskENTER_CRITICAL();
+        if (!w.signaled) {
+            sem_waiter_t* prev = NULL;
+            for (pw = &s->first; *pw != NULL; prev = *pw, pw = &(*pw)->next) {
+                if (*pw == &w) {
+                    *pw = w.next;
+                    if (s->last == &w) {
+                        s->last = prev;
+                    }
+                    break;
+                }
+            }
+            taskEXIT_CRITICAL();
+            return LWESP_SYS_TIMEOUT;
+        }
+        taskEXIT_CRITICAL();
+        ulTaskNotifyTakeIndexed(LWESP_SYS_NOTIFY_INDEX, pdTRUE, portMAX_DELAY); /* Notification is on its way */
+        break;
+    }
+    return xTaskGetTickCount() - t;
+}
+
+uint8_t
+lwesp_sys_sem_release(lwesp_sys_sem_t* p) {
+    sem_t* s = *p;
+    TaskHandle_t task = NULL;
+
+    taskENTER_CRITICAL();
+    if (s->first != NULL) {                     /* Give semaphore directly to first waiter */
+        sem_waiter_t* w = s->first;
+        s->first = w->next;
+        if (s->first == NULL) {
+            s->last = NULL;
+        }
+        task = w->task;
+        w->signaled = 1;
+    } else {
+        s->count = 1;
+    }
+    taskEXIT_CRITICAL();
+    if (task != NULL) {
+        xTaskNotifyGiveIndexed(task, LWESP_SYS_NOTIFY_INDEX);
+    }
+    return 1;
+}
+
+uint8_t
+lwesp_sys_sem_isvalid(lwesp_sys_sem_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+uint8_t
+lwesp_sys_sem_invalid(lwesp_sys_sem_t* p) {
+    *p = LWESP_SYS_SEM_NULL;
+    return 1;
+}
+
+uint8_t
+lwesp_sys_mbox_create(lwesp_sys_mbox_t* b, size_t size) {
+    *b = NULL;
+    if (size > LWESP_SYS_STATIC_MBOX_LEN) {
+        return 0;
+    }
+    taskENTER_CRITICAL();
+    for (size_t i = 0; i < LWESP_SYS_STATIC_MBOX_COUNT; ++i) {
+        if (mboxes[i].handle == NULL) {
+            *b = mboxes[i].handle = xQueueCreateStatic(size, sizeof(void*), mboxes[i].storage, &mboxes[i].buff);
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return *b != NULL;
+}
+
+uint8_t
+lwesp_sys_mbox_delete(lwesp_sys_mbox_t* b) {
+    if (uxQueueMessagesWaiting(*b)) {
+        return 0;
+    }
+    vQueueDelete(*b);
+    taskENTER_CRITICAL();
+    for (size_t i = 0; i < LWESP_SYS_STATIC_MBOX_COUNT; ++i) {
+        if (mboxes[i].handle == *b) {
+            mboxes[i].handle = NULL;            /* Return entry to pool */
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return 1;
+}
+
+uint32_t
+lwesp_sys_mbox_put(lwesp_sys_mbox_t* b, void* m) {
+    uint32_t t = xTaskGetTickCount();
+
+    xQueueSend(*b, &m, portMAX_DELAY);
+    return xTaskGetTickCount() - t;
+}
+
+uint32_t
+lwesp_sys_mbox_get(lwesp_sys_mbox_t* b, void** m, uint32_t timeout) {
+    uint32_t t = xTaskGetTickCount();
+
+    if (xQueueReceive(*b, m, !timeout ? portMAX_DELAY : timeout)) {
+        return xTaskGetTickCount() - t;
+    }
+    return LWESP_SYS_TIMEOUT;
+}
+
+uint8_t
+lwesp_sys_mbox_putnow(lwesp_sys_mbox_t* b, void* m) {
+    return xQueueSend(*b, &m, 0) == pdPASS;
+}
+
+uint8_t
+lwesp_sys_mbox_getnow(lwesp_sys_mbox_t* b, void** m) {
+    return xQueueReceive(*b, m, 0) == pdPASS;
+}
+
+uint8_t
+lwesp_sys_mbox_isvalid(lwesp_sys_mbox_t* b) {
+    return b != NULL && *b != NULL;
+}
+
+uint8_t
+lwesp_sys_mbox_invalid(lwesp_sys_mbox_t* b) {
+    *b = LWESP_SYS_MBOX_NULL;
+    return 1;
+}
+
+uint8_t
+lwesp_sys_thread_create(lwesp_sys_thread_t* t, const char* name, lwesp_sys_thread_fn thread_func, void* const arg, size_t stack_size, lwesp_sys_thread_prio_t prio) {
+    TaskHandle_t h = NULL;
+
+    if (stack_size == 0) {
+        stack_size = LWESP_SYS_THREAD_SS;
+    }
+    if (stack_size > LWESP_SYS_THREAD_SS) {
+        return 0;
+    }
+    vTaskSuspendAll();
+    for (size_t i = 0; i < LWESP_SYS_STATIC_THREAD_COUNT; ++i) {
+        if (threads[i].handle == NULL) {
+            h = threads[i].handle = xTaskCreateStatic(thread_func, name, stack_size, arg, prio, threads[i].stack, &threads[i].tcb);
+            break;
+        }
+    }
+    xTaskResumeAll();
+    if (t != NULL) {
+        *t = h;
+    }
+    return h != NULL;
+}
+
+uint8_t
+lwesp_sys_thread_terminate(lwesp_sys_thread_t* t) {
+    TaskHandle_t h = t != NULL ? *t : xTaskGetCurrentTaskHandle();
+
+    /*
+     * Entry of other thread returns to pool immediately.
+     * Thread deleting itself keeps its entry, as its stack is still in use
+     */
+    if (h != xTaskGetCurrentTaskHandle()) {
+        vTaskSuspendAll();
+        for (size_t i = 0; i < LWESP_SYS_STATIC_THREAD_COUNT; ++i) {
+            if (threads[i].handle == h) {
+                vTaskDelete(h);
+                threads[i].handle = NULL;
+                break;
+            }
+        }
+        xTaskResumeAll();
+    } else {
+        vTaskDelete(NULL);
+    }
+    return 1;
+}
+
+uint8_t
+lwesp_sys_thread_yield(void) {
+    taskYIELD();
+    return 1;
+}
+
+#if LWESP_CFG_SYS_THREAD_NOTIFY
+
+uint8_t
+lwesp_sys_thread_notify_get(lwesp_sys_thread_notify_t* n) {
+    *n = xTaskGetCurrentTaskHandle();
+    return *n != NULL;
+}
+
+uint32_t
+lwesp_sys_thread_notify_wait(uint32_t timeout) {
+    uint32_t t = xTaskGetTickCount();
+    return ulTaskNotifyTakeIndexed(LWESP_SYS_NOTIFY_INDEX, pdTRUE, !timeout ? portMAX_DELAY : timeout) > 0 ? (xTaskGetTickCount() - t) : LWESP_SYS_TIMEOUT;
+}
+
+uint8_t
+lwesp_sys_thread_notify(lwesp_sys_thread_notify_t* n) {
+    xTaskNotifyGiveIndexed(*n, LWESP_SYS_NOTIFY_INDEX);
+    return 1;
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY */
+
+#if LWESP_CFG_SYS_THREAD_STACK_INFO
+
+uint8_t
+lwesp_sys_thread_stack_free(lwesp_sys_thread_t* t, size_t* free_ss) {
+    *free_ss = (size_t)uxTaskGetStackHighWaterMark(*t); /* Requires INCLUDE_uxTaskGetStackHighWaterMark */
+    return 1;
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_STACK_INFO */
+
+#endif /* !__DOXYGEN__ */
@@ -0,0 +1,669 @@
+/**
+ * \file            lwesp_sys_posix.c
+ * \brief           System dependant functions for POSIX
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwESP - Lightweight ESP-AT parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         $_version_$
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include "system/lwesp_sys.h"
+#include "lwesp/lwesp_utils.h"
+
+#if !__DOXYGEN__
+
+/* Number of lock-free attempts before mailbox operation blocks */
+#ifndef LWESP_SYS_MBOX_SPIN_COUNT
+#define LWESP_SYS_MBOX_SPIN_COUNT           64
+#endif /* LWESP_SYS_MBOX_SPIN_COUNT */
+
+/**
+ * \brief           Binary semaphore, built on mutex and condition variable
+ */
+typedef struct lwesp_sys_posix_sem {
+    pthread_mutex_t mutex;                      /*!< Mutex to protect count */
+    pthread_cond_t cond;                        /*!< Condition signaled on release */
+    uint8_t count;                              /*!< Current semaphore count */
+} posix_sem_t;
+
+/**
+ * \brief           Mailbox cell
+ */
+typedef struct {
+    size_t seq;                                 /*!< Sequence number, tells if cell is free or full */
+    void* data;                                 /*!< Entry */
+} posix_mbox_cell_t;
+
+/**
+ * \brief           Bounded lock-free MPMC message queue
+ *
+ * Entries are exchanged through cells with sequence numbers,
+ * mutex and conditions are used only when thread has to block.
+ */
+typedef struct lwesp_sys_posix_mbox {
+    size_t enq_pos;                             /*!< Next write position */
+    uint8_t pad0[64 - sizeof(size_t)];          /*!< Keep positions in separate cache lines */
+    size_t deq_pos;                             /*!< Next read position */
+    uint8_t pad1[64 - sizeof(size_t)];
+    size_t mask;                                /*!< Number of cells minus `1`, power of 2 */
+    unsigned get_waiters;                       /*!< Number of threads blocked in get */
+    unsigned put_waiters;                       /*!< Number of threads blocked in put */
+    pthread_mutex_t mutex;                      /*!< Mutex for blocking wait */
+    pthread_cond_t not_empty;                   /*!< Condition signaled when entry is written */
+    pthread_cond_t not_full;                    /*!< Condition signaled when entry is read */
+    posix_mbox_cell_t cells[1];
+} posix_mbox_t;
+
+/**
+ * \brief           Thread notification object
+ */
+typedef struct lwesp_sys_posix_notify {
+    posix_sem_t sem;                            /*!< Semaphore used to wake up thread */
+} posix_notify_t;
+
+/**
+ * \brief           Thread start arguments
+ */
+typedef struct {
+    lwesp_sys_thread_fn fn;
+    void* arg;
+} posix_thread_arg_t;
+
+static struct timespec sys_start_time;
+static pthread_mutex_t sys_mutex_obj;
+static lwesp_sys_mutex_t sys_mutex;             /* Mutex ID for main protection */
+static pthread_condattr_t cond_attr;            /* Condition attributes, monotonic clock */
+#if LWESP_CFG_SYS_THREAD_NOTIFY
+static pthread_key_t notify_key;                /* Thread local key for notification object */
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY */
+
+/**
+ * \brief           Get current kernel time in units of milliseconds
+ */
+static uint32_t
+osKernelSysTick(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((now.tv_sec - sys_start_time.tv_sec) * 1000
+                      + (now.tv_nsec - sys_start_time.tv_nsec) / 1000000);
+}
+
+/**
+ * \brief           Calculate absolute monotonic time for timed wait
+ * \param[out]      ts: Absolute time output
+ * \param[in]       timeout: Relative timeout in units of milliseconds
+ */
+static void
+abs_time(struct timespec* ts, uint32_t timeout) {
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += timeout / 1000;
+    ts->tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ++ts->tv_sec;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+/**
+ * \brief           Wait for condition with optional timeout
+ * \param[in]       c: Condition variable
+ * \param[in]       m: Locked mutex
+ * \param[in]       ts: Absolute timeout or `NULL` to wait forever
+ * \return          `1` on wake-up, `0` on timeout
+ */
+static uint8_t
+cond_wait(pthread_cond_t* c, pthread_mutex_t* m, const struct timespec* ts) {
+    if (ts == NULL) {
+        pthread_cond_wait(c, m);
+        return 1;
+    }
+    return pthread_cond_timedwait(c, m, ts) != ETIMEDOUT;
+}
+
+static void
+sem_init_obj(posix_sem_t* s, uint8_t cnt) {
+    pthread_mutex_init(&s->mutex, NULL);
+    pthread_cond_init(&s->cond, &cond_attr);
+    s->count = cnt ? 1 : 0;
+}
+
+static uint32_t
+sem_wait_obj(posix_sem_t* s, uint32_t timeout) {
+    struct timespec ts;
+    uint32_t tick = osKernelSysTick();
+
+    if (timeout > 0) {
+        abs_time(&ts, timeout);
+    }
+    pthread_mutex_lock(&s->mutex);
+    while (s->count == 0) {
+        if (!cond_wait(&s->cond, &s->mutex, timeout > 0 ? &ts : NULL) && s->count == 0) {
+            pthread_mutex_unlock(&s->mutex);
+            return LWESP_SYS_TIMEOUT;
+        }
+    }
+    s->count = 0;
+    pthread_mutex_unlock(&s->mutex);
+    return osKernelSysTick() - tick;
+}
+
+static void
+sem_release_obj(posix_sem_t* s) {
+    pthread_mutex_lock(&s->mutex);
+    s->count = 1;
+    pthread_cond_signal(&s->cond);
+    pthread_mutex_unlock(&s->mutex);
+}
+
+#if LWESP_CFG_SYS_THREAD_NOTIFY
+/**
+ * \brief           Free notification object on thread exit
+ */
+static void
+notify_destroy(void* arg) {
+    posix_notify_t* n = arg;
+
+    pthread_cond_destroy(&n->sem.cond);
+    pthread_mutex_destroy(&n->sem.mutex);
+    free(n);
+}
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY */
+
+/**
+ * \brief           Thread entry wrapper, converts return type
+ */
+static void*
+thread_entry(void* arg) {
+    posix_thread_arg_t a = *(posix_thread_arg_t*)arg;
+
+    free(arg);
+    a.fn(a.arg);
+    return NULL;
+}
+
+uint8_t
+lwesp_sys_init(void) {
+    pthread_mutexattr_t attr;
+
+    clock_gettime(CLOCK_MONOTONIC, &sys_start_time);
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&sys_mutex_obj, &attr);
+    pthread_mutexattr_destroy(&attr);
+    sys_mutex = &sys_mutex_obj;
+#if LWESP_CFG_SYS_THREAD_NOTIFY
+    pthread_key_create(&notify_key, notify_destroy);
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY */
+    return 1;
+}
+
+uint32_t
+lwesp_sys_now(void) {
+    return osKernelSysTick();
+}
+
+#if LWESP_CFG_SYS_NOW_US
+
+uint32_t
+lwesp_sys_now_us(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((now.tv_sec - sys_start_time.tv_sec) * 1000000
+                      + (now.tv_nsec - sys_start_time.tv_nsec) / 1000);
+}
+
+#endif /* LWESP_CFG_SYS_NOW_US */
+
+#if LWESP_CFG_OS
+uint8_t
+lwesp_sys_protect(void) {
+    lwesp_sys_mutex_lock(&sys_mutex);
+    return 1;
+}
+
+uint8_t
+lwesp_sys_unprotect(void) {
+    lwesp_sys_mutex_unlock(&sys_mutex);
+    return 1;
+}
+
+uint8_t
+lwesp_sys_mutex_create(lwesp_sys_mutex_t* p) {
+    pthread_mutexattr_t attr;
+
+    *p = malloc(sizeof(**p));
+    if (*p != NULL) {
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+        if (pthread_mutex_init(*p, &attr) != 0) {
+            free(*p);
+            *p = NULL;
+        }
+        pthread_mutexattr_destroy(&attr);
+    }
+    return *p != NULL;
+}
+
+uint8_t
+lwesp_sys_mutex_delete(lwesp_sys_mutex_t* p) {
+    pthread_mutex_destroy(*p);
+    free(*p);
+    return 1;
+}
+
+uint8_t
+lwesp_sys_mutex_lock(lwesp_sys_mutex_t* p) {
+    return pthread_mutex_lock(*p) == 0;
+}
+
+uint8_t
+lwesp_sys_mutex_unlock(lwesp_sys_mutex_t* p) {
+    return pthread_mutex_unlock(*p) == 0;
+}
+
+uint8_t
+lwesp_sys_mutex_isvalid(lwesp_sys_mutex_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+uint8_t
+lwesp_sys_mutex_invalid(lwesp_sys_mutex_t* p) {
+    *p = LWESP_SYS_MUTEX_NULL;
+    return 1;
+}
+
+uint8_t
+lwesp_sys_sem_create(lwesp_sys_sem_t* p, uint8_t cnt) {
+    *p = malloc(sizeof(**p));
+    if (*p != NULL) {
+        sem_init_obj(*p, cnt);
+    }
+    return *p != NULL;
+}
+
+uint8_t
+lwesp_sys_sem_delete(lwesp_sys_sem_t* p) {
+    pthread_cond_destroy(&(*p)->cond);
+    pthread_mutex_destroy(&(*p)->mutex);
+    free(*p);
+    return 1;
+}
+
+uint32_t
+lwesp_sys_sem_wait(lwesp_sys_sem_t* p, uint32_t timeout) {
+    return sem_wait_obj(*p, timeout);
+}
+
+uint8_t
+lwesp_sys_sem_release(lwesp_sys_sem_t* p) {
+    sem_release_obj(*p);
+    return 1;
+}
+
+uint8_t
+lwesp_sys_sem_isvalid(lwesp_sys_sem_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+uint8_t
+lwesp_sys_sem_invalid(lwesp_sys_sem_t* p) {
+    *p = LWESP_SYS_SEM_NULL;
+    return 1;
+}
+
+uint8_t
+lwesp_sys_mbox_create(lwesp_sys_mbox_t* b, size_t size) {
+    posix_mbox_t* mbox;
+    size_t cnt = 2;
+
+    *b = NULL;
+    if (size == 0) {
+        return 0;
+    }
+    while (cnt < size) {                        /* Number of cells must be power of 2 */
+        cnt <<= 1;
+    }
+    mbox = malloc(sizeof(*mbox) + (cnt - 1) * sizeof(mbox->cells[0]));
+    if (mbox != NULL) {
+        memset(mbox, 0x00, sizeof(*mbox));
+        mbox->mask = cnt - 1;
+        for (size_t i = 0; i < cnt; ++i) {
+            mbox->cells[i].seq = i;
+        }
+        pthread_mutex_init(&mbox->mutex, NULL);
+        pthread_cond_init(&mbox->not_empty, &cond_attr);
+        pthread_cond_init(&mbox->not_full, &cond_attr);
+        *b = mbox;
+    }
+    return *b != NULL;
+}
+
+uint8_t
+lwesp_sys_mbox_delete(lwesp_sys_mbox_t* b) {
+    posix_mbox_t* mbox = *b;
+
+    if (__atomic_load_n(&mbox->enq_pos, __ATOMIC_ACQUIRE) != __atomic_load_n(&mbox->deq_pos, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+    pthread_cond_destroy(&mbox->not_full);
+    pthread_cond_destroy(&mbox->not_empty);
+    pthread_mutex_destroy(&mbox->mutex);
+    free(mbox);
+    return 1;
+}
+
+/**
+ * \brief           Wake up one thread blocked on condition, if any
+ * \param[in]       mbox: Message box
+ * \param[in]       waiters: Number of waiters for condition
+ * \param[in]       cond: Condition to signal
+ */
+static void
+mbox_wake(posix_mbox_t* mbox, unsigned* waiters, pthread_cond_t* cond) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);    /* Pairs with fence in blocking path */
+    if (__atomic_load_n(waiters, __ATOMIC_RELAXED) > 0) {
+        pthread_mutex_lock(&mbox->mutex);
+        pthread_cond_signal(cond);
+        pthread_mutex_unlock(&mbox->mutex);
+    }
+}
+
+/**
+ * \brief           Try to write entry to message box without blocking
+ * \param[in]       mbox: Message box
+ * \param[in]       m: Entry to write
+ * \return          `1` on success, `0` if full
+ */
+static uint8_t
+mbox_try_put(posix_mbox_t* mbox, void* m) {
+    posix_mbox_cell_t* cell;
+    size_t pos = __atomic_load_n(&mbox->enq_pos, __ATOMIC_RELAXED), seq;
+
+    while (1) {
+        cell = &mbox->cells[pos & mbox->mask];
+        seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        if (seq == pos) {                       /* Cell is free, try to claim it */
+            if (__atomic_compare_exchange_n(&mbox->enq_pos, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if ((intptr_t)(seq - pos) < 0) { /* Cell still holds entry from previous round */
+            return 0;
+        } else {
+            pos = __atomic_load_n(&mbox->enq_pos, __ATOMIC_RELAXED);
+        }
+    }
+    cell->data = m;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * \brief           Try to read entry from message box without blocking
+ * \param[in]       mbox: Message box
+ * \param[out]      m: Pointer to output entry
+ * \return          `1` on success, `0` if empty
+ */
+static uint8_t
+mbox_try_get(posix_mbox_t* mbox, void** m) {
+    posix_mbox_cell_t* cell;
+    size_t pos = __atomic_load_n(&mbox->deq_pos, __ATOMIC_RELAXED), seq;
+
+    while (1) {
+        cell = &mbox->cells[pos & mbox->mask];
+        seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        if (seq == pos + 1) {                   /* Cell is full, try to claim it */
+            if (__atomic_compare_exchange_n(&mbox->deq_pos, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if ((intptr_t)(seq - (pos + 1)) < 0) {   /* Cell not written yet */
+            return 0;
+        } else {
+            pos = __atomic_load_n(&mbox->deq_pos, __ATOMIC_RELAXED);
+        }
+    }
+    *m = cell->data;
+    __atomic_store_n(&cell->seq, pos + mbox->mask + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+uint32_t
+lwesp_sys_mbox_put(lwesp_sys_mbox_t* b, void* m) {
+    posix_mbox_t* mbox = *b;
+    uint32_t time = osKernelSysTick();          /* Get start time */
+
+    for (size_t i = 0; i < LWESP_SYS_MBOX_SPIN_COUNT; ++i) {
+        if (mbox_try_put(mbox, m)) {
+            mbox_wake(mbox, &mbox->get_waiters, &mbox->not_empty);
+            return osKernelSysTick() - time;
+        }
+    }
+
+    /* Slow path, block until entry is read by other thread */
+    pthread_mutex_lock(&mbox->mutex);
+    __atomic_add_fetch(&mbox->put_waiters, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    while (!mbox_try_put(mbox, m)) {
+        pthread_cond_wait(&mbox->not_full, &mbox->mutex);
+    }
+    __atomic_sub_fetch(&mbox->put_waiters, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&mbox->mutex);
+    mbox_wake(mbox, &mbox->get_waiters, &mbox->not_empty);
+    return osKernelSysTick() - time;
+}
+
+uint32_t
+lwesp_sys_mbox_get(lwesp_sys_mbox_t* b, void** m, uint32_t timeout) {
+    posix_mbox_t* mbox = *b;
+    struct timespec ts;
+    uint32_t time = osKernelSysTick();
+    uint8_t res;
+
+    for (size_t i = 0; i < LWESP_SYS_MBOX_SPIN_COUNT; ++i) {
+        if (mbox_try_get(mbox, m)) {
+            mbox_wake(mbox, &mbox->put_waiters, &mbox->not_full);
+            return osKernelSysTick() - time;
+        }
+    }
+
+    /* Slow path, block until entry is written or timeout */
+    if (timeout > 0) {
+        abs_time(&ts, timeout);
+    }
+    pthread_mutex_lock(&mbox->mutex);
+    __atomic_add_fetch(&mbox->get_waiters, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    while (!(res = mbox_try_get(mbox, m))) {
+        if (!cond_wait(&mbox->not_empty, &mbox->mutex, timeout > 0 ? &ts : NULL)) {
+            res = mbox_try_get(mbox, m);
+            break;
+        }
+    }
+    __atomic_sub_fetch(&mbox->get_waiters, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&mbox->mutex);
+    if (!res) {
+        return LWESP_SYS_TIMEOUT;
+    }
+    mbox_wake(mbox, &mbox->put_waiters, &mbox->not_full);
+    return osKernelSysTick() - time;
+}
+
+uint8_t
+lwesp_sys_mbox_putnow(lwesp_sys_mbox_t* b, void* m) {
+    posix_mbox_t* mbox = *b;
+
+    if (mbox_try_put(mbox, m)) {
+        mbox_wake(mbox, &mbox->get_waiters, &mbox->not_empty);
+        return 1;
+    }
+    return 0;
+}
+
+uint8_t
+lwesp_sys_mbox_getnow(lwesp_sys_mbox_t* b, void** m) {
+    posix_mbox_t* mbox = *b;
+
+    if (mbox_try_get(mbox, m)) {
+        mbox_wake(mbox, &mbox->put_waiters, &mbox->not_full);
+        return 1;
+    }
+    return 0;
+}
+
+uint8_t
+lwesp_sys_mbox_isvalid(lwesp_sys_mbox_t* b) {
+    return b != NULL && *b != NULL;
+}
+
+uint8_t
+lwesp_sys_mbox_invalid(lwesp_sys_mbox_t* b) {
+    *b = LWESP_SYS_MBOX_NULL;
+    return 1;
+}
+
+uint8_t
+lwesp_sys_thread_create(lwesp_sys_thread_t* t, const char* name, lwesp_sys_thread_fn thread_func, void* const arg, size_t stack_size, lwesp_sys_thread_prio_t prio) {
+    posix_thread_arg_t* a;
+    pthread_attr_t attr;
+    pthread_t h;
+    int res;
+
+    LWESP_UNUSED(prio);
+    if ((a = malloc(sizeof(*a))) == NULL) {
+        return 0;
+    }
+    a->fn = thread_func;
+    a->arg = arg;
+
+    pthread_attr_init(&attr);
+    if (stack_size >= (size_t)PTHREAD_STACK_MIN) { /* Smaller values are RTOS words, use default size */
+        pthread_attr_setstacksize(&attr, stack_size);
+    }
+    if (t == NULL) {
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    }
+    res = pthread_create(&h, &attr, thread_entry, a);
+    pthread_attr_destroy(&attr);
+    if (res != 0) {
+        free(a);
+        return 0;
+    }
+#ifdef __linux__
+    if (name != NULL) {
+        char n[16];
+
+        strncpy(n, name, sizeof(n) - 1);        /* Linux limits names to 15 characters */
+        n[sizeof(n) - 1] = '\0';
+        pthread_setname_np(h, n);
+    }
+#endif /* __linux__ */
+    LWESP_CFG_SYS_THREAD_CREATE_HOOK(&h, name, prio);
+    if (t != NULL) {
+        *t = h;
+    }
+    return 1;
+}
+
+uint8_t
+lwesp_sys_thread_terminate(lwesp_sys_thread_t* t) {
+    if (t == NULL) {                            /* Shall we terminate ourself? */
+        pthread_exit(NULL);
+    }
+    pthread_cancel(*t);
+    pthread_join(*t, NULL);
+    return 1;
+}
+
+uint8_t
+lwesp_sys_thread_yield(void) {
+    sched_yield();
+    return 1;
+}
+
+#if LWESP_CFG_SYS_THREAD_NOTIFY
+
+uint8_t
+lwesp_sys_thread_notify_get(lwesp_sys_thread_notify_t* n) {
+    posix_notify_t* h = pthread_getspecific(notify_key);
+
+    if (h == NULL) {                            /* Create object on first use in this thread */
+        h = malloc(sizeof(*h));
+        if (h != NULL) {
+            sem_init_obj(&h->sem, 0);
+            pthread_setspecific(notify_key, h);
+        }
+    }
+    *n = h;
+    return h != NULL;
+}
+
+uint32_t
+lwesp_sys_thread_notify_wait(uint32_t timeout) {
+    posix_notify_t* h = pthread_getspecific(notify_key);
+
+    if (h == NULL) {
+        return LWESP_SYS_TIMEOUT;
+    }
+    return sem_wait_obj(&h->sem, timeout);
+}
+
+uint8_t
+lwesp_sys_thread_notify(lwesp_sys_thread_notify_t* n) {
+    sem_release_obj(&(*n)->sem);
+    return 1;
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY */
+
+#if LWESP_CFG_SYS_THREAD_STACK_INFO
+
+uint8_t
+lwesp_sys_thread_stack_free(lwesp_sys_thread_t* t, size_t* free_ss) {
+    /* Stack usage is not tracked by pthread, hosted stacks are not size-critical */
+    (void)t;
+    *free_ss = 0;
+    return 0;
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_STACK_INFO */
+
+#endif /* LWESP_CFG_OS */
+#endif /* !__DOXYGEN__ */
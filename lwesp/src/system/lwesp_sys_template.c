@@ -57,6 +57,25 @@ lwesp_sys_now(void) {
     return osKernelSysTick();
 }
 
+#if LWESP_CFG_SYS_NOW_US || __DOXYGEN__
+
+/**
+ * \brief           Get current time in units of microseconds
+ *
+ * Used as time base for statistics counters and trace timestamps.
+ * Value must increase monotonically and wrap around at `32-bit` boundary.
+ * Use hardware counter, such as `DWT->CYCCNT` on ARM Cortex-M or `QueryPerformanceCounter` on Windows
+ *
+ * \note            This function is required only when \ref LWESP_CFG_SYS_NOW_US is enabled
+ * \return          Current time in units of microseconds
+ */
+uint32_t
+lwesp_sys_now_us(void) {
+    return osKernelSysTick() * 1000U;
+}
+
+#endif /* LWESP_CFG_SYS_NOW_US || __DOXYGEN__ */
+
 /**
  * \brief           Protect middleware core
  *
@@ -386,3 +405,57 @@ lwesp_sys_thread_yield(void) {
     osThreadYield();
     return 1;
 }
+
+#if LWESP_CFG_SYS_THREAD_NOTIFY || __DOXYGEN__
+
+/**
+ * \brief           Get notification handle of current thread
+ * \param[out]      n: Pointer to save notification handle to
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwesp_sys_thread_notify_get(lwesp_sys_thread_notify_t* n) {
+    *n = osThreadGetId();
+    return *n != NULL;
+}
+
+/**
+ * \brief           Wait for notification of current thread
+ * \param[in]       timeout: Timeout to wait in units of milliseconds. Set to `0` to wait forever
+ * \return          Number of milliseconds waited for notification or \ref LWESP_SYS_TIMEOUT if timeout occurred
+ */
+uint32_t
+lwesp_sys_thread_notify_wait(uint32_t timeout) {
+    uint32_t tick = osKernelSysTick();
+    osEvent evt = osSignalWait(LWESP_SYS_THREAD_NOTIFY_FLAG, timeout == 0 ? osWaitForever : timeout);
+    return evt.status == osEventSignal ? (osKernelSysTick() - tick) : LWESP_SYS_TIMEOUT;
+}
+
+/**
+ * \brief           Notify thread, waiting in \ref lwesp_sys_thread_notify_wait
+ * \param[in]       n: Notification handle of thread to notify
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwesp_sys_thread_notify(lwesp_sys_thread_notify_t* n) {
+    return osSignalSet(*n, LWESP_SYS_THREAD_NOTIFY_FLAG) != (int32_t)0x80000000;
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY || __DOXYGEN__ */
+
+#if LWESP_CFG_SYS_THREAD_STACK_INFO || __DOXYGEN__
+
+/**
+ * \brief           Get lowest free stack of thread since it was started (high-water mark)
+ * \param[in]       t: Pointer to thread handle
+ * \param[out]      free_ss: Pointer to output variable for free stack,
+ *                      in the same units as stack size in \ref lwesp_sys_thread_create
+ * \return          `1` on success, `0` when port cannot report stack usage
+ */
+uint8_t
+lwesp_sys_thread_stack_free(lwesp_sys_thread_t* t, size_t* free_ss) {
+    *free_ss = (size_t)osThreadGetStackSpace(*t);
+    return 1;
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_STACK_INFO || __DOXYGEN__ */
@@ -38,44 +38,123 @@
 
 #if !__DOXYGEN__
 
+/* Number of lock-free attempts before mailbox operation blocks */
+#ifndef LWESP_SYS_MBOX_SPIN_COUNT
+#define LWESP_SYS_MBOX_SPIN_COUNT           64
+#endif /* LWESP_SYS_MBOX_SPIN_COUNT */
+
+/**
+ * \brief           Mailbox cell
+ */
+typedef struct {
+    volatile LONG seq;                          /*!< Sequence number, tells if cell is free or full */
+    void* data;                                 /*!< Entry */
+} win32_mbox_cell_t;
+
 /**
- * \brief           Custom message queue implementation for WIN32
+ * \brief           Bounded lock-free MPMC message queue implementation for WIN32
+ *
+ * Entries are exchanged through cells with sequence numbers,
+ * critical section and conditions are used only when thread has to block.
  */
 typedef struct {
-    lwesp_sys_sem_t sem_not_empty;              /*!< Semaphore indicates not empty */
-    lwesp_sys_sem_t sem_not_full;               /*!< Semaphore indicates not full */
-    lwesp_sys_sem_t sem;                        /*!< Semaphore to lock access */
-    size_t in, out, size;
-    void* entries[1];
+    volatile LONG enq_pos;                      /*!< Next write position */
+    uint8_t pad0[64 - sizeof(LONG)];            /*!< Keep positions in separate cache lines */
+    volatile LONG deq_pos;                      /*!< Next read position */
+    uint8_t pad1[64 - sizeof(LONG)];
+    LONG mask;                                  /*!< Number of cells minus `1`, power of 2 */
+    volatile LONG get_waiters;                  /*!< Number of threads blocked in get */
+    volatile LONG put_waiters;                  /*!< Number of threads blocked in put */
+    CRITICAL_SECTION cs;                        /*!< Lock for blocking wait */
+    CONDITION_VARIABLE not_empty;               /*!< Condition signaled when entry is written */
+    CONDITION_VARIABLE not_full;                /*!< Condition signaled when entry is read */
+    win32_mbox_cell_t cells[1];
 } win32_mbox_t;
 
 static LARGE_INTEGER freq, sys_start_time;
 static lwesp_sys_mutex_t sys_mutex;             /* Mutex ID for main protection */
+#if LWESP_CFG_SYS_THREAD_NOTIFY
+static DWORD notify_tls = TLS_OUT_OF_INDEXES;   /* Thread local slot for notification event */
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY */
+
+/**
+ * \brief           Wake up one thread blocked on condition, if any
+ * \param[in]       m: Message box handle
+ * \param[in]       waiters: Number of waiters for condition
+ * \param[in]       cond: Condition to signal
+ */
+static void
+mbox_wake(win32_mbox_t* m, volatile LONG* waiters, CONDITION_VARIABLE* cond) {
+    MemoryBarrier();                            /* Pairs with barrier in blocking path */
+    if (*waiters > 0) {
+        EnterCriticalSection(&m->cs);
+        WakeConditionVariable(cond);
+        LeaveCriticalSection(&m->cs);
+    }
+}
 
 /**
- * \brief           Check if message box is full
+ * \brief           Try to write entry to message box without blocking
  * \param[in]       m: Message box handle
- * \return          1 if full, 0 otherwise
+ * \param[in]       e: Entry to write
+ * \return          1 on success, 0 if full
  */
 static uint8_t
-mbox_is_full(win32_mbox_t* m) {
-    size_t size = 0;
-    if (m->in > m->out) {
-        size = (m->in - m->out);
-    } else if (m->out > m->in) {
-        size = m->size - m->out + m->in;
+mbox_try_put(win32_mbox_t* m, void* e) {
+    win32_mbox_cell_t* cell;
+    LONG pos = m->enq_pos, seq, diff;
+
+    while (1) {
+        cell = &m->cells[pos & m->mask];
+        seq = cell->seq;
+        diff = (LONG)((ULONG)seq - (ULONG)pos);
+        if (diff == 0) {                        /* Cell is free, try to claim it */
+            LONG prev = InterlockedCompareExchange(&m->enq_pos, (LONG)((ULONG)pos + 1), pos);
+            if (prev == pos) {
+                break;
+            }
+            pos = prev;
+        } else if (diff < 0) {                  /* Cell still holds entry from previous round */
+            return 0;
+        } else {
+            pos = m->enq_pos;
+        }
     }
-    return size == m->size - 1;
+    cell->data = e;
+    InterlockedExchange(&cell->seq, (LONG)((ULONG)pos + 1));
+    return 1;
 }
 
 /**
- * \brief           Check if message box is empty
+ * \brief           Try to read entry from message box without blocking
  * \param[in]       m: Message box handle
- * \return          1 if empty, 0 otherwise
+ * \param[out]      e: Pointer to output entry
+ * \return          1 on success, 0 if empty
  */
 static uint8_t
-mbox_is_empty(win32_mbox_t* m) {
-    return m->in == m->out;
+mbox_try_get(win32_mbox_t* m, void** e) {
+    win32_mbox_cell_t* cell;
+    LONG pos = m->deq_pos, seq, diff;
+
+    while (1) {
+        cell = &m->cells[pos & m->mask];
+        seq = cell->seq;
+        diff = (LONG)((ULONG)seq - ((ULONG)pos + 1));
+        if (diff == 0) {                        /* Cell is full, try to claim it */
+            LONG prev = InterlockedCompareExchange(&m->deq_pos, (LONG)((ULONG)pos + 1), pos);
+            if (prev == pos) {
+                break;
+            }
+            pos = prev;
+        } else if (diff < 0) {                  /* Cell not written yet */
+            return 0;
+        } else {
+            pos = m->deq_pos;
+        }
+    }
+    *e = cell->data;
+    InterlockedExchange(&cell->seq, (LONG)((ULONG)pos + (ULONG)m->mask + 1));
+    return 1;
 }
 
 /**
@@ -98,6 +177,11 @@ lwesp_sys_init(void) {
     QueryPerformanceCounter(&sys_start_time);
 
     lwesp_sys_mutex_create(&sys_mutex);
+#if LWESP_CFG_SYS_THREAD_NOTIFY
+    if (notify_tls == TLS_OUT_OF_INDEXES) {
+        notify_tls = TlsAlloc();
+    }
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY */
     return 1;
 }
 
@@ -106,6 +190,18 @@ lwesp_sys_now(void) {
     return osKernelSysTick();
 }
 
+#if LWESP_CFG_SYS_NOW_US
+
+uint32_t
+lwesp_sys_now_us(void) {
+    LARGE_INTEGER now;
+
+    QueryPerformanceCounter(&now);
+    return (uint32_t)(((now.QuadPart - sys_start_time.QuadPart) * 1000000) / freq.QuadPart);
+}
+
+#endif /* LWESP_CFG_SYS_NOW_US */
+
 #if LWESP_CFG_OS
 uint8_t
 lwesp_sys_protect(void) {
@@ -206,16 +302,23 @@ lwesp_sys_sem_invalid(lwesp_sys_sem_t* p) {
 uint8_t
 lwesp_sys_mbox_create(lwesp_sys_mbox_t* b, size_t size) {
     win32_mbox_t* mbox;
+    size_t cnt = 2;
 
     *b = 0;
 
-    mbox = malloc(sizeof(*mbox) + size * sizeof(void*));
+    while (cnt < size) {                        /* Number of cells must be power of 2 */
+        cnt <<= 1;
+    }
+    mbox = malloc(sizeof(*mbox) + (cnt - 1) * sizeof(mbox->cells[0]));
     if (mbox != NULL) {
         memset(mbox, 0x00, sizeof(*mbox));
-        mbox->size = size + 1;                  /* Set it to 1 more as cyclic buffer has only one less than size */
-        lwesp_sys_sem_create(&mbox->sem, 1);
-        lwesp_sys_sem_create(&mbox->sem_not_empty, 0);
-        lwesp_sys_sem_create(&mbox->sem_not_full, 0);
+        mbox->mask = (LONG)(cnt - 1);
+        for (size_t i = 0; i < cnt; ++i) {
+            mbox->cells[i].seq = (LONG)i;
+        }
+        InitializeCriticalSection(&mbox->cs);
+        InitializeConditionVariable(&mbox->not_empty);
+        InitializeConditionVariable(&mbox->not_full);
         *b = mbox;
     }
     return *b != NULL;
@@ -224,9 +327,7 @@ lwesp_sys_mbox_create(lwesp_sys_mbox_t* b, size_t size) {
 uint8_t
 lwesp_sys_mbox_delete(lwesp_sys_mbox_t* b) {
     win32_mbox_t* mbox = *b;
-    lwesp_sys_sem_delete(&mbox->sem);
-    lwesp_sys_sem_delete(&mbox->sem_not_full);
-    lwesp_sys_sem_delete(&mbox->sem_not_empty);
+    DeleteCriticalSection(&mbox->cs);
     free(mbox);
     return 1;
 }
@@ -236,52 +337,56 @@ lwesp_sys_mbox_put(lwesp_sys_mbox_t* b, void* m) {
     win32_mbox_t* mbox = *b;
     uint32_t time = osKernelSysTick();          /* Get start time */
 
-    lwesp_sys_sem_wait(&mbox->sem, 0);          /* Wait for access */
-
-    /*
-     * Since function is blocking until ready to write something to queue,
-     * wait and release the semaphores to allow other threads
-     * to process the queue before we can write new value.
-     */
-    while (mbox_is_full(mbox)) {
-        lwesp_sys_sem_release(&mbox->sem);      /* Release semaphore */
-        lwesp_sys_sem_wait(&mbox->sem_not_full, 0); /* Wait for semaphore indicating not full */
-        lwesp_sys_sem_wait(&mbox->sem, 0);      /* Wait availability again */
+    for (size_t i = 0; i < LWESP_SYS_MBOX_SPIN_COUNT; ++i) {
+        if (mbox_try_put(mbox, m)) {
+            mbox_wake(mbox, &mbox->get_waiters, &mbox->not_empty);
+            return osKernelSysTick() - time;
+        }
+        YieldProcessor();
     }
-    mbox->entries[mbox->in] = m;
-    if (++mbox->in >= mbox->size) {
-        mbox->in = 0;
+
+    /* Slow path, block until entry is read by other thread */
+    EnterCriticalSection(&mbox->cs);
+    InterlockedIncrement(&mbox->put_waiters);   /* Full barrier, pairs with barrier in wake function */
+    while (!mbox_try_put(mbox, m)) {
+        SleepConditionVariableCS(&mbox->not_full, &mbox->cs, INFINITE);
     }
-    lwesp_sys_sem_release(&mbox->sem_not_empty);/* Signal non-empty state */
-    lwesp_sys_sem_release(&mbox->sem);          /* Release access for other threads */
+    InterlockedDecrement(&mbox->put_waiters);
+    LeaveCriticalSection(&mbox->cs);
+    mbox_wake(mbox, &mbox->get_waiters, &mbox->not_empty);
     return osKernelSysTick() - time;
 }
 
 uint32_t
 lwesp_sys_mbox_get(lwesp_sys_mbox_t* b, void** m, uint32_t timeout) {
     win32_mbox_t* mbox = *b;
-    uint32_t time;
-
-    time = osKernelSysTick();
+    uint32_t time = osKernelSysTick(), elapsed;
+    uint8_t res;
 
-    /* Get exclusive access to message queue */
-    if (lwesp_sys_sem_wait(&mbox->sem, timeout) == LWESP_SYS_TIMEOUT) {
-        return LWESP_SYS_TIMEOUT;
+    for (size_t i = 0; i < LWESP_SYS_MBOX_SPIN_COUNT; ++i) {
+        if (mbox_try_get(mbox, m)) {
+            mbox_wake(mbox, &mbox->put_waiters, &mbox->not_full);
+            return osKernelSysTick() - time;
+        }
+        YieldProcessor();
     }
-    while (mbox_is_empty(mbox)) {
-        lwesp_sys_sem_release(&mbox->sem);
-        if (lwesp_sys_sem_wait(&mbox->sem_not_empty, timeout) == LWESP_SYS_TIMEOUT) {
-            return LWESP_SYS_TIMEOUT;
+
+    /* Slow path, block until entry is written or timeout */
+    EnterCriticalSection(&mbox->cs);
+    InterlockedIncrement(&mbox->get_waiters);   /* Full barrier, pairs with barrier in wake function */
+    while (!(res = mbox_try_get(mbox, m))) {
+        elapsed = osKernelSysTick() - time;
+        if (timeout > 0 && elapsed >= timeout) {
+            break;
         }
-        lwesp_sys_sem_wait(&mbox->sem, timeout);
+        SleepConditionVariableCS(&mbox->not_empty, &mbox->cs, timeout == 0 ? INFINITE : (timeout - elapsed));
     }
-    *m = mbox->entries[mbox->out];
-    if (++mbox->out >= mbox->size) {
-        mbox->out = 0;
+    InterlockedDecrement(&mbox->get_waiters);
+    LeaveCriticalSection(&mbox->cs);
+    if (!res) {
+        return LWESP_SYS_TIMEOUT;
     }
-    lwesp_sys_sem_release(&mbox->sem_not_full);
-    lwesp_sys_sem_release(&mbox->sem);
-
+    mbox_wake(mbox, &mbox->put_waiters, &mbox->not_full);
     return osKernelSysTick() - time;
 }
 
@@ -289,39 +394,22 @@ uint8_t
 lwesp_sys_mbox_putnow(lwesp_sys_mbox_t* b, void* m) {
     win32_mbox_t* mbox = *b;
 
-    lwesp_sys_sem_wait(&mbox->sem, 0);
-    if (mbox_is_full(mbox)) {
-        lwesp_sys_sem_release(&mbox->sem);
-        return 0;
-    }
-    mbox->entries[mbox->in] = m;
-    if (mbox->in == mbox->out) {
-        lwesp_sys_sem_release(&mbox->sem_not_empty);
-    }
-    if (++mbox->in >= mbox->size) {
-        mbox->in = 0;
+    if (mbox_try_put(mbox, m)) {
+        mbox_wake(mbox, &mbox->get_waiters, &mbox->not_empty);
+        return 1;
     }
-    lwesp_sys_sem_release(&mbox->sem);
-    return 1;
+    return 0;
 }
 
 uint8_t
 lwesp_sys_mbox_getnow(lwesp_sys_mbox_t* b, void** m) {
     win32_mbox_t* mbox = *b;
 
-    lwesp_sys_sem_wait(&mbox->sem, 0);          /* Wait exclusive access */
-    if (mbox->in == mbox->out) {
-        lwesp_sys_sem_release(&mbox->sem);      /* Release access */
-        return 0;
-    }
-
-    *m = mbox->entries[mbox->out];
-    if (++mbox->out >= mbox->size) {
-        mbox->out = 0;
+    if (mbox_try_get(mbox, m)) {
+        mbox_wake(mbox, &mbox->put_waiters, &mbox->not_full);
+        return 1;
     }
-    lwesp_sys_sem_release(&mbox->sem_not_full); /* Queue not full anymore */
-    lwesp_sys_sem_release(&mbox->sem);          /* Release semaphore */
-    return 1;
+    return 0;
 }
 
 uint8_t
@@ -339,11 +427,16 @@ uint8_t
 lwesp_sys_thread_create(lwesp_sys_thread_t* t, const char* name, lwesp_sys_thread_fn thread_func, void* const arg, size_t stack_size, lwesp_sys_thread_prio_t prio) {
     HANDLE h;
     DWORD id;
-    h = CreateThread(0, 0, (LPTHREAD_START_ROUTINE)thread_func, arg, 0, &id);
+    h = CreateThread(0, 0, (LPTHREAD_START_ROUTINE)thread_func, arg, CREATE_SUSPENDED, &id);
+    if (h == NULL) {
+        return 0;
+    }
+    LWESP_CFG_SYS_THREAD_CREATE_HOOK(&h, name, prio);
+    ResumeThread(h);
     if (t != NULL) {
         *t = h;
     }
-    return h != NULL;
+    return 1;
 }
 
 uint8_t
@@ -365,5 +458,54 @@ lwesp_sys_thread_yield(void) {
     return 1;
 }
 
+#if LWESP_CFG_SYS_THREAD_NOTIFY
+
+uint8_t
+lwesp_sys_thread_notify_get(lwesp_sys_thread_notify_t* n) {
+    HANDLE h = TlsGetValue(notify_tls);
+
+    if (h == NULL) {                            /* Create event on first use in this thread */
+        h = CreateEvent(NULL, FALSE, FALSE, NULL);
+        if (h != NULL) {
+            TlsSetValue(notify_tls, h);
+        }
+    }
+    *n = h;
+    return h != NULL;
+}
+
+uint32_t
+lwesp_sys_thread_notify_wait(uint32_t timeout) {
+    HANDLE h = TlsGetValue(notify_tls);
+    uint32_t tick = osKernelSysTick();
+
+    if (h == NULL) {
+        return LWESP_SYS_TIMEOUT;
+    }
+    if (WaitForSingleObject(h, timeout == 0 ? INFINITE : timeout) == WAIT_OBJECT_0) {
+        return osKernelSysTick() - tick;
+    }
+    return LWESP_SYS_TIMEOUT;
+}
+
+uint8_t
+lwesp_sys_thread_notify(lwesp_sys_thread_notify_t* n) {
+    return SetEvent(*n);
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_NOTIFY */
+
+#if LWESP_CFG_SYS_THREAD_STACK_INFO
+
+uint8_t
+lwesp_sys_thread_stack_free(lwesp_sys_thread_t* t, size_t* free_ss) {
+    /* Not implemented, stack usage is not tracked on Windows threads */
+    (void)t;
+    *free_ss = 0;
+    return 0;
+}
+
+#endif /* LWESP_CFG_SYS_THREAD_STACK_INFO */
+
 #endif /* LWESP_CFG_OS */
 #endif /* !__DOXYGEN__ */
@@ -0,0 +1,514 @@
+/*
+ * Benchmark suite for parser, packet buffers, allocator and data paths.
+ *
+ * Designed to run against simulated device (system/lwesp_ll_sim.c),
+ * where remote side of TCP connection is echo server and port 1883 is minimal MQTT broker.
+ * Micro benchmarks (parser, packet buffers, allocator) do not depend on device timing.
+ *
+ * Results are printed in machine readable form, one JSON object per line:
+ *
+ * {"bench":"pbuf_copy","iters":65536,"time_ms":210,"ns_per_iter":3204,"bytes_per_s":319575161}
+ *
+ * Collect lines for every commit and compare them with external tools.
+ *
+ * Parser benchmarks feed recorded UART traces directly to the parser with core locked
+ * and access library internals for that purpose.
+ * Application must not execute any other commands while benchmark runs.
+ */
+#include "benchmark.h"
+#include "lwesp/lwesp.h"
+#include "lwesp/lwesp_private.h"
+#include "lwesp/lwesp_mem.h"
+#include "lwesp/lwesp_netconn.h"
+#include "lwesp/apps/lwesp_mqtt_client_api.h"
+
+/**
+ * \brief           Minimum measured time of one benchmark in units of milliseconds
+ */
+#define BENCH_MIN_TIME              200
+
+/**
+ * \brief           Function used to print results, may be redefined to write to result file
+ */
+#ifndef BENCH_PRINTF
+#define BENCH_PRINTF                printf
+#endif
+
+/**
+ * \brief           Remote host and ports of simulated servers
+ */
+#define BENCH_HOST                  "10.0.0.1"
+#define BENCH_ECHO_PORT             7
+#define BENCH_MQTT_PORT             1883
+
+/**
+ * \brief           Size of data block for packet buffer and end-to-end benchmarks
+ */
+#define BENCH_BLOCK_SIZE            1024
+#define BENCH_CHAIN_LEN             8
+
+/**
+ * \brief           Benchmark function
+ * \param[in]       arg: User argument
+ * \param[in]       iters: Number of iterations to execute
+ * \param[out]      bytes: Number of processed bytes in all iterations
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+typedef lwespr_t (*bench_fn)(void* arg, size_t iters, size_t* bytes);
+
+static char bench_trace[2048];
+static size_t bench_trace_len;
+static uint8_t bench_block[BENCH_BLOCK_SIZE];
+static size_t bench_recv_bytes;
+
+/**
+ * \brief           Run benchmark with doubling number of iterations until minimum time is reached
+ * \param[in]       name: Benchmark name for output
+ * \param[in]       fn: Benchmark function
+ * \param[in]       arg: User argument for benchmark function
+ */
+static void
+bench_run(const char* name, bench_fn fn, void* arg) {
+    size_t iters = 1, bytes = 0;
+    uint32_t time;
+    lwespr_t res;
+
+    while (1) {
+        time = lwesp_sys_now();
+        res = fn(arg, iters, &bytes);
+        time = lwesp_sys_now() - time;
+        if (res != lwespOK || time >= BENCH_MIN_TIME) {
+            break;
+        }
+        iters <<= 1;
+    }
+    if (res != lwespOK) {
+        BENCH_PRINTF("{\"bench\":\"%s\",\"error\":%d}\r\n", name, (int)res);
+        return;
+    }
+    BENCH_PRINTF("{\"bench\":\"%s\",\"iters\":%llu,\"time_ms\":%llu,\"ns_per_iter\":%llu,\"bytes_per_s\":%llu}\r\n",
+                 name, (unsigned long long)iters, (unsigned long long)time,
+                 (unsigned long long)time * 1000000ULL / iters,
+                 (unsigned long long)bytes * 1000ULL / time);
+}
+
+/**
+ * \brief           Feed recorded trace to parser
+ * \param[in]       arg: Fake message to set as current command or `NULL` to keep current one
+ */
+static lwespr_t
+bench_parser(void* arg, size_t iters, size_t* bytes) {
+    lwesp_msg_t* msg = arg, *msg_prev;
+    uint32_t active_conns[LWESP_ARRAYSIZE(esp.m.active_conns)];
+
+    lwesp_core_lock();
+    msg_prev = esp.msg;
+    memcpy(active_conns, esp.m.active_conns, sizeof(active_conns));
+    if (msg != NULL) {
+        esp.msg = msg;
+    }
+    for (size_t i = 0; i < iters; ++i) {
+        if (msg != NULL && msg->cmd_def == LWESP_CMD_WIFI_CWLAP) {
+            msg->msg.ap_list.apsi = 0;          /* Start filling list from beginning again */
+        }
+        lwespi_process(bench_trace, bench_trace_len);
+    }
+    esp.msg = msg_prev;
+    memcpy(esp.m.active_conns, active_conns, sizeof(active_conns));
+    lwesp_core_unlock();
+    *bytes = iters * bench_trace_len;
+    return lwespOK;
+}
+
+/**
+ * \brief           Connection callback for IPD parser benchmark
+ */
+static lwespr_t
+bench_conn_evt_fn(lwesp_evt_t* evt) {
+    if (lwesp_evt_get_type(evt) == LWESP_EVT_CONN_RECV) {
+        bench_recv_bytes += lwesp_pbuf_length(lwesp_evt_conn_recv_get_buff(evt), 1);
+    }
+    return lwespOK;
+}
+
+/**
+ * \brief           Run parser benchmarks on recorded traces
+ */
+static void
+bench_parser_all(void) {
+    static lwesp_ap_t aps[16];
+    static lwesp_conn_t conns[LWESP_CFG_MAX_CONNS];
+    lwesp_msg_t msg;
+
+#if !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE
+    lwesp_conn_p conn;
+
+    /* IPD heavy, data must arrive to active connection */
+    if (lwesp_conn_start(&conn, LWESP_CONN_TYPE_TCP, BENCH_HOST, BENCH_ECHO_PORT, NULL, bench_conn_evt_fn, 1) == lwespOK) {
+        bench_trace_len = 0;
+        for (size_t i = 0; i < 3; ++i) {
+            bench_trace_len += sprintf(&bench_trace[bench_trace_len], "\r\n+IPD,%d,%d:", (int)lwesp_conn_getnum(conn), 512);
+            memset(&bench_trace[bench_trace_len], 'a' + i, 512);
+            bench_trace_len += 512;
+        }
+        bench_recv_bytes = 0;
+        bench_run("parser_ipd", bench_parser, NULL);
+        lwesp_conn_close(conn, 1);
+    } else {
+        BENCH_PRINTF("{\"bench\":\"parser_ipd\",\"error\":%d}\r\n", (int)lwespERRCONNFAIL);
+    }
+#endif /* !LWESP_CFG_CONN_MANUAL_TCP_RECEIVE */
+
+    /* CIPSTATUS heavy, parser writes connection data, keep copy and restore it after */
+    memcpy(conns, esp.m.conns, sizeof(conns));
+    memset(&msg, 0x00, sizeof(msg));
+    msg.cmd_def = LWESP_CMD_TCPIP_CIPSTATUS;
+    msg.cmd = LWESP_CMD_TCPIP_CIPSTATUS;
+    bench_trace_len = sprintf(bench_trace, "STATUS:3\r\n");
+    for (size_t i = 0; i < LWESP_CFG_MAX_CONNS; ++i) {
+        bench_trace_len += sprintf(&bench_trace[bench_trace_len], "+CIPSTATUS:%d,\"TCP\",\"192.168.1.%d\",80,%d,0\r\n",
+                                   (int)i, (int)(10 + i), (int)(40000 + i));
+    }
+    bench_run("parser_cipstatus", bench_parser, &msg);
+    lwesp_core_lock();
+    memcpy(esp.m.conns, conns, sizeof(conns));
+    lwesp_core_unlock();
+
+#if LWESP_CFG_MODE_STATION
+    /* CWLAP heavy */
+    memset(&msg, 0x00, sizeof(msg));
+    msg.cmd_def = LWESP_CMD_WIFI_CWLAP;
+    msg.cmd = LWESP_CMD_WIFI_CWLAP;
+    msg.msg.ap_list.aps = aps;
+    msg.msg.ap_list.apsl = LWESP_ARRAYSIZE(aps);
+    bench_trace_len = 0;
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(aps); ++i) {
+        bench_trace_len += sprintf(&bench_trace[bench_trace_len], "+CWLAP:(3,\"lwesp-ap-%02d\",-%d,\"02:00:00:00:00:%02x\",%d)\r\n",
+                                   (int)i, (int)(40 + i), (int)i, (int)(1 + i % 13));
+    }
+    bench_run("parser_cwlap", bench_parser, &msg);
+#endif /* LWESP_CFG_MODE_STATION */
+}
+
+/**
+ * \brief           Memory copy benchmark setup
+ */
+typedef struct {
+    size_t len;                                 /*!< Number of bytes to copy in one iteration */
+    size_t dst_offset;                          /*!< Destination offset from word boundary */
+} bench_copy_t;
+
+/**
+ * \brief           Copy memory block with \ref LWESP_MEMCPY
+ * \param[in]       arg: Copy setup, \ref bench_copy_t
+ */
+static lwespr_t
+bench_memcpy(void* arg, size_t iters, size_t* bytes) {
+    static uint32_t in[BENCH_BLOCK_SIZE / 4], out[BENCH_BLOCK_SIZE / 4 + 1];
+    const bench_copy_t* c = arg;
+
+    for (size_t i = 0; i < iters; ++i) {
+        LWESP_MEMCPY((uint8_t*)out + c->dst_offset, in, c->len);
+    }
+    *bytes = iters * c->len;
+    return lwespOK;
+}
+
+/**
+ * \brief           Set memory block with \ref LWESP_MEMSET
+ * \param[in]       arg: Set setup, \ref bench_copy_t
+ */
+static lwespr_t
+bench_memset(void* arg, size_t iters, size_t* bytes) {
+    static uint32_t out[BENCH_BLOCK_SIZE / 4 + 1];
+    const bench_copy_t* c = arg;
+
+    for (size_t i = 0; i < iters; ++i) {
+        LWESP_MEMSET((uint8_t*)out + c->dst_offset, (int)i, c->len);
+    }
+    *bytes = iters * c->len;
+    return lwespOK;
+}
+
+/**
+ * \brief           Run memory copy and set benchmarks
+ *
+ * Results depend on \ref LWESP_CFG_MEM_FAST_COPY setting,
+ * run with option enabled and disabled to compare library and C library functions.
+ */
+static void
+bench_copy_all(void) {
+    static const bench_copy_t block = {BENCH_BLOCK_SIZE, 0}, block_unaligned = {BENCH_BLOCK_SIZE, 1},
+                              small = {16, 0}, tiny = {5, 0};
+
+    bench_run("memcpy_block", bench_memcpy, (void*)&block);
+    bench_run("memcpy_block_unaligned", bench_memcpy, (void*)&block_unaligned);
+    bench_run("memcpy_small", bench_memcpy, (void*)&small);
+    bench_run("memcpy_tiny", bench_memcpy, (void*)&tiny);
+    bench_run("memset_block", bench_memset, (void*)&block);
+}
+
+/**
+ * \brief           Allocate and free single packet buffer
+ */
+static lwespr_t
+bench_pbuf_new_free(void* arg, size_t iters, size_t* bytes) {
+    lwesp_pbuf_p p;
+
+    for (size_t i = 0; i < iters; ++i) {
+        if ((p = lwesp_pbuf_new(256)) == NULL) {
+            return lwespERRMEM;
+        }
+        lwesp_pbuf_free(p);
+    }
+    *bytes = iters * 256;
+    return lwespOK;
+}
+
+/**
+ * \brief           Build chain of packet buffers with concatenation and free it
+ */
+static lwespr_t
+bench_pbuf_cat(void* arg, size_t iters, size_t* bytes) {
+    lwesp_pbuf_p head, p;
+
+    for (size_t i = 0; i < iters; ++i) {
+        if ((head = lwesp_pbuf_new(BENCH_BLOCK_SIZE / BENCH_CHAIN_LEN)) == NULL) {
+            return lwespERRMEM;
+        }
+        for (size_t j = 1; j < BENCH_CHAIN_LEN; ++j) {
+            if ((p = lwesp_pbuf_new(BENCH_BLOCK_SIZE / BENCH_CHAIN_LEN)) == NULL) {
+                lwesp_pbuf_free(head);
+                return lwespERRMEM;
+            }
+            lwesp_pbuf_cat(head, p);
+        }
+        lwesp_pbuf_free(head);
+    }
+    *bytes = iters * BENCH_BLOCK_SIZE;
+    return lwespOK;
+}
+
+/**
+ * \brief           Copy chain of packet buffers to linear memory
+ * \param[in]       arg: Packet buffer chain
+ */
+static lwespr_t
+bench_pbuf_copy(void* arg, size_t iters, size_t* bytes) {
+    static uint8_t out[BENCH_BLOCK_SIZE];
+
+    for (size_t i = 0; i < iters; ++i) {
+        if (lwesp_pbuf_copy(arg, out, sizeof(out), 0) != sizeof(out)) {
+            return lwespERR;
+        }
+    }
+    *bytes = iters * sizeof(out);
+    return lwespOK;
+}
+
+/**
+ * \brief           Find binary needle at the end of packet buffer chain
+ * \param[in]       arg: Packet buffer chain
+ */
+static lwespr_t
+bench_pbuf_memfind(void* arg, size_t iters, size_t* bytes) {
+    for (size_t i = 0; i < iters; ++i) {
+        if (lwesp_pbuf_memfind(arg, "\r\n\r\n", 4, 0) == LWESP_SIZET_MAX) {
+            return lwespERR;
+        }
+    }
+    *bytes = iters * BENCH_BLOCK_SIZE;
+    return lwespOK;
+}
+
+/**
+ * \brief           Find string at the end of packet buffer chain
+ * \param[in]       arg: Packet buffer chain
+ */
+static lwespr_t
+bench_pbuf_strfind(void* arg, size_t iters, size_t* bytes) {
+    for (size_t i = 0; i < iters; ++i) {
+        if (lwesp_pbuf_strfind(arg, "HTTP", 0) == LWESP_SIZET_MAX) {
+            return lwespERR;
+        }
+    }
+    *bytes = iters * BENCH_BLOCK_SIZE;
+    return lwespOK;
+}
+
+/**
+ * \brief           Run packet buffer benchmarks
+ */
+static void
+bench_pbuf_all(void) {
+    lwesp_pbuf_p head = NULL, p;
+
+    bench_run("pbuf_new_free", bench_pbuf_new_free, NULL);
+    bench_run("pbuf_cat", bench_pbuf_cat, NULL);
+
+    /* Prepare chain with needles at the end for copy and search operations */
+    for (size_t i = 0; i < BENCH_CHAIN_LEN; ++i) {
+        if ((p = lwesp_pbuf_new(BENCH_BLOCK_SIZE / BENCH_CHAIN_LEN)) == NULL) {
+            lwesp_pbuf_free(head);
+            BENCH_PRINTF("{\"bench\":\"pbuf_copy\",\"error\":%d}\r\n", (int)lwespERRMEM);
+            return;
+        }
+        head = head == NULL ? p : head;
+        if (p != head) {
+            lwesp_pbuf_cat(head, p);
+        }
+    }
+    memset(bench_block, 'x', sizeof(bench_block));
+    memcpy(&bench_block[sizeof(bench_block) - 8], "HTTP\r\n\r\n", 8);
+    lwesp_pbuf_take(head, bench_block, sizeof(bench_block), 0);
+
+    bench_run("pbuf_copy", bench_pbuf_copy, head);
+    bench_run("pbuf_memfind", bench_pbuf_memfind, head);
+    bench_run("pbuf_strfind", bench_pbuf_strfind, head);
+    lwesp_pbuf_free(head);
+}
+
+/**
+ * \brief           Allocate and free blocks of pseudo-random size
+ */
+static lwespr_t
+bench_mem(void* arg, size_t iters, size_t* bytes) {
+    static void* ptrs[32];
+    uint32_t seed = 0x12345678;
+    size_t size, idx;
+
+    *bytes = 0;
+    for (size_t i = 0; i < iters; ++i) {
+        seed = seed * 1664525UL + 1013904223UL;
+        idx = (seed >> 8) % LWESP_ARRAYSIZE(ptrs);
+        size = 16 + (seed >> 16) % 512;
+        if (ptrs[idx] != NULL) {
+            lwesp_mem_free_s(&ptrs[idx]);
+        }
+        if ((ptrs[idx] = lwesp_mem_malloc(size)) != NULL) {
+            *bytes += size;
+        }
+    }
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(ptrs); ++i) {
+        lwesp_mem_free_s(&ptrs[i]);
+    }
+    return lwespOK;
+}
+
+#if LWESP_CFG_NETCONN
+/**
+ * \brief           Send data block to echo server and wait for it to come back
+ * \param[in]       arg: Connected netconn
+ */
+static lwespr_t
+bench_tcp(void* arg, size_t iters, size_t* bytes) {
+    lwesp_pbuf_p pbuf;
+    size_t rx = 0;
+    lwespr_t res;
+
+    for (size_t i = 0; i < iters; ++i) {
+        if ((res = lwesp_netconn_write(arg, bench_block, sizeof(bench_block))) != lwespOK
+            || (res = lwesp_netconn_flush(arg)) != lwespOK) {
+            return res;
+        }
+        while (rx < (i + 1) * sizeof(bench_block)) {
+            if ((res = lwesp_netconn_receive(arg, &pbuf)) != lwespOK) {
+                return res;
+            }
+            rx += lwesp_pbuf_length(pbuf, 1);
+            lwesp_pbuf_free(pbuf);
+        }
+    }
+    *bytes = iters * sizeof(bench_block);
+    return lwespOK;
+}
+#endif /* LWESP_CFG_NETCONN */
+
+/**
+ * \brief           Publish message and wait for broker to deliver it back
+ * \param[in]       arg: Connected MQTT client with subscription
+ */
+static lwespr_t
+bench_mqtt(void* arg, size_t iters, size_t* bytes) {
+    lwesp_mqtt_client_api_buf_p buf;
+    lwespr_t res;
+
+    for (size_t i = 0; i < iters; ++i) {
+        if ((res = lwesp_mqtt_client_api_publish(arg, "lwesp/bench", bench_block, 256, LWESP_MQTT_QOS_AT_LEAST_ONCE, 0)) != lwespOK
+            || (res = lwesp_mqtt_client_api_receive(arg, &buf, 1000)) != lwespOK) {
+            return res;
+        }
+        lwesp_mqtt_client_api_buf_free(buf);
+    }
+    *bytes = iters * 256;
+    return lwespOK;
+}
+
+/**
+ * \brief           Run end-to-end benchmarks against simulated servers
+ */
+static void
+bench_e2e_all(void) {
+    static const lwesp_mqtt_client_info_t info = {
+        .id = "lwesp_bench",
+        .keep_alive = 10,
+    };
+    lwesp_mqtt_client_api_p client;
+#if LWESP_CFG_NETCONN
+    lwesp_netconn_p nc;
+
+    if ((nc = lwesp_netconn_new(LWESP_NETCONN_TYPE_TCP)) != NULL) {
+        if (lwesp_netconn_connect(nc, BENCH_HOST, BENCH_ECHO_PORT) == lwespOK) {
+            memset(bench_block, 'x', sizeof(bench_block));
+            bench_run("e2e_tcp_echo", bench_tcp, nc);
+            lwesp_netconn_close(nc);
+        } else {
+            BENCH_PRINTF("{\"bench\":\"e2e_tcp_echo\",\"error\":%d}\r\n", (int)lwespERRCONNFAIL);
+        }
+        lwesp_netconn_delete(nc);
+    }
+#endif /* LWESP_CFG_NETCONN */
+
+    if ((client = lwesp_mqtt_client_api_new(512, 512)) != NULL) {
+        if (lwesp_mqtt_client_api_connect(client, BENCH_HOST, BENCH_MQTT_PORT, &info) == LWESP_MQTT_CONN_STATUS_ACCEPTED
+            && lwesp_mqtt_client_api_subscribe(client, "lwesp/bench", LWESP_MQTT_QOS_AT_MOST_ONCE) == lwespOK) {
+            bench_run("e2e_mqtt_loopback", bench_mqtt, client);
+            lwesp_mqtt_client_api_close(client);
+        } else {
+            BENCH_PRINTF("{\"bench\":\"e2e_mqtt_loopback\",\"error\":%d}\r\n", (int)lwespERRCONNFAIL);
+        }
+        lwesp_mqtt_client_api_delete(client);
+    }
+}
+
+/**
+ * \brief           Run all benchmarks and print results
+ * \note            Library must be initialized, station is joined to access point if not already
+ */
+void
+benchmark_run(void) {
+#if LWESP_CFG_MODE_STATION
+    if (!lwesp_sta_is_joined()) {
+        lwesp_sta_join("lwesp-sim", "lwesp-sim", NULL, NULL, NULL, 1);
+    }
+#endif /* LWESP_CFG_MODE_STATION */
+
+    bench_parser_all();
+    bench_copy_all();
+    bench_pbuf_all();
+    bench_run("mem_malloc_free", bench_mem, NULL);
+    bench_e2e_all();
+}
+
+/**
+ * \brief           Benchmark thread, runs all benchmarks once and terminates
+ * \param[in]       arg: User argument
+ */
+void
+benchmark_thread(void const* arg) {
+    LWESP_UNUSED(arg);
+
+    benchmark_run();
+    printf("Benchmark finished\r\n");
+    lwesp_sys_thread_terminate(NULL);
+}
@@ -11,7 +11,7 @@ static lwespr_t   http_post_end_cb(http_state_t* hs);
 #endif /* HTTP_SUPPORT_POST */
 
 static char*    led_cgi_handler(http_param_t* params, size_t params_len);
-static char*    usart_cgi_handler(http_param_t* params, size_t params_len);
+static char*    usart_cgi_handler(http_state_t* hs);
 
 /**
  * \brief           List of CGI handlers
@@ -19,7 +19,7 @@ static char*    usart_cgi_handler(http_param_t* params, size_t params_len);
 const http_cgi_t
 cgi_handlers[] = {
     { "/led.cgi", led_cgi_handler },
-    { "/usart.cgi", usart_cgi_handler },
+    { .uri = "/usart.cgi", .method = HTTP_METHOD_GET, .req_fn = usart_cgi_handler },
 };
 
 /**
@@ -168,17 +168,18 @@ led_cgi_handler(http_param_t* params, size_t params_len) {
 }
 
 /**
- * \brief           CGI handler function when user connects to "http://ip/usart.cgi?param1=value1&param2=value2"
- * \param[in]       params: Pointer to list of parameters with URI
- * \param[in]       params_len: Number of parameters
+ * \brief           CGI handler function when user connects to "http://ip/usart.cgi?baud=115200"
+ * \param[in]       hs: HTTP state
  * \return          URI string to return to user
  */
 char*
-usart_cgi_handler(http_param_t* params, size_t params_len) {
+usart_cgi_handler(http_state_t* hs) {
+    const char* baud;
+    size_t len;
+
     printf("USART CGI HANDLER!\r\n");
-    while (params_len--) {
-        printf("Param: name = %s, value = %s\r\n", params->name, params->value);
-        params++;
+    if ((baud = lwesp_http_server_get_param(hs, "baud", &len)) != NULL) {
+        printf("Param: name = baud, value = %.*s\r\n", (int)len, baud);
     }
     return "/index.html";
 }
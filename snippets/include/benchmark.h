@@ -0,0 +1,15 @@
+#ifndef SNIPPET_HDR_BENCHMARK_H
+#define SNIPPET_HDR_BENCHMARK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+void benchmark_run(void);
+void benchmark_thread(void const* arg);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SNIPPET_HDR_BENCHMARK_H */
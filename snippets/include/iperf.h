@@ -0,0 +1,53 @@
+#ifndef SNIPPET_HDR_IPERF_H
+#define SNIPPET_HDR_IPERF_H
+
+#include <stdint.h>
+#include "lwesp/lwesp.h"
+#include "lwesp/lwesp_netconn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Maximal number of parallel connections in single test
+ */
+#define IPERF_MAX_CONNS             4
+
+/**
+ * \brief           Maximal data chunk size for single write
+ */
+#define IPERF_MAX_CHUNK             4096
+
+/**
+ * \brief           Direction of data transfer, seen from ESP device
+ */
+typedef enum {
+    IPERF_DIR_UPLOAD,                           /*!< Device sends data to remote side */
+    IPERF_DIR_DOWNLOAD,                         /*!< Device receives data from remote side */
+} iperf_dir_t;
+
+/**
+ * \brief           Throughput test configuration
+ */
+typedef struct {
+    const char* name;                           /*!< Test name for output */
+    lwesp_netconn_type_t type;                  /*!< \ref LWESP_NETCONN_TYPE_TCP or \ref LWESP_NETCONN_TYPE_UDP */
+    iperf_dir_t dir;                            /*!< Transfer direction */
+    uint8_t server;                             /*!< Set to `1` to wait for remote side to connect, `0` to connect to `host` */
+    const char* host;                           /*!< Remote host in client mode */
+    lwesp_port_t port;                          /*!< Remote port in client mode, local port in server mode */
+    size_t chunk_size;                          /*!< Size of single write, up to \ref IPERF_MAX_CHUNK */
+    size_t conn_count;                          /*!< Number of parallel connections, up to \ref IPERF_MAX_CONNS */
+    uint32_t duration;                          /*!< Test duration in units of milliseconds */
+    uint32_t interval;                          /*!< Report interval in units of milliseconds, `0` to print summary only */
+} iperf_cfg_t;
+
+lwespr_t    iperf_run(const iperf_cfg_t* cfg);
+void        iperf_thread(void const* arg);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SNIPPET_HDR_IPERF_H */
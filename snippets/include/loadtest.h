@@ -0,0 +1,57 @@
+#ifndef SNIPPET_HDR_LOADTEST_H
+#define SNIPPET_HDR_LOADTEST_H
+
+#include <stdint.h>
+#include "lwesp/lwesp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \brief           Maximal number of concurrent sessions in single test
+ */
+#define LOADTEST_MAX_SESSIONS       LWESP_CFG_MAX_CONNS
+
+/**
+ * \brief           Maximal payload size of single message
+ */
+#define LOADTEST_MAX_PAYLOAD        1460
+
+/**
+ * \brief           Function used to print results, may be redefined to write to result file
+ */
+#ifndef LOADTEST_PRINTF
+#define LOADTEST_PRINTF             printf
+#endif
+
+/**
+ * \brief           Session type, selects API used to drive traffic
+ */
+typedef enum {
+    LOADTEST_TYPE_CONN,                         /*!< TCP with callback based connection API, \ref lwesp_conn_send */
+    LOADTEST_TYPE_NETCONN_TCP,                  /*!< TCP with sequential netconn API */
+    LOADTEST_TYPE_NETCONN_UDP,                  /*!< UDP with sequential netconn API */
+    LOADTEST_TYPE_MQTT,                         /*!< MQTT publish and loopback with MQTT client API */
+    LOADTEST_TYPE_END,                          /*!< Last entry, number of types */
+} loadtest_type_t;
+
+/**
+ * \brief           Load test configuration
+ */
+typedef struct {
+    loadtest_type_t type;                       /*!< Session type */
+    size_t sessions;                            /*!< Number of concurrent sessions, up to \ref LOADTEST_MAX_SESSIONS */
+    size_t payload;                             /*!< Message payload size, up to \ref LOADTEST_MAX_PAYLOAD */
+    uint32_t rate;                              /*!< Messages per second of each session, `0` to send next message as soon as previous one returns */
+    uint32_t duration;                          /*!< Test duration in units of milliseconds */
+} loadtest_cfg_t;
+
+lwespr_t    loadtest_run(const loadtest_cfg_t* cfg);
+void        loadtest_thread(void const* arg);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* SNIPPET_HDR_LOADTEST_H */
@@ -0,0 +1,326 @@
+/*
+ * Throughput benchmark, similar to iperf tool.
+ *
+ * Single test opens one or more TCP or UDP connections and transfers data
+ * in upload (device sends) or download (device receives) direction for configured time.
+ * Device can act as client and connect to remote side, or as server and wait for remote side to connect.
+ *
+ * Remote side can be any tool that sinks or sources raw data, for example:
+ *
+ *  - TCP upload, device as client: `iperf -s -p 5001` (iperf version 2) or `nc -l 5001 > /dev/null`
+ *  - TCP download, device as client: `nc -l 5001 < /dev/zero`
+ *  - UDP upload, device as client: `nc -u -l 5001 > /dev/null`
+ *  - UDP download, device as client: remote side must send to address of first datagram,
+ *      device sends one chunk after connection is established to announce itself
+ *
+ * Results are printed in machine readable form, one JSON object per line,
+ * interval reports during the test and summary at the end:
+ *
+ * {"iperf":"tcp_up","time_ms":10004,"bytes":1310720,"conns":1,"chunk":1460,"errors":0,"kbps":1048,"cpu_producer":38,"cpu_process":21,"heap_peak":9216,"heap_min_free":22528}
+ *
+ * CPU load is utilization of stack threads in percent, reported when \ref LWESP_CFG_STATS_THREAD is enabled.
+ * Heap usage is reported when \ref LWESP_CFG_MEM_STATS is enabled.
+ * Use the same configuration on every platform to compare effect of stack options.
+ */
+#include "iperf.h"
+#include "lwesp/lwesp.h"
+#include "lwesp/lwesp_mem.h"
+#include "lwesp/lwesp_netconn.h"
+
+#if !LWESP_CFG_NETCONN_RECEIVE_TIMEOUT
+#error "LWESP_CFG_NETCONN_RECEIVE_TIMEOUT must be enabled in `lwesp_opts.h` to use iperf snippet."
+#endif /* !LWESP_CFG_NETCONN_RECEIVE_TIMEOUT */
+
+/**
+ * \brief           Remote host and port for default tests in \ref iperf_thread
+ */
+#ifndef IPERF_HOST
+#define IPERF_HOST                  "192.168.1.100"
+#endif /* IPERF_HOST */
+#ifndef IPERF_PORT
+#define IPERF_PORT                  5001
+#endif /* IPERF_PORT */
+
+/**
+ * \brief           Receive timeout for download tests in units of milliseconds,
+ *                  worker checks test end time at least this often
+ */
+#define IPERF_RECV_TIMEOUT          100
+
+/**
+ * \brief           State of single test connection
+ */
+typedef struct {
+    const iperf_cfg_t* cfg;                     /*!< Test configuration */
+    lwesp_netconn_p nc;                         /*!< Netconn handle */
+    uint32_t end_time;                          /*!< Time when transfer stops */
+    volatile size_t bytes;                      /*!< Number of transferred bytes */
+    lwespr_t res;                               /*!< Result of transfer */
+} iperf_worker_t;
+
+static iperf_worker_t workers[IPERF_MAX_CONNS];
+static uint8_t iperf_chunk[IPERF_MAX_CHUNK];
+static lwesp_sys_mbox_t iperf_done_mbox;
+
+/**
+ * \brief           Get throughput in units of kbit/s
+ * \param[in]       bytes: Number of transferred bytes
+ * \param[in]       time: Time in units of milliseconds
+ * \return          Throughput
+ */
+static uint32_t
+iperf_kbps(size_t bytes, uint32_t time) {
+    return time > 0 ? (uint32_t)(((uint64_t)bytes * 8U) / time) : 0;
+}
+
+/**
+ * \brief           Get sum of transferred bytes of all test connections
+ * \param[in]       cnt: Number of connections
+ * \return          Number of bytes
+ */
+static size_t
+iperf_get_bytes(size_t cnt) {
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < cnt; ++i) {
+        bytes += workers[i].bytes;
+    }
+    return bytes;
+}
+
+/**
+ * \brief           Thread transferring data on single test connection
+ * \param[in]       arg: Worker state
+ */
+static void
+iperf_worker_thread(void* const arg) {
+    iperf_worker_t* w = arg;
+    const iperf_cfg_t* cfg = w->cfg;
+    lwesp_pbuf_p pbuf;
+    lwespr_t res = lwespOK;
+
+    if (cfg->dir == IPERF_DIR_DOWNLOAD) {
+        lwesp_netconn_set_receive_timeout(w->nc, IPERF_RECV_TIMEOUT);
+        if (cfg->type == LWESP_NETCONN_TYPE_UDP && !cfg->server) {
+            res = lwesp_netconn_send(w->nc, iperf_chunk, cfg->chunk_size);  /* Announce to remote side */
+        }
+    } else {
+        lwesp_netconn_set_receive_timeout(w->nc, LWESP_NETCONN_RECEIVE_NO_WAIT);
+    }
+    while (res == lwespOK && (int32_t)(lwesp_sys_now() - w->end_time) < 0) {
+        if (cfg->dir == IPERF_DIR_UPLOAD) {
+            if (cfg->type == LWESP_NETCONN_TYPE_UDP) {
+                res = lwesp_netconn_send(w->nc, iperf_chunk, cfg->chunk_size);
+            } else {
+                res = lwesp_netconn_write(w->nc, iperf_chunk, cfg->chunk_size);
+            }
+            if (res == lwespOK) {
+                w->bytes += cfg->chunk_size;
+            }
+
+            /* Drop data sent back by remote side, such as echo server */
+            while (lwesp_netconn_receive(w->nc, &pbuf) == lwespOK) {
+                lwesp_pbuf_free(pbuf);
+            }
+        } else {
+            res = lwesp_netconn_receive(w->nc, &pbuf);
+            if (res == lwespOK) {
+                w->bytes += lwesp_pbuf_length(pbuf, 1);
+                lwesp_pbuf_free(pbuf);
+            } else if (res == lwespTIMEOUT) {
+                res = lwespOK;
+            }
+        }
+    }
+    if (res == lwespOK && cfg->dir == IPERF_DIR_UPLOAD && cfg->type != LWESP_NETCONN_TYPE_UDP) {
+        res = lwesp_netconn_flush(w->nc);       /* Send remaining buffered data */
+    }
+    w->res = res;
+    lwesp_netconn_close(w->nc);
+    lwesp_netconn_delete(w->nc);
+    w->nc = NULL;
+    lwesp_sys_mbox_put(&iperf_done_mbox, w);
+    lwesp_sys_thread_terminate(NULL);
+}
+
+/**
+ * \brief           Open test connections according to configuration
+ * \param[in]       cfg: Test configuration
+ * \return          Number of opened connections
+ */
+static size_t
+iperf_open(const iperf_cfg_t* cfg) {
+    lwesp_netconn_p server = NULL;
+    lwespr_t res;
+    size_t cnt;
+
+    if (cfg->server && cfg->type == LWESP_NETCONN_TYPE_TCP) {
+        server = lwesp_netconn_new(LWESP_NETCONN_TYPE_TCP);
+        if (server == NULL
+            || lwesp_netconn_bind(server, cfg->port) != lwespOK
+            || lwesp_netconn_listen_with_max_conn(server, (uint16_t)cfg->conn_count) != lwespOK) {
+            printf("{\"iperf\":\"%s\",\"error\":\"listen\"}\r\n", cfg->name);
+            if (server != NULL) {
+                lwesp_netconn_delete(server);
+            }
+            return 0;
+        }
+        printf("{\"iperf\":\"%s\",\"listen\":%u}\r\n", cfg->name, (unsigned)cfg->port);
+    }
+    for (cnt = 0; cnt < cfg->conn_count; ++cnt) {
+        if (server != NULL) {
+            res = lwesp_netconn_accept(server, &workers[cnt].nc);
+        } else {
+            workers[cnt].nc = lwesp_netconn_new(cfg->type);
+            if (workers[cnt].nc == NULL) {
+                break;
+            }
+            if (cfg->type == LWESP_NETCONN_TYPE_UDP && cfg->server) {
+                /* Accept datagrams from any remote side on local port */
+                res = lwesp_netconn_connect_ex(workers[cnt].nc, cfg->host != NULL ? cfg->host : "0.0.0.0",
+                                               cfg->port, 0, NULL, (lwesp_port_t)(cfg->port + cnt), 2);
+            } else {
+                res = lwesp_netconn_connect(workers[cnt].nc, cfg->host, cfg->port);
+            }
+            if (res != lwespOK) {
+                lwesp_netconn_delete(workers[cnt].nc);
+            }
+        }
+        if (res != lwespOK) {
+            workers[cnt].nc = NULL;
+            printf("{\"iperf\":\"%s\",\"error\":\"connect\",\"res\":%d}\r\n", cfg->name, (int)res);
+            break;
+        }
+    }
+    if (server != NULL) {
+        lwesp_netconn_delete(server);           /* Stop accepting new connections */
+    }
+    return cnt;
+}
+
+/**
+ * \brief           Run single throughput test
+ * \note            Function blocks for test duration, only one test may run at the same time
+ * \param[in]       cfg: Test configuration
+ * \return          \ref lwespOK when all connections were opened, member of \ref lwespr_t otherwise
+ */
+lwespr_t
+iperf_run(const iperf_cfg_t* cfg) {
+    size_t cnt, started = 0, done = 0, errors = 0, bytes, last_bytes = 0;
+    uint32_t start, now, last;
+    void* m;
+#if LWESP_CFG_STATS_THREAD
+    lwesp_stats_t stats;
+    uint32_t producer_busy, process_busy, time_units;
+#endif /* LWESP_CFG_STATS_THREAD */
+#if LWESP_CFG_MEM_STATS
+    lwesp_mem_stats_t ms;
+#endif /* LWESP_CFG_MEM_STATS */
+
+    if (cfg == NULL || cfg->chunk_size == 0 || cfg->chunk_size > IPERF_MAX_CHUNK
+        || cfg->conn_count == 0 || cfg->conn_count > IPERF_MAX_CONNS
+        || (cfg->type != LWESP_NETCONN_TYPE_TCP && cfg->type != LWESP_NETCONN_TYPE_UDP)
+        || (!cfg->server && cfg->host == NULL)) {
+        return lwespPARERR;
+    }
+    if (!lwesp_sys_mbox_isvalid(&iperf_done_mbox)
+        && !lwesp_sys_mbox_create(&iperf_done_mbox, IPERF_MAX_CONNS)) {
+        return lwespERRMEM;
+    }
+    LWESP_MEMSET(workers, 0x00, sizeof(workers));
+    for (size_t i = 0; i < sizeof(iperf_chunk); ++i) {
+        iperf_chunk[i] = (uint8_t)('0' + (i % 10));
+    }
+
+    cnt = iperf_open(cfg);
+
+#if LWESP_CFG_STATS_THREAD
+    lwesp_stats_get(&stats);
+    producer_busy = stats.producer.busy_time;
+    process_busy = stats.process.busy_time;
+#endif /* LWESP_CFG_STATS_THREAD */
+    start = lwesp_sys_now();
+    for (size_t i = 0; i < cnt; ++i) {
+        workers[i].cfg = cfg;
+        workers[i].end_time = start + cfg->duration;
+        if (lwesp_sys_thread_create(NULL, "iperf", (lwesp_sys_thread_fn)iperf_worker_thread, &workers[i], LWESP_SYS_THREAD_SS, LWESP_SYS_THREAD_PRIO)) {
+            ++started;
+        } else {
+            lwesp_netconn_close(workers[i].nc);
+            lwesp_netconn_delete(workers[i].nc);
+            workers[i].nc = NULL;
+            ++errors;
+        }
+    }
+
+    /* Wait for all connections to finish, print interval reports */
+    last = start;
+    while (done < started) {
+        if (lwesp_sys_mbox_get(&iperf_done_mbox, &m, cfg->interval) != LWESP_SYS_TIMEOUT) {
+            if (((iperf_worker_t*)m)->res != lwespOK) {
+                ++errors;
+            }
+            ++done;
+        }
+        now = lwesp_sys_now();
+        if (cfg->interval > 0 && (now - last) >= cfg->interval && done < started) {
+            bytes = iperf_get_bytes(cnt);
+            printf("{\"iperf\":\"%s\",\"time_ms\":%u,\"bytes\":%u,\"kbps\":%u}\r\n", cfg->name, (unsigned)(now - start),
+                   (unsigned)(bytes - last_bytes), (unsigned)iperf_kbps(bytes - last_bytes, now - last));
+            last_bytes = bytes;
+            last = now;
+        }
+    }
+    now = lwesp_sys_now() - start;
+    bytes = iperf_get_bytes(cnt);
+
+    /* Print summary */
+    printf("{\"iperf\":\"%s\",\"time_ms\":%u,\"bytes\":%u,\"conns\":%u,\"chunk\":%u,\"errors\":%u,\"kbps\":%u",
+           cfg->name, (unsigned)now, (unsigned)bytes, (unsigned)started, (unsigned)cfg->chunk_size,
+           (unsigned)errors, (unsigned)iperf_kbps(bytes, now));
+#if LWESP_CFG_STATS_THREAD
+    lwesp_stats_get(&stats);
+    time_units = now * (LWESP_STATS_TIME_FREQ / 1000);
+    if (time_units > 0) {
+        printf(",\"cpu_producer\":%u,\"cpu_process\":%u",
+               (unsigned)(((uint64_t)(stats.producer.busy_time - producer_busy) * 100U) / time_units),
+               (unsigned)(((uint64_t)(stats.process.busy_time - process_busy) * 100U) / time_units));
+    }
+#endif /* LWESP_CFG_STATS_THREAD */
+#if LWESP_CFG_MEM_STATS
+    if (lwesp_mem_get_stats(&ms) == lwespOK) {
+        printf(",\"heap_peak\":%u,\"heap_min_free\":%u", (unsigned)ms.bytes_peak, (unsigned)ms.bytes_min_free);
+    }
+#endif /* LWESP_CFG_MEM_STATS */
+    printf("}\r\n");
+    return cnt == cfg->conn_count ? lwespOK : lwespERRCONNFAIL;
+}
+
+/**
+ * \brief           Default tests, executed by \ref iperf_thread
+ */
+static const iperf_cfg_t
+iperf_tests[] = {
+    { "tcp_up",         LWESP_NETCONN_TYPE_TCP, IPERF_DIR_UPLOAD,   0, IPERF_HOST, IPERF_PORT, 1460, 1, 10000, 1000 },
+    { "tcp_up_small",   LWESP_NETCONN_TYPE_TCP, IPERF_DIR_UPLOAD,   0, IPERF_HOST, IPERF_PORT,  256, 1, 10000, 1000 },
+    { "tcp_up_4conn",   LWESP_NETCONN_TYPE_TCP, IPERF_DIR_UPLOAD,   0, IPERF_HOST, IPERF_PORT, 1460, 4, 10000, 1000 },
+    { "tcp_down",       LWESP_NETCONN_TYPE_TCP, IPERF_DIR_DOWNLOAD, 0, IPERF_HOST, IPERF_PORT, 1460, 1, 10000, 1000 },
+    { "udp_up",         LWESP_NETCONN_TYPE_UDP, IPERF_DIR_UPLOAD,   0, IPERF_HOST, IPERF_PORT, 1460, 1, 10000, 1000 },
+    { "udp_down",       LWESP_NETCONN_TYPE_UDP, IPERF_DIR_DOWNLOAD, 0, IPERF_HOST, IPERF_PORT, 1460, 1, 10000, 1000 },
+};
+
+/**
+ * \brief           Thread running all default throughput tests against \ref IPERF_HOST
+ * \note            Device must be connected to access point before thread starts
+ * \param[in]       arg: User argument, not used
+ */
+void
+iperf_thread(void const* arg) {
+    LWESP_UNUSED(arg);
+
+    for (size_t i = 0; i < LWESP_ARRAYSIZE(iperf_tests); ++i) {
+        iperf_run(&iperf_tests[i]);
+    }
+    printf("{\"iperf\":\"done\"}\r\n");
+    lwesp_sys_thread_terminate(NULL);
+}
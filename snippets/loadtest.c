@@ -0,0 +1,494 @@
+/*
+ * Scalability load test, sweeping number of sessions, payload size and message rate.
+ *
+ * Single test opens N concurrent sessions of one type and each session sends messages
+ * at configured rate to echo server (TCP, UDP) or MQTT broker with loopback (MQTT)
+ * and waits for every message to come back. Round trip time of each message is its latency.
+ *
+ * Designed to run against simulated device (system/lwesp_ll_sim.c),
+ * where remote side of TCP and UDP connection is echo server and port 1883 is minimal MQTT broker.
+ * With real device, set \ref LOADTEST_HOST to host running echo server and MQTT broker.
+ *
+ * Results are printed in machine readable form, one JSON object per test:
+ *
+ * {"loadtest":"netconn_tcp","sessions":4,"payload":512,"rate":20,"time_ms":3001,"msgs":240,"drops":0,"errors":0,"kbps":327,"msgs_per_s":79,"p50_ms":3,"p99_ms":6,"max_ms":7,"max_conns":5,"mbox_producer":16,"mbox_process":16,"heap_peak":24576}
+ *
+ * - `msgs`: Number of messages that came back before \ref LOADTEST_ECHO_TIMEOUT
+ * - `drops`: Number of messages sent, but not received back in time
+ * - `errors`: Number of failed sends and sessions that could not be opened
+ * - `kbps`: Payload throughput of received messages in both directions
+ * - `heap_peak`: Heap high water mark since start of application, with \ref LWESP_CFG_MEM_STATS
+ * - Mailbox fill level and write fails with \ref LWESP_CFG_STATS_THREAD, input and receive drops with \ref LWESP_CFG_STATS_TRAFFIC
+ *
+ * Number of connections and mailbox sizes are compile time options.
+ * Build and run the same sweep with different \ref LWESP_CFG_MAX_CONNS,
+ * \ref LWESP_CFG_THREAD_PRODUCER_MBOX_SIZE and \ref LWESP_CFG_THREAD_PROCESS_MBOX_SIZE,
+ * configuration values are part of every result line to compare the runs.
+ */
+#include "loadtest.h"
+#include "lwesp/lwesp.h"
+#include "lwesp/lwesp_mem.h"
+#include "lwesp/lwesp_netconn.h"
+#include "lwesp/apps/lwesp_mqtt_client_api.h"
+
+#if !LWESP_CFG_NETCONN || !LWESP_CFG_NETCONN_RECEIVE_TIMEOUT
+#error "LWESP_CFG_NETCONN and LWESP_CFG_NETCONN_RECEIVE_TIMEOUT must be enabled in `lwesp_opts.h` to use loadtest snippet."
+#endif /* !LWESP_CFG_NETCONN || !LWESP_CFG_NETCONN_RECEIVE_TIMEOUT */
+
+/**
+ * \brief           Remote host with echo server and MQTT broker
+ */
+#ifndef LOADTEST_HOST
+#define LOADTEST_HOST               "10.0.0.1"
+#endif /* LOADTEST_HOST */
+#ifndef LOADTEST_ECHO_PORT
+#define LOADTEST_ECHO_PORT          7
+#endif /* LOADTEST_ECHO_PORT */
+#ifndef LOADTEST_MQTT_PORT
+#define LOADTEST_MQTT_PORT          1883
+#endif /* LOADTEST_MQTT_PORT */
+
+/**
+ * \brief           Time to wait for message to come back in units of milliseconds,
+ *                  message is counted as dropped after that
+ */
+#define LOADTEST_ECHO_TIMEOUT       1000
+
+/**
+ * \brief           Latency histogram, buckets are `1` millisecond wide up to \ref LOADTEST_HIST_FINE
+ *                  and \ref LOADTEST_HIST_COARSE milliseconds wide up to \ref LOADTEST_ECHO_TIMEOUT
+ */
+#define LOADTEST_HIST_FINE          64
+#define LOADTEST_HIST_COARSE        8
+#define LOADTEST_HIST_SIZE          (LOADTEST_HIST_FINE + (LOADTEST_ECHO_TIMEOUT - LOADTEST_HIST_FINE) / LOADTEST_HIST_COARSE + 1)
+
+/**
+ * \brief           State of single test session
+ */
+typedef struct {
+    const loadtest_cfg_t* cfg;                  /*!< Test configuration */
+    size_t idx;                                 /*!< Session index */
+    lwesp_conn_p conn;                          /*!< Connection handle for \ref LOADTEST_TYPE_CONN */
+    lwesp_netconn_p nc;                         /*!< Netconn handle for netconn types */
+    lwesp_mqtt_client_api_p client;             /*!< Client handle for \ref LOADTEST_TYPE_MQTT */
+    char topic[24];                             /*!< Own topic for \ref LOADTEST_TYPE_MQTT */
+    lwesp_sys_mbox_t rx_mbox;                   /*!< Receive notifications for \ref LOADTEST_TYPE_CONN */
+    volatile size_t rx;                         /*!< Received bytes for \ref LOADTEST_TYPE_CONN */
+    uint32_t end_time;                          /*!< Time when session stops sending */
+    size_t msgs;                                /*!< Number of messages received back */
+    size_t drops;                               /*!< Number of messages not received back in time */
+    size_t errors;                              /*!< Number of failed sends */
+    uint32_t lat_max;                           /*!< Maximal latency */
+    uint16_t hist[LOADTEST_HIST_SIZE];          /*!< Latency histogram */
+} loadtest_session_t;
+
+static loadtest_session_t sessions[LOADTEST_MAX_SESSIONS];
+static uint8_t loadtest_payload[LOADTEST_MAX_PAYLOAD];
+static lwesp_sys_mbox_t loadtest_done_mbox;
+static const char* const
+loadtest_type_names[] = {
+    [LOADTEST_TYPE_CONN] = "conn_tcp",
+    [LOADTEST_TYPE_NETCONN_TCP] = "netconn_tcp",
+    [LOADTEST_TYPE_NETCONN_UDP] = "netconn_udp",
+    [LOADTEST_TYPE_MQTT] = "mqtt",
+};
+
+/**
+ * \brief           Connection callback for \ref LOADTEST_TYPE_CONN sessions
+ * \param[in]       evt: Event information with data
+ * \return          \ref lwespOK on success, member of \ref lwespr_t otherwise
+ */
+static lwespr_t
+loadtest_conn_evt_fn(lwesp_evt_t* evt) {
+    lwesp_conn_p conn = lwesp_conn_get_from_evt(evt);
+    loadtest_session_t* s = conn != NULL ? lwesp_conn_get_arg(conn) : NULL;
+
+    if (s != NULL && lwesp_evt_get_type(evt) == LWESP_EVT_CONN_RECV) {
+        lwesp_pbuf_p pbuf = lwesp_evt_conn_recv_get_buff(evt);
+
+        s->rx += lwesp_pbuf_length(pbuf, 1);
+        lwesp_conn_recved(conn, pbuf);
+        lwesp_sys_mbox_putnow(&s->rx_mbox, s);  /* Wake-up session, it checks received length */
+    }
+    return lwespOK;
+}
+
+/**
+ * \brief           Send message and wait for it to come back
+ * \param[in]       s: Session
+ * \param[in]       len: Message length
+ * \return          \ref lwespOK when message came back, \ref lwespTIMEOUT when it did not,
+ *                      member of \ref lwespr_t enumeration when it could not be sent
+ */
+static lwespr_t
+loadtest_echo(loadtest_session_t* s, size_t len) {
+    lwesp_mqtt_client_api_buf_p buf;
+    lwesp_pbuf_p pbuf;
+    size_t rx = 0, target;
+    uint32_t start = lwesp_sys_now(), elapsed;
+    lwespr_t res;
+    void* m;
+
+    switch (s->cfg->type) {
+        case LOADTEST_TYPE_CONN: {
+            target = s->rx + len;
+            if ((res = lwesp_conn_send(s->conn, loadtest_payload, len, NULL, 1)) != lwespOK) {
+                return res;
+            }
+            while (s->rx < target) {
+                elapsed = lwesp_sys_now() - start;
+                if (elapsed >= LOADTEST_ECHO_TIMEOUT
+                    || lwesp_sys_mbox_get(&s->rx_mbox, &m, LOADTEST_ECHO_TIMEOUT - elapsed) == LWESP_SYS_TIMEOUT) {
+                    return lwespTIMEOUT;
+                }
+            }
+            return lwespOK;
+        }
+        case LOADTEST_TYPE_NETCONN_TCP:
+        case LOADTEST_TYPE_NETCONN_UDP: {
+            if (s->cfg->type == LOADTEST_TYPE_NETCONN_UDP) {
+                res = lwesp_netconn_send(s->nc, loadtest_payload, len);
+            } else if ((res = lwesp_netconn_write(s->nc, loadtest_payload, len)) == lwespOK) {
+                res = lwesp_netconn_flush(s->nc);
+            }
+            if (res != lwespOK) {
+                return res;
+            }
+            while (rx < len) {
+                elapsed = lwesp_sys_now() - start;
+                if (elapsed >= LOADTEST_ECHO_TIMEOUT) {
+                    return lwespTIMEOUT;
+                }
+                lwesp_netconn_set_receive_timeout(s->nc, LOADTEST_ECHO_TIMEOUT - elapsed);
+                if ((res = lwesp_netconn_receive(s->nc, &pbuf)) != lwespOK) {
+                    return res;
+                }
+                rx += lwesp_pbuf_length(pbuf, 1);
+                lwesp_pbuf_free(pbuf);
+            }
+            return lwespOK;
+        }
+        case LOADTEST_TYPE_MQTT: {
+            if ((res = lwesp_mqtt_client_api_publish(s->client, s->topic, loadtest_payload, len,
+                                                     LWESP_MQTT_QOS_AT_MOST_ONCE, 0)) != lwespOK) {
+                return res;
+            }
+            if ((res = lwesp_mqtt_client_api_receive(s->client, &buf, LOADTEST_ECHO_TIMEOUT)) != lwespOK) {
+                return lwespTIMEOUT;
+            }
+            lwesp_mqtt_client_api_buf_free(buf);
+            return lwespOK;
+        }
+        default:
+            return lwespPARERR;
+    }
+}
+
+/**
+ * \brief           Thread driving traffic on single session
+ * \param[in]       arg: Session state
+ */
+static void
+loadtest_session_thread(void* const arg) {
+    loadtest_session_t* s = arg;
+    const loadtest_cfg_t* cfg = s->cfg;
+    uint32_t interval, next, now, lat;
+    lwespr_t res;
+
+    interval = cfg->rate > 0 ? 1000 / cfg->rate : 0;
+    next = lwesp_sys_now();
+    while ((int32_t)(lwesp_sys_now() - s->end_time) < 0) {
+        now = lwesp_sys_now();
+        if (interval > 0) {
+            if ((int32_t)(next - now) > 0) {
+                lwesp_delay(next - now);        /* Keep configured rate */
+                continue;
+            }
+            next += interval;
+        }
+        now = lwesp_sys_now();
+        res = loadtest_echo(s, cfg->payload);
+        lat = lwesp_sys_now() - now;
+        if (res == lwespOK) {
+            ++s->msgs;
+            ++s->hist[lat < LOADTEST_HIST_FINE ? lat : LWESP_MIN(LOADTEST_HIST_FINE + (lat - LOADTEST_HIST_FINE) / LOADTEST_HIST_COARSE,
+                                                               LOADTEST_HIST_SIZE - 1)];
+            if (lat > s->lat_max) {
+                s->lat_max = lat;
+            }
+        } else if (res == lwespTIMEOUT) {
+            ++s->drops;
+        } else {
+            ++s->errors;
+            lwesp_delay(10);                    /* Do not spin on failing session */
+        }
+    }
+    lwesp_sys_mbox_put(&loadtest_done_mbox, s);
+    lwesp_sys_thread_terminate(NULL);
+}
+
+/**
+ * \brief           Open session according to configuration
+ * \param[in]       s: Session with configuration and index set
+ * \return          \ref lwespOK on success, member of \ref lwespr_t enumeration otherwise
+ */
+static lwespr_t
+loadtest_session_open(loadtest_session_t* s) {
+    lwesp_mqtt_client_info_t info = {
+        .keep_alive = 10,
+    };
+    char id[24];
+    lwespr_t res = lwespERRMEM;
+
+    switch (s->cfg->type) {
+        case LOADTEST_TYPE_CONN: {
+            if (!lwesp_sys_mbox_create(&s->rx_mbox, 4)) {
+                return lwespERRMEM;
+            }
+            if ((res = lwesp_conn_start(&s->conn, LWESP_CONN_TYPE_TCP, LOADTEST_HOST, LOADTEST_ECHO_PORT,
+                                        s, loadtest_conn_evt_fn, 1)) != lwespOK) {
+                s->conn = NULL;
+                lwesp_sys_mbox_delete(&s->rx_mbox);
+                lwesp_sys_mbox_invalid(&s->rx_mbox);
+            }
+            break;
+        }
+        case LOADTEST_TYPE_NETCONN_TCP:
+        case LOADTEST_TYPE_NETCONN_UDP: {
+            s->nc = lwesp_netconn_new(s->cfg->type == LOADTEST_TYPE_NETCONN_UDP ? LWESP_NETCONN_TYPE_UDP : LWESP_NETCONN_TYPE_TCP);
+            if (s->nc != NULL && (res = lwesp_netconn_connect(s->nc, LOADTEST_HOST, LOADTEST_ECHO_PORT)) != lwespOK) {
+                lwesp_netconn_delete(s->nc);
+                s->nc = NULL;
+            }
+            break;
+        }
+        case LOADTEST_TYPE_MQTT: {
+            sprintf(id, "lwesp_load_%u", (unsigned)s->idx);
+            sprintf(s->topic, "lwesp/load/%u", (unsigned)s->idx);
+            info.id = id;
+            s->client = lwesp_mqtt_client_api_new(s->cfg->payload + 64, s->cfg->payload + 64);
+            if (s->client != NULL) {
+                if (lwesp_mqtt_client_api_connect(s->client, LOADTEST_HOST, LOADTEST_MQTT_PORT, &info) == LWESP_MQTT_CONN_STATUS_ACCEPTED
+                    && lwesp_mqtt_client_api_subscribe(s->client, s->topic, LWESP_MQTT_QOS_AT_MOST_ONCE) == lwespOK) {
+                    res = lwespOK;
+                } else {
+                    lwesp_mqtt_client_api_delete(s->client);
+                    s->client = NULL;
+                    res = lwespERRCONNFAIL;
+                }
+            }
+            break;
+        }
+        default:
+            res = lwespPARERR;
+            break;
+    }
+    return res;
+}
+
+/**
+ * \brief           Close session and release its resources
+ * \param[in]       s: Session to close
+ */
+static void
+loadtest_session_close(loadtest_session_t* s) {
+    if (s->conn != NULL) {
+        lwesp_conn_close(s->conn, 1);
+        s->conn = NULL;
+        lwesp_sys_mbox_delete(&s->rx_mbox);
+        lwesp_sys_mbox_invalid(&s->rx_mbox);
+    }
+    if (s->nc != NULL) {
+        lwesp_netconn_close(s->nc);
+        lwesp_netconn_delete(s->nc);
+        s->nc = NULL;
+    }
+    if (s->client != NULL) {
+        lwesp_mqtt_client_api_close(s->client);
+        lwesp_mqtt_client_api_delete(s->client);
+        s->client = NULL;
+    }
+}
+
+/**
+ * \brief           Get latency percentile from histogram of all sessions
+ * \param[in]       cnt: Number of sessions
+ * \param[in]       total: Number of samples in all histograms
+ * \param[in]       pct: Percentile, `0` to `100`
+ * \return          Latency in units of milliseconds, upper bound of histogram bucket
+ */
+static uint32_t
+loadtest_percentile(size_t cnt, size_t total, uint32_t pct) {
+    size_t target, sum = 0;
+
+    target = (total * pct + 99) / 100;
+    for (uint32_t i = 0; i < LOADTEST_HIST_SIZE; ++i) {
+        for (size_t j = 0; j < cnt; ++j) {
+            sum += sessions[j].hist[i];
+        }
+        if (sum >= target && sum > 0) {
+            return i < LOADTEST_HIST_FINE ? i : LOADTEST_HIST_FINE + (i - LOADTEST_HIST_FINE + 1) * LOADTEST_HIST_COARSE - 1;
+        }
+    }
+    return LOADTEST_ECHO_TIMEOUT;
+}
+
+/**
+ * \brief           Run single load test and print its result
+ * \note            Function blocks for test duration, only one test may run at the same time
+ * \param[in]       cfg: Test configuration
+ * \return          \ref lwespOK when all sessions were opened, member of \ref lwespr_t otherwise
+ */
+lwespr_t
+loadtest_run(const loadtest_cfg_t* cfg) {
+    size_t cnt = 0, started = 0, done = 0, msgs = 0, drops = 0, errors = 0;
+    uint32_t start, time, lat_max = 0;
+    void* m;
+#if LWESP_CFG_STATS_THREAD || LWESP_CFG_STATS_TRAFFIC
+    lwesp_stats_t stats;
+#endif /* LWESP_CFG_STATS_THREAD || LWESP_CFG_STATS_TRAFFIC */
+#if LWESP_CFG_STATS_THREAD
+    uint32_t mbox_fails;
+#endif /* LWESP_CFG_STATS_THREAD */
+#if LWESP_CFG_STATS_TRAFFIC
+    uint32_t ipd_drops, uart_drops;
+#endif /* LWESP_CFG_STATS_TRAFFIC */
+#if LWESP_CFG_MEM_STATS
+    lwesp_mem_stats_t ms;
+#endif /* LWESP_CFG_MEM_STATS */
+
+    if (cfg == NULL || cfg->type >= LOADTEST_TYPE_END
+        || cfg->sessions == 0 || cfg->sessions > LOADTEST_MAX_SESSIONS
+        || cfg->payload == 0 || cfg->payload > LOADTEST_MAX_PAYLOAD) {
+        return lwespPARERR;
+    }
+    if (!lwesp_sys_mbox_isvalid(&loadtest_done_mbox)
+        && !lwesp_sys_mbox_create(&loadtest_done_mbox, LOADTEST_MAX_SESSIONS)) {
+        return lwespERRMEM;
+    }
+    LWESP_MEMSET(sessions, 0x00, sizeof(sessions));
+    for (size_t i = 0; i < sizeof(loadtest_payload); ++i) {
+        loadtest_payload[i] = (uint8_t)('a' + (i % 26));
+    }
+
+    /* Open all sessions first, measured traffic starts at the same time */
+    for (; cnt < cfg->sessions; ++cnt) {
+        sessions[cnt].cfg = cfg;
+        sessions[cnt].idx = cnt;
+        if (loadtest_session_open(&sessions[cnt]) != lwespOK) {
+            break;
+        }
+    }
+    errors = cfg->sessions - cnt;
+
+#if LWESP_CFG_STATS_THREAD || LWESP_CFG_STATS_TRAFFIC
+    lwesp_stats_get(&stats);
+#endif /* LWESP_CFG_STATS_THREAD || LWESP_CFG_STATS_TRAFFIC */
+#if LWESP_CFG_STATS_THREAD
+    mbox_fails = stats.mbox_producer.write_fails + stats.mbox_process.write_fails;
+#endif /* LWESP_CFG_STATS_THREAD */
+#if LWESP_CFG_STATS_TRAFFIC
+    ipd_drops = stats.conn.ipd_drops;
+    uart_drops = stats.uart_rx_dropped;
+#endif /* LWESP_CFG_STATS_TRAFFIC */
+    start = lwesp_sys_now();
+    for (size_t i = 0; i < cnt; ++i) {
+        sessions[i].end_time = start + cfg->duration;
+        if (lwesp_sys_thread_create(NULL, "loadtest", (lwesp_sys_thread_fn)loadtest_session_thread, &sessions[i], LWESP_SYS_THREAD_SS, LWESP_SYS_THREAD_PRIO)) {
+            ++started;
+        } else {
+            ++errors;
+        }
+    }
+    while (done < started) {
+        if (lwesp_sys_mbox_get(&loadtest_done_mbox, &m, 0) != LWESP_SYS_TIMEOUT) {
+            ++done;
+        }
+    }
+    time = lwesp_sys_now() - start;
+    for (size_t i = 0; i < cnt; ++i) {
+        msgs += sessions[i].msgs;
+        drops += sessions[i].drops;
+        errors += sessions[i].errors;
+        if (sessions[i].lat_max > lat_max) {
+            lat_max = sessions[i].lat_max;
+        }
+        loadtest_session_close(&sessions[i]);
+    }
+
+    /* Print result */
+    LOADTEST_PRINTF("{\"loadtest\":\"%s\",\"sessions\":%u,\"payload\":%u,\"rate\":%u,\"time_ms\":%u,\"msgs\":%u,\"drops\":%u,\"errors\":%u",
+                    loadtest_type_names[cfg->type], (unsigned)cfg->sessions, (unsigned)cfg->payload, (unsigned)cfg->rate,
+                    (unsigned)time, (unsigned)msgs, (unsigned)drops, (unsigned)errors);
+    LOADTEST_PRINTF(",\"kbps\":%u,\"msgs_per_s\":%u,\"p50_ms\":%u,\"p99_ms\":%u,\"max_ms\":%u",
+                    time > 0 ? (unsigned)(((uint64_t)msgs * cfg->payload * 2U * 8U) / time) : 0U,
+                    time > 0 ? (unsigned)(((uint64_t)msgs * 1000U) / time) : 0U,
+                    (unsigned)LWESP_MIN(loadtest_percentile(cnt, msgs, 50), lat_max),
+                    (unsigned)LWESP_MIN(loadtest_percentile(cnt, msgs, 99), lat_max), (unsigned)lat_max);
+    LOADTEST_PRINTF(",\"max_conns\":%u,\"mbox_producer\":%u,\"mbox_process\":%u", (unsigned)LWESP_CFG_MAX_CONNS,
+                    (unsigned)LWESP_CFG_THREAD_PRODUCER_MBOX_SIZE, (unsigned)LWESP_CFG_THREAD_PROCESS_MBOX_SIZE);
+#if LWESP_CFG_STATS_THREAD || LWESP_CFG_STATS_TRAFFIC
+    lwesp_stats_get(&stats);
+#endif /* LWESP_CFG_STATS_THREAD || LWESP_CFG_STATS_TRAFFIC */
+#if LWESP_CFG_STATS_THREAD
+    LOADTEST_PRINTF(",\"mbox_producer_depth_max\":%u,\"mbox_process_depth_max\":%u,\"mbox_write_fails\":%u",
+                    (unsigned)stats.mbox_producer.depth_max, (unsigned)stats.mbox_process.depth_max,
+                    (unsigned)(stats.mbox_producer.write_fails + stats.mbox_process.write_fails - mbox_fails));
+#endif /* LWESP_CFG_STATS_THREAD */
+#if LWESP_CFG_STATS_TRAFFIC
+    LOADTEST_PRINTF(",\"ipd_drops\":%u,\"uart_rx_dropped\":%u",
+                    (unsigned)(stats.conn.ipd_drops - ipd_drops), (unsigned)(stats.uart_rx_dropped - uart_drops));
+#endif /* LWESP_CFG_STATS_TRAFFIC */
+#if LWESP_CFG_MEM_STATS
+    if (lwesp_mem_get_stats(&ms) == lwespOK) {
+        LOADTEST_PRINTF(",\"heap_peak\":%u,\"heap_min_free\":%u", (unsigned)ms.bytes_peak, (unsigned)ms.bytes_min_free);
+    }
+#endif /* LWESP_CFG_MEM_STATS */
+    LOADTEST_PRINTF("}\r\n");
+    return cnt == cfg->sessions ? lwespOK : lwespERRCONNFAIL;
+}
+
+/**
+ * \brief           Sweep values of default test set, executed by \ref loadtest_thread
+ */
+static const size_t loadtest_payloads[] = {64, 512, LOADTEST_MAX_PAYLOAD};
+static const uint32_t loadtest_rates[] = {10, 0};
+
+/**
+ * \brief           Thread running full sweep of session types, session counts, payload sizes and message rates.
+ *
+ * Session count doubles from `1` up to \ref LOADTEST_MAX_SESSIONS
+ *
+ * \note            Library must be initialized, station is joined to access point if not already
+ * \param[in]       arg: User argument, not used
+ */
+void
+loadtest_thread(void const* arg) {
+    loadtest_cfg_t cfg = {
+        .duration = 3000,
+    };
+    LWESP_UNUSED(arg);
+
+#if LWESP_CFG_MODE_STATION
+    if (!lwesp_sta_is_joined()) {
+        lwesp_sta_join("lwesp-sim", "lwesp-sim", NULL, NULL, NULL, 1);
+    }
+#endif /* LWESP_CFG_MODE_STATION */
+
+    for (cfg.type = LOADTEST_TYPE_CONN; cfg.type < LOADTEST_TYPE_END; ++cfg.type) {
+        for (cfg.sessions = 1;; cfg.sessions = LWESP_MIN(cfg.sessions << 1, LOADTEST_MAX_SESSIONS)) {
+            for (size_t p = 0; p < LWESP_ARRAYSIZE(loadtest_payloads); ++p) {
+                for (size_t r = 0; r < LWESP_ARRAYSIZE(loadtest_rates); ++r) {
+                    cfg.payload = loadtest_payloads[p];
+                    cfg.rate = loadtest_rates[r];
+                    loadtest_run(&cfg);
+                }
+            }
+            if (cfg.sessions == LOADTEST_MAX_SESSIONS) {
+                break;                          /* Last step always uses all sessions */
+            }
+        }
+    }
+    LOADTEST_PRINTF("{\"loadtest\":\"done\"}\r\n");
+    lwesp_sys_thread_terminate(NULL);
+}
@@ -45,9 +45,7 @@ mqtt_client_api_cayenne_thread(void const* arg) {
 beg:
     while (1) {
         /* Wait IP and connected to network */
-        while (!lwesp_sta_has_ip()) {
-            lwesp_delay(1000);
-        }
+        lwesp_wait_for(LWESP_STATE_HAS_IP, 0);
 
         if (client == NULL) {
             client = lwesp_mqtt_client_api_new(256, 256);
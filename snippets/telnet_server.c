@@ -46,11 +46,12 @@ telnet_cli_printf(const char* fmt, ...) {
 
     memset(&tempStr, 0x00, sizeof(tempStr) );
     va_start(argptr, fmt);
-    len = vsprintf(tempStr, fmt, argptr);
+    len = vsnprintf(tempStr, sizeof(tempStr), fmt, argptr);
     va_end(argptr);
 
-    if (len > 0 && len < 128) {
-        lwesp_netconn_write(client, (uint8_t*)tempStr, len);
+    if (len > 0) {
+        /* Longer output is truncated, not dropped */
+        lwesp_netconn_write(client, (uint8_t*)tempStr, LWESP_MIN((size_t)len, sizeof(tempStr) - 1));
     }
 }
 